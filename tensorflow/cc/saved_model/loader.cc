@@ -15,8 +15,11 @@ limitations under the License.
 
 #include "tensorflow/cc/saved_model/loader.h"
 
+#include <algorithm>
 #include <string>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
@@ -40,7 +43,9 @@ limitations under the License.
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/file_system_helper.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/statusor.h"
+#include "tensorflow/core/platform/threadpool.h"
 #include "tensorflow/core/protobuf/meta_graph.pb.h"
 #include "tensorflow/core/protobuf/saver.pb.h"
 #include "tensorflow/core/public/session.h"
@@ -225,6 +230,39 @@ Status RunInitOp(const RunOptions& run_options, const string& export_dir,
   return OkStatus();
 }
 
+// Runs `request` against `bundle`, fetching all the outputs of its signature.
+Status RunWarmupRequest(const RunOptions& run_options,
+                        const SavedModelBundleInterface& bundle,
+                        const SavedModelWarmupRequest& request) {
+  const auto& signatures = bundle.GetSignatures();
+  const auto signature = signatures.find(request.signature_name);
+  if (signature == signatures.end()) {
+    return errors::NotFound("Warmup request for unknown signature: ",
+                            request.signature_name);
+  }
+  std::vector<std::pair<string, Tensor>> inputs;
+  inputs.reserve(request.inputs.size());
+  for (const auto& input : request.inputs) {
+    const auto tensor_info = signature->second.inputs().find(input.first);
+    if (tensor_info == signature->second.inputs().end()) {
+      return errors::InvalidArgument("Warmup request for signature ",
+                                     request.signature_name,
+                                     " has an unknown input: ", input.first);
+    }
+    inputs.emplace_back(tensor_info->second.name(), input.second);
+  }
+  std::vector<string> output_tensor_names;
+  output_tensor_names.reserve(signature->second.outputs_size());
+  for (const auto& output : signature->second.outputs()) {
+    output_tensor_names.push_back(output.second.name());
+  }
+  std::vector<Tensor> outputs;
+  RunMetadata run_metadata;
+  return bundle.GetSession()->Run(run_options, inputs, output_tensor_names,
+                                  /*target_tensor_names=*/{}, &outputs,
+                                  &run_metadata);
+}
+
 Status RunRestore(const RunOptions& run_options, const string& export_dir,
                   const StringPiece restore_op_name,
                   const StringPiece variable_filename_const_op_name,
@@ -494,6 +532,39 @@ Status LoadSavedModel(const SessionOptions& session_options,
   return OkStatus();
 }
 
+Status WarmUpSavedModel(const RunOptions& run_options,
+                        const SavedModelBundleInterface& bundle,
+                        const std::vector<SavedModelWarmupRequest>& requests,
+                        int num_threads) {
+  if (num_threads < 1) {
+    return errors::InvalidArgument("num_threads must be positive; was ",
+                                   num_threads);
+  }
+  if (requests.empty()) return OkStatus();
+  LOG(INFO) << "Running " << requests.size()
+            << " warmup requests on SavedModel bundle.";
+  const uint64 start_microseconds = Env::Default()->NowMicros();
+  mutex mu;
+  Status status;
+  {
+    thread::ThreadPool pool(Env::Default(), "saved_model_warmup",
+                            std::min<int>(num_threads, requests.size()));
+    for (const SavedModelWarmupRequest& request : requests) {
+      pool.Schedule([&run_options, &bundle, &request, &mu, &status] {
+        const Status request_status =
+            RunWarmupRequest(run_options, bundle, request);
+        mutex_lock l(mu);
+        status.Update(request_status);
+      });
+    }
+    // The pool waits for the requests to finish when it is destroyed.
+  }
+  LOG(INFO) << "SavedModel warmup took "
+            << GetLatencyMicroseconds(start_microseconds)
+            << " microseconds; Status: " << status;
+  return status;
+}
+
 bool MaybeSavedModelDirectory(const string& export_dir) {
   const string saved_model_pb_path =
       io::JoinPath(export_dir, kSavedModelFilenamePb);
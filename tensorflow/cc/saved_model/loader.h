@@ -20,6 +20,8 @@ limitations under the License.
 
 #include <string>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "tensorflow/core/framework/graph_debug_info.pb.h"
 #include "tensorflow/core/lib/core/status.h"
@@ -135,6 +137,29 @@ Status LoadSavedModel(const SessionOptions& session_options,
                       const std::unordered_set<string>& tags,
                       SavedModelBundleLite* const bundle);
 
+/// A request run against a loaded SavedModel before it serves traffic, e.g. one
+/// recorded from production traffic. `inputs` are keyed by the input keys of
+/// the signature named `signature_name`.
+struct SavedModelWarmupRequest {
+  string signature_name;
+  std::vector<std::pair<string, Tensor>> inputs;
+};
+
+/// Runs `requests` against the session of `bundle`, fetching all the outputs
+/// of their signatures, with up to `num_threads` requests in flight at a time.
+///
+/// The first run of a signature is much slower than the next ones: the session
+/// prunes and partitions the graph, instantiates its functions and kernels,
+/// and possibly compiles them, before caching the result. Warming up all the
+/// signatures concurrently before reporting a model as ready moves that cost
+/// out of the first requests, without serializing it.
+///
+/// Returns the first error encountered, if any, once all requests are done.
+Status WarmUpSavedModel(const RunOptions& run_options,
+                        const SavedModelBundleInterface& bundle,
+                        const std::vector<SavedModelWarmupRequest>& requests,
+                        int num_threads);
+
 /// Checks whether the provided directory could contain a SavedModel. Note that
 /// the method does not load any data by itself. If the method returns `false`,
 /// the export directory definitely does not contain a SavedModel. If the method
@@ -26,6 +26,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/lib/io/path.h"
 #include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/protobuf/meta_graph.pb.h"
 
@@ -178,6 +179,32 @@ TEST_F(LoaderTest, RestoreSession) {
   CheckSavedModelBundle(export_dir, actual_bundle);
 }
 
+TEST_F(LoaderTest, WarmUpSavedModel) {
+  SavedModelBundle bundle;
+  SessionOptions session_options;
+  RunOptions run_options;
+
+  const string export_dir =
+      io::JoinPath(testing::TensorFlowSrcRoot(), kTestDataSharded);
+  TF_ASSERT_OK(LoadSavedModel(session_options, run_options, export_dir,
+                              {kSavedModelTagServe}, &bundle));
+
+  std::vector<SavedModelWarmupRequest> requests;
+  for (float x : {0, 1, 2, 3}) {
+    requests.push_back(
+        {"regress_x_to_y",
+         {{kRegressInputs, test::AsTensor<tstring>({MakeSerializedExample(x)},
+                                                   TensorShape({1}))}}});
+  }
+  TF_EXPECT_OK(
+      WarmUpSavedModel(run_options, bundle, requests, /*num_threads=*/2));
+  CheckSavedModelBundle(export_dir, bundle);
+
+  requests.push_back({"unknown_signature", {}});
+  EXPECT_TRUE(errors::IsNotFound(
+      WarmUpSavedModel(run_options, bundle, requests, /*num_threads=*/2)));
+}
+
 TEST_F(LoaderTest, NoTagMatch) {
   SavedModelBundle bundle;
   RunOptions run_options;
@@ -159,6 +159,11 @@ Status CompileGraph(GraphDef graph_def, const tf2xla::Config& config,
       flags.entry_point,
       xla::cpu::CpuAotCompilationOptions::RelocationModel::BigPic);
   aot_opts.set_use_mlir_hlo_lowering(use_mlir_hlo_lowering);
+  if (flags.max_parallelism < 0) {
+    return errors::InvalidArgument("max_parallelism must be non-negative, got ",
+                                   flags.max_parallelism);
+  }
+  aot_opts.set_max_parallelism(flags.max_parallelism);
 
   if (flags.sanitize_dataflow) {
     aot_opts.set_sanitize_dataflow(flags.sanitize_dataflow);
@@ -75,6 +75,11 @@ void AppendMainFlags(std::vector<Flag>* flag_list, MainFlags* flags) {
        "function."},
       {"out_session_module", &flags->out_session_module,
        "Output session module proto."},
+      {"max_parallelism", &flags->max_parallelism,
+       "If greater than 0, the expensive ops are partitioned into at most this "
+       "many parallel tasks at compile time, which run on the thread pool "
+       "passed to set_thread_pool() of the generated class.  The default of 0 "
+       "generates single-threaded code."},
       {"mlir_components", &flags->mlir_components,
        "The MLIR components to enable. Currently only Bridge is supported."},
       {"experimental_quantize", &flags->experimental_quantize,
@@ -25,6 +25,7 @@ limitations under the License.
 #include "tensorflow/compiler/jit/xla_activity_listener.h"
 #include "tensorflow/core/framework/attr_value.pb.h"
 #include "tensorflow/core/framework/metrics.h"
+#include "tensorflow/core/lib/monitoring/counter.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/tsl/platform/mutex.h"
@@ -62,8 +63,25 @@ void RegisterExecutionForCluster(
 // signature before  we attempt to compile it.
 constexpr int64_t kDefaultCompilationThreshold = 2;
 
-// Maximum number of ongoing compilations.
-constexpr int64_t kMaxNumOngoingCompilations = kNumAsyncDeviceCompilerThreads;
+// Maximum number of ongoing compilations, including the ones waiting for a
+// compiler thread.
+constexpr int64_t kMaxNumOngoingCompilations =
+    kMaxNumOngoingAsyncDeviceCompilations;
+
+auto* async_compilations_rejected = monitoring::Counter<0>::New(
+    "/tensorflow/core/xla_async_compilations_rejected",
+    "The number of asynchronous XLA compilations that were not queued because "
+    "too many compilations were ongoing.");
+
+auto* async_compilation_queue_time = monitoring::Counter<0>::New(
+    "/tensorflow/core/xla_async_compilation_queue_time_usecs",
+    "The cumulative time asynchronous XLA compilations waited for a compiler "
+    "thread.");
+
+auto* async_compilation_fallback_executions = monitoring::Counter<0>::New(
+    "/tensorflow/core/xla_async_compilation_fallback_executions",
+    "The number of cluster executions that took the fallback path because the "
+    "cluster was being compiled asynchronously.");
 
 }  // namespace
 
@@ -184,6 +202,7 @@ bool DeviceCompilationProfiler::ShouldCompileCluster(
     if (num_ongoing_compilations_ >= kMaxNumOngoingCompilations) {
       VLOG(2) << "Not asynchronously compiling cluster " << function.name()
               << " because of too many ongoing compilations.";
+      async_compilations_rejected->GetCell()->IncrementBy(1);
       return false;
     }
   }
@@ -213,6 +232,21 @@ int64_t DeviceCompilationProfiler::GetNumOngoingAsyncCompilations() const {
   return num_ongoing_compilations_;
 }
 
+void DeviceCompilationProfiler::RegisterAsyncCompilationStart(
+    int64_t queue_time_us) {
+  async_compilation_queue_time->GetCell()->IncrementBy(queue_time_us);
+}
+
+void DeviceCompilationProfiler::RegisterFallbackExecution(
+    const NameAttrList& function) {
+  async_compilation_fallback_executions->GetCell()->IncrementBy(1);
+  mutex_lock lock(mu_);
+  auto it =
+      cluster_compile_stats_.emplace(function.name(), ClusterCompileStats{})
+          .first;
+  ++it->second.fallback_execution_count;
+}
+
 std::string DeviceCompilationProfiler::DebugString() const {
   std::string debug_string =
       "DeviceCompilationProfiler {\ncluster_compile_stats: {\n";
@@ -41,6 +41,10 @@ class DeviceCompilationProfiler : public ResourceBase {
     // Cumulative time spent compiling the cluster.
     int64_t cumulative_compile_time_us = 0;
 
+    // The number of times this cluster took the fallback path because it was
+    // being compiled asynchronously.
+    int64_t fallback_execution_count = 0;
+
     // True if we have decided that this cluster is too dynamic (i.e. its shapes
     // change too frequently) to profitably JIT compile.  Once a cluster is
     // tagged megamorphic, it stays megamorphic forever.
@@ -51,6 +55,7 @@ class DeviceCompilationProfiler : public ResourceBase {
           "DeviceCompilationProfiler::ClusterCompileStats {compile_count=",
           compile_count, ", execution_count=", execution_count,
           ", cumulative_compile_time_us=", cumulative_compile_time_us,
+          ", fallback_execution_count=", fallback_execution_count,
           ", is_megamorphic=", is_megamorphic, "}");
     }
   };
@@ -78,9 +83,19 @@ class DeviceCompilationProfiler : public ResourceBase {
                                      int64_t compile_time_us,
                                      bool used_persistent_cache);
 
+  // Ongoing asynchronous compilations include the ones that are queued and
+  // wait for a compiler thread.
   void IncrementOngoingAsyncCompilations();
   void DecrementOngoingAsyncCompilations();
   int64_t GetNumOngoingAsyncCompilations() const;
+
+  // Registers that a queued asynchronous compilation started on a compiler
+  // thread after waiting for `queue_time_us`.
+  void RegisterAsyncCompilationStart(int64_t queue_time_us);
+
+  // Registers an execution of the cluster that took the fallback path while
+  // the cluster was being compiled asynchronously.
+  void RegisterFallbackExecution(const NameAttrList& function);
   std::string DebugString() const override;
 
  private:
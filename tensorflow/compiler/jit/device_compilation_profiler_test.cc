@@ -105,6 +105,21 @@ TEST(DeviceCompilationProfilerTest, OngoingAsyncCompilations) {
   EXPECT_EQ(profiler->GetNumOngoingAsyncCompilations(), 0);
 }
 
+TEST(DeviceCompilationProfilerTest, RegisterFallbackExecution) {
+  DeviceCompilationProfiler* profiler = new DeviceCompilationProfiler();
+  core::ScopedUnref profiler_ref(profiler);
+
+  NameAttrList function;
+  function.set_name("TestFunc");
+
+  for (int i = 0; i < 3; ++i) {
+    profiler->RegisterFallbackExecution(function);
+  }
+  TF_ASSERT_OK_AND_ASSIGN(auto stats, profiler->GetCompileStats(function));
+  EXPECT_EQ(stats.fallback_execution_count, 3);
+  EXPECT_EQ(stats.compile_count, 0);
+}
+
 TEST(DeviceCompilationProfilerTest, ShouldCompileClusterNotFound) {
   DeviceCompilationProfiler* profiler = new DeviceCompilationProfiler();
   core::ScopedUnref profiler_ref(profiler);
@@ -189,8 +204,7 @@ TEST(DeviceCompilationProfilerTest, ShouldCompileClusterAsync) {
   NameAttrList function;
   function.set_name("TestFunc");
 
-  const int64_t kMaxNumOngoingCompilations = 10;
-  for (int i = 0; i < kMaxNumOngoingCompilations; ++i) {
+  for (int i = 0; i < kMaxNumOngoingAsyncDeviceCompilations; ++i) {
     profiler->IncrementOngoingAsyncCompilations();
   }
 
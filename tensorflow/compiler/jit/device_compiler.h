@@ -16,9 +16,11 @@ limitations under the License.
 #ifndef TENSORFLOW_COMPILER_JIT_DEVICE_COMPILER_H_
 #define TENSORFLOW_COMPILER_JIT_DEVICE_COMPILER_H_
 
+#include <functional>
 #include <memory>
 #include <numeric>
 #include <optional>
+#include <queue>
 #include <string>
 #include <utility>
 #include <variant>
@@ -159,6 +161,9 @@ class DeviceCompiler : public ResourceBase {
                              OpKernelContext* ctx,
                              DeviceCompilationProfiler* profiler);
 
+  // Runs the queued asynchronous compilation with the highest priority.
+  void RunNextAsynchronousCompilation();
+
   std::unique_ptr<DeviceExecutablePersistor<ExecutableType, ClientType>>
       persistor_;
   std::unique_ptr<DeviceCompilerClient<ExecutableType, ClientType>>
@@ -168,6 +173,30 @@ class DeviceCompiler : public ResourceBase {
   // Pool of threads for asynchronous compilations.
   std::unique_ptr<thread::ThreadPool> async_compiler_threads_;
 
+  // An asynchronous compilation waiting for a thread of
+  // `async_compiler_threads_`. The compilations of the clusters that executed
+  // the most run first, so that the hot clusters leave the fallback path
+  // first. Compilations of the same priority run in the order they were
+  // requested.
+  struct PendingAsyncCompilation {
+    int64_t priority;
+    int64_t sequence_number;
+    std::function<void()> compile;
+
+    bool operator<(const PendingAsyncCompilation& other) const {
+      if (priority != other.priority) {
+        return priority < other.priority;
+      }
+      return sequence_number > other.sequence_number;
+    }
+  };
+
+  mutex pending_async_compilations_mu_;
+  std::priority_queue<PendingAsyncCompilation> pending_async_compilations_
+      TF_GUARDED_BY(pending_async_compilations_mu_);
+  int64_t next_async_compilation_sequence_number_
+      TF_GUARDED_BY(pending_async_compilations_mu_) = 0;
+
   mutex cluster_mutexes_mu_;
   absl::flat_hash_map<DeviceCompilationClusterSignature, std::unique_ptr<mutex>,
                       DeviceCompilationClusterSignature::Hash>
@@ -369,9 +398,12 @@ Status DeviceCompiler<ExecutableType, ClientType>::CompileAsynchronous(
   // All values are captured by value. Make sure that all pointer values (like
   // entry) do not get freed until the lambda has finished.
   const std::string& function_name = function.name();
-  async_compiler_threads_->Schedule([=] {
+  const uint64 queued_us = Env::Default()->NowMicros();
+  auto compile = [=] {
     VLOG(2) << "Starting asynchronous compilation of cluster " << function_name
             << '.';
+    profiler->RegisterAsyncCompilationStart(Env::Default()->NowMicros() -
+                                            queued_us);
     // We don't need to lock mu, but do it anyway to satisfy thread safety
     // analysis.
     mutex mu;
@@ -387,10 +419,37 @@ Status DeviceCompiler<ExecutableType, ClientType>::CompileAsynchronous(
       cache_->Store(signature, std::nullopt, s.status(), std::nullopt,
                     std::nullopt);
     }
-  });
+  };
+
+  StatusOr<DeviceCompilationProfiler::ClusterCompileStats> stats =
+      profiler->GetCompileStats(function);
+  const int64_t priority = stats.ok() ? stats->execution_count : 0;
+  {
+    mutex_lock lock(pending_async_compilations_mu_);
+    pending_async_compilations_.push(
+        {priority, next_async_compilation_sequence_number_++,
+         std::move(compile)});
+  }
+  // Every scheduled task runs one compilation, not necessarily the one queued
+  // above.
+  async_compiler_threads_->Schedule(
+      [this] { RunNextAsynchronousCompilation(); });
   return OkStatus();
 }
 
+template <typename ExecutableType, typename ClientType>
+void DeviceCompiler<ExecutableType,
+                    ClientType>::RunNextAsynchronousCompilation() {
+  std::function<void()> compile;
+  {
+    mutex_lock lock(pending_async_compilations_mu_);
+    DCHECK(!pending_async_compilations_.empty());
+    compile = pending_async_compilations_.top().compile;
+    pending_async_compilations_.pop();
+  }
+  compile();
+}
+
 template <typename ExecutableType, typename ClientType>
 Status DeviceCompiler<ExecutableType, ClientType>::CompileImpl(
     const XlaCompiler::CompileOptions& compile_options,
@@ -484,6 +543,7 @@ Status DeviceCompiler<ExecutableType, ClientType>::CompileImpl(
   } else if (state == DeviceCompileState::kCompiling) {
     VLOG(2) << "Ongoing asynchronous compilation for signature: "
             << human_signature;
+    profiler->RegisterFallbackExecution(function);
     return OkStatus();
   } else if (state == DeviceCompileState::kCompiled) {
     VLOG(2) << "Already Compiled for signature: " << human_signature;
@@ -28,6 +28,7 @@ limitations under the License.
 #include "tensorflow/core/framework/device.h"
 #include "tensorflow/core/lib/strings/proto_serialization.h"
 #include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/platform/random.h"
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/platform/statusor.h"
 #include "tensorflow/tsl/platform/statusor.h"
@@ -114,7 +115,8 @@ class DeviceExecutablePersistor {
       DeviceCompilerClient<ExecutableType, ClientType>* compiler_client) const;
 
   // Saves the cache entry in the file directory supplied during the
-  // construction of this class. Overwrites existing entries.
+  // construction of this class. Overwrites existing entries. Readers, possibly
+  // in other processes, either see the previous entry or the complete new one.
   Status SaveSerializedEntry(const XlaSerializedCacheEntry& entry) const;
 
   // Tries to read a cache entry given a `key` by searching the file directory
@@ -261,7 +263,20 @@ DeviceExecutablePersistor<ExecutableType, ClientType>::SaveSerializedEntry(
   Env* env = Env::Default();
   TF_RETURN_IF_ERROR(env->RecursivelyCreateDir(persistent_cache_directory_));
   const std::string file_path = GetFilePath(entry.key());
-  return WriteBinaryProto(env, file_path, entry);
+  // Several processes may share the cache directory, and read an entry while
+  // another one writes it. Write the entry to a file with a unique name first,
+  // and rename it to its final name once complete, which is atomic on POSIX
+  // file systems.
+  const std::string tmp_file_path =
+      absl::StrCat(file_path, ".tmp", random::New64());
+  Status status = WriteBinaryProto(env, tmp_file_path, entry);
+  if (status.ok()) {
+    status = env->RenameFile(tmp_file_path, file_path);
+  }
+  if (!status.ok()) {
+    env->DeleteFile(tmp_file_path).IgnoreError();
+  }
+  return status;
 }
 
 template <typename ExecutableType, typename ClientType>
@@ -305,6 +305,42 @@ TEST_F(DeviceExecutionPersistorTest, PersistBuildSerializedExecutable) {
   EXPECT_EQ(entry.executable(), serialized_xla_executable_);
 }
 
+TEST_F(DeviceExecutionPersistorTest, PersistOverwritesEntryAtomically) {
+  const std::string cache_dir = io::JoinPath(cache_dir_, "atomic");
+  XlaDeviceExecutablePersistor::Config config(
+      /*persistent_cache_directory=*/cache_dir,
+      /*disable_strict_signature_checks=*/false,
+      /*persistence_prefix=*/"xla");
+  XlaDeviceExecutablePersistor persistor(config,
+                                         DefaultXlaOptions().device_type);
+
+  MockXlaCompilerClient mock_client;
+  EXPECT_CALL(mock_client, SerializeExecutable(_))
+      .WillOnce(Return(StatusOr<std::string>(serialized_xla_executable_)))
+      .WillOnce(Return(StatusOr<std::string>("another_executable")));
+
+  // A second process persisting the same entry replaces it.
+  TF_ASSERT_OK_AND_ASSIGN(auto executable, BuildSampleExecutable());
+  for (int i = 0; i < 2; ++i) {
+    TF_EXPECT_OK(persistor.TryToPersistExecutable(
+        /*signature_hash=*/123, "signature_string", DefaultXlaOptions(),
+        compilation_result_add_, *executable, &mock_client));
+  }
+
+  auto key =
+      CreateCacheKey(/*signature_hash=*/123, compilation_result_add_,
+                     persistor.device_type(), persistor.persistence_prefix());
+  TF_ASSERT_OK_AND_ASSIGN(auto entry, ReadCacheEntryFromFile(key, cache_dir));
+  EXPECT_EQ(entry.executable(), "another_executable");
+
+  // No temporary file is left behind.
+  std::vector<std::string> children;
+  TF_ASSERT_OK(Env::Default()->GetChildren(cache_dir, &children));
+  ASSERT_EQ(children.size(), 1u);
+  EXPECT_EQ(io::JoinPath(cache_dir, children[0]),
+            GetFilePath(key, cache_dir));
+}
+
 TEST_F(DeviceExecutionPersistorTest, PersistSerializeExecutableError) {
   XlaDeviceExecutablePersistor::Config config(
       /*persistent_cache_directory=*/cache_dir_,
@@ -125,6 +125,12 @@ struct XlaOpsCommonFlags {
   // If true, _XlaCompile compiles the cluster asynchronously with respect to
   // the main execution. The fallback path is taken while compilation happens.
   bool tf_xla_async_compilation;
+  // If non-empty, _XlaCompile pads the leading dimension of the inputs of the
+  // clusters that are computed row by row up to the next bucket, and _XlaRun
+  // slices the outputs back, so that one executable serves many batch sizes.
+  // Either "pow2" for powers of two, or a comma-separated list of increasing
+  // sizes. Defaults to empty.
+  std::string tf_xla_shape_buckets;
 
   class PjRtForSingleDeviceCompilationRollout {
    public:
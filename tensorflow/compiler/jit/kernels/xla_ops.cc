@@ -43,6 +43,7 @@ limitations under the License.
 #include "tensorflow/compiler/jit/xla_host_send_device_context.h"
 #include "tensorflow/compiler/jit/xla_launch_util.h"
 #include "tensorflow/compiler/jit/xla_platform_info.h"
+#include "tensorflow/compiler/jit/xla_shape_bucketing.h"
 #include "tensorflow/compiler/tf2xla/tf2xla_util.h"
 #include "tensorflow/compiler/tf2xla/xla_compiler.h"
 #include "tensorflow/compiler/tf2xla/xla_helpers.h"
@@ -124,12 +125,21 @@ class ExecutableClosure {
   }
   int num_constant_args() const { return num_constant_args_; }
 
+  // Set if the executable was compiled for inputs padded up to a shape bucket.
+  const std::optional<ShapeBucket>& shape_bucket() const {
+    return shape_bucket_;
+  }
+  void set_shape_bucket(const ShapeBucket& shape_bucket) {
+    shape_bucket_ = shape_bucket;
+  }
+
  private:
   ClientType* client_;
   ExecutableType* executable_;
   const XlaCompiler::CompilationResult* compilation_result_;
   ResourceVarsSnapshot resource_var_snapshots_;
   int num_constant_args_;
+  std::optional<ShapeBucket> shape_bucket_;
 
   TF_DISALLOW_COPY_AND_ASSIGN(ExecutableClosure);
 };
@@ -797,9 +807,23 @@ void XlaCompileOp::Compute(OpKernelContext* ctx) {
 
   std::vector<const Tensor*> inputs = InputsFromContext(ctx);
   bool cannot_compile_cluster;
+  bool can_bucket_shapes;
   {
     mutex_lock guard(cannot_compile_cluster_mu_);
     cannot_compile_cluster = cannot_compile_cluster_;
+    if (!can_bucket_shapes_.has_value()) {
+      // Padding is done by _XlaRun, which only supports clusters without
+      // compile-time constants and resource variables.
+      const FunctionDef* fdef =
+          ctx->function_library()->GetFunctionLibraryDefinition()->Find(
+              function_.name());
+      can_bucket_shapes_ =
+          GetShapeBucketsFromFlags() != nullptr &&
+          !platform_info_.is_on_xla_device() && constants_.empty() &&
+          resources_.empty() && !has_ref_vars_ && fdef != nullptr &&
+          IsRowWiseFunction(*fdef);
+    }
+    can_bucket_shapes = *can_bucket_shapes_;
   }
   DeviceCompileMode compile_mode = [&] {
     if (must_compile_) {
@@ -815,6 +839,7 @@ void XlaCompileOp::Compute(OpKernelContext* ctx) {
           ->tf_xla_use_device_api.IsEnabledInXlaCompileAndRunForDevice(
               platform_info_.device_type());
 
+  std::optional<ShapeBucket> shape_bucket;
   if (GetXlaOpsCommonFlags()->tf_xla_always_defer_compilation ||
       cannot_compile_cluster) {
     executable = nullptr;
@@ -837,9 +862,38 @@ void XlaCompileOp::Compute(OpKernelContext* ctx) {
           /*may_alias_resource_update=*/false, &kernel, &pjrt_client,
           &pjrt_executable);
     } else {
-      status = CompileToLocalExecutable(
-          ctx, function_, has_ref_vars_, platform_info_, args, compile_mode,
-          /*may_alias_resource_update=*/false, &client, &kernel, &executable);
+      if (can_bucket_shapes) {
+        std::vector<XlaCompiler::Argument> bucketed_args = args;
+        shape_bucket =
+            BucketArguments(*GetShapeBucketsFromFlags(), &bucketed_args);
+        if (shape_bucket.has_value()) {
+          status = CompileToLocalExecutable(
+              ctx, function_, has_ref_vars_, platform_info_, bucketed_args,
+              compile_mode, /*may_alias_resource_update=*/false, &client,
+              &kernel, &executable);
+          // The outputs can only be sliced back when their leading dimension
+          // is the padded one. Otherwise, fall back to compiling for the exact
+          // shapes from now on.
+          if (!status.ok() ||
+              (kernel != nullptr &&
+               !OutputsAreRowWise(*kernel, shape_bucket->padded_size))) {
+            VLOG(1) << "Disabling shape bucketing for " << function_.name()
+                    << ": " << status;
+            {
+              mutex_lock guard(cannot_compile_cluster_mu_);
+              can_bucket_shapes_ = false;
+            }
+            shape_bucket.reset();
+            kernel = nullptr;
+            executable = nullptr;
+          }
+        }
+      }
+      if (!shape_bucket.has_value()) {
+        status = CompileToLocalExecutable(
+            ctx, function_, has_ref_vars_, platform_info_, args, compile_mode,
+            /*may_alias_resource_update=*/false, &client, &kernel, &executable);
+      }
     }
     if (compile_mode != DeviceCompileMode::kLazy ||
         status.code() != error::UNIMPLEMENTED) {
@@ -889,10 +943,14 @@ void XlaCompileOp::Compute(OpKernelContext* ctx) {
     compilation_key.flat<tstring>()(0) = key;
     VLOG(2) << "Compiled with PJRT. compilation_key: " << key;
   } else {
+    XlaExecutableClosure closure(client, executable, kernel,
+                                 std::move(variables_snapshot),
+                                 constants_.size());
+    if (shape_bucket.has_value()) {
+      closure.set_shape_bucket(*shape_bucket);
+    }
     XlaExecutableClosureStore::KeyT key =
-        XlaExecutableClosureStore::Global()->Produce(XlaExecutableClosure(
-            client, executable, kernel, std::move(variables_snapshot),
-            constants_.size()));
+        XlaExecutableClosureStore::Global()->Produce(std::move(closure));
     compilation_key.flat<tstring>()(0) = key;
     VLOG(2) << "Compiled with XLA. compilation_key: " << key;
   }
@@ -926,6 +984,8 @@ void XlaRunOp::Compute(OpKernelContext* ctx) {
       closure.executable()->executable()->module().input_output_alias_config();
   StatusOr<std::vector<xla::ExecutionInput>> execution_inputs;
   std::map<int, const Tensor*> snapshot_ptrs;
+  std::vector<Tensor> padded_inputs;
+  std::map<int, const Tensor*> padded_input_ptrs;
   {
     tensorflow::profiler::TraceMe hlo_module_activity(
         [&] {
@@ -941,10 +1001,22 @@ void XlaRunOp::Compute(OpKernelContext* ctx) {
                                                 ? &variable_tensor.value()
                                                 : nullptr);
     }
+    if (closure.shape_bucket().has_value()) {
+      // Bucketed clusters have neither constant nor resource inputs, so every
+      // input but the compilation key is padded.
+      padded_inputs.resize(ctx->num_inputs() - 1);
+      for (int i = 0, end = padded_inputs.size(); i < end; ++i) {
+        OP_REQUIRES_OK(ctx, PadLeadingDimension(
+                                ctx, ctx->input(i),
+                                closure.shape_bucket()->padded_size,
+                                &padded_inputs[i]));
+        padded_input_ptrs.emplace(i, &padded_inputs[i]);
+      }
+    }
     execution_inputs = launch_context.PopulateInputs(
         ctx, closure.compilation_result(), snapshot_ptrs,
         /*missing_ctx_input_prefix=*/closure.num_constant_args(),
-        input_output_alias);
+        input_output_alias, padded_input_ptrs);
     OP_REQUIRES_OK(ctx, execution_inputs.status());
   }
 
@@ -970,6 +1042,14 @@ void XlaRunOp::Compute(OpKernelContext* ctx) {
           ctx, closure.compilation_result(), execution_output->ConsumeResult(),
           /*missing_ctx_input_prefix=*/closure.num_constant_args(),
           absl::MakeSpan(*variable_infos), input_output_alias, snapshot_ptrs));
+
+  // Drop the rows computed from the padding.
+  if (closure.shape_bucket().has_value()) {
+    for (int i = 0; i < ctx->num_outputs(); ++i) {
+      Tensor* output = ctx->mutable_output(i);
+      *output = output->Slice(0, closure.shape_bucket()->size);
+    }
+  }
 }
 
 XlaMergeOp::XlaMergeOp(OpKernelConstruction* ctx) : OpKernel(ctx) {}
@@ -17,6 +17,7 @@ limitations under the License.
 #define TENSORFLOW_COMPILER_JIT_KERNELS_XLA_OPS_H_
 
 #include <atomic>
+#include <optional>
 
 #include "tensorflow/compiler/jit/device_compiler.h"
 #include "tensorflow/compiler/jit/xla_device.h"
@@ -114,6 +115,12 @@ class XlaCompileOp : public OpKernel {
   bool cannot_compile_cluster_ TF_GUARDED_BY(cannot_compile_cluster_mu_) =
       false;
 
+  // Whether the inputs of the cluster may be padded up to the shape buckets
+  // configured with --tf_xla_shape_buckets. Unset until the first call to
+  // _XlaCompile, and set to false if a bucketed compilation fails.
+  std::optional<bool> can_bucket_shapes_
+      TF_GUARDED_BY(cannot_compile_cluster_mu_);
+
   mutex cannot_compile_cluster_mu_;
 };
 
@@ -144,7 +144,32 @@ void PjRtDeviceContext::CopyTensorInSameDevice(const Tensor* input_tensor,
                                                Device* device,
                                                Tensor* output_tensor,
                                                StatusCallback done) const {
-  done(errors::Unimplemented("Same-device copies not implemented."));
+  profiler::TraceMe traceme("PjRtDeviceContext::CopyTensorInSameDevice");
+  if (input_tensor->NumElements() == 0) {
+    VLOG(2) << "CopyTensorInSameDevice empty tensor";
+    done(OkStatus());
+    return;
+  }
+  AsyncValueTensor* input_av_tensor =
+      tensorflow::AsyncValueTensor::FromTensor(input_tensor);
+  AsyncValueTensor* output_av_tensor =
+      tensorflow::AsyncValueTensor::FromTensor(output_tensor);
+  if (input_av_tensor == nullptr || output_av_tensor == nullptr ||
+      input_av_tensor->GetBuffer() == nullptr) {
+    done(errors::Unimplemented(
+        "Same-device copies are only implemented for tensors backed by PjRt "
+        "buffers."));
+    return;
+  }
+  // The output tensor should be newly allocated, which does not point to a
+  // valid buffer yet.
+  CHECK(!output_av_tensor->GetBuffer());  // Crash OK
+  // PjRt buffers are immutable, so the copy shares the device memory of the
+  // input. The buffer is freed when the last tensor referring to it is, and is
+  // not donated to an executable while it is shared (see
+  // PreparePjRtExecutableArguments).
+  output_av_tensor->SetBuffer(input_av_tensor->GetBuffer());
+  done(OkStatus());
 }
 
 }  // namespace tensorflow
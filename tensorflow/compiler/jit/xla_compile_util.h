@@ -26,6 +26,13 @@ namespace tensorflow {
 // The number of compiler threads to use for asynchronous device compilation.
 inline constexpr int64_t kNumAsyncDeviceCompilerThreads = 10;
 
+// The maximum number of asynchronous device compilations that are either
+// running or waiting for a compiler thread. Further requests are rejected, and
+// the clusters keep running through the fallback path until they are requested
+// again.
+inline constexpr int64_t kMaxNumOngoingAsyncDeviceCompilations =
+    4 * kNumAsyncDeviceCompilerThreads;
+
 enum class DeviceCompileMode {
   kLazy,
   kStrict,
@@ -137,7 +137,8 @@ XlaComputationLaunchContext::PopulateInputs(
     const XlaCompiler::CompilationResult* compilation_result,
     const std::map<int, const Tensor*>& resource_vars,
     int missing_ctx_input_prefix,
-    const xla::HloInputOutputAliasConfig& input_output_alias) {
+    const xla::HloInputOutputAliasConfig& input_output_alias,
+    const std::map<int, const Tensor*>& input_overrides) {
   std::vector<xla::ExecutionInput> arguments;
   arguments.reserve(compilation_result->xla_input_shapes.size());
 
@@ -160,8 +161,10 @@ XlaComputationLaunchContext::PopulateInputs(
                                 update.modified;
                        });
 
-    const Tensor* t = is_resource_variable
-                          ? resource_vars.at(arg_num)
+    auto override_it = input_overrides.find(arg_num);
+    const Tensor* t = is_resource_variable ? resource_vars.at(arg_num)
+                      : override_it != input_overrides.end()
+                          ? override_it->second
                           : &(ctx->input(arg_num - missing_ctx_input_prefix));
     CHECK(t);
     bool donate_buffer =
@@ -602,17 +605,22 @@ void PreparePjRtExecutableArguments(
     } else {
       tensor = inputs[arg_num];
     }
-    if (!tensor->RefCountIsOne()) {
+    AsyncValueTensor* av_tensor = AsyncValueTensor::FromTensor(tensor);
+    std::shared_ptr<xla::PjRtBuffer> buffer = av_tensor->GetBuffer();
+    // A buffer can only be donated if no other tensor refers to it, either
+    // through the same tensor buffer or through a same-device copy that
+    // shares the PjRtBuffer. Besides `buffer`, the tensor itself holds one
+    // reference to the PjRtBuffer.
+    if (!tensor->RefCountIsOne() || buffer.use_count() > 2) {
       non_donatable_input_indices->insert(arg_num);
     }
 
-    AsyncValueTensor* av_tensor = AsyncValueTensor::FromTensor(tensor);
-    if (av_tensor->GetBuffer() == nullptr) {
+    if (buffer == nullptr) {
       // TODO(b/260799971): verify size 0 argument is supported.
       CHECK_EQ(tensor->NumElements(), 0);  // Crash OK
       continue;
     }
-    args->push_back(av_tensor->GetBuffer().get());
+    args->push_back(buffer.get());
   }
 }
 
@@ -61,7 +61,8 @@ Status SetOutputForConstant(
 //
 // The obtained PjRtBuffers are populated to `args` vector.
 // `non_donatable_input_indices` will also be set, which contains the indices of
-// the input that should not be donated to output.
+// the input that should not be donated to output, because the tensor buffer or
+// the PjRtBuffer of the input is shared with other tensors.
 void PreparePjRtExecutableArguments(
     const std::vector<int>& input_mapping,
     const std::vector<const Tensor*>& inputs,
@@ -132,12 +133,16 @@ class XlaComputationLaunchContext {
   // missing and adjusts input indices accordingly.  All elements in kernel's
   // input_mapping must be greater than or equal to `missing_ctx_input_prefix`
   // (in other words, no inputs actually required by the kernel can be missing).
+  //
+  // `input_overrides` is a map from TensorFlow argument number to the tensor
+  // passed instead of the corresponding input of `ctx`, e.g. a padded copy.
   StatusOr<std::vector<xla::ExecutionInput>> PopulateInputs(
       OpKernelContext* ctx,
       const XlaCompiler::CompilationResult* compilation_result,
       const std::map<int, const Tensor*>& resource_vars,
       int missing_ctx_input_prefix,
-      const xla::HloInputOutputAliasConfig& input_output_alias);
+      const xla::HloInputOutputAliasConfig& input_output_alias,
+      const std::map<int, const Tensor*>& input_overrides = {});
 
   // Given the XLA output in `output`, populate all outputs of `ctx`.  Also
   // writes out the resource variable updates.
@@ -39,7 +39,9 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/platform/notification.h"
 #include "tensorflow/core/platform/refcount.h"
+#include "tensorflow/core/tfrt/common/async_value_tensor.h"
 #include "tensorflow/core/tfrt/common/create_pjrt_client_util.h"
 #include "tensorflow/core/tfrt/common/pjrt_util.h"
 #include "tensorflow/tsl/framework/allocator.h"
@@ -271,6 +273,43 @@ TEST_F(PjRtExecutionUtilTest, PreparePjRtExecutableArguments) {
       *literal2, xla::LiteralUtil::CreateR2<int32_t>({{4, 5, 6}})));
 }
 
+TEST_F(PjRtExecutionUtilTest,
+       PreparePjRtExecutableArgumentsSharedBuffersAreNotDonatable) {
+  std::vector<const Tensor*> inputs;
+  inputs.push_back(CreateDeviceTensor<int32_t>(TensorShape({1, 3}), {1, 2, 3}));
+  inputs.push_back(CreateDeviceTensor<int32_t>(TensorShape({1, 3}), {4, 5, 6}));
+  // A same-device copy of the first input shares its PjRtBuffer.
+  Tensor* copy = new Tensor(device_allocator_, DT_INT32, inputs[0]->shape());
+  tensors_.push_back(copy);
+  Notification done;
+  Status copy_status;
+  device_context_->CopyTensorInSameDevice(inputs[0], device_, copy,
+                                          [&](const Status& status) {
+                                            copy_status = status;
+                                            done.Notify();
+                                          });
+  done.WaitForNotification();
+  TF_ASSERT_OK(copy_status);
+  EXPECT_EQ(AsyncValueTensor::FromTensor(copy)->GetBuffer(),
+            AsyncValueTensor::FromTensor(inputs[0])->GetBuffer());
+  inputs.push_back(copy);
+  std::vector<int> input_mapping{0, 1, 2};
+
+  std::vector<xla::PjRtBuffer*> exec_args;
+  exec_args.reserve(input_mapping.size());
+  absl::flat_hash_set<int> non_donatable_input_indices;
+  PreparePjRtExecutableArguments(input_mapping, inputs, {}, &exec_args,
+                                 &non_donatable_input_indices);
+
+  EXPECT_EQ(exec_args.size(), 3);
+  EXPECT_EQ(exec_args[0], exec_args[2]);
+  EXPECT_EQ(non_donatable_input_indices, absl::flat_hash_set<int>({0, 2}));
+
+  std::shared_ptr<xla::Literal> literal = *exec_args[2]->ToLiteralSync();
+  EXPECT_TRUE(xla::LiteralTestUtil::Equal(
+      *literal, xla::LiteralUtil::CreateR2<int32_t>({{1, 2, 3}})));
+}
+
 TEST_F(PjRtExecutionUtilTest, PreparePjRtExecutableArgumentsVariableInputs) {
   std::vector<VariableInfo> variables;
   Var* var1 = CreateVariable<int32>("v1", TensorShape({1, 2}), {1, 2});
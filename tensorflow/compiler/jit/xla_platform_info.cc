@@ -22,6 +22,8 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_replace.h"
 #include "tensorflow/compiler/jit/device_executable_persistor.h"
 #include "tensorflow/compiler/jit/flags.h"
 #include "tensorflow/compiler/jit/pjrt_device_compiler_client.h"
@@ -31,6 +33,7 @@ limitations under the License.
 #include "tensorflow/compiler/xla/client/local_client.h"
 #include "tensorflow/compiler/xla/pjrt/pjrt_client.h"
 #include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/platform/stream_executor_no_cuda.h"
 #include "tensorflow/core/tfrt/common/create_pjrt_client_util.h"
 #include "tensorflow/core/tfrt/common/global_state.h"
 #include "tensorflow/core/tfrt/common/pjrt_util.h"
@@ -231,6 +234,24 @@ Status BuildXlaDeviceCompiler(DeviceBase* device, FunctionLibraryRuntime* flr,
                                    platform_info.device_type().type());
   }
 
+  // HSA code objects only load on the AMDGPU target they were compiled for, so
+  // keep persisted entries of different targets apart when several hosts share
+  // a persistent cache directory.
+  if (const auto* accelerator_device_info =
+          device->tensorflow_accelerator_device_info();
+      accelerator_device_info != nullptr &&
+      accelerator_device_info->stream != nullptr &&
+      accelerator_device_info->stream->parent()->platform_kind() ==
+          se::PlatformKind::kROCm) {
+    std::string gcn_arch_name = accelerator_device_info->stream->parent()
+                                    ->GetDeviceDescription()
+                                    .rocm_compute_capability()
+                                    .gcn_arch_name();
+    persistor_config.persistence_prefix =
+        absl::StrCat(persistor_config.persistence_prefix, "_",
+                     absl::StrReplaceAll(gcn_arch_name, {{":", "_"}}));
+  }
+
   *xla_device_compiler = CreateXlaDeviceCompiler(
       persistor_config, DeviceType(registration->compilation_device_name),
       client.value());
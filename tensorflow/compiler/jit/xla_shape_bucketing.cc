@@ -0,0 +1,274 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/jit/xla_shape_bucketing.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <variant>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_split.h"
+#include "tensorflow/compiler/jit/flags.h"
+#include "tensorflow/compiler/xla/status_macros.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/stream_executor_no_cuda.h"
+
+namespace tensorflow {
+namespace {
+
+// Ops that compute each row of their outputs from the same row of their
+// inputs. Broadcasting a constant along the leading dimension is fine, and so
+// is contracting the other dimensions, as long as the leading dimension of the
+// result comes from the leading dimension of the inputs (see `IsRowWiseNode`).
+const absl::flat_hash_set<std::string>& RowWiseOps() {
+  static const auto* ops = new absl::flat_hash_set<std::string>({
+      "Abs",
+      "Add",
+      "AddV2",
+      "BiasAdd",
+      "Cast",
+      "Ceil",
+      "Const",
+      "Cos",
+      "Div",
+      "DivNoNan",
+      "Elu",
+      "Equal",
+      "Erf",
+      "Exp",
+      "Floor",
+      "Greater",
+      "GreaterEqual",
+      "Identity",
+      "LeakyRelu",
+      "Less",
+      "LessEqual",
+      "Log",
+      "Log1p",
+      "LogSoftmax",
+      "LogicalAnd",
+      "LogicalNot",
+      "LogicalOr",
+      "MatMul",
+      "Maximum",
+      "Minimum",
+      "Mul",
+      "Neg",
+      "NotEqual",
+      "Pow",
+      "RealDiv",
+      "Reciprocal",
+      "Relu",
+      "Relu6",
+      "Round",
+      "Rsqrt",
+      "Select",
+      "SelectV2",
+      "Selu",
+      "Sigmoid",
+      "Sign",
+      "Sin",
+      "Softmax",
+      "Softplus",
+      "Sqrt",
+      "Square",
+      "SquaredDifference",
+      "Sub",
+      "Tanh",
+  });
+  return *ops;
+}
+
+bool IsRowWiseNode(const NodeDef& node) {
+  if (!RowWiseOps().contains(node.op())) {
+    return false;
+  }
+  if (node.op() == "MatMul") {
+    // Transposing the left-hand side contracts its leading dimension, and
+    // transposing the right-hand side moves it to the columns of the result.
+    for (const char* attr : {"transpose_a", "transpose_b"}) {
+      auto it = node.attr().find(attr);
+      if (it != node.attr().end() && it->second.b()) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+StatusOr<ShapeBuckets> ShapeBuckets::Parse(absl::string_view spec) {
+  ShapeBuckets buckets;
+  if (spec == "pow2") {
+    buckets.powers_of_two_ = true;
+    return buckets;
+  }
+  for (absl::string_view size_str : absl::StrSplit(spec, ',')) {
+    int64_t size;
+    if (!absl::SimpleAtoi(size_str, &size) || size <= 0) {
+      return errors::InvalidArgument("Invalid shape bucket '", size_str,
+                                     "' in '", spec, "'");
+    }
+    if (!buckets.sizes_.empty() && size <= buckets.sizes_.back()) {
+      return errors::InvalidArgument("Shape buckets must be increasing: '",
+                                     spec, "'");
+    }
+    buckets.sizes_.push_back(size);
+  }
+  return buckets;
+}
+
+int64_t ShapeBuckets::Bucket(int64_t size) const {
+  if (powers_of_two_) {
+    if (size > std::numeric_limits<int64_t>::max() / 2) {
+      return size;
+    }
+    int64_t bucket = 1;
+    while (bucket < size) {
+      bucket <<= 1;
+    }
+    return bucket;
+  }
+  auto it = std::lower_bound(sizes_.begin(), sizes_.end(), size);
+  return it == sizes_.end() ? size : *it;
+}
+
+const ShapeBuckets* GetShapeBucketsFromFlags() {
+  static const ShapeBuckets* buckets = []() -> const ShapeBuckets* {
+    const std::string& spec = GetXlaOpsCommonFlags()->tf_xla_shape_buckets;
+    if (spec.empty()) {
+      return nullptr;
+    }
+    StatusOr<ShapeBuckets> parsed = ShapeBuckets::Parse(spec);
+    if (!parsed.ok()) {
+      LOG(ERROR) << "Ignoring --tf_xla_shape_buckets: " << parsed.status();
+      return nullptr;
+    }
+    return new ShapeBuckets(*std::move(parsed));
+  }();
+  return buckets;
+}
+
+bool IsRowWiseFunction(const FunctionDef& fdef) {
+  return std::all_of(fdef.node_def().begin(), fdef.node_def().end(),
+                     IsRowWiseNode);
+}
+
+std::optional<ShapeBucket> BucketArguments(const ShapeBuckets& buckets,
+                                           std::vector<XlaArgument>* args) {
+  if (args->empty()) {
+    return std::nullopt;
+  }
+  std::optional<int64_t> size;
+  for (const XlaArgument& arg : *args) {
+    if (arg.kind != XlaArgument::kParameter ||
+        !std::holds_alternative<TensorShape>(arg.shape) ||
+        !DataTypeCanUseMemcpy(arg.type)) {
+      return std::nullopt;
+    }
+    const TensorShape& shape = std::get<TensorShape>(arg.shape);
+    if (shape.dims() < 2 || shape.dim_size(0) == 0 ||
+        (size.has_value() && shape.dim_size(0) != *size)) {
+      return std::nullopt;
+    }
+    size = shape.dim_size(0);
+  }
+
+  ShapeBucket bucket{*size, buckets.Bucket(*size)};
+  if (bucket.padded_size == bucket.size) {
+    return std::nullopt;
+  }
+  // The outputs are sliced along the dimensions of the padded size, which must
+  // therefore only appear as the leading dimension.
+  for (const XlaArgument& arg : *args) {
+    const TensorShape& shape = std::get<TensorShape>(arg.shape);
+    for (int d = 1; d < shape.dims(); ++d) {
+      if (shape.dim_size(d) == bucket.padded_size) {
+        return std::nullopt;
+      }
+    }
+  }
+
+  for (XlaArgument& arg : *args) {
+    std::get<TensorShape>(arg.shape).set_dim(0, bucket.padded_size);
+  }
+  return bucket;
+}
+
+bool OutputsAreRowWise(const XlaCompilationResult& result,
+                       int64_t padded_size) {
+  if (!result.resource_updates.empty()) {
+    return false;
+  }
+  for (const XlaOutputDescription& output : result.outputs) {
+    if (output.is_constant || output.type == DT_RESOURCE ||
+        output.is_tensor_list || output.shape.dims() == 0 ||
+        output.shape.dim_size(0) != padded_size) {
+      return false;
+    }
+    for (int d = 1; d < output.shape.dims(); ++d) {
+      if (output.shape.dim_size(d) == padded_size) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+Status PadLeadingDimension(OpKernelContext* ctx, const Tensor& input,
+                           int64_t padded_size, Tensor* padded) {
+  TensorShape padded_shape = input.shape();
+  TF_RET_CHECK(padded_shape.dims() > 0 &&
+               padded_shape.dim_size(0) <= padded_size);
+  padded_shape.set_dim(0, padded_size);
+  TF_RETURN_IF_ERROR(
+      ctx->allocate_temp(input.dtype(), padded_shape, padded));
+
+  const uint64_t size = input.TotalBytes();
+  const uint64_t padding = padded->TotalBytes() - size;
+  se::Stream* stream =
+      ctx->op_device_context() ? ctx->op_device_context()->stream() : nullptr;
+  if (stream == nullptr) {
+    char* data = static_cast<char*>(padded->data());
+    std::memcpy(data, input.data(), size);
+    std::memset(data + size, 0, padding);
+    return OkStatus();
+  }
+
+  se::DeviceMemoryBase padded_mem(padded->data(), padded->TotalBytes());
+  if (size > 0) {
+    se::DeviceMemoryBase input_mem(input.data(), size);
+    stream->ThenMemcpyD2D(&padded_mem, input_mem, size);
+  }
+  if (padding > 0) {
+    se::DeviceMemoryBase padding_mem(
+        static_cast<char*>(padded->data()) + size, padding);
+    stream->ThenMemZero(&padding_mem, padding);
+  }
+  if (!stream->ok()) {
+    return errors::Internal("Failed to pad the inputs of the computation");
+  }
+  return OkStatus();
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,97 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_COMPILER_JIT_XLA_SHAPE_BUCKETING_H_
+#define TENSORFLOW_COMPILER_JIT_XLA_SHAPE_BUCKETING_H_
+
+#include <optional>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "tensorflow/compiler/tf2xla/xla_argument.h"
+#include "tensorflow/compiler/tf2xla/xla_helpers.h"
+#include "tensorflow/core/framework/function.pb.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/platform/statusor.h"
+
+namespace tensorflow {
+
+// Shape bucketing lets a single executable serve the executions of an
+// auto-clustered computation that only differ by the size of the leading
+// (batch) dimension of their inputs: _XlaCompile compiles the cluster for the
+// inputs padded with zeros up to the next bucket, and _XlaRun slices the padded
+// rows off the outputs. This is only sound for the clusters that compute every
+// row of their outputs from the same row of their inputs, see
+// `IsRowWiseFunction`.
+
+// The sizes that the leading dimension is padded to.
+class ShapeBuckets {
+ public:
+  // Parses `spec`, which is either "pow2" for powers of two, or a
+  // comma-separated list of strictly increasing positive sizes.
+  static StatusOr<ShapeBuckets> Parse(absl::string_view spec);
+
+  // Returns the smallest bucket that is at least `size`, or `size` if it is
+  // larger than all the buckets.
+  int64_t Bucket(int64_t size) const;
+
+ private:
+  ShapeBuckets() = default;
+
+  bool powers_of_two_ = false;
+  std::vector<int64_t> sizes_;
+};
+
+// Returns the buckets configured with --tf_xla_shape_buckets, or nullptr if
+// shape bucketing is disabled or the flag is invalid.
+const ShapeBuckets* GetShapeBucketsFromFlags();
+
+// The size of the leading dimension of the inputs of a bucketed execution,
+// before and after padding.
+struct ShapeBucket {
+  int64_t size;
+  int64_t padded_size;
+};
+
+// Returns true if `fdef` only contains ops that compute each row of their
+// outputs from the same row of their inputs, so that the padded rows of the
+// inputs don't leak into the other rows of the outputs.
+bool IsRowWiseFunction(const FunctionDef& fdef);
+
+// Pads the leading dimension of `args` up to the bucket of their common size,
+// and returns the sizes before and after padding. Returns std::nullopt and
+// leaves `args` unchanged if they can't be bucketed: some of them are not
+// parameters of rank 2 or more, their leading dimensions differ, or they
+// already fill their bucket.
+std::optional<ShapeBucket> BucketArguments(const ShapeBuckets& buckets,
+                                           std::vector<XlaArgument>* args);
+
+// Returns true if all the outputs of `result` are tensors whose leading
+// dimension, and only that one, is `padded_size`, and the computation doesn't
+// update any resource variable, so that slicing the outputs recovers the
+// outputs of the computation on the unpadded inputs.
+bool OutputsAreRowWise(const XlaCompilationResult& result,
+                       int64_t padded_size);
+
+// Allocates `padded` and fills it with a copy of `input` followed by zeros, up
+// to `padded_size` rows. The copy is enqueued on the stream of `ctx` if any.
+Status PadLeadingDimension(OpKernelContext* ctx, const Tensor& input,
+                           int64_t padded_size, Tensor* padded);
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_COMPILER_JIT_XLA_SHAPE_BUCKETING_H_
@@ -0,0 +1,111 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/compiler/jit/xla_shape_bucketing.h"
+
+#include <optional>
+#include <variant>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "tensorflow/core/framework/function_testlib.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+
+namespace tensorflow {
+namespace {
+
+XlaArgument Parameter(const TensorShape& shape) {
+  XlaArgument arg;
+  arg.kind = XlaArgument::kParameter;
+  arg.type = DT_FLOAT;
+  arg.shape = shape;
+  return arg;
+}
+
+TEST(ShapeBucketsTest, PowersOfTwo) {
+  TF_ASSERT_OK_AND_ASSIGN(ShapeBuckets buckets, ShapeBuckets::Parse("pow2"));
+  EXPECT_EQ(buckets.Bucket(1), 1);
+  EXPECT_EQ(buckets.Bucket(5), 8);
+  EXPECT_EQ(buckets.Bucket(64), 64);
+  EXPECT_EQ(buckets.Bucket(65), 128);
+}
+
+TEST(ShapeBucketsTest, List) {
+  TF_ASSERT_OK_AND_ASSIGN(ShapeBuckets buckets,
+                          ShapeBuckets::Parse("16,128,512"));
+  EXPECT_EQ(buckets.Bucket(3), 16);
+  EXPECT_EQ(buckets.Bucket(128), 128);
+  EXPECT_EQ(buckets.Bucket(129), 512);
+  EXPECT_EQ(buckets.Bucket(1000), 1000);
+}
+
+TEST(ShapeBucketsTest, InvalidSpec) {
+  EXPECT_FALSE(ShapeBuckets::Parse("16,8").ok());
+  EXPECT_FALSE(ShapeBuckets::Parse("0,8").ok());
+  EXPECT_FALSE(ShapeBuckets::Parse("pow3").ok());
+}
+
+TEST(ShapeBucketingTest, RowWiseFunction) {
+  EXPECT_TRUE(IsRowWiseFunction(test::function::XTimesTwo()));
+  // The bodies of the functions that are called are not inspected.
+  EXPECT_FALSE(IsRowWiseFunction(test::function::XTimes16()));
+}
+
+TEST(ShapeBucketingTest, BucketArguments) {
+  TF_ASSERT_OK_AND_ASSIGN(ShapeBuckets buckets, ShapeBuckets::Parse("pow2"));
+  std::vector<XlaArgument> args = {Parameter(TensorShape({5, 3})),
+                                   Parameter(TensorShape({5, 7}))};
+  std::optional<ShapeBucket> bucket = BucketArguments(buckets, &args);
+  ASSERT_TRUE(bucket.has_value());
+  EXPECT_EQ(bucket->size, 5);
+  EXPECT_EQ(bucket->padded_size, 8);
+  EXPECT_EQ(std::get<TensorShape>(args[0].shape), TensorShape({8, 3}));
+  EXPECT_EQ(std::get<TensorShape>(args[1].shape), TensorShape({8, 7}));
+}
+
+TEST(ShapeBucketingTest, BucketArgumentsRejectsMismatchedShapes) {
+  TF_ASSERT_OK_AND_ASSIGN(ShapeBuckets buckets, ShapeBuckets::Parse("pow2"));
+  std::vector<XlaArgument> different_sizes = {Parameter(TensorShape({5, 3})),
+                                              Parameter(TensorShape({6, 3}))};
+  EXPECT_FALSE(BucketArguments(buckets, &different_sizes).has_value());
+  EXPECT_EQ(std::get<TensorShape>(different_sizes[0].shape),
+            TensorShape({5, 3}));
+
+  std::vector<XlaArgument> vector = {Parameter(TensorShape({5}))};
+  EXPECT_FALSE(BucketArguments(buckets, &vector).has_value());
+
+  std::vector<XlaArgument> ambiguous = {Parameter(TensorShape({5, 8}))};
+  EXPECT_FALSE(BucketArguments(buckets, &ambiguous).has_value());
+
+  std::vector<XlaArgument> full = {Parameter(TensorShape({4, 3}))};
+  EXPECT_FALSE(BucketArguments(buckets, &full).has_value());
+}
+
+TEST(ShapeBucketingTest, OutputsAreRowWise) {
+  XlaCompilationResult result;
+  result.outputs.resize(1);
+  result.outputs[0].type = DT_FLOAT;
+  result.outputs[0].shape = TensorShape({8, 3});
+  EXPECT_TRUE(OutputsAreRowWise(result, 8));
+
+  result.outputs[0].shape = TensorShape({8, 8});
+  EXPECT_FALSE(OutputsAreRowWise(result, 8));
+
+  result.outputs[0].shape = TensorShape({3});
+  EXPECT_FALSE(OutputsAreRowWise(result, 8));
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -21,8 +21,10 @@ limitations under the License.
 //===----------------------------------------------------------------------===//
 #include "tensorflow/compiler/mlir/tools/kernel_gen/kernel_creator.h"
 
+#include <algorithm>
 #include <string>
 
+#include "llvm/ADT/StringMap.h"  // from @llvm-project
 #include "mlir/Conversion/AffineToStandard/AffineToStandard.h"  // from @llvm-project
 #include "mlir/Conversion/ComplexToStandard/ComplexToStandard.h"  // from @llvm-project
 #include "mlir/Conversion/FuncToLLVM/ConvertFuncToLLVMPass.h"  // from @llvm-project
@@ -43,6 +45,7 @@ limitations under the License.
 #include "mlir/Dialect/Linalg/Transforms/Transforms.h"  // from @llvm-project
 #include "mlir/Dialect/MemRef/Transforms/Passes.h"  // from @llvm-project
 #include "mlir/Dialect/SCF/Transforms/Passes.h"  // from @llvm-project
+#include "mlir/IR/Matchers.h"  // from @llvm-project
 #include "mlir/Parser/Parser.h"  // from @llvm-project
 #include "mlir/Pass/Pass.h"  // from @llvm-project
 #include "mlir/Pass/PassManager.h"  // from @llvm-project
@@ -109,6 +112,51 @@ bool IsSmallAlloc(Value alloc) {
   return type.getNumElements() * bitwidth <= kMaximumSizeInBytes * 8;
 }
 
+#if TENSORFLOW_USE_ROCM
+/// Sets the maximum work group size of each ROCm kernel to the block size it is
+/// launched with. The bound lets the backend give each thread more registers
+/// than a work group of 1024 threads allows. Kernels that are launched with a
+/// dynamic block size keep the bound of 1024.
+void SetRocdlMaxFlatWorkGroupSizes(mlir::ModuleOp module) {
+  constexpr int64_t kMaxFlatWorkGroupSize = 1024;
+  llvm::StringMap<int64_t> block_sizes;
+  module.walk([&](mlir::gpu::LaunchFuncOp launch) {
+    int64_t block_size = 1;
+    for (Value dim : {launch.getBlockSizeX(), launch.getBlockSizeY(),
+                      launch.getBlockSizeZ()}) {
+      llvm::APInt value;
+      if (!mlir::matchPattern(dim, mlir::m_ConstantInt(&value))) {
+        block_size = kMaxFlatWorkGroupSize;
+        break;
+      }
+      block_size *= value.getSExtValue();
+    }
+    std::string kernel = (launch.getKernelModuleName().getValue() + "::" +
+                          launch.getKernelName().getValue())
+                             .str();
+    auto it = block_sizes.try_emplace(kernel, block_size).first;
+    it->second = std::max(it->second, block_size);
+  });
+
+  for (auto gpu_module : module.getOps<mlir::gpu::GPUModuleOp>()) {
+    gpu_module.walk([&](mlir::gpu::GPUFuncOp gpu_kernel) {
+      if (!gpu_kernel.isKernel()) return;
+      std::string kernel =
+          (gpu_module.getName() + "::" + gpu_kernel.getName()).str();
+      auto it = block_sizes.find(kernel);
+      int64_t block_size = it == block_sizes.end()
+                               ? kMaxFlatWorkGroupSize
+                               : std::clamp<int64_t>(it->second, 1,
+                                                     kMaxFlatWorkGroupSize);
+      gpu_kernel->setAttr(
+          "rocdl.max_flat_work_group_size",
+          mlir::IntegerAttr::get(
+              mlir::IntegerType::get(module.getContext(), 32), block_size));
+    });
+  }
+}
+#endif
+
 Status LowerTFToJITInvocation(mlir::ModuleOp module,
                               llvm::ArrayRef<int64_t> tile_sizes,
                               llvm::ArrayRef<int64_t> unroll_factors,
@@ -316,17 +364,7 @@ Status LowerKernelBodiesToLowLevelIr(mlir::ModuleOp module,
 #endif
 
 #if TENSORFLOW_USE_ROCM
-  auto gpu_modules = module.getOps<::mlir::gpu::GPUModuleOp>();
-  for (::mlir::gpu::GPUModuleOp gpu_module : gpu_modules) {
-    gpu_module.walk([&](mlir::gpu::GPUFuncOp gpu_kernel) {
-      if (gpu_kernel.isKernel()) {
-        gpu_kernel->setAttr(
-            "rocdl.max_flat_work_group_size",
-            mlir::IntegerAttr::get(
-                mlir::IntegerType::get(module.getContext(), 32), 1024));
-      }
-    });
-  }
+  SetRocdlMaxFlatWorkGroupSizes(module);
 #endif
 
   mlir::PassManager pm(module.getContext());
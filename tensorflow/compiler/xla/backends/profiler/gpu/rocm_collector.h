@@ -0,0 +1,38 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_COMPILER_XLA_BACKENDS_PROFILER_GPU_ROCM_COLLECTOR_H_
+#define TENSORFLOW_COMPILER_XLA_BACKENDS_PROFILER_GPU_ROCM_COLLECTOR_H_
+
+#include <cstdint>
+#include <memory>
+
+#include "tensorflow/compiler/xla/backends/profiler/gpu/rocm_tracer.h"
+
+namespace xla {
+namespace profiler {
+
+// Creates the default RocmTraceCollector. The collector correlates the HIP API
+// callbacks with the roctracer activity records of the kernel, memcpy and
+// memset operations they launched, and exports them as one XPlane per GPU plus
+// a host plane for the HIP API calls.
+std::unique_ptr<RocmTraceCollector> CreateRocmCollector(
+    const RocmTraceCollectorOptions& options, uint64_t start_walltime_ns,
+    uint64_t start_gputime_ns);
+
+}  // namespace profiler
+}  // namespace xla
+
+#endif  // TENSORFLOW_COMPILER_XLA_BACKENDS_PROFILER_GPU_ROCM_COLLECTOR_H_
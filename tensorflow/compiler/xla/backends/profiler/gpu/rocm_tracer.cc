@@ -1515,7 +1515,7 @@ tsl::Status RocmTracer::EnableActivityTracing() {
     // Create the memory pool to store activity records in
     if (se::wrap::roctracer_default_pool_expl(nullptr) == NULL) {
       roctracer_properties_t properties{};
-      properties.buffer_size = 0x1000;
+      properties.buffer_size = options_->activity_buffer_size;
       properties.buffer_callback_fun = ActivityCallback;
       properties.buffer_callback_arg = this;
       VLOG(3) << "Creating roctracer activity buffer";
@@ -26,6 +26,7 @@ limitations under the License.
 #include "tensorflow/tsl/platform/macros.h"
 #include "tensorflow/tsl/platform/status.h"
 #include "tensorflow/tsl/platform/types.h"
+#include "tensorflow/tsl/profiler/protobuf/xplane.pb.h"
 
 namespace xla {
 namespace profiler {
@@ -168,6 +169,11 @@ struct RocmTracerOptions {
   // If the ops vector is empty, then enable Activity records for entire domain
   absl::flat_hash_map<activity_domain_t, std::vector<uint32_t> >
       activity_tracing;
+
+  // Size in bytes of each buffer of the roctracer activity pool. roctracer
+  // double buffers activity records and only calls back into the tracer when a
+  // buffer is full, so larger buffers mean fewer callbacks while profiling.
+  size_t activity_buffer_size = 2 * 1024 * 1024;
 };
 
 struct RocmTraceCollectorOptions {
@@ -219,6 +225,10 @@ class RocmTraceCollector {
                                uint32_t num_events) = 0;
   virtual void Flush() = 0;
 
+  // Consumer side function (i.e. called by GPU tracer). Writes the collected
+  // events into `space`; Flush must have been called before.
+  virtual void Export(tsl::profiler::XSpace* space) {}
+
   AnnotationMap* annotation_map() { return &annotation_map_; }
 
  protected:
@@ -116,6 +116,13 @@ DebugOptions DefaultDebugOptionsIgnoringFlags() {
   opts.set_xla_gpu_pgle_profile_file_or_directory_path("");
   opts.set_xla_gpu_enable_highest_priority_async_stream(false);
   opts.set_xla_gpu_enable_data_parallel_collective_optimizer(false);
+  opts.set_xla_gpu_enable_pipelined_all_gather(false);
+  opts.set_xla_gpu_enable_pipelined_reduce_scatter(false);
+  opts.set_xla_gpu_enable_host_offload(false);
+  opts.set_xla_gpu_enable_cost_model_rematerialization(true);
+  opts.set_xla_gpu_enable_dot_batching(false);
+  opts.set_xla_gpu_num_thunk_streams(1);
+  opts.set_xla_cpu_reuse_temp_buffers(true);
 
   opts.set_xla_cpu_enable_mlir_tiling_and_fusion(true);
   opts.set_xla_cpu_enable_custom_matmul_tiling(false);
@@ -139,6 +146,15 @@ DebugOptions DefaultDebugOptionsIgnoringFlags() {
   opts.set_xla_gpu_collective_inflation_factor(1);
 
   opts.set_xla_gpu_enable_experimental_block_size(false);
+  opts.set_xla_gpu_enable_softmax_fusion(false);
+  opts.set_xla_gpu_enable_fused_attention(false);
+  opts.set_xla_gpu_enable_radix_sort(false);
+  opts.set_xla_gpu_pgle_profiling_runs(0);
+  // Large enough to disable windowed einsum by default.
+  opts.set_xla_gpu_threshold_for_windowed_einsum_mib(100000);
+  opts.set_xla_gpu_unroll_windowed_einsum(false);
+  opts.set_xla_gpu_bidirectional_windowed_einsum(false);
+  opts.set_xla_gpu_autotune_max_devices(1);
 
   return opts;
 }
@@ -1008,6 +1024,54 @@ void MakeDebugOptionsFlags(std::vector<tsl::Flag>* flag_list,
           &DebugOptions::set_xla_gpu_enable_data_parallel_collective_optimizer),
       debug_options->xla_gpu_enable_data_parallel_collective_optimizer(),
       "Enable data parallel collective optimizer."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_enable_pipelined_all_gather",
+      bool_setter_for(&DebugOptions::set_xla_gpu_enable_pipelined_all_gather),
+      debug_options->xla_gpu_enable_pipelined_all_gather(),
+      "Pipeline all-gathers of while loops into the previous iteration."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_enable_pipelined_reduce_scatter",
+      bool_setter_for(
+          &DebugOptions::set_xla_gpu_enable_pipelined_reduce_scatter),
+      debug_options->xla_gpu_enable_pipelined_reduce_scatter(),
+      "Pipeline reduce-scatters of while loops into the next iteration."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_enable_host_offload",
+      bool_setter_for(&DebugOptions::set_xla_gpu_enable_host_offload),
+      debug_options->xla_gpu_enable_host_offload(),
+      "Offload buffers that are unused for long spans of the program to "
+      "pinned host memory when the program does not fit into device memory."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_enable_cost_model_rematerialization",
+      bool_setter_for(
+          &DebugOptions::set_xla_gpu_enable_cost_model_rematerialization),
+      debug_options->xla_gpu_enable_cost_model_rematerialization(),
+      "Prefer rematerializing instructions that are cheap to recompute, as "
+      "estimated by the Gpu performance model."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_enable_dot_batching",
+      bool_setter_for(&DebugOptions::set_xla_gpu_enable_dot_batching),
+      debug_options->xla_gpu_enable_dot_batching(),
+      "Batch small independent dots of the same shape into one batched "
+      "gemm."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_num_thunk_streams",
+      int32_setter_for(&DebugOptions::set_xla_gpu_num_thunk_streams),
+      debug_options->xla_gpu_num_thunk_streams(),
+      "The number of streams to run independent thunks on concurrently. 1 "
+      "runs all thunks on the main stream."));
+  flag_list->push_back(tsl::Flag(
+      "xla_cpu_object_cache_dir",
+      string_setter_for(&DebugOptions::set_xla_cpu_object_cache_dir),
+      debug_options->xla_cpu_object_cache_dir(),
+      "Directory in which the CPU JIT caches the object code of compiled "
+      "modules across processes. Empty disables the cache."));
+  flag_list->push_back(tsl::Flag(
+      "xla_cpu_reuse_temp_buffers",
+      bool_setter_for(&DebugOptions::set_xla_cpu_reuse_temp_buffers),
+      debug_options->xla_cpu_reuse_temp_buffers(),
+      "Reuse the memory for the temporary buffers of a CPU executable across "
+      "executions."));
   flag_list->push_back(tsl::Flag(
       "xla_partitioning_algorithm", setter_for_xla_partitioning_algorithm,
       DebugOptions::PartitioningAlgorithm_Name(
@@ -1037,6 +1101,76 @@ void MakeDebugOptionsFlags(std::vector<tsl::Flag>* flag_list,
                     &DebugOptions::set_xla_gpu_enable_experimental_block_size),
                 debug_options->xla_gpu_enable_experimental_block_size(),
                 "Enable experimental block size."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_performance_model_coefficients",
+      string_setter_for(
+          &DebugOptions::set_xla_gpu_performance_model_coefficients),
+      debug_options->xla_gpu_performance_model_coefficients(),
+      "Comma-separated name=value overrides of the GPU performance model "
+      "coefficients used for fusion decisions, as printed by the "
+      "gpu_performance_model_calibration tool."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_enable_softmax_fusion",
+      bool_setter_for(&DebugOptions::set_xla_gpu_enable_softmax_fusion),
+      debug_options->xla_gpu_enable_softmax_fusion(),
+      "Fuse softmax- and layer norm-like row normalizations into a single "
+      "kernel that keeps each row on chip."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_enable_fused_attention",
+      bool_setter_for(&DebugOptions::set_xla_gpu_enable_fused_attention),
+      debug_options->xla_gpu_enable_fused_attention(),
+      "Rewrite scaled dot product attention and its gradient into "
+      "memory-efficient fused kernels on ROCm. Only takes effect with "
+      "--xla_gpu_enable_xla_runtime_executable."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_pgle_profiling_runs",
+      int32_setter_for(&DebugOptions::set_xla_gpu_pgle_profiling_runs),
+      debug_options->xla_gpu_pgle_profiling_runs(),
+      "If positive, profile single device modules that have no profile in "
+      "the --xla_gpu_pgle_profile_file_or_directory_path directory this many "
+      "times, write the profile there and recompile them with it."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_threshold_for_windowed_einsum_mib",
+      int64_setter_for(
+          &DebugOptions::set_xla_gpu_threshold_for_windowed_einsum_mib),
+      debug_options->xla_gpu_threshold_for_windowed_einsum_mib(),
+      "Partition dots with operands or output larger than this many MiB into "
+      "windowed einsum loops that overlap collective-permutes with partial "
+      "dots."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_unroll_windowed_einsum",
+      bool_setter_for(&DebugOptions::set_xla_gpu_unroll_windowed_einsum),
+      debug_options->xla_gpu_unroll_windowed_einsum(),
+      "Unroll the windowed einsum loops by two to overlap the "
+      "collective-permute of a window with the dot of the previous one."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_bidirectional_windowed_einsum",
+      bool_setter_for(&DebugOptions::set_xla_gpu_bidirectional_windowed_einsum),
+      debug_options->xla_gpu_bidirectional_windowed_einsum(),
+      "Send the windows of the windowed einsum loops in both directions "
+      "around the ring of partitions."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_autotune_max_devices",
+      int32_setter_for(&DebugOptions::set_xla_gpu_autotune_max_devices),
+      debug_options->xla_gpu_autotune_max_devices(),
+      "Distribute the convolution and GEMM autotuning benchmarks across up to "
+      "this many local GPUs of the same model as the compiling GPU. 1 "
+      "autotunes on the compiling GPU only, 0 uses all of them."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_shared_autotune_results_dir",
+      string_setter_for(
+          &DebugOptions::set_xla_gpu_shared_autotune_results_dir),
+      debug_options->xla_gpu_shared_autotune_results_dir(),
+      "A directory of autotuning results shared by several jobs. The "
+      "compiler loads the results of the environment of the compiling GPU "
+      "from it before autotuning, and appends its new results to it."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_enable_radix_sort",
+      bool_setter_for(&DebugOptions::set_xla_gpu_enable_radix_sort),
+      debug_options->xla_gpu_enable_radix_sort(),
+      "Rewrite large sorts of keys, or of keys and values, with a simple "
+      "comparator into radix sort custom calls. Only supported on ROCm with "
+      "the XLA runtime."));
 }  // NOLINT(readability/fn_size)
 
 // Allocates flag_values and flag_objects; this function must not be called more
@@ -51,6 +51,7 @@ limitations under the License.
 #include "tensorflow/compiler/xla/service/hlo_ordering.h"
 #include "tensorflow/compiler/xla/service/sharding_propagation.h"
 #include "tensorflow/compiler/xla/util.h"
+#include "tensorflow/tsl/platform/env.h"
 #include "tensorflow/tsl/platform/errors.h"
 #include "tensorflow/tsl/platform/status.h"
 #include "ortools/linear_solver/linear_solver.h"
@@ -4226,8 +4227,13 @@ StatusOr<AutoShardingResult> AutoShardingImplementation::RunAutoSharding(
     std::iota(device_mesh_ids.begin(), device_mesh_ids.end(), 0);
     device_mesh.SetValues(device_mesh_ids);
 
-    // TODO (zhuohan): include the prof result as an option.
     spmd::ProfilingResult prof_result;
+    if (!option_.profiling_result_file.empty()) {
+      std::string prof_text;
+      TF_RETURN_IF_ERROR(tsl::ReadFileToString(
+          tsl::Env::Default(), option_.profiling_result_file, &prof_text));
+      TF_ASSIGN_OR_RETURN(prof_result, spmd::ProfilingResult::Parse(prof_text));
+    }
     spmd::ClusterEnvironment cluster_env(
         original_device_mesh, device_mesh, option_.device_mesh_alpha,
         option_.device_mesh_beta, prof_result, solver_option);
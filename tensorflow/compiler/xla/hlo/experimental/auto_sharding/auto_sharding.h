@@ -157,6 +157,10 @@ struct AutoShardingOption {
   // element models the communication performance along each mesh dimension.
   std::vector<double> device_mesh_alpha;
   std::vector<double> device_mesh_beta;
+  // Path to measured collective costs in the format of
+  // ProfilingResult::Parse. When set, they replace the alpha-beta model for
+  // the mesh dimensions whose replica groups were measured.
+  std::string profiling_result_file;
   // Load the strategy vector instead of solving one.
   bool load_strategy = false;
   // Explore other mesh shapes with the same number of devices as the provided
@@ -232,6 +236,10 @@ struct AutoShardingOption {
                                  absl::StrJoin(device_mesh_alpha, ","), "]"));
     lines.push_back(absl::StrCat("device_mesh_beta: [",
                                  absl::StrJoin(device_mesh_beta, ","), "]"));
+    if (!profiling_result_file.empty()) {
+      lines.push_back(
+          absl::StrCat("profiling_result_file: ", profiling_result_file));
+    }
 
     lines.push_back(absl::StrCat("load_strategy: ", load_strategy));
     if (load_strategy) {
@@ -21,6 +21,7 @@ limitations under the License.
 #include <vector>
 
 #include "tensorflow/compiler/xla/hlo/experimental/auto_sharding/auto_sharding_util.h"
+#include "tensorflow/compiler/xla/hlo/experimental/auto_sharding/profiling_result.h"
 #include "tensorflow/compiler/xla/hlo/ir/hlo_module.h"
 #include "tensorflow/compiler/xla/hlo/utils/hlo_matchers.h"
 #include "tensorflow/compiler/xla/service/hlo_parser.h"
@@ -952,6 +953,34 @@ ENTRY %entry {
   EXPECT_GT(pass.GetSolverOptimalObjectiveValue(), 0);
 }
 
+TEST(ProfilingResultTest, Parse) {
+  TF_ASSERT_OK_AND_ASSIGN(ProfilingResult prof_result,
+                          ProfilingResult::Parse(R"(
+# Measured on two devices.
+all-reduce ((0,1)) float32 1000 2.0
+all-reduce ((0,1)) float32 0 1.0
+all-gather ((0,1)) float32 0 0.5
+all-gather ((0,1)) float32 1000 0.75
+)"));
+  EXPECT_TRUE(prof_result.Enabled());
+  EXPECT_TRUE(prof_result.Covers({{0, 1}}, "float32"));
+  EXPECT_FALSE(prof_result.Covers({{0}, {1}}, "float32"));
+  // The costs are interpolated between the measured sizes, minus the cost of
+  // an empty collective.
+  EXPECT_DOUBLE_EQ(prof_result.EstimateAllReduceCost({{0, 1}}, 500, "float32"),
+                   0.5);
+  EXPECT_DOUBLE_EQ(prof_result.EstimateAllGatherCost({{0, 1}}, 2000, "float32"),
+                   0.5);
+  // Reduce-scatter is approximated by all-reduce.
+  EXPECT_DOUBLE_EQ(
+      prof_result.EstimateReduceScatterCost({{0, 1}}, 1000, "float32"), 0.5);
+
+  EXPECT_FALSE(ProfilingResult().Enabled());
+  EXPECT_FALSE(ProfilingResult::Parse("all-reduce ((0,1)) float32 0").ok());
+  EXPECT_FALSE(ProfilingResult::Parse("all-to-all ((0,1)) float32 0 1.0").ok());
+  EXPECT_FALSE(ProfilingResult::Parse("all-reduce ((0,1)) float32 0 1.0").ok());
+}
+
 }  // namespace
 }  // namespace spmd
 }  // namespace xla
@@ -36,7 +36,8 @@ double ClusterEnvironment::AllGatherCost(double num_bytes, int mesh_dim) const {
     return solver_option_.all_gather_cost;
   }
 
-  if (prof_result_.Enabled()) {
+  if (prof_result_.Enabled() &&
+      prof_result_.Covers(cached_replica_groups_[mesh_dim], "float32")) {
     return prof_result_.EstimateAllGatherCost(cached_replica_groups_[mesh_dim],
                                               num_bytes / 4, "float32");
   }
@@ -61,7 +62,8 @@ double ClusterEnvironment::AllReduceCost(double num_bytes, int32_t mesh_dim,
     return solver_option_.all_reduce_cost;
   }
 
-  if (prof_result_.Enabled()) {
+  if (prof_result_.Enabled() &&
+      prof_result_.Covers(cached_replica_groups_[mesh_dim], "float32")) {
     return prof_result_.EstimateAllReduceCost(cached_replica_groups_[mesh_dim],
                                               num_bytes / 4, "float32");
   }
@@ -89,7 +91,8 @@ double ClusterEnvironment::ReduceScatterCost(double num_bytes,
     return solver_option_.reduce_scatter_cost;
   }
 
-  if (prof_result_.Enabled()) {
+  if (prof_result_.Enabled() &&
+      prof_result_.Covers(cached_replica_groups_[mesh_dim], "float32")) {
     return prof_result_.EstimateReduceScatterCost(
         cached_replica_groups_[mesh_dim], num_bytes / 4, "float32");
   }
@@ -106,7 +109,8 @@ double ClusterEnvironment::AllToAllCost(double num_bytes, int mesh_dim) const {
     return solver_option_.all_to_all_cost;
   }
 
-  if (prof_result_.Enabled()) {
+  if (prof_result_.Enabled() &&
+      prof_result_.Covers(cached_replica_groups_[mesh_dim], "float32")) {
     return prof_result_.EstimateAllToAllCost(cached_replica_groups_[mesh_dim],
                                              num_bytes / 4, "float32");
   }
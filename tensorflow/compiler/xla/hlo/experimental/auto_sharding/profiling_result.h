@@ -21,7 +21,14 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
+#include "absl/algorithm/container.h"
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
 #include "tensorflow/compiler/xla/hlo/experimental/auto_sharding/auto_sharding_strategy.h"
+#include "tensorflow/compiler/xla/statusor.h"
+#include "tensorflow/compiler/xla/util.h"
 
 namespace xla {
 namespace spmd {
@@ -38,8 +45,76 @@ class ProfilingResult {
     }
   }
 
+  // Parses the profiling results from `text`, in which every line holds one
+  // measurement:
+  //   <collective> <replica_groups> <dtype> <size> <time>
+  // e.g. "all-reduce ((0,1)(2,3)) float32 1048576 0.0012". <collective> is one
+  // of all-reduce, all-gather and reduce-scatter, <replica_groups> is written
+  // as by Group2Str, <size> is the number of elements and <time> is in
+  // seconds. Empty lines and lines starting with '#' are ignored. Each
+  // collective, replica groups and dtype needs at least two different sizes.
+  static StatusOr<ProfilingResult> Parse(absl::string_view text) {
+    ProfilingResult result;
+    for (absl::string_view line : absl::StrSplit(text, '\n')) {
+      line = absl::StripAsciiWhitespace(line);
+      if (line.empty() || absl::StartsWith(line, "#")) continue;
+      std::vector<absl::string_view> fields =
+          absl::StrSplit(line, ' ', absl::SkipEmpty());
+      int64_t size;
+      double time;
+      if (fields.size() != 5 || !absl::SimpleAtoi(fields[3], &size) ||
+          !absl::SimpleAtod(fields[4], &time)) {
+        return InvalidArgument("Invalid profiling result line: %s", line);
+      }
+      StableHashMap<Key, Value>* cost_dict;
+      if (fields[0] == "all-reduce") {
+        cost_dict = &result.all_reduce_cost_dict_;
+      } else if (fields[0] == "all-gather") {
+        cost_dict = &result.all_gather_cost_dict_;
+      } else if (fields[0] == "reduce-scatter") {
+        cost_dict = &result.reduce_scatter_cost_dict_;
+      } else {
+        return InvalidArgument(
+            "Unknown collective in profiling result line: %s", line);
+      }
+      (*cost_dict)[Key(std::string(fields[1]), std::string(fields[2]))]
+          .push_back({size, time});
+    }
+
+    for (auto* cost_dict :
+         {&result.all_reduce_cost_dict_, &result.all_gather_cost_dict_,
+          &result.reduce_scatter_cost_dict_}) {
+      for (auto& [key, cost_list] : *cost_dict) {
+        absl::c_sort(cost_list);
+        bool has_duplicate_sizes =
+            absl::c_adjacent_find(cost_list, [](const auto& a, const auto& b) {
+              return a.first == b.first;
+            }) != cost_list.end();
+        if (cost_list.size() < 2 || has_duplicate_sizes) {
+          return InvalidArgument(
+              "Profiling result for %s %s needs at least two different sizes",
+              key.first, key.second);
+        }
+      }
+    }
+    result.enabled_ = !result.all_reduce_cost_dict_.empty();
+    return result;
+  }
+
   bool Enabled() const { return enabled_; }
 
+  // Returns true if the costs of the collectives over `replica_groups` can be
+  // estimated from the profiling results.
+  bool Covers(const std::vector<std::vector<int64_t>>& replica_groups,
+              const std::string& dtype) const {
+    Key key(Group2Str(replica_groups), dtype);
+    return all_reduce_cost_dict_.contains(key) &&
+           (all_gather_cost_dict_.empty() ||
+            all_gather_cost_dict_.contains(key)) &&
+           (reduce_scatter_cost_dict_.empty() ||
+            reduce_scatter_cost_dict_.contains(key));
+  }
+
   double EstimateAllGatherCost(
       const std::vector<std::vector<int64_t>>& replica_groups, int64_t size,
       const std::string& dtype) const {
@@ -53,7 +53,7 @@ extern "C" {
 // Changes include:
 // * Adding a new field to the PJRT_Api or argument structs
 // * Renaming a method or argument (doesn't affect ABI)
-#define PJRT_API_MINOR 1
+#define PJRT_API_MINOR 2
 
 // The plugin should set the major_version and minor_version of
 // PJRT_Api.pjrt_api_version to be the `PJRT_API_MAJOR` and `PJRT_API_MINOR` in
@@ -249,6 +249,40 @@ typedef struct PJRT_Executable PJRT_Executable;
 typedef struct PJRT_LoadedExecutable PJRT_LoadedExecutable;
 typedef struct PJRT_Buffer PJRT_Buffer;
 
+struct PJRT_KeyValueGetCallback_Args {
+  size_t struct_size;
+  void* priv;
+  const char* key;
+  size_t key_size;
+  int64_t timeout_in_ms;
+  void* user_arg;
+  // Allocated by the callback with malloc() and freed by the caller with
+  // free().
+  char* value;        // out
+  size_t value_size;  // out
+};
+PJRT_DEFINE_STRUCT_TRAITS(PJRT_KeyValueGetCallback_Args, value_size);
+
+// Gets the value of `key` from a key-value store shared by all the nodes of a
+// client, waiting for up to `timeout_in_ms` for it to be set. Returns false if
+// the value could not be retrieved. Must be thread-safe.
+typedef bool (*PJRT_KeyValueGetCallback)(PJRT_KeyValueGetCallback_Args* args);
+
+struct PJRT_KeyValuePutCallback_Args {
+  size_t struct_size;
+  void* priv;
+  const char* key;
+  size_t key_size;
+  const char* value;
+  size_t value_size;
+  void* user_arg;
+};
+PJRT_DEFINE_STRUCT_TRAITS(PJRT_KeyValuePutCallback_Args, user_arg);
+
+// Sets `key` to `value` in a key-value store shared by all the nodes of a
+// client. Returns false if the value could not be set. Must be thread-safe.
+typedef bool (*PJRT_KeyValuePutCallback)(PJRT_KeyValuePutCallback_Args* args);
+
 struct PJRT_Client_Create_Args {
   size_t struct_size;
   void* priv;
@@ -256,8 +290,16 @@ struct PJRT_Client_Create_Args {
   PJRT_NamedValue* create_options;
   size_t num_options;
   PJRT_Client* client;  // out
-};
-PJRT_DEFINE_STRUCT_TRAITS(PJRT_Client_Create_Args, client);
+  // Optional key-value store used by the nodes of a multi-node client to
+  // exchange the information they need to set up collectives. Either both or
+  // neither of the callbacks must be set; the user args are passed to the
+  // callbacks and must outlive the client.
+  PJRT_KeyValueGetCallback kv_get_callback;
+  void* kv_get_user_arg;
+  PJRT_KeyValuePutCallback kv_put_callback;
+  void* kv_put_user_arg;
+};
+PJRT_DEFINE_STRUCT_TRAITS(PJRT_Client_Create_Args, kv_put_user_arg);
 
 // Creates and initializes a new PJRT_Client and returns in `client`.
 typedef PJRT_Error* PJRT_Client_Create(PJRT_Client_Create_Args* args);
@@ -13,9 +13,16 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <cstdint>
 #include <memory>
+#include <optional>
+#include <set>
+#include <string>
 #include <utility>
+#include <variant>
+#include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "tensorflow/compiler/xla/pjrt/c/pjrt_c_api_helpers.h"
 #include "tensorflow/compiler/xla/pjrt/c/pjrt_c_api_wrapper_impl.h"
 #include "tensorflow/compiler/xla/pjrt/gpu/gpu_helpers.h"
@@ -29,13 +36,81 @@ PJRT_Error* PJRT_Client_Create(PJRT_Client_Create_Args* args) {
       "PJRT_Client_Create_Args", PJRT_Client_Create_Args_STRUCT_SIZE,
       args->struct_size));
 
-  // TODO(b/261916900) initializing allocator_config is important as should be
-  // passed through the args later.
+  absl::flat_hash_map<std::string, xla::PjRtValueType> create_options =
+      pjrt::ConvertFromPjRtNamedValueList(args->create_options,
+                                          args->num_options);
+  const auto kExpectedOptionNameAndTypes =
+      absl::flat_hash_map<std::string, PJRT_NamedValue_Type>({
+          {"platform_name", PJRT_NamedValue_Type::PJRT_NamedValue_kString},
+          {"allocator", PJRT_NamedValue_Type::PJRT_NamedValue_kString},
+          {"memory_fraction", PJRT_NamedValue_Type::PJRT_NamedValue_kFloat},
+          {"preallocate", PJRT_NamedValue_Type::PJRT_NamedValue_kInt64},
+          {"visible_devices", PJRT_NamedValue_Type::PJRT_NamedValue_kInt64List},
+          {"node_id", PJRT_NamedValue_Type::PJRT_NamedValue_kInt64},
+          {"num_nodes", PJRT_NamedValue_Type::PJRT_NamedValue_kInt64},
+      });
+  PJRT_RETURN_IF_ERROR(
+      ValidateCreateOptions(create_options, kExpectedOptionNameAndTypes));
+
+  std::optional<std::string> platform_name;
+  if (auto it = create_options.find("platform_name");
+      it != create_options.end()) {
+    platform_name = std::get<std::string>(it->second);
+  }
   xla::GpuAllocatorConfig allocator_config;
-  PJRT_ASSIGN_OR_RETURN(std::unique_ptr<xla::PjRtClient> client,
-                        xla::GetStreamExecutorGpuClient(
-                            /*asynchronous=*/true, allocator_config,
-                            /*node_id=*/0));
+  if (auto it = create_options.find("allocator"); it != create_options.end()) {
+    const std::string& allocator = std::get<std::string>(it->second);
+    if (allocator == "default") {
+      allocator_config.kind = xla::GpuAllocatorConfig::Kind::kDefault;
+    } else if (allocator == "platform") {
+      allocator_config.kind = xla::GpuAllocatorConfig::Kind::kPlatform;
+    } else if (allocator == "bfc") {
+      allocator_config.kind = xla::GpuAllocatorConfig::Kind::kBFC;
+    } else if (allocator == "cuda_async") {
+      allocator_config.kind = xla::GpuAllocatorConfig::Kind::kCudaAsync;
+    } else {
+      return new PJRT_Error{tsl::errors::InvalidArgument(
+          "Allocator ", allocator,
+          " is not supported; expected one of default, platform, bfc or "
+          "cuda_async.")};
+    }
+  }
+  if (auto it = create_options.find("memory_fraction");
+      it != create_options.end()) {
+    allocator_config.memory_fraction = std::get<float>(it->second);
+  }
+  if (auto it = create_options.find("preallocate");
+      it != create_options.end()) {
+    allocator_config.preallocate = std::get<int64_t>(it->second) != 0;
+  }
+  std::optional<std::set<int>> visible_devices;
+  if (auto it = create_options.find("visible_devices");
+      it != create_options.end()) {
+    const auto& devices = std::get<std::vector<int64_t>>(it->second);
+    visible_devices.emplace(devices.begin(), devices.end());
+  }
+  int node_id = 0;
+  if (auto it = create_options.find("node_id"); it != create_options.end()) {
+    node_id = std::get<int64_t>(it->second);
+  }
+  int num_nodes = 1;
+  if (auto it = create_options.find("num_nodes"); it != create_options.end()) {
+    num_nodes = std::get<int64_t>(it->second);
+  }
+  if (num_nodes > 1 &&
+      (args->kv_get_callback == nullptr || args->kv_put_callback == nullptr)) {
+    return new PJRT_Error{tsl::errors::InvalidArgument(
+        "A client with more than one node needs key-value store callbacks.")};
+  }
+
+  PJRT_ASSIGN_OR_RETURN(
+      std::unique_ptr<xla::PjRtClient> client,
+      xla::GetStreamExecutorGpuClient(
+          /*asynchronous=*/true, allocator_config, node_id, num_nodes,
+          visible_devices, platform_name,
+          /*should_stage_host_to_device_transfers=*/true,
+          pjrt::ConvertFromCKeyValueGetCallback(args),
+          pjrt::ConvertFromCKeyValuePutCallback(args)));
   args->client = pjrt::CreateWrapperClient(std::move(client));
   return nullptr;
 }
@@ -15,6 +15,8 @@ limitations under the License.
 
 #include "tensorflow/compiler/xla/pjrt/c/pjrt_c_api_helpers.h"
 
+#include <cstdlib>
+#include <cstring>
 #include <functional>
 #include <memory>
 #include <string>
@@ -23,6 +25,7 @@ limitations under the License.
 #include <vector>
 
 #include "absl/status/status.h"
+#include "absl/time/time.h"
 #include "tensorflow/compiler/xla/pjrt/c/pjrt_c_api.h"
 #include "tensorflow/compiler/xla/pjrt/pjrt_client.h"
 #include "tensorflow/compiler/xla/pjrt/pjrt_future.h"
@@ -30,6 +33,7 @@ limitations under the License.
 #include "tensorflow/compiler/xla/status.h"
 #include "tensorflow/compiler/xla/statusor.h"
 #include "tensorflow/compiler/xla/xla_data.pb.h"
+#include "tensorflow/tsl/platform/logging.h"
 
 namespace pjrt {
 
@@ -592,4 +596,97 @@ PJRT_DeviceDescription* GetDeviceDescription(const PJRT_Api* api,
   return args.device_description;
 }
 
+static bool CallKeyValueGetCallback(PJRT_KeyValueGetCallback_Args* args) {
+  auto* data = static_cast<PJRT_KeyValueCallbackData*>(args->user_arg);
+  xla::StatusOr<std::string> value =
+      data->kv_get(std::string(args->key, args->key_size),
+                   absl::Milliseconds(args->timeout_in_ms));
+  if (!value.ok()) {
+    LOG(ERROR) << "Key-value store get failed: " << value.status();
+    return false;
+  }
+  args->value = static_cast<char*>(std::malloc(value->size()));
+  std::memcpy(args->value, value->data(), value->size());
+  args->value_size = value->size();
+  return true;
+}
+
+static bool CallKeyValuePutCallback(PJRT_KeyValuePutCallback_Args* args) {
+  auto* data = static_cast<PJRT_KeyValueCallbackData*>(args->user_arg);
+  xla::Status status =
+      data->kv_put(std::string(args->key, args->key_size),
+                   std::string(args->value, args->value_size));
+  if (!status.ok()) {
+    LOG(ERROR) << "Key-value store put failed: " << status;
+    return false;
+  }
+  return true;
+}
+
+std::unique_ptr<PJRT_KeyValueCallbackData> ConvertToCKeyValueCallbacks(
+    xla::PjRtClient::KeyValueGetCallback kv_get,
+    xla::PjRtClient::KeyValuePutCallback kv_put,
+    PJRT_Client_Create_Args* args) {
+  args->kv_get_callback = nullptr;
+  args->kv_get_user_arg = nullptr;
+  args->kv_put_callback = nullptr;
+  args->kv_put_user_arg = nullptr;
+  if (kv_get == nullptr || kv_put == nullptr) return nullptr;
+
+  auto data = std::make_unique<PJRT_KeyValueCallbackData>();
+  data->kv_get = std::move(kv_get);
+  data->kv_put = std::move(kv_put);
+  args->kv_get_callback = CallKeyValueGetCallback;
+  args->kv_get_user_arg = data.get();
+  args->kv_put_callback = CallKeyValuePutCallback;
+  args->kv_put_user_arg = data.get();
+  return data;
+}
+
+xla::PjRtClient::KeyValueGetCallback ConvertFromCKeyValueGetCallback(
+    const PJRT_Client_Create_Args* args) {
+  if (args->kv_get_callback == nullptr) return nullptr;
+  return [c_callback = args->kv_get_callback, user_arg = args->kv_get_user_arg](
+             const std::string& key,
+             absl::Duration timeout) -> xla::StatusOr<std::string> {
+    PJRT_KeyValueGetCallback_Args get_args;
+    get_args.struct_size = PJRT_KeyValueGetCallback_Args_STRUCT_SIZE;
+    get_args.priv = nullptr;
+    get_args.key = key.data();
+    get_args.key_size = key.size();
+    get_args.timeout_in_ms = absl::ToInt64Milliseconds(timeout);
+    get_args.user_arg = user_arg;
+    get_args.value = nullptr;
+    get_args.value_size = 0;
+    if (!c_callback(&get_args)) {
+      return tsl::errors::Unavailable(
+          "Failed to get key from the key-value store: ", key);
+    }
+    std::string value(get_args.value, get_args.value_size);
+    std::free(get_args.value);
+    return value;
+  };
+}
+
+xla::PjRtClient::KeyValuePutCallback ConvertFromCKeyValuePutCallback(
+    const PJRT_Client_Create_Args* args) {
+  if (args->kv_put_callback == nullptr) return nullptr;
+  return [c_callback = args->kv_put_callback, user_arg = args->kv_put_user_arg](
+             const std::string& key, const std::string& value) -> xla::Status {
+    PJRT_KeyValuePutCallback_Args put_args;
+    put_args.struct_size = PJRT_KeyValuePutCallback_Args_STRUCT_SIZE;
+    put_args.priv = nullptr;
+    put_args.key = key.data();
+    put_args.key_size = key.size();
+    put_args.value = value.data();
+    put_args.value_size = value.size();
+    put_args.user_arg = user_arg;
+    if (!c_callback(&put_args)) {
+      return tsl::errors::Unavailable(
+          "Failed to put key into the key-value store: ", key);
+    }
+    return tsl::OkStatus();
+  };
+}
+
 }  // namespace pjrt
@@ -160,6 +160,28 @@ xla::PjRtChunk ConvertToCppChunk(const PJRT_Chunk& chunk);
 PJRT_DeviceDescription* GetDeviceDescription(const PJRT_Api* api,
                                              PJRT_Device* device);
 
+// The C++ key-value store callbacks called by the C callbacks that
+// ConvertToCKeyValueCallbacks sets.
+struct PJRT_KeyValueCallbackData {
+  xla::PjRtClient::KeyValueGetCallback kv_get;
+  xla::PjRtClient::KeyValuePutCallback kv_put;
+};
+
+// Sets the key-value store callbacks of `args` to C callbacks that call
+// `kv_get` and `kv_put`, or to nullptr if they are null. The returned data is
+// used by the C callbacks and must outlive the client created with `args`.
+std::unique_ptr<PJRT_KeyValueCallbackData> ConvertToCKeyValueCallbacks(
+    xla::PjRtClient::KeyValueGetCallback kv_get,
+    xla::PjRtClient::KeyValuePutCallback kv_put,
+    PJRT_Client_Create_Args* args);
+
+// Returns C++ callbacks that call the key-value store callbacks of `args`, or
+// null callbacks if `args` has none.
+xla::PjRtClient::KeyValueGetCallback ConvertFromCKeyValueGetCallback(
+    const PJRT_Client_Create_Args* args);
+xla::PjRtClient::KeyValuePutCallback ConvertFromCKeyValuePutCallback(
+    const PJRT_Client_Create_Args* args);
+
 }  // namespace pjrt
 
 #endif  // TENSORFLOW_COMPILER_XLA_PJRT_C_PJRT_C_API_HELPERS_H_
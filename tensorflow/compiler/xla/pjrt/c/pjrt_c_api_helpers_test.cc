@@ -15,11 +15,14 @@ limitations under the License.
 #include "tensorflow/compiler/xla/pjrt/c/pjrt_c_api_helpers.h"
 
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include "absl/container/flat_hash_map.h"
+#include "absl/time/time.h"
 #include "tensorflow/tsl/lib/core/status_test_util.h"
 #include "tensorflow/tsl/platform/status.h"
 
@@ -88,5 +91,44 @@ TEST(PjRtCApiHelperTest, InvalidOptionTypeIndex) {
                         "has type index 1 but expected type index is 0"));
 }
 
+TEST(PjRtCApiHelperTest, KeyValueCallbacksRoundTrip) {
+  absl::flat_hash_map<std::string, std::string> store;
+  xla::PjRtClient::KeyValueGetCallback kv_get =
+      [&store](const std::string& key,
+               absl::Duration timeout) -> xla::StatusOr<std::string> {
+    auto it = store.find(key);
+    if (it == store.end()) return tsl::errors::NotFound(key);
+    return it->second;
+  };
+  xla::PjRtClient::KeyValuePutCallback kv_put =
+      [&store](const std::string& key, const std::string& value) {
+        store[key] = value;
+        return tsl::OkStatus();
+      };
+
+  PJRT_Client_Create_Args args;
+  std::unique_ptr<PJRT_KeyValueCallbackData> data =
+      ConvertToCKeyValueCallbacks(kv_get, kv_put, &args);
+  ASSERT_NE(data, nullptr);
+  xla::PjRtClient::KeyValueGetCallback converted_get =
+      ConvertFromCKeyValueGetCallback(&args);
+  xla::PjRtClient::KeyValuePutCallback converted_put =
+      ConvertFromCKeyValuePutCallback(&args);
+
+  TF_ASSERT_OK(converted_put("key", std::string("value\0with nul", 14)));
+  EXPECT_EQ(store["key"], std::string("value\0with nul", 14));
+  TF_ASSERT_OK_AND_ASSIGN(std::string value,
+                          converted_get("key", absl::Seconds(1)));
+  EXPECT_EQ(value, std::string("value\0with nul", 14));
+  EXPECT_FALSE(converted_get("missing", absl::Seconds(1)).ok());
+}
+
+TEST(PjRtCApiHelperTest, NoKeyValueCallbacks) {
+  PJRT_Client_Create_Args args;
+  EXPECT_EQ(ConvertToCKeyValueCallbacks(nullptr, nullptr, &args), nullptr);
+  EXPECT_TRUE(ConvertFromCKeyValueGetCallback(&args) == nullptr);
+  EXPECT_TRUE(ConvertFromCKeyValuePutCallback(&args) == nullptr);
+}
+
 }  // namespace
 }  // namespace pjrt
@@ -0,0 +1,202 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/pjrt/compilation_cache.h"
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/strings/escaping.h"
+#include "absl/strings/str_cat.h"
+#include "tensorflow/compiler/xla/pjrt/compile_options.pb.h"
+#include "tensorflow/tsl/lib/strings/proto_serialization.h"
+#include "tensorflow/tsl/platform/env.h"
+#include "tensorflow/tsl/platform/errors.h"
+#include "tensorflow/tsl/platform/fingerprint.h"
+#include "tensorflow/tsl/platform/logging.h"
+#include "tensorflow/tsl/platform/path.h"
+
+namespace xla {
+
+PjRtCompilationCache::PjRtCompilationCache(PjRtClient* client,
+                                           Options options)
+    : client_(client), options_(std::move(options)) {}
+
+/*static*/ StatusOr<std::string> PjRtCompilationCache::Key(
+    const PjRtClient& client, const XlaComputation& computation,
+    const CompileOptions& options) {
+  std::string serialized_computation;
+  if (!tsl::SerializeToStringDeterministic(computation.proto(),
+                                           &serialized_computation)) {
+    return InternalError("Failed to serialize computation %s",
+                         computation.name());
+  }
+  TF_ASSIGN_OR_RETURN(CompileOptionsProto options_proto, options.ToProto());
+  std::string serialized_options;
+  if (!tsl::SerializeToStringDeterministic(options_proto,
+                                           &serialized_options)) {
+    return InternalError("Failed to serialize compile options");
+  }
+
+  // Executables of different platforms or compiler versions must not be
+  // mixed.
+  std::string data =
+      absl::StrCat(client.platform_name(), ";", client.platform_version(), ";",
+                   serialized_options.size(), ";", serialized_options,
+                   serialized_computation);
+  const tsl::Fprint128 fingerprint = tsl::Fingerprint128(data);
+  absl::string_view fp_bytes(reinterpret_cast<const char*>(&fingerprint),
+                             sizeof(tsl::Fprint128));
+  return absl::BytesToHexString(fp_bytes);
+}
+
+StatusOr<std::shared_ptr<PjRtLoadedExecutable>>
+PjRtCompilationCache::GetOrCompile(const XlaComputation& computation,
+                                   const CompileOptions& options) {
+  TF_ASSIGN_OR_RETURN(std::string key, Key(*client_, computation, options));
+  if (std::shared_ptr<PjRtLoadedExecutable> executable = Lookup(key)) {
+    VLOG(2) << "Compilation cache hit for " << computation.name() << ": "
+            << key;
+    return executable;
+  }
+
+  std::unique_ptr<PjRtLoadedExecutable> executable =
+      LoadPersistent(key, options);
+  if (executable == nullptr) {
+    VLOG(1) << "Compilation cache miss for " << computation.name() << ": "
+            << key;
+    TF_ASSIGN_OR_RETURN(executable, client_->Compile(computation, options));
+    StorePersistent(key, *executable);
+  }
+  return Insert(key, std::move(executable));
+}
+
+std::shared_ptr<PjRtLoadedExecutable> PjRtCompilationCache::Lookup(
+    const std::string& key) {
+  absl::MutexLock lock(&mu_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) return nullptr;
+  lru_.splice(lru_.end(), lru_, it->second);
+  return it->second->executable;
+}
+
+std::shared_ptr<PjRtLoadedExecutable> PjRtCompilationCache::Insert(
+    const std::string& key, std::shared_ptr<PjRtLoadedExecutable> executable) {
+  absl::MutexLock lock(&mu_);
+  if (auto it = entries_.find(key); it != entries_.end()) {
+    lru_.splice(lru_.end(), lru_, it->second);
+    return it->second->executable;
+  }
+  int64_t size_bytes =
+      std::max<int64_t>(executable->SizeOfGeneratedCodeInBytes(), 0);
+  lru_.push_back(Entry{key, executable, size_bytes});
+  auto entry = std::prev(lru_.end());
+  entries_[entry->key] = entry;
+  size_bytes_ += size_bytes;
+  EvictIfOverCapacity();
+  return executable;
+}
+
+void PjRtCompilationCache::EvictIfOverCapacity() {
+  while (size_bytes_ > options_.capacity_bytes && lru_.size() > 1) {
+    Entry& entry = lru_.front();
+    VLOG(1) << "Evicting " << entry.size_bytes
+            << " bytes from the compilation cache: " << entry.key;
+    size_bytes_ -= entry.size_bytes;
+    entries_.erase(entry.key);
+    lru_.pop_front();
+  }
+}
+
+void PjRtCompilationCache::Clear() {
+  absl::MutexLock lock(&mu_);
+  entries_.clear();
+  lru_.clear();
+  size_bytes_ = 0;
+}
+
+int64_t PjRtCompilationCache::size_bytes() const {
+  absl::MutexLock lock(&mu_);
+  return size_bytes_;
+}
+
+int64_t PjRtCompilationCache::num_entries() const {
+  absl::MutexLock lock(&mu_);
+  return entries_.size();
+}
+
+std::unique_ptr<PjRtLoadedExecutable> PjRtCompilationCache::LoadPersistent(
+    const std::string& key, const CompileOptions& options) const {
+  if (options_.persistent_cache_dir.empty()) return nullptr;
+  tsl::Env* env = tsl::Env::Default();
+  std::string path = tsl::io::JoinPath(options_.persistent_cache_dir, key);
+  if (!env->FileExists(path).ok()) return nullptr;
+
+  std::string serialized;
+  if (Status status = tsl::ReadFileToString(env, path, &serialized);
+      !status.ok()) {
+    LOG(WARNING) << "Failed to read cached executable " << path << ": "
+                 << status;
+    return nullptr;
+  }
+  StatusOr<std::unique_ptr<PjRtLoadedExecutable>> executable =
+      client_->DeserializeExecutable(serialized, options);
+  if (!executable.ok()) {
+    LOG(WARNING) << "Failed to deserialize cached executable " << path << ": "
+                 << executable.status();
+    return nullptr;
+  }
+  VLOG(1) << "Loaded executable from the persistent compilation cache: "
+          << path;
+  return *std::move(executable);
+}
+
+void PjRtCompilationCache::StorePersistent(
+    const std::string& key, const PjRtLoadedExecutable& executable) const {
+  if (options_.persistent_cache_dir.empty()) return;
+  StatusOr<std::string> serialized = executable.SerializeExecutable();
+  if (!serialized.ok()) {
+    VLOG(1) << "Not storing executable in the persistent compilation cache: "
+            << serialized.status();
+    return;
+  }
+
+  tsl::Env* env = tsl::Env::Default();
+  if (Status status = env->RecursivelyCreateDir(options_.persistent_cache_dir);
+      !status.ok() && !tsl::errors::IsAlreadyExists(status)) {
+    LOG(WARNING) << "Failed to create compilation cache directory "
+                 << options_.persistent_cache_dir << ": " << status;
+    return;
+  }
+  // Write to a unique temporary file first, so that concurrent readers never
+  // see a partially written executable.
+  std::string path = tsl::io::JoinPath(options_.persistent_cache_dir, key);
+  std::string temp_path = path;
+  if (!env->CreateUniqueFileName(&temp_path, ".tmp")) {
+    LOG(WARNING) << "Failed to create a temporary file name for " << path;
+    return;
+  }
+  Status status = tsl::WriteStringToFile(env, temp_path, *serialized);
+  if (status.ok()) status = env->RenameFile(temp_path, path);
+  if (!status.ok()) {
+    LOG(WARNING) << "Failed to store executable " << path << ": " << status;
+    env->DeleteFile(temp_path).IgnoreError();
+  }
+}
+
+}  // namespace xla
@@ -0,0 +1,120 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_COMPILER_XLA_PJRT_COMPILATION_CACHE_H_
+#define TENSORFLOW_COMPILER_XLA_PJRT_COMPILATION_CACHE_H_
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorflow/compiler/xla/client/xla_computation.h"
+#include "tensorflow/compiler/xla/pjrt/pjrt_client.h"
+#include "tensorflow/compiler/xla/pjrt/pjrt_executable.h"
+#include "tensorflow/compiler/xla/statusor.h"
+
+namespace xla {
+
+// A cache of the executables compiled by a PjRtClient, keyed on a fingerprint
+// of the computation and the compile options. Thread-safe.
+//
+// The cache accounts for the size of the generated code of the executables it
+// holds and evicts the least recently used ones once it exceeds its capacity,
+// so that it can be shared by many models and model versions without holding
+// on to an unbounded number of executables. Executables stay alive while they
+// are used, even if they are evicted.
+//
+// Optionally, executables are also serialized to a directory, so that they
+// can be loaded instead of being compiled again after an eviction or in
+// another process. Clients that cannot serialize executables only use the
+// in-memory cache.
+class PjRtCompilationCache {
+ public:
+  struct Options {
+    // The maximum total size of the generated code of the cached executables.
+    // The most recently used executable is kept even if it is larger.
+    int64_t capacity_bytes = int64_t{1} << 30;
+
+    // If not empty, the directory in which compiled executables are stored.
+    std::string persistent_cache_dir;
+  };
+
+  PjRtCompilationCache(PjRtClient* client, Options options);
+
+  PjRtCompilationCache(const PjRtCompilationCache&) = delete;
+  PjRtCompilationCache& operator=(const PjRtCompilationCache&) = delete;
+
+  // Returns the executable compiled from `computation` with `options`,
+  // compiling it if it is not in the cache. Concurrent calls for the same key
+  // may each compile the computation; only one of the executables is cached.
+  StatusOr<std::shared_ptr<PjRtLoadedExecutable>> GetOrCompile(
+      const XlaComputation& computation, const CompileOptions& options);
+
+  // Returns the key of the executable compiled from `computation` with
+  // `options` by `client`.
+  static StatusOr<std::string> Key(const PjRtClient& client,
+                                   const XlaComputation& computation,
+                                   const CompileOptions& options);
+
+  // Removes all executables from the in-memory cache.
+  void Clear();
+
+  int64_t size_bytes() const;
+  int64_t num_entries() const;
+
+ private:
+  struct Entry {
+    std::string key;
+    std::shared_ptr<PjRtLoadedExecutable> executable;
+    int64_t size_bytes;
+  };
+
+  // Returns the cached executable for `key` and marks it as most recently
+  // used, or nullptr if there is none.
+  std::shared_ptr<PjRtLoadedExecutable> Lookup(const std::string& key);
+
+  // Inserts `executable` unless there already is an executable for `key`,
+  // and returns the cached executable.
+  std::shared_ptr<PjRtLoadedExecutable> Insert(
+      const std::string& key, std::shared_ptr<PjRtLoadedExecutable> executable);
+
+  void EvictIfOverCapacity() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Loads the executable for `key` from the persistent cache, or returns
+  // nullptr if there is none.
+  std::unique_ptr<PjRtLoadedExecutable> LoadPersistent(
+      const std::string& key, const CompileOptions& options) const;
+  void StorePersistent(const std::string& key,
+                       const PjRtLoadedExecutable& executable) const;
+
+  PjRtClient* const client_;
+  const Options options_;
+
+  mutable absl::Mutex mu_;
+  // Ordered from least to most recently used.
+  std::list<Entry> lru_ ABSL_GUARDED_BY(mu_);
+  absl::flat_hash_map<absl::string_view, std::list<Entry>::iterator> entries_
+      ABSL_GUARDED_BY(mu_);
+  int64_t size_bytes_ ABSL_GUARDED_BY(mu_) = 0;
+};
+
+}  // namespace xla
+
+#endif  // TENSORFLOW_COMPILER_XLA_PJRT_COMPILATION_CACHE_H_
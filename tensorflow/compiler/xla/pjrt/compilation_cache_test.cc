@@ -0,0 +1,111 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/pjrt/compilation_cache.h"
+
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+#include "tensorflow/compiler/xla/client/xla_computation.h"
+#include "tensorflow/compiler/xla/pjrt/tfrt_cpu_pjrt_client.h"
+#include "tensorflow/compiler/xla/service/hlo_parser.h"
+#include "tensorflow/tsl/lib/core/status_test_util.h"
+#include "tensorflow/tsl/platform/statusor.h"
+
+namespace xla {
+namespace {
+
+constexpr char kAdd[] = R"(
+HloModule Add
+ENTRY main {
+  p = f32[4] parameter(0)
+  ROOT add = f32[4] add(p, p)
+})";
+
+constexpr char kMul[] = R"(
+HloModule Mul
+ENTRY main {
+  p = f32[4] parameter(0)
+  ROOT mul = f32[4] multiply(p, p)
+})";
+
+XlaComputation Parse(const char* hlo) {
+  auto module = ParseAndReturnUnverifiedModule(hlo).value();
+  return XlaComputation(module->ToProto());
+}
+
+TEST(PjRtCompilationCacheTest, ReusesExecutables) {
+  TF_ASSERT_OK_AND_ASSIGN(auto client, GetTfrtCpuClient(/*asynchronous=*/true));
+  PjRtCompilationCache cache(client.get(), {});
+
+  TF_ASSERT_OK_AND_ASSIGN(auto add, cache.GetOrCompile(Parse(kAdd), {}));
+  TF_ASSERT_OK_AND_ASSIGN(auto add_again,
+                          cache.GetOrCompile(Parse(kAdd), {}));
+  EXPECT_EQ(add, add_again);
+
+  TF_ASSERT_OK_AND_ASSIGN(auto mul, cache.GetOrCompile(Parse(kMul), {}));
+  EXPECT_NE(add, mul);
+  EXPECT_EQ(cache.num_entries(), 2);
+  EXPECT_EQ(cache.size_bytes(), add->SizeOfGeneratedCodeInBytes() +
+                                    mul->SizeOfGeneratedCodeInBytes());
+}
+
+TEST(PjRtCompilationCacheTest, KeyDependsOnComputationAndOptions) {
+  TF_ASSERT_OK_AND_ASSIGN(auto client, GetTfrtCpuClient(/*asynchronous=*/true));
+  CompileOptions options;
+  CompileOptions other_options;
+  other_options.parameter_is_tupled_arguments = true;
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::string key,
+      PjRtCompilationCache::Key(*client, Parse(kAdd), options));
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::string same_key,
+      PjRtCompilationCache::Key(*client, Parse(kAdd), options));
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::string mul_key,
+      PjRtCompilationCache::Key(*client, Parse(kMul), options));
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::string options_key,
+      PjRtCompilationCache::Key(*client, Parse(kAdd), other_options));
+  EXPECT_EQ(key, same_key);
+  EXPECT_NE(key, mul_key);
+  EXPECT_NE(key, options_key);
+}
+
+TEST(PjRtCompilationCacheTest, EvictsLeastRecentlyUsed) {
+  TF_ASSERT_OK_AND_ASSIGN(auto client, GetTfrtCpuClient(/*asynchronous=*/true));
+  PjRtCompilationCache::Options options;
+  options.capacity_bytes = 1;
+  PjRtCompilationCache cache(client.get(), options);
+
+  TF_ASSERT_OK_AND_ASSIGN(auto add, cache.GetOrCompile(Parse(kAdd), {}));
+  ASSERT_GT(add->SizeOfGeneratedCodeInBytes(), 0);
+  // The most recently used executable is kept even if it is too large.
+  EXPECT_EQ(cache.num_entries(), 1);
+
+  TF_ASSERT_OK_AND_ASSIGN(auto mul, cache.GetOrCompile(Parse(kMul), {}));
+  EXPECT_EQ(cache.num_entries(), 1);
+  EXPECT_EQ(cache.size_bytes(), mul->SizeOfGeneratedCodeInBytes());
+
+  // `add` was evicted, so it is compiled again.
+  TF_ASSERT_OK_AND_ASSIGN(auto add_again,
+                          cache.GetOrCompile(Parse(kAdd), {}));
+  EXPECT_NE(add, add_again);
+}
+
+}  // namespace
+}  // namespace xla
@@ -337,6 +337,36 @@ TEST(StreamExecutorGpuClientTest, FromHostAsync) {
         literals[i]->Relayout(src_literals[i].shape().layout()).data<float>());
   }
 }
+TEST(StreamExecutorGpuClientTest, FromLargeHostBuffers) {
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto client, GetStreamExecutorGpuClient(true, /*allocator_config=*/{},
+                                              /*node_id=*/0));
+  ASSERT_GE(client->addressable_devices().size(), 1);
+
+  // Large enough to be transferred in several chunks, and several buffers so
+  // that the transfers use different streams.
+  constexpr int64_t kNumElements = (20 << 20) / sizeof(float) + 3;
+  std::vector<std::vector<float>> host_data;
+  std::vector<std::unique_ptr<PjRtBuffer>> buffers;
+  for (int i = 0; i < 4; ++i) {
+    std::vector<float>& data = host_data.emplace_back(kNumElements);
+    std::iota(data.begin(), data.end(), static_cast<float>(i));
+    TF_ASSERT_OK_AND_ASSIGN(
+        buffers.emplace_back(),
+        client->BufferFromHostBuffer(
+            data.data(), F32, {kNumElements}, /*byte_strides=*/std::nullopt,
+            PjRtClient::HostBufferSemantics::kImmutableUntilTransferCompletes,
+            /*on_done_with_host_buffer=*/nullptr,
+            client->addressable_devices()[0]));
+  }
+
+  for (int i = 0; i < buffers.size(); ++i) {
+    TF_ASSERT_OK_AND_ASSIGN(std::shared_ptr<Literal> literal,
+                            buffers[i]->ToLiteralSync());
+    EXPECT_EQ(literal->data<float>(), absl::MakeConstSpan(host_data[i]));
+  }
+}
+
 TEST(StreamExecutorGpuClientTest, CopyRawToHostFullBuffer) {
   TF_ASSERT_OK_AND_ASSIGN(
       auto client, GetStreamExecutorGpuClient(true, /*allocator_config=*/{},
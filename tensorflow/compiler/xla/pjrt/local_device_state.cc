@@ -46,6 +46,9 @@ LocalDeviceState::LocalDeviceState(se::StreamExecutor* executor,
       prng_seed_generator_(prng_seed_device_()),
       prng_seed_distribution_(std::numeric_limits<int>::min(),
                               std::numeric_limits<int>::max()) {
+  int num_host_to_device_streams =
+      stream_options.has_value() ? stream_options->num_host_to_device_streams
+                                 : kNumHostToDeviceStreams;
   int num_device_to_host_streams =
       stream_options.has_value() ? stream_options->num_device_to_host_streams
                                  : kNumDeviceToHostStreams;
@@ -56,13 +59,16 @@ LocalDeviceState::LocalDeviceState(se::StreamExecutor* executor,
   if (stream_options.has_value()) {
     compute_stream_->implementation()->SetPriority(stream_options->priority);
   }
-  host_to_device_stream_ = std::make_unique<se::Stream>(executor);
-  if (stream_options.has_value()) {
-    host_to_device_stream_->implementation()->SetPriority(
-        stream_options->priority);
-  }
   compute_stream_->Init();
-  host_to_device_stream_->Init();
+  host_to_device_streams_.reserve(num_host_to_device_streams);
+  for (int i = 0; i < num_host_to_device_streams; ++i) {
+    auto stream = std::make_unique<se::Stream>(executor);
+    if (stream_options.has_value()) {
+      stream->implementation()->SetPriority(stream_options->priority);
+    }
+    stream->Init();
+    host_to_device_streams_.push_back(std::move(stream));
+  }
   if (use_callback_stream) {
     callback_stream_map_ =
         absl::flat_hash_map<se::Stream*, std::unique_ptr<se::Stream>>();
@@ -160,6 +166,14 @@ se::Stream* LocalDeviceState::GetDeviceToHostStream() {
   return device_to_host_streams_.at(i).get();
 }
 
+se::Stream* LocalDeviceState::GetHostToDeviceStream() {
+  absl::MutexLock lock(&mu_);
+  int i = next_host_to_device_stream_;
+  next_host_to_device_stream_ =
+      (next_host_to_device_stream_ + 1) % host_to_device_streams_.size();
+  return host_to_device_streams_.at(i).get();
+}
+
 se::Stream* LocalDeviceState::GetDeviceToDeviceStream() {
   absl::MutexLock lock(&mu_);
   int i = next_device_to_device_stream_;
@@ -102,7 +102,10 @@ class PjRtCApiDevice : public PjRtDevice {
 
 class PjRtCApiClient : public PjRtClient {
  public:
-  PjRtCApiClient(const PJRT_Api* c_api, PJRT_Client* c_client);
+  PjRtCApiClient(
+      const PJRT_Api* c_api, PJRT_Client* c_client,
+      std::unique_ptr<::pjrt::PJRT_KeyValueCallbackData> kv_callback_data =
+          nullptr);
 
   int process_index() const override;
 
@@ -241,6 +244,9 @@ class PjRtCApiClient : public PjRtClient {
   void InitDevices();
 
   const PJRT_Api* c_api_;
+  // Used by the key-value store callbacks of `c_client_`, so it must be
+  // destroyed after it.
+  std::unique_ptr<::pjrt::PJRT_KeyValueCallbackData> kv_callback_data_;
   std::unique_ptr<PJRT_Client, ::pjrt::PJRT_ClientDeleter> c_client_;
 
   std::vector<std::unique_ptr<PjRtCApiDevice>> owned_devices_;
@@ -535,9 +541,13 @@ class CApiCopyToDeviceStream : public CopyToDeviceStream {
   const PJRT_Api* c_api_;
 };
 
+// `kv_get` and `kv_put` give the plugin access to a key-value store shared by
+// all the nodes of a multi-node client, e.g. the distributed runtime client.
 StatusOr<std::unique_ptr<PjRtClient>> GetCApiClient(
     absl::string_view device_type,
-    const absl::flat_hash_map<std::string, PjRtValueType>& create_options = {});
+    const absl::flat_hash_map<std::string, PjRtValueType>& create_options = {},
+    PjRtClient::KeyValueGetCallback kv_get = nullptr,
+    PjRtClient::KeyValuePutCallback kv_put = nullptr);
 
 StatusOr<std::unique_ptr<PjRtTopologyDescription>> GetCApiTopology(
     absl::string_view device_type);
@@ -678,6 +678,14 @@ PjRtStreamExecutorBuffer::ReleaseDeviceMemoryOwnership(
   return ref;
 }
 
+// Size of the chunks in which large arrays are staged for host to device
+// transfers.
+static constexpr int64_t kHostToDeviceChunkBytes = 8 << 20;
+
+// Minimum number of bytes each thread handles when a layout-changing copy of a
+// host buffer is split across the client's thread pool.
+static constexpr int64_t kMinTransposeBytesPerThread = 1 << 20;
+
 StatusOr<std::unique_ptr<PjRtBuffer>>
 PjRtStreamExecutorClient::BufferFromHostBuffer(
     const void* data, PrimitiveType type, absl::Span<int64_t const> dims,
@@ -770,22 +778,38 @@ PjRtStreamExecutorClient::BufferFromHostBuffer(
     }
   }
 
+  // Independent transfers are spread over the host to device streams so that
+  // they can run concurrently.
+  se::Stream* h2d_stream = local_device->GetHostToDeviceStream();
   TF_ASSIGN_OR_RETURN(
       std::unique_ptr<PjRtStreamExecutorBuffer> py_buffer,
-      AllocateDestinationBuffer(device_shape, device, local_device,
-                                local_device->host_to_device_stream(),
+      AllocateDestinationBuffer(device_shape, device, local_device, h2d_stream,
                                 /*is_uninitialized_create=*/false, this));
 
   PjRtStreamExecutorBuffer::ScopedHold device_buffer(
       py_buffer->GetBufferWithUsageHold());
   CHECK(device_buffer.ok());
 
+  // Large arrays that are staged on a separate thread are staged in chunks,
+  // so that the transfer of each chunk overlaps copying the next one into the
+  // staging memory instead of waiting for the whole array to be copied. This
+  // requires the device representation of the array to be its host
+  // representation.
+  bool chunked_transfer =
+      host_buffer_semantics != HostBufferSemantics::kImmutableOnlyDuringCall &&
+      should_stage_host_to_device_transfers() &&
+      host_and_device_strides_equal && size > kHostToDeviceChunkBytes &&
+      device_shape.IsArray() && device_shape.is_static() &&
+      device_shape.layout().tiles().empty() &&
+      transfer_manager->GetByteSizeRequirement(device_shape) == size;
+
   // If necessary, allocate a host-side buffer for staging host-to-device
   // transfers. On GPU this is a buffer in pinned memory.
   std::shared_ptr<void> staging_buffer;
-  if (host_buffer_semantics == HostBufferSemantics::kImmutableOnlyDuringCall ||
-      should_stage_host_to_device_transfers() ||
-      !host_and_device_strides_equal) {
+  if (!chunked_transfer &&
+      (host_buffer_semantics == HostBufferSemantics::kImmutableOnlyDuringCall ||
+       should_stage_host_to_device_transfers() ||
+       !host_and_device_strides_equal)) {
     void* ptr = host_memory_allocator()->AllocateRaw(
         tsl::Allocator::kAllocatorAlignment, size);
     staging_buffer = std::shared_ptr<void>(
@@ -799,11 +823,23 @@ PjRtStreamExecutorClient::BufferFromHostBuffer(
     absl::InlinedVector<int64_t, 4> permutation(dims.size());
     absl::c_reverse_copy(device_shape.layout().minor_to_major(),
                          permutation.begin());
+    // A transpose performed on the calling thread may be split across the
+    // thread pool; one performed as part of the asynchronous transfer below
+    // already runs on the thread pool and must not block waiting for it.
+    int num_threads = 1;
+    if (host_buffer_semantics ==
+        HostBufferSemantics::kImmutableOnlyDuringCall) {
+      num_threads = std::clamp<int64_t>(size / kMinTransposeBytesPerThread, 1,
+                                        thread_pool()->NumThreads());
+    }
     absl::MutexLock lock(&transpose_mu_);
-    TF_ASSIGN_OR_RETURN(transpose,
-                        transpose_cache_.GetOrCreate(
-                            primitive_util::ByteWidth(type), dims, permutation,
-                            TransposePlan::Striding{*byte_strides}));
+    TF_ASSIGN_OR_RETURN(
+        transpose,
+        transpose_cache_.GetOrCreate(
+            primitive_util::ByteWidth(type), dims, permutation,
+            TransposePlan::Striding{*byte_strides},
+            /*output_tiling=*/TransposePlan::Tiling{},
+            TransposePlan::Transformation::kNone, num_threads));
   }
 
   // Copy the buffer into a staging buffer before returning control to the
@@ -812,7 +848,11 @@ PjRtStreamExecutorClient::BufferFromHostBuffer(
   // thread.
   if (host_buffer_semantics == HostBufferSemantics::kImmutableOnlyDuringCall) {
     if (transpose) {
-      transpose->Execute(data, staging_buffer.get());
+      transpose->Execute(
+          data, staging_buffer.get(),
+          [this](std::function<void()> fn) {
+            thread_pool()->Schedule(std::move(fn));
+          });
     } else {
       std::memcpy(staging_buffer.get(), data, size);
     }
@@ -829,13 +869,15 @@ PjRtStreamExecutorClient::BufferFromHostBuffer(
   // TODO(misard) assess if it would be preferable to introduce a heuristic to
   // put the transfer into the calling thread for small literals.
   auto transfer_h2d =
-      [local_client = client(), transfer_manager, local_device, data, size,
+      [local_client = client(), transfer_manager, local_device, h2d_stream,
+       host_memory_allocator = host_memory_allocator(), data, size,
        movable_device_buffer{device_buffer.ToClosure()}, device_shape,
        py_buffer{py_buffer.get()},
        on_device_shape{py_buffer->on_device_shape()},
        staging_buffer{std::move(staging_buffer)},
        on_done_with_host_buffer{std::move(on_done_with_host_buffer)},
-       host_buffer_semantics, transpose{std::move(transpose)}]() {
+       host_buffer_semantics, transpose{std::move(transpose)},
+       chunked_transfer]() {
         PjRtStreamExecutorBuffer::ScopedHold device_buffer(
             movable_device_buffer);
         // This function uses TF_CHECK_OK and value() since we have no way
@@ -848,7 +890,26 @@ PjRtStreamExecutorClient::BufferFromHostBuffer(
         // If applicable on the backend, stage the transfer via host memory
         // allocated via the host_memory_allocator. On GPU, this is pinned
         // memory.
-        if (staging_buffer) {
+        if (chunked_transfer) {
+          se::DeviceMemoryBase device_memory = buffer.root_buffer();
+          for (int64_t offset = 0; offset < size;
+               offset += kHostToDeviceChunkBytes) {
+            int64_t chunk_size =
+                std::min<int64_t>(kHostToDeviceChunkBytes, size - offset);
+            void* chunk = host_memory_allocator->AllocateRaw(
+                tsl::Allocator::kAllocatorAlignment, chunk_size);
+            std::memcpy(chunk, static_cast<const char*>(data) + offset,
+                        chunk_size);
+            se::DeviceMemoryBase device_chunk(
+                static_cast<char*>(device_memory.opaque()) + offset,
+                chunk_size);
+            h2d_stream->ThenMemcpy(&device_chunk, chunk, chunk_size);
+            local_device->ThenExecuteCallback(
+                h2d_stream, [chunk, host_memory_allocator]() {
+                  host_memory_allocator->DeallocateRaw(chunk);
+                });
+          }
+        } else if (staging_buffer) {
           // If we didn't already copy the input buffer into the staging buffer,
           // do so now.
           if (host_buffer_semantics !=
@@ -865,24 +926,23 @@ PjRtStreamExecutorClient::BufferFromHostBuffer(
               static_cast<const char*>(staging_buffer.get()),
               ShapeUtil::DeviceShapeToHostShape(on_device_shape));
           TF_CHECK_OK(transfer_manager->TransferLiteralToDeviceAsync(
-              local_device->host_to_device_stream(), literal, buffer));
+              h2d_stream, literal, buffer));
         } else {
           BorrowingLiteral literal(
               reinterpret_cast<const char*>(data),
               ShapeUtil::DeviceShapeToHostShape(on_device_shape));
           // Otherwise, just transfer the literal.
           TF_CHECK_OK(transfer_manager->TransferLiteralToDeviceAsync(
-              local_device->host_to_device_stream(), literal, buffer));
+              h2d_stream, literal, buffer));
         }
 
         std::shared_ptr<BufferSequencingEvent> event =
             device_buffer->definition_events()[0];
         TF_CHECK_OK(AddDestinationBufferSynchronization(
-            local_device, std::move(device_buffer), event,
-            local_device->host_to_device_stream()));
+            local_device, std::move(device_buffer), event, h2d_stream));
 
         local_device->ThenExecuteCallback(
-            local_device->host_to_device_stream(),
+            h2d_stream,
             [staging_buffer{std::move(staging_buffer)},
              on_done_with_host_buffer{std::move(on_done_with_host_buffer)}]() {
               if (on_done_with_host_buffer) {
@@ -957,10 +1017,10 @@ PjRtStreamExecutorClient::BufferFromHostLiteral(const LiteralSlice& literal,
   TF_ASSIGN_OR_RETURN(
       Shape compact_shape,
       transfer_manager->ChooseCompactLayoutForShape(literal.shape()));
+  se::Stream* h2d_stream = local_device->GetHostToDeviceStream();
   TF_ASSIGN_OR_RETURN(
       std::unique_ptr<PjRtStreamExecutorBuffer> py_buffer,
-      AllocateDestinationBuffer(compact_shape, device, local_device,
-                                local_device->host_to_device_stream(),
+      AllocateDestinationBuffer(compact_shape, device, local_device, h2d_stream,
                                 /*is_uninitialized_create=*/false, this));
 
   PjRtStreamExecutorBuffer::ScopedHold device_buffer(
@@ -974,6 +1034,7 @@ PjRtStreamExecutorClient::BufferFromHostLiteral(const LiteralSlice& literal,
   // TODO(misard) assess if it would be preferable to introduce a heuristic to
   // put the transfer into the calling thread for small literals.
   auto transfer_h2d = [local_client = client(), transfer_manager, local_device,
+                       h2d_stream,
                        movable_device_buffer{device_buffer.ToClosure()},
                        literal, py_buffer{py_buffer.get()},
                        on_device_shape{py_buffer->on_device_shape()}]() {
@@ -984,7 +1045,6 @@ PjRtStreamExecutorClient::BufferFromHostLiteral(const LiteralSlice& literal,
     // memory that has already been allocated, and a possible Event
     // allocation.
 
-    se::Stream* h2d_stream = local_device->host_to_device_stream();
     ShapedBuffer buffer = device_buffer->AsShapedBuffer(on_device_shape);
     TF_CHECK_OK(transfer_manager->TransferLiteralToDeviceAsync(
         h2d_stream, literal, buffer));
@@ -22,6 +22,8 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Analysis/TargetLibraryInfo.h"
 #include "llvm/Analysis/TargetTransformInfo.h"
@@ -98,6 +100,17 @@ llvm::Expected<std::unique_ptr<llvm::MemoryBuffer>> CompilerFunctor::operator()(
     pre_optimization_hook_(module);
   }
 
+  // The key must be computed before the module is optimized in place.
+  std::string object_cache_key;
+  if (object_cache_) {
+    object_cache_key = DiskObjectCache::Key(module, ObjectCacheOptions());
+    if (std::unique_ptr<llvm::MemoryBuffer> object =
+            object_cache_->Lookup(object_cache_key)) {
+      RunPostCodegenHook(*object);
+      return std::move(object);
+    }
+  }
+
   llvm::OptimizationLevel opt_level;
   if (optimize_for_size_) {
     opt_level = llvm::OptimizationLevel::Os;
@@ -203,17 +216,41 @@ llvm::Expected<std::unique_ptr<llvm::MemoryBuffer>> CompilerFunctor::operator()(
   std::unique_ptr<llvm::MemoryBuffer> memory_buffer(
       new llvm::SmallVectorMemoryBuffer(std::move(stream_buffer)));
 
+  if (object_cache_) {
+    object_cache_->Store(object_cache_key, memory_buffer->getMemBufferRef());
+  }
+  RunPostCodegenHook(*memory_buffer);
+
+  return std::move(memory_buffer);
+}
+
+std::string CompilerFunctor::ObjectCacheOptions() const {
+  std::string fast_math_flags;
+  llvm::raw_string_ostream fast_math_flags_stream(fast_math_flags);
+  fast_math_flags_.print(fast_math_flags_stream);
+  fast_math_flags_stream.flush();
+  return absl::StrCat(
+      target_machine_->getTargetTriple().str(), ";",
+      target_machine_->getTargetCPU().str(), ";",
+      target_machine_->getTargetFeatureString().str(), ";", opt_level_, ";",
+      optimize_for_size_, ";", disable_expensive_passes_, ";",
+      disable_slp_vectorizer_, ";", fast_math_flags, ";", dfsan_enabled_, ";",
+      absl::StrJoin(dfsan_abi_list_files_, ","), ";",
+      absl::StrJoin(convert_to_xla_runtime_abi_, ","));
+}
+
+void CompilerFunctor::RunPostCodegenHook(
+    const llvm::MemoryBuffer& memory_buffer) const {
   if (post_codegen_hook_) {
     llvm::Expected<std::unique_ptr<llvm::object::ObjectFile>> obj_file =
-        llvm::object::ObjectFile::createObjectFile(*memory_buffer);
+        llvm::object::ObjectFile::createObjectFile(
+            memory_buffer.getMemBufferRef());
     if (obj_file) {
       post_codegen_hook_(*obj_file.get());
     } else {
       LOG(WARNING) << "Could convert memory buffer to object file!";
     }
   }
-
-  return std::move(memory_buffer);
 }
 
 }  // namespace cpu
@@ -17,6 +17,7 @@ limitations under the License.
 #define TENSORFLOW_COMPILER_XLA_SERVICE_CPU_COMPILER_FUNCTOR_H_
 
 #include <functional>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -27,6 +28,7 @@ limitations under the License.
 #include "llvm/IR/Operator.h"
 #include "llvm/Object/ObjectFile.h"
 #include "llvm/Target/TargetMachine.h"
+#include "tensorflow/compiler/xla/service/cpu/object_cache.h"
 #include "tensorflow/compiler/xla/service/llvm_compiler.h"
 #include "tensorflow/tsl/platform/logging.h"
 
@@ -47,7 +49,8 @@ class CompilerFunctor : public llvm::orc::IRCompileLayer::IRCompiler {
           nullptr,
       bool dfsan_enabled = false,
       const std::vector<std::string>& dfsan_abi_list_files = {},
-      const std::vector<std::string>& convert_to_xla_runtime_abi = {})
+      const std::vector<std::string>& convert_to_xla_runtime_abi = {},
+      const std::string& object_cache_dir = "")
       : IRCompiler(llvm::orc::IRSymbolMapper::ManglingOptions()),
         target_machine_(target_machine),
         opt_level_(opt_level),
@@ -60,13 +63,21 @@ class CompilerFunctor : public llvm::orc::IRCompileLayer::IRCompiler {
         post_codegen_hook_(std::move(post_codegen_hook)),
         dfsan_enabled_(dfsan_enabled),
         dfsan_abi_list_files_(dfsan_abi_list_files),
-        convert_to_xla_runtime_abi_(convert_to_xla_runtime_abi) {}
+        convert_to_xla_runtime_abi_(convert_to_xla_runtime_abi) {
+    if (!object_cache_dir.empty()) object_cache_.emplace(object_cache_dir);
+  }
 
   // Compile a Module to an ObjectFile.
   llvm::Expected<std::unique_ptr<llvm::MemoryBuffer>> operator()(
       llvm::Module& module) override;
 
  private:
+  // Returns a description of the target and the options that determine the
+  // object code, for the object cache key.
+  std::string ObjectCacheOptions() const;
+
+  void RunPostCodegenHook(const llvm::MemoryBuffer& memory_buffer) const;
+
   llvm::TargetMachine* target_machine_;
   const unsigned opt_level_;
   const bool optimize_for_size_;
@@ -79,6 +90,9 @@ class CompilerFunctor : public llvm::orc::IRCompileLayer::IRCompiler {
   const bool dfsan_enabled_ = false;
   const std::vector<std::string> dfsan_abi_list_files_;
   const std::vector<std::string> convert_to_xla_runtime_abi_;
+  // If set, objects are looked up here before optimizing and compiling a
+  // module, and stored here after compiling one.
+  std::optional<DiskObjectCache> object_cache_;
 };
 
 }  // namespace cpu
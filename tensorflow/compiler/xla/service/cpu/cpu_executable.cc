@@ -52,6 +52,7 @@ limitations under the License.
 #include "tensorflow/compiler/xla/xla_data.pb.h"
 #include "tensorflow/tsl/platform/env.h"
 #include "tensorflow/tsl/platform/logging.h"
+#include "tensorflow/tsl/platform/mem.h"
 
 namespace xla {
 namespace cpu {
@@ -78,6 +79,7 @@ CpuExecutable::CpuExecutable(
     XlaDebugInfoManager::Get()->RegisterModule(
         module().unique_id(), shared_module(), buffer_assignment_);
   }
+  InitializeTempArenaLayout();
 
   // Resolve symbols in the constructor rather than at execution time to avoid
   // races because FindSymbol is not thread safe.
@@ -113,6 +115,7 @@ CpuExecutable::CpuExecutable(
     XlaDebugInfoManager::Get()->RegisterModule(
         module().unique_id(), shared_module(), buffer_assignment_);
   }
+  InitializeTempArenaLayout();
 }
 
 CpuExecutable::~CpuExecutable() {
@@ -121,6 +124,61 @@ CpuExecutable::~CpuExecutable() {
   }
 }
 
+// Alignment of the buffers in a temp arena, which matches the alignment of
+// the buffers returned by the default allocator.
+static constexpr int64_t kTempArenaAlignment = 64;
+
+void CpuExecutable::TempArenaDeleter::operator()(char* arena) const {
+  tsl::port::AlignedFree(arena);
+}
+
+void CpuExecutable::InitializeTempArenaLayout() {
+  if (!assignment_ || !has_module() ||
+      !module().config().debug_options().xla_cpu_reuse_temp_buffers()) {
+    return;
+  }
+  temp_arena_offsets_.assign(assignment_->Allocations().size(), -1);
+  for (const BufferAllocation& allocation : assignment_->Allocations()) {
+    // Buffers that are live out are moved into the result of the execution,
+    // so they must be allocated separately.
+    if (allocation.is_entry_computation_parameter() ||
+        allocation.is_constant() || allocation.is_thread_local() ||
+        allocation.maybe_live_out() || allocation.size() == 0) {
+      continue;
+    }
+    temp_arena_offsets_[allocation.index()] = temp_arena_size_;
+    temp_arena_size_ += RoundUpTo(allocation.size(), kTempArenaAlignment);
+  }
+  VLOG(2) << "Temp arena of module " << module().name() << " has "
+          << temp_arena_size_ << " bytes";
+}
+
+CpuExecutable::TempArena CpuExecutable::AcquireTempArena() {
+  if (temp_arena_size_ == 0) return nullptr;
+  {
+    absl::MutexLock lock(&temp_arenas_mu_);
+    if (!free_temp_arenas_.empty()) {
+      TempArena arena = std::move(free_temp_arenas_.back());
+      free_temp_arenas_.pop_back();
+      return arena;
+    }
+  }
+  VLOG(2) << "Allocating a temp arena of " << temp_arena_size_
+          << " bytes for module " << module().name();
+  TempArena arena(static_cast<char*>(
+      tsl::port::AlignedMalloc(temp_arena_size_, kTempArenaAlignment)));
+  CHECK(arena != nullptr) << "Failed to allocate a temp arena of "
+                          << temp_arena_size_ << " bytes";
+  // See the comment in MemoryForAllocation.
+  ABSL_ANNOTATE_MEMORY_IS_INITIALIZED(arena.get(), temp_arena_size_);
+  return arena;
+}
+
+void CpuExecutable::ReleaseTempArena(TempArena arena) {
+  absl::MutexLock lock(&temp_arenas_mu_);
+  free_temp_arenas_.push_back(std::move(arena));
+}
+
 static StatusOr<MaybeOwningDeviceMemory> MemoryForAllocation(
     const BufferAllocation& allocation,
     absl::Span<ExecutionInput const> arguments,
@@ -159,7 +217,7 @@ static StatusOr<MaybeOwningDeviceMemory> MemoryForAllocation(
 
 StatusOr<std::vector<MaybeOwningDeviceMemory>> CpuExecutable::CreateBufferTable(
     se::DeviceMemoryAllocator* memory_allocator, int device_ordinal,
-    absl::Span<ExecutionInput const> arguments) {
+    absl::Span<ExecutionInput const> arguments, char* temp_arena) {
   std::vector<MaybeOwningDeviceMemory> buffers(
       assignment_->Allocations().size());
   VLOG(3) << "Allocating " << assignment_->Allocations().size()
@@ -167,6 +225,14 @@ StatusOr<std::vector<MaybeOwningDeviceMemory>> CpuExecutable::CreateBufferTable(
   for (BufferAllocation::Index i = 0; i < assignment_->Allocations().size();
        ++i) {
     const BufferAllocation& allocation = assignment_->GetAllocation(i);
+    if (temp_arena != nullptr && temp_arena_offsets_[i] >= 0) {
+      VLOG(3) << allocation.ToString();
+      VLOG(3) << "buffer is in the temp arena at offset "
+              << temp_arena_offsets_[i];
+      buffers[i] = MaybeOwningDeviceMemory{se::DeviceMemoryBase(
+          temp_arena + temp_arena_offsets_[i], allocation.size())};
+      continue;
+    }
     TF_ASSIGN_OR_RETURN(
         buffers[i], MemoryForAllocation(allocation, arguments, memory_allocator,
                                         device_ordinal));
@@ -622,10 +688,11 @@ StatusOr<ExecutionOutput> CpuExecutable::ExecuteAsyncOnStream(
       run_options->stream()->implementation());
   se::Stream* stream = run_options->stream();
   se::DeviceMemoryAllocator* memory_allocator = run_options->allocator();
+  TempArena temp_arena = AcquireTempArena();
   TF_ASSIGN_OR_RETURN(
       std::vector<MaybeOwningDeviceMemory> buffers,
       CreateBufferTable(memory_allocator, stream->parent()->device_ordinal(),
-                        arguments));
+                        arguments, temp_arena.get()));
 
   TF_ASSIGN_OR_RETURN(
       ExecutionOutput result,
@@ -646,17 +713,23 @@ StatusOr<ExecutionOutput> CpuExecutable::ExecuteAsyncOnStream(
     ServiceExecutableRunOptions run_options;
     std::shared_ptr<std::vector<MaybeOwningDeviceMemory>> task_buffers;
     HloExecutionProfile* hlo_execution_profile;
+    std::shared_ptr<TempArena> temp_arena;
 
     Status operator()() {
-      return executable->ExecuteComputeFunction(
+      Status status = executable->ExecuteComputeFunction(
           &run_options.run_options(), *task_buffers, hlo_execution_profile);
+      // Return the arena as soon as the computation is done: the task itself
+      // may only be destroyed after the executable.
+      if (*temp_arena) executable->ReleaseTempArena(std::move(*temp_arena));
+      return status;
     }
   };
   host_stream->EnqueueTaskWithStatus(
       AsyncRunTask{this, *run_options,
                    std::make_shared<std::vector<MaybeOwningDeviceMemory>>(
                        std::move(buffers)),
-                   hlo_execution_profile});
+                   hlo_execution_profile,
+                   std::make_shared<TempArena>(std::move(temp_arena))});
 
   MarkToBeReleasedArguments(absl::MakeSpan(arguments), result);
   return std::move(result);
@@ -17,6 +17,7 @@ limitations under the License.
 #define TENSORFLOW_COMPILER_XLA_SERVICE_CPU_CPU_EXECUTABLE_H_
 
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <string_view>
@@ -24,6 +25,8 @@ limitations under the License.
 #include <variant>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "tensorflow/compiler/xla/hlo/ir/hlo_instruction.h"
 #include "tensorflow/compiler/xla/hlo/ir/hlo_module.h"
@@ -239,9 +242,30 @@ class CpuExecutable : public Executable {
   //
   //  - buffers_to_free: buffers whose ownership was donated by the caller that
   //    are to be freed by the caller.
+  //
+  // If `temp_arena` is not null, temporary buffers that are not live out are
+  // placed in it instead of being allocated with `memory_allocator`.
   StatusOr<std::vector<MaybeOwningDeviceMemory>> CreateBufferTable(
       se::DeviceMemoryAllocator* memory_allocator, int device_ordinal,
-      absl::Span<ExecutionInput const> arguments);
+      absl::Span<ExecutionInput const> arguments, char* temp_arena = nullptr);
+
+  // Memory for the temporary buffers of one execution, laid out as described
+  // by `temp_arena_offsets_`.
+  struct TempArenaDeleter {
+    void operator()(char* arena) const;
+  };
+  using TempArena = std::unique_ptr<char[], TempArenaDeleter>;
+
+  // Computes the offsets of the temporary buffers in a temp arena.
+  void InitializeTempArenaLayout();
+
+  // Returns a temp arena that is not used by any other execution, allocating
+  // a new one if all of them are in use, or nullptr if temp arenas are not
+  // used by this executable.
+  TempArena AcquireTempArena();
+
+  // Makes `arena` available to subsequent executions.
+  void ReleaseTempArena(TempArena arena);
 
   // Creates an Execution output holding ScopedShapedBuffer for holding the
   // result of the computation, moving buffers out of allocated_buffers and into
@@ -281,6 +305,18 @@ class CpuExecutable : public Executable {
   // If not null, XLA Runtime is enabled.
   std::unique_ptr<XlaRuntimeCpuExecutable> xla_runtime_executable_;
 
+  // Offsets of the allocations in a temp arena, or -1 for the allocations that
+  // are not placed in it, and the size of a temp arena.
+  std::vector<int64_t> temp_arena_offsets_;
+  int64_t temp_arena_size_ = 0;
+
+  // Temp arenas that are not in use by an execution. Arenas are kept when an
+  // execution finishes so that later executions reuse memory that is already
+  // mapped, instead of allocating and faulting it in again; concurrent
+  // executions each take their own arena.
+  absl::Mutex temp_arenas_mu_;
+  std::vector<TempArena> free_temp_arenas_ ABSL_GUARDED_BY(temp_arenas_mu_);
+
   CpuExecutable(const CpuExecutable&) = delete;
   CpuExecutable& operator=(const CpuExecutable&) = delete;
 };
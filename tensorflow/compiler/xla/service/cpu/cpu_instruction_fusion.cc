@@ -49,6 +49,16 @@ bool IsNonComplexNonBatchedMatrixVectorDot(const HloInstruction* hlo) {
          hlo->dot_dimension_numbers().lhs_batch_dimensions_size() == 0;
 }
 
+// Returns true if `hlo` is a non-batched F32 or F64 matrix-matrix dot that is
+// emitted as a call to the MKL GEMM, which can accumulate into the output.
+bool IsNonBatchedMklMatrixMatrixDot(const HloInstruction* hlo) {
+  const Shape& hlo_shape = hlo->shape();
+  return hlo->opcode() == HloOpcode::kDot && hlo_shape.dimensions_size() == 2 &&
+         (hlo_shape.element_type() == F32 || hlo_shape.element_type() == F64) &&
+         hlo->dot_dimension_numbers().lhs_batch_dimensions_size() == 0 &&
+         hlo->GetModule()->config().debug_options().xla_cpu_use_mkl_dnn();
+}
+
 bool HasExactlyOneUse(const HloInstruction& hlo_instr) {
   return hlo_instr.user_count() == 1 &&
          absl::c_count(hlo_instr.users().front()->operands(), &hlo_instr) == 1;
@@ -56,9 +66,19 @@ bool HasExactlyOneUse(const HloInstruction& hlo_instr) {
 
 bool CanBeOutputFused(const HloInstruction* producer,
                       const HloInstruction* consumer) {
-  return consumer->opcode() == HloOpcode::kAdd &&
-         IsNonComplexNonBatchedMatrixVectorDot(producer) &&
-         HasExactlyOneUse(*producer) == 1;
+  if (consumer->opcode() != HloOpcode::kAdd || !HasExactlyOneUse(*producer)) {
+    return false;
+  }
+  if (IsNonComplexNonBatchedMatrixVectorDot(producer)) {
+    return true;
+  }
+  // The GEMM accumulates into a copy of the addend, so the addend (the bias or
+  // the residual) has to have the layout of the dot.
+  const HloInstruction* addend =
+      consumer->operand(consumer->operand(0) == producer ? 1 : 0);
+  return IsNonBatchedMklMatrixMatrixDot(producer) &&
+         ShapeUtil::Equal(producer->shape(), consumer->shape()) &&
+         ShapeUtil::Equal(addend->shape(), consumer->shape());
 }
 
 bool CanBeOutputFusedIntoSomeOperand(const HloInstruction* consumer) {
@@ -688,6 +688,22 @@ TEST_F(OpcodeFusionTest, DotAddOutputFusion_19x50x19) {
               Not(op::Fusion()));
 }
 
+TEST_F(OpcodeFusionTest, DotAddOutputFusion_19x50x19_Mkl) {
+  auto module = CreateNewVerifiedModule();
+  DebugOptions debug_options = GetDebugOptionsForTest();
+  debug_options.set_xla_cpu_use_mkl_dnn(true);
+  module->config().set_debug_options(debug_options);
+  CreateComputationForDotAddOutputFusionTest(TestName(), module.get(), /*m=*/19,
+                                             /*k=*/50, /*n=*/19,
+                                             /*add_extra_use_for_dot=*/false);
+
+  RunFusionAndCheckOpcodesWereFused(
+      module.get(),
+      {HloOpcode::kDot, HloOpcode::kAdd, HloOpcode::kParameter,
+       HloOpcode::kParameter, HloOpcode::kParameter},
+      HloInstruction::FusionKind::kOutput);
+}
+
 TEST_F(OpcodeFusionTest, DotAddOutputFusion_19x50x1_multi_use) {
   auto module = CreateNewVerifiedModule();
   CreateComputationForDotAddOutputFusionTest(TestName(), module.get(), /*m=*/19,
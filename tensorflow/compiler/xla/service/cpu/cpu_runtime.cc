@@ -96,6 +96,14 @@ extern const char* const kMKLSingleThreadedMatMulF32SymbolName =
     "__xla_cpu_runtime_MKLSingleThreadedMatMulF32";
 extern const char* const kMKLSingleThreadedMatMulF64SymbolName =
     "__xla_cpu_runtime_MKLSingleThreadedMatMulF64";
+extern const char* const kMKLMatMulAddF32SymbolName =
+    "__xla_cpu_runtime_MKLMatMulAddF32";
+extern const char* const kMKLMatMulAddF64SymbolName =
+    "__xla_cpu_runtime_MKLMatMulAddF64";
+extern const char* const kMKLSingleThreadedMatMulAddF32SymbolName =
+    "__xla_cpu_runtime_MKLSingleThreadedMatMulAddF32";
+extern const char* const kMKLSingleThreadedMatMulAddF64SymbolName =
+    "__xla_cpu_runtime_MKLSingleThreadedMatMulAddF64";
 extern const char* const kEigenConv2DF16SymbolName =
     "__xla_cpu_runtime_EigenConv2DF16";
 extern const char* const kEigenConv2DF32SymbolName =
@@ -143,6 +151,8 @@ extern const char* const kStatusIsSuccessSymbolName =
     "__xla_cpu_runtime_StatusIsSuccess";
 extern const char* const kKeyValueSortSymbolName =
     "__xla_cpu_runtime_KeyValueSort";
+extern const char* const kKeyValueSortByKeySymbolName =
+    "__xla_cpu_runtime_KeyValueSortByKey";
 extern const char* const kTopKF32SymbolName = "__xla_cpu_runtime_TopKF32";
 extern const char* const kTracingStartSymbolName =
     "__xla_cpu_runtime_TracingStart";
@@ -198,6 +198,11 @@ class DotOpEmitter {
   // one element at a time.
   void EmitNaiveLlvmIrGemm();
 
+  // Initializes the first `size_bytes` bytes of the target, which a GEMM then
+  // accumulates into, with the addend if there is one and with zeros
+  // otherwise.  The addend has the layout of the target, and may alias it.
+  void InitializeTargetForAccumulation(int64_t size_bytes);
+
   // When doing a tiled GEMV in LLVM IR, a "tile" consists of this many vector
   // registers.
   int64_t GetGemvTilingFactor() const {
@@ -213,8 +218,14 @@ class DotOpEmitter {
     // information in one place.
     const std::tuple<int64_t, int64_t, int64_t> kDefaultTileSize =
         std::tuple<int64_t, int64_t, int64_t>(11, 9, 1);
+    // With AVX-512 there are 32 vector registers: keep a 14x2 register tile of
+    // the result in 28 of them and use the rest for the row of the RHS and the
+    // LHS broadcast, like the usual AVX-512 GEMM microkernels.
+    const std::tuple<int64_t, int64_t, int64_t> kAvx512TileSize =
+        std::tuple<int64_t, int64_t, int64_t>(14, 1, 2);
     return options::LlvmIrGemmTileSize(hlo_module_config_)
-        .value_or(kDefaultTileSize);
+        .value_or(target_machine_features_.has_avx512() ? kAvx512TileSize
+                                                        : kDefaultTileSize);
   }
 
   std::array<int64_t, 3> GetMlirGemmTileSize() const {
@@ -270,10 +281,8 @@ Status DotOpEmitter::EmitLinalgMatmul() {
                                  rhs_array_.GetBasePointer()};
   llvm::Value* target_ptr = target_array_.GetBasePointer();
 
-  // Zero out the output buffer.
-  int64_t size_bytes = ShapeUtil::ByteSizeOf(dot_info_.result_shape);
-  b_->CreateMemSet(target_ptr, b_->getInt8(0), /*Size=*/size_bytes,
-                   /*Align=*/llvm::MaybeAlign(1));
+  InitializeTargetForAccumulation(
+      ShapeUtil::ByteSizeOf(dot_info_.result_shape));
 
   std::string name =
       absl::StrCat("linalgMatMul_", dot_info_.result_shape.ToString(true), "_",
@@ -392,10 +401,8 @@ void DotOpEmitter::EmitTiledLlvmIrGemm() {
     std::swap(m, n);
   }
 
-  int64_t size_bytes =
-      m * n * ShapeUtil::ByteSizeOfPrimitiveType(primitive_type);
-  b_->CreateMemSet(target, b_->getInt8(0), /*Size=*/size_bytes,
-                   /*Align=*/llvm::MaybeAlign(1));
+  InitializeTargetForAccumulation(
+      m * n * ShapeUtil::ByteSizeOfPrimitiveType(primitive_type));
 
   int64_t max_target_vector_width =
       target_machine_features_.vector_register_num_elements(
@@ -610,9 +617,21 @@ Status DotOpEmitter::EmitBatch() {
   return EmitCallToBatchRuntime();
 }
 
-void DotOpEmitter::EmitNaiveLlvmIrGemm() {
-  CHECK_EQ(addend_array_, nullptr);
+void DotOpEmitter::InitializeTargetForAccumulation(int64_t size_bytes) {
+  llvm::Value* target = target_array_.GetBasePointer();
+  if (addend_array_ == nullptr) {
+    b_->CreateMemSet(target, b_->getInt8(0), /*Size=*/size_bytes,
+                     /*Align=*/llvm::MaybeAlign(1));
+    return;
+  }
+  CHECK(LayoutUtil::Equal(addend_array_->GetShape().layout(),
+                          target_array_.GetShape().layout()));
+  b_->CreateMemMove(target, /*DstAlign=*/llvm::MaybeAlign(1),
+                    addend_array_->GetBasePointer(),
+                    /*SrcAlign=*/llvm::MaybeAlign(1), /*Size=*/size_bytes);
+}
 
+void DotOpEmitter::EmitNaiveLlvmIrGemm() {
   const Shape& lhs_shape = lhs_array_.GetShape();
   const Shape& rhs_shape = rhs_array_.GetShape();
   const DotDimensionNumbers& dim_nums = dot_info_.dim_nums;
@@ -668,6 +687,24 @@ void DotOpEmitter::EmitNaiveLlvmIrGemm() {
   llvm_ir::IrArray::Index rhs_index(rhs_multi_index, rhs_shape,
                                     b_->getInt64Ty());
 
+  // Create index into target address. The target index is the concatenation of
+  // the rhs and lhs indexes with the reduction dimensions removed. The terms
+  // from the rhs index are the lower dimensions in the index so we add them
+  // first.
+  std::vector<llvm::Value*> target_multi_index;
+  for (int dimension = 0; dimension < lhs_index.size(); ++dimension) {
+    if (dimension != lhs_reduction_dimension) {
+      target_multi_index.push_back(lhs_index[dimension]);
+    }
+  }
+  for (int dimension = 0; dimension < rhs_index.size(); ++dimension) {
+    if (dimension != rhs_reduction_dimension) {
+      target_multi_index.push_back(rhs_index[dimension]);
+    }
+  }
+  llvm_ir::IrArray::Index target_index(
+      target_multi_index, target_array_.GetShape(), lhs_index.GetType());
+
   // For computing the sum of products we alloca a single location to store the
   // dot product result as we accumulate it within the reduction loop. After the
   // reduction loop we load the result and store into the output array.
@@ -681,11 +718,14 @@ void DotOpEmitter::EmitNaiveLlvmIrGemm() {
       b_->CreateAlloca(accum_type, /*ArraySize=*/nullptr, "accum_address");
 
   // Preheader basic block of reduction loop:
-  // - Initialize accumulator to zero.
+  // - Initialize accumulator to zero, or to the addend element.
   llvm::BasicBlock* preheader_bb = reduction_loop->GetPreheaderBasicBlock();
   b_->SetInsertPoint(preheader_bb->getTerminator());
 
-  b_->CreateStore(llvm::Constant::getNullValue(accum_type), accum_address);
+  b_->CreateStore(
+      addend_array_ ? addend_array_->EmitReadArrayElement(target_index, b_)
+                    : llvm::Constant::getNullValue(accum_type),
+      accum_address);
 
   // Body basic block of reduction loop:
   // - Load elements from lhs and rhs array.
@@ -730,25 +770,6 @@ void DotOpEmitter::EmitNaiveLlvmIrGemm() {
   SetToFirstInsertPoint(reduction_loop->GetExitBasicBlock(), b_);
 
   llvm::Value* result = b_->CreateLoad(accum_type, accum_address);
-
-  // Create index into target address. The target index is the concatenation of
-  // the rhs and lhs indexes with the reduction dimensions removed. The terms
-  // from the rhs index are the lower dimensions in the index so we add them
-  // first.
-  std::vector<llvm::Value*> target_multi_index;
-  for (int dimension = 0; dimension < lhs_index.size(); ++dimension) {
-    if (dimension != lhs_reduction_dimension) {
-      target_multi_index.push_back(lhs_index[dimension]);
-    }
-  }
-  for (int dimension = 0; dimension < rhs_index.size(); ++dimension) {
-    if (dimension != rhs_reduction_dimension) {
-      target_multi_index.push_back(rhs_index[dimension]);
-    }
-  }
-
-  llvm_ir::IrArray::Index target_index(
-      target_multi_index, target_array_.GetShape(), lhs_index.GetType());
   target_array_.EmitWriteArrayElement(target_index, result, b_);
 
   // Set the IR builder insert point to the exit basic block of the outer most
@@ -799,11 +820,19 @@ Status DotOpEmitter::EmitCallToRuntime() {
   //          int32_t transpose_rhs);
   // The two transpose_... parameters are actually booleans, but we use int32_t
   // to avoid target-dependent calling convention details.
+  //
+  // The MKL matmul-add functions take a `float* addend` after `rhs`, which
+  // has the layout of `out`, and compute out = addend + lhs * rhs.
 
   bool multi_threaded = ShouldUseMultiThreadedEigen(hlo_module_config_);
   bool use_mkl_dnn = hlo_module_config_.debug_options().xla_cpu_use_mkl_dnn();
   bool use_acl = hlo_module_config_.debug_options().xla_cpu_use_acl();
   PrimitiveType type = target_array_.GetShape().element_type();
+  if (addend_array_ != nullptr) {
+    TF_RET_CHECK(use_mkl_dnn && (type == F32 || type == F64));
+    TF_RET_CHECK(LayoutUtil::Equal(addend_array_->GetShape().layout(),
+                                   target_array_.GetShape().layout()));
+  }
   llvm::Function* function = b_->GetInsertBlock()->getParent();
   llvm::Module* module = function->getParent();
   llvm::Type* float_type;
@@ -816,23 +845,37 @@ Status DotOpEmitter::EmitCallToRuntime() {
       float_type = b_->getHalfTy();
       break;
     case F32:
-      fn_name =
-          multi_threaded
-              ? (use_mkl_dnn ? runtime::kMKLMatMulF32SymbolName
-                             : (use_acl ? runtime::kACLMatMulF32SymbolName
-                                        : runtime::kEigenMatMulF32SymbolName))
-              : (use_mkl_dnn
-                     ? runtime::kMKLSingleThreadedMatMulF32SymbolName
-                     : runtime::kEigenSingleThreadedMatMulF32SymbolName);
+      if (addend_array_ != nullptr) {
+        fn_name = multi_threaded
+                      ? runtime::kMKLMatMulAddF32SymbolName
+                      : runtime::kMKLSingleThreadedMatMulAddF32SymbolName;
+      } else {
+        fn_name =
+            multi_threaded
+                ? (use_mkl_dnn
+                       ? runtime::kMKLMatMulF32SymbolName
+                       : (use_acl ? runtime::kACLMatMulF32SymbolName
+                                  : runtime::kEigenMatMulF32SymbolName))
+                : (use_mkl_dnn
+                       ? runtime::kMKLSingleThreadedMatMulF32SymbolName
+                       : runtime::kEigenSingleThreadedMatMulF32SymbolName);
+      }
       float_type = b_->getFloatTy();
       break;
     case F64:
-      fn_name = multi_threaded
-                    ? (use_mkl_dnn ? runtime::kMKLMatMulF64SymbolName
-                                   : runtime::kEigenMatMulF64SymbolName)
-                    : (use_mkl_dnn
-                           ? runtime::kMKLSingleThreadedMatMulF64SymbolName
-                           : runtime::kEigenSingleThreadedMatMulF64SymbolName);
+      if (addend_array_ != nullptr) {
+        fn_name = multi_threaded
+                      ? runtime::kMKLMatMulAddF64SymbolName
+                      : runtime::kMKLSingleThreadedMatMulAddF64SymbolName;
+      } else {
+        fn_name =
+            multi_threaded
+                ? (use_mkl_dnn ? runtime::kMKLMatMulF64SymbolName
+                               : runtime::kEigenMatMulF64SymbolName)
+                : (use_mkl_dnn
+                       ? runtime::kMKLSingleThreadedMatMulF64SymbolName
+                       : runtime::kEigenSingleThreadedMatMulF64SymbolName);
+      }
       float_type = b_->getDoubleTy();
       break;
     case C64:
@@ -862,11 +905,16 @@ Status DotOpEmitter::EmitCallToRuntime() {
   llvm::Type* int64_type = b_->getInt64Ty();
   llvm::Type* int32_type = b_->getInt32Ty();
   llvm::Type* int8_ptr_type = b_->getInt8Ty()->getPointerTo();
+  std::vector<llvm::Type*> matmul_arg_types = {
+      int8_ptr_type, float_ptr_type, float_ptr_type, float_ptr_type};
+  if (addend_array_ != nullptr) {
+    matmul_arg_types.push_back(float_ptr_type);
+  }
+  matmul_arg_types.insert(matmul_arg_types.end(), {int64_type, int64_type,
+                                                   int64_type, int32_type,
+                                                   int32_type});
   llvm::FunctionType* matmul_type = llvm::FunctionType::get(
-      b_->getVoidTy(),
-      {int8_ptr_type, float_ptr_type, float_ptr_type, float_ptr_type,
-       int64_type, int64_type, int64_type, int32_type, int32_type},
-      /*isVarArg=*/false);
+      b_->getVoidTy(), matmul_arg_types, /*isVarArg=*/false);
 
   llvm::FunctionCallee matmul_func =
       module->getOrInsertFunction(fn_name, matmul_type);
@@ -902,15 +950,23 @@ Status DotOpEmitter::EmitCallToRuntime() {
     std::swap(transpose_lhs, transpose_rhs);
   }
 
-  b_->CreateCall(
-      matmul_func,
-      {b_->CreateBitCast(executable_run_options_value_, int8_ptr_type),
-       b_->CreateBitCast(target_array_.GetBasePointer(), float_ptr_type),
-       b_->CreateBitCast(lhs->GetBasePointer(), float_ptr_type),
-       b_->CreateBitCast(rhs->GetBasePointer(), float_ptr_type),
-       b_->getInt64(mat_mult_dims.m), b_->getInt64(mat_mult_dims.n),
+  std::vector<llvm::Value*> matmul_args = {
+      b_->CreateBitCast(executable_run_options_value_, int8_ptr_type),
+      b_->CreateBitCast(target_array_.GetBasePointer(), float_ptr_type),
+      b_->CreateBitCast(lhs->GetBasePointer(), float_ptr_type),
+      b_->CreateBitCast(rhs->GetBasePointer(), float_ptr_type)};
+  if (addend_array_ != nullptr) {
+    // The addend has the layout of the target, so it is transposed along with
+    // the target when the operands are swapped.
+    matmul_args.push_back(
+        b_->CreateBitCast(addend_array_->GetBasePointer(), float_ptr_type));
+  }
+  matmul_args.insert(
+      matmul_args.end(),
+      {b_->getInt64(mat_mult_dims.m), b_->getInt64(mat_mult_dims.n),
        b_->getInt64(mat_mult_dims.k), b_->getInt32(transpose_lhs),
        b_->getInt32(transpose_rhs)});
+  b_->CreateCall(matmul_func, matmul_args);
   return OkStatus();
 }
 
@@ -1157,20 +1213,26 @@ bool CanEmitTiledLlvmIrGemm(
     const TargetMachineFeatures& target_machine_features) {
   CHECK(IsAlignedGemm(dot_info, target_machine_features));
 
-  if (ShouldUseMultiThreadedEigen(config)) {
-    return false;
-  }
-
   int m = dot_info.result_shape.dimensions(0);
   int k = dot_info.lhs_shape.dimensions(
       dot_info.dim_nums.lhs_contracting_dimensions(0));
   int n = dot_info.result_shape.dimensions(1);
 
+  // On AVX-512 targets the tiled emitter keeps up with Eigen for GEMMs with
+  // few rows, which are too small to amortize dispatching them to the Eigen
+  // thread pool.
+  bool avx512_small_gemm = target_machine_features.has_avx512() && m < 64 &&
+                           k <= 256 && n <= 256;
+
+  if (ShouldUseMultiThreadedEigen(config) && !avx512_small_gemm) {
+    return false;
+  }
+
   if (!options::ForceEnableExperimentalLlvmIrGemm(config)) {
     // TODO(sanjoy):  We should make these numbers micro-arch specific.
     bool small_gemm =
         k <= 128 && ((m <= 32 && n <= 128) || (m <= 128 && n <= 32));
-    if (!small_gemm) {
+    if (!small_gemm && !avx512_small_gemm) {
       return false;
     }
   }
@@ -24,6 +24,7 @@ limitations under the License.
 #include <map>
 #include <memory>
 #include <numeric>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -63,6 +64,7 @@ limitations under the License.
 #include "tensorflow/compiler/xla/service/cpu/ir_emission_utils.h"
 #include "tensorflow/compiler/xla/service/cpu/ir_function.h"
 #include "tensorflow/compiler/xla/service/cpu/parallel_loop_emitter.h"
+#include "tensorflow/compiler/xla/service/cpu/runtime_key_value_sort.h"
 #include "tensorflow/compiler/xla/service/elemental_ir_emitter.h"
 #include "tensorflow/compiler/xla/service/llvm_ir/buffer_assignment_util.h"
 #include "tensorflow/compiler/xla/service/llvm_ir/dynamic_update_slice_util.h"
@@ -555,6 +557,63 @@ Status IrEmitter::HandleOutfeed(HloInstruction* outfeed) {
   return OkStatus();
 }
 
+namespace {
+
+// If `sort` orders its elements by a single less-than or greater-than
+// comparison of its keys, returns how to order the bits of the keys and
+// whether the sort is descending.
+std::optional<std::pair<SortKeyKind, bool>> GetSortByKey(
+    const HloSortInstruction* sort) {
+  const HloInstruction* root = sort->to_apply()->root_instruction();
+  if (root->opcode() != HloOpcode::kCompare ||
+      root->operand(0)->opcode() != HloOpcode::kParameter ||
+      root->operand(1)->opcode() != HloOpcode::kParameter) {
+    return std::nullopt;
+  }
+  int64_t lhs = root->operand(0)->parameter_number();
+  int64_t rhs = root->operand(1)->parameter_number();
+  bool swapped;
+  if (lhs == 0 && rhs == 1) {
+    swapped = false;
+  } else if (lhs == 1 && rhs == 0) {
+    swapped = true;
+  } else {
+    return std::nullopt;
+  }
+  bool descending;
+  switch (root->comparison_direction()) {
+    case ComparisonDirection::kLt:
+      descending = swapped;
+      break;
+    case ComparisonDirection::kGt:
+      descending = !swapped;
+      break;
+    default:
+      return std::nullopt;
+  }
+
+  PrimitiveType type = sort->keys()->shape().element_type();
+  SortKeyKind kind;
+  if (primitive_util::IsUnsignedIntegralType(type)) {
+    kind = SortKeyKind::kUnsigned;
+  } else if (primitive_util::IsSignedIntegralType(type)) {
+    kind = SortKeyKind::kSigned;
+  } else if (type == F16 || type == BF16 || type == F32 || type == F64) {
+    kind = Cast<HloCompareInstruction>(root)->order() == ComparisonOrder::kTotal
+               ? SortKeyKind::kFloatTotalOrder
+               : SortKeyKind::kFloat;
+  } else {
+    return std::nullopt;
+  }
+  int bit_width = primitive_util::BitWidth(type);
+  if (bit_width != 8 && bit_width != 16 && bit_width != 32 && bit_width != 64) {
+    return std::nullopt;
+  }
+  return std::make_pair(kind, descending);
+}
+
+}  // namespace
+
 Status IrEmitter::HandleSort(HloInstruction* hlo) {
   const HloSortInstruction* sort = Cast<HloSortInstruction>(hlo);
   TF_RETURN_IF_ERROR(EmitTargetAddressForOp(sort));
@@ -634,6 +693,24 @@ Status IrEmitter::HandleSort(HloInstruction* hlo) {
     Store(size, slot_in_sizes_alloca);
   }
 
+  // Sorts by a plain comparison of the keys don't need to call the comparator.
+  std::optional<std::pair<SortKeyKind, bool>> sort_by_key = GetSortByKey(sort);
+  if (sort_by_key.has_value() &&
+      sort_dimension_elements <= std::numeric_limits<uint32_t>::max()) {
+    EmitCallToFunc(
+        runtime::kKeyValueSortByKeySymbolName,
+        {b_.getInt64(higher_dimensions), b_.getInt64(sort_dimension_elements),
+         b_.getInt64(lower_dimensions), values,
+         b_.getInt32(sort->operand_count()), sizes,
+         b_.getInt32(static_cast<int32_t>(sort_by_key->first)),
+         b_.getInt1(sort_by_key->second)},
+        b_.getVoidTy());
+    if (sort->values_count() > 0) {
+      llvm_ir::EmitTuple(GetIrArrayFor(sort), destination_addresses, &b_);
+    }
+    return OkStatus();
+  }
+
   auto less_than_function =
       FindOrDie(emitted_functions_,
                 ComputationToEmit{sort->to_apply(), allow_reassociation_});
@@ -0,0 +1,102 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/service/cpu/object_cache.h"
+
+#include <memory>
+#include <string>
+
+#include "absl/strings/escaping.h"
+#include "absl/strings/str_cat.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/Support/raw_ostream.h"
+#include "tensorflow/tsl/platform/env.h"
+#include "tensorflow/tsl/platform/errors.h"
+#include "tensorflow/tsl/platform/fingerprint.h"
+#include "tensorflow/tsl/platform/logging.h"
+#include "tensorflow/tsl/platform/path.h"
+
+namespace xla {
+namespace cpu {
+
+/*static*/ std::string DiskObjectCache::Key(const llvm::Module& module,
+                                            absl::string_view options) {
+  // Object code from different LLVM versions must not be mixed.
+  std::string data = absl::StrCat(LLVM_VERSION_STRING, ";", options, ";");
+  llvm::raw_string_ostream ostream(data);
+  llvm::WriteBitcodeToFile(module, ostream);
+  ostream.flush();
+
+  const tsl::Fprint128 fingerprint = tsl::Fingerprint128(data);
+  absl::string_view fp_bytes(reinterpret_cast<const char*>(&fingerprint),
+                             sizeof(tsl::Fprint128));
+  return absl::BytesToHexString(fp_bytes);
+}
+
+std::string DiskObjectCache::Path(absl::string_view key) const {
+  return tsl::io::JoinPath(directory_, absl::StrCat(key, ".o"));
+}
+
+std::unique_ptr<llvm::MemoryBuffer> DiskObjectCache::Lookup(
+    absl::string_view key) const {
+  tsl::Env* env = tsl::Env::Default();
+  std::string path = Path(key);
+  if (!env->FileExists(path).ok()) {
+    VLOG(2) << "Object cache miss: " << path;
+    return nullptr;
+  }
+  std::string object;
+  if (tsl::Status status = tsl::ReadFileToString(env, path, &object);
+      !status.ok()) {
+    LOG(WARNING) << "Failed to read cached object " << path << ": " << status;
+    return nullptr;
+  }
+  VLOG(1) << "Object cache hit: " << path;
+  return llvm::MemoryBuffer::getMemBufferCopy(object, path);
+}
+
+void DiskObjectCache::Store(absl::string_view key,
+                            llvm::MemoryBufferRef object) const {
+  tsl::Env* env = tsl::Env::Default();
+  if (tsl::Status status = env->RecursivelyCreateDir(directory_);
+      !status.ok() && !tsl::errors::IsAlreadyExists(status)) {
+    LOG(WARNING) << "Failed to create object cache directory " << directory_
+                 << ": " << status;
+    return;
+  }
+
+  // Write to a unique temporary file first, so that concurrent readers never
+  // see a partially written object.
+  std::string path = Path(key);
+  std::string temp_path = path;
+  if (!env->CreateUniqueFileName(&temp_path, ".tmp")) {
+    LOG(WARNING) << "Failed to create a temporary file name for " << path;
+    return;
+  }
+  tsl::Status status = tsl::WriteStringToFile(
+      env, temp_path,
+      absl::string_view(object.getBufferStart(), object.getBufferSize()));
+  if (status.ok()) status = env->RenameFile(temp_path, path);
+  if (!status.ok()) {
+    LOG(WARNING) << "Failed to store object " << path << ": " << status;
+    env->DeleteFile(temp_path).IgnoreError();
+    return;
+  }
+  VLOG(1) << "Stored object in cache: " << path;
+}
+
+}  // namespace cpu
+}  // namespace xla
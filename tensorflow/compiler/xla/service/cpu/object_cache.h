@@ -0,0 +1,65 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_COMPILER_XLA_SERVICE_CPU_OBJECT_CACHE_H_
+#define TENSORFLOW_COMPILER_XLA_SERVICE_CPU_OBJECT_CACHE_H_
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/strings/string_view.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/MemoryBuffer.h"
+
+namespace xla {
+namespace cpu {
+
+// A cache of the object files compiled from LLVM modules, stored as one file
+// per module in a directory so that it outlives the process.
+//
+// Entries are keyed on a fingerprint of the unoptimized module together with
+// everything else that determines the object code, such as the target and the
+// compilation options, so a cached object can be used instead of optimizing
+// and compiling an identical module again. The cache may be shared by several
+// processes: entries are written to a temporary file first and then renamed.
+// Errors reading or writing the cache are logged and otherwise ignored.
+class DiskObjectCache {
+ public:
+  explicit DiskObjectCache(std::string directory)
+      : directory_(std::move(directory)) {}
+
+  // Returns the key of the object code compiled from `module`. `options` must
+  // describe the target machine and all compilation options that influence
+  // the object code.
+  static std::string Key(const llvm::Module& module,
+                         absl::string_view options);
+
+  // Returns the cached object for `key`, or nullptr if there is none.
+  std::unique_ptr<llvm::MemoryBuffer> Lookup(absl::string_view key) const;
+
+  // Stores `object` as the object for `key`.
+  void Store(absl::string_view key, llvm::MemoryBufferRef object) const;
+
+ private:
+  std::string Path(absl::string_view key) const;
+
+  const std::string directory_;
+};
+
+}  // namespace cpu
+}  // namespace xla
+
+#endif  // TENSORFLOW_COMPILER_XLA_SERVICE_CPU_OBJECT_CACHE_H_
@@ -0,0 +1,85 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/service/cpu/object_cache.h"
+
+#include <memory>
+#include <string>
+
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/SourceMgr.h"
+#include "tensorflow/tsl/platform/logging.h"
+#include "tensorflow/tsl/platform/path.h"
+#include "tensorflow/tsl/platform/test.h"
+
+namespace xla {
+namespace cpu {
+namespace {
+
+constexpr char kAddIr[] = R"(
+define i32 @f(i32 %a, i32 %b) {
+  %r = add i32 %a, %b
+  ret i32 %r
+}
+)";
+
+constexpr char kMulIr[] = R"(
+define i32 @f(i32 %a, i32 %b) {
+  %r = mul i32 %a, %b
+  ret i32 %r
+}
+)";
+
+class DiskObjectCacheTest : public ::testing::Test {
+ protected:
+  std::unique_ptr<llvm::Module> Parse(const char* ir) {
+    llvm::SMDiagnostic err;
+    std::unique_ptr<llvm::Module> module =
+        llvm::parseAssemblyString(ir, err, context_);
+    CHECK(module != nullptr);
+    return module;
+  }
+
+  llvm::LLVMContext context_;
+};
+
+TEST_F(DiskObjectCacheTest, KeyDependsOnModuleAndOptions) {
+  std::string add_key = DiskObjectCache::Key(*Parse(kAddIr), "options");
+  EXPECT_EQ(add_key, DiskObjectCache::Key(*Parse(kAddIr), "options"));
+  EXPECT_NE(add_key, DiskObjectCache::Key(*Parse(kMulIr), "options"));
+  EXPECT_NE(add_key, DiskObjectCache::Key(*Parse(kAddIr), "other options"));
+}
+
+TEST_F(DiskObjectCacheTest, StoreAndLookup) {
+  DiskObjectCache cache(tsl::io::JoinPath(tsl::testing::TmpDir(),
+                                          "object_cache_store_and_lookup"));
+  std::string key = DiskObjectCache::Key(*Parse(kAddIr), "options");
+  EXPECT_EQ(cache.Lookup(key), nullptr);
+
+  constexpr char kObject[] = "not really an object file";
+  cache.Store(key, llvm::MemoryBufferRef(kObject, "object"));
+  std::unique_ptr<llvm::MemoryBuffer> object = cache.Lookup(key);
+  ASSERT_NE(object, nullptr);
+  EXPECT_EQ(object->getBuffer(), kObject);
+
+  EXPECT_EQ(cache.Lookup(DiskObjectCache::Key(*Parse(kMulIr), "options")),
+            nullptr);
+}
+
+}  // namespace
+}  // namespace cpu
+}  // namespace xla
@@ -17,6 +17,11 @@ limitations under the License.
 
 #define EIGEN_USE_THREADS
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
 #include "absl/base/dynamic_annotations.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
@@ -29,9 +34,48 @@ limitations under the License.
 using ComputeFunctionType = void (*)(void*, const void*, const void**, void**,
                                      void*, int64_t*, uint64_t*);
 
-// Dispatches 'num_partitions - 1' calls to 'function_ptr' in parallel.
-// Calls 'function_ptr' for first partition inline.
-// Uses blocking counter to synchronize threads after parallel calls complete.
+namespace {
+
+// The state shared by the threads running the partitions of one fork-join.
+// Partitions are not bound to threads: every participating thread claims the
+// next unclaimed partition until none are left. The state is reference
+// counted because workers that are dequeued late may still look at it after
+// all partitions are done and the calling thread has returned.
+struct ForkJoinState {
+  explicit ForkJoinState(int32_t num_partitions)
+      : statuses(num_partitions), done(num_partitions) {}
+
+  // Runs unclaimed partitions until there are none left.
+  void RunPartitions(ComputeFunctionType function, void* result_ptr,
+                     const void* run_options_ptr, void** buffer_table,
+                     int64_t* partitions, int64_t stride,
+                     uint64_t* prof_counters) {
+    const int32_t num_partitions = statuses.size();
+    for (int32_t i = next.fetch_add(1, std::memory_order_relaxed);
+         i < num_partitions; i = next.fetch_add(1, std::memory_order_relaxed)) {
+      function(result_ptr, run_options_ptr, nullptr, buffer_table,
+               &statuses[i], &partitions[i * stride], prof_counters);
+      VLOG(3) << "ParallelForkJoin partition " << i << " done.";
+      done.DecrementCount();
+    }
+  }
+
+  std::atomic<int32_t> next{0};
+  std::vector<XlaCustomCallStatus> statuses;
+  tsl::BlockingCounter done;
+};
+
+}  // namespace
+
+// Runs 'num_partitions' calls to 'function_ptr' in parallel on the intra-op
+// thread pool and the calling thread.
+//
+// Up to 'num_partitions - 1' workers are dispatched to the thread pool. The
+// workers and the calling thread then claim partitions dynamically, so a
+// partition is never stuck behind other work queued on the pool: if workers
+// start late, the calling thread runs their partitions instead of blocking,
+// and threads that finish early pick up more partitions. The calling thread
+// waits only for partitions that are already running.
 //
 // The 'partitions' array has a total number of elements equal to
 // 'num_partitions * num_partitioned_dims * 2' (the '2' is necessary to specify
@@ -73,34 +117,39 @@ ABSL_ATTRIBUTE_NO_SANITIZE_MEMORY void __xla_cpu_runtime_ParallelForkJoin(
   const xla::ExecutableRunOptions* run_options =
       static_cast<const xla::ExecutableRunOptions*>(run_options_ptr);
   CHECK_NE(run_options, nullptr);
-  CHECK_NE(run_options->intra_op_thread_pool(), nullptr);
+  const Eigen::ThreadPoolDevice* thread_pool =
+      run_options->intra_op_thread_pool();
 
   ComputeFunctionType function =
       reinterpret_cast<ComputeFunctionType>(function_ptr);
   // Compute partition stride in 'partitions' array.
   const int64_t stride = 2 * num_partitioned_dims;
 
-  std::vector<XlaCustomCallStatus> statuses(num_partitions);
-
-  // Dispatch 'num_partitions - 1' compute functions to run in parallel.
-  tsl::BlockingCounter bc(num_partitions - 1);
-  for (int32_t i = 1; i < num_partitions; ++i) {
-    const int64_t offset = i * stride;
-    run_options->intra_op_thread_pool()->enqueueNoNotification(
-        [i, function, result_ptr, run_options_ptr, buffer_table, prof_counters,
-         partitions, offset, &bc, &statuses]() {
-          function(result_ptr, run_options_ptr, nullptr, buffer_table,
-                   &statuses[i], &partitions[offset], prof_counters);
-          bc.DecrementCount();
-          VLOG(3) << "ParallelForkJoin partition " << i << " done.";
+  auto state = std::make_shared<ForkJoinState>(num_partitions);
+
+  // Dispatch workers to the thread pool. More workers than threads would only
+  // find all partitions claimed. Without a thread pool, which AOT compiled
+  // code may be run with, all partitions run on the calling thread.
+  const int32_t num_workers =
+      thread_pool == nullptr
+          ? 0
+          : std::min<int32_t>(num_partitions - 1, thread_pool->numThreads());
+  for (int32_t i = 0; i < num_workers; ++i) {
+    thread_pool->enqueueNoNotification(
+        [state, function, result_ptr, run_options_ptr, buffer_table,
+         partitions, stride, prof_counters]() {
+          state->RunPartitions(function, result_ptr, run_options_ptr,
+                               buffer_table, partitions, stride,
+                               prof_counters);
         });
   }
 
-  // Call first compute function inline.
-  function(result_ptr, run_options_ptr, params, buffer_table, &statuses[0],
-           &partitions[0], prof_counters);
-  VLOG(3) << "ParallelForkJoin partition 0 done.";
-  bc.Wait();
+  // Run partitions on the calling thread as well, then wait for the ones
+  // claimed by workers.
+  state->RunPartitions(function, result_ptr, run_options_ptr, buffer_table,
+                       partitions, stride, prof_counters);
+  state->done.Wait();
+  const std::vector<XlaCustomCallStatus>& statuses = state->statuses;
 
   // Collect all error messages (if any).
   std::vector<std::pair<int32_t, absl::string_view>> error_messages;
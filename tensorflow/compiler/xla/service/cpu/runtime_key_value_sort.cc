@@ -15,14 +15,186 @@ limitations under the License.
 #include "tensorflow/compiler/xla/service/cpu/runtime_key_value_sort.h"
 
 #include <algorithm>
+#include <array>
 #include <cstring>
 #include <memory>
 #include <numeric>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "absl/base/dynamic_annotations.h"
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
 
+namespace {
+
+using xla::cpu::SortKeyKind;
+
+// Reorders the 'n' elements of a row, which starts at 'row' and has
+// 'element_size' bytes between consecutive elements, such that the i-th
+// element becomes the element at 'indices[i]'. 'scratch' must hold 'n'
+// elements.
+template <typename Index>
+void ReorderRow(char* row, int64_t stride, int32_t element_size,
+                const Index* indices, int64_t n, char* scratch) {
+  for (int64_t i = 0; i < n; ++i) {
+    std::memcpy(scratch + i * element_size, row + indices[i] * stride,
+                element_size);
+  }
+  for (int64_t i = 0; i < n; ++i) {
+    std::memcpy(row + i * stride, scratch + i * element_size, element_size);
+  }
+}
+
+// Returns 'x', the bits of a key of kind 'kKind', mapped to an unsigned
+// integer such that the integers are ordered like the keys.
+template <SortKeyKind kKind, typename UInt>
+UInt ToOrderedBits(UInt x) {
+  constexpr UInt kSignBit = UInt{1} << (sizeof(UInt) * 8 - 1);
+  if constexpr (kKind == SortKeyKind::kUnsigned) {
+    return x;
+  } else if constexpr (kKind == SortKeyKind::kSigned) {
+    return x ^ kSignBit;
+  } else {
+    if constexpr (kKind == SortKeyKind::kFloat) {
+      // -0 and +0 are equivalent.
+      if (x == kSignBit) x = 0;
+    }
+    // Negative numbers are ordered by descending magnitude, positive numbers
+    // by ascending magnitude.
+    return (x & kSignBit) ? ~x : (x | kSignBit);
+  }
+}
+
+template <SortKeyKind kKind, typename UInt>
+void LoadKeys(const char* row, int64_t stride, int64_t n, bool descending,
+              UInt* keys) {
+  for (int64_t i = 0; i < n; ++i) {
+    UInt x;
+    std::memcpy(&x, row + i * stride, sizeof(UInt));
+    UInt ordered = ToOrderedBits<kKind>(x);
+    keys[i] = descending ? ~ordered : ordered;
+  }
+}
+
+// Below this many elements radix sort does not pay off.
+constexpr int64_t kMinRadixSortElements = 256;
+
+// Sorts 'keys' and permutes 'indices' along, keeping the relative order of
+// equal keys. 'key_scratch' and 'index_scratch' must hold 'n' elements.
+template <typename UInt>
+void StableSortByKey(UInt* keys, uint32_t* indices, int64_t n,
+                     UInt* key_scratch, uint32_t* index_scratch) {
+  if (n < kMinRadixSortElements) {
+    std::vector<std::pair<UInt, uint32_t>> pairs(n);
+    for (int64_t i = 0; i < n; ++i) pairs[i] = {keys[i], indices[i]};
+    // Ties are broken by the index, which makes the sort stable.
+    std::sort(pairs.begin(), pairs.end());
+    for (int64_t i = 0; i < n; ++i) {
+      keys[i] = pairs[i].first;
+      indices[i] = pairs[i].second;
+    }
+    return;
+  }
+
+  // Least significant digit radix sort with 8-bit digits. The histograms of
+  // all digits are computed in a single pass, and digits for which all keys
+  // are in the same bucket are skipped.
+  constexpr int kNumDigits = sizeof(UInt);
+  std::vector<std::array<int64_t, 256>> counts(kNumDigits);
+  for (auto& digit_counts : counts) digit_counts.fill(0);
+  for (int64_t i = 0; i < n; ++i) {
+    for (int d = 0; d < kNumDigits; ++d) {
+      ++counts[d][(keys[i] >> (8 * d)) & 0xff];
+    }
+  }
+
+  UInt* src_keys = keys;
+  uint32_t* src_indices = indices;
+  UInt* dst_keys = key_scratch;
+  uint32_t* dst_indices = index_scratch;
+  for (int d = 0; d < kNumDigits; ++d) {
+    std::array<int64_t, 256>& digit_counts = counts[d];
+    if (*std::max_element(digit_counts.begin(), digit_counts.end()) == n) {
+      continue;
+    }
+    int64_t offset = 0;
+    for (int64_t& count : digit_counts) {
+      int64_t bucket_size = count;
+      count = offset;
+      offset += bucket_size;
+    }
+    for (int64_t i = 0; i < n; ++i) {
+      int64_t pos = digit_counts[(src_keys[i] >> (8 * d)) & 0xff]++;
+      dst_keys[pos] = src_keys[i];
+      dst_indices[pos] = src_indices[i];
+    }
+    std::swap(src_keys, dst_keys);
+    std::swap(src_indices, dst_indices);
+  }
+  if (src_keys != keys) {
+    std::copy(src_keys, src_keys + n, keys);
+    std::copy(src_indices, src_indices + n, indices);
+  }
+}
+
+template <SortKeyKind kKind, typename UInt>
+void SortByKey(int64_t a, int64_t b, int64_t c, char** values,
+               int32_t values_count,
+               const int32_t* values_primitive_type_size_in_bytes,
+               bool descending) {
+  std::vector<UInt> keys(b);
+  std::vector<UInt> key_scratch(b);
+  std::vector<uint32_t> indices(b);
+  std::vector<uint32_t> index_scratch(b);
+  int32_t max_size = *std::max_element(
+      values_primitive_type_size_in_bytes,
+      values_primitive_type_size_in_bytes + values_count);
+  std::vector<char> scratch(b * max_size);
+
+  // See __xla_cpu_runtime_KeyValueSort for the iteration logic.
+  for (int64_t index = 0; index < a * c; ++index) {
+    int64_t base_offset = index % c + (index - index % c) * b;
+    LoadKeys<kKind>(values[0] + base_offset * sizeof(UInt),
+                    c * sizeof(UInt), b, descending, keys.data());
+    std::iota(indices.begin(), indices.end(), 0);
+    StableSortByKey(keys.data(), indices.data(), b, key_scratch.data(),
+                    index_scratch.data());
+    for (int32_t i = 0; i < values_count; ++i) {
+      int32_t size = values_primitive_type_size_in_bytes[i];
+      ReorderRow(values[i] + base_offset * size, c * size, size,
+                 indices.data(), b, scratch.data());
+    }
+  }
+}
+
+template <SortKeyKind kKind>
+void SortByKey(int64_t a, int64_t b, int64_t c, char** values,
+               int32_t values_count,
+               const int32_t* values_primitive_type_size_in_bytes,
+               bool descending) {
+  switch (values_primitive_type_size_in_bytes[0]) {
+    case 1:
+      return SortByKey<kKind, uint8_t>(a, b, c, values, values_count,
+                                       values_primitive_type_size_in_bytes,
+                                       descending);
+    case 2:
+      return SortByKey<kKind, uint16_t>(a, b, c, values, values_count,
+                                        values_primitive_type_size_in_bytes,
+                                        descending);
+    case 4:
+      return SortByKey<kKind, uint32_t>(a, b, c, values, values_count,
+                                        values_primitive_type_size_in_bytes,
+                                        descending);
+    case 8:
+      return SortByKey<kKind, uint64_t>(a, b, c, values, values_count,
+                                        values_primitive_type_size_in_bytes,
+                                        descending);
+  }
+}
+
+}  // namespace
+
 ABSL_ATTRIBUTE_NO_SANITIZE_MEMORY void __xla_cpu_runtime_KeyValueSort(
     int64_t a, int64_t b, int64_t c, char** values, int32_t values_count,
     int32_t* values_primitive_type_size_in_bytes, bool is_stable,
@@ -50,8 +222,11 @@ ABSL_ATTRIBUTE_NO_SANITIZE_MEMORY void __xla_cpu_runtime_KeyValueSort(
   std::unique_ptr<int64_t[]> indices(new int64_t[sort_dimension_elements]);
   std::unique_ptr<char*[]> comparison_values(new char*[2 * values_count]);
   std::iota(indices.get(), indices.get() + sort_dimension_elements, 0);
-  std::unique_ptr<std::string[]> reordered_values(
-      new std::string[sort_dimension_elements]);
+  int32_t max_size = *std::max_element(
+      values_primitive_type_size_in_bytes,
+      values_primitive_type_size_in_bytes + values_count);
+  std::unique_ptr<char[]> reordered_values(
+      new char[sort_dimension_elements * max_size]);
   for (int64_t index = 0; index < num_iteration_elements; ++index) {
     // If the sort should be stable, we have to reinitialize indices to iota to
     // guarantee that we still keep the relative order in case of ties.
@@ -91,21 +266,40 @@ ABSL_ATTRIBUTE_NO_SANITIZE_MEMORY void __xla_cpu_runtime_KeyValueSort(
 
     // Reorder the values according to the order defined by 'indices'.
     for (int32_t idx = 0; idx < values_count; ++idx) {
-      for (int64_t i = 0; i < sort_dimension_elements; ++i) {
-        int64_t memory_index =
-            (base_offset + indices[i] * sort_dimension_offset) *
-            values_primitive_type_size_in_bytes[idx];
-
-        reordered_values[i] =
-            std::string(values[idx] + memory_index,
-                        values_primitive_type_size_in_bytes[idx]);
-      }
-      for (int64_t i = 0; i < sort_dimension_elements; ++i) {
-        int64_t memory_index = (base_offset + i * sort_dimension_offset) *
-                               values_primitive_type_size_in_bytes[idx];
-        memcpy(values[idx] + memory_index, reordered_values[i].c_str(),
-               values_primitive_type_size_in_bytes[idx]);
-      }
+      int32_t size = values_primitive_type_size_in_bytes[idx];
+      ReorderRow(values[idx] + base_offset * size,
+                 sort_dimension_offset * size, size, indices.get(),
+                 sort_dimension_elements, reordered_values.get());
     }
   }
 }
+
+ABSL_ATTRIBUTE_NO_SANITIZE_MEMORY void __xla_cpu_runtime_KeyValueSortByKey(
+    int64_t a, int64_t b, int64_t c, char** values, int32_t values_count,
+    int32_t* values_primitive_type_size_in_bytes, int32_t key_kind,
+    bool descending) {
+  // 'values' and 'values_primitive_type_size_in_bytes' are managed by the JIT
+  // code, so msan can't tell they are initialized.
+  ABSL_ANNOTATE_MEMORY_IS_INITIALIZED(values, values_count * sizeof(char*));
+  ABSL_ANNOTATE_MEMORY_IS_INITIALIZED(values_primitive_type_size_in_bytes,
+                                      values_count * sizeof(int32_t));
+
+  switch (static_cast<SortKeyKind>(key_kind)) {
+    case SortKeyKind::kUnsigned:
+      return SortByKey<SortKeyKind::kUnsigned>(
+          a, b, c, values, values_count, values_primitive_type_size_in_bytes,
+          descending);
+    case SortKeyKind::kSigned:
+      return SortByKey<SortKeyKind::kSigned>(
+          a, b, c, values, values_count, values_primitive_type_size_in_bytes,
+          descending);
+    case SortKeyKind::kFloat:
+      return SortByKey<SortKeyKind::kFloat>(
+          a, b, c, values, values_count, values_primitive_type_size_in_bytes,
+          descending);
+    case SortKeyKind::kFloatTotalOrder:
+      return SortByKey<SortKeyKind::kFloatTotalOrder>(
+          a, b, c, values, values_count, values_primitive_type_size_in_bytes,
+          descending);
+  }
+}
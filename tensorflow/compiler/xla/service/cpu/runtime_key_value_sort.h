@@ -41,6 +41,37 @@ extern void __xla_cpu_runtime_KeyValueSort(
     int32_t* values_primitive_type_size_in_bytes, bool is_stable,
     char* run_options, int64_t* prof_counters,
     void (*less_than)(char*, char*, char**, char**, int64_t*));
+
+// Like __xla_cpu_runtime_KeyValueSort, but for sorts whose comparator orders
+// the elements by a single less-than or greater-than comparison of the key in
+// 'values[0]', which allows sorting without calling a comparator. 'key_kind'
+// is a xla::cpu::SortKeyKind and determines how the bits of the keys are
+// ordered; keys must have 1, 2, 4 or 8 bytes. 'descending' sorts by
+// greater-than instead of less-than. The sort is always stable and 'b' must
+// be less than 2^32.
+extern void __xla_cpu_runtime_KeyValueSortByKey(
+    int64_t a, int64_t b, int64_t c, char** values, int32_t values_count,
+    int32_t* values_primitive_type_size_in_bytes, int32_t key_kind,
+    bool descending);
 }
 
+namespace xla {
+namespace cpu {
+
+// How __xla_cpu_runtime_KeyValueSortByKey orders the bits of the keys.
+enum class SortKeyKind : int32_t {
+  kUnsigned = 0,
+  kSigned = 1,
+  // Floating point numbers compared with the partial order: -0 and +0 are
+  // equivalent. NaNs, for which the comparison does not define an order, are
+  // sorted before or after all other keys, depending on their sign bit.
+  kFloat = 2,
+  // Floating point numbers compared with the total order
+  // -NaN < -Inf < -Finite < -0 < +0 < +Finite < +Inf < +NaN.
+  kFloatTotalOrder = 3,
+};
+
+}  // namespace cpu
+}  // namespace xla
+
 #endif  // TENSORFLOW_COMPILER_XLA_SERVICE_CPU_RUNTIME_KEY_VALUE_SORT_H_
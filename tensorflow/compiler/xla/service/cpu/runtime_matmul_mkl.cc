@@ -16,6 +16,8 @@ limitations under the License.
 #if defined(ENABLE_MKL) && !defined(INTEL_MKL_DNN_ONLY)
 #include "tensorflow/compiler/xla/service/cpu/runtime_matmul_mkl.h"
 
+#include <cstring>
+
 #include "third_party/intel_mkl_ml/include/mkl_cblas.h"
 #include "third_party/intel_mkl_ml/include/mkl_service.h"
 #include "tensorflow/compiler/xla/executable_run_options.h"
@@ -28,12 +30,13 @@ namespace {
 // BLAS GEMM API for 32-bit Matrix Multiplication.
 
 // MatMul function is defined as: c = alpha * op(a) * op(b) + beta * c.
-// Since XLA MatMul does not used alpha, beta, we set them to 1.0 and 0.0.
+// Since XLA MatMul does not used alpha, we set it to 1.0. beta is 0.0, or 1.0
+// to accumulate into `out`.
 // Matrix lhs, rhs and out are all column-major.
 void MatMulF32(const void* run_options_ptr, float* out, float* lhs, float* rhs,
                int64_t m, int64_t n, int64_t k, int32_t transpose_lhs,
-               int32_t transpose_rhs) {
-  const float alpha = 1.0f, beta = 0.0f;
+               int32_t transpose_rhs, float beta = 0.0f) {
+  const float alpha = 1.0f;
   // lda, ldb, and ldc are the leading dimensions of matrices a, b, and c,
   // respectively. For column-major matrices, the leading dimension is the
   // stride between consecutive columns (which equals the number of rows). If
@@ -50,12 +53,14 @@ void MatMulF32(const void* run_options_ptr, float* out, float* lhs, float* rhs,
 // BLAS GEMM API for 64-bit Matrix Multiplication.
 
 // MatMul function is defined as: c = alpha * op(a) * op(b) + beta * c.
-// Since XLA MatMul does not used alpha, beta, we set them to 1.0 and 0.0.
+// Since XLA MatMul does not used alpha, we set it to 1.0. beta is 0.0, or 1.0
+// to accumulate into `out`.
 // Matrix lhs, rhs and out are all column-major.
 void MatMulF64(const void* run_options_ptr, double* out, double* lhs,
                double* rhs, int64_t m, int64_t n, int64_t k,
-               int32_t transpose_lhs, int32_t transpose_rhs) {
-  const float alpha = 1.0f, beta = 0.0f;
+               int32_t transpose_lhs, int32_t transpose_rhs,
+               double beta = 0.0) {
+  const double alpha = 1.0;
   // lda, ldb, and ldc are the leading dimensions of matrices a, b, and c,
   // respectively. For a column-major matrix, the leading dimension is the
   // stride between consecutive columns (which equals the number of rows). If
@@ -69,6 +74,15 @@ void MatMulF64(const void* run_options_ptr, double* out, double* lhs,
               lda, rhs, ldb, beta, out, ldc);
 }
 
+// Copies the m x n matrix `addend` to `out`, unless the addend was assigned the
+// buffer of the output, so that the GEMM can accumulate into `out`.
+template <typename T>
+void CopyAddend(T* out, const T* addend, int64_t m, int64_t n) {
+  if (addend != out) {
+    std::memcpy(out, addend, m * n * sizeof(T));
+  }
+}
+
 }  // namespace
 
 ABSL_ATTRIBUTE_NO_SANITIZE_MEMORY void __xla_cpu_runtime_MKLMatMulF32(
@@ -126,4 +140,56 @@ __xla_cpu_runtime_MKLSingleThreadedMatMulF64(const void* run_options_ptr,
   // Set thread number back to the previous number.
   mkl_set_num_threads_local(prev_num_threads);
 }
+
+ABSL_ATTRIBUTE_NO_SANITIZE_MEMORY void __xla_cpu_runtime_MKLMatMulAddF32(
+    const void* run_options_ptr, float* out, float* lhs, float* rhs,
+    float* addend, int64_t m, int64_t n, int64_t k, int32_t transpose_lhs,
+    int32_t transpose_rhs) {
+  const xla::ExecutableRunOptions* run_options =
+      static_cast<const xla::ExecutableRunOptions*>(run_options_ptr);
+  int prev_num_threads = mkl_set_num_threads_local(
+      run_options->intra_op_thread_pool()->numThreads());
+  CopyAddend(out, addend, m, n);
+  MatMulF32(nullptr, out, lhs, rhs, m, n, k, transpose_lhs, transpose_rhs,
+            /*beta=*/1.0f);
+  mkl_set_num_threads_local(prev_num_threads);
+}
+
+ABSL_ATTRIBUTE_NO_SANITIZE_MEMORY void __xla_cpu_runtime_MKLMatMulAddF64(
+    const void* run_options_ptr, double* out, double* lhs, double* rhs,
+    double* addend, int64_t m, int64_t n, int64_t k, int32_t transpose_lhs,
+    int32_t transpose_rhs) {
+  const xla::ExecutableRunOptions* run_options =
+      static_cast<const xla::ExecutableRunOptions*>(run_options_ptr);
+  int prev_num_threads = mkl_set_num_threads_local(
+      run_options->intra_op_thread_pool()->numThreads());
+  CopyAddend(out, addend, m, n);
+  MatMulF64(nullptr, out, lhs, rhs, m, n, k, transpose_lhs, transpose_rhs,
+            /*beta=*/1.0);
+  mkl_set_num_threads_local(prev_num_threads);
+}
+
+ABSL_ATTRIBUTE_NO_SANITIZE_MEMORY void
+__xla_cpu_runtime_MKLSingleThreadedMatMulAddF32(
+    const void* run_options_ptr, float* out, float* lhs, float* rhs,
+    float* addend, int64_t m, int64_t n, int64_t k, int32_t transpose_lhs,
+    int32_t transpose_rhs) {
+  int prev_num_threads = mkl_set_num_threads_local(1);
+  CopyAddend(out, addend, m, n);
+  MatMulF32(nullptr, out, lhs, rhs, m, n, k, transpose_lhs, transpose_rhs,
+            /*beta=*/1.0f);
+  mkl_set_num_threads_local(prev_num_threads);
+}
+
+ABSL_ATTRIBUTE_NO_SANITIZE_MEMORY void
+__xla_cpu_runtime_MKLSingleThreadedMatMulAddF64(
+    const void* run_options_ptr, double* out, double* lhs, double* rhs,
+    double* addend, int64_t m, int64_t n, int64_t k, int32_t transpose_lhs,
+    int32_t transpose_rhs) {
+  int prev_num_threads = mkl_set_num_threads_local(1);
+  CopyAddend(out, addend, m, n);
+  MatMulF64(nullptr, out, lhs, rhs, m, n, k, transpose_lhs, transpose_rhs,
+            /*beta=*/1.0);
+  mkl_set_num_threads_local(prev_num_threads);
+}
 #endif  // ENABLE_MKL
@@ -37,6 +37,23 @@ extern void __xla_cpu_runtime_MKLSingleThreadedMatMulF64(
     const void* /* xla::ExecutableRunOptions* */ run_options_ptr, double* out,
     double* lhs, double* rhs, int64_t m, int64_t n, int64_t k,
     int32_t transpose_lhs, int32_t transpose_rhs);
+// Computes out = addend + op(lhs) * op(rhs). `addend` may alias `out`.
+extern void __xla_cpu_runtime_MKLMatMulAddF32(
+    const void* /* xla::ExecutableRunOptions* */ run_options_ptr, float* out,
+    float* lhs, float* rhs, float* addend, int64_t m, int64_t n, int64_t k,
+    int32_t transpose_lhs, int32_t transpose_rhs);
+extern void __xla_cpu_runtime_MKLMatMulAddF64(
+    const void* /* xla::ExecutableRunOptions* */ run_options_ptr, double* out,
+    double* lhs, double* rhs, double* addend, int64_t m, int64_t n, int64_t k,
+    int32_t transpose_lhs, int32_t transpose_rhs);
+extern void __xla_cpu_runtime_MKLSingleThreadedMatMulAddF32(
+    const void* /* xla::ExecutableRunOptions* */ run_options_ptr, float* out,
+    float* lhs, float* rhs, float* addend, int64_t m, int64_t n, int64_t k,
+    int32_t transpose_lhs, int32_t transpose_rhs);
+extern void __xla_cpu_runtime_MKLSingleThreadedMatMulAddF64(
+    const void* /* xla::ExecutableRunOptions* */ run_options_ptr, double* out,
+    double* lhs, double* rhs, double* addend, int64_t m, int64_t n, int64_t k,
+    int32_t transpose_lhs, int32_t transpose_rhs);
 
 #else
 inline extern void __xla_cpu_runtime_MKLMatMulF32(
@@ -71,6 +88,38 @@ inline extern void __xla_cpu_runtime_MKLSingleThreadedMatMulF64(
                "ENABLE_MKL. Add --config=mkl to build with MKL.";
   exit(1);
 }
+inline extern void __xla_cpu_runtime_MKLMatMulAddF32(
+    const void* /* xla::ExecutableRunOptions* */ run_options_ptr, float* out,
+    float* lhs, float* rhs, float* addend, int64_t m, int64_t n, int64_t k,
+    int32_t transpose_lhs, int32_t transpose_rhs) {
+  std::cerr << "Attempt to call MKL MatMul runtime library without defining "
+               "ENABLE_MKL. Add --config=mkl to build with MKL.";
+  exit(1);
+}
+inline extern void __xla_cpu_runtime_MKLMatMulAddF64(
+    const void* /* xla::ExecutableRunOptions* */ run_options_ptr, double* out,
+    double* lhs, double* rhs, double* addend, int64_t m, int64_t n, int64_t k,
+    int32_t transpose_lhs, int32_t transpose_rhs) {
+  std::cerr << "Attempt to call MKL MatMul runtime library without defining "
+               "ENABLE_MKL. Add --config=mkl to build with MKL.";
+  exit(1);
+}
+inline extern void __xla_cpu_runtime_MKLSingleThreadedMatMulAddF32(
+    const void* /* xla::ExecutableRunOptions* */ run_options_ptr, float* out,
+    float* lhs, float* rhs, float* addend, int64_t m, int64_t n, int64_t k,
+    int32_t transpose_lhs, int32_t transpose_rhs) {
+  std::cerr << "Attempt to call MKL MatMul runtime library without defining "
+               "ENABLE_MKL. Add --config=mkl to build with MKL.";
+  exit(1);
+}
+inline extern void __xla_cpu_runtime_MKLSingleThreadedMatMulAddF64(
+    const void* /* xla::ExecutableRunOptions* */ run_options_ptr, double* out,
+    double* lhs, double* rhs, double* addend, int64_t m, int64_t n, int64_t k,
+    int32_t transpose_lhs, int32_t transpose_rhs) {
+  std::cerr << "Attempt to call MKL MatMul runtime library without defining "
+               "ENABLE_MKL. Add --config=mkl to build with MKL.";
+  exit(1);
+}
 
 #endif  // ENABLE_MKL
 #endif  // TENSORFLOW_COMPILER_XLA_SERVICE_CPU_RUNTIME_MATMUL_MKL_H_
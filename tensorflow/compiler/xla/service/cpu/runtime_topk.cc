@@ -16,10 +16,10 @@ limitations under the License.
 #include "tensorflow/compiler/xla/service/cpu/runtime_topk.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <cstring>
-#include <limits>
+#include <functional>
 #include <memory>
-#include <numeric>
 #include <vector>
 
 #include "absl/base/dynamic_annotations.h"
@@ -27,43 +27,44 @@ limitations under the License.
 template <typename T>
 static void TopK(int64_t batch_size, int64_t input_size, int64_t k,
                  const T* values, T* out_values, int32_t* out_indices) {
+  static_assert(sizeof(T) == sizeof(uint32_t));
   // 'values' is managed by the JIT code, so msan can't tell they are
   // initialized.
   ABSL_ANNOTATE_MEMORY_IS_INITIALIZED(values,
                                       input_size * batch_size * sizeof(T));
 
-  std::vector<int32_t> temp_indices(input_size);
+  // Each element is packed into a single integer with the value in the high
+  // bits and the bitwise negated index in the low bits. The top k elements are
+  // then the k largest integers, which avoids indirect loads and branches on
+  // ties when comparing them, and allows the packing loop to be vectorized.
+  std::vector<uint64_t> packed(input_size);
   for (int64_t batch = 0; batch != batch_size; ++batch) {
-    std::iota(temp_indices.begin(), temp_indices.end(), 0);
-
     const T* values_batch = values + batch * input_size;
 
-    auto convert_to_int = [](T value) {
+    for (int64_t i = 0; i < input_size; ++i) {
       uint32_t x;
-      std::memcpy(&x, &value, sizeof(x));
-      return static_cast<int32_t>(x) < 0
-                 ? std::numeric_limits<int32_t>::max() - x
-                 : x;
-    };
+      std::memcpy(&x, &values_batch[i], sizeof(x));
+      // Compare in integers to enforce a total order of
+      // -NaN < -Inf < -0 < +0 < +Inf < +NaN.
+      uint32_t ordered = (x & 0x80000000u) ? ~x : (x | 0x80000000u);
+      // Negating the index sorts smaller indices first on ties.
+      packed[i] = (static_cast<uint64_t>(ordered) << 32) |
+                  static_cast<uint32_t>(~static_cast<uint32_t>(i));
+    }
 
-    auto kth_element = temp_indices.begin() + k;
-    std::partial_sort(temp_indices.begin(), kth_element, temp_indices.end(),
-                      [&](size_t i1, size_t i2) {
-                        // Do the comparison in integers to enforce a total
-                        // order of -NaN < -Inf < -0 < +0 < +Inf < +NaN.
-                        int32_t v1 = convert_to_int(values_batch[i1]);
-                        int32_t v2 = convert_to_int(values_batch[i2]);
-                        if (v1 == v2) {
-                          return i1 < i2;  // Stabilize sorting.
-                        }
-                        return v1 > v2;
-                      });
+    auto kth_element = packed.begin() + k;
+    if (kth_element != packed.end()) {
+      std::nth_element(packed.begin(), kth_element, packed.end(),
+                       std::greater<uint64_t>());
+    }
+    std::sort(packed.begin(), kth_element, std::greater<uint64_t>());
 
     T* out_values_batch = out_values + batch * k;
     int32_t* out_indices_batch = out_indices + batch * k;
-    std::copy(temp_indices.begin(), kth_element, out_indices_batch);
     for (int64_t i = 0; i < k; i++) {
-      out_values_batch[i] = values_batch[temp_indices[i]];
+      int32_t index = static_cast<int32_t>(~static_cast<uint32_t>(packed[i]));
+      out_indices_batch[i] = index;
+      out_values_batch[i] = values_batch[index];
     }
   }
 }
@@ -17,6 +17,7 @@ limitations under the License.
 
 #include <algorithm>
 
+#include "llvm/MC/MCSubtargetInfo.h"
 #include "tensorflow/compiler/xla/cpu_function_runtime.h"
 #include "tensorflow/tsl/platform/logging.h"
 
@@ -36,6 +37,15 @@ llvm::TargetTransformInfo* LLVMTargetMachineFeatures::GetTargetTransformInfoFor(
   return &it->second;
 }
 
+bool LLVMTargetMachineFeatures::has_avx512() const {
+  // The subtarget info accounts for both the target CPU and any explicitly
+  // enabled features.
+  const llvm::MCSubtargetInfo* subtarget_info =
+      target_machine_->getMCSubtargetInfo();
+  return subtarget_info != nullptr &&
+         subtarget_info->checkFeatures("+avx512f");
+}
+
 int64_t LLVMTargetMachineFeatures::minimum_alignment_for_allocation(
     int64_t size_bytes) const {
   // Assume that all pointers are aligned to at least
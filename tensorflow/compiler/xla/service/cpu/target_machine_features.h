@@ -58,6 +58,12 @@ class TargetMachineFeatures {
   // this functionality).
   virtual int vector_register_count(const llvm::Function& function) const = 0;
 
+  // Return true if the target supports the AVX-512 foundation instructions,
+  // i.e. has 32 vector registers of 64 bytes.  Unlike the queries above this
+  // does not take a function, so that it can be used before any IR is
+  // emitted, e.g. to pick the implementation strategy of a dot.
+  virtual bool has_avx512() const = 0;
+
   // Returns the minimum alignment for a buffer of size size_bytes.
   virtual int64_t minimum_alignment_for_allocation(
       int64_t size_bytes) const = 0;
@@ -99,6 +105,8 @@ class LLVMTargetMachineFeatures : public TargetMachineFeatures {
         tti->getRegisterClassForType(/*Vector=*/true)));
   }
 
+  bool has_avx512() const override;
+
   int64_t minimum_alignment_for_allocation(int64_t size_bytes) const override;
 
  private:
@@ -48,6 +48,8 @@ class TargetMachineFeaturesWithFakeAlignmentLogic
     LOG(FATAL) << "Unexpected call to " << __func__;
   }
 
+  bool has_avx512() const override { return false; }
+
   int64_t minimum_alignment_for_allocation(int64_t size_bytes) const override {
     return fake_alignment_logic_(size_bytes);
   }
@@ -19,6 +19,7 @@ limitations under the License.
 #include <string>
 
 #include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
 #include "tensorflow/compiler/xla/hlo/ir/hlo_computation.h"
 #include "tensorflow/compiler/xla/service/cpu/cpu_compiler.h"
 #include "tensorflow/compiler/xla/service/cpu/test_target_triple_helper.h"
@@ -111,6 +112,45 @@ INSTANTIATE_TEST_SUITE_P(CpuEigenDotOperationTestInstantiation,
                          ::testing::ValuesIn(GetDotTestCases()),
                          DotTestSpecToString);
 
+class CpuSmallDotOperationTest : public CpuCodegenTest {
+ protected:
+  void CompileAndCheck(absl::string_view features,
+                       const std::string& filecheck_lines) {
+    HloComputation::Builder builder(TestName());
+    Shape lhs_shape = ShapeUtil::MakeShape(F32, {48, 256});
+    Shape rhs_shape = ShapeUtil::MakeShape(F32, {256, 256});
+    Shape result_shape = ShapeUtil::MakeShape(F32, {48, 256});
+    HloInstruction* lhs = builder.AddInstruction(
+        HloInstruction::CreateParameter(0, lhs_shape, "lhs"));
+    HloInstruction* rhs = builder.AddInstruction(
+        HloInstruction::CreateParameter(1, rhs_shape, "rhs"));
+    builder.AddInstruction(CreateCanonicalDot(result_shape, lhs, rhs));
+
+    CpuAotCompilationOptions options{
+        /*triple=*/"x86_64-pc-linux", /*cpu_name=*/"",
+        /*features=*/std::string(features),
+        /*entry_point_name=*/"entry",
+        /*relocation_model=*/CpuAotCompilationOptions::RelocationModel::Static};
+
+    auto hlo_module = CreateNewVerifiedModule();
+    hlo_module->AddEntryComputation(builder.Build());
+
+    CompileAheadOfTimeAndVerifyIr(std::move(hlo_module), options,
+                                  filecheck_lines,
+                                  /*match_optimized_ir=*/true);
+  }
+};
+
+TEST_F(CpuSmallDotOperationTest, CallsEigenWithoutAvx512) {
+  CompileAndCheck("+avx2,+fma",
+                  R"(CHECK: call void @__xla_cpu_runtime_EigenMatMulF32)");
+}
+
+TEST_F(CpuSmallDotOperationTest, EmitsTiledGemmWithAvx512) {
+  CompileAndCheck("+avx512f",
+                  R"(CHECK-NOT: call void @__xla_cpu_runtime_EigenMatMulF32)");
+}
+
 }  // namespace
 }  // namespace cpu
 }  // namespace xla
@@ -58,6 +58,85 @@ CHECK: call void @__xla_cpu_runtime_KeyValueSort
                                 /*match_optimized_ir=*/true);
 }
 
+TEST_F(CpuKeyValueSortTest, SortByKeyWithoutComparator) {
+  const std::string hlo_text = R"(
+HloModule KeyValueSort
+
+compare {
+  p.0.lhs = s32[] parameter(0)
+  p.0.rhs = s32[] parameter(1)
+  p.1.lhs = f32[] parameter(2)
+  p.1.rhs = f32[] parameter(3)
+  ROOT gt = pred[] compare(p.0.lhs, p.0.rhs), direction=GT
+}
+
+ENTRY main {
+  a = s32[10] parameter(0)
+  b = f32[10] parameter(1)
+
+  ROOT result = (s32[10], f32[10]) sort(a, b), dimensions={0}, to_apply=compare
+}
+)";
+
+  std::string filecheck_pattern = R"(
+CHECK: call void @__xla_cpu_runtime_KeyValueSortByKey
+)";
+
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(hlo_text));
+
+  CpuAotCompilationOptions options{
+      /*triple=*/kTargetTripleForHost, /*cpu_name=*/kTargetCpuForHost,
+      /*features=*/"",
+      /*entry_point_name=*/"entry",
+      /*relocation_model=*/CpuAotCompilationOptions::RelocationModel::Static};
+
+  CompileAheadOfTimeAndVerifyIr(std::move(module), options, filecheck_pattern,
+                                /*match_optimized_ir=*/true);
+}
+
+TEST_F(CpuKeyValueSortTest, SortByKeyIsStable) {
+  // Enough elements with many equal keys to take the radix sort path.
+  const std::string hlo_text = R"(
+HloModule KeyValueSort
+
+compare {
+  p.0.lhs = s32[] parameter(0)
+  p.0.rhs = s32[] parameter(1)
+  p.1.lhs = s32[] parameter(2)
+  p.1.rhs = s32[] parameter(3)
+  ROOT lt = pred[] compare(p.0.rhs, p.0.lhs), direction=LT
+}
+
+ENTRY main {
+  iota = s32[4,1000] iota(), iota_dimension=1
+  seven = s32[] constant(7)
+  sevens = s32[4,1000] broadcast(seven), dimensions={}
+  keys = s32[4,1000] remainder(iota, sevens)
+  ROOT result = (s32[4,1000], s32[4,1000]) sort(keys, iota), dimensions={1},
+      is_stable=true, to_apply=compare
+}
+)";
+  EXPECT_TRUE(RunAndCompare(hlo_text, std::nullopt));
+}
+
+TEST_F(CpuKeyValueSortTest, SortByFloatKeyWithTotalOrder) {
+  const std::string hlo_text = R"(
+HloModule KeyValueSort
+
+compare {
+  p.0.lhs = f32[] parameter(0)
+  p.0.rhs = f32[] parameter(1)
+  ROOT lt = pred[] compare(p.0.lhs, p.0.rhs), direction=LT, type=TOTALORDER
+}
+
+ENTRY main {
+  a = f32[3,500] parameter(0)
+  ROOT result = f32[3,500] sort(a), dimensions={1}, to_apply=compare
+}
+)";
+  EXPECT_TRUE(RunAndCompare(hlo_text, std::nullopt));
+}
+
 }  // namespace
 }  // namespace cpu
 }  // namespace xla
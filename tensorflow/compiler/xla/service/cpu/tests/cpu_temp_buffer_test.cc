@@ -0,0 +1,67 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <memory>
+#include <string>
+
+#include "tensorflow/compiler/xla/literal.h"
+#include "tensorflow/compiler/xla/literal_util.h"
+#include "tensorflow/compiler/xla/service/cpu/tests/cpu_codegen_test.h"
+#include "tensorflow/compiler/xla/service/executable.h"
+#include "tensorflow/compiler/xla/tests/literal_test_util.h"
+#include "tensorflow/tsl/platform/test.h"
+
+namespace xla {
+namespace cpu {
+namespace {
+
+class CpuTempBufferTest : public CpuCodegenTest {};
+
+TEST_F(CpuTempBufferTest, ReusedTempBuffersDoNotLeakIntoLaterExecutions) {
+  // The result of the first dot is a temporary buffer.
+  const std::string hlo_text = R"(
+HloModule Cube
+
+ENTRY main {
+  p = f32[2,2] parameter(0)
+  square = f32[2,2] dot(p, p), lhs_contracting_dims={1},
+      rhs_contracting_dims={0}
+  ROOT cube = f32[2,2] dot(square, p), lhs_contracting_dims={1},
+      rhs_contracting_dims={0}
+}
+)";
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(hlo_text));
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<Executable> executable,
+      CreateExecutable(std::move(module), /*run_hlo_passes=*/true));
+
+  Literal a = LiteralUtil::CreateR2<float>({{1, 1}, {0, 1}});
+  Literal b = LiteralUtil::CreateR2<float>({{2, 0}, {0, 2}});
+  Literal a_cubed = LiteralUtil::CreateR2<float>({{1, 3}, {0, 1}});
+  Literal b_cubed = LiteralUtil::CreateR2<float>({{8, 0}, {0, 8}});
+  for (int i = 0; i < 3; ++i) {
+    TF_ASSERT_OK_AND_ASSIGN(
+        Literal result,
+        test_runner_.ExecuteWithExecutable(executable.get(), {&a}));
+    EXPECT_TRUE(LiteralTestUtil::Equal(a_cubed, result));
+    TF_ASSERT_OK_AND_ASSIGN(
+        result, test_runner_.ExecuteWithExecutable(executable.get(), {&b}));
+    EXPECT_TRUE(LiteralTestUtil::Equal(b_cubed, result));
+  }
+}
+
+}  // namespace
+}  // namespace cpu
+}  // namespace xla
@@ -1150,5 +1150,79 @@ ENTRY entry {
   XLA_VLOG_LINES(1, module->ToString());
 }
 
+TEST_F(DataParallelCollectiveOptimizerTest, TransformReduceScatterForward) {
+  constexpr absl::string_view hlo_string = R"(
+HloModule module
+
+add {
+  lhs = bf16[] parameter(0)
+  rhs = bf16[] parameter(1)
+  ROOT add = bf16[] add(lhs, rhs)
+}
+
+while_cond {
+  param = (s32[], bf16[3,8,128], bf16[3,2,128]) parameter(0)
+  gte = s32[] get-tuple-element(param), index=0
+  constant.1 = s32[] constant(3)
+  ROOT cmp = pred[] compare(gte, constant.1), direction=LT
+}
+
+while_body {
+  param = (s32[], bf16[3,8,128], bf16[3,2,128]) parameter(0)
+  get-tuple-element.394 = s32[] get-tuple-element(param), index=0
+  get-tuple-element.395 = bf16[3,8,128] get-tuple-element(param), index=1
+  get-tuple-element.396 = bf16[3,2,128] get-tuple-element(param), index=2
+  constant.2557 = s32[] constant(1)
+  add.230 = s32[] add(get-tuple-element.394, constant.2557)
+  constant.2559 = s32[] constant(3)
+  subtract.139 = s32[] subtract(constant.2559, get-tuple-element.394)
+  constant.2560 = s32[] constant(-1)
+  add.231 = s32[] add(subtract.139, constant.2560)
+  constant.2561 = s32[] constant(0)
+  compare.747 = pred[] compare(add.231, constant.2561), direction=LT
+  constant.2562 = s32[] constant(2)
+  add.232 = s32[] add(subtract.139, constant.2562)
+  select.1348 = s32[] select(compare.747, add.232, add.231)
+  dynamic-slice.99 = bf16[1,8,128] dynamic-slice(get-tuple-element.395, select.1348, constant.2561, constant.2561), dynamic_slice_sizes={1,8,128}
+  mul = bf16[1,8,128] multiply(dynamic-slice.99, dynamic-slice.99)
+  rs.1 = bf16[1,2,128] reduce-scatter(mul), replica_groups={}, to_apply=add, channel_id=1, dimensions={1}
+  dynamic-update-slice.35 = bf16[3,2,128] dynamic-update-slice(get-tuple-element.396, rs.1, select.1348, constant.2561, constant.2561)
+  ROOT tuple = (s32[], bf16[3,8,128], bf16[3,2,128]) tuple(add.230, get-tuple-element.395, dynamic-update-slice.35)
+}
+
+ENTRY entry {
+  c0 = s32[] constant(0)
+  p0 = bf16[3,8,128] parameter(0)
+  p1 = bf16[3,2,128] parameter(1)
+  tuple = (s32[], bf16[3,8,128], bf16[3,2,128]) tuple(c0, p0, p1)
+  while = (s32[], bf16[3,8,128], bf16[3,2,128]) while(tuple), condition=while_cond, body=while_body
+  ROOT gte1 = bf16[3,2,128] get-tuple-element(while), index=2
+}
+)";
+  auto module = ParseAndReturnUnverifiedModule(hlo_string, config_).value();
+  EXPECT_TRUE(
+      RunOptimizer(
+          module.get(), /*last_run=*/true, 0,
+          /*process_different_sized_ops=*/true,
+          DataParallelCollectiveOptimizer::PipeliningDirection::kForward,
+          HloPredicateIsOp<HloOpcode::kReduceScatter>)
+          .value());
+  XLA_VLOG_LINES(1, module->ToString());
+  // The reduce-scatter of the last iteration is peeled out of the loop.
+  const HloInstruction* root = module->entry_computation()->root_instruction();
+  EXPECT_THAT(root, op::DynamicUpdateSlice(_, op::ReduceScatter(), _, _, _));
+  const HloInstruction* sliced = root->operand(1)->operand(0);
+  EXPECT_EQ(sliced->opcode(), HloOpcode::kDynamicSlice);
+  const HloInstruction* while_inst = sliced->operand(1)->operand(0);
+  EXPECT_EQ(while_inst->opcode(), HloOpcode::kWhile);
+  // The loop now reduce-scatters the result of the previous iteration.
+  const HloInstruction* while_root =
+      while_inst->while_body()->root_instruction();
+  EXPECT_THAT(while_root->operand(2),
+              op::DynamicUpdateSlice(
+                  op::DynamicUpdateSlice(_, op::ReduceScatter(), _, _, _), _,
+                  _, _, _));
+}
+
 }  // namespace
 }  // namespace xla
@@ -0,0 +1,251 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/service/dot_batcher.h"
+
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "absl/algorithm/container.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
+#include "tensorflow/compiler/xla/hlo/ir/hlo_computation.h"
+#include "tensorflow/compiler/xla/hlo/ir/hlo_instruction.h"
+#include "tensorflow/compiler/xla/hlo/ir/hlo_opcode.h"
+#include "tensorflow/compiler/xla/service/graphcycles/graphcycles.h"
+#include "tensorflow/compiler/xla/service/hlo_creation_utils.h"
+#include "tensorflow/compiler/xla/shape_util.h"
+#include "tensorflow/tsl/platform/errors.h"
+#include "tensorflow/tsl/platform/statusor.h"
+
+namespace xla {
+namespace {
+
+// Returns a string which is equal for dots that can be batched together.
+std::string BatchKey(const HloInstruction* dot) {
+  std::string key = absl::StrCat(
+      dot->operand(0)->shape().ToString(/*print_layout=*/true), ";",
+      dot->operand(1)->shape().ToString(/*print_layout=*/true), ";",
+      dot->shape().ToString(/*print_layout=*/true), ";",
+      DotDimensionNumbersToString(dot->dot_dimension_numbers()));
+  for (int precision : dot->precision_config().operand_precision()) {
+    absl::StrAppend(&key, ";",
+                    PrecisionToString(
+                        static_cast<PrecisionConfig::Precision>(precision)));
+  }
+  return key;
+}
+
+// Returns the dimension numbers of the dots with a new major batch dimension
+// added to both operands.
+DotDimensionNumbers BatchedDimensionNumbers(const DotDimensionNumbers& dnums) {
+  DotDimensionNumbers batched;
+  batched.add_lhs_batch_dimensions(0);
+  batched.add_rhs_batch_dimensions(0);
+  for (int64_t dim : dnums.lhs_batch_dimensions()) {
+    batched.add_lhs_batch_dimensions(dim + 1);
+  }
+  for (int64_t dim : dnums.rhs_batch_dimensions()) {
+    batched.add_rhs_batch_dimensions(dim + 1);
+  }
+  for (int64_t dim : dnums.lhs_contracting_dimensions()) {
+    batched.add_lhs_contracting_dimensions(dim + 1);
+  }
+  for (int64_t dim : dnums.rhs_contracting_dimensions()) {
+    batched.add_rhs_contracting_dimensions(dim + 1);
+  }
+  return batched;
+}
+
+// Stacks the `operand_number`th operands of `dots` along a new major
+// dimension.
+StatusOr<HloInstruction*> StackOperands(absl::Span<HloInstruction* const> dots,
+                                        int64_t operand_number) {
+  std::vector<HloInstruction*> reshapes;
+  reshapes.reserve(dots.size());
+  for (HloInstruction* dot : dots) {
+    HloInstruction* operand = dot->mutable_operand(operand_number);
+    DimensionVector dims = {1};
+    dims.insert(dims.end(), operand->shape().dimensions().begin(),
+                operand->shape().dimensions().end());
+    TF_ASSIGN_OR_RETURN(HloInstruction * reshape,
+                        MakeReshapeHlo(dims, operand));
+    reshapes.push_back(reshape);
+  }
+  return MakeConcatHlo(reshapes, /*dimension=*/0);
+}
+
+// Replaces `dots`, which must have the same BatchKey and be independent of
+// each other, by slices of a single batched dot, which is returned.
+StatusOr<HloInstruction*> BatchDots(absl::Span<HloInstruction* const> dots) {
+  VLOG(2) << "Batching " << dots.size() << " dots like " << dots[0]->ToString();
+  HloInstruction* first = dots[0];
+  TF_ASSIGN_OR_RETURN(HloInstruction * lhs, StackOperands(dots, 0));
+  TF_ASSIGN_OR_RETURN(HloInstruction * rhs, StackOperands(dots, 1));
+  TF_ASSIGN_OR_RETURN(
+      HloInstruction * batched,
+      MakeDotHlo(lhs, rhs,
+                 BatchedDimensionNumbers(first->dot_dimension_numbers()),
+                 first->precision_config(),
+                 /*preferred_element_type=*/first->shape().element_type(),
+                 &first->metadata()));
+
+  // The batch dimension is the major dimension of the result.
+  const Shape& shape = batched->shape();
+  DimensionVector start_indices(shape.rank(), 0);
+  DimensionVector limit_indices(shape.dimensions().begin(),
+                                shape.dimensions().end());
+  DimensionVector strides(shape.rank(), 1);
+  for (int64_t i = 0; i < dots.size(); ++i) {
+    start_indices[0] = i;
+    limit_indices[0] = i + 1;
+    TF_ASSIGN_OR_RETURN(
+        HloInstruction * slice,
+        MakeSliceHlo(batched, start_indices, limit_indices, strides));
+    TF_ASSIGN_OR_RETURN(HloInstruction * reshape,
+                        MakeReshapeHlo(dots[i]->shape(), slice));
+    // Important: We do RAUW, not ReplaceInstruction, because the old
+    // instruction must live until the end of the pass.
+    TF_RETURN_IF_ERROR(dots[i]->ReplaceAllUsesWith(reshape));
+  }
+  return batched;
+}
+
+StatusOr<bool> BatchDotsInComputation(HloComputation* comp,
+                                      int64_t max_size_to_batch) {
+  auto is_batch_candidate = [&](const HloInstruction* instr) {
+    // Cowardly skip instructions with control dependencies.
+    if (instr->opcode() != HloOpcode::kDot ||
+        !instr->control_predecessors().empty() ||
+        !instr->control_successors().empty() ||
+        !instr->shape().is_static()) {
+      return false;
+    }
+    int64_t bytes = ShapeUtil::ByteSizeOfElements(instr->shape());
+    for (const HloInstruction* operand : instr->operands()) {
+      if (!operand->shape().is_static()) return false;
+      bytes += ShapeUtil::ByteSizeOfElements(operand->shape());
+    }
+    return bytes <= max_size_to_batch;
+  };
+
+  // Group the candidates by their BatchKey. For determinism, keys and dots are
+  // kept in post order.
+  std::vector<HloInstruction*> post_order = comp->MakeInstructionPostOrder();
+  std::vector<std::string> keys;
+  absl::flat_hash_map<std::string, std::vector<HloInstruction*>> candidates;
+  for (HloInstruction* instr : post_order) {
+    if (!is_batch_candidate(instr)) continue;
+    std::string key = BatchKey(instr);
+    std::vector<HloInstruction*>& dots = candidates[key];
+    if (dots.empty()) keys.push_back(key);
+    dots.push_back(instr);
+  }
+  if (absl::c_none_of(keys, [&](const std::string& key) {
+        return candidates[key].size() > 1;
+      })) {
+    return false;
+  }
+
+  // Build a dependency graph representing the whole computation.
+  tensorflow::GraphCycles graph;
+  absl::flat_hash_map<HloInstruction*, int32_t> graph_ids_map;
+  auto graph_id = [&](HloInstruction* instr) {
+    auto [it, inserted] = graph_ids_map.emplace(instr, -1);
+    if (inserted) {
+      it->second = graph.NewNode();
+    }
+    return it->second;
+  };
+  for (HloInstruction* instr : post_order) {
+    int32_t id = graph_id(instr);
+    for (HloInstruction* operand : instr->operands()) {
+      CHECK(graph.InsertEdge(graph_id(operand), id));
+    }
+    for (HloInstruction* control_pred : instr->control_predecessors()) {
+      CHECK(graph.InsertEdge(graph_id(control_pred), id));
+    }
+  }
+
+  // Greedily collect the dots that are independent of all dots collected so
+  // far. Batching an independent set of dots can't create a cycle; the graph
+  // is updated after each batch so that later batches see the dependencies it
+  // adds.
+  absl::flat_hash_set<HloInstruction*> dead_instrs;
+  for (const std::string& key : keys) {
+    std::vector<HloInstruction*>& dots = candidates[key];
+    for (int64_t i = 0; i < dots.size(); ++i) {
+      if (dots[i] == nullptr) continue;
+      std::vector<HloInstruction*> batch = {dots[i]};
+      for (int64_t j = i + 1; j < dots.size(); ++j) {
+        HloInstruction* dot = dots[j];
+        if (dot == nullptr) continue;
+        int32_t dot_id = graph_id(dot);
+        if (absl::c_any_of(batch, [&](HloInstruction* member) {
+              int32_t member_id = graph_id(member);
+              return graph.IsReachableNonConst(member_id, dot_id) ||
+                     graph.IsReachableNonConst(dot_id, member_id);
+            })) {
+          continue;
+        }
+        batch.push_back(dot);
+        dots[j] = nullptr;
+      }
+      if (batch.size() < 2) continue;
+
+      TF_ASSIGN_OR_RETURN(HloInstruction * batched, BatchDots(batch));
+      std::vector<int32_t> successors;
+      for (HloInstruction* member : batch) {
+        absl::c_copy(graph.SuccessorsCopy(graph_id(member)),
+                     std::back_inserter(successors));
+      }
+      int32_t batched_id = graph_id(batched);
+      for (HloInstruction* member : batch) {
+        graph.InsertEdge(graph_id(member), batched_id);
+        dead_instrs.insert(member);
+      }
+      for (int32_t succ : successors) {
+        graph.InsertEdge(batched_id, succ);
+      }
+    }
+  }
+
+  // Now it's finally safe to delete the old instructions from the graph.
+  for (HloInstruction* instr : dead_instrs) {
+    TF_RETURN_IF_ERROR(comp->RemoveInstruction(instr));
+  }
+  return !dead_instrs.empty();
+}
+
+}  // namespace
+
+StatusOr<bool> DotBatcher::Run(
+    HloModule* module,
+    const absl::flat_hash_set<absl::string_view>& execution_threads) {
+  bool changed = false;
+  for (HloComputation* comp :
+       module->MakeNonfusionComputations(execution_threads)) {
+    TF_ASSIGN_OR_RETURN(bool changed_computation,
+                        BatchDotsInComputation(comp, max_size_to_batch_));
+    changed |= changed_computation;
+  }
+  return changed;
+}
+
+}  // namespace xla
@@ -0,0 +1,66 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_COMPILER_XLA_SERVICE_DOT_BATCHER_H_
+#define TENSORFLOW_COMPILER_XLA_SERVICE_DOT_BATCHER_H_
+
+#include <cstdint>
+
+#include "tensorflow/compiler/xla/service/hlo_pass_interface.h"
+
+namespace xla {
+
+// Batches independent dots with the same operand shapes and dimension numbers
+// into a single dot with an additional batch dimension.  Transforms
+//
+//   x = f32[8,16] dot(f32[8,32] a, f32[32,16] b)
+//   y = f32[8,16] dot(f32[8,32] c, f32[32,16] d)
+//
+// into
+//
+//   z = f32[2,8,16] dot(concat(reshape(a), reshape(c)),
+//                       concat(reshape(b), reshape(d))),
+//     lhs_batch_dims={0}, rhs_batch_dims={0}
+//   x = reshape(slice(z))
+//   y = reshape(slice(z)).
+//
+// Unlike DotMerger, the dots do not need to share an operand.  This is how
+// per-head projections or the towers of multi-tower models end up in one
+// batched gemm call instead of many tiny ones, at the price of copying the
+// operands into the concatenations.  The dots must be independent -- no dot of
+// a batch transitively depends on another one.
+//
+// Only dots whose input+output bytes are below `max_size_to_batch` are batched;
+// large dots saturate the device on their own.  The pass expects the
+// canonical dots produced by DotDecomposer and should run before layout
+// assignment.
+class DotBatcher : public HloModulePass {
+ public:
+  explicit DotBatcher(int64_t max_size_to_batch)
+      : max_size_to_batch_(max_size_to_batch) {}
+
+  absl::string_view name() const override { return "dot-batcher"; }
+  using HloPassInterface::Run;
+  StatusOr<bool> Run(
+      HloModule* module,
+      const absl::flat_hash_set<absl::string_view>& execution_threads) override;
+
+ private:
+  int64_t max_size_to_batch_;
+};
+
+}  // namespace xla
+
+#endif  // TENSORFLOW_COMPILER_XLA_SERVICE_DOT_BATCHER_H_
@@ -0,0 +1,169 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/service/dot_batcher.h"
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+
+#include "absl/strings/string_view.h"
+#include "tensorflow/compiler/xla/service/pattern_matcher.h"
+#include "tensorflow/compiler/xla/service/pattern_matcher_gmock.h"
+#include "tensorflow/compiler/xla/tests/hlo_test_base.h"
+#include "tensorflow/tsl/lib/core/status_test_util.h"
+
+namespace xla {
+namespace {
+
+namespace m = ::xla::match;
+
+class DotBatcherTest : public HloTestBase {
+ public:
+  DotBatcherTest()
+      : HloTestBase(/*verifier_layout_sensitive=*/false,
+                    /*allow_mixed_precision_in_hlo_verifier=*/false) {}
+};
+
+TEST_F(DotBatcherTest, BatchIndependentDots) {
+  absl::string_view module_string = R"(
+  HloModule module
+
+  ENTRY main {
+    lhs0 = f32[8,32] parameter(0)
+    rhs0 = f32[32,16] parameter(1)
+    lhs1 = f32[8,32] parameter(2)
+    rhs1 = f32[32,16] parameter(3)
+    dot0 = f32[8,16] dot(lhs0, rhs0), lhs_contracting_dims={1}, rhs_contracting_dims={0}
+    dot1 = f32[8,16] dot(lhs1, rhs1), lhs_contracting_dims={1}, rhs_contracting_dims={0}
+    ROOT tuple = (f32[8,16], f32[8,16]) tuple(dot0, dot1)
+  })";
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> module,
+                          ParseAndReturnVerifiedModule(module_string));
+  DotBatcher pass(/*max_size_to_batch=*/std::numeric_limits<int64_t>::max());
+  TF_ASSERT_OK_AND_ASSIGN(bool changed, this->RunHloPass(&pass, module.get()));
+  EXPECT_TRUE(changed);
+
+  const HloInstruction* dot0 = nullptr;
+  const HloInstruction* dot1 = nullptr;
+  EXPECT_THAT(module->entry_computation()->root_instruction(),
+              GmockMatch(m::Tuple(m::Reshape(m::Slice(m::Dot(&dot0))),
+                                  m::Reshape(m::Slice(m::Dot(&dot1))))));
+  EXPECT_EQ(dot0, dot1);
+  EXPECT_TRUE(ShapeUtil::Equal(dot0->shape(),
+                               ShapeUtil::MakeShape(F32, {2, 8, 16})));
+  EXPECT_THAT(dot0, GmockMatch(m::Dot(
+                        m::Concatenate(m::Reshape(m::Parameter(0)),
+                                       m::Reshape(m::Parameter(2))),
+                        m::Concatenate(m::Reshape(m::Parameter(1)),
+                                       m::Reshape(m::Parameter(3))))));
+  const DotDimensionNumbers& dnums = dot0->dot_dimension_numbers();
+  EXPECT_THAT(dnums.lhs_batch_dimensions(), ::testing::ElementsAre(0));
+  EXPECT_THAT(dnums.rhs_batch_dimensions(), ::testing::ElementsAre(0));
+  EXPECT_THAT(dnums.lhs_contracting_dimensions(), ::testing::ElementsAre(2));
+  EXPECT_THAT(dnums.rhs_contracting_dimensions(), ::testing::ElementsAre(1));
+}
+
+TEST_F(DotBatcherTest, BatchDotsWithBatchDimensions) {
+  absl::string_view module_string = R"(
+  HloModule module
+
+  ENTRY main {
+    lhs0 = f32[4,8,32] parameter(0)
+    rhs0 = f32[4,32,16] parameter(1)
+    lhs1 = f32[4,8,32] parameter(2)
+    rhs1 = f32[4,32,16] parameter(3)
+    lhs2 = f32[4,8,32] parameter(4)
+    rhs2 = f32[4,32,16] parameter(5)
+    dot0 = f32[4,8,16] dot(lhs0, rhs0), lhs_batch_dims={0}, rhs_batch_dims={0}, lhs_contracting_dims={2}, rhs_contracting_dims={1}
+    dot1 = f32[4,8,16] dot(lhs1, rhs1), lhs_batch_dims={0}, rhs_batch_dims={0}, lhs_contracting_dims={2}, rhs_contracting_dims={1}
+    dot2 = f32[4,8,16] dot(lhs2, rhs2), lhs_batch_dims={0}, rhs_batch_dims={0}, lhs_contracting_dims={2}, rhs_contracting_dims={1}
+    ROOT tuple = (f32[4,8,16], f32[4,8,16], f32[4,8,16]) tuple(dot0, dot1, dot2)
+  })";
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> module,
+                          ParseAndReturnVerifiedModule(module_string));
+  DotBatcher pass(/*max_size_to_batch=*/std::numeric_limits<int64_t>::max());
+  TF_ASSERT_OK_AND_ASSIGN(bool changed, this->RunHloPass(&pass, module.get()));
+  EXPECT_TRUE(changed);
+
+  const HloInstruction* dot = nullptr;
+  EXPECT_THAT(module->entry_computation()->root_instruction()->operand(2),
+              GmockMatch(m::Reshape(m::Slice(m::Dot(&dot)))));
+  EXPECT_TRUE(ShapeUtil::Equal(dot->shape(),
+                               ShapeUtil::MakeShape(F32, {3, 4, 8, 16})));
+  const DotDimensionNumbers& dnums = dot->dot_dimension_numbers();
+  EXPECT_THAT(dnums.lhs_batch_dimensions(), ::testing::ElementsAre(0, 1));
+  EXPECT_THAT(dnums.rhs_batch_dimensions(), ::testing::ElementsAre(0, 1));
+}
+
+TEST_F(DotBatcherTest, NoBatchingOfDependentDots) {
+  absl::string_view module_string = R"(
+  HloModule module
+
+  ENTRY main {
+    lhs = f32[32,32] parameter(0)
+    rhs = f32[32,32] parameter(1)
+    dot0 = f32[32,32] dot(lhs, rhs), lhs_contracting_dims={1}, rhs_contracting_dims={0}
+    ROOT dot1 = f32[32,32] dot(dot0, rhs), lhs_contracting_dims={1}, rhs_contracting_dims={0}
+  })";
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> module,
+                          ParseAndReturnVerifiedModule(module_string));
+  DotBatcher pass(/*max_size_to_batch=*/std::numeric_limits<int64_t>::max());
+  TF_ASSERT_OK_AND_ASSIGN(bool changed, this->RunHloPass(&pass, module.get()));
+  EXPECT_FALSE(changed);
+}
+
+TEST_F(DotBatcherTest, NoBatchingOfDifferentShapes) {
+  absl::string_view module_string = R"(
+  HloModule module
+
+  ENTRY main {
+    lhs0 = f32[8,32] parameter(0)
+    rhs0 = f32[32,16] parameter(1)
+    lhs1 = f32[8,32] parameter(2)
+    rhs1 = f32[32,8] parameter(3)
+    dot0 = f32[8,16] dot(lhs0, rhs0), lhs_contracting_dims={1}, rhs_contracting_dims={0}
+    dot1 = f32[8,8] dot(lhs1, rhs1), lhs_contracting_dims={1}, rhs_contracting_dims={0}
+    ROOT tuple = (f32[8,16], f32[8,8]) tuple(dot0, dot1)
+  })";
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> module,
+                          ParseAndReturnVerifiedModule(module_string));
+  DotBatcher pass(/*max_size_to_batch=*/std::numeric_limits<int64_t>::max());
+  TF_ASSERT_OK_AND_ASSIGN(bool changed, this->RunHloPass(&pass, module.get()));
+  EXPECT_FALSE(changed);
+}
+
+TEST_F(DotBatcherTest, NoBatchingOfLargeDots) {
+  absl::string_view module_string = R"(
+  HloModule module
+
+  ENTRY main {
+    lhs0 = f32[8,32] parameter(0)
+    rhs0 = f32[32,16] parameter(1)
+    lhs1 = f32[8,32] parameter(2)
+    rhs1 = f32[32,16] parameter(3)
+    dot0 = f32[8,16] dot(lhs0, rhs0), lhs_contracting_dims={1}, rhs_contracting_dims={0}
+    dot1 = f32[8,16] dot(lhs1, rhs1), lhs_contracting_dims={1}, rhs_contracting_dims={0}
+    ROOT tuple = (f32[8,16], f32[8,16]) tuple(dot0, dot1)
+  })";
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> module,
+                          ParseAndReturnVerifiedModule(module_string));
+  DotBatcher pass(/*max_size_to_batch=*/1024);
+  TF_ASSERT_OK_AND_ASSIGN(bool changed, this->RunHloPass(&pass, module.get()));
+  EXPECT_FALSE(changed);
+}
+
+}  // namespace
+}  // namespace xla
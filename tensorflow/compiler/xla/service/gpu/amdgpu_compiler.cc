@@ -143,21 +143,28 @@ AMDGPUCompiler::CompileTargetBinary(const HloModuleConfig& module_config,
     rocdl_dir_ = GetROCDLDir(module_config);
   }
 
-  if (relocatable) {
-    return Unimplemented("relocatable target binary is not implemented");
-  }
-
   std::vector<uint8_t> hsaco;
   {
     XLA_SCOPED_LOGGING_TIMER(
         "AMDGPUCompiler::CompileTargetBinary - CompileToHsaco");
     TF_ASSIGN_OR_RETURN(
         hsaco, amdgpu::CompileToHsaco(llvm_module, gpu_version, module_config,
-                                      rocdl_dir_));
+                                      rocdl_dir_, relocatable));
   }
 
   return std::pair<std::string, std::vector<uint8_t>>("", std::move(hsaco));
 }
 
+StatusOr<bool> AMDGPUCompiler::CanUseLinkModules(
+    const HloModuleConfig& module_config) {
+  return true;
+}
+
+StatusOr<std::vector<uint8_t>> AMDGPUCompiler::LinkModules(
+    se::StreamExecutor* stream_exec, std::vector<std::vector<uint8_t>> modules,
+    const DebugOptions& debug_options) {
+  return amdgpu::LinkHsacoObjects(modules);
+}
+
 }  // namespace gpu
 }  // namespace xla
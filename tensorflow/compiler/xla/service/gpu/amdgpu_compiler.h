@@ -50,6 +50,16 @@ class AMDGPUCompiler : public GpuCompiler {
       const HloModule* debug_module) override;
 
  private:
+  // Relocatable HSACO objects are linked with ld.lld, which is always
+  // available in a ROCm installation.
+  StatusOr<bool> CanUseLinkModules(
+      const HloModuleConfig& module_config) override;
+
+  StatusOr<std::vector<uint8_t>> LinkModules(
+      se::StreamExecutor* stream_exec,
+      std::vector<std::vector<uint8_t>> modules,
+      const DebugOptions& debug_options) override;
+
   // The parent directory of ROCm-Device-Libs IR libraries.
   std::string rocdl_dir_;
 
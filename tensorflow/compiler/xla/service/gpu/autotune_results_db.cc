@@ -0,0 +1,314 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/service/gpu/autotune_results_db.h"
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/time/time.h"
+#include "tensorflow/compiler/xla/stream_executor/blas.h"
+#include "tensorflow/compiler/xla/stream_executor/device_description.h"
+#include "tensorflow/compiler/xla/stream_executor/dnn.h"
+#include "tensorflow/compiler/xla/util.h"
+#include "tensorflow/tsl/platform/errors.h"
+#include "tensorflow/tsl/platform/logging.h"
+#include "tensorflow/tsl/platform/path.h"
+#include "tensorflow/tsl/util/proto/proto_utils.h"
+
+namespace xla {
+namespace gpu {
+namespace {
+
+// The version of the structure of AutotuneResults, which is the same as the
+// one of SerializeAutotuneResults.
+// LINT.IfChange(version)
+constexpr int kVersion = 1;
+// LINT.ThenChange()
+
+constexpr char kResultsSuffix[] = ".pb";
+constexpr char kTemporarySuffix[] = ".tmp";
+
+using Entries = tsl::protobuf::RepeatedPtrField<AutotuneResults::Entry>;
+using EntryKey = std::pair<std::string, std::string>;
+
+EntryKey KeyOf(const AutotuneResults::Entry& entry) {
+  return {entry.device(), entry.hlo()};
+}
+
+bool SameEnvironment(const AutotuneResults::Environment& a,
+                     const AutotuneResults::Environment& b) {
+  return std::tie(a.platform(), a.compute_capability(), a.dnn_version(),
+                  a.blas_version()) == std::tie(b.platform(),
+                                                b.compute_capability(),
+                                                b.dnn_version(),
+                                                b.blas_version());
+}
+
+// Returns true if `a` is known to be faster than `b`. ROCm records a negative
+// run time for the convolutions that have a single candidate algorithm.
+bool IsFaster(const tensorflow::AutotuneResult& a,
+              const tensorflow::AutotuneResult& b) {
+  if (!a.has_run_time() || !b.has_run_time()) return false;
+  const absl::Duration a_time =
+      tsl::proto_utils::FromDurationProto(a.run_time());
+  const absl::Duration b_time =
+      tsl::proto_utils::FromDurationProto(b.run_time());
+  return a_time > absl::ZeroDuration() && b_time > absl::ZeroDuration() &&
+         a_time < b_time;
+}
+
+void MergeEntries(const Entries& from, Entries* to) {
+  // Ordered, so that the merged results are deterministic.
+  std::map<EntryKey, AutotuneResults::Entry> entries;
+  for (const AutotuneResults::Entry& entry : *to) {
+    entries.emplace(KeyOf(entry), entry);
+  }
+  for (const AutotuneResults::Entry& entry : from) {
+    auto [it, inserted] = entries.emplace(KeyOf(entry), entry);
+    if (!inserted && IsFaster(entry.result(), it->second.result())) {
+      it->second = entry;
+    }
+  }
+  to->Clear();
+  for (auto& [key, entry] : entries) {
+    *to->Add() = std::move(entry);
+  }
+}
+
+void AddMissingEntries(const Entries& from, const Entries& base, Entries* to) {
+  std::set<EntryKey> base_keys;
+  for (const AutotuneResults::Entry& entry : base) {
+    base_keys.insert(KeyOf(entry));
+  }
+  for (const AutotuneResults::Entry& entry : from) {
+    if (!base_keys.count(KeyOf(entry))) {
+      *to->Add() = entry;
+    }
+  }
+}
+
+StatusOr<AutotuneResults> ReadResults(tsl::Env* env, const std::string& path) {
+  std::string data;
+  TF_RETURN_IF_ERROR(tsl::ReadFileToString(env, path, &data));
+  AutotuneResults results;
+  if (!results.ParseFromString(data)) {
+    return tsl::errors::DataLoss("Failed to parse autotune results file ",
+                                 path);
+  }
+  if (results.version() != kVersion) {
+    return tsl::errors::FailedPrecondition(
+        "Version mismatch in autotune results file ", path, ". Expected ",
+        kVersion, " but was ", results.version());
+  }
+  return results;
+}
+
+}  // namespace
+
+AutotuneResultsDatabase::AutotuneResultsDatabase(std::string directory,
+                                                 tsl::Env* env)
+    : directory_(std::move(directory)), env_(env) {}
+
+StatusOr<std::vector<std::string>> AutotuneResultsDatabase::ListFiles(
+    const std::string& environment_dir) const {
+  std::vector<std::string> files;
+  if (!env_->IsDirectory(environment_dir).ok()) {
+    return files;
+  }
+  std::vector<std::string> children;
+  TF_RETURN_IF_ERROR(env_->GetChildren(environment_dir, &children));
+  for (const std::string& child : children) {
+    // The temporary files of the concurrent writers are skipped.
+    if (absl::EndsWith(child, kResultsSuffix)) {
+      files.push_back(tsl::io::JoinPath(environment_dir, child));
+    }
+  }
+  std::sort(files.begin(), files.end());
+  return files;
+}
+
+StatusOr<AutotuneResults> AutotuneResultsDatabase::Load(
+    const AutotuneResults::Environment& environment) const {
+  AutotuneResults merged;
+  merged.set_version(kVersion);
+  *merged.mutable_environment() = environment;
+  TF_ASSIGN_OR_RETURN(
+      std::vector<std::string> files,
+      ListFiles(tsl::io::JoinPath(
+          directory_, AutotuneEnvironmentDirectoryName(environment))));
+  for (const std::string& file : files) {
+    StatusOr<AutotuneResults> results = ReadResults(env_, file);
+    if (tsl::errors::IsNotFound(results.status())) {
+      // Removed by a concurrent compaction, which wrote its entries to a new
+      // file first.
+      continue;
+    }
+    TF_RETURN_IF_ERROR(results.status());
+    if (!SameEnvironment(results->environment(), environment)) {
+      LOG(WARNING) << "Skipping autotune results file " << file
+                   << " of another environment: "
+                   << results->environment().ShortDebugString();
+      continue;
+    }
+    MergeAutotuneResults(*results, &merged);
+  }
+  return merged;
+}
+
+Status AutotuneResultsDatabase::WriteNewFile(const AutotuneResults& results,
+                                             const std::string& prefix) const {
+  const std::string environment_dir = tsl::io::JoinPath(
+      directory_, AutotuneEnvironmentDirectoryName(results.environment()));
+  TF_RETURN_IF_ERROR(env_->RecursivelyCreateDir(environment_dir));
+  std::string path = tsl::io::JoinPath(environment_dir, prefix);
+  if (!env_->CreateUniqueFileName(&path, kResultsSuffix)) {
+    return tsl::errors::Internal("Failed to create a unique file name in ",
+                                 environment_dir);
+  }
+  const std::string temporary_path = absl::StrCat(path, kTemporarySuffix);
+  AutotuneResults versioned = results;
+  versioned.set_version(kVersion);
+  TF_RETURN_IF_ERROR(tsl::WriteStringToFile(env_, temporary_path,
+                                            versioned.SerializeAsString()));
+  return env_->RenameFile(temporary_path, path);
+}
+
+Status AutotuneResultsDatabase::Append(const AutotuneResults& results) const {
+  if (results.dots_size() == 0 && results.convs_size() == 0) {
+    return OkStatus();
+  }
+  return WriteNewFile(results, "results-");
+}
+
+Status AutotuneResultsDatabase::Compact() const {
+  TF_ASSIGN_OR_RETURN(std::vector<AutotuneResults::Environment> environments,
+                      ListEnvironments());
+  for (const AutotuneResults::Environment& environment : environments) {
+    const std::string environment_dir = tsl::io::JoinPath(
+        directory_, AutotuneEnvironmentDirectoryName(environment));
+    TF_ASSIGN_OR_RETURN(std::vector<std::string> files,
+                        ListFiles(environment_dir));
+    if (files.size() < 2) continue;
+
+    // Only the files that were merged are removed, so that the files
+    // appended during the compaction are kept.
+    AutotuneResults merged;
+    *merged.mutable_environment() = environment;
+    for (const std::string& file : files) {
+      TF_ASSIGN_OR_RETURN(AutotuneResults results, ReadResults(env_, file));
+      MergeAutotuneResults(results, &merged);
+    }
+    TF_RETURN_IF_ERROR(WriteNewFile(merged, "merged-"));
+    for (const std::string& file : files) {
+      Status status = env_->DeleteFile(file);
+      if (!status.ok() && !tsl::errors::IsNotFound(status)) return status;
+    }
+    VLOG(1) << "Merged " << files.size() << " autotune results files of "
+            << environment_dir;
+  }
+  return OkStatus();
+}
+
+StatusOr<std::vector<AutotuneResults::Environment>>
+AutotuneResultsDatabase::ListEnvironments() const {
+  std::vector<AutotuneResults::Environment> environments;
+  if (!env_->IsDirectory(directory_).ok()) {
+    return environments;
+  }
+  std::vector<std::string> children;
+  TF_RETURN_IF_ERROR(env_->GetChildren(directory_, &children));
+  std::sort(children.begin(), children.end());
+  for (const std::string& child : children) {
+    TF_ASSIGN_OR_RETURN(std::vector<std::string> files,
+                        ListFiles(tsl::io::JoinPath(directory_, child)));
+    // The environment is read from the first file that still exists.
+    for (const std::string& file : files) {
+      StatusOr<AutotuneResults> results = ReadResults(env_, file);
+      if (tsl::errors::IsNotFound(results.status())) continue;
+      TF_RETURN_IF_ERROR(results.status());
+      environments.push_back(results->environment());
+      break;
+    }
+  }
+  return environments;
+}
+
+AutotuneResults::Environment GetAutotuneEnvironment(
+    se::StreamExecutor* stream_exec) {
+  AutotuneResults::Environment environment;
+  environment.set_platform(stream_exec->platform()->Name());
+  const se::DeviceDescription& description =
+      stream_exec->GetDeviceDescription();
+  if (stream_exec->platform_kind() == se::PlatformKind::kROCm) {
+    environment.set_compute_capability(
+        description.rocm_compute_capability().gcn_arch_name());
+  } else {
+    environment.set_compute_capability(
+        description.cuda_compute_capability().ToString());
+  }
+  if (se::dnn::DnnSupport* dnn = stream_exec->AsDnn()) {
+    StatusOr<se::dnn::VersionInfo> version = dnn->GetVersion();
+    if (version.ok()) {
+      environment.set_dnn_version(absl::StrCat(version->major_version(), ".",
+                                               version->minor_version(), ".",
+                                               version->patch()));
+    }
+  }
+  if (se::blas::BlasSupport* blas = stream_exec->AsBlas()) {
+    std::string version;
+    if (blas->GetVersion(&version).ok()) {
+      environment.set_blas_version(version);
+    }
+  }
+  return environment;
+}
+
+std::string AutotuneEnvironmentDirectoryName(
+    const AutotuneResults::Environment& environment) {
+  std::string name = absl::StrCat(
+      environment.platform(), "_", environment.compute_capability(), "_dnn-",
+      environment.dnn_version(), "_blas-", environment.blas_version());
+  for (char& c : name) {
+    if (!absl::ascii_isalnum(c) && c != '.' && c != '-' && c != '_') c = '_';
+  }
+  return name;
+}
+
+void MergeAutotuneResults(const AutotuneResults& from, AutotuneResults* to) {
+  MergeEntries(from.dots(), to->mutable_dots());
+  MergeEntries(from.convs(), to->mutable_convs());
+}
+
+AutotuneResults AutotuneResultsDifference(const AutotuneResults& results,
+                                          const AutotuneResults& base) {
+  AutotuneResults difference;
+  difference.set_version(results.version());
+  *difference.mutable_environment() = results.environment();
+  AddMissingEntries(results.dots(), base.dots(), difference.mutable_dots());
+  AddMissingEntries(results.convs(), base.convs(), difference.mutable_convs());
+  return difference;
+}
+
+}  // namespace gpu
+}  // namespace xla
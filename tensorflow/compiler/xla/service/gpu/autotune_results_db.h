@@ -0,0 +1,99 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_COMPILER_XLA_SERVICE_GPU_AUTOTUNE_RESULTS_DB_H_
+#define TENSORFLOW_COMPILER_XLA_SERVICE_GPU_AUTOTUNE_RESULTS_DB_H_
+
+#include <string>
+#include <vector>
+
+#include "tensorflow/compiler/xla/autotune_results.pb.h"
+#include "tensorflow/compiler/xla/statusor.h"
+#include "tensorflow/compiler/xla/stream_executor/stream_executor.h"
+#include "tensorflow/compiler/xla/types.h"
+#include "tensorflow/tsl/platform/env.h"
+#include "tensorflow/tsl/platform/status.h"
+
+namespace xla {
+namespace gpu {
+
+// A directory of autotuning results shared by the jobs of a fleet, so that
+// each job only autotunes the dots and convolutions that no job autotuned in
+// the same environment before (see --xla_gpu_shared_autotune_results_dir).
+//
+// The directory has one subdirectory per environment, named by
+// AutotuneEnvironmentDirectoryName, which holds serialized AutotuneResults.
+// Files are never modified: new results are appended as a new file, which is
+// written under a temporary name and renamed, so that readers only see
+// complete files. Compact() merges the files of each environment into one to
+// keep loading fast; it can run concurrently with the jobs.
+class AutotuneResultsDatabase {
+ public:
+  explicit AutotuneResultsDatabase(std::string directory,
+                                   tsl::Env* env = tsl::Env::Default());
+
+  // Returns the merged results of `environment`, with no entries if the
+  // database has none. Files of another environment or version are skipped.
+  StatusOr<AutotuneResults> Load(
+      const AutotuneResults::Environment& environment) const;
+
+  // Adds the entries of `results` to the results of `results.environment()`.
+  Status Append(const AutotuneResults& results) const;
+
+  // Merges the files of each environment into a single file.
+  Status Compact() const;
+
+  // Returns the environments that have results in the database.
+  StatusOr<std::vector<AutotuneResults::Environment>> ListEnvironments() const;
+
+ private:
+  // Returns the paths of the results files of the environment directory
+  // `environment_dir`, which may not exist.
+  StatusOr<std::vector<std::string>> ListFiles(
+      const std::string& environment_dir) const;
+
+  // Atomically writes `results` as a new file with the name
+  // `prefix`<unique id>.pb in the directory of its environment.
+  Status WriteNewFile(const AutotuneResults& results,
+                      const std::string& prefix) const;
+
+  const std::string directory_;
+  tsl::Env* const env_;
+};
+
+// Returns the environment of the autotuning results produced on
+// `stream_exec`.
+AutotuneResults::Environment GetAutotuneEnvironment(
+    se::StreamExecutor* stream_exec);
+
+// Returns the name of the directory of the results of `environment` in an
+// AutotuneResultsDatabase.
+std::string AutotuneEnvironmentDirectoryName(
+    const AutotuneResults::Environment& environment);
+
+// Merges the entries of `from` into `to`, keyed by device and HLO. If both
+// have an entry for a key, keeps the one with the shorter run time, or the one
+// of `to` if either run time is unknown. Sorts the entries of `to`.
+void MergeAutotuneResults(const AutotuneResults& from, AutotuneResults* to);
+
+// Returns the entries of `results` that `base` has no entry for, with the
+// version and environment of `results`.
+AutotuneResults AutotuneResultsDifference(const AutotuneResults& results,
+                                          const AutotuneResults& base);
+
+}  // namespace gpu
+}  // namespace xla
+
+#endif  // TENSORFLOW_COMPILER_XLA_SERVICE_GPU_AUTOTUNE_RESULTS_DB_H_
@@ -0,0 +1,173 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/service/gpu/autotune_results_db.h"
+
+#include <string>
+#include <vector>
+
+#include "absl/time/time.h"
+#include "tensorflow/tsl/lib/core/status_test_util.h"
+#include "tensorflow/tsl/platform/env.h"
+#include "tensorflow/tsl/platform/path.h"
+#include "tensorflow/tsl/platform/test.h"
+#include "tensorflow/tsl/util/proto/proto_utils.h"
+
+namespace xla {
+namespace gpu {
+namespace {
+
+AutotuneResults::Environment Environment(const std::string& arch) {
+  AutotuneResults::Environment environment;
+  environment.set_platform("ROCM");
+  environment.set_compute_capability(arch);
+  environment.set_dnn_version("2.19.0");
+  environment.set_blas_version("3.0.0");
+  return environment;
+}
+
+AutotuneResults::Entry Entry(const std::string& hlo, int64_t run_time_us) {
+  AutotuneResults::Entry entry;
+  entry.set_device("AMD Instinct MI250X");
+  entry.set_hlo(hlo);
+  *entry.mutable_result()->mutable_run_time() =
+      tsl::proto_utils::ToDurationProto(absl::Microseconds(run_time_us));
+  return entry;
+}
+
+AutotuneResults Results(const std::string& arch,
+                        const std::vector<AutotuneResults::Entry>& convs) {
+  AutotuneResults results;
+  *results.mutable_environment() = Environment(arch);
+  for (const AutotuneResults::Entry& conv : convs) {
+    *results.add_convs() = conv;
+  }
+  return results;
+}
+
+std::string TestDirectory(const std::string& name) {
+  std::string directory = tsl::io::JoinPath(tsl::testing::TmpDir(), name);
+  int64_t undeleted_files, undeleted_dirs;
+  tsl::Env::Default()
+      ->DeleteRecursively(directory, &undeleted_files, &undeleted_dirs)
+      .IgnoreError();
+  return directory;
+}
+
+TEST(AutotuneResultsDatabaseTest, LoadsAppendedResults) {
+  AutotuneResultsDatabase database(TestDirectory("append"));
+  TF_ASSERT_OK(database.Append(Results("gfx90a", {Entry("conv0", 10)})));
+  TF_ASSERT_OK(database.Append(Results("gfx90a", {Entry("conv1", 20)})));
+  TF_ASSERT_OK(database.Append(Results("gfx942", {Entry("conv2", 30)})));
+
+  TF_ASSERT_OK_AND_ASSIGN(AutotuneResults results,
+                          database.Load(Environment("gfx90a")));
+  EXPECT_EQ(results.version(), 1);
+  ASSERT_EQ(results.convs_size(), 2);
+  EXPECT_EQ(results.convs(0).hlo(), "conv0");
+  EXPECT_EQ(results.convs(1).hlo(), "conv1");
+
+  TF_ASSERT_OK_AND_ASSIGN(results, database.Load(Environment("gfx1100")));
+  EXPECT_EQ(results.convs_size(), 0);
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::vector<AutotuneResults::Environment> environments,
+      database.ListEnvironments());
+  EXPECT_EQ(environments.size(), 2);
+}
+
+TEST(AutotuneResultsDatabaseTest, LoadsEmptyDatabase) {
+  AutotuneResultsDatabase database(TestDirectory("empty"));
+  TF_ASSERT_OK_AND_ASSIGN(AutotuneResults results,
+                          database.Load(Environment("gfx90a")));
+  EXPECT_EQ(results.convs_size(), 0);
+  TF_ASSERT_OK(database.Compact());
+}
+
+TEST(AutotuneResultsDatabaseTest, CompactsFiles) {
+  const std::string directory = TestDirectory("compact");
+  AutotuneResultsDatabase database(directory);
+  for (int i = 0; i < 3; ++i) {
+    TF_ASSERT_OK(database.Append(
+        Results("gfx90a", {Entry("conv0", 10 - i), Entry("conv1", 20)})));
+  }
+  TF_ASSERT_OK(database.Compact());
+
+  std::vector<std::string> files;
+  const std::string environment_dir = tsl::io::JoinPath(
+      directory, AutotuneEnvironmentDirectoryName(Environment("gfx90a")));
+  TF_ASSERT_OK(tsl::Env::Default()->GetChildren(environment_dir, &files));
+  EXPECT_EQ(files.size(), 1);
+
+  TF_ASSERT_OK_AND_ASSIGN(AutotuneResults results,
+                          database.Load(Environment("gfx90a")));
+  ASSERT_EQ(results.convs_size(), 2);
+  EXPECT_EQ(tsl::proto_utils::FromDurationProto(
+                results.convs(0).result().run_time()),
+            absl::Microseconds(8));
+}
+
+TEST(AutotuneResultsDatabaseTest, SkipsResultsOfAnotherEnvironment) {
+  const std::string directory = TestDirectory("validate");
+  AutotuneResultsDatabase database(directory);
+  // A file of gfx942 in the directory of gfx90a.
+  AutotuneResults results = Results("gfx942", {Entry("conv0", 10)});
+  results.set_version(1);
+  const std::string environment_dir = tsl::io::JoinPath(
+      directory, AutotuneEnvironmentDirectoryName(Environment("gfx90a")));
+  TF_ASSERT_OK(tsl::Env::Default()->RecursivelyCreateDir(environment_dir));
+  TF_ASSERT_OK(tsl::WriteStringToFile(
+      tsl::Env::Default(), tsl::io::JoinPath(environment_dir, "misplaced.pb"),
+      results.SerializeAsString()));
+
+  TF_ASSERT_OK_AND_ASSIGN(results, database.Load(Environment("gfx90a")));
+  EXPECT_EQ(results.convs_size(), 0);
+}
+
+TEST(AutotuneResultsDatabaseTest, MergeKeepsFasterResult) {
+  AutotuneResults to = Results("gfx90a", {Entry("conv0", 10)});
+  MergeAutotuneResults(
+      Results("gfx90a", {Entry("conv1", 30), Entry("conv0", 5)}), &to);
+  ASSERT_EQ(to.convs_size(), 2);
+  EXPECT_EQ(to.convs(0).hlo(), "conv0");
+  EXPECT_EQ(
+      tsl::proto_utils::FromDurationProto(to.convs(0).result().run_time()),
+      absl::Microseconds(5));
+
+  // A result with an unknown run time does not replace one with a run time.
+  MergeAutotuneResults(Results("gfx90a", {Entry("conv0", -1)}), &to);
+  EXPECT_EQ(
+      tsl::proto_utils::FromDurationProto(to.convs(0).result().run_time()),
+      absl::Microseconds(5));
+}
+
+TEST(AutotuneResultsDatabaseTest, Difference) {
+  AutotuneResults difference = AutotuneResultsDifference(
+      Results("gfx90a", {Entry("conv0", 10), Entry("conv1", 20)}),
+      Results("gfx90a", {Entry("conv0", 10)}));
+  ASSERT_EQ(difference.convs_size(), 1);
+  EXPECT_EQ(difference.convs(0).hlo(), "conv1");
+  EXPECT_EQ(difference.environment().compute_capability(), "gfx90a");
+}
+
+TEST(AutotuneResultsDatabaseTest, DirectoryName) {
+  EXPECT_EQ(
+      AutotuneEnvironmentDirectoryName(Environment("gfx90a:sramecc+:xnack-")),
+      "ROCM_gfx90a_sramecc__xnack-_dnn-2.19.0_blas-3.0.0");
+}
+
+}  // namespace
+}  // namespace gpu
+}  // namespace xla
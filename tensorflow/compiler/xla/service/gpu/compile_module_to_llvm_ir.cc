@@ -25,7 +25,9 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/strings/str_cat.h"
+#include "absl/time/time.h"
 #include "llvm/AsmParser/Parser.h"
 #include "llvm/IR/DiagnosticInfo.h"
 #include "llvm/IR/DiagnosticPrinter.h"
@@ -52,11 +54,16 @@ limitations under the License.
 #include "tensorflow/compiler/xla/service/gpu/gpu_convert_async_collectives_to_sync.h"
 #include "tensorflow/compiler/xla/service/gpu/gpu_device_info.h"
 #include "tensorflow/compiler/xla/service/gpu/gpu_executable.h"
+#include "tensorflow/compiler/xla/service/gpu/gpu_hlo_cost_analysis.h"
 #include "tensorflow/compiler/xla/service/gpu/gpu_hlo_schedule.h"
+#include "tensorflow/compiler/xla/service/gpu/gpu_performance_model.h"
+#include "tensorflow/compiler/xla/service/gpu/gpu_types.h"
+#include "tensorflow/compiler/xla/service/gpu/host_offloader.h"
 #include "tensorflow/compiler/xla/service/gpu/ir_emitter_context.h"
 #include "tensorflow/compiler/xla/service/gpu/ir_emitter_unnested.h"
 #include "tensorflow/compiler/xla/service/gpu/metrics.h"
 #include "tensorflow/compiler/xla/service/gpu/sequential_thunk.h"
+#include "tensorflow/compiler/xla/service/gpu/thunk_stream_assignment.h"
 #include "tensorflow/compiler/xla/service/gpu/while_thunk.h"
 #include "tensorflow/compiler/xla/service/hlo_dataflow_analysis.h"
 #include "tensorflow/compiler/xla/service/hlo_pass_pipeline.h"
@@ -101,6 +108,62 @@ static bool HasFp8(const HloModule& hlo_module) {
   return false;
 }
 
+// Returns the time the Gpu performance model estimates for recomputing an
+// instruction, converted to the bytes the device reads or writes in the same
+// time. The cost analysis of a computation is only run once rematerialization
+// looks at one of its instructions.
+static HloRematerialization::RecomputeCostFunction GetRecomputeCostFunction(
+    const GpuDeviceInfo& gpu_device_info,
+    const GpuPerformanceModelCoefficients& coefficients, int pointer_size) {
+  struct State {
+    absl::flat_hash_map<const HloComputation*,
+                        absl::flat_hash_map<const HloInstruction*, double>>
+        costs;
+  };
+  auto state = std::make_shared<State>();
+  return [state, gpu_device_info, coefficients,
+          pointer_size](const HloInstruction* instruction) -> double {
+    const HloComputation* computation = instruction->parent();
+    auto it = state->costs.find(computation);
+    if (it == state->costs.end()) {
+      HloCostAnalysis::Options options{[pointer_size](const Shape& shape) {
+        return GetSizeOfShape(shape, pointer_size);
+      }};
+      options.set_bytes_per_second(gpu_device_info.memory_bandwidth);
+      GpuHloCostAnalysis cost_analysis(options);
+      it = state->costs.try_emplace(computation).first;
+      Status status = computation->Accept(&cost_analysis);
+      if (!status.ok()) {
+        VLOG(1) << "Cost analysis of " << computation->name()
+                << " failed: " << status;
+        return 0;
+      }
+      for (const HloInstruction* instr : computation->instructions()) {
+        switch (instr->opcode()) {
+          case HloOpcode::kParameter:
+          case HloOpcode::kConstant:
+          case HloOpcode::kBitcast:
+          case HloOpcode::kGetTupleElement:
+          case HloOpcode::kTuple:
+            continue;
+          default:
+            break;
+        }
+        absl::Duration time =
+            GpuPerformanceModel::EstimateRunTimes(
+                instr, &cost_analysis, gpu_device_info, /*fused_users=*/{},
+                /*multi_output=*/false, coefficients)
+                .time_unfused;
+        it->second[instr] =
+            absl::ToDoubleSeconds(time) * gpu_device_info.memory_bandwidth;
+      }
+    }
+    // Instructions added by rematerialization itself are not recomputed again.
+    auto cost = it->second.find(instruction);
+    return cost == it->second.end() ? 0 : cost->second;
+  };
+}
+
 // Lowers MLIR module to the XLA Gpu runtime custom calls.
 static Status LowerToXlaGpuRuntime(mlir::ModuleOp module,
                                    llvm::StringRef entry_function_name,
@@ -237,6 +300,20 @@ Status CompileModuleToLlvmIrImpl(
     pipeline.AddPass<GpuConvertAsyncCollectivesToSync>(is_nop);
     pipeline.AddPass<OptimizationBarrierExpander>();
 
+    // The copies to and from the host are custom calls of the Xla runtime.
+    const DebugOptions& debug_options = hlo_module->config().debug_options();
+    if (debug_options.xla_gpu_enable_host_offload() &&
+        debug_options.xla_gpu_enable_xla_runtime_executable()) {
+      HostOffloader::Options options;
+      // The same budget as rematerialization below, which handles what the
+      // offloading leaves over.
+      options.memory_limit_bytes = gpu_device_info.device_memory_size * 0.75;
+      pipeline.AddPass<HostOffloader>(
+          options, [pointer_size](const Shape& shape) {
+            return GetSizeOfShape(shape, pointer_size);
+          });
+    }
+
     TF_RETURN_IF_ERROR(pipeline.Run(hlo_module).status());
   }
 
@@ -245,6 +322,22 @@ Status CompileModuleToLlvmIrImpl(
     return GetSizeOfShape(buffer_value.shape(), pointer_size);
   };
 
+  const DebugOptions& debug_options = hlo_module->config().debug_options();
+  HloRematerialization::RecomputeCostFunction recompute_cost_function;
+  if (debug_options.xla_gpu_enable_cost_model_rematerialization()) {
+    GpuVersion gpu_version = cuda_compute_capability;
+    if (platform_id == se::rocm::kROCmPlatformId) {
+      gpu_version = rocm_compute_capability;
+    }
+    TF_ASSIGN_OR_RETURN(
+        const GpuPerformanceModelCoefficients coefficients,
+        GpuPerformanceModelCoefficients::ForDevice(
+            gpu_device_info, gpu_version,
+            debug_options.xla_gpu_performance_model_coefficients()));
+    recompute_cost_function =
+        GetRecomputeCostFunction(gpu_device_info, coefficients, pointer_size);
+  }
+
   HloRematerialization::RematerializationSizes sizes;
   HloRematerialization remat(
       [pointer_size](const Shape& shape) {
@@ -256,7 +349,8 @@ Status CompileModuleToLlvmIrImpl(
       HloRematerialization::RematerializationPass::kPostFusion,
       /*block_size_limit=*/1, /*block_rematerialization_factor=*/1,
       /*compact_shape_function=*/nullptr,
-      HloRematerialization::RematerializationMode::kRecomputeAndCompress);
+      HloRematerialization::RematerializationMode::kRecomputeAndCompress,
+      /*min_remat_size=*/0, std::move(recompute_cost_function));
   TF_ASSIGN_OR_RETURN(bool changed, remat.Run(hlo_module));
   if (changed) {
     VLOG(1) << "HloRematerialization saved "
@@ -362,6 +456,13 @@ Status CompileModuleToLlvmIrImpl(
   }
 
   auto thunk_sequence = ir_emitter->ConsumeThunkSequence();
+  // The assignment looks at the operations the thunks were emitted from.
+  const int num_thunk_streams =
+      hlo_module->config().debug_options().xla_gpu_num_thunk_streams();
+  if (num_thunk_streams > 1) {
+    results->thunk_stream_assignment = ThunkStreamAssignment::Create(
+        *thunk_sequence, results->allocations, num_thunk_streams);
+  }
   ForAllThunks([](Thunk* thunk) { thunk->ClearCompileTimeInfo(); },
                thunk_sequence.get());
   results->executable = std::move(thunk_sequence);
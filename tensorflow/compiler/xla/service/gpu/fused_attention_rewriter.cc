@@ -0,0 +1,807 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/service/gpu/fused_attention_rewriter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "absl/algorithm/container.h"
+#include "absl/base/casts.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/str_format.h"
+#include "tensorflow/compiler/xla/hlo/ir/hlo_computation.h"
+#include "tensorflow/compiler/xla/hlo/ir/hlo_instruction.h"
+#include "tensorflow/compiler/xla/hlo/ir/hlo_opcode.h"
+#include "tensorflow/compiler/xla/hlo/ir/hlo_reachability.h"
+#include "tensorflow/compiler/xla/layout_util.h"
+#include "tensorflow/compiler/xla/primitive_util.h"
+#include "tensorflow/compiler/xla/shape_util.h"
+#include "tensorflow/compiler/xla/xla_data.pb.h"
+#include "tensorflow/tsl/platform/errors.h"
+#include "tensorflow/tsl/platform/logging.h"
+
+namespace xla {
+namespace gpu {
+namespace {
+
+// The largest head dimension the kernels in
+// runtime/fused_attention_kernel.cu.cc are instantiated for.
+constexpr int64_t kMaxHeadDim = 128;
+
+// The largest batch, which the kernels map to the grid y dimension.
+constexpr int64_t kMaxBatch = 65535;
+
+// Returns the value of `hlo` if it is a scalar constant or a broadcast of one.
+std::optional<double> GetScalarConstant(const HloInstruction* hlo) {
+  if (hlo->opcode() == HloOpcode::kBroadcast) {
+    hlo = hlo->operand(0);
+  }
+  if (hlo->opcode() != HloOpcode::kConstant ||
+      !ShapeUtil::IsEffectiveScalar(hlo->shape())) {
+    return std::nullopt;
+  }
+  return hlo->literal().GetAsDouble(
+      std::vector<int64_t>(hlo->shape().rank(), 0));
+}
+
+bool IsFloatingPointConvert(const HloInstruction* hlo) {
+  return hlo->opcode() == HloOpcode::kConvert &&
+         primitive_util::IsFloatingPointType(hlo->shape().element_type()) &&
+         primitive_util::IsFloatingPointType(
+             hlo->operand(0)->shape().element_type());
+}
+
+// Collects the instructions of a matched pattern, so that we can check that the
+// values they compute are not used outside of it.
+class Pattern {
+ public:
+  void Add(HloInstruction* hlo) {
+    // Constants are often shared, and are not computed by the pattern anyway.
+    if (!GetScalarConstant(hlo).has_value()) {
+      instructions_.insert(hlo);
+    }
+  }
+
+  bool Contains(const HloInstruction* hlo) const {
+    return instructions_.contains(hlo);
+  }
+
+  // Returns whether all the users of the instructions of the pattern are in
+  // the pattern, or in `outputs`.
+  bool IsClosed(
+      const absl::flat_hash_set<const HloInstruction*>& outputs) const {
+    return absl::c_all_of(instructions_, [&](const HloInstruction* hlo) {
+      return absl::c_all_of(hlo->users(), [&](const HloInstruction* user) {
+        return instructions_.contains(user) || outputs.contains(user);
+      });
+    });
+  }
+
+  const absl::flat_hash_set<HloInstruction*>& instructions() const {
+    return instructions_;
+  }
+
+ private:
+  absl::flat_hash_set<HloInstruction*> instructions_;
+};
+
+// Skips floating point converts, adding them to `pattern`.
+HloInstruction* SkipConverts(HloInstruction* hlo, Pattern& pattern) {
+  while (IsFloatingPointConvert(hlo)) {
+    pattern.Add(hlo);
+    hlo = hlo->mutable_operand(0);
+  }
+  return hlo;
+}
+
+// Returns the only user of `hlo`, or nullptr.
+HloInstruction* SoleUser(const HloInstruction* hlo) {
+  return hlo->user_count() == 1 ? hlo->users()[0] : nullptr;
+}
+
+// Follows floating point converts through the users of `hlo`, adding them to
+// `pattern`.
+HloInstruction* FollowConverts(HloInstruction* hlo, Pattern& pattern) {
+  while (HloInstruction* user = SoleUser(hlo)) {
+    if (!IsFloatingPointConvert(user)) break;
+    pattern.Add(user);
+    hlo = user;
+  }
+  return hlo;
+}
+
+// If `hlo` is `x * c` or `x / c` with a constant c, returns x and sets
+// `factor` to c or 1/c.
+HloInstruction* MatchScale(HloInstruction* hlo, double& factor) {
+  if (hlo->opcode() == HloOpcode::kMultiply) {
+    for (int i = 0; i < 2; ++i) {
+      std::optional<double> value = GetScalarConstant(hlo->operand(1 - i));
+      if (value.has_value()) {
+        factor = *value;
+        return hlo->mutable_operand(i);
+      }
+    }
+  } else if (hlo->opcode() == HloOpcode::kDivide) {
+    std::optional<double> value = GetScalarConstant(hlo->operand(1));
+    if (value.has_value() && *value != 0.0) {
+      factor = 1.0 / *value;
+      return hlo->mutable_operand(0);
+    }
+  }
+  return nullptr;
+}
+
+bool FactorsMatch(double lhs, double rhs) {
+  return std::abs(lhs - rhs) <= 1e-6 * std::max(std::abs(lhs), std::abs(rhs));
+}
+
+// If `hlo` is `select(mask, x, c)` with a constant c, returns x and sets
+// `mask` and `value`.
+HloInstruction* MatchMask(HloInstruction* hlo, HloInstruction*& mask,
+                          double& value) {
+  if (hlo->opcode() != HloOpcode::kSelect) return nullptr;
+  std::optional<double> constant = GetScalarConstant(hlo->operand(2));
+  if (!constant.has_value() ||
+      hlo->operand(0)->shape().element_type() != PRED ||
+      !ShapeUtil::SameDimensions(hlo->operand(0)->shape(), hlo->shape())) {
+    return nullptr;
+  }
+  mask = hlo->mutable_operand(0);
+  value = *constant;
+  return hlo->mutable_operand(1);
+}
+
+// If `hlo` is dropout of x, `select(keep, x * c, 0)` or
+// `select(keep, x, 0) * c` (or with x / c), returns x and sets `keep` and
+// `scale`.
+HloInstruction* MatchDropout(HloInstruction* hlo, HloInstruction*& keep,
+                             double& scale, Pattern& pattern) {
+  double zero;
+  if (HloInstruction* scaled = MatchMask(hlo, keep, zero)) {
+    if (zero != 0.0) return nullptr;
+    HloInstruction* x = MatchScale(scaled, scale);
+    if (x == nullptr) return nullptr;
+    pattern.Add(hlo);
+    pattern.Add(scaled);
+    return x;
+  }
+  HloInstruction* selected = MatchScale(hlo, scale);
+  if (selected == nullptr) return nullptr;
+  HloInstruction* x = MatchMask(selected, keep, zero);
+  if (x == nullptr || zero != 0.0) return nullptr;
+  pattern.Add(hlo);
+  pattern.Add(selected);
+  return x;
+}
+
+// If `hlo` broadcasts a value of rank r-1 along the minor-most dimension of a
+// rank r shape, returns that value.
+HloInstruction* MatchRowBroadcast(HloInstruction* hlo) {
+  const int64_t rank = hlo->shape().rank();
+  if (hlo->opcode() != HloOpcode::kBroadcast || rank == 0) return nullptr;
+  std::vector<int64_t> dimensions(rank - 1);
+  absl::c_iota(dimensions, 0);
+  if (hlo->operand(0)->shape().rank() != rank - 1 ||
+      hlo->dimensions() != dimensions) {
+    return nullptr;
+  }
+  return hlo->mutable_operand(0);
+}
+
+// If `hlo` reduces the minor-most dimension of x with `reducer`, returns x.
+HloInstruction* MatchRowReduction(HloInstruction* hlo, HloOpcode reducer) {
+  if (hlo->opcode() != HloOpcode::kReduce || hlo->operand_count() != 2 ||
+      hlo->shape().IsTuple()) {
+    return nullptr;
+  }
+  HloInstruction* x = hlo->mutable_operand(0);
+  const HloInstruction* root = hlo->to_apply()->root_instruction();
+  std::optional<double> init = GetScalarConstant(hlo->operand(1));
+  if (hlo->dimensions() != std::vector<int64_t>{x->shape().rank() - 1} ||
+      root->opcode() != reducer ||
+      root->operand(0)->opcode() != HloOpcode::kParameter ||
+      root->operand(1)->opcode() != HloOpcode::kParameter ||
+      !init.has_value()) {
+    return nullptr;
+  }
+  if (reducer == HloOpcode::kAdd) {
+    return *init == 0.0 ? x : nullptr;
+  }
+  return std::isinf(*init) && *init < 0 ? x : nullptr;
+}
+
+// If `hlo` is `exp(x - max(x)) / sum(exp(x - max(x)))` over the minor-most
+// dimension, returns x.
+HloInstruction* MatchSoftmax(HloInstruction* hlo, Pattern& pattern) {
+  if (hlo->opcode() != HloOpcode::kDivide) return nullptr;
+  HloInstruction* exp = hlo->mutable_operand(0);
+  HloInstruction* broadcast_sum = hlo->mutable_operand(1);
+  HloInstruction* sum = MatchRowBroadcast(broadcast_sum);
+  if (exp->opcode() != HloOpcode::kExp || sum == nullptr ||
+      MatchRowReduction(sum, HloOpcode::kAdd) != exp) {
+    return nullptr;
+  }
+  HloInstruction* subtract = exp->mutable_operand(0);
+  if (subtract->opcode() != HloOpcode::kSubtract) return nullptr;
+  HloInstruction* x = subtract->mutable_operand(0);
+  HloInstruction* broadcast_max = subtract->mutable_operand(1);
+  HloInstruction* max = MatchRowBroadcast(broadcast_max);
+  if (max == nullptr || MatchRowReduction(max, HloOpcode::kMaximum) != x) {
+    return nullptr;
+  }
+  for (HloInstruction* instr :
+       {hlo, exp, broadcast_sum, sum, subtract, broadcast_max, max}) {
+    pattern.Add(instr);
+  }
+  return x;
+}
+
+// Returns whether `hlo` is a dot with the leading dimensions as batch
+// dimensions and the given contracting dimensions.
+bool IsBatchDot(const HloInstruction* hlo, int64_t lhs_contracting,
+                int64_t rhs_contracting) {
+  if (hlo->opcode() != HloOpcode::kDot) return false;
+  const int64_t rank = hlo->shape().rank();
+  if (rank < 2 || hlo->operand(0)->shape().rank() != rank ||
+      hlo->operand(1)->shape().rank() != rank) {
+    return false;
+  }
+  std::vector<int64_t> batch(rank - 2);
+  absl::c_iota(batch, 0);
+  const DotDimensionNumbers& dnums = hlo->dot_dimension_numbers();
+  return absl::c_equal(dnums.lhs_batch_dimensions(), batch) &&
+         absl::c_equal(dnums.rhs_batch_dimensions(), batch) &&
+         absl::c_equal(dnums.lhs_contracting_dimensions(),
+                       std::vector<int64_t>{lhs_contracting}) &&
+         absl::c_equal(dnums.rhs_contracting_dimensions(),
+                       std::vector<int64_t>{rhs_contracting});
+}
+
+struct FusedAttention {
+  HloInstruction* query = nullptr;
+  HloInstruction* key = nullptr;
+  HloInstruction* value = nullptr;
+  HloInstruction* bias = nullptr;
+  HloInstruction* mask = nullptr;
+  HloInstruction* dropout_keep = nullptr;
+  double scale = 1.0;
+  double mask_value = 0.0;
+  double dropout_scale = 1.0;
+  bool key_transposed = false;
+  bool value_transposed = false;
+
+  // The softmax, the (dropped out) probabilities multiplied with the value,
+  // and that product.
+  HloInstruction* probabilities = nullptr;
+  HloInstruction* weights = nullptr;
+  HloInstruction* output = nullptr;
+
+  // The instructions computing the logits and the probabilities. Only the
+  // gradient computation may use them.
+  Pattern pattern;
+};
+
+struct FusedAttentionBackward {
+  HloInstruction* output_grad = nullptr;
+  HloInstruction* query_grad = nullptr;
+  HloInstruction* key_grad = nullptr;
+  HloInstruction* value_grad = nullptr;
+  Pattern pattern;
+};
+
+// Matches the logits `dot(Q, K) * scale + bias`, masked, starting from the
+// softmax input.
+bool MatchLogits(HloInstruction* hlo, FusedAttention& attention) {
+  Pattern& pattern = attention.pattern;
+  const int64_t rank = hlo->shape().rank();
+  hlo = SkipConverts(hlo, pattern);
+  if (HloInstruction* x =
+          MatchMask(hlo, attention.mask, attention.mask_value)) {
+    pattern.Add(hlo);
+    hlo = SkipConverts(x, pattern);
+  }
+
+  // Returns the dot computing `hlo` up to scaling and converts, or nullptr.
+  auto match_scaled_dot = [&](HloInstruction* instr, double& scale,
+                              Pattern& dot_pattern) -> HloInstruction* {
+    instr = SkipConverts(instr, dot_pattern);
+    if (HloInstruction* x = MatchScale(instr, scale)) {
+      dot_pattern.Add(instr);
+      instr = SkipConverts(x, dot_pattern);
+    }
+    return IsBatchDot(instr, rank - 1, rank - 1) ||
+                   IsBatchDot(instr, rank - 1, rank - 2)
+               ? instr
+               : nullptr;
+  };
+
+  HloInstruction* dot = nullptr;
+  if (hlo->opcode() == HloOpcode::kAdd) {
+    for (int i = 0; i < 2 && dot == nullptr; ++i) {
+      Pattern operand_pattern;
+      double scale = 1.0;
+      dot = match_scaled_dot(hlo->mutable_operand(i), scale, operand_pattern);
+      if (dot != nullptr) {
+        attention.bias = hlo->mutable_operand(1 - i);
+        attention.scale = scale;
+        pattern.Add(hlo);
+        for (HloInstruction* instr : operand_pattern.instructions()) {
+          pattern.Add(instr);
+        }
+      }
+    }
+  } else {
+    dot = match_scaled_dot(hlo, attention.scale, pattern);
+  }
+  if (dot == nullptr) return false;
+
+  pattern.Add(dot);
+  attention.query = dot->mutable_operand(0);
+  attention.key = dot->mutable_operand(1);
+  attention.key_transposed = IsBatchDot(dot, rank - 1, rank - 2);
+  return true;
+}
+
+bool HasDefaultLayout(const HloInstruction* hlo) {
+  return hlo->shape().IsArray() &&
+         LayoutUtil::IsMonotonicWithDim0Major(hlo->shape().layout());
+}
+
+// Returns whether the kernels support the shapes and types of `attention`.
+bool IsSupported(const FusedAttention& attention) {
+  const Shape& query_shape = attention.query->shape();
+  const PrimitiveType type = query_shape.element_type();
+  if (type != F16 && type != BF16 && type != F32) return false;
+  for (const HloInstruction* hlo :
+       {attention.query, attention.key, attention.value, attention.output}) {
+    if (hlo->shape().element_type() != type || !HasDefaultLayout(hlo)) {
+      return false;
+    }
+  }
+  const int64_t rank = query_shape.rank();
+  const int64_t head_dim = query_shape.dimensions(rank - 1);
+  const int64_t value_dim = attention.output->shape().dimensions(rank - 1);
+  const int64_t batch = ShapeUtil::ElementsIn(query_shape) /
+                        (query_shape.dimensions(rank - 2) * head_dim);
+  if (head_dim > kMaxHeadDim || value_dim > kMaxHeadDim ||
+      batch > kMaxBatch) {
+    return false;
+  }
+  const Shape& logits_shape = attention.probabilities->shape();
+  if (attention.bias != nullptr &&
+      (!ShapeUtil::SameDimensions(attention.bias->shape(), logits_shape) ||
+       !HasDefaultLayout(attention.bias) ||
+       (attention.bias->shape().element_type() != type &&
+        attention.bias->shape().element_type() != F32))) {
+    return false;
+  }
+  for (const HloInstruction* mask :
+       {attention.mask, attention.dropout_keep}) {
+    if (mask != nullptr &&
+        (!ShapeUtil::SameDimensions(mask->shape(), logits_shape) ||
+         !HasDefaultLayout(mask))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Matches the forward pass, starting from the dot with the value.
+std::optional<FusedAttention> MatchForward(HloInstruction* output) {
+  const int64_t rank = output->shape().rank();
+  FusedAttention attention;
+  if (IsBatchDot(output, rank - 1, rank - 2)) {
+    attention.value_transposed = false;
+  } else if (IsBatchDot(output, rank - 1, rank - 1)) {
+    attention.value_transposed = true;
+  } else {
+    return std::nullopt;
+  }
+  Pattern& pattern = attention.pattern;
+  attention.output = output;
+  attention.value = output->mutable_operand(1);
+  attention.weights = output->mutable_operand(0);
+
+  HloInstruction* hlo = SkipConverts(attention.weights, pattern);
+  if (HloInstruction* x = MatchDropout(hlo, attention.dropout_keep,
+                                       attention.dropout_scale, pattern)) {
+    hlo = SkipConverts(x, pattern);
+  }
+  attention.probabilities = hlo;
+  HloInstruction* logits = MatchSoftmax(hlo, pattern);
+  if (logits == nullptr || !MatchLogits(logits, attention) ||
+      !IsSupported(attention)) {
+    return std::nullopt;
+  }
+  return attention;
+}
+
+// Returns whether `hlo` is `rowsum(P * dP)`.
+bool IsRowSumOfProduct(HloInstruction* hlo, const HloInstruction* p,
+                       const HloInstruction* dp, Pattern& pattern) {
+  HloInstruction* product = MatchRowReduction(hlo, HloOpcode::kAdd);
+  if (product == nullptr || product->opcode() != HloOpcode::kMultiply) {
+    return false;
+  }
+  const HloInstruction* lhs = product->operand(0);
+  const HloInstruction* rhs = product->operand(1);
+  if (!((lhs == p && rhs == dp) || (lhs == dp && rhs == p))) return false;
+  pattern.Add(hlo);
+  pattern.Add(product);
+  return true;
+}
+
+// Returns whether `hlo` is `P * x` (or `x * P`), and sets `x`.
+bool IsMultipliedBy(HloInstruction* hlo, const HloInstruction* p,
+                    HloInstruction*& x) {
+  if (hlo->opcode() != HloOpcode::kMultiply) return false;
+  for (int i = 0; i < 2; ++i) {
+    if (hlo->operand(i) == p) {
+      x = hlo->mutable_operand(1 - i);
+      return true;
+    }
+  }
+  return false;
+}
+
+// Returns whether `hlo` is a broadcast of `rowsum(P * dP)`, negated if
+// `negated`.
+bool IsBroadcastRowSum(HloInstruction* hlo, const HloInstruction* p,
+                       const HloInstruction* dp, bool negated,
+                       Pattern& pattern) {
+  pattern.Add(hlo);
+  if (negated && hlo->opcode() == HloOpcode::kNegate) {
+    return IsBroadcastRowSum(hlo->mutable_operand(0), p, dp,
+                             /*negated=*/false, pattern);
+  }
+  HloInstruction* row = MatchRowBroadcast(hlo);
+  if (row == nullptr) return false;
+  if (negated) {
+    if (row->opcode() != HloOpcode::kNegate) return false;
+    pattern.Add(row);
+    row = row->mutable_operand(0);
+  }
+  return IsRowSumOfProduct(row, p, dp, pattern);
+}
+
+// Returns whether `hlo` is the gradient of the softmax P for the gradient dP
+// of its result, `P * (dP - rowsum(P * dP))`, in one of the forms it takes
+// after differentiation and simplification.
+bool IsSoftmaxGrad(HloInstruction* hlo, const HloInstruction* p,
+                   const HloInstruction* dp, Pattern& pattern) {
+  Pattern grad_pattern;
+  grad_pattern.Add(hlo);
+  HloInstruction* x;
+  bool matched = false;
+  if (IsMultipliedBy(hlo, p, x)) {
+    // P * (dP - rowsum(P * dP))
+    grad_pattern.Add(x);
+    matched = x->opcode() == HloOpcode::kSubtract && x->operand(0) == dp &&
+              IsBroadcastRowSum(x->mutable_operand(1), p, dp,
+                                /*negated=*/false, grad_pattern);
+  } else if (hlo->opcode() == HloOpcode::kSubtract ||
+             hlo->opcode() == HloOpcode::kAdd) {
+    // P * dP - P * rowsum(P * dP), or P * dP + P * -rowsum(P * dP).
+    const bool negated = hlo->opcode() == HloOpcode::kAdd;
+    for (int i = 0; i < (negated ? 2 : 1) && !matched; ++i) {
+      HloInstruction* product = hlo->mutable_operand(i);
+      HloInstruction* correction = hlo->mutable_operand(1 - i);
+      HloInstruction* correction_row;
+      HloInstruction* product_rhs;
+      matched = IsMultipliedBy(product, p, product_rhs) && product_rhs == dp &&
+                IsMultipliedBy(correction, p, correction_row) &&
+                IsBroadcastRowSum(correction_row, p, dp, negated,
+                                  grad_pattern);
+      if (matched) {
+        grad_pattern.Add(product);
+        grad_pattern.Add(correction);
+      }
+    }
+  }
+  if (!matched) return false;
+  for (HloInstruction* instr : grad_pattern.instructions()) {
+    pattern.Add(instr);
+  }
+  return true;
+}
+
+// Finds the gradient of the softmax among the values computed from `dp`.
+HloInstruction* FindSoftmaxGrad(HloInstruction* dp, const HloInstruction* p,
+                                Pattern& pattern) {
+  // The gradient is at most three instructions away from dP.
+  std::vector<HloInstruction*> candidates = {dp};
+  for (int depth = 0; depth < 3; ++depth) {
+    std::vector<HloInstruction*> users;
+    for (HloInstruction* candidate : candidates) {
+      for (HloInstruction* user : candidate->users()) {
+        if (IsSoftmaxGrad(user, p, dp, pattern)) return user;
+        users.push_back(user);
+      }
+    }
+    candidates = std::move(users);
+  }
+  return nullptr;
+}
+
+// Matches the gradient of the attention output with respect to Q, K and V.
+// This is the reverse of the forward pattern: it starts from the gradient of
+// the weights, dot(dO, V), and ends in the dots computing dQ and dK.
+std::optional<FusedAttentionBackward> MatchBackward(
+    const FusedAttention& attention) {
+  if (attention.key_transposed || attention.value_transposed) {
+    return std::nullopt;
+  }
+  const int64_t rank = attention.output->shape().rank();
+  FusedAttentionBackward backward;
+  Pattern& pattern = backward.pattern;
+
+  // dV = dot(weights, dO), contracting the queries.
+  for (HloInstruction* user : attention.weights->users()) {
+    if (user != attention.output && IsBatchDot(user, rank - 2, rank - 2) &&
+        user->operand(0) == attention.weights) {
+      backward.value_grad = user;
+      backward.output_grad = user->mutable_operand(1);
+    }
+  }
+  if (backward.value_grad == nullptr ||
+      !ShapeUtil::Equal(backward.output_grad->shape(),
+                        attention.output->shape())) {
+    return std::nullopt;
+  }
+
+  // d(weights) = dot(dO, V), contracting the value dimension.
+  HloInstruction* grad = nullptr;
+  for (HloInstruction* user : backward.output_grad->users()) {
+    if (IsBatchDot(user, rank - 1, rank - 1) &&
+        user->operand(0) == backward.output_grad &&
+        user->operand(1) == attention.value) {
+      grad = user;
+    }
+  }
+  if (grad == nullptr) return std::nullopt;
+  pattern.Add(grad);
+  grad = FollowConverts(grad, pattern);
+
+  // Back through the dropout, `select(keep, d(weights) * c, 0)` in either
+  // order.
+  if (attention.dropout_keep != nullptr) {
+    // The dropout is two instructions, so it ends at the user of the user of
+    // d(weights).
+    HloInstruction* user = SoleUser(grad);
+    HloInstruction* dropped = user == nullptr ? nullptr : SoleUser(user);
+    HloInstruction* keep;
+    double scale;
+    Pattern dropout_pattern;
+    if (dropped == nullptr ||
+        MatchDropout(dropped, keep, scale, dropout_pattern) != grad ||
+        keep != attention.dropout_keep ||
+        !FactorsMatch(scale, attention.dropout_scale)) {
+      return std::nullopt;
+    }
+    for (HloInstruction* instr : dropout_pattern.instructions()) {
+      pattern.Add(instr);
+    }
+    grad = FollowConverts(dropped, pattern);
+  }
+
+  // Back through the softmax.
+  grad = FindSoftmaxGrad(grad, attention.probabilities, pattern);
+  if (grad == nullptr) return std::nullopt;
+  grad = FollowConverts(grad, pattern);
+
+  // Back through the mask, `select(mask, d(logits), 0)`. The bias just passes
+  // the gradient through.
+  if (attention.mask != nullptr) {
+    HloInstruction* user = SoleUser(grad);
+    HloInstruction* mask;
+    double zero;
+    if (user == nullptr || MatchMask(user, mask, zero) != grad ||
+        mask != attention.mask || zero != 0.0) {
+      return std::nullopt;
+    }
+    pattern.Add(user);
+    grad = FollowConverts(user, pattern);
+  }
+  if (attention.scale != 1.0) {
+    HloInstruction* user = SoleUser(grad);
+    double scale;
+    if (user == nullptr || MatchScale(user, scale) != grad ||
+        !FactorsMatch(scale, attention.scale)) {
+      return std::nullopt;
+    }
+    pattern.Add(user);
+    grad = FollowConverts(user, pattern);
+  }
+
+  // dQ = dot(d(logits), K) and dK = dot(d(logits), Q).
+  for (HloInstruction* user : grad->users()) {
+    if (user->operand(0) != grad) continue;
+    if (IsBatchDot(user, rank - 1, rank - 2) &&
+        user->operand(1) == attention.key) {
+      backward.query_grad = user;
+    } else if (IsBatchDot(user, rank - 2, rank - 2) &&
+               user->operand(1) == attention.query) {
+      backward.key_grad = user;
+    }
+  }
+  if (backward.query_grad == nullptr || backward.key_grad == nullptr ||
+      grad->user_count() != 2) {
+    return std::nullopt;
+  }
+
+  const PrimitiveType type = attention.query->shape().element_type();
+  for (const HloInstruction* hlo :
+       {backward.output_grad, backward.query_grad, backward.key_grad,
+        backward.value_grad}) {
+    if (hlo->shape().element_type() != type || !HasDefaultLayout(hlo)) {
+      return std::nullopt;
+    }
+  }
+  return backward;
+}
+
+std::string F32Attribute(double value) {
+  return absl::StrFormat("0x%08X : f32",
+                         absl::bit_cast<uint32_t>(static_cast<float>(value)));
+}
+
+// Returns the attributes of the custom calls, as a dictionary attribute.
+std::string GetAttributes(const FusedAttention& attention) {
+  auto bool_attribute = [](bool value) { return value ? "true" : "false"; };
+  return absl::StrFormat(
+      "{scale = %s, has_bias = %s, has_mask = %s, mask_value = %s, "
+      "has_dropout = %s, dropout_scale = %s, key_transposed = %s, "
+      "value_transposed = %s}",
+      F32Attribute(attention.scale), bool_attribute(attention.bias != nullptr),
+      bool_attribute(attention.mask != nullptr),
+      F32Attribute(attention.mask_value),
+      bool_attribute(attention.dropout_keep != nullptr),
+      F32Attribute(attention.dropout_scale),
+      bool_attribute(attention.key_transposed),
+      bool_attribute(attention.value_transposed));
+}
+
+Status RewriteAttention(HloComputation* computation,
+                        const FusedAttention& attention,
+                        const std::optional<FusedAttentionBackward>& backward) {
+  std::vector<HloInstruction*> operands = {attention.query, attention.key,
+                                           attention.value};
+  for (HloInstruction* operand :
+       {attention.bias, attention.mask, attention.dropout_keep}) {
+    if (operand != nullptr) operands.push_back(operand);
+  }
+  const std::string attributes = GetAttributes(attention);
+  const Shape& query_shape = attention.query->shape();
+  Shape logsumexp_shape = ShapeUtil::MakeShapeWithDescendingLayout(
+      F32, query_shape.dimensions().subspan(0, query_shape.rank() - 1));
+
+  HloInstruction* forward =
+      computation->AddInstruction(HloInstruction::CreateCustomCall(
+          ShapeUtil::MakeTupleShape(
+              {attention.output->shape(), logsumexp_shape}),
+          operands, kFusedAttentionCallTarget, attributes,
+          CustomCallApiVersion::API_VERSION_TYPED_FFI));
+  forward->set_metadata(attention.output->metadata());
+  HloInstruction* output = computation->AddInstruction(
+      HloInstruction::CreateGetTupleElement(forward, 0));
+  HloInstruction* logsumexp = computation->AddInstruction(
+      HloInstruction::CreateGetTupleElement(forward, 1));
+
+  if (backward.has_value()) {
+    operands.push_back(output);
+    operands.push_back(logsumexp);
+    operands.push_back(backward->output_grad);
+    // The last result is scratch space for the backward kernels.
+    HloInstruction* gradients =
+        computation->AddInstruction(HloInstruction::CreateCustomCall(
+            ShapeUtil::MakeTupleShape(
+                {backward->query_grad->shape(), backward->key_grad->shape(),
+                 backward->value_grad->shape(), logsumexp_shape}),
+            operands, kFusedAttentionBackwardCallTarget, attributes,
+            CustomCallApiVersion::API_VERSION_TYPED_FFI));
+    gradients->set_metadata(backward->value_grad->metadata());
+    int64_t index = 0;
+    for (HloInstruction* grad :
+         {backward->query_grad, backward->key_grad, backward->value_grad}) {
+      HloInstruction* gte = computation->AddInstruction(
+          HloInstruction::CreateGetTupleElement(gradients, index++));
+      TF_RETURN_IF_ERROR(computation->ReplaceInstruction(grad, gte));
+    }
+  }
+  return computation->ReplaceInstruction(attention.output, output);
+}
+
+// Rewrites the first attention pattern of `computation`, if any, and returns
+// whether it did.
+StatusOr<bool> RewriteFirstAttention(HloComputation* computation) {
+  for (HloInstruction* instr : computation->MakeInstructionPostOrder()) {
+    if (instr->opcode() != HloOpcode::kDot) continue;
+    std::optional<FusedAttention> attention = MatchForward(instr);
+    if (!attention.has_value()) continue;
+
+    // The probabilities are either only used by the forward pass, or also by
+    // its gradient, which then has to be rewritten too.
+    absl::flat_hash_set<const HloInstruction*> outputs = {attention->output};
+    std::optional<FusedAttentionBackward> backward;
+    if (!attention->pattern.IsClosed(outputs)) {
+      backward = MatchBackward(*attention);
+      if (!backward.has_value()) {
+        VLOG(2) << "Attention probabilities have unsupported users: "
+                << attention->probabilities->ToString();
+        continue;
+      }
+      outputs.insert({backward->query_grad, backward->key_grad,
+                      backward->value_grad});
+      Pattern both = backward->pattern;
+      for (HloInstruction* hlo : attention->pattern.instructions()) {
+        both.Add(hlo);
+      }
+      if (!both.IsClosed(outputs)) {
+        VLOG(2) << "Attention gradient has unsupported users: "
+                << attention->output->ToString();
+        continue;
+      }
+      // The backward custom call reads dO, so dO must not depend on the
+      // gradients it computes.
+      std::unique_ptr<HloReachabilityMap> reachability =
+          HloReachabilityMap::Build(computation);
+      if (absl::c_any_of(
+              std::vector<const HloInstruction*>{backward->query_grad,
+                                                 backward->key_grad,
+                                                 backward->value_grad},
+              [&](const HloInstruction* grad) {
+                return reachability->IsReachable(grad, backward->output_grad);
+              })) {
+        continue;
+      }
+    }
+    VLOG(2) << "Rewriting attention "
+            << (backward.has_value() ? "and its gradient " : "")
+            << "computing " << attention->output->ToString();
+    TF_RETURN_IF_ERROR(RewriteAttention(computation, *attention, backward));
+    return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+StatusOr<bool> FusedAttentionRewriter::Run(
+    HloModule* module,
+    const absl::flat_hash_set<absl::string_view>& execution_threads) {
+  if (!std::holds_alternative<se::RocmComputeCapability>(gpu_version_)) {
+    return false;
+  }
+  bool changed = false;
+  for (HloComputation* computation :
+       module->MakeNonfusionComputations(execution_threads)) {
+    while (true) {
+      TF_ASSIGN_OR_RETURN(bool rewritten, RewriteFirstAttention(computation));
+      if (!rewritten) break;
+      changed = true;
+    }
+  }
+  return changed;
+}
+
+}  // namespace gpu
+}  // namespace xla
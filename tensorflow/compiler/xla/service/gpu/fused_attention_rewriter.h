@@ -0,0 +1,73 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_COMPILER_XLA_SERVICE_GPU_FUSED_ATTENTION_REWRITER_H_
+#define TENSORFLOW_COMPILER_XLA_SERVICE_GPU_FUSED_ATTENTION_REWRITER_H_
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow/compiler/xla/hlo/ir/hlo_module.h"
+#include "tensorflow/compiler/xla/service/gpu/gpu_types.h"
+#include "tensorflow/compiler/xla/service/hlo_pass_interface.h"
+#include "tensorflow/compiler/xla/statusor.h"
+
+namespace xla {
+namespace gpu {
+
+// Custom call targets of the memory-efficient attention kernels in
+// runtime/fused_attention.cc.
+inline constexpr absl::string_view kFusedAttentionCallTarget =
+    "__gpu$FusedAttention";
+inline constexpr absl::string_view kFusedAttentionBackwardCallTarget =
+    "__gpu$FusedAttentionBackward";
+
+// Rewrites scaled dot product attention
+//
+//   logits = dot(Q, K) * scale + bias, replaced by a constant where !mask
+//   P = softmax(logits) over the minor-most dimension
+//   O = dot(select(keep, P * dropout_scale, 0), V)
+//
+// where the scale, bias, mask and dropout are optional, into a
+// kFusedAttentionCallTarget custom call returning (O, logsumexp(logits)). The
+// custom call never materializes the [q_len, kv_len] attention matrix.
+//
+// If P is also used by the gradient of O with respect to Q, K and V, that
+// gradient computation is rewritten into a kFusedAttentionBackwardCallTarget
+// custom call, which recomputes P from the log-sum-exp.
+//
+// Q, K and V have batch dimensions first, then the sequence and head
+// dimensions: the rewrite is done after layout assignment, when transposes have
+// been folded into the dots. The kernels are only built for ROCm, so the pass
+// does nothing on other platforms.
+class FusedAttentionRewriter : public HloModulePass {
+ public:
+  explicit FusedAttentionRewriter(GpuVersion gpu_version)
+      : gpu_version_(gpu_version) {}
+
+  absl::string_view name() const override { return "fused-attention-rewriter"; }
+
+  using HloPassInterface::Run;
+  StatusOr<bool> Run(
+      HloModule* module,
+      const absl::flat_hash_set<absl::string_view>& execution_threads) override;
+
+ private:
+  GpuVersion gpu_version_;
+};
+
+}  // namespace gpu
+}  // namespace xla
+
+#endif  // TENSORFLOW_COMPILER_XLA_SERVICE_GPU_FUSED_ATTENTION_REWRITER_H_
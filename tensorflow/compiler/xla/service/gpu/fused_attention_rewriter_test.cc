@@ -0,0 +1,249 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/service/gpu/fused_attention_rewriter.h"
+
+#include <string>
+
+#include "absl/strings/string_view.h"
+#include "absl/strings/substitute.h"
+#include "tensorflow/compiler/xla/hlo/ir/hlo_instruction.h"
+#include "tensorflow/compiler/xla/service/pattern_matcher.h"
+#include "tensorflow/compiler/xla/shape_util.h"
+#include "tensorflow/compiler/xla/stream_executor/device_description.h"
+#include "tensorflow/compiler/xla/tests/hlo_test_base.h"
+#include "tensorflow/compiler/xla/xla_data.pb.h"
+#include "tensorflow/tsl/platform/status_matchers.h"
+#include "tensorflow/tsl/platform/statusor.h"
+#include "tensorflow/tsl/platform/test.h"
+
+namespace xla {
+namespace gpu {
+namespace {
+
+namespace m = ::xla::match;
+using ::tsl::testing::IsOkAndHolds;
+
+class FusedAttentionRewriterTest : public HloTestBase {
+ protected:
+  FusedAttentionRewriter RocmRewriter() {
+    return FusedAttentionRewriter(se::RocmComputeCapability("gfx90a"));
+  }
+};
+
+constexpr absl::string_view kComputations = R"(
+max {
+  lhs = f32[] parameter(0)
+  rhs = f32[] parameter(1)
+  ROOT maximum = f32[] maximum(lhs, rhs)
+}
+
+add {
+  lhs = f32[] parameter(0)
+  rhs = f32[] parameter(1)
+  ROOT add = f32[] add(lhs, rhs)
+})";
+
+// Softmax of `logits` over the minor-most dimension of f32[2,4,128,128].
+constexpr absl::string_view kSoftmax = R"(
+  neg_inf = f32[] constant(-inf)
+  row_max = f32[2,4,128] reduce(logits, neg_inf), dimensions={3}, to_apply=max
+  broadcast_max = f32[2,4,128,128] broadcast(row_max), dimensions={0,1,2}
+  shifted = f32[2,4,128,128] subtract(logits, broadcast_max)
+  exp = f32[2,4,128,128] exponential(shifted)
+  zero = f32[] constant(0)
+  row_sum = f32[2,4,128] reduce(exp, zero), dimensions={3}, to_apply=add
+  broadcast_sum = f32[2,4,128,128] broadcast(row_sum), dimensions={0,1,2}
+  probs = f32[2,4,128,128] divide(exp, broadcast_sum))";
+
+TEST_F(FusedAttentionRewriterTest, RewritesScaledAttention) {
+  const std::string hlo = absl::Substitute(R"(
+HloModule attention
+$0
+
+ENTRY main {
+  q = f16[2,4,128,64] parameter(0)
+  k = f16[2,4,128,64] parameter(1)
+  v = f16[2,4,128,64] parameter(2)
+  qk = f16[2,4,128,128] dot(q, k), lhs_batch_dims={0,1}, lhs_contracting_dims={3}, rhs_batch_dims={0,1}, rhs_contracting_dims={3}
+  qk_f32 = f32[2,4,128,128] convert(qk)
+  scale = f32[] constant(0.125)
+  broadcast_scale = f32[2,4,128,128] broadcast(scale), dimensions={}
+  logits = f32[2,4,128,128] multiply(qk_f32, broadcast_scale)
+$1
+  probs_f16 = f16[2,4,128,128] convert(probs)
+  ROOT output = f16[2,4,128,64] dot(probs_f16, v), lhs_batch_dims={0,1}, lhs_contracting_dims={3}, rhs_batch_dims={0,1}, rhs_contracting_dims={2}
+})",
+                                           kComputations, kSoftmax);
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(hlo));
+  EXPECT_THAT(RunHloPass(RocmRewriter(), module.get()), IsOkAndHolds(true));
+
+  const HloInstruction* call;
+  ASSERT_TRUE(Match(
+      module->entry_computation()->root_instruction(),
+      m::GetTupleElement(m::CustomCall(&call, {kFusedAttentionCallTarget},
+                                       m::Parameter(0), m::Parameter(1),
+                                       m::Parameter(2)),
+                         0)));
+  EXPECT_TRUE(ShapeUtil::Equal(call->shape().tuple_shapes(1),
+                               ShapeUtil::MakeShape(F32, {2, 4, 128})));
+  EXPECT_EQ(call->raw_backend_config_string(),
+            "{scale = 0x3E000000 : f32, has_bias = false, has_mask = false, "
+            "mask_value = 0x00000000 : f32, has_dropout = false, "
+            "dropout_scale = 0x3F800000 : f32, key_transposed = false, "
+            "value_transposed = false}");
+}
+
+TEST_F(FusedAttentionRewriterTest, RewritesAttentionWithBiasMaskAndDropout) {
+  const std::string hlo = absl::Substitute(R"(
+HloModule attention
+$0
+
+ENTRY main {
+  q = f32[2,4,128,64] parameter(0)
+  k = f32[2,4,128,64] parameter(1)
+  v = f32[2,4,128,64] parameter(2)
+  bias = f32[2,4,128,128] parameter(3)
+  mask = pred[2,4,128,128] parameter(4)
+  keep = pred[2,4,128,128] parameter(5)
+  qk = f32[2,4,128,128] dot(q, k), lhs_batch_dims={0,1}, lhs_contracting_dims={3}, rhs_batch_dims={0,1}, rhs_contracting_dims={3}
+  biased = f32[2,4,128,128] add(qk, bias)
+  mask_value = f32[] constant(-10000)
+  broadcast_mask_value = f32[2,4,128,128] broadcast(mask_value), dimensions={}
+  logits = f32[2,4,128,128] select(mask, biased, broadcast_mask_value)
+$1
+  dropout_scale = f32[] constant(1.25)
+  broadcast_dropout_scale = f32[2,4,128,128] broadcast(dropout_scale), dimensions={}
+  scaled_probs = f32[2,4,128,128] multiply(probs, broadcast_dropout_scale)
+  broadcast_zero = f32[2,4,128,128] broadcast(zero), dimensions={}
+  dropped = f32[2,4,128,128] select(keep, scaled_probs, broadcast_zero)
+  ROOT output = f32[2,4,128,64] dot(dropped, v), lhs_batch_dims={0,1}, lhs_contracting_dims={3}, rhs_batch_dims={0,1}, rhs_contracting_dims={2}
+})",
+                                           kComputations, kSoftmax);
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(hlo));
+  EXPECT_THAT(RunHloPass(RocmRewriter(), module.get()), IsOkAndHolds(true));
+
+  const HloInstruction* call;
+  ASSERT_TRUE(Match(
+      module->entry_computation()->root_instruction(),
+      m::GetTupleElement(
+          m::CustomCall(&call, {kFusedAttentionCallTarget}, m::Parameter(0),
+                        m::Parameter(1), m::Parameter(2), m::Parameter(3),
+                        m::Parameter(4), m::Parameter(5)),
+          0)));
+  EXPECT_EQ(call->raw_backend_config_string(),
+            "{scale = 0x3F800000 : f32, has_bias = true, has_mask = true, "
+            "mask_value = 0xC61C4000 : f32, has_dropout = true, "
+            "dropout_scale = 0x3FA00000 : f32, key_transposed = false, "
+            "value_transposed = false}");
+}
+
+TEST_F(FusedAttentionRewriterTest, RewritesAttentionGradient) {
+  const std::string hlo = absl::Substitute(R"(
+HloModule attention_training
+$0
+
+ENTRY main {
+  q = f32[2,4,128,64] parameter(0)
+  k = f32[2,4,128,64] parameter(1)
+  v = f32[2,4,128,64] parameter(2)
+  output_grad = f32[2,4,128,64] parameter(3)
+  qk = f32[2,4,128,128] dot(q, k), lhs_batch_dims={0,1}, lhs_contracting_dims={3}, rhs_batch_dims={0,1}, rhs_contracting_dims={3}
+  scale = f32[] constant(0.125)
+  broadcast_scale = f32[2,4,128,128] broadcast(scale), dimensions={}
+  logits = f32[2,4,128,128] multiply(qk, broadcast_scale)
+$1
+  output = f32[2,4,128,64] dot(probs, v), lhs_batch_dims={0,1}, lhs_contracting_dims={3}, rhs_batch_dims={0,1}, rhs_contracting_dims={2}
+  value_grad = f32[2,4,128,64] dot(probs, output_grad), lhs_batch_dims={0,1}, lhs_contracting_dims={2}, rhs_batch_dims={0,1}, rhs_contracting_dims={2}
+  probs_grad = f32[2,4,128,128] dot(output_grad, v), lhs_batch_dims={0,1}, lhs_contracting_dims={3}, rhs_batch_dims={0,1}, rhs_contracting_dims={3}
+  product = f32[2,4,128,128] multiply(probs, probs_grad)
+  product_sum = f32[2,4,128] reduce(product, zero), dimensions={3}, to_apply=add
+  broadcast_product_sum = f32[2,4,128,128] broadcast(product_sum), dimensions={0,1,2}
+  centered_grad = f32[2,4,128,128] subtract(probs_grad, broadcast_product_sum)
+  softmax_grad = f32[2,4,128,128] multiply(probs, centered_grad)
+  logits_grad = f32[2,4,128,128] multiply(softmax_grad, broadcast_scale)
+  query_grad = f32[2,4,128,64] dot(logits_grad, k), lhs_batch_dims={0,1}, lhs_contracting_dims={3}, rhs_batch_dims={0,1}, rhs_contracting_dims={2}
+  key_grad = f32[2,4,128,64] dot(logits_grad, q), lhs_batch_dims={0,1}, lhs_contracting_dims={2}, rhs_batch_dims={0,1}, rhs_contracting_dims={2}
+  ROOT result = (f32[2,4,128,64], f32[2,4,128,64], f32[2,4,128,64], f32[2,4,128,64]) tuple(output, query_grad, key_grad, value_grad)
+})",
+                                           kComputations, kSoftmax);
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(hlo));
+  EXPECT_THAT(RunHloPass(RocmRewriter(), module.get()), IsOkAndHolds(true));
+
+  auto forward = m::CustomCall({kFusedAttentionCallTarget}, m::Parameter(0),
+                               m::Parameter(1), m::Parameter(2));
+  auto backward = m::CustomCall(
+      {kFusedAttentionBackwardCallTarget}, m::Parameter(0), m::Parameter(1),
+      m::Parameter(2), m::GetTupleElement(forward, 0),
+      m::GetTupleElement(forward, 1), m::Parameter(3));
+  EXPECT_TRUE(Match(module->entry_computation()->root_instruction(),
+                    m::Tuple(m::GetTupleElement(forward, 0),
+                             m::GetTupleElement(backward, 0),
+                             m::GetTupleElement(backward, 1),
+                             m::GetTupleElement(backward, 2))));
+}
+
+constexpr absl::string_view kUnscaledAttention = R"(
+HloModule attention
+$0
+
+ENTRY main {
+  q = f32[2,4,128,$2] parameter(0)
+  k = f32[2,4,128,$2] parameter(1)
+  v = f32[2,4,128,$2] parameter(2)
+  logits = f32[2,4,128,128] dot(q, k), lhs_batch_dims={0,1}, lhs_contracting_dims={3}, rhs_batch_dims={0,1}, rhs_contracting_dims={3}
+$1
+  ROOT output = f32[2,4,128,$2] dot(probs, v), lhs_batch_dims={0,1}, lhs_contracting_dims={3}, rhs_batch_dims={0,1}, rhs_contracting_dims={2}
+})";
+
+TEST_F(FusedAttentionRewriterTest, DoesNotRewriteOnCuda) {
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto module,
+      ParseAndReturnVerifiedModule(absl::Substitute(
+          kUnscaledAttention, kComputations, kSoftmax, /*head_dim=*/64)));
+  FusedAttentionRewriter rewriter(se::CudaComputeCapability{8, 0});
+  EXPECT_THAT(RunHloPass(&rewriter, module.get()), IsOkAndHolds(false));
+}
+
+TEST_F(FusedAttentionRewriterTest, DoesNotRewriteLargeHeadDim) {
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto module,
+      ParseAndReturnVerifiedModule(absl::Substitute(
+          kUnscaledAttention, kComputations, kSoftmax, /*head_dim=*/256)));
+  EXPECT_THAT(RunHloPass(RocmRewriter(), module.get()), IsOkAndHolds(false));
+}
+
+TEST_F(FusedAttentionRewriterTest, DoesNotRewriteWhenProbabilitiesEscape) {
+  const std::string hlo = absl::Substitute(R"(
+HloModule attention
+$0
+
+ENTRY main {
+  q = f32[2,4,128,64] parameter(0)
+  k = f32[2,4,128,64] parameter(1)
+  v = f32[2,4,128,64] parameter(2)
+  logits = f32[2,4,128,128] dot(q, k), lhs_batch_dims={0,1}, lhs_contracting_dims={3}, rhs_batch_dims={0,1}, rhs_contracting_dims={3}
+$1
+  output = f32[2,4,128,64] dot(probs, v), lhs_batch_dims={0,1}, lhs_contracting_dims={3}, rhs_batch_dims={0,1}, rhs_contracting_dims={2}
+  ROOT result = (f32[2,4,128,64], f32[2,4,128,128]) tuple(output, probs)
+})",
+                                           kComputations, kSoftmax);
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(hlo));
+  EXPECT_THAT(RunHloPass(RocmRewriter(), module.get()), IsOkAndHolds(false));
+}
+
+}  // namespace
+}  // namespace gpu
+}  // namespace xla
@@ -42,10 +42,12 @@ class FusionInstructionMerger {
  public:
   explicit FusionInstructionMerger(HloComputation* computation,
                                    const GpuDeviceInfo& d,
-                                   HloCostAnalysis::ShapeSizeFunction f)
+                                   HloCostAnalysis::ShapeSizeFunction f,
+                                   const GpuPerformanceModelCoefficients& c)
       : computation_(computation),
         shape_size_function_(f),
         gpu_device_info_(d),
+        performance_model_coefficients_(c),
         dump_fusion_visualization_(computation->parent()
                                        ->config()
                                        .debug_options()
@@ -66,6 +68,7 @@ class FusionInstructionMerger {
   std::optional<GpuHloCostAnalysis> cost_analysis_;
   FusionInfoCache fusion_info_cache_;
   const GpuDeviceInfo& gpu_device_info_;
+  const GpuPerformanceModelCoefficients& performance_model_coefficients_;
   bool changed_ = false;
   bool dump_fusion_visualization_ = false;
 
@@ -267,7 +270,7 @@ FusionDecision FusionInstructionMerger::ShouldFuse(HloInstruction* producer) {
 
   GpuPerformanceModel::RunTimes t = GpuPerformanceModel::EstimateRunTimes(
       producer, &*cost_analysis_, gpu_device_info_, producer->users(),
-      /*multi_output=*/false);
+      /*multi_output=*/false, performance_model_coefficients_);
   if (t.time_fused > t.time_unfused) {
     ++num_fail_slower_if_fused_;
     return "will execute slower if fused";
@@ -288,7 +291,8 @@ StatusOr<bool> FusionMerger::Run(
     XLA_VLOG_LINES(9, computation->ToString());
 
     FusionInstructionMerger fusion_merger(computation, gpu_device_info_,
-                                          shape_size_function_);
+                                          shape_size_function_,
+                                          performance_model_coefficients_);
     TF_RETURN_IF_ERROR(fusion_merger.Run());
     changed |= fusion_merger.changed();
 
@@ -19,6 +19,7 @@ limitations under the License.
 #include "tensorflow/compiler/xla/hlo/ir/hlo_module.h"
 #include "tensorflow/compiler/xla/service/gpu/gpu_device_info.h"
 #include "tensorflow/compiler/xla/service/gpu/gpu_hlo_cost_analysis.h"
+#include "tensorflow/compiler/xla/service/gpu/gpu_performance_model.h"
 #include "tensorflow/compiler/xla/service/hlo_pass_interface.h"
 
 namespace xla {
@@ -62,8 +63,12 @@ namespace gpu {
 class FusionMerger : public HloModulePass {
  public:
   explicit FusionMerger(const GpuDeviceInfo& d,
-                        HloCostAnalysis::ShapeSizeFunction f)
-      : gpu_device_info_(d), shape_size_function_(f) {}
+                        HloCostAnalysis::ShapeSizeFunction f,
+                        const GpuPerformanceModelCoefficients& c =
+                            GpuPerformanceModelCoefficients())
+      : gpu_device_info_(d),
+        shape_size_function_(f),
+        performance_model_coefficients_(c) {}
   absl::string_view name() const override { return "fusion_merger"; }
 
   using HloPassInterface::Run;
@@ -74,6 +79,7 @@ class FusionMerger : public HloModulePass {
  private:
   const GpuDeviceInfo gpu_device_info_;
   HloCostAnalysis::ShapeSizeFunction shape_size_function_;
+  const GpuPerformanceModelCoefficients performance_model_coefficients_;
 };
 
 }  // namespace gpu
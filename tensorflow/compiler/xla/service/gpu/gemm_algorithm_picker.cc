@@ -26,12 +26,14 @@ limitations under the License.
 #include <variant>
 #include <vector>
 
+#include "absl/container/flat_hash_set.h"
 #include "tensorflow/compiler/xla/hlo/ir/hlo_computation.h"
 #include "tensorflow/compiler/xla/hlo/ir/hlo_instruction.h"
 #include "tensorflow/compiler/xla/service/gpu/backend_configs.pb.h"
 #include "tensorflow/compiler/xla/service/gpu/gpu_asm_opts_util.h"
 #include "tensorflow/compiler/xla/service/gpu/gpu_serializable_autotuner.h"
 #include "tensorflow/compiler/xla/service/gpu/matmul_utils.h"
+#include "tensorflow/compiler/xla/service/gpu/multi_device_autotuning.h"
 #include "tensorflow/compiler/xla/service/gpu/stream_executor_util.h"
 #include "tensorflow/compiler/xla/stream_executor/blas.h"
 #include "tensorflow/compiler/xla/stream_executor/device_description.h"
@@ -48,6 +50,10 @@ limitations under the License.
 #include "tensorflow/compiler/xla/service/gpu/buffer_comparator.h"
 #include "tensorflow/compiler/xla/stream_executor/cuda/cuda_blas_lt.h"
 #include "tensorflow/compiler/xla/stream_executor/gpu/redzone_allocator.h"
+#elif TENSORFLOW_USE_ROCM
+#include "rocm/rocm_config.h"
+#include "tensorflow/compiler/xla/stream_executor/gpu/redzone_allocator.h"
+#include "tensorflow/compiler/xla/stream_executor/rocm/hip_blas_lt.h"
 #endif
 
 namespace xla {
@@ -55,7 +61,7 @@ namespace gpu {
 
 using tensorflow::AutotuneResult;
 
-#if (defined(GOOGLE_CUDA) && GOOGLE_CUDA)
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 se::RedzoneAllocator CreateRedzoneAllocator(
     se::Stream* stream, se::DeviceMemoryAllocator* allocator,
     const DebugOptions& debug_options, const AutotuneConfig& config) {
@@ -92,7 +98,9 @@ StatusOr<std::optional<size_t>> GetBestAlgorithm(
         allocator.AllocateBytes(ShapeUtil::ByteSizeOf(output_shape)));
   }
 
+#if GOOGLE_CUDA
   BufferComparator comparator(output_shape, hlo_module_config);
+#endif  // GOOGLE_CUDA
 
   std::vector<AutotuneResult> results;
   std::optional<int64_t> reference_algorithm;
@@ -141,6 +149,7 @@ StatusOr<std::optional<size_t>> GetBestAlgorithm(
       continue;
     }
 
+#if GOOGLE_CUDA
     if (!reference_algorithm) {
       stream->ThenMemcpy(&reference_buffer, output_buffer,
                          output_buffer.size());
@@ -160,6 +169,7 @@ StatusOr<std::optional<size_t>> GetBestAlgorithm(
             *reference_algorithm);
       }
     }
+#endif  // GOOGLE_CUDA
   }
 
   if (!autotune_config.should_crash_on_check_failure) {
@@ -208,25 +218,25 @@ StatusOr<std::optional<size_t>> GetBestBlasAlgorithm(
 
 namespace {
 
-StatusOr<se::cuda::BlasLt::Epilogue> AsBlasLtEpilogue(
+StatusOr<se::gpu::BlasLt::Epilogue> AsBlasLtEpilogue(
     GemmBackendConfig_Epilogue epilogue) {
   switch (epilogue) {
     case GemmBackendConfig::DEFAULT:
-      return se::cuda::BlasLt::Epilogue::kDefault;
+      return se::gpu::BlasLt::Epilogue::kDefault;
     case GemmBackendConfig::RELU:
-      return se::cuda::BlasLt::Epilogue::kReLU;
+      return se::gpu::BlasLt::Epilogue::kReLU;
     case GemmBackendConfig::GELU:
-      return se::cuda::BlasLt::Epilogue::kGELU;
+      return se::gpu::BlasLt::Epilogue::kGELU;
     case GemmBackendConfig::GELU_AUX:
-      return se::cuda::BlasLt::Epilogue::kGELUWithAux;
+      return se::gpu::BlasLt::Epilogue::kGELUWithAux;
     case GemmBackendConfig::BIAS:
-      return se::cuda::BlasLt::Epilogue::kBias;
+      return se::gpu::BlasLt::Epilogue::kBias;
     case GemmBackendConfig::BIAS_RELU:
-      return se::cuda::BlasLt::Epilogue::kBiasThenReLU;
+      return se::gpu::BlasLt::Epilogue::kBiasThenReLU;
     case GemmBackendConfig::BIAS_GELU:
-      return se::cuda::BlasLt::Epilogue::kBiasThenGELU;
+      return se::gpu::BlasLt::Epilogue::kBiasThenGELU;
     case GemmBackendConfig::BIAS_GELU_AUX:
-      return se::cuda::BlasLt::Epilogue::kBiasThenGELUWithAux;
+      return se::gpu::BlasLt::Epilogue::kBiasThenGELUWithAux;
     default:
       return InternalError("Unsupported Epilogue.");
   }
@@ -259,13 +269,21 @@ static auto& autotune_cache ABSL_GUARDED_BY(autotune_cache_mu) =
 static int64_t autotune_cache_hits ABSL_GUARDED_BY(autotune_cache_mu) = 0;
 static int64_t autotune_cache_misses ABSL_GUARDED_BY(autotune_cache_mu) = 0;
 
-#if (defined(GOOGLE_CUDA) && GOOGLE_CUDA)
+#if GOOGLE_CUDA || TF_HIPBLASLT
 
 StatusOr<std::optional<se::blas::AlgorithmType>> DoGemmAutotune(
     const HloInstruction* gemm, const GemmBackendConfig& gemm_config,
     se::DeviceMemoryAllocator* allocator, se::Stream* stream) {
   VLOG(3) << "Starting autotune of GemmThunk " << gemm->ToString();
 
+#if TENSORFLOW_USE_ROCM
+  // rocBLAS does not enumerate its GEMM algorithms, so on ROCm only hipBLASLt
+  // matmuls are autotuned.
+  if (!IsCublasLtMatmul(*gemm)) {
+    return {std::nullopt};
+  }
+#endif  // TENSORFLOW_USE_ROCM
+
   auto key = AutotuneCacheKeyFromInstruction(
       gemm, stream->parent()->GetDeviceDescription().model_str());
 
@@ -351,16 +369,16 @@ StatusOr<std::optional<se::blas::AlgorithmType>> DoGemmAutotune(
     TF_ASSIGN_OR_RETURN(auto plan,
                         cublas_lt::MatmulPlan::From(config, epilogue));
     TF_ASSIGN_OR_RETURN(
-        std::vector<se::cuda::BlasLt::MatmulAlgorithm> algorithms,
+        std::vector<se::gpu::BlasLt::MatmulAlgorithm> algorithms,
         plan.GetAlgorithms(stream));
 
     TF_ASSIGN_OR_RETURN(
         std::optional<size_t> best_algorithm_idx,
-        GetBestAlgorithm<se::cuda::BlasLt::MatmulAlgorithm>(
+        GetBestAlgorithm<se::gpu::BlasLt::MatmulAlgorithm>(
             stream, buffer_allocator, gemm->ToString(), autotune_config,
             lhs_buffer, rhs_buffer, output_buffer, algorithms, output_shape,
             hlo_module_config, gemm_config.beta(),
-            [&](const se::cuda::BlasLt::MatmulAlgorithm& algorithm)
+            [&](const se::gpu::BlasLt::MatmulAlgorithm& algorithm)
                 -> StatusOr<se::blas::ProfileResult> {
               se::OwningScratchAllocator<> scratch_allocator(
                   stream->parent()->device_ordinal(), allocator);
@@ -412,7 +430,9 @@ StatusOr<std::optional<se::blas::AlgorithmType>> DoGemmAutotune(
   return it->second;
 }
 
-StatusOr<bool> RunOnInstruction(HloInstruction* instr, DeviceConfig config) {
+StatusOr<std::optional<se::blas::AlgorithmType>> AutotuneOnDevice(
+    const HloInstruction* instr, const GemmBackendConfig& gemm_config,
+    DeviceConfig config) {
   se::StreamExecutor* executor = config.stream_exec;
   se::DeviceMemoryAllocator* allocator = config.allocator;
   if (allocator == nullptr) {
@@ -420,19 +440,61 @@ StatusOr<bool> RunOnInstruction(HloInstruction* instr, DeviceConfig config) {
   }
   TF_ASSIGN_OR_RETURN(se::Stream* const stream,
                       allocator->GetStream(executor->device_ordinal()));
+  return DoGemmAutotune(instr, gemm_config, allocator, stream);
+}
 
+// Fills the autotune cache with the results of the GEMMs of `module`,
+// autotuning them in parallel on `devices`, which have the same model as the
+// compiling device of `config`.
+void AutotuneModuleOnDevices(
+    HloModule* module,
+    const absl::flat_hash_set<absl::string_view>& execution_threads,
+    DeviceConfig config, absl::Span<se::StreamExecutor* const> devices) {
+  const std::string& model_str =
+      config.stream_exec->GetDeviceDescription().model_str();
+  // Identical GEMMs are autotuned once.
+  absl::flat_hash_set<AutotuneCacheKey> keys;
+  std::vector<const HloInstruction*> gemms;
+  for (HloComputation* computation :
+       module->MakeNonfusionComputations(execution_threads)) {
+    for (HloInstruction* instr : computation->instructions()) {
+      if (IsCublasGemm(*instr) &&
+          keys.insert(AutotuneCacheKeyFromInstruction(instr, model_str))
+              .second) {
+        gemms.push_back(instr);
+      }
+    }
+  }
+  if (gemms.size() < 2) return;
+
+  // The allocator of the config belongs to the compiling device; the other
+  // devices allocate on their StreamExecutor.
+  AutotuneOnDevices(
+      gemms, devices,
+      [&](const HloInstruction* instr, se::StreamExecutor* device) -> Status {
+        TF_ASSIGN_OR_RETURN(GemmBackendConfig gemm_config,
+                            instr->backend_config<GemmBackendConfig>());
+        DeviceConfig device_config{
+            device, device == config.stream_exec ? config.allocator : nullptr};
+        return AutotuneOnDevice(instr, gemm_config, device_config).status();
+      });
+}
+
+StatusOr<bool> RunOnInstruction(HloInstruction* instr, DeviceConfig config) {
+  se::StreamExecutor* executor = config.stream_exec;
   GemmBackendConfig gemm_config =
       instr->backend_config<GemmBackendConfig>().value();
 
   TF_ASSIGN_OR_RETURN(std::optional<se::blas::AlgorithmType> gemm_algorithm,
-                      DoGemmAutotune(instr, gemm_config, allocator, stream));
+                      AutotuneOnDevice(instr, gemm_config, config));
 
   // We update instruction->backend_config(); if no algorithms are supported,
   // a different API is used, which does not require specifying an algorithm.
   GemmBackendConfig updated_config = gemm_config;
 
   // We only set the 'algorithm' field on non-Ampere architectures, as for
-  // Ampere it's ignored in any case.
+  // Ampere it's ignored in any case. On ROCm it selects the hipBLASLt
+  // algorithm and is always set.
   if (gemm_algorithm &&
       !executor->GetDeviceDescription().cuda_compute_capability().IsAtLeast(
           se::CudaComputeCapability::AMPERE)) {
@@ -491,7 +553,7 @@ StatusOr<bool> RunOnComputation(HloComputation* computation,
     if (IsCublasGemm(*instr)) {
       bool result;
       if (auto device_config = std::get_if<DeviceConfig>(&config)) {
-#if (defined(GOOGLE_CUDA) && GOOGLE_CUDA)
+#if GOOGLE_CUDA || TF_HIPBLASLT
         TF_ASSIGN_OR_RETURN(result, RunOnInstruction(instr, *device_config));
 #else
         LOG(FATAL) << "GPU-enabled build is required to run autotuning";
@@ -562,6 +624,17 @@ StatusOr<bool> GemmAlgorithmPicker::Run(
     return false;
   }
 
+#if GOOGLE_CUDA || TF_HIPBLASLT
+  if (const auto* device_config = std::get_if<DeviceConfig>(&config_)) {
+    std::vector<se::StreamExecutor*> devices = GetAutotuningDevices(
+        device_config->stream_exec, module->config().debug_options());
+    if (devices.size() > 1) {
+      AutotuneModuleOnDevices(module, execution_threads, *device_config,
+                              devices);
+    }
+  }
+#endif
+
   bool changed = false;
   for (HloComputation* computation :
        module->MakeNonfusionComputations(execution_threads)) {
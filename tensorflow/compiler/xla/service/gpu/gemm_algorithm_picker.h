@@ -36,6 +36,12 @@ limitations under the License.
 #include "tensorflow/compiler/xla/service/gpu/gpu_conv_runner.h"
 #include "tensorflow/compiler/xla/stream_executor/cuda/cuda_blas_lt.h"
 #include "tensorflow/compiler/xla/stream_executor/gpu/redzone_allocator.h"
+#elif TENSORFLOW_USE_ROCM
+#include "rocm/rocm_config.h"
+#include "tensorflow/compiler/xla/stream_executor/gpu/redzone_allocator.h"
+#if TF_HIPBLASLT
+#include "tensorflow/compiler/xla/stream_executor/rocm/hip_blas_lt.h"
+#endif  // TF_HIPBLASLT
 #endif
 
 namespace xla {
@@ -55,7 +61,7 @@ static AutotuneConfig GetConfig(const DebugOptions& debug_options) {
           debug_options.xla_gpu_crash_on_verification_failures()};
 }
 
-#if (defined(GOOGLE_CUDA) && GOOGLE_CUDA)
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 se::RedzoneAllocator CreateRedzoneAllocator(
     se::Stream* stream, se::DeviceMemoryAllocator* allocator,
     const DebugOptions& debug_options, const AutotuneConfig& config);
@@ -79,6 +85,10 @@ StatusOr<std::optional<size_t>> GetBestBlasAlgorithm(
 // In deviceless mode, we pass in some information related to the device and
 // use stored autotune results to rewrite Gemm instructions. If the required
 // autotune result is not stored, then algorithm is set to kRuntimeAutotuning.
+//
+// In device mode with --xla_gpu_autotune_max_devices other than 1, the GEMMs
+// of the module are first autotuned in parallel on the local devices of the
+// same model as the compiling device, see GetAutotuningDevices.
 class GemmAlgorithmPicker : public HloModulePass {
  public:
   static void ClearAutotuneResults();
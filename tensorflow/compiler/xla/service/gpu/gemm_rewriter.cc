@@ -22,6 +22,7 @@ limitations under the License.
 #include <memory>
 #include <numeric>
 #include <optional>
+#include <string>
 #include <tuple>
 #include <utility>
 #include <vector>
@@ -905,6 +906,11 @@ class GemmRewriterVisitor : public DfsHloRewriteVisitor {
         ReplaceInstruction(add ? add : instr, slice ? slice : new_custom_call));
     return true;
 #else
+    // The FP8 GEMMs of hipBLASLt on MI300 take the FNUZ variants of the FP8
+    // types, which have a different exponent bias than F8E4M3FN and F8E5M2.
+    VLOG(1) << "Failed to rewrite " << instr->ToShortString()
+            << " into FP8 Custom Call. FP8 Custom Calls are not supported on "
+               "ROCm.";
     return false;
 #endif
   }
@@ -1309,6 +1315,12 @@ class GemmRewriterVisitor : public DfsHloRewriteVisitor {
     } else {
       return OkStatus();
     }
+#if TENSORFLOW_USE_ROCM && TF_ROCM_VERSION < 60000
+    // hipBLASLt before ROCm 6.0 only implements the plain GELU epilogue.
+    if (config.epilogue() != GemmBackendConfig::GELU) {
+      return OkStatus();
+    }
+#endif
 
     std::unique_ptr<HloInstruction> output = gemm->CloneWithNewShape(
         has_aux ? ShapeUtil::MakeTupleShape({gemm->shape(), gemm->shape()})
@@ -1517,9 +1529,9 @@ class GemmRewriterVisitor : public DfsHloRewriteVisitor {
   StatusOr<bool> GemmIsSupportedByCublasLt(
       const HloInstruction &instr,
       const GemmBackendConfig &gemm_backend_config) const {
-    if (std::holds_alternative<se::RocmComputeCapability>(gpu_version_)) {
-      return false;
-    }
+#if TENSORFLOW_USE_ROCM && !TF_HIPBLASLT
+    return false;
+#endif
 
     const HloInstruction *lhs = instr.operand(0);
     const HloInstruction *rhs = instr.operand(1);
@@ -1556,9 +1568,14 @@ class GemmRewriterVisitor : public DfsHloRewriteVisitor {
 
     auto rocm_compute_capability_ =
         std::get<se::RocmComputeCapability>(gpu_version_);
-    // as of ROCm 5.5, hipblaslt only supports MI200.
-    if(rocm_compute_capability_.gcn_arch_name().substr(0,6) != "gfx90a")
-        return false;
+    // As of ROCm 5.5 hipblaslt only supports MI200, MI300 support was added in
+    // ROCm 6.0.
+    const std::string gfx_arch =
+        rocm_compute_capability_.gcn_arch_name().substr(0, 6);
+    if (gfx_arch != "gfx90a" &&
+        (TF_ROCM_VERSION < 60000 || gfx_arch.substr(0, 5) != "gfx94")) {
+      return false;
+    }
 #endif
 
     // 2. cublasLt does not support rhs col dimension size > 4194240 for
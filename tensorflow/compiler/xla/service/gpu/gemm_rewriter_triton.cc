@@ -20,6 +20,7 @@ limitations under the License.
 #include <cstdint>
 #include <stack>
 #include <string>
+#include <variant>
 #include <vector>
 
 #include "absl/algorithm/container.h"
@@ -75,10 +76,21 @@ int64_t FirstContractingDimensionIndex(const HloInstruction& dot,
   return dimension_numbers.rhs_contracting_dimensions(0);
 }
 
+// BF16 dots are only lowered to tensor core (NVIDIA Ampere+) or matrix core
+// (AMD MFMA) instructions on recent hardware.
+bool HasTritonBF16Support(const GpuVersion& gpu_version) {
+  if (auto* cuda_compute_capability =
+          std::get_if<se::CudaComputeCapability>(&gpu_version)) {
+    return cuda_compute_capability->IsAtLeast(
+        stream_executor::CudaComputeCapability::AMPERE);
+  }
+  auto rocm_compute_capability =
+      std::get<se::RocmComputeCapability>(gpu_version);
+  return rocm_compute_capability.has_bf16_dtype_support();
+}
+
 // Data types that are tested to work in the triton GEMM emitter.
 bool IsTritonSupportedInputType(PrimitiveType t, GpuVersion gpu_version) {
-  auto cuda_compute_capability =
-      std::get<se::CudaComputeCapability>(gpu_version);
   switch (t) {
     case PRED:
     case S8:
@@ -88,8 +100,7 @@ bool IsTritonSupportedInputType(PrimitiveType t, GpuVersion gpu_version) {
     case F32:
       return true;
     case BF16:
-      return cuda_compute_capability.IsAtLeast(
-          stream_executor::CudaComputeCapability::AMPERE);
+      return HasTritonBF16Support(gpu_version);
     default:
       return false;
   }
@@ -736,15 +747,12 @@ bool IsTritonHandledGEMM(const HloInstruction& dot,
   }
 
   auto supported_output_type = [&](const PrimitiveType t) {
-    auto cuda_compute_capability =
-        std::get<se::CudaComputeCapability>(gpu_version);
     switch (t) {
       case F16:
       case F32:
         return true;
       case BF16:
-        return cuda_compute_capability.IsAtLeast(
-            stream_executor::CudaComputeCapability::AMPERE);
+        return HasTritonBF16Support(gpu_version);
       default:
         return false;
     }
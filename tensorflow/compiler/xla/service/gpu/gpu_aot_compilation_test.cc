@@ -14,14 +14,28 @@ limitations under the License.
 ==============================================================================*/
 
 #include <memory>
+#include <string>
 #include <utility>
 
-#include "tensorflow/compiler/xla/service/gpu/nvptx_compiler.h"
+#include "tensorflow/compiler/xla/service/gpu/executable.pb.h"
 #include "tensorflow/compiler/xla/tests/hlo_test_base.h"
+#if GOOGLE_CUDA
+#include "tensorflow/compiler/xla/service/gpu/nvptx_compiler.h"
+#elif TENSORFLOW_USE_ROCM
+#include "tensorflow/compiler/xla/service/gpu/amdgpu_compiler.h"
+#endif
 
 namespace xla {
 namespace gpu {
 
+#if GOOGLE_CUDA
+using TestCompiler = NVPTXCompiler;
+constexpr char kPlatformName[] = "cuda";
+#elif TENSORFLOW_USE_ROCM
+using TestCompiler = AMDGPUCompiler;
+constexpr char kPlatformName[] = "ROCM";
+#endif
+
 using GpuAotCompilationTest = HloTestBase;
 
 TEST_F(GpuAotCompilationTest, LoadExecutableFromAotCompilation) {
@@ -36,9 +50,10 @@ ENTRY main {
   TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> module,
                           ParseAndReturnVerifiedModule(hlo_string));
 
-  NVPTXCompiler compiler;
+  TestCompiler compiler;
   TF_ASSERT_OK_AND_ASSIGN(se::Platform * platform,
-                          se::MultiPlatformManager::PlatformWithName("cuda"));
+                          se::MultiPlatformManager::PlatformWithName(
+                              kPlatformName));
   TF_ASSERT_OK_AND_ASSIGN(se::StreamExecutor * stream_exec,
                           platform->ExecutorForDevice(0));
 
@@ -74,9 +89,10 @@ ENTRY main {
   TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> module,
                           ParseAndReturnVerifiedModule(hlo_string));
 
-  NVPTXCompiler compiler;
+  TestCompiler compiler;
   TF_ASSERT_OK_AND_ASSIGN(se::Platform * platform,
-                          se::MultiPlatformManager::PlatformWithName("cuda"));
+                          se::MultiPlatformManager::PlatformWithName(
+                              kPlatformName));
   TF_ASSERT_OK_AND_ASSIGN(se::StreamExecutor * stream_exec,
                           platform->ExecutorForDevice(0));
 
@@ -92,7 +108,11 @@ ENTRY main {
   // Stream executor is not passed as an option.
   GpuTargetConfig gpu_target_config;
   gpu_target_config.gpu_device_info = GetGpuDeviceInfo(stream_exec);
+#if GOOGLE_CUDA
   gpu_target_config.gpu_version = cuda_compute_capability;
+#elif TENSORFLOW_USE_ROCM
+  gpu_target_config.gpu_version = rocm_compute_capability;
+#endif
   gpu_target_config.platform_name = stream_exec->platform()->Name();
 
   AotCompilationOptions aot_options(compiler.PlatformId());
@@ -114,5 +134,50 @@ ENTRY main {
                           aot_result->LoadExecutable(&compiler, stream_exec));
 }
 
+#if TENSORFLOW_USE_ROCM
+TEST_F(GpuAotCompilationTest, RejectExecutableForDifferentGcnArch) {
+  const absl::string_view hlo_string = R"(
+HloModule Test
+
+ENTRY main {
+  a = f32[100, 200]{1,0} parameter(0)
+  ROOT b = f32[100, 200]{0,1} copy(a)
+}
+)";
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> module,
+                          ParseAndReturnVerifiedModule(hlo_string));
+
+  TestCompiler compiler;
+  TF_ASSERT_OK_AND_ASSIGN(se::Platform * platform,
+                          se::MultiPlatformManager::PlatformWithName(
+                              kPlatformName));
+  TF_ASSERT_OK_AND_ASSIGN(se::StreamExecutor * stream_exec,
+                          platform->ExecutorForDevice(0));
+
+  auto module_group = std::make_unique<HloModuleGroup>(std::move(module));
+  AotCompilationOptions aot_options(compiler.PlatformId());
+  aot_options.set_executor(stream_exec);
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::vector<std::unique_ptr<AotCompilationResult>> aot_results,
+      compiler.CompileAheadOfTime(std::move(module_group), aot_options));
+
+  TF_ASSERT_OK_AND_ASSIGN(std::string serialized_aot_result,
+                          aot_results[0]->SerializeAsString());
+  XlaRuntimeGpuExecutableProto proto;
+  ASSERT_TRUE(proto.ParseFromString(serialized_aot_result));
+  EXPECT_EQ(proto.rocm_gcn_arch_name(), stream_exec->GetDeviceDescription()
+                                            .rocm_compute_capability()
+                                            .gcn_arch_name());
+
+  // Pretend the executable was serialized on a host with a different GPU.
+  proto.set_rocm_gcn_arch_name("gfx000");
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<AotCompilationResult> aot_result,
+      compiler.LoadAotCompilationResult(proto.SerializeAsString()));
+  EXPECT_EQ(aot_result->LoadExecutable(&compiler, stream_exec).status().code(),
+            tsl::error::FAILED_PRECONDITION);
+}
+#endif  // TENSORFLOW_USE_ROCM
+
 }  // namespace gpu
 }  // namespace xla
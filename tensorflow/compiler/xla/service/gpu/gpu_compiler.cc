@@ -29,6 +29,7 @@ limitations under the License.
 #include <variant>
 #include <vector>
 
+#include "absl/algorithm/container.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/strings/str_cat.h"
 #include "absl/types/variant.h"
@@ -77,6 +78,7 @@ limitations under the License.
 #include "tensorflow/compiler/xla/service/data_parallel_collective_optimizer.h"
 #include "tensorflow/compiler/xla/service/dot_decomposer.h"
 #include "tensorflow/compiler/xla/service/dot_dimension_merger.h"
+#include "tensorflow/compiler/xla/service/dot_batcher.h"
 #include "tensorflow/compiler/xla/service/dot_merger.h"
 #include "tensorflow/compiler/xla/service/dump.h"
 #include "tensorflow/compiler/xla/service/dynamic_dimension_simplifier.h"
@@ -89,9 +91,11 @@ limitations under the License.
 #include "tensorflow/compiler/xla/service/gather_simplifier.h"
 #include "tensorflow/compiler/xla/service/gpu/alias_passthrough_params.h"
 #include "tensorflow/compiler/xla/service/gpu/all_reduce_blueconnect.h"
+#include "tensorflow/compiler/xla/service/gpu/autotune_results_db.h"
 #include "tensorflow/compiler/xla/service/gpu/compile_module_to_llvm_ir.h"
 #include "tensorflow/compiler/xla/service/gpu/conv_layout_normalization.h"
 #include "tensorflow/compiler/xla/service/gpu/dot_dimension_sorter.h"
+#include "tensorflow/compiler/xla/service/gpu/fused_attention_rewriter.h"
 #include "tensorflow/compiler/xla/service/gpu/fusion_merger.h"
 #include "tensorflow/compiler/xla/service/gpu/gemm_broadcast_folding_rewriter.h"
 #include "tensorflow/compiler/xla/service/gpu/gemm_rewriter.h"
@@ -106,6 +110,7 @@ limitations under the License.
 #include "tensorflow/compiler/xla/service/gpu/gpu_hlo_cost_analysis.h"
 #include "tensorflow/compiler/xla/service/gpu/gpu_hlo_schedule.h"
 #include "tensorflow/compiler/xla/service/gpu/gpu_layout_assignment.h"
+#include "tensorflow/compiler/xla/service/gpu/gpu_performance_model.h"
 #include "tensorflow/compiler/xla/service/gpu/gpu_reduce_scatter_creator.h"
 #include "tensorflow/compiler/xla/service/gpu/gpu_sanitize_constant_names.h"
 #include "tensorflow/compiler/xla/service/gpu/gpu_scatter_expander.h"
@@ -122,12 +127,15 @@ limitations under the License.
 #include "tensorflow/compiler/xla/service/gpu/metrics.h"
 #include "tensorflow/compiler/xla/service/gpu/move_copy_to_users.h"
 #include "tensorflow/compiler/xla/service/gpu/multi_output_fusion.h"
+#include "tensorflow/compiler/xla/service/gpu/pgle_profile_converter.h"
+#include "tensorflow/compiler/xla/service/gpu/radix_sort_rewriter.h"
 #include "tensorflow/compiler/xla/service/gpu/reduction_degenerate_dim_remover.h"
 #include "tensorflow/compiler/xla/service/gpu/reduction_dimension_grouper.h"
 #include "tensorflow/compiler/xla/service/gpu/reduction_layout_normalizer.h"
 #include "tensorflow/compiler/xla/service/gpu/reduction_splitter.h"
 #include "tensorflow/compiler/xla/service/gpu/runtime_intrinsics.h"
 #include "tensorflow/compiler/xla/service/gpu/scatter_slice_simplifier.h"
+#include "tensorflow/compiler/xla/service/gpu/softmax_fusion.h"
 #include "tensorflow/compiler/xla/service/gpu/topk_specializer.h"
 #include "tensorflow/compiler/xla/service/gpu/topk_splitter.h"
 #include "tensorflow/compiler/xla/service/gpu/tree_reduction_rewriter.h"
@@ -156,6 +164,8 @@ limitations under the License.
 #include "tensorflow/compiler/xla/service/rng_bit_generator_expander.h"
 #include "tensorflow/compiler/xla/service/rng_expander.h"
 #include "tensorflow/compiler/xla/service/scatter_simplifier.h"
+#include "tensorflow/compiler/xla/service/service_executable_run_options.h"
+#include "tensorflow/compiler/xla/service/shaped_buffer.h"
 #include "tensorflow/compiler/xla/service/sharding_propagation.h"
 #include "tensorflow/compiler/xla/service/sharding_remover.h"
 #include "tensorflow/compiler/xla/service/simplify_fp_conversions.h"
@@ -192,7 +202,9 @@ limitations under the License.
 #include "tensorflow/tsl/platform/errors.h"
 #include "tensorflow/tsl/platform/statusor.h"
 #include "tensorflow/tsl/platform/threadpool.h"
+#include "tensorflow/tsl/profiler/lib/profiler_session.h"
 #include "tensorflow/tsl/profiler/lib/traceme.h"
+#include "tensorflow/tsl/profiler/protobuf/xplane.pb.h"
 
 #if TENSORFLOW_USE_ROCM
 #include "rocm/rocm_config.h"
@@ -202,6 +214,11 @@ limitations under the License.
 #include "tensorflow/compiler/xla/service/gpu/triton_autotuner.h"
 #elif TENSORFLOW_USE_ROCM
 #include "rocm/rocm_config.h"
+#include "tensorflow/compiler/xla/service/gpu/runtime/radix_sort_kernel.h"
+#if TF_HIPBLASLT
+#include "tensorflow/compiler/xla/service/gpu/gemm_algorithm_picker.h"
+#include "tensorflow/compiler/xla/service/gpu/triton_autotuner.h"
+#endif  // TF_HIPBLASLT
 #endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 
 namespace xla {
@@ -239,6 +256,15 @@ bool RequiresCollectiveScheduleLinearizer(const HloModule* module) {
   return false;
 }
 
+// Returns the AMDGPU target recorded with serialized executables, or an empty
+// string for CUDA.
+std::string RocmGcnArchName(const GpuVersion& gpu_version) {
+  if (auto* rocm = std::get_if<se::RocmComputeCapability>(&gpu_version)) {
+    return rocm->gcn_arch_name();
+  }
+  return "";
+}
+
 }  // end anonymous namespace
 
 StatusOr<std::unique_ptr<Executable>>
@@ -255,6 +281,19 @@ GpuXlaRuntimeAotCompilationResult::LoadExecutable(
       HloModule::CreateFromProto(xla_runtime_executable.hlo_module_proto(),
                                  hlo_module_config));
   auto gpu_compiler = tensorflow::down_cast<GpuCompiler*>(compiler);
+  GpuVersion gpu_version = gpu_compiler->GetGpuVersion(executor);
+
+  // HSA code objects are not portable across AMDGPU targets, refuse to load an
+  // executable serialized for a different one instead of failing at launch.
+  const std::string& rocm_gcn_arch_name =
+      xla_runtime_gpu_executable_.rocm_gcn_arch_name();
+  if (auto* rocm = std::get_if<se::RocmComputeCapability>(&gpu_version);
+      rocm != nullptr && !rocm_gcn_arch_name.empty() &&
+      rocm->gcn_arch_name() != rocm_gcn_arch_name) {
+    return FailedPrecondition(
+        "Serialized executable was compiled for %s, but the device is %s",
+        rocm_gcn_arch_name, rocm->gcn_arch_name());
+  }
 
   std::vector<GpuExecutable::ConstantInfo> constants;
   for (auto& cst : xla_runtime_gpu_executable_.constants()) {
@@ -271,7 +310,7 @@ GpuXlaRuntimeAotCompilationResult::LoadExecutable(
       xla_runtime_gpu_executable_.entry_func_attrs(),
       GetDebugOptionsFromFlags(), xla_runtime_gpu_executable_.gpu_asm_text(),
       xla_runtime_gpu_executable_.gpu_binary(), std::move(constants),
-      gpu_compiler->GetGpuVersion(executor), executor);
+      gpu_version, executor);
 }
 
 GpuTargetConfig::GpuTargetConfig(const se::GpuTargetConfigProto& proto)
@@ -336,6 +375,103 @@ void AddHloVerifier(HloPassPipeline* pipeline, HloVerifierOpts&& opts = {},
                                                "hlo verifier");
   }
 }
+
+// Loads the autotuning results of the environment of `stream_exec` from the
+// shared `directory` into the autotuners, and returns them. The results are
+// empty if the directory can't be read, since it only saves autotuning time.
+AutotuneResults LoadSharedAutotuneResults(const std::string& directory,
+                                          se::StreamExecutor* stream_exec) {
+  const AutotuneResults::Environment environment =
+      GetAutotuneEnvironment(stream_exec);
+  StatusOr<AutotuneResults> results =
+      AutotuneResultsDatabase(directory).Load(environment);
+  if (!results.ok()) {
+    LOG(WARNING) << "Failed to load the shared autotune results of "
+                 << directory << ": " << results.status();
+    AutotuneResults empty;
+    *empty.mutable_environment() = environment;
+    return empty;
+  }
+  Status status = GpuConvAlgorithmPicker::LoadAutotuneResults(*results);
+#if GOOGLE_CUDA || TF_HIPBLASLT
+  status.Update(GemmAlgorithmPicker::LoadAutotuneResults(*results));
+#endif  // GOOGLE_CUDA || TF_HIPBLASLT
+  if (!status.ok()) {
+    LOG(WARNING) << "Failed to load the shared autotune results of "
+                 << directory << ": " << status;
+  }
+  VLOG(1) << "Loaded " << results->convs_size() << " convolution and "
+          << results->dots_size() << " dot autotune results of "
+          << AutotuneEnvironmentDirectoryName(environment) << " from "
+          << directory;
+  return *std::move(results);
+}
+
+// Appends the results of the autotuners that are not in `loaded` to the
+// shared `directory`.
+void AppendSharedAutotuneResults(const std::string& directory,
+                                 const AutotuneResults& loaded) {
+  AutotuneResults results;
+  Status status = GpuConvAlgorithmPicker::WriteAutotuneResults(&results);
+#if GOOGLE_CUDA || TF_HIPBLASLT
+  status.Update(GemmAlgorithmPicker::WriteAutotuneResults(&results));
+#endif  // GOOGLE_CUDA || TF_HIPBLASLT
+  if (status.ok()) {
+    AutotuneResults new_results = AutotuneResultsDifference(results, loaded);
+    *new_results.mutable_environment() = loaded.environment();
+    status = AutotuneResultsDatabase(directory).Append(new_results);
+  }
+  if (!status.ok()) {
+    LOG(WARNING) << "Failed to append the autotune results to " << directory
+                 << ": " << status;
+  }
+}
+
+// Returns true if `dynamic_slice` only feeds, through elementwise ops, the
+// update of a dynamic-update-slice of the same array at the same start indices
+// and with the same sizes. Each element of the slice is then read before it is
+// overwritten with the element computed from it, so the dynamic-update-slice
+// can still be done in place. This is the usual read-modify-write of a slice
+// of the loop state in the body of a while loop.
+bool DynamicSliceReadsUpdatedRegion(const HloInstruction* dynamic_slice) {
+  const HloInstruction* array = dynamic_slice->operand(0);
+  std::queue<const HloInstruction*> q;
+  absl::flat_hash_set<const HloInstruction*> visited;
+  q.push(dynamic_slice);
+  visited.insert(dynamic_slice);
+  bool found_update = false;
+  while (!q.empty()) {
+    const HloInstruction* hlo_operand = q.front();
+    q.pop();
+    for (const HloInstruction* hlo : hlo_operand->users()) {
+      if (hlo->opcode() == HloOpcode::kDynamicUpdateSlice) {
+        if (hlo->operand(0) != array || hlo->operand(1) != hlo_operand ||
+            absl::c_count(hlo->operands(), hlo_operand) != 1 ||
+            !ShapeUtil::SameDimensions(dynamic_slice->shape(),
+                                       hlo_operand->shape())) {
+          return false;
+        }
+        for (int64_t i = 1; i < dynamic_slice->operand_count(); ++i) {
+          if (!dynamic_slice->operand(i)->Identical(*hlo->operand(i + 1))) {
+            return false;
+          }
+        }
+        found_update = true;
+        continue;
+      }
+      if (visited.contains(hlo)) {
+        continue;
+      }
+      if (!hlo->IsElementwiseOnOperand(hlo->operand_index(hlo_operand)) ||
+          hlo->opcode() == HloOpcode::kCopy) {
+        return false;
+      }
+      visited.insert(hlo);
+      q.push(hlo);
+    }
+  }
+  return found_update;
+}
 }  // namespace
 
 // Runs optimization passes on the given HLO module.
@@ -422,7 +558,10 @@ Status GpuCompiler::OptimizeHloModule(HloModule* hlo_module,
         /*is_spmd=*/true, /*propagate_metadata=*/false,
         hlo_module->config().allow_spmd_sharding_propagation_to_output());
     spmd_pipeline.AddPass<spmd::StatefulRngSpmdPartitioner>(
-        num_partitions, hlo_module->config().replica_count());
+        num_partitions, hlo_module->config().replica_count(),
+        debug_options.xla_gpu_threshold_for_windowed_einsum_mib(),
+        debug_options.xla_gpu_unroll_windowed_einsum(),
+        debug_options.xla_gpu_bidirectional_windowed_einsum());
     spmd_pipeline.AddPass<CollectivePermuteMotion>();
     TF_RETURN_IF_ERROR(spmd_pipeline.Run(hlo_module).status());
   } else {
@@ -589,6 +728,14 @@ Status GpuCompiler::OptimizeHloModule(HloModule* hlo_module,
       pipeline.AddPass<AlgebraicSimplifier>(layout_insensitive_algsimp_opts);
     }();
 
+    // Batch the small dots left over by DotMerger, which become a single
+    // strided batched gemm. This runs once, since the batched dots could be
+    // batched again in a fixed point.
+    if (hlo_module->config().debug_options().xla_gpu_enable_dot_batching()) {
+      pipeline.AddPass<DotBatcher>(/*max_size_to_batch=*/int64_t{1} << 20);
+      pipeline.AddPass<HloDCE>();
+    }
+
     // Run WhileLoopTripCountAnnotator at the end of the simplification
     // pipeline, before layout assignment and fusion.  This pass does some
     // pattern-matching on while bodies/conditions, and this is where the HLO is
@@ -617,17 +764,50 @@ Status GpuCompiler::OptimizeHloModule(HloModule* hlo_module,
     collectives_pipeline.AddPass<WhileLoopAllReduceCodeMotion>(
         /*enable_reduce_scatter=*/debug_options
             .xla_gpu_enable_while_loop_reduce_scatter_code_motion());
-    if (debug_options.xla_gpu_enable_data_parallel_collective_optimizer()) {
+    // Pipeline collectives of layer loops across iterations: the all-reduces
+    // and reduce-scatters of iteration i are moved to iteration i+1 and the
+    // all-gathers of iteration i+1 to iteration i, so that each overlaps with
+    // the computation of a whole layer. Only the last of these runs removes
+    // the markers left for the other runs.
+    const bool pipeline_all_reduce =
+        debug_options.xla_gpu_enable_data_parallel_collective_optimizer();
+    const bool pipeline_all_gather =
+        debug_options.xla_gpu_enable_pipelined_all_gather();
+    const bool pipeline_reduce_scatter =
+        debug_options.xla_gpu_enable_pipelined_reduce_scatter();
+    if (pipeline_all_reduce) {
       DataParallelCollectiveOptimizer::DataParallelCollectiveConfig config{
           /*level_to_operate_on=*/0,
           /*max_pipelining_per_loop=*/INT64_MAX,
-          /*last_run=*/true,
+          /*last_run=*/!pipeline_all_gather && !pipeline_reduce_scatter,
           /*process_different_sized_ops=*/true,
           /*pipelining_direction=*/
           DataParallelCollectiveOptimizer::PipeliningDirection::kForward,
           /*should_process=*/HloPredicateIsOp<HloOpcode::kAllReduce>};
       collectives_pipeline.AddPass<DataParallelCollectiveOptimizer>(config);
     }
+    if (pipeline_all_gather) {
+      DataParallelCollectiveOptimizer::DataParallelCollectiveConfig config{
+          /*level_to_operate_on=*/0,
+          /*max_pipelining_per_loop=*/INT64_MAX,
+          /*last_run=*/!pipeline_reduce_scatter,
+          /*process_different_sized_ops=*/true,
+          /*pipelining_direction=*/
+          DataParallelCollectiveOptimizer::PipeliningDirection::kBackward,
+          /*should_process=*/HloPredicateIsOp<HloOpcode::kAllGather>};
+      collectives_pipeline.AddPass<DataParallelCollectiveOptimizer>(config);
+    }
+    if (pipeline_reduce_scatter) {
+      DataParallelCollectiveOptimizer::DataParallelCollectiveConfig config{
+          /*level_to_operate_on=*/0,
+          /*max_pipelining_per_loop=*/INT64_MAX,
+          /*last_run=*/true,
+          /*process_different_sized_ops=*/true,
+          /*pipelining_direction=*/
+          DataParallelCollectiveOptimizer::PipeliningDirection::kForward,
+          /*should_process=*/HloPredicateIsOp<HloOpcode::kReduceScatter>};
+      collectives_pipeline.AddPass<DataParallelCollectiveOptimizer>(config);
+    }
 
     // Run algebraic simplifier to reshape(broadcast) into a broadcast when
     // the reshape is just adding a unit dimension. This will help with the
@@ -688,6 +868,13 @@ Status GpuCompiler::OptimizeHloModule(HloModule* hlo_module,
       hlo_module, stream_exec, options, gpu_target_config, autotune_results));
 
   const GpuDeviceInfo& gpu_device_info = gpu_target_config.gpu_device_info;
+  TF_ASSIGN_OR_RETURN(
+      const GpuPerformanceModelCoefficients performance_model_coefficients,
+      GpuPerformanceModelCoefficients::ForDevice(
+          gpu_device_info, gpu_version,
+          hlo_module->config()
+              .debug_options()
+              .xla_gpu_performance_model_coefficients()));
 
   {
     HloPassFix<HloPassPipeline> fusion("fusion");
@@ -703,9 +890,11 @@ Status GpuCompiler::OptimizeHloModule(HloModule* hlo_module,
                                          gpu_device_info);
     fusion.AddPass<GpuInstructionFusion>(/*may_duplicate=*/true,
                                          gpu_device_info);
-    fusion.AddPass<FusionMerger>(gpu_device_info, ShapeSizeBytesFunction());
+    fusion.AddPass<FusionMerger>(gpu_device_info, ShapeSizeBytesFunction(),
+                                 performance_model_coefficients);
     fusion.AddPass<GpuMultiOutputFusion>(gpu_device_info,
-                                         ShapeSizeBytesFunction());
+                                         ShapeSizeBytesFunction(),
+                                         performance_model_coefficients);
     fusion.AddPass<HloCSE>(/*is_layout_sensitive=*/true,
                            /*only_fusion_computations=*/true);
     fusion.AddPass<HloDCE>();
@@ -880,6 +1069,21 @@ Status GpuCompiler::OptimizeHloPostLayoutAssignment(
     });
     pipeline.AddPass<HloPassFix<MoveCopyToUsers>>();
 
+    // Rewrite attention into fused kernels before its dots become GEMMs. The
+    // kernels are custom calls of the XLA runtime.
+    if (debug_options.xla_gpu_enable_fused_attention() &&
+        debug_options.xla_gpu_enable_xla_runtime_executable()) {
+      pipeline.AddPass<FusedAttentionRewriter>(gpu_target_config.gpu_version);
+    }
+
+#if TENSORFLOW_USE_ROCM
+    // Rewrite large sorts into radix sort custom calls of the XLA runtime.
+    if (debug_options.xla_gpu_enable_radix_sort() &&
+        debug_options.xla_gpu_enable_xla_runtime_executable()) {
+      pipeline.AddPass<RadixSortRewriter>(GetRadixSortScratchSize);
+    }
+#endif  // TENSORFLOW_USE_ROCM
+
     auto compute_capability = 
       std::get<ComputeCap>(gpu_target_config.gpu_version);
 
@@ -894,7 +1098,18 @@ Status GpuCompiler::OptimizeHloPostLayoutAssignment(
         pipeline.AddPass<GemmRewriterTriton>(gpu_target_config.gpu_version);
       }
     }
-#endif    
+#elif TF_HIPBLASLT
+    // On AMD GPUs Triton GEMMs are only profitable with matrix cores (MFMA).
+    if (debug_options.xla_gpu_enable_triton_gemm() &&
+        std::holds_alternative<se::RocmComputeCapability>(
+            gpu_target_config.gpu_version)) {
+      auto rocm_compute_capability =
+          std::get<se::RocmComputeCapability>(gpu_target_config.gpu_version);
+      if (rocm_compute_capability.has_mfma_instr_support()) {
+        pipeline.AddPass<GemmRewriterTriton>(gpu_target_config.gpu_version);
+      }
+    }
+#endif  // GOOGLE_CUDA
     pipeline.AddPass<GemmRewriter>(gpu_target_config.gpu_version);
     // Rewrite GEMMs with broadcasted inputs as strided GEMMs.
     pipeline.AddPass<GemmBroadcastFoldingRewriter>();
@@ -910,6 +1125,9 @@ Status GpuCompiler::OptimizeHloPostLayoutAssignment(
     pipeline.AddPass<HloPassFix<ReductionSplitter>>();
     pipeline.AddPass<HloPassFix<GpuTreeReductionRewriter>>(
         gpu_target_config.gpu_version);
+    if (debug_options.xla_gpu_enable_softmax_fusion()) {
+      pipeline.AddPass<SoftmaxFusion>();
+    }
     TF_RETURN_IF_ERROR(pipeline.Run(hlo_module).status());
   }
 
@@ -945,18 +1163,18 @@ Status GpuCompiler::OptimizeHloPostLayoutAssignment(
     GpuConvAlgorithmPicker::ClearAutotuneResults();
     TF_RETURN_IF_ERROR(
         GpuConvAlgorithmPicker::LoadAutotuneResults(*autotune_results));
-#if GOOGLE_CUDA
+#if GOOGLE_CUDA || TF_HIPBLASLT
     GemmAlgorithmPicker::ClearAutotuneResults();
     TF_RETURN_IF_ERROR(
         GemmAlgorithmPicker::LoadAutotuneResults(*autotune_results));
     TritonAutotuner::ClearAutotuneResults();
     TF_RETURN_IF_ERROR(TritonAutotuner::LoadAutotuneResults(*autotune_results));
-#endif  // GOOGLE_CUDA
+#endif  // GOOGLE_CUDA || TF_HIPBLASLT
   }
   if (GpuConvAlgorithmPicker::IsEnabled(hlo_module)) {
     pipeline.AddPass<GpuConvAlgorithmPicker>(autotune_config);
   }
-#if GOOGLE_CUDA
+#if GOOGLE_CUDA || TF_HIPBLASLT
   pipeline.AddPass<GemmAlgorithmPicker>(autotune_config);
 
   // By default use an externally provided thread pool.
@@ -977,7 +1195,7 @@ Status GpuCompiler::OptimizeHloPostLayoutAssignment(
   }
 
   pipeline.AddPass<TritonAutotuner>(autotune_config, thread_pool);
-#endif  // GOOGLE_CUDA
+#endif  // GOOGLE_CUDA || TF_HIPBLASLT
 
   GpuFloatSupport bf16_support(BF16);
   pipeline.AddPass<FloatNormalization>(&bf16_support);
@@ -1010,7 +1228,19 @@ Status GpuCompiler::OptimizeHloPostLayoutAssignment(
   }
 
   pipeline.AddPass<HloCSE>(/*is_layout_sensitive=*/true);
+
+  const std::string& shared_autotune_results_dir =
+      debug_options.xla_gpu_shared_autotune_results_dir();
+  std::optional<AutotuneResults> shared_autotune_results;
+  if (autotune_config.is_online() && !shared_autotune_results_dir.empty()) {
+    shared_autotune_results =
+        LoadSharedAutotuneResults(shared_autotune_results_dir, stream_exec);
+  }
   TF_RETURN_IF_ERROR(pipeline.Run(hlo_module).status());
+  if (shared_autotune_results.has_value()) {
+    AppendSharedAutotuneResults(shared_autotune_results_dir,
+                                *shared_autotune_results);
+  }
 
   return OkStatus();
 }
@@ -1229,17 +1459,12 @@ GpuCompiler::CompileToTargetBinary(const HloModuleConfig& module_config,
   }
 
   // Test whether LinkModules is supported.
-#if GOOGLE_CUDA
   TF_ASSIGN_OR_RETURN(bool can_use_link_modules,
                       CanUseLinkModules(module_config));
   if (!can_use_link_modules) {
     return compile_single_module(llvm_module.get(), /*relocatable=*/false,
                                  /*shard_number=*/std::nullopt);
   }
-#elif TENSORFLOW_USE_ROCM
-  return compile_single_module(llvm_module.get(), /*relocatable=*/false,
-                               /*shard_number=*/std::nullopt);
-#endif
   std::vector<std::unique_ptr<llvm::Module>> llvm_modules;
   int num_functions = 0;
   for (llvm::Function& func : llvm_module->functions()) {
@@ -1335,7 +1560,7 @@ GpuCompiler::CompileToTargetBinary(const HloModuleConfig& module_config,
       this->LinkModules(stream_exec, std::move(submodule_compile_results),
                         module_config.debug_options());
   if (!maybe_backend_result.ok()) {
-    LOG(ERROR) << "The CUDA linking API did not work. Please use "
+    LOG(ERROR) << "The GPU linking API did not work. Please use "
                   "XLA_FLAGS=--xla_gpu_force_compilation_parallelism=1 to "
                   "bypass it, but expect to get longer compilation time due to "
                   "the lack of multi-threading. Original error: "
@@ -1345,9 +1570,145 @@ GpuCompiler::CompileToTargetBinary(const HloModuleConfig& module_config,
   return std::make_pair(ptx_snippets, std::move(*maybe_backend_result));
 }
 
+// Runs `executable` `runs` times on zero-initialized arguments under the
+// profiler, and converts the device trace into a PGLE profile.
+static StatusOr<ProfiledInstructionsProto> ProfileForPgle(
+    Executable* executable, se::StreamExecutor* stream_exec,
+    se::DeviceMemoryAllocator* allocator, int runs) {
+  const HloModule& module = executable->module();
+  if (allocator == nullptr) {
+    allocator = stream_exec->GetAllocator();
+  }
+  const int device_ordinal = stream_exec->device_ordinal();
+  TF_ASSIGN_OR_RETURN(se::Stream* const stream,
+                      allocator->GetStream(device_ordinal));
+
+  std::vector<se::OwningDeviceMemory> buffers;
+  std::vector<ShapedBuffer> arguments;
+  for (const HloInstruction* parameter :
+       module.entry_computation()->parameter_instructions()) {
+    const Shape& shape = parameter->shape();
+    if (!shape.IsArray() || !shape.is_static()) {
+      return Unimplemented(
+          "Profiling needs static array parameters, but %s is %s.",
+          parameter->name(), shape.ToString());
+    }
+    TF_ASSIGN_OR_RETURN(
+        se::OwningDeviceMemory buffer,
+        allocator->Allocate(device_ordinal, ShapeUtil::ByteSizeOf(shape)));
+    se::DeviceMemoryBase memory = *buffer;
+    stream->ThenMemZero(&memory, memory.size());
+    arguments.emplace_back(shape, device_ordinal);
+    arguments.back().set_buffer(memory, /*index=*/{});
+    buffers.push_back(std::move(buffer));
+  }
+  std::vector<const ShapedBuffer*> argument_ptrs;
+  for (const ShapedBuffer& argument : arguments) {
+    argument_ptrs.push_back(&argument);
+  }
+
+  ExecutableRunOptions run_options;
+  run_options.set_stream(stream);
+  run_options.set_allocator(allocator);
+  run_options.set_device_ordinal(device_ordinal);
+  ServiceExecutableRunOptions service_run_options(run_options);
+
+  // Warm up outside of the trace, which must not include one-time costs such
+  // as module loading.
+  TF_RETURN_IF_ERROR(executable
+                         ->ExecuteOnStream(&service_run_options, argument_ptrs,
+                                           /*hlo_execution_profile=*/nullptr)
+                         .status());
+  std::unique_ptr<tsl::ProfilerSession> session =
+      tsl::ProfilerSession::Create(tsl::ProfilerSession::DefaultOptions());
+  TF_RETURN_IF_ERROR(session->Status());
+  for (int i = 0; i < runs; ++i) {
+    TF_RETURN_IF_ERROR(executable
+                           ->ExecuteOnStream(&service_run_options,
+                                             argument_ptrs,
+                                             /*hlo_execution_profile=*/nullptr)
+                           .status());
+  }
+  tensorflow::profiler::XSpace space;
+  TF_RETURN_IF_ERROR(session->CollectData(&space));
+  return ConvertXSpaceToProfiledInstructions(space, &module);
+}
+
+StatusOr<std::unique_ptr<Executable>> GpuCompiler::RunBackendWithPgleProfiling(
+    std::unique_ptr<HloModule> module, se::StreamExecutor* stream_exec,
+    const CompileOptions& options) {
+  const DebugOptions& debug_options = module->config().debug_options();
+  const std::string& profile_directory =
+      debug_options.xla_gpu_pgle_profile_file_or_directory_path();
+  const int runs = debug_options.xla_gpu_pgle_profiling_runs();
+
+  // Neither compilation profiles again.
+  HloModuleConfig config = module->config();
+  DebugOptions compile_debug_options = debug_options;
+  compile_debug_options.set_xla_gpu_pgle_profiling_runs(0);
+  config.set_debug_options(compile_debug_options);
+  module->set_config(config);
+  // Keep the instruction names, which the profile refers to.
+  std::unique_ptr<HloModule> profiled_module =
+      module->Clone(config, /*suffix=*/"");
+
+  TF_ASSIGN_OR_RETURN(
+      std::unique_ptr<Executable> executable,
+      RunBackend(std::move(profiled_module), stream_exec, options));
+
+  const auto& attributes = executable->module()
+                               .entry_computation()
+                               ->root_instruction()
+                               ->frontend_attributes()
+                               .map();
+  auto fingerprint = attributes.find(std::string(kFingerprintBeforeLHS));
+  TF_RET_CHECK(fingerprint != attributes.end());
+  const std::string profile_path =
+      absl::StrCat(profile_directory, "/", fingerprint->second, ".pbtxt");
+  if (tsl::Env::Default()->FileExists(profile_path).ok()) {
+    // The module was already scheduled with this profile.
+    return executable;
+  }
+
+  StatusOr<ProfiledInstructionsProto> profile = ProfileForPgle(
+      executable.get(), stream_exec, options.device_allocator, runs);
+  if (!profile.ok()) {
+    LOG(WARNING) << "Failed to profile " << module->name()
+                 << " for the latency hiding scheduler: " << profile.status();
+    return executable;
+  }
+  TF_RETURN_IF_ERROR(
+      tsl::WriteTextProto(tsl::Env::Default(), profile_path, *profile));
+  LOG(INFO) << "Wrote the profile of " << module->name() << " to "
+            << profile_path << ", recompiling";
+  return RunBackend(std::move(module), stream_exec, options);
+}
+
 StatusOr<std::unique_ptr<Executable>> GpuCompiler::RunBackend(
     std::unique_ptr<HloModule> module, se::StreamExecutor* stream_exec,
     const CompileOptions& options) {
+  const DebugOptions& debug_options = module->config().debug_options();
+  if (debug_options.xla_gpu_pgle_profiling_runs() > 0 &&
+      debug_options.xla_gpu_enable_latency_hiding_scheduler()) {
+    const std::string& profile_directory =
+        debug_options.xla_gpu_pgle_profile_file_or_directory_path();
+    // Only single device programs can run on their own; for the others,
+    // profile the real run and convert the trace with
+    // pgle_profile_converter_main.
+    if (module->config().replica_count() * module->config().num_partitions() !=
+        1) {
+      LOG(WARNING) << "--xla_gpu_pgle_profiling_runs is ignored for "
+                   << module->name() << ", which runs on several devices.";
+    } else if (!tsl::Env::Default()->IsDirectory(profile_directory).ok()) {
+      LOG(WARNING) << "--xla_gpu_pgle_profiling_runs needs "
+                      "--xla_gpu_pgle_profile_file_or_directory_path to be a "
+                      "directory.";
+    } else {
+      return RunBackendWithPgleProfiling(std::move(module), stream_exec,
+                                         options);
+    }
+  }
+
   VLOG(1) << "Starting to compile HLO module " << module->name();
   XLA_SCOPED_LOGGING_TIMER(
       absl::StrCat("GpuCompiler::RunBackend for ", module->name()));
@@ -1439,7 +1800,8 @@ StatusOr<std::unique_ptr<Executable>> GpuCompiler::RunBackend(
                .xla_gpu_enable_persistent_temp_buffers(),
            std::move(buffer_assignment_proto),
            [buffer_assignment] { return buffer_assignment->ToVerboseString(); },
-           std::move(module)}));
+           std::move(module),
+           std::move(compile_module_results.thunk_stream_assignment)}));
   if (embed_ir_in_executable) {
     DCHECK_NE("", ir_module_string_before_opt);
     gpu_executable->set_ir_module_string(ir_module_string_before_opt);
@@ -1458,7 +1820,8 @@ StatusOr<std::unique_ptr<Executable>> GpuCompiler::RunBackend(
 StatusOr<std::vector<std::unique_ptr<AotCompilationResult>>>
 GpuCompiler::CompileAheadOfTime(std::unique_ptr<HloModuleGroup> module_group,
                                 const AotCompilationOptions& options) {
-  CHECK(options.PlatformId() == se::cuda::kCudaPlatformId);
+  CHECK(options.PlatformId() == se::cuda::kCudaPlatformId ||
+        options.PlatformId() == se::rocm::kROCmPlatformId);
 
   std::vector<std::unique_ptr<HloModule>> modules =
       module_group->ConsumeModules();
@@ -1587,10 +1950,14 @@ GpuCompiler::CompileAheadOfTime(std::unique_ptr<HloModuleGroup> module_group,
     std::string data(obj_file->getBuffer().data(),
                      obj_file->getBuffer().size());
 
+    GpuVersion gpu_version = gpu_target_config
+                                 ? gpu_target_config->gpu_version
+                                 : GetGpuVersion(options.executor());
     results.emplace_back(std::make_unique<GpuXlaRuntimeAotCompilationResult>(
         module->ToProto(), data, program->module,
         compile_module_results.entry_func_attrs, backend_result.first,
-        backend_result.second, compile_module_results.constants));
+        backend_result.second, compile_module_results.constants,
+        RocmGcnArchName(gpu_version)));
   }
   return std::move(results);
 }
@@ -1617,7 +1984,8 @@ StatusOr<std::unique_ptr<AotCompilationResult>> GpuCompiler::Export(
   std::unique_ptr<AotCompilationResult> result =
       std::make_unique<xla::gpu::GpuXlaRuntimeAotCompilationResult>(
           module_proto, obj_file, mlir_module, entry_func_attrs, text, binary,
-          gpu_executable->constants());
+          gpu_executable->constants(),
+          RocmGcnArchName(gpu_executable->gpu_version()));
   return result;
 }
 
@@ -1737,7 +2105,8 @@ std::optional<bool> GpuCompiler::FusionCanShareBufferHint(
   // that the iteration order is the same, we only allow ops on the path from
   // fusion parameter to fusion output which are elementwise (no copy) or
   // bitcast or a dynamic update slice with the first operand being on this
-  // path.
+  // path. A dynamic slice of the path is also allowed if it only reads the
+  // region that the dynamic update slice overwrites.
   HloInstruction* fusion_param =
       user->fused_parameter(user->operand_index(operand));
   HloInstruction* output = user->fused_expression_root();
@@ -1765,6 +2134,13 @@ std::optional<bool> GpuCompiler::FusionCanShareBufferHint(
       if (visited.contains(hlo)) {
         continue;
       }
+      if (hlo->opcode() == HloOpcode::kDynamicSlice &&
+          hlo->operand_index(hlo_operand) == 0 &&
+          DynamicSliceReadsUpdatedRegion(hlo)) {
+        // The slice is a copy of the region, it does not share the buffer.
+        visited.insert(hlo);
+        continue;
+      }
       // This check also catches the case that we reach a different fusion
       // output, as that fusion output would have a tuple op as user, which we
       // do not allow here.
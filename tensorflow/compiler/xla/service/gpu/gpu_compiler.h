@@ -52,7 +52,8 @@ class GpuXlaRuntimeAotCompilationResult : public AotCompilationResult {
       HloModuleProto hlo, std::string_view obj_file,
       std::string_view mlir_module, EntryFunctionAttributes entry_func_attrs,
       std::string_view gpu_asm_text, absl::Span<const uint8_t> gpu_binary,
-      absl::Span<const GpuExecutable::ConstantInfo> constants = {}) {
+      absl::Span<const GpuExecutable::ConstantInfo> constants = {},
+      std::string_view rocm_gcn_arch_name = {}) {
     XlaRuntimeExecutableProto xla_runtime_executable;
     *xla_runtime_executable.mutable_hlo_module_proto() = hlo;
     xla_runtime_executable.set_obj_file(std::string(obj_file));
@@ -71,6 +72,8 @@ class GpuXlaRuntimeAotCompilationResult : public AotCompilationResult {
       cst_proto->set_allocation_index(cst.allocation_index);
       cst_proto->set_content(cst.content.data(), cst.content.size());
     }
+    xla_runtime_gpu_executable_.set_rocm_gcn_arch_name(
+        std::string(rocm_gcn_arch_name));
   }
 
   explicit GpuXlaRuntimeAotCompilationResult(
@@ -202,6 +205,14 @@ class GpuCompiler : public LLVMCompiler {
       se::dnn::VersionInfo dnn_version,
       se::DeviceMemoryAllocator* device_allocator) = 0;
 
+  // Implements --xla_gpu_pgle_profiling_runs: compiles `module` once, profiles
+  // the executable on `stream_exec`, writes the profile to the PGLE profile
+  // directory and compiles `module` again, now with the profile guided latency
+  // estimator.
+  StatusOr<std::unique_ptr<Executable>> RunBackendWithPgleProfiling(
+      std::unique_ptr<HloModule> module, se::StreamExecutor* stream_exec,
+      const CompileOptions& options);
+
   virtual HloDataflowAnalysis::CanShareBuffer GetCanShareBuffer() {
     return &FusionCanShareBufferHint;
   }
@@ -27,6 +27,7 @@ limitations under the License.
 #include <vector>
 
 #include "absl/algorithm/container.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "tensorflow/compiler/xla/hlo/ir/hlo_casting_utils.h"
@@ -37,6 +38,7 @@ limitations under the License.
 #include "tensorflow/compiler/xla/service/gpu/gpu_asm_opts_util.h"
 #include "tensorflow/compiler/xla/service/gpu/gpu_autotuning.pb.h"
 #include "tensorflow/compiler/xla/service/gpu/hlo_algorithm_denylist.h"
+#include "tensorflow/compiler/xla/service/gpu/multi_device_autotuning.h"
 #include "tensorflow/compiler/xla/service/gpu/stream_executor_util.h"
 #include "tensorflow/compiler/xla/stream_executor/scratch_allocator.h"
 #include "tensorflow/compiler/xla/stream_executor/stream.h"
@@ -1148,6 +1150,44 @@ StatusOr<bool> GpuConvAlgorithmPicker::RunOnInstruction(HloInstruction* instr) {
   return true;
 }
 
+void GpuConvAlgorithmPicker::AutotuneOnDevices(
+    HloModule* module,
+    const absl::flat_hash_set<absl::string_view>& execution_threads,
+    absl::Span<se::StreamExecutor* const> devices) {
+  const DeviceConfig& device_config = std::get<DeviceConfig>(config_);
+  const std::string& model_str =
+      device_config.stream_exec->GetDeviceDescription().model_str();
+  // Identical convolutions are autotuned once.
+  absl::flat_hash_set<AutotuneCacheKey> keys;
+  std::vector<const HloInstruction*> convs;
+  for (HloComputation* computation :
+       module->MakeNonfusionComputations(execution_threads)) {
+    for (HloInstruction* instr : computation->instructions()) {
+      if (IsCandidate(instr) &&
+          keys.insert(AutotuneCacheKeyFromInstruction(instr, model_str))
+              .second) {
+        convs.push_back(instr);
+      }
+    }
+  }
+  if (convs.size() < 2) return;
+
+  // The devices have the same model, so their results land on the cache
+  // keys of the compiling device. The allocator of the config belongs to the
+  // compiling device; the other devices allocate on their StreamExecutor.
+  gpu::AutotuneOnDevices(
+      convs, devices,
+      [&](const HloInstruction* instr, se::StreamExecutor* device) {
+        GpuConvAlgorithmPicker device_picker(DeviceConfig{
+            device, device == device_config.stream_exec
+                        ? device_config.allocator
+                        : nullptr});
+        return device_picker
+            .PickBestAlgorithm(Cast<HloCustomCallInstruction>(instr))
+            .status();
+      });
+}
+
 StatusOr<bool> GpuConvAlgorithmPicker::RunOnComputation(
     HloComputation* computation) {
   std::vector<HloInstruction*> convs;
@@ -1177,6 +1217,14 @@ StatusOr<bool> GpuConvAlgorithmPicker::Run(
     return false;
   }
 
+  if (const auto* device_config = std::get_if<DeviceConfig>(&config_)) {
+    std::vector<se::StreamExecutor*> devices = GetAutotuningDevices(
+        device_config->stream_exec, module->config().debug_options());
+    if (devices.size() > 1) {
+      AutotuneOnDevices(module, execution_threads, devices);
+    }
+  }
+
   bool changed = false;
   for (HloComputation* computation :
        module->MakeNonfusionComputations(execution_threads)) {
@@ -73,6 +73,11 @@ namespace gpu {
 // In deviceless mode, we pass in some information related to the device and
 // use stored autotune results to rewrite convolutions. If the required autotune
 // result is not stored, then the performance of convolution will be suboptimal.
+//
+// In device mode with --xla_gpu_autotune_max_devices other than 1, the
+// convolutions of the module are first autotuned in parallel on the local
+// devices of the same model as the compiling device, see
+// GetAutotuningDevices.
 class GpuConvAlgorithmPicker : public HloModulePass {
  public:
   static void ClearAutotuneResults();
@@ -120,6 +125,13 @@ class GpuConvAlgorithmPicker : public HloModulePass {
       se::DeviceMemoryBase result_buffer);
 
  private:
+  // Fills the autotune cache with the results of the convolutions of `module`,
+  // autotuning them in parallel on `devices`.
+  void AutotuneOnDevices(
+      HloModule* module,
+      const absl::flat_hash_set<absl::string_view>& execution_threads,
+      absl::Span<se::StreamExecutor* const> devices);
+
   StatusOr<bool> RunOnComputation(HloComputation* computation);
   StatusOr<bool> RunOnInstruction(HloInstruction* instr);
   StatusOr<tensorflow::AutotuneResult> PickBestAlgorithm(
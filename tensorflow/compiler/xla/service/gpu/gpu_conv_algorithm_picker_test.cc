@@ -96,5 +96,44 @@ ENTRY main {
           {1}, m::Shape().WithElementType(U8).WithDims({new_scratch_bytes}))));
 }
 
+TEST_F(GpuConvAlgorithmPickerTest, AutotuneOnAllDevices) {
+  constexpr absl::string_view kHlo = R"(
+HloModule module
+
+ENTRY main {
+  %arg0 = f32[3,56,56,16]{2,1,0,3} parameter(0)
+  %arg1 = f32[3,3,3,64]{2,1,0,3} parameter(1)
+  %arg2 = f32[3,3,3,32]{2,1,0,3} parameter(2)
+  %conv0 = f32[54,54,16,64]{1,0,3,2} convolution(%arg0, %arg1), window={size=3x3}, dim_labels=f01b_i01o->01bf
+  %conv1 = f32[54,54,16,32]{1,0,3,2} convolution(%arg0, %arg2), window={size=3x3}, dim_labels=f01b_i01o->01bf
+  ROOT %tuple = (f32[54,54,16,64]{1,0,3,2}, f32[54,54,16,32]{1,0,3,2}) tuple(%conv0, %conv1)
+})";
+  TF_ASSERT_OK_AND_ASSIGN(auto m, ParseAndReturnVerifiedModule(kHlo));
+  DebugOptions debug_options = m->config().debug_options();
+  debug_options.set_xla_gpu_autotune_max_devices(0);
+  m->config().set_debug_options(debug_options);
+
+  se::Platform* platform = PlatformUtil::GetDefaultPlatform().value();
+  TF_ASSERT_OK_AND_ASSIGN(std::vector<se::StreamExecutor*> executors,
+                          PlatformUtil::GetStreamExecutors(platform));
+  ASSERT_GT(executors.size(), 0);
+  DeviceConfig device_config{executors[0], /*allocator=*/nullptr};
+
+  TF_ASSERT_OK(RunHloPass(GpuConvRewriter(), m.get()).status());
+  TF_ASSERT_OK_AND_ASSIGN(
+      bool changed,
+      RunHloPass(GpuConvAlgorithmPicker(device_config), m.get()));
+  EXPECT_TRUE(changed);
+
+  // Both convolutions have a result, whichever device autotuned them.
+  AutotuneResults results;
+  TF_ASSERT_OK(GpuConvAlgorithmPicker::WriteAutotuneResults(&results));
+  ASSERT_EQ(results.convs_size(), 2);
+  for (const auto& conv : results.convs()) {
+    EXPECT_EQ(conv.device(),
+              executors[0]->GetDeviceDescription().model_str());
+  }
+}
+
 }  // namespace
 }  // namespace xla::gpu
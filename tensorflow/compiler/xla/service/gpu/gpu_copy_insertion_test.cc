@@ -355,6 +355,64 @@ ENTRY main {
       GpuCompiler::FusionCanShareBufferHint(fusion, fusion->operand(0), {}));
 }
 
+TEST_F(FusionCanShareBufferHintTest,
+       BufferCanBeSharedDynamicSliceOfUpdatedRegion) {
+  const char* const kModuleString = R"(
+HloModule fusion
+
+fused_computation {
+  param_0.1 = f32[8,16]{1,0} parameter(0)
+  param_1.1 = s32[] parameter(1)
+  zero = s32[] constant(0)
+  slice = f32[1,16]{1,0} dynamic-slice(param_0.1, param_1.1, zero), dynamic_slice_sizes={1,16}
+  neg = f32[1,16]{1,0} negate(slice)
+  ROOT dus = f32[8,16]{1,0} dynamic-update-slice(param_0.1, neg, param_1.1, zero)
+}
+
+ENTRY main {
+  param_0 = f32[8,16]{1,0} parameter(0)
+  param_1 = s32[] parameter(1)
+  ROOT fusion = f32[8,16]{1,0} fusion(param_0, param_1), kind=kLoop, calls=fused_computation
+}
+)";
+
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<xla::HloModule> module,
+                          ParseAndReturnVerifiedModule(kModuleString));
+  HloInstruction* fusion = module->entry_computation()->root_instruction();
+  ExpectOptionalTrue(
+      GpuCompiler::FusionCanShareBufferHint(fusion, fusion->operand(0), {}));
+}
+
+TEST_F(FusionCanShareBufferHintTest,
+       BufferCannotBeSharedDynamicSliceOfOtherRegion) {
+  const char* const kModuleString = R"(
+HloModule fusion
+
+fused_computation {
+  param_0.1 = f32[8,16]{1,0} parameter(0)
+  param_1.1 = s32[] parameter(1)
+  zero = s32[] constant(0)
+  one = s32[] constant(1)
+  next = s32[] add(param_1.1, one)
+  slice = f32[1,16]{1,0} dynamic-slice(param_0.1, next, zero), dynamic_slice_sizes={1,16}
+  neg = f32[1,16]{1,0} negate(slice)
+  ROOT dus = f32[8,16]{1,0} dynamic-update-slice(param_0.1, neg, param_1.1, zero)
+}
+
+ENTRY main {
+  param_0 = f32[8,16]{1,0} parameter(0)
+  param_1 = s32[] parameter(1)
+  ROOT fusion = f32[8,16]{1,0} fusion(param_0, param_1), kind=kLoop, calls=fused_computation
+}
+)";
+
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<xla::HloModule> module,
+                          ParseAndReturnVerifiedModule(kModuleString));
+  HloInstruction* fusion = module->entry_computation()->root_instruction();
+  ExpectOptionalFalse(
+      GpuCompiler::FusionCanShareBufferHint(fusion, fusion->operand(0), {}));
+}
+
 }  // namespace
 }  // namespace gpu
 }  // namespace xla
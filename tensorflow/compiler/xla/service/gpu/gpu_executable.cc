@@ -51,6 +51,7 @@ limitations under the License.
 #include "tensorflow/compiler/xla/status.h"
 #include "tensorflow/compiler/xla/status_macros.h"
 #include "tensorflow/compiler/xla/stream_executor/device_memory.h"
+#include "tensorflow/compiler/xla/stream_executor/event.h"
 #include "tensorflow/compiler/xla/stream_executor/platform.h"
 #include "tensorflow/compiler/xla/stream_executor/stream_executor_pimpl.h"
 #include "tensorflow/compiler/xla/util.h"
@@ -121,7 +122,8 @@ GpuExecutable::GpuExecutable(GpuExecutable::Params params)
       verbose_buffer_assignment_string_dumper_(
           params.verbose_buffer_assignment_string_dumper),
       constants_(std::move(params.constants)),
-      output_info_(std::move(params.output_info)) {
+      output_info_(std::move(params.output_info)),
+      thunk_stream_assignment_(std::move(params.thunk_stream_assignment)) {
 #if TENSORFLOW_USE_ROCM
   // ROCm uses hsaco hashes to distinguish between modules.
   // Bad things happen if multiple modules with identical code are loaded.
@@ -188,7 +190,8 @@ Status ExecuteThunks(const std::string& module_name, ModuleIdentifier module_id,
                      const ServiceExecutableRunOptions* run_options,
                      const BufferAllocations& buffer_allocations,
                      bool block_host_until_done,
-                     bool use_highest_priority_for_async_stream) {
+                     bool use_highest_priority_for_async_stream,
+                     const ThunkStreamAssignment* stream_assignment) {
   se::Stream* main_stream = run_options->stream();
   se::StreamExecutor* executor = main_stream->parent();
   stream_executor::StreamPriority stream_priority =
@@ -200,6 +203,34 @@ Status ExecuteThunks(const std::string& module_name, ModuleIdentifier module_id,
   StatusOr<StreamPool::Ptr> async_comms_stream =
       run_options->BorrowStream(executor->device_ordinal(), stream_priority);
 
+  // Borrow the streams that thunks run on besides the main stream. If fewer
+  // streams can be borrowed, several of the assigned streams share one.
+  std::vector<StreamPool::Ptr> borrowed_streams;
+  std::vector<se::Stream*> streams = {main_stream};
+  if (stream_assignment != nullptr) {
+    for (int i = 1; i < stream_assignment->num_streams(); ++i) {
+      StatusOr<StreamPool::Ptr> stream =
+          run_options->BorrowStream(executor->device_ordinal());
+      if (!stream.ok()) break;
+      streams.push_back(stream->get());
+      borrowed_streams.push_back(std::move(*stream));
+    }
+  }
+  auto stream_for_thunk = [&](int64_t thunk_index) {
+    if (stream_assignment == nullptr) return main_stream;
+    return streams[stream_assignment->stream(thunk_index) % streams.size()];
+  };
+  // The events recorded after the thunks that thunks on other streams wait
+  // for.
+  std::vector<std::unique_ptr<se::Event>> thunk_done_events(
+      thunk_sequence.size());
+
+  // The other streams fork from the main stream, so that they see the work
+  // enqueued on it before the execution.
+  for (int i = 1; i < streams.size(); ++i) {
+    streams[i]->ThenWaitFor(main_stream);
+  }
+
   uint64_t start_nanos = tsl::Env::Default()->NowNanos();
 
   tsl::profiler::TraceMe hlo_module_activity(
@@ -215,7 +246,8 @@ Status ExecuteThunks(const std::string& module_name, ModuleIdentifier module_id,
                            module_id_str);
   });
 
-  for (const std::unique_ptr<Thunk>& thunk : thunk_sequence) {
+  for (int64_t i = 0; i < thunk_sequence.size(); ++i) {
+    const std::unique_ptr<Thunk>& thunk = thunk_sequence[i];
     // Annotate execution of this op if tracing was enabled when we started
     // running this module.  If tracing is enabled *while* we're running the
     // module, we won't get any data, but that's probably an OK trade-off.
@@ -224,10 +256,32 @@ Status ExecuteThunks(const std::string& module_name, ModuleIdentifier module_id,
     TF_RET_CHECK(async_comms_stream.ok() || !NeedsAsyncCommsStream(*thunk))
         << "`run_options` must have a stream borrower for async thunks.";
 
+    se::Stream* stream = stream_for_thunk(i);
+    if (stream_assignment != nullptr) {
+      for (int64_t dependency : stream_assignment->waits(i)) {
+        if (stream_for_thunk(dependency) != stream) {
+          stream->ThenWaitFor(thunk_done_events[dependency].get());
+        }
+      }
+    }
+
     Thunk::ExecuteParams thunk_params{
-        *run_options, buffer_allocations, main_stream,
+        *run_options, buffer_allocations, stream,
         async_comms_stream.ok() ? async_comms_stream->get() : nullptr};
     TF_RETURN_IF_ERROR(thunk->ExecuteOnStream(thunk_params));
+
+    if (stream_assignment != nullptr && stream_assignment->needs_event(i)) {
+      thunk_done_events[i] = std::make_unique<se::Event>(executor);
+      if (!thunk_done_events[i]->Init()) {
+        return InternalError("Failed to create a thunk done event");
+      }
+      stream->ThenRecordEvent(thunk_done_events[i].get());
+    }
+  }
+
+  // Join the other streams back into the main stream.
+  for (int i = 1; i < streams.size(); ++i) {
+    main_stream->ThenWaitFor(streams[i]);
   }
   return MaybeSyncAndProfile(run_options, start_nanos,
                              block_host_until_done ? main_stream : nullptr);
@@ -737,7 +791,8 @@ Status GpuExecutable::ExecuteThunksOrXlaRuntime(
         has_module() ? module_config()
                            .debug_options()
                            .xla_gpu_enable_highest_priority_async_stream()
-                     : false);
+                     : false,
+        thunk_stream_assignment_ ? &*thunk_stream_assignment_ : nullptr);
   }
 
   if (gpu_runtime_executable_) {
@@ -39,6 +39,7 @@ limitations under the License.
 #include "tensorflow/compiler/xla/service/gpu/non_atomically_upgradeable_rw_lock.h"
 #include "tensorflow/compiler/xla/service/gpu/runtime/executable.h"
 #include "tensorflow/compiler/xla/service/gpu/thunk.h"
+#include "tensorflow/compiler/xla/service/gpu/thunk_stream_assignment.h"
 #include "tensorflow/compiler/xla/service/hlo_execution_profile.h"
 #include "tensorflow/compiler/xla/service/shaped_buffer.h"
 #include "tensorflow/compiler/xla/statusor.h"
@@ -103,6 +104,10 @@ class GpuExecutable : public Executable {
     };
 
     std::unique_ptr<HloModule> debug_module = nullptr;
+
+    // The streams the thunks run on. If not set, they all run on the main
+    // stream.
+    std::optional<ThunkStreamAssignment> thunk_stream_assignment;
   };
 
   // Analyze the entry function to construct buffer allocation and other output
@@ -184,6 +189,8 @@ class GpuExecutable : public Executable {
 
   const std::vector<ConstantInfo>& constants() const { return constants_; }
 
+  const GpuVersion& gpu_version() const { return gpu_version_; }
+
   xla::EntryFunctionAttributes entry_func_attrs() const {
     return entry_func_attrs_;
   }
@@ -311,6 +318,10 @@ class GpuExecutable : public Executable {
 
   std::vector<ConstantInfo> constants_;
   const absl::flat_hash_map<ShapeIndex, OutputInfo> output_info_;
+
+  // The streams the thunks run on, see ThunkStreamAssignment.
+  const std::optional<ThunkStreamAssignment> thunk_stream_assignment_;
+
   // Retains shared ownership of on-device constants that are managed by XLA and
   // potentially shared with other executables.
   std::vector<std::shared_ptr<se::DeviceMemoryBase>> shared_constants_;
@@ -15,18 +15,23 @@ limitations under the License.
 
 #include "tensorflow/compiler/xla/service/gpu/gpu_float_support.h"
 
+#include "tensorflow/compiler/xla/primitive_util.h"
+
 namespace xla {
 namespace gpu {
 
 bool GpuFloatSupport::IsSupported(const HloInstruction& hlo) const {
   switch (hlo.opcode()) {
-    // Collective ops.
+    // Collective ops that only move data. FP8 data is moved as bytes.
     case HloOpcode::kAllGather:
+    case HloOpcode::kAllToAll:
+    case HloOpcode::kCollectivePermute:
+      return LowPrecisionType() == BF16 ||
+             primitive_util::IsF8Type(LowPrecisionType());
+    // Collective ops that reduce.
     case HloOpcode::kAllReduce:
     case HloOpcode::kAllReduceStart:
     case HloOpcode::kAllReduceDone:
-    case HloOpcode::kAllToAll:
-    case HloOpcode::kCollectivePermute:
     case HloOpcode::kReduceScatter:
     // Handled by Triton GEMM.
     case HloOpcode::kDot:
@@ -17,26 +17,80 @@ limitations under the License.
 
 #include <algorithm>
 #include <cstdint>
+#include <string>
+#include <variant>
 #include <vector>
 
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
 #include "absl/time/time.h"
 #include "tensorflow/compiler/xla/hlo/ir/hlo_instruction.h"
+#include "tensorflow/compiler/xla/util.h"
 
 namespace xla {
 namespace gpu {
 
 namespace {
 
-// Estimated values in the absence of easy ways to query them.
-static constexpr absl::Duration kKernelLaunchOverhead = absl::Microseconds(1);
-static constexpr float kL2CacheSpeedup = 2.5;
-static constexpr float kL1CacheSpeedup = 8;
-// A very conservative estimate. L1 size varies because it can be dynamically
-// configured as shared memory; there is no easy way to query its actual size;
-// also we do not count what occupies cache, but rather claim that what is
-// much smaller than the cache size will likely stay in it.
-// For reference, it can be up to 256 kB per SM on RTX A6000.
-static constexpr float kL1CacheSizePerSM = 2 * 1024;
+// Estimated values for AMD GPUs in the absence of easy ways to query them.
+// They can be refined on the actual device with the
+// gpu_performance_model_calibration tool.
+GpuPerformanceModelCoefficients RocmCoefficients(
+    se::RocmComputeCapability rocm_compute_capability) {
+  GpuPerformanceModelCoefficients coefficients;
+  // Launching and synchronizing a HIP kernel takes noticeably longer than a
+  // CUDA one, which makes fusion relatively more profitable.
+  coefficients.kernel_launch_overhead = absl::Microseconds(3);
+  // The nominal bandwidth derived from the memory clock and bus width is not
+  // reached on HBM parts.
+  coefficients.memory_bandwidth_efficiency = 0.8;
+  coefficients.l2_cache_speedup = 2;
+  // The vector L1 cache is 16 kB per CU and, unlike on NVIDIA GPUs, is
+  // separate from the LDS (shared memory), so it does not shrink with the
+  // shared memory usage of the kernel.
+  coefficients.l1_cache_size_per_core = 16 * 1024;
+  coefficients.l1_cache_speedup = 4;
+  // A CU issues one 64-wide wavefront per cycle across its four SIMD16 units.
+  // ROCm does not report the lane count.
+  coefficients.fpus_per_core = 64;
+
+  const std::string gfx_version = rocm_compute_capability.gfx_version();
+  if (gfx_version == "gfx908") {
+    // MI100: MFMA FP32 throughput.
+    coefficients.matrix_flops_per_cycle_per_core = 256;
+  } else if (gfx_version == "gfx90a") {
+    // MI200: packed FP32 FMA and MFMA FP32 throughput.
+    coefficients.flops_per_cycle_per_fpu = 4;
+    coefficients.matrix_flops_per_cycle_per_core = 256;
+  } else if (gfx_version == "gfx1030") {
+    // Navi21: 128 MB Infinity Cache.
+    coefficients.last_level_cache_size = 128 * 1024 * 1024;
+    coefficients.last_level_cache_speedup = 2;
+  } else if (gfx_version == "gfx1100") {
+    // Navi31: 96 MB Infinity Cache, dual-issue FP32.
+    coefficients.last_level_cache_size = 96 * 1024 * 1024;
+    coefficients.last_level_cache_speedup = 2;
+    coefficients.flops_per_cycle_per_fpu = 4;
+  }
+  return coefficients;
+}
+
+// Returns whether the instruction is, or is a fusion that contains, a dot.
+bool HasDot(const HloInstruction* instr) {
+  if (instr->opcode() == HloOpcode::kDot) {
+    return true;
+  }
+  if (instr->opcode() == HloOpcode::kFusion) {
+    for (const HloInstruction* fused : instr->fused_instructions()) {
+      if (fused->opcode() == HloOpcode::kDot) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
 
 // Returns whether a fusion uses the parameter at the given index elementwise
 // from its root.
@@ -49,16 +103,21 @@ bool FusionUsesParameterElementwiseFromRoot(
 }
 
 // Estimate read time of n_bytes_total bytes from global memory on a
-// given GPU. Account for L1 / L2 cache speedup if the input's nominal size
-// n_bytes_net is small.
+// given GPU. Account for L1 / L2 / last level cache speedup if the input's
+// nominal size n_bytes_net is small.
 absl::Duration ReadTime(const GpuDeviceInfo& gpu_device_info,
+                        const GpuPerformanceModelCoefficients& coefficients,
                         int64_t n_bytes_net, int64_t n_bytes_total) {
-  float bw = gpu_device_info.memory_bandwidth;
+  float bw = gpu_device_info.memory_bandwidth *
+             coefficients.memory_bandwidth_efficiency;
   if (n_bytes_net < gpu_device_info.l2_cache_size) {
-    bw *= kL2CacheSpeedup;
-    if (n_bytes_net < kL1CacheSizePerSM * gpu_device_info.core_count) {
-      bw *= kL1CacheSpeedup;
+    bw *= coefficients.l2_cache_speedup;
+    if (n_bytes_net <
+        coefficients.l1_cache_size_per_core * gpu_device_info.core_count) {
+      bw *= coefficients.l1_cache_speedup;
     }
+  } else if (n_bytes_net < coefficients.last_level_cache_size) {
+    bw *= coefficients.last_level_cache_speedup;
   }
   return absl::Seconds(n_bytes_total / bw);
 }
@@ -68,7 +127,9 @@ absl::Duration ReadTime(const GpuDeviceInfo& gpu_device_info,
 // inputs as if it is fused into the consumer.
 absl::Duration ProducerInputAccessTime(
     const GpuHloCostAnalysis* cost_analysis,
-    const GpuDeviceInfo& gpu_device_info, const HloInstruction* producer,
+    const GpuDeviceInfo& gpu_device_info,
+    const GpuPerformanceModelCoefficients& coefficients,
+    const HloInstruction* producer,
     const HloInstruction* fused_consumer = nullptr) {
   absl::Duration ret = absl::ZeroDuration();
   float producer_output_utilization = 1.f;
@@ -118,24 +179,96 @@ absl::Duration ProducerInputAccessTime(
     }
     CHECK_LE(common_utilization, producer_output_utilization);
     ret += ReadTime(
-        gpu_device_info, std::min(p_size_net, p_size_accessed),
+        gpu_device_info, coefficients, std::min(p_size_net, p_size_accessed),
         p_size_accessed * (producer_output_utilization - common_utilization));
   }
   return ret;
 }
 }  // namespace
 
+/*static*/ StatusOr<GpuPerformanceModelCoefficients>
+GpuPerformanceModelCoefficients::ForDevice(const GpuDeviceInfo& gpu_device_info,
+                                           const GpuVersion& gpu_version,
+                                           absl::string_view overrides) {
+  GpuPerformanceModelCoefficients coefficients;
+  if (const auto* rocm_compute_capability =
+          std::get_if<se::RocmComputeCapability>(&gpu_version)) {
+    coefficients = RocmCoefficients(*rocm_compute_capability);
+  }
+  TF_RETURN_IF_ERROR(coefficients.ApplyOverrides(overrides));
+  VLOG(2) << "Performance model coefficients for " << gpu_device_info.name
+          << ": " << coefficients.ToString();
+  return coefficients;
+}
+
+Status GpuPerformanceModelCoefficients::ApplyOverrides(
+    absl::string_view overrides) {
+  for (absl::string_view entry :
+       absl::StrSplit(overrides, ',', absl::SkipWhitespace())) {
+    std::vector<absl::string_view> name_and_value =
+        absl::StrSplit(entry, absl::MaxSplits('=', 1));
+    double value;
+    if (name_and_value.size() != 2 ||
+        !absl::SimpleAtod(name_and_value[1], &value)) {
+      return InvalidArgument(
+          "Expected a performance model coefficient as name=value, got \"%s\"",
+          entry);
+    }
+    absl::string_view name = absl::StripAsciiWhitespace(name_and_value[0]);
+    if (name == "kernel_launch_overhead_us") {
+      kernel_launch_overhead = absl::Microseconds(value);
+    } else if (name == "memory_bandwidth_efficiency") {
+      memory_bandwidth_efficiency = value;
+    } else if (name == "l2_cache_speedup") {
+      l2_cache_speedup = value;
+    } else if (name == "l1_cache_speedup") {
+      l1_cache_speedup = value;
+    } else if (name == "l1_cache_size_per_core") {
+      l1_cache_size_per_core = static_cast<int64_t>(value);
+    } else if (name == "last_level_cache_size") {
+      last_level_cache_size = static_cast<int64_t>(value);
+    } else if (name == "last_level_cache_speedup") {
+      last_level_cache_speedup = value;
+    } else if (name == "fpus_per_core") {
+      fpus_per_core = static_cast<int64_t>(value);
+    } else if (name == "flops_per_cycle_per_fpu") {
+      flops_per_cycle_per_fpu = value;
+    } else if (name == "matrix_flops_per_cycle_per_core") {
+      matrix_flops_per_cycle_per_core = value;
+    } else {
+      return InvalidArgument("Unknown performance model coefficient \"%s\"",
+                             name);
+    }
+  }
+  return OkStatus();
+}
+
+std::string GpuPerformanceModelCoefficients::ToString() const {
+  return absl::StrFormat(
+      "kernel_launch_overhead_us=%g,memory_bandwidth_efficiency=%g,"
+      "l2_cache_speedup=%g,l1_cache_speedup=%g,l1_cache_size_per_core=%d,"
+      "last_level_cache_size=%d,last_level_cache_speedup=%g,fpus_per_core=%d,"
+      "flops_per_cycle_per_fpu=%g,matrix_flops_per_cycle_per_core=%g",
+      absl::ToDoubleMicroseconds(kernel_launch_overhead),
+      memory_bandwidth_efficiency, l2_cache_speedup, l1_cache_speedup,
+      l1_cache_size_per_core, last_level_cache_size, last_level_cache_speedup,
+      fpus_per_core, flops_per_cycle_per_fpu, matrix_flops_per_cycle_per_core);
+}
+
 /*static*/ struct GpuPerformanceModel::RunTimes
 GpuPerformanceModel::EstimateRunTimes(
     const HloInstruction* producer, const GpuHloCostAnalysis* cost_analysis,
     const GpuDeviceInfo& gpu_device_info,
-    const std::vector<HloInstruction*> fused_users, bool multi_output) {
+    const std::vector<HloInstruction*> fused_users, bool multi_output,
+    const GpuPerformanceModelCoefficients& coefficients) {
   VLOG(8) << "Producer: " << producer->name();
   if (producer->opcode() == HloOpcode::kFusion) {
     VLOG(10) << producer->fused_instructions_computation()->ToString();
   }
 
-  float memory_bandwidth_bytes_per_second = gpu_device_info.memory_bandwidth;
+  float memory_bandwidth_bytes_per_second =
+      gpu_device_info.memory_bandwidth *
+      coefficients.memory_bandwidth_efficiency;
 
   float producer_bytes_out = cost_analysis->output_bytes_accessed(*producer);
   float producer_bytes_in =
@@ -147,10 +280,27 @@ GpuPerformanceModel::EstimateRunTimes(
       ShapeUtil::ElementsInRecursive(producer->shape());
   VLOG(8) << "Producer elements out: " << producer_elements_out;
 
+  const bool use_matrix_cores =
+      coefficients.matrix_flops_per_cycle_per_core > 0 && HasDot(producer);
+  const int64_t fpus_per_core = gpu_device_info.fpus_per_core > 0
+                                    ? gpu_device_info.fpus_per_core
+                                    : coefficients.fpus_per_core;
   auto compute_time = [&](int64_t n_flops, int64_t n_threads) {
-    int fpu_count = gpu_device_info.core_count * gpu_device_info.fpus_per_core;
+    if (use_matrix_cores) {
+      float flop_per_second = coefficients.matrix_flops_per_cycle_per_core *
+                              1e9 * gpu_device_info.clock_rate_ghz *
+                              gpu_device_info.core_count;
+      return absl::Seconds(n_flops / flop_per_second);
+    }
+    int64_t fpu_count = gpu_device_info.core_count * fpus_per_core;
+    if (fpu_count == 0) {
+      // Nothing is known about the compute throughput; treat the kernel as
+      // memory bound rather than as infinitely slow.
+      return absl::ZeroDuration();
+    }
     float n_threads_active = fmin(n_threads, fpu_count);
-    float flop_per_second_per_fpu = 2 * 1e9 * gpu_device_info.clock_rate_ghz;
+    float flop_per_second_per_fpu = coefficients.flops_per_cycle_per_fpu *
+                                    1e9 * gpu_device_info.clock_rate_ghz;
     float flop_per_second_effective =
         flop_per_second_per_fpu * n_threads_active;
     return absl::Seconds(n_flops / flop_per_second_effective);
@@ -160,13 +310,15 @@ GpuPerformanceModel::EstimateRunTimes(
       compute_time(cost_analysis->flop_count(*producer), producer_elements_out);
   VLOG(8) << "Compute time unfused: " << compute_time_unfused;
   VLOG(8) << "Input access time unfused: "
-          << ProducerInputAccessTime(cost_analysis, gpu_device_info, producer);
+          << ProducerInputAccessTime(cost_analysis, gpu_device_info,
+                                     coefficients, producer);
   absl::Duration output_write_time_unfused =
       absl::Seconds(producer_bytes_out / memory_bandwidth_bytes_per_second);
   VLOG(8) << "Output write time unfused: " << output_write_time_unfused;
   absl::Duration exec_time_unfused = std::max(
       compute_time_unfused,
-      ProducerInputAccessTime(cost_analysis, gpu_device_info, producer) +
+      ProducerInputAccessTime(cost_analysis, gpu_device_info, coefficients,
+                              producer) +
           output_write_time_unfused);
 
   int64_t fused_consumer_count = fused_users.size();
@@ -184,9 +336,10 @@ GpuPerformanceModel::EstimateRunTimes(
         producer_elements_out * utilization_by_this_consumer);
     exec_time_fused += std::max(
         compute_time_by_this_consumer,
-        ProducerInputAccessTime(cost_analysis, gpu_device_info, producer, u));
+        ProducerInputAccessTime(cost_analysis, gpu_device_info, coefficients,
+                                producer, u));
     producer_output_read_time_unfused +=
-        ReadTime(gpu_device_info,
+        ReadTime(gpu_device_info, coefficients,
                  std::min(producer_bytes_out,
                           producer_bytes_out * utilization_by_this_consumer),
                  producer_bytes_out * utilization_by_this_consumer);
@@ -194,12 +347,12 @@ GpuPerformanceModel::EstimateRunTimes(
   VLOG(8) << "Utilization of producer output: " << total_producer_utilization;
 
   absl::Duration time_unfused =
-      kKernelLaunchOverhead * (fused_consumer_count + 1) + exec_time_unfused +
+      coefficients.kernel_launch_overhead * (fused_consumer_count + 1) + exec_time_unfused +
       producer_output_read_time_unfused;
   VLOG(8) << "Unfused time: " << time_unfused;
 
   absl::Duration time_fused =
-      kKernelLaunchOverhead * fused_consumer_count + exec_time_fused;
+      coefficients.kernel_launch_overhead * fused_consumer_count + exec_time_fused;
   // Multi-output fusion still writes the initial output of the producer.
   // For now assume that the producer's output does not need to be recomputed.
   if (multi_output) {
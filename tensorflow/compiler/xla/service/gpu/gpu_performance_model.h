@@ -17,15 +17,59 @@ limitations under the License.
 #define TENSORFLOW_COMPILER_XLA_SERVICE_GPU_GPU_PERFORMANCE_MODEL_H_
 
 #include <cstdint>
+#include <string>
 #include <vector>
 
+#include "absl/strings/string_view.h"
 #include "absl/time/time.h"
 #include "tensorflow/compiler/xla/service/gpu/gpu_device_info.h"
 #include "tensorflow/compiler/xla/service/gpu/gpu_hlo_cost_analysis.h"
+#include "tensorflow/compiler/xla/service/gpu/gpu_types.h"
+#include "tensorflow/compiler/xla/statusor.h"
 
 namespace xla {
 namespace gpu {
 
+// Device characteristics used by the performance model that can't be queried
+// from the device description. The defaults are estimates for NVIDIA GPUs.
+struct GpuPerformanceModelCoefficients {
+  absl::Duration kernel_launch_overhead = absl::Microseconds(1);
+  // Fraction of the nominal DRAM bandwidth that streaming kernels achieve.
+  float memory_bandwidth_efficiency = 1;
+  float l2_cache_speedup = 2.5;
+  float l1_cache_speedup = 8;
+  // A very conservative estimate. L1 size varies because it can be dynamically
+  // configured as shared memory; there is no easy way to query its actual
+  // size; also we do not count what occupies cache, but rather claim that what
+  // is much smaller than the cache size will likely stay in it.
+  // For reference, it can be up to 256 kB per SM on RTX A6000.
+  int64_t l1_cache_size_per_core = 2 * 1024;
+  // Memory-side cache behind L2, e.g. AMD Infinity Cache; 0 if there is none.
+  int64_t last_level_cache_size = 0;
+  float last_level_cache_speedup = 1;
+  // Used instead of `GpuDeviceInfo::fpus_per_core` when the device does not
+  // report it.
+  int64_t fpus_per_core = 0;
+  // Vector FP32 FLOPs per cycle per FPU: 2 for FMA, 4 for packed FMA.
+  float flops_per_cycle_per_fpu = 2;
+  // Matrix core (e.g. MFMA) FP32 FLOPs per cycle per core; 0 if there are no
+  // matrix cores or dots are not expected to use them.
+  float matrix_flops_per_cycle_per_core = 0;
+
+  // Returns the coefficients for the given device, with `overrides` applied
+  // on top. `overrides` is a comma-separated list of `name=value` pairs, as
+  // printed by `ToString` and by the gpu_performance_model_calibration tool;
+  // durations are in microseconds and sizes in bytes.
+  static StatusOr<GpuPerformanceModelCoefficients> ForDevice(
+      const GpuDeviceInfo& gpu_device_info, const GpuVersion& gpu_version,
+      absl::string_view overrides = "");
+
+  // Sets the coefficients named in `overrides`, see `ForDevice`.
+  Status ApplyOverrides(absl::string_view overrides);
+
+  std::string ToString() const;
+};
+
 class GpuPerformanceModel {
  public:
   struct RunTimes {
@@ -36,7 +80,9 @@ class GpuPerformanceModel {
       const HloInstruction* producer, const GpuHloCostAnalysis* cost_analysis,
       const GpuDeviceInfo& gpu_device_info,
       const std::vector<HloInstruction*> fused_users = {},
-      bool multi_output = false);
+      bool multi_output = false,
+      const GpuPerformanceModelCoefficients& coefficients =
+          GpuPerformanceModelCoefficients());
 };
 
 }  // namespace gpu
@@ -0,0 +1,343 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// A micro-benchmark that fits the coefficients of the GPU performance model
+// (see gpu_performance_model.h) on the attached device. See kUsage for details.
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "tensorflow/compiler/xla/debug_options_flags.h"
+#include "tensorflow/compiler/xla/literal.h"
+#include "tensorflow/compiler/xla/service/gpu/gpu_device_info.h"
+#include "tensorflow/compiler/xla/service/gpu/gpu_performance_model.h"
+#include "tensorflow/compiler/xla/service/gpu/gpu_types.h"
+#include "tensorflow/compiler/xla/service/hlo_parser.h"
+#include "tensorflow/compiler/xla/service/hlo_runner.h"
+#include "tensorflow/compiler/xla/service/platform_util.h"
+#include "tensorflow/compiler/xla/status_macros.h"
+#include "tensorflow/tsl/platform/init_main.h"
+#include "tensorflow/tsl/platform/logging.h"
+#include "tensorflow/tsl/util/command_line_flags.h"
+
+namespace xla {
+namespace gpu {
+namespace {
+
+const char* const kUsage = R"(
+This tool runs a set of micro-benchmarks on the attached GPU and fits the
+coefficients of the performance model that guides fusion decisions: kernel
+launch overhead, achievable DRAM bandwidth, L1 / L2 / last level cache
+speedups, and vector and matrix compute throughput.
+
+It prints a flag that makes XLA use the measured coefficients:
+
+  bazel run gpu_performance_model_calibration > coefficients.txt
+  XLA_FLAGS="$(cat coefficients.txt)" python train.py
+)";
+
+// Number of sequential kernels used to measure the launch overhead.
+constexpr int kLaunchOverheadKernels = 33;
+// Number of f32 elements of the streaming benchmarks.
+constexpr int64_t kStreamElements = 64 * 1024 * 1024;
+// Number of multiply-add pairs per element of the compute benchmark.
+constexpr int kComputeChainLength = 256;
+// Size of the matrices of the matrix compute benchmark.
+constexpr int64_t kMatrixSize = 4096;
+
+// A chain of `num_kernels` reductions, each of which depends on the previous
+// one and therefore runs as a separate kernel.
+std::string LaunchOverheadHlo(int num_kernels) {
+  std::string hlo = R"(
+HloModule launch_overhead
+
+add {
+  a = f32[] parameter(0)
+  b = f32[] parameter(1)
+  ROOT s = f32[] add(a, b)
+}
+
+ENTRY e {
+  p0 = f32[1024] parameter(0)
+  zero = f32[] constant(0)
+  r0 = f32[] reduce(p0, zero), dimensions={0}, to_apply=add
+)";
+  for (int i = 1; i < num_kernels; ++i) {
+    absl::StrAppendFormat(&hlo,
+                          "  b%d = f32[1024] broadcast(r%d), dimensions={}\n"
+                          "  x%d = f32[1024] add(p0, b%d)\n"
+                          "  r%d = f32[] reduce(x%d, zero), dimensions={0}, "
+                          "to_apply=add\n",
+                          i, i - 1, i, i, i, i);
+  }
+  absl::StrAppendFormat(&hlo, "  ROOT out = f32[] copy(r%d)\n}\n",
+                        num_kernels - 1);
+  return hlo;
+}
+
+// Adds two large arrays; streams three arrays through DRAM.
+std::string StreamHlo(int64_t n) {
+  return absl::StrFormat(R"(
+HloModule stream
+
+ENTRY e {
+  p0 = f32[%d] parameter(0)
+  p1 = f32[%d] parameter(1)
+  ROOT a0 = f32[%d] add(p0, p1)
+}
+)",
+                         n, n, n);
+}
+
+// Adds a large array to an array of `small` elements broadcast `repeats`
+// times. The small array is read from cache if it fits.
+std::string BroadcastHlo(int64_t small, int64_t repeats) {
+  const int64_t n = small * repeats;
+  return absl::StrFormat(R"(
+HloModule broadcast
+
+ENTRY e {
+  p0 = f32[%d] parameter(0)
+  bc0 = f32[%d,%d] broadcast(p0), dimensions={1}
+  b0 = f32[%d] bitcast(bc0)
+  p1 = f32[%d] parameter(1)
+  ROOT a0 = f32[%d] add(b0, p1)
+}
+)",
+                         small, repeats, small, n, n, n);
+}
+
+// A chain of `length` dependent multiply-add pairs per element.
+std::string ComputeHlo(int64_t n, int length) {
+  std::string hlo = absl::StrFormat(R"(
+HloModule compute
+
+ENTRY e {
+  p0 = f32[%d] parameter(0)
+  c = f32[] constant(1.0001)
+  cb = f32[%d] broadcast(c), dimensions={}
+  x0 = f32[%d] copy(p0)
+)",
+                                    n, n, n);
+  for (int i = 0; i < length; ++i) {
+    absl::StrAppendFormat(&hlo,
+                          "  m%d = f32[%d] multiply(x%d, cb)\n"
+                          "  x%d = f32[%d] add(m%d, cb)\n",
+                          i, n, i, i + 1, n, i);
+  }
+  absl::StrAppendFormat(&hlo, "  ROOT out = f32[%d] copy(x%d)\n}\n", n,
+                        length);
+  return hlo;
+}
+
+std::string MatrixHlo(int64_t n) {
+  return absl::StrFormat(R"(
+HloModule matrix
+
+ENTRY e {
+  p0 = f32[%d,%d] parameter(0)
+  p1 = f32[%d,%d] parameter(1)
+  ROOT d0 = f32[%d,%d] dot(p0, p1), lhs_contracting_dims={1}, rhs_contracting_dims={0}
+}
+)",
+                         n, n, n, n, n, n);
+}
+
+class Calibrator {
+ public:
+  Calibrator(HloRunner* runner, int iterations)
+      : runner_(runner), iterations_(iterations) {}
+
+  // Returns the median wall time of executing `hlo` on the device, with the
+  // arguments already resident on the device.
+  StatusOr<absl::Duration> MeasureRunTime(const std::string& hlo) {
+    HloModuleConfig config;
+    config.set_debug_options(GetDebugOptionsFromFlags());
+    TF_ASSIGN_OR_RETURN(std::unique_ptr<HloModule> module,
+                        ParseAndReturnUnverifiedModule(hlo, config));
+    std::vector<Literal> arguments;
+    for (const HloInstruction* parameter :
+         module->entry_computation()->parameter_instructions()) {
+      arguments.push_back(Literal::CreateFromShape(parameter->shape()));
+    }
+    TF_ASSIGN_OR_RETURN(
+        std::unique_ptr<Executable> executable,
+        runner_->CreateExecutable(std::move(module), /*run_hlo_passes=*/true));
+    TF_ASSIGN_OR_RETURN(std::vector<ScopedShapedBuffer> buffers,
+                        runner_->TransferLiteralsToDevice(arguments));
+
+    // Warm up.
+    TF_RETURN_IF_ERROR(
+        runner_->ExecuteWithDeviceBuffers(executable.get(), buffers).status());
+    std::vector<absl::Duration> times;
+    for (int i = 0; i < iterations_; ++i) {
+      absl::Time start = absl::Now();
+      TF_RETURN_IF_ERROR(
+          runner_->ExecuteWithDeviceBuffers(executable.get(), buffers)
+              .status());
+      times.push_back(absl::Now() - start);
+    }
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+  }
+
+  // Returns the run time of `hlo` minus the fixed cost of running any module,
+  // which includes the host-side overhead of the runner.
+  StatusOr<absl::Duration> MeasureKernelTime(const std::string& hlo) {
+    TF_ASSIGN_OR_RETURN(absl::Duration time, MeasureRunTime(hlo));
+    return std::max(time - base_time_, absl::Nanoseconds(1));
+  }
+
+  Status Calibrate(const GpuDeviceInfo& device_info,
+                   GpuPerformanceModelCoefficients* coefficients) {
+    TF_ASSIGN_OR_RETURN(base_time_, MeasureRunTime(LaunchOverheadHlo(1)));
+    TF_ASSIGN_OR_RETURN(absl::Duration chain_time,
+                        MeasureKernelTime(LaunchOverheadHlo(
+                            kLaunchOverheadKernels)));
+    coefficients->kernel_launch_overhead =
+        chain_time / (kLaunchOverheadKernels - 1);
+
+    // Time per byte of streaming through DRAM.
+    TF_ASSIGN_OR_RETURN(absl::Duration stream_time,
+                        MeasureKernelTime(StreamHlo(kStreamElements)));
+    const double stream_bytes = 3.0 * sizeof(float) * kStreamElements;
+    const double dram_seconds_per_byte =
+        absl::ToDoubleSeconds(stream_time) / stream_bytes;
+    coefficients->memory_bandwidth_efficiency =
+        1.0 / (dram_seconds_per_byte * device_info.memory_bandwidth);
+
+    // Speedup of reading the broadcast operand of `small_bytes` bytes, over
+    // reading it from DRAM.
+    auto cache_speedup = [&](int64_t small_bytes) -> StatusOr<double> {
+      const int64_t small = std::max<int64_t>(small_bytes / sizeof(float), 1);
+      const int64_t repeats = std::max<int64_t>(kStreamElements / small, 1);
+      const double large_bytes = 1.0 * sizeof(float) * small * repeats;
+      TF_ASSIGN_OR_RETURN(absl::Duration time,
+                          MeasureKernelTime(BroadcastHlo(small, repeats)));
+      const double dram_read_seconds = large_bytes * dram_seconds_per_byte;
+      // The large operand and the output go to DRAM.
+      const double cached_read_seconds = std::max(
+          absl::ToDoubleSeconds(time) - 2 * dram_read_seconds, 1e-9);
+      return std::max(dram_read_seconds / cached_read_seconds, 1.0);
+    };
+    TF_ASSIGN_OR_RETURN(double l2_speedup,
+                        cache_speedup(device_info.l2_cache_size / 2));
+    coefficients->l2_cache_speedup = l2_speedup;
+    TF_ASSIGN_OR_RETURN(
+        double l1_speedup,
+        cache_speedup(coefficients->l1_cache_size_per_core *
+                      device_info.core_count / 2));
+    coefficients->l1_cache_speedup = std::max(l1_speedup / l2_speedup, 1.0);
+    if (coefficients->last_level_cache_size > device_info.l2_cache_size) {
+      TF_ASSIGN_OR_RETURN(
+          coefficients->last_level_cache_speedup,
+          cache_speedup(coefficients->last_level_cache_size / 2));
+    }
+
+    // Vector compute throughput in the units of GpuHloCostAnalysis, which
+    // counts one FLOP per elementwise multiply or add.
+    const int64_t fpus_per_core = device_info.fpus_per_core > 0
+                                      ? device_info.fpus_per_core
+                                      : coefficients->fpus_per_core;
+    if (fpus_per_core > 0) {
+      const int64_t n = kStreamElements / 4;
+      TF_ASSIGN_OR_RETURN(absl::Duration time,
+                          MeasureKernelTime(ComputeHlo(n, kComputeChainLength)));
+      const double flops = 2.0 * kComputeChainLength * n;
+      coefficients->flops_per_cycle_per_fpu =
+          flops / (absl::ToDoubleSeconds(time) * 1e9 *
+                   device_info.clock_rate_ghz * device_info.core_count *
+                   fpus_per_core);
+    }
+
+    if (coefficients->matrix_flops_per_cycle_per_core > 0) {
+      TF_ASSIGN_OR_RETURN(absl::Duration time,
+                          MeasureKernelTime(MatrixHlo(kMatrixSize)));
+      const double flops = 2.0 * kMatrixSize * kMatrixSize * kMatrixSize;
+      coefficients->matrix_flops_per_cycle_per_core =
+          flops / (absl::ToDoubleSeconds(time) * 1e9 *
+                   device_info.clock_rate_ghz * device_info.core_count);
+    }
+    return OkStatus();
+  }
+
+ private:
+  HloRunner* runner_;
+  const int iterations_;
+  absl::Duration base_time_;
+};
+
+Status RealMain(int iterations) {
+  TF_ASSIGN_OR_RETURN(se::Platform * platform,
+                      PlatformUtil::GetPlatform("gpu"));
+  HloRunner runner(platform);
+  se::StreamExecutor* stream_exec = runner.backend().default_stream_executor();
+  const se::DeviceDescription& description =
+      stream_exec->GetDeviceDescription();
+  GpuVersion gpu_version = description.cuda_compute_capability();
+  if (platform->Name() == "ROCM") {
+    gpu_version = description.rocm_compute_capability();
+  }
+  const GpuDeviceInfo device_info = GetGpuDeviceInfo(stream_exec);
+
+  // Start from the built-in estimates for the device, which provide the
+  // coefficients that are not measured (e.g. cache sizes).
+  TF_ASSIGN_OR_RETURN(GpuPerformanceModelCoefficients coefficients,
+                      GpuPerformanceModelCoefficients::ForDevice(
+                          device_info, gpu_version));
+  LOG(INFO) << "Calibrating the performance model on " << device_info.name
+            << ", starting from " << coefficients.ToString();
+  Calibrator calibrator(&runner, iterations);
+  TF_RETURN_IF_ERROR(calibrator.Calibrate(device_info, &coefficients));
+  std::cout << "--xla_gpu_performance_model_coefficients="
+            << coefficients.ToString() << std::endl;
+  return OkStatus();
+}
+
+}  // namespace
+}  // namespace gpu
+}  // namespace xla
+
+int main(int argc, char** argv) {
+  int iterations = 20;
+  std::vector<tsl::Flag> flag_list = {
+      tsl::Flag("iterations", &iterations,
+                "Number of timed executions of each benchmark; the median is "
+                "used."),
+  };
+  xla::AppendDebugOptionsFlags(&flag_list);
+  const std::string usage_string = absl::StrCat(
+      xla::gpu::kUsage, "\n\n", tsl::Flags::Usage(argv[0], flag_list));
+  bool parse_ok = tsl::Flags::Parse(&argc, argv, flag_list);
+  tsl::port::InitMain(usage_string.c_str(), &argc, &argv);
+  if (!parse_ok || iterations <= 0) {
+    LOG(QFATAL) << usage_string;
+  }
+  xla::Status status = xla::gpu::RealMain(iterations);
+  if (!status.ok()) {
+    LOG(ERROR) << status;
+    return 1;
+  }
+  return 0;
+}
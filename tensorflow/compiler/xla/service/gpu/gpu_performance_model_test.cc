@@ -845,6 +845,152 @@ TEST_F(GpuPerformanceModelTest, UnusedParameter) {
   EXPECT_NEAR(absl::ToInt64Microseconds(t.time_unfused), 2, 1);
 }
 
+TEST_F(GpuPerformanceModelTest, RocmComputeTimeIsFinite) {
+  absl::string_view hlo_string = R"(
+HloModule m
+
+f {
+  b0 = f32[10000000] parameter(0)
+  e0 = f32[10000000] log(b0)
+  e1 = f32[10000000] log(e0)
+  e2 = f32[10000000] log(e1)
+  ROOT e3 = f32[10000000] log(e2)
+}
+
+ENTRY e {
+  p0 = f32[10000000] parameter(0)
+  ROOT r.1 = f32[10000000] fusion(p0), kind=kLoop, calls=f
+}
+)";
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(hlo_string));
+  HloInstruction* root = module->entry_computation()->root_instruction();
+  ASSERT_IS_OK(root->Accept(&analysis_));
+
+  // ROCm does not report the number of FPUs per core.
+  GpuDeviceInfo device_info = TestGpuDeviceInfo::AMDMI210DeviceInfo();
+  ASSERT_EQ(device_info.fpus_per_core, 0);
+  TF_ASSERT_OK_AND_ASSIGN(
+      GpuPerformanceModelCoefficients coefficients,
+      GpuPerformanceModelCoefficients::ForDevice(
+          device_info, se::RocmComputeCapability("gfx90a")));
+  GpuPerformanceModel::RunTimes t = GpuPerformanceModel::EstimateRunTimes(
+      root, &analysis_, device_info, /*fused_users=*/{},
+      /*multi_output=*/false, coefficients);
+  EXPECT_LT(t.time_unfused, absl::InfiniteDuration());
+  // At least as slow as streaming the data at the nominal bandwidth.
+  EXPECT_GT(t.time_unfused, absl::Microseconds(48));
+}
+
+TEST_F(GpuPerformanceModelTest, RocmKernelLaunchOverhead) {
+  absl::string_view hlo_string = R"(
+HloModule m
+
+f {
+  p0 = f32[1000] parameter(0)
+  p1 = f32[1000] parameter(1)
+  ROOT b0 = f32[1000] add(p0, p1)
+}
+
+ENTRY e {
+  p0 = f32[1000] parameter(0)
+  p1 = f32[1000] parameter(1)
+  ROOT r.1 = f32[1000] fusion(p0, p1), kind=kLoop, calls=f
+}
+)";
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(hlo_string));
+  HloInstruction* root = module->entry_computation()->root_instruction();
+  ASSERT_IS_OK(root->Accept(&analysis_));
+
+  GpuDeviceInfo device_info = TestGpuDeviceInfo::AMDMI210DeviceInfo();
+  TF_ASSERT_OK_AND_ASSIGN(
+      GpuPerformanceModelCoefficients coefficients,
+      GpuPerformanceModelCoefficients::ForDevice(
+          device_info, se::RocmComputeCapability("gfx90a")));
+  GpuPerformanceModel::RunTimes t = GpuPerformanceModel::EstimateRunTimes(
+      root, &analysis_, device_info, /*fused_users=*/{},
+      /*multi_output=*/false, coefficients);
+  // Dominated by the kernel launch overhead.
+  EXPECT_NEAR(absl::ToInt64Microseconds(t.time_unfused), 3, 1);
+}
+
+TEST_F(GpuPerformanceModelTest, InfinityCacheEffect) {
+  absl::string_view hlo_string = R"(
+HloModule m
+
+f {
+  p0 = f32[4000000] parameter(0)
+  bc0 = f32[4000000,10] broadcast(p0), dimensions={0}
+  b0 = f32[40000000] bitcast(bc0)
+  p1 = f32[40000000] parameter(1)
+  ROOT a0 = f32[40000000] add(b0, p1)
+}
+
+ENTRY e {
+  p0 = f32[4000000] parameter(0)
+  p1 = f32[40000000] parameter(1)
+  ROOT r.1 = f32[40000000] fusion(p0, p1), kind=kLoop, calls=f
+}
+)";
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(hlo_string));
+  HloInstruction* root = module->entry_computation()->root_instruction();
+  ASSERT_IS_OK(root->Accept(&analysis_));
+
+  // Parameter 0 does not fit in L2, but it fits in the Infinity Cache.
+  GpuDeviceInfo device_info = TestGpuDeviceInfo::AMDMI210DeviceInfo();
+  TF_ASSERT_OK_AND_ASSIGN(
+      GpuPerformanceModelCoefficients with_infinity_cache,
+      GpuPerformanceModelCoefficients::ForDevice(
+          device_info, se::RocmComputeCapability("gfx1030")));
+  TF_ASSERT_OK_AND_ASSIGN(
+      GpuPerformanceModelCoefficients without_infinity_cache,
+      GpuPerformanceModelCoefficients::ForDevice(
+          device_info, se::RocmComputeCapability("gfx1030"),
+          "last_level_cache_size=0"));
+  GpuPerformanceModel::RunTimes t_with = GpuPerformanceModel::EstimateRunTimes(
+      root, &analysis_, device_info, /*fused_users=*/{},
+      /*multi_output=*/false, with_infinity_cache);
+  GpuPerformanceModel::RunTimes t_without =
+      GpuPerformanceModel::EstimateRunTimes(
+          root, &analysis_, device_info, /*fused_users=*/{},
+          /*multi_output=*/false, without_infinity_cache);
+  EXPECT_LT(t_with.time_unfused, t_without.time_unfused);
+}
+
+TEST(GpuPerformanceModelCoefficientsTest, CudaUsesDefaults) {
+  TF_ASSERT_OK_AND_ASSIGN(
+      GpuPerformanceModelCoefficients coefficients,
+      GpuPerformanceModelCoefficients::ForDevice(
+          TestGpuDeviceInfo::RTXA6000DeviceInfo(),
+          se::CudaComputeCapability(8, 6)));
+  EXPECT_EQ(coefficients.ToString(),
+            GpuPerformanceModelCoefficients().ToString());
+}
+
+TEST(GpuPerformanceModelCoefficientsTest, Overrides) {
+  TF_ASSERT_OK_AND_ASSIGN(
+      GpuPerformanceModelCoefficients coefficients,
+      GpuPerformanceModelCoefficients::ForDevice(
+          TestGpuDeviceInfo::AMDMI210DeviceInfo(),
+          se::RocmComputeCapability("gfx90a"),
+          "kernel_launch_overhead_us=4.5, l2_cache_speedup=1.5"));
+  EXPECT_EQ(coefficients.kernel_launch_overhead, absl::Microseconds(4.5));
+  EXPECT_EQ(coefficients.l2_cache_speedup, 1.5);
+  // Not overridden.
+  EXPECT_EQ(coefficients.matrix_flops_per_cycle_per_core, 256);
+
+  // The string representation can be passed back as overrides.
+  GpuPerformanceModelCoefficients parsed;
+  TF_ASSERT_OK(parsed.ApplyOverrides(coefficients.ToString()));
+  EXPECT_EQ(parsed.ToString(), coefficients.ToString());
+
+  EXPECT_FALSE(parsed.ApplyOverrides("no_such_coefficient=1").ok());
+  EXPECT_FALSE(parsed.ApplyOverrides("l2_cache_speedup").ok());
+  EXPECT_FALSE(parsed.ApplyOverrides("l2_cache_speedup=fast").ok());
+}
+
 }  // namespace
 }  // namespace gpu
 }  // namespace xla
@@ -0,0 +1,250 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/service/gpu/host_offloader.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/str_format.h"
+#include "tensorflow/compiler/xla/hlo/ir/hlo_computation.h"
+#include "tensorflow/compiler/xla/hlo/ir/hlo_instruction.h"
+#include "tensorflow/compiler/xla/hlo/ir/hlo_instructions.h"
+#include "tensorflow/compiler/xla/hlo/ir/hlo_opcode.h"
+#include "tensorflow/compiler/xla/hlo/ir/hlo_schedule.h"
+#include "tensorflow/compiler/xla/service/buffer_value.h"
+#include "tensorflow/compiler/xla/service/heap_simulator.h"
+#include "tensorflow/compiler/xla/service/hlo_dataflow_analysis.h"
+#include "tensorflow/compiler/xla/shape_util.h"
+#include "tensorflow/compiler/xla/util.h"
+#include "tensorflow/tsl/platform/errors.h"
+#include "tensorflow/tsl/platform/logging.h"
+#include "tensorflow/tsl/platform/statusor.h"
+
+namespace xla {
+namespace gpu {
+namespace {
+
+// A buffer that is not used between the schedule positions `last_use_before`
+// and `first_use_after`.
+struct Candidate {
+  HloInstruction* value;
+  int64_t bytes;
+  int64_t last_use_before;
+  int64_t first_use_after;
+};
+
+// Returns whether `user` reads `value` without aliasing its buffer, so that
+// it can read a reloaded copy instead.
+bool IsOffloadableUse(const HloInstruction* value, const HloInstruction* user) {
+  switch (user->opcode()) {
+    case HloOpcode::kBitcast:
+    case HloOpcode::kGetTupleElement:
+    case HloOpcode::kTuple:
+    case HloOpcode::kWhile:
+    case HloOpcode::kConditional:
+    case HloOpcode::kCall:
+    case HloOpcode::kAsyncStart:
+    case HloOpcode::kOptimizationBarrier:
+      return false;
+    default:
+      break;
+  }
+  for (const auto& [operand_index, output_index] :
+       HloDataflowAnalysis::GetInPlaceInputOutputPairs(user)) {
+    if (user->operand(operand_index.operand_number) == value) return false;
+  }
+  return true;
+}
+
+std::optional<Candidate> GetCandidate(
+    HloInstruction* value,
+    const absl::flat_hash_map<const HloInstruction*, int64_t>& positions,
+    const HostOffloader::Options& options,
+    const HloCostAnalysis::ShapeSizeFunction& shape_size) {
+  switch (value->opcode()) {
+    // These don't define a buffer of their own, or one that the program
+    // could release.
+    case HloOpcode::kParameter:
+    case HloOpcode::kConstant:
+    case HloOpcode::kBitcast:
+    case HloOpcode::kGetTupleElement:
+      return std::nullopt;
+    default:
+      break;
+  }
+  if (!value->shape().IsArray() || !value->shape().is_static() ||
+      value->IsRoot() || value->HasSideEffect()) {
+    return std::nullopt;
+  }
+  const int64_t bytes = shape_size(value->shape());
+  if (bytes < options.min_offload_bytes) return std::nullopt;
+
+  std::vector<int64_t> uses = {positions.at(value)};
+  for (const HloInstruction* user : value->users()) {
+    if (!IsOffloadableUse(value, user)) return std::nullopt;
+    uses.push_back(positions.at(user));
+  }
+  if (uses.size() < 2) return std::nullopt;
+  std::sort(uses.begin(), uses.end());
+
+  Candidate candidate{value, bytes, 0, 0};
+  for (size_t i = 1; i < uses.size(); ++i) {
+    if (uses[i] - uses[i - 1] >
+        candidate.first_use_after - candidate.last_use_before) {
+      candidate.last_use_before = uses[i - 1];
+      candidate.first_use_after = uses[i];
+    }
+  }
+  if (candidate.first_use_after - candidate.last_use_before <
+      options.min_unused_instructions) {
+    return std::nullopt;
+  }
+  return candidate;
+}
+
+HloInstruction* AddCustomCall(HloComputation* computation, const Shape& shape,
+                              absl::Span<HloInstruction* const> operands,
+                              absl::string_view target, int64_t uid) {
+  HloInstruction* call =
+      computation->AddInstruction(HloInstruction::CreateCustomCall(
+          shape, operands, target, absl::StrFormat("{uid = %d : i32}", uid),
+          CustomCallApiVersion::API_VERSION_TYPED_FFI));
+  // The calls only have an effect on streams and host buffers, which the
+  // compiler does not see.
+  Cast<HloCustomCallInstruction>(call)->set_custom_call_has_side_effect(true);
+  return call;
+}
+
+}  // namespace
+
+StatusOr<bool> HostOffloader::Run(
+    HloModule* module,
+    const absl::flat_hash_set<absl::string_view>& execution_threads) {
+  if (!module->has_schedule()) {
+    return InternalError("HostOffloader requires a scheduled module.");
+  }
+  TF_ASSIGN_OR_RETURN(
+      int64_t peak_bytes,
+      HeapSimulator::MinimumMemoryForModule(
+          module->schedule(), [&](const BufferValue& buffer) {
+            return shape_size_(buffer.shape());
+          }));
+  if (peak_bytes <= options_.memory_limit_bytes) {
+    VLOG(2) << module->name() << " needs " << peak_bytes
+            << " bytes, which fit into the limit of "
+            << options_.memory_limit_bytes;
+    return false;
+  }
+
+  HloComputation* entry = module->entry_computation();
+  const std::vector<HloInstruction*>& sequence =
+      module->schedule().sequence(entry).instructions();
+  absl::flat_hash_map<const HloInstruction*, int64_t> positions;
+  for (int64_t i = 0; i < sequence.size(); ++i) positions[sequence[i]] = i;
+
+  std::vector<Candidate> candidates;
+  for (HloInstruction* instr : sequence) {
+    if (std::optional<Candidate> candidate =
+            GetCandidate(instr, positions, options_, shape_size_)) {
+      candidates.push_back(*candidate);
+    }
+  }
+  // Largest buffers first, then those that stay unused the longest.
+  std::sort(candidates.begin(), candidates.end(),
+            [&](const Candidate& a, const Candidate& b) {
+              return std::make_tuple(-a.bytes,
+                                     a.last_use_before - a.first_use_after,
+                                     positions.at(a.value)) <
+                     std::make_tuple(-b.bytes,
+                                     b.last_use_before - b.first_use_after,
+                                     positions.at(b.value));
+            });
+
+  // Instructions to insert before and after each position of the sequence.
+  std::vector<std::vector<HloInstruction*>> before(sequence.size());
+  std::vector<std::vector<HloInstruction*>> after(sequence.size());
+  const Shape handle_shape = ShapeUtil::MakeShape(S32, {});
+  const int64_t excess_bytes = peak_bytes - options_.memory_limit_bytes;
+  int64_t offloaded_bytes = 0;
+  int64_t uid = 0;
+  for (const Candidate& candidate : candidates) {
+    if (offloaded_bytes >= excess_bytes) break;
+    HloInstruction* value = candidate.value;
+    const int64_t middle =
+        (candidate.last_use_before + candidate.first_use_after) / 2;
+    const int64_t offload_done = std::min(
+        candidate.last_use_before + options_.overlap_instructions, middle);
+    const int64_t reload_start = std::max(
+        candidate.first_use_after - options_.overlap_instructions, middle + 1);
+
+    HloInstruction* offload_start_call = AddCustomCall(
+        entry, handle_shape, {value}, kHostOffloadStartCallTarget, uid);
+    HloInstruction* offload_done_call =
+        AddCustomCall(entry, handle_shape, {offload_start_call, value},
+                      kHostOffloadDoneCallTarget, uid);
+    HloInstruction* reload_start_call =
+        AddCustomCall(entry, value->shape(), {offload_done_call},
+                      kHostReloadStartCallTarget, uid);
+    HloInstruction* reload_done_call = AddCustomCall(
+        entry, handle_shape, {reload_start_call}, kHostReloadDoneCallTarget,
+        uid);
+    reload_start_call->set_metadata(value->metadata());
+
+    std::vector<HloInstruction*> users = value->users();
+    for (HloInstruction* user : users) {
+      auto it = positions.find(user);
+      if (it == positions.end() || it->second < candidate.first_use_after) {
+        continue;
+      }
+      TF_RETURN_IF_ERROR(value->ReplaceUseWith(user, reload_start_call));
+      TF_RETURN_IF_ERROR(reload_done_call->AddControlDependencyTo(user));
+    }
+
+    after[candidate.last_use_before].push_back(offload_start_call);
+    after[offload_done].push_back(offload_done_call);
+    before[reload_start].push_back(reload_start_call);
+    before[candidate.first_use_after].push_back(reload_done_call);
+    VLOG(2) << "Offloading " << value->name() << " (" << candidate.bytes
+            << " bytes) to the host between schedule positions "
+            << candidate.last_use_before << " and "
+            << candidate.first_use_after;
+    offloaded_bytes += candidate.bytes;
+    ++uid;
+  }
+  if (uid == 0) return false;
+
+  HloInstructionSequence new_sequence;
+  for (int64_t i = 0; i < sequence.size(); ++i) {
+    for (HloInstruction* instr : before[i]) new_sequence.push_back(instr);
+    new_sequence.push_back(sequence[i]);
+    for (HloInstruction* instr : after[i]) new_sequence.push_back(instr);
+  }
+  module->schedule().set_sequence(entry, std::move(new_sequence));
+  TF_RETURN_IF_ERROR(module->schedule().Verify());
+  VLOG(1) << "Offloaded " << uid << " buffers (" << offloaded_bytes
+          << " bytes) of " << module->name() << " to the host, to bring its "
+          << peak_bytes << " bytes closer to the limit of "
+          << options_.memory_limit_bytes;
+  return true;
+}
+
+}  // namespace gpu
+}  // namespace xla
@@ -0,0 +1,102 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_COMPILER_XLA_SERVICE_GPU_HOST_OFFLOADER_H_
+#define TENSORFLOW_COMPILER_XLA_SERVICE_GPU_HOST_OFFLOADER_H_
+
+#include <cstdint>
+#include <utility>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow/compiler/xla/hlo/ir/hlo_module.h"
+#include "tensorflow/compiler/xla/service/hlo_cost_analysis.h"
+#include "tensorflow/compiler/xla/service/hlo_pass_interface.h"
+#include "tensorflow/compiler/xla/statusor.h"
+
+namespace xla {
+namespace gpu {
+
+// Custom calls implementing the copies to and from pinned host memory, see
+// runtime/host_offload.cc. The start calls issue the copies on a separate
+// stream, the done calls make the compute stream wait for them.
+inline constexpr absl::string_view kHostOffloadStartCallTarget =
+    "__gpu$HostOffloadStart";
+inline constexpr absl::string_view kHostOffloadDoneCallTarget =
+    "__gpu$HostOffloadDone";
+inline constexpr absl::string_view kHostReloadStartCallTarget =
+    "__gpu$HostReloadStart";
+inline constexpr absl::string_view kHostReloadDoneCallTarget =
+    "__gpu$HostReloadDone";
+
+// Offloads buffers of a scheduled module to pinned host memory while they are
+// not used, when the module does not fit into device memory.
+//
+// Activations of a training step are typically produced in the forward pass and
+// used again much later in the backward pass. For a value that is not used for
+// a long span of the schedule, the pass copies it to the host after its last
+// use before the span and back to the device before its first use after it:
+//
+//   x = fusion(...)              x = fusion(...)
+//   y = fusion(x)                y = fusion(x)
+//   ...                          h0 = s32[] custom-call(x), HostOffloadStart
+//                                ...
+//                                h1 = s32[] custom-call(h0, x), HostOffloadDone
+//                                ...
+//                                r = custom-call(h1), HostReloadStart
+//                                ...
+//                                h2 = s32[] custom-call(r), HostReloadDone
+//   z = fusion(x)                z = fusion(r)
+//
+// The device buffer of `x` is free after HostOffloadDone and the one of `r`
+// is only allocated at HostReloadStart. The copies overlap with the
+// instructions between the starts and the dones.
+//
+// The candidates with the largest size are offloaded first, until the offloaded
+// bytes cover the difference between the peak memory of the schedule and the
+// limit. The pass only rewrites the entry computation and must run after
+// scheduling; it updates the schedule.
+class HostOffloader : public HloModulePass {
+ public:
+  struct Options {
+    // The device memory available to the module.
+    int64_t memory_limit_bytes = 0;
+    // Buffers smaller than this are not worth a round trip over PCIe.
+    int64_t min_offload_bytes = 16 * 1024 * 1024;
+    // The number of instructions a buffer has to stay unused to be offloaded.
+    int64_t min_unused_instructions = 64;
+    // The number of instructions between the start and the done of a copy.
+    int64_t overlap_instructions = 8;
+  };
+
+  HostOffloader(Options options, HloCostAnalysis::ShapeSizeFunction shape_size)
+      : options_(options), shape_size_(std::move(shape_size)) {}
+
+  absl::string_view name() const override { return "host-offloader"; }
+
+  using HloPassInterface::Run;
+  StatusOr<bool> Run(
+      HloModule* module,
+      const absl::flat_hash_set<absl::string_view>& execution_threads) override;
+
+ private:
+  Options options_;
+  HloCostAnalysis::ShapeSizeFunction shape_size_;
+};
+
+}  // namespace gpu
+}  // namespace xla
+
+#endif  // TENSORFLOW_COMPILER_XLA_SERVICE_GPU_HOST_OFFLOADER_H_
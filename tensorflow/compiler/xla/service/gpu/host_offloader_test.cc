@@ -0,0 +1,140 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/service/gpu/host_offloader.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "tensorflow/compiler/xla/hlo/ir/hlo_instruction.h"
+#include "tensorflow/compiler/xla/hlo/ir/hlo_module.h"
+#include "tensorflow/compiler/xla/shape_util.h"
+#include "tensorflow/compiler/xla/tests/hlo_test_base.h"
+#include "tensorflow/tsl/platform/statusor.h"
+#include "tensorflow/tsl/platform/test.h"
+
+namespace xla {
+namespace gpu {
+namespace {
+
+// `x` is used right after it is defined and then again at the end of a long
+// chain of small instructions that does not use it.
+constexpr char kHlo[] = R"(
+HloModule m, is_scheduled=true
+
+ENTRY main {
+  p0 = f32[256,1024] parameter(0)
+  x = f32[256,1024] exponential(p0)
+  early = f32[1,16] slice(x), slice={[0:1], [0:16]}
+  n0 = f32[1,16] negate(early)
+  n1 = f32[1,16] negate(n0)
+  n2 = f32[1,16] negate(n1)
+  n3 = f32[1,16] negate(n2)
+  n4 = f32[1,16] negate(n3)
+  n5 = f32[1,16] negate(n4)
+  n6 = f32[1,16] negate(n5)
+  n7 = f32[1,16] negate(n6)
+  n8 = f32[1,16] negate(n7)
+  n9 = f32[1,16] negate(n8)
+  n10 = f32[1,16] negate(n9)
+  n11 = f32[1,16] negate(n10)
+  late = f32[256,1024] add(x, x)
+  ROOT tuple = (f32[256,1024], f32[1,16]) tuple(late, n11)
+}
+)";
+
+class HostOffloaderTest : public HloTestBase {
+ protected:
+  static HostOffloader::Options GetOptions(int64_t memory_limit_bytes) {
+    HostOffloader::Options options;
+    options.memory_limit_bytes = memory_limit_bytes;
+    options.min_offload_bytes = 1024;
+    options.min_unused_instructions = 8;
+    options.overlap_instructions = 2;
+    return options;
+  }
+
+  static int64_t ShapeSize(const Shape& shape) {
+    return ShapeUtil::ByteSizeOf(shape, /*pointer_size=*/8);
+  }
+
+  // Returns the position of the instruction `name` or calling `target` in the
+  // schedule of the entry computation, or -1.
+  static int64_t PositionOf(const HloModule& module, absl::string_view name) {
+    const std::vector<HloInstruction*>& sequence =
+        module.schedule().sequence(module.entry_computation()).instructions();
+    for (int64_t i = 0; i < sequence.size(); ++i) {
+      if (sequence[i]->name() == name || sequence[i]->IsCustomCall(name)) {
+        return i;
+      }
+    }
+    return -1;
+  }
+};
+
+TEST_F(HostOffloaderTest, OffloadsUnusedBuffer) {
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(kHlo));
+  TF_ASSERT_OK_AND_ASSIGN(
+      bool changed,
+      HostOffloader(GetOptions(/*memory_limit_bytes=*/1), &ShapeSize)
+          .Run(module.get()));
+  EXPECT_TRUE(changed);
+
+  const HloInstruction* late = FindInstruction(module.get(), "late");
+  EXPECT_TRUE(late->operand(0)->IsCustomCall(kHostReloadStartCallTarget));
+  EXPECT_EQ(late->operand(0), late->operand(1));
+  const HloInstruction* x = FindInstruction(module.get(), "x");
+  EXPECT_EQ(x->user_count(), 3);
+
+  // The copy to the host starts after the last use before the unused span and
+  // the copy back finishes before the first use after it.
+  const int64_t early = PositionOf(*module, "early");
+  const int64_t offload_start =
+      PositionOf(*module, kHostOffloadStartCallTarget);
+  const int64_t offload_done = PositionOf(*module, kHostOffloadDoneCallTarget);
+  const int64_t reload_start = PositionOf(*module, kHostReloadStartCallTarget);
+  const int64_t reload_done = PositionOf(*module, kHostReloadDoneCallTarget);
+  EXPECT_EQ(offload_start, early + 1);
+  EXPECT_LT(offload_start + 1, offload_done);
+  EXPECT_LT(offload_done + 1, reload_start);
+  EXPECT_LT(reload_start + 1, reload_done);
+  EXPECT_EQ(reload_done + 1, PositionOf(*module, "late"));
+  TF_EXPECT_OK(verifier().Run(module.get()).status());
+}
+
+TEST_F(HostOffloaderTest, DoesNotOffloadIfModuleFits) {
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(kHlo));
+  TF_ASSERT_OK_AND_ASSIGN(
+      bool changed,
+      HostOffloader(GetOptions(/*memory_limit_bytes=*/int64_t{1} << 40),
+                    &ShapeSize)
+          .Run(module.get()));
+  EXPECT_FALSE(changed);
+}
+
+TEST_F(HostOffloaderTest, DoesNotOffloadShortUnusedSpans) {
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(kHlo));
+  HostOffloader::Options options = GetOptions(/*memory_limit_bytes=*/1);
+  options.min_unused_instructions = 64;
+  TF_ASSERT_OK_AND_ASSIGN(bool changed,
+                          HostOffloader(options, &ShapeSize).Run(module.get()));
+  EXPECT_FALSE(changed);
+}
+
+}  // namespace
+}  // namespace gpu
+}  // namespace xla
@@ -24,6 +24,7 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
+#include "llvm/IR/IntrinsicsAMDGPU.h"
 #include "llvm/IR/IntrinsicsNVPTX.h"
 #include "llvm/IR/Verifier.h"
 #include "mlir/Dialect/Arith/IR/Arith.h"  // from @llvm-project
@@ -331,11 +332,44 @@ llvm::Value* EmitPrintf(absl::string_view fmt,
 }
 
 // Helper function to emit call to AMDGPU shfl_down function.
+//
+// Shuffles by a constant distance use cross-lane instructions that do not go
+// through LDS: DPP row_shl moves values by up to 15 lanes within a row of 16
+// lanes and ds_swizzle exchanges the two halves of 32 lanes. Other distances
+// use ds_bpermute via __ockl_readuplane_i32. The shuffle is only exact for the
+// lanes that read from lanes at the same offset within an aligned group of
+// `2 * distance` lanes, which is what warp reductions use.
 llvm::Value* EmitAMDGPUShflDown(llvm::Value* value, llvm::Value* offset,
                                 llvm::IRBuilder<>* b) {
   llvm::Module* module = b->GetInsertBlock()->getModule();
   CHECK_EQ(value->getType()->getPrimitiveSizeInBits(), 32);
   auto* i32_ty = b->getInt32Ty();
+  if (auto* constant_offset = llvm::dyn_cast<llvm::ConstantInt>(offset)) {
+    const int64_t distance = constant_offset->getSExtValue();
+    if (distance > 0 && distance < 16) {
+      // DPP row_shl:distance; lanes past the end of the row keep their value.
+      constexpr int kDppRowShl0 = 0x100;
+      llvm::Function* dpp = llvm::Intrinsic::getDeclaration(
+          module, llvm::Intrinsic::amdgcn_update_dpp, {i32_ty});
+      llvm::Value* src = b->CreateBitCast(value, i32_ty);
+      llvm::Value* result = b->CreateCall(
+          dpp, {src, src, b->getInt32(kDppRowShl0 + distance),
+                /*row_mask=*/b->getInt32(0xf), /*bank_mask=*/b->getInt32(0xf),
+                /*bound_ctrl=*/b->getFalse()});
+      return b->CreateBitCast(result, value->getType());
+    }
+    if (distance == 16) {
+      // ds_swizzle in bitmask mode: and_mask = 0x1f, or_mask = 0,
+      // xor_mask = 0x10.
+      constexpr int kSwizzleXor16 = 0x1f | (0x10 << 10);
+      llvm::Function* swizzle = llvm::Intrinsic::getDeclaration(
+          module, llvm::Intrinsic::amdgcn_ds_swizzle);
+      llvm::Value* result = b->CreateCall(
+          swizzle,
+          {b->CreateBitCast(value, i32_ty), b->getInt32(kSwizzleXor16)});
+      return b->CreateBitCast(result, value->getType());
+    }
+  }
   llvm::FunctionCallee shfl_fn = module->getOrInsertFunction(
       llvm_ir::AsStringRef("__ockl_readuplane_i32"),
       llvm::FunctionType::get(/*Result=*/i32_ty, {i32_ty, i32_ty},
@@ -591,8 +625,15 @@ bool CanEmitFusedDynamicUpdateSliceInPlaceForGpu(
 
   auto output_buffers = fusion.getOutputBuffers();
   CHECK_EQ(1, output_buffers.size());
-  auto parameter = mlir::dyn_cast<mlir::bufferization::ToTensorOp>(
-      dus.getOperand().getDefiningOp());
+  // A bitcast does not change the bytes of the buffer, so the update can be
+  // done in place through bitcasts of the parameter too.
+  mlir::Value operand = dus.getOperand();
+  while (auto bitcast = mlir::dyn_cast_or_null<mlir::mhlo::BitcastOp>(
+             operand.getDefiningOp())) {
+    operand = bitcast.getOperand();
+  }
+  auto parameter = mlir::dyn_cast_or_null<mlir::bufferization::ToTensorOp>(
+      operand.getDefiningOp());
 
   if (!parameter) {
     return false;
@@ -59,6 +59,10 @@ inline constexpr int64_t BatchedReductionRaceFreeBound() { return 8; }
 // Fusions that use Triton have FusionBackendConfig.kind equal to this string.
 inline constexpr absl::string_view kTritonGemmFusionKind = "__triton_gemm";
 
+// Fusions created by SoftmaxFusion have FusionBackendConfig.kind equal to this
+// string.
+inline constexpr absl::string_view kSoftmaxFusionKind = "__softmax";
+
 // Returns true if `hlo` will be implemented as a call to a cuSolver routine.
 //
 // This returns true if `hlo` is a CustomCall HLO with a call target equal to
@@ -121,6 +125,10 @@ llvm::Value* EmitPrintf(absl::string_view fmt,
 // can't correctly do so on both Volta and earlier GPUs.
 //
 // https://docs.nvidia.com/cuda/parallel-thread-execution/#data-movement-and-conversion-instructions-shfl-sync
+//
+// On AMDGPU, shuffles by a constant `offset` below 32 use DPP or ds_swizzle,
+// which only produce the shuffled value for lanes whose index is a multiple of
+// `2 * offset`; this is sufficient for tree reductions.
 llvm::Value* EmitFullWarpShuffleDown(llvm::Value* value, llvm::Value* offset,
                                      llvm::IRBuilder<>* builder);
 
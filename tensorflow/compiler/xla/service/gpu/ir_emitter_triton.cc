@@ -23,6 +23,7 @@ limitations under the License.
 #include <string>
 #include <system_error>  // NOLINT(build/c++11): required to interface with LLVM
 #include <utility>
+#include <variant>
 #include <vector>
 
 #include "llvm/ADT/STLExtras.h"
@@ -198,10 +199,21 @@ ma::ConstantOp CreateConst(mlir::ImplicitLocOpBuilder b, Type type,
   LOG(FATAL) << "Constant type not supported: " << llvm_ir::DumpToString(type);
 }
 
+// Returns the integer compute capability Triton passes expect. On ROCm the
+// NVIDIA tensor core (MMA) rewrites are not applicable, so 0 is returned and
+// Triton keeps the dot in a blocked layout that the AMDGPU lowering maps onto
+// MFMA instructions.
+int TritonComputeCapability(const GpuVersion& gpu_version) {
+  if (auto* cc = std::get_if<se::CudaComputeCapability>(&gpu_version)) {
+    return cc->major * 10 + cc->minor;
+  }
+  return 0;
+}
+
 void CreateTritonPipeline(mlir::OpPassManager& pm,
-                          const se::CudaComputeCapability& cc, int num_warps,
+                          const GpuVersion& gpu_version, int num_warps,
                           int num_stages) {
-  const int ccAsInt = cc.major * 10 + cc.minor;
+  const int ccAsInt = TritonComputeCapability(gpu_version);
   // Based on optimize_ttir() in
   // @triton//:python/triton/compiler/compiler.py
   pm.addPass(mlir::createInlinerPass());
@@ -781,7 +793,7 @@ StatusOr<LaunchDimensions> MatMul(
 
 StatusOr<LaunchDimensions> TritonWrapper(
     absl::string_view fn_name, const HloComputation* hlo_computation,
-    const se::CudaComputeCapability& cc, const GpuDeviceInfo& device_info,
+    const GpuVersion& gpu_version, const GpuDeviceInfo& device_info,
     const AutotuneResult::TritonGemmKey& config, llvm::Module* llvm_module,
     LaunchDimensionsGenerator generator, mlir::MLIRContext& mlir_context) {
   mlir_context.loadDialect<mt::TritonDialect>();
@@ -862,7 +874,8 @@ StatusOr<LaunchDimensions> TritonWrapper(
     }
   }
 
-  CreateTritonPipeline(pm, cc, config.num_warps(), config.num_stages());
+  CreateTritonPipeline(pm, gpu_version, config.num_warps(),
+                       config.num_stages());
   // Triton generates pointers to the global address space, while XLA needs a
   // kernel signature with pointers to the generic address space.
   pm.addPass(std::make_unique<GeneralizeKernelSignaturePass>());
@@ -885,8 +898,10 @@ StatusOr<LaunchDimensions> TritonWrapper(
   }
   launch_dimensions.SetSharedMemBytes(shared_mem_bytes);
 
+  const bool is_rocm =
+      std::holds_alternative<se::RocmComputeCapability>(gpu_version);
   std::unique_ptr<llvm::Module> ll_triton_module = mt::translateLLVMToLLVMIR(
-      &llvm_module->getContext(), triton_module, /*isROCM=*/false);
+      &llvm_module->getContext(), triton_module, /*isROCM=*/is_rocm);
   LogAndVerify(ll_triton_module.get());
   for (auto& metadata :
        llvm::make_early_inc_range(ll_triton_module->named_metadata())) {
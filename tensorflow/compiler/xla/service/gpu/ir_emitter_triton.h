@@ -23,6 +23,7 @@ limitations under the License.
 #include "mlir/IR/Builders.h"  // from @llvm-project
 #include "tensorflow/compiler/xla/hlo/ir/hlo_instructions.h"
 #include "tensorflow/compiler/xla/service/gpu/gpu_device_info.h"
+#include "tensorflow/compiler/xla/service/gpu/gpu_types.h"
 #include "tensorflow/compiler/xla/service/gpu/launch_dimensions.h"
 #include "tensorflow/compiler/xla/statusor.h"
 #include "tensorflow/tsl/protobuf/autotuning.pb.h"
@@ -49,9 +50,11 @@ using LaunchDimensionsGenerator = std::function<StatusOr<LaunchDimensions>(
 // Generate Triton IR by running the provided generator, compile it into LLVM IR
 // and return launch dimensions.
 // The MatMul() above is one of such possible IR generators.
+// `gpu_version` selects the target: NVPTX for CUDA compute capabilities and
+// AMDGPU for ROCm ones.
 StatusOr<LaunchDimensions> TritonWrapper(
     absl::string_view fn_name, const HloComputation* hlo_computation,
-    const se::CudaComputeCapability& cc, const GpuDeviceInfo& device_info,
+    const GpuVersion& gpu_version, const GpuDeviceInfo& device_info,
     const AutotuneResult::TritonGemmKey& config, llvm::Module* llvm_module,
     LaunchDimensionsGenerator generator, mlir::MLIRContext& mlir_context);
 
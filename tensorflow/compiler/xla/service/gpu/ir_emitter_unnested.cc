@@ -487,12 +487,28 @@ std::string GetIrNameFromLoc(mlir::Location loc) {
 
 // For a row reduction, returns the number of rows we can process in parallel
 // per warp.
-int RowReductionGetRowsPerWarp(int reduced_dimension_size) {
-  if (WarpSize() % reduced_dimension_size != 0 ||
-      reduced_dimension_size >= WarpSize()) {
+int RowReductionGetRowsPerWarp(int reduced_dimension_size, int warp_size) {
+  if (warp_size % reduced_dimension_size != 0 ||
+      reduced_dimension_size >= warp_size) {
     return 1;
   }
-  return WarpSize() / reduced_dimension_size;
+  return warp_size / reduced_dimension_size;
+}
+
+// Returns the warp size that row reductions are tiled for. On AMD GPUs this
+// is the wavefront size of the device, which is 64 on GCN and CDNA parts, so
+// that the intra-warp reduction covers the whole wavefront and the inter-warp
+// reduction goes through half as many shared memory slots. Column reductions
+// keep 32-wide warps: their square tile of 64-wide warps would exceed 1024
+// threads per block.
+int64_t RowReductionWarpSize(const llvm::Module* module,
+                             const GpuDeviceInfo& gpu_device_info) {
+  if (llvm::Triple(module->getTargetTriple()).getArch() ==
+          llvm::Triple::amdgcn &&
+      gpu_device_info.threads_per_warp == 2 * WarpSize()) {
+    return gpu_device_info.threads_per_warp;
+  }
+  return WarpSize();
 }
 
 }  // namespace
@@ -1762,7 +1778,7 @@ Status IrEmitterUnnested::EmitLaunchFunc(mlir::Operation* op) {
   return OkStatus();
 }
 
-#if GOOGLE_CUDA
+#if GOOGLE_CUDA || TF_HIPBLASLT
 Status IrEmitterUnnested::EmitTritonFusion(
     mlir::Operation* op,
     const tensorflow::AutotuneResult::TritonGemmKey& config) {
@@ -1809,10 +1825,14 @@ Status IrEmitterUnnested::EmitTritonFusion(
       ir_emitter_context_->name_uniquer()->GetUniqueName(
           llvm_ir::SanitizeFunctionName(
               absl::StrCat(suggested_kernel_name, "_impl")));
+#if GOOGLE_CUDA
+  GpuVersion gpu_version = ir_emitter_context_->cuda_compute_capability();
+#else
+  GpuVersion gpu_version = ir_emitter_context_->rocm_compute_capability();
+#endif  // GOOGLE_CUDA
   TF_ASSIGN_OR_RETURN(
       LaunchDimensions launch_dimensions,
-      TritonWrapper(impl_fn_name, hlo_computation,
-                    ir_emitter_context_->cuda_compute_capability(),
+      TritonWrapper(impl_fn_name, hlo_computation, gpu_version,
                     ir_emitter_context_->gpu_device_info(), config, module_,
                     &MatMul, *ir_emitter_context_->mlir_context()));
   llvm::Function* impl_fn = module_->getFunction(impl_fn_name);
@@ -1840,7 +1860,7 @@ Status IrEmitterUnnested::EmitTritonFusion(
 
   return OkStatus();
 }
-#endif  // GOOGLE_CUDA
+#endif  // GOOGLE_CUDA || TF_HIPBLASLT
 
 // TODO(timshen): update the comment once the HandleFusion code path deleted.
 //
@@ -2014,6 +2034,238 @@ Status IrEmitterUnnested::EmitUnnestedTranspose(
   return OkStatus();
 }
 
+Status IrEmitterUnnested::EmitSoftmaxFusion(
+    mlir::lmhlo::FusionOp fusion, HloComputation* fused_computation) {
+  const HloInstruction* root = fused_computation->root_instruction();
+  const Shape& row_major_shape = root->shape();
+  TF_RET_CHECK(row_major_shape.IsArray() && row_major_shape.rank() >= 1)
+      << root->ToString();
+  const int64_t rank = row_major_shape.rank();
+  const int64_t row_length = row_major_shape.dimensions(rank - 1);
+  const Shape row_shape = ShapeUtil::DeleteDimension(rank - 1, row_major_shape);
+  const int64_t num_rows = ShapeUtil::ElementsIn(row_shape);
+  if (num_rows > std::numeric_limits<int32_t>::max()) {
+    return FailedPrecondition("Too many rows (%d) for a softmax fusion",
+                              num_rows);
+  }
+
+  // One block computes one row.
+  const GpuDeviceInfo& gpu_device_info = ir_emitter_context_->gpu_device_info();
+  const int64_t warp_size = RowReductionWarpSize(module_, gpu_device_info);
+  const int64_t max_threads_per_block = RoundDownTo(
+      std::min<int64_t>(gpu_device_info.threads_per_block_limit, 1024),
+      warp_size);
+  const int64_t threads_per_block =
+      std::min(RoundUpTo(row_length, warp_size), max_threads_per_block);
+  const int64_t num_warps = threads_per_block / warp_size;
+  LaunchDimensions launch_dimensions(num_rows, threads_per_block);
+
+  TF_ASSIGN_OR_RETURN(
+      std::optional<std::vector<llvm_ir::IrArray>> opt_ir_arrays,
+      BuildKernelThunkForFusion(fusion, launch_dimensions));
+  if (!opt_ir_arrays.has_value()) {
+    // The kernel was reused, no need to emit code.
+    return OkStatus();
+  }
+  std::vector<llvm_ir::IrArray>& ir_arrays = opt_ir_arrays.value();
+  absl::Span<llvm_ir::IrArray> operand_arrays =
+      absl::MakeSpan(ir_arrays).subspan(0, fusion.getInputBuffers().size());
+  const llvm_ir::IrArray& output_array =
+      ir_arrays[fusion.getInputBuffers().size()];
+
+  llvm::Type* index_ty = GetIndexTypeForKernel(
+      fusion, ShapeUtil::ElementsIn(row_major_shape), &b_);
+  auto constant = [&](uint64_t c) -> llvm::Constant* {
+    return llvm::ConstantInt::get(index_ty, c);
+  };
+  auto is_zero = [&](llvm::Value* value) {
+    return b_.CreateICmpEQ(value, constant(0));
+  };
+  llvm::Value* thread_id = EmitThreadId(threads_per_block, index_ty);
+  llvm::Value* row = EmitBlockId(num_rows, index_ty);
+  llvm::Value* lane_id = b_.CreateURem(thread_id, constant(warp_size), "lane_id");
+  llvm::Value* warp_id = b_.CreateUDiv(thread_id, constant(warp_size), "warp_id");
+  const std::vector<llvm::Value*> row_multidim =
+      IrArray::Index(row, row_shape, &b_).multidim();
+  auto element_index = [&](llvm::Value* column) {
+    std::vector<llvm::Value*> multidim = row_multidim;
+    multidim.push_back(column);
+    return IrArray::Index(multidim, row_major_shape, index_ty);
+  };
+  auto shared_element = [&](llvm::GlobalVariable* shared, llvm::Value* index) {
+    llvm::Value* gep = b_.CreateInBoundsGEP(shared->getValueType(), shared,
+                                            {constant(0), index});
+    // __shared__ memory uses a different address space, so we cast it to
+    // global address space before writing or reading.
+    return b_.CreateAddrSpaceCast(
+        gep, llvm::PointerType::getWithSamePointeeType(
+                 llvm::cast<llvm::PointerType>(gep->getType()),
+                 /*AddressSpace=*/0));
+  };
+  KernelSupportLibrary ksl(&b_);
+  auto for_each_column =
+      [&](absl::string_view name,
+          const std::function<Status(llvm::Value* column)>& body) {
+        return ksl.ForWithStatus(name, thread_id, constant(row_length),
+                                 threads_per_block, body);
+      };
+
+  FusedIrEmitter fused_emitter(elemental_emitter_);
+
+  // Keep the rows of the parameters that are read in every pass over the row
+  // in shared memory, as long as they fit. Leave room for the block
+  // reductions.
+  const std::vector<HloInstruction*> post_order =
+      fused_computation->MakeInstructionPostOrder();
+  const int64_t num_reductions =
+      absl::c_count_if(post_order, [](const HloInstruction* hlo) {
+        return hlo->opcode() == HloOpcode::kReduce;
+      });
+  int64_t shmem_budget = gpu_device_info.shared_memory_per_block -
+                         num_reductions * (num_warps + 1) * sizeof(double);
+  bool has_cached_rows = false;
+  for (int i = 0; i < fused_computation->num_parameters(); ++i) {
+    const HloInstruction* parameter = fused_computation->parameter_instruction(i);
+    const llvm_ir::IrArray& ir_array = operand_arrays[i];
+    const int64_t row_bytes =
+        row_length *
+        ShapeUtil::ByteSizeOfPrimitiveType(parameter->shape().element_type());
+    if (!ShapeUtil::SameDimensions(parameter->shape(), row_major_shape) ||
+        row_bytes > shmem_budget) {
+      fused_emitter.BindGenerator(
+          *parameter, [this, ir_array](const IrArray::Index& index) {
+            return ir_array.EmitReadArrayElement(index, &b_);
+          });
+      continue;
+    }
+    shmem_budget -= row_bytes;
+    has_cached_rows = true;
+    llvm::Type* element_type = llvm_ir::PrimitiveTypeToIrType(
+        parameter->shape().element_type(), module_);
+    llvm::GlobalVariable* row_cache = llvm_ir::AllocateSharedMemoryTile(
+        module_, llvm::ArrayType::get(element_type, row_length), "row_cache");
+    TF_RETURN_IF_ERROR(
+        for_each_column("softmax_cache_row", [&](llvm::Value* column) {
+          Store(ir_array.EmitReadArrayElement(element_index(column), &b_),
+                shared_element(row_cache, column));
+          return OkStatus();
+        }));
+    fused_emitter.BindGenerator(
+        *parameter, [this, element_type, row_cache,
+                     &shared_element](const IrArray::Index& index) {
+          return Load(element_type,
+                      shared_element(row_cache, index.multidim().back()),
+                      "row_cache_element");
+        });
+  }
+  if (has_cached_rows) {
+    EmitSyncThreads();
+  }
+
+  // After its block reduction, every thread holds the result of each row
+  // reduction for its row.
+  absl::flat_hash_map<const HloInstruction*, llvm::AllocaInst*>
+      reduction_results;
+  for (const HloInstruction* hlo : post_order) {
+    if (hlo->opcode() != HloOpcode::kReduce) {
+      continue;
+    }
+    llvm::Type* element_type =
+        llvm_ir::PrimitiveTypeToIrType(hlo->shape().element_type(), module_);
+    llvm::AllocaInst* result = llvm_ir::EmitAllocaAtFunctionEntry(
+        element_type, "row_reduction_result", &b_);
+    reduction_results[hlo] = result;
+    fused_emitter.BindGenerator(
+        *hlo, [this, element_type, result](const IrArray::Index&) {
+          return Load(element_type, result);
+        });
+  }
+
+  for (const HloInstruction* hlo : post_order) {
+    if (hlo->opcode() != HloOpcode::kReduce) {
+      continue;
+    }
+    const HloComputation* reducer = hlo->to_apply();
+    llvm::Type* element_type =
+        llvm_ir::PrimitiveTypeToIrType(hlo->shape().element_type(), module_);
+    TF_ASSIGN_OR_RETURN(llvm::Value * init_value,
+                        (*fused_emitter.GetGenerator(*hlo->operand(1)))(
+                            IrArray::Index(index_ty)));
+    llvm::AllocaInst* partial_result = llvm_ir::EmitAllocaAtFunctionEntry(
+        element_type, "partial_reduction_result", &b_);
+    llvm::AllocaInst* input_address = llvm_ir::EmitAllocaAtFunctionEntry(
+        element_type, "reduction_input_address", &b_);
+    Store(init_value, partial_result);
+
+    // Each thread reduces a strided subset of the row.
+    TF_ASSIGN_OR_RETURN(llvm_ir::ElementGenerator input_gen,
+                        fused_emitter.GetGenerator(*hlo->operand(0)));
+    TF_RETURN_IF_ERROR(
+        for_each_column("softmax_reduce", [&](llvm::Value* column) -> Status {
+          TF_ASSIGN_OR_RETURN(llvm::Value * input,
+                              input_gen(element_index(column)));
+          Store(input, input_address);
+          TF_ASSIGN_OR_RETURN(
+              std::vector<llvm::Value*> results,
+              ComputeNestedElementFromAddrs(*reducer,
+                                            {partial_result, input_address}));
+          Store(results[0], partial_result);
+          return OkStatus();
+        }));
+
+    // Then the block reduces the partial results: within each warp, and then
+    // across the warps through shared memory.
+    const TypedPointer partial_result_typed = {partial_result, element_type};
+    EmitFullWarpShuffleDownLoopForReduce(reducer,
+                                         absl::MakeSpan(&partial_result_typed, 1),
+                                         threads_per_block, warp_size);
+    llvm::GlobalVariable* block_result = llvm_ir::AllocateSharedMemoryTile(
+        module_, llvm::ArrayType::get(element_type, 1), "block_result");
+    if (num_warps > 1) {
+      llvm::GlobalVariable* warp_results = llvm_ir::AllocateSharedMemoryTile(
+          module_, llvm::ArrayType::get(element_type, num_warps),
+          "warp_results");
+      ksl.If("softmax_intra_warp_reduce_write", is_zero(lane_id), [&] {
+        Store(Load(element_type, partial_result),
+              shared_element(warp_results, warp_id));
+      });
+      EmitSyncThreads();
+      ksl.If("softmax_inter_warp_reduce", is_zero(warp_id), [&] {
+        Store(init_value, partial_result);
+        ksl.If("softmax_warp_exists",
+               b_.CreateICmpULT(lane_id, constant(num_warps)), [&] {
+                 Store(Load(element_type, shared_element(warp_results, lane_id)),
+                       partial_result);
+               });
+        EmitFullWarpShuffleDownLoopForReduce(
+            reducer, absl::MakeSpan(&partial_result_typed, 1),
+            threads_per_block, warp_size);
+        ksl.If("softmax_block_reduce_write", is_zero(lane_id), [&] {
+          Store(Load(element_type, partial_result),
+                shared_element(block_result, constant(0)));
+        });
+      });
+    } else {
+      ksl.If("softmax_block_reduce_write", is_zero(thread_id), [&] {
+        Store(Load(element_type, partial_result),
+              shared_element(block_result, constant(0)));
+      });
+    }
+    EmitSyncThreads();
+    Store(Load(element_type, shared_element(block_result, constant(0))),
+          reduction_results.at(hlo));
+  }
+
+  TF_ASSIGN_OR_RETURN(llvm_ir::ElementGenerator output_gen,
+                      fused_emitter.GetGenerator(*root));
+  return for_each_column("softmax_output", [&](llvm::Value* column) -> Status {
+    IrArray::Index index = element_index(column);
+    TF_ASSIGN_OR_RETURN(llvm::Value * output, output_gen(index));
+    output_array.EmitWriteArrayElement(index, output, &b_);
+    return OkStatus();
+  });
+}
+
 // Returns true if the fusion has consistent transpose heros.
 static bool HasConsistentTransposeHeros(HloComputation* fusion) {
   std::vector<HloInstruction*> hlo_roots = GetFusionRoots(fusion);
@@ -2070,6 +2322,10 @@ Status IrEmitterUnnested::EmitFusion(mlir::Operation* op) {
       GetOrCreateSubComputationFromRegion(&fusion_op.getRegion(),
                                           /*is_fusion=*/true));
 
+  if (backend_config.kind() == kSoftmaxFusionKind) {
+    return EmitSoftmaxFusion(fusion_op, fused_computation);
+  }
+
   if (HasAnyUnnestedReductionRoot(fused_computation)) {
     return EmitUnnestedReduction(fusion_op, fused_computation);
   }
@@ -2079,7 +2335,7 @@ Status IrEmitterUnnested::EmitFusion(mlir::Operation* op) {
     return EmitUnnestedTranspose(fusion_op, fused_computation);
   }
 
-#if GOOGLE_CUDA
+#if GOOGLE_CUDA || TF_HIPBLASLT
   if (backend_config.kind() == kTritonGemmFusionKind) {
     if (!backend_config.has_triton_gemm_config()) {
       LOG(WARNING) << "Using fallback triton GEMM config for op "
@@ -2094,7 +2350,7 @@ Status IrEmitterUnnested::EmitFusion(mlir::Operation* op) {
     }
     return EmitTritonFusion(fusion_op, backend_config.triton_gemm_config());
   }
-#endif  // GOOGLE_CUDA
+#endif  // GOOGLE_CUDA || TF_HIPBLASLT
 
   auto fusion_results = fusion_op.getFusionResults();
   TF_RET_CHECK(!fusion_results.empty());
@@ -3932,14 +4188,15 @@ ReductionCodegenState IrEmitterUnnested::GenerateReductionCodegenState(
       llvm::GlobalVariable* shared_cache = [&]() -> llvm::GlobalVariable* {
         if (reduction_codegen_state.IsRowReduction()) {
           // Multi-row reductions do not use shared memory.
-          if (RowReductionGetRowsPerWarp(tiling_scheme.GetDimsInElems()[2]) >
-              1) {
+          const int warp_size = reduction_codegen_state.GetWarpSize();
+          if (RowReductionGetRowsPerWarp(tiling_scheme.GetDimsInElems()[2],
+                                         warp_size) > 1) {
             return nullptr;
           }
           // Allocate __shared__
           // cache[num_partial_results][num_warps][scaling_factor].
-          CHECK_EQ(tiling_scheme.GetNumThreadsPerBlock() % WarpSize(), 0);
-          int num_warps = tiling_scheme.GetNumThreadsPerBlock() / WarpSize();
+          CHECK_EQ(tiling_scheme.GetNumThreadsPerBlock() % warp_size, 0);
+          int num_warps = tiling_scheme.GetNumThreadsPerBlock() / warp_size;
           return AllocateShared(tiling_scheme, element_type,
                                 {num_partial_results, num_warps},
                                 "shared_cache");
@@ -3973,15 +4230,16 @@ ReductionCodegenState IrEmitterUnnested::GenerateReductionCodegenState(
 void IrEmitterUnnested::EmitFullWarpShuffleDownLoopForReduce(
     const HloComputation* reducer,
     absl::Span<TypedPointer const> partial_result_addresses,
-    int threads_per_block, int num_results_per_warp) {
-  // This only works when the block size is a multiple of 32 threads.
+    int threads_per_block, int warp_size, int num_results_per_warp) {
+  // This only works when the block size is a multiple of the warp size.
 
   // We check this here as a mistake in the number of threads per
   // block is very hard to detect.
-  CHECK_EQ(threads_per_block % 32, 0);
-  CHECK_EQ(WarpSize() % num_results_per_warp, 0);
+  CHECK_EQ(threads_per_block % warp_size, 0);
+  CHECK_EQ(warp_size % num_results_per_warp, 0);
 
-  for (int distance = 16 / num_results_per_warp; distance >= 1; distance /= 2) {
+  for (int distance = warp_size / 2 / num_results_per_warp; distance >= 1;
+       distance /= 2) {
     absl::InlinedVector<llvm::Value*, 2> reduction_params;
 
     for (auto acc : partial_result_addresses) {
@@ -4201,15 +4459,18 @@ void IrEmitterUnnested::EmitReductionOutputForRowReduction(
          state.partial_result_address->getAllocatedType()});
   }
 
+  const int warp_size = reduction_codegen_state.GetWarpSize();
   int reduced_dimension_size = tiling_scheme.GetDimsInElems()[2];
-  int num_rows_per_warp = RowReductionGetRowsPerWarp(reduced_dimension_size);
+  int num_rows_per_warp =
+      RowReductionGetRowsPerWarp(reduced_dimension_size, warp_size);
   EmitFullWarpShuffleDownLoopForReduce(
       reducer, absl::MakeSpan(current_outputs),
-      tiling_scheme.GetNumThreadsPerBlockPhysical(), num_rows_per_warp);
+      tiling_scheme.GetNumThreadsPerBlockPhysical(), warp_size,
+      num_rows_per_warp);
 
   KernelSupportLibrary ksl(&b_);
   llvm::Value* warp_id =
-      b_.CreateUDiv(thread_id_info.thread_id_x, constant(WarpSize()));
+      b_.CreateUDiv(thread_id_info.thread_id_x, constant(warp_size));
 
   auto emit_write_output = [&](llvm::Value* write_condition,
                                const absl::Span<TypedPointer const> values) {
@@ -4227,7 +4488,12 @@ void IrEmitterUnnested::EmitReductionOutputForRowReduction(
     return;
   }
 
-  ksl.If("intra_warp_reduce_write", is_zero(thread_id_info.lane_id), [&] {
+  // `thread_id_info.lane_id` is relative to 32-wide warps. The number of
+  // threads in X of a row reduction is a multiple of the warp size, so the
+  // lane can be derived from the X coordinate.
+  llvm::Value* lane_id =
+      b_.CreateURem(thread_id_info.thread_id_x, constant(warp_size));
+  ksl.If("intra_warp_reduce_write", is_zero(lane_id), [&] {
     for (int oidx = 0; oidx < num_outputs; oidx++) {
       const ReductionCodegenState::ReductionCalculationState& state =
           reduction_codegen_state.GetCalculationStateFor(reduction, oidx);
@@ -4247,8 +4513,7 @@ void IrEmitterUnnested::EmitReductionOutputForRowReduction(
       const ReductionCodegenState::ReductionCalculationState& state =
           reduction_codegen_state.GetCalculationStateFor(reduction, oidx);
       llvm::Value* block_accum_addr = thread_id_info.GEPIntoSharedMemory(
-          &b_, state.shared_cache,
-          {constant(partial_result_idx), thread_id_info.lane_id});
+          &b_, state.shared_cache, {constant(partial_result_idx), lane_id});
 
       llvm::Type* element_type =
           state.partial_result_address->getAllocatedType();
@@ -4262,7 +4527,7 @@ void IrEmitterUnnested::EmitReductionOutputForRowReduction(
 
       llvm::Value* warp_exists = b_.CreateICmpULT(
           thread_id_info.thread_id_x,
-          constant(tiling_scheme.GetNumThreadsFor(kDimX) / WarpSize()));
+          constant(tiling_scheme.GetNumThreadsFor(kDimX) / warp_size));
 
       llvm::Value* selected_value =
           b_.CreateSelect(warp_exists, block_accum_addr, initial_value_addr);
@@ -4275,10 +4540,10 @@ void IrEmitterUnnested::EmitReductionOutputForRowReduction(
     // TODO(b/241414088) If only warp is present, then inter-warp communication
     // using shared memory and synchronization using barrier is also unnecessary
     // and should be removed.
-    if (tiling_scheme.GetNumThreadsPerBlock() > WarpSize()) {
+    if (tiling_scheme.GetNumThreadsPerBlock() > warp_size) {
       EmitFullWarpShuffleDownLoopForReduce(
           reducer, absl::MakeSpan(selected_values),
-          tiling_scheme.GetNumThreadsPerBlock());
+          tiling_scheme.GetNumThreadsPerBlock(), warp_size);
     }
 
     emit_write_output(is_zero(thread_id_info.thread_id_x), selected_values);
@@ -4348,9 +4613,10 @@ void IrEmitterUnnested::EmitReductionOutputForColumnReduction(
                                     ->getResultElementType()});
   }
 
-  EmitFullWarpShuffleDownLoopForReduce(reducer,
-                                       absl::MakeSpan(shmem_transposed_addrs),
-                                       tiling_scheme.GetNumThreadsPerBlock());
+  EmitFullWarpShuffleDownLoopForReduce(
+      reducer, absl::MakeSpan(shmem_transposed_addrs),
+      tiling_scheme.GetNumThreadsPerBlock(),
+      reduction_codegen_state.GetWarpSize());
 
   // Some warps in the block are completely outside of the bound of the
   // tensor, so they should not write any output at all.
@@ -4825,10 +5091,10 @@ static int GetPrimitiveBitwidth(mlir::Value i) {
 // allows larger # of bytes-in-flight.
 static int CalculateVirtualThreadScalingFactorForReduction(
     const ReductionDimensions& reduction_dimensions,
-    const se::CudaComputeCapability& cc) {
+    const se::CudaComputeCapability& cc, int warp_size) {
   int64_t dimx = reduction_dimensions.dimensions[kDimX];
   if (reduction_dimensions.is_row_reduction && dimx <= 128) {
-    int rows_per_warp = RowReductionGetRowsPerWarp(dimx);
+    int rows_per_warp = RowReductionGetRowsPerWarp(dimx, warp_size);
     if (cc.IsAtLeast(se::CudaComputeCapability::AMPERE)) {
       return rows_per_warp * 3;
     }
@@ -4910,7 +5176,7 @@ static bool CanVectorizeReduction(
     se::CudaComputeCapability cc, const GpuDeviceInfo& gpu_info,
     mlir::lmhlo::FusionOp fusion, HloComputation* fused_computation,
     const ReductionDimensions& reduction_dimensions, int num_threads_x,
-    Vector3 reduction_tiling, const Shape& input_shape,
+    int warp_size, Vector3 reduction_tiling, const Shape& input_shape,
     bool reduction_is_race_free) {
   if (!reduction_dimensions.is_row_reduction) {
     return IsUnrollingColumnReductionBeneficial(
@@ -4925,7 +5191,7 @@ static bool CanVectorizeReduction(
 
   // Enabling vectorization if number of threads is <= warpsize leads to half or
   // more of the threads not doing any work.
-  if (reduction_dimensions.is_row_reduction && num_threads_x <= WarpSize()) {
+  if (reduction_dimensions.is_row_reduction && num_threads_x <= warp_size) {
     return false;
   }
 
@@ -4975,11 +5241,17 @@ StatusOr<ReductionCodegenInfo> IrEmitterUnnested::ComputeReductionCodegenInfo(
            << reduction_dimensions.dimensions[2];
   Vector3 reduction_tiling = GetReductionTiling(reduction_dimensions);
 
+  const int64_t warp_size =
+      reduction_dimensions.is_row_reduction
+          ? RowReductionWarpSize(module_,
+                                 ir_emitter_context_->gpu_device_info())
+          : WarpSize();
   int64_t num_threads_y =
-      reduction_dimensions.is_row_reduction ? 1 : WarpSize();
+      reduction_dimensions.is_row_reduction ? 1 : warp_size;
   int64_t num_threads_x = [&] {
     if (reduction_dimensions.is_row_reduction) {
-      if (RowReductionGetRowsPerWarp(reduction_dimensions.dimensions[2]) > 1) {
+      if (RowReductionGetRowsPerWarp(reduction_dimensions.dimensions[2],
+                                     warp_size) > 1) {
         return reduction_dimensions.dimensions[2];
       }
       // Use 512 as default block size (threads per block) for row reductions.
@@ -4992,9 +5264,9 @@ StatusOr<ReductionCodegenInfo> IrEmitterUnnested::ComputeReductionCodegenInfo(
       return std::min(max_block_size,
                       RoundUpTo(CeilOfRatio(reduction_dimensions.dimensions[2],
                                             reduction_tiling[2]),
-                                WarpSize()));
+                                warp_size));
     }
-    return WarpSize();
+    return warp_size;
   }();
 
   se::CudaComputeCapability cc = ir_emitter_context_->cuda_compute_capability();
@@ -5012,8 +5284,8 @@ StatusOr<ReductionCodegenInfo> IrEmitterUnnested::ComputeReductionCodegenInfo(
       (shmem_usage * 2 <= shmem_budget) &&
       CanVectorizeReduction(cc, ir_emitter_context_->gpu_device_info(), fusion,
                             fused_computation, reduction_dimensions,
-                            num_threads_x, reduction_tiling, input_shape,
-                            reduction_is_race_free);
+                            num_threads_x, warp_size, reduction_tiling,
+                            input_shape, reduction_is_race_free);
   int vector_size = vectorize ? 2 : 1;
 
   int num_partial_results = 1;
@@ -5071,7 +5343,8 @@ StatusOr<ReductionCodegenInfo> IrEmitterUnnested::ComputeReductionCodegenInfo(
 
   Vector3 num_threads = {1, num_threads_y, num_threads_x};
   int virtual_thread_scaling_factor =
-      CalculateVirtualThreadScalingFactorForReduction(reduction_dimensions, cc);
+      CalculateVirtualThreadScalingFactorForReduction(reduction_dimensions, cc,
+                                                      warp_size);
   VLOG(2) << "Using virtual thread scaling: " << virtual_thread_scaling_factor;
 
   TilingScheme tiling_scheme(reduction_dimensions.dimensions, reduction_tiling,
@@ -5079,7 +5352,7 @@ StatusOr<ReductionCodegenInfo> IrEmitterUnnested::ComputeReductionCodegenInfo(
                              virtual_thread_scaling_factor);
   return ReductionCodegenInfo(tiling_scheme, num_partial_results,
                               reduction_dimensions.is_row_reduction,
-                              reduction_is_race_free);
+                              reduction_is_race_free, warp_size);
 }
 
 // Generate a single element of the tile (update the accumulator state) for a
@@ -5154,7 +5427,9 @@ Status IrEmitterUnnested::EmitIRForReduction(
 
   CHECK(!reductions.empty()) << " expect at least one reduce instructions.";
   const TilingScheme& tiling_scheme = reduction_info.GetTilingScheme();
-  CHECK_EQ(tiling_scheme.GetNumThreadsPerBlockPhysical() % WarpSize(), 0);
+  CHECK_EQ(tiling_scheme.GetNumThreadsPerBlockPhysical() %
+               reduction_info.GetWarpSize(),
+           0);
   llvm::Type* index_ty =
       GetIndexTypeForKernel(fusion,
                             tiling_scheme.GetNumThreadsPerBlockPhysical() *
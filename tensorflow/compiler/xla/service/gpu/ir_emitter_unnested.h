@@ -203,10 +203,12 @@ class IrEmitterUnnested : public IrEmitter {
 #if GOOGLE_CUDA
   Status EmitCublasLtMatmulThunkF8(mlir::Operation* op);
   Status EmitConvolutionReorderThunk(mlir::Operation* op);
+#endif  // GOOGLE_CUDA
+#if GOOGLE_CUDA || TF_HIPBLASLT
   Status EmitTritonFusion(
       mlir::Operation* op,
       const tensorflow::AutotuneResult::TritonGemmKey& config);
-#endif  // GOOGLE_CUDA
+#endif  // GOOGLE_CUDA || TF_HIPBLASLT
 #if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
   Status EmitCholeskyThunk(mlir::Operation* op);
 #endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
@@ -502,6 +504,14 @@ class IrEmitterUnnested : public IrEmitter {
   Status EmitUnnestedTranspose(mlir::lmhlo::FusionOp fusion,
                                HloComputation* fused_computation);
 
+  // Emits a fusion created by SoftmaxFusion. Each block computes one row of
+  // the output: the row reductions in the fusion are computed one after the
+  // other by the whole block, and the rows of the parameters of the output
+  // shape are read from global memory once and kept in shared memory if they
+  // fit.
+  Status EmitSoftmaxFusion(mlir::lmhlo::FusionOp fusion,
+                           HloComputation* fused_computation);
+
   // Computes the KernelMappingScheme for the reduce HLO and indicates whether
   // the reduction is a row reduction. For an un-fused reduce op, unnested_hlo
   // and first_reduce are the same instruction. For a kInput fusion,
@@ -697,7 +707,7 @@ class IrEmitterUnnested : public IrEmitter {
   void EmitFullWarpShuffleDownLoopForReduce(
       const HloComputation* reducer,
       absl::Span<TypedPointer const> partial_result_addresses,
-      int threads_per_block, int num_results_per_warp = 1);
+      int threads_per_block, int warp_size, int num_results_per_warp = 1);
 
   // Allocates a shared tile of given dimensions, applying scaling specified in
   // tilng_scheme as a major-most dimension to avoid collisions.
@@ -169,11 +169,12 @@ class ReductionCodegenInfo {
  public:
   explicit ReductionCodegenInfo(TilingScheme mapping_scheme,
                                 int num_partial_results, bool is_row_reduction,
-                                bool is_race_free)
+                                bool is_race_free, int warp_size = 32)
       : tiling_scheme_(mapping_scheme),
         num_partial_results_(num_partial_results),
         is_row_reduction_(is_row_reduction),
-        is_race_free_(is_race_free) {
+        is_race_free_(is_race_free),
+        warp_size_(warp_size) {
     if (num_partial_results > 1) {
       CHECK_EQ(num_partial_results,
                mapping_scheme.GetTileSizeFor(TilingScheme::DimX));
@@ -185,6 +186,9 @@ class ReductionCodegenInfo {
   int GetNumPartialResults() const { return num_partial_results_; }
   bool IsRaceFree() const { return is_race_free_; }
 
+  // Number of threads per warp that the intra-warp reduction is emitted for.
+  int GetWarpSize() const { return warp_size_; }
+
  private:
   friend class ReductionCodegenState;
 
@@ -192,6 +196,7 @@ class ReductionCodegenInfo {
   int num_partial_results_;
   bool is_row_reduction_;
   bool is_race_free_;
+  int warp_size_;
 };
 
 class ReductionCodegenState {
@@ -222,6 +227,8 @@ class ReductionCodegenState {
 
   bool IsRaceFree() const { return reduction_codegen_info_.IsRaceFree(); }
 
+  int GetWarpSize() const { return reduction_codegen_info_.GetWarpSize(); }
+
   const ReductionCalculationState& GetCalculationStateFor(
       const HloInstruction* instruction, int operand_idx) const {
     const ReductionOpState& op_state = state_.at(instruction);
@@ -718,10 +718,9 @@ void HsacoCache::Add(const std::string& ir, uint64_t hash,
   g_hsacoCache.cache.back().hsaco = hsaco;
 }
 
-// Emits the given module to HSA Code Object. target_machine is an initialized
-// TargetMachine for the AMDGPU target.
-StatusOr<std::vector<uint8_t>> EmitModuleToHsaco(
-    llvm::Module* module, llvm::TargetMachine* target_machine) {
+// Returns the first local temporary directory, used for compile-time
+// artifacts.
+StatusOr<std::string> GetTempDirForCompilation() {
   auto* env = tsl::Env::Default();
   std::vector<std::string> tempdir_vector;
   env->GetLocalTempDirectories(&tempdir_vector);
@@ -731,10 +730,80 @@ StatusOr<std::vector<uint8_t>> EmitModuleToHsaco(
   }
   std::string tempdir_name = tempdir_vector.front();
   VLOG(1) << "Compile-time artifacts located at: " << tempdir_name;
+  return tempdir_name;
+}
 
+bool KeepTempFiles() {
   bool keep_tempfiles = false;
   TF_CHECK_OK(tsl::ReadBoolFromEnvVar("TF_ROCM_KEEP_XLA_TEMPFILES",
                                       /*default_val=*/false, &keep_tempfiles));
+  return keep_tempfiles;
+}
+
+StatusOr<std::vector<uint8_t>> ReadBinaryFile(const std::string& path) {
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  if (!file) {
+    return xla::InternalError("unable to open %s", path);
+  }
+  std::ifstream::pos_type file_size = file.tellg();
+
+  std::vector<uint8_t> content(file_size);
+  file.seekg(0, std::ios::beg);
+  file.read(reinterpret_cast<char*>(content.data()), file_size);
+  file.close();
+  return content;
+}
+
+// Links the relocatable AMDGPU objects at `isabin_paths` into the HSA code
+// object at `hsaco_path` with ld.lld.
+Status LinkObjectsToHsaco(const std::vector<std::string>& isabin_paths,
+                          const std::string& hsaco_path) {
+  // Locate lld.
+  std::string lld_path;
+  if (std::getenv("ROCM_PATH")) {
+       lld_path = tsl::io::JoinPath(std::getenv("ROCM_PATH"), "llvm/bin");
+  }
+  else {
+       lld_path = tsl::io::JoinPath("/opt/rocm", "llvm/bin");
+  }
+
+  auto lld_program = llvm::sys::findProgramByName("ld.lld", {lld_path});
+  if (!lld_program) {
+    return xla::InternalError("unable to find ld.lld in %s: %s", lld_path,
+                              lld_program.getError().message());
+  }
+  std::vector<llvm::StringRef> lld_args{
+      llvm_ir::AsStringRef("ld.lld"),
+      llvm_ir::AsStringRef("-flavor"),
+      llvm_ir::AsStringRef("gnu"),
+      llvm_ir::AsStringRef("-shared"),
+  };
+  for (const std::string& isabin_path : isabin_paths) {
+    lld_args.push_back(llvm_ir::AsStringRef(isabin_path));
+  }
+  lld_args.push_back(llvm_ir::AsStringRef("-o"));
+  lld_args.push_back(llvm_ir::AsStringRef(hsaco_path));
+
+  std::string error_message;
+  int lld_result =
+      llvm::sys::ExecuteAndWait(*lld_program, llvm_ir::AsArrayRef(lld_args),
+                                std::nullopt, {}, 0, 0, &error_message);
+  if (lld_result) {
+    return xla::InternalError("ld.lld execute fail: %s, error code %d",
+                              error_message, lld_result);
+  }
+  return OkStatus();
+}
+
+// Emits the given module to HSA Code Object. target_machine is an initialized
+// TargetMachine for the AMDGPU target. If `relocatable` is true the module is
+// only lowered to a relocatable object file, which can later be linked with
+// other objects by amdgpu::LinkHsacoObjects.
+StatusOr<std::vector<uint8_t>> EmitModuleToHsaco(
+    llvm::Module* module, llvm::TargetMachine* target_machine,
+    bool relocatable) {
+  TF_ASSIGN_OR_RETURN(std::string tempdir_name, GetTempDirForCompilation());
+  bool keep_tempfiles = KeepTempFiles();
   // Prepare filenames for all stages of compilation:
   // IR, binary ISA, and HSACO.
   std::string random_number = std::to_string(tsl::random::New64());
@@ -782,50 +851,22 @@ StatusOr<std::vector<uint8_t>> EmitModuleToHsaco(
     module->print(*ir_fs, nullptr);
     ir_fs->flush();
   }
-  // Locate lld.
-  std::string lld_path;
-  if (std::getenv("ROCM_PATH")) {
-       lld_path = tsl::io::JoinPath(std::getenv("ROCM_PATH"), "llvm/bin");
-  }
-  else {
-       lld_path = tsl::io::JoinPath("/opt/rocm", "llvm/bin");
-  }
-
-  auto lld_program = llvm::sys::findProgramByName("ld.lld", {lld_path});
-  if (!lld_program) {
-    return xla::InternalError("unable to find ld.lld in %s: %s", lld_path,
-                              lld_program.getError().message());
-  }
-  std::vector<llvm::StringRef> lld_args{
-      llvm_ir::AsStringRef("ld.lld"),    llvm_ir::AsStringRef("-flavor"),
-      llvm_ir::AsStringRef("gnu"),       llvm_ir::AsStringRef("-shared"),
-      llvm_ir::AsStringRef(isabin_path), llvm_ir::AsStringRef("-o"),
-      llvm_ir::AsStringRef(hsaco_path),
-  };
 
-  std::string error_message;
-  int lld_result =
-      llvm::sys::ExecuteAndWait(*lld_program, llvm_ir::AsArrayRef(lld_args),
-                                std::nullopt, {}, 0, 0, &error_message);
-  if (lld_result) {
-    return xla::InternalError("ld.lld execute fail: %s, error code %d",
-                              error_message, lld_result);
+  StatusOr<std::vector<uint8_t>> result;
+  if (relocatable) {
+    result = ReadBinaryFile(isabin_path);
+  } else {
+    Status link_status = LinkObjectsToHsaco({isabin_path}, hsaco_path);
+    result = link_status.ok() ? ReadBinaryFile(hsaco_path)
+                              : StatusOr<std::vector<uint8_t>>(link_status);
   }
 
-  // Read HSACO.
-  std::ifstream hsaco_file(hsaco_path, std::ios::binary | std::ios::ate);
-  std::ifstream::pos_type hsaco_file_size = hsaco_file.tellg();
-
-  std::vector<uint8_t> hsaco(hsaco_file_size);
-  hsaco_file.seekg(0, std::ios::beg);
-  hsaco_file.read(reinterpret_cast<char*>(&hsaco[0]), hsaco_file_size);
-  hsaco_file.close();
   if (!keep_tempfiles) {
     remove(ir_path.c_str());
     remove(isabin_path.c_str());
     remove(hsaco_path.c_str());
   }
-  return hsaco;
+  return result;
 }
 
 // Links ROCm-Device-Libs into the given module if the module needs it.
@@ -957,7 +998,7 @@ namespace amdgpu {
 StatusOr<std::vector<uint8_t>> CompileToHsaco(
     llvm::Module* module, GpuVersion gpu_version,
     const HloModuleConfig& hlo_module_config,
-    const std::string& rocdl_dir_path) {
+    const std::string& rocdl_dir_path, bool relocatable) {
   static absl::once_flag backend_init_flag;
   absl::call_once(backend_init_flag, AMDGPUBackendInit, hlo_module_config);
 
@@ -977,6 +1018,9 @@ StatusOr<std::vector<uint8_t>> CompileToHsaco(
     if (pos != std::string::npos) str = str.substr(pos + 1);
   }
   str += hlo_module_config.compilation_cache_key();
+  // Relocatable objects and linked code objects of the same IR must not alias
+  // in the HSACO cache.
+  if (relocatable) str += "relocatable";
   {
     tsl::profiler::TraceMe activity(
         [&] { return absl::StrCat("Compiling IR", module->getName().str()); },
@@ -1021,12 +1065,55 @@ StatusOr<std::vector<uint8_t>> CompileToHsaco(
         kAMDGPUInlineThreshold));
 
     // Lower optimized LLVM module to HSA code object.
-    TF_ASSIGN_OR_RETURN(hsaco, EmitModuleToHsaco(module, target_machine.get()));
+    TF_ASSIGN_OR_RETURN(hsaco, EmitModuleToHsaco(module, target_machine.get(),
+                                                 relocatable));
     HsacoCache::Add(str, hash, gcn_arch_name, hsaco);
   }
   return hsaco;
 }
 
+StatusOr<std::vector<uint8_t>> LinkHsacoObjects(
+    const std::vector<std::vector<uint8_t>>& objects) {
+  tsl::profiler::TraceMe activity("Linking HSACO objects",
+                                  tsl::profiler::TraceMeLevel::kInfo);
+  XLA_SCOPED_LOGGING_TIMER("Link HSACO objects");
+
+  TF_ASSIGN_OR_RETURN(std::string tempdir_name, GetTempDirForCompilation());
+  std::string random_number = std::to_string(tsl::random::New64());
+
+  std::vector<std::string> isabin_paths;
+  isabin_paths.reserve(objects.size());
+  auto remove_temp_files = [&](const std::string& hsaco_path) {
+    if (KeepTempFiles()) return;
+    for (const std::string& isabin_path : isabin_paths) {
+      remove(isabin_path.c_str());
+    }
+    remove(hsaco_path.c_str());
+  };
+
+  std::string hsaco_path = tsl::io::JoinPath(
+      tempdir_name, absl::StrCat("xla_linked_", random_number, ".hsaco"));
+  for (int i = 0; i < objects.size(); ++i) {
+    isabin_paths.push_back(tsl::io::JoinPath(
+        tempdir_name, absl::StrCat("xla_linked_", random_number, "_", i, ".o")));
+    std::ofstream isabin_file(isabin_paths.back(), std::ios::binary);
+    isabin_file.write(reinterpret_cast<const char*>(objects[i].data()),
+                      objects[i].size());
+    isabin_file.close();
+    if (!isabin_file) {
+      remove_temp_files(hsaco_path);
+      return xla::InternalError("unable to write %s", isabin_paths.back());
+    }
+  }
+
+  Status link_status = LinkObjectsToHsaco(isabin_paths, hsaco_path);
+  StatusOr<std::vector<uint8_t>> hsaco =
+      link_status.ok() ? ReadBinaryFile(hsaco_path)
+                       : StatusOr<std::vector<uint8_t>>(link_status);
+  remove_temp_files(hsaco_path);
+  return hsaco;
+}
+
 }  // namespace amdgpu
 
 }  // namespace gpu
@@ -52,11 +52,18 @@ StatusOr<std::string> CompileToPtx(
 namespace amdgpu {
 // Compiles the argument module and returns it with LLVM AMDGPU backend.
 // rocdl_dir_path is the parent directory of ROCm-Device-Libs bitcode libraries.
-// The contents of the module may be changed.
+// The contents of the module may be changed. If `relocatable` is true, returns
+// a relocatable object that has to be linked with LinkHsacoObjects before it
+// can be loaded.
 StatusOr<std::vector<uint8_t>> CompileToHsaco(
     llvm::Module* module, GpuVersion gpu_version,
     const HloModuleConfig& hlo_module_config,
-    const std::string& rocdl_dir_path);
+    const std::string& rocdl_dir_path, bool relocatable = false);
+
+// Links relocatable objects returned by CompileToHsaco into a single HSA code
+// object.
+StatusOr<std::vector<uint8_t>> LinkHsacoObjects(
+    const std::vector<std::vector<uint8_t>>& objects);
 }  // namespace amdgpu
 
 }  // namespace gpu
@@ -0,0 +1,92 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/service/gpu/multi_device_autotuning.h"
+
+#include <atomic>
+#include <string>
+
+#include "tensorflow/compiler/xla/stream_executor/multi_platform_manager.h"
+#include "tensorflow/compiler/xla/stream_executor/platform.h"
+#include "tensorflow/tsl/platform/env.h"
+#include "tensorflow/tsl/platform/logging.h"
+#include "tensorflow/tsl/platform/threadpool.h"
+
+namespace xla {
+namespace gpu {
+
+std::vector<se::StreamExecutor*> GetAutotuningDevices(
+    se::StreamExecutor* stream_exec, const DebugOptions& debug_options) {
+  std::vector<se::StreamExecutor*> devices = {stream_exec};
+  const int max_devices = debug_options.xla_gpu_autotune_max_devices();
+  if (max_devices == 1) {
+    return devices;
+  }
+  StatusOr<se::Platform*> platform =
+      se::MultiPlatformManager::PlatformWithId(stream_exec->platform()->id());
+  if (!platform.ok()) {
+    VLOG(1) << "Autotuning on the compiling device only: " << platform.status();
+    return devices;
+  }
+  const std::string& model_str =
+      stream_exec->GetDeviceDescription().model_str();
+  const int num_devices = (*platform)->VisibleDeviceCount();
+  for (int ordinal = 0; ordinal < num_devices; ++ordinal) {
+    if (max_devices > 0 && devices.size() >= max_devices) break;
+    if (ordinal == stream_exec->device_ordinal()) continue;
+    StatusOr<se::StreamExecutor*> device =
+        (*platform)->ExecutorForDevice(ordinal);
+    if (!device.ok()) {
+      VLOG(1) << "Not autotuning on device " << ordinal << ": "
+              << device.status();
+      continue;
+    }
+    if ((*device)->GetDeviceDescription().model_str() != model_str) {
+      VLOG(1) << "Not autotuning on device " << ordinal << ", which is a "
+              << (*device)->GetDeviceDescription().model_str()
+              << " and not a " << model_str;
+      continue;
+    }
+    devices.push_back(*device);
+  }
+  VLOG(1) << "Autotuning on " << devices.size() << " devices";
+  return devices;
+}
+
+void AutotuneOnDevices(
+    absl::Span<const HloInstruction* const> instrs,
+    absl::Span<se::StreamExecutor* const> devices,
+    const std::function<Status(const HloInstruction*, se::StreamExecutor*)>&
+        autotune) {
+  std::atomic<size_t> next_instr = 0;
+  // The destructor of the pool waits for the devices to be done.
+  tsl::thread::ThreadPool thread_pool(tsl::Env::Default(), "xla_autotuning",
+                                      static_cast<int>(devices.size()));
+  for (se::StreamExecutor* device : devices) {
+    thread_pool.Schedule([&, device] {
+      for (size_t i = next_instr++; i < instrs.size(); i = next_instr++) {
+        Status status = autotune(instrs[i], device);
+        if (!status.ok()) {
+          VLOG(1) << "Failed to autotune " << instrs[i]->name()
+                  << " on device " << device->device_ordinal() << ": "
+                  << status;
+        }
+      }
+    });
+  }
+}
+
+}  // namespace gpu
+}  // namespace xla
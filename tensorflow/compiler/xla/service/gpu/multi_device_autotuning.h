@@ -0,0 +1,60 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_COMPILER_XLA_SERVICE_GPU_MULTI_DEVICE_AUTOTUNING_H_
+#define TENSORFLOW_COMPILER_XLA_SERVICE_GPU_MULTI_DEVICE_AUTOTUNING_H_
+
+#include <functional>
+#include <vector>
+
+#include "absl/types/span.h"
+#include "tensorflow/compiler/xla/hlo/ir/hlo_instruction.h"
+#include "tensorflow/compiler/xla/statusor.h"
+#include "tensorflow/compiler/xla/stream_executor/stream_executor.h"
+#include "tensorflow/compiler/xla/xla.pb.h"
+
+namespace xla {
+namespace gpu {
+
+// Returns the devices that the autotuners distribute their candidate
+// benchmarks to: `stream_exec`, followed by the other local devices of its
+// platform that have the same model, up to
+// debug_options.xla_gpu_autotune_max_devices devices (all of them if 0).
+//
+// Since the devices have the same model, the results they produce are valid
+// for the cache key of `stream_exec`. Devices that fail to initialize are
+// skipped.
+std::vector<se::StreamExecutor*> GetAutotuningDevices(
+    se::StreamExecutor* stream_exec, const DebugOptions& debug_options);
+
+// Calls `autotune` on each of `instrs`, on one thread per device of
+// `devices`. Each device takes the next instruction that no device has
+// autotuned yet, so that the load is balanced even when the benchmarks of the
+// instructions take very different times.
+//
+// The autotuners call this to fill their caches before rewriting the
+// instructions serially, which then hits the cache. The failures are only
+// logged, so that the serial pass retries the instruction on the compiling
+// device and reports its error the usual way.
+void AutotuneOnDevices(
+    absl::Span<const HloInstruction* const> instrs,
+    absl::Span<se::StreamExecutor* const> devices,
+    const std::function<Status(const HloInstruction*, se::StreamExecutor*)>&
+        autotune);
+
+}  // namespace gpu
+}  // namespace xla
+
+#endif  // TENSORFLOW_COMPILER_XLA_SERVICE_GPU_MULTI_DEVICE_AUTOTUNING_H_
@@ -99,7 +99,8 @@ HloInstruction* SelectPreferredFusionCandidate(
 std::vector<HloInstruction*> GetProducerConsumerMultiOutputFusionCandidates(
     const HloInstruction* producer, const HloReachabilityMap& reachability,
     FusionInfoCache* fusion_info_cache, GpuHloCostAnalysis* cost_analysis,
-    const GpuDeviceInfo& device_info) {
+    const GpuDeviceInfo& device_info,
+    const GpuPerformanceModelCoefficients& performance_model_coefficients) {
   std::vector<HloInstruction*> fusion_candidates;
   const HloComputation* computation = producer->parent();
   const HloModule* module = computation->parent();
@@ -180,7 +181,7 @@ std::vector<HloInstruction*> GetProducerConsumerMultiOutputFusionCandidates(
 
     GpuPerformanceModel::RunTimes t = GpuPerformanceModel::EstimateRunTimes(
         producer, cost_analysis, device_info, {consumer},
-        /*multi_output=*/true);
+        /*multi_output=*/true, performance_model_coefficients);
     if (t.time_fused > t.time_unfused) {
       dump_negative_explanation(FusionDecision{}
                                 << "will execute slower if fused");
@@ -354,7 +355,7 @@ StatusOr<bool> GpuMultiOutputFusion::DoMultiOutputFusion() {
     // traversal, and hence, not get into the way of subsequent fusion attempts.
     const auto candidates = GetProducerConsumerMultiOutputFusionCandidates(
         producer, *reachability_, &fusion_info_cache, &cost_analysis,
-        device_info_);
+        device_info_, performance_model_coefficients_);
     auto* consumer_for_fusion = SelectPreferredFusionCandidate(candidates);
     if (consumer_for_fusion == nullptr) {
       continue;
@@ -27,6 +27,7 @@ limitations under the License.
 #include "tensorflow/compiler/xla/service/gpu/gpu_device_info.h"
 #include "tensorflow/compiler/xla/service/gpu/gpu_fusible.h"
 #include "tensorflow/compiler/xla/service/gpu/gpu_hlo_cost_analysis.h"
+#include "tensorflow/compiler/xla/service/gpu/gpu_performance_model.h"
 #include "tensorflow/compiler/xla/service/hlo_pass_interface.h"
 #include "tensorflow/compiler/xla/statusor.h"
 
@@ -94,8 +95,12 @@ namespace gpu {
 class GpuMultiOutputFusion : public HloModulePass {
  public:
   explicit GpuMultiOutputFusion(const GpuDeviceInfo& d,
-                                HloCostAnalysis::ShapeSizeFunction f)
-      : device_info_(d), shape_size_function_(f) {}
+                                HloCostAnalysis::ShapeSizeFunction f,
+                                const GpuPerformanceModelCoefficients& c =
+                                    GpuPerformanceModelCoefficients())
+      : device_info_(d),
+        shape_size_function_(f),
+        performance_model_coefficients_(c) {}
 
   absl::string_view name() const override { return "multi_output_fusion"; }
 
@@ -124,6 +129,7 @@ class GpuMultiOutputFusion : public HloModulePass {
 
   const GpuDeviceInfo device_info_;
   HloCostAnalysis::ShapeSizeFunction shape_size_function_;
+  const GpuPerformanceModelCoefficients performance_model_coefficients_;
 };
 
 }  // namespace gpu
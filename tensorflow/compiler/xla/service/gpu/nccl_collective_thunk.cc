@@ -56,6 +56,12 @@ bool IsTypeSupportedByNccl(PrimitiveType element_type,
       // be implicitly converted into other 16-bit types like ncclFloat16 as
       // they involve actual computation and not just data movement.
       return !IsReductionCollective(reduction_op);
+    case F8E5M2:
+    case F8E4M3FN:
+    case F8E4M3B11FNUZ:
+      // FP8 data is moved as 8-bit integers, which is only correct for the
+      // collectives that do not reduce.
+      return !IsReductionCollective(reduction_op);
     default:
       return false;
   }
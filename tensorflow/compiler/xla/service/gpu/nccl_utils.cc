@@ -105,6 +105,16 @@ StatusOr<ncclDataType_t> ToNcclDataType(PrimitiveType element_type,
       // For collectives that just move data around, we can use ncclFloat16 for
       // 16-bit integer data types.
       return ncclFloat16;
+    case F8E5M2:
+    case F8E4M3FN:
+    case F8E4M3B11FNUZ:
+      // There are no FP8 reductions in NCCL, but the collectives that just
+      // move data around can use ncclUint8.
+      if (IsReductionCollective(reduction_op)) {
+        return tsl::errors::InvalidArgument(absl::StrFormat(
+            "Unsupported data type: %s", PrimitiveType_Name(element_type)));
+      }
+      return ncclUint8;
 #if defined(__CUDA_BF16_TYPES_EXIST__)
     case BF16:
       return ncclBfloat16;
@@ -0,0 +1,271 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/service/gpu/pgle_profile_converter.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow/compiler/xla/hlo/ir/hlo_computation.h"
+#include "tensorflow/compiler/xla/hlo/ir/hlo_instruction.h"
+#include "tensorflow/compiler/xla/service/llvm_ir/llvm_util.h"
+#include "tensorflow/compiler/xla/util.h"
+#include "tensorflow/tsl/platform/logging.h"
+#include "tensorflow/tsl/profiler/utils/tf_xplane_visitor.h"
+#include "tensorflow/tsl/profiler/utils/xplane_schema.h"
+#include "tensorflow/tsl/profiler/utils/xplane_utils.h"
+#include "tensorflow/tsl/profiler/utils/xplane_visitor.h"
+
+namespace xla {
+namespace gpu {
+
+PgleProfileBuilder::PgleProfileBuilder(const HloModule* module)
+    : module_(module) {
+  if (module_ == nullptr) return;
+  for (const HloComputation* computation : module_->computations()) {
+    if (computation->IsFusionComputation()) continue;
+    for (const HloInstruction* instr : computation->instructions()) {
+      instructions_.insert(instr->name());
+      kernel_to_instruction_.emplace(
+          llvm_ir::SanitizeFunctionName(instr->name()), instr->name());
+    }
+  }
+}
+
+void PgleProfileBuilder::AddExecution(absl::string_view name,
+                                      double duration_us) {
+  if (module_ != nullptr && !instructions_.contains(name)) {
+    VLOG(3) << "Skipping " << name << ", which is not in " << module_->name();
+    return;
+  }
+  Executions& executions = executions_[std::string(name)];
+  executions.total_us += duration_us;
+  ++executions.count;
+}
+
+std::string PgleProfileBuilder::InstructionForKernel(
+    absl::string_view kernel_name) const {
+  CHECK(module_ != nullptr);
+  // rocprof prints code objects with a ".kd" suffix, and sometimes appends the
+  // argument list.
+  kernel_name = kernel_name.substr(0, kernel_name.find_first_of("( "));
+  absl::ConsumeSuffix(&kernel_name, ".kd");
+  if (auto it = kernel_to_instruction_.find(kernel_name);
+      it != kernel_to_instruction_.end()) {
+    return it->second;
+  }
+  // The second and later kernels of an instruction are uniquified with a
+  // numeric suffix, e.g. fusion_3_1 for fusion.3.
+  size_t separator = kernel_name.find_last_of('_');
+  int64_t unused;
+  if (separator != absl::string_view::npos &&
+      absl::SimpleAtoi(kernel_name.substr(separator + 1), &unused)) {
+    if (auto it =
+            kernel_to_instruction_.find(kernel_name.substr(0, separator));
+        it != kernel_to_instruction_.end()) {
+      return it->second;
+    }
+  }
+  return "";
+}
+
+ProfiledInstructionsProto PgleProfileBuilder::Build() const {
+  ProfiledInstructionsProto profile;
+  for (const auto& [name, executions] : executions_) {
+    ProfiledInstructionsProto::InstructionCost* cost = profile.add_costs();
+    cost->set_name(name);
+    cost->set_cost_us(executions.total_us / executions.count);
+  }
+  return profile;
+}
+
+StatusOr<ProfiledInstructionsProto> ConvertXSpaceToProfiledInstructions(
+    const tensorflow::profiler::XSpace& space, const HloModule* module) {
+  PgleProfileBuilder builder(module);
+  std::vector<const tensorflow::profiler::XPlane*> planes =
+      tsl::profiler::FindPlanesWithPrefix(space,
+                                          tsl::profiler::kGpuPlanePrefix);
+  if (planes.empty()) {
+    return InvalidArgument("The trace has no GPU device planes.");
+  }
+
+  struct Kernel {
+    int64_t timestamp_ps;
+    int64_t duration_ps;
+    std::string hlo_op;
+  };
+  for (const tensorflow::profiler::XPlane* plane : planes) {
+    tsl::profiler::XPlaneVisitor visitor =
+        tsl::profiler::CreateTfXPlaneVisitor(plane);
+    visitor.ForEachLine([&](const tsl::profiler::XLineVisitor& line) {
+      std::vector<Kernel> kernels;
+      line.ForEachEvent([&](const tsl::profiler::XEventVisitor& event) {
+        std::optional<tsl::profiler::XStatVisitor> hlo_op =
+            event.GetStat(tsl::profiler::StatType::kHloOp);
+        if (!hlo_op.has_value()) return;
+        if (module != nullptr) {
+          std::optional<tsl::profiler::XStatVisitor> hlo_module =
+              event.GetStat(tsl::profiler::StatType::kHloModule);
+          if (hlo_module.has_value() &&
+              hlo_module->StrOrRefValue() != module->name()) {
+            return;
+          }
+        }
+        kernels.push_back({event.TimestampPs(), event.DurationPs(),
+                           std::string(hlo_op->StrOrRefValue())});
+      });
+      std::sort(kernels.begin(), kernels.end(),
+                [](const Kernel& a, const Kernel& b) {
+                  return a.timestamp_ps < b.timestamp_ps;
+                });
+      // An instruction may launch several kernels (e.g. a reduction and its
+      // initialization), which run back to back on its stream.
+      for (size_t i = 0; i < kernels.size();) {
+        int64_t duration_ps = 0;
+        size_t j = i;
+        for (; j < kernels.size() && kernels[j].hlo_op == kernels[i].hlo_op;
+             ++j) {
+          duration_ps += kernels[j].duration_ps;
+        }
+        builder.AddExecution(kernels[i].hlo_op, duration_ps / 1e6);
+        i = j;
+      }
+    });
+  }
+  if (builder.size() == 0) {
+    return InvalidArgument(
+        "The trace has no kernels annotated with HLO instructions%s.",
+        module == nullptr ? "" : " of " + module->name());
+  }
+  return builder.Build();
+}
+
+namespace {
+
+// Splits a CSV line, honouring double quotes (kernel names of libraries may
+// contain commas).
+std::vector<std::string> SplitCsvLine(absl::string_view line) {
+  std::vector<std::string> fields(1);
+  bool quoted = false;
+  for (size_t i = 0; i < line.size(); ++i) {
+    const char c = line[i];
+    if (c == '"') {
+      if (quoted && i + 1 < line.size() && line[i + 1] == '"') {
+        fields.back().push_back('"');
+        ++i;
+      } else {
+        quoted = !quoted;
+      }
+    } else if (c == ',' && !quoted) {
+      fields.emplace_back();
+    } else {
+      fields.back().push_back(c);
+    }
+  }
+  return fields;
+}
+
+}  // namespace
+
+StatusOr<ProfiledInstructionsProto> ConvertRocprofCsvToProfiledInstructions(
+    absl::string_view csv, const HloModule& module) {
+  std::vector<absl::string_view> lines =
+      absl::StrSplit(csv, '\n', absl::SkipWhitespace());
+  if (lines.empty()) {
+    return InvalidArgument("The rocprof trace is empty.");
+  }
+
+  std::vector<std::string> header = SplitCsvLine(lines[0]);
+  auto column = [&](absl::string_view name) -> std::optional<size_t> {
+    for (size_t i = 0; i < header.size(); ++i) {
+      if (absl::StripAsciiWhitespace(header[i]) == name) return i;
+    }
+    return std::nullopt;
+  };
+  std::optional<size_t> kernel_name = column("KernelName");
+  std::optional<size_t> duration = column("DurationNs");
+  std::optional<size_t> begin = column("BeginNs");
+  std::optional<size_t> end = column("EndNs");
+  if (!kernel_name.has_value() ||
+      !(duration.has_value() || (begin.has_value() && end.has_value()))) {
+    return InvalidArgument(
+        "Expected a KernelName column and either a DurationNs or BeginNs and "
+        "EndNs columns in the rocprof trace, got: %s",
+        lines[0]);
+  }
+
+  PgleProfileBuilder builder(&module);
+  std::optional<ProfiledInstructionsProto::InstructionCost> current;
+  auto flush = [&] {
+    if (current.has_value()) {
+      builder.AddExecution(current->name(), current->cost_us());
+      current.reset();
+    }
+  };
+  for (size_t i = 1; i < lines.size(); ++i) {
+    std::vector<std::string> fields = SplitCsvLine(lines[i]);
+    auto field = [&](size_t index) -> absl::string_view {
+      return index < fields.size() ? absl::StripAsciiWhitespace(fields[index])
+                                   : absl::string_view();
+    };
+    int64_t duration_ns;
+    if (duration.has_value()) {
+      if (!absl::SimpleAtoi(field(*duration), &duration_ns)) {
+        return InvalidArgument("Invalid DurationNs on line %d of the trace.",
+                               i + 1);
+      }
+    } else {
+      int64_t begin_ns, end_ns;
+      if (!absl::SimpleAtoi(field(*begin), &begin_ns) ||
+          !absl::SimpleAtoi(field(*end), &end_ns)) {
+        return InvalidArgument(
+            "Invalid BeginNs or EndNs on line %d of the trace.", i + 1);
+      }
+      duration_ns = end_ns - begin_ns;
+    }
+
+    std::string instruction = builder.InstructionForKernel(field(*kernel_name));
+    if (instruction.empty()) {
+      VLOG(3) << "Skipping kernel " << field(*kernel_name);
+      flush();
+      continue;
+    }
+    // Consecutive kernels of the same instruction count as one execution.
+    if (!current.has_value() || current->name() != instruction) {
+      flush();
+      current.emplace();
+      current->set_name(instruction);
+    }
+    current->set_cost_us(current->cost_us() + duration_ns / 1e3);
+  }
+  flush();
+  if (builder.size() == 0) {
+    return InvalidArgument(
+        "None of the kernels in the rocprof trace were emitted for %s.",
+        module.name());
+  }
+  return builder.Build();
+}
+
+}  // namespace gpu
+}  // namespace xla
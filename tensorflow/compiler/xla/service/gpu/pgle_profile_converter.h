@@ -0,0 +1,96 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_COMPILER_XLA_SERVICE_GPU_PGLE_PROFILE_CONVERTER_H_
+#define TENSORFLOW_COMPILER_XLA_SERVICE_GPU_PGLE_PROFILE_CONVERTER_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow/compiler/xla/hlo/ir/hlo_module.h"
+#include "tensorflow/compiler/xla/statusor.h"
+#include "tensorflow/compiler/xla/xla.pb.h"
+#include "tensorflow/tsl/profiler/protobuf/xplane.pb.h"
+
+namespace xla {
+namespace gpu {
+
+// Builds the ProfiledInstructionsProto consumed by
+// ProfileGuidedLatencyEstimator (see
+// --xla_gpu_pgle_profile_file_or_directory_path) from device traces of an XLA
+// GPU executable.
+//
+// The cost of an instruction is the device time of the kernels it launches,
+// averaged over all of its executions in the trace. For async collectives the
+// cost of the start instruction is the time of the collective kernel, which
+// the estimator uses as the latency between the start and the done.
+class PgleProfileBuilder {
+ public:
+  // If `module` is not null, only records instructions of `module`.
+  explicit PgleProfileBuilder(const HloModule* module = nullptr);
+
+  // Records one execution of the instruction `name`, whose kernels took
+  // `duration_us` of device time.
+  void AddExecution(absl::string_view name, double duration_us);
+
+  // Resolves a kernel name, as printed by rocprof, to the name of the
+  // instruction that launched it. Returns an empty string if the kernel was
+  // not emitted by XLA for `module`. Requires a module.
+  std::string InstructionForKernel(absl::string_view kernel_name) const;
+
+  // Returns the number of distinct instructions recorded.
+  int64_t size() const { return static_cast<int64_t>(executions_.size()); }
+
+  ProfiledInstructionsProto Build() const;
+
+ private:
+  struct Executions {
+    double total_us = 0;
+    int64_t count = 0;
+  };
+
+  const HloModule* module_;
+  absl::flat_hash_set<std::string> instructions_;
+  // Sanitized (kernel) name to instruction name, for the instructions of
+  // `module_`.
+  absl::flat_hash_map<std::string, std::string> kernel_to_instruction_;
+  // Ordered, so that the profile is deterministic.
+  std::map<std::string, Executions> executions_;
+};
+
+// Converts an XSpace collected by the profiler while running `module`, e.g.
+// with the ROCm device tracer. Kernels are attributed to instructions by the
+// `hlo_op` annotation XLA attaches to each thunk. Consecutive kernels of the
+// same instruction on a stream count as one execution. If `module` is null,
+// all annotated kernels are recorded.
+StatusOr<ProfiledInstructionsProto> ConvertXSpaceToProfiledInstructions(
+    const tensorflow::profiler::XSpace& space, const HloModule* module);
+
+// Converts the kernel trace written by `rocprof --hip-trace` or
+// `rocprof --stats --timestamp on` (results.csv), which has a KernelName
+// column and either BeginNs/EndNs or DurationNs columns. Kernels are
+// attributed to instructions of `module` by name; library kernels (rocBLAS,
+// MIOpen, RCCL) carry no instruction name and are skipped.
+StatusOr<ProfiledInstructionsProto> ConvertRocprofCsvToProfiledInstructions(
+    absl::string_view csv, const HloModule& module);
+
+}  // namespace gpu
+}  // namespace xla
+
+#endif  // TENSORFLOW_COMPILER_XLA_SERVICE_GPU_PGLE_PROFILE_CONVERTER_H_
@@ -0,0 +1,153 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Converts a device trace of an XLA GPU executable into a profile for the
+// profile guided latency estimator. See kUsage for details.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "tensorflow/compiler/xla/hlo/ir/hlo_module.h"
+#include "tensorflow/compiler/xla/service/gpu/gpu_hlo_schedule.h"
+#include "tensorflow/compiler/xla/service/gpu/pgle_profile_converter.h"
+#include "tensorflow/compiler/xla/status_macros.h"
+#include "tensorflow/compiler/xla/tools/hlo_module_loader.h"
+#include "tensorflow/compiler/xla/util.h"
+#include "tensorflow/compiler/xla/xla.pb.h"
+#include "tensorflow/tsl/platform/env.h"
+#include "tensorflow/tsl/platform/init_main.h"
+#include "tensorflow/tsl/platform/logging.h"
+#include "tensorflow/tsl/platform/statusor.h"
+#include "tensorflow/tsl/profiler/protobuf/xplane.pb.h"
+#include "tensorflow/tsl/util/command_line_flags.h"
+
+namespace xla {
+namespace gpu {
+namespace {
+
+const char* const kUsage = R"(
+This tool converts a device trace of an XLA GPU program into the profile read
+by --xla_gpu_pgle_profile_file_or_directory_path, so that the latency hiding
+scheduler uses measured instruction costs and collective latencies instead of
+generic estimates.
+
+The trace is either
+  - an XSpace (*.xplane.pb) collected by the TensorFlow / JAX profiler, whose
+    kernels are annotated with the HLO instructions that launched them, or
+  - a rocprof kernel trace (results.csv), collected with
+      rocprof --hip-trace python train.py
+    which needs --hlo_module to map kernel names back to instructions. Only
+    kernels emitted by XLA are attributed; library calls are skipped.
+
+--hlo_module is the optimized module, as dumped by
+--xla_dump_to=<dir> --xla_dump_hlo_as_text (the *after_optimizations.txt
+file). If --output is a directory, the profile is written to
+<output>/<fingerprint>.pbtxt, which is where the compiler looks for the
+profile of this module:
+
+  pgle_profile_converter_main --trace=results.csv \
+    --hlo_module=module_0001.jit_step.after_optimizations.txt \
+    --output=/tmp/pgle
+  XLA_FLAGS=--xla_gpu_pgle_profile_file_or_directory_path=/tmp/pgle \
+    python train.py
+)";
+
+Status RealMain(const std::string& trace_path,
+                const std::string& hlo_module_path,
+                const std::string& output_path) {
+  std::unique_ptr<HloModule> module;
+  if (!hlo_module_path.empty()) {
+    TF_ASSIGN_OR_RETURN(module, LoadModuleFromFile(hlo_module_path));
+  }
+
+  ProfiledInstructionsProto profile;
+  if (absl::EndsWith(trace_path, ".csv")) {
+    if (module == nullptr) {
+      return InvalidArgument("Converting a rocprof trace needs --hlo_module.");
+    }
+    std::string csv;
+    TF_RETURN_IF_ERROR(
+        tsl::ReadFileToString(tsl::Env::Default(), trace_path, &csv));
+    TF_ASSIGN_OR_RETURN(profile,
+                        ConvertRocprofCsvToProfiledInstructions(csv, *module));
+  } else {
+    tensorflow::profiler::XSpace space;
+    TF_RETURN_IF_ERROR(
+        tsl::ReadBinaryProto(tsl::Env::Default(), trace_path, &space));
+    TF_ASSIGN_OR_RETURN(
+        profile, ConvertXSpaceToProfiledInstructions(space, module.get()));
+  }
+
+  std::string path = output_path;
+  if (tsl::Env::Default()->IsDirectory(output_path).ok()) {
+    std::string fingerprint;
+    if (module != nullptr) {
+      const auto& attributes = module->entry_computation()
+                                   ->root_instruction()
+                                   ->frontend_attributes()
+                                   .map();
+      if (auto it = attributes.find(std::string(kFingerprintBeforeLHS));
+          it != attributes.end()) {
+        fingerprint = it->second;
+      }
+    }
+    if (fingerprint.empty()) {
+      return InvalidArgument(
+          "Writing to a directory needs an --hlo_module with a %s attribute.",
+          kFingerprintBeforeLHS);
+    }
+    path = absl::StrCat(output_path, "/", fingerprint, ".pbtxt");
+  }
+  TF_RETURN_IF_ERROR(tsl::WriteTextProto(tsl::Env::Default(), path, profile));
+  LOG(INFO) << "Wrote the costs of " << profile.costs_size()
+            << " instructions to " << path;
+  return OkStatus();
+}
+
+}  // namespace
+}  // namespace gpu
+}  // namespace xla
+
+int main(int argc, char** argv) {
+  std::string trace_path;
+  std::string hlo_module_path;
+  std::string output_path;
+  std::vector<tsl::Flag> flag_list = {
+      tsl::Flag("trace", &trace_path,
+                "An XSpace (.xplane.pb) or rocprof kernel trace (.csv)."),
+      tsl::Flag("hlo_module", &hlo_module_path,
+                "The optimized HLO module the trace was collected for."),
+      tsl::Flag("output", &output_path,
+                "The profile to write, or the directory to write it to."),
+  };
+  const std::string usage =
+      absl::StrCat(xla::gpu::kUsage, tsl::Flags::Usage(argv[0], flag_list));
+  bool parse_ok = tsl::Flags::Parse(&argc, argv, flag_list);
+  tsl::port::InitMain(usage.c_str(), &argc, &argv);
+  if (!parse_ok || trace_path.empty() || output_path.empty()) {
+    LOG(QFATAL) << usage;
+  }
+
+  xla::Status status =
+      xla::gpu::RealMain(trace_path, hlo_module_path, output_path);
+  if (!status.ok()) {
+    LOG(ERROR) << status;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,152 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/service/gpu/pgle_profile_converter.h"
+
+#include <cstdint>
+#include <memory>
+
+#include "absl/strings/string_view.h"
+#include "tensorflow/compiler/xla/tests/hlo_test_base.h"
+#include "tensorflow/compiler/xla/xla.pb.h"
+#include "tensorflow/tsl/platform/status_matchers.h"
+#include "tensorflow/tsl/platform/statusor.h"
+#include "tensorflow/tsl/platform/test.h"
+#include "tensorflow/tsl/profiler/protobuf/xplane.pb.h"
+#include "tensorflow/tsl/profiler/utils/xplane_builder.h"
+#include "tensorflow/tsl/profiler/utils/xplane_schema.h"
+#include "tensorflow/tsl/profiler/utils/xplane_test_utils.h"
+
+namespace xla {
+namespace gpu {
+namespace {
+
+using ::tsl::testing::StatusIs;
+
+constexpr char kHlo[] = R"(
+HloModule module
+
+ENTRY main {
+  p0 = f32[1024] parameter(0)
+  fusion.1 = f32[1024] exponential(p0)
+  all-reduce-start.2 = f32[1024] all-reduce-start(fusion.1), to_apply=add
+  all-reduce-done.3 = f32[1024] all-reduce-done(all-reduce-start.2)
+  ROOT fusion.4 = f32[1024] negate(all-reduce-done.3)
+}
+
+add {
+  lhs = f32[] parameter(0)
+  rhs = f32[] parameter(1)
+  ROOT add = f32[] add(lhs, rhs)
+}
+)";
+
+class PgleProfileConverterTest : public HloTestBase {
+ protected:
+  void SetUp() override {
+    HloTestBase::SetUp();
+    TF_ASSERT_OK_AND_ASSIGN(module_, ParseAndReturnVerifiedModule(kHlo));
+  }
+
+  // Returns the cost of `name` in `profile`, or -1.
+  static double CostOf(const ProfiledInstructionsProto& profile,
+                       absl::string_view name) {
+    for (const auto& cost : profile.costs()) {
+      if (cost.name() == name) return cost.cost_us();
+    }
+    return -1;
+  }
+
+  std::unique_ptr<HloModule> module_;
+};
+
+TEST_F(PgleProfileConverterTest, ConvertsRocprofTraceWithTimestamps) {
+  // Two executions; fusion.1 launches two kernels. The rocBLAS kernel is not
+  // attributed to any instruction.
+  constexpr char kCsv[] = R"(Index,KernelName,gpu-id,BeginNs,EndNs
+0,"fusion_1.kd",0,1000,3000
+1,"fusion_1_1.kd",0,3000,4000
+2,"Cijk_Alik_Bljk_SB_MT64x64x16(float*, float const*)",0,4000,9000
+3,"fusion_4.kd",0,9000,10000
+4,"fusion_1.kd",0,20000,24000
+5,"fusion_1_1.kd",0,24000,25000
+6,"fusion_4.kd",0,25000,28000
+)";
+  TF_ASSERT_OK_AND_ASSIGN(
+      ProfiledInstructionsProto profile,
+      ConvertRocprofCsvToProfiledInstructions(kCsv, *module_));
+  EXPECT_EQ(profile.costs_size(), 2);
+  EXPECT_DOUBLE_EQ(CostOf(profile, "fusion.1"), 4.0);
+  EXPECT_DOUBLE_EQ(CostOf(profile, "fusion.4"), 2.0);
+}
+
+TEST_F(PgleProfileConverterTest, ConvertsRocprofTraceWithDurations) {
+  constexpr char kCsv[] = R"("KernelName","DurationNs"
+"fusion_4",1500
+)";
+  TF_ASSERT_OK_AND_ASSIGN(
+      ProfiledInstructionsProto profile,
+      ConvertRocprofCsvToProfiledInstructions(kCsv, *module_));
+  EXPECT_EQ(profile.costs_size(), 1);
+  EXPECT_DOUBLE_EQ(CostOf(profile, "fusion.4"), 1.5);
+}
+
+TEST_F(PgleProfileConverterTest, RejectsRocprofTraceWithoutTimes) {
+  EXPECT_THAT(ConvertRocprofCsvToProfiledInstructions(
+                  "Index,KernelName\n0,fusion_1\n", *module_),
+              StatusIs(tsl::error::INVALID_ARGUMENT));
+}
+
+TEST_F(PgleProfileConverterTest, ConvertsXSpace) {
+  using ::tsl::profiler::StatType;
+  tensorflow::profiler::XSpace space;
+  tsl::profiler::XPlaneBuilder plane(
+      tsl::profiler::GetOrCreateGpuXPlane(&space, /*device_ordinal=*/0));
+  tsl::profiler::XLineBuilder compute_stream = plane.GetOrCreateLine(0);
+  tsl::profiler::XLineBuilder comms_stream = plane.GetOrCreateLine(1);
+  auto kernel = [&](tsl::profiler::XLineBuilder& line,
+                    absl::string_view hlo_op, absl::string_view hlo_module,
+                    int64_t offset_us, int64_t duration_us) {
+    tsl::profiler::CreateXEvent(&plane, &line, "kernel", offset_us * 1000000,
+                                duration_us * 1000000,
+                                {{StatType::kHloOp, hlo_op},
+                                 {StatType::kHloModule, hlo_module}});
+  };
+  kernel(compute_stream, "fusion.1", "module", 0, 3);
+  kernel(compute_stream, "fusion.1", "module", 3, 2);
+  kernel(comms_stream, "all-reduce-start.2", "module", 5, 40);
+  kernel(compute_stream, "fusion.4", "module", 45, 1);
+  // Another module that happens to have instructions of the same name.
+  kernel(compute_stream, "fusion.4", "other_module", 50, 100);
+  kernel(compute_stream, "fusion.1", "module", 200, 7);
+
+  TF_ASSERT_OK_AND_ASSIGN(ProfiledInstructionsProto profile,
+                          ConvertXSpaceToProfiledInstructions(space,
+                                                              module_.get()));
+  EXPECT_EQ(profile.costs_size(), 3);
+  EXPECT_DOUBLE_EQ(CostOf(profile, "fusion.1"), 6.0);
+  EXPECT_DOUBLE_EQ(CostOf(profile, "all-reduce-start.2"), 40.0);
+  EXPECT_DOUBLE_EQ(CostOf(profile, "fusion.4"), 1.0);
+}
+
+TEST_F(PgleProfileConverterTest, RejectsXSpaceWithoutGpuPlanes) {
+  tensorflow::profiler::XSpace space;
+  EXPECT_THAT(ConvertXSpaceToProfiledInstructions(space, module_.get()),
+              StatusIs(tsl::error::INVALID_ARGUMENT));
+}
+
+}  // namespace
+}  // namespace gpu
+}  // namespace xla
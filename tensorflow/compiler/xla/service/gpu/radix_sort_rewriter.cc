@@ -0,0 +1,209 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/service/gpu/radix_sort_rewriter.h"
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/str_format.h"
+#include "tensorflow/compiler/xla/comparison_util.h"
+#include "tensorflow/compiler/xla/hlo/ir/hlo_casting_utils.h"
+#include "tensorflow/compiler/xla/hlo/ir/hlo_computation.h"
+#include "tensorflow/compiler/xla/hlo/ir/hlo_instruction.h"
+#include "tensorflow/compiler/xla/hlo/ir/hlo_instructions.h"
+#include "tensorflow/compiler/xla/hlo/ir/hlo_opcode.h"
+#include "tensorflow/compiler/xla/layout_util.h"
+#include "tensorflow/compiler/xla/primitive_util.h"
+#include "tensorflow/compiler/xla/shape_util.h"
+#include "tensorflow/compiler/xla/xla_data.pb.h"
+#include "tensorflow/tsl/platform/errors.h"
+#include "tensorflow/tsl/platform/logging.h"
+
+namespace xla {
+namespace gpu {
+namespace {
+
+// The operand of a sort whose elements are the keys of the sort, and the order
+// of the keys.
+struct SortKeys {
+  int64_t operand;
+  bool descending;
+};
+
+bool IsSupportedKeyType(PrimitiveType type) {
+  switch (type) {
+    case S8:
+    case U8:
+    case S16:
+    case U16:
+    case S32:
+    case U32:
+    case S64:
+    case U64:
+    case F16:
+    case BF16:
+    case F32:
+    case F64:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool IsSupportedValueType(PrimitiveType type) {
+  if (!primitive_util::IsArrayType(type)) return false;
+  int bit_width = primitive_util::BitWidth(type);
+  return bit_width == 8 || bit_width == 16 || bit_width == 32 ||
+         bit_width == 64;
+}
+
+// Returns the keys of `sort` if its comparator is a single LT or GT
+// comparison of the elements of one operand.
+std::optional<SortKeys> MatchComparator(const HloSortInstruction* sort) {
+  const HloInstruction* root = sort->to_apply()->root_instruction();
+  if (root->opcode() != HloOpcode::kCompare) return std::nullopt;
+  const HloInstruction* lhs = root->operand(0);
+  const HloInstruction* rhs = root->operand(1);
+  if (lhs->opcode() != HloOpcode::kParameter ||
+      rhs->opcode() != HloOpcode::kParameter) {
+    return std::nullopt;
+  }
+  // Parameters 2 * i and 2 * i + 1 are two elements of operand i.
+  const int64_t lhs_number = lhs->parameter_number();
+  const int64_t rhs_number = rhs->parameter_number();
+  if (lhs_number / 2 != rhs_number / 2 || lhs_number == rhs_number) {
+    return std::nullopt;
+  }
+  const auto* compare = Cast<HloCompareInstruction>(root);
+  const ComparisonDirection direction = compare->direction();
+  if (direction != ComparisonDirection::kLt &&
+      direction != ComparisonDirection::kGt) {
+    return std::nullopt;
+  }
+  SortKeys keys;
+  keys.operand = lhs_number / 2;
+  const bool swapped = lhs_number % 2 == 1;
+  keys.descending = (direction == ComparisonDirection::kGt) != swapped;
+
+  const PrimitiveType key_type =
+      sort->operand(keys.operand)->shape().element_type();
+  if (!IsSupportedKeyType(key_type)) return std::nullopt;
+  if (primitive_util::IsFloatingPointType(key_type) &&
+      compare->order() != Comparison::Order::kTotal && sort->is_stable()) {
+    return std::nullopt;
+  }
+  return keys;
+}
+
+}  // namespace
+
+StatusOr<bool> RadixSortRewriter::Run(
+    HloModule* module,
+    const absl::flat_hash_set<absl::string_view>& execution_threads) {
+  bool changed = false;
+  for (HloComputation* computation :
+       module->MakeNonfusionComputations(execution_threads)) {
+    for (HloInstruction* instr : computation->MakeInstructionPostOrder()) {
+      auto* sort = DynCast<HloSortInstruction>(instr);
+      if (sort == nullptr || sort->operand_count() > 2) continue;
+      std::optional<SortKeys> keys = MatchComparator(sort);
+      if (!keys.has_value()) {
+        VLOG(2) << "Unsupported sort comparator: " << sort->ToString();
+        continue;
+      }
+
+      const HloInstruction* keys_operand = sort->operand(keys->operand);
+      const Shape& keys_shape = keys_operand->shape();
+      const int64_t dimension = sort->sort_dimension();
+      if (!LayoutUtil::HasLayout(keys_shape) ||
+          LayoutUtil::Minor(keys_shape.layout(), 0) != dimension) {
+        VLOG(2) << "Sort dimension is not the minor-most dimension: "
+                << sort->ToString();
+        continue;
+      }
+      bool same_layouts = true;
+      for (const HloInstruction* operand : sort->operands()) {
+        same_layouts &= LayoutUtil::LayoutsInShapesEqual(operand->shape(),
+                                                         keys_shape);
+      }
+      if (!same_layouts) continue;
+
+      const int64_t num_items = keys_shape.dimensions(dimension);
+      if (num_items < min_num_items_) continue;
+      const int64_t batch_size =
+          ShapeUtil::ElementsIn(keys_shape) / num_items;
+      if (num_items * batch_size > std::numeric_limits<int32_t>::max()) {
+        continue;
+      }
+
+      const HloInstruction* values_operand =
+          sort->operand_count() == 2 ? sort->operand(1 - keys->operand)
+                                     : nullptr;
+      PrimitiveType value_type = PRIMITIVE_TYPE_INVALID;
+      if (values_operand != nullptr) {
+        value_type = values_operand->shape().element_type();
+        if (!IsSupportedValueType(value_type)) continue;
+      }
+
+      StatusOr<int64_t> scratch_size =
+          scratch_size_(keys_shape.element_type(), value_type, num_items,
+                        batch_size, keys->descending);
+      if (!scratch_size.ok()) {
+        VLOG(2) << "Radix sort is not supported: " << scratch_size.status();
+        continue;
+      }
+
+      std::vector<HloInstruction*> operands = {
+          sort->mutable_operand(keys->operand)};
+      std::vector<Shape> shapes = {keys_shape};
+      if (values_operand != nullptr) {
+        operands.push_back(sort->mutable_operand(1 - keys->operand));
+        shapes.push_back(values_operand->shape());
+      }
+      shapes.push_back(ShapeUtil::MakeShape(U8, {*scratch_size}));
+      HloInstruction* radix_sort =
+          computation->AddInstruction(HloInstruction::CreateCustomCall(
+              ShapeUtil::MakeTupleShape(shapes), operands,
+              kRadixSortCallTarget,
+              absl::StrFormat("{descending = %s, dimension = %d : i64}",
+                              keys->descending ? "true" : "false", dimension),
+              CustomCallApiVersion::API_VERSION_TYPED_FFI));
+      radix_sort->set_metadata(sort->metadata());
+
+      HloInstruction* sorted_keys = computation->AddInstruction(
+          HloInstruction::CreateGetTupleElement(radix_sort, 0));
+      HloInstruction* replacement = sorted_keys;
+      if (values_operand != nullptr) {
+        HloInstruction* sorted_values = computation->AddInstruction(
+            HloInstruction::CreateGetTupleElement(radix_sort, 1));
+        replacement = computation->AddInstruction(
+            keys->operand == 0
+                ? HloInstruction::CreateTuple({sorted_keys, sorted_values})
+                : HloInstruction::CreateTuple({sorted_values, sorted_keys}));
+      }
+      TF_RETURN_IF_ERROR(computation->ReplaceInstruction(sort, replacement));
+      changed = true;
+    }
+  }
+  return changed;
+}
+
+}  // namespace gpu
+}  // namespace xla
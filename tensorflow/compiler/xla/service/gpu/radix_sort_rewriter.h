@@ -0,0 +1,82 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_COMPILER_XLA_SERVICE_GPU_RADIX_SORT_REWRITER_H_
+#define TENSORFLOW_COMPILER_XLA_SERVICE_GPU_RADIX_SORT_REWRITER_H_
+
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow/compiler/xla/hlo/ir/hlo_module.h"
+#include "tensorflow/compiler/xla/service/hlo_pass_interface.h"
+#include "tensorflow/compiler/xla/statusor.h"
+#include "tensorflow/compiler/xla/xla_data.pb.h"
+
+namespace xla {
+namespace gpu {
+
+// Custom call target of the radix sort in runtime/radix_sort.cc.
+inline constexpr absl::string_view kRadixSortCallTarget = "__gpu$RadixSort";
+
+// Rewrites sorts of keys, or of keys and values, whose comparator only
+// compares the keys with LT or GT into a kRadixSortCallTarget custom call:
+//
+//   (keys, [values], scratch) custom-call(keys, [values])
+//
+// A large bitonic sort needs a kernel launch per stage that does not fit in a
+// shared memory tile, while the radix sort makes a few passes over the data.
+// Sorts of fewer than `min_num_items` elements along the sort dimension are
+// left to the bitonic sort emitter.
+//
+// The keys are integers, or floating point numbers compared in their total
+// order (or in the partial order if the sort is not stable: a radix sort
+// orders -0 before +0, which the partial order considers equal). The values
+// have a width of 8, 16, 32 or 64 bits. The sort dimension is the minor-most
+// dimension of the layouts, so the pass runs after layout assignment.
+class RadixSortRewriter : public HloModulePass {
+ public:
+  // Returns the size of the scratch buffer of a sort of `batch_size` rows of
+  // `num_items` keys of `key_type`, with values of `value_type` unless it is
+  // PRIMITIVE_TYPE_INVALID.
+  using ScratchSizeFunction = std::function<StatusOr<int64_t>(
+      PrimitiveType key_type, PrimitiveType value_type, int64_t num_items,
+      int64_t batch_size, bool descending)>;
+
+  static constexpr int64_t kDefaultMinNumItems = 1 << 14;
+
+  explicit RadixSortRewriter(ScratchSizeFunction scratch_size,
+                             int64_t min_num_items = kDefaultMinNumItems)
+      : scratch_size_(std::move(scratch_size)),
+        min_num_items_(min_num_items) {}
+
+  absl::string_view name() const override { return "radix-sort-rewriter"; }
+
+  using HloPassInterface::Run;
+  StatusOr<bool> Run(
+      HloModule* module,
+      const absl::flat_hash_set<absl::string_view>& execution_threads) override;
+
+ private:
+  ScratchSizeFunction scratch_size_;
+  int64_t min_num_items_;
+};
+
+}  // namespace gpu
+}  // namespace xla
+
+#endif  // TENSORFLOW_COMPILER_XLA_SERVICE_GPU_RADIX_SORT_REWRITER_H_
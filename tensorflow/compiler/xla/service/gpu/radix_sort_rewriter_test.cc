@@ -0,0 +1,223 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/service/gpu/radix_sort_rewriter.h"
+
+#include <cstdint>
+#include <string>
+
+#include "absl/strings/string_view.h"
+#include "absl/strings/substitute.h"
+#include "tensorflow/compiler/xla/hlo/ir/hlo_instruction.h"
+#include "tensorflow/compiler/xla/service/pattern_matcher.h"
+#include "tensorflow/compiler/xla/shape_util.h"
+#include "tensorflow/compiler/xla/tests/hlo_test_base.h"
+#include "tensorflow/compiler/xla/xla_data.pb.h"
+#include "tensorflow/tsl/platform/status_matchers.h"
+#include "tensorflow/tsl/platform/statusor.h"
+#include "tensorflow/tsl/platform/test.h"
+
+namespace xla {
+namespace gpu {
+namespace {
+
+namespace m = ::xla::match;
+using ::tsl::testing::IsOkAndHolds;
+
+constexpr int64_t kScratchSize = 4096;
+
+class RadixSortRewriterTest : public HloTestBase {
+ protected:
+  RadixSortRewriter Rewriter() {
+    return RadixSortRewriter([](PrimitiveType, PrimitiveType, int64_t,
+                                int64_t, bool) -> StatusOr<int64_t> {
+      return kScratchSize;
+    });
+  }
+
+  // Returns a module sorting `shape` keys, and values of `values_shape` if it
+  // is not empty, with `comparator` as the root of the comparator.
+  std::string SortModule(absl::string_view shape,
+                         absl::string_view values_shape,
+                         absl::string_view comparator, bool is_stable = true,
+                         int64_t dimension = 0) {
+    std::string values_parameters;
+    std::string operands = "keys";
+    std::string result_shape(shape);
+    std::string values;
+    if (!values_shape.empty()) {
+      values_parameters = absl::Substitute(R"(
+  lhs_value = $0[] parameter(2)
+  rhs_value = $0[] parameter(3))",
+                                           values_shape.substr(0, 3));
+      values = absl::Substitute("\n  values = $0 parameter(1)", values_shape);
+      operands = "keys, values";
+      result_shape = absl::Substitute("($0, $1)", shape, values_shape);
+    }
+    return absl::Substitute(R"(
+HloModule sort
+
+compare {
+  lhs = $0[] parameter(0)
+  rhs = $0[] parameter(1)$1
+  ROOT compare = pred[] $2
+}
+
+ENTRY main {
+  keys = $3 parameter(0)$4
+  ROOT sort = $5 sort($6), dimensions={$7}, is_stable=$8, to_apply=compare
+})",
+                            shape.substr(0, 3), values_parameters, comparator,
+                            shape, values, result_shape, operands, dimension,
+                            is_stable ? "true" : "false");
+  }
+};
+
+TEST_F(RadixSortRewriterTest, RewritesKeySort) {
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto module, ParseAndReturnVerifiedModule(SortModule(
+                       "s32[20000]", "", "compare(lhs, rhs), direction=LT")));
+  EXPECT_THAT(RunHloPass(Rewriter(), module.get()), IsOkAndHolds(true));
+
+  const HloInstruction* call;
+  ASSERT_TRUE(Match(module->entry_computation()->root_instruction(),
+                    m::GetTupleElement(
+                        m::CustomCall(&call, {kRadixSortCallTarget},
+                                      m::Parameter(0)),
+                        0)));
+  EXPECT_TRUE(ShapeUtil::Equal(call->shape().tuple_shapes(1),
+                               ShapeUtil::MakeShape(U8, {kScratchSize})));
+  EXPECT_EQ(call->raw_backend_config_string(),
+            "{descending = false, dimension = 0 : i64}");
+}
+
+TEST_F(RadixSortRewriterTest, RewritesKeyValueSortInDescendingOrder) {
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto module,
+      ParseAndReturnVerifiedModule(
+          SortModule("f32[8,20000]", "s32[8,20000]",
+                     "compare(lhs, rhs), direction=GT, type=TOTALORDER",
+                     /*is_stable=*/true, /*dimension=*/1)));
+  EXPECT_THAT(RunHloPass(Rewriter(), module.get()), IsOkAndHolds(true));
+
+  const HloInstruction* call;
+  ASSERT_TRUE(Match(
+      module->entry_computation()->root_instruction(),
+      m::Tuple(m::GetTupleElement(m::CustomCall(&call, {kRadixSortCallTarget},
+                                                m::Parameter(0),
+                                                m::Parameter(1)),
+                                  0),
+               m::GetTupleElement(m::CustomCall(), 1))));
+  EXPECT_EQ(call->raw_backend_config_string(),
+            "{descending = true, dimension = 1 : i64}");
+}
+
+TEST_F(RadixSortRewriterTest, RewritesSortOfValuesByKeysOfSecondOperand) {
+  // The keys are the second operand, and the swapped parameters of the LT
+  // comparison sort them in descending order.
+  const std::string hlo = R"(
+HloModule sort
+
+compare {
+  lhs_value = f16[] parameter(0)
+  rhs_value = f16[] parameter(1)
+  lhs = u16[] parameter(2)
+  rhs = u16[] parameter(3)
+  ROOT compare = pred[] compare(rhs, lhs), direction=LT
+}
+
+ENTRY main {
+  values = f16[20000] parameter(0)
+  keys = u16[20000] parameter(1)
+  ROOT sort = (f16[20000], u16[20000]) sort(values, keys), dimensions={0}, to_apply=compare
+})";
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(hlo));
+  EXPECT_THAT(RunHloPass(Rewriter(), module.get()), IsOkAndHolds(true));
+
+  const HloInstruction* call;
+  ASSERT_TRUE(Match(
+      module->entry_computation()->root_instruction(),
+      m::Tuple(m::GetTupleElement(m::CustomCall(&call, {kRadixSortCallTarget},
+                                                m::Parameter(1),
+                                                m::Parameter(0)),
+                                  1),
+               m::GetTupleElement(m::CustomCall(), 0))));
+  EXPECT_EQ(call->raw_backend_config_string(),
+            "{descending = true, dimension = 0 : i64}");
+}
+
+TEST_F(RadixSortRewriterTest, RewritesUnstableFloatSortInPartialOrder) {
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto module, ParseAndReturnVerifiedModule(
+                       SortModule("f32[20000]", "",
+                                  "compare(lhs, rhs), direction=LT",
+                                  /*is_stable=*/false)));
+  EXPECT_THAT(RunHloPass(Rewriter(), module.get()), IsOkAndHolds(true));
+}
+
+TEST_F(RadixSortRewriterTest, DoesNotRewriteStableFloatSortInPartialOrder) {
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto module, ParseAndReturnVerifiedModule(SortModule(
+                       "f32[20000]", "", "compare(lhs, rhs), direction=LT")));
+  EXPECT_THAT(RunHloPass(Rewriter(), module.get()), IsOkAndHolds(false));
+}
+
+TEST_F(RadixSortRewriterTest, DoesNotRewriteSmallSort) {
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto module, ParseAndReturnVerifiedModule(SortModule(
+                       "s32[8,1000]", "", "compare(lhs, rhs), direction=LT",
+                       /*is_stable=*/true, /*dimension=*/1)));
+  EXPECT_THAT(RunHloPass(Rewriter(), module.get()), IsOkAndHolds(false));
+}
+
+TEST_F(RadixSortRewriterTest, DoesNotRewriteSortOfMajorDimension) {
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto module, ParseAndReturnVerifiedModule(SortModule(
+                       "s32[20000,8]", "", "compare(lhs, rhs), direction=LT",
+                       /*is_stable=*/true, /*dimension=*/0)));
+  EXPECT_THAT(RunHloPass(Rewriter(), module.get()), IsOkAndHolds(false));
+}
+
+TEST_F(RadixSortRewriterTest, DoesNotRewriteEqualityComparator) {
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto module, ParseAndReturnVerifiedModule(SortModule(
+                       "s32[20000]", "", "compare(lhs, rhs), direction=LE")));
+  EXPECT_THAT(RunHloPass(Rewriter(), module.get()), IsOkAndHolds(false));
+}
+
+TEST_F(RadixSortRewriterTest, DoesNotRewriteComparatorOfBothOperands) {
+  const std::string hlo = R"(
+HloModule sort
+
+compare {
+  lhs = s32[] parameter(0)
+  rhs = s32[] parameter(1)
+  lhs_value = s32[] parameter(2)
+  rhs_value = s32[] parameter(3)
+  ROOT compare = pred[] compare(lhs, rhs_value), direction=LT
+}
+
+ENTRY main {
+  keys = s32[20000] parameter(0)
+  values = s32[20000] parameter(1)
+  ROOT sort = (s32[20000], s32[20000]) sort(keys, values), dimensions={0}, to_apply=compare
+})";
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(hlo));
+  EXPECT_THAT(RunHloPass(Rewriter(), module.get()), IsOkAndHolds(false));
+}
+
+}  // namespace
+}  // namespace gpu
+}  // namespace xla
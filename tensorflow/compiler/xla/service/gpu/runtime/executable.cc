@@ -34,10 +34,13 @@ limitations under the License.
 #include "tensorflow/compiler/xla/service/gpu/runtime/cublas_lt_matmul.h"
 #include "tensorflow/compiler/xla/service/gpu/runtime/custom_call.h"
 #include "tensorflow/compiler/xla/service/gpu/runtime/fft.h"
+#include "tensorflow/compiler/xla/service/gpu/runtime/fused_attention.h"
+#include "tensorflow/compiler/xla/service/gpu/runtime/host_offload.h"
 #include "tensorflow/compiler/xla/service/gpu/runtime/gemm.h"
 #include "tensorflow/compiler/xla/service/gpu/runtime/io_feed.h"
 #include "tensorflow/compiler/xla/service/gpu/runtime/memcpy.h"
 #include "tensorflow/compiler/xla/service/gpu/runtime/memset.h"
+#include "tensorflow/compiler/xla/service/gpu/runtime/radix_sort.h"
 #include "tensorflow/compiler/xla/service/gpu/runtime/send_recv.h"
 #include "tensorflow/compiler/xla/service/gpu/runtime/support.h"
 #include "tensorflow/compiler/xla/service/gpu/runtime/topk.h"
@@ -94,11 +97,17 @@ void RegisterXlaGpuRuntimeCustomCalls(DirectCustomCallRegistry& registry) {
   RegisterMemsetCustomCalls(registry);
   RegisterSendRecvCustomCalls(registry);
   RegisterTopkCustomCall(registry);
+  RegisterFusedAttentionCustomCalls(registry);
+  RegisterRadixSortCustomCalls(registry);
+  RegisterHostOffloadCustomCalls(registry);
 
-#if GOOGLE_CUDA
-  // Graph launch kernels depend on Cuda Graph API.
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+  // Graph launch kernels depend on Cuda Graph API (HIP Graph API on ROCm).
   RegisterGraphLaunchCustomCalls(registry);
   RegisterConcurrentRegionCustomCalls(registry);
+#endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+
+#if GOOGLE_CUDA
   RegisterMatmulCustomCalls(registry);
 #endif  // GOOGLE_CUDA
 
@@ -357,6 +366,16 @@ Status GpuRuntimeExecutable::Execute(
       async_comms_stream.ok() ? async_comms_stream->get() : nullptr);
   SendRecvEvents send_recv_events;
 
+  // Copies to and from host memory run on their own stream, so that they
+  // overlap with compute and with async collectives. Without one they are
+  // serialized with the compute stream.
+  StatusOr<StreamPool::Ptr> host_copy_stream =
+      run_options->BorrowStream(executor->device_ordinal());
+  HostOffloadSupport host_offload(host_copy_stream.ok()
+                                      ? host_copy_stream->get()
+                                      : run_options->stream(),
+                                  &host_offload_buffers_);
+
   // Always pass in the temp buffer, even if it is null, to accommodate the
   // 0-sized buffer corner case.
   se::DeviceMemoryBase temp_buffer;
@@ -368,12 +387,12 @@ Status GpuRuntimeExecutable::Execute(
   StreamExecutorConvRunners::Snapshot conv_runners =
       conv_runners_(executor)->snapshot();
 
-#if GOOGLE_CUDA
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
   StreamExecutorGraphInstances::Snapshot graph_instances =
       graph_instances_(executor)->snapshot();
   CapturedFunctionExecutionCount::Snapshot execution_count =
       captured_function_counts_(executor)->snapshot();
-#endif  // GOOGLE_CUDA
+#endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 
   // Kernels in concurrent regions should be launched on borrowed stream, so
   // that the cuda graph won't record dependencies between kernels.
@@ -400,9 +419,13 @@ Status GpuRuntimeExecutable::Execute(
       &collectives_, &fft_plans, &send_recv_events, &gpu_lock,
 #if GOOGLE_CUDA
       // Auxiliary data that is available only if compiled with CUDA support.
-      &matmul_plans, &graph_instances, &execution_count,
+      &matmul_plans,
 #endif  // GOOGLE_CUDA
-      &concurrent_region_status,
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+      // Graph instances are backed by CUDA graphs or HIP graphs.
+      &graph_instances, &execution_count,
+#endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+      &concurrent_region_status, &host_offload,
       // Null pointer will be interpreted as an absence of async collectives
       // support and custom calls will safely return an error.
       async_collectives.async_comm_stream() ? &async_collectives : nullptr);
@@ -0,0 +1,212 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/service/gpu/runtime/fused_attention.h"
+
+#include <cstdint>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "tensorflow/compiler/xla/runtime/custom_call.h"
+#include "tensorflow/compiler/xla/runtime/custom_call_registry.h"
+#include "tensorflow/compiler/xla/runtime/executable.h"
+#include "tensorflow/compiler/xla/service/gpu/runtime/fused_attention_kernel.h"
+#include "tensorflow/compiler/xla/service/gpu/runtime/support.h"
+#include "tensorflow/compiler/xla/service/service_executable_run_options.h"
+#include "tensorflow/compiler/xla/stream_executor/gpu/gpu_stream.h"
+#include "tensorflow/compiler/xla/xla_data.pb.h"
+#include "tensorflow/tsl/platform/statusor.h"
+
+namespace xla::gpu {
+namespace {
+
+using ::xla::runtime::CustomCall;
+using ::xla::runtime::StridedMemrefView;
+
+// Returns the next argument of the custom call, advancing `index`.
+absl::StatusOr<StridedMemrefView> NextArg(CustomCall::RemainingArgs& args,
+                                          int64_t& index) {
+  if (index >= args.size()) {
+    return absl::InvalidArgumentError("Missing fused attention argument");
+  }
+  auto arg = args.get<StridedMemrefView>(index++);
+  if (failed(arg)) {
+    return absl::InvalidArgumentError(
+        "Unsupported fused attention argument type");
+  }
+  return *arg;
+}
+
+absl::StatusOr<const bool*> NextMaskArg(CustomCall::RemainingArgs& args,
+                                        int64_t& index) {
+  TF_ASSIGN_OR_RETURN(StridedMemrefView mask, NextArg(args, index));
+  if (mask.dtype != PrimitiveType::PRED) {
+    return absl::InvalidArgumentError("Masks should be PRED");
+  }
+  return static_cast<const bool*>(mask.data);
+}
+
+// The arguments and attributes shared by the forward and backward custom
+// calls.
+struct FusedAttentionInputs {
+  FusedAttentionParams params;
+  PrimitiveType dtype;
+  PrimitiveType bias_type = PrimitiveType::PRIMITIVE_TYPE_INVALID;
+};
+
+// Reads the query, key, value, bias, mask and dropout mask arguments, which
+// come first in both custom calls.
+absl::StatusOr<FusedAttentionInputs> GetInputs(
+    CustomCall::RemainingArgs& args, int64_t& index, float scale,
+    bool has_bias, bool has_mask, float mask_value, bool has_dropout,
+    float dropout_scale, bool key_transposed, bool value_transposed) {
+  FusedAttentionInputs inputs;
+  FusedAttentionParams& params = inputs.params;
+  TF_ASSIGN_OR_RETURN(StridedMemrefView query, NextArg(args, index));
+  TF_ASSIGN_OR_RETURN(StridedMemrefView key, NextArg(args, index));
+  TF_ASSIGN_OR_RETURN(StridedMemrefView value, NextArg(args, index));
+  const int64_t rank = query.sizes.size();
+  if (rank < 2 || key.sizes.size() != rank || value.sizes.size() != rank) {
+    return absl::InvalidArgumentError("Invalid fused attention input shapes");
+  }
+  if (key.dtype != query.dtype || value.dtype != query.dtype) {
+    return absl::InvalidArgumentError(
+        "Query, key and value should have the same type");
+  }
+  inputs.dtype = query.dtype;
+  params.query = query.data;
+  params.key = key.data;
+  params.value = value.data;
+  params.batch = 1;
+  for (int64_t i = 0; i < rank - 2; ++i) params.batch *= query.sizes[i];
+  params.q_len = query.sizes[rank - 2];
+  params.head_dim = query.sizes[rank - 1];
+  params.kv_len = key.sizes[key_transposed ? rank - 1 : rank - 2];
+  params.value_dim = value.sizes[value_transposed ? rank - 2 : rank - 1];
+  params.key_transposed = key_transposed;
+  params.value_transposed = value_transposed;
+  params.scale = scale;
+
+  if (has_bias) {
+    TF_ASSIGN_OR_RETURN(StridedMemrefView bias, NextArg(args, index));
+    params.bias = bias.data;
+    inputs.bias_type = bias.dtype;
+  }
+  if (has_mask) {
+    TF_ASSIGN_OR_RETURN(params.mask, NextMaskArg(args, index));
+    params.mask_value = mask_value;
+  }
+  if (has_dropout) {
+    TF_ASSIGN_OR_RETURN(params.dropout_keep, NextMaskArg(args, index));
+    params.dropout_scale = dropout_scale;
+  }
+  return inputs;
+}
+
+absl::Status FusedAttentionImpl(const ServiceExecutableRunOptions* run_options,
+                                CustomCall::RemainingArgs args, float scale,
+                                bool has_bias, bool has_mask, float mask_value,
+                                bool has_dropout, float dropout_scale,
+                                bool key_transposed, bool value_transposed) {
+  int64_t index = 0;
+  TF_ASSIGN_OR_RETURN(
+      FusedAttentionInputs inputs,
+      GetInputs(args, index, scale, has_bias, has_mask, mask_value,
+                has_dropout, dropout_scale, key_transposed, value_transposed));
+  TF_ASSIGN_OR_RETURN(StridedMemrefView output, NextArg(args, index));
+  TF_ASSIGN_OR_RETURN(StridedMemrefView logsumexp, NextArg(args, index));
+  if (logsumexp.dtype != PrimitiveType::F32) {
+    return absl::InvalidArgumentError("Log-sum-exp should be F32");
+  }
+  inputs.params.output = output.data;
+  inputs.params.logsumexp = static_cast<float*>(logsumexp.data);
+  return RunFusedAttentionForward(
+      se::gpu::AsGpuStreamValue(run_options->stream()), inputs.dtype,
+      inputs.bias_type, inputs.params);
+}
+
+absl::Status FusedAttentionBackwardImpl(
+    const ServiceExecutableRunOptions* run_options,
+    CustomCall::RemainingArgs args, float scale, bool has_bias, bool has_mask,
+    float mask_value, bool has_dropout, float dropout_scale,
+    bool key_transposed, bool value_transposed) {
+  int64_t index = 0;
+  TF_ASSIGN_OR_RETURN(
+      FusedAttentionInputs inputs,
+      GetInputs(args, index, scale, has_bias, has_mask, mask_value,
+                has_dropout, dropout_scale, key_transposed, value_transposed));
+  FusedAttentionParams& params = inputs.params;
+  TF_ASSIGN_OR_RETURN(StridedMemrefView output, NextArg(args, index));
+  TF_ASSIGN_OR_RETURN(StridedMemrefView logsumexp, NextArg(args, index));
+  TF_ASSIGN_OR_RETURN(StridedMemrefView output_grad, NextArg(args, index));
+  TF_ASSIGN_OR_RETURN(StridedMemrefView query_grad, NextArg(args, index));
+  TF_ASSIGN_OR_RETURN(StridedMemrefView key_grad, NextArg(args, index));
+  TF_ASSIGN_OR_RETURN(StridedMemrefView value_grad, NextArg(args, index));
+  TF_ASSIGN_OR_RETURN(StridedMemrefView output_dot_grad, NextArg(args, index));
+  if (logsumexp.dtype != PrimitiveType::F32 ||
+      output_dot_grad.dtype != PrimitiveType::F32) {
+    return absl::InvalidArgumentError(
+        "Log-sum-exp and its scratch buffer should be F32");
+  }
+  params.output = output.data;
+  params.logsumexp = static_cast<float*>(logsumexp.data);
+  params.output_grad = output_grad.data;
+  params.query_grad = query_grad.data;
+  params.key_grad = key_grad.data;
+  params.value_grad = value_grad.data;
+  params.output_dot_grad = static_cast<float*>(output_dot_grad.data);
+  return RunFusedAttentionBackward(
+      se::gpu::AsGpuStreamValue(run_options->stream()), inputs.dtype,
+      inputs.bias_type, params);
+}
+
+}  // namespace
+
+XLA_RUNTIME_DEFINE_CUSTOM_CALL(
+    FusedAttention, FunctionWrapper<FusedAttentionImpl>(), checks,
+    CustomCall::Bind("__gpu$FusedAttention")
+        .UserData<const ServiceExecutableRunOptions*>()
+        .RemainingArgs()  // inputs, output, logsumexp
+        .Attr<float>("scale")
+        .Attr<bool>("has_bias")
+        .Attr<bool>("has_mask")
+        .Attr<float>("mask_value")
+        .Attr<bool>("has_dropout")
+        .Attr<float>("dropout_scale")
+        .Attr<bool>("key_transposed")
+        .Attr<bool>("value_transposed"));
+
+XLA_RUNTIME_DEFINE_CUSTOM_CALL(
+    FusedAttentionBackward, FunctionWrapper<FusedAttentionBackwardImpl>(),
+    checks,
+    CustomCall::Bind("__gpu$FusedAttentionBackward")
+        .UserData<const ServiceExecutableRunOptions*>()
+        .RemainingArgs()  // inputs, output, logsumexp, output_grad, gradients
+        .Attr<float>("scale")
+        .Attr<bool>("has_bias")
+        .Attr<bool>("has_mask")
+        .Attr<float>("mask_value")
+        .Attr<bool>("has_dropout")
+        .Attr<float>("dropout_scale")
+        .Attr<bool>("key_transposed")
+        .Attr<bool>("value_transposed"));
+
+void RegisterFusedAttentionCustomCalls(
+    runtime::DirectCustomCallRegistry& registry) {
+  registry.Register("__gpu$FusedAttention", FusedAttention);
+  registry.Register("__gpu$FusedAttentionBackward", FusedAttentionBackward);
+}
+
+}  // namespace xla::gpu
@@ -0,0 +1,170 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/service/gpu/runtime/fused_attention_kernel.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "third_party/eigen3/Eigen/Core"
+#include "tensorflow/compiler/xla/primitive_util.h"
+#include "tensorflow/compiler/xla/service/gpu/runtime/fused_attention_kernel_common.h"
+#include "tensorflow/compiler/xla/stream_executor/gpu/gpu_types.h"
+#include "tensorflow/compiler/xla/xla_data.pb.h"
+#include "tensorflow/tsl/platform/logging.h"
+#include "tensorflow/tsl/platform/statusor.h"
+
+#if !TENSORFLOW_USE_ROCM
+#include "third_party/gpus/cuda/include/cuda_runtime_api.h"
+#endif
+
+namespace xla::gpu {
+namespace {
+
+using ::stream_executor::gpu::GpuStreamHandle;
+
+// The largest grid y dimension, which indexes the batch.
+constexpr int64_t kMaxBatch = 65535;
+
+struct FusedAttentionKernels {
+  void* forward;
+  void* backward_preprocess;
+  void* backward_key_value;
+  void* backward_query;
+};
+
+template <typename T, typename TBias, int kHeadDim>
+FusedAttentionKernels GetKernelsForHeadDim() {
+  return {GetFusedAttentionForwardKernel<T, TBias, kHeadDim>(),
+          GetFusedAttentionBackwardPreprocessKernel<T>(),
+          GetFusedAttentionBackwardKeyValueKernel<T, TBias, kHeadDim>(),
+          GetFusedAttentionBackwardQueryKernel<T, TBias, kHeadDim>()};
+}
+
+template <typename T, typename TBias>
+absl::StatusOr<FusedAttentionKernels> GetKernelsForBias(int64_t head_dim) {
+  if (head_dim <= 32) return GetKernelsForHeadDim<T, TBias, 32>();
+  if (head_dim <= 64) return GetKernelsForHeadDim<T, TBias, 64>();
+  if (head_dim <= 128) return GetKernelsForHeadDim<T, TBias, 128>();
+  return absl::UnimplementedError(
+      absl::StrCat("Unsupported head dimension: ", head_dim));
+}
+
+template <typename T>
+absl::StatusOr<FusedAttentionKernels> GetKernelsForType(
+    PrimitiveType bias_type, int64_t head_dim) {
+  if (bias_type == PrimitiveType::F32) {
+    return GetKernelsForBias<T, float>(head_dim);
+  }
+  return GetKernelsForBias<T, T>(head_dim);
+}
+
+absl::StatusOr<FusedAttentionKernels> GetKernels(
+    PrimitiveType dtype, PrimitiveType bias_type,
+    const FusedAttentionParams& params) {
+  if (params.bias != nullptr && bias_type != dtype &&
+      bias_type != PrimitiveType::F32) {
+    return absl::UnimplementedError(absl::StrCat(
+        "Unsupported bias type: ",
+        primitive_util::LowercasePrimitiveTypeName(bias_type)));
+  }
+  if (params.batch > kMaxBatch) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Batch too large (", params.batch, ")"));
+  }
+  const int64_t head_dim = std::max(params.head_dim, params.value_dim);
+  switch (dtype) {
+    case PrimitiveType::F16:
+      return GetKernelsForType<Eigen::half>(bias_type, head_dim);
+    case PrimitiveType::BF16:
+      return GetKernelsForType<Eigen::bfloat16>(bias_type, head_dim);
+    case PrimitiveType::F32:
+      return GetKernelsForBias<float, float>(head_dim);
+    default:
+      return absl::UnimplementedError(
+          "Fused attention not implemented for this dtype");
+  }
+}
+
+// Launches `kernel` with one thread per row, for `num_rows` rows in each of
+// `num_batches` batches.
+absl::Status Launch(GpuStreamHandle stream, void* kernel, int64_t num_rows,
+                    int64_t num_batches, FusedAttentionParams params) {
+  dim3 blocks((num_rows + kFusedAttentionBlockSize - 1) /
+                  kFusedAttentionBlockSize,
+              num_batches);
+  void* kernel_args[] = {&params};
+#if TENSORFLOW_USE_ROCM
+  hipError_t launch_status =
+      hipLaunchKernel(kernel, blocks, kFusedAttentionBlockSize, kernel_args,
+                      /*sharedMemBytes=*/0, stream);
+  if (launch_status != hipSuccess) {
+    return absl::InternalError(absl::StrCat("Failed to launch kernel: ",
+                                            hipGetErrorString(launch_status)));
+  }
+#else
+  cudaError_t launch_status =
+      cudaLaunchKernel(kernel, blocks, kFusedAttentionBlockSize, kernel_args,
+                       /*sharedMem=*/0, stream);
+  if (launch_status != cudaSuccess) {
+    return absl::InternalError(absl::StrCat("Failed to launch kernel: ",
+                                            cudaGetErrorString(launch_status)));
+  }
+#endif
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+absl::Status RunFusedAttentionForward(GpuStreamHandle stream,
+                                      PrimitiveType dtype,
+                                      PrimitiveType bias_type,
+                                      const FusedAttentionParams& params) {
+  VLOG(2) << "FusedAttention: "
+          << primitive_util::LowercasePrimitiveTypeName(dtype)
+          << ", batch: " << params.batch << ", q_len: " << params.q_len
+          << ", kv_len: " << params.kv_len << ", head_dim: " << params.head_dim
+          << ", value_dim: " << params.value_dim;
+  TF_ASSIGN_OR_RETURN(FusedAttentionKernels kernels,
+                      GetKernels(dtype, bias_type, params));
+  return Launch(stream, kernels.forward, params.q_len, params.batch, params);
+}
+
+absl::Status RunFusedAttentionBackward(GpuStreamHandle stream,
+                                       PrimitiveType dtype,
+                                       PrimitiveType bias_type,
+                                       const FusedAttentionParams& params) {
+  VLOG(2) << "FusedAttentionBackward: "
+          << primitive_util::LowercasePrimitiveTypeName(dtype)
+          << ", batch: " << params.batch << ", q_len: " << params.q_len
+          << ", kv_len: " << params.kv_len << ", head_dim: " << params.head_dim
+          << ", value_dim: " << params.value_dim;
+  TF_ASSIGN_OR_RETURN(FusedAttentionKernels kernels,
+                      GetKernels(dtype, bias_type, params));
+  // The key/value and query kernels both read `output_dot_grad`, and write
+  // disjoint gradients, so they only need to run after the preprocessing.
+  TF_RETURN_IF_ERROR(Launch(stream, kernels.backward_preprocess,
+                            params.batch * params.q_len, /*num_batches=*/1,
+                            params));
+  TF_RETURN_IF_ERROR(Launch(stream, kernels.backward_key_value, params.kv_len,
+                            params.batch, params));
+  return Launch(stream, kernels.backward_query, params.q_len, params.batch,
+                params);
+}
+
+}  // namespace xla::gpu
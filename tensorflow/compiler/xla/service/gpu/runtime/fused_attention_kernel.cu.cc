@@ -0,0 +1,427 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Memory-efficient ("flash") attention kernels. The attention probabilities
+// are never materialized: the forward pass computes the softmax online while
+// walking over the keys, and only saves the log-sum-exp of every query row,
+// from which the backward pass recomputes the probabilities. When adding
+// support for new patterns or types, you also need to modify the rewriter in
+// gpu_fused_attention_rewriter.cc for these changes to be picked up.
+
+#if TENSORFLOW_USE_ROCM
+#include <hip/hip_runtime.h>
+#endif
+
+#include <cstdint>
+#include <limits>
+
+#include "third_party/eigen3/Eigen/Core"
+#include "tensorflow/compiler/xla/service/gpu/runtime/fused_attention_kernel_common.h"
+
+namespace xla::gpu {
+namespace {
+
+constexpr float kNegInfinity = -std::numeric_limits<float>::infinity();
+
+template <int kHeadDim>
+using Tile = float[kFusedAttentionTileSize][kHeadDim];
+
+// Returns the dot product of two zero-padded rows.
+template <int kHeadDim>
+__device__ __forceinline__ float Dot(const float* lhs, const float* rhs) {
+  float result = 0.0f;
+#pragma unroll
+  for (int d = 0; d < kHeadDim; ++d) {
+    result += lhs[d] * rhs[d];
+  }
+  return result;
+}
+
+// Loads element `column` of every row of a [num_rows, size] tensor (or
+// [size, num_rows] if `transposed`) into `row`, zero-padded to kHeadDim.
+template <typename T, int kHeadDim>
+__device__ __forceinline__ void LoadRow(const T* data, int64_t num_rows,
+                                        int64_t size, bool transposed,
+                                        int64_t index, bool active,
+                                        float* row) {
+#pragma unroll
+  for (int d = 0; d < kHeadDim; ++d) {
+    row[d] = active && d < size ? static_cast<float>(
+                                      data[transposed ? d * num_rows + index
+                                                      : index * size + d])
+                                : 0.0f;
+  }
+}
+
+template <typename T, int kHeadDim>
+__device__ __forceinline__ void StoreRow(const float* row, int64_t num_rows,
+                                         int64_t size, bool transposed,
+                                         int64_t index, T* data) {
+#pragma unroll
+  for (int d = 0; d < kHeadDim; ++d) {
+    if (d < size) {
+      data[transposed ? d * num_rows + index : index * size + d] =
+          static_cast<T>(row[d]);
+    }
+  }
+}
+
+// Cooperatively loads the rows [tile_start, tile_start + tile size) of a
+// [num_rows, size] tensor (or [size, num_rows] if `transposed`) into shared
+// memory, zero-padded.
+template <typename T, int kHeadDim>
+__device__ __forceinline__ void LoadTile(const T* data, int64_t num_rows,
+                                         int64_t size, bool transposed,
+                                         int64_t tile_start,
+                                         Tile<kHeadDim>& tile) {
+  for (int i = threadIdx.x; i < kFusedAttentionTileSize * kHeadDim;
+       i += blockDim.x) {
+    const int r = i / kHeadDim;
+    const int d = i % kHeadDim;
+    const int64_t index = tile_start + r;
+    tile[r][d] =
+        index < num_rows && d < size
+            ? static_cast<float>(
+                  data[transposed ? d * num_rows + index : index * size + d])
+            : 0.0f;
+  }
+}
+
+// Computes the attention logit at `index` (in the [batch, q_len, kv_len]
+// logits) from the query.key product. Returns false if it is masked out.
+template <typename TBias>
+__device__ __forceinline__ bool Logit(const FusedAttentionParams& params,
+                                      int64_t index, float dot, float* logit) {
+  *logit = dot * params.scale;
+  if (params.bias != nullptr) {
+    *logit += static_cast<float>(static_cast<const TBias*>(params.bias)[index]);
+  }
+  if (params.mask != nullptr && !params.mask[index]) {
+    *logit = params.mask_value;
+    return false;
+  }
+  return true;
+}
+
+// Returns what the probability at `index` is multiplied by for dropout.
+__device__ __forceinline__ float DropoutMultiplier(
+    const FusedAttentionParams& params, int64_t index) {
+  if (params.dropout_keep == nullptr) return 1.0f;
+  return params.dropout_keep[index] ? params.dropout_scale : 0.0f;
+}
+
+template <typename T, typename TBias, int kHeadDim>
+__global__ void __launch_bounds__(kFusedAttentionBlockSize)
+    FusedAttentionForward(FusedAttentionParams params) {
+  __shared__ Tile<kHeadDim> key_tile;
+  __shared__ Tile<kHeadDim> value_tile;
+
+  const int64_t batch = blockIdx.y;
+  const int64_t row =
+      static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+  const bool active = row < params.q_len;
+  const int64_t query_row = batch * params.q_len + row;
+  const T* key = static_cast<const T*>(params.key) +
+                 batch * params.kv_len * params.head_dim;
+  const T* value = static_cast<const T*>(params.value) +
+                   batch * params.kv_len * params.value_dim;
+
+  float query[kHeadDim];
+  LoadRow<T, kHeadDim>(static_cast<const T*>(params.query), params.q_len,
+                       params.head_dim, /*transposed=*/false, query_row,
+                       active, query);
+  float accumulator[kHeadDim] = {};
+  float row_max = kNegInfinity;
+  float row_sum = 0.0f;
+
+  for (int64_t tile_start = 0; tile_start < params.kv_len;
+       tile_start += kFusedAttentionTileSize) {
+    __syncthreads();
+    LoadTile<T, kHeadDim>(key, params.kv_len, params.head_dim,
+                          params.key_transposed, tile_start, key_tile);
+    LoadTile<T, kHeadDim>(value, params.kv_len, params.value_dim,
+                          params.value_transposed, tile_start, value_tile);
+    __syncthreads();
+    if (!active) continue;
+
+    float logits[kFusedAttentionTileSize];
+    float tile_max = kNegInfinity;
+#pragma unroll
+    for (int j = 0; j < kFusedAttentionTileSize; ++j) {
+      logits[j] = kNegInfinity;
+      if (tile_start + j < params.kv_len) {
+        Logit<TBias>(params, query_row * params.kv_len + tile_start + j,
+                     Dot<kHeadDim>(query, key_tile[j]), &logits[j]);
+        tile_max = fmaxf(tile_max, logits[j]);
+      }
+    }
+    const float new_max = fmaxf(row_max, tile_max);
+    if (new_max == kNegInfinity) continue;
+
+    // Rescale what was accumulated with the previous maximum.
+    const float correction = expf(row_max - new_max);
+    row_sum *= correction;
+#pragma unroll
+    for (int d = 0; d < kHeadDim; ++d) {
+      accumulator[d] *= correction;
+    }
+#pragma unroll
+    for (int j = 0; j < kFusedAttentionTileSize; ++j) {
+      if (tile_start + j >= params.kv_len) break;
+      const float probability = expf(logits[j] - new_max);
+      row_sum += probability;
+      const float dropped =
+          probability *
+          DropoutMultiplier(params, query_row * params.kv_len + tile_start + j);
+#pragma unroll
+      for (int d = 0; d < kHeadDim; ++d) {
+        accumulator[d] += dropped * value_tile[j][d];
+      }
+    }
+    row_max = new_max;
+  }
+  if (!active) return;
+
+#pragma unroll
+  for (int d = 0; d < kHeadDim; ++d) {
+    accumulator[d] /= row_sum;
+  }
+  StoreRow<T, kHeadDim>(accumulator, params.q_len, params.value_dim,
+                        /*transposed=*/false, query_row,
+                        static_cast<T*>(params.output));
+  params.logsumexp[query_row] = row_max + logf(row_sum);
+}
+
+template <typename T>
+__global__ void __launch_bounds__(kFusedAttentionBlockSize)
+    FusedAttentionBackwardPreprocess(FusedAttentionParams params) {
+  const int64_t row =
+      static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+  if (row >= params.batch * params.q_len) return;
+  const T* output =
+      static_cast<const T*>(params.output) + row * params.value_dim;
+  const T* output_grad =
+      static_cast<const T*>(params.output_grad) + row * params.value_dim;
+  float sum = 0.0f;
+  for (int64_t d = 0; d < params.value_dim; ++d) {
+    sum += static_cast<float>(output[d]) * static_cast<float>(output_grad[d]);
+  }
+  params.output_dot_grad[row] = sum;
+}
+
+// Every thread accumulates the gradients of one key and value row over all
+// the queries.
+template <typename T, typename TBias, int kHeadDim>
+__global__ void __launch_bounds__(kFusedAttentionBlockSize)
+    FusedAttentionBackwardKeyValue(FusedAttentionParams params) {
+  __shared__ Tile<kHeadDim> query_tile;
+  __shared__ Tile<kHeadDim> output_grad_tile;
+  __shared__ float logsumexp_tile[kFusedAttentionTileSize];
+  __shared__ float output_dot_grad_tile[kFusedAttentionTileSize];
+
+  const int64_t batch = blockIdx.y;
+  const int64_t column =
+      static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+  const bool active = column < params.kv_len;
+  const T* query = static_cast<const T*>(params.query) +
+                   batch * params.q_len * params.head_dim;
+  const T* output_grad = static_cast<const T*>(params.output_grad) +
+                         batch * params.q_len * params.value_dim;
+  const int64_t key_offset = batch * params.kv_len * params.head_dim;
+  const int64_t value_offset = batch * params.kv_len * params.value_dim;
+
+  float key[kHeadDim];
+  float value[kHeadDim];
+  LoadRow<T, kHeadDim>(static_cast<const T*>(params.key) + key_offset,
+                       params.kv_len, params.head_dim, params.key_transposed,
+                       column, active, key);
+  LoadRow<T, kHeadDim>(static_cast<const T*>(params.value) + value_offset,
+                       params.kv_len, params.value_dim,
+                       params.value_transposed, column, active, value);
+  float key_grad[kHeadDim] = {};
+  float value_grad[kHeadDim] = {};
+
+  for (int64_t tile_start = 0; tile_start < params.q_len;
+       tile_start += kFusedAttentionTileSize) {
+    __syncthreads();
+    LoadTile<T, kHeadDim>(query, params.q_len, params.head_dim,
+                          /*transposed=*/false, tile_start, query_tile);
+    LoadTile<T, kHeadDim>(output_grad, params.q_len, params.value_dim,
+                          /*transposed=*/false, tile_start, output_grad_tile);
+    for (int i = threadIdx.x; i < kFusedAttentionTileSize; i += blockDim.x) {
+      const int64_t row = tile_start + i;
+      const bool in_bounds = row < params.q_len;
+      const int64_t query_row = batch * params.q_len + row;
+      logsumexp_tile[i] = in_bounds ? params.logsumexp[query_row] : 0.0f;
+      output_dot_grad_tile[i] =
+          in_bounds ? params.output_dot_grad[query_row] : 0.0f;
+    }
+    __syncthreads();
+    if (!active) continue;
+
+    for (int i = 0; i < kFusedAttentionTileSize; ++i) {
+      if (tile_start + i >= params.q_len) break;
+      const int64_t index =
+          (batch * params.q_len + tile_start + i) * params.kv_len + column;
+      float logit;
+      const bool unmasked = Logit<TBias>(
+          params, index, Dot<kHeadDim>(query_tile[i], key), &logit);
+      const float probability = expf(logit - logsumexp_tile[i]);
+      const float multiplier = DropoutMultiplier(params, index);
+      const float dropped = probability * multiplier;
+#pragma unroll
+      for (int d = 0; d < kHeadDim; ++d) {
+        value_grad[d] += dropped * output_grad_tile[i][d];
+      }
+      if (!unmasked) continue;
+      const float logit_grad =
+          probability *
+          (Dot<kHeadDim>(output_grad_tile[i], value) * multiplier -
+           output_dot_grad_tile[i]) *
+          params.scale;
+#pragma unroll
+      for (int d = 0; d < kHeadDim; ++d) {
+        key_grad[d] += logit_grad * query_tile[i][d];
+      }
+    }
+  }
+  if (!active) return;
+
+  StoreRow<T, kHeadDim>(key_grad, params.kv_len, params.head_dim,
+                        params.key_transposed, column,
+                        static_cast<T*>(params.key_grad) + key_offset);
+  StoreRow<T, kHeadDim>(value_grad, params.kv_len, params.value_dim,
+                        params.value_transposed, column,
+                        static_cast<T*>(params.value_grad) + value_offset);
+}
+
+// Every thread accumulates the gradient of one query row over all the keys.
+template <typename T, typename TBias, int kHeadDim>
+__global__ void __launch_bounds__(kFusedAttentionBlockSize)
+    FusedAttentionBackwardQuery(FusedAttentionParams params) {
+  __shared__ Tile<kHeadDim> key_tile;
+  __shared__ Tile<kHeadDim> value_tile;
+
+  const int64_t batch = blockIdx.y;
+  const int64_t row =
+      static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+  const bool active = row < params.q_len;
+  const int64_t query_row = batch * params.q_len + row;
+  const T* key = static_cast<const T*>(params.key) +
+                 batch * params.kv_len * params.head_dim;
+  const T* value = static_cast<const T*>(params.value) +
+                   batch * params.kv_len * params.value_dim;
+
+  float query[kHeadDim];
+  float output_grad[kHeadDim];
+  LoadRow<T, kHeadDim>(static_cast<const T*>(params.query), params.q_len,
+                       params.head_dim, /*transposed=*/false, query_row,
+                       active, query);
+  LoadRow<T, kHeadDim>(static_cast<const T*>(params.output_grad), params.q_len,
+                       params.value_dim, /*transposed=*/false, query_row,
+                       active, output_grad);
+  const float logsumexp = active ? params.logsumexp[query_row] : 0.0f;
+  const float output_dot_grad =
+      active ? params.output_dot_grad[query_row] : 0.0f;
+  float query_grad[kHeadDim] = {};
+
+  for (int64_t tile_start = 0; tile_start < params.kv_len;
+       tile_start += kFusedAttentionTileSize) {
+    __syncthreads();
+    LoadTile<T, kHeadDim>(key, params.kv_len, params.head_dim,
+                          params.key_transposed, tile_start, key_tile);
+    LoadTile<T, kHeadDim>(value, params.kv_len, params.value_dim,
+                          params.value_transposed, tile_start, value_tile);
+    __syncthreads();
+    if (!active) continue;
+
+    for (int j = 0; j < kFusedAttentionTileSize; ++j) {
+      if (tile_start + j >= params.kv_len) break;
+      const int64_t index = query_row * params.kv_len + tile_start + j;
+      float logit;
+      if (!Logit<TBias>(params, index, Dot<kHeadDim>(query, key_tile[j]),
+                        &logit)) {
+        continue;
+      }
+      const float probability = expf(logit - logsumexp);
+      const float logit_grad =
+          probability *
+          (Dot<kHeadDim>(output_grad, value_tile[j]) *
+               DropoutMultiplier(params, index) -
+           output_dot_grad) *
+          params.scale;
+#pragma unroll
+      for (int d = 0; d < kHeadDim; ++d) {
+        query_grad[d] += logit_grad * key_tile[j][d];
+      }
+    }
+  }
+  if (!active) return;
+
+  StoreRow<T, kHeadDim>(query_grad, params.q_len, params.head_dim,
+                        /*transposed=*/false, query_row,
+                        static_cast<T*>(params.query_grad));
+}
+
+}  // namespace
+
+template <typename T, typename TBias, int kHeadDim>
+void* GetFusedAttentionForwardKernel() {
+  return reinterpret_cast<void*>(&FusedAttentionForward<T, TBias, kHeadDim>);
+}
+
+template <typename T>
+void* GetFusedAttentionBackwardPreprocessKernel() {
+  return reinterpret_cast<void*>(&FusedAttentionBackwardPreprocess<T>);
+}
+
+template <typename T, typename TBias, int kHeadDim>
+void* GetFusedAttentionBackwardKeyValueKernel() {
+  return reinterpret_cast<void*>(
+      &FusedAttentionBackwardKeyValue<T, TBias, kHeadDim>);
+}
+
+template <typename T, typename TBias, int kHeadDim>
+void* GetFusedAttentionBackwardQueryKernel() {
+  return reinterpret_cast<void*>(
+      &FusedAttentionBackwardQuery<T, TBias, kHeadDim>);
+}
+
+#define INSTANTIATE_FUSED_ATTENTION_KERNELS_FOR_HEAD_DIM(T, TBias, kHeadDim) \
+  template void* GetFusedAttentionForwardKernel<T, TBias, kHeadDim>();      \
+  template void* GetFusedAttentionBackwardKeyValueKernel<T, TBias,          \
+                                                         kHeadDim>();       \
+  template void* GetFusedAttentionBackwardQueryKernel<T, TBias, kHeadDim>();
+
+#define INSTANTIATE_FUSED_ATTENTION_KERNELS_FOR_BIAS(T, TBias)   \
+  INSTANTIATE_FUSED_ATTENTION_KERNELS_FOR_HEAD_DIM(T, TBias, 32) \
+  INSTANTIATE_FUSED_ATTENTION_KERNELS_FOR_HEAD_DIM(T, TBias, 64) \
+  INSTANTIATE_FUSED_ATTENTION_KERNELS_FOR_HEAD_DIM(T, TBias, 128)
+
+#define INSTANTIATE_FUSED_ATTENTION_KERNELS(T)                       \
+  template void* GetFusedAttentionBackwardPreprocessKernel<T>();     \
+  INSTANTIATE_FUSED_ATTENTION_KERNELS_FOR_BIAS(T, T)                 \
+  INSTANTIATE_FUSED_ATTENTION_KERNELS_FOR_BIAS(T, float)
+
+INSTANTIATE_FUSED_ATTENTION_KERNELS(Eigen::half)
+INSTANTIATE_FUSED_ATTENTION_KERNELS(Eigen::bfloat16)
+template void* GetFusedAttentionBackwardPreprocessKernel<float>();
+INSTANTIATE_FUSED_ATTENTION_KERNELS_FOR_BIAS(float, float)
+
+#undef INSTANTIATE_FUSED_ATTENTION_KERNELS
+#undef INSTANTIATE_FUSED_ATTENTION_KERNELS_FOR_BIAS
+#undef INSTANTIATE_FUSED_ATTENTION_KERNELS_FOR_HEAD_DIM
+
+}  // namespace xla::gpu
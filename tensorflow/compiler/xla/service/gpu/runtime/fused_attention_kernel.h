@@ -0,0 +1,44 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_COMPILER_XLA_SERVICE_GPU_RUNTIME_FUSED_ATTENTION_KERNEL_H_
+#define TENSORFLOW_COMPILER_XLA_SERVICE_GPU_RUNTIME_FUSED_ATTENTION_KERNEL_H_
+
+#include <cstdint>
+
+#include "absl/status/status.h"
+#include "tensorflow/compiler/xla/service/gpu/runtime/fused_attention_kernel_common.h"
+#include "tensorflow/compiler/xla/stream_executor/gpu/gpu_types.h"
+#include "tensorflow/compiler/xla/xla_data.pb.h"
+
+namespace xla::gpu {
+
+// Computes `params.output` and `params.logsumexp` from the query, key, value
+// and the optional bias, mask and dropout mask. `dtype` is the element type of
+// query, key, value and output, `bias_type` the element type of the bias, if
+// any.
+absl::Status RunFusedAttentionForward(
+    ::tensorflow::se::gpu::GpuStreamHandle stream, PrimitiveType dtype,
+    PrimitiveType bias_type, const FusedAttentionParams& params);
+
+// Computes `params.query_grad`, `params.key_grad` and `params.value_grad` from
+// the inputs and outputs of the forward pass and `params.output_grad`.
+absl::Status RunFusedAttentionBackward(
+    ::tensorflow::se::gpu::GpuStreamHandle stream, PrimitiveType dtype,
+    PrimitiveType bias_type, const FusedAttentionParams& params);
+
+}  // namespace xla::gpu
+
+#endif  // TENSORFLOW_COMPILER_XLA_SERVICE_GPU_RUNTIME_FUSED_ATTENTION_KERNEL_H_
@@ -0,0 +1,96 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_COMPILER_XLA_SERVICE_GPU_RUNTIME_FUSED_ATTENTION_KERNEL_COMMON_H_
+#define TENSORFLOW_COMPILER_XLA_SERVICE_GPU_RUNTIME_FUSED_ATTENTION_KERNEL_COMMON_H_
+
+// Contains shared declarations between fused_attention_kernel.cc and
+// fused_attention_kernel.cu.cc but avoids including ABSL, etc. which some GPU
+// compilers cannot handle.
+
+#include <cstdint>
+
+namespace xla::gpu {
+
+// Every thread of a block computes one row of the result (a query row in the
+// forward and query gradient kernels, a key row in the key/value gradient
+// kernel), and the block walks over the other sequence in tiles of
+// `kFusedAttentionTileSize` rows staged in shared memory.
+static constexpr int kFusedAttentionBlockSize = 64;
+static constexpr int kFusedAttentionTileSize = 32;
+
+// Arguments of the fused attention kernels. All tensors are dense and row
+// major, with a single (flattened) batch dimension:
+//  - query:     [batch, q_len, head_dim]
+//  - key:       [batch, kv_len, head_dim] ([batch, head_dim, kv_len] if
+//               `key_transposed`)
+//  - value:     [batch, kv_len, value_dim] ([batch, value_dim, kv_len] if
+//               `value_transposed`)
+//  - bias, mask, dropout_keep: [batch, q_len, kv_len], optional
+//  - output:    [batch, q_len, value_dim]
+//  - logsumexp: [batch, q_len], f32
+// The attention logits are `scale * query.key + bias`, replaced by
+// `mask_value` where `mask` is false. The probabilities are multiplied by
+// `dropout_scale` where `dropout_keep` is true, and zeroed elsewhere.
+struct FusedAttentionParams {
+  const void* query = nullptr;
+  const void* key = nullptr;
+  const void* value = nullptr;
+  const void* bias = nullptr;
+  const bool* mask = nullptr;
+  const bool* dropout_keep = nullptr;
+  void* output = nullptr;
+  float* logsumexp = nullptr;
+
+  // Only used by the backward kernels. `output_dot_grad` is a [batch, q_len]
+  // f32 scratch buffer.
+  const void* output_grad = nullptr;
+  float* output_dot_grad = nullptr;
+  void* query_grad = nullptr;
+  void* key_grad = nullptr;
+  void* value_grad = nullptr;
+
+  int64_t batch = 0;
+  int64_t q_len = 0;
+  int64_t kv_len = 0;
+  int64_t head_dim = 0;
+  int64_t value_dim = 0;
+  bool key_transposed = false;
+  bool value_transposed = false;
+
+  float scale = 1.0f;
+  float mask_value = 0.0f;
+  float dropout_scale = 1.0f;
+};
+
+// `T` is the type of query, key, value and output (and of their gradients),
+// `TBias` the type of the bias. `kHeadDim` bounds both `head_dim` and
+// `value_dim`.
+template <typename T, typename TBias, int kHeadDim>
+void* GetFusedAttentionForwardKernel();
+
+// Computes `output_dot_grad` = rowsum(output * output_grad).
+template <typename T>
+void* GetFusedAttentionBackwardPreprocessKernel();
+
+template <typename T, typename TBias, int kHeadDim>
+void* GetFusedAttentionBackwardKeyValueKernel();
+
+template <typename T, typename TBias, int kHeadDim>
+void* GetFusedAttentionBackwardQueryKernel();
+
+}  // namespace xla::gpu
+
+#endif  // TENSORFLOW_COMPILER_XLA_SERVICE_GPU_RUNTIME_FUSED_ATTENTION_KERNEL_COMMON_H_
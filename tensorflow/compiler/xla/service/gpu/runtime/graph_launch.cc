@@ -24,6 +24,7 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
+#include "absl/functional/any_invocable.h"
 #include "absl/strings/str_cat.h"
 #include "absl/synchronization/mutex.h"
 #include "tensorflow/compiler/xla/runtime/custom_call.h"
@@ -39,6 +40,8 @@ limitations under the License.
 
 #if GOOGLE_CUDA
 #include "tensorflow/compiler/xla/stream_executor/cuda/cuda_graph.h"
+#elif TENSORFLOW_USE_ROCM
+#include "tensorflow/compiler/xla/stream_executor/rocm/rocm_graph.h"
 #endif  // #if GOOGLE_CUDA
 
 namespace xla {
@@ -94,9 +97,27 @@ H AbslHashValue(H h, const RemainingArgsPtrs& m) {
 // Runs capture function exported by the executable to constuct a CUDA graph.
 //----------------------------------------------------------------------------//
 
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+
+// Captures all operations launched by `capture` into a platform graph.
+static absl::StatusOr<OwnedGpuGraph> CaptureGpuGraph(
+    se::Stream* stream, absl::AnyInvocable<absl::Status()> capture) {
 #if GOOGLE_CUDA
+  return se::gpu::CaptureCudaGraph(stream, std::move(capture));
+#else
+  return se::gpu::CaptureHipGraph(stream, std::move(capture));
+#endif  // GOOGLE_CUDA
+}
 
-using se::gpu::OwnedCudaGraph;
+// Instantiates a captured platform graph into an executable graph instance.
+static absl::StatusOr<OwnedGpuGraphExec> InstantiateGpuGraph(
+    OwnedGpuGraph graph) {
+#if GOOGLE_CUDA
+  return se::gpu::InstantiateCudaGraph(std::move(graph));
+#else
+  return se::gpu::InstantiateHipGraph(std::move(graph));
+#endif  // GOOGLE_CUDA
+}
 
 static bool InDebugMode() {
 #ifdef NDEBUG
@@ -105,7 +126,7 @@ static bool InDebugMode() {
   return true;
 }
 
-static absl::StatusOr<OwnedCudaGraph> CaptureGraph(
+static absl::StatusOr<OwnedGpuGraph> CaptureGraph(
     const ServiceExecutableRunOptions* run_options,
     runtime::FunctionRef function_ref, CustomCall::RemainingArgs fwd_args,
     CustomCall::UserData user_data) {
@@ -114,8 +135,8 @@ static absl::StatusOr<OwnedCudaGraph> CaptureGraph(
   // executables.
   se::StreamExecutor* executor = run_options->stream()->parent();
 
-  // Initialize (with memoization) BlasSupport here because cublasCreate fails
-  // during cuda graph capturing.
+  // Initialize (with memoization) BlasSupport here because cublasCreate (and
+  // rocblas_create_handle) fails during graph capturing.
   if (function_ref.RequiresBlas()) {
     if (!executor->AsBlas()) {
       return absl::InternalError("Failed to initialize BLAS support");
@@ -178,14 +199,14 @@ static absl::StatusOr<OwnedCudaGraph> CaptureGraph(
   }
 
   // Create a graph from running the graph capture function.
-  auto captured = se::gpu::CaptureCudaGraph(capture_stream->get(), [&]() {
+  auto captured = CaptureGpuGraph(capture_stream->get(), [&]() {
     return function_ref(args, runtime::NoResultConverter{}, opts,
                         /*verify_arguments=*/InDebugMode())
         .status();
   });
 
   if (!captured.ok()) {
-    return InternalError("CaptureCudaGraph failed (%s): %s",
+    return InternalError("CaptureGpuGraph failed (%s): %s",
                          diagnostic.empty() ? "<no details>" : diagnostic,
                          captured.status().ToString());
   }
@@ -240,7 +261,7 @@ static absl::Status RunGraphWithoutCapture(
   return absl::OkStatus();
 }
 
-#endif  // #if GOOGLE_CUDA
+#endif  // #if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 
 //===----------------------------------------------------------------------===//
 // Define the cuda graph launch custom call.
@@ -258,8 +279,8 @@ static absl::Status LaunchGraph(
     NonAtomicallyUpgradeableRWLock* gpu_lock,
     ConcurrentRegionStatus* region_status, CustomCall::RemainingArgs fwd_args,
     CustomCall::FunctionOrdinal capture) {
-#if GOOGLE_CUDA
-  VLOG(1) << "Launch Cuda Graph: capture=" << capture.ordinal;
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+  VLOG(1) << "Launch GPU Graph: capture=" << capture.ordinal;
 
   // Get a reference to exported function that captures the cuda graph.
   runtime::FunctionRef function_ref = executable->function_ref(capture.ordinal);
@@ -306,8 +327,7 @@ static absl::Status LaunchGraph(
             TF_ASSIGN_OR_RETURN(auto g, CaptureGraph(run_options, function_ref,
                                                      fwd_args, user_data()));
 
-            TF_ASSIGN_OR_RETURN(auto e,
-                                se::gpu::InstantiateCudaGraph(std::move(g)));
+            TF_ASSIGN_OR_RETURN(auto e, InstantiateGpuGraph(std::move(g)));
             return GraphInstance(ptrs_hash, std::move(e));
           }));
 
@@ -324,8 +344,11 @@ static absl::Status LaunchGraph(
   }
 
   // Otherwise we have to re-capture the graph and update the graph instance.
+  // Only buffer addresses can change between runs, so the graph topology is
+  // identical and the executable instance is updated in place instead of
+  // paying for a new instantiation.
   VLOG(3) << "Update cached graph instance";
-  // Capture CUDA graph by running capture function.
+  // Capture GPU graph by running capture function.
   TF_ASSIGN_OR_RETURN(
       auto g, CaptureGraph(run_options, function_ref, fwd_args, user_data()));
 
@@ -341,11 +364,11 @@ static absl::Status LaunchGraph(
 
   return instance->exec.Launch(run_options->stream());
 
-#else  // #if !GOOGLE_CUDA
+#else  // #if !GOOGLE_CUDA && !TENSORFLOW_USE_ROCM
 
-  return absl::InternalError("Cuda graphs are not supported");
+  return absl::InternalError("GPU graphs are not supported");
 
-#endif  // #if GOOGLE_CUDA
+#endif  // #if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 }
 
 //===----------------------------------------------------------------------===//
@@ -0,0 +1,195 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/service/gpu/runtime/host_offload.h"
+
+#include <cstdint>
+#include <utility>
+
+#include "absl/strings/str_format.h"
+#include "tensorflow/compiler/xla/runtime/custom_call.h"
+#include "tensorflow/compiler/xla/runtime/executable.h"
+#include "tensorflow/compiler/xla/service/gpu/runtime/support.h"
+#include "tensorflow/compiler/xla/service/service_executable_run_options.h"
+#include "tensorflow/tsl/platform/statusor.h"
+
+namespace xla {
+namespace gpu {
+
+using xla::runtime::CustomCall;
+using xla::runtime::FlatMemrefView;
+
+//===----------------------------------------------------------------------===//
+// Offload a device buffer to the host.
+//===----------------------------------------------------------------------===//
+
+static absl::Status HostOffloadStartImpl(
+    const ServiceExecutableRunOptions* run_options,
+    HostOffloadSupport* host_offload, FlatMemrefView source,
+    FlatMemrefView handle, int32_t uid) {
+  if (host_offload == nullptr) {
+    return absl::InternalError("Host offload support is not available");
+  }
+  TF_ASSIGN_OR_RETURN(void* host_buffer,
+                      host_offload->HostBuffer(uid, source.size_in_bytes));
+  se::Stream* copy_stream = host_offload->copy_stream();
+  // The source is ready once the work enqueued so far on the compute stream
+  // completes.
+  if (copy_stream != run_options->stream()) {
+    copy_stream->ThenWaitFor(run_options->stream());
+  }
+  copy_stream->ThenMemcpy(host_buffer, GetDeviceAddress(source),
+                          source.size_in_bytes);
+  return host_offload->RecordEvent(uid);
+}
+
+XLA_RUNTIME_DEFINE_CUSTOM_CALL(
+    HostOffloadStart, FunctionWrapper<HostOffloadStartImpl>(), checks,
+    CustomCall::Bind("__gpu$HostOffloadStart")
+        .UserData<const ServiceExecutableRunOptions*>()
+        .UserData<HostOffloadSupport*>()
+        .Arg<FlatMemrefView>()  // source
+        .Arg<FlatMemrefView>()  // handle
+        .Attr<int32_t>("uid"));
+
+//===----------------------------------------------------------------------===//
+// Reload an offloaded buffer to the device.
+//===----------------------------------------------------------------------===//
+
+static absl::Status HostReloadStartImpl(
+    const ServiceExecutableRunOptions* run_options,
+    HostOffloadSupport* host_offload, FlatMemrefView handle,
+    FlatMemrefView destination, int32_t uid) {
+  if (host_offload == nullptr) {
+    return absl::InternalError("Host offload support is not available");
+  }
+  TF_ASSIGN_OR_RETURN(void* host_buffer,
+                      host_offload->HostBuffer(uid, destination.size_in_bytes));
+  se::Stream* copy_stream = host_offload->copy_stream();
+  // The destination may have held another buffer that the compute stream was
+  // still using.
+  if (copy_stream != run_options->stream()) {
+    copy_stream->ThenWaitFor(run_options->stream());
+  }
+  se::DeviceMemoryBase destination_data = GetDeviceAddress(destination);
+  copy_stream->ThenMemcpy(&destination_data, host_buffer,
+                          destination.size_in_bytes);
+  return host_offload->RecordEvent(uid);
+}
+
+XLA_RUNTIME_DEFINE_CUSTOM_CALL(
+    HostReloadStart, FunctionWrapper<HostReloadStartImpl>(), checks,
+    CustomCall::Bind("__gpu$HostReloadStart")
+        .UserData<const ServiceExecutableRunOptions*>()
+        .UserData<HostOffloadSupport*>()
+        .Arg<FlatMemrefView>()  // handle
+        .Arg<FlatMemrefView>()  // destination
+        .Attr<int32_t>("uid"));
+
+//===----------------------------------------------------------------------===//
+// Wait for an offload or a reload to complete.
+//===----------------------------------------------------------------------===//
+
+static absl::Status HostCopyDoneImpl(
+    const ServiceExecutableRunOptions* run_options,
+    HostOffloadSupport* host_offload, CustomCall::RemainingArgs args,
+    int32_t uid) {
+  if (host_offload == nullptr) {
+    return absl::InternalError("Host offload support is not available");
+  }
+  TF_ASSIGN_OR_RETURN(se::Event event, host_offload->PopEvent(uid));
+  run_options->stream()->ThenWaitFor(&event);
+  return absl::OkStatus();
+}
+
+XLA_RUNTIME_DEFINE_CUSTOM_CALL(
+    HostOffloadDone, FunctionWrapper<HostCopyDoneImpl>(), checks,
+    CustomCall::Bind("__gpu$HostOffloadDone")
+        .UserData<const ServiceExecutableRunOptions*>()
+        .UserData<HostOffloadSupport*>()
+        .RemainingArgs()  // handle, source, handle
+        .Attr<int32_t>("uid"));
+
+XLA_RUNTIME_DEFINE_CUSTOM_CALL(
+    HostReloadDone, FunctionWrapper<HostCopyDoneImpl>(), checks,
+    CustomCall::Bind("__gpu$HostReloadDone")
+        .UserData<const ServiceExecutableRunOptions*>()
+        .UserData<HostOffloadSupport*>()
+        .RemainingArgs()  // destination, handle
+        .Attr<int32_t>("uid"));
+
+//===----------------------------------------------------------------------===//
+
+HostOffloadBuffers::~HostOffloadBuffers() {
+  absl::MutexLock lock(&mutex_);
+  for (auto& [key, buffer] : buffers_) {
+    key.first->HostMemoryDeallocate(buffer);
+  }
+}
+
+absl::StatusOr<void*> HostOffloadBuffers::GetOrAllocate(
+    se::StreamExecutor* executor, int64_t uid, int64_t size) {
+  absl::MutexLock lock(&mutex_);
+  auto [it, inserted] = buffers_.try_emplace({executor, uid}, nullptr);
+  if (inserted) {
+    it->second = executor->HostMemoryAllocate(size);
+    if (it->second == nullptr) {
+      buffers_.erase(it);
+      return absl::ResourceExhaustedError(absl::StrFormat(
+          "Failed to allocate %d bytes of pinned host memory to offload a "
+          "buffer (uid=%d, device_ordinal=%d)",
+          size, uid, executor->device_ordinal()));
+    }
+  }
+  return it->second;
+}
+
+absl::Status HostOffloadSupport::RecordEvent(int64_t uid) {
+  se::Event done_event(copy_stream_->parent());
+  if (!done_event.Init()) return absl::InternalError("Failed to create event");
+  copy_stream_->ThenRecordEvent(&done_event);
+
+  absl::MutexLock lock(&mutex_);
+  auto [_, was_inserted] = done_events_.insert({uid, std::move(done_event)});
+  if (!was_inserted) {
+    return absl::InternalError(absl::StrFormat(
+        "Host copy done event has not been consumed (uid=%d, "
+        "device_ordinal=%d)",
+        uid, copy_stream_->parent()->device_ordinal()));
+  }
+  return absl::OkStatus();
+}
+
+absl::StatusOr<se::Event> HostOffloadSupport::PopEvent(int64_t uid) {
+  absl::MutexLock lock(&mutex_);
+  auto done_event = done_events_.extract(uid);
+  if (!done_event) {
+    return absl::InternalError(absl::StrFormat(
+        "Host copy done event was not found (uid=%d, device_ordinal=%d)", uid,
+        copy_stream_->parent()->device_ordinal()));
+  }
+  return std::move(done_event.mapped());
+}
+
+void RegisterHostOffloadCustomCalls(
+    runtime::DirectCustomCallRegistry& registry) {
+  registry.Register("__gpu$HostOffloadStart", HostOffloadStart);
+  registry.Register("__gpu$HostOffloadDone", HostOffloadDone);
+  registry.Register("__gpu$HostReloadStart", HostReloadStart);
+  registry.Register("__gpu$HostReloadDone", HostReloadDone);
+}
+
+}  // namespace gpu
+}  // namespace xla
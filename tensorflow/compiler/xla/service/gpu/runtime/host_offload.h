@@ -0,0 +1,86 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_COMPILER_XLA_SERVICE_GPU_RUNTIME_HOST_OFFLOAD_H_
+#define TENSORFLOW_COMPILER_XLA_SERVICE_GPU_RUNTIME_HOST_OFFLOAD_H_
+
+#include <cstdint>
+#include <utility>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorflow/compiler/xla/runtime/custom_call_registry.h"
+#include "tensorflow/compiler/xla/stream_executor/event.h"
+#include "tensorflow/compiler/xla/stream_executor/stream.h"
+#include "tensorflow/compiler/xla/stream_executor/stream_executor.h"
+
+namespace xla {
+namespace gpu {
+
+// Registers XLA Gpu runtime custom calls copying buffers to and from pinned
+// host memory (see HostOffloader).
+void RegisterHostOffloadCustomCalls(
+    runtime::DirectCustomCallRegistry& registry);
+
+// Pinned host buffers of a Gpu executable, one for each offloaded buffer and
+// stream executor. They are allocated on first use and kept for later runs.
+class HostOffloadBuffers {
+ public:
+  HostOffloadBuffers() = default;
+  HostOffloadBuffers(const HostOffloadBuffers&) = delete;
+  HostOffloadBuffers& operator=(const HostOffloadBuffers&) = delete;
+  ~HostOffloadBuffers();
+
+  absl::StatusOr<void*> GetOrAllocate(se::StreamExecutor* executor,
+                                      int64_t uid, int64_t size);
+
+ private:
+  absl::Mutex mutex_;
+  absl::flat_hash_map<std::pair<se::StreamExecutor*, int64_t>, void*> buffers_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+// Support for copying buffers to and from host memory on a separate stream,
+// instantiated for each Gpu executable run.
+class HostOffloadSupport {
+ public:
+  HostOffloadSupport(se::Stream* copy_stream, HostOffloadBuffers* buffers)
+      : copy_stream_(copy_stream), buffers_(buffers) {}
+
+  se::Stream* copy_stream() const { return copy_stream_; }
+
+  absl::StatusOr<void*> HostBuffer(int64_t uid, int64_t size) {
+    return buffers_->GetOrAllocate(copy_stream_->parent(), uid, size);
+  }
+
+  // Records the completion of the copies enqueued so far on the copy stream.
+  absl::Status RecordEvent(int64_t uid);
+  absl::StatusOr<se::Event> PopEvent(int64_t uid);
+
+ private:
+  absl::Mutex mutex_;
+  se::Stream* copy_stream_;
+  HostOffloadBuffers* buffers_;
+
+  absl::flat_hash_map<int64_t, se::Event> done_events_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace gpu
+}  // namespace xla
+
+#endif  // TENSORFLOW_COMPILER_XLA_SERVICE_GPU_RUNTIME_HOST_OFFLOAD_H_
@@ -33,6 +33,8 @@ limitations under the License.
 
 #if GOOGLE_CUDA
 #include "tensorflow/compiler/xla/stream_executor/cuda/cuda_graph.h"
+#elif TENSORFLOW_USE_ROCM
+#include "tensorflow/compiler/xla/stream_executor/rocm/rocm_graph.h"
 #endif  // #if GOOGLE_CUDA
 
 namespace xla {
@@ -79,7 +81,7 @@ static absl::Status LaunchImpl(
       }));
   assert((*kernel)->name() == name && "unexpected loaded kernel");
 
-#if GOOGLE_CUDA
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
   TF_ASSIGN_OR_RETURN(bool is_capturing, se::gpu::IsStreamCapturing(stream));
 #else
   bool is_capturing = false;
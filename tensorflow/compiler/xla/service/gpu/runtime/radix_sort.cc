@@ -0,0 +1,104 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/service/gpu/runtime/radix_sort.h"
+
+#include <cstdint>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "tensorflow/compiler/xla/runtime/custom_call.h"
+#include "tensorflow/compiler/xla/runtime/custom_call_registry.h"
+#include "tensorflow/compiler/xla/runtime/executable.h"
+#include "tensorflow/compiler/xla/service/gpu/runtime/radix_sort_kernel.h"
+#include "tensorflow/compiler/xla/service/gpu/runtime/support.h"
+#include "tensorflow/compiler/xla/service/service_executable_run_options.h"
+#include "tensorflow/compiler/xla/stream_executor/gpu/gpu_stream.h"
+#include "tensorflow/compiler/xla/xla_data.pb.h"
+#include "tensorflow/tsl/platform/statusor.h"
+
+namespace xla::gpu {
+namespace {
+
+using ::xla::runtime::CustomCall;
+using ::xla::runtime::StridedMemrefView;
+
+int64_t NumElements(const StridedMemrefView& view) {
+  int64_t num_elements = 1;
+  for (int64_t size : view.sizes) num_elements *= size;
+  return num_elements;
+}
+
+// The arguments are the keys, the optional values, the sorted keys, the sorted
+// values if there are values, and the scratch buffer. The sorted dimension is
+// the minor-most dimension of all of them.
+absl::Status RadixSortImpl(const ServiceExecutableRunOptions* run_options,
+                           CustomCall::RemainingArgs args, bool descending,
+                           int64_t dimension) {
+  if (args.size() != 3 && args.size() != 5) {
+    return absl::InvalidArgumentError("Invalid number of radix sort arguments");
+  }
+  auto arg = [&](int64_t index) -> absl::StatusOr<StridedMemrefView> {
+    auto view = args.get<StridedMemrefView>(index);
+    if (failed(view)) {
+      return absl::InvalidArgumentError(
+          "Unsupported radix sort argument type");
+    }
+    return *view;
+  };
+  const bool has_values = args.size() == 5;
+  TF_ASSIGN_OR_RETURN(StridedMemrefView keys, arg(0));
+  TF_ASSIGN_OR_RETURN(StridedMemrefView sorted_keys, arg(has_values ? 2 : 1));
+  TF_ASSIGN_OR_RETURN(StridedMemrefView scratch, arg(args.size() - 1));
+  if (dimension < 0 || dimension >= static_cast<int64_t>(keys.sizes.size())) {
+    return absl::InvalidArgumentError("Invalid radix sort dimension");
+  }
+  if (scratch.dtype != PrimitiveType::U8) {
+    return absl::InvalidArgumentError("Radix sort scratch should be U8");
+  }
+  PrimitiveType value_type = PrimitiveType::PRIMITIVE_TYPE_INVALID;
+  const void* values = nullptr;
+  void* sorted_values = nullptr;
+  if (has_values) {
+    TF_ASSIGN_OR_RETURN(StridedMemrefView values_view, arg(1));
+    TF_ASSIGN_OR_RETURN(StridedMemrefView sorted_values_view, arg(3));
+    value_type = values_view.dtype;
+    values = values_view.data;
+    sorted_values = sorted_values_view.data;
+  }
+  const int64_t num_items = keys.sizes[dimension];
+  const int64_t batch_size = num_items == 0 ? 0 : NumElements(keys) / num_items;
+  if (batch_size == 0) return absl::OkStatus();
+  return RunRadixSort(se::gpu::AsGpuStreamValue(run_options->stream()),
+                      keys.dtype, value_type, keys.data, sorted_keys.data,
+                      values, sorted_values, scratch.data,
+                      NumElements(scratch), num_items, batch_size, descending);
+}
+
+}  // namespace
+
+XLA_RUNTIME_DEFINE_CUSTOM_CALL(
+    RadixSort, FunctionWrapper<RadixSortImpl>(), checks,
+    CustomCall::Bind("__gpu$RadixSort")
+        .UserData<const ServiceExecutableRunOptions*>()
+        .RemainingArgs()  // keys, [values], sorted keys, [values], scratch
+        .Attr<bool>("descending")
+        .Attr<int64_t>("dimension"));
+
+void RegisterRadixSortCustomCalls(runtime::DirectCustomCallRegistry& registry) {
+  registry.Register("__gpu$RadixSort", RadixSort);
+}
+
+}  // namespace xla::gpu
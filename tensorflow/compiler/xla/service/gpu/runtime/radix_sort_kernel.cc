@@ -0,0 +1,255 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/service/gpu/runtime/radix_sort_kernel.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow/compiler/xla/primitive_util.h"
+#include "tensorflow/compiler/xla/service/gpu/runtime/radix_sort_kernel_common.h"
+#include "tensorflow/compiler/xla/stream_executor/gpu/gpu_types.h"
+#include "tensorflow/compiler/xla/xla_data.pb.h"
+#include "tensorflow/tsl/platform/logging.h"
+#include "tensorflow/tsl/platform/statusor.h"
+
+namespace xla::gpu {
+namespace {
+
+using ::stream_executor::gpu::GpuStreamHandle;
+
+// Alignment of the scratch buffer of the hipCUB sort, after the total order
+// keys.
+constexpr int64_t kScratchAlignment = 256;
+
+using SortFunction = hipError_t (*)(void* scratch, size_t& scratch_size,
+                                    const void* keys_in, void* keys_out,
+                                    const void* values_in, void* values_out,
+                                    int num_items, int batch_size,
+                                    bool descending, hipStream_t stream);
+
+using TotalOrderFunction = hipError_t (*)(const void* in, void* out,
+                                          int64_t num_items,
+                                          hipStream_t stream);
+
+template <typename K, typename V>
+hipError_t Sort(void* scratch, size_t& scratch_size, const void* keys_in,
+                void* keys_out, const void* values_in, void* values_out,
+                int num_items, int batch_size, bool descending,
+                hipStream_t stream) {
+  if constexpr (std::is_void_v<V>) {
+    return RadixSortKeys<K>(scratch, scratch_size,
+                            static_cast<const K*>(keys_in),
+                            static_cast<K*>(keys_out), num_items, batch_size,
+                            descending, stream);
+  } else {
+    return RadixSortPairs<K, V>(
+        scratch, scratch_size, static_cast<const K*>(keys_in),
+        static_cast<K*>(keys_out), static_cast<const V*>(values_in),
+        static_cast<V*>(values_out), num_items, batch_size, descending,
+        stream);
+  }
+}
+
+template <typename K>
+hipError_t TotalOrder(const void* in, void* out, int64_t num_items,
+                      hipStream_t stream) {
+  return RadixSortTotalOrderKeys<K>(static_cast<const K*>(in),
+                                    static_cast<K*>(out), num_items, stream);
+}
+
+// The values are sorted as unsigned integers of the same width.
+template <typename K>
+absl::StatusOr<SortFunction> GetSortFunctionForKey(PrimitiveType value_type) {
+  if (value_type == PRIMITIVE_TYPE_INVALID) return &Sort<K, void>;
+  switch (primitive_util::BitWidth(value_type)) {
+    case 8:
+      return &Sort<K, uint8_t>;
+    case 16:
+      return &Sort<K, uint16_t>;
+    case 32:
+      return &Sort<K, uint32_t>;
+    case 64:
+      return &Sort<K, uint64_t>;
+    default:
+      return absl::UnimplementedError(
+          absl::StrCat("Radix sort not implemented for values of type ",
+                       primitive_util::LowercasePrimitiveTypeName(value_type)));
+  }
+}
+
+// The keys of the sort, and the function that maps floating point keys to
+// integers with the same total order, or null for integer keys.
+struct SortFunctions {
+  SortFunction sort;
+  TotalOrderFunction total_order = nullptr;
+};
+
+absl::StatusOr<SortFunctions> GetSortFunctions(PrimitiveType key_type,
+                                               PrimitiveType value_type) {
+  switch (key_type) {
+    case PrimitiveType::S8: {
+      TF_ASSIGN_OR_RETURN(SortFunction sort,
+                          GetSortFunctionForKey<int8_t>(value_type));
+      return SortFunctions{sort};
+    }
+    case PrimitiveType::U8: {
+      TF_ASSIGN_OR_RETURN(SortFunction sort,
+                          GetSortFunctionForKey<uint8_t>(value_type));
+      return SortFunctions{sort};
+    }
+    case PrimitiveType::S16: {
+      TF_ASSIGN_OR_RETURN(SortFunction sort,
+                          GetSortFunctionForKey<int16_t>(value_type));
+      return SortFunctions{sort};
+    }
+    case PrimitiveType::U16: {
+      TF_ASSIGN_OR_RETURN(SortFunction sort,
+                          GetSortFunctionForKey<uint16_t>(value_type));
+      return SortFunctions{sort};
+    }
+    case PrimitiveType::S32: {
+      TF_ASSIGN_OR_RETURN(SortFunction sort,
+                          GetSortFunctionForKey<int32_t>(value_type));
+      return SortFunctions{sort};
+    }
+    case PrimitiveType::U32: {
+      TF_ASSIGN_OR_RETURN(SortFunction sort,
+                          GetSortFunctionForKey<uint32_t>(value_type));
+      return SortFunctions{sort};
+    }
+    case PrimitiveType::S64: {
+      TF_ASSIGN_OR_RETURN(SortFunction sort,
+                          GetSortFunctionForKey<int64_t>(value_type));
+      return SortFunctions{sort};
+    }
+    case PrimitiveType::U64: {
+      TF_ASSIGN_OR_RETURN(SortFunction sort,
+                          GetSortFunctionForKey<uint64_t>(value_type));
+      return SortFunctions{sort};
+    }
+    case PrimitiveType::F16:
+    case PrimitiveType::BF16: {
+      TF_ASSIGN_OR_RETURN(SortFunction sort,
+                          GetSortFunctionForKey<int16_t>(value_type));
+      return SortFunctions{sort, &TotalOrder<int16_t>};
+    }
+    case PrimitiveType::F32: {
+      TF_ASSIGN_OR_RETURN(SortFunction sort,
+                          GetSortFunctionForKey<int32_t>(value_type));
+      return SortFunctions{sort, &TotalOrder<int32_t>};
+    }
+    case PrimitiveType::F64: {
+      TF_ASSIGN_OR_RETURN(SortFunction sort,
+                          GetSortFunctionForKey<int64_t>(value_type));
+      return SortFunctions{sort, &TotalOrder<int64_t>};
+    }
+    default:
+      return absl::UnimplementedError(
+          absl::StrCat("Radix sort not implemented for keys of type ",
+                       primitive_util::LowercasePrimitiveTypeName(key_type)));
+  }
+}
+
+// Returns the size of the total order keys at the start of the scratch
+// buffer, rounded up to kScratchAlignment.
+int64_t TotalOrderKeysSize(const SortFunctions& functions,
+                           PrimitiveType key_type, int64_t num_items) {
+  if (functions.total_order == nullptr) return 0;
+  int64_t size = num_items * primitive_util::ByteWidth(key_type);
+  return (size + kScratchAlignment - 1) / kScratchAlignment *
+         kScratchAlignment;
+}
+
+absl::Status CheckSize(int64_t num_items, int64_t batch_size) {
+  if (num_items * batch_size > std::numeric_limits<int>::max()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Radix sort of ", batch_size, "x", num_items,
+                     " elements is too large"));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status ToStatus(hipError_t error, absl::string_view what) {
+  if (error == hipSuccess) return absl::OkStatus();
+  return absl::InternalError(
+      absl::StrCat(what, " failed: ", hipGetErrorString(error)));
+}
+
+}  // namespace
+
+absl::StatusOr<int64_t> GetRadixSortScratchSize(PrimitiveType key_type,
+                                                PrimitiveType value_type,
+                                                int64_t num_items,
+                                                int64_t batch_size,
+                                                bool descending) {
+  TF_RETURN_IF_ERROR(CheckSize(num_items, batch_size));
+  TF_ASSIGN_OR_RETURN(SortFunctions functions,
+                      GetSortFunctions(key_type, value_type));
+  size_t sort_scratch_size = 0;
+  TF_RETURN_IF_ERROR(ToStatus(
+      functions.sort(nullptr, sort_scratch_size, nullptr, nullptr, nullptr,
+                     nullptr, num_items, batch_size, descending,
+                     /*stream=*/nullptr),
+      "Radix sort scratch size query"));
+  return TotalOrderKeysSize(functions, key_type, num_items * batch_size) +
+         static_cast<int64_t>(sort_scratch_size);
+}
+
+absl::Status RunRadixSort(GpuStreamHandle stream, PrimitiveType key_type,
+                          PrimitiveType value_type, const void* keys_in,
+                          void* keys_out, const void* values_in,
+                          void* values_out, void* scratch,
+                          int64_t scratch_size, int64_t num_items,
+                          int64_t batch_size, bool descending) {
+  VLOG(2) << "RadixSort: "
+          << primitive_util::LowercasePrimitiveTypeName(key_type)
+          << ", n: " << num_items << ", bs: " << batch_size;
+  TF_RETURN_IF_ERROR(CheckSize(num_items, batch_size));
+  TF_ASSIGN_OR_RETURN(SortFunctions functions,
+                      GetSortFunctions(key_type, value_type));
+  const int64_t total_items = num_items * batch_size;
+  const int64_t keys_size =
+      TotalOrderKeysSize(functions, key_type, total_items);
+  if (scratch_size < keys_size) {
+    return absl::InvalidArgumentError("Radix sort scratch buffer too small");
+  }
+  if (functions.total_order != nullptr) {
+    TF_RETURN_IF_ERROR(
+        ToStatus(functions.total_order(keys_in, scratch, total_items, stream),
+                 "Radix sort key mapping"));
+    keys_in = scratch;
+  }
+  size_t sort_scratch_size = scratch_size - keys_size;
+  TF_RETURN_IF_ERROR(ToStatus(
+      functions.sort(static_cast<char*>(scratch) + keys_size,
+                     sort_scratch_size, keys_in, keys_out, values_in,
+                     values_out, num_items, batch_size, descending, stream),
+      "Radix sort"));
+  if (functions.total_order != nullptr) {
+    TF_RETURN_IF_ERROR(
+        ToStatus(functions.total_order(keys_out, keys_out, total_items, stream),
+                 "Radix sort key mapping"));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace xla::gpu
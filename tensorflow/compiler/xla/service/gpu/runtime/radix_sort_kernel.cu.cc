@@ -0,0 +1,172 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Radix sort of the __gpu$RadixSort custom call. See
+// radix_sort_rewriter.cc for the sorts that are rewritten into it.
+
+#include <hip/hip_runtime.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "hipcub/hipcub.hpp"
+#include "tensorflow/compiler/xla/service/gpu/runtime/radix_sort_kernel_common.h"
+
+namespace xla::gpu {
+namespace {
+
+constexpr int kTotalOrderBlockSize = 256;
+
+// Returns the offset of the first item of row `row`.
+struct RowOffset {
+  int num_items;
+  __host__ __device__ __forceinline__ int operator()(int row) const {
+    return row * num_items;
+  }
+};
+
+using RowOffsetIterator =
+    hipcub::TransformInputIterator<int, RowOffset,
+                                   hipcub::CountingInputIterator<int>>;
+
+RowOffsetIterator RowOffsets(int num_items) {
+  return RowOffsetIterator(hipcub::CountingInputIterator<int>(0),
+                           RowOffset{num_items});
+}
+
+template <typename K>
+__global__ void TotalOrderKeys(const K* in, K* out, int64_t num_items) {
+  using U = std::make_unsigned_t<K>;
+  // All the bits but the sign bit.
+  constexpr U kMagnitudeMask = ~U{0} >> 1;
+  for (int64_t i = blockIdx.x * int64_t{blockDim.x} + threadIdx.x;
+       i < num_items; i += int64_t{blockDim.x} * gridDim.x) {
+    K key = in[i];
+    // The magnitude of negative numbers is reversed, so that larger
+    // magnitudes map to smaller integers.
+    out[i] = key < 0 ? static_cast<K>(static_cast<U>(key) ^ kMagnitudeMask)
+                     : key;
+  }
+}
+
+}  // namespace
+
+template <typename K>
+hipError_t RadixSortKeys(void* scratch, size_t& scratch_size, const K* keys_in,
+                         K* keys_out, int num_items, int batch_size,
+                         bool descending, hipStream_t stream) {
+  constexpr int kEndBit = sizeof(K) * 8;
+  if (batch_size == 1) {
+    return descending ? hipcub::DeviceRadixSort::SortKeysDescending(
+                            scratch, scratch_size, keys_in, keys_out,
+                            num_items, 0, kEndBit, stream)
+                      : hipcub::DeviceRadixSort::SortKeys(
+                            scratch, scratch_size, keys_in, keys_out,
+                            num_items, 0, kEndBit, stream);
+  }
+  RowOffsetIterator offsets = RowOffsets(num_items);
+  return descending
+             ? hipcub::DeviceSegmentedRadixSort::SortKeysDescending(
+                   scratch, scratch_size, keys_in, keys_out,
+                   num_items * batch_size, batch_size, offsets, offsets + 1, 0,
+                   kEndBit, stream)
+             : hipcub::DeviceSegmentedRadixSort::SortKeys(
+                   scratch, scratch_size, keys_in, keys_out,
+                   num_items * batch_size, batch_size, offsets, offsets + 1, 0,
+                   kEndBit, stream);
+}
+
+template <typename K, typename V>
+hipError_t RadixSortPairs(void* scratch, size_t& scratch_size,
+                          const K* keys_in, K* keys_out, const V* values_in,
+                          V* values_out, int num_items, int batch_size,
+                          bool descending, hipStream_t stream) {
+  constexpr int kEndBit = sizeof(K) * 8;
+  if (batch_size == 1) {
+    return descending ? hipcub::DeviceRadixSort::SortPairsDescending(
+                            scratch, scratch_size, keys_in, keys_out,
+                            values_in, values_out, num_items, 0, kEndBit,
+                            stream)
+                      : hipcub::DeviceRadixSort::SortPairs(
+                            scratch, scratch_size, keys_in, keys_out,
+                            values_in, values_out, num_items, 0, kEndBit,
+                            stream);
+  }
+  RowOffsetIterator offsets = RowOffsets(num_items);
+  return descending
+             ? hipcub::DeviceSegmentedRadixSort::SortPairsDescending(
+                   scratch, scratch_size, keys_in, keys_out, values_in,
+                   values_out, num_items * batch_size, batch_size, offsets,
+                   offsets + 1, 0, kEndBit, stream)
+             : hipcub::DeviceSegmentedRadixSort::SortPairs(
+                   scratch, scratch_size, keys_in, keys_out, values_in,
+                   values_out, num_items * batch_size, batch_size, offsets,
+                   offsets + 1, 0, kEndBit, stream);
+}
+
+template <typename K>
+hipError_t RadixSortTotalOrderKeys(const K* in, K* out, int64_t num_items,
+                                   hipStream_t stream) {
+  if (num_items == 0) return hipSuccess;
+  constexpr int64_t kMaxBlocks = 4096;
+  int64_t num_blocks = (num_items + kTotalOrderBlockSize - 1) /
+                       kTotalOrderBlockSize;
+  if (num_blocks > kMaxBlocks) num_blocks = kMaxBlocks;
+  hipLaunchKernelGGL(TotalOrderKeys<K>, dim3(num_blocks),
+                     dim3(kTotalOrderBlockSize), 0, stream, in, out,
+                     num_items);
+  return hipGetLastError();
+}
+
+#define INSTANTIATE_RADIX_SORT_PAIRS(K)                                      \
+  template hipError_t RadixSortPairs<K, uint8_t>(                          \
+      void*, size_t&, const K*, K*, const uint8_t*, uint8_t*, int, int,    \
+      bool, hipStream_t);                                                  \
+  template hipError_t RadixSortPairs<K, uint16_t>(                         \
+      void*, size_t&, const K*, K*, const uint16_t*, uint16_t*, int, int,  \
+      bool, hipStream_t);                                                  \
+  template hipError_t RadixSortPairs<K, uint32_t>(                         \
+      void*, size_t&, const K*, K*, const uint32_t*, uint32_t*, int, int,  \
+      bool, hipStream_t);                                                  \
+  template hipError_t RadixSortPairs<K, uint64_t>(                         \
+      void*, size_t&, const K*, K*, const uint64_t*, uint64_t*, int, int,  \
+      bool, hipStream_t);
+
+#define INSTANTIATE_RADIX_SORT(K)                                           \
+  template hipError_t RadixSortKeys<K>(void*, size_t&, const K*, K*, int, \
+                                       int, bool, hipStream_t);           \
+  INSTANTIATE_RADIX_SORT_PAIRS(K)
+
+INSTANTIATE_RADIX_SORT(int8_t)
+INSTANTIATE_RADIX_SORT(uint8_t)
+INSTANTIATE_RADIX_SORT(int16_t)
+INSTANTIATE_RADIX_SORT(uint16_t)
+INSTANTIATE_RADIX_SORT(int32_t)
+INSTANTIATE_RADIX_SORT(uint32_t)
+INSTANTIATE_RADIX_SORT(int64_t)
+INSTANTIATE_RADIX_SORT(uint64_t)
+
+template hipError_t RadixSortTotalOrderKeys<int16_t>(const int16_t*, int16_t*,
+                                                     int64_t, hipStream_t);
+template hipError_t RadixSortTotalOrderKeys<int32_t>(const int32_t*, int32_t*,
+                                                     int64_t, hipStream_t);
+template hipError_t RadixSortTotalOrderKeys<int64_t>(const int64_t*, int64_t*,
+                                                     int64_t, hipStream_t);
+
+#undef INSTANTIATE_RADIX_SORT
+#undef INSTANTIATE_RADIX_SORT_PAIRS
+
+}  // namespace xla::gpu
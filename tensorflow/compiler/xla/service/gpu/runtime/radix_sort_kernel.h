@@ -0,0 +1,53 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_COMPILER_XLA_SERVICE_GPU_RUNTIME_RADIX_SORT_KERNEL_H_
+#define TENSORFLOW_COMPILER_XLA_SERVICE_GPU_RUNTIME_RADIX_SORT_KERNEL_H_
+
+#include <cstdint>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "tensorflow/compiler/xla/stream_executor/gpu/gpu_types.h"
+#include "tensorflow/compiler/xla/xla_data.pb.h"
+
+namespace xla::gpu {
+
+// Returns the size of the scratch buffer of RunRadixSort. `value_type` is
+// PRIMITIVE_TYPE_INVALID if only keys are sorted.
+absl::StatusOr<int64_t> GetRadixSortScratchSize(PrimitiveType key_type,
+                                                PrimitiveType value_type,
+                                                int64_t num_items,
+                                                int64_t batch_size,
+                                                bool descending);
+
+// Input:
+//  - keys_in: [batch_size, num_items] key_type
+//  - values_in: [batch_size, num_items] value_type, null if `value_type` is
+//    PRIMITIVE_TYPE_INVALID
+// Output:
+//  - keys_out, values_out: the rows of keys_in and values_in, ordered by key.
+// The sort is stable. Floating point keys are sorted in their total order.
+absl::Status RunRadixSort(::stream_executor::gpu::GpuStreamHandle stream,
+                          PrimitiveType key_type, PrimitiveType value_type,
+                          const void* keys_in, void* keys_out,
+                          const void* values_in, void* values_out,
+                          void* scratch, int64_t scratch_size,
+                          int64_t num_items, int64_t batch_size,
+                          bool descending);
+
+}  // namespace xla::gpu
+
+#endif  // TENSORFLOW_COMPILER_XLA_SERVICE_GPU_RUNTIME_RADIX_SORT_KERNEL_H_
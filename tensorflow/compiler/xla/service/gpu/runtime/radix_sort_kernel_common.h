@@ -0,0 +1,60 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_COMPILER_XLA_SERVICE_GPU_RUNTIME_RADIX_SORT_KERNEL_COMMON_H_
+#define TENSORFLOW_COMPILER_XLA_SERVICE_GPU_RUNTIME_RADIX_SORT_KERNEL_COMMON_H_
+
+// Contains shared declarations between radix_sort_kernel.cc and
+// radix_sort_kernel.cu.cc but avoids including ABSL, etc. which some GPU
+// compilers cannot handle.
+
+#include <hip/hip_runtime.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace xla::gpu {
+
+// Sorts each of the `batch_size` rows of `num_items` keys of `keys_in` into
+// `keys_out`, with a stable hipCUB radix sort. If `scratch` is null, only sets
+// `scratch_size` to the size of the scratch buffer that the sort needs.
+//
+// K is an integer type: floating point keys are sorted as integers that have
+// the same total order (see RadixSortTotalOrderKeys).
+template <typename K>
+hipError_t RadixSortKeys(void* scratch, size_t& scratch_size, const K* keys_in,
+                         K* keys_out, int num_items, int batch_size,
+                         bool descending, hipStream_t stream);
+
+// Same as RadixSortKeys, and also permutes the rows of `values_in` like the
+// keys into `values_out`. V is an unsigned integer type with the width of the
+// values.
+template <typename K, typename V>
+hipError_t RadixSortPairs(void* scratch, size_t& scratch_size,
+                          const K* keys_in, K* keys_out, const V* values_in,
+                          V* values_out, int num_items, int batch_size,
+                          bool descending, hipStream_t stream);
+
+// Maps the `num_items` floating point numbers of `in`, reinterpreted as the
+// signed integers K of the same width, into `out` so that the integer order of
+// the results is the total order of the numbers: -NaN < -Inf < ... < -0 < +0 <
+// ... < +Inf < +NaN. The mapping is its own inverse, and `in` may be `out`.
+template <typename K>
+hipError_t RadixSortTotalOrderKeys(const K* in, K* out, int64_t num_items,
+                                   hipStream_t stream);
+
+}  // namespace xla::gpu
+
+#endif  // TENSORFLOW_COMPILER_XLA_SERVICE_GPU_RUNTIME_RADIX_SORT_KERNEL_COMMON_H_
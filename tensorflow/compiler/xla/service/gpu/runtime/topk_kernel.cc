@@ -24,12 +24,18 @@ limitations under the License.
 #include "absl/numeric/bits.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
-#include "third_party/gpus/cuda/include/cuda_runtime_api.h"
+#include "absl/strings/str_cat.h"
 #include "tensorflow/compiler/xla/primitive_util.h"
 #include "tensorflow/compiler/xla/service/gpu/runtime/topk_kernel_common.h"
 #include "tensorflow/compiler/xla/stream_executor/gpu/gpu_stream.h"
 #include "tensorflow/compiler/xla/xla_data.pb.h"
 
+#if TENSORFLOW_USE_ROCM
+#include "rocm/include/hip/hip_runtime.h"
+#else
+#include "third_party/gpus/cuda/include/cuda_runtime_api.h"
+#endif
+
 namespace xla::gpu {
 
 namespace {
@@ -101,9 +107,18 @@ absl::Status TypedTopK(TopkArgs<T> args) {
   int blocks_per_grid = args.batch_size;
   constexpr size_t max_kv_size = sizeof(uint64_t);
   // Allocate shmem assuming we have a full reduction.
-  int shmem_size = absl::bit_ceil(args.k) * max_kv_size * 32;
+  int shmem_size = absl::bit_ceil(args.k) * max_kv_size * kTopKWarpSize;
   void* kernel_args[] = {&args.data, &args.num_elements, &args.top_elements,
                          &args.top_indices, &args.k};
+#if TENSORFLOW_USE_ROCM
+  hipError_t launch_status =
+      hipLaunchKernel(kernel, blocks_per_grid, num_threads, kernel_args,
+                      shmem_size, args.stream);
+  if (launch_status != hipSuccess) {
+    return absl::InternalError(absl::StrCat("Failed to launch kernel: ",
+                                            hipGetErrorString(launch_status)));
+  }
+#else
   cudaError_t launch_status =
       cudaLaunchKernel(kernel, blocks_per_grid, num_threads, kernel_args,
                        shmem_size, args.stream);
@@ -111,6 +126,7 @@ absl::Status TypedTopK(TopkArgs<T> args) {
     return absl::InternalError(absl::StrCat("Failed to launch kernel: ",
                                             cudaGetErrorString(launch_status)));
   }
+#endif
   return absl::OkStatus();
 }
 
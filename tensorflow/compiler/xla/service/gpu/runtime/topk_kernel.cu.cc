@@ -17,6 +17,10 @@ limitations under the License.
 // adding support for new shapes/dtypes, you also need to modify the rewritter
 // on topk_specializer.cc for these changes to be picked up.
 
+#if TENSORFLOW_USE_ROCM
+#include <hip/hip_runtime.h>
+#endif
+
 #include <cstddef>
 #include <cstdint>
 #include <limits>
@@ -47,12 +51,19 @@ struct Descending {
     }
 
     __device__ __forceinline__ KVT ShuffleDown(int offset) const {
-      unsigned FULL_MASK = 0xffffffff;
       // The static casts here are necessary because some types will be
       // broadened (e.g. bfloat16 -> f32), so we need to narrow them back after
       // the shuffle.
+#if TENSORFLOW_USE_ROCM
+      // HIP shuffles always involve the whole wavefront.
+      return KVT(
+          static_cast<T>(__shfl_down(static_cast<float>(k_), offset)),
+          static_cast<V>(__shfl_down(static_cast<uint32_t>(v_), offset)));
+#else
+      unsigned FULL_MASK = 0xffffffff;
       return KVT(static_cast<T>(__shfl_down_sync(FULL_MASK, k_, offset)),
                  static_cast<V>(__shfl_down_sync(FULL_MASK, v_, offset)));
+#endif
     }
 
    private:
@@ -80,10 +91,10 @@ __device__ __forceinline__ int Idx(int i) {
 //
 // To compute the final largest K elements, we shard the data threads and each
 // of them computes the top k elements for the data in its slice. When all lanes
-// in a warp are done with their TopK, we merge all the lane-local topks into
-// lane 0 using warp-local reductions. The lane-local topk is computed at
-// PerWarpTopK() and the warp reduction is computed in Reduce(). The warp-local
-// results are stored in shared memory.
+// in a warp (a 64-wide wavefront on most AMD GPUs) are done with their TopK, we
+// merge all the lane-local topks into lane 0 using warp-local reductions. The
+// lane-local topk is computed at PerWarpTopK() and the warp reduction is
+// computed in Reduce(). The warp-local results are stored in shared memory.
 //
 // Once all warps are done, we load all previously produced results into a
 // single warp and repeat the reduction described above. This is implemented in
@@ -184,12 +195,12 @@ class TopK {
       Push(tmp, kv);
     }
 
-    Reduce(tmp, 32);
+    Reduce(tmp, kTopKWarpSize);
 
-    if (threadIdx.x % 32 != 0) return;
-    int warp_id = threadIdx.x / 32;
+    if (threadIdx.x % kTopKWarpSize != 0) return;
+    int warp_id = threadIdx.x / kTopKWarpSize;
     for (int i = 0; i < K; i++) {
-      buffer_[i * 32 + warp_id] = tmp[i];
+      buffer_[i * kTopKWarpSize + warp_id] = tmp[i];
     }
   }
 
@@ -198,11 +209,13 @@ class TopK {
   __device__ void MergeTopKs(KT* keys, uint32_t* values) {
     KVT tmp[K];
     // We only use one warp for this step.
-    if (threadIdx.x / 32 != 0) return;
+    if (threadIdx.x / kTopKWarpSize != 0) return;
     __syncthreads();
 #pragma unroll
-    for (int i = 0; i < K; i++) tmp[i] = buffer_[i * 32 + threadIdx.x];
-    Reduce(tmp, blockDim.x / 32);
+    for (int i = 0; i < K; i++) {
+      tmp[i] = buffer_[i * kTopKWarpSize + threadIdx.x];
+    }
+    Reduce(tmp, blockDim.x / kTopKWarpSize);
     if (threadIdx.x != 0) return;
     for (int i = 0; i < num_outputs_; ++i) {
       tmp[i].Write(&keys[i], &values[i]);
@@ -213,7 +226,7 @@ class TopK {
   // resulting array is stored in the tmp array of lane 0. For all other lanes,
   // `tmp` is unspecified after this function is called.
   __device__ __forceinline__ void Reduce(KVT tmp[K], int num_lanes) {
-    int lane_id = threadIdx.x % 32;
+    int lane_id = threadIdx.x % kTopKWarpSize;
     for (int offset = num_lanes / 2; offset > 0; offset /= 2) {
 #pragma unroll
       for (int i = 0; i < K; i++) {
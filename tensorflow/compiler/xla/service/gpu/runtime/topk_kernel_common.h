@@ -26,6 +26,21 @@ namespace xla::gpu {
 // block we support is 1024.
 static constexpr size_t kTopKMaxThreadsPerBlock = 1024;
 
+// The number of threads of a warp, or of a wavefront on AMD GPUs. The kernels
+// reduce the per-thread results of a warp with shuffles, and keep one result
+// per warp in shared memory.
+#if TENSORFLOW_USE_ROCM
+#if defined(__AMDGCN_WAVEFRONT_SIZE)
+static constexpr size_t kTopKWarpSize = __AMDGCN_WAVEFRONT_SIZE;
+#else
+// The host compilation does not know the wavefront size of the device, so it
+// uses the largest one.
+static constexpr size_t kTopKWarpSize = 64;
+#endif
+#else
+static constexpr size_t kTopKWarpSize = 32;
+#endif
+
 template <typename T, size_t K>
 void* GetTopKKernelForK(int n);
 
@@ -0,0 +1,195 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/service/gpu/softmax_fusion.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/algorithm/container.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/str_cat.h"
+#include "tensorflow/compiler/xla/hlo/ir/hlo_computation.h"
+#include "tensorflow/compiler/xla/hlo/ir/hlo_instruction.h"
+#include "tensorflow/compiler/xla/hlo/ir/hlo_opcode.h"
+#include "tensorflow/compiler/xla/service/gpu/backend_configs.pb.h"
+#include "tensorflow/compiler/xla/service/gpu/ir_emission_utils.h"
+#include "tensorflow/compiler/xla/shape_util.h"
+#include "tensorflow/compiler/xla/util.h"
+#include "tensorflow/tsl/platform/errors.h"
+#include "tensorflow/tsl/platform/logging.h"
+#include "tensorflow/tsl/platform/statusor.h"
+
+namespace xla::gpu {
+namespace {
+
+// Rows longer than this are better served by the tiled reduction emitter,
+// which splits a row across several blocks.
+constexpr int64_t kMaxRowLength = 32768;
+
+// Returns whether `reduce` reduces the minor-most dimension of a rank >= 1
+// operand of shape `row_major_shape` with a scalar binary reducer.
+bool IsRowReduction(const HloInstruction& reduce,
+                    const Shape& row_major_shape) {
+  if (reduce.opcode() != HloOpcode::kReduce || reduce.shape().IsTuple() ||
+      reduce.operand_count() != 2) {
+    return false;
+  }
+  const HloInstruction* input = reduce.operand(0);
+  const int64_t rank = input->shape().rank();
+  if (!ShapeUtil::SameDimensions(input->shape(), row_major_shape) ||
+      reduce.dimensions() != std::vector<int64_t>{rank - 1} ||
+      input->shape().layout().minor_to_major(0) != rank - 1 ||
+      reduce.operand(1)->opcode() != HloOpcode::kConstant) {
+    return false;
+  }
+  const HloInstruction* reducer_root = reduce.to_apply()->root_instruction();
+  return reduce.to_apply()->num_parameters() == 2 &&
+         reducer_root->IsElementwiseBinary() &&
+         reducer_root->operand(0)->opcode() == HloOpcode::kParameter &&
+         reducer_root->operand(1)->opcode() == HloOpcode::kParameter;
+}
+
+// Returns whether `hlo` can be computed by the softmax emitter, which computes
+// values of shape `row_major_shape` one row at a time, and values of the shape
+// of its rows (with the minor-most dimension removed) once per row.
+bool IsFusibleIntoRowNormalization(const HloInstruction& hlo,
+                                   const Shape& row_major_shape,
+                                   const Shape& row_shape) {
+  auto has_supported_shape = [&] {
+    return hlo.shape().IsArray() &&
+           (ShapeUtil::SameDimensions(hlo.shape(), row_major_shape) ||
+            ShapeUtil::SameDimensions(hlo.shape(), row_shape));
+  };
+  switch (hlo.opcode()) {
+    case HloOpcode::kConstant:
+      return ShapeUtil::IsEffectiveScalar(hlo.shape());
+    case HloOpcode::kBroadcast: {
+      // Values computed in the fusion are only available for the current row,
+      // so they may only be broadcast along the rows.
+      const Shape& operand_shape = hlo.operand(0)->shape();
+      if (ShapeUtil::SameDimensions(operand_shape, row_major_shape)) {
+        return false;
+      }
+      if (ShapeUtil::SameDimensions(operand_shape, row_shape)) {
+        std::vector<int64_t> row_dimensions(row_shape.rank());
+        absl::c_iota(row_dimensions, 0);
+        return ShapeUtil::SameDimensions(hlo.shape(), row_major_shape) &&
+               hlo.dimensions() == row_dimensions;
+      }
+      return has_supported_shape();
+    }
+    case HloOpcode::kReduce:
+      return IsRowReduction(hlo, row_major_shape);
+    case HloOpcode::kCopy:
+    case HloOpcode::kRng:
+      return false;
+    default:
+      return hlo.IsElementwise() && !hlo.HasSideEffect() &&
+             has_supported_shape();
+  }
+}
+
+// Collects the instructions that can be fused with `root` into a row
+// normalization, in reverse post order. `post_order_index` is the position of
+// `root` in `post_order`. An instruction is fused only if all of its users
+// are, so that the fusion does not need to produce multiple outputs.
+std::vector<HloInstruction*> CollectRowNormalization(
+    HloInstruction* root, const std::vector<HloInstruction*>& post_order,
+    int64_t post_order_index,
+    const absl::flat_hash_set<HloInstruction*>& already_fused) {
+  const Shape& row_major_shape = root->shape();
+  const Shape row_shape = ShapeUtil::DeleteDimension(
+      row_major_shape.rank() - 1, row_major_shape);
+  std::vector<HloInstruction*> fused = {root};
+  absl::flat_hash_set<HloInstruction*> fused_set = {root};
+  for (int64_t i = post_order_index - 1; i >= 0; --i) {
+    HloInstruction* hlo = post_order[i];
+    if (already_fused.contains(hlo) || hlo->user_count() == 0 ||
+        !IsFusibleIntoRowNormalization(*hlo, row_major_shape, row_shape)) {
+      continue;
+    }
+    if (absl::c_all_of(hlo->users(), [&](HloInstruction* user) {
+          return fused_set.contains(user);
+        })) {
+      fused.push_back(hlo);
+      fused_set.insert(hlo);
+    }
+  }
+  return fused;
+}
+
+StatusOr<bool> RunOnComputation(HloComputation* computation) {
+  bool changed = false;
+  std::vector<HloInstruction*> post_order =
+      computation->MakeInstructionPostOrder();
+  absl::flat_hash_set<HloInstruction*> already_fused;
+  // Visit consumers before their producers, so that each fusion is rooted at
+  // the last instruction of the pattern.
+  for (int64_t i = post_order.size() - 1; i >= 0; --i) {
+    HloInstruction* root = post_order[i];
+    if (already_fused.contains(root) || !root->IsElementwise() ||
+        !root->shape().IsArray() || root->shape().rank() == 0 ||
+        root->HasSideEffect()) {
+      continue;
+    }
+    const int64_t rank = root->shape().rank();
+    const int64_t row_length = root->shape().dimensions(rank - 1);
+    if (root->shape().layout().minor_to_major(0) != rank - 1 ||
+        row_length > kMaxRowLength ||
+        !IsFusibleIntoRowNormalization(
+            *root, root->shape(),
+            ShapeUtil::DeleteDimension(rank - 1, root->shape()))) {
+      continue;
+    }
+    std::vector<HloInstruction*> fused =
+        CollectRowNormalization(root, post_order, i, already_fused);
+    if (absl::c_none_of(fused, [](const HloInstruction* hlo) {
+          return hlo->opcode() == HloOpcode::kReduce;
+        })) {
+      continue;
+    }
+    VLOG(3) << "Fusing row normalization rooted at " << root->ToString();
+    already_fused.insert(fused.begin(), fused.end());
+    const std::string fusion_name = absl::StrCat("softmax_", root->name());
+    HloInstruction* fusion = computation->CreateFusionInstruction(
+        fused, HloInstruction::FusionKind::kCustom);
+    computation->parent()->SetAndUniquifyInstrName(fusion, fusion_name);
+    TF_ASSIGN_OR_RETURN(auto backend_config,
+                        fusion->backend_config<FusionBackendConfig>());
+    backend_config.set_kind(std::string(kSoftmaxFusionKind));
+    TF_RETURN_IF_ERROR(fusion->set_backend_config(backend_config));
+    changed = true;
+  }
+  return changed;
+}
+
+}  // namespace
+
+StatusOr<bool> SoftmaxFusion::Run(
+    HloModule* module,
+    const absl::flat_hash_set<absl::string_view>& execution_threads) {
+  bool changed = false;
+  for (HloComputation* computation :
+       module->MakeNonfusionComputations(execution_threads)) {
+    TF_ASSIGN_OR_RETURN(bool computation_changed,
+                        RunOnComputation(computation));
+    changed |= computation_changed;
+  }
+  return changed;
+}
+
+}  // namespace xla::gpu
@@ -23,7 +23,20 @@ limitations under the License.
 
 namespace xla::gpu {
 
-// Pass to match softmax patterns and replace them with custom calls.
+// Pass to match softmax and layer norm patterns and replace them with fusions
+// of kind kCustom with the `kSoftmaxFusionKind` backend config.
+//
+// A matched pattern normalizes the rows (the minor-most dimension) of its
+// input: it consists of row reductions, broadcasts of their results back to
+// the rows, and elementwise ops, e.g.
+//   max = reduce(x, -inf), dimensions={1}, to_apply=max
+//   e = exp(x - broadcast(max))
+//   sum = reduce(e, 0), dimensions={1}, to_apply=add
+//   ROOT softmax = e / broadcast(sum)
+// IrEmitterUnnested emits such a fusion as a single kernel in which a block
+// computes one row: the reductions are block-wide, and the inputs of the row
+// are kept in shared memory between the passes over the row, so that the input
+// is read from global memory only once.
 class SoftmaxFusion : public HloModulePass {
  public:
   SoftmaxFusion() = default;
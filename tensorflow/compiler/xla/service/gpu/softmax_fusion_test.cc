@@ -0,0 +1,229 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/service/gpu/softmax_fusion.h"
+
+#include <gtest/gtest.h>
+#include "tensorflow/compiler/xla/error_spec.h"
+#include "tensorflow/compiler/xla/hlo/ir/hlo_instruction.h"
+#include "tensorflow/compiler/xla/hlo/ir/hlo_opcode.h"
+#include "tensorflow/compiler/xla/service/gpu/backend_configs.pb.h"
+#include "tensorflow/compiler/xla/service/gpu/ir_emission_utils.h"
+#include "tensorflow/compiler/xla/service/gpu/tests/gpu_codegen_test.h"
+
+namespace xla {
+namespace gpu {
+namespace {
+
+constexpr const char* kSoftmaxHlo = R"(
+HloModule softmax
+
+max_computation {
+  arg_0 = f32[] parameter(0)
+  arg_1 = f32[] parameter(1)
+  ROOT maximum = f32[] maximum(arg_0, arg_1)
+}
+
+add_computation {
+  arg_0 = f32[] parameter(0)
+  arg_1 = f32[] parameter(1)
+  ROOT add = f32[] add(arg_0, arg_1)
+}
+
+ENTRY main {
+  param_0 = f32[127,1000] parameter(0)
+  constant_neg_inf = f32[] constant(-inf)
+  reduce = f32[127] reduce(param_0, constant_neg_inf), dimensions={1}, to_apply=max_computation
+  broadcast = f32[127,1000] broadcast(reduce), dimensions={0}
+  subtract = f32[127,1000] subtract(param_0, broadcast)
+  exponential = f32[127,1000] exponential(subtract)
+  constant_zero = f32[] constant(0)
+  sum = f32[127] reduce(exponential, constant_zero), dimensions={1}, to_apply=add_computation
+  broadcast_sum = f32[127,1000] broadcast(sum), dimensions={0}
+  ROOT divide = f32[127,1000] divide(exponential, broadcast_sum)
+}
+)";
+
+constexpr const char* kLayerNormHlo = R"(
+HloModule layer_norm
+
+add_computation {
+  arg_0 = f32[] parameter(0)
+  arg_1 = f32[] parameter(1)
+  ROOT add = f32[] add(arg_0, arg_1)
+}
+
+ENTRY main {
+  param_0 = f32[4,33,2049] parameter(0)
+  param_1 = f32[2049] parameter(1)
+  constant_zero = f32[] constant(0)
+  constant_n = f32[] constant(2049)
+  broadcast_n = f32[4,33] broadcast(constant_n), dimensions={}
+  sum = f32[4,33] reduce(param_0, constant_zero), dimensions={2}, to_apply=add_computation
+  mean = f32[4,33] divide(sum, broadcast_n)
+  broadcast_mean = f32[4,33,2049] broadcast(mean), dimensions={0,1}
+  centered = f32[4,33,2049] subtract(param_0, broadcast_mean)
+  square = f32[4,33,2049] multiply(centered, centered)
+  square_sum = f32[4,33] reduce(square, constant_zero), dimensions={2}, to_apply=add_computation
+  variance = f32[4,33] divide(square_sum, broadcast_n)
+  constant_epsilon = f32[] constant(1e-5)
+  broadcast_epsilon = f32[4,33] broadcast(constant_epsilon), dimensions={}
+  variance_epsilon = f32[4,33] add(variance, broadcast_epsilon)
+  rsqrt = f32[4,33] rsqrt(variance_epsilon)
+  broadcast_rsqrt = f32[4,33,2049] broadcast(rsqrt), dimensions={0,1}
+  normalized = f32[4,33,2049] multiply(centered, broadcast_rsqrt)
+  broadcast_gamma = f32[4,33,2049] broadcast(param_1), dimensions={2}
+  ROOT scaled = f32[4,33,2049] multiply(normalized, broadcast_gamma)
+}
+)";
+
+class SoftmaxFusionTest : public GpuCodegenTest {
+ public:
+  DebugOptions GetDebugOptionsForTest() override {
+    DebugOptions debug_options = GpuCodegenTest::GetDebugOptionsForTest();
+    debug_options.set_xla_gpu_enable_softmax_fusion(true);
+    return debug_options;
+  }
+
+  // Runs SoftmaxFusion on `hlo_text` and expects the root to become a
+  // softmax fusion of `num_fused_instructions` instructions.
+  void ExpectSoftmaxFusion(const char* hlo_text,
+                           int64_t num_fused_instructions) {
+    auto module = ParseAndReturnVerifiedModule(hlo_text).value();
+    EXPECT_TRUE(SoftmaxFusion().Run(module.get()).value());
+    const HloInstruction* root =
+        module->entry_computation()->root_instruction();
+    ASSERT_EQ(root->opcode(), HloOpcode::kFusion);
+    EXPECT_EQ(root->fusion_kind(), HloInstruction::FusionKind::kCustom);
+    EXPECT_EQ(root->backend_config<FusionBackendConfig>().value().kind(),
+              kSoftmaxFusionKind);
+    EXPECT_EQ(root->fused_instruction_count(), num_fused_instructions);
+  }
+};
+
+TEST_F(SoftmaxFusionTest, FusesSoftmax) {
+  ExpectSoftmaxFusion(kSoftmaxHlo, /*num_fused_instructions=*/10);
+}
+
+TEST_F(SoftmaxFusionTest, FusesLayerNorm) {
+  ExpectSoftmaxFusion(kLayerNormHlo, /*num_fused_instructions=*/20);
+}
+
+TEST_F(SoftmaxFusionTest, DoesNotFuseWithoutRowReduction) {
+  auto module = ParseAndReturnVerifiedModule(R"(
+HloModule m
+
+ENTRY main {
+  param_0 = f32[128,512] parameter(0)
+  exponential = f32[128,512] exponential(param_0)
+  ROOT negate = f32[128,512] negate(exponential)
+}
+)")
+                    .value();
+  EXPECT_FALSE(SoftmaxFusion().Run(module.get()).value());
+}
+
+TEST_F(SoftmaxFusionTest, DoesNotFuseColumnReduction) {
+  auto module = ParseAndReturnVerifiedModule(R"(
+HloModule m
+
+add_computation {
+  arg_0 = f32[] parameter(0)
+  arg_1 = f32[] parameter(1)
+  ROOT add = f32[] add(arg_0, arg_1)
+}
+
+ENTRY main {
+  param_0 = f32[128,512] parameter(0)
+  constant_zero = f32[] constant(0)
+  sum = f32[512] reduce(param_0, constant_zero), dimensions={0}, to_apply=add_computation
+  broadcast_sum = f32[128,512] broadcast(sum), dimensions={1}
+  ROOT divide = f32[128,512] divide(param_0, broadcast_sum)
+}
+)")
+                    .value();
+  EXPECT_FALSE(SoftmaxFusion().Run(module.get()).value());
+}
+
+TEST_F(SoftmaxFusionTest, DoesNotFuseReductionWithOtherUsers) {
+  auto module = ParseAndReturnVerifiedModule(R"(
+HloModule m
+
+add_computation {
+  arg_0 = f32[] parameter(0)
+  arg_1 = f32[] parameter(1)
+  ROOT add = f32[] add(arg_0, arg_1)
+}
+
+ENTRY main {
+  param_0 = f32[128,512] parameter(0)
+  exponential = f32[128,512] exponential(param_0)
+  constant_zero = f32[] constant(0)
+  sum = f32[128] reduce(exponential, constant_zero), dimensions={1}, to_apply=add_computation
+  broadcast_sum = f32[128,512] broadcast(sum), dimensions={0}
+  divide = f32[128,512] divide(exponential, broadcast_sum)
+  ROOT tuple = (f32[128,512], f32[128]) tuple(divide, sum)
+}
+)")
+                    .value();
+  // `sum` is also an output of the computation, so it cannot be fused without
+  // making the fusion multi-output.
+  EXPECT_FALSE(SoftmaxFusion().Run(module.get()).value());
+}
+
+TEST_F(SoftmaxFusionTest, SoftmaxExecutesCorrectly) {
+  EXPECT_TRUE(RunAndCompare(kSoftmaxHlo, ErrorSpec{1e-5, 1e-5}));
+}
+
+TEST_F(SoftmaxFusionTest, LayerNormExecutesCorrectly) {
+  EXPECT_TRUE(RunAndCompare(kLayerNormHlo, ErrorSpec{1e-4, 1e-4}));
+}
+
+TEST_F(SoftmaxFusionTest, SoftmaxOfSmallRowsExecutesCorrectly) {
+  // Rows shorter than a warp are reduced by a single, partially idle warp.
+  EXPECT_TRUE(RunAndCompare(R"(
+HloModule softmax
+
+max_computation {
+  arg_0 = f32[] parameter(0)
+  arg_1 = f32[] parameter(1)
+  ROOT maximum = f32[] maximum(arg_0, arg_1)
+}
+
+add_computation {
+  arg_0 = f32[] parameter(0)
+  arg_1 = f32[] parameter(1)
+  ROOT add = f32[] add(arg_0, arg_1)
+}
+
+ENTRY main {
+  param_0 = f32[300,7] parameter(0)
+  constant_neg_inf = f32[] constant(-inf)
+  reduce = f32[300] reduce(param_0, constant_neg_inf), dimensions={1}, to_apply=max_computation
+  broadcast = f32[300,7] broadcast(reduce), dimensions={0}
+  subtract = f32[300,7] subtract(param_0, broadcast)
+  exponential = f32[300,7] exponential(subtract)
+  constant_zero = f32[] constant(0)
+  sum = f32[300] reduce(exponential, constant_zero), dimensions={1}, to_apply=add_computation
+  broadcast_sum = f32[300,7] broadcast(sum), dimensions={0}
+  ROOT divide = f32[300,7] divide(exponential, broadcast_sum)
+}
+)",
+                            ErrorSpec{1e-5, 1e-5}));
+}
+
+}  // namespace
+}  // namespace gpu
+}  // namespace xla
@@ -65,8 +65,10 @@ std::string GpuCodegenTest::MakePlatformSpecificLlvm(absl::string_view input) {
         is_built_with_rocm_ ? "amdgpu_kernel void" : "void"},
        {"BARRIER",
         is_built_with_rocm_ ? "@llvm.amdgcn.s.barrier" : "@llvm.nvvm.barrier0"},
-       {"SHUFFLE", is_built_with_rocm_ ? "i32 @llvm.amdgcn.ds.bpermute"
-                                       : "float @llvm.nvvm.shfl.sync.down.f32"},
+       {"SHUFFLE",
+        is_built_with_rocm_
+            ? "i32 @llvm.amdgcn.{{update.dpp.i32|ds.swizzle|ds.bpermute}}"
+            : "float @llvm.nvvm.shfl.sync.down.f32"},
        {"TIDX", is_built_with_rocm_ ? "@llvm.amdgcn.workitem.id.x"
                                     : "@llvm.nvvm.read.ptx.sreg.tid.x"},
        {"LCAL", is_built_with_rocm_ ? "%[[LOGICAL_T1:.*]] = call { i1, i64 } "
@@ -820,7 +820,7 @@ TEST_F(GpuKernelTilingTest, RowReductionCorrectShmemUsage) {
   )";
   auto hlo_module = ParseAndReturnVerifiedModule(kHloString).value();
   auto expected_ir = is_built_with_rocm_ ? R"(
-; CHECK: %llvm.amdgcn.kernel.fusion.lds.t = type { [1 x [1 x [2 x float]]] }
+; CHECK: %llvm.amdgcn.kernel.fusion.lds.t = type { [1 x [1 x [{{1|2}} x float]]] }
 ; CHECK: @llvm.amdgcn.kernel.fusion.lds = internal addrspace(3) global %llvm.amdgcn.kernel.fusion.lds.t undef, align 8
   )"
                                          : R"(
@@ -830,6 +830,38 @@ TEST_F(GpuKernelTilingTest, RowReductionCorrectShmemUsage) {
                      /*match_optimized_ir=*/true);
 }
 
+TEST_F(GpuKernelTilingTest, RowReductionUsesCrossLaneOpsOnAmdgpu) {
+  if (!is_built_with_rocm_) {
+    GTEST_SKIP() << "DPP and ds_swizzle are AMDGPU instructions.";
+  }
+  const char *const kHloString = R"(
+  HloModule RowReduce
+
+  Sum {
+    x.1 = f32[] parameter(0)
+    y.1 = f32[] parameter(1)
+    ROOT add.1 = f32[] add(x.1, y.1)
+  }
+
+  ENTRY reduce.1 {
+    parameter = f32[1024,4096] parameter(0)
+    init_value = f32[] constant(0)
+    ROOT reduce = f32[1024] reduce(parameter, init_value), dimensions={1}, to_apply=Sum
+  }
+  )";
+  auto hlo_module = ParseAndReturnVerifiedModule(kHloString).value();
+  // Short shuffle distances use DPP row shifts and the distance of 16 lanes
+  // uses ds_swizzle instead of going through LDS.
+  auto expected_ir = R"(
+; CHECK: call i32 @llvm.amdgcn.ds.swizzle
+; CHECK: call i32 @llvm.amdgcn.update.dpp.i32
+)";
+  CompileAndVerifyIr(std::move(hlo_module), expected_ir,
+                     /*match_optimized_ir=*/true);
+
+  EXPECT_TRUE(RunAndCompareNoHloPasses(kHloString, ErrorSpec{0.001}));
+}
+
 TEST_F(GpuKernelTilingTest, ReductionInputTooLarge) {
   const char *const kHloString = R"(
   HloModule RowReduce
@@ -133,8 +133,10 @@ CHECK-NOT: icmp ult i32 %[[masked_thread_id]], 16
 // Verify that we only do one warp reducton by checking that there are 6
 // shfl.sync corresponding to 1 declaration and 5 shuffle instructions.  The
 // second warp reduction was originally produced for inter-warp reduction
-// which we have now optimized away.
-CHECK-COUNT-6: SHUFFLE
+// which we have now optimized away. On AMDGPU the shuffles use DPP for the
+// four shortest distances and ds_swizzle for the longest one, so there are
+// two declarations.
+CHECK-COUNT-NUM_SHUFFLES: SHUFFLE
 CHECK-NOT: SHUFFLE
 )";
 
@@ -143,8 +145,9 @@ CHECK-NOT: SHUFFLE
       {"X_THREAD", is_built_with_rocm_ ? 
         "@llvm.amdgcn.workitem.id.x" :
         "@llvm.nvvm.read.ptx.sreg.tid.x"},
+      {"NUM_SHUFFLES", is_built_with_rocm_ ? "7" : "6"},
       {"SHUFFLE", is_built_with_rocm_ ?
-        "llvm.amdgcn.ds.bpermute" :
+        "llvm.amdgcn.{{update.dpp.i32|ds.swizzle|ds.bpermute}}" :
        	"llvm.nvvm.shfl.sync.down.f32"}});
 
   CompileAndVerifyIr(hlo_text, expected_optimized_llvm_ir, true);
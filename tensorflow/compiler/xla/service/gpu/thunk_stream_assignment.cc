@@ -0,0 +1,221 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/service/gpu/thunk_stream_assignment.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/algorithm/container.h"
+#include "absl/strings/str_join.h"
+#include "llvm/ADT/SetVector.h"
+#include "llvm/ADT/SmallVector.h"
+#include "mlir/IR/BuiltinTypes.h"  // from @llvm-project
+#include "mlir/IR/Operation.h"  // from @llvm-project
+#include "mlir/IR/Value.h"  // from @llvm-project
+#include "mlir/Interfaces/SideEffectInterfaces.h"  // from @llvm-project
+#include "mlir/Transforms/RegionUtils.h"  // from @llvm-project
+#include "tensorflow/compiler/xla/mlir_hlo/lhlo/IR/lhlo_ops.h"
+#include "tensorflow/compiler/xla/service/gpu/ir_emission_utils.h"
+#include "tensorflow/tsl/platform/logging.h"
+
+namespace xla {
+namespace gpu {
+namespace {
+
+// The number of thunks to look back on each stream for a dependency. Beyond
+// that a thunk conservatively depends on the last thunk it looked at.
+constexpr int64_t kMaxLookback = 256;
+
+ThunkBufferUses::Placement GetPlacement(Thunk::Kind kind) {
+  switch (kind) {
+    case Thunk::kKernel:
+    case Thunk::kCopy:
+    case Thunk::kMemset32BitValue:
+    case Thunk::kMemzero:
+      return ThunkBufferUses::kAnyStream;
+    case Thunk::kCholesky:
+    case Thunk::kConvolution:
+    case Thunk::kConvolutionReorder:
+    case Thunk::kCublasLtMatmul:
+    case Thunk::kCustomCall:
+    case Thunk::kFft:
+    case Thunk::kGemm:
+    case Thunk::kTriangularSolve:
+      return ThunkBufferUses::kMainStream;
+    default:
+      return ThunkBufferUses::kBarrier;
+  }
+}
+
+// Returns the buffers accessed by the operation of `thunk`. Thunks whose
+// buffers can't be determined are barriers.
+ThunkBufferUses GetBufferUses(Thunk& thunk,
+                              absl::Span<const BufferAllocation> allocations) {
+  ThunkBufferUses barrier;
+  mlir::Operation* op = thunk.op();
+  ThunkBufferUses::Placement placement = GetPlacement(thunk.kind());
+  if (op == nullptr || placement == ThunkBufferUses::kBarrier) return barrier;
+
+  llvm::SmallVector<mlir::Value> reads;
+  llvm::SmallVector<mlir::Value> writes;
+  if (auto fusion = mlir::dyn_cast<mlir::lmhlo::FusionOp>(op)) {
+    reads = fusion.getInputBuffers();
+    writes = fusion.getOutputBuffers();
+  } else {
+    // Buffers used by the regions of an operation are not its operands.
+    if (op->getNumRegions() > 0) {
+      llvm::SetVector<mlir::Value> used_values;
+      mlir::getUsedValuesDefinedAbove(op->getRegions(), used_values);
+      if (!used_values.empty()) return barrier;
+    }
+    if (!mlir::isa<mlir::MemoryEffectOpInterface>(op)) return barrier;
+    for (mlir::Value operand : op->getOperands()) {
+      if (!operand.getType().isa<mlir::MemRefType>()) continue;
+      (WritesMlirBuffer(op, operand) ? writes : reads).push_back(operand);
+    }
+  }
+
+  ThunkBufferUses uses;
+  uses.placement = placement;
+  for (auto [values, is_write] : {std::make_pair(&reads, false),
+                                  std::make_pair(&writes, true)}) {
+    for (mlir::Value value : *values) {
+      StatusOr<BufferAllocation::Slice> slice =
+          GetAllocationSlice(value, allocations);
+      if (!slice.ok()) return barrier;
+      uses.uses.push_back({*slice, is_write});
+    }
+  }
+  return uses;
+}
+
+bool DependsOn(const ThunkBufferUses& a, const ThunkBufferUses& b) {
+  if (a.placement == ThunkBufferUses::kBarrier ||
+      b.placement == ThunkBufferUses::kBarrier) {
+    return true;
+  }
+  for (const ThunkBufferUses::Use& use_a : a.uses) {
+    for (const ThunkBufferUses::Use& use_b : b.uses) {
+      if ((use_a.is_write || use_b.is_write) &&
+          use_a.slice.OverlapsWith(use_b.slice)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+ThunkStreamAssignment ThunkStreamAssignment::Create(
+    const ThunkSequence& thunks, absl::Span<const BufferAllocation> allocations,
+    int num_streams) {
+  std::vector<ThunkBufferUses> uses;
+  uses.reserve(thunks.size());
+  for (const std::unique_ptr<Thunk>& thunk : thunks) {
+    uses.push_back(GetBufferUses(*thunk, allocations));
+  }
+  return Create(uses, num_streams);
+}
+
+ThunkStreamAssignment ThunkStreamAssignment::Create(
+    absl::Span<const ThunkBufferUses> thunks, int num_streams) {
+  ThunkStreamAssignment assignment;
+  const int64_t num_thunks = thunks.size();
+  assignment.num_streams_ = std::max(num_streams, 1);
+  assignment.streams_.assign(num_thunks, 0);
+  assignment.waits_.resize(num_thunks);
+  assignment.needs_event_.assign(num_thunks, false);
+  if (assignment.num_streams_ == 1) return assignment;
+
+  const int n = assignment.num_streams_;
+  // The thunks assigned to each stream, in order.
+  std::vector<std::vector<int64_t>> on_stream(n);
+  // For each stream, the last thunk on every stream that is known to be
+  // complete before the next thunk enqueued on the stream runs.
+  std::vector<std::vector<int64_t>> stream_synced(n,
+                                                  std::vector<int64_t>(n, -1));
+  // The same for each thunk, once it has been enqueued.
+  std::vector<std::vector<int64_t>> thunk_synced(num_thunks);
+  int64_t last_barrier = -1;
+
+  for (int64_t i = 0; i < num_thunks; ++i) {
+    const ThunkBufferUses& thunk = thunks[i];
+
+    // The last thunk on each stream that thunk `i` depends on. Thunks before
+    // the last barrier are complete before it, so there is no need to look
+    // further back.
+    std::vector<int64_t> last_dependency(n, -1);
+    for (int s = 0; s < n; ++s) {
+      const std::vector<int64_t>& candidates = on_stream[s];
+      for (int64_t k = candidates.size() - 1, looked = 0;
+           k >= 0 && candidates[k] >= last_barrier; --k, ++looked) {
+        if (looked == kMaxLookback ||
+            DependsOn(thunk, thunks[candidates[k]])) {
+          last_dependency[s] = candidates[k];
+          break;
+        }
+      }
+    }
+
+    int stream = 0;
+    if (thunk.placement == ThunkBufferUses::kAnyStream) {
+      auto latest = absl::c_max_element(last_dependency);
+      if (*latest >= 0) {
+        // Continue on the stream of the latest dependency.
+        stream = latest - last_dependency.begin();
+      } else {
+        // Otherwise pick the least recently used stream.
+        auto last_used = [&](int s) {
+          return on_stream[s].empty() ? -1 : on_stream[s].back();
+        };
+        for (int s = 1; s < n; ++s) {
+          if (last_used(s) < last_used(stream)) stream = s;
+        }
+      }
+    }
+
+    std::vector<int64_t>& synced = stream_synced[stream];
+    for (int s = 0; s < n; ++s) {
+      if (s == stream || last_dependency[s] <= synced[s]) continue;
+      const int64_t dependency = last_dependency[s];
+      assignment.waits_[i].push_back(dependency);
+      assignment.needs_event_[dependency] = true;
+      for (int t = 0; t < n; ++t) {
+        synced[t] = std::max(synced[t], thunk_synced[dependency][t]);
+      }
+    }
+    synced[stream] = i;
+    thunk_synced[i] = synced;
+    on_stream[stream].push_back(i);
+    assignment.streams_[i] = stream;
+    if (thunk.placement == ThunkBufferUses::kBarrier) last_barrier = i;
+  }
+
+  if (VLOG_IS_ON(2)) {
+    std::vector<int64_t> thunks_per_stream(n);
+    for (int s = 0; s < n; ++s) thunks_per_stream[s] = on_stream[s].size();
+    VLOG(2) << "Assigned " << num_thunks << " thunks to " << n
+            << " streams: " << absl::StrJoin(thunks_per_stream, ", ");
+  }
+  return assignment;
+}
+
+}  // namespace gpu
+}  // namespace xla
@@ -0,0 +1,101 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_COMPILER_XLA_SERVICE_GPU_THUNK_STREAM_ASSIGNMENT_H_
+#define TENSORFLOW_COMPILER_XLA_SERVICE_GPU_THUNK_STREAM_ASSIGNMENT_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "absl/types/span.h"
+#include "tensorflow/compiler/xla/service/buffer_assignment.h"
+#include "tensorflow/compiler/xla/service/gpu/thunk.h"
+
+namespace xla {
+namespace gpu {
+
+// The buffers a thunk reads and writes, and where it is allowed to run.
+struct ThunkBufferUses {
+  enum Placement {
+    // Kernels, copies and memsets can run on any stream.
+    kAnyStream,
+    // Library calls share per-executor handles and workspaces between streams,
+    // so they stay on the main stream. They are still ordered only after the
+    // thunks they depend on.
+    kMainStream,
+    // Thunks with nested thunk sequences, collectives and feeds run on the main
+    // stream after all previous thunks and before all later ones.
+    kBarrier,
+  };
+
+  struct Use {
+    BufferAllocation::Slice slice;
+    bool is_write;
+  };
+
+  Placement placement = kBarrier;
+  std::vector<Use> uses;
+};
+
+// Assigns the thunks of a sequence to a pool of streams, so that independent
+// thunks run concurrently instead of one after the other on the main stream.
+// Two thunks depend on each other if they access overlapping slices and one of
+// them writes; the later one then waits for an event recorded after the
+// earlier one. As buffer assignment reuses memory based on the sequential
+// order of the thunks, this also orders thunks whose buffers share memory.
+//
+// Stream 0 is the main stream of the execution. All other streams wait for the
+// main stream when the execution starts and the main stream waits for all of
+// them when it ends, so that the streams fork from and join the main stream as
+// required for graph capture.
+class ThunkStreamAssignment {
+ public:
+  // Assigns `thunks` to up to `num_streams` streams. The thunks must still
+  // hold the LMHLO operations they were emitted from.
+  static ThunkStreamAssignment Create(
+      const ThunkSequence& thunks,
+      absl::Span<const BufferAllocation> allocations, int num_streams);
+
+  // Assigns thunks with the given buffer uses to up to `num_streams` streams.
+  static ThunkStreamAssignment Create(absl::Span<const ThunkBufferUses> thunks,
+                                      int num_streams);
+
+  int num_streams() const { return num_streams_; }
+
+  // The stream the thunk at `thunk_index` runs on.
+  int stream(int64_t thunk_index) const { return streams_[thunk_index]; }
+
+  // The thunks running on other streams that the thunk at `thunk_index` has to
+  // wait for.
+  absl::Span<const int64_t> waits(int64_t thunk_index) const {
+    return waits_[thunk_index];
+  }
+
+  // Whether a later thunk waits for the thunk at `thunk_index`.
+  bool needs_event(int64_t thunk_index) const {
+    return needs_event_[thunk_index];
+  }
+
+ private:
+  int num_streams_ = 1;
+  std::vector<int> streams_;
+  std::vector<std::vector<int64_t>> waits_;
+  std::vector<bool> needs_event_;
+};
+
+}  // namespace gpu
+}  // namespace xla
+
+#endif  // TENSORFLOW_COMPILER_XLA_SERVICE_GPU_THUNK_STREAM_ASSIGNMENT_H_
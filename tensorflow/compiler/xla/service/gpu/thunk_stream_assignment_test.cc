@@ -0,0 +1,143 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/service/gpu/thunk_stream_assignment.h"
+
+#include <cstdint>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "tensorflow/compiler/xla/service/buffer_assignment.h"
+
+namespace xla {
+namespace gpu {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+class ThunkStreamAssignmentTest : public ::testing::Test {
+ protected:
+  ThunkStreamAssignmentTest()
+      : alloc_(/*index=*/0, /*size=*/1024, /*color=*/0),
+        a_(&alloc_, /*offset=*/0, /*size=*/256),
+        b_(&alloc_, /*offset=*/256, /*size=*/256),
+        c_(&alloc_, /*offset=*/512, /*size=*/256) {}
+
+  static ThunkBufferUses Uses(
+      ThunkBufferUses::Placement placement,
+      std::vector<BufferAllocation::Slice> reads,
+      std::vector<BufferAllocation::Slice> writes) {
+    ThunkBufferUses uses;
+    uses.placement = placement;
+    for (const BufferAllocation::Slice& slice : reads) {
+      uses.uses.push_back({slice, /*is_write=*/false});
+    }
+    for (const BufferAllocation::Slice& slice : writes) {
+      uses.uses.push_back({slice, /*is_write=*/true});
+    }
+    return uses;
+  }
+
+  BufferAllocation alloc_;
+  BufferAllocation::Slice a_;
+  BufferAllocation::Slice b_;
+  BufferAllocation::Slice c_;
+};
+
+TEST_F(ThunkStreamAssignmentTest, IndependentThunksRunConcurrently) {
+  std::vector<ThunkBufferUses> thunks = {
+      Uses(ThunkBufferUses::kAnyStream, {}, {a_}),
+      Uses(ThunkBufferUses::kAnyStream, {}, {b_}),
+  };
+  ThunkStreamAssignment assignment =
+      ThunkStreamAssignment::Create(thunks, /*num_streams=*/2);
+  EXPECT_EQ(assignment.stream(0), 0);
+  EXPECT_EQ(assignment.stream(1), 1);
+  EXPECT_THAT(assignment.waits(1), IsEmpty());
+  EXPECT_FALSE(assignment.needs_event(0));
+}
+
+TEST_F(ThunkStreamAssignmentTest, DependentThunkWaitsForOtherStreams) {
+  std::vector<ThunkBufferUses> thunks = {
+      Uses(ThunkBufferUses::kAnyStream, {}, {a_}),
+      Uses(ThunkBufferUses::kAnyStream, {}, {b_}),
+      Uses(ThunkBufferUses::kAnyStream, {a_, b_}, {c_}),
+  };
+  ThunkStreamAssignment assignment =
+      ThunkStreamAssignment::Create(thunks, /*num_streams=*/2);
+  // The last thunk continues on the stream of its latest dependency.
+  EXPECT_EQ(assignment.stream(2), 1);
+  EXPECT_THAT(assignment.waits(2), ElementsAre(0));
+  EXPECT_TRUE(assignment.needs_event(0));
+  EXPECT_FALSE(assignment.needs_event(1));
+}
+
+TEST_F(ThunkStreamAssignmentTest, ReadersDoNotDependOnEachOther) {
+  std::vector<ThunkBufferUses> thunks = {
+      Uses(ThunkBufferUses::kAnyStream, {a_}, {b_}),
+      Uses(ThunkBufferUses::kAnyStream, {a_}, {c_}),
+  };
+  ThunkStreamAssignment assignment =
+      ThunkStreamAssignment::Create(thunks, /*num_streams=*/2);
+  EXPECT_NE(assignment.stream(0), assignment.stream(1));
+  EXPECT_THAT(assignment.waits(1), IsEmpty());
+}
+
+TEST_F(ThunkStreamAssignmentTest, BarrierJoinsAllStreams) {
+  std::vector<ThunkBufferUses> thunks = {
+      Uses(ThunkBufferUses::kAnyStream, {}, {a_}),
+      Uses(ThunkBufferUses::kAnyStream, {}, {b_}),
+      ThunkBufferUses(),
+      Uses(ThunkBufferUses::kAnyStream, {}, {c_}),
+  };
+  ThunkStreamAssignment assignment =
+      ThunkStreamAssignment::Create(thunks, /*num_streams=*/2);
+  EXPECT_EQ(assignment.stream(2), 0);
+  EXPECT_THAT(assignment.waits(2), ElementsAre(1));
+  // Everything after the barrier depends on it.
+  EXPECT_EQ(assignment.stream(3), 0);
+  EXPECT_THAT(assignment.waits(3), IsEmpty());
+}
+
+TEST_F(ThunkStreamAssignmentTest, LibraryCallsStayOnMainStream) {
+  std::vector<ThunkBufferUses> thunks = {
+      Uses(ThunkBufferUses::kAnyStream, {}, {a_}),
+      Uses(ThunkBufferUses::kAnyStream, {}, {b_}),
+      Uses(ThunkBufferUses::kMainStream, {b_}, {c_}),
+  };
+  ThunkStreamAssignment assignment =
+      ThunkStreamAssignment::Create(thunks, /*num_streams=*/2);
+  EXPECT_EQ(assignment.stream(1), 1);
+  EXPECT_EQ(assignment.stream(2), 0);
+  EXPECT_THAT(assignment.waits(2), ElementsAre(1));
+}
+
+TEST_F(ThunkStreamAssignmentTest, SingleStream) {
+  std::vector<ThunkBufferUses> thunks = {
+      Uses(ThunkBufferUses::kAnyStream, {}, {a_}),
+      Uses(ThunkBufferUses::kAnyStream, {}, {b_}),
+  };
+  ThunkStreamAssignment assignment =
+      ThunkStreamAssignment::Create(thunks, /*num_streams=*/1);
+  EXPECT_EQ(assignment.stream(0), 0);
+  EXPECT_EQ(assignment.stream(1), 0);
+  EXPECT_FALSE(assignment.needs_event(0));
+}
+
+}  // namespace
+}  // namespace gpu
+}  // namespace xla
@@ -80,6 +80,10 @@ limitations under the License.
 #include "tensorflow/tsl/protobuf/autotuning.pb.h"
 #include "tensorflow/tsl/util/proto/proto_utils.h"
 
+#if TENSORFLOW_USE_ROCM
+#include "tensorflow/tsl/platform/rocm_rocdl_path.h"
+#endif  // TENSORFLOW_USE_ROCM
+
 namespace xla {
 namespace gpu {
 
@@ -301,8 +305,13 @@ class TritonAutotunerVisitor : public DfsHloRewriteVisitor {
 
     const std::vector<AutotuneResult::TritonGemmKey> configurations =
         GetPossibleMatmulAutotuneConfigs(
+#if GOOGLE_CUDA
             device_config.stream_exec->GetDeviceDescription()
                 .cuda_compute_capability());
+#else
+            device_config.stream_exec->GetDeviceDescription()
+                .rocm_compute_capability());
+#endif  // GOOGLE_CUDA
 
     // Pre-compile all versions first using the thread pool.
     if (thread_pool_) {
@@ -592,10 +601,15 @@ class TritonAutotunerVisitor : public DfsHloRewriteVisitor {
                            .Run(new_hlo_module.get())
                            .status());
 
+#if GOOGLE_CUDA
+    const char* target_triple = nvptx::TargetTriple();
+    const char* data_layout = nvptx::DataLayout();
+#else
+    const char* target_triple = amdgpu::TargetTriple();
+    const char* data_layout = amdgpu::DataLayout();
+#endif  // GOOGLE_CUDA
     Status compilation_status = xla::gpu::CompileModuleToLlvmIrImpl(
-        new_hlo_module.get(), &llvm_context,
-        /*target_triple=*/nvptx::TargetTriple(),
-        /*data_layout=*/nvptx::DataLayout(),
+        new_hlo_module.get(), &llvm_context, target_triple, data_layout,
         /*platform_name=*/device_config.stream_exec->platform()->Name(),
         /*platform_id=*/device_config.stream_exec->platform()->id(),
         gpu_device_info, device_description.cuda_compute_capability(),
@@ -624,6 +638,7 @@ class TritonAutotunerVisitor : public DfsHloRewriteVisitor {
       launch_dimensions.push_back(kernel_thunk->launch_dimensions());
     }
 
+#if GOOGLE_CUDA
     TF_ASSIGN_OR_RETURN(
         std::string ptx,
         nvptx::CompileToPtx(compile_module_results.llvm_module.get(),
@@ -636,6 +651,16 @@ class TritonAutotunerVisitor : public DfsHloRewriteVisitor {
         std::vector<uint8_t> cubin,
         se::CompileGpuAsm(device_config.stream_exec->device_ordinal(),
                           ptx.c_str(), ptxas_config));
+#else
+    // On ROCm the kernels are loaded from the HSA code object, which takes
+    // the place of the cubin; there is no intermediate assembly.
+    std::string ptx;
+    TF_ASSIGN_OR_RETURN(
+        std::vector<uint8_t> cubin,
+        amdgpu::CompileToHsaco(compile_module_results.llvm_module.get(),
+                               device_description.rocm_compute_capability(),
+                               new_hlo_module->config(), tsl::RocdlRoot()));
+#endif  // GOOGLE_CUDA
 
     uint64_t end_compilation_nanos = tsl::Env::Default()->NowNanos();
     absl::Duration compilation_time_span =
@@ -690,6 +715,30 @@ std::vector<AutotuneResult::TritonGemmKey> GetPossibleMatmulAutotuneConfigs(
   return configs;
 }
 
+std::vector<AutotuneResult::TritonGemmKey> GetPossibleMatmulAutotuneConfigs(
+    se::RocmComputeCapability compute_capability) {
+  // MFMA instructions operate on 32x32 or 16x16 output tiles per wavefront of
+  // 64 threads, so block_m and block_n are kept multiples of 32 whenever
+  // matrix cores are available and num_warps counts wavefronts. AMD GPUs also
+  // have a 64KiB LDS, which limits software pipelining to at most two stages.
+  std::vector<AutotuneResult::TritonGemmKey> configs = {
+      GemmKey(32, 32, 256, 1, 1, 4), GemmKey(64, 32, 32, 16, 1, 4),
+      GemmKey(32, 64, 64, 4, 1, 4),  GemmKey(64, 64, 64, 1, 1, 4),
+      GemmKey(32, 32, 128, 8, 1, 4), GemmKey(64, 32, 64, 1, 2, 4)};
+  if (compute_capability.has_mfma_instr_support()) {
+    absl::c_copy(
+        std::vector<AutotuneResult::TritonGemmKey>{
+            GemmKey(128, 128, 32, 1, 1, 4),  GemmKey(128, 128, 64, 1, 1, 4),
+            GemmKey(256, 128, 32, 1, 1, 8),  GemmKey(128, 256, 32, 1, 1, 8),
+            GemmKey(128, 64, 64, 1, 2, 4),   GemmKey(64, 128, 64, 1, 2, 4),
+            GemmKey(256, 256, 32, 1, 1, 8),  GemmKey(128, 128, 32, 4, 1, 4),
+            GemmKey(64, 64, 128, 8, 1, 4),   GemmKey(32, 128, 64, 1, 2, 4),
+            GemmKey(128, 32, 64, 1, 2, 4),   GemmKey(64, 256, 32, 1, 1, 4)},
+        std::back_inserter(configs));
+  }
+  return configs;
+}
+
 std::unique_ptr<HloModule> ExtractInstructionIntoNewModule(
     const HloInstruction& hlo) {
   auto new_hlo_module = std::make_unique<HloModule>(
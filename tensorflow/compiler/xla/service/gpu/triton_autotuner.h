@@ -58,6 +58,11 @@ class TritonAutotuner : public HloModulePass {
 std::vector<tensorflow::AutotuneResult::TritonGemmKey>
 GetPossibleMatmulAutotuneConfigs(se::CudaComputeCapability compute_capability);
 
+// Returns a list of possible tilings for a gemm performed in Triton on an AMD
+// GPU; tiles are sized for the MFMA instructions when they are available.
+std::vector<tensorflow::AutotuneResult::TritonGemmKey>
+GetPossibleMatmulAutotuneConfigs(se::RocmComputeCapability compute_capability);
+
 // Extracts an HLO instruction into a new HLO module replacing its operands
 // with parameter instructions.
 std::unique_ptr<HloModule> ExtractInstructionIntoNewModule(
@@ -158,6 +158,22 @@ TEST_F(TritonAutotunerTest, AmpereUsesMoreThanTwoStages) {
                   }));
 }
 
+TEST_F(TritonAutotunerTest, MfmaConfigsUseNoMoreThanTwoStages) {
+  const se::RocmComputeCapability compute_capability{"gfx90a"};
+  const std::vector<tensorflow::AutotuneResult::TritonGemmKey> configs =
+      GetPossibleMatmulAutotuneConfigs(compute_capability);
+  EXPECT_TRUE(
+      std::any_of(configs.begin(), configs.end(),
+                  [](const tensorflow::AutotuneResult::TritonGemmKey& key) {
+                    return key.block_m() >= 128 && key.block_n() >= 128;
+                  }));
+  EXPECT_FALSE(
+      std::any_of(configs.begin(), configs.end(),
+                  [](const tensorflow::AutotuneResult::TritonGemmKey& key) {
+                    return key.num_stages() > 2;
+                  }));
+}
+
 TEST_F(TritonAutotunerTest, Int8FusedGemm) {
   const std::string hlo = R"(
 HloModule module
@@ -44,6 +44,8 @@ limitations under the License.
 #include "tensorflow/compiler/xla/service/memory_space_assignment_repacking.h"
 #include "tensorflow/compiler/xla/status.h"
 #include "tensorflow/compiler/xla/util.h"
+#include "tensorflow/tsl/platform/env.h"
+#include "tensorflow/tsl/platform/threadpool.h"
 
 namespace xla {
 
@@ -1807,10 +1809,26 @@ HeapSimulator::Result<BufferType>
 ChooseBestHeapAlgorithm<BufferType>::Finish() {
   DCHECK(!algorithms_.empty());
   std::vector<Result> results(algorithms_.size());
+  // The algorithms only share the buffers, which they do not modify, so they
+  // can run concurrently. Below this many buffers, starting the threads costs
+  // more than it saves.
+  constexpr int64_t kMinBuffersForParallelFinish = 1000;
+  if (algorithms_.size() > 1 && num_buffers_ >= kMinBuffersForParallelFinish) {
+    tsl::thread::ThreadPool pool(tsl::Env::Default(), "heap_simulator",
+                                 algorithms_.size());
+    for (int i = 0; i < algorithms_.size(); ++i) {
+      pool.Schedule(
+          [this, &results, i] { results[i] = algorithms_[i]->Finish(); });
+    }
+    // The destructor of the pool waits for the algorithms to finish.
+  } else {
+    for (int i = 0; i < algorithms_.size(); ++i) {
+      results[i] = algorithms_[i]->Finish();
+    }
+  }
   int64_t min_size = INT64_MAX;
   int min_size_index = -1;
   for (int i = 0; i < algorithms_.size(); ++i) {
-    results[i] = algorithms_[i]->Finish();
     if (results[i].heap_size < min_size) {
       min_size = results[i].heap_size;
       min_size_index = i;
@@ -830,6 +830,7 @@ class ChooseBestHeapAlgorithm : public HeapAlgorithm<BufferType> {
   ~ChooseBestHeapAlgorithm() override {}
 
   void Alloc(const BufferType* buffer, int64_t size) override {
+    ++num_buffers_;
     for (auto& algorithm : algorithms_) {
       algorithm->Alloc(buffer, size);
     }
@@ -837,6 +838,7 @@ class ChooseBestHeapAlgorithm : public HeapAlgorithm<BufferType> {
 
   void ShareWith(const BufferType* buffer, const BufferType* share_with,
                  int64_t size) override {
+    ++num_buffers_;
     for (auto& algorithm : algorithms_) {
       algorithm->ShareWith(buffer, share_with, size);
     }
@@ -848,10 +850,13 @@ class ChooseBestHeapAlgorithm : public HeapAlgorithm<BufferType> {
     }
   }
 
+  // Runs the algorithms concurrently when there are enough buffers for it to
+  // pay off, and returns the result with the smallest heap.
   Result Finish() override;
 
  private:
   std::vector<std::unique_ptr<HeapAlgorithm<BufferType>>> algorithms_;
+  int64_t num_buffers_ = 0;
 };
 
 extern template class GlobalDecreasingSizeBestFitHeap<HloValue>;
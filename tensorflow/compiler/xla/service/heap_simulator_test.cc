@@ -1518,6 +1518,70 @@ TEST_F(ConstrainedGlobalDecreasingSizeBestFitHeapTest, ColocatedII) {
   EXPECT_EQ(0, result.heap_results[0].chunk_map.at(buffer_c_).offset);
 }
 
+class ChooseBestHeapAlgorithmTest : public ::testing::Test {
+ protected:
+  ChooseBestHeapAlgorithmTest() : builder_("heap_simulator_test") {}
+
+  const HloValue* DummyBufferValue() {
+    const HloValue::Id id = buffers_.size();
+    auto const0 = builder_.AddInstruction(
+        HloInstruction::CreateConstant(LiteralUtil::CreateR0<float>(1.0)));
+    buffers_.emplace_back(std::make_unique<HloValue>(id, const0, ShapeIndex{}));
+    return buffers_.back().get();
+  }
+
+  // Replays the same sequence of buffers, enough of them for the algorithms
+  // to run concurrently, into `heap`.
+  void RunSequence(const std::vector<const HloValue*>& values,
+                   HeapAlgorithm<HloValue>* heap) {
+    for (int i = 0; i < values.size(); ++i) {
+      heap->Alloc(values[i], i % 37 + 1);
+      if (i >= 3) {
+        heap->Free(values[i - 3], (i - 3) % 37 + 1);
+      }
+    }
+    for (int i = std::max<int>(values.size() - 3, 0); i < values.size(); ++i) {
+      heap->Free(values[i], i % 37 + 1);
+    }
+  }
+
+ private:
+  HloComputation::Builder builder_;
+  std::vector<std::unique_ptr<HloValue>> buffers_;
+};
+
+TEST_F(ChooseBestHeapAlgorithmTest, ManyBuffers) {
+  std::vector<const HloValue*> values;
+  for (int i = 0; i < 2000; ++i) {
+    values.push_back(DummyBufferValue());
+  }
+
+  int64_t min_heap_size = INT64_MAX;
+  for (auto type : {GlobalDecreasingSizeBestFitHeap<HloValue>::kSpatial,
+                    GlobalDecreasingSizeBestFitHeap<HloValue>::kTemporal}) {
+    GlobalDecreasingSizeBestFitHeap<HloValue> heap(/*alignment=*/1, type);
+    RunSequence(values, &heap);
+    min_heap_size = std::min(min_heap_size, heap.Finish().heap_size);
+  }
+
+  auto algorithms = std::make_unique<
+      std::vector<std::unique_ptr<HeapAlgorithm<HloValue>>>>();
+  algorithms->push_back(
+      std::make_unique<GlobalDecreasingSizeBestFitHeap<HloValue>>(
+          /*alignment=*/1,
+          GlobalDecreasingSizeBestFitHeap<HloValue>::kSpatial));
+  algorithms->push_back(
+      std::make_unique<GlobalDecreasingSizeBestFitHeap<HloValue>>(
+          /*alignment=*/1,
+          GlobalDecreasingSizeBestFitHeap<HloValue>::kTemporal));
+  ChooseBestHeapAlgorithm<HloValue> heap(std::move(algorithms));
+  RunSequence(values, &heap);
+  const HeapSimulator::Result<HloValue> result = heap.Finish();
+  EXPECT_EQ(result.heap_size, min_heap_size);
+  ASSERT_EQ(result.heap_results.size(), 1);
+  EXPECT_EQ(result.heap_results[0].chunk_map.size(), values.size());
+}
+
 class IntervalTreeTest : public ::testing::Test {};
 
 TEST_F(IntervalTreeTest, InsertAndRemove) {
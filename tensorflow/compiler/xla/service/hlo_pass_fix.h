@@ -67,6 +67,7 @@ class HloPassFix : public Pass {
     int64_t iteration_count = 0;
     VLOG(3) << "Running HloPassFix.";
     while (changed_this_iteration) {
+      SetFixedPointIteration(static_cast<Pass*>(this), iteration_count);
       TF_ASSIGN_OR_RETURN(
           changed_this_iteration,
           Pass::RunOnModuleGroup(module_group, execution_threads));
@@ -84,6 +85,15 @@ class HloPassFix : public Pass {
   }
 
  private:
+  // Tells a pass pipeline which iteration of the loop it runs, see
+  // HloPassPipeline::set_fixed_point_iteration(). Other passes ignore it.
+  template <typename T>
+  static auto SetFixedPointIteration(T* pass, int64_t iteration)
+      -> decltype(pass->set_fixed_point_iteration(iteration)) {
+    return pass->set_fixed_point_iteration(iteration);
+  }
+  static void SetFixedPointIteration(...) {}
+
   Status RunToFixPoint(
       HloModule* module, RunState* run_state,
       const absl::flat_hash_set<absl::string_view>& execution_threads) {
@@ -119,6 +129,7 @@ class HloPassFix : public Pass {
     // If Pass does not override the default
     // HloPassInterface::RunOnChangedComputations that calls into
     // HloPassFix<Pass>::Run, avoid infinite recursion.
+    SetFixedPointIteration(static_cast<Pass*>(this), run_state->iteration);
     TF_ASSIGN_OR_RETURN(bool changed, Pass::Run(module, execution_threads));
     if (changed) {
       auto computations = module->computations(execution_threads);
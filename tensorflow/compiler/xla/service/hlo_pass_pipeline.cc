@@ -170,9 +170,23 @@ StatusOr<bool> HloPassPipeline::RunPassesInternal(
   RecordPassEndMetadata(*hlo, std::string(kPipelineStart),
                         /*module_changed=*/false);
 
+  // Passes can only be skipped in the iterations of a fixed point loop, where
+  // nothing but this pipeline changes the module between its runs.
+  const bool skip_unchanged_passes = fixed_point_iteration_ > 0;
+  fixed_point_iteration_ = 0;
+  if (!skip_unchanged_passes) {
+    passes_since_change_ = 0;
+  }
+
   bool changed = false;
   for (int i = 0; i < passes.size(); i++) {
     HloPassInterface* pass = passes[i];
+    if (skip_unchanged_passes && passes_since_change_ >= passes.size()) {
+      VLOG(1) << "  Skipping HLO pass " << pass->name()
+              << ", the module did not change since it last ran";
+      ++passes_since_change_;
+      continue;
+    }
     XLA_SCOPED_LOGGING_TIMER(absl::StrCat("HLO pass: ", pass->name()));
     std::string pass_name = std::string(pass->name());
     VLOG(1) << "  HLO pass " << pass_name;
@@ -205,6 +219,7 @@ StatusOr<bool> HloPassPipeline::RunPassesInternal(
     }
     RecordPassEndMetadata(*hlo, pass_name, pass_changed);
     changed |= pass_changed;
+    passes_since_change_ = pass_changed ? 0 : passes_since_change_ + 1;
     if (pass_changed) {
       VLOG(3) << "  Pass caused changes " << pass->name();
       // Embed RunInvariantCheckers into lambda to enable recording of errors
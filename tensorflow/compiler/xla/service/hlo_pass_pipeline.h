@@ -89,6 +89,15 @@ class HloPassPipeline : public HloPassInterface {
 
   bool IsPassPipeline() override { return true; }
 
+  // Called by HloPassFix before each run of the pipeline in its fixed point
+  // loop. In the iterations after the first one, the passes that ran without
+  // changing the module, and after which no pass changed it, are skipped: they
+  // would see the same module again. Any other run of the pipeline runs all of
+  // its passes.
+  void set_fixed_point_iteration(int64_t iteration) {
+    fixed_point_iteration_ = iteration;
+  }
+
   // Return size of passes_.
   int PassesSize() { return passes_.size(); }
   // Return reference to pass specified by index.
@@ -155,6 +164,12 @@ class HloPassPipeline : public HloPassInterface {
   std::vector<std::unique_ptr<HloPassInterface>> invariant_checkers_;
   bool run_called_ = false;
 
+  // See set_fixed_point_iteration(). The number of passes that ran (or were
+  // skipped) since the last pass that changed the module, counted across the
+  // iterations of the fixed point loop.
+  int64_t fixed_point_iteration_ = 0;
+  int64_t passes_since_change_ = 0;
+
   CompilationStats* compilation_stats_;
   // Default stats instance for when one is not passed in the constructor.
   // Use via compilation_stats_, not directly.
@@ -19,6 +19,7 @@ limitations under the License.
 #include "tensorflow/compiler/xla/hlo/ir/hlo_instruction.h"
 #include "tensorflow/compiler/xla/hlo/ir/hlo_module.h"
 #include "tensorflow/compiler/xla/service/hlo_parser.h"
+#include "tensorflow/compiler/xla/service/hlo_pass_fix.h"
 #include "tensorflow/compiler/xla/tests/hlo_test_base.h"
 #include "tensorflow/compiler/xla/util.h"
 #include "tensorflow/tsl/lib/core/status_test_util.h"
@@ -133,6 +134,26 @@ class BarBlowerUpper : public HloModulePass {
   }
 };
 
+// A module pass which reports a change in its first `num_changes` runs, and
+// counts its runs.
+class CountingModulePass : public HloModulePass {
+ public:
+  CountingModulePass(int num_changes, int* num_runs)
+      : num_changes_(num_changes), num_runs_(num_runs) {}
+  absl::string_view name() const override { return "counting"; }
+
+  using HloPassInterface::Run;
+  StatusOr<bool> Run(HloModule* module,
+                     const absl::flat_hash_set<absl::string_view>&
+                         execution_threads) override {
+    return ++*num_runs_ <= num_changes_;
+  }
+
+ private:
+  const int num_changes_;
+  int* num_runs_;
+};
+
 TEST_F(HloPassPipelineTest, ModulePassChanged) {
   // Test an HLO module pass which changes a module.
   const std::string module_str = R"(
@@ -176,6 +197,41 @@ ENTRY main {
   EXPECT_FALSE(changed);
 }
 
+TEST_F(HloPassPipelineTest, FixedPointSkipsUnchangedPasses) {
+  const std::string module_str = R"(
+HloModule FixedPointSkipsUnchangedPasses
+
+ENTRY main {
+  a = f32[] parameter(0)
+  b = f32[] parameter(1)
+  ROOT foo = f32[] multiply(a, b)
+}
+)";
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VerifiedHloModule> module,
+                          ParseAndReturnVerifiedModule(module_str));
+  int first_runs = 0;
+  int second_runs = 0;
+  HloPassFix<HloPassPipeline> pipeline(TestName());
+  pipeline.AddPass<CountingModulePass>(/*num_changes=*/2, &first_runs);
+  pipeline.AddPass<CountingModulePass>(/*num_changes=*/0, &second_runs);
+
+  TF_ASSERT_OK_AND_ASSIGN(bool changed, pipeline.Run(module.get()));
+  EXPECT_TRUE(changed);
+  // The first pass changes the module in the first two iterations, and the
+  // third iteration finds the fixed point. The second pass is skipped in the
+  // third iteration, since the module has not changed since it last ran.
+  EXPECT_EQ(first_runs, 3);
+  EXPECT_EQ(second_runs, 2);
+
+  // A run outside of a fixed point loop runs all the passes.
+  TF_ASSERT_OK_AND_ASSIGN(
+      changed, pipeline.HloPassPipeline::Run(module.get(),
+                                             /*execution_threads=*/{}));
+  EXPECT_FALSE(changed);
+  EXPECT_EQ(first_runs, 4);
+  EXPECT_EQ(second_runs, 3);
+}
+
 TEST_F(HloPassPipelineTest, ModulePassChangedForParallelThread) {
   // Test an HLO module pass which changes a module.
   const std::string module_str = R"(
@@ -18,6 +18,7 @@ limitations under the License.
 #include <algorithm>
 #include <memory>
 #include <string>
+#include <utility>
 
 #include "tensorflow/compiler/xla/hlo/ir/hlo_computation.h"
 #include "tensorflow/compiler/xla/hlo/ir/hlo_instruction.h"
@@ -41,9 +42,11 @@ using ::testing::_;
 // RematerializationTestBase for more.
 class HloRematerializationTest : public RematerializationTestBase {
  protected:
-  StatusOr<bool> RunHloRematerialization(int64_t memory_limit_bytes,
-                                         HloModule* module,
-                                         int64_t min_remat_size = 0) {
+  StatusOr<bool> RunHloRematerialization(
+      int64_t memory_limit_bytes, HloModule* module,
+      int64_t min_remat_size = 0,
+      HloRematerialization::RecomputeCostFunction recompute_cost_function =
+          nullptr) {
     TF_EXPECT_OK(verifier().Run(module).status());
     if (!module->has_schedule()) {
       HloMemoryScheduler scheduler(
@@ -57,7 +60,7 @@ class HloRematerializationTest : public RematerializationTestBase {
         HloRematerialization::RematerializationPass::kPreFusion,
         /*block_size_limit=*/1, /*block_rematerialization_factor=*/1, nullptr,
         HloRematerialization::RematerializationMode::kRecomputeAndCompress,
-        min_remat_size);
+        min_remat_size, std::move(recompute_cost_function));
     return remat.Run(module);
   }
 };
@@ -122,6 +125,45 @@ TEST_F(HloRematerializationTest, SingleComputationNoWorthRemat) {
   EXPECT_FALSE(changed);
 }
 
+// Test that of two instructions freeing the same memory, the one that is
+// cheaper to recompute is rematerialized.
+TEST_F(HloRematerializationTest, PrefersCheapRecomputation) {
+  const std::string& hlo_string = R"(
+HloModule module, is_scheduled=true
+
+ENTRY %entry {
+  %p0 = f32[] parameter(0)
+  %p1 = f32[32,32]{1,0} parameter(1)
+  %expensive = f32[32,32]{1,0} dot(%p1, %p1), lhs_contracting_dims={1},
+    rhs_contracting_dims={0}
+  %cheap = f32[32,32]{1,0} broadcast(%p0), dimensions={}
+  %big = f32[2048]{0} broadcast(%p0), dimensions={}
+  %slice = f32[1]{0} slice(%big), slice={[0:1]}
+  %add = f32[32,32]{1,0} add(%expensive, %cheap)
+  ROOT %tuple = (f32[32,32]{1,0}, f32[1]{0}) tuple(%add, %slice)
+}
+)";
+
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(hlo_string));
+  const HloInstruction* add = FindInstruction(module.get(), "add");
+  const HloInstruction* expensive = add->operand(0);
+  const HloInstruction* cheap = add->operand(1);
+
+  // Both %expensive and %cheap are live at %big and rematerializing either of
+  // them brings the peak of about 20KB below the limit.
+  TF_ASSERT_OK_AND_ASSIGN(
+      bool changed,
+      RunHloRematerialization(
+          /*memory_limit_bytes=*/17 * 1024, module.get(),
+          /*min_remat_size=*/0, [](const HloInstruction* instruction) {
+            return instruction->opcode() == HloOpcode::kDot ? 1e9 : 0.0;
+          }));
+  EXPECT_TRUE(changed);
+  EXPECT_EQ(add->operand(0), expensive);
+  EXPECT_THAT(add->operand(1), op::Broadcast(::testing::Ne(cheap)));
+}
+
 // Test rematerialization of a single computation produced by
 // MakeRematerializableComputation but with a sufficiently high memory limit
 // such that no instructions are rematerialized.
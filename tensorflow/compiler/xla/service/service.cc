@@ -19,6 +19,7 @@ limitations under the License.
 #include <functional>
 #include <memory>
 #include <numeric>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -94,6 +95,35 @@ Status RecordResult(const ShapedBuffer& result, se::Stream* stream,
   return OkStatus();
 }
 
+// Returns a copy of `literal` whose arrays have the layouts of the
+// corresponding arrays of `device_shape`, or std::nullopt if `literal` already
+// has those layouts. The transfer manager copies arrays whose layout differs
+// from the device layout before transferring them.
+std::optional<Literal> RelayoutForDevice(const Literal& literal,
+                                         const Shape& device_shape) {
+  Shape shape = literal.shape();
+  bool needs_relayout = false;
+  ShapeUtil::ForEachMutableSubshape(
+      &shape, [&](Shape* subshape, const ShapeIndex& index) {
+        if (!subshape->IsArray()) {
+          return;
+        }
+        const Layout& device_layout =
+            ShapeUtil::GetSubshape(device_shape, index).layout();
+        // Packed sub-byte arrays are left to the transfer manager, since
+        // literals store them unpacked.
+        if (subshape->layout() != device_layout &&
+            device_layout.element_size_in_bits() == 0) {
+          *subshape->mutable_layout() = device_layout;
+          needs_relayout = true;
+        }
+      });
+  if (!needs_relayout) {
+    return std::nullopt;
+  }
+  return literal.Relayout(shape);
+}
+
 }  // namespace
 
 ServiceOptions& ServiceOptions::set_platform(se::Platform* platform) {
@@ -1028,8 +1058,11 @@ Status Service::TransferToServer(const TransferToServerRequest* arg,
   }
 
   // Allocate memory in each replica and transfer the data to all replicas.
+  // The device layout is the same for all replicas, so a literal that must be
+  // relaid out is relaid out once rather than once per replica.
   std::vector<ScopedShapedBuffer> replicated_buffers;
   replicated_buffers.reserve(replicas.size());
+  std::optional<Literal> relaid_out;
   for (se::StreamExecutor* executor : replicas) {
     auto device_shape_representation_fn = [this](const Shape& shape) {
       return execute_backend_->compiler()->DefaultDeviceShapeRepresentation(
@@ -1040,10 +1073,14 @@ Status Service::TransferToServer(const TransferToServerRequest* arg,
         execute_backend_->transfer_manager()->AllocateScopedShapedBuffer(
             shape, execute_backend_->memory_allocator(),
             executor->device_ordinal(), device_shape_representation_fn));
+    if (replicated_buffers.empty() && replicas.size() > 1) {
+      relaid_out = RelayoutForDevice(literal, shaped_buffer.on_device_shape());
+    }
     TF_ASSIGN_OR_RETURN(auto stream, execute_backend_->BorrowStream(executor));
     TF_RETURN_IF_ERROR(
         execute_backend_->transfer_manager()->TransferLiteralToDevice(
-            stream.get(), literal, shaped_buffer));
+            stream.get(), relaid_out.has_value() ? *relaid_out : literal,
+            shaped_buffer));
     replicated_buffers.emplace_back(std::move(shaped_buffer));
   }
   TF_ASSIGN_OR_RETURN(*result->mutable_data(),
@@ -114,8 +114,21 @@ tsl::StatusOr<cublasLtEpilogue_t> AsCublasLtEpilogue(
 #if TENSORFLOW_USE_ROCM
     case BlasLt::Epilogue::kGELU:
       return CUBLASLT_EPILOGUE_GELU;
-    default:
-      return tsl::errors::Internal("Unsupported epilogue");
+#if TF_ROCM_VERSION >= 60000
+    case BlasLt::Epilogue::kGELUWithAux:
+      return CUBLASLT_EPILOGUE_GELU_AUX;
+    case BlasLt::Epilogue::kBiasThenGELU:
+      return CUBLASLT_EPILOGUE_GELU_BIAS;
+    case BlasLt::Epilogue::kBiasThenGELUWithAux:
+      return CUBLASLT_EPILOGUE_GELU_AUX_BIAS;
+#else
+    case BlasLt::Epilogue::kGELUWithAux:
+    case BlasLt::Epilogue::kBiasThenGELU:
+    case BlasLt::Epilogue::kBiasThenGELUWithAux:
+      return tsl::errors::Internal(
+          "GELU with bias or auxiliary output epilogues require "
+          "hipblaslt >= 6.0");
+#endif
 #elif CUDA_VERSION >= 11040
     case BlasLt::Epilogue::kGELU:
       return CUBLASLT_EPILOGUE_GELU;
@@ -182,12 +195,8 @@ tsl::Status BlasLt::Init() {
 }
 
 cudaDataType_t BlasLt::MatrixLayout::type() const {
-#if GOOGLE_CUDA
   return static_cast<cudaDataType_t>(
       GetAttr<uint32_t>(handle_.get(), CUBLASLT_MATRIX_LAYOUT_TYPE).value());
-#else
-  return HIPBLAS_R_32F;
-#endif
 }
 
 /*static*/ tsl::StatusOr<BlasLt::MatmulDesc> BlasLt::MatmulDesc::Create(
@@ -271,23 +280,11 @@ tsl::StatusOr<std::vector<BlasLt::MatmulAlgorithm>> BlasLt::GetMatmulAlgorithms(
     gpu::ScopedActivateExecutorContext sac{parent_};
 
     int found_algorithm_count = 0;
-/*
     SE_CUBLAS_RETURN_IF_ERROR(cublasLtMatmulAlgoGetHeuristic(
         blas_lt_.get(), plan.op_desc.get(), plan.a_desc.get(),
         plan.b_desc.get(), plan.c_desc.get(), plan.d_desc.get(),
         preference.get(), max_algorithm_count, results.data(),
         &found_algorithm_count));
-*/
-    auto error = cublasLtMatmulAlgoGetHeuristic(
-        blas_lt_.get(), plan.op_desc.get(), plan.a_desc.get(),
-        plan.b_desc.get(), plan.c_desc.get(), plan.d_desc.get(),
-        preference.get(), max_algorithm_count, results.data(),
-        &found_algorithm_count);
-    if(error != 0) {
-        printf("cublasLtMatmulAlgoGetHeuristic return %d\n", int(error));
-        fflush(stdout);
-        SE_CUBLAS_RETURN_IF_ERROR(error);
-    }
     results.resize(found_algorithm_count);
   }
 
@@ -409,9 +406,34 @@ tsl::Status BlasLt::DoMatmul(Stream* stream, const BlasLt::MatmulPlan& plan,
     if (d_amax != nullptr)
       return tsl::errors::Internal("hipblaslt does not support amax");
 
-    if (aux != nullptr)
+    if (aux != nullptr) {
+#if TF_ROCM_VERSION >= 60000
+      TF_RETURN_IF_ERROR(SetAttr(plan.op_desc.get(),
+                                 CUBLASLT_MATMUL_DESC_EPILOGUE_AUX_POINTER,
+                                 aux.opaque()));
+
+      // Set leading dim and batch stride of auxiliary output to match output.
+      TF_ASSIGN_OR_RETURN(
+          int64_t output_leading_dim,
+          GetAttr<int64_t>(plan.d_desc.get(), CUBLASLT_MATRIX_LAYOUT_LD));
+
+      TF_RETURN_IF_ERROR(SetAttr(plan.op_desc.get(),
+                                 CUBLASLT_MATMUL_DESC_EPILOGUE_AUX_LD,
+                                 output_leading_dim));
+
+      TF_ASSIGN_OR_RETURN(
+          int64_t output_batch_stride,
+          GetAttr<int64_t>(plan.d_desc.get(),
+                           CUBLASLT_MATRIX_LAYOUT_STRIDED_BATCH_OFFSET));
+
+      TF_RETURN_IF_ERROR(SetAttr(plan.op_desc.get(),
+                                 CUBLASLT_MATMUL_DESC_EPILOGUE_AUX_BATCH_STRIDE,
+                                 output_batch_stride));
+#else
       return tsl::errors::Internal(
-          "hipblaslt does not support auxiliary inputs / outputs");
+          "Auxiliary inputs / outputs require hipblaslt >= 6.0");
+#endif
+    }
 #endif
     gpu::ScopedActivateExecutorContext sac{parent_};
 
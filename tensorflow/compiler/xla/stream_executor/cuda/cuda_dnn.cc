@@ -6347,6 +6347,15 @@ bool CudnnSupport::GetRnnAlgorithms(
   return true;
 }
 
+bool CudnnSupport::GetPersistentRnnAlgorithm(dnn::AlgorithmDesc* algorithm) {
+  PreloadCudnnSubLibs(PreloadCudnnType::Rnn);
+  // The static persistent algorithm doesn't need a plan for the batch size,
+  // unlike CUDNN_RNN_ALGO_PERSIST_DYNAMIC.
+  *algorithm = dnn::AlgorithmDesc(CUDNN_RNN_ALGO_PERSIST_STATIC,
+                                  /*use_tensor_ops=*/false);
+  return true;
+}
+
 bool CudnnSupport::GetConvolveBackwardDataAlgorithms(
     CudaComputeCapability cuda_compute_capability, dnn::DataType input_type,
     const NumericOptions& numeric_options,
@@ -327,6 +327,8 @@ class CudnnSupport : public dnn::DnnSupport {
   bool GetRnnAlgorithms(
       std::vector<dnn::AlgorithmDesc>* out_algorithms) override;
 
+  bool GetPersistentRnnAlgorithm(dnn::AlgorithmDesc* algorithm) override;
+
   bool DoBatchNormalizationForward(
       Stream* stream, const DeviceMemory<float>& x,
       const DeviceMemory<float>& scale, const DeviceMemory<float>& offset,
@@ -1047,6 +1047,7 @@ GpuExecutor::CreateDeviceDescription(int device_ordinal) {
     // Lower the hex characters to match sysfs.
     pci_bus_id = absl::AsciiStrToLower(pci_bus_id);
     builder.set_pci_bus_id(pci_bus_id);
+    builder.set_physical_pci_bus_id(pci_bus_id);
 
     // Read the NUMA node corresponding to the PCI bus ID out of sysfs.
     int numa_node = TryToReadNumaNode(pci_bus_id, device_ordinal);
@@ -36,6 +36,7 @@ DeviceDescription::DeviceDescription()
       driver_version_(kUndefinedString),
       runtime_version_(kUndefinedString),
       pci_bus_id_(kUndefinedString),
+      physical_pci_bus_id_(kUndefinedString),
       name_(kUndefinedString),
       model_str_(kUndefinedString),
       thread_dim_limit_(kUninitializedUint64, kUninitializedUint64,
@@ -100,6 +101,13 @@ std::unique_ptr<std::map<std::string, std::string>> DeviceDescription::ToMap()
   result["AMDGPU GCN Arch Name"] = rocm_compute_capability().gcn_arch_name();
 
   result["NUMA Node"] = absl::StrCat(numa_node());
+  if (!compute_partition_mode_.empty()) {
+    result["Compute Partition Mode"] = compute_partition_mode_;
+  }
+  if (!memory_partition_mode_.empty()) {
+    result["Memory Partition Mode"] = memory_partition_mode_;
+  }
+  result["Physical PCI bus ID"] = physical_pci_bus_id_;
   result["Core Count"] = absl::StrCat(core_count());
   result["ECC Enabled"] = absl::StrCat(ecc_enabled());
   return owned_result;
@@ -129,7 +129,7 @@ class RocmComputeCapability {
   RocmComputeCapability() = default;
   ~RocmComputeCapability() = default;
 
-  std::string gcn_arch_name() { return gcn_arch_name_; }
+  std::string gcn_arch_name() const { return gcn_arch_name_; }
 
   std::string gfx_version() {
     std::vector<std::string> tokens = absl::StrSplit(gcn_arch_name_, ':');
@@ -164,6 +164,12 @@ class RocmComputeCapability {
     return gfx_versions_with_fp16_atomics_support().count(gfx_version()) != 0;
   }
 
+  // The FP8 instructions of these GPUs implement the FNUZ variants of the FP8
+  // formats, not F8E4M3FN and F8E5M2.
+  bool has_fp8_support() {
+    return gfx_versions_with_fp8_support().count(gfx_version()) != 0;
+  }
+
   RocmComputeCapabilityProto ToProto() const {
     RocmComputeCapabilityProto proto;
     proto.set_gcn_arch_name(gcn_arch_name_);
@@ -178,24 +184,31 @@ class RocmComputeCapability {
         "gfx906",  // MI50 / MI60
         "gfx908",  // MI100
         "gfx90a",  // MI200
+        "gfx940",  // MI300
+        "gfx941",  // MI300
+        "gfx942",  // MI300
         "gfx1030", // Navi21
         "gfx1100"  // Navi31
     };
   }
   std::set<std::string> gfx_versions_with_nhwc_layout_support() {
-    return {"gfx908", "gfx90a"};
+    return {"gfx908", "gfx90a", "gfx940", "gfx941", "gfx942"};
   }
   std::set<std::string> gfx_versions_with_fast_bf16_support() {
-    return {"gfx908", "gfx90a"};
+    return {"gfx908", "gfx90a", "gfx940", "gfx941", "gfx942"};
   }
   std::set<std::string> gfx_versions_with_fast_fp16_support() {
-    return {"gfx906", "gfx908", "gfx90a", "gfx1030", "gfx1100"};
+    return {"gfx906", "gfx908", "gfx90a",  "gfx940",
+            "gfx941", "gfx942", "gfx1030", "gfx1100"};
   }
   std::set<std::string> gfx_versions_with_mfma_instr_support() {
-    return {"gfx908", "gfx90a"};
+    return {"gfx908", "gfx90a", "gfx940", "gfx941", "gfx942"};
   }
   std::set<std::string> gfx_versions_with_fp16_atomics_support() {
-    return {"gfx90a"};
+    return {"gfx90a", "gfx940", "gfx941", "gfx942"};
+  }
+  std::set<std::string> gfx_versions_with_fp8_support() {
+    return {"gfx940", "gfx941", "gfx942"};
   }
 };
 
@@ -242,6 +255,34 @@ class DeviceDescription {
   // is returned.
   int numa_node() const { return numa_node_; }
 
+  // Returns the compute partition mode of the physical GPU this device is a
+  // partition of (e.g. "SPX" or "CPX" on an AMD MI300), or an empty string if
+  // the GPU cannot be partitioned.
+  const std::string &compute_partition_mode() const {
+    return compute_partition_mode_;
+  }
+
+  // Returns the memory partition mode of the physical GPU this device is a
+  // partition of (e.g. "NPS1" or "NPS4" on an AMD MI300), or an empty string if
+  // the GPU cannot be partitioned.
+  const std::string &memory_partition_mode() const {
+    return memory_partition_mode_;
+  }
+
+  // Returns the PCI bus identifier of the physical GPU this device is a
+  // partition of. Devices that are partitions of the same GPU share the
+  // memory and the interconnect links of that GPU. Same as pci_bus_id() if the
+  // device is not a partition.
+  const std::string &physical_pci_bus_id() const {
+    return physical_pci_bus_id_;
+  }
+
+  // Returns true if this device is one of several partitions of a physical
+  // GPU.
+  bool is_partition() const {
+    return !compute_partition_mode_.empty() && compute_partition_mode_ != "SPX";
+  }
+
   // Number of cores (traditional notion of core; i.e. an SM on an NVIDIA device
   // or an AMD Compute Unit.
   int core_count() const { return core_count_; }
@@ -366,6 +407,9 @@ class DeviceDescription {
   std::string driver_version_;
   std::string runtime_version_;
   std::string pci_bus_id_;
+  std::string physical_pci_bus_id_;
+  std::string compute_partition_mode_;
+  std::string memory_partition_mode_;
   std::string name_;
   std::string model_str_;
 
@@ -500,6 +544,15 @@ class DeviceDescriptionBuilder {
   }
 
   void set_numa_node(int value) { device_description_->numa_node_ = value; }
+  void set_physical_pci_bus_id(const std::string &value) {
+    device_description_->physical_pci_bus_id_ = value;
+  }
+  void set_compute_partition_mode(const std::string &value) {
+    device_description_->compute_partition_mode_ = value;
+  }
+  void set_memory_partition_mode(const std::string &value) {
+    device_description_->memory_partition_mode_ = value;
+  }
   void set_core_count(int value) { device_description_->core_count_ = value; }
   void set_fpus_per_core(int value) {
     device_description_->fpus_per_core_ = value;
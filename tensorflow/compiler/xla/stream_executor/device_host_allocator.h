@@ -18,14 +18,21 @@ limitations under the License.
 
 #include <vector>
 
+#include "absl/container/flat_hash_set.h"
 #include "tensorflow/compiler/xla/stream_executor/stream_executor.h"
 #include "tensorflow/tsl/framework/allocator.h"
 #include "tensorflow/tsl/platform/macros.h"
+#include "tensorflow/tsl/platform/mutex.h"
+#include "tensorflow/tsl/platform/numa.h"
 #include "tensorflow/tsl/profiler/lib/traceme.h"
 
 namespace stream_executor {
 // Allocator for pinned CPU RAM that is made known to a StreamExecutor-based
 // device for the purpose of efficient DMA with the device.
+//
+// On multi-socket hosts with NUMA support, memory is allocated on `numa_node`
+// and then registered with the device, so that staging buffers of a GPU stay
+// local to the socket the GPU is attached to.
 class DeviceHostAllocator : public tsl::SubAllocator {
  public:
   // Note: stream_exec cannot be null.
@@ -47,6 +54,11 @@ class DeviceHostAllocator : public tsl::SubAllocator {
     void* ptr = nullptr;
     *bytes_received = num_bytes;
     if (num_bytes > 0) {
+      ptr = NumaAllocateAndRegister(num_bytes);
+      if (ptr != nullptr) {
+        VisitAlloc(ptr, numa_node_, num_bytes);
+        return ptr;
+      }
       ptr = stream_exec_->HostMemoryAllocate(num_bytes);
       if (ptr == nullptr) {
         LOG(WARNING) << "could not allocate pinned host memory of size: "
@@ -63,6 +75,16 @@ class DeviceHostAllocator : public tsl::SubAllocator {
 
     if (ptr != nullptr) {
       VisitFree(ptr, numa_node_, num_bytes);
+      {
+        tsl::mutex_lock l(mu_);
+        if (numa_ptrs_.erase(ptr) > 0) {
+          if (!stream_exec_->HostMemoryUnregister(ptr)) {
+            LOG(WARNING) << "could not unregister pinned host memory " << ptr;
+          }
+          tsl::port::NUMAFree(ptr, num_bytes);
+          return;
+        }
+      }
       stream_exec_->HostMemoryDeallocate(ptr);
     }
   }
@@ -74,9 +96,35 @@ class DeviceHostAllocator : public tsl::SubAllocator {
   }
 
  private:
+  // Returns memory allocated on numa_node_ and registered with the device, or
+  // nullptr if NUMA placement is unavailable or failed.
+  void* NumaAllocateAndRegister(size_t num_bytes) {
+    if (numa_node_ < 0 || !tsl::port::NUMAEnabled() ||
+        tsl::port::NUMANumNodes() <= 1) {
+      return nullptr;
+    }
+    void* ptr = tsl::port::NUMAMalloc(numa_node_, num_bytes,
+                                      tsl::Allocator::kAllocatorAlignment);
+    if (ptr == nullptr) return nullptr;
+    if (!stream_exec_->HostMemoryRegister(ptr, num_bytes)) {
+      LOG(WARNING) << "could not register host memory of size " << num_bytes
+                   << " on NUMA node " << numa_node_
+                   << "; falling back to default placement";
+      tsl::port::NUMAFree(ptr, num_bytes);
+      return nullptr;
+    }
+    tsl::mutex_lock l(mu_);
+    numa_ptrs_.insert(ptr);
+    return ptr;
+  }
+
   StreamExecutor* stream_exec_;  // not owned, non-null
   const int numa_node_;
 
+  tsl::mutex mu_;
+  // Regions allocated by NumaAllocateAndRegister().
+  absl::flat_hash_set<void*> numa_ptrs_ TF_GUARDED_BY(mu_);
+
   TF_DISALLOW_COPY_AND_ASSIGN(DeviceHostAllocator);
 };
 
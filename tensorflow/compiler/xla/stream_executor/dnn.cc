@@ -266,6 +266,10 @@ bool DnnSupport::GetRnnAlgorithms(std::vector<AlgorithmDesc>* out_algorithms) {
   return false;
 }
 
+bool DnnSupport::GetPersistentRnnAlgorithm(AlgorithmDesc* algorithm) {
+  return false;
+}
+
 tsl::Status DnnSupport::DoPoolForward(
     DataType element_type, Stream* stream,
     const dnn::PoolingDescriptor& pooling_dimensions,
@@ -1696,6 +1696,11 @@ class DnnSupport {
   // Returns a list of supported rnn algorithms.
   virtual bool GetRnnAlgorithms(std::vector<AlgorithmDesc>* out_algorithms);
 
+  // Returns in `algorithm` the rnn algorithm that keeps the recurrent weights
+  // on chip across the time steps, which saves a launch per step for small
+  // models. Returns false if there is no such algorithm.
+  virtual bool GetPersistentRnnAlgorithm(AlgorithmDesc* algorithm);
+
   // Version of DoConvolve that uses pre-quantized 8 bit coefficients.
   // coefficient_scales specifies the scaling of each column of coefficients:
   // original float coefficient[row * num_columns + column] =
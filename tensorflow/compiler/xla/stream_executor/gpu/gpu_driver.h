@@ -28,6 +28,10 @@ limitations under the License.
 #include "tensorflow/tsl/platform/status.h"
 #include "tensorflow/tsl/platform/statusor.h"
 
+#if TENSORFLOW_USE_ROCM
+#include "rocm/rocm_config.h"
+#endif  // TENSORFLOW_USE_ROCM
+
 namespace stream_executor {
 namespace gpu {
 
@@ -149,8 +153,9 @@ class GpuDriver {
   static int GetGpuStreamPriority(
       GpuContext* context, stream_executor::StreamPriority stream_priority);
 
-  // Virtual memory support was added to CUDA in 10.2
-#if CUDA_VERSION >= 10020
+  // Virtual memory support was added to CUDA in 10.2 and to HIP in ROCm 6.0
+  // (hipMemAddressReserve/hipMemCreate/hipMemMap).
+#if CUDA_VERSION >= 10020 || TF_ROCM_VERSION >= 60000
 
   // Reserves a range of virtual device memory addresses via
   // cuMemAddressReserve. bytes must be a multiple of the host page size.
@@ -205,7 +210,7 @@ class GpuDriver {
   // https://docs.nvidia.com/cuda/cuda-driver-api/group__CUDA__VA.html#group__CUDA__VA_1gfb50aac00c848fd7087e858f59bf7e2a
   static void UnmapMemory(GpuContext* context, GpuDevicePtr va, uint64_t bytes);
 
-#endif  // CUDA_VERSION >= 10200
+#endif  // CUDA_VERSION >= 10200 || TF_ROCM_VERSION >= 60000
 
   // Given a device ordinal, returns a device handle into the device outparam,
   // which must not be null.
@@ -390,6 +390,13 @@ class GpuExecutor : public internal::StreamExecutorInterface {
   // GPU binary (PTX or CUBIN or HSACO) -> {CUDA module, reference count}.
   std::unordered_map<const void*, std::pair<GpuModuleHandle, uint64_t>>
       gpu_binary_to_module_ ABSL_GUARDED_BY(in_memory_modules_mu_);
+#if TENSORFLOW_USE_ROCM
+  // Fingerprint of the HSACO contents -> {ROCm module, number of binaries}.
+  // Identical binaries, e.g. the kernels of two executables compiled from the
+  // same HLO, share a single module.
+  absl::flat_hash_map<absl::uint128, std::pair<GpuModuleHandle, uint64_t>>
+      hsaco_fingerprint_to_module_ ABSL_GUARDED_BY(in_memory_modules_mu_);
+#endif  // TENSORFLOW_USE_ROCM
 
   // Guards the launched kernel set.
   absl::Mutex launched_kernels_mu_;
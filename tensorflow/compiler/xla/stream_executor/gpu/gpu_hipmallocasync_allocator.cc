@@ -0,0 +1,432 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/stream_executor/gpu/gpu_hipmallocasync_allocator.h"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#if TENSORFLOW_USE_ROCM
+#include "tensorflow/compiler/xla/stream_executor/rocm/rocm_activation.h"
+#include "tensorflow/compiler/xla/stream_executor/rocm/rocm_driver_wrapper.h"
+#endif  // TENSORFLOW_USE_ROCM
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "tensorflow/compiler/xla/stream_executor/device_id_utils.h"
+#include "tensorflow/compiler/xla/stream_executor/gpu/gpu_init.h"
+#include "tensorflow/compiler/xla/stream_executor/stream_executor.h"
+#include "tensorflow/tsl/framework/allocator.h"
+#include "tensorflow/tsl/framework/device_id.h"
+#include "tensorflow/tsl/platform/logging.h"
+#include "tensorflow/tsl/platform/mutex.h"
+#include "tensorflow/tsl/util/env_var.h"
+
+namespace stream_executor {
+
+#if TF_HIP_MALLOC_ASYNC_SUPPORTED
+static std::string GetHipErrorMessage(hipError_t result) {
+  const char* error = wrap::hipGetErrorString(result);
+  return absl::StrCat("HIP error: ", error ? error : "<unknown>", " (",
+                      static_cast<int>(result), ")");
+}
+
+// Returns a hipMemPool attribute, or 0 (after logging) if it can't be read.
+static uint64_t GetPoolAttribute(hipMemPool_t pool, hipMemPoolAttr attr) {
+  uint64_t value = 0;
+  if (auto result = wrap::hipMemPoolGetAttribute(pool, attr, &value)) {
+    LOG(ERROR) << "Error while fetching hipMallocAsync pool attribute: "
+               << GetHipErrorMessage(result);
+    return 0;
+  }
+  return value;
+}
+#endif  // TF_HIP_MALLOC_ASYNC_SUPPORTED
+
+void GpuHipMallocAsyncAllocator::PrintAllocatorStatisticsNoLock() {
+  std::map<size_t, int> size_map_histogram;
+  std::vector<std::string> ptr_size_string;
+  for (auto p : size_map_) {
+    if (VLOG_IS_ON(8)) {
+      ptr_size_string.push_back(
+          absl::StrCat("(", absl::Hex(p.first), ",", p.second) + ")");
+    }
+    size_map_histogram[p.second]++;
+  }
+  LOG(ERROR) << "Histogram of current allocation: (allocation_size_in_bytes, "
+             << "nb_allocation_of_that_sizes), ...;";
+  for (auto p : size_map_histogram) {
+    LOG(ERROR) << p.first << ", " << p.second;
+  }
+
+  VLOG(8) << "\nThe sorted list of (ptr,size):";
+  VLOG(8) << absl::StrJoin(ptr_size_string, ",");
+
+#if TF_HIP_MALLOC_ASYNC_SUPPORTED
+  LOG(ERROR) << "hipMemPoolAttrReservedMemCurrent: "
+             << GetPoolAttribute(pool_, hipMemPoolAttrReservedMemCurrent);
+  LOG(ERROR) << "hipMemPoolAttrUsedMemCurrent: "
+             << GetPoolAttribute(pool_, hipMemPoolAttrUsedMemCurrent);
+  LOG(ERROR) << "hipMemPoolAttrReservedMemHigh: "
+             << GetPoolAttribute(pool_, hipMemPoolAttrReservedMemHigh);
+  LOG(ERROR) << "hipMemPoolAttrUsedMemHigh: "
+             << GetPoolAttribute(pool_, hipMemPoolAttrUsedMemHigh);
+#endif  // TF_HIP_MALLOC_ASYNC_SUPPORTED
+}
+
+void GpuHipMallocAsyncAllocator::PrintAllocatorStatistics() {
+  tsl::mutex_lock lock(lock_);
+  PrintAllocatorStatisticsNoLock();
+}
+
+std::atomic<int> GpuHipMallocAsyncAllocator::number_instantiated_(0);
+
+GpuHipMallocAsyncAllocator::GpuHipMallocAsyncAllocator(
+    tsl::PlatformDeviceId platform_device_id, size_t pool_size,
+    bool reserve_memory, bool compute_stats)
+    : name_(absl::StrCat("gpu_hip_async_", platform_device_id.value())),
+      reserve_memory_(reserve_memory) {
+  ++number_instantiated_;
+
+  // Stop clang from complaining about unused private fields when
+  // TF_HIP_MALLOC_ASYNC_SUPPORTED is not defined.
+  (void)reserve_memory_;
+
+#if TF_HIP_MALLOC_ASYNC_SUPPORTED
+  stream_exec_ = DeviceIdUtil::ExecutorForPlatformDeviceId(
+                     GPUMachineManager(), platform_device_id)
+                     .value();
+  pool_ = nullptr;
+  hip_stream_ = nullptr;
+
+  rocm::ScopedActivateExecutorContext scoped_activation{stream_exec_};
+
+  // Check that hipMallocAsync is supported.
+  int hip_malloc_async_supported = 0;
+  if (auto status = wrap::hipDeviceGetAttribute(
+          &hip_malloc_async_supported, hipDeviceAttributeMemoryPoolsSupported,
+          platform_device_id.value())) {
+    LOG(FATAL)  // Crash OK.
+        << "On device: " << platform_device_id.value()
+        << ". Failed to get device attribute : " << GetHipErrorMessage(status);
+  }
+  if (!hip_malloc_async_supported)
+    LOG(FATAL)  // Crash OK.
+        << "TF_GPU_ALLOCATOR=hip_malloc_async isn't currently supported on "
+        << "GPU id " << platform_device_id.value() << ":"
+        << " Possible causes: device not supported, driver too old,"
+        << " ROCm version too old (request ROCm 5.3+).";
+
+  if (auto status =
+          wrap::hipDeviceGetDefaultMemPool(&pool_, platform_device_id.value()))
+    LOG(FATAL) <<  // Crash OK.
+        "Failed to get default HIP pool: " << GetHipErrorMessage(status);
+
+  // By default keep the whole pool cached, like GpuCudaMallocAsyncAllocator.
+  // Processes sharing a GPU can lower the threshold so that memory freed by
+  // one process is returned to the driver at synchronization points.
+  int64_t release_threshold = -1;
+  TF_CHECK_OK(tsl::ReadInt64FromEnvVar("TF_HIP_MALLOC_ASYNC_RELEASE_THRESHOLD",
+                                       /*default_val=*/-1, &release_threshold));
+  uint64_t release_threshold_64 =
+      release_threshold < 0 ? pool_size : release_threshold;
+
+  VLOG(1) << Name() << " HipMallocAsync initialized on platform: "
+          << platform_device_id.value() << " with pool size of: " << pool_size
+          << " and release threshold of: " << release_threshold_64
+          << " this ptr: " << this;
+  if (auto status = wrap::hipMemPoolSetAttribute(
+          pool_, hipMemPoolAttrReleaseThreshold, &release_threshold_64))
+    LOG(FATAL) <<  // Crash OK.
+        "Failed to set HIP pool attribute: " << GetHipErrorMessage(status);
+
+  if (compute_stats) {
+    stats_ = std::make_unique<tsl::AllocatorStats>();
+    stats_->bytes_limit = static_cast<int64_t>(pool_size);
+  }  // If not set, it means we do not compute stats.
+
+  // If in TF_DETERMINISTIC_ALLOCATOR is set, then make the allocator behave
+  // determistically.
+  bool deterministic = false;
+  TF_CHECK_OK(tsl::ReadBoolFromEnvVar("TF_DETERMINISTIC_ALLOCATOR",
+                                      /*default_val=*/false, &deterministic));
+  if (deterministic) {
+    int disable = 0;
+    if (auto status = wrap::hipMemPoolSetAttribute(
+            pool_, hipMemPoolReuseAllowOpportunistic, &disable)) {
+      LOG(FATAL) <<  // Crash OK.
+          "Failed to set HIP pool attribute: " << GetHipErrorMessage(status);
+    }
+    if (auto status = wrap::hipMemPoolSetAttribute(
+            pool_, hipMemPoolReuseAllowInternalDependencies, &disable)) {
+      LOG(FATAL) <<  // Crash OK.
+          "Failed to set HIP pool attribute: " << GetHipErrorMessage(status);
+    }
+  }
+
+  // Set read/write access to all GPUs.
+  static auto* all_pools_ = new std::vector<hipMemPool_t*>();
+  static auto* all_ids_ = new std::vector<tsl::PlatformDeviceId>();
+  DCHECK(all_pools_->size() == all_ids_->size());
+  for (int i = 0; i < all_pools_->size(); ++i) {
+    // Set the current pool access to the previous GPUs.
+    hipMemAccessDesc map;
+    map.flags = hipMemAccessFlagsProtReadWrite;
+    map.location.id = (*all_ids_)[i].value();
+    map.location.type = hipMemLocationTypeDevice;
+
+    VLOG(2) << "Setting access of the current pool to "
+            << " location id: " << map.location.id;
+    int can_access_peer;
+    if (auto status = wrap::hipDeviceCanAccessPeer(
+            &can_access_peer, platform_device_id.value(), map.location.id)) {
+      pool_ = nullptr;
+      LOG(FATAL)  // Crash OK.
+          << "hipDeviceCanAccessPeer failed to know if GPU id "
+          << map.location.id << " can access GPU id "
+          << platform_device_id.value() << ": " << GetHipErrorMessage(status);
+    }
+    if (can_access_peer == 1) {
+      if (auto status = wrap::hipMemPoolSetAccess(pool_, &map, 1)) {
+        pool_ = nullptr;
+        LOG(FATAL)  // Crash OK.
+            << "Error when setting access to the pool id: " << i
+            << " location id: " << map.location.id
+            << " error: " << GetHipErrorMessage(status);
+      }
+    }
+
+    // Set the previous pools access to the current GPU.
+    map.location.id = platform_device_id.value();
+
+    VLOG(2) << "Set access to the pool id: " << i
+            << " location id: " << map.location.id;
+    if (auto status = wrap::hipDeviceCanAccessPeer(
+            &can_access_peer, (*all_ids_)[i].value(),
+            platform_device_id.value())) {
+      pool_ = nullptr;
+      LOG(FATAL)  // Crash OK.
+          << "hipDeviceCanAccessPeer failed: " << GetHipErrorMessage(status);
+    }
+    if (can_access_peer == 1) {
+      if (auto status = wrap::hipMemPoolSetAccess(*(*all_pools_)[i], &map, 1)) {
+        pool_ = nullptr;
+        LOG(FATAL)  // Crash OK.
+            << "Error when setting access to the pool id: " << i
+            << " location id: " << map.location.id
+            << " error: " << GetHipErrorMessage(status);
+      }
+    }
+  }
+  all_pools_->push_back(&pool_);
+  all_ids_->push_back(platform_device_id);
+
+  VLOG(2) << Name() << " GpuHipMallocAsyncAllocator PoolSize " << pool_size;
+#else   // TF_HIP_MALLOC_ASYNC_SUPPORTED
+  LOG(FATAL) << "GpuHipMallocAsyncAllocator requires ROCm 5.3+";  // Crash OK.
+#endif  // TF_HIP_MALLOC_ASYNC_SUPPORTED
+}
+
+GpuHipMallocAsyncAllocator::~GpuHipMallocAsyncAllocator() {}
+
+void* GpuHipMallocAsyncAllocator::AllocateRaw(size_t alignment,
+                                              size_t num_bytes) {
+#if TF_HIP_MALLOC_ASYNC_SUPPORTED
+  CHECK(hip_stream_ != nullptr)
+      << "A stream must be added to the GpuHipMallocAsync allocator";
+  if (pool_ == nullptr) {
+    LOG(FATAL)  // Crash OK.
+        << "The instantiation of GpuHipMallocAsyncAllocator failed."
+        << " See previous errors.";
+  }
+  // The lock is only needed when stats are enabled, but it must be around
+  // the hipMallocFromPoolAsync call as well to ensure consistency of the stats
+  // update.
+  std::unique_lock<tsl::mutex> lock(lock_, std::defer_lock);
+  if (stats_) {
+    lock.lock();
+  }
+  rocm::ScopedActivateExecutorContext scoped_activation{stream_exec_};
+  void* ptr = nullptr;
+  if (auto result =
+          wrap::hipMallocFromPoolAsync(&ptr, num_bytes, pool_, hip_stream_)) {
+    size_t free, total;
+    wrap::hipMemGetInfo(&free, &total);
+    LOG(ERROR) << Name() << " hipMallocAsync failed to allocate " << num_bytes
+               << " bytes: " << GetHipErrorMessage(result)
+               << "\n Reported by HIP: Free memory/Total memory: " << free
+               << "/" << total;
+    if (stats_) {
+      LOG(ERROR) << "Stats: " << stats_->DebugString();
+      PrintAllocatorStatisticsNoLock();
+    }
+
+    return nullptr;
+  }
+
+  // Update stats.
+  if (stats_) {
+    ++(stats_->num_allocs);
+    stats_->bytes_in_use += num_bytes;
+    if (stats_->bytes_in_use > stats_->peak_bytes_in_use) {
+      VLOG(9) << "New Peak memory usage of " << stats_->bytes_in_use
+              << " bytes.";
+    }
+    stats_->peak_bytes_in_use =
+        std::max(stats_->peak_bytes_in_use, stats_->bytes_in_use);
+    stats_->largest_alloc_size =
+        std::max<std::size_t>(stats_->largest_alloc_size, num_bytes);
+    bool ptr_inserted = size_map_.emplace(ptr, num_bytes).second;
+    DCHECK(ptr_inserted);
+  }
+  VLOG(10) << Name() << " Allocated " << num_bytes << " at " << ptr;
+  return ptr;
+#else   // TF_HIP_MALLOC_ASYNC_SUPPORTED
+  return nullptr;
+#endif  // TF_HIP_MALLOC_ASYNC_SUPPORTED
+}
+
+void GpuHipMallocAsyncAllocator::DeallocateRaw(void* ptr) {
+#if TF_HIP_MALLOC_ASYNC_SUPPORTED
+  if (ptr == nullptr) return;
+  // The lock is only needed when stats are enabled, but it must be around
+  // the hipFreeAsync call as well to ensure consistency of the stats update.
+  std::unique_lock<tsl::mutex> lock(lock_, std::defer_lock);
+  if (stats_) {
+    lock.lock();
+  }
+  if (auto result = wrap::hipFreeAsync(ptr, hip_stream_)) {
+    if (result == hipErrorDeinitialized) {
+      // It happens with multi-GPU that TF free the GPU allocation after
+      // the driver is unloaded. It is safe to ignore this error here.
+      VLOG(1) << "Ignoring HIP error: " << GetHipErrorMessage(result);
+    } else {
+      size_t free, total;
+      rocm::ScopedActivateExecutorContext scoped_activation{stream_exec_};
+      wrap::hipMemGetInfo(&free, &total);
+      LOG(ERROR) << "hipFreeAsync failed to free " << ptr << ": "
+                 << GetHipErrorMessage(result)
+                 << "\n Free memory/Total memory: " << free << "/" << total;
+      if (stats_) {
+        LOG(ERROR) << "Stats: " << stats_->DebugString();
+      }
+    }
+  }
+
+  // Updates the stats.
+  if (stats_) {
+    DCHECK(size_map_.contains(ptr));
+    size_t size = size_map_[ptr];
+    stats_->bytes_in_use -= size;
+    size_map_.erase(ptr);
+  }
+
+  VLOG(10) << Name() << " Freed ptr: " << ptr;
+#endif  // TF_HIP_MALLOC_ASYNC_SUPPORTED
+}
+
+bool GpuHipMallocAsyncAllocator::TracksAllocationSizes() const {
+  return static_cast<bool>(stats_);
+}
+
+size_t GpuHipMallocAsyncAllocator::RequestedSize(const void* ptr) const {
+  if (!stats_ || !ptr) return 0;
+  tsl::mutex_lock l(lock_);
+  return size_map_.at(ptr);
+}
+
+size_t GpuHipMallocAsyncAllocator::AllocatedSize(const void* ptr) const {
+  if (!stats_ || !ptr) return 0;
+  tsl::mutex_lock l(lock_);
+  return size_map_.at(ptr);
+}
+
+#if TF_HIP_MALLOC_ASYNC_SUPPORTED
+void GpuHipMallocAsyncAllocator::UpdatePoolStats(tsl::AllocatorStats* stats) {
+  if (pool_ == nullptr) return;
+  stats->pool_bytes = static_cast<int64_t>(
+      GetPoolAttribute(pool_, hipMemPoolAttrReservedMemCurrent));
+  stats->peak_pool_bytes = static_cast<int64_t>(
+      GetPoolAttribute(pool_, hipMemPoolAttrReservedMemHigh));
+  // Memory the driver holds for this pool but that is not handed out to TF is
+  // what other processes sharing the GPU cannot use until it is released.
+  stats->bytes_reserved = *stats->pool_bytes - stats->bytes_in_use;
+  stats->peak_bytes_reserved =
+      std::max(stats->peak_bytes_reserved, stats->bytes_reserved);
+}
+#endif  // TF_HIP_MALLOC_ASYNC_SUPPORTED
+
+std::optional<tsl::AllocatorStats> GpuHipMallocAsyncAllocator::GetStats() {
+  if (!stats_) return std::nullopt;
+  tsl::mutex_lock l(lock_);
+#if TF_HIP_MALLOC_ASYNC_SUPPORTED
+  UpdatePoolStats(stats_.get());
+#endif  // TF_HIP_MALLOC_ASYNC_SUPPORTED
+  return *stats_;
+}
+
+bool GpuHipMallocAsyncAllocator::ClearStats() {
+  if (!stats_) return false;
+  tsl::mutex_lock l(lock_);
+  stats_->num_allocs = 0;
+  stats_->peak_bytes_in_use = stats_->bytes_in_use;
+  stats_->peak_bytes_reserved = stats_->bytes_reserved;
+  stats_->largest_alloc_size = 0;
+  return true;
+}
+
+void GpuHipMallocAsyncAllocator::SetStreamAndPreallocateMemory(void* stream) {
+#if TF_HIP_MALLOC_ASYNC_SUPPORTED
+  hipStream_t new_hip_stream = *(static_cast<hipStream_t*>(stream));
+  // We don't need to re-set the HIP stream if this is the same stream
+  if (hip_stream_ != nullptr && new_hip_stream != hip_stream_) {
+    LOG(FATAL) <<  // Crash OK.
+        "Trying to set the stream twice. This isn't supported. ";
+  }
+
+  uint64_t pool_size_64 = 0;
+  if (stats_ && stats_->bytes_limit) {
+    pool_size_64 = *stats_->bytes_limit;
+  } else {
+    pool_size_64 = GetPoolAttribute(pool_, hipMemPoolAttrReleaseThreshold);
+  }
+  hip_stream_ = new_hip_stream;
+  int64_t prealloc_size = 0;
+  // TF_HIP_MALLOC_ASYNC_PREALLOC=-1 is a special value that preallocates the
+  // total pool size.
+  TF_CHECK_OK(tsl::ReadInt64FromEnvVar("TF_HIP_MALLOC_ASYNC_PREALLOC", 0,
+                                       &prealloc_size));
+  if (prealloc_size == -1) {
+    prealloc_size = pool_size_64;
+  } else if (reserve_memory_) {
+    prealloc_size = pool_size_64;
+  }
+
+  if (prealloc_size != 0) {
+    void* ptr = AllocateRaw(0, prealloc_size);
+    DeallocateRaw(ptr);
+    VLOG(2) << Name() << " GpuHipMallocAsyncAllocator reserved the pool for "
+            << prealloc_size << " bytes"
+            << ". First ptr: " << ptr;
+    ClearStats();
+  }
+#endif  // TF_HIP_MALLOC_ASYNC_SUPPORTED
+}
+
+}  // namespace stream_executor
@@ -0,0 +1,138 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_COMPILER_XLA_STREAM_EXECUTOR_GPU_GPU_HIPMALLOCASYNC_ALLOCATOR_H_
+#define TENSORFLOW_COMPILER_XLA_STREAM_EXECUTOR_GPU_GPU_HIPMALLOCASYNC_ALLOCATOR_H_
+
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "tensorflow/compiler/xla/stream_executor/stream_executor.h"
+#include "tensorflow/tsl/framework/allocator.h"
+#include "tensorflow/tsl/framework/device_id.h"
+#include "tensorflow/tsl/platform/macros.h"
+#include "tensorflow/tsl/platform/mutex.h"
+
+#if TENSORFLOW_USE_ROCM
+#include "rocm/include/hip/hip_runtime.h"
+#include "rocm/rocm_config.h"
+
+#define TF_HIP_MALLOC_ASYNC_SUPPORTED TF_ROCM_VERSION >= 50300
+#endif  // TENSORFLOW_USE_ROCM
+
+namespace stream_executor {
+
+// An allocator that wraps hipMallocFromPoolAsync, the ROCm counterpart of
+// GpuCudaMallocAsyncAllocator. Use the environment variable
+// `TF_GPU_ALLOCATOR=hip_malloc_async` to enable it.
+//
+// The allocator sub-allocates from the default memory pool of the device and
+// lets the HIP driver own the pooled memory, instead of pre-reserving a fixed
+// arena like [Gpu]BFCAllocator. This makes it possible for several processes
+// to share one GPU without fragmenting each other's reservations.
+//
+// The pool keeps up to `release_threshold` bytes cached after a
+// synchronization point; memory above that threshold is returned to the
+// driver and becomes available to other processes. The threshold defaults to
+// `pool_size` and can be overridden with
+// `TF_HIP_MALLOC_ASYNC_RELEASE_THRESHOLD=nb_bytes` (0 releases everything on
+// every synchronization point). `TF_HIP_MALLOC_ASYNC_PREALLOC=nb_bytes`
+// preallocates that much memory when the stream is set; -1 preallocates
+// `pool_size`.
+//
+// Pool-level statistics (reserved and used bytes as reported by the driver)
+// are exported through `GetStats()` as `pool_bytes`, `peak_pool_bytes`,
+// `bytes_reserved` and `peak_bytes_reserved`.
+class GpuHipMallocAsyncAllocator : public tsl::Allocator {
+ public:
+  explicit GpuHipMallocAsyncAllocator(tsl::PlatformDeviceId platform_device_id,
+                                      size_t pool_size,
+                                      bool reserve_memory = false,
+                                      bool compute_stats = true);
+  ~GpuHipMallocAsyncAllocator() override;
+  std::string Name() override { return name_; }
+  void* AllocateRaw(size_t alignment,
+                    size_t num_bytes) override ABSL_NO_THREAD_SAFETY_ANALYSIS;
+  void DeallocateRaw(void* ptr) override ABSL_NO_THREAD_SAFETY_ANALYSIS;
+
+  bool TracksAllocationSizes() const override;
+
+  size_t RequestedSize(const void* ptr) const override;
+
+  size_t AllocatedSize(const void* ptr) const override;
+
+  std::optional<tsl::AllocatorStats> GetStats() override;
+
+  bool ClearStats() override;
+
+  void SetStreamAndPreallocateMemory(void* stream) override;
+
+  // With the right VLOG set, it prints:
+  // - the number of ptr currently allocated per size (histogram).
+  // - each ptr value and its size.
+  // - the hipMemPool reserved/used statistics.
+  void PrintAllocatorStatistics();
+
+  static int GetInstantiatedCountTestOnly() { return number_instantiated_; }
+
+  tsl::AllocatorMemoryType GetMemoryType() const override {
+    return tsl::AllocatorMemoryType::kDevice;
+  }
+
+ private:
+  void PrintAllocatorStatisticsNoLock() ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+#if TF_HIP_MALLOC_ASYNC_SUPPORTED
+  // Copies the driver reported pool statistics into `stats`.
+  void UpdatePoolStats(tsl::AllocatorStats* stats);
+
+  StreamExecutor* stream_exec_;  // Not owned.
+
+  // hipMallocAsync is stream aware, but TF StreamExecutor uses only one
+  // compute stream and already synchronizes with the h2d, d2h and d2d
+  // streams, so there is no need for extra synchronization.
+  // Not owned.
+  hipStream_t hip_stream_;
+
+  // Not owned. The default pool of the associated GPU.
+  // If null, then the instantiation failed and the first allocation
+  // will return an error.
+  hipMemPool_t pool_;
+#endif  // TF_HIP_MALLOC_ASYNC_SUPPORTED
+
+  // Just a counter for the number of time this class is instantiated.
+  // Only useful for tests.
+  static std::atomic<int> number_instantiated_;
+
+  std::string name_;
+
+  bool reserve_memory_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(GpuHipMallocAsyncAllocator);
+
+  // Stats.
+  // Structures mutable after construction
+  mutable tsl::mutex lock_;
+  std::unique_ptr<tsl::AllocatorStats> stats_ ABSL_PT_GUARDED_BY(lock_);
+  absl::flat_hash_map<const void*, size_t> size_map_ ABSL_GUARDED_BY(lock_);
+};
+
+}  // namespace stream_executor
+
+#endif  // TENSORFLOW_COMPILER_XLA_STREAM_EXECUTOR_GPU_GPU_HIPMALLOCASYNC_ALLOCATOR_H_
@@ -16,6 +16,8 @@ limitations under the License.
 #ifndef TENSORFLOW_COMPILER_XLA_STREAM_EXECUTOR_ROCM_HIP_BLAS_LT_H_
 #define TENSORFLOW_COMPILER_XLA_STREAM_EXECUTOR_ROCM_HIP_BLAS_LT_H_
 
+#include "rocm/rocm_config.h"
+
 #if TF_HIPBLASLT
 #define cublasStatus_t hipblasStatus_t
 #define cudaDataType_t hipblasDatatype_t
@@ -50,6 +52,8 @@ limitations under the License.
 #define cublasLtMatmulAlgoGetHeuristic wrap::hipblasLtMatmulAlgoGetHeuristic
 #define cublasLtMatrixLayoutSetAttribute wrap::hipblasLtMatrixLayoutSetAttribute
 #define cublasLtMatmulDescSetAttribute wrap::hipblasLtMatmulDescSetAttribute
+#define cublasLtMatrixLayoutGetAttribute wrap::hipblasLtMatrixLayoutGetAttribute
+#define cublasLtMatmulDescGetAttribute wrap::hipblasLtMatmulDescGetAttribute
 
 #define CUBLASLT_POINTER_MODE_DEVICE HIPBLAS_POINTER_MODE_DEVICE
 #define CUBLASLT_POINTER_MODE_HOST HIPBLAS_POINTER_MODE_HOST
@@ -58,10 +62,18 @@ limitations under the License.
 #define CUBLASLT_EPILOGUE_BIAS HIPBLASLT_EPILOGUE_BIAS
 #define CUBLASLT_EPILOGUE_RELU_BIAS HIPBLASLT_EPILOGUE_RELU_BIAS
 #define CUBLASLT_EPILOGUE_GELU HIPBLASLT_EPILOGUE_GELU
-// not supported in 5.5
-//#define CUBLASLT_EPILOGUE_GELU_AUX HIPBLASLT_EPILOGUE_GELU_AUX
-//#define CUBLASLT_EPILOGUE_GELU_BIAS HIPBLASLT_EPILOGUE_GELU_BIAS
-//#define CUBLASLT_EPILOGUE_GELU_AUX_BIAS HIPBLASLT_EPILOGUE_GELU_AUX_BIAS
+// The GELU+bias and auxiliary-output epilogues are not supported in 5.5.
+#if TF_ROCM_VERSION >= 60000
+#define CUBLASLT_EPILOGUE_GELU_AUX HIPBLASLT_EPILOGUE_GELU_AUX
+#define CUBLASLT_EPILOGUE_GELU_BIAS HIPBLASLT_EPILOGUE_GELU_BIAS
+#define CUBLASLT_EPILOGUE_GELU_AUX_BIAS HIPBLASLT_EPILOGUE_GELU_AUX_BIAS
+#define CUBLASLT_MATMUL_DESC_EPILOGUE_AUX_POINTER \
+  HIPBLASLT_MATMUL_DESC_EPILOGUE_AUX_POINTER
+#define CUBLASLT_MATMUL_DESC_EPILOGUE_AUX_LD HIPBLASLT_MATMUL_DESC_EPILOGUE_AUX_LD
+#define CUBLASLT_MATMUL_DESC_EPILOGUE_AUX_BATCH_STRIDE \
+  HIPBLASLT_MATMUL_DESC_EPILOGUE_AUX_BATCH_STRIDE
+#define CUBLASLT_MATRIX_LAYOUT_LD HIPBLASLT_MATRIX_LAYOUT_LD
+#endif  // TF_ROCM_VERSION >= 60000
 #define CUBLASLT_MATRIX_LAYOUT_BATCH_COUNT HIPBLASLT_MATRIX_LAYOUT_BATCH_COUNT
 #define CUBLASLT_MATRIX_LAYOUT_STRIDED_BATCH_OFFSET HIPBLASLT_MATRIX_LAYOUT_STRIDED_BATCH_OFFSET
 #define CUBLASLT_MATRIX_LAYOUT_TYPE HIPBLASLT_MATRIX_LAYOUT_TYPE
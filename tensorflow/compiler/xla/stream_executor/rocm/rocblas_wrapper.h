@@ -264,6 +264,7 @@ using stream_executor::internal::CachedDsoLoader::GetRocblasDsoHandle;
   __macro(rocblas_create_handle)                \
   __macro(rocblas_destroy_handle)               \
   __macro(rocblas_set_stream)                   \
+  __macro(rocblas_set_workspace)                \
   __macro(rocblas_set_atomics_mode)
 
 // clang-format on
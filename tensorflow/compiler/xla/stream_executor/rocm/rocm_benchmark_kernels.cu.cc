@@ -0,0 +1,65 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <hip/hip_runtime.h>
+
+namespace stream_executor {
+namespace gpu {
+
+// Empty kernels, which measure the launch overhead of kernels with arguments
+// of various sizes.
+template <int kNumBytes>
+struct KernelArgs {
+  char bytes[kNumBytes];
+};
+
+__global__ void EmptyKernel() {}
+
+template <int kNumBytes>
+__global__ void EmptyKernelWithArgs(KernelArgs<kNumBytes> args) {}
+
+template <int kNumBytes>
+void LaunchEmptyKernelWithArgs(hipStream_t stream) {
+  hipLaunchKernelGGL(EmptyKernelWithArgs<kNumBytes>, dim3(1), dim3(1), 0,
+                     stream, KernelArgs<kNumBytes>{});
+}
+
+// Launches an empty kernel with `arg_size_bytes` bytes of arguments on
+// `stream`. Returns false if there is no kernel with this argument size.
+bool rocm_LaunchEmptyKernel(void* stream, int arg_size_bytes) {
+  hipStream_t hip_stream = reinterpret_cast<hipStream_t>(stream);
+  switch (arg_size_bytes) {
+    case 0:
+      hipLaunchKernelGGL(EmptyKernel, dim3(1), dim3(1), 0, hip_stream);
+      return true;
+    case 64:
+      LaunchEmptyKernelWithArgs<64>(hip_stream);
+      return true;
+    case 256:
+      LaunchEmptyKernelWithArgs<256>(hip_stream);
+      return true;
+    case 1024:
+      LaunchEmptyKernelWithArgs<1024>(hip_stream);
+      return true;
+    case 2048:
+      LaunchEmptyKernelWithArgs<2048>(hip_stream);
+      return true;
+    default:
+      return false;
+  }
+}
+
+}  // namespace gpu
+}  // namespace stream_executor
@@ -98,13 +98,24 @@ static string ToString(rocblas_status status) {
   }
 }
 
+namespace {
+
+// Size of the device workspace preallocated for each rocBLAS handle. It holds
+// the temporary buffers of the BLAS routines, which rocBLAS would otherwise
+// allocate and free on every call.
+constexpr uint64_t kWorkspaceSize = 32 * 1024 * 1024;
+
+}  // namespace
+
 bool ROCMBlas::Init() {
   gpu::ScopedActivateExecutorContext sac{parent_};
-  rocblas_status ret = wrap::rocblas_create_handle(&blas_);
+  rocblas_handle handle;
+  rocblas_status ret = wrap::rocblas_create_handle(&handle);
   if (ret != rocblas_status_success) {
     LOG(ERROR) << "failed to create rocBLAS handle: " << ToString(ret);
     return false;
   }
+  wrap::rocblas_destroy_handle(handle);
 
 #if TF_HIPBLASLT
   if (!blas_lt_.Init().ok()) {
@@ -116,7 +127,7 @@ bool ROCMBlas::Init() {
 }
 
 ROCMBlas::ROCMBlas(gpu::GpuExecutor *parent)
-    : parent_(CHECK_NOTNULL(parent)), blas_(nullptr)
+    : parent_(CHECK_NOTNULL(parent))
 #if TF_HIPBLASLT
     , 
     blas_lt_(parent)
@@ -124,25 +135,60 @@ ROCMBlas::ROCMBlas(gpu::GpuExecutor *parent)
      {}
 
 ROCMBlas::~ROCMBlas() {
-  if (blas_ != nullptr) {
-    gpu::ScopedActivateExecutorContext sac{parent_};
-    wrap::rocblas_destroy_handle(blas_);
+  absl::MutexLock lock{&mu_};
+  if (handles_.empty()) {
+    return;
+  }
+  gpu::ScopedActivateExecutorContext sac{parent_};
+  for (auto &[stream, entry] : handles_) {
+    wrap::rocblas_destroy_handle(entry->handle);
+    if (!entry->workspace.is_null()) {
+      parent_->Deallocate(&entry->workspace);
+    }
   }
 }
 
-bool ROCMBlas::SetStream(Stream *stream) {
+ROCMBlas::StreamHandle *ROCMBlas::GetHandle(Stream *stream) {
   CHECK(stream != nullptr);
-  CHECK(AsGpuStreamValue(stream) != nullptr);
-  CHECK(blas_ != nullptr);
+  GpuStreamHandle gpu_stream = AsGpuStreamValue(stream);
+  CHECK(gpu_stream != nullptr);
+
+  absl::MutexLock lock{&mu_};
+  auto it = handles_.find(gpu_stream);
+  if (it != handles_.end()) {
+    return it->second.get();
+  }
+
   gpu::ScopedActivateExecutorContext sac{parent_};
-  rocblas_status ret =
-      wrap::rocblas_set_stream(blas_, AsGpuStreamValue(stream));
+  auto entry = std::make_unique<StreamHandle>();
+  rocblas_status ret = wrap::rocblas_create_handle(&entry->handle);
+  if (ret != rocblas_status_success) {
+    LOG(ERROR) << "failed to create rocBLAS handle: " << ToString(ret);
+    return nullptr;
+  }
+  ret = wrap::rocblas_set_stream(entry->handle, gpu_stream);
   if (ret != rocblas_status_success) {
     LOG(ERROR) << "failed to set stream for rocBLAS calls: " << ToString(ret);
-    return false;
+    wrap::rocblas_destroy_handle(entry->handle);
+    return nullptr;
   }
 
-  return true;
+  // Without a workspace of its own, the handle falls back to the device memory
+  // management of rocBLAS, so a failed allocation is not an error.
+  entry->workspace = parent_->Allocate(kWorkspaceSize, /*memory_space=*/0);
+  if (!entry->workspace.is_null()) {
+    ret = wrap::rocblas_set_workspace(entry->handle,
+                                      entry->workspace.opaque(),
+                                      entry->workspace.size());
+    if (ret != rocblas_status_success) {
+      VLOG(1) << "failed to set the rocBLAS workspace: " << ToString(ret);
+      parent_->Deallocate(&entry->workspace);
+    }
+  }
+
+  StreamHandle *handle = entry.get();
+  handles_.emplace(gpu_stream, std::move(entry));
+  return handle;
 }
 
 namespace {
@@ -201,12 +247,11 @@ template <typename FuncT, typename... Args>
 bool ROCMBlas::DoBlasInternalImpl(FuncT rocblas_func, Stream *stream,
                                   bool pointer_mode_host, bool err_on_failure,
                                   Args... args) {
-  absl::MutexLock lock{&mu_};
-
-  CHECK(blas_ != nullptr);
-  if (!SetStream(stream)) {
+  StreamHandle *handle = GetHandle(stream);
+  if (handle == nullptr) {
     return false;
   }
+  absl::MutexLock lock{&handle->mu};
 
   gpu::ScopedActivateExecutorContext sac{parent_};
 
@@ -214,14 +259,15 @@ bool ROCMBlas::DoBlasInternalImpl(FuncT rocblas_func, Stream *stream,
   bool allow_atomics = !OpDeterminismRequired();
   rocblas_status ret;
   if (!allow_atomics) {
-    ret = wrap::rocblas_set_atomics_mode(blas_, rocblas_atomics_not_allowed);
+    ret = wrap::rocblas_set_atomics_mode(handle->handle,
+                                         rocblas_atomics_not_allowed);
     if (err_on_failure && ret != rocblas_status_success) {
       LOG(ERROR) << "failed to to set atomics mode before "
                  << rocblas_func.kName << ": " << ToString(ret);
     }
   }
 
-  ret = rocblas_func(blas_, args...);
+  ret = rocblas_func(handle->handle, args...);
   if (err_on_failure && ret != rocblas_status_success) {
     LOG(ERROR) << "failed to run ROCBLAS routine " << rocblas_func.kName << ": "
                << ToString(ret);
@@ -535,6 +581,52 @@ tsl::Status ROCMBlas::DoBlasGemm(Stream *stream, blas::Transpose transa,
   }
 }
 
+static tsl::StatusOr<std::unique_ptr<GpuTimer, GpuTimerDeleter>>
+StartGpuTimerForProfile(Stream *stream, GpuExecutor *executor,
+                        blas::ProfileResult *output_profile_result) {
+  std::unique_ptr<GpuTimer, GpuTimerDeleter> timer;
+  if (output_profile_result) {
+    timer.reset(new GpuTimer(executor));
+    if (!timer->Init() || !timer->Start(AsGpuStream(stream))) {
+      return tsl::errors::Internal(
+          "output_profile_result given, but unable to create a GpuTimer");
+    }
+  }
+  return timer;
+}
+
+static tsl::Status PopulateProfileFromTimer(
+    GpuTimer *timer, blas::AlgorithmType algorithm,
+    blas::ProfileResult *output_profile_result, Stream *stream) {
+  if (timer) {
+    if (!timer->Stop(AsGpuStream(stream))) {
+      return tsl::errors::Internal("unable to stop GpuTimer.");
+    }
+    output_profile_result->set_is_valid(true);
+    output_profile_result->set_algorithm(algorithm);
+    output_profile_result->set_elapsed_time_in_ms(
+        timer->GetElapsedMilliseconds());
+  }
+  return tsl::OkStatus();
+}
+
+// The GEMMs with an algorithm are only implemented for int8 inputs with int32
+// accumulation and output, which is what the int8 GEMMs of XLA ask for. The
+// other types go through DoBlasGemm.
+static tsl::Status CheckInt8GemmTypes(absl::string_view name,
+                                      blas::DataType type_a,
+                                      blas::DataType type_b,
+                                      blas::DataType type_c,
+                                      blas::ComputationType computation_type) {
+  if (type_a != blas::DataType::kInt8 || type_b != blas::DataType::kInt8 ||
+      type_c != blas::DataType::kInt32 ||
+      computation_type != blas::ComputationType::kI32) {
+    return tsl::errors::Internal(
+        name, " is only implemented on ROCm for int8 inputs and int32 output");
+  }
+  return tsl::OkStatus();
+}
+
 tsl::Status ROCMBlas::DoBlasGemmWithAlgorithm(
     Stream *stream, blas::Transpose transa, blas::Transpose transb, uint64_t m,
     uint64_t n, uint64 k, const void *alpha, const DeviceMemoryBase &a,
@@ -543,9 +635,23 @@ tsl::Status ROCMBlas::DoBlasGemmWithAlgorithm(
     blas::DataType type_c, int ldc, blas::ComputationType computation_type,
     blas::AlgorithmType algorithm, blas::ComputePrecision precision,
     blas::ProfileResult *output_profile_result) {
-  // ROCM TODO: properly implement the interface
-  return tsl::errors::Internal("DoBlasGemmWithAlgorithm ",
-                               "is not implemented on ROCm yet");
+  TF_RETURN_IF_ERROR(CheckInt8GemmTypes("DoBlasGemmWithAlgorithm", type_a,
+                                        type_b, type_c, computation_type));
+  blas_log("DoBlasGemmWithAlgorithm");
+  TF_ASSIGN_OR_RETURN(auto timer, StartGpuTimerForProfile(
+                                      stream, parent_, output_profile_result));
+
+  // rocBLAS has a single algorithm for the int8 GEMM. The int8 matrices are
+  // not packed in int8x4 (flags = 0).
+  TF_RETURN_IF_ERROR(DoBlasInternalStatus(
+      wrap::rocblas_gemm_ex, stream, /* pointer_mode_host = */ true,
+      ROCMBlasTranspose(transa), ROCMBlasTranspose(transb), (rocblas_int)m,
+      (rocblas_int)n, (rocblas_int)k, alpha, a.opaque(), rocblas_datatype_i8_r,
+      lda, b.opaque(), rocblas_datatype_i8_r, ldb, beta, c->opaque(),
+      rocblas_datatype_i32_r, ldc, c->opaque(), rocblas_datatype_i32_r, ldc,
+      rocblas_datatype_i32_r, rocblas_gemm_algo_standard, 0, 0));
+  return PopulateProfileFromTimer(timer.get(), algorithm,
+                                  output_profile_result, stream);
 }
 
 tsl::Status ROCMBlas::DoBlasGemmStridedBatchedWithAlgorithm(
@@ -557,9 +663,24 @@ tsl::Status ROCMBlas::DoBlasGemmStridedBatchedWithAlgorithm(
     int batch_count, blas::ComputationType computation_type,
     blas::AlgorithmType algorithm, blas::ComputePrecision precision,
     blas::ProfileResult *output_profile_result) {
-  // ROCM TODO: properly implement the interface
-  return tsl::errors::Internal("DoBlasGemmStridedBatchedWithAlgorithm ",
-                               "is not implemented on ROCm yet");
+  TF_RETURN_IF_ERROR(CheckInt8GemmTypes("DoBlasGemmStridedBatchedWithAlgorithm",
+                                        type_a, type_b, type_c,
+                                        computation_type));
+  blas_log("DoBlasGemmStridedBatchedWithAlgorithm");
+  TF_ASSIGN_OR_RETURN(auto timer, StartGpuTimerForProfile(
+                                      stream, parent_, output_profile_result));
+
+  TF_RETURN_IF_ERROR(DoBlasInternalStatus(
+      wrap::rocblas_gemm_strided_batched_ex, stream,
+      /* pointer_mode_host = */ true, ROCMBlasTranspose(transa),
+      ROCMBlasTranspose(transb), (rocblas_int)m, (rocblas_int)n,
+      (rocblas_int)k, alpha, a.opaque(), rocblas_datatype_i8_r, lda, stride_a,
+      b.opaque(), rocblas_datatype_i8_r, ldb, stride_b, beta, c->opaque(),
+      rocblas_datatype_i32_r, ldc, stride_c, c->opaque(),
+      rocblas_datatype_i32_r, ldc, stride_c, batch_count,
+      rocblas_datatype_i32_r, rocblas_gemm_algo_standard, 0, 0));
+  return PopulateProfileFromTimer(timer.get(), algorithm,
+                                  output_profile_result, stream);
 }
 
 bool ROCMBlas::GetBlasGemmAlgorithms(
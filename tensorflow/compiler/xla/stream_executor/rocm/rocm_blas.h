@@ -20,7 +20,10 @@ limitations under the License.
 #ifndef TENSORFLOW_COMPILER_XLA_STREAM_EXECUTOR_ROCM_ROCM_BLAS_H_
 #define TENSORFLOW_COMPILER_XLA_STREAM_EXECUTOR_ROCM_ROCM_BLAS_H_
 
+#include <memory>
+
 #include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "rocm/rocm_config.h"
@@ -30,6 +33,8 @@ limitations under the License.
 #include "rocm/include/rocblas.h"
 #endif
 #include "tensorflow/compiler/xla/stream_executor/blas.h"
+#include "tensorflow/compiler/xla/stream_executor/device_memory.h"
+#include "tensorflow/compiler/xla/stream_executor/gpu/gpu_types.h"
 #include "tensorflow/compiler/xla/stream_executor/platform/port.h"
 #include "tensorflow/compiler/xla/stream_executor/plugin_registry.h"
 #include "tensorflow/compiler/xla/stream_executor/temporary_device_memory.h"
@@ -89,10 +94,11 @@ class ROCMBlas : public blas::BlasSupport {
  public:
   explicit ROCMBlas(GpuExecutor *parent);
 
-  // Allocates a rocBLAS handle.
+  // Checks that rocBLAS handles can be created on the device. The handles are
+  // created lazily, one per stream.
   bool Init();
 
-  // Releases the rocBLAS handle, if present.
+  // Releases the rocBLAS handles and their workspaces.
   ~ROCMBlas() override;
 
   TENSORFLOW_STREAM_EXECUTOR_GPU_BLAS_SUPPORT_OVERRIDES
@@ -100,12 +106,22 @@ class ROCMBlas : public blas::BlasSupport {
   BlasLt &blas_lt() { return blas_lt_; }
 #endif
  private:
-  // Tells rocBLAS to enqueue the BLAS operation onto a particular Stream.
+  // A rocBLAS handle bound to one GPU stream, with the device workspace it
+  // uses for the temporary buffers of the BLAS routines.
+  struct StreamHandle {
+    // Serializes the BLAS calls on the handle, which is not thread-safe.
+    absl::Mutex mu;
+    rocblas_handle handle = nullptr;
+    DeviceMemoryBase workspace;
+  };
+
+  // Returns the handle bound to `stream`, creating it on the first use.
   //
-  // rocBLAS is stateful, and only be associated with one stream (in order to
-  // enqueue dispatch) at a given time. As a result, this generally must be
-  // invoked before calling into rocBLAS.
-  bool SetStream(Stream *stream) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  // rocBLAS is stateful, and a handle can only be associated with one stream
+  // (in order to enqueue dispatch) at a given time. Giving each stream its own
+  // handle lets the streams issue BLAS calls concurrently, without rebinding
+  // the handle before every call. Returns nullptr on failure.
+  StreamHandle *GetHandle(Stream *stream);
 
   // A helper function that calls the real rocBLAS function together with error
   // handling.
@@ -186,15 +202,18 @@ class ROCMBlas : public blas::BlasSupport {
       DeviceMemorySlice<T> c_ptrs_to_wrappers, int ldc, int batch_count,
       ScratchAllocator *scratch_allocator);
 
-  // mutex that guards the rocBLAS handle for this device.
+  // mutex that guards the map of rocBLAS handles for this device.
   absl::Mutex mu_;
 
   // GpuExecutor which instantiated this ROCMBlas.
   // Immutable post-initialization.
   GpuExecutor *parent_;
 
-  // rocBLAS library handle on the device.
-  rocblas_handle blas_ ABSL_GUARDED_BY(mu_);
+  // rocBLAS library handles on the device, keyed by the GPU stream they are
+  // bound to. The entries are never removed before the destructor, so the
+  // pointers returned by GetHandle stay valid.
+  absl::flat_hash_map<GpuStreamHandle, std::unique_ptr<StreamHandle>> handles_
+      ABSL_GUARDED_BY(mu_);
 
 #if TF_HIPBLASLT
   BlasLt blas_lt_;
@@ -17,11 +17,18 @@ limitations under the License.
 
 #include <functional>
 #include <memory>
+#include <optional>
+#include <string>
+#include <vector>
 
 #include "absl/algorithm/container.h"
 #include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
+#include "absl/strings/str_split.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "third_party/eigen3/Eigen/Core"
 #include "rocm/include/miopen/miopen.h"
@@ -530,7 +537,7 @@ uint64_t GetHashValue(miopenConvolutionDescriptor_t conv_desc) {
 
   uint64_t hash_value = tsl::hash<int>()(c_mode);
   auto hash64Combine = [&hash_value](int element) {
-    tsl::Hash64Combine(hash_value, tsl::hash<int>()(element));
+    hash_value = tsl::Hash64Combine(hash_value, tsl::hash<int>()(element));
   };
   std::for_each(pad.begin(), pad.end(), hash64Combine);
   std::for_each(stride.begin(), stride.end(), hash64Combine);
@@ -625,6 +632,137 @@ std::map<uint64_t, miopenFusionPlanDescriptor_t>
     CachedFusionPlans::cached_plans;
 std::set<uint64_t> CachedFusionPlans::unsupported_plans;
 
+// Process-wide, optionally persistent cache of the algorithms picked by the
+// MIOpen Find mode APIs.
+//
+// By default the Find results only live in process memory. If the env var
+// TF_ROCM_MIOPEN_FIND_CACHE_PATH is set to a file name, the results are also
+// loaded from and appended to that file, so that a freshly started process does
+// not have to benchmark again the convolutions seen by its predecessors. With
+// TF_ROCM_MIOPEN_FIND_CACHE_READ_ONLY=1 the file is only read, which allows a
+// cache generated ahead of time to be shared by several replicas.
+//
+// The file starts with a header recording the cache format, the ROCm and the
+// MIOpen versions it was produced with; a file with a different header is
+// ignored (and rewritten unless read-only). Each entry is keyed on the GCN
+// architecture, the convolution kind and the hash of the tensor, filter and
+// convolution descriptors.
+class MIOpenFindCache {
+ public:
+  struct Entry {
+    int64_t algo_id;
+    size_t workspace_size;
+    float elapsed_time_in_ms;
+  };
+
+  static MIOpenFindCache& Get() {
+    static MIOpenFindCache* cache = new MIOpenFindCache();
+    return *cache;
+  }
+
+  std::optional<Entry> Lookup(const std::string& key) {
+    absl::MutexLock lock{&mutex_};
+    auto it = entries_.find(key);
+    if (it == entries_.end()) return std::nullopt;
+    return it->second;
+  }
+
+  void Insert(const std::string& key, const Entry& entry) {
+    absl::MutexLock lock{&mutex_};
+    entries_[key] = entry;
+    if (path_.empty() || read_only_) return;
+
+    if (file_ == nullptr) {
+      // Start a new file if there is none yet or the existing one has been
+      // produced by a different ROCm / MIOpen version.
+      tsl::Env* env = tsl::Env::Default();
+      tsl::Status status = file_is_current_
+                               ? env->NewAppendableFile(path_, &file_)
+                               : env->NewWritableFile(path_, &file_);
+      if (status.ok() && !file_is_current_) {
+        status = file_->Append(absl::StrCat(Header(), "\n"));
+        file_is_current_ = status.ok();
+      }
+      if (!status.ok()) {
+        LOG(WARNING) << "Failed to open MIOpen find cache " << path_
+                     << " for writing: " << status;
+        file_.reset();
+        path_.clear();
+        return;
+      }
+    }
+
+    // Whole lines are appended with a single write so that concurrent writers
+    // sharing the file do not interleave entries.
+    tsl::Status status = file_->Append(
+        absl::StrCat(key, " ", entry.algo_id, " ", entry.workspace_size, " ",
+                     entry.elapsed_time_in_ms, "\n"));
+    if (status.ok()) status = file_->Flush();
+    if (!status.ok()) {
+      LOG(WARNING) << "Failed to write to MIOpen find cache " << path_ << ": "
+                   << status;
+    }
+  }
+
+ private:
+  MIOpenFindCache() {
+    TF_CHECK_OK(tsl::ReadStringFromEnvVar("TF_ROCM_MIOPEN_FIND_CACHE_PATH", "",
+                                          &path_));
+    TF_CHECK_OK(tsl::ReadBoolFromEnvVar("TF_ROCM_MIOPEN_FIND_CACHE_READ_ONLY",
+                                        false, &read_only_));
+    if (!path_.empty()) {
+      absl::MutexLock lock{&mutex_};
+      Load();
+    }
+  }
+
+  static std::string Header() {
+    return absl::StrCat("# miopen-find-cache v1 rocm=", TF_ROCM_VERSION,
+                        " miopen=", TF_MIOPEN_VERSION);
+  }
+
+  void Load() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    std::string contents;
+    tsl::Status status =
+        tsl::ReadFileToString(tsl::Env::Default(), path_, &contents);
+    if (!status.ok()) {
+      VLOG(1) << "No MIOpen find cache loaded from " << path_ << ": " << status;
+      return;
+    }
+
+    std::vector<absl::string_view> lines = absl::StrSplit(contents, '\n');
+    if (lines.empty() || lines[0] != Header()) {
+      LOG(WARNING) << "Ignoring MIOpen find cache " << path_
+                   << " produced by a different ROCm / MIOpen version";
+      return;
+    }
+    file_is_current_ = true;
+
+    for (size_t i = 1; i < lines.size(); ++i) {
+      std::vector<absl::string_view> fields =
+          absl::StrSplit(lines[i], ' ', absl::SkipEmpty());
+      Entry entry;
+      // Skip truncated or malformed lines, e.g. left by an interrupted writer.
+      if (fields.size() != 4 || !absl::SimpleAtoi(fields[1], &entry.algo_id) ||
+          !absl::SimpleAtoi(fields[2], &entry.workspace_size) ||
+          !absl::SimpleAtof(fields[3], &entry.elapsed_time_in_ms)) {
+        continue;
+      }
+      entries_[std::string(fields[0])] = entry;
+    }
+    VLOG(1) << "Loaded " << entries_.size()
+            << " MIOpen find results from " << path_;
+  }
+
+  absl::Mutex mutex_;
+  std::string path_;
+  bool read_only_ = false;
+  // Whether the file at `path_` exists and has a header matching this build.
+  bool file_is_current_ = false;
+  std::unique_ptr<tsl::WritableFile> file_ ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_map<std::string, Entry> entries_ ABSL_GUARDED_BY(mutex_);
+};
+
 dnn::ProfileResult GetProfileResultFromConvSolution(
     miopenConvSolution_t solution) {
   dnn::ProfileResult profile_result;
@@ -1671,15 +1809,15 @@ class ScopedFusionPlanBatchNormActivationForward : public ScopedFusionPlanBase {
     }
   }
 
-  miopenStatus_t SetBatchNormForwardArgs(const void* scale, const void* offset,
-                                         void* batch_mean, void* batch_var,
-                                         void* saved_mean, void* saved_var,
-                                         double epsilon) {
+  miopenStatus_t SetBatchNormForwardArgs(
+      const void* scale, const void* offset, void* batch_mean, void* batch_var,
+      void* saved_mean, void* saved_var, double epsilon,
+      double exponential_average_factor = 1.0) {
     float alpha = 1.0;
     float beta = 0.0;
     return ScopedFusionPlanBase::SetBatchNormForwardArgs(
         k_batchnorm_op_idx, &alpha, &beta, scale, offset, batch_mean, batch_var,
-        saved_mean, saved_var, /*exponential_average_factor=*/1.0, epsilon);
+        saved_mean, saved_var, exponential_average_factor, epsilon);
   }
 
   miopenStatus_t SetActivationForwardArgs(
@@ -1941,8 +2079,16 @@ class MIOpenRnnParamsDescriptor : public MIOpenDescriptorCommon<void> {
   SE_DISALLOW_COPY_AND_ASSIGN(MIOpenRnnParamsDescriptor);
 };
 
+class MIOpenRnnSequenceTensorDescriptor;
+
 class MIOpenRnnDescriptor : public MIOpenDescriptorCommon<dnn::RnnDescriptor> {
  public:
+  // The sizes of the buffers of the RNN calls for a shape of the input.
+  struct SpaceSizes {
+    size_t workspace_size_in_bytes = 0;
+    size_t reserve_space_size_in_bytes = 0;
+  };
+
   MIOpenRnnDescriptor(miopenHandle_t miopen_handle, int num_layers,
                       int hidden_size, int input_size,
                       miopenRNNInputMode_t input_mode,
@@ -2005,6 +2151,12 @@ class MIOpenRnnDescriptor : public MIOpenDescriptorCommon<dnn::RnnDescriptor> {
     if (!miopen_params_desc_) return nullptr;
     return miopen_params_desc_->handle();
   }
+  // Returns the sizes of the buffers for the shape of `input_desc`. They are
+  // queried once per shape, since the cached descriptors run the many short
+  // sequences of a model with the same shapes.
+  tsl::StatusOr<SpaceSizes> GetSpaceSizes(
+      miopenHandle_t miopen_handle,
+      const MIOpenRnnSequenceTensorDescriptor& input_desc) const;
   ParamsRegions ParamsWeightRegions() const override {
     if (!ok()) return ParamsRegions();
     return miopen_params_desc_->params_weights();
@@ -2028,6 +2180,10 @@ class MIOpenRnnDescriptor : public MIOpenDescriptorCommon<dnn::RnnDescriptor> {
   // no dropout in MIOpen.
   // std::unique_ptr<miopenDropoutDescriptor> miopen_dropout_desc_;
   std::unique_ptr<MIOpenRnnParamsDescriptor> miopen_params_desc_;
+  // The sizes of the buffers keyed by the sequence length and the batch size.
+  mutable absl::Mutex space_sizes_mu_;
+  mutable absl::flat_hash_map<std::pair<int, int>, SpaceSizes> space_sizes_
+      ABSL_GUARDED_BY(space_sizes_mu_);
   SE_DISALLOW_COPY_AND_ASSIGN(MIOpenRnnDescriptor);
 };
 
@@ -2235,21 +2391,9 @@ bool CheckRNNParameterSize(
          rnn_desc.ParamsSizeInBytes();
 }
 
-bool CreateRnnWorkspace(Stream* stream, miopenHandle_t miopen_handle,
-                        const MIOpenRnnDescriptor& rnn_desc,
-                        const MIOpenRnnSequenceTensorDescriptor& input_desc,
+bool CreateRnnWorkspace(Stream* stream, size_t workspace_size_in_bytes,
                         ScratchAllocator* workspace_allocator,
                         DeviceMemory<uint8>* workspace) {
-  // Query the workspace size.
-  size_t workspace_size_in_bytes = 0;
-  auto status = wrap::miopenGetRNNWorkspaceSize(
-      miopen_handle /*handle*/, rnn_desc.handle() /*rnnDesc*/,
-      input_desc.seq_length() /*seqLength*/, input_desc.handles() /*xDesc*/,
-      &workspace_size_in_bytes /*sizeInBytes*/);
-  if (status != miopenStatusSuccess) {
-    LOG(ERROR) << "Unable to query workspace size: " << ToString(status);
-    return false;
-  }
   // Allocate the workspace.
   if (workspace_size_in_bytes > 0) {
     auto allocated =
@@ -2268,6 +2412,43 @@ bool CreateRnnWorkspace(Stream* stream, miopenHandle_t miopen_handle,
 
 }  // namespace
 
+tsl::StatusOr<MIOpenRnnDescriptor::SpaceSizes>
+MIOpenRnnDescriptor::GetSpaceSizes(
+    miopenHandle_t miopen_handle,
+    const MIOpenRnnSequenceTensorDescriptor& input_desc) const {
+  const std::pair<int, int> key(input_desc.seq_length(),
+                                input_desc.batch_size());
+  absl::MutexLock lock(&space_sizes_mu_);
+  auto it = space_sizes_.find(key);
+  if (it != space_sizes_.end()) return it->second;
+
+  if (!CheckRNNParameterSize(miopen_handle, *this, input_desc)) {
+    return tsl::Status(absl::StatusCode::kInvalidArgument,
+                       "Invalid RNN parameter size");
+  }
+  SpaceSizes sizes;
+  auto status = wrap::miopenGetRNNWorkspaceSize(
+      miopen_handle /*handle*/, rnn_desc_ /*rnnDesc*/,
+      input_desc.seq_length() /*seqLength*/, input_desc.handles() /*xDesc*/,
+      &sizes.workspace_size_in_bytes /*sizeInBytes*/);
+  if (status != miopenStatusSuccess) {
+    return tsl::Status(
+        absl::StatusCode::kInternal,
+        absl::StrCat("Unable to query workspace size: ", ToString(status)));
+  }
+  status = wrap::miopenGetRNNTrainingReserveSize(
+      miopen_handle /*handle*/, rnn_desc_ /*rnnDesc*/,
+      input_desc.seq_length() /*seqLength*/, input_desc.handles() /*xDesc*/,
+      &sizes.reserve_space_size_in_bytes /*sizeInBytes*/);
+  if (status != miopenStatusSuccess) {
+    return tsl::Status(absl::StatusCode::kInternal,
+                       absl::StrCat("Unable to query reserve space size: ",
+                                    ToString(status)));
+  }
+  space_sizes_.emplace(key, sizes);
+  return sizes;
+}
+
 template <class T>
 bool MIOpenSupport::DoRnnForwardImpl(
     Stream* stream, const MIOpenRnnDescriptor& rnn_desc,
@@ -2300,36 +2481,27 @@ bool MIOpenSupport::DoRnnForwardImpl(
 
   auto miopen = miopen_->GetHandle(parent_, stream);
 
-  // check params size
-
-  if (!CheckRNNParameterSize(miopen.handle(), rnn_desc, input_desc)) {
-    LOG(ERROR) << "Invalid parameters";
+  // check params size and query the sizes of the spaces
+  auto space_sizes = rnn_desc.GetSpaceSizes(miopen.handle(), input_desc);
+  if (!space_sizes.ok()) {
+    LOG(ERROR) << space_sizes.status();
     return false;
   }
 
   // create the workspace
   DeviceMemory<uint8> workspace;
-  if (!CreateRnnWorkspace(stream, miopen.handle(), rnn_desc, input_desc,
+  if (!CreateRnnWorkspace(stream, space_sizes->workspace_size_in_bytes,
                           workspace_allocator, &workspace)) {
     LOG(ERROR) << "Unable to create rnn workspace";
 
     return false;
   }
 
-  // query the reserve space size
   // allocate the reserve space
   DeviceMemory<uint8> reserve_space;
   if (is_training) {
-    size_t reserve_space_size_in_bytes = 0;
-    auto status = wrap::miopenGetRNNTrainingReserveSize(
-        miopen.handle() /*handle*/, rnn_desc.handle() /*rnnDesc*/,
-        model_dims.seq_length /*seqLength*/, input_desc.handles() /*xDesc*/,
-        &reserve_space_size_in_bytes /*sizeInBytes*/);
-    if (status != miopenStatusSuccess) {
-      LOG(ERROR) << "Unable to query reserve space size: " << ToString(status);
-      return false;
-    }
-
+    const size_t reserve_space_size_in_bytes =
+        space_sizes->reserve_space_size_in_bytes;
     if (reserve_space_size_in_bytes > 0) {
       auto allocated =
           reserve_space_allocator->AllocateBytes(reserve_space_size_in_bytes);
@@ -2446,16 +2618,16 @@ bool MIOpenSupport::DoRnnBackwardImpl(
 
   auto miopen = miopen_->GetHandle(parent_, stream);
 
-  // check params size
-
-  if (!CheckRNNParameterSize(miopen.handle(), rnn_desc, input_desc)) {
-    LOG(ERROR) << "Invalid parameters";
+  // check params size and query the sizes of the spaces
+  auto space_sizes = rnn_desc.GetSpaceSizes(miopen.handle(), input_desc);
+  if (!space_sizes.ok()) {
+    LOG(ERROR) << space_sizes.status();
     return false;
   }
 
   // create the workspace
   DeviceMemory<uint8> workspace;
-  if (!CreateRnnWorkspace(stream, miopen.handle(), rnn_desc, input_desc,
+  if (!CreateRnnWorkspace(stream, space_sizes->workspace_size_in_bytes,
                           workspace_allocator, &workspace)) {
     LOG(ERROR) << "Unable to create rnn workspace";
     return false;
@@ -3622,6 +3794,30 @@ bool MIOpenSupport::GetMIOpenConvolveAlgorithmsFindMode(
   ScopedConvolutionDescriptor conv{convolution_descriptor,
                                    ToMIOpenDataType(element_type)};
 
+  // Reuse a previous Find result for the same problem, possibly produced by
+  // another process, instead of benchmarking again.
+  uint64_t problem_hash = GetHashValue(input_nd.handle());
+  problem_hash = tsl::Hash64Combine(problem_hash, GetHashValue(filter.handle()));
+  problem_hash =
+      tsl::Hash64Combine(problem_hash, GetHashValue(output_nd.handle()));
+  problem_hash = tsl::Hash64Combine(problem_hash, GetHashValue(conv.handle()));
+  const std::string find_cache_key = absl::StrCat(
+      stream->parent()->GetDeviceDescription().rocm_compute_capability()
+          .gcn_arch_name(),
+      "/", static_cast<int>(kind), "/", absl::Hex(problem_hash));
+  MIOpenFindCache& find_cache = MIOpenFindCache::Get();
+  if (auto cached = find_cache.Lookup(find_cache_key)) {
+    VLOG(kConvDebugVlogLevel)
+        << "Using cached MIOpen find result for " << find_cache_key;
+    dnn::ProfileResult profile_result;
+    profile_result.set_algorithm(
+        {cached->algo_id, false, cached->workspace_size});
+    profile_result.set_elapsed_time_in_ms(cached->elapsed_time_in_ms);
+    profile_result.set_scratch_size(cached->workspace_size);
+    out_algorithms->push_back(profile_result);
+    return true;
+  }
+
   // Determine the workspace memory size that will need by the call to Find
   size_t scratch_memory_size = 0;
   switch (kind) {
@@ -3755,8 +3951,13 @@ bool MIOpenSupport::GetMIOpenConvolveAlgorithmsFindMode(
     }
   }
 
-  out_algorithms->emplace_back(
-      GetProfileResultFromConvAlgoPerf(kind, returnedAlgorithm));
+  dnn::ProfileResult profile_result =
+      GetProfileResultFromConvAlgoPerf(kind, returnedAlgorithm);
+  find_cache.Insert(
+      find_cache_key,
+      {profile_result.algorithm().algo_id(), profile_result.scratch_size(),
+       profile_result.elapsed_time_in_ms()});
+  out_algorithms->push_back(profile_result);
 
   return true;
 }
@@ -3776,6 +3977,32 @@ bool MIOpenSupport::GetRnnAlgorithms(
   return true;
 }
 
+template <typename T>
+void launchInplaceSideInputActivation(hipStream_t stream, void* y_data,
+                                      const void* side_input_data,
+                                      int activation_mode, uint64_t n);
+
+template <typename T>
+void launchReluBackward(hipStream_t stream, const void* dy_data,
+                        const void* y_data, void* dx_data, uint64_t n);
+
+namespace {
+
+// Maps the Eigen types used by the DNN interface to the HIP types of the
+// elementwise kernels in rocm_helpers.cu.cc.
+template <typename T>
+using HipElementType =
+    typename std::conditional<std::is_same_v<T, Eigen::half>, __half, T>::type;
+
+// MIOpen batch normalization has no side input or activation of its own, the
+// fused ops only support Relu on top of it.
+bool IsSupportedBatchNormActivation(dnn::ActivationMode activation_mode) {
+  return activation_mode == dnn::ActivationMode::kNone ||
+         activation_mode == dnn::ActivationMode::kRelu;
+}
+
+}  // namespace
+
 bool MIOpenSupport::DoBatchNormalizationForward(
     Stream* stream, const DeviceMemory<Eigen::half>& x,
     const DeviceMemory<float>& scale, const DeviceMemory<float>& offset,
@@ -3841,6 +4068,46 @@ bool MIOpenSupport::DoBatchNormalizationForwardImpl(
   float one = 1.0;
   float zero = 0.0;
 
+  const bool has_side_input = !side_input.is_null();
+  const bool has_activation = activation_mode != dnn::ActivationMode::kNone;
+  if (!IsSupportedBatchNormActivation(activation_mode)) {
+    LOG(ERROR) << "unsupported activation for MIOpen batch normalization: "
+               << dnn::ActivationModeString(activation_mode);
+    return false;
+  }
+
+  // BatchNorm+Activation has a MIOpen fusion plan for training. The residual
+  // BatchNorm+Add+Activation pattern does not, because fusion plans have no
+  // elementwise add, so the side input is added by a separate kernel.
+  if (is_training && has_activation && !has_side_input) {
+    ScopedActivationDescriptor activation_desc{activation_mode};
+    ScopedFusionPlanBatchNormActivationForward fusion_plan{
+        miopen.handle(), x_descriptor.handle(),
+        scale_offset_descriptor.handle(), activation_desc};
+    if (fusion_plan.CompilationSucceeded()) {
+      auto status = fusion_plan.SetBatchNormForwardArgs(
+          scale.opaque(), offset.opaque(), batch_mean->opaque(),
+          batch_var->opaque(), saved_mean->opaque(), saved_inv_var->opaque(),
+          epsilon, exponential_average_factor);
+      if (status == miopenStatusSuccess) {
+        status = fusion_plan.SetActivationForwardArgs(activation_desc);
+      }
+      if (status == miopenStatusSuccess) {
+        status = fusion_plan.Execute(x_descriptor.handle(), x.opaque(),
+                                     x_descriptor.handle(), y->opaque());
+      }
+      if (status != miopenStatusSuccess) {
+        LOG(ERROR) << "failed to enqueue fused forward batch normalization on "
+                      "stream: "
+                   << ToString(status);
+        return false;
+      }
+      return true;
+    }
+    VLOG(2) << "BatchNorm+Activation fusion plan is not supported, running "
+               "the activation as a separate kernel";
+  }
+
   auto status = miopenStatusInvalidValue;
   if (is_training) {
     status = wrap::miopenBatchNormalizationForwardTraining(
@@ -3863,6 +4130,12 @@ bool MIOpenSupport::DoBatchNormalizationForwardImpl(
                << ToString(status);
     return false;
   }
+  if (has_side_input || has_activation) {
+    launchInplaceSideInputActivation<HipElementType<T>>(
+        AsGpuStreamValue(stream), y->opaque(),
+        has_side_input ? side_input.opaque() : nullptr,
+        static_cast<int>(activation_mode), x_desc.ElementCount());
+  }
   return true;
 }
 
@@ -3879,9 +4152,10 @@ bool MIOpenSupport::DoBatchNormalizationBackward(
     DeviceMemory<uint8>* reserve_space_data,
     ScratchAllocator* workspace_allocator) {
   return DoBatchNormalizationBackwardImpl<Eigen::half, float>(
-      stream, miopenHalf, miopenFloat, y_backprop, x, scale, mean, inv_var,
-      x_desc, scale_offset_desc, epsilon, x_backprop, scale_backprop,
-      offset_backprop);
+      stream, miopenHalf, miopenFloat, y_backprop, x, scale, mean, inv_var, y,
+      x_desc, scale_offset_desc, epsilon, activation_mode, x_backprop,
+      scale_backprop, offset_backprop, side_input_backprop,
+      workspace_allocator);
 }
 
 bool MIOpenSupport::DoBatchNormalizationBackward(
@@ -3897,9 +4171,10 @@ bool MIOpenSupport::DoBatchNormalizationBackward(
     DeviceMemory<uint8>* reserve_space_data,
     ScratchAllocator* workspace_allocator) {
   return DoBatchNormalizationBackwardImpl<float, float>(
-      stream, miopenFloat, miopenFloat, y_backprop, x, scale, mean, variance,
-      x_desc, scale_offset_desc, epsilon, x_backprop, scale_backprop,
-      offset_backprop);
+      stream, miopenFloat, miopenFloat, y_backprop, x, scale, mean, variance, y,
+      x_desc, scale_offset_desc, epsilon, activation_mode, x_backprop,
+      scale_backprop, offset_backprop, side_input_backprop,
+      workspace_allocator);
 }
 
 template <class T, class U>
@@ -3907,10 +4182,13 @@ bool MIOpenSupport::DoBatchNormalizationBackwardImpl(
     Stream* stream, int miopen_input_type, int miopen_scale_type,
     const DeviceMemory<T>& y_backprop, const DeviceMemory<T>& x,
     const DeviceMemory<U>& scale, const DeviceMemory<U>& mean,
-    const DeviceMemory<U>& variance, const dnn::BatchDescriptor& x_desc,
+    const DeviceMemory<U>& variance, const DeviceMemory<T>& y,
+    const dnn::BatchDescriptor& x_desc,
     const dnn::BatchDescriptor& scale_offset_desc, const double epsilon,
-    DeviceMemory<T>* x_backprop, DeviceMemory<U>* scale_backprop,
-    DeviceMemory<U>* offset_backprop) {
+    dnn::ActivationMode activation_mode, DeviceMemory<T>* x_backprop,
+    DeviceMemory<U>* scale_backprop, DeviceMemory<U>* offset_backprop,
+    DeviceMemory<T>* side_input_backprop,
+    ScratchAllocator* workspace_allocator) {
   auto miopen = miopen_->GetHandle(parent_, stream);
   ScopedTensorDescriptor x_descriptor{
       x_desc, static_cast<miopenDataType_t>(miopen_input_type)};
@@ -3920,9 +4198,48 @@ bool MIOpenSupport::DoBatchNormalizationBackwardImpl(
   float one = 1.0;
   float zero = 0.0;
 
+  if (!IsSupportedBatchNormActivation(activation_mode)) {
+    LOG(ERROR) << "unsupported activation for MIOpen batch normalization: "
+               << dnn::ActivationModeString(activation_mode);
+    return false;
+  }
+
+  // For BatchNorm(+Add)+Relu the gradient of the activation is computed first.
+  // With a side input it is also the gradient of the side input, so it is
+  // written straight to side_input_backprop and fed to the batch norm from
+  // there; otherwise it goes to a workspace buffer.
+  DeviceMemory<T> bn_y_backprop = y_backprop;
+  if (activation_mode != dnn::ActivationMode::kNone) {
+    if (y.is_null()) {
+      LOG(ERROR) << "fused backward batch normalization requires the forward "
+                    "output";
+      return false;
+    }
+    if (side_input_backprop != nullptr && !side_input_backprop->is_null()) {
+      bn_y_backprop = *side_input_backprop;
+    } else {
+      if (workspace_allocator == nullptr) {
+        LOG(ERROR) << "fused backward batch normalization requires a "
+                      "workspace allocator";
+        return false;
+      }
+      auto allocated = workspace_allocator->AllocateBytes(y_backprop.size());
+      if (!allocated.ok()) {
+        LOG(ERROR) << "failed to allocate workspace for fused backward batch "
+                      "normalization: "
+                   << allocated.status();
+        return false;
+      }
+      bn_y_backprop = DeviceMemory<T>(allocated.value());
+    }
+    launchReluBackward<HipElementType<T>>(
+        AsGpuStreamValue(stream), y_backprop.opaque(), y.opaque(),
+        bn_y_backprop.opaque(), x_desc.ElementCount());
+  }
+
   auto status = wrap::miopenBatchNormalizationBackward(
       miopen.handle(), mode, &one, &zero, &one, &zero, x_descriptor.handle(),
-      x.opaque(), x_descriptor.handle(), y_backprop.opaque(),
+      x.opaque(), x_descriptor.handle(), bn_y_backprop.opaque(),
       x_descriptor.handle(), x_backprop->opaque(),
       scale_offset_descriptor.handle(), scale.opaque(),
       scale_backprop->opaque(), offset_backprop->opaque(), epsilon,
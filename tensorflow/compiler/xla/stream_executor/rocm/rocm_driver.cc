@@ -19,6 +19,7 @@ limitations under the License.
 #include <map>
 #include <set>
 #include <utility>
+#include <vector>
 
 #include "absl/base/casts.h"
 #include "absl/container/inlined_vector.h"
@@ -708,6 +709,135 @@ GpuDriver::ContextGetSharedMemConfig(GpuContext* context) {
                                                                      : lowest;
 }
 
+#if TF_ROCM_VERSION >= 60000
+/* static */ tsl::StatusOr<GpuDriver::VmemSpan> GpuDriver::ReserveVirtualMemory(
+    GpuContext* context, uint64_t bytes) {
+  ScopedActivateContext activation(context);
+  hipDeviceptr_t base;
+  hipError_t res = wrap::hipMemAddressReserve(&base, bytes, /*alignment=*/0,
+                                              /*addr=*/nullptr, /*flags=*/0);
+  if (res != hipSuccess) {
+    return tsl::errors::Internal(
+        absl::StrFormat("error reserving %d bytes of virtual GPU memory: %s",
+                        bytes, ToString(res)));
+  }
+  return {{base, bytes}};
+}
+
+/* static */ void GpuDriver::FreeVirtualMemory(
+    GpuContext* context, GpuDriver::VmemSpan reservation) {
+  ScopedActivateContext activation(context);
+  hipError_t res =
+      wrap::hipMemAddressFree(reservation.base, reservation.size_bytes);
+  if (res != hipSuccess) {
+    LOG(ERROR) << "error freeing vmem reservation of size "
+               << reservation.size_bytes << " at address " << reservation.base;
+  }
+}
+
+/* static */ tsl::StatusOr<uint64_t> GpuDriver::GetMinAllocationGranularity(
+    GpuDeviceHandle device) {
+  hipMemAllocationProp props = {};
+  props.type = hipMemAllocationTypePinned;
+  props.location.type = hipMemLocationTypeDevice;
+  props.location.id = device;
+
+  size_t granularity;
+  hipError_t res = wrap::hipMemGetAllocationGranularity(
+      &granularity, &props, hipMemAllocationGranularityMinimum);
+  if (res != hipSuccess) {
+    return tsl::errors::Internal("failed to get min allocation granularity: ",
+                                 ToString(res));
+  }
+  return granularity;
+}
+
+/* static */ tsl::StatusOr<GpuDriver::GenericMemoryHandle>
+GpuDriver::CreateMemoryHandle(GpuContext* context, uint64_t bytes) {
+  ScopedActivateContext activation(context);
+  hipDevice_t device;
+  TF_RETURN_IF_ERROR(GetDevice(context->device_ordinal(), &device));
+
+  hipMemAllocationProp props = {};
+  props.type = hipMemAllocationTypePinned;
+  props.location.type = hipMemLocationTypeDevice;
+  props.location.id = device;
+
+  hipMemGenericAllocationHandle_t mem_handle;
+  hipError_t res = wrap::hipMemCreate(&mem_handle, bytes, &props, 0);
+  if (res != hipSuccess) {
+    return tsl::errors::Internal(
+        absl::StrFormat("failed to create memory allocation of size %d: %s",
+                        bytes, ToString(res)));
+  }
+  // HIP allocation handles are opaque pointers; store them in the integral
+  // handle field shared with the CUDA implementation.
+  return GpuDriver::GenericMemoryHandle{
+      reinterpret_cast<uint64_t>(mem_handle), bytes};
+}
+
+/* static */ void GpuDriver::ReleaseMemoryHandle(
+    GpuContext* context, GpuDriver::GenericMemoryHandle handle) {
+  ScopedActivateContext activation(context);
+
+  hipError_t res = wrap::hipMemRelease(
+      reinterpret_cast<hipMemGenericAllocationHandle_t>(handle.handle));
+  if (res != hipSuccess) {
+    LOG(ERROR) << "Failed to release memory handle " << handle.handle
+               << " of size " << handle.bytes << ": " << ToString(res);
+  }
+}
+
+/* static */ tsl::Status GpuDriver::MapMemory(
+    GpuContext* context, hipDeviceptr_t va,
+    const GpuDriver::GenericMemoryHandle& handle,
+    const std::vector<GpuDeviceHandle>& device_handles) {
+  ScopedActivateContext activation(context);
+
+  // NB: Zero is the only valid value for both flags and offset.
+  hipError_t res = wrap::hipMemMap(
+      va, handle.bytes, /*offset=*/0,
+      reinterpret_cast<hipMemGenericAllocationHandle_t>(handle.handle),
+      /*flags=*/0);
+  if (res != hipSuccess) {
+    return tsl::errors::Internal(absl::StrFormat(
+        "Failed to map %d bytes at %p: %s", handle.bytes, va, ToString(res)));
+  }
+
+  std::vector<hipMemAccessDesc> access_descriptors(device_handles.size());
+  for (int i = 0; i < access_descriptors.size(); ++i) {
+    access_descriptors[i].location.id = device_handles[i];
+    access_descriptors[i].location.type = hipMemLocationTypeDevice;
+    access_descriptors[i].flags = hipMemAccessFlagsProtReadWrite;
+  }
+
+  res = wrap::hipMemSetAccess(va, handle.bytes, access_descriptors.data(),
+                              access_descriptors.size());
+  if (res != hipSuccess) {
+    // Unmap the memory that we failed to set access for.
+    if (wrap::hipMemUnmap(va, handle.bytes) != hipSuccess) {
+      LOG(ERROR)
+          << "Failed to unmap memory in GpuDriver::MapMemory error path.";
+    }
+    return tsl::errors::Internal(absl::StrFormat(
+        "Failed to set read/write access on memory mapped at %p: %s", va,
+        ToString(res)));
+  }
+  return tsl::OkStatus();
+}
+
+/* static */ void GpuDriver::UnmapMemory(GpuContext* context,
+                                         hipDeviceptr_t va, uint64_t bytes) {
+  ScopedActivateContext activation(context);
+
+  hipError_t res = wrap::hipMemUnmap(va, bytes);
+  if (res != hipSuccess) {
+    LOG(ERROR) << "Failed to unmap memory at " << va << " of size " << bytes
+               << ": " << ToString(res);
+  }
+}
+#endif  // TF_ROCM_VERSION >= 60000
+
 /* static */ tsl::Status GpuDriver::DestroyEvent(GpuContext* context,
                                                  GpuEventHandle* event) {
   if (*event == nullptr) {
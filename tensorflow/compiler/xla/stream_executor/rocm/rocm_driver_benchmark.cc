@@ -0,0 +1,251 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Microbenchmarks of the primitives of the ROCm StreamExecutor: kernel
+// launches, memcpys, events, streams and host callbacks.
+//
+// Run with:
+//   rocm_driver_benchmark --benchmark_filter=all --benchmark_format=json
+
+#if TENSORFLOW_USE_ROCM
+#include <cstdint>
+#include <vector>
+
+#include "absl/synchronization/notification.h"
+#include "tensorflow/compiler/xla/stream_executor/device_memory.h"
+#include "tensorflow/compiler/xla/stream_executor/event.h"
+#include "tensorflow/compiler/xla/stream_executor/gpu/gpu_stream.h"
+#include "tensorflow/compiler/xla/stream_executor/multi_platform_manager.h"
+#include "tensorflow/compiler/xla/stream_executor/stream.h"
+#include "tensorflow/compiler/xla/stream_executor/stream_executor.h"
+#include "tensorflow/tsl/platform/logging.h"
+#include "tensorflow/tsl/platform/status.h"
+#include "tensorflow/tsl/platform/test_benchmark.h"
+
+namespace stream_executor {
+namespace gpu {
+
+extern bool rocm_LaunchEmptyKernel(void* stream, int arg_size_bytes);
+
+namespace {
+
+StreamExecutor* GetExecutor() {
+  Platform* platform = MultiPlatformManager::PlatformWithName("ROCM").value();
+  return platform->ExecutorForDevice(0).value();
+}
+
+// Host memory of `size` bytes, pinned or pageable.
+class HostBuffer {
+ public:
+  HostBuffer(StreamExecutor* executor, int64_t size, bool pinned)
+      : executor_(executor), pinned_(pinned) {
+    if (pinned_) {
+      data_ = executor_->HostMemoryAllocate(size);
+    } else {
+      pageable_.resize(size);
+      data_ = pageable_.data();
+    }
+  }
+
+  ~HostBuffer() {
+    if (pinned_) {
+      executor_->HostMemoryDeallocate(data_);
+    }
+  }
+
+  void* data() { return data_; }
+
+ private:
+  StreamExecutor* executor_;
+  const bool pinned_;
+  std::vector<char> pageable_;
+  void* data_ = nullptr;
+};
+
+// The sizes of the memcpys, with pageable and pinned host memory.
+void MemcpyArgs(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"bytes", "pinned"});
+  for (int pinned : {0, 1}) {
+    for (int64_t size = 1 << 10; size <= 1 << 28; size <<= 3) {
+      benchmark->Args({size, pinned});
+    }
+  }
+}
+
+// Launches empty kernels without waiting for them.
+void BM_KernelLaunch(benchmark::State& state) {
+  StreamExecutor* executor = GetExecutor();
+  Stream stream(executor);
+  stream.Init();
+  CHECK(stream.ok());
+  const int arg_size_bytes = state.range(0);
+  for (auto s : state) {
+    CHECK(rocm_LaunchEmptyKernel(AsGpuStreamValue(&stream), arg_size_bytes));
+  }
+  TF_CHECK_OK(stream.BlockHostUntilDone());
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_KernelLaunch)->Arg(0)->Arg(64)->Arg(256)->Arg(1024)->Arg(2048);
+
+// Launches empty kernels and waits for each of them.
+void BM_KernelLaunchAndSync(benchmark::State& state) {
+  StreamExecutor* executor = GetExecutor();
+  Stream stream(executor);
+  stream.Init();
+  CHECK(stream.ok());
+  const int arg_size_bytes = state.range(0);
+  for (auto s : state) {
+    CHECK(rocm_LaunchEmptyKernel(AsGpuStreamValue(&stream), arg_size_bytes));
+    TF_CHECK_OK(stream.BlockHostUntilDone());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_KernelLaunchAndSync)->Arg(0)->Arg(2048);
+
+void BM_MemcpyHostToDevice(benchmark::State& state) {
+  StreamExecutor* executor = GetExecutor();
+  Stream stream(executor);
+  stream.Init();
+  CHECK(stream.ok());
+  const int64_t size = state.range(0);
+  HostBuffer host(executor, size, /*pinned=*/state.range(1));
+  DeviceMemory<char> device = executor->AllocateArray<char>(size);
+  for (auto s : state) {
+    stream.ThenMemcpy(&device, host.data(), size);
+    TF_CHECK_OK(stream.BlockHostUntilDone());
+  }
+  executor->Deallocate(&device);
+  state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_MemcpyHostToDevice)->Apply(MemcpyArgs)->UseRealTime();
+
+void BM_MemcpyDeviceToHost(benchmark::State& state) {
+  StreamExecutor* executor = GetExecutor();
+  Stream stream(executor);
+  stream.Init();
+  CHECK(stream.ok());
+  const int64_t size = state.range(0);
+  HostBuffer host(executor, size, /*pinned=*/state.range(1));
+  DeviceMemory<char> device = executor->AllocateArray<char>(size);
+  for (auto s : state) {
+    stream.ThenMemcpy(host.data(), device, size);
+    TF_CHECK_OK(stream.BlockHostUntilDone());
+  }
+  executor->Deallocate(&device);
+  state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_MemcpyDeviceToHost)->Apply(MemcpyArgs)->UseRealTime();
+
+void BM_MemcpyDeviceToDevice(benchmark::State& state) {
+  StreamExecutor* executor = GetExecutor();
+  Stream stream(executor);
+  stream.Init();
+  CHECK(stream.ok());
+  const int64_t size = state.range(0);
+  DeviceMemory<char> src = executor->AllocateArray<char>(size);
+  DeviceMemory<char> dst = executor->AllocateArray<char>(size);
+  for (auto s : state) {
+    stream.ThenMemcpy(&dst, src, size);
+    TF_CHECK_OK(stream.BlockHostUntilDone());
+  }
+  executor->Deallocate(&src);
+  executor->Deallocate(&dst);
+  state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_MemcpyDeviceToDevice)
+    ->RangeMultiplier(8)
+    ->Range(1 << 10, 1 << 28)
+    ->UseRealTime();
+
+// Records an event and queries it once, without waiting for it.
+void BM_EventRecordAndQuery(benchmark::State& state) {
+  StreamExecutor* executor = GetExecutor();
+  Stream stream(executor);
+  stream.Init();
+  CHECK(stream.ok());
+  Event event(executor);
+  CHECK(event.Init());
+  for (auto s : state) {
+    stream.ThenRecordEvent(&event);
+    benchmark::DoNotOptimize(event.PollForStatus());
+  }
+  TF_CHECK_OK(stream.BlockHostUntilDone());
+}
+BENCHMARK(BM_EventRecordAndQuery);
+
+// Records an event and polls it until it completes.
+void BM_EventRecordAndSync(benchmark::State& state) {
+  StreamExecutor* executor = GetExecutor();
+  Stream stream(executor);
+  stream.Init();
+  CHECK(stream.ok());
+  Event event(executor);
+  CHECK(event.Init());
+  for (auto s : state) {
+    stream.ThenRecordEvent(&event);
+    while (event.PollForStatus() == Event::Status::kPending) {
+    }
+  }
+}
+BENCHMARK(BM_EventRecordAndSync)->UseRealTime();
+
+// Makes a stream wait for an event recorded on another stream.
+void BM_StreamWaitForEvent(benchmark::State& state) {
+  StreamExecutor* executor = GetExecutor();
+  Stream stream(executor);
+  stream.Init();
+  Stream other(executor);
+  other.Init();
+  CHECK(stream.ok() && other.ok());
+  Event event(executor);
+  CHECK(event.Init());
+  for (auto s : state) {
+    other.ThenRecordEvent(&event);
+    stream.ThenWaitFor(&event);
+    TF_CHECK_OK(stream.BlockHostUntilDone());
+  }
+}
+BENCHMARK(BM_StreamWaitForEvent)->UseRealTime();
+
+void BM_StreamCreate(benchmark::State& state) {
+  StreamExecutor* executor = GetExecutor();
+  for (auto s : state) {
+    Stream stream(executor);
+    stream.Init();
+    CHECK(stream.ok());
+  }
+}
+BENCHMARK(BM_StreamCreate);
+
+// Enqueues a host callback and waits for it to run.
+void BM_HostCallback(benchmark::State& state) {
+  StreamExecutor* executor = GetExecutor();
+  Stream stream(executor);
+  stream.Init();
+  CHECK(stream.ok());
+  for (auto s : state) {
+    absl::Notification done;
+    stream.ThenDoHostCallback([&done]() { done.Notify(); });
+    done.WaitForNotification();
+  }
+  TF_CHECK_OK(stream.BlockHostUntilDone());
+}
+BENCHMARK(BM_HostCallback)->UseRealTime();
+
+}  // namespace
+}  // namespace gpu
+}  // namespace stream_executor
+
+#endif  // TENSORFLOW_USE_ROCM
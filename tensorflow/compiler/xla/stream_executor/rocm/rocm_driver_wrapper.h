@@ -23,6 +23,7 @@ limitations under the License.
 #define __HIP_DISABLE_CPP_FUNCTIONS__
 
 #include "rocm/include/hip/hip_runtime.h"
+#include "rocm/rocm_config.h"
 #include "tensorflow/compiler/xla/stream_executor/platform/dso_loader.h"
 #include "tensorflow/compiler/xla/stream_executor/platform/port.h"
 #include "tensorflow/tsl/platform/env.h"
@@ -91,6 +92,12 @@ namespace wrap {
   __macro(hipGetDevice)                             \
   __macro(hipGetDeviceCount)                        \
   __macro(hipGetDeviceProperties)                   \
+  __macro(hipGetErrorString)                        \
+  __macro(hipGraphDestroy)                          \
+  __macro(hipGraphExecDestroy)                      \
+  __macro(hipGraphExecUpdate)                       \
+  __macro(hipGraphInstantiate)                      \
+  __macro(hipGraphLaunch)                           \
   __macro(hipHostFree)                              \
   __macro(hipHostMalloc)                            \
   __macro(hipHostRegister)                          \
@@ -123,15 +130,51 @@ namespace wrap {
   __macro(hipSetDevice)                             \
   __macro(hipDeviceGetStreamPriorityRange)          \
   __macro(hipStreamAddCallback)                     \
+  __macro(hipStreamBeginCapture)                    \
   __macro(hipStreamCreateWithFlags)                 \
   __macro(hipStreamCreateWithPriority)              \
   __macro(hipStreamDestroy)                         \
+  __macro(hipStreamEndCapture)                      \
+  __macro(hipStreamIsCapturing)                     \
   __macro(hipStreamQuery)                           \
   __macro(hipStreamSynchronize)                     \
   __macro(hipStreamWaitEvent)  // clang-format on
 
 HIP_ROUTINE_EACH(STREAM_EXECUTOR_HIP_WRAP)
 #undef HIP_ROUTINE_EACH
+
+#if TF_ROCM_VERSION >= 50300
+// Stream ordered memory allocator APIs used by GpuHipMallocAsyncAllocator.
+// clang-format off
+#define HIP_MEMPOOL_ROUTINE_EACH(__macro)           \
+  __macro(hipDeviceGetDefaultMemPool)               \
+  __macro(hipFreeAsync)                             \
+  __macro(hipMallocFromPoolAsync)                   \
+  __macro(hipMemPoolGetAttribute)                   \
+  __macro(hipMemPoolSetAccess)                      \
+  __macro(hipMemPoolSetAttribute)                   \
+  __macro(hipMemPoolTrimTo)  // clang-format on
+
+HIP_MEMPOOL_ROUTINE_EACH(STREAM_EXECUTOR_HIP_WRAP)
+#undef HIP_MEMPOOL_ROUTINE_EACH
+#endif  // TF_ROCM_VERSION >= 50300
+
+#if TF_ROCM_VERSION >= 60000
+// Virtual memory management APIs used by the GPU virtual memory allocator.
+// clang-format off
+#define HIP_VMM_ROUTINE_EACH(__macro)               \
+  __macro(hipMemAddressFree)                        \
+  __macro(hipMemAddressReserve)                     \
+  __macro(hipMemCreate)                             \
+  __macro(hipMemGetAllocationGranularity)           \
+  __macro(hipMemMap)                                \
+  __macro(hipMemRelease)                            \
+  __macro(hipMemSetAccess)                          \
+  __macro(hipMemUnmap)  // clang-format on
+
+HIP_VMM_ROUTINE_EACH(STREAM_EXECUTOR_HIP_WRAP)
+#undef HIP_VMM_ROUTINE_EACH
+#endif  // TF_ROCM_VERSION >= 60000
 #undef STREAM_EXECUTOR_HIP_WRAP
 #undef TO_STR
 #undef TO_STR_
@@ -13,9 +13,15 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <elf.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <cstring>
+#include <optional>
+
 #include "absl/base/casts.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/functional/any_invocable.h"
 #include "absl/strings/ascii.h"
 #include "absl/strings/numbers.h"
@@ -88,6 +94,24 @@ static GpuContext* GetGpuContext(Stream* stream) {
       ->gpu_context();
 }
 
+// Returns the fingerprint of the HSACO code object at `hsaco`, or std::nullopt
+// if its size is unknown. Code objects are ELF files, whose size is given by
+// the end of their section and program header tables; other formats (e.g.
+// offload bundles) are not fingerprinted.
+static std::optional<absl::uint128> HsacoFingerprint(const char* hsaco) {
+  Elf64_Ehdr header;
+  std::memcpy(&header, hsaco, sizeof(header));
+  if (std::memcmp(header.e_ident, ELFMAG, SELFMAG) != 0 ||
+      header.e_ident[EI_CLASS] != ELFCLASS64) {
+    return std::nullopt;
+  }
+  size_t size = std::max<size_t>(
+      {sizeof(header), header.e_shoff + header.e_shnum * header.e_shentsize,
+       header.e_phoff + header.e_phnum * header.e_phentsize});
+  auto fp = tsl::Fingerprint128(absl::string_view(hsaco, size));
+  return absl::MakeUint128(fp.high64, fp.low64);
+}
+
 GpuContext* ExtractGpuContext(GpuExecutor* rocm_exec) {
   CHECK(rocm_exec != nullptr);
   return rocm_exec->gpu_context();
@@ -97,8 +121,12 @@ GpuExecutor::~GpuExecutor() {
   for (auto& it : disk_modules_) {
     GpuDriver::UnloadModule(context_, it.second);
   }
+  // Binaries with identical contents share their module.
+  absl::flat_hash_set<hipModule_t> in_memory_module_set;
   for (auto& it : in_memory_modules_) {
-    GpuDriver::UnloadModule(context_, it.second);
+    if (in_memory_module_set.insert(it.second).second) {
+      GpuDriver::UnloadModule(context_, it.second);
+    }
   }
   if (context_ != nullptr) {
     GpuDriver::DestroyContext(context_);
@@ -128,14 +156,24 @@ bool GpuExecutor::UnloadGpuBinary(const void* gpu_binary) {
   auto& refcount = module_it->second.second;
   VLOG(3) << "Found HSACO module " << module << " with refcount " << refcount;
   if (--refcount == 0) {
-    VLOG(3) << "Unloading  HSACO module " << module;
-    GpuDriver::UnloadModule(context_, module);
-    gpu_binary_to_module_.erase(module_it);
-    const char* mem_it = nullptr;
-    for (auto x : in_memory_modules_) {
-      if (x.second == module) mem_it = x.first;
+    // The module may be shared with other binaries of the same contents.
+    bool is_shared = false;
+    for (auto it = hsaco_fingerprint_to_module_.begin();
+         it != hsaco_fingerprint_to_module_.end(); ++it) {
+      if (it->second.first != module) continue;
+      if (--it->second.second == 0) {
+        hsaco_fingerprint_to_module_.erase(it);
+      } else {
+        is_shared = true;
+      }
+      break;
     }
-    if (mem_it != nullptr) in_memory_modules_.erase(mem_it);
+    if (!is_shared) {
+      VLOG(3) << "Unloading  HSACO module " << module;
+      GpuDriver::UnloadModule(context_, module);
+    }
+    in_memory_modules_.erase(static_cast<const char*>(gpu_binary));
+    gpu_binary_to_module_.erase(module_it);
   }
   return true;
 }
@@ -254,11 +292,9 @@ tsl::Status GpuExecutor::GetKernel(const MultiKernelLoaderSpec& spec,
 
     const char* hsaco = spec.cuda_cubin_in_memory().bytes();
     absl::MutexLock lock{&in_memory_modules_mu_};
-    module = in_memory_modules_[hsaco];
-
-    if (module == nullptr) {
-      TF_RETURN_IF_ERROR(GpuDriver::LoadHsaco(context_, hsaco, &module));
-    }
+    // The kernels of a binary share its module, which is loaded by the first
+    // of them and unloaded with the last.
+    TF_RETURN_IF_ERROR(LoadModuleFromHsaco(hsaco, &module));
     kernel_to_gpu_binary_[kernel] = hsaco;
   } else {
     return tsl::errors::Internal("No method of loading ROCM kernel provided");
@@ -398,11 +434,25 @@ tsl::Status GpuExecutor::LoadModuleFromHsaco(const char* hsaco,
   std::tie(*module, module_refcount) = gpu_binary_to_module_[hsaco];
 
   if (*module == nullptr) {
-    TF_RETURN_IF_ERROR(GpuDriver::LoadHsaco(context_, hsaco, module));
+    std::optional<absl::uint128> fingerprint = HsacoFingerprint(hsaco);
+    auto shared_it = fingerprint.has_value()
+                         ? hsaco_fingerprint_to_module_.find(*fingerprint)
+                         : hsaco_fingerprint_to_module_.end();
+    if (shared_it != hsaco_fingerprint_to_module_.end()) {
+      *module = shared_it->second.first;
+      ++shared_it->second.second;
+      VLOG(3) << "HSACO " << static_cast<const void*>(hsaco)
+              << " has the contents of module " << *module;
+    } else {
+      TF_RETURN_IF_ERROR(GpuDriver::LoadHsaco(context_, hsaco, module));
+      if (fingerprint.has_value()) {
+        hsaco_fingerprint_to_module_[*fingerprint] = {*module, 1};
+      }
+      VLOG(3) << "Loaded HSACO " << static_cast<const void*>(hsaco)
+              << " as module " << *module;
+    }
     module_refcount = 1;
     in_memory_modules_[hsaco] = *module;
-    VLOG(3) << "Loaded HSACO " << static_cast<const void*>(hsaco)
-            << " as module " << *module;
   } else {
     ++module_refcount;
     VLOG(3) << "HSACO " << static_cast<const void*>(hsaco)
@@ -854,6 +904,55 @@ static int TryToReadNumaNode(const string& pci_bus_id, int device_ordinal) {
   return kUnknownNumaNode;
 }
 
+// Attempts to read the partition mode `attribute` (current_compute_partition or
+// current_memory_partition) of the GPU at `pci_bus_id` out of SysFS. Returns an
+// empty string if the GPU cannot be partitioned.
+static std::string TryToReadPartitionMode(const std::string& pci_bus_id,
+                                          const char* attribute) {
+  std::string filename =
+      absl::StrFormat("/sys/bus/pci/devices/%s/%s", pci_bus_id, attribute);
+  FILE* file = fopen(filename.c_str(), "r");
+  if (file == nullptr) {
+    return "";
+  }
+  char buf[32];
+  size_t did_read = fread(buf, sizeof(buf[0]), sizeof(buf) - 1, file);
+  buf[did_read] = '\0';
+  fclose(file);
+  return std::string(absl::StripAsciiWhitespace(buf));
+}
+
+// Reads the partition modes of the physical GPU that the device at
+// `pci_bus_id` belongs to. The partitions of a GPU are exposed as PCI functions
+// of the same device, and the driver only exposes the partition modes on the
+// first function, so they are looked up there when they are not found on the
+// device itself.
+static void ReadPartitionModes(const std::string& pci_bus_id,
+                               internal::DeviceDescriptionBuilder* builder) {
+  std::string physical_pci_bus_id = pci_bus_id;
+  std::string compute_mode =
+      TryToReadPartitionMode(pci_bus_id, "current_compute_partition");
+  size_t function_pos = pci_bus_id.rfind('.');
+  if (compute_mode.empty() && function_pos != std::string::npos) {
+    physical_pci_bus_id =
+        absl::StrCat(pci_bus_id.substr(0, function_pos), ".0");
+    compute_mode = TryToReadPartitionMode(physical_pci_bus_id,
+                                          "current_compute_partition");
+  }
+  if (compute_mode.empty()) {
+    builder->set_physical_pci_bus_id(pci_bus_id);
+    return;
+  }
+  std::string memory_mode =
+      TryToReadPartitionMode(physical_pci_bus_id, "current_memory_partition");
+  VLOG(1) << "GPU " << pci_bus_id << " is a partition of "
+          << physical_pci_bus_id << " in compute partition mode "
+          << compute_mode << " and memory partition mode " << memory_mode;
+  builder->set_physical_pci_bus_id(physical_pci_bus_id);
+  builder->set_compute_partition_mode(compute_mode);
+  builder->set_memory_partition_mode(memory_mode);
+}
+
 tsl::StatusOr<std::unique_ptr<DeviceDescription>>
 GpuExecutor::CreateDeviceDescription(int device_ordinal) {
   GpuDeviceHandle device;
@@ -896,6 +995,10 @@ GpuExecutor::CreateDeviceDescription(int device_ordinal) {
     // Read the NUMA node corresponding to the PCI bus ID out of sysfs.
     int numa_node = TryToReadNumaNode(pci_bus_id, device_ordinal);
     builder.set_numa_node(numa_node);
+
+    // Read the partition modes of MI300 and later GPUs, which can expose one
+    // physical GPU as several devices.
+    ReadPartitionModes(pci_bus_id, &builder);
   }
 
   hipDeviceProp_t prop;
@@ -0,0 +1,167 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/stream_executor/rocm/rocm_graph.h"
+
+#include <atomic>
+#include <string>
+
+#include "absl/strings/str_format.h"
+#include "tensorflow/compiler/xla/stream_executor/gpu/gpu_stream.h"
+#include "tensorflow/compiler/xla/stream_executor/rocm/rocm_driver_wrapper.h"
+
+namespace stream_executor {
+namespace gpu {
+
+template <typename... Args>
+static tsl::Status InternalError(const absl::FormatSpec<Args...>& format,
+                                 const Args&... args) {
+  return tsl::errors::Internal(absl::StrFormat(format, args...));
+}
+
+//===----------------------------------------------------------------------===//
+// RAII helpers for HIP graph types.
+//===----------------------------------------------------------------------===//
+
+std::atomic<size_t> RocmGraphSupport::allocated_rocm_graph_execs_;
+std::atomic<size_t> RocmGraphSupport::alive_rocm_graph_execs_;
+
+/*static*/ size_t RocmGraphSupport::NotifyGraphExecCreated() {
+  alive_rocm_graph_execs_.fetch_add(1, std::memory_order_relaxed);
+  return allocated_rocm_graph_execs_.fetch_add(1, std::memory_order_relaxed);
+}
+
+/*static*/ size_t RocmGraphSupport::allocated_rocm_graph_execs() {
+  return allocated_rocm_graph_execs_.load(std::memory_order_relaxed);
+}
+
+/*static*/ size_t RocmGraphSupport::alive_rocm_graph_execs() {
+  return alive_rocm_graph_execs_.load(std::memory_order_relaxed);
+}
+
+void RocmGraphSupport::DestroyGraph::operator()(hipGraph_t graph) {
+  hipError_t err = wrap::hipGraphDestroy(graph);
+  CHECK(err == hipSuccess)
+      << "Failed to destroy HIP graph: " << wrap::hipGetErrorString(err);
+}
+
+void RocmGraphSupport::DestroyGraphExec::operator()(hipGraphExec_t instance) {
+  hipError_t err = wrap::hipGraphExecDestroy(instance);
+  alive_rocm_graph_execs_.fetch_sub(1, std::memory_order_relaxed);
+  VLOG(5) << "Destroy HIP graph exec (remaining alive instances: "
+          << RocmGraphSupport::alive_rocm_graph_execs() << ")";
+  CHECK(err == hipSuccess) << "Failed to destroy HIP graph instance: "
+                           << wrap::hipGetErrorString(err);
+}
+
+tsl::Status OwnedHipGraphExec::Update(OwnedHipGraph graph) {
+  VLOG(3) << "Update HIP graph exec with a new graph after " << num_launches_
+          << " launches since last update "
+          << " #" << num_updates_++;
+
+  num_launches_ = 0;
+
+  hipGraphExecUpdateResult updated;
+  hipGraphNode_t error_node;
+
+  auto err = wrap::hipGraphExecUpdate(get(), graph.get(), &error_node,
+                                      &updated);
+  if (err != hipSuccess || updated != hipGraphExecUpdateSuccess)
+    return InternalError("Failed to update hip graph: %s",
+                         wrap::hipGetErrorString(err));
+
+  return tsl::OkStatus();
+}
+
+tsl::Status OwnedHipGraphExec::Launch(stream_executor::Stream* stream) {
+  VLOG(3) << "Launch HIP graph " << get()
+          << " on a stream: " << stream->DebugStreamPointers() << " #"
+          << ++num_launches_;
+
+  if (auto err = wrap::hipGraphLaunch(get(), AsGpuStreamValue(stream));
+      err != hipSuccess)
+    return InternalError("failed to run hip graph: %s",
+                         wrap::hipGetErrorString(err));
+
+  return tsl::OkStatus();
+}
+
+//===----------------------------------------------------------------------===//
+// HIP Graph Helpers.
+//===----------------------------------------------------------------------===//
+
+tsl::StatusOr<OwnedHipGraph> CaptureHipGraph(
+    stream_executor::Stream* stream, absl::AnyInvocable<tsl::Status()> capture,
+    hipStreamCaptureMode mode) {
+  VLOG(3) << "Capture HIP graph on a stream: " << stream->DebugStreamPointers();
+
+  hipGraph_t graph;
+
+  // Get the underlying HIP stream for passing to HIP APIs.
+  auto gpu_stream = AsGpuStreamValue(stream);
+
+  // Capture graph constructed by the exported graph capture function.
+  if (auto err = wrap::hipStreamBeginCapture(gpu_stream, mode);
+      err != hipSuccess)
+    return InternalError("stream begin capture failed: %s",
+                         wrap::hipGetErrorString(err));
+
+  // Call into graph capture function.
+  auto captured = capture();
+
+  // Always stop capturing the stream before checking `captured` result.
+  if (auto err = wrap::hipStreamEndCapture(gpu_stream, &graph);
+      err != hipSuccess)
+    return InternalError("stream end capture failed: %s",
+                         wrap::hipGetErrorString(err));
+
+  if (!captured.ok())
+    return InternalError("failed to capture HIP graph: %s", captured.message());
+
+  VLOG(5) << "Captured HIP graph " << graph;
+
+  return OwnedHipGraph(graph);
+}
+
+tsl::StatusOr<OwnedHipGraphExec> InstantiateHipGraph(OwnedHipGraph graph) {
+  hipGraphExec_t exec;
+
+  if (auto err = wrap::hipGraphInstantiate(&exec, &*graph, nullptr, nullptr, 0);
+      err != hipSuccess) {
+    return InternalError("graph instantiation failed: %s",
+                         wrap::hipGetErrorString(err));
+  }
+
+  size_t id = RocmGraphSupport::NotifyGraphExecCreated();
+  VLOG(5) << "Instantiated HIP graph exec instance #" << id
+          << " (alive instances: " << RocmGraphSupport::alive_rocm_graph_execs()
+          << ")";
+  return OwnedHipGraphExec(exec);
+}
+
+tsl::StatusOr<bool> IsStreamCapturing(stream_executor::Stream* stream) {
+  hipStreamCaptureStatus capture_status;
+  hipError_t err = wrap::hipStreamIsCapturing(
+      stream_executor::gpu::AsGpuStreamValue(stream), &capture_status);
+  if (err != hipSuccess) {
+    return InternalError("Failed to get stream's capture status: %s",
+                         wrap::hipGetErrorString(err));
+  }
+
+  return capture_status == hipStreamCaptureStatusActive;
+}
+
+}  // namespace gpu
+}  // namespace stream_executor
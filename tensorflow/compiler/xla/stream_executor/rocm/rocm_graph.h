@@ -0,0 +1,108 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_COMPILER_XLA_STREAM_EXECUTOR_ROCM_ROCM_GRAPH_H_
+#define TENSORFLOW_COMPILER_XLA_STREAM_EXECUTOR_ROCM_ROCM_GRAPH_H_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include "absl/functional/any_invocable.h"
+#include "rocm/include/hip/hip_runtime.h"
+#include "tensorflow/compiler/xla/stream_executor/stream.h"
+#include "tensorflow/tsl/platform/statusor.h"
+
+namespace stream_executor {
+namespace gpu {
+
+class RocmGraphSupport {
+ public:
+  // Deleters for HIP graph and graph exec instance that check the returned
+  // status and terminate if it's not `hipSuccess`.
+  struct DestroyGraph {
+    void operator()(hipGraph_t);
+  };
+  struct DestroyGraphExec {
+    void operator()(hipGraphExec_t);
+  };
+
+  static size_t NotifyGraphExecCreated();
+
+  static size_t allocated_rocm_graph_execs();
+  static size_t alive_rocm_graph_execs();
+
+ private:
+  // Global counters for the total number of allocated and alive HIP graph
+  // execs to track the resource usage at run time.
+  static std::atomic<size_t> allocated_rocm_graph_execs_;
+  static std::atomic<size_t> alive_rocm_graph_execs_;
+};
+
+//===----------------------------------------------------------------------===//
+// RAII helpers for HIP graph types.
+//===----------------------------------------------------------------------===//
+
+class OwnedHipGraph
+    : public std::unique_ptr<std::remove_pointer_t<hipGraph_t>,
+                             RocmGraphSupport::DestroyGraph> {
+  // Bring std::unique_ptr constructors in scope.
+  using std::unique_ptr<std::remove_pointer_t<hipGraph_t>,
+                        RocmGraphSupport::DestroyGraph>::unique_ptr;
+};
+
+class OwnedHipGraphExec
+    : public std::unique_ptr<std::remove_pointer_t<hipGraphExec_t>,
+                             RocmGraphSupport::DestroyGraphExec> {
+  // Bring std::unique_ptr constructors in scope.
+  using std::unique_ptr<std::remove_pointer_t<hipGraphExec_t>,
+                        RocmGraphSupport::DestroyGraphExec>::unique_ptr;
+
+ public:
+  // Updates executable graph instance with a newly captured graph. Returns an
+  // error if the new graph is not compatible (see `hipGraphExecUpdate`). Graphs
+  // that differ only in kernel argument values (i.e. buffer addresses) are
+  // always compatible, so this is the fast path for pointer changes.
+  tsl::Status Update(OwnedHipGraph graph);
+
+  // Launches captured graph on a given stream.
+  tsl::Status Launch(stream_executor::Stream* stream);
+
+ private:
+  uint64_t num_updates_ = 0;
+  uint64_t num_launches_ = 0;
+};
+
+//===----------------------------------------------------------------------===//
+// HIP Graph Helpers.
+//===----------------------------------------------------------------------===//
+
+// Captures all operations added to a `stream` by the `capture` function into
+// the hip graph instance.
+tsl::StatusOr<OwnedHipGraph> CaptureHipGraph(
+    stream_executor::Stream* stream, absl::AnyInvocable<tsl::Status()> capture,
+    hipStreamCaptureMode mode = hipStreamCaptureModeThreadLocal);
+
+// Instantiates a captured hip graph instance into a hip graph executable.
+tsl::StatusOr<OwnedHipGraphExec> InstantiateHipGraph(OwnedHipGraph graph);
+
+// Returns true if the stream is in graph capture mode
+tsl::StatusOr<bool> IsStreamCapturing(stream_executor ::Stream* stream);
+
+}  // namespace gpu
+}  // namespace stream_executor
+
+#endif  // TENSORFLOW_COMPILER_XLA_STREAM_EXECUTOR_ROCM_ROCM_GRAPH_H_
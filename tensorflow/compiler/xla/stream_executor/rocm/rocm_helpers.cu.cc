@@ -147,6 +147,57 @@ template void launchInplaceBiasActivation<hip_bfloat16>(hipStream_t stream, void
 template void launchInplaceBiasActivation<float>(hipStream_t stream, void* c_data, const void* bias_data, int activation_mode, uint64_t m, uint64_t n, int64_t ldc, float param);
 template void launchInplaceBiasActivation<double>(hipStream_t stream, void* c_data, const void* bias_data, int activation_mode, uint64_t m, uint64_t n, int64_t ldc, float param);
 
+// y = act(y + side_input), used to apply the residual add and the activation
+// of a fused batch normalization. side_input may be null.
+template <typename T, int act_mode>
+__global__ void launchInplaceSideInputActivation_kernel(T* y_data, const T* side_input_data, uint64_t n) {
+  uint64_t i = threadIdx.x + uint64_t(blockIdx.x)*blockDim.x;
+  if(i>=n)
+      return;
+  float v = float(y_data[i]);
+  if(side_input_data != nullptr)
+      v += float(side_input_data[i]);
+  if(act_mode==2)
+      v = v>0.0f ? v : 0.0f;
+  y_data[i] = (T)v;
+}
+
+template <typename T>
+void launchInplaceSideInputActivation(hipStream_t stream, void* y_data, const void* side_input_data, int activation_mode, uint64_t n) {
+  uint64_t bx = 256;
+  uint64_t gx = (n+bx-1)/bx;
+  auto kernel = launchInplaceSideInputActivation_kernel<T,0>;
+  if(activation_mode==2)
+    kernel = launchInplaceSideInputActivation_kernel<T,2>;
+
+  hipLaunchKernelGGL(kernel,
+    dim3(gx, 1, 1),
+    dim3(bx, 1, 1), 0, stream, (T*)y_data, (const T*)side_input_data, n);
+}
+
+template void launchInplaceSideInputActivation<__half>(hipStream_t stream, void* y_data, const void* side_input_data, int activation_mode, uint64_t n);
+template void launchInplaceSideInputActivation<float>(hipStream_t stream, void* y_data, const void* side_input_data, int activation_mode, uint64_t n);
+
+// dx = y > 0 ? dy : 0, the gradient of a relu given its output y.
+template <typename T>
+__global__ void launchReluBackward_kernel(const T* dy_data, const T* y_data, T* dx_data, uint64_t n) {
+  uint64_t i = threadIdx.x + uint64_t(blockIdx.x)*blockDim.x;
+  if(i>=n)
+      return;
+  dx_data[i] = float(y_data[i])>0.0f ? dy_data[i] : (T)0.0f;
+}
+
+template <typename T>
+void launchReluBackward(hipStream_t stream, const void* dy_data, const void* y_data, void* dx_data, uint64_t n) {
+  uint64_t bx = 256;
+  uint64_t gx = (n+bx-1)/bx;
+  hipLaunchKernelGGL(launchReluBackward_kernel<T>,
+    dim3(gx, 1, 1),
+    dim3(bx, 1, 1), 0, stream, (const T*)dy_data, (const T*)y_data, (T*)dx_data, n);
+}
+
+template void launchReluBackward<__half>(hipStream_t stream, const void* dy_data, const void* y_data, void* dx_data, uint64_t n);
+template void launchReluBackward<float>(hipStream_t stream, const void* dy_data, const void* y_data, void* dx_data, uint64_t n);
 
 };  // namespace gpu
 };  // namespace stream_executor
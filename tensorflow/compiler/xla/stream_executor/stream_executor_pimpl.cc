@@ -362,6 +362,14 @@ bool StreamExecutor::GetRnnAlgorithms(
   return dnn_support->GetRnnAlgorithms(out_algorithms);
 }
 
+bool StreamExecutor::GetPersistentRnnAlgorithm(dnn::AlgorithmDesc* algorithm) {
+  dnn::DnnSupport* dnn_support = AsDnn();
+  if (!dnn_support) {
+    return false;
+  }
+  return dnn_support->GetPersistentRnnAlgorithm(algorithm);
+}
+
 bool StreamExecutor::GetBlasGemmAlgorithms(
     Stream* stream, std::vector<blas::AlgorithmType>* out_algorithms) {
   blas::BlasSupport* blas_support = AsBlas();
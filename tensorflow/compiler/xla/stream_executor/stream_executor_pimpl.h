@@ -421,6 +421,9 @@ class StreamExecutor {
   // Returns the list of supported algorithms for rnn operation.
   bool GetRnnAlgorithms(std::vector<dnn::AlgorithmDesc>* out_algorithms);
 
+  // Returns the persistent algorithm for rnn operation, if there is one.
+  bool GetPersistentRnnAlgorithm(dnn::AlgorithmDesc* algorithm);
+
   // Get the list of supported algorithms for BLAS gemm.
   bool GetBlasGemmAlgorithms(Stream* stream,
                              std::vector<blas::AlgorithmType>* out_algorithms);
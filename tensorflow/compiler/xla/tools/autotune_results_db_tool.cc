@@ -0,0 +1,183 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Lists, merges into, compacts and queries a shared autotune results database
+// (see --xla_gpu_shared_autotune_results_dir).
+//
+// Usage:
+//   autotune_results_db_tool --db_dir=DIR list
+//   autotune_results_db_tool --db_dir=DIR compact
+//   autotune_results_db_tool --db_dir=DIR [environment flags] \
+//       merge FILE...
+//   autotune_results_db_tool --db_dir=DIR [environment flags] \
+//       [--hlo=SUBSTRING] lookup
+//
+// FILE is an AutotuneResults proto in text or binary format, e.g. written by
+// xla::SerializeAutotuneResults. The environment flags override the
+// environment of FILE for merge, and must be set for lookup.
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "tensorflow/compiler/xla/autotune_results.pb.h"
+#include "tensorflow/compiler/xla/service/gpu/autotune_results_db.h"
+#include "tensorflow/compiler/xla/util.h"
+#include "tensorflow/tsl/platform/env.h"
+#include "tensorflow/tsl/platform/init_main.h"
+#include "tensorflow/tsl/platform/logging.h"
+#include "tensorflow/tsl/platform/status.h"
+#include "tensorflow/tsl/util/command_line_flags.h"
+
+namespace xla {
+namespace gpu {
+namespace {
+
+// Sets the fields of `environment` that are not empty in `flags`.
+void OverrideEnvironment(const AutotuneResults::Environment& flags,
+                         AutotuneResults::Environment* environment) {
+  if (!flags.platform().empty()) {
+    environment->set_platform(flags.platform());
+  }
+  if (!flags.compute_capability().empty()) {
+    environment->set_compute_capability(flags.compute_capability());
+  }
+  if (!flags.dnn_version().empty()) {
+    environment->set_dnn_version(flags.dnn_version());
+  }
+  if (!flags.blas_version().empty()) {
+    environment->set_blas_version(flags.blas_version());
+  }
+}
+
+void PrintEntries(const char* kind,
+                  const tsl::protobuf::RepeatedPtrField<AutotuneResults::Entry>&
+                      entries,
+                  const std::string& hlo_substring) {
+  for (const AutotuneResults::Entry& entry : entries) {
+    if (!absl::StrContains(entry.hlo(), hlo_substring)) continue;
+    std::cout << kind << " " << entry.device() << "\n  " << entry.hlo()
+              << "\n  " << entry.result().ShortDebugString() << "\n";
+  }
+}
+
+Status List(const AutotuneResultsDatabase& db) {
+  TF_ASSIGN_OR_RETURN(std::vector<AutotuneResults::Environment> environments,
+                      db.ListEnvironments());
+  for (const AutotuneResults::Environment& environment : environments) {
+    TF_ASSIGN_OR_RETURN(AutotuneResults results, db.Load(environment));
+    std::cout << AutotuneEnvironmentDirectoryName(environment) << ": "
+              << results.dots_size() << " dots, " << results.convs_size()
+              << " convs\n";
+  }
+  return OkStatus();
+}
+
+Status Merge(const AutotuneResultsDatabase& db,
+             const AutotuneResults::Environment& environment_flags,
+             const std::vector<std::string>& files) {
+  for (const std::string& file : files) {
+    AutotuneResults results;
+    TF_RETURN_IF_ERROR(
+        tsl::ReadTextOrBinaryProto(tsl::Env::Default(), file, &results));
+    OverrideEnvironment(environment_flags, results.mutable_environment());
+    if (results.environment().platform().empty() ||
+        results.environment().compute_capability().empty()) {
+      return InvalidArgument(
+          "%s has no environment; set --platform and --compute_capability",
+          file);
+    }
+    TF_ASSIGN_OR_RETURN(AutotuneResults existing,
+                        db.Load(results.environment()));
+    AutotuneResults difference = AutotuneResultsDifference(results, existing);
+    std::cout << file << ": " << difference.dots_size() << " new dots, "
+              << difference.convs_size() << " new convs\n";
+    if (difference.dots_size() + difference.convs_size() > 0) {
+      TF_RETURN_IF_ERROR(db.Append(difference));
+    }
+  }
+  return OkStatus();
+}
+
+Status Lookup(const AutotuneResultsDatabase& db,
+              const AutotuneResults::Environment& environment,
+              const std::string& hlo_substring) {
+  if (environment.platform().empty() ||
+      environment.compute_capability().empty()) {
+    return InvalidArgument("lookup needs --platform and --compute_capability");
+  }
+  TF_ASSIGN_OR_RETURN(AutotuneResults results, db.Load(environment));
+  PrintEntries("dot", results.dots(), hlo_substring);
+  PrintEntries("conv", results.convs(), hlo_substring);
+  return OkStatus();
+}
+
+}  // namespace
+}  // namespace gpu
+}  // namespace xla
+
+int main(int argc, char** argv) {
+  std::string db_dir;
+  std::string platform;
+  std::string compute_capability;
+  std::string dnn_version;
+  std::string blas_version;
+  std::string hlo_substring;
+  const std::vector<tsl::Flag> flag_list = {
+      tsl::Flag("db_dir", &db_dir, "Directory of the database."),
+      tsl::Flag("platform", &platform, "Platform name, e.g. ROCM."),
+      tsl::Flag("compute_capability", &compute_capability,
+                "gfx arch name, e.g. gfx90a:sramecc+:xnack-, or CUDA compute "
+                "capability."),
+      tsl::Flag("dnn_version", &dnn_version, "MIOpen or cuDNN version."),
+      tsl::Flag("blas_version", &blas_version, "rocBLAS or cuBLAS version."),
+      tsl::Flag("hlo", &hlo_substring,
+                "Only print the entries whose HLO contains this string."),
+  };
+  std::string usage = tsl::Flags::Usage(
+      absl::StrCat(argv[0], " list|compact|merge FILE...|lookup"),
+      flag_list);
+  bool parse_ok = tsl::Flags::Parse(&argc, argv, flag_list);
+  tsl::port::InitMain(usage.c_str(), &argc, &argv);
+  if (!parse_ok || argc < 2 || db_dir.empty()) {
+    LOG(QFATAL) << usage;
+  }
+
+  xla::AutotuneResults::Environment environment;
+  environment.set_platform(platform);
+  environment.set_compute_capability(compute_capability);
+  environment.set_dnn_version(dnn_version);
+  environment.set_blas_version(blas_version);
+
+  xla::gpu::AutotuneResultsDatabase db(db_dir);
+  const std::string command = argv[1];
+  tsl::Status status;
+  if (command == "list" && argc == 2) {
+    status = xla::gpu::List(db);
+  } else if (command == "compact" && argc == 2) {
+    status = db.Compact();
+  } else if (command == "merge" && argc > 2) {
+    status = xla::gpu::Merge(db, environment,
+                             std::vector<std::string>(argv + 2, argv + argc));
+  } else if (command == "lookup" && argc == 2) {
+    status = xla::gpu::Lookup(db, environment, hlo_substring);
+  } else {
+    LOG(QFATAL) << usage;
+  }
+  TF_CHECK_OK(status);
+  return 0;
+}
@@ -15,14 +15,24 @@ limitations under the License.
 
 #include "tensorflow/compiler/xla/tools/run_hlo_module.h"
 
+#include <algorithm>
+#include <chrono>  // NOLINT(build/c++11)
+#include <cmath>
+#include <cstdint>
 #include <functional>
 #include <iostream>
+#include <map>
 #include <memory>
+#include <optional>
 #include <random>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "absl/strings/ascii.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
 #include "absl/types/span.h"
 #include "tensorflow/compiler/xla/client/lib/testing.h"
 #include "tensorflow/compiler/xla/debug_options_flags.h"
@@ -30,6 +40,7 @@ limitations under the License.
 #include "tensorflow/compiler/xla/hlo/ir/hlo_module.h"
 #include "tensorflow/compiler/xla/literal.h"
 #include "tensorflow/compiler/xla/literal_comparison.h"
+#include "tensorflow/compiler/xla/service/executable.h"
 #include "tensorflow/compiler/xla/service/hlo_runner.h"
 #include "tensorflow/compiler/xla/service/hlo_verifier.h"
 #include "tensorflow/compiler/xla/tests/test_utils.h"
@@ -42,6 +53,13 @@ limitations under the License.
 #include "tensorflow/tsl/platform/logging.h"
 #include "tensorflow/tsl/platform/path.h"
 #include "tensorflow/tsl/platform/status.h"
+#include "tensorflow/tsl/profiler/lib/profiler_session.h"
+#include "tensorflow/tsl/profiler/protobuf/xplane.pb.h"
+#include "tensorflow/tsl/profiler/utils/tf_xplane_visitor.h"
+#include "tensorflow/tsl/profiler/utils/xplane_schema.h"
+#include "tensorflow/tsl/profiler/utils/xplane_utils.h"
+#include "tensorflow/tsl/profiler/utils/xplane_visitor.h"
+#include "tensorflow/tsl/util/command_line_flags.h"
 
 namespace xla {
 namespace {
@@ -116,6 +134,108 @@ StatusOr<Literal> ExecuteWithRunner(std::unique_ptr<HloModule> module,
 
   return std::move(result_status).value();
 }
+
+// Adds the device time of each execution of each thunk in the GPU device
+// planes of `space` to `thunk_times_us`. Kernels are attributed to thunks by
+// the `hlo_op` annotation of the thunk, and consecutive kernels of the same
+// thunk on a stream count as one execution.
+void AddThunkTimes(const tensorflow::profiler::XSpace& space,
+                   std::map<std::string, std::vector<double>>* thunk_times_us) {
+  struct Kernel {
+    int64_t timestamp_ps;
+    int64_t duration_ps;
+    std::string hlo_op;
+  };
+  for (const tensorflow::profiler::XPlane* plane :
+       tsl::profiler::FindPlanesWithPrefix(space,
+                                           tsl::profiler::kGpuPlanePrefix)) {
+    tsl::profiler::XPlaneVisitor visitor =
+        tsl::profiler::CreateTfXPlaneVisitor(plane);
+    visitor.ForEachLine([&](const tsl::profiler::XLineVisitor& line) {
+      std::vector<Kernel> kernels;
+      line.ForEachEvent([&](const tsl::profiler::XEventVisitor& event) {
+        std::optional<tsl::profiler::XStatVisitor> hlo_op =
+            event.GetStat(tsl::profiler::StatType::kHloOp);
+        if (!hlo_op.has_value()) return;
+        kernels.push_back({event.TimestampPs(), event.DurationPs(),
+                           std::string(hlo_op->StrOrRefValue())});
+      });
+      std::sort(kernels.begin(), kernels.end(),
+                [](const Kernel& a, const Kernel& b) {
+                  return a.timestamp_ps < b.timestamp_ps;
+                });
+      for (size_t i = 0; i < kernels.size();) {
+        int64_t duration_ps = 0;
+        size_t j = i;
+        for (; j < kernels.size() && kernels[j].hlo_op == kernels[i].hlo_op;
+             ++j) {
+          duration_ps += kernels[j].duration_ps;
+        }
+        (*thunk_times_us)[kernels[i].hlo_op].push_back(duration_ps / 1e6);
+        i = j;
+      }
+    });
+  }
+}
+
+std::string PercentilesString(const std::vector<double>& values) {
+  return absl::StrFormat("p50 %.3f  p90 %.3f  p99 %.3f  min %.3f  max %.3f",
+                         Percentile(values, 50), Percentile(values, 90),
+                         Percentile(values, 99), Percentile(values, 0),
+                         Percentile(values, 100));
+}
+
+std::vector<double> SecondsToMillis(const std::vector<double>& seconds) {
+  std::vector<double> millis;
+  millis.reserve(seconds.size());
+  for (double s : seconds) millis.push_back(s * 1e3);
+  return millis;
+}
+
+void PrintBenchmarkResult(const HloBenchmarkResult& result, int index) {
+  std::cout << "\n=== Variant " << index << ": "
+            << (result.variant.empty() ? "(default flags)" : result.variant)
+            << "\n";
+  std::cout << absl::StrFormat("compile time: %.3f s\n", result.compile_time_s);
+  std::cout << "compute time (ms) over " << result.compute_times_s.size()
+            << " iterations: "
+            << PercentilesString(SecondsToMillis(result.compute_times_s))
+            << "\n";
+  std::cout << "wall time (ms) over " << result.wall_times_s.size()
+            << " iterations: "
+            << PercentilesString(SecondsToMillis(result.wall_times_s)) << "\n";
+  if (result.thunk_times_us.empty()) return;
+
+  // The thunks are printed by decreasing total device time.
+  std::vector<std::pair<double, const std::string*>> thunks;
+  for (const auto& [name, times] : result.thunk_times_us) {
+    double total = 0;
+    for (double t : times) total += t;
+    thunks.push_back({total, &name});
+  }
+  std::sort(thunks.begin(), thunks.end(),
+            [](const auto& a, const auto& b) { return a.first > b.first; });
+  std::cout << "thunk device times (us):\n";
+  for (const auto& [total, name] : thunks) {
+    const std::vector<double>& times = result.thunk_times_us.at(*name);
+    std::cout << absl::StrFormat("  %s: executions %d  total %.1f  ", *name,
+                                 times.size(), total)
+              << PercentilesString(times) << "\n";
+  }
+}
+
+void PrintBenchmarkSummary(const std::vector<HloBenchmarkResult>& results) {
+  if (results.size() < 2) return;
+  const double baseline = Percentile(results[0].compute_times_s, 50);
+  std::cout << "\n=== Median compute time by variant\n";
+  for (int i = 0; i < results.size(); ++i) {
+    const double median = Percentile(results[i].compute_times_s, 50);
+    std::cout << absl::StrFormat("%d: %.3f ms (%.2fx of variant 0)  %s\n", i,
+                                 median * 1e3,
+                                 baseline > 0 ? median / baseline : 0.0,
+                                 results[i].variant);
+  }
+}
 }  // namespace
 
 Status RunAndCompare(
@@ -266,4 +386,138 @@ Status RunAndCompare(
                        engine, options, iteration_literals_proto,
                        reference_module_modifier_hook, config_modifier_hook);
 }
+
+StatusOr<std::vector<std::pair<std::string, DebugOptions>>>
+ParseDebugOptionsVariants(absl::string_view variants,
+                          const DebugOptions& base) {
+  std::vector<std::pair<std::string, DebugOptions>> result;
+  for (absl::string_view variant : absl::StrSplit(variants, ';')) {
+    variant = absl::StripAsciiWhitespace(variant);
+    DebugOptions debug_options = base;
+    std::vector<tsl::Flag> flag_list;
+    MakeDebugOptionsFlags(&flag_list, &debug_options);
+    std::vector<std::string> args = {"run_hlo_module"};
+    for (absl::string_view flag :
+         absl::StrSplit(variant, absl::ByAnyChar(" \t\n"), absl::SkipEmpty())) {
+      args.emplace_back(flag);
+    }
+    // Flags::Parse terminates the remaining arguments with a null pointer.
+    std::vector<char*> argv;
+    for (std::string& arg : args) argv.push_back(arg.data());
+    argv.push_back(nullptr);
+    int argc = args.size();
+    if (!tsl::Flags::Parse(&argc, argv.data(), flag_list) || argc != 1) {
+      return InvalidArgument(
+          "Failed to parse the debug options variant \"%s\".", variant);
+    }
+    result.emplace_back(std::string(variant), std::move(debug_options));
+  }
+  return result;
+}
+
+double Percentile(std::vector<double> values, double percentile) {
+  if (values.empty()) return 0;
+  std::sort(values.begin(), values.end());
+  const int64_t rank = static_cast<int64_t>(
+      std::ceil(percentile / 100 * static_cast<double>(values.size())));
+  return values[std::clamp<int64_t>(rank - 1, 0, values.size() - 1)];
+}
+
+StatusOr<std::vector<HloBenchmarkResult>> RunBenchmark(
+    const std::string& hlo_filename, HloRunnerInterface* runner,
+    std::minstd_rand0* engine, const RunHloModuleOptions& options) {
+  if (options.benchmark_iterations <= 0) {
+    return InvalidArgument("The benchmark needs at least one iteration.");
+  }
+  TF_ASSIGN_OR_RETURN(
+      auto variants,
+      ParseDebugOptionsVariants(options.benchmark_debug_options_variants,
+                                GetDebugOptionsFromFlags()));
+
+  std::vector<HloBenchmarkResult> results;
+  // All the variants run with the arguments generated for the first one.
+  std::vector<Literal> args;
+  for (int v = 0; v < variants.size(); ++v) {
+    const DebugOptions& debug_options = variants[v].second;
+    HloBenchmarkResult result;
+    result.variant = variants[v].first;
+    TF_ASSIGN_OR_RETURN(
+        auto module,
+        LoadModuleFromFile(hlo_filename, hlo_module_loader_details::Config(),
+                           options.input_format,
+                           [&](HloModuleConfig* config) {
+                             config->set_debug_options(debug_options);
+                             config->set_seed(42);
+                           }));
+    if (options.flatten_control_flow) {
+      HloControlFlowFlattening control_flow_flattening(
+          HloControlFlowFlattening::Options{/*while_execution_count=*/1});
+      TF_RETURN_IF_ERROR(control_flow_flattening.Run(module.get()).status());
+    }
+    TF_RETURN_WITH_CONTEXT_IF_ERROR(
+        VerifyHloModule(module.get(), /*layout_sensitive=*/false,
+                        /*allow_mixed_precision=*/true),
+        absl::StrCat("(on ", runner->Name(), ")"));
+    if (v == 0) {
+      TF_ASSIGN_OR_RETURN(
+          args, MakeFakeArguments(module.get(), engine,
+                                  options.use_large_float_range,
+                                  options.treat_gte_as_data_formatting));
+    }
+
+    std::cerr << "Compiling variant " << v << " with runner " << runner->Name()
+              << "...\n";
+    auto start = std::chrono::high_resolution_clock::now();
+    TF_ASSIGN_OR_RETURN(std::unique_ptr<Executable> executable,
+                        runner->CreateExecutable(std::move(module),
+                                                 options.run_test_hlo_passes));
+    result.compile_time_s = std::chrono::duration<double>(
+                                std::chrono::high_resolution_clock::now() -
+                                start)
+                                .count();
+
+    auto execute = [&](ExecutionProfile* profile) -> Status {
+      TF_RETURN_WITH_CONTEXT_IF_ERROR(
+          runner->ExecuteWithExecutable(executable.get(), args, profile)
+              .status(),
+          absl::StrCat("Failed to execute on ", runner->Name()));
+      return OkStatus();
+    };
+    for (int i = 0; i < options.benchmark_warmup_iterations; ++i) {
+      TF_RETURN_IF_ERROR(execute(/*profile=*/nullptr));
+    }
+    for (int i = 0; i < options.benchmark_iterations; ++i) {
+      ExecutionProfile profile;
+      start = std::chrono::high_resolution_clock::now();
+      TF_RETURN_IF_ERROR(execute(&profile));
+      result.wall_times_s.push_back(
+          std::chrono::duration<double>(
+              std::chrono::high_resolution_clock::now() - start)
+              .count());
+      result.compute_times_s.push_back(
+          static_cast<double>(profile.compute_time_ns()) / 1e9);
+    }
+
+    if (options.benchmark_profile_thunks) {
+      std::unique_ptr<tsl::ProfilerSession> session =
+          tsl::ProfilerSession::Create(tsl::ProfilerSession::DefaultOptions());
+      TF_RETURN_IF_ERROR(session->Status());
+      for (int i = 0; i < options.benchmark_iterations; ++i) {
+        TF_RETURN_IF_ERROR(execute(/*profile=*/nullptr));
+      }
+      tensorflow::profiler::XSpace space;
+      TF_RETURN_IF_ERROR(session->CollectData(&space));
+      AddThunkTimes(space, &result.thunk_times_us);
+      if (result.thunk_times_us.empty()) {
+        std::cerr << "The profile of variant " << v
+                  << " has no thunk device times; the platform may not have "
+                     "a device tracer.\n";
+      }
+    }
+    PrintBenchmarkResult(result, v);
+    results.push_back(std::move(result));
+  }
+  PrintBenchmarkSummary(results);
+  return results;
+}
 }  // namespace xla
@@ -17,12 +17,16 @@ limitations under the License.
 #define TENSORFLOW_COMPILER_XLA_TOOLS_RUN_HLO_MODULE_H_
 
 #include <functional>
+#include <map>
 #include <random>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "tensorflow/compiler/xla/hlo/ir/hlo_module.h"
 #include "tensorflow/compiler/xla/service/hlo_runner.h"
 #include "tensorflow/compiler/xla/tools/run_hlo_module.pb.h"
+#include "tensorflow/compiler/xla/xla.pb.h"
 #include "tensorflow/tsl/platform/status.h"
 
 namespace xla {
@@ -49,6 +53,11 @@ struct RunHloModuleOptions {
   std::string input_literals_file;
   bool random_init_input_literals{true};
   bool force_fake_data{false};
+  // Benchmark mode, see RunBenchmark. Disabled if benchmark_iterations is 0.
+  int benchmark_iterations{0};
+  int benchmark_warmup_iterations{3};
+  std::string benchmark_debug_options_variants;
+  bool benchmark_profile_thunks{false};
 };
 
 // Runs test_module on the platform with the name
@@ -75,6 +84,46 @@ Status RunAndCompare(
     std::function<Status(const HloModule&, HloRunnerInterface*, HloModule*)>
         reference_module_modifier_hook = {},
     std::function<void(HloModuleConfig*)> config_modifier_hook = {});
+
+// The timings of one variant of the debug options in the benchmark mode.
+struct HloBenchmarkResult {
+  // The debug option flags of the variant, empty for the flags of the tool.
+  std::string variant;
+  double compile_time_s = 0;
+  // The execution time reported by the runner, per timed iteration.
+  std::vector<double> compute_times_s;
+  // The time of the ExecuteWithExecutable calls, which includes the argument
+  // and result transfers, per timed iteration.
+  std::vector<double> wall_times_s;
+  // The device time of each execution of each thunk, by HLO instruction. Only
+  // filled if options.benchmark_profile_thunks is set and the platform has a
+  // device tracer.
+  std::map<std::string, std::vector<double>> thunk_times_us;
+};
+
+// Parses a ';'-separated list of variants of the debug options, each a list of
+// DebugOptions flags, e.g.
+// "--xla_gpu_autotune_level=0;--xla_gpu_autotune_level=4". The flags of each
+// variant are applied on top of `base`, so an empty variant stands for `base`.
+StatusOr<std::vector<std::pair<std::string, DebugOptions>>>
+ParseDebugOptionsVariants(absl::string_view variants,
+                          const DebugOptions& base);
+
+// Returns the nearest-rank `percentile` (in [0, 100]) of `values`, or 0 if
+// `values` is empty.
+double Percentile(std::vector<double> values, double percentile);
+
+// For each variant of options.benchmark_debug_options_variants, compiles the
+// module in 'hlo_filename' once on `runner`, runs it
+// options.benchmark_warmup_iterations times and then
+// options.benchmark_iterations timed times, with the same fake arguments for
+// all the variants, and prints the percentiles of the timings to stdout. If
+// options.benchmark_profile_thunks is set, the timed iterations are repeated
+// under the profiler to collect the device time of each thunk, so that the
+// profiler does not perturb the end-to-end timings.
+StatusOr<std::vector<HloBenchmarkResult>> RunBenchmark(
+    const std::string& hlo_filename, HloRunnerInterface* runner,
+    std::minstd_rand0* engine, const RunHloModuleOptions& options);
 }  // namespace xla
 
 #endif  // TENSORFLOW_COMPILER_XLA_TOOLS_RUN_HLO_MODULE_H_
@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 
 #include <string>
+#include <vector>
 
 #include "tensorflow/tsl/platform/path.h"
 #include "tensorflow/tsl/platform/subprocess.h"
@@ -24,16 +25,19 @@ namespace {
 
 class RunHloModuleTest : public ::testing::Test {
  protected:
-  void RunHlo(const std::string& file_name) {
+  void RunHlo(const std::string& file_name,
+              const std::vector<std::string>& extra_args = {}) {
     std::string run_hlo_module_bin = tsl::io::JoinPath(
         tsl::testing::XlaSrcRoot(), "tools", "run_hlo_module");
 
     std::string hlo_path = tsl::io::JoinPath(tsl::testing::XlaSrcRoot(),
                                              "tools", "data", file_name);
 
+    std::vector<std::string> args = {run_hlo_module_bin, hlo_path,
+                                     "--platform=Host"};
+    args.insert(args.end(), extra_args.begin(), extra_args.end());
     tsl::SubProcess proc;
-    proc.SetProgram(run_hlo_module_bin,
-                    {run_hlo_module_bin, hlo_path, "--platform=Host"});
+    proc.SetProgram(run_hlo_module_bin, args);
     proc.SetChannelAction(tsl::CHAN_STDOUT, tsl::ACTION_PIPE);
     proc.SetChannelAction(tsl::CHAN_STDERR, tsl::ACTION_PIPE);
     EXPECT_TRUE(proc.Start());
@@ -85,5 +89,32 @@ TEST_F(RunHloModuleTest, MustAliasWithSharding) {
               testing::Not(testing::HasSubstr("memory allocation bug")));
 }
 
+TEST_F(RunHloModuleTest, Benchmark) {
+  RunHlo("add.hlo",
+         {"--benchmark_iterations=3", "--benchmark_warmup_iterations=1",
+          "--benchmark_debug_options_variants=--xla_cpu_enable_fast_math="
+          "false;"});
+
+  EXPECT_TRUE(exited_normally_);
+  EXPECT_EQ(exit_status_, 0);
+  EXPECT_THAT(stdout_output_,
+              testing::HasSubstr(
+                  "=== Variant 0: --xla_cpu_enable_fast_math=false"));
+  EXPECT_THAT(stdout_output_,
+              testing::HasSubstr("=== Variant 1: (default flags)"));
+  EXPECT_THAT(stdout_output_,
+              testing::HasSubstr("compute time (ms) over 3 iterations"));
+}
+
+TEST_F(RunHloModuleTest, BenchmarkWithInvalidVariant) {
+  RunHlo("add.hlo", {"--benchmark_iterations=1",
+                     "--benchmark_debug_options_variants=--not_a_flag"});
+
+  EXPECT_TRUE(exited_normally_);
+  EXPECT_NE(exit_status_, 0);
+  EXPECT_THAT(stderr_output_,
+              testing::HasSubstr("Failed to parse the debug options variant"));
+}
+
 }  // namespace
 }  // namespace xla
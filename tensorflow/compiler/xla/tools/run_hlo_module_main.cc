@@ -52,6 +52,15 @@ Usage:
     --input_format=[hlo|pb|pbtxt]               \
     --platform=[CPU|CUDA|Interpreter] \
     path/to/hlo_module
+
+With --benchmark_iterations=N, the module is instead compiled once and run N
+times after a warmup on the test platform only, and the percentiles of the run
+times are printed. --benchmark_debug_options_variants compares several
+variants of the debug options in one invocation, e.g. with
+
+  --benchmark_debug_options_variants="--xla_gpu_autotune_level=0;"
+
+the module is benchmarked without autotuning and with the default flags.
 )";
 const char kInterpreterPlatformName[] = "Interpreter";
 
@@ -130,6 +139,24 @@ int main(int argc, char** argv) {
       tsl::Flag("different_random_seeds", &different_random_seeds,
                 "Whether each iteration should use a different random seed for "
                 "the HloModuleConfig."),
+      tsl::Flag("benchmark_iterations", &opts.benchmark_iterations,
+                "If positive, benchmark the module on the test platform "
+                "instead of comparing it against the reference platform: "
+                "compile it once, run it this many times and print the "
+                "percentiles of the run times."),
+      tsl::Flag("benchmark_warmup_iterations",
+                &opts.benchmark_warmup_iterations,
+                "The number of untimed runs before the timed runs of the "
+                "benchmark."),
+      tsl::Flag("benchmark_debug_options_variants",
+                &opts.benchmark_debug_options_variants,
+                "A ';'-separated list of variants of the debug options to "
+                "benchmark, each a space-separated list of DebugOptions "
+                "flags applied on top of the flags of the tool. An empty "
+                "variant benchmarks the flags of the tool."),
+      tsl::Flag("benchmark_profile_thunks", &opts.benchmark_profile_thunks,
+                "Repeat the timed runs of the benchmark under the profiler and "
+                "print the percentiles of the device time of each thunk."),
   };
   xla::AppendDebugOptionsFlags(&flag_list);
   // The usage string includes the message at the top of the file, the
@@ -168,6 +195,16 @@ int main(int argc, char** argv) {
   if (opts.random_init_input_literals) {
     engine = std::make_unique<std::minstd_rand0>();
   }
+  if (opts.benchmark_iterations > 0) {
+    xla::StatusOr<std::vector<xla::HloBenchmarkResult>> results =
+        xla::RunBenchmark(hlo_filename, &test_runner, engine.get(), opts);
+    if (!results.ok()) {
+      std::cerr << results.status() << "\n";
+      return -1;
+    }
+    return 0;
+  }
+
   int failure_count = 0;
   const int iteration_count = opts.iterations;
   for (int i = 1; i <= iteration_count; ++i) {
@@ -22,6 +22,7 @@ limitations under the License.
 #include "tensorflow/core/platform/stacktrace.h"
 #include "tensorflow/core/platform/stream_executor.h"
 #include "tensorflow/core/protobuf/config.pb.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/tsl/platform/thread_annotations.h"
 
 namespace tensorflow {
@@ -33,6 +34,13 @@ namespace {
 //  - Should EventMgrs be shared between devices on a machine with multiple
 //  devices of the same type?
 static const int kNumThreads = 2;
+
+bool UseHostCallbacks() {
+  bool use_host_callbacks = false;
+  TF_CHECK_OK(ReadBoolFromEnvVar("TF_GPU_EVENT_MGR_HOST_CALLBACKS",
+                                 /*default_val=*/false, &use_host_callbacks));
+  return use_host_callbacks;
+}
 }  // namespace
 
 namespace device_event_mgr {
@@ -100,6 +108,7 @@ EventMgr::EventMgr(se::StreamExecutor* se, const GPUOptions& gpu_options)
       polling_active_delay_usecs_(gpu_options.polling_active_delay_usecs()
                                       ? gpu_options.polling_active_delay_usecs()
                                       : 10),
+      use_host_callbacks_(UseHostCallbacks()),
       threadpool_(Env::Default(), "Device_Event_Manager", kNumThreads) {
   device_event_mgr::InitThreadpoolLabels(&threadpool_);
   StartPollingLoop();
@@ -108,6 +117,11 @@ EventMgr::EventMgr(se::StreamExecutor* se, const GPUOptions& gpu_options)
 EventMgr::~EventMgr() {
   StopPollingLoop();
 
+  // Host callbacks reference this object, so wait for the streams to drain.
+  while (pending_host_callbacks_.load(std::memory_order_acquire) > 0) {
+    Env::Default()->SleepForMicroseconds(polling_active_delay_usecs_);
+  }
+
   for (auto& [stream, stream_callbacks] : callbacks_) {
     for (auto& [event, callback] : stream_callbacks) {
       threadpool_.Schedule(std::move(callback));
@@ -189,6 +203,17 @@ void EventMgr::EnqueueCallback(se::Stream* stream, std::function<void()> func) {
   }
 }
 
+void EventMgr::ThenExecuteWithHostCallback(se::Stream* stream,
+                                           std::function<void()> func) {
+  pending_host_callbacks_.fetch_add(1, std::memory_order_relaxed);
+  stream->ThenDoHostCallback([this, func = std::move(func)]() mutable {
+    // Host functions must not call into the driver, and `func` may, so it
+    // still runs on the threadpool like callbacks from the polling path.
+    threadpool_.Schedule(std::move(func));
+    pending_host_callbacks_.fetch_sub(1, std::memory_order_release);
+  });
+}
+
 // This function must be called periodically to check whether pending
 // events have recorded, and then retire them.  Initial observations
 // suggest that typical behavior in a TensorFlow program is to have
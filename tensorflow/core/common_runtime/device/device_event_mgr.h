@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_COMMON_RUNTIME_DEVICE_DEVICE_EVENT_MGR_H_
 #define TENSORFLOW_CORE_COMMON_RUNTIME_DEVICE_DEVICE_EVENT_MGR_H_
 
+#include <atomic>
 #include <deque>
 #include <functional>
 #include <memory>
@@ -67,7 +68,16 @@ class EventMgr {
   // Execute `func` when all pending stream actions have completed.  func must
   // be brief and non-blocking since it executes in the one thread used for all
   // such callbacks and also buffer deletions.
+  //
+  // With TF_GPU_EVENT_MGR_HOST_CALLBACKS=true, completion is signalled by a
+  // host function enqueued on the stream (cuLaunchHostFunc/hipLaunchHostFunc)
+  // instead of by polling an event, which removes the polling interval and
+  // mu_ from the completion path.
   void ThenExecute(se::Stream* stream, std::function<void()> func) {
+    if (use_host_callbacks_ && stream->ok()) {
+      ThenExecuteWithHostCallback(stream, std::move(func));
+      return;
+    }
     mutex_lock l(mu_);
     EnqueueCallback(stream, std::move(func));
     PollEvents(stream);
@@ -80,6 +90,9 @@ class EventMgr {
 
   se::StreamExecutor* const exec_;
   const int32 polling_active_delay_usecs_;
+  const bool use_host_callbacks_;
+  // Host callbacks enqueued on a stream that have not run yet.
+  std::atomic<int64_t> pending_host_callbacks_ = {0};
   mutex mu_;
   condition_variable events_pending_ TF_GUARDED_BY(mu_);
 
@@ -90,6 +103,10 @@ class EventMgr {
   void EnqueueCallback(se::Stream* stream, std::function<void()> func)
       TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
+  // Enqueues a host function on `stream` that hands `func` to threadpool_.
+  void ThenExecuteWithHostCallback(se::Stream* stream,
+                                   std::function<void()> func);
+
   // This function should be called at roughly the same tempo as QueueTensors()
   // to check whether pending events have recorded, and then retire them.
   //
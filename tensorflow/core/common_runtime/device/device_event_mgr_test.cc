@@ -137,6 +137,32 @@ TEST(EventMgr, WarnIfInCallback) {
   note.WaitForNotification();
   EXPECT_TRUE(hit);
 }
+
+// Tests that callbacks fire through host callbacks, without going through the
+// polling loop or the callback queue.
+TEST(EventMgr, HostCallbacks) {
+  setenv("TF_GPU_EVENT_MGR_HOST_CALLBACKS", "true", /*overwrite=*/1);
+  auto stream_exec = se::GPUMachineManager()->ExecutorForDevice(0).value();
+  TEST_EventMgr em(stream_exec, GPUOptions());
+  unsetenv("TF_GPU_EVENT_MGR_HOST_CALLBACKS");
+  TEST_EventMgrHelper th(&em);
+  std::unique_ptr<se::Stream> stream(new se::Stream(stream_exec));
+  CHECK(stream);
+  stream->Init();
+
+  constexpr int kNumCallbacks = 100;
+  std::atomic<int> num_done(0);
+  Notification note;
+  for (int i = 0; i < kNumCallbacks; ++i) {
+    em.ThenExecute(stream.get(), [&num_done, &note]() {
+      if (++num_done == kNumCallbacks) note.Notify();
+    });
+  }
+  EXPECT_EQ(0, th.queue_size());
+  EXPECT_EQ(0, th.free_size());
+  note.WaitForNotification();
+  EXPECT_EQ(kNumCallbacks, num_done);
+}
 }  // namespace
 
 // Provides access to private resources of BaseGPUDevice.
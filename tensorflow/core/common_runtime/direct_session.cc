@@ -365,6 +365,12 @@ DirectSession::DirectSession(const SessionOptions& options,
   if (!status.ok()) {
     LOG(ERROR) << status.message();
   }
+  const Status planning_status =
+      ReadBoolFromEnvVar("TF_DIRECT_SESSION_STATIC_MEMORY_PLANNING", false,
+                         &enable_static_memory_planning_);
+  if (!planning_status.ok()) {
+    LOG(ERROR) << planning_status.message();
+  }
   session_handle_ =
       strings::StrCat("direct", strings::FpToString(random::New64()));
   int devices_added = 0;
@@ -1400,6 +1406,7 @@ Status DirectSession::CreateExecutors(
     params.device = device;
     params.session_metadata = session_metadata;
     params.function_library = lib;
+    params.enable_static_memory_planning = enable_static_memory_planning_;
     auto opseg = device->op_segment();
     params.create_kernel =
         [this, lib, opseg](const std::shared_ptr<const NodeProperties>& props,
@@ -1517,7 +1524,7 @@ Status DirectSession::GetOrCreateExecutors(
 
   // See if we already have the executors for this run.
   {
-    mutex_lock l(executor_lock_);  // could use reader lock
+    tf_shared_lock l(executor_lock_);
     auto it = executors_.find(key);
     if (it != executors_.end()) {
       *executors_and_keys = it->second.get();
@@ -1550,7 +1557,7 @@ Status DirectSession::GetOrCreateExecutors(
 
   // See if we already have the executors for this run.
   {
-    mutex_lock l(executor_lock_);
+    tf_shared_lock l(executor_lock_);
     auto it = executors_.find(sorted_key);
     if (it != executors_.end()) {
       *executors_and_keys = it->second.get();
@@ -1885,6 +1892,47 @@ Status DirectSession::MakeCallable(const CallableOptions& callable_options,
   return OkStatus();
 }
 
+Status DirectSession::WarmUp(const std::vector<CallableOptions>& signatures) {
+  TF_RETURN_IF_ERROR(CheckNotClosed());
+  TF_RETURN_IF_ERROR(CheckGraphCreated("WarmUp()"));
+  if (signatures.empty()) {
+    return OkStatus();
+  }
+
+  std::vector<Status> statuses(signatures.size());
+  auto warm_up = [this, &signatures, &statuses](int i) {
+    const CallableOptions& signature = signatures[i];
+    RunStateArgs run_state_args(signature.run_options().debug_options());
+    run_state_args.collective_graph_key =
+        signature.run_options().experimental().collective_graph_key();
+    const std::vector<string> feeds(signature.feed().begin(),
+                                    signature.feed().end());
+    const std::vector<string> fetches(signature.fetch().begin(),
+                                      signature.fetch().end());
+    const std::vector<string> targets(signature.target().begin(),
+                                      signature.target().end());
+    ExecutorsAndKeys* executors_and_keys;
+    statuses[i] = GetOrCreateExecutors(feeds, fetches, targets,
+                                       &executors_and_keys, &run_state_args);
+  };
+  {
+    // The executors are created on a dedicated pool, since the inter-op pools
+    // may be too small, or the caller may run on one of them.
+    thread::ThreadPool pool(
+        options_.env, "direct_session_warm_up",
+        std::min<int>(signatures.size(), port::MaxParallelism()));
+    for (int i = 0; i < signatures.size(); ++i) {
+      pool.Schedule([&warm_up, i]() { warm_up(i); });
+    }
+  }
+
+  StatusGroup status_group;
+  for (const Status& s : statuses) {
+    status_group.Update(s);
+  }
+  return status_group.as_summary_status();
+}
+
 class DirectSession::RunCallableCallFrame : public CallFrameInterface {
  public:
   RunCallableCallFrame(DirectSession* session,
@@ -133,6 +133,13 @@ class DirectSession : public Session {
 
   ::tensorflow::Status ReleaseCallable(CallableHandle handle) override;
 
+  // Creates the executors that Run() uses for the feeds, fetches and targets
+  // of each of `signatures`, in parallel, so that the first Run() calls with
+  // these signatures do not pay for pruning, optimizing and partitioning the
+  // graph. Only the `feed`, `fetch`, `target` and `run_options` fields of the
+  // signatures are used. Returns the errors of all the signatures that failed.
+  ::tensorflow::Status WarmUp(const std::vector<CallableOptions>& signatures);
+
   ::tensorflow::Status Finalize() override;
 
   const SessionOptions& options() const { return options_; }
@@ -355,6 +362,11 @@ class DirectSession : public Session {
   // If true, blocks until device has finished all queued operations in a step.
   bool sync_on_finish_ = true;
 
+  // If true, the outputs of kernels on CPU devices are served from a static
+  // memory plan once their sizes are known. Enabled by setting
+  // TF_DIRECT_SESSION_STATIC_MEMORY_PLANNING=true.
+  bool enable_static_memory_planning_ = false;
+
   std::vector<std::unique_ptr<FunctionInfo>> functions_
       TF_GUARDED_BY(executor_lock_);
 
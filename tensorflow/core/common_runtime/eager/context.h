@@ -39,6 +39,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/eager/custom_device.h"
 #include "tensorflow/core/common_runtime/eager/custom_device_op_handler.h"
 #include "tensorflow/core/common_runtime/eager/eager_executor.h"
+#include "tensorflow/core/common_runtime/eager/eager_operation_pool.h"
 #include "tensorflow/core/common_runtime/eager/kernel_and_device.h"
 #include "tensorflow/core/common_runtime/eager/rendezvous_cache.h"
 #include "tensorflow/core/common_runtime/function.h"
@@ -732,6 +733,10 @@ class EagerContext : public ImmediateExecutionContext, public core::RefCounted {
       rendezvous_creator_;
   CustomDeviceOpHandler custom_device_op_handler_;
 
+  // Operations released by the clients, reused by CreateOperation().
+  const std::shared_ptr<EagerOperationPool> operation_pool_ =
+      std::make_shared<EagerOperationPool>(/*max_size=*/64);
+
   mutable mutex composite_devices_mu_;
   // Maps from the fingerprint of a set of device names to a virtual
   // CompositeDevice.
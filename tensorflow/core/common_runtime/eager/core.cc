@@ -150,7 +150,9 @@ ImmediateExecutionTensorHandle* EagerContext::CreateLocalHandleFromTFTensor(
 // depends on EagerContext. Thus, the context build target can't depend on
 // EagerOperation.
 ImmediateExecutionOperation* EagerContext::CreateOperation() {
-  return new EagerOperation(this);
+  ImmediateExecutionOperation* op = operation_pool_->Get();
+  if (op != nullptr) return op;
+  return new EagerOperation(this, operation_pool_);
 }
 
 // TODO(b/152902651): Once we move many execute.cc functions into
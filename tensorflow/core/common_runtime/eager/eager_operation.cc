@@ -36,6 +36,19 @@ namespace tensorflow {
 // An EagerOperation object can be reused for a different op by calling
 // Clear(), and then Reset(...) with the same arguments that would have
 // been provided to the constructor.
+void EagerOperation::Release() {
+  std::shared_ptr<EagerOperationPool> pool = pool_.lock();
+  if (pool != nullptr) {
+    Clear();
+    // Drop the state that Reset() doesn't overwrite.
+    stack_trace_.reset();
+    eager_func_params_.reset();
+    cancellation_manager_ = nullptr;
+    if (pool->Put(this)) return;
+  }
+  delete this;
+}
+
 void EagerOperation::Clear() {
   for (ImmediateExecutionTensorHandle* h : inputs_) {
     h->Unref();
@@ -321,28 +334,37 @@ Status EagerOperation::Reset(
   DCHECK(inputs_.empty());
   ClearInferenceState();
   bool is_function = false;
-  TF_RETURN_IF_ERROR(AttrTypeMapForOp(op, &attr_types_, &is_function));
-
-  // Don't update the device of direct function calls.
-  // Particularly, if the user did not explicitly request any device for this
-  // function, picking a device would result in this device being the default
-  // for nodes inside the function. This is undesirable for multi-device
-  // functions since the not-explicitly-placed nodes inside the body will all
-  // end up on this default device.
-  colocation_exempt_ = is_function;
-  if (!is_function) {
-    const auto& exempt_ops = InputColocationExemptionRegistry::Global()->Get();
-    colocation_exempt_ = exempt_ops.find(op) != exempt_ops.end();
-
-    TF_RETURN_IF_ERROR(OpDefForOp(op, &op_def_));
-  } else if (!remote && !ctx_.FindFunctionByName(op)) {
-    return errors::NotFound(
-        "'", op,
-        "' is neither a type of a primitive operation nor a name "
-        "of a function registered in binary running on ",
-        port::Hostname(),
-        ". Make sure the operation or function is "
-        "registered in the binary running in this process.");
+  if (reset_op_def_ != nullptr && attrs_.op_name() == op) {
+    // The operation is reset to the same primitive op as before, whose
+    // attribute types, op def and colocation exemption cannot have changed.
+    op_def_ = reset_op_def_;
+  } else {
+    reset_op_def_ = nullptr;
+    TF_RETURN_IF_ERROR(AttrTypeMapForOp(op, &attr_types_, &is_function));
+
+    // Don't update the device of direct function calls.
+    // Particularly, if the user did not explicitly request any device for
+    // this function, picking a device would result in this device being the
+    // default for nodes inside the function. This is undesirable for
+    // multi-device functions since the not-explicitly-placed nodes inside the
+    // body will all end up on this default device.
+    colocation_exempt_ = is_function;
+    if (!is_function) {
+      const auto& exempt_ops =
+          InputColocationExemptionRegistry::Global()->Get();
+      colocation_exempt_ = exempt_ops.find(op) != exempt_ops.end();
+
+      TF_RETURN_IF_ERROR(OpDefForOp(op, &op_def_));
+      reset_op_def_ = op_def_;
+    } else if (!remote && !ctx_.FindFunctionByName(op)) {
+      return errors::NotFound(
+          "'", op,
+          "' is neither a type of a primitive operation nor a name "
+          "of a function registered in binary running on ",
+          port::Hostname(),
+          ". Make sure the operation or function is "
+          "registered in the binary running in this process.");
+    }
   }
   attrs_.Reset(op);
   stack_trace_.reset();
@@ -15,8 +15,10 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_COMMON_RUNTIME_EAGER_EAGER_OPERATION_H_
 #define TENSORFLOW_CORE_COMMON_RUNTIME_EAGER_EAGER_OPERATION_H_
 
+#include <memory>
 #include <optional>
 #include <string>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -29,6 +31,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/eager/attr_builder.h"
 #include "tensorflow/core/common_runtime/eager/context.h"
 #include "tensorflow/core/common_runtime/eager/eager_executor.h"
+#include "tensorflow/core/common_runtime/eager/eager_operation_pool.h"
 #include "tensorflow/core/common_runtime/eager/kernel_and_device.h"
 #include "tensorflow/core/common_runtime/eager/tensor_handle.h"
 #include "tensorflow/core/framework/cancellation.h"
@@ -41,15 +44,21 @@ namespace tensorflow {
 
 class EagerOperation : public ImmediateExecutionOperation {
  public:
-  explicit EagerOperation(tensorflow::EagerContext* ctx)
-      : ImmediateExecutionOperation(kEager), ctx_(*ctx), is_function_(false) {}
+  // If `pool` is set, the operation is returned to it when released, to be
+  // reused by a later EagerContext::CreateOperation().
+  explicit EagerOperation(tensorflow::EagerContext* ctx,
+                          std::weak_ptr<EagerOperationPool> pool = {})
+      : ImmediateExecutionOperation(kEager),
+        ctx_(*ctx),
+        pool_(std::move(pool)),
+        is_function_(false) {}
   ~EagerOperation() override {
     for (ImmediateExecutionTensorHandle* h : inputs_) {
       h->Unref();
     }
   }
 
-  void Release() override { delete this; }
+  void Release() override;
 
   void Clear() override;
   Status Reset(const char* op, const char* raw_device_name) override {
@@ -174,6 +183,7 @@ class EagerOperation : public ImmediateExecutionOperation {
   // This is useful if we want the EagerOperation to point to a different
   // function.
   void UpdateName(const string& name) {
+    reset_op_def_ = nullptr;
     op_name_ = name.c_str();
     attrs_.set_op_name(name);
   }
@@ -253,6 +263,7 @@ class EagerOperation : public ImmediateExecutionOperation {
                                     const std::vector<DataType>& dtypes);
 
   tensorflow::EagerContext& ctx_;
+  const std::weak_ptr<EagerOperationPool> pool_;
   const char* op_name_ = nullptr;
   AttrBuilder attrs_;
   const AttrTypeMap* attr_types_;
@@ -291,6 +302,10 @@ class EagerOperation : public ImmediateExecutionOperation {
 
   std::optional<EagerFunctionParams> eager_func_params_;
 
+  // The op def of the primitive op given to the last successful Reset, which
+  // lets a Reset to the same op skip the registry lookups. Null for functions.
+  const tensorflow::OpDef* reset_op_def_ = nullptr;
+
   // Inference information
   const tensorflow::OpDef* op_def_;  // op definition from protobuf
   int inference_arg_idx_;  // arg definition index for the next input to be
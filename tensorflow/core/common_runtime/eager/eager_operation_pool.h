@@ -0,0 +1,77 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_EAGER_EAGER_OPERATION_POOL_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_EAGER_EAGER_OPERATION_POOL_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "tensorflow/c/eager/immediate_execution_operation.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+
+// Free list of the operations released by the clients of an EagerContext, so
+// that creating an operation reuses the memory of a previous one, including
+// the capacity of its inputs and attributes containers, instead of allocating
+// a new EagerOperation for every op executed eagerly.
+//
+// The pool is owned by the EagerContext through a shared_ptr, and every
+// operation it creates holds a weak_ptr to it: an operation released after the
+// pool is destroyed is deleted instead of being returned to the pool.
+//
+// This class is thread-safe.
+class EagerOperationPool {
+ public:
+  explicit EagerOperationPool(size_t max_size) : max_size_(max_size) {}
+
+  ~EagerOperationPool() {
+    // The pool is not reachable anymore, so the operations delete themselves
+    // when released.
+    for (ImmediateExecutionOperation* op : operations_) {
+      op->Release();
+    }
+  }
+
+  // Returns an operation previously added to the pool, or nullptr if the pool
+  // is empty. The operation must be Reset() before being used.
+  ImmediateExecutionOperation* Get() {
+    mutex_lock l(mu_);
+    if (operations_.empty()) return nullptr;
+    ImmediateExecutionOperation* op = operations_.back();
+    operations_.pop_back();
+    return op;
+  }
+
+  // Adds `op` to the pool, which takes its ownership, and returns true, unless
+  // the pool is full. `op` must not hold any input.
+  bool Put(ImmediateExecutionOperation* op) {
+    mutex_lock l(mu_);
+    if (operations_.size() >= max_size_) return false;
+    operations_.push_back(op);
+    return true;
+  }
+
+ private:
+  const size_t max_size_;
+  mutex mu_;
+  std::vector<ImmediateExecutionOperation*> operations_ TF_GUARDED_BY(mu_);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_EAGER_EAGER_OPERATION_POOL_H_
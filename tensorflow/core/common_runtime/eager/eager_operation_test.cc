@@ -79,5 +79,44 @@ TEST(EagerOperationTest, EagerFunctionParamsAndStepId) {
   ctx->Unref();
 }
 
+TEST(EagerOperationTest, ReleasedOperationsAreReused) {
+  StaticDeviceMgr device_mgr(DeviceFactory::NewDevice(
+      "CPU", {}, "/job:localhost/replica:0/task:0/device:CPU:0"));
+  auto ctx = new EagerContext(
+      SessionOptions(),
+      tensorflow::ContextDevicePlacementPolicy::DEVICE_PLACEMENT_SILENT, false,
+      &device_mgr, false, nullptr, nullptr, nullptr,
+      /*run_eager_op_as_function=*/true);
+
+  tensorflow::FunctionDef function_def;
+  CHECK(tensorflow::protobuf::TextFormat::ParseFromString(
+      "    signature {"
+      "      name: 'DummyFunction'"
+      "    }",
+      &function_def));
+  TF_ASSERT_OK(ctx->AddFunctionDef(function_def));
+
+  string device_name = "/job:localhost/replica:0/task:0/device:CPU:0";
+  auto op = down_cast<EagerOperation*>(ctx->CreateOperation());
+  TF_ASSERT_OK(op->Reset("DummyFunction", device_name.c_str()));
+  op->SetStepId(255);
+  op->Release();
+
+  // The released operation is handed out again, without its previous state.
+  auto reused_op = down_cast<EagerOperation*>(ctx->CreateOperation());
+  EXPECT_EQ(op, reused_op);
+  EXPECT_FALSE(reused_op->eager_func_params().has_value());
+  TF_ASSERT_OK(reused_op->Reset("DummyFunction", device_name.c_str()));
+  EXPECT_EQ("DummyFunction", reused_op->Name());
+
+  // Operations that are not released are not shared.
+  auto other_op = ctx->CreateOperation();
+  EXPECT_NE(reused_op, other_op);
+
+  other_op->Release();
+  reused_op->Release();
+  ctx->Unref();
+}
+
 }  // namespace
 }  // namespace tensorflow
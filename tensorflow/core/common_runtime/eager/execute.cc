@@ -31,6 +31,7 @@ limitations under the License.
 // clang-format off
 // Required for IS_MOBILE_PLATFORM
 #include "absl/container/btree_map.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/strings/str_replace.h"
 #include "tensorflow/core/common_runtime/arg_ret_placement.h"
@@ -303,14 +304,40 @@ Status GetOutputDTypes(EagerOperation* op, DataTypeVector* output_dtypes) {
   return OkStatus();
 }
 
-const KernelDef* GetKernelDef(const EagerOperation& op, const NodeDef* node_def,
+constexpr int kMaxThreadLocalKernelDefCacheSize = 1024;
+
+// Matching the attributes of an op against all the kernels registered for it
+// is a significant part of the cost of dispatching small ops, and it happens on
+// every execution. The lookups are cached per thread, keyed by the attribute
+// fingerprint of the op and by its device, so that repeated executions skip
+// the kernel registry. Registered kernels are never unregistered, so cached
+// pointers remain valid. Failed lookups are not cached, since the missing
+// kernels may be registered later by loading a library.
+const KernelDef* GetKernelDef(EagerOperation* op, const NodeDef* node_def,
                               const Device* op_device) {
   if (node_def == nullptr || op_device == nullptr) return nullptr;
+  thread_local absl::flat_hash_map<Fprint128, const KernelDef*,
+                                   Fprint128Hasher>
+      kernel_def_cache;
+  // The attribute fingerprint for the requested device is also used as the
+  // kernel cache key and is memoized by the AttrBuilder.
+  const Fprint128 cache_key = tsl::FingerprintCat128(
+      op->MutableAttrs()->CacheKey(op->DeviceName()),
+      Fingerprint128(op_device->name()));
+  if (auto it = kernel_def_cache.find(cache_key);
+      it != kernel_def_cache.end()) {
+    return it->second;
+  }
+
   const KernelDef* kernel_def = nullptr;
   Status s = FindKernelDef(DeviceType(op_device->device_type()), *node_def,
                            &kernel_def,
                            /*kernel_class_name=*/nullptr);
   if (!s.ok()) return nullptr;
+  if (kernel_def_cache.size() >= kMaxThreadLocalKernelDefCacheSize) {
+    kernel_def_cache.clear();
+  }
+  kernel_def_cache.emplace(cache_key, kernel_def);
   return kernel_def;
 }
 
@@ -1372,12 +1399,18 @@ Status GetOrCreateKernelAndDevice(
   absl::flat_hash_map<string, const std::vector<string>*> composite_devices;
   std::unordered_map<int, DtypeAndPartialTensorShape>
       input_resource_variable_dtypes_and_shapes;
+  // The kernel def is only needed to find the host memory inputs of the op,
+  // and to wrap it in a function on a kernel cache miss.
   const KernelDef* kernel_def = nullptr;
-  if (!op->is_function()) {
-    const NodeDef* node_def = &op->MutableAttrs()->BuildNodeDef();
-    kernel_def = GetKernelDef(*op, node_def, device);
-  }
+  auto get_kernel_def = [&]() -> const KernelDef* {
+    if (kernel_def == nullptr && !op->is_function()) {
+      const NodeDef* node_def = &op->MutableAttrs()->BuildNodeDef();
+      kernel_def = GetKernelDef(op, node_def, device);
+    }
+    return kernel_def;
+  };
   if (op->is_function() || ctx.RunEagerOpAsFunction()) {
+    get_kernel_def();
     TF_RETURN_IF_ERROR(ExtractFunctionInputInfo(
         op, kernel_def, input_device_ptrs, composite_devices,
         input_resource_variable_dtypes_and_shapes));
@@ -1481,7 +1514,7 @@ Status GetOrCreateKernelAndDevice(
       allow_control_flow_sync_execution = true;
       shape_inference_on_tfe_dialect_import = false;
       int_args_and_retvals_on_device =
-          IntArgsAndRetvalsOnDevice(op, kernel_def);
+          IntArgsAndRetvalsOnDevice(op, get_kernel_def());
       op = wrapped_op;
       if (int_args_and_retvals_on_device) {
         op->MutableAttrs()->Set(FunctionLibraryDefinition::kIntsOnDeviceAttr,
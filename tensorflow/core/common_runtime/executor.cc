@@ -34,6 +34,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/propagator_state.h"
 #include "tensorflow/core/common_runtime/renamed_device.h"
 #include "tensorflow/core/common_runtime/simple_propagator_state.h"
+#include "tensorflow/core/common_runtime/static_memory_planner.h"
 #include "tensorflow/core/common_runtime/step_stats_collector.h"
 #include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/cancellation.h"
@@ -57,6 +58,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/gtl/flatmap.h"
+#include "tensorflow/core/graph/algorithm.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/lib/gtl/manual_constructor.h"
 #include "tensorflow/core/lib/hash/hash.h"
@@ -78,6 +80,7 @@ limitations under the License.
 #include "tensorflow/core/profiler/lib/traceme_encode.h"
 #include "tensorflow/core/protobuf/error_codes.pb.h"
 #include "tensorflow/core/util/determinism.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/managed_stack_trace.h"
 #include "tensorflow/core/util/tensor_slice_reader_cache.h"
 
@@ -139,6 +142,18 @@ struct KernelTimer {
   }
 };
 
+// If true, ready nodes are dispatched in order of their estimated distance to
+// the end of the graph, so that nodes on the critical path start first.
+bool CriticalPathSchedulingEnabled() {
+  static const bool enabled = [] {
+    bool enabled;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_EXECUTOR_CRITICAL_PATH_SCHEDULING",
+                                   /*default_val=*/false, &enabled));
+    return enabled;
+  }();
+  return enabled;
+}
+
 // TODO(b/152925936): Re-evaluate these constants with current usage patterns.
 typedef gtl::InlinedVector<TensorValue, 4> TensorValueVec;
 typedef gtl::InlinedVector<AllocatorAttributes, 4> AllocatorAttributeVec;
@@ -150,6 +165,17 @@ class ExecutorImpl : public Executor {
   Status Initialize(const Graph& graph) {
     TF_RETURN_IF_ERROR(immutable_state_.Initialize(graph));
     kernel_stats_.Initialize(immutable_state_.graph_view());
+    if (CriticalPathSchedulingEnabled()) {
+      kernel_stats_.InitializeCriticalPaths(graph,
+                                            immutable_state_.graph_view());
+    }
+    Device* device = immutable_state_.params().device;
+    if (immutable_state_.params().enable_static_memory_planning &&
+        device->device_type() == DEVICE_CPU) {
+      memory_planner_ = std::make_unique<StaticMemoryPlanner>(
+          graph, immutable_state_.graph_view(),
+          device->GetAllocator(AllocatorAttributes()));
+    }
     return OkStatus();
   }
 
@@ -208,7 +234,81 @@ class ExecutorImpl : public Executor {
       cost_estimate.store(new_estimate, std::memory_order_relaxed);
     }
 
+    // Computes the order in which critical path lengths are accumulated, and
+    // an initial estimate of them.
+    void InitializeCriticalPaths(const Graph& graph, const GraphView& gview) {
+      std::vector<Node*> post_order;
+      // In post order every node comes after its successors, except across
+      // loop back edges, which are ignored for the estimate.
+      GetPostOrder(graph, &post_order);
+      post_order_.reserve(post_order.size());
+      for (const Node* n : post_order) {
+        if (gview.node(n->id())) post_order_.push_back(n->id());
+      }
+      critical_path_cycles_ =
+          std::make_unique<std::atomic_int_fast64_t[]>(gview.num_nodes());
+      for (int32_t i = 0; i < gview.num_nodes(); ++i) {
+        critical_path_cycles_[i] = 0;
+      }
+      UpdateCriticalPaths(gview);
+    }
+
+    bool HasCriticalPaths() const { return critical_path_cycles_ != nullptr; }
+
+    // Returns the estimated cycles from the start of `node` to the end of the
+    // graph along its most expensive path of successors.
+    int64_t CriticalPathCycles(const NodeItem& node) const {
+      return critical_path_cycles_[node.node_id].load(
+          std::memory_order_relaxed);
+    }
+
+    // Recomputes the critical path estimates from the latest cost estimates
+    // every kCriticalPathUpdateInterval calls.
+    void MaybeUpdateCriticalPaths(const GraphView& gview) {
+      if (!HasCriticalPaths()) return;
+      if (num_runs_.fetch_add(1, std::memory_order_relaxed) %
+              kCriticalPathUpdateInterval ==
+          kCriticalPathUpdateInterval - 1) {
+        UpdateCriticalPaths(gview);
+      }
+    }
+
    private:
+    // N.B. Concurrent runs may read partially updated values, which only
+    // affects the dispatch order.
+    void UpdateCriticalPaths(const GraphView& gview) {
+      for (int32_t id : post_order_) {
+        const NodeItem& item = *gview.node(id);
+        int64_t max_successor = 0;
+        for (const EdgeInfo& e : item.output_edges()) {
+          max_successor = std::max<int64_t>(
+              max_successor,
+              critical_path_cycles_[e.dst_id].load(std::memory_order_relaxed));
+        }
+        for (const ControlEdgeInfo& e : item.output_control_edges()) {
+          max_successor = std::max<int64_t>(
+              max_successor,
+              critical_path_cycles_[e.dst_id].load(std::memory_order_relaxed));
+        }
+        // Only kernels marked expensive track their cost; the others are
+        // assumed to be cheap.
+        const int64_t cost =
+            is_expensive_[id]
+                ? cost_estimates_[id].load(std::memory_order_relaxed)
+                : kInexpensiveCostCycles;
+        critical_path_cycles_[id].store(cost + max_successor,
+                                        std::memory_order_relaxed);
+      }
+    }
+
+    static constexpr uint64 kInexpensiveCostCycles = 1000;
+    static constexpr uint64 kCriticalPathUpdateInterval = 100;
+
+    // Node ids in post order, used to accumulate critical paths.
+    std::vector<int32_t> post_order_;
+    std::unique_ptr<std::atomic_int_fast64_t[]> critical_path_cycles_;
+    std::atomic<uint64> num_runs_{0};
+
     // Initial time (in CPU cycles) we expect an operation to take.  Used to
     // determine whether an operation should be place in a threadpool.
     // Operations start out "expensive".
@@ -223,6 +323,8 @@ class ExecutorImpl : public Executor {
 
   ImmutableExecutorState immutable_state_;
   KernelStats kernel_stats_;
+  // Null unless static memory planning is enabled for this executor.
+  std::unique_ptr<StaticMemoryPlanner> memory_planner_;
 
   TF_DISALLOW_COPY_AND_ASSIGN(ExecutorImpl);
 };
@@ -281,7 +383,8 @@ class ExecutorState {
  public:
   ExecutorState(const Executor::Args& args,
                 const ImmutableExecutorState& immutable_state_,
-                ExecutorImpl::KernelStats* kernel_stats_);
+                ExecutorImpl::KernelStats* kernel_stats_,
+                StaticMemoryPlanner* memory_planner);
   ~ExecutorState();
 
   void RunAsync(Executor::DoneCallback done);
@@ -386,6 +489,7 @@ class ExecutorState {
   CallFrameInterface* call_frame_;
   const ImmutableExecutorState& immutable_state_;
   ExecutorImpl::KernelStats* const kernel_stats_;
+  StaticMemoryPlanner* const memory_planner_;  // Not owned. May be null.
   CancellationManager* cancellation_manager_;
   tsl::CoordinationServiceAgent* coordination_service_agent_;
   absl::optional<ManagedStackTrace> stack_trace_ = absl::nullopt;
@@ -415,7 +519,8 @@ class ExecutorState {
 template <class PropagatorStateType>
 ExecutorState<PropagatorStateType>::ExecutorState(
     const Executor::Args& args, const ImmutableExecutorState& immutable_state,
-    ExecutorImpl::KernelStats* kernel_stats)
+    ExecutorImpl::KernelStats* kernel_stats,
+    StaticMemoryPlanner* memory_planner)
     : vlog_(VLOG_IS_ON(1)),
       log_memory_(LogMemory::IsEnabled()),
       step_id_(args.step_id),
@@ -437,6 +542,7 @@ ExecutorState<PropagatorStateType>::ExecutorState(
       call_frame_(args.call_frame),
       immutable_state_(immutable_state),
       kernel_stats_(kernel_stats),
+      memory_planner_(memory_planner),
       cancellation_manager_(args.cancellation_manager),
       coordination_service_agent_(args.coordination_service_agent),
       stack_trace_(args.stack_trace),
@@ -881,6 +987,8 @@ void ExecutorState<PropagatorStateType>::ProcessInline(
       params.output_attr_array = item.output_attrs();
       params.forward_from_array = item.forward_from();
       params.outputs_required_array = item.outputs_required.get();
+      params.planned_output_allocator_array =
+          memory_planner_ ? memory_planner_->output_allocators(item) : nullptr;
       params.inputs = inputs;
       params.input_alloc_attrs = input_alloc_attrs;
 
@@ -1120,6 +1228,10 @@ Status ExecutorState<PropagatorStateType>::ProcessOutputs(
                                           ctx->step_id(), i, to_log);
           }
         } else {
+          if (TF_PREDICT_FALSE(memory_planner_ != nullptr &&
+                               memory_planner_->recording())) {
+            memory_planner_->RecordOutput(item, i, *val.tensor);
+          }
           // NOTE that std::move is used here, so val.tensor goes to
           // uninitialized state (val.tensor->IsInitialized return false).
           out->state = Entry::State::HAS_VALUE;
@@ -1261,6 +1373,20 @@ void ExecutorState<PropagatorStateType>::ScheduleReady(
       }
     }
   } else {
+    // With critical path scheduling, ready nodes are visited from the longest
+    // to the shortest remaining path. The most critical expensive node is
+    // kept to run inline and the others are dispatched in that order, so idle
+    // workers, which steal the oldest work, pick up the most critical first.
+    const bool prioritize = kernel_stats_->HasCriticalPaths();
+    if (prioritize && ready->size() > 1) {
+      std::stable_sort(ready->begin(), ready->end(),
+                       [this](const TaggedNode& a, const TaggedNode& b) {
+                         return kernel_stats_->CriticalPathCycles(
+                                    *a.node_item) >
+                                kernel_stats_->CriticalPathCycles(
+                                    *b.node_item);
+                       });
+    }
     const TaggedNode* curr_expensive_node = nullptr;
     TaggedNodeSeq expensive_nodes;
     if (inline_ready == nullptr) {
@@ -1275,6 +1401,8 @@ void ExecutorState<PropagatorStateType>::ScheduleReady(
         if (tagged_node.get_is_dead() || !kernel_stats_->IsExpensive(item)) {
           // Inline this inexpensive node.
           inline_ready->push_back(tagged_node);
+        } else if (prioritize && curr_expensive_node != nullptr) {
+          expensive_nodes.push_back(tagged_node);
         } else {
           if (curr_expensive_node) {
             expensive_nodes.push_back(*curr_expensive_node);
@@ -1289,7 +1417,11 @@ void ExecutorState<PropagatorStateType>::ScheduleReady(
       } else {
         // There are inline nodes to run already. We dispatch this expensive
         // node to other thread.
-        expensive_nodes.push_back(*curr_expensive_node);
+        if (prioritize) {
+          expensive_nodes.insert(expensive_nodes.begin(), *curr_expensive_node);
+        } else {
+          expensive_nodes.push_back(*curr_expensive_node);
+        }
       }
     }
     if (!expensive_nodes.empty()) {
@@ -1474,16 +1606,25 @@ void ExecutorState<PropagatorStateType>::Finish() {
 }
 
 void ExecutorImpl::RunAsync(const Args& args, DoneCallback done) {
+  kernel_stats_.MaybeUpdateCriticalPaths(immutable_state_.graph_view());
+  StaticMemoryPlanner* memory_planner = memory_planner_.get();
+  if (memory_planner != nullptr && memory_planner->recording()) {
+    done = [memory_planner, done = std::move(done)](const Status& s) {
+      memory_planner->StepDone(s.ok());
+      done(s);
+    };
+  }
   if (OpOrderDeterminismRequired()) {
     (new ExecutorState<OrderedPropagatorState>(args, immutable_state_,
-                                               &kernel_stats_))
+                                               &kernel_stats_, memory_planner))
         ->RunAsync(std::move(done));
   } else if (immutable_state_.requires_control_flow_support()) {
-    (new ExecutorState<PropagatorState>(args, immutable_state_, &kernel_stats_))
+    (new ExecutorState<PropagatorState>(args, immutable_state_, &kernel_stats_,
+                                        memory_planner))
         ->RunAsync(std::move(done));
   } else {
     (new ExecutorState<SimplePropagatorState>(args, immutable_state_,
-                                              &kernel_stats_))
+                                              &kernel_stats_, memory_planner))
         ->RunAsync(std::move(done));
   }
 }
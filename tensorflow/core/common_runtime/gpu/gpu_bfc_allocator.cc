@@ -21,6 +21,7 @@ limitations under the License.
 #include <string>
 #include <utility>
 
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/tsl/framework/bfc_allocator.h"
 #include "tensorflow/tsl/platform/logging.h"
 
@@ -80,6 +81,19 @@ bool GetGarbageCollectionValue() {
       << " Using the default value \"true\".";
   return true;
 }
+
+size_t GetThreadCacheMaxChunkBytes(size_t orig_value) {
+  int64_t value;
+  Status status = ReadInt64FromEnvVar("TF_GPU_BFC_THREAD_CACHE_MAX_CHUNK_BYTES",
+                                      orig_value, &value);
+  if (!status.ok() || value < 0) {
+    LOG(ERROR) << "The TF_GPU_BFC_THREAD_CACHE_MAX_CHUNK_BYTES environment "
+               << "variable is set but could not be parsed. Using original "
+               << "config value of " << orig_value << ".";
+    return orig_value;
+  }
+  return static_cast<size_t>(value);
+}
 }  // anonymous namespace
 
 GPUBFCAllocator::GPUBFCAllocator(
@@ -95,6 +109,8 @@ GPUBFCAllocator::GPUBFCAllocator(
           o.garbage_collection = GetGarbageCollectionValue();
         }
         o.fragmentation_fraction = opts.fragmentation_fraction;
+        o.thread_cache_max_chunk_bytes =
+            GetThreadCacheMaxChunkBytes(opts.thread_cache_max_chunk_bytes);
         return o;
       }()) {}
 
@@ -46,6 +46,10 @@ class GPUBFCAllocator : public tsl::BFCAllocator {
 
     double fragmentation_fraction = 0;
     bool allow_retry_on_failure = true;
+
+    // Overridden by TF_GPU_BFC_THREAD_CACHE_MAX_CHUNK_BYTES if that envvar is
+    // set.
+    size_t thread_cache_max_chunk_bytes = 0;
   };
 
   GPUBFCAllocator(std::unique_ptr<tsl::SubAllocator> sub_allocator,
@@ -40,6 +40,7 @@ limitations under the License.
 #include "tensorflow/tsl/platform/test_benchmark.h"
 #include "tensorflow/tsl/platform/threadpool.h"
 #include "tensorflow/tsl/platform/types.h"
+#include "tensorflow/tsl/profiler/lib/scoped_memory_debug_annotation.h"
 
 namespace tsl {
 namespace {
@@ -263,6 +264,118 @@ TEST_P(GPUBFCAllocatorTest, TestCustomMemoryLimit) {
   a.DeallocateRaw(first_ptr);
 }
 
+TEST_P(GPUBFCAllocatorTest, ThreadCacheReusesSmallChunks) {
+  GPUBFCAllocator::Options options;
+  options.thread_cache_max_chunk_bytes = 4096;
+  GPUBFCAllocator a(GetParam()(1ull << 32), 1 << 30, "GPU_0_bfc", options);
+
+  void* small = a.AllocateRaw(1, 1000);
+  a.DeallocateRaw(small);
+  // Freed small chunks stay in use until reused by the same thread.
+  EXPECT_EQ(1024, a.GetStats()->bytes_in_use);
+  void* reused = a.AllocateRaw(1, 900);
+  EXPECT_EQ(small, reused);
+  EXPECT_EQ(900, a.RequestedSize(reused));
+  a.DeallocateRaw(reused);
+
+  // Requests above the threshold bypass the cache.
+  void* large = a.AllocateRaw(1, 8192);
+  a.DeallocateRaw(large);
+  EXPECT_EQ(1024, a.GetStats()->bytes_in_use);
+}
+
+TEST_P(GPUBFCAllocatorTest, ThreadCacheIsFlushedUnderMemoryPressure) {
+  GPUBFCAllocator::Options options;
+  options.thread_cache_max_chunk_bytes = 1 << 20;
+  options.thread_cache_max_bytes = 1 << 20;
+  GPUBFCAllocator a(GetParam()(1ull << 32), 1 << 20, "GPU_0_bfc", options);
+
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 4; ++i) {
+    ptrs.push_back(a.AllocateRaw(1, 256 << 10));
+    ASSERT_NE(nullptr, ptrs.back());
+  }
+  for (void* ptr : ptrs) {
+    a.DeallocateRaw(ptr);
+  }
+
+  // The whole pool is parked in the thread cache; a larger request must flush
+  // it back to the bins to succeed.
+  void* whole = a.AllocateRaw(1, 1 << 20);
+  EXPECT_NE(nullptr, whole);
+  a.DeallocateRaw(whole);
+}
+
+TEST_P(GPUBFCAllocatorTest, ThreadCacheAcrossThreads) {
+  GPUBFCAllocator::Options options;
+  options.thread_cache_max_chunk_bytes = 4096;
+  GPUBFCAllocator a(GetParam()(1ull << 32), 1 << 30, "GPU_0_bfc", options);
+
+  {
+    thread::ThreadPool pool(Env::Default(), "bfc_thread_cache", 4);
+    for (int t = 0; t < 4; ++t) {
+      pool.Schedule([&a, t] {
+        random::PhiloxRandom philox(t, 17);
+        random::SimplePhilox rand(&philox);
+        std::vector<void*> ptrs;
+        for (int i = 0; i < 1000; ++i) {
+          if (ptrs.empty() || rand.Rand32() % 2 == 0) {
+            void* ptr = a.AllocateRaw(1, 1 + rand.Rand32() % 8192);
+            CHECK_NE(nullptr, ptr);
+            ptrs.push_back(ptr);
+          } else {
+            a.DeallocateRaw(ptrs.back());
+            ptrs.pop_back();
+          }
+        }
+        for (void* ptr : ptrs) {
+          a.DeallocateRaw(ptr);
+        }
+      });
+    }
+  }
+
+  // A request for most of the memory forces the remaining cached chunks back
+  // into the bins.
+  void* large = a.AllocateRaw(1, (1 << 30) - (1 << 20));
+  EXPECT_NE(nullptr, large);
+  a.DeallocateRaw(large);
+}
+
+TEST_P(GPUBFCAllocatorTest, RecordsAllocationTrace) {
+  GPUBFCAllocator a(GetParam()(1ull << 32), 2 << 20, "GPU_0_bfc", {});
+  a.EnableAllocationTrace();
+
+  void* p1;
+  {
+    profiler::ScopedMemoryDebugAnnotation annotation("op_a", 7);
+    p1 = a.AllocateRaw(1, 1000);
+  }
+  void* p2 = a.AllocateRaw(1, 4 << 20);
+  EXPECT_EQ(nullptr, p2);
+  a.DeallocateRaw(p1);
+
+  AllocationTrace trace = a.RecordAllocationTrace();
+  EXPECT_EQ("GPU_0_bfc", trace.allocator_name());
+  EXPECT_EQ(2 << 20, trace.memory_limit());
+  ASSERT_EQ(3, trace.event_size());
+  ASSERT_EQ(1, trace.op_name_size());
+  EXPECT_EQ("op_a", trace.op_name(0));
+
+  EXPECT_EQ(1000, trace.event(0).num_bytes());
+  EXPECT_EQ(a.AllocationId(p1), trace.event(0).allocation_id());
+  EXPECT_EQ(0, trace.event(0).op_name_index());
+  EXPECT_EQ(uint64_t{7}, trace.event(0).step_id());
+
+  // Failed allocations are recorded with allocation id 0.
+  EXPECT_EQ(4 << 20, trace.event(1).num_bytes());
+  EXPECT_EQ(0, trace.event(1).allocation_id());
+  EXPECT_EQ(-1, trace.event(1).op_name_index());
+
+  EXPECT_EQ(0, trace.event(2).num_bytes());
+  EXPECT_EQ(trace.event(0).allocation_id(), trace.event(2).allocation_id());
+}
+
 TEST_P(GPUBFCAllocatorTest, AllocationsAndDeallocationsWithGrowth) {
   GPUOptions options;
   options.set_allow_growth(true);
@@ -349,11 +349,12 @@ class BaseGPUDevice::StreamGroupFactory {
 
  private:
   // Returns priority for the given virtual GPU id from the session options.
-  // Returns 0 if no virtual devices are specified.
+  // Returns the experimental stream_priority option if the virtual device
+  // doesn't have a priority.
   int GetPriority(int tf_device_id, const GPUOptions& options) {
     int id = tf_device_id;
     int i = 0;
-    int priority = 0;
+    int priority = options.experimental().stream_priority();
     while (i < options.experimental().virtual_devices_size()) {
       const int size =
           options.experimental().virtual_devices().Get(i).priority_size();
@@ -1044,6 +1045,33 @@ Status VerifyVirtualDeviceSettings(
   return OkStatus();
 }
 
+Status VerifyStreamPriority(
+    const GPUOptions& gpu_options,
+    const std::vector<tsl::PlatformDeviceId>& valid_platform_device_ids,
+    const std::map<int, std::pair<int, int>>& supported_priority_ranges) {
+  const int priority = gpu_options.experimental().stream_priority();
+  if (priority == 0) return OkStatus();
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+  for (tsl::PlatformDeviceId platform_device_id : valid_platform_device_ids) {
+    const int gpu_id = platform_device_id.value();
+    auto it = supported_priority_ranges.find(gpu_id);
+    if (it == supported_priority_ranges.end()) {
+      return errors::Internal(
+          "Failed to find supported priority range for GPU device ", gpu_id);
+    }
+    const std::pair<int, int>& priority_range = it->second;
+    if (priority > priority_range.first || priority < priority_range.second) {
+      return errors::InvalidArgument(
+          "Stream priority ", priority,
+          " is outside the range of supported priorities [",
+          priority_range.second, ",", priority_range.first, "] on GPU# ",
+          gpu_id);
+    }
+  }
+#endif
+  return OkStatus();
+}
+
 int64_t MinSystemMemory(int64_t available_memory, int cc_major) {
   // We use the following heuristic for now:
   //
@@ -1212,6 +1240,8 @@ Allocator* BaseGPUDevice::GetScopedAllocator(AllocatorAttributes attr,
 }
 
 const int BaseGPUDeviceFactory::InterconnectMap::kSameDeviceStrength = 1000;
+const int BaseGPUDeviceFactory::InterconnectMap::kSamePhysicalDeviceStrength =
+    500;
 const int BaseGPUDeviceFactory::InterconnectMap::kStreamExecutorStrength = 1;
 
 Status BaseGPUDeviceFactory::CacheDeviceIds() {
@@ -1456,6 +1486,8 @@ Status BaseGPUDeviceFactory::CreateDevices(
     }
   }
 
+  TF_RETURN_IF_ERROR(VerifyStreamPriority(
+      gpu_options, valid_platform_device_ids, supported_priority_ranges));
   const auto& virtual_devices = gpu_options.experimental().virtual_devices();
   if (!virtual_devices.empty()) {
     TF_RETURN_IF_ERROR(VerifyVirtualDeviceSettings(
@@ -1760,6 +1792,26 @@ Status BaseGPUDeviceFactory::GetDeviceLocalities(
         ilink->set_device_id(tf_gpu_dst.value());
         ilink->set_type("SAME_DEVICE");
         ilink->set_strength(InterconnectMap::kSameDeviceStrength);
+        continue;
+      }
+
+      // If this is one of multiple partitions of the same physical GPU (e.g.
+      // an MI300 in CPX mode), add links to the other partitions, which
+      // share the memory of the GPU, so that collectives keep their traffic
+      // within the GPU where they can.
+      if (!desc->is_partition()) continue;
+      auto dst_desc_status =
+          gpu_manager->DescriptionForDevice(platform_gpu_dst.value());
+      if (!dst_desc_status.ok()) {
+        return dst_desc_status.status();
+      }
+      auto dst_desc = std::move(dst_desc_status).value();
+      if (dst_desc->is_partition() &&
+          dst_desc->physical_pci_bus_id() == desc->physical_pci_bus_id()) {
+        InterconnectLink* ilink = links->add_link();
+        ilink->set_device_id(tf_gpu_dst.value());
+        ilink->set_type("SAME_PHYSICAL_DEVICE");
+        ilink->set_strength(InterconnectMap::kSamePhysicalDeviceStrength);
       }
     }
 
@@ -1768,6 +1820,8 @@ Status BaseGPUDeviceFactory::GetDeviceLocalities(
             << " TfDeviceId " << tf_device_id << " on bus "
             << dev_locality.bus_id() << " numa: " << numa_node
             << " pci: " << desc->pci_bus_id()
+            << " compute partition: " << desc->compute_partition_mode()
+            << " memory partition: " << desc->memory_partition_mode()
             << " DeviceLocality: " << dev_locality.DebugString();
   }
   return OkStatus();
@@ -1894,6 +1948,10 @@ Status BaseGPUDeviceFactory::EnablePeerAccess(
         } else {
           ++enabled_peer_count;
         }
+      } else if (platform_gpu_i != platform_gpu_j) {
+        VLOG(1) << "No peer access from device ordinal " << platform_gpu_i
+                << " to " << platform_gpu_j
+                << ", copies between them are staged by the driver.";
       }
     }
   }
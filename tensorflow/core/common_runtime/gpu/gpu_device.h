@@ -365,6 +365,7 @@ class BaseGPUDeviceFactory : public DeviceFactory {
     // faster links should have a higher value than slower links.
     int32 strength;
     static const int kSameDeviceStrength;
+    static const int kSamePhysicalDeviceStrength;
     static const int kStreamExecutorStrength;
     std::set<std::pair<tsl::PlatformDeviceId, tsl::PlatformDeviceId>>
         directed_links;
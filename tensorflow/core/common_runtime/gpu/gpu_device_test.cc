@@ -19,6 +19,7 @@ limitations under the License.
 
 #include "tensorflow/compiler/xla/stream_executor/device_id_utils.h"
 #include "tensorflow/compiler/xla/stream_executor/gpu/gpu_cudamallocasync_allocator.h"
+#include "tensorflow/compiler/xla/stream_executor/gpu/gpu_hipmallocasync_allocator.h"
 #include "tensorflow/compiler/xla/stream_executor/gpu/gpu_init.h"
 #include "tensorflow/core/common_runtime/gpu/gpu_process_state.h"
 #include "tensorflow/core/platform/env.h"
@@ -203,6 +204,44 @@ TEST_F(GPUDeviceTest, DISABLED_ON_GPU_ROCM(CudaMallocAsyncPreallocate)) {
   EXPECT_EQ(status.code(), error::OK);
 }
 
+#if TF_HIP_MALLOC_ASYNC_SUPPORTED
+TEST_F(GPUDeviceTest, HipMallocAsync) {
+  SessionOptions opts = MakeSessionOptions("0", 0, 1);
+  setenv("TF_GPU_ALLOCATOR", "hip_malloc_async", 1);
+  std::vector<std::unique_ptr<Device>> devices;
+  Status status;
+
+  int number_instantiated =
+      se::GpuHipMallocAsyncAllocator::GetInstantiatedCountTestOnly();
+  {  // The new scope is to trigger the destruction of the object.
+    status = DeviceFactory::GetFactory("GPU")->CreateDevices(
+        opts, kDeviceNamePrefix, &devices);
+    EXPECT_THAT(devices, SizeIs(1));
+    Device* device = devices[0].get();
+    auto* device_info = device->tensorflow_accelerator_device_info();
+    EXPECT_NE(device_info, nullptr);
+
+    AllocatorAttributes allocator_attributes = AllocatorAttributes();
+    allocator_attributes.set_gpu_compatible(true);
+    Allocator* allocator = devices[0]->GetAllocator(allocator_attributes);
+    void* ptr = allocator->AllocateRaw(Allocator::kAllocatorAlignment, 1024);
+    EXPECT_NE(ptr, nullptr);
+
+    std::optional<AllocatorStats> stats = allocator->GetStats();
+    ASSERT_TRUE(stats.has_value());
+    EXPECT_EQ(stats->bytes_in_use, 1024);
+    EXPECT_TRUE(stats->pool_bytes.has_value());
+    allocator->DeallocateRaw(ptr);
+  }
+
+  unsetenv("TF_GPU_ALLOCATOR");
+
+  EXPECT_EQ(number_instantiated + 1,
+            se::GpuHipMallocAsyncAllocator::GetInstantiatedCountTestOnly());
+  EXPECT_EQ(status.code(), error::OK);
+}
+#endif  // TF_HIP_MALLOC_ASYNC_SUPPORTED
+
 TEST_F(GPUDeviceTest, FailedToParseVisibleDeviceList) {
   SessionOptions opts = MakeSessionOptions("0,abc");
   std::vector<std::unique_ptr<Device>> devices;
@@ -377,6 +416,30 @@ TEST_F(GPUDeviceTest, SingleVirtualDeviceWithMemoryLimitAndPriority) {
   EXPECT_EQ(static_cast<BaseGPUDevice*>(devices[0].get())->priority(), 0);
 }
 
+TEST_F(GPUDeviceTest, StreamPriority) {
+  // -1 is a valid priority value for both AMD and NVidia GPUs
+  SessionOptions opts = MakeSessionOptions("0");
+  opts.config.mutable_gpu_options()->mutable_experimental()
+      ->set_stream_priority(-1);
+  std::vector<std::unique_ptr<Device>> devices;
+  TF_CHECK_OK(DeviceFactory::GetFactory("GPU")->CreateDevices(
+      opts, kDeviceNamePrefix, &devices));
+  EXPECT_THAT(devices, SizeIs(1));
+  EXPECT_EQ(-1, static_cast<BaseGPUDevice*>(devices[0].get())->priority());
+}
+
+TEST_F(GPUDeviceTest, StreamPriorityOutOfRange) {
+  SessionOptions opts = MakeSessionOptions("0");
+  opts.config.mutable_gpu_options()->mutable_experimental()
+      ->set_stream_priority(2);
+  std::vector<std::unique_ptr<Device>> devices;
+  Status status = DeviceFactory::GetFactory("GPU")->CreateDevices(
+      opts, kDeviceNamePrefix, &devices);
+  EXPECT_EQ(status.code(), error::INVALID_ARGUMENT);
+  ExpectErrorMessageSubstr(
+      status, "Stream priority 2 is outside the range of supported priorities");
+}
+
 TEST_F(GPUDeviceTest, MultipleVirtualDevices) {
   // Valid range for priority values on AMD GPUs in (-1,1)
   // Valid range for priority values on NVidia GPUs in (-2, 0)
@@ -556,6 +619,36 @@ TEST_F(GPUDeviceTest, CopyTensorInSameDevice) {
   }
 }
 
+TEST_F(GPUDeviceTest, CopyLargePageableTensor) {
+  SessionOptions opts = MakeSessionOptions("0");
+  std::vector<std::unique_ptr<Device>> devices;
+  TF_ASSERT_OK(DeviceFactory::GetFactory("GPU")->CreateDevices(
+      opts, kDeviceNamePrefix, &devices));
+  Device* device = devices[0].get();
+  auto* device_info = device->tensorflow_accelerator_device_info();
+  CHECK(device_info);
+  DeviceContext* device_context = device_info->default_context;
+  Allocator* allocator = device->GetAllocator(AllocatorAttributes());
+
+  // Large enough to be staged in several chunks, with a partial last chunk.
+  constexpr int kNumElements = (10 << 20) / sizeof(float) + 3;
+  Tensor cpu_tensor(cpu_allocator(), DT_FLOAT, TensorShape({kNumElements}));
+  auto input = cpu_tensor.tensor<float, 1>();
+  for (int i = 0; i < kNumElements; ++i) {
+    input(i) = i;
+  }
+  Tensor gpu_tensor(allocator, DT_FLOAT, TensorShape({kNumElements}));
+  CopyCPUToGPU(&cpu_tensor, &gpu_tensor, device, device_context);
+
+  Tensor output_cpu_tensor(cpu_allocator(), DT_FLOAT,
+                           TensorShape({kNumElements}));
+  CopyGPUToCPU(&gpu_tensor, &output_cpu_tensor, device, device_context);
+  auto output = output_cpu_tensor.tensor<float, 1>();
+  for (int i = 0; i < kNumElements; ++i) {
+    ASSERT_EQ(input(i), output(i)) << " for index " << i;
+  }
+}
+
 TEST_F(GPUDeviceTest, DeviceDetails) {
   DeviceFactory* factory = DeviceFactory::GetFactory("GPU");
   std::vector<string> devices;
@@ -23,6 +23,7 @@ limitations under the License.
 #include "tensorflow/compiler/xla/stream_executor/device_id_utils.h"
 #include "tensorflow/compiler/xla/stream_executor/device_mem_allocator.h"
 #include "tensorflow/compiler/xla/stream_executor/gpu/gpu_cudamallocasync_allocator.h"
+#include "tensorflow/compiler/xla/stream_executor/gpu/gpu_hipmallocasync_allocator.h"
 #include "tensorflow/compiler/xla/stream_executor/gpu/gpu_init.h"
 #include "tensorflow/compiler/xla/stream_executor/stream_executor.h"
 #include "tensorflow/core/common_runtime/device/device_host_allocator.h"
@@ -76,6 +77,34 @@ static bool UseCudaMallocAsyncAllocator() {
 #endif
 }
 
+// NOLINTNEXTLINE(clang-diagnostic-unused-function)
+static bool UseHipMallocAsyncAllocator() {
+  const char* allocator_env = std::getenv("TF_GPU_ALLOCATOR");
+  auto result = allocator_env != nullptr &&
+                std::strcmp(allocator_env, "hip_malloc_async") == 0;
+#if TF_HIP_MALLOC_ASYNC_SUPPORTED
+  return result;
+#else
+  if (result)
+    LOG(ERROR) << "TF_GPU_ALLOCATOR=hip_malloc_async environment found, "
+               << "but TensorFlow was not compiled with ROCm 5.3+.";
+  return false;
+#endif
+}
+
+// NOLINTNEXTLINE(clang-diagnostic-unused-function)
+static bool UseVirtualMemAllocator() {
+#if TENSORFLOW_USE_ROCM
+  bool use_virtual_mem_allocator = false;
+  TF_CHECK_OK(tsl::ReadBoolFromEnvVar("TF_GPU_VIRTUAL_MEM_ALLOCATOR",
+                                      /*default_val=*/false,
+                                      &use_virtual_mem_allocator));
+  return use_virtual_mem_allocator;
+#else
+  return true;
+#endif
+}
+
 /*static*/ GPUProcessState* GPUProcessState::singleton(GPUProcessState* ps) {
   static GPUProcessState* instance = ps ? ps : new GPUProcessState;
   DCHECK((!ps) || (ps == instance))
@@ -109,16 +138,15 @@ static std::unique_ptr<SubAllocator> CreateSubAllocator(
                       .value();
 
   // FIXME(imintz): Observed OOM issues when using the virtual memory
-  // allocators. This should be reenabled when resolved.
-#if 0 && defined(GOOGLE_CUDA) && CUDA_VERSION >= 10020
-  // Use the old allocator when unified memory is required.
+  // allocators on CUDA. This should be reenabled when resolved. On ROCm the
+  // virtual memory allocator is opt-in via TF_GPU_VIRTUAL_MEM_ALLOCATOR.
+#if (0 && defined(GOOGLE_CUDA) && CUDA_VERSION >= 10020) || \
+    TF_ROCM_VERSION >= 60000
+  // The old allocator is used below when unified memory is required.
   // TODO(imintz): Remove the cuMemAlloc capability of this allocator.
-  if (options.per_process_gpu_memory_fraction() > 1.0 ||
-      options.experimental().use_unified_memory()) {
-    return new se::DeviceMemAllocator(executor, platform_device_id,
-                                  /*use_unified_memory=*/true, alloc_visitors,
-                                  {});
-  } else {
+  if (UseVirtualMemAllocator() &&
+      options.per_process_gpu_memory_fraction() <= 1.0 &&
+      !options.experimental().use_unified_memory()) {
     auto* gpu_context = reinterpret_cast<stream_executor::gpu::GpuContext*>(
         executor->implementation()->GpuContextHack());
 
@@ -137,20 +165,27 @@ static std::unique_ptr<SubAllocator> CreateSubAllocator(
     // collection.
     // TODO(imintz): Update BFC allocator to ensure it doesn't create holes in
     // the va space.
-    return GpuVirtualMemAllocator::Create(
-               alloc_visitors, {}, *gpu_context, platform_device_id,
-               /*virtual_address_space_size=*/total_bytes * 2,
-               platform_peer_gpu_ids_vec)
-        .value()
-        .release();
+    auto virtual_mem_allocator = GpuVirtualMemAllocator::Create(
+        alloc_visitors, {}, *gpu_context, platform_device_id,
+        /*virtual_address_space_size=*/total_bytes * 2,
+        platform_peer_gpu_ids_vec);
+    if (virtual_mem_allocator.ok()) {
+      // A single growable reservation lets the BFC allocator coalesce all of
+      // its regions instead of fragmenting across disjoint allocations.
+      LOG(INFO) << "Using GPU virtual memory sub-allocator for GPU: "
+                << platform_device_id;
+      return std::move(virtual_mem_allocator).value();
+    }
+    LOG(WARNING) << "Failed to create GPU virtual memory allocator, falling "
+                 << "back to device memory allocator: "
+                 << virtual_mem_allocator.status();
   }
-#else
+#endif
   return absl::WrapUnique(new se::DeviceMemAllocator(
       executor, platform_device_id,
       (options.per_process_gpu_memory_fraction() > 1.0 ||
        options.experimental().use_unified_memory()),
       alloc_visitors, {}));
-#endif
 }
 
 Allocator* GPUProcessState::GetGPUAllocator(
@@ -222,6 +257,15 @@ Allocator* GPUProcessState::GetGPUAllocator(
       // **WARNING** probably will not work in a multi-gpu scenario
       gpu_bfc_allocator.reset();
       gpu_allocator = new GPUcudaMallocAllocator(platform_device_id);
+    } else if (UseHipMallocAsyncAllocator()) {
+      LOG(INFO) << "Using HIP malloc Async allocator for GPU: "
+                << platform_device_id;
+      // Passes all allocation requests through to hipMallocFromPoolAsync so
+      // that the pooled memory is owned by the HIP driver and can be shared
+      // with other processes on the same GPU.
+      gpu_bfc_allocator.reset();
+      gpu_allocator =
+          new se::GpuHipMallocAsyncAllocator(platform_device_id, total_bytes);
     } else if (UseCudaMallocAsyncAllocator() ||
                options.experimental().use_cuda_malloc_async()) {
       LOG(INFO) << "Using CUDA malloc Async allocator for GPU: "
@@ -312,12 +356,12 @@ Allocator* GPUProcessState::GetGpuHostAllocator(const GPUOptions& options,
     tf_shared_lock lock(mu_);
 
     if (process_state_->ProcessState::FLAGS_brain_gpu_record_mem_types &&
-        !gpu_host_allocators_.empty() &&
-        gpu_host_allocators_[0].recording_allocator != nullptr) {
-      return gpu_host_allocators_[0].recording_allocator.get();
+        static_cast<int>(gpu_host_allocators_.size()) > numa_node &&
+        gpu_host_allocators_[numa_node].recording_allocator != nullptr) {
+      return gpu_host_allocators_[numa_node].recording_allocator.get();
     }
     if (static_cast<int>(gpu_host_allocators_.size()) > numa_node) {
-      return gpu_host_allocators_[0].allocator.get();
+      return gpu_host_allocators_[numa_node].allocator.get();
     }
   }
 
@@ -355,15 +399,18 @@ Allocator* GPUProcessState::GetGpuHostAllocator(const GPUOptions& options,
   }
 
   while (static_cast<int>(gpu_host_allocators_.size()) <= numa_node) {
-    while (gpu_host_alloc_visitors_.size() <= numa_node) {
+    // Allocators are created for every node up to `numa_node`, each placing
+    // its memory on its own node.
+    const int node = gpu_host_allocators_.size();
+    while (gpu_host_alloc_visitors_.size() <= node) {
       gpu_host_alloc_visitors_.push_back({});
     }
-    while (gpu_host_free_visitors_.size() <= numa_node) {
+    while (gpu_host_free_visitors_.size() <= node) {
       gpu_host_free_visitors_.push_back({});
     }
-    SubAllocator* sub_allocator = new DeviceHostAllocator(
-        se, numa_node, gpu_host_alloc_visitors_[numa_node],
-        gpu_host_free_visitors_[numa_node]);
+    SubAllocator* sub_allocator =
+        new DeviceHostAllocator(se, node, gpu_host_alloc_visitors_[node],
+                                gpu_host_free_visitors_[node]);
 
     tsl::BFCAllocator::Options allocator_opts;
     allocator_opts.allow_growth =
@@ -395,9 +442,9 @@ Allocator* GPUProcessState::GetGpuHostAllocator(const GPUOptions& options,
     }
   }
   if (process_state_->ProcessState::FLAGS_brain_gpu_record_mem_types) {
-    return gpu_host_allocators_[0].recording_allocator.get();
+    return gpu_host_allocators_[numa_node].recording_allocator.get();
   } else {
-    return gpu_host_allocators_[0].allocator.get();
+    return gpu_host_allocators_[numa_node].allocator.get();
   }
 }
 
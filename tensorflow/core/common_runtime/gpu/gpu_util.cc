@@ -17,6 +17,7 @@ limitations under the License.
 
 #include <algorithm>
 #include <cstring>
+#include <limits>
 
 #include "tensorflow/core/common_runtime/copy_tensor.h"
 #include "tensorflow/core/common_runtime/device.h"
@@ -38,6 +39,7 @@ limitations under the License.
 #include "tensorflow/core/platform/stream_executor.h"
 #include "tensorflow/core/platform/tensor_coding.h"
 #include "tensorflow/core/profiler/lib/scoped_annotation.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/util.h"
 
 // IMPLEMENTATION NOTE:
@@ -202,9 +204,14 @@ void GPUUtil::DeviceToDeviceCopy(
     done(s);
     return;
   }
+  // Spreads the copies to different destinations over the copy streams, so
+  // that copies to different peers run over their links concurrently instead
+  // of queueing on the same stream. The copies to the same destination with
+  // the same index still run in order on the same stream.
   auto send_device_to_device_stream =
       static_cast<const GPUDeviceContext*>(send_dev_context)
-          ->device_to_device_stream(dev_to_dev_stream_index);
+          ->device_to_device_stream(dev_to_dev_stream_index +
+                                    dst->parsed_name().id);
   if (send_device_to_device_stream == nullptr) {
     done(errors::Internal("No send gpu copy-out-stream is available."));
     return;
@@ -265,6 +272,19 @@ bool NeedStaging(const Tensor* tensor) {
   return tensor->GetMemoryType() == AllocatorMemoryType::kHostPageable;
 }
 
+// Staged CPU->GPU copies are split into chunks of this many bytes, so that the
+// DMA of one chunk overlaps with the host memcpy into the staging buffer of
+// the next one.
+int64_t StagingChunkBytes() {
+  static const int64_t chunk_bytes = [] {
+    int64_t value;
+    TF_CHECK_OK(ReadInt64FromEnvVar("TF_GPU_STAGING_CHUNK_BYTES",
+                                    /*default_val=*/4 << 20, &value));
+    return value > 0 ? value : std::numeric_limits<int64_t>::max();
+  }();
+  return chunk_bytes;
+}
+
 }  // namespace
 
 // static
@@ -367,11 +387,28 @@ void GPUUtil::CopyCPUTensorToGPU(const Tensor* cpu_tensor,
     if (do_staging) {
       staging_buffer = host_memory_allocator->AllocateRaw(
           tensorflow::Allocator::kAllocatorAlignment, total_bytes);
-      std::memcpy(staging_buffer, src_ptr, total_bytes);
-      input_ref.Unref();
+      if (staging_buffer == nullptr) {
+        LOG_FIRST_N(WARNING, 1)
+            << "Could not allocate " << total_bytes
+            << " bytes of host memory to stage data for CPU->GPU transfer. "
+               "Staging will be skipped.";
+        do_staging = false;
+      }
+    }
 
-      recv_host_to_device_stream->ThenMemcpy(&gpu_dst_ptr, staging_buffer,
-                                             total_bytes);
+    if (do_staging) {
+      const int64_t chunk_bytes = StagingChunkBytes();
+      for (int64_t offset = 0; offset < total_bytes; offset += chunk_bytes) {
+        const int64_t bytes = std::min(chunk_bytes, total_bytes - offset);
+        char* staging_chunk = static_cast<char*>(staging_buffer) + offset;
+        std::memcpy(staging_chunk, static_cast<const char*>(src_ptr) + offset,
+                    bytes);
+        DeviceMemoryBase gpu_dst_chunk(static_cast<char*>(dst_ptr) + offset,
+                                       bytes);
+        recv_host_to_device_stream->ThenMemcpy(&gpu_dst_chunk, staging_chunk,
+                                               bytes);
+      }
+      input_ref.Unref();
     } else {
       recv_host_to_device_stream->ThenMemcpy(&gpu_dst_ptr, src_ptr,
                                              total_bytes);
@@ -20,7 +20,7 @@ limitations under the License.
 #include "tensorflow/tsl/platform/numbers.h"
 #include "tensorflow/tsl/profiler/lib/traceme.h"
 
-#if CUDA_VERSION >= 10020
+#if CUDA_VERSION >= 10020 || TF_ROCM_VERSION >= 60000
 
 namespace tensorflow {
 namespace {
@@ -39,9 +39,34 @@ size_t AlignUp(size_t value, size_t alignment) {
   return (value + alignment - 1) & ~(alignment - 1);
 }
 
+// Returns the device address `offset` bytes past `base`. CUDA device pointers
+// are integers while HIP device pointers are `void*`, so the arithmetic is done
+// on the integral representation.
+GpuDevicePtr OffsetDevicePtr(GpuDevicePtr base, size_t offset) {
+#if TENSORFLOW_USE_ROCM
+  return static_cast<char*>(base) + offset;
+#else
+  return base + offset;
+#endif
+}
+
+// Returns the number of bytes between `base` and `ptr`.
+size_t DevicePtrDistance(GpuDevicePtr base, GpuDevicePtr ptr) {
+#if TENSORFLOW_USE_ROCM
+  return static_cast<char*>(ptr) - static_cast<char*>(base);
+#else
+  return ptr - base;
+#endif
+}
+
 StatusOr<bool> SupportsVirtualAddressManagement(GpuDeviceHandle device) {
+#if TENSORFLOW_USE_ROCM
+  return GpuDriver::GetDeviceAttribute(
+      hipDeviceAttributeVirtualMemoryManagementSupported, device);
+#else
   return GpuDriver::GetDeviceAttribute(
       CU_DEVICE_ATTRIBUTE_VIRTUAL_ADDRESS_MANAGEMENT_SUPPORTED, device);
+#endif
 }
 
 Status CheckVirtualAddressManagementSupport(GpuDeviceHandle device,
@@ -138,12 +163,12 @@ void* GpuVirtualMemAllocator::Alloc(size_t alignment, size_t num_bytes,
   if (num_bytes == 0) return nullptr;
   size_t padded_bytes = (num_bytes + granularity_ - 1) & ~(granularity_ - 1);
 
-  GpuDevicePtr next_va = vmem_.base + next_alloc_offset_;
+  GpuDevicePtr next_va = OffsetDevicePtr(vmem_.base, next_alloc_offset_);
 
   // TODO(imintz): Attempt to extend the vmem allocation by reserving additional
   // virtual memory at the specific address at the end of the initial vmem
   // reservation.
-  if (next_va + padded_bytes > vmem_.base + vmem_.size_bytes) {
+  if (next_alloc_offset_ + padded_bytes > vmem_.size_bytes) {
     LOG(ERROR) << "OOM in GPU virtual memory allocator when attempting to "
                   "allocate {request: "
                << tsl::strings::HumanReadableNumBytes(num_bytes)
@@ -217,7 +242,7 @@ void GpuVirtualMemAllocator::Free(void* ptr, size_t num_bytes) {
 
   // Move back the next_alloc_offset_ if this free was at the end.
   if (mapping_it + num_mappings_to_free == mappings_.end()) {
-    next_alloc_offset_ = mapping_it->va - vmem_.base;
+    next_alloc_offset_ = DevicePtrDistance(vmem_.base, mapping_it->va);
   }
 
   mappings_.erase(mapping_it, mapping_it + num_mappings_to_free);
@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 
 // CUDA virtual memory API is only available in CUDA versions greater than 10.2.
+// The equivalent HIP virtual memory API is available starting with ROCm 6.0.
 
 #ifndef TENSORFLOW_CORE_COMMON_RUNTIME_GPU_GPU_VIRTUAL_MEM_ALLOCATOR_H_
 #define TENSORFLOW_CORE_COMMON_RUNTIME_GPU_GPU_VIRTUAL_MEM_ALLOCATOR_H_
@@ -25,12 +26,12 @@ limitations under the License.
 #include "tensorflow/tsl/framework/allocator.h"
 #include "tensorflow/tsl/framework/device_id.h"
 
-#if GOOGLE_CUDA
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 #include "tensorflow/compiler/xla/stream_executor/gpu/gpu_driver.h"
 #include "tensorflow/compiler/xla/stream_executor/gpu/gpu_types.h"
 #endif
 
-#if CUDA_VERSION >= 10020
+#if CUDA_VERSION >= 10020 || TF_ROCM_VERSION >= 60000
 
 namespace tensorflow {
 
@@ -96,7 +97,7 @@ class GpuVirtualMemAllocator : public tsl::SubAllocator {
   // created with "free".
   size_t next_alloc_offset_ = 0;
 
-  // Smallest allocation as determined by CUDA.
+  // Smallest allocation as determined by CUDA (or HIP).
   const size_t granularity_;
 
   struct Mapping {
@@ -111,6 +112,6 @@ class GpuVirtualMemAllocator : public tsl::SubAllocator {
 
 }  // namespace tensorflow
 
-#endif  // CUDA_VERSION >= 10200
+#endif  // CUDA_VERSION >= 10200 || TF_ROCM_VERSION >= 60000
 
 #endif  // TENSORFLOW_CORE_COMMON_RUNTIME_GPU_GPU_VIRTUAL_MEM_ALLOCATOR_H_
@@ -15,7 +15,7 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/gpu/gpu_virtual_mem_allocator.h"
 
-#if CUDA_VERSION >= 10020
+#if CUDA_VERSION >= 10020 || TF_ROCM_VERSION >= 60000
 
 #include "tensorflow/compiler/xla/stream_executor/device_id_utils.h"
 #include "tensorflow/compiler/xla/stream_executor/gpu/gpu_init.h"
@@ -69,7 +69,8 @@ TEST(GpuVirtualMemAllocatorTest, SimpleAlloc) {
   std::memset(host_mem[0], 'z', kBufSize);
   std::memset(host_mem[1], 0, kBufSize);
 
-  GpuDevicePtr gpu_buf = reinterpret_cast<GpuDevicePtr>(gpu_block) + 2048;
+  GpuDevicePtr gpu_buf =
+      reinterpret_cast<GpuDevicePtr>(static_cast<char*>(gpu_block) + 2048);
   ASSERT_TRUE(GpuDriver::SynchronousMemcpyH2D(gpu_context, gpu_buf, host_mem[0],
                                               kBufSize)
                   .ok());
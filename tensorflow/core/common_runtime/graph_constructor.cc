@@ -52,9 +52,12 @@ limitations under the License.
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/lib/strings/scanner.h"
 #include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/platform/cpu_info.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/threadpool.h"
 #include "tensorflow/core/public/version.h"
 
 namespace tensorflow {
@@ -224,6 +227,7 @@ class GraphConstructor {
   Status ValidateInputMapAndControlDependencies();
   Status BuildNodeIndex();
   Status InitFromEdges();
+  void PrepareNodeDefs();
   Status Convert();
   Status AddBackEdges();
   Status UpdateVersionDef();
@@ -304,6 +308,9 @@ class GraphConstructor {
   // possible. After calling this method, the result of get_node_def(i) is
   // undefined.
   virtual NodeDef consume_node_def(int i) = 0;
+  // Returns the i^th node in the graph for in-place updates, or nullptr if the
+  // nodes are not owned. Must not be called after consume_node_def(i).
+  virtual NodeDef* mutable_node_def(int i) = 0;
   // Returns the version information for the graph, or nullptr if none is
   // available.
   virtual const VersionDef* versions() const = 0;
@@ -339,6 +346,10 @@ class GraphConstructor {
   // Intermediate datastructure used to track the destinations of back edges.
   absl::flat_hash_set<int> merge_node_indices_;
 
+  // If not empty, the result of adding the default attributes to and
+  // validating each node, which PrepareNodeDefs() did ahead of Convert().
+  std::vector<Status> prepared_node_status_;
+
   // Mapping from node name to the index within node_defs_.
   struct NodeInfo {
     explicit NodeInfo(int i) : gdef_index(i), node(nullptr) {}
@@ -436,6 +447,7 @@ class NodeDefCopyingGraphConstructor : public GraphConstructor {
   size_t node_def_count() const override { return node_defs_.size(); }
   const NodeDef& get_node_def(int i) const override { return *node_defs_[i]; }
   NodeDef consume_node_def(int i) override { return *node_defs_[i]; }
+  NodeDef* mutable_node_def(int i) override { return nullptr; }
   const VersionDef* versions() const override { return versions_; }
   std::optional<FunctionDefLibrary> consume_library() override {
     if (library_ == nullptr) {
@@ -478,6 +490,11 @@ class NodeDefMovingGraphConstructor : public GraphConstructor {
     is_consumed_[i] = true;
     return std::move(*graph_def_.mutable_node(i));
   }
+  NodeDef* mutable_node_def(int i) override {
+    CHECK(!is_consumed_[i])
+        << "NodeDef " << i << " accessed after it was consumed.";
+    return graph_def_.mutable_node(i);
+  }
   const VersionDef* versions() const override { return &graph_def_.versions(); }
   std::optional<FunctionDefLibrary> consume_library() override {
     return std::move(*graph_def_.mutable_library());
@@ -1187,6 +1204,41 @@ std::shared_ptr<AbstractStackTrace> GraphConstructor::CreateStackTraceForNode(
   return nullptr;
 }
 
+void GraphConstructor::PrepareNodeDefs() {
+  // Below this size, starting the threads costs more than it saves.
+  constexpr int kMinNodesForParallelPreparation = 10000;
+  const int num_nodes = node_def_count();
+  if (opts_.importing || num_nodes < kMinNodesForParallelPreparation ||
+      (!opts_.add_default_attributes && !opts_.validate_nodes) ||
+      mutable_node_def(0) == nullptr) {
+    return;
+  }
+  // The op def lookups, the default attributes and the validation of each node
+  // only depend on the node itself, unlike what Convert() does with the nodes
+  // in topological order. The statuses are kept, so that Convert() reports the
+  // same error as if it had prepared the nodes itself.
+  prepared_node_status_.resize(num_nodes);
+  thread::ThreadPool pool(Env::Default(), "prepare_node_defs",
+                          port::MaxParallelism());
+  pool.ParallelFor(
+      num_nodes, /*cost_per_unit=*/10000, [this](int64_t start, int64_t end) {
+        for (int64_t i = start; i < end; ++i) {
+          NodeDef* node_def = mutable_node_def(i);
+          const OpDef* op_def;
+          Status s = g_->op_registry()->LookUpOpDef(node_def->op(), &op_def);
+          if (s.ok()) {
+            if (opts_.add_default_attributes) {
+              AddDefaultsToNodeDef(*op_def, node_def);
+            }
+            if (opts_.validate_nodes) {
+              s = ValidateNodeDef(*node_def, *op_def);
+            }
+          }
+          prepared_node_status_[i] = std::move(s);
+        }
+      });
+}
+
 Status GraphConstructor::Convert() {
   // Import functions before adding nodes, since imported nodes may refer to
   // functions
@@ -1196,6 +1248,7 @@ Status GraphConstructor::Convert() {
     TF_RETURN_IF_ERROR(
         g_->AddFunctionLibrary(*std::move(library), library_traces));
   }
+  PrepareNodeDefs();
 
   std::vector<InputInfo> inputs;
   int processed = 0;
@@ -1309,6 +1362,8 @@ Status GraphConstructor::Convert() {
 
     if (opts_.importing) {
       TF_RETURN_IF_ERROR(ModifyNodeDefForImport(&node_def));
+    } else if (!prepared_node_status_.empty()) {
+      TF_RETURN_IF_ERROR(prepared_node_status_[o]);
     } else {
       const OpDef* op_def;
       TF_RETURN_IF_ERROR(
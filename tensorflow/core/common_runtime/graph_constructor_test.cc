@@ -824,6 +824,44 @@ TEST_F(GraphConstructorTest, TypeMismatch) {
        "expected int32."});
 }
 
+// The large graphs that are moved into the graph are prepared in parallel.
+TEST_F(GraphConstructorTest, LargeMovedGraphDefaultAttrs) {
+  constexpr int kNumNodes = 20000;
+  GraphDef gdef;
+  for (int i = 0; i < kNumNodes; ++i) {
+    NodeDef* node = gdef.add_node();
+    node->set_name(absl::StrCat("n", i));
+    node->set_op("TestDefaultAttr");
+  }
+  GraphConstructorOptions opts;
+  opts.validate_nodes = true;
+  TF_ASSERT_OK(ConvertGraphDefToGraph(opts, std::move(gdef), &graph_));
+  EXPECT_EQ(graph_.num_op_nodes(), kNumNodes);
+  for (Node* n : graph_.op_nodes()) {
+    int default_int;
+    TF_ASSERT_OK(GetNodeAttr(n->attrs(), "default_int", &default_int));
+    EXPECT_EQ(default_int, 31415);
+  }
+}
+
+TEST_F(GraphConstructorTest, LargeMovedGraphInvalidNode) {
+  constexpr int kNumNodes = 20000;
+  GraphDef gdef;
+  for (int i = 0; i < kNumNodes; ++i) {
+    NodeDef* node = gdef.add_node();
+    node->set_name(absl::StrCat("n", i));
+    node->set_op("TestDefaultAttr");
+  }
+  AddNodeAttr("default_int", "not an int", gdef.mutable_node(kNumNodes / 2));
+  const string original_graph_description = GraphDebugString();
+  GraphConstructorOptions opts;
+  opts.validate_nodes = true;
+  Status s = ConvertGraphDefToGraph(opts, std::move(gdef), &graph_);
+  EXPECT_TRUE(errors::IsInvalidArgument(s)) << s;
+  EXPECT_TRUE(absl::StrContains(s.message(), "n10000")) << s;
+  EXPECT_EQ(original_graph_description, GraphDebugString());
+}
+
 TEST_F(GraphConstructorTest, EmptyGraph) {
   ExpectOK("");
   ExpectVersions(0, 0);
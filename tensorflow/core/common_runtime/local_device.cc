@@ -47,6 +47,22 @@ bool OverrideGlobalThreadPoolFromEnvironment() {
   return override_global_threadpool;
 }
 
+// Returns true if the threads of the intra-op pools that are not pinned to a
+// NUMA node are partitioned over the NUMA nodes.
+bool NumaPartitionedThreadPoolFromEnvironment() {
+  static const bool numa_partitioned_threadpool = [] {
+    bool flag;
+    auto status = ReadBoolFromEnvVar("TF_NUMA_PARTITIONED_THREADPOOL",
+                                     /*default_val=*/false, &flag);
+    if (!status.ok()) {
+      LOG(ERROR) << "NumaPartitionedThreadPool: " << status.message();
+      return false;
+    }
+    return flag;
+  }();
+  return numa_partitioned_threadpool;
+}
+
 }  // namespace
 
 /* static */
@@ -83,6 +99,7 @@ struct LocalDevice::EigenThreadPoolInfo {
     }
     ThreadOptions thread_opts;
     thread_opts.numa_node = numa_node;
+    thread_opts.numa_partitioned = NumaPartitionedThreadPoolFromEnvironment();
     eigen_worker_threads_.num_threads = intra_op_parallelism_threads;
     eigen_worker_threads_.workers = new thread::ThreadPool(
         options.env, thread_opts, strings::StrCat("numa_", numa_node, "_Eigen"),
@@ -50,6 +50,10 @@ struct LocalExecutorParams {
 
   // Whether control flow nodes are allowed to be executed synchronously.
   bool allow_control_flow_sync_execution = false;
+
+  // Whether the outputs of kernels running on a CPU device are served from an
+  // arena planned after the first steps. See `StaticMemoryPlanner`.
+  bool enable_static_memory_planning = false;
 };
 
 }  // end namespace tensorflow
@@ -47,6 +47,14 @@ Status PjRtCompileOnDemandOp::Compile(
   compile_options.is_entry_computation = true;
   compile_options.use_tuple_arg = false;
   compile_options.always_return_tuple = true;
+  // Updated variables alias their inputs, so that the buffer of a variable
+  // that no other tensor refers to is donated to the update instead of a new
+  // buffer being allocated. Reference variables cannot be donated.
+  bool has_ref_inputs = false;
+  for (int i = 0; i < ctx->num_inputs(); ++i) {
+    has_ref_inputs |= ctx->input_is_ref(i);
+  }
+  compile_options.alias_resource_update = !has_ref_inputs;
   XlaCompiler compiler(options);
   TF_RETURN_IF_ERROR(compiler.CompileSingleOp(
       compile_options, XlaCompiler::SingleOpCompileArgument(*ctx), args,
@@ -50,6 +50,7 @@ limitations under the License.
 #include "tensorflow/core/graph/graph.h"
 #include "tensorflow/core/graph/graph_node_util.h"
 #include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/gtl/cleanup.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/lib/gtl/map_util.h"
 #include "tensorflow/core/platform/blocking_counter.h"
@@ -510,13 +511,24 @@ Status ProcessFunctionLibraryRuntime::InstantiateMultiDevice(
 
   {
     mutex_lock l(mu_);
+    // Waits for an identical request that is being instantiated, and uses its
+    // result if it succeeded.
+    while (pending_instantiations_.count(function_key) > 0) {
+      pending_instantiations_cv_.wait(l);
+    }
     const auto& it = table_.find(function_key);
     if (it != table_.end()) {
       *handle = it->second;
       ++mdevice_data_[*handle]->instantiation_counter_;
       return OkStatus();
     }
+    pending_instantiations_.insert(function_key);
   }
+  auto pending_cleanup = gtl::MakeCleanup([this, &function_key] {
+    mutex_lock l(mu_);
+    pending_instantiations_.erase(function_key);
+    pending_instantiations_cv_.notify_all();
+  });
 
   VLOG(1) << "Instantiating MultiDevice function \"" << function_name
           << "\" on default device \"" << options.target << "\"";
@@ -637,11 +649,19 @@ Status ProcessFunctionLibraryRuntime::InstantiateMultiDevice(
   const int num_subgraphs = subgraphs->size();
   gtl::InlinedVector<Status, 4> instantiate_status(num_subgraphs);
   BlockingCounter counter(static_cast<int>(num_subgraphs));
-  auto runner = [this, num_subgraphs](std::function<void()> fn) {
-    // NOTE: Only use thread pool to instantiate sub-function when there are
-    // more than 8 sub-functions. We want to avoid cost of switching thread when
-    // there are only a few sub-functions.
-    if (default_thread_pool_ != nullptr && num_subgraphs > 8) {
+  int64_t num_subgraph_nodes = 0;
+  for (const auto& pair : *subgraphs) {
+    num_subgraph_nodes += pair.second->num_op_nodes();
+  }
+  // NOTE: Only use thread pool to instantiate sub-function when there are
+  // more than 8 sub-functions, or a few large ones. We want to avoid cost of
+  // switching thread when there are only a few small sub-functions.
+  const bool parallel_instantiation =
+      default_thread_pool_ != nullptr &&
+      (num_subgraphs > 8 ||
+       (num_subgraphs > 1 && num_subgraph_nodes >= 1000 * num_subgraphs));
+  auto runner = [this, parallel_instantiation](std::function<void()> fn) {
+    if (parallel_instantiation) {
       default_thread_pool_->Schedule(fn);
     } else {
       fn();
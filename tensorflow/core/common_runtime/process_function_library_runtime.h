@@ -19,6 +19,7 @@ limitations under the License.
 #include <optional>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "absl/types/variant.h"
 #include "tensorflow/core/common_runtime/composite_device.h"
@@ -520,6 +521,12 @@ class ProcessFunctionLibraryRuntime {
   std::unordered_map<string, FunctionLibraryRuntime::Handle> table_
       TF_GUARDED_BY(mu_);
 
+  // The function_keys of the multi-device functions being instantiated. The
+  // identical instantiation requests wait on `pending_instantiations_cv_`
+  // for them, instead of partitioning and optimizing the function again.
+  std::unordered_set<string> pending_instantiations_ TF_GUARDED_BY(mu_);
+  condition_variable pending_instantiations_cv_;
+
   // Function data for instantiated remote functions.
   std::unordered_map<FunctionLibraryRuntime::Handle,
                      std::unique_ptr<FunctionData>>
@@ -732,6 +732,31 @@ FunctionLibraryRuntime::InstantiateOptions MakeOptions(
   return inst_opts;
 }
 
+TEST_F(ProcessFunctionLibraryRuntimeTest, MultiDevice_ParallelInstantiation) {
+  Init({test::function::XTimesTwo()});
+  const FunctionLibraryRuntime::InstantiateOptions inst_opts =
+      MakeOptions("CPU:0", {"CPU:0"}, {"CPU:0"});
+
+  // The identical concurrent requests share a single instantiation.
+  constexpr int kNumRequests = 16;
+  std::vector<FunctionLibraryRuntime::Handle> handles(kNumRequests);
+  {
+    thread::ThreadPool tp(Env::Default(), "test", 4);
+    for (int i = 0; i < kNumRequests; ++i) {
+      tp.Schedule([this, &inst_opts, &handles, i]() {
+        TF_CHECK_OK(Instantiate("XTimesTwo", {{"T", DT_FLOAT}}, inst_opts,
+                                &handles[i]));
+      });
+    }
+  }
+  for (int i = 1; i < kNumRequests; ++i) {
+    EXPECT_EQ(handles[0], handles[i]);
+  }
+  for (int i = 0; i < kNumRequests; ++i) {
+    TF_EXPECT_OK(proc_flr_->ReleaseHandle(handles[i]));
+  }
+}
+
 TEST_F(ProcessFunctionLibraryRuntimeTest, MultiDevice_ExplicitOutputDevice) {
   if (gpu_device_ == nullptr) {
     GTEST_SKIP() << "No GPUs available";
@@ -290,8 +290,7 @@ void PropagatorState::FindOrCreateChildFrame(FrameState* frame,
   // Initialize iteration 0.
   {
     mutex_lock l(temp->mu);
-    temp->SetIteration(0, new IterationState(0, temp->pending_counts,
-                                             temp->total_input_tensors));
+    temp->SetIteration(0, temp->NewIteration(0));
   }
 
   {
@@ -753,8 +752,7 @@ PropagatorState::FrameState::IncrementIteration(TaggedNodeSeq* ready) {
   iteration_count++;
 
   // Initialize the next iteration.
-  IterationState* next_iter =
-      new IterationState(iteration_count, pending_counts, total_input_tensors);
+  IterationState* next_iter = NewIteration(iteration_count);
   SetIteration(iteration_count, next_iter);
   num_outstanding_iterations++;
   {
@@ -771,11 +769,27 @@ PropagatorState::FrameState::IncrementIteration(TaggedNodeSeq* ready) {
   return next_iter;
 }
 
+PropagatorState::IterationState* PropagatorState::FrameState::NewIteration(
+    int64_t iter_num) {
+  if (free_iterations.empty()) {
+    return new IterationState(iter_num, pending_counts, total_input_tensors);
+  }
+  IterationState* iter_state = free_iterations.back();
+  free_iterations.pop_back();
+  iter_state->Reset(iter_num, pending_counts);
+  return iter_state;
+}
+
 bool PropagatorState::FrameState::CleanupIterations(IterationState* iter_state,
                                                     TaggedNodeSeq* ready) {
   int64_t curr_iter = iter_state->iter_num;
   while (curr_iter <= iteration_count && IsIterationDone(iter_state)) {
-    delete iter_state;
+    // The tensors that were not consumed by the iteration are released now
+    // rather than when the state is reused.
+    for (int i = 0; i < total_input_tensors; ++i) {
+      iter_state->input_tensors[i].ClearVal();
+    }
+    free_iterations.push_back(iter_state);
     SetIteration(curr_iter, nullptr);
     --num_outstanding_iterations;
     ++curr_iter;
@@ -135,8 +135,16 @@ class PropagatorState {
           counts(*pending_counts) {  // Initialize with copy of *pending_counts
     }
 
-    const int64_t
-        iter_num;  // The index of this iteration in the enclosing loop.
+    // Resets a completed iteration state, whose input tensors are cleared,
+    // for its reuse as iteration `iter_num` of the same frame.
+    void Reset(int64_t iter_num, const PendingCounts* pending_counts) {
+      this->iter_num = iter_num;
+      outstanding_ops = 0;
+      outstanding_frame_count = 0;
+      counts.ResetFrom(*pending_counts);
+    }
+
+    int64_t iter_num;  // The index of this iteration in the enclosing loop.
 
     // One copy per iteration. For iteration k, i-th node's j-th input is in
     // input_tensors[k][immutable_state_.nodes[i].input_start + j]. An entry is
@@ -287,6 +295,11 @@ class PropagatorState {
     IterationState** const iterations_raw TF_GUARDED_BY(mu);
     IterationState* iterations_first TF_GUARDED_BY(mu);
 
+    // The states of the completed iterations, which are reused by the next
+    // iterations of this frame instead of allocating their input tensors and
+    // pending counts again. They are deleted with the frame.
+    std::vector<IterationState*> free_iterations TF_GUARDED_BY(mu);
+
    public:
     // The NextIteration nodes to enter a new iteration. If the number of
     // outstanding iterations reaches the limit, we will defer the start of
@@ -400,6 +413,11 @@ class PropagatorState {
                             TaggedNodeSeq* ready)
         TF_EXCLUSIVE_LOCKS_REQUIRED(mu);
 
+    // Returns the state of iteration `iter_num`, reusing the state of a
+    // completed iteration if there is one.
+    IterationState* NewIteration(int64_t iter_num)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu);
+
     // Cleanup iterations of this frame starting from the given iteration.
     bool CleanupIterations(IterationState* iter_state, TaggedNodeSeq* ready)
         TF_EXCLUSIVE_LOCKS_REQUIRED(mu);
@@ -419,6 +437,9 @@ class PropagatorState {
         delete iterations[i];
         iterations[i] = nullptr;
       }
+      for (IterationState* iter_state : free_iterations) {
+        delete iter_state;
+      }
     }
 
    private:
@@ -16,6 +16,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/single_threaded_executor.h"
 
 #include <utility>
+#include <vector>
 
 #include "tensorflow/core/common_runtime/entry.h"
 #include "tensorflow/core/common_runtime/executor.h"
@@ -68,6 +69,27 @@ typedef gtl::InlinedVector<AllocatorAttributes, 4> AllocatorAttributeVec;
 static const string& kSingleThreadedExecutor =
     *new string("SINGLE_THREADED_EXECUTOR");
 
+// Returns an error if `schedule` isn't a topological order of all the nodes of
+// `graph`.
+Status ValidateSchedule(const Graph& graph, absl::Span<Node* const> schedule) {
+  if (schedule.size() != static_cast<size_t>(graph.num_nodes())) {
+    return errors::InvalidArgument("Graph had ", graph.num_nodes(),
+                                   " but schedule had ", schedule.size());
+  }
+  std::vector<bool> scheduled(graph.num_node_ids(), false);
+  for (const Node* n : schedule) {
+    for (const Edge* e : n->in_edges()) {
+      if (!scheduled[e->src()->id()]) {
+        return errors::InvalidArgument("Node ", n->name(),
+                                       " is scheduled before its input ",
+                                       e->src()->name());
+      }
+    }
+    scheduled[n->id()] = true;
+  }
+  return OkStatus();
+}
+
 class SingleThreadedExecutorImpl : public Executor {
  public:
   explicit SingleThreadedExecutorImpl(const LocalExecutorParams& params)
@@ -82,16 +104,21 @@ class SingleThreadedExecutorImpl : public Executor {
     }
   }
 
-  Status Initialize(const Graph& graph) {
-    // Topologicially sort `graph` to get a sequence of OpKernels.
+  Status Initialize(const Graph& graph, absl::Span<Node* const> schedule) {
     std::vector<Node*> ordered_nodes;
-    ordered_nodes.reserve(graph.num_nodes());
-    GetReversePostOrder(graph, &ordered_nodes);
-    int ordered_nodes_size = ordered_nodes.size();
-    if (ordered_nodes_size != graph.num_nodes()) {
-      return errors::InvalidArgument("Graph had ", graph.num_nodes(),
-                                     " but reverse post-order had ",
-                                     ordered_nodes.size());
+    if (schedule.empty()) {
+      // Topologicially sort `graph` to get a sequence of OpKernels.
+      ordered_nodes.reserve(graph.num_nodes());
+      GetReversePostOrder(graph, &ordered_nodes);
+      int ordered_nodes_size = ordered_nodes.size();
+      if (ordered_nodes_size != graph.num_nodes()) {
+        return errors::InvalidArgument("Graph had ", graph.num_nodes(),
+                                       " but reverse post-order had ",
+                                       ordered_nodes.size());
+      }
+    } else {
+      TF_RETURN_IF_ERROR(ValidateSchedule(graph, schedule));
+      ordered_nodes.assign(schedule.begin(), schedule.end());
     }
 
     // We reserve two less nodes because we do not need to create kernels for
@@ -592,8 +619,15 @@ static SingleThreadedExecutorRegistrar registrar;
 
 Status NewSingleThreadedExecutor(const LocalExecutorParams& params,
                                  const Graph& graph, Executor** executor) {
+  return NewSingleThreadedExecutor(params, graph, /*schedule=*/{}, executor);
+}
+
+Status NewSingleThreadedExecutor(const LocalExecutorParams& params,
+                                 const Graph& graph,
+                                 absl::Span<Node* const> schedule,
+                                 Executor** executor) {
   auto impl = std::make_unique<SingleThreadedExecutorImpl>(params);
-  TF_RETURN_IF_ERROR(impl->Initialize(graph));
+  TF_RETURN_IF_ERROR(impl->Initialize(graph, schedule));
   *executor = impl.release();
   return OkStatus();
 }
@@ -16,7 +16,9 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_COMMON_RUNTIME_SINGLE_THREADED_EXECUTOR_H_
 #define TENSORFLOW_CORE_COMMON_RUNTIME_SINGLE_THREADED_EXECUTOR_H_
 
+#include "absl/types/span.h"
 #include "tensorflow/core/common_runtime/executor.h"
+#include "tensorflow/core/graph/graph.h"
 
 namespace tensorflow {
 
@@ -54,6 +56,13 @@ namespace tensorflow {
 Status NewSingleThreadedExecutor(const LocalExecutorParams& params,
                                  const Graph& graph, Executor** executor);
 
+// Same as above, but executes the kernels in the order of `schedule`, which
+// must contain all the nodes of `graph` in a topological order.
+Status NewSingleThreadedExecutor(const LocalExecutorParams& params,
+                                 const Graph& graph,
+                                 absl::Span<Node* const> schedule,
+                                 Executor** executor);
+
 // Returns OkStatus() for ops which are compatible with synchronous execution,
 // and otherwise returns an error message appropriate for propagation if needed.
 // If `allow_control_flow_sync_execution` is set to `true` control
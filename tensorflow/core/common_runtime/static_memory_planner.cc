@@ -0,0 +1,278 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/static_memory_planner.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/graph/algorithm.h"
+#include "tensorflow/core/platform/logging.h"
+
+namespace tensorflow {
+
+namespace {
+
+size_t AlignedSize(size_t bytes) {
+  constexpr size_t kAlignment = Allocator::kAllocatorAlignment;
+  return (bytes + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+}  // namespace
+
+// A single allocation from the base allocator, split into buffers. Every
+// buffer is exposed as an allocator that serves one tensor at a time.
+//
+// Each tensor allocated through a buffer allocator, including those that fall
+// back to the base allocator, holds a reference on the arena, so that the arena
+// outlives the planner if tensors escape the executor.
+class StaticMemoryPlanner::Arena : public core::RefCounted {
+ public:
+  Arena(Allocator* base_allocator, const std::vector<size_t>& buffer_bytes)
+      : base_allocator_(base_allocator) {
+    for (size_t bytes : buffer_bytes) total_bytes_ += AlignedSize(bytes);
+    base_ = static_cast<char*>(base_allocator_->AllocateRaw(
+        Allocator::kAllocatorAlignment, total_bytes_));
+    if (base_ == nullptr) return;
+    size_t offset = 0;
+    for (size_t bytes : buffer_bytes) {
+      buffers_.push_back(
+          std::make_unique<BufferAllocator>(this, base_ + offset, bytes));
+      offset += AlignedSize(bytes);
+    }
+  }
+
+  ~Arena() override {
+    if (base_ != nullptr) base_allocator_->DeallocateRaw(base_);
+  }
+
+  bool ok() const { return base_ != nullptr; }
+  size_t total_bytes() const { return total_bytes_; }
+  Allocator* buffer(int index) { return buffers_[index].get(); }
+
+ private:
+  class BufferAllocator : public Allocator {
+   public:
+    BufferAllocator(Arena* arena, char* ptr, size_t bytes)
+        : arena_(arena), ptr_(ptr), bytes_(bytes) {}
+
+    std::string Name() override { return "static_memory_plan"; }
+
+    void* AllocateRaw(size_t alignment, size_t num_bytes) override {
+      arena_->Ref();
+      if (num_bytes <= bytes_ && alignment <= Allocator::kAllocatorAlignment &&
+          !in_use_.exchange(true, std::memory_order_acquire)) {
+        return ptr_;
+      }
+      void* ptr = arena_->base_allocator_->AllocateRaw(alignment, num_bytes);
+      if (ptr == nullptr) arena_->Unref();
+      return ptr;
+    }
+
+    void DeallocateRaw(void* ptr) override {
+      if (ptr == ptr_) {
+        in_use_.store(false, std::memory_order_release);
+      } else {
+        arena_->base_allocator_->DeallocateRaw(ptr);
+      }
+      // N.B. This may delete `this`.
+      arena_->Unref();
+    }
+
+    AllocatorMemoryType GetMemoryType() const override {
+      return arena_->base_allocator_->GetMemoryType();
+    }
+
+   private:
+    Arena* const arena_;
+    char* const ptr_;
+    const size_t bytes_;
+    std::atomic<bool> in_use_{false};
+  };
+
+  Allocator* const base_allocator_;
+  char* base_ = nullptr;
+  size_t total_bytes_ = 0;
+  std::vector<std::unique_ptr<BufferAllocator>> buffers_;
+};
+
+StaticMemoryPlanner::StaticMemoryPlanner(const Graph& graph,
+                                         const GraphView& gview,
+                                         Allocator* base_allocator)
+    : gview_(gview), base_allocator_(base_allocator) {
+  std::vector<Node*> order;
+  GetReversePostOrder(graph, &order);
+  topo_order_.reserve(order.size());
+  for (const Node* n : order) {
+    if (gview_.node(n->id()) != nullptr) topo_order_.push_back(n->id());
+  }
+
+  const int32_t num_nodes = gview_.num_nodes();
+  output_offsets_.resize(num_nodes, 0);
+  int32_t num_outputs = 0;
+  for (int32_t id = 0; id < num_nodes; ++id) {
+    output_offsets_[id] = num_outputs;
+    const NodeItem* item = gview_.node(id);
+    if (item != nullptr) num_outputs += item->num_outputs;
+  }
+  recorded_bytes_ = std::make_unique<std::atomic<int64_t>[]>(num_outputs);
+  for (int32_t i = 0; i < num_outputs; ++i) {
+    recorded_bytes_[i].store(kUnknownBytes, std::memory_order_relaxed);
+  }
+  output_allocators_.resize(num_nodes, nullptr);
+  output_allocator_storage_.resize(num_nodes);
+}
+
+StaticMemoryPlanner::~StaticMemoryPlanner() {
+  mutex_lock l(mu_);
+  if (arena_ != nullptr) arena_->Unref();
+}
+
+void StaticMemoryPlanner::RecordOutput(const NodeItem& item, int index,
+                                       const Tensor& tensor) {
+  std::atomic<int64_t>& recorded =
+      recorded_bytes_[output_offsets_[item.node_id] + index];
+  const int64_t bytes =
+      DataTypeCanUseMemcpy(tensor.dtype()) && tensor.TotalBytes() > 0
+          ? static_cast<int64_t>(tensor.TotalBytes())
+          : kDynamicBytes;
+  int64_t expected = kUnknownBytes;
+  if (!recorded.compare_exchange_strong(expected, bytes,
+                                        std::memory_order_relaxed) &&
+      expected != bytes) {
+    recorded.store(kDynamicBytes, std::memory_order_relaxed);
+  }
+}
+
+void StaticMemoryPlanner::StepDone(bool ok) {
+  if (!recording()) return;
+  mutex_lock l(mu_);
+  if (!recording()) return;
+  if (ok && ++num_recorded_steps_ >= kNumRecordingSteps) {
+    BuildPlan();
+    recording_.store(false, std::memory_order_relaxed);
+  }
+}
+
+size_t StaticMemoryPlanner::arena_bytes() const {
+  mutex_lock l(mu_);
+  return arena_ != nullptr ? arena_->total_bytes() : 0;
+}
+
+void StaticMemoryPlanner::BuildPlan() {
+  struct PlannedOutput {
+    int32 node_id;
+    int index;
+    size_t bytes;
+    // Live range, in positions of `topo_order_`.
+    int start;
+    int end;
+  };
+  std::vector<int> position(gview_.num_nodes(), 0);
+  for (int i = 0; i < topo_order_.size(); ++i) position[topo_order_[i]] = i;
+
+  std::vector<PlannedOutput> outputs;
+  for (int32_t id : topo_order_) {
+    const NodeItem& item = gview_.node_ref(id);
+    for (int i = 0; i < item.num_outputs; ++i) {
+      const int64_t bytes =
+          recorded_bytes_[output_offsets_[id] + i].load(
+              std::memory_order_relaxed);
+      if (bytes <= 0 || IsRefType(item.output_type(i))) continue;
+      outputs.push_back({id, i, static_cast<size_t>(bytes), position[id],
+                         position[id]});
+    }
+  }
+  if (outputs.empty()) return;
+  // Index the planned outputs by node to compute their live ranges.
+  std::vector<int> first_output(gview_.num_nodes(), -1);
+  for (int i = outputs.size() - 1; i >= 0; --i) {
+    first_output[outputs[i].node_id] = i;
+  }
+  for (int32_t id : topo_order_) {
+    if (first_output[id] < 0) continue;
+    for (const EdgeInfo& e : gview_.node_ref(id).output_edges()) {
+      for (int i = first_output[id];
+           i < outputs.size() && outputs[i].node_id == id; ++i) {
+        if (outputs[i].index == e.output_slot) {
+          outputs[i].end = std::max(outputs[i].end, position[e.dst_id]);
+        }
+      }
+    }
+  }
+
+  // Greedy by size: visit the outputs from the largest to the smallest, and
+  // place each one in the smallest existing buffer that is not live during its
+  // live range, or in a new buffer.
+  std::vector<int> order(outputs.size());
+  for (int i = 0; i < order.size(); ++i) order[i] = i;
+  std::stable_sort(order.begin(), order.end(), [&outputs](int a, int b) {
+    return outputs[a].bytes > outputs[b].bytes;
+  });
+  std::vector<size_t> buffer_bytes;
+  std::vector<std::vector<std::pair<int, int>>> buffer_ranges;
+  std::vector<int> assignment(outputs.size(), -1);
+  for (int i : order) {
+    const PlannedOutput& output = outputs[i];
+    int best = -1;
+    for (int b = buffer_bytes.size() - 1; b >= 0 && best < 0; --b) {
+      bool overlaps = false;
+      for (const auto& range : buffer_ranges[b]) {
+        if (range.first <= output.end && output.start <= range.second) {
+          overlaps = true;
+          break;
+        }
+      }
+      if (!overlaps) best = b;
+    }
+    if (best < 0) {
+      best = buffer_bytes.size();
+      buffer_bytes.push_back(output.bytes);
+      buffer_ranges.emplace_back();
+    }
+    buffer_ranges[best].emplace_back(output.start, output.end);
+    assignment[i] = best;
+  }
+
+  arena_ = new Arena(base_allocator_, buffer_bytes);
+  if (!arena_->ok()) {
+    LOG(WARNING) << "Could not allocate a static memory plan arena of "
+                 << arena_->total_bytes() << " bytes; outputs will be "
+                 << "allocated dynamically.";
+    arena_->Unref();
+    arena_ = nullptr;
+    return;
+  }
+  size_t total_output_bytes = 0;
+  for (int i = 0; i < outputs.size(); ++i) {
+    const PlannedOutput& output = outputs[i];
+    std::vector<Allocator*>& allocators =
+        output_allocator_storage_[output.node_id];
+    allocators.resize(gview_.node_ref(output.node_id).num_outputs, nullptr);
+    allocators[output.index] = arena_->buffer(assignment[i]);
+    total_output_bytes += output.bytes;
+  }
+  for (int32_t id = 0; id < gview_.num_nodes(); ++id) {
+    if (!output_allocator_storage_[id].empty()) {
+      output_allocators_[id] = output_allocator_storage_[id].data();
+    }
+  }
+  VLOG(1) << "Static memory plan: " << outputs.size() << " outputs ("
+          << total_output_bytes << " bytes) in " << buffer_bytes.size()
+          << " buffers (" << arena_->total_bytes() << " bytes).";
+  planned_.store(true, std::memory_order_release);
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,116 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_STATIC_MEMORY_PLANNER_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_STATIC_MEMORY_PLANNER_H_
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "tensorflow/core/common_runtime/graph_view.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/refcount.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+
+// Plans the memory of the outputs of a graph whose shapes do not change
+// between steps, and serves them from a single preallocated arena.
+//
+// The planner first records the size of every output during
+// `kNumRecordingSteps` successful steps. Outputs with the same size in all of
+// them are assigned to arena buffers with a greedy-by-size strategy: outputs
+// whose live ranges, taken over a topological order of the graph, do not
+// overlap share a buffer.
+//
+// The plan only decides which outputs should share memory. Each buffer is
+// handed out only while it is free, i.e. after the tensor previously stored in
+// it has been deallocated, and the requests that find it busy (e.g. because
+// the tensor escaped the step or the schedule differs from the topological
+// order) fall back to the device allocator. It is therefore always safe to use
+// the plan, including with concurrent steps and loops.
+//
+// All methods are thread-safe.
+class StaticMemoryPlanner {
+ public:
+  static constexpr int kNumRecordingSteps = 2;
+
+  // `base_allocator` backs the arena and serves the requests that the plan
+  // cannot serve. Not owned, and must outlive the tensors allocated through
+  // the planner.
+  StaticMemoryPlanner(const Graph& graph, const GraphView& gview,
+                      Allocator* base_allocator);
+  ~StaticMemoryPlanner();
+
+  // Returns true while output sizes are being recorded.
+  bool recording() const { return recording_.load(std::memory_order_relaxed); }
+
+  // Records the size of output `index` of `item` for the current step.
+  void RecordOutput(const NodeItem& item, int index, const Tensor& tensor);
+
+  // Must be called at the end of every step. Builds the plan after
+  // `kNumRecordingSteps` successful steps.
+  void StepDone(bool ok);
+
+  // Returns an array indexed by output number for `item`, whose entries are
+  // either nullptr or the allocator that should be used for that output, or
+  // nullptr if none of the outputs of `item` is planned.
+  Allocator* const* output_allocators(const NodeItem& item) const {
+    if (!planned_.load(std::memory_order_acquire)) return nullptr;
+    return output_allocators_[item.node_id];
+  }
+
+  // Returns the size of the arena, or 0 if there is no plan yet.
+  size_t arena_bytes() const;
+
+ private:
+  class Arena;
+
+  // Sentinel values for `recorded_bytes_`.
+  static constexpr int64_t kUnknownBytes = -1;
+  static constexpr int64_t kDynamicBytes = -2;
+
+  void BuildPlan() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  const GraphView& gview_;
+  Allocator* const base_allocator_;  // Not owned.
+
+  // Node ids in topological order.
+  std::vector<int32> topo_order_;
+
+  // `recorded_bytes_[output_offsets_[id] + i]` is the size of output `i` of
+  // node `id` in the recorded steps, or one of the sentinel values above.
+  std::vector<int32> output_offsets_;
+  std::unique_ptr<std::atomic<int64_t>[]> recorded_bytes_;
+
+  std::atomic<bool> recording_{true};
+  std::atomic<bool> planned_{false};
+
+  mutable mutex mu_;
+  int num_recorded_steps_ TF_GUARDED_BY(mu_) = 0;
+  Arena* arena_ TF_GUARDED_BY(mu_) = nullptr;
+  // Indexed by node id. Written once before `planned_` is set.
+  std::vector<Allocator* const*> output_allocators_;
+  std::vector<std::vector<Allocator*>> output_allocator_storage_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(StaticMemoryPlanner);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_STATIC_MEMORY_PLANNER_H_
@@ -0,0 +1,152 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/static_schedule_executor.h"
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "absl/container/flat_hash_map.h"
+#include "tensorflow/core/common_runtime/executor_factory.h"
+#include "tensorflow/core/common_runtime/single_threaded_executor.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/graph/algorithm.h"
+#include "tensorflow/core/grappler/clusters/utils.h"
+#include "tensorflow/core/grappler/clusters/virtual_cluster.h"
+#include "tensorflow/core/grappler/costs/cost_estimator.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/grappler/optimizers/static_schedule.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/protobuf/device_properties.pb.h"
+
+namespace tensorflow {
+
+bool CanScheduleStatically(const LocalExecutorParams& params,
+                           const Graph& graph) {
+  if (params.device == nullptr || params.device->device_type() != DEVICE_CPU) {
+    return false;
+  }
+  for (const Node* n : graph.op_nodes()) {
+    // Partitioned graphs communicate through pairs of _Send and _Recv nodes,
+    // which must be allowed to run in any order.
+    if (n->IsSend() || n->IsRecv()) {
+      return false;
+    }
+    if (!ValidateOpIsSafeForSyncExecution(
+             *n, params.allow_control_flow_sync_execution)
+             .ok()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+Status ComputeStaticSchedule(const LocalExecutorParams& params,
+                             const Graph& graph, std::vector<Node*>* schedule) {
+  schedule->clear();
+  GetReversePostOrder(graph, schedule);
+
+  grappler::GrapplerItem item;
+  graph.ToGraphDef(&item.graph);
+  std::unordered_map<string, DeviceProperties> devices;
+  devices[params.device->name()] = grappler::GetLocalCPUInfo();
+  grappler::VirtualCluster cluster(devices);
+  std::unordered_map<const NodeDef*, grappler::Costs::NanoSeconds>
+      completion_times;
+  TF_RETURN_IF_ERROR(grappler::EstimateEarliestExecutionTimes(
+      item, &cluster, &completion_times));
+
+  absl::flat_hash_map<string, int64_t> completion_time_by_name;
+  for (const auto& completion_time : completion_times) {
+    completion_time_by_name[completion_time.first->name()] =
+        completion_time.second.count();
+  }
+  absl::flat_hash_map<const Node*, int64_t> completion_time_by_node;
+  for (const Node* n : *schedule) {
+    if (n->IsSource()) {
+      completion_time_by_node[n] = std::numeric_limits<int64_t>::min();
+    } else if (n->IsSink()) {
+      completion_time_by_node[n] = std::numeric_limits<int64_t>::max();
+    } else {
+      auto it = completion_time_by_name.find(n->name());
+      if (it == completion_time_by_name.end()) {
+        return errors::Internal("No completion time estimated for node ",
+                                n->name());
+      }
+      completion_time_by_node[n] = it->second;
+    }
+  }
+
+  // Every node completes at least one nanosecond after its inputs, so sorting
+  // by completion time preserves the topological order. Ties are broken by
+  // the reverse post-order.
+  std::stable_sort(schedule->begin(), schedule->end(),
+                   [&completion_time_by_node](const Node* a, const Node* b) {
+                     return completion_time_by_node[a] <
+                            completion_time_by_node[b];
+                   });
+  return OkStatus();
+}
+
+Status NewStaticScheduleExecutor(const LocalExecutorParams& params,
+                                 const Graph& graph,
+                                 std::unique_ptr<Executor>* executor) {
+  Executor* ret;
+  if (!CanScheduleStatically(params, graph)) {
+    VLOG(1) << "Graph can't be scheduled statically, using the default "
+               "executor";
+    TF_RETURN_IF_ERROR(NewLocalExecutor(params, graph, &ret));
+    executor->reset(ret);
+    return OkStatus();
+  }
+
+  std::vector<Node*> schedule;
+  Status status = ComputeStaticSchedule(params, graph, &schedule);
+  if (!status.ok()) {
+    // The single-threaded executor falls back to the reverse post-order.
+    VLOG(1) << "Failed to compute a static schedule: " << status;
+    schedule.clear();
+  }
+  TF_RETURN_IF_ERROR(
+      NewSingleThreadedExecutor(params, graph, schedule, &ret));
+  executor->reset(ret);
+  return OkStatus();
+}
+
+namespace {
+
+class StaticScheduleExecutorRegistrar {
+ public:
+  StaticScheduleExecutorRegistrar() {
+    ExecutorFactory::Register("STATIC_SCHEDULE_EXECUTOR", new Factory());
+  }
+
+ private:
+  class Factory : public ExecutorFactory {
+    Status NewExecutor(const LocalExecutorParams& params, const Graph& graph,
+                       std::unique_ptr<Executor>* out_executor) override {
+      return NewStaticScheduleExecutor(params, graph, out_executor);
+    }
+  };
+};
+static StaticScheduleExecutorRegistrar registrar;
+
+}  // namespace
+
+}  // namespace tensorflow
@@ -0,0 +1,59 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_STATIC_SCHEDULE_EXECUTOR_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_STATIC_SCHEDULE_EXECUTOR_H_
+
+#include <memory>
+#include <vector>
+
+#include "tensorflow/core/common_runtime/executor.h"
+#include "tensorflow/core/common_runtime/local_executor_params.h"
+#include "tensorflow/core/graph/graph.h"
+
+namespace tensorflow {
+
+// Creates a new `Executor` that executes `graph` following a schedule computed
+// ahead of time: the kernels run on the caller thread, in the order of the
+// completion times estimated by the grappler cost model (see
+// grappler/optimizers/static_schedule.h). All scheduling decisions are taken
+// when the executor is created, so that the execution of a step doesn't pay for
+// the pending-count bookkeeping and the thread hops of the default executor.
+// This mostly benefits small graphs on CPU, which are dominated by this
+// overhead.
+//
+// Only fully static graphs can be scheduled this way, i.e. the graphs that the
+// single-threaded executor supports on a CPU device (see
+// single_threaded_executor.h). Other graphs are executed by the default
+// executor.
+//
+// This executor is registered as "STATIC_SCHEDULE_EXECUTOR", and can be
+// selected with ConfigProto.Experimental.executor_type.
+Status NewStaticScheduleExecutor(const LocalExecutorParams& params,
+                                 const Graph& graph,
+                                 std::unique_ptr<Executor>* executor);
+
+// Returns true if `graph` can be executed with a static schedule.
+bool CanScheduleStatically(const LocalExecutorParams& params,
+                           const Graph& graph);
+
+// Computes the order in which the static schedule executor runs the nodes of
+// `graph`, including its source and sink nodes.
+Status ComputeStaticSchedule(const LocalExecutorParams& params,
+                             const Graph& graph, std::vector<Node*>* schedule);
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_STATIC_SCHEDULE_EXECUTOR_H_
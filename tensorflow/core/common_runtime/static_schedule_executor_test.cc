@@ -0,0 +1,129 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/static_schedule_executor.h"
+
+#include <memory>
+#include <vector>
+
+#include "tensorflow/core/common_runtime/device.h"
+#include "tensorflow/core/common_runtime/device_factory.h"
+#include "tensorflow/core/common_runtime/executor.h"
+#include "tensorflow/core/common_runtime/executor_factory.h"
+#include "tensorflow/core/framework/function.h"
+#include "tensorflow/core/framework/op.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/graph/algorithm.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/graph/testlib.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/public/version.h"
+
+namespace tensorflow {
+namespace {
+
+class StaticScheduleExecutorTest : public ::testing::Test {
+ protected:
+  StaticScheduleExecutorTest()
+      : device_(DeviceFactory::NewDevice("CPU", {},
+                                         "/job:localhost/replica:0/task:0")) {
+    params_.device = device_.get();
+    params_.create_kernel =
+        [this](const std::shared_ptr<const NodeProperties>& props,
+               OpKernel** kernel) {
+          return CreateNonCachedKernel(device_.get(), nullptr, props,
+                                       TF_GRAPH_DEF_VERSION, kernel);
+        };
+    params_.delete_kernel = [](OpKernel* kernel) {
+      DeleteNonCachedKernel(kernel);
+    };
+  }
+
+  std::unique_ptr<Device> device_;
+  LocalExecutorParams params_;
+};
+
+Tensor V(float val) {
+  Tensor tensor(DT_FLOAT, TensorShape({}));
+  tensor.scalar<float>()() = val;
+  return tensor;
+}
+
+// out = (a + b) * -a
+std::unique_ptr<Graph> BuildGraph() {
+  auto g = std::make_unique<Graph>(OpRegistry::Global());
+  Node* a = test::graph::Arg(g.get(), 0, DT_FLOAT);
+  Node* b = test::graph::Arg(g.get(), 1, DT_FLOAT);
+  Node* sum = test::graph::Add(g.get(), a, b);
+  Node* neg = test::graph::Unary(g.get(), "Neg", a);
+  Node* mul = test::graph::Multi(g.get(), "Mul", {sum, neg});
+  test::graph::Retval(g.get(), 0, mul);
+  FixupSourceAndSinkEdges(g.get());
+  return g;
+}
+
+TEST_F(StaticScheduleExecutorTest, ScheduleIsTopological) {
+  std::unique_ptr<Graph> g = BuildGraph();
+  ASSERT_TRUE(CanScheduleStatically(params_, *g));
+  std::vector<Node*> schedule;
+  TF_ASSERT_OK(ComputeStaticSchedule(params_, *g, &schedule));
+  ASSERT_EQ(schedule.size(), static_cast<size_t>(g->num_nodes()));
+  EXPECT_TRUE(schedule.front()->IsSource());
+  EXPECT_TRUE(schedule.back()->IsSink());
+
+  std::vector<bool> scheduled(g->num_node_ids(), false);
+  for (const Node* n : schedule) {
+    for (const Edge* e : n->in_edges()) {
+      EXPECT_TRUE(scheduled[e->src()->id()])
+          << n->name() << " runs before " << e->src()->name();
+    }
+    scheduled[n->id()] = true;
+  }
+}
+
+TEST_F(StaticScheduleExecutorTest, Run) {
+  std::unique_ptr<Graph> g = BuildGraph();
+  std::unique_ptr<Executor> executor;
+  TF_ASSERT_OK(
+      NewExecutor("STATIC_SCHEDULE_EXECUTOR", params_, *g, &executor));
+  FunctionCallFrame call_frame({DT_FLOAT, DT_FLOAT}, {DT_FLOAT});
+  TF_ASSERT_OK(call_frame.SetArgs({V(1.0), V(2.0)}));
+  Executor::Args args;
+  args.call_frame = &call_frame;
+  args.runner = [](const std::function<void()>& fn) { fn(); };
+  TF_ASSERT_OK(executor->Run(args));
+  std::vector<Tensor> retvals;
+  TF_ASSERT_OK(call_frame.ConsumeRetvals(&retvals, false));
+  EXPECT_EQ(-3.0, retvals[0].scalar<float>()());
+}
+
+TEST_F(StaticScheduleExecutorTest, ControlFlowIsNotStatic) {
+  auto g = std::make_unique<Graph>(OpRegistry::Global());
+  Node* a = test::graph::Arg(g.get(), 0, DT_FLOAT);
+  Node* pred = test::graph::Arg(g.get(), 1, DT_BOOL);
+  Node* sw = test::graph::Switch(g.get(), a, pred);
+  test::graph::Retval(g.get(), 0, sw);
+  FixupSourceAndSinkEdges(g.get());
+  EXPECT_FALSE(CanScheduleStatically(params_, *g));
+
+  // The graph is executed by the default executor instead.
+  std::unique_ptr<Executor> executor;
+  TF_EXPECT_OK(NewStaticScheduleExecutor(params_, *g, &executor));
+  EXPECT_NE(executor, nullptr);
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -0,0 +1,213 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/pipeline_benchmark.h"
+
+#include <cstdint>
+#include <ctime>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/cleanup/cleanup.h"
+#include "absl/memory/memory.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "tensorflow/core/data/standalone.h"
+#include "tensorflow/core/framework/cancellation.h"
+#include "tensorflow/core/framework/model.h"
+#include "tensorflow/core/framework/model.pb.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/tsl/platform/cpu_info.h"
+#include "tensorflow/tsl/platform/env.h"
+#include "tensorflow/tsl/platform/errors.h"
+#include "tensorflow/tsl/platform/logging.h"
+#include "tensorflow/tsl/platform/mem.h"
+#include "tensorflow/tsl/platform/status.h"
+#include "tensorflow/tsl/platform/statusor.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+// Same as the RAM budget of the autotuning in `ModelDatasetOp`.
+constexpr double kRamBudgetShare = 0.5;
+
+using ::tensorflow::data::model::ModelProto;
+
+constexpr int64_t kUnlimitedElements = std::numeric_limits<int64_t>::max();
+
+// Produces up to `num_elements` elements. Returns the number of elements
+// produced.
+tsl::StatusOr<int64_t> GetElements(standalone::Iterator& iterator,
+                                   int64_t num_elements) {
+  int64_t num_produced = 0;
+  bool end_of_input = false;
+  while (num_produced < num_elements) {
+    std::vector<Tensor> element;
+    TF_RETURN_IF_ERROR(iterator.GetNext(&element, &end_of_input));
+    if (end_of_input) {
+      break;
+    }
+    ++num_produced;
+  }
+  return num_produced;
+}
+
+tsl::StatusOr<ModelProto> ModelSnapshot(model::Model& model) {
+  ModelProto model_proto;
+  if (model.output() != nullptr) {
+    TF_RETURN_IF_ERROR(model.ToProto(&model_proto));
+  }
+  return model_proto;
+}
+
+// Adds the stats of the node `node_id` and its inputs to `stages`, from the
+// model snapshots at the `start` and the `end` of the measurement.
+void AddStages(const ModelProto& start, const ModelProto& end,
+               int64_t node_id, int64_t depth, double wall_time_seconds,
+               std::vector<PipelineStageStats>& stages) {
+  auto node_it = end.nodes().find(node_id);
+  if (node_it == end.nodes().end()) {
+    return;
+  }
+  const ModelProto::Node& node = node_it->second;
+  int64_t start_num_elements = 0;
+  int64_t start_processing_time = 0;
+  if (auto start_it = start.nodes().find(node_id);
+      start_it != start.nodes().end()) {
+    start_num_elements = start_it->second.num_elements();
+    start_processing_time = start_it->second.processing_time();
+  }
+
+  PipelineStageStats stage;
+  stage.name = absl::StrCat(node.name(), "(id:", node.id(), ")");
+  stage.depth = depth;
+  stage.num_elements = node.num_elements() - start_num_elements;
+  if (wall_time_seconds > 0) {
+    stage.elements_per_second = stage.num_elements / wall_time_seconds;
+  }
+  // Processing times are recorded in nanoseconds.
+  stage.processing_time_seconds =
+      (node.processing_time() - start_processing_time) / 1e9;
+  stage.buffered_elements = node.buffered_elements();
+  for (const ModelProto::Node::Parameter& parameter : node.parameters()) {
+    if (parameter.name() == model::kBufferSize) {
+      stage.buffer_size = parameter.value();
+    }
+  }
+  stages.push_back(stage);
+  for (int64_t input : node.inputs()) {
+    AddStages(start, end, input, depth + 1, wall_time_seconds, stages);
+  }
+}
+
+}  // namespace
+
+tsl::StatusOr<PipelineBenchmarkResult> RunPipelineBenchmark(
+    const GraphDef& graph_def, const PipelineBenchmarkOptions& options) {
+  standalone::Dataset::Params params;
+  params.session_options.config.set_inter_op_parallelism_threads(
+      options.inter_op_parallelism_threads);
+  params.session_options.config.set_intra_op_parallelism_threads(
+      options.intra_op_parallelism_threads);
+  std::unique_ptr<standalone::Dataset> dataset;
+  TF_RETURN_IF_ERROR(
+      standalone::Dataset::FromGraph(params, graph_def, &dataset));
+  auto pipeline_model = std::make_shared<model::Model>();
+  std::unique_ptr<standalone::Iterator> iterator;
+  TF_RETURN_IF_ERROR(
+      dataset->MakeIterator(/*split_providers=*/{}, pipeline_model, &iterator));
+
+  // The iterator records its performance in `model` instead of the model of
+  // the dataset, so the autotuning runs on `pipeline_model`.
+  CancellationManager cancellation_manager;
+  std::unique_ptr<Thread> optimization_thread;
+  if (options.autotune) {
+    optimization_thread = absl::WrapUnique(Env::Default()->StartThread(
+        /*thread_options=*/{}, /*name=*/"tf_data_pipeline_benchmark_model",
+        [&pipeline_model, &cancellation_manager]() {
+          Status status = pipeline_model->OptimizeLoop(
+              model::AutotuneAlgorithm::DEFAULT, tsl::port::MaxParallelism(),
+              static_cast<int64_t>(kRamBudgetShare * tsl::port::AvailableRam()),
+              &cancellation_manager);
+          if (!status.ok()) {
+            LOG(WARNING) << "Optimization loop failed: " << status;
+          }
+        }));
+  }
+  absl::Cleanup stop_optimization = [&cancellation_manager,
+                                     &optimization_thread]() {
+    cancellation_manager.StartCancel();
+    optimization_thread.reset();
+  };
+
+  if (options.num_warmup_elements > 0) {
+    TF_RETURN_IF_ERROR(
+        GetElements(*iterator, options.num_warmup_elements).status());
+  }
+  TF_ASSIGN_OR_RETURN(ModelProto start_model,
+                      ModelSnapshot(*pipeline_model));
+  const uint64_t start_micros = Env::Default()->NowMicros();
+  const std::clock_t start_cpu_time = std::clock();
+
+  PipelineBenchmarkResult result;
+  TF_ASSIGN_OR_RETURN(result.num_elements,
+                      GetElements(*iterator, options.num_elements > 0
+                                                 ? options.num_elements
+                                                 : kUnlimitedElements));
+
+  result.cpu_time_seconds =
+      static_cast<double>(std::clock() - start_cpu_time) / CLOCKS_PER_SEC;
+  result.wall_time_seconds =
+      (Env::Default()->NowMicros() - start_micros) / 1e6;
+  if (result.wall_time_seconds > 0) {
+    result.elements_per_second =
+        result.num_elements / result.wall_time_seconds;
+  }
+  TF_ASSIGN_OR_RETURN(ModelProto end_model,
+                      ModelSnapshot(*pipeline_model));
+  if (!end_model.nodes().empty()) {
+    AddStages(start_model, end_model, end_model.output(), /*depth=*/0,
+              result.wall_time_seconds, result.stages);
+  }
+  return result;
+}
+
+std::string PipelineBenchmarkResultString(
+    const PipelineBenchmarkResult& result) {
+  std::string str = absl::StrFormat(
+      "Produced %d elements in %.3fs: %.1f elements/s, %.3fs CPU time.\n",
+      result.num_elements, result.wall_time_seconds,
+      result.elements_per_second, result.cpu_time_seconds);
+  absl::StrAppendFormat(&str, "%-48s %12s %14s %14s %10s %12s\n", "Iterator",
+                        "Elements", "Elements/s", "Self time (s)", "Buffered",
+                        "Buffer size");
+  for (const PipelineStageStats& stage : result.stages) {
+    std::string buffer_size =
+        stage.buffer_size.has_value()
+            ? absl::StrFormat("%.0f", *stage.buffer_size)
+            : "-";
+    absl::StrAppendFormat(
+        &str, "%-48s %12d %14.1f %14.3f %10d %12s\n",
+        absl::StrCat(std::string(2 * stage.depth, ' '), stage.name),
+        stage.num_elements, stage.elements_per_second,
+        stage.processing_time_seconds, stage.buffered_elements, buffer_size);
+  }
+  return str;
+}
+
+}  // namespace data
+}  // namespace tensorflow
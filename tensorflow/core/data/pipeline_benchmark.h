@@ -0,0 +1,85 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_DATA_PIPELINE_BENCHMARK_H_
+#define TENSORFLOW_CORE_DATA_PIPELINE_BENCHMARK_H_
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/framework/graph.pb.h"
+#include "tensorflow/tsl/platform/statusor.h"
+
+namespace tensorflow {
+namespace data {
+
+// Runs a serialized tf.data pipeline outside a session with the standalone
+// API, and breaks its performance down by iterator with the autotuning model.
+
+struct PipelineBenchmarkOptions {
+  // The number of elements to measure. If 0, the pipeline runs to the end of
+  // its input.
+  int64_t num_elements = 0;
+  // The number of elements produced before the measurement starts.
+  int64_t num_warmup_elements = 0;
+  // The size of the inter-op and intra-op thread pools. If 0, they are sized
+  // by the runtime.
+  int32_t inter_op_parallelism_threads = 0;
+  int32_t intra_op_parallelism_threads = 0;
+  // Whether to run the autotuning optimization during the benchmark.
+  bool autotune = true;
+};
+
+// The performance of one iterator of the pipeline, over the measurement.
+struct PipelineStageStats {
+  // The name of the iterator model node, e.g. "ParallelMapV2(id:3)".
+  std::string name;
+  // The distance to the output iterator of the pipeline.
+  int64_t depth = 0;
+  int64_t num_elements = 0;
+  double elements_per_second = 0.0;
+  // The time spent in this iterator, excluding its inputs, summed over all
+  // the threads it runs on.
+  double processing_time_seconds = 0.0;
+  // The number of buffered elements at the end of the measurement.
+  int64_t buffered_elements = 0;
+  // The buffer size of buffered iterators, e.g. prefetch.
+  std::optional<double> buffer_size;
+};
+
+struct PipelineBenchmarkResult {
+  int64_t num_elements = 0;
+  double wall_time_seconds = 0.0;
+  double elements_per_second = 0.0;
+  // The CPU time of the process during the measurement.
+  double cpu_time_seconds = 0.0;
+  // The iterators of the pipeline, from its output.
+  std::vector<PipelineStageStats> stages;
+};
+
+// Benchmarks the dataset produced by `graph_def`, which has the format of
+// serialized datasets: its `_Retval` node returns the dataset variant.
+tsl::StatusOr<PipelineBenchmarkResult> RunPipelineBenchmark(
+    const GraphDef& graph_def, const PipelineBenchmarkOptions& options);
+
+// Returns a human-readable table of `result`.
+std::string PipelineBenchmarkResultString(
+    const PipelineBenchmarkResult& result);
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DATA_PIPELINE_BENCHMARK_H_
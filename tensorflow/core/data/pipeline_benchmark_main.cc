@@ -0,0 +1,94 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Benchmarks a serialized tf.data pipeline, and prints its throughput and the
+// time spent in each of its iterators. For example:
+//
+//   run_pipeline_benchmark --graph=/tmp/dataset_graph.pb --num_elements=10000
+//
+// The graph is the serialized dataset graph, e.g. written by
+// `tf.io.write_file(path, dataset._as_serialized_graph())`.
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/data/pipeline_benchmark.h"
+#include "tensorflow/core/framework/graph.pb.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/init_main.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/util/command_line_flags.h"
+
+int main(int argc, char** argv) {
+  std::string graph;
+  int64_t num_elements = 0;
+  int64_t num_warmup_elements = 0;
+  int32_t inter_op_parallelism_threads = 0;
+  int32_t intra_op_parallelism_threads = 0;
+  bool autotune = true;
+  std::vector<tensorflow::Flag> flag_list = {
+      tensorflow::Flag("graph", &graph,
+                       "serialized dataset graph, in binary or text format"),
+      tensorflow::Flag("num_elements", &num_elements,
+                       "number of elements to measure, or 0 for all elements"),
+      tensorflow::Flag("num_warmup_elements", &num_warmup_elements,
+                       "number of elements produced before the measurement"),
+      tensorflow::Flag("inter_op_parallelism_threads",
+                       &inter_op_parallelism_threads,
+                       "size of the inter-op thread pool, or 0 for default"),
+      tensorflow::Flag("intra_op_parallelism_threads",
+                       &intra_op_parallelism_threads,
+                       "size of the intra-op thread pool, or 0 for default"),
+      tensorflow::Flag("autotune", &autotune,
+                       "whether to autotune the pipeline while it runs"),
+  };
+  std::string usage = tensorflow::Flags::Usage(argv[0], flag_list);
+  if (!tensorflow::Flags::Parse(&argc, argv, flag_list) || graph.empty()) {
+    LOG(ERROR) << usage;
+    return -1;
+  }
+  tensorflow::port::InitMain(argv[0], &argc, &argv);
+
+  tensorflow::GraphDef graph_def;
+  tensorflow::Env* env = tensorflow::Env::Default();
+  tensorflow::Status status =
+      tensorflow::ReadBinaryProto(env, graph, &graph_def);
+  if (!status.ok()) {
+    status = tensorflow::ReadTextProto(env, graph, &graph_def);
+  }
+  if (!status.ok()) {
+    LOG(ERROR) << "Failed to read the dataset graph " << graph << ": "
+               << status;
+    return -1;
+  }
+
+  tensorflow::data::PipelineBenchmarkOptions options;
+  options.num_elements = num_elements;
+  options.num_warmup_elements = num_warmup_elements;
+  options.inter_op_parallelism_threads = inter_op_parallelism_threads;
+  options.intra_op_parallelism_threads = intra_op_parallelism_threads;
+  options.autotune = autotune;
+  tsl::StatusOr<tensorflow::data::PipelineBenchmarkResult> result =
+      tensorflow::data::RunPipelineBenchmark(graph_def, options);
+  if (!result.ok()) {
+    LOG(ERROR) << "Failed to run the dataset: " << result.status();
+    return -1;
+  }
+  std::cout << tensorflow::data::PipelineBenchmarkResultString(*result);
+  return 0;
+}
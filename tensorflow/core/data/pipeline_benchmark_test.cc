@@ -0,0 +1,76 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/pipeline_benchmark.h"
+
+#include <string>
+
+#include "tensorflow/core/data/service/common.pb.h"
+#include "tensorflow/core/data/service/test_util.h"
+#include "tensorflow/core/framework/graph.pb.h"
+#include "tensorflow/tsl/lib/core/status_test_util.h"
+#include "tensorflow/tsl/platform/status_matchers.h"
+#include "tensorflow/tsl/platform/statusor.h"
+#include "tensorflow/tsl/platform/test.h"
+#include "tensorflow/tsl/protobuf/error_codes.pb.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+using ::testing::Contains;
+using ::testing::Field;
+using ::testing::HasSubstr;
+using ::testing::IsEmpty;
+using ::testing::Not;
+using ::tsl::testing::StatusIs;
+
+TEST(PipelineBenchmarkTest, RunToEndOfInput) {
+  PipelineBenchmarkOptions options;
+  options.autotune = false;
+  TF_ASSERT_OK_AND_ASSIGN(
+      PipelineBenchmarkResult result,
+      RunPipelineBenchmark(testing::RangeDataset(10).graph(), options));
+  EXPECT_EQ(result.num_elements, 10);
+  ASSERT_THAT(result.stages, Not(IsEmpty()));
+  EXPECT_EQ(result.stages[0].depth, 0);
+  EXPECT_EQ(result.stages[0].num_elements, 10);
+  EXPECT_THAT(result.stages,
+              Contains(Field(&PipelineStageStats::name, HasSubstr("Range"))));
+}
+
+TEST(PipelineBenchmarkTest, NumElements) {
+  PipelineBenchmarkOptions options;
+  options.num_elements = 5;
+  options.num_warmup_elements = 3;
+  options.inter_op_parallelism_threads = 2;
+  TF_ASSERT_OK_AND_ASSIGN(
+      PipelineBenchmarkResult result,
+      RunPipelineBenchmark(testing::RangeDataset(100).graph(), options));
+  EXPECT_EQ(result.num_elements, 5);
+  ASSERT_THAT(result.stages, Not(IsEmpty()));
+  // The warmup elements are not measured.
+  EXPECT_EQ(result.stages[0].num_elements, 5);
+  EXPECT_THAT(PipelineBenchmarkResultString(result),
+              HasSubstr("Produced 5 elements"));
+}
+
+TEST(PipelineBenchmarkTest, InvalidGraph) {
+  EXPECT_THAT(RunPipelineBenchmark(GraphDef(), PipelineBenchmarkOptions()),
+              StatusIs(error::NOT_FOUND));
+}
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
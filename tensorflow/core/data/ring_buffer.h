@@ -0,0 +1,148 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_DATA_RING_BUFFER_H_
+#define TENSORFLOW_CORE_DATA_RING_BUFFER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace tensorflow {
+namespace data {
+
+// A bounded, lock-free, multi-producer multi-consumer FIFO buffer.
+//
+// Elements are popped in the order in which they were pushed, which lets
+// asynchronous transformations hand their in-flight results from the
+// thread that schedules them to the consumer without a shared lock: the
+// scheduling thread pushes a result when it starts the corresponding call and
+// the consumer pops results in the same order, waiting for each one to
+// complete.
+//
+// Each slot carries a sequence number that tells producers and consumers
+// whether the slot is free for the current lap around the buffer, so that
+// `TryPush` and `TryPop` only contend on the (separate) push and pop
+// positions. `T` must be default constructible and movable.
+template <typename T>
+class RingBuffer {
+ public:
+  // Creates a buffer that holds up to `capacity` elements, rounded up to the
+  // next power of two.
+  explicit RingBuffer(size_t capacity)
+      : mask_(RoundUpToPowerOfTwo(capacity) - 1),
+        slots_(std::make_unique<Slot[]>(mask_ + 1)) {
+    for (size_t i = 0; i <= mask_; ++i) {
+      slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  RingBuffer(const RingBuffer&) = delete;
+  RingBuffer& operator=(const RingBuffer&) = delete;
+
+  // Appends `value` to the buffer. Returns false, leaving `value` intact, if
+  // the buffer is full.
+  bool TryPush(T&& value) {
+    size_t position = push_position_.load(std::memory_order_relaxed);
+    while (true) {
+      Slot& slot = slots_[position & mask_];
+      const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+      const ptrdiff_t diff = static_cast<ptrdiff_t>(sequence - position);
+      if (diff == 0) {
+        if (push_position_.compare_exchange_weak(position, position + 1,
+                                                 std::memory_order_relaxed)) {
+          slot.value = std::move(value);
+          slot.sequence.store(position + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        position = push_position_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Removes the element at the front of the buffer and stores it in `value`.
+  // Returns false if the buffer is empty.
+  bool TryPop(T* value) {
+    size_t position = pop_position_.load(std::memory_order_relaxed);
+    while (true) {
+      Slot& slot = slots_[position & mask_];
+      const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+      const ptrdiff_t diff = static_cast<ptrdiff_t>(sequence - (position + 1));
+      if (diff == 0) {
+        if (pop_position_.compare_exchange_weak(position, position + 1,
+                                                std::memory_order_relaxed)) {
+          *value = std::move(slot.value);
+          slot.value = T();
+          slot.sequence.store(position + mask_ + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        position = pop_position_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Returns the number of elements in the buffer. The result is exact if no
+  // push or pop is in progress; otherwise it is a snapshot that may already
+  // be stale.
+  size_t size() const {
+    const size_t pop_position = pop_position_.load(std::memory_order_acquire);
+    const size_t push_position = push_position_.load(std::memory_order_acquire);
+    return push_position > pop_position ? push_position - pop_position : 0;
+  }
+
+  bool empty() const { return size() == 0; }
+
+  size_t capacity() const { return mask_ + 1; }
+
+  // Returns the `index`-th element from the front of the buffer. Must not be
+  // called concurrently with `TryPush` or `TryPop`, e.g. it is meant for
+  // checkpointing a quiescent buffer.
+  const T& at(size_t index) const {
+    return slots_[(pop_position_.load(std::memory_order_relaxed) + index) &
+                  mask_]
+        .value;
+  }
+
+ private:
+  // Avoids false sharing between the push and pop positions.
+  static constexpr size_t kCacheLineSize = 64;
+
+  struct Slot {
+    std::atomic<size_t> sequence;
+    T value;
+  };
+
+  static size_t RoundUpToPowerOfTwo(size_t n) {
+    size_t result = 1;
+    while (result < n) result <<= 1;
+    return result;
+  }
+
+  const size_t mask_;
+  const std::unique_ptr<Slot[]> slots_;
+  alignas(kCacheLineSize) std::atomic<size_t> push_position_{0};
+  alignas(kCacheLineSize) std::atomic<size_t> pop_position_{0};
+};
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DATA_RING_BUFFER_H_
@@ -0,0 +1,122 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/ring_buffer.h"
+
+#include <memory>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+TEST(RingBufferTest, Capacity) {
+  EXPECT_EQ(RingBuffer<int>(1).capacity(), 1);
+  EXPECT_EQ(RingBuffer<int>(5).capacity(), 8);
+  EXPECT_EQ(RingBuffer<int>(64).capacity(), 64);
+}
+
+TEST(RingBufferTest, PushAndPopInOrder) {
+  RingBuffer<std::shared_ptr<int>> buffer(4);
+  int value = 0;
+  // Go around the buffer several times.
+  for (int lap = 0; lap < 3; ++lap) {
+    for (int i = 0; i < 3; ++i) {
+      EXPECT_TRUE(buffer.TryPush(std::make_shared<int>(value + i)));
+    }
+    EXPECT_EQ(buffer.size(), 3);
+    EXPECT_EQ(*buffer.at(1), value + 1);
+    for (int i = 0; i < 3; ++i) {
+      std::shared_ptr<int> result;
+      ASSERT_TRUE(buffer.TryPop(&result));
+      EXPECT_EQ(*result, value + i);
+    }
+    EXPECT_TRUE(buffer.empty());
+    value += 3;
+  }
+}
+
+TEST(RingBufferTest, Full) {
+  RingBuffer<int> buffer(2);
+  EXPECT_TRUE(buffer.TryPush(1));
+  EXPECT_TRUE(buffer.TryPush(2));
+  int value = 3;
+  EXPECT_FALSE(buffer.TryPush(std::move(value)));
+  EXPECT_EQ(value, 3);
+  int result;
+  ASSERT_TRUE(buffer.TryPop(&result));
+  EXPECT_EQ(result, 1);
+  EXPECT_TRUE(buffer.TryPush(std::move(value)));
+}
+
+TEST(RingBufferTest, Empty) {
+  RingBuffer<int> buffer(2);
+  int result = -1;
+  EXPECT_FALSE(buffer.TryPop(&result));
+  EXPECT_EQ(result, -1);
+}
+
+TEST(RingBufferTest, ConcurrentProducersAndConsumers) {
+  constexpr int kNumThreads = 4;
+  constexpr int kNumElementsPerThread = 10000;
+  RingBuffer<int> buffer(16);
+  std::vector<std::vector<int>> popped(kNumThreads);
+  {
+    std::vector<std::unique_ptr<Thread>> threads;
+    for (int i = 0; i < kNumThreads; ++i) {
+      threads.emplace_back(Env::Default()->StartThread(
+          ThreadOptions(), "producer", [i, &buffer]() {
+            for (int j = 0; j < kNumElementsPerThread; ++j) {
+              while (!buffer.TryPush(i * kNumElementsPerThread + j)) {
+                std::this_thread::yield();
+              }
+            }
+          }));
+      threads.emplace_back(Env::Default()->StartThread(
+          ThreadOptions(), "consumer", [i, &buffer, &popped]() {
+            while (popped[i].size() < kNumElementsPerThread) {
+              int value;
+              if (buffer.TryPop(&value)) {
+                popped[i].push_back(value);
+              } else {
+                std::this_thread::yield();
+              }
+            }
+          }));
+    }
+  }
+  EXPECT_TRUE(buffer.empty());
+
+  // Every element is popped exactly once, and each consumer observes the
+  // elements of each producer in the order in which they were pushed.
+  std::vector<int> counts(kNumThreads * kNumElementsPerThread, 0);
+  for (const std::vector<int>& values : popped) {
+    std::vector<int> last(kNumThreads, -1);
+    for (int value : values) {
+      ++counts[value];
+      const int producer = value / kNumElementsPerThread;
+      EXPECT_GT(value, last[producer]);
+      last[producer] = value;
+    }
+  }
+  for (int count : counts) EXPECT_EQ(count, 1);
+}
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
@@ -0,0 +1,145 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/service/auto_scaler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/time/time.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+mutex* GetWorkerCountHooksLock() {
+  static mutex* mu = new mutex;
+  return mu;
+}
+
+std::vector<WorkerCountHook>* GetWorkerCountHooks()
+    TF_EXCLUSIVE_LOCKS_REQUIRED(*GetWorkerCountHooksLock()) {
+  static std::vector<WorkerCountHook>* hooks =
+      new std::vector<WorkerCountHook>;
+  return hooks;
+}
+
+}  // namespace
+
+AutoScaler::AutoScaler(const Options& options) : options_(options) {
+  DCHECK_GE(options_.target_buffer_occupancy, 0.0);
+  DCHECK_LT(options_.target_buffer_occupancy, 1.0);
+}
+
+void AutoScaler::ReportClientWaitTime(int64_t job_id,
+                                      int64_t iteration_client_id,
+                                      absl::Duration wait_time)
+    TF_LOCKS_EXCLUDED(mu_) {
+  mutex_lock l(mu_);
+  job_reports_[job_id].client_wait_times[iteration_client_id] = wait_time;
+}
+
+void AutoScaler::ReportBufferOccupancy(int64_t job_id,
+                                       const std::string& worker_address,
+                                       double occupancy)
+    TF_LOCKS_EXCLUDED(mu_) {
+  mutex_lock l(mu_);
+  job_reports_[job_id].buffer_occupancies[worker_address] =
+      std::clamp(occupancy, 0.0, 1.0);
+}
+
+void AutoScaler::RemoveClient(int64_t iteration_client_id)
+    TF_LOCKS_EXCLUDED(mu_) {
+  mutex_lock l(mu_);
+  for (auto& [job_id, reports] : job_reports_) {
+    reports.client_wait_times.erase(iteration_client_id);
+  }
+}
+
+void AutoScaler::RemoveWorker(const std::string& worker_address)
+    TF_LOCKS_EXCLUDED(mu_) {
+  mutex_lock l(mu_);
+  for (auto& [job_id, reports] : job_reports_) {
+    reports.buffer_occupancies.erase(worker_address);
+  }
+}
+
+void AutoScaler::RemoveJob(int64_t job_id) TF_LOCKS_EXCLUDED(mu_) {
+  mutex_lock l(mu_);
+  job_reports_.erase(job_id);
+}
+
+absl::flat_hash_map<int64_t, int64_t> AutoScaler::GetRecommendedNumWorkers()
+    const TF_LOCKS_EXCLUDED(mu_) {
+  mutex_lock l(mu_);
+  absl::flat_hash_map<int64_t, int64_t> recommended_num_workers;
+  for (const auto& [job_id, reports] : job_reports_) {
+    if (reports.client_wait_times.empty() ||
+        reports.buffer_occupancies.empty()) {
+      continue;
+    }
+    recommended_num_workers[job_id] = GetRecommendedNumWorkers(reports);
+  }
+  return recommended_num_workers;
+}
+
+int64_t AutoScaler::GetRecommendedNumWorkers(const JobReports& reports) const {
+  absl::Duration total_wait_time;
+  for (const auto& [client_id, wait_time] : reports.client_wait_times) {
+    total_wait_time += wait_time;
+  }
+  double total_occupancy = 0.0;
+  for (const auto& [worker_address, occupancy] : reports.buffer_occupancies) {
+    total_occupancy += occupancy;
+  }
+  const int64_t num_workers = reports.buffer_occupancies.size();
+  const absl::Duration wait_time =
+      total_wait_time / static_cast<int64_t>(reports.client_wait_times.size());
+  const double occupancy = total_occupancy / num_workers;
+
+  // The number of workers that would keep the buffers at the target
+  // occupancy if the consumption rate does not change.
+  const int64_t target_num_workers = static_cast<int64_t>(
+      std::ceil(num_workers * (1.0 - occupancy) /
+                (1.0 - options_.target_buffer_occupancy)));
+  if (wait_time > options_.max_client_wait_time) {
+    return std::max(num_workers + 1, target_num_workers);
+  }
+  if (occupancy > options_.target_buffer_occupancy) {
+    return std::max<int64_t>(target_num_workers, 1);
+  }
+  return num_workers;
+}
+
+void RegisterWorkerCountHook(WorkerCountHook hook) {
+  mutex_lock l(*GetWorkerCountHooksLock());
+  GetWorkerCountHooks()->push_back(std::move(hook));
+}
+
+void RunWorkerCountHooks(int64_t job_id, int64_t recommended_num_workers) {
+  mutex_lock l(*GetWorkerCountHooksLock());
+  for (const WorkerCountHook& hook : *GetWorkerCountHooks()) {
+    hook(job_id, recommended_num_workers);
+  }
+}
+
+}  // namespace data
+}  // namespace tensorflow
@@ -0,0 +1,108 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_DATA_SERVICE_AUTO_SCALER_H_
+#define TENSORFLOW_CORE_DATA_SERVICE_AUTO_SCALER_H_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/time/time.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+namespace data {
+
+// An `AutoScaler` recommends the number of workers of tf.data service jobs,
+// from the time the clients wait for elements and the occupancy of the worker
+// buffers.
+//
+// Clients that wait for elements while the buffers of the workers are not full
+// mean that the job needs more workers. When the clients don't wait and the
+// buffers are mostly full, the workers produce elements faster than they are
+// consumed, and the job can run on fewer workers.
+//
+// This class is thread-safe.
+class AutoScaler {
+ public:
+  struct Options {
+    // Clients that wait longer than this on average for an element are
+    // starved.
+    absl::Duration max_client_wait_time = absl::Milliseconds(1);
+    // The fraction of the worker buffers that the recommendations aim to keep
+    // full. Must be in [0, 1).
+    double target_buffer_occupancy = 0.5;
+  };
+
+  AutoScaler() : AutoScaler(Options()) {}
+  explicit AutoScaler(const Options& options);
+
+  // Reports the average time the client with id `iteration_client_id` waited
+  // for an element of job `job_id` since its previous report.
+  void ReportClientWaitTime(int64_t job_id, int64_t iteration_client_id,
+                            absl::Duration wait_time);
+
+  // Reports the fraction of the buffer of the task of job `job_id` on worker
+  // `worker_address` that is full.
+  void ReportBufferOccupancy(int64_t job_id, const std::string& worker_address,
+                             double occupancy);
+
+  // Drops the reports of the client with id `iteration_client_id`.
+  void RemoveClient(int64_t iteration_client_id);
+
+  // Drops the reports of the worker at `worker_address`.
+  void RemoveWorker(const std::string& worker_address);
+
+  // Drops the reports of job `job_id`.
+  void RemoveJob(int64_t job_id);
+
+  // Returns the recommended number of workers, keyed by job id, of the jobs
+  // that have reports from both their clients and their workers.
+  absl::flat_hash_map<int64_t, int64_t> GetRecommendedNumWorkers() const;
+
+ private:
+  struct JobReports {
+    absl::flat_hash_map<int64_t, absl::Duration> client_wait_times;
+    absl::flat_hash_map<std::string, double> buffer_occupancies;
+  };
+
+  // Returns the recommended number of workers from the reports of a job.
+  int64_t GetRecommendedNumWorkers(const JobReports& reports) const;
+
+  const Options options_;
+
+  mutable mutex mu_;
+  absl::flat_hash_map<int64_t, JobReports> job_reports_ TF_GUARDED_BY(mu_);
+};
+
+// A hook that is called with the recommended number of workers for a job.
+using WorkerCountHook =
+    std::function<void(int64_t job_id, int64_t recommended_num_workers)>;
+
+// Registers `hook`, which the dispatchers of the process periodically call
+// with the recommended number of workers of their jobs. This lets deployments
+// scale their tf.data service workers to what the jobs need. The hooks are
+// called without holding any dispatcher lock.
+void RegisterWorkerCountHook(WorkerCountHook hook);
+
+// Calls the registered hooks.
+void RunWorkerCountHooks(int64_t job_id, int64_t recommended_num_workers);
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DATA_SERVICE_AUTO_SCALER_H_
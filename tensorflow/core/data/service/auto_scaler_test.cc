@@ -0,0 +1,123 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/service/auto_scaler.h"
+
+#include <cstdint>
+
+#include "absl/strings/str_cat.h"
+#include "absl/time/time.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+using ::testing::Pair;
+using ::testing::UnorderedElementsAre;
+
+TEST(AutoScalerTest, NoReports) {
+  AutoScaler auto_scaler;
+  EXPECT_TRUE(auto_scaler.GetRecommendedNumWorkers().empty());
+}
+
+TEST(AutoScalerTest, RequiresClientAndWorkerReports) {
+  AutoScaler auto_scaler;
+  auto_scaler.ReportClientWaitTime(/*job_id=*/0, /*iteration_client_id=*/0,
+                                   absl::Seconds(1));
+  auto_scaler.ReportBufferOccupancy(/*job_id=*/1, "/worker/0",
+                                    /*occupancy=*/0.0);
+  EXPECT_TRUE(auto_scaler.GetRecommendedNumWorkers().empty());
+}
+
+TEST(AutoScalerTest, ScaleUpWhenClientsWait) {
+  AutoScaler auto_scaler;
+  auto_scaler.ReportClientWaitTime(/*job_id=*/0, /*iteration_client_id=*/0,
+                                   absl::Milliseconds(10));
+  auto_scaler.ReportBufferOccupancy(/*job_id=*/0, "/worker/0",
+                                    /*occupancy=*/0.0);
+  auto_scaler.ReportBufferOccupancy(/*job_id=*/0, "/worker/1",
+                                    /*occupancy=*/0.0);
+  EXPECT_THAT(auto_scaler.GetRecommendedNumWorkers(),
+              UnorderedElementsAre(Pair(0, 4)));
+}
+
+TEST(AutoScalerTest, ScaleUpByOneWorkerWhenBuffersAreFull) {
+  AutoScaler auto_scaler;
+  auto_scaler.ReportClientWaitTime(/*job_id=*/0, /*iteration_client_id=*/0,
+                                   absl::Milliseconds(10));
+  auto_scaler.ReportBufferOccupancy(/*job_id=*/0, "/worker/0",
+                                    /*occupancy=*/0.9);
+  EXPECT_THAT(auto_scaler.GetRecommendedNumWorkers(),
+              UnorderedElementsAre(Pair(0, 2)));
+}
+
+TEST(AutoScalerTest, ScaleDownWhenBuffersAreFull) {
+  AutoScaler auto_scaler;
+  auto_scaler.ReportClientWaitTime(/*job_id=*/0, /*iteration_client_id=*/0,
+                                   absl::ZeroDuration());
+  for (int i = 0; i < 4; ++i) {
+    auto_scaler.ReportBufferOccupancy(/*job_id=*/0, absl::StrCat("/worker/", i),
+                                      /*occupancy=*/0.75);
+  }
+  EXPECT_THAT(auto_scaler.GetRecommendedNumWorkers(),
+              UnorderedElementsAre(Pair(0, 2)));
+}
+
+TEST(AutoScalerTest, KeepWorkers) {
+  AutoScaler auto_scaler;
+  auto_scaler.ReportClientWaitTime(/*job_id=*/0, /*iteration_client_id=*/0,
+                                   absl::ZeroDuration());
+  auto_scaler.ReportBufferOccupancy(/*job_id=*/0, "/worker/0",
+                                    /*occupancy=*/0.5);
+  auto_scaler.ReportBufferOccupancy(/*job_id=*/0, "/worker/1",
+                                    /*occupancy=*/0.2);
+  EXPECT_THAT(auto_scaler.GetRecommendedNumWorkers(),
+              UnorderedElementsAre(Pair(0, 2)));
+}
+
+TEST(AutoScalerTest, RemoveReports) {
+  AutoScaler auto_scaler;
+  for (int64_t job_id : {0, 1}) {
+    auto_scaler.ReportClientWaitTime(job_id, /*iteration_client_id=*/job_id,
+                                     absl::ZeroDuration());
+    auto_scaler.ReportBufferOccupancy(job_id, "/worker/0", /*occupancy=*/0.5);
+    auto_scaler.ReportBufferOccupancy(job_id, "/worker/1", /*occupancy=*/0.5);
+  }
+  auto_scaler.RemoveWorker("/worker/1");
+  EXPECT_THAT(auto_scaler.GetRecommendedNumWorkers(),
+              UnorderedElementsAre(Pair(0, 1), Pair(1, 1)));
+  auto_scaler.RemoveClient(/*iteration_client_id=*/0);
+  EXPECT_THAT(auto_scaler.GetRecommendedNumWorkers(),
+              UnorderedElementsAre(Pair(1, 1)));
+  auto_scaler.RemoveJob(/*job_id=*/1);
+  EXPECT_TRUE(auto_scaler.GetRecommendedNumWorkers().empty());
+}
+
+TEST(AutoScalerTest, WorkerCountHooks) {
+  int64_t hook_job_id = -1;
+  int64_t hook_num_workers = -1;
+  RegisterWorkerCountHook(
+      [&](int64_t job_id, int64_t recommended_num_workers) {
+        hook_job_id = job_id;
+        hook_num_workers = recommended_num_workers;
+      });
+  RunWorkerCountHooks(/*job_id=*/3, /*recommended_num_workers=*/5);
+  EXPECT_EQ(hook_job_id, 3);
+  EXPECT_EQ(hook_num_workers, 5);
+}
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
@@ -15,6 +15,7 @@ limitations under the License.
 #include "tensorflow/core/data/service/client/data_service_client.h"
 
 #include <algorithm>
+#include <cstdlib>
 #include <functional>
 #include <limits>
 #include <memory>
@@ -27,6 +28,7 @@ limitations under the License.
 #include "absl/algorithm/container.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
 #include "absl/strings/substitute.h"
 #include "absl/time/time.h"
 #include "tensorflow/core/data/service/client/common.h"
@@ -61,6 +63,22 @@ bool IsColocatedTask(const TaskInfo& task) {
   });
 }
 
+// Returns the rack of the worker of `task`, or an empty string if the worker
+// doesn't have a rack tag.
+std::string GetWorkerRack(const TaskInfo& task) {
+  for (const std::string& worker_tag : task.worker_tags()) {
+    if (absl::StartsWithIgnoreCase(worker_tag, kRackWorkerTagPrefix)) {
+      return worker_tag.substr(kRackWorkerTagPrefix.size());
+    }
+  }
+  return "";
+}
+
+std::string GetClientRack() {
+  const char* rack = std::getenv("TF_DATA_SERVICE_CLIENT_RACK");
+  return rack == nullptr ? "" : rack;
+}
+
 StatusOr<DataTransferServerInfo> GetTransferServer(const std::string& protocol,
                                                    const TaskInfo& task_info) {
   for (const auto& transfer_server : task_info.transfer_servers()) {
@@ -77,6 +95,7 @@ StatusOr<DataTransferServerInfo> GetTransferServer(const std::string& protocol,
 
 DataServiceClient::DataServiceClient(const DataServiceParams& params)
     : params_(params),
+      rack_(GetClientRack()),
       max_outstanding_requests_(params.max_outstanding_requests) {}
 
 DataServiceClient::~DataServiceClient() {
@@ -135,6 +154,7 @@ Status DataServiceClient::Initialize() {
 StatusOr<GetNextResult> DataServiceClient::GetNext(
     DataServiceContextFactory context_factory) TF_LOCKS_EXCLUDED(mu_) {
   VLOG(3) << "Getting the next element from tf.data service client.";
+  const int64_t start_micros = Env::Default()->NowMicros();
   mutex_lock l(mu_);
   if (ctx_ == nullptr) {
     ctx_ = context_factory();
@@ -182,6 +202,8 @@ StatusOr<GetNextResult> DataServiceClient::GetNext(
     VLOG(1) << "Consumer " << *params_.consumer_index << ": Result "
             << get_next_index_++;
   }
+  wait_time_usec_since_heartbeat_ += Env::Default()->NowMicros() - start_micros;
+  ++num_elements_since_heartbeat_;
   next.tensors.swap(result->element);
   return next;
 }
@@ -414,12 +436,22 @@ Status DataServiceClient::AddTask(const TaskInfo& task_info)
 void DataServiceClient::Heartbeat() TF_LOCKS_EXCLUDED(mu_) {
   ClientHeartbeatRequest req;
   req.set_iteration_client_id(iteration_client_id_);
-  if (IsCoordinatedRead()) {
+  {
     mutex_lock l(mu_);
-    req.set_current_round(current_round_);
-    if (round_robin_round_limit_.has_value()) {
-      req.set_blocked_round(round_robin_round_limit_.value());
+    if (IsCoordinatedRead()) {
+      req.set_current_round(current_round_);
+      if (round_robin_round_limit_.has_value()) {
+        req.set_blocked_round(round_robin_round_limit_.value());
+      }
     }
+    // Reports the average wait time so the dispatcher can recommend the
+    // number of workers.
+    if (num_elements_since_heartbeat_ > 0) {
+      req.set_wait_time_usec(wait_time_usec_since_heartbeat_ /
+                             num_elements_since_heartbeat_);
+    }
+    wait_time_usec_since_heartbeat_ = 0;
+    num_elements_since_heartbeat_ = 0;
   }
   ClientHeartbeatResponse resp;
   Status s = dispatcher_->ClientHeartbeat(req, resp);
@@ -480,12 +512,17 @@ void DataServiceClient::UpdateTasks(const ClientHeartbeatResponse& resp)
       }
     }
   }
+  const bool has_same_rack_tasks =
+      !rack_.empty() &&
+      absl::c_any_of(resp.task_info(), [this](const TaskInfo& task) {
+        return GetWorkerRack(task) == rack_;
+      });
   for (auto& task : resp.task_info()) {
     auto it = task_id_to_task.find(task.task_id());
     if (it == task_id_to_task.end()) {
       continue;
     }
-    if (!ShouldReadFromTask(task)) {
+    if (!ShouldReadFromTask(task, has_same_rack_tasks)) {
       VLOG(3) << "Skipping untargeted worker task " << task.task_id();
       should_finish_iteration_ = false;
       continue;
@@ -499,7 +536,8 @@ void DataServiceClient::UpdateTasks(const ClientHeartbeatResponse& resp)
   }
 }
 
-bool DataServiceClient::ShouldReadFromTask(const TaskInfo& task) const
+bool DataServiceClient::ShouldReadFromTask(const TaskInfo& task,
+                                           bool has_same_rack_tasks) const
     TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
   if (IsCoordinatedRead()) {
     return true;
@@ -517,6 +555,14 @@ bool DataServiceClient::ShouldReadFromTask(const TaskInfo& task) const
   if (params_.target_workers == TARGET_WORKERS_AUTO && is_cross_tf_host_read) {
     return false;
   }
+
+  // Cross-rack reads go through the network between racks. tf.data service
+  // avoids them if the rack of the client has workers.
+  const bool is_cross_rack_read =
+      !is_local_task && has_same_rack_tasks && GetWorkerRack(task) != rack_;
+  if (params_.target_workers == TARGET_WORKERS_AUTO && is_cross_rack_read) {
+    return false;
+  }
   return true;
 }
 
@@ -574,13 +620,14 @@ void DataServiceClient::RunWorkerThread(std::function<void()> done)
   });
   VLOG(1) << "Starting worker thread";
   std::shared_ptr<Task> task_to_process;
+  int64_t max_elements = 0;
   while (true) {
     std::shared_ptr<Result> result;
     {
       mutex_lock l(mu_);
       if (task_to_process) {
         task_to_process->in_use = false;
-        --outstanding_requests_;
+        outstanding_requests_ -= max_elements;
         task_to_process = nullptr;
         worker_thread_cv_.notify_one();
       }
@@ -598,7 +645,8 @@ void DataServiceClient::RunWorkerThread(std::function<void()> done)
       }
       DCHECK(task_to_process != nullptr);
       task_to_process->in_use = true;
-      ++outstanding_requests_;
+      max_elements = GetMaxElementsPerRequest();
+      outstanding_requests_ += max_elements;
       if (IsCoordinatedRead()) {
         // Reserve a spot in the results_ queue.
         results_.push(std::make_shared<Result>());
@@ -611,15 +659,15 @@ void DataServiceClient::RunWorkerThread(std::function<void()> done)
       VLOG(3) << "Processing task " << task_to_process->info.task_id();
     }
     int64_t deadline_micros = kint64max;
-    Status s =
-        GetElementTraced(task_to_process.get(), deadline_micros,
-                         /*enqueue_result=*/!IsCoordinatedRead(), result);
+    Status s = GetElementTraced(
+        task_to_process.get(), deadline_micros, max_elements,
+        /*enqueue_result=*/!IsCoordinatedRead(), result);
     if (!s.ok()) {
       mutex_lock l(mu_);
       VLOG(1) << "Failed to get element from worker "
               << task_to_process->info.worker_address() << ": " << s;
       task_to_process->in_use = false;
-      --outstanding_requests_;
+      outstanding_requests_ -= max_elements;
       status_ = errors::CreateWithUpdatedMessage(
           s, absl::StrCat("Failed to get element from worker ",
                           task_to_process->info.worker_address(), ": ",
@@ -692,8 +740,25 @@ void DataServiceClient::AdvanceTaskIndex() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
   }
 }
 
-Status DataServiceClient::TryGetElement(const Task& task,
-                                        GetElementResult& result) {
+int64_t DataServiceClient::GetMaxElementsPerRequest() const
+    TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+  // Round-robin reads fetch one element from each task per round.
+  if (IsCoordinatedRead()) {
+    return 1;
+  }
+  // Shares the available buffer space between the tasks, so that one task
+  // receiving a large batch does not starve the others.
+  const int64_t available_elements =
+      max_outstanding_requests_ - static_cast<int64_t>(results_.size()) -
+      outstanding_requests_;
+  const int64_t max_elements_per_task =
+      max_outstanding_requests_ / std::max<int64_t>(tasks_.size(), 1);
+  return std::max<int64_t>(
+      std::min(available_elements, max_elements_per_task), 1);
+}
+
+Status DataServiceClient::TryGetElement(
+    Task& task, int64_t max_elements, std::vector<GetElementResult>& results) {
   GetElementRequest req;
   req.set_task_id(task.info.task_id());
   req.set_skipped_previous_round(task.skipped_previous_round);
@@ -705,35 +770,55 @@ Status DataServiceClient::TryGetElement(const Task& task,
   if (params_.cross_trainer_cache_options) {
     req.set_trainer_id(params_.cross_trainer_cache_options->trainer_id());
   }
-  return task.worker->GetElement(req, result);
+  if (max_elements > 1 && !task.get_elements_unimplemented) {
+    Status s = task.worker->GetElements(req, max_elements, results);
+    if (!errors::IsUnimplemented(s)) {
+      return s;
+    }
+    // Workers running older versions only serve one element per request.
+    VLOG(1) << "Worker " << task.info.worker_address()
+            << " does not support batched GetElements requests: " << s;
+    task.get_elements_unimplemented = true;
+  }
+  results.clear();
+  return task.worker->GetElement(req, results.emplace_back());
 }
 
 void DataServiceClient::ProcessGetElementResponse(
-    bool enqueue_result, GetElementResult& get_element_result,
+    bool enqueue_result, std::vector<GetElementResult>& get_element_results,
     std::shared_ptr<Result> result, Task& task) TF_LOCKS_EXCLUDED(mu_) {
   mutex_lock l(mu_);
-  result->ready = true;
-  result->end_of_sequence = get_element_result.end_of_sequence;
-  result->skip = get_element_result.skip;
-  if (!get_element_result.end_of_sequence && !get_element_result.skip) {
-    task.skipped_previous_round = false;
-    result->element = std::move(get_element_result.components);
-    result->element_index = get_element_result.element_index;
-    result->task_id = task.info.task_id();
-  } else if (get_element_result.skip) {
-    task.skipped_previous_round = true;
-  } else {
-    task.end_of_sequence = true;
-    finished_tasks_++;
-  }
-  if (enqueue_result && !result->end_of_sequence) {
-    ctx_->RecordBufferEnqueue(result->element);
-    results_.push(std::move(result));
+  for (GetElementResult& get_element_result : get_element_results) {
+    if (!result) {
+      // Batched requests are only sent when `enqueue_result` is true.
+      DCHECK(enqueue_result);
+      result = std::make_shared<Result>();
+    }
+    result->ready = true;
+    result->end_of_sequence = get_element_result.end_of_sequence;
+    result->skip = get_element_result.skip;
+    if (!get_element_result.end_of_sequence && !get_element_result.skip) {
+      task.skipped_previous_round = false;
+      result->element = std::move(get_element_result.components);
+      result->element_index = get_element_result.element_index;
+      result->task_id = task.info.task_id();
+    } else if (get_element_result.skip) {
+      task.skipped_previous_round = true;
+    } else {
+      task.end_of_sequence = true;
+      finished_tasks_++;
+    }
+    if (enqueue_result && !result->end_of_sequence) {
+      ctx_->RecordBufferEnqueue(result->element);
+      results_.push(std::move(result));
+    }
+    result = nullptr;
   }
   get_next_cv_.notify_all();
 }
 
 Status DataServiceClient::GetElementTraced(Task* task, int64_t deadline_micros,
+                                           int64_t max_elements,
                                            bool enqueue_result,
                                            std::shared_ptr<Result> result)
     TF_LOCKS_EXCLUDED(mu_) {
@@ -752,7 +837,8 @@ Status DataServiceClient::GetElementTraced(Task* task, int64_t deadline_micros,
            {"round_index", task->round}});
     });
   }
-  Status s = GetElement(task, deadline_micros, enqueue_result, result);
+  Status s =
+      GetElement(task, deadline_micros, max_elements, enqueue_result, result);
   mutex_lock l(mu_);
   VLOG(3) << "Got an element for task id " << task->info.task_id();
   return s;
@@ -789,12 +875,12 @@ Status DataServiceClient::MaybeRemoveTask(Task& task, int64_t deadline_micros,
 }
 
 Status DataServiceClient::GetElement(Task* task, int64_t deadline_micros,
-                                     bool enqueue_result,
+                                     int64_t max_elements, bool enqueue_result,
                                      std::shared_ptr<Result> result)
     TF_LOCKS_EXCLUDED(mu_) {
-  GetElementResult get_element_result;
+  std::vector<GetElementResult> get_element_results;
   for (int num_retries = 0;; ++num_retries) {
-    Status s = TryGetElement(*task, get_element_result);
+    Status s = TryGetElement(*task, max_elements, get_element_results);
     if (s.ok()) break;
     if (!IsPreemptedError(s)) {
       std::string data_transfer_protocol =
@@ -850,7 +936,8 @@ Status DataServiceClient::GetElement(Task* task, int64_t deadline_micros,
             << (backoff_until - now_micros) << " microseconds";
     Env::Default()->SleepForMicroseconds(backoff_until - now_micros);
   }
-  ProcessGetElementResponse(enqueue_result, get_element_result, result, *task);
+  ProcessGetElementResponse(enqueue_result, get_element_results, result,
+                            *task);
   return OkStatus();
 }
 
@@ -94,6 +94,9 @@ class DataServiceClient {
     // deleted from `tasks_` on the next dispatcher heartbeat.
     bool removed = false;
     bool skipped_previous_round = false;
+    // Whether the worker doesn't serve batched `GetElements` requests. Only
+    // accessed by the worker thread processing the task.
+    bool get_elements_unimplemented = false;
     // Indicates whether a worker thread is currently processing the task.
     bool in_use TF_GUARDED_BY(&DataServiceClient::mu_) = false;
     // Indicates whether the worker has returned end_of_sequence for the task.
@@ -147,7 +150,8 @@ class DataServiceClient {
       const DataTransferServerInfo& transfer_server, const TaskInfo& task_info);
   void Heartbeat();
   void UpdateTasks(const ClientHeartbeatResponse& resp);
-  bool ShouldReadFromTask(const TaskInfo& task) const;
+  // `has_same_rack_tasks` is true if some tasks run in the rack of the client.
+  bool ShouldReadFromTask(const TaskInfo& task, bool has_same_rack_tasks) const;
   void RecordTFMetrics(const ClientHeartbeatResponse& resp);
   void UpdateBufferSize();
   void UpdateWorkerThreads();
@@ -159,21 +163,29 @@ class DataServiceClient {
   // task a chance to proceed.
   std::shared_ptr<Task> GetTaskToProcess();
   void AdvanceTaskIndex();
-  Status TryGetElement(const Task& task, GetElementResult& result);
-  void ProcessGetElementResponse(bool enqueue_result,
-                                 GetElementResult& get_element_result,
-                                 std::shared_ptr<Result> result, Task& task);
+  // Returns the maximum number of elements a new request may fetch, so that
+  // the buffered and requested elements stay within
+  // `max_outstanding_requests_`.
+  int64_t GetMaxElementsPerRequest() const;
+  Status TryGetElement(Task& task, int64_t max_elements,
+                       std::vector<GetElementResult>& results);
+  void ProcessGetElementResponse(
+      bool enqueue_result, std::vector<GetElementResult>& get_element_results,
+      std::shared_ptr<Result> result, Task& task);
   Status GetElementTraced(Task* task, int64_t deadline_micros,
-                          bool enqueue_result, std::shared_ptr<Result> result);
+                          int64_t max_elements, bool enqueue_result,
+                          std::shared_ptr<Result> result);
   Status MaybeRemoveTask(Task& task, int64_t deadline_micros, Result& result);
-  Status GetElement(Task* task, int64_t deadline_micros, bool enqueue_result,
-                    std::shared_ptr<Result> result);
+  Status GetElement(Task* task, int64_t deadline_micros, int64_t max_elements,
+                    bool enqueue_result, std::shared_ptr<Result> result);
   bool ResultReady() const;
   std::shared_ptr<Result> PopNextResult();
   bool IsCoordinatedRead() const;
   std::string DebugString() const;
 
   const DataServiceParams params_;
+  // The rack of the client, or an empty string if it is unknown.
+  const std::string rack_;
 
   mutable mutex mu_;
   condition_variable get_next_cv_ TF_GUARDED_BY(mu_);
@@ -182,7 +194,7 @@ class DataServiceClient {
 
   bool cancelled_ TF_GUARDED_BY(mu_) = false;
 
-  // Number of outstanding requests.
+  // Number of elements requested by the outstanding requests.
   int64_t outstanding_requests_ TF_GUARDED_BY(mu_) = 0;
 
   // max_outstanding_requests controls how many elements may be held in memory
@@ -232,6 +244,11 @@ class DataServiceClient {
 
   int64_t get_next_index_ TF_GUARDED_BY(mu_) = 0;
 
+  // The time `GetNext` waited for the elements produced since the last
+  // heartbeat, and the number of these elements.
+  int64_t wait_time_usec_since_heartbeat_ TF_GUARDED_BY(mu_) = 0;
+  int64_t num_elements_since_heartbeat_ TF_GUARDED_BY(mu_) = 0;
+
   bool iteration_finished_ TF_GUARDED_BY(mu_) = false;
   bool should_finish_iteration_ TF_GUARDED_BY(mu_) = true;
 
@@ -39,6 +39,11 @@ constexpr int kDataServiceVersion = 7;
 // workers on other TF hosts when the host runs a local tf.data service worker.
 constexpr absl::string_view kColocatedWorkerTag = "COLOCATED";
 
+// Workers with a "RACK:<rack>" tag are in rack <rack>. Clients that set their
+// rack with the TF_DATA_SERVICE_CLIENT_RACK environment variable avoid reading
+// from the workers of other racks when their rack has workers.
+constexpr absl::string_view kRackWorkerTagPrefix = "RACK:";
+
 // Container to hold the result of a `GetNext` call.
 struct GetNextResult final {
   explicit GetNextResult() = default;
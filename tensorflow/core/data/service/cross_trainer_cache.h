@@ -20,14 +20,23 @@ limitations under the License.
 #include <functional>
 #include <limits>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
 #include "tensorflow/core/data/service/logging_utils.h"
 #include "tensorflow/core/framework/metrics.h"
+#include "tensorflow/core/lib/hash/crc32c.h"
+#include "tensorflow/core/platform/coding.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/file_system.h"
 #include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/platform/random.h"
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/platform/statusor.h"
 #include "tensorflow/core/platform/thread_annotations.h"
@@ -46,6 +55,10 @@ namespace data {
 // collected when the cache becomes full. Consequently, trainers read from a
 // sliding window through the dataset and may not read the full dataset.
 //
+// Optionally, elements evicted from memory are spilled to local disk, e.g. an
+// SSD, and read back from there, so that trainers that fall behind the memory
+// window do not skip data (see `CrossTrainerCacheSpillOptions`).
+//
 // The `CrossTrainerCache` class is thread-safe.
 //
 // Example usage:
@@ -78,7 +91,9 @@ namespace data {
 // To use the cache, the user needs to define a `CachableSequence` to generate
 // an infinite sequence of data. It should implement a `GetNext` method to
 // produce elements, and a `GetElementSizeBytes` method to estimate the element
-// size in bytes.
+// size in bytes. To spill elements to disk, it should also implement
+// `SerializeElement` and `DeserializeElement`, which may be called
+// concurrently.
 template <class ElementType>
 class CachableSequence {
  public:
@@ -89,6 +104,32 @@ class CachableSequence {
 
   // Returns the estimated size of the element in bytes.
   virtual size_t GetElementSizeBytes(const ElementType&) const = 0;
+
+  // Serializes an element to spill it to disk.
+  virtual StatusOr<std::string> SerializeElement(const ElementType&) const {
+    return errors::Unimplemented(
+        "This cachable sequence does not support spilling to disk.");
+  }
+
+  // Parses an element serialized by `SerializeElement`.
+  virtual StatusOr<ElementType> DeserializeElement(absl::string_view) const {
+    return errors::Unimplemented(
+        "This cachable sequence does not support spilling to disk.");
+  }
+};
+
+// Options for spilling the elements evicted from the memory of a
+// `CrossTrainerCache` to local disk.
+struct CrossTrainerCacheSpillOptions {
+  // The directory of the spill files. If empty, evicted elements are
+  // discarded.
+  std::string directory;
+  // The maximum total size of the spill files in bytes. Once exceeded, the
+  // oldest spilled elements are discarded.
+  size_t max_spill_size_bytes = 0;
+  // The maximum size of each spill file in bytes. A spill file is deleted once
+  // all of its elements have been discarded.
+  size_t max_file_size_bytes = size_t{256} << 20;  // 256MB
 };
 
 // Sliding-window cache shared across concurrent trainers.
@@ -100,7 +141,8 @@ class CrossTrainerCache {
   // REQUIRES: `max_cache_size_bytes >= max(GetElementSizeBytes(*))`
   explicit CrossTrainerCache(
       size_t max_cache_size_bytes,
-      std::unique_ptr<CachableSequence<ElementType>> cachable_sequence);
+      std::unique_ptr<CachableSequence<ElementType>> cachable_sequence,
+      const CrossTrainerCacheSpillOptions& spill_options = {});
   virtual ~CrossTrainerCache() = default;
   CrossTrainerCache(const CrossTrainerCache&) = delete;
   CrossTrainerCache& operator=(const CrossTrainerCache&) = delete;
@@ -126,6 +168,34 @@ class CrossTrainerCache {
     bool cache_hit;
   };
 
+  // An append-only spill file. Each record is the length of the serialized
+  // element as a fixed64, the masked crc32c of the serialized element as a
+  // fixed32, and the serialized element. The file is deleted when the last
+  // reference to it is dropped.
+  struct SpillFile {
+    ~SpillFile() {
+      writer.reset();
+      reader.reset();
+      Env::Default()->DeleteFile(filename).IgnoreError();
+    }
+
+    std::string filename;
+    std::unique_ptr<WritableFile> writer;
+    std::unique_ptr<RandomAccessFile> reader;
+    size_t size_bytes = 0;
+  };
+
+  // An element spilled to disk.
+  struct SpilledElement {
+    std::shared_ptr<SpillFile> file;
+    size_t offset = 0;
+    // The size of the record in bytes.
+    size_t record_size_bytes = 0;
+  };
+
+  static constexpr size_t kSpillRecordHeaderSize =
+      sizeof(uint64_t) + sizeof(uint32_t);
+
   // Returns the next element and metrics about this query.
   StatusOr<CacheQueryResult> GetCacheQueryResult(const std::string& trainer_id);
 
@@ -142,6 +212,22 @@ class CrossTrainerCache {
   StatusOr<std::shared_ptr<const ElementType>> GetElement(
       const std::string& trainer_id);
 
+  // Returns the spilled element to read for `trainer_id`, or nullopt if its
+  // next element is in memory.
+  std::optional<SpilledElement> GetSpilledElement(
+      const std::string& trainer_id);
+
+  // Reads a spilled element back from disk.
+  StatusOr<std::shared_ptr<const ElementType>> ReadSpilledElement(
+      const SpilledElement& spilled_element) const;
+
+  // Appends `element` to the spill files and discards the oldest spilled
+  // elements if the spill files exceed `max_spill_size_bytes`.
+  Status SpillElement(const ElementType& element);
+
+  // Discards spilled elements until `spill_size_bytes_` fits in the budget.
+  void DiscardSpilledElements(size_t max_spill_size_bytes);
+
   // Reads a new element and writes it into the cache.
   Status ExtendCache();
 
@@ -155,6 +241,8 @@ class CrossTrainerCache {
   // Maximum cache size in bytes.
   const size_t max_cache_size_bytes_;
 
+  const CrossTrainerCacheSpillOptions spill_options_;
+
   // The element sequence over which the sliding window cache operates.
   std::unique_ptr<CachableSequence<ElementType>> cachable_sequence_;
 
@@ -170,12 +258,25 @@ class CrossTrainerCache {
   size_t cache_size_bytes_ TF_GUARDED_BY(mu_) = 0;
   size_t cache_start_index_ TF_GUARDED_BY(mu_) = 0;
 
+  // `spilled_` stores the elements spilled to disk, which precede the elements
+  // in `cache_`, i.e. `spill_start_index_ + spilled_.size()` is always equal to
+  // `cache_start_index_`.
+  bool spill_enabled_ TF_GUARDED_BY(mu_) = false;
+  std::deque<SpilledElement> spilled_ TF_GUARDED_BY(mu_);
+  size_t spill_size_bytes_ TF_GUARDED_BY(mu_) = 0;
+  size_t spill_start_index_ TF_GUARDED_BY(mu_) = 0;
+  // The spill file that new elements are appended to.
+  std::shared_ptr<SpillFile> spill_file_ TF_GUARDED_BY(mu_);
+  int64_t num_spill_files_ TF_GUARDED_BY(mu_) = 0;
+
   // True if one thread is extending the cache.
   bool extending_cache_ TF_GUARDED_BY(mu_) = false;
 
   // Maps trainer IDs to element indices. The indices are absolute indices
   // within the dataset. The actual index to use with `cache_` would be
-  // `trainer_to_element_index_map_[trainer_id] - cache_start_index_`.
+  // `trainer_to_element_index_map_[trainer_id] - cache_start_index_`, and with
+  // `spilled_`, `trainer_to_element_index_map_[trainer_id] -
+  // spill_start_index_`.
   absl::flat_hash_map<std::string, size_t> trainer_to_element_index_map_
       TF_GUARDED_BY(mu_);
 };
@@ -183,13 +284,29 @@ class CrossTrainerCache {
 template <class ElementType>
 CrossTrainerCache<ElementType>::CrossTrainerCache(
     size_t max_cache_size_bytes,
-    std::unique_ptr<CachableSequence<ElementType>> cachable_sequence)
+    std::unique_ptr<CachableSequence<ElementType>> cachable_sequence,
+    const CrossTrainerCacheSpillOptions& spill_options)
     : max_cache_size_bytes_(max_cache_size_bytes),
+      spill_options_(spill_options),
       cachable_sequence_(std::move(cachable_sequence)) {
   DCHECK_GT(max_cache_size_bytes, 0)
       << "CrossTrainerCache size must be greater than 0.";
   VLOG(2) << "Initialized tf.data service cross-trainer cache with "
           << FormatBytes(max_cache_size_bytes) << " of memory.";
+  if (!spill_options_.directory.empty() &&
+      spill_options_.max_spill_size_bytes > 0) {
+    Status s = Env::Default()->RecursivelyCreateDir(spill_options_.directory);
+    if (s.ok()) {
+      spill_enabled_ = true;
+      VLOG(2) << "tf.data service cross-trainer cache spills up to "
+              << FormatBytes(spill_options_.max_spill_size_bytes) << " to "
+              << spill_options_.directory << ".";
+    } else {
+      LOG(WARNING) << "Failed to create the tf.data service cross-trainer "
+                   << "cache spill directory " << spill_options_.directory
+                   << "; evicted elements will be discarded: " << s;
+    }
+  }
 }
 
 template <class ElementType>
@@ -212,20 +329,22 @@ CrossTrainerCache<ElementType>::GetCacheQueryResult(
     const std::string& trainer_id) {
   bool should_extend_cache = false;
   while (true) {
+    std::optional<SpilledElement> spilled_element;
     {
       mutex_lock l(mu_);
       TF_RETURN_IF_ERROR(status_);
       if (IsElementReady(trainer_id)) {
-        TF_ASSIGN_OR_RETURN(std::shared_ptr<const ElementType> element,
-                            GetElement(trainer_id));
-        return CacheQueryResult{element,
-                                /*is_cache_hit=*/!should_extend_cache};
-      }
-
-      // Extends the cache or waits for another thread to extend the cache. When
-      // concurrent trainers wait for the next element, only one of them should
-      // extend the cache.
-      if (extending_cache_) {
+        spilled_element = GetSpilledElement(trainer_id);
+        if (!spilled_element.has_value()) {
+          TF_ASSIGN_OR_RETURN(std::shared_ptr<const ElementType> element,
+                              GetElement(trainer_id));
+          return CacheQueryResult{element,
+                                  /*is_cache_hit=*/!should_extend_cache};
+        }
+      } else if (extending_cache_) {
+        // Extends the cache or waits for another thread to extend the cache.
+        // When concurrent trainers wait for the next element, only one of them
+        // should extend the cache.
         should_extend_cache = false;
         cv_.wait(l);
       } else {
@@ -234,6 +353,14 @@ CrossTrainerCache<ElementType>::GetCacheQueryResult(
       }
     }
 
+    if (spilled_element.has_value()) {
+      // Reads the element without holding the lock, so that trainers reading
+      // from memory are not blocked by those reading from disk.
+      TF_ASSIGN_OR_RETURN(std::shared_ptr<const ElementType> element,
+                          ReadSpilledElement(*spilled_element));
+      return CacheQueryResult{element, /*is_cache_hit=*/true};
+    }
+
     if (should_extend_cache) {
       Status s = ExtendCache();
       mutex_lock l(mu_);
@@ -271,12 +398,54 @@ template <class ElementType>
 size_t CrossTrainerCache<ElementType>::GetElementIndex(
     const std::string& trainer_id) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
   size_t element_index = trainer_to_element_index_map_[trainer_id];
-  if (element_index < cache_start_index_) {
-    element_index = cache_start_index_;
+  if (element_index < spill_start_index_) {
+    element_index = spill_start_index_;
   }
   return element_index;
 }
 
+template <class ElementType>
+std::optional<typename CrossTrainerCache<ElementType>::SpilledElement>
+CrossTrainerCache<ElementType>::GetSpilledElement(const std::string& trainer_id)
+    TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+  size_t element_index = GetElementIndex(trainer_id);
+  if (element_index >= cache_start_index_) {
+    return std::nullopt;
+  }
+  trainer_to_element_index_map_[trainer_id] = element_index + 1;
+  return spilled_[element_index - spill_start_index_];
+}
+
+template <class ElementType>
+StatusOr<std::shared_ptr<const ElementType>>
+CrossTrainerCache<ElementType>::ReadSpilledElement(
+    const SpilledElement& spilled_element) const TF_LOCKS_EXCLUDED(mu_) {
+  std::string scratch(spilled_element.record_size_bytes, '\0');
+  StringPiece record;
+  TF_RETURN_IF_ERROR(spilled_element.file->reader->Read(
+      spilled_element.offset, spilled_element.record_size_bytes, &record,
+      scratch.data()));
+  if (record.size() != spilled_element.record_size_bytes) {
+    return errors::DataLoss("Truncated tf.data service cross-trainer cache "
+                            "spill file ",
+                            spilled_element.file->filename);
+  }
+  const uint64_t length = core::DecodeFixed64(record.data());
+  const uint32_t crc =
+      crc32c::Unmask(core::DecodeFixed32(record.data() + sizeof(uint64_t)));
+  absl::string_view serialized(record.data() + kSpillRecordHeaderSize,
+                               record.size() - kSpillRecordHeaderSize);
+  if (length != serialized.size() ||
+      crc32c::Value(serialized.data(), serialized.size()) != crc) {
+    return errors::DataLoss("Corrupted record in tf.data service "
+                            "cross-trainer cache spill file ",
+                            spilled_element.file->filename);
+  }
+  TF_ASSIGN_OR_RETURN(ElementType element,
+                      cachable_sequence_->DeserializeElement(serialized));
+  return std::make_shared<const ElementType>(std::move(element));
+}
+
 template <class ElementType>
 Status CrossTrainerCache<ElementType>::ExtendCache() TF_LOCKS_EXCLUDED(mu_) {
   TF_ASSIGN_OR_RETURN(ElementType element, cachable_sequence_->GetNext());
@@ -305,15 +474,84 @@ void CrossTrainerCache<ElementType>::FreeSpace(size_t new_element_size_bytes)
          cache_size_bytes_ + new_element_size_bytes > max_cache_size_bytes_) {
     size_t free_bytes =
         cachable_sequence_->GetElementSizeBytes(*cache_.front());
+    bool spilled = false;
+    if (spill_enabled_) {
+      Status s = SpillElement(*cache_.front());
+      if (s.ok()) {
+        spilled = true;
+      } else {
+        LOG(WARNING) << "Failed to spill tf.data service cross-trainer cache "
+                     << "elements to " << spill_options_.directory
+                     << "; evicted elements will be discarded: " << s;
+        spill_enabled_ = false;
+        DiscardSpilledElements(/*max_spill_size_bytes=*/0);
+        spill_file_.reset();
+      }
+    }
     cache_.pop_front();
     cache_size_bytes_ -= free_bytes;
     ++cache_start_index_;
+    if (!spilled) {
+      spill_start_index_ = cache_start_index_;
+    }
+    metrics::RecordTFDataServiceCrossTrainerCacheEviction(
+        /*spilled=*/spilled);
     ++num_elements_discarded;
   }
 
   VLOG(3) << "Freed " << num_elements_discarded << " element(s) from "
           << "tf.data service cross-trainer cache. Memory usage: "
-          << FormatBytes(cache_size_bytes_) << ".";
+          << FormatBytes(cache_size_bytes_) << ", disk usage: "
+          << FormatBytes(spill_size_bytes_) << ".";
+}
+
+template <class ElementType>
+Status CrossTrainerCache<ElementType>::SpillElement(const ElementType& element)
+    TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+  TF_ASSIGN_OR_RETURN(std::string serialized,
+                      cachable_sequence_->SerializeElement(element));
+  if (spill_file_ == nullptr ||
+      spill_file_->size_bytes >= spill_options_.max_file_size_bytes) {
+    auto file = std::make_shared<SpillFile>();
+    file->filename = io::JoinPath(
+        spill_options_.directory,
+        absl::StrCat("cross_trainer_cache_", random::New64(), "_",
+                     num_spill_files_++));
+    TF_RETURN_IF_ERROR(
+        Env::Default()->NewWritableFile(file->filename, &file->writer));
+    TF_RETURN_IF_ERROR(
+        Env::Default()->NewRandomAccessFile(file->filename, &file->reader));
+    spill_file_ = std::move(file);
+  }
+  std::string header;
+  core::PutFixed64(&header, serialized.size());
+  core::PutFixed32(&header,
+                   crc32c::Mask(crc32c::Value(serialized.data(),
+                                              serialized.size())));
+  TF_RETURN_IF_ERROR(spill_file_->writer->Append(header));
+  TF_RETURN_IF_ERROR(spill_file_->writer->Append(serialized));
+  // Flushes so that readers of the file see the record.
+  TF_RETURN_IF_ERROR(spill_file_->writer->Flush());
+  SpilledElement spilled_element;
+  spilled_element.file = spill_file_;
+  spilled_element.offset = spill_file_->size_bytes;
+  spilled_element.record_size_bytes = header.size() + serialized.size();
+  spill_file_->size_bytes += spilled_element.record_size_bytes;
+  spill_size_bytes_ += spilled_element.record_size_bytes;
+  spilled_.push_back(std::move(spilled_element));
+  DiscardSpilledElements(spill_options_.max_spill_size_bytes);
+  return OkStatus();
+}
+
+template <class ElementType>
+void CrossTrainerCache<ElementType>::DiscardSpilledElements(
+    size_t max_spill_size_bytes) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+  while (!spilled_.empty() && spill_size_bytes_ > max_spill_size_bytes) {
+    spill_size_bytes_ -= spilled_.front().record_size_bytes;
+    spilled_.pop_front();
+    ++spill_start_index_;
+    metrics::RecordTFDataServiceCrossTrainerCacheSpillDiscard();
+  }
 }
 
 template <class ElementType>
@@ -341,11 +579,15 @@ void CrossTrainerCache<ElementType>::RecordMetrics(
     const CacheQueryResult& result) {
   metrics::RecordTFDataServiceCrossTrainerCacheQuery(result.cache_hit);
   size_t cache_size_bytes = 0;
+  size_t spill_size_bytes = 0;
   {
     mutex_lock l(mu_);
     cache_size_bytes = cache_size_bytes_;
+    spill_size_bytes = spill_size_bytes_;
   }
   metrics::RecordTFDataServiceCrossTrainerCacheSizeBytes(cache_size_bytes);
+  metrics::RecordTFDataServiceCrossTrainerCacheSpillSizeBytes(
+      spill_size_bytes);
 }
 
 }  // namespace data
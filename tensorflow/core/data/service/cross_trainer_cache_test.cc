@@ -22,7 +22,9 @@ limitations under the License.
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/memory/memory.h"
+#include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
 #include "absl/time/time.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_testutil.h"
@@ -30,6 +32,7 @@ limitations under the License.
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/path.h"
 #include "tensorflow/core/platform/random.h"
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/platform/status_matchers.h"
@@ -61,6 +64,22 @@ class InfiniteRange : public CachableSequence<int64_t> {
   int64_t next_ = 0;
 };
 
+class SpillableInfiniteRange : public InfiniteRange {
+ public:
+  StatusOr<std::string> SerializeElement(
+      const int64_t& element) const override {
+    return absl::StrCat(element);
+  }
+  StatusOr<int64_t> DeserializeElement(
+      absl::string_view serialized) const override {
+    int64_t element = 0;
+    if (!absl::SimpleAtoi(serialized, &element)) {
+      return errors::DataLoss("Invalid element: ", serialized);
+    }
+    return element;
+  }
+};
+
 class TensorDataset : public CachableSequence<Tensor> {
  public:
   StatusOr<Tensor> GetNext() override { return Tensor("Test Tensor"); }
@@ -190,6 +209,69 @@ TEST(CrossTrainerCacheTest, SlowTrainersSkipData) {
   EXPECT_THAT(cache.Get("Slow trainer 2"), IsOkAndHolds(Pointee(Gt(94))));
 }
 
+CrossTrainerCacheSpillOptions SpillOptions(size_t max_spill_size_bytes) {
+  CrossTrainerCacheSpillOptions spill_options;
+  spill_options.directory = io::JoinPath(
+      ::testing::TempDir(), absl::StrCat("spill_", random::New64()));
+  spill_options.max_spill_size_bytes = max_spill_size_bytes;
+  spill_options.max_file_size_bytes = 64;
+  return spill_options;
+}
+
+TEST(CrossTrainerCacheTest, SlowTrainersReadSpilledData) {
+  CellReader<int64_t> evictions(
+      "/tensorflow/data/service/cross_trainer_cache_evictions");
+  CrossTrainerCache<int64_t> cache(
+      /*max_cache_size_bytes=*/5 * sizeof(int64_t),
+      std::make_unique<SpillableInfiniteRange>(),
+      SpillOptions(/*max_spill_size_bytes=*/size_t{1} << 20));
+  EXPECT_THAT(cache.Get("Slow trainer"), IsOkAndHolds(Pointee(0)));
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_THAT(cache.Get("Fast trainer"), IsOkAndHolds(Pointee(i)));
+  }
+  EXPECT_EQ(evictions.Delta("true"), 95);
+  EXPECT_EQ(evictions.Delta("false"), 0);
+
+  // The slow trainer reads the evicted elements from disk.
+  for (int i = 1; i < 100; ++i) {
+    EXPECT_THAT(cache.Get("Slow trainer"), IsOkAndHolds(Pointee(i)));
+  }
+}
+
+TEST(CrossTrainerCacheTest, SpilledDataIsDiscarded) {
+  CellReader<int64_t> discards(
+      "/tensorflow/data/service/cross_trainer_cache_spill_discards");
+  CrossTrainerCache<int64_t> cache(
+      /*max_cache_size_bytes=*/5 * sizeof(int64_t),
+      std::make_unique<SpillableInfiniteRange>(),
+      // Each record holds a 12-byte header and 2 digits.
+      SpillOptions(/*max_spill_size_bytes=*/10 * 14));
+  EXPECT_THAT(cache.Get("Slow trainer"), IsOkAndHolds(Pointee(0)));
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_THAT(cache.Get("Fast trainer"), IsOkAndHolds(Pointee(i)));
+  }
+  EXPECT_GT(discards.Delta(), 0);
+
+  // 95 elements were evicted from memory, and at most 10 of them remain on
+  // disk.
+  EXPECT_THAT(cache.Get("Slow trainer"), IsOkAndHolds(Pointee(Gt(84))));
+}
+
+TEST(CrossTrainerCacheTest, SequenceWithoutSpillSupportDiscardsData) {
+  CellReader<int64_t> evictions(
+      "/tensorflow/data/service/cross_trainer_cache_evictions");
+  CrossTrainerCache<int64_t> cache(
+      /*max_cache_size_bytes=*/5 * sizeof(int64_t),
+      std::make_unique<InfiniteRange>(),
+      SpillOptions(/*max_spill_size_bytes=*/size_t{1} << 20));
+  EXPECT_THAT(cache.Get("Slow trainer"), IsOkAndHolds(Pointee(0)));
+  for (int i = 0; i < 20; ++i) {
+    EXPECT_THAT(cache.Get("Fast trainer"), IsOkAndHolds(Pointee(i)));
+  }
+  EXPECT_EQ(evictions.Delta("false"), 15);
+  EXPECT_THAT(cache.Get("Slow trainer"), IsOkAndHolds(Pointee(Gt(14))));
+}
+
 TEST(CrossTrainerCacheTest, NewTrainersStartLate) {
   CrossTrainerCache<int64_t> cache(
       /*max_cache_size_bytes=*/5 * sizeof(int64_t),
@@ -77,6 +77,16 @@ class DataTransferClient {
   virtual Status GetElement(const GetElementRequest& req,
                             GetElementResult& result) = 0;
 
+  // Fetches at most `max_elements` next elements. The first element is
+  // required, and the following elements are returned if the server has them
+  // ready. Only the last element may be skipped or end of sequence. By default,
+  // fetches one element with `GetElement`.
+  virtual Status GetElements(const GetElementRequest& req, int64_t max_elements,
+                             std::vector<GetElementResult>& results) {
+    results.clear();
+    return GetElement(req, results.emplace_back());
+  }
+
   // Makes a best effort to cancel all outstanding calls in progress for the
   // client, and causes further calls to return Cancelled status.
   virtual void TryCancel() = 0;
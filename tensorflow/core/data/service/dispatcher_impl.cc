@@ -225,9 +225,12 @@ Status DataServiceDispatcherImpl::Start() {
     }
   }
   for (const auto& iteration : state_.ListIterations()) {
+    // The split providers are restored by the first `GetSplit` call for the
+    // iteration, so that the restart doesn't wait for replaying the splits of
+    // all the iterations, most of which are usually finished.
     if (IsDynamicShard(iteration->job->processing_mode)) {
-      TF_RETURN_IF_ERROR(RestoreSplitProviders(
-          *iteration, split_providers_[iteration->iteration_id]));
+      split_providers_[iteration->iteration_id] =
+          std::make_shared<IterationSplitProviders>();
     }
   }
   for (const auto& client_id : state_.ListActiveClientIds()) {
@@ -262,20 +265,23 @@ size_t DataServiceDispatcherImpl::NumActiveIterations() TF_LOCKS_EXCLUDED(mu_) {
 }
 
 Status DataServiceDispatcherImpl::RestoreSplitProviders(
-    const Iteration& iteration,
-    std::vector<std::unique_ptr<SplitProvider>>& restored)
-    TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
-  const std::vector<int64_t>& indices =
-      iteration.distributed_epoch_state.value().indices;
+    int64_t iteration_id, std::vector<std::unique_ptr<SplitProvider>>& restored)
+    TF_LOCKS_EXCLUDED(mu_) {
+  std::vector<int64_t> indices;
   std::vector<std::unique_ptr<SplitProvider>> split_providers;
-  TF_RETURN_IF_ERROR(
-      MakeSplitProviders(iteration.job->dataset_id, split_providers));
+  {
+    mutex_lock l(mu_);
+    std::shared_ptr<const Iteration> iteration;
+    TF_RETURN_IF_ERROR(state_.IterationFromId(iteration_id, iteration));
+    indices = iteration->distributed_epoch_state.value().indices;
+    TF_RETURN_IF_ERROR(
+        MakeSplitProviders(iteration->job->dataset_id, split_providers));
+  }
   for (int provider_index = 0; provider_index < indices.size();
        ++provider_index) {
     int index = indices[provider_index];
     VLOG(1) << "Restoring split provider " << provider_index
-            << " for iteration " << iteration.iteration_id << " to index "
-            << index;
+            << " for iteration " << iteration_id << " to index " << index;
     Tensor unused_tensor;
     bool unused_end_of_splits;
     for (int i = 0; i < index; ++i) {
@@ -371,6 +377,16 @@ Status DataServiceDispatcherImpl::WorkerHeartbeat(
   TF_RETURN_IF_ERROR(
       FindNewTasks(worker_address, current_tasks, assigned_tasks, response));
 
+  for (const auto& [task_id, occupancy] : request->task_buffer_occupancy()) {
+    std::shared_ptr<const Task> task;
+    if (!state_.TaskFromId(task_id, task).ok()) {
+      continue;
+    }
+    metrics::RecordTFDataServiceWorkerBufferOccupancy(occupancy);
+    auto_scaler_.ReportBufferOccupancy(task->iteration->job->id,
+                                       worker_address, occupancy);
+  }
+
   for (const auto& [path, snapshot_manager] : snapshots_) {
     TF_RETURN_IF_ERROR(snapshot_manager->WorkerHeartbeat(*request, *response));
   }
@@ -419,22 +435,45 @@ Status DataServiceDispatcherImpl::GetDatasetDef(
 Status DataServiceDispatcherImpl::GetSplit(const GetSplitRequest* request,
                                            GetSplitResponse* response) {
   TF_RETURN_IF_ERROR(CheckStarted());
-  mutex_lock l(mu_);
   int64_t iteration_id = request->iteration_id();
   int64_t repetition = request->repetition();
   int64_t provider_index = request->split_provider_index();
   VLOG(3) << "Received GetSplit request for iteration " << iteration_id
           << ", repetition " << repetition << ", split provider index "
           << provider_index;
-  std::shared_ptr<const Iteration> iteration;
-  TF_RETURN_IF_ERROR(state_.IterationFromId(iteration_id, iteration));
-  if (!iteration->distributed_epoch_state.has_value()) {
-    return errors::FailedPrecondition(
-        "Cannot get split for iteration ", iteration_id,
-        ", since it is not a distributed_epoch iteration.");
+  std::shared_ptr<IterationSplitProviders> iteration_split_providers;
+  {
+    mutex_lock l(mu_);
+    std::shared_ptr<const Iteration> iteration;
+    TF_RETURN_IF_ERROR(state_.IterationFromId(iteration_id, iteration));
+    if (!iteration->distributed_epoch_state.has_value()) {
+      return errors::FailedPrecondition(
+          "Cannot get split for iteration ", iteration_id,
+          ", since it is not a distributed_epoch iteration.");
+    }
+    iteration_split_providers = split_providers_[iteration_id];
+    DCHECK(iteration_split_providers != nullptr);
+  }
+  // The split provider is used without holding `mu_`. Its state and the
+  // distributed epoch state of the iteration only change under
+  // `iteration_split_providers->mu`.
+  mutex_lock split_providers_lock(iteration_split_providers->mu);
+  if (!iteration_split_providers->initialized) {
+    TF_RETURN_IF_ERROR(RestoreSplitProviders(
+        iteration_id, iteration_split_providers->split_providers));
+    iteration_split_providers->initialized = true;
+  }
+  int64_t current_repetition;
+  {
+    mutex_lock l(mu_);
+    std::shared_ptr<const Iteration> iteration;
+    TF_RETURN_IF_ERROR(state_.IterationFromId(iteration_id, iteration));
+    current_repetition =
+        iteration->distributed_epoch_state.value().repetitions[provider_index];
   }
-  int64_t current_repetition =
-      iteration->distributed_epoch_state.value().repetitions[provider_index];
+  SplitProvider* split_provider =
+      iteration_split_providers->split_providers[provider_index].get();
+  DCHECK(split_provider != nullptr);
   if (repetition < current_repetition) {
     response->set_end_of_splits(true);
     VLOG(3) << "Returning end_of_splits since current repetition "
@@ -447,21 +486,21 @@ Status DataServiceDispatcherImpl::GetSplit(const GetSplitRequest* request,
     // input, e.g. for the longer input to `Dataset.zip`. In this case we mark
     // the previous repetitions as completed and advance to the requested
     // repetition.
-    TF_RETURN_IF_ERROR(split_providers_[iteration_id][provider_index]->Reset());
+    TF_RETURN_IF_ERROR(split_provider->Reset());
   }
-  SplitProvider* split_provider =
-      split_providers_[iteration_id][provider_index].get();
-  DCHECK(split_provider != nullptr);
   Tensor split;
   bool end_of_splits = false;
   TF_RETURN_IF_ERROR(split_provider->GetNext(&split, &end_of_splits));
-  TF_RETURN_IF_ERROR(RecordSplitProduced(iteration_id, repetition,
-                                         request->split_provider_index(),
-                                         end_of_splits));
+  {
+    mutex_lock l(mu_);
+    TF_RETURN_IF_ERROR(RecordSplitProduced(iteration_id, repetition,
+                                           request->split_provider_index(),
+                                           end_of_splits));
+  }
   response->set_end_of_splits(end_of_splits);
   if (end_of_splits) {
     // Reset the split provider to prepare for the next iteration.
-    TF_RETURN_IF_ERROR(split_providers_[iteration_id][provider_index]->Reset());
+    TF_RETURN_IF_ERROR(split_provider->Reset());
   } else {
     split.AsProtoTensorContent(response->mutable_split());
   }
@@ -687,6 +726,7 @@ Status DataServiceDispatcherImpl::ReleaseIterationClient(
   release_iteration_client->set_iteration_client_id(iteration_client_id);
   release_iteration_client->set_time_micros(env_->NowMicros());
   TF_RETURN_IF_ERROR(Apply(update));
+  auto_scaler_.RemoveClient(iteration_client_id);
   return OkStatus();
 }
 
@@ -757,9 +797,11 @@ Status DataServiceDispatcherImpl::CreateIteration(
   std::shared_ptr<const Job> job;
   TF_RETURN_IF_ERROR(state_.JobFromId(request.job_id(), job));
   if (IsDynamicShard(job->processing_mode)) {
-    TF_RETURN_IF_ERROR(
-        MakeSplitProviders(job->dataset_id, split_providers_[iteration_id]));
-    num_split_providers = split_providers_[iteration_id].size();
+    std::vector<std::unique_ptr<SplitProvider>> split_providers;
+    TF_RETURN_IF_ERROR(MakeSplitProviders(job->dataset_id, split_providers));
+    num_split_providers = split_providers.size();
+    split_providers_[iteration_id] =
+        std::make_shared<IterationSplitProviders>(std::move(split_providers));
   }
   Update update;
   CreateIterationUpdate* create_iteration = update.mutable_create_iteration();
@@ -954,6 +996,13 @@ Status DataServiceDispatcherImpl::ClientHeartbeat(
         "Consider configuring the dispatcher with a higher "
         "`iteration_gc_timeout_ms`.");
   }
+  if (request->optional_wait_time_usec_case() ==
+      ClientHeartbeatRequest::kWaitTimeUsec) {
+    metrics::RecordTFDataServiceClientWaitTime(request->wait_time_usec());
+    auto_scaler_.ReportClientWaitTime(
+        iteration->job->id, request->iteration_client_id(),
+        absl::Microseconds(request->wait_time_usec()));
+  }
   if (request->optional_current_round_case() ==
       ClientHeartbeatRequest::kCurrentRound) {
     round_robin_rounds_[request->iteration_client_id()] =
@@ -1167,33 +1216,55 @@ Status DataServiceDispatcherImpl::Apply(const Update& update)
 void DataServiceDispatcherImpl::MaintenanceThread() {
   int64_t next_check_micros = 0;
   while (true) {
-    mutex_lock l(mu_);
-    while (!cancelled_ && env_->NowMicros() < next_check_micros) {
-      int64_t remaining_micros = next_check_micros - env_->NowMicros();
-      maintenance_thread_cv_.wait_for(
-          l, std::chrono::microseconds(remaining_micros));
-    }
-    if (cancelled_) {
-      return;
-    }
+    absl::flat_hash_map<int64_t, int64_t> recommended_num_workers;
     {
-      Status s = ReleaseMissingClients();
-      if (!s.ok()) {
-        LOG(WARNING) << "Error releasing missing clients: " << s;
+      mutex_lock l(mu_);
+      while (!cancelled_ && env_->NowMicros() < next_check_micros) {
+        int64_t remaining_micros = next_check_micros - env_->NowMicros();
+        maintenance_thread_cv_.wait_for(
+            l, std::chrono::microseconds(remaining_micros));
       }
-    }
-    {
-      Status s = GcOldIterations();
-      if (!s.ok()) {
-        LOG(WARNING) << "Error garbage collecting old iterations: " << s;
+      if (cancelled_) {
+        return;
+      }
+      {
+        Status s = ReleaseMissingClients();
+        if (!s.ok()) {
+          LOG(WARNING) << "Error releasing missing clients: " << s;
+        }
       }
+      {
+        Status s = GcOldIterations();
+        if (!s.ok()) {
+          LOG(WARNING) << "Error garbage collecting old iterations: " << s;
+        }
+      }
+      DetectMissingWorkers();
+      recommended_num_workers = UpdateRecommendedNumWorkers();
+      next_check_micros =
+          env_->NowMicros() + (config_.job_gc_check_interval_ms() * 1000);
+    }
+    // The hooks are called without holding `mu_`, so that they can't block
+    // the dispatcher.
+    for (const auto& [job_id, num_workers] : recommended_num_workers) {
+      RunWorkerCountHooks(job_id, num_workers);
     }
-    DetectMissingWorkers();
-    next_check_micros =
-        env_->NowMicros() + (config_.job_gc_check_interval_ms() * 1000);
   }
 }
 
+absl::flat_hash_map<int64_t, int64_t>
+DataServiceDispatcherImpl::UpdateRecommendedNumWorkers()
+    TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+  absl::flat_hash_map<int64_t, int64_t> recommended_num_workers =
+      auto_scaler_.GetRecommendedNumWorkers();
+  for (const auto& [job_id, num_workers] : recommended_num_workers) {
+    VLOG(2) << "Recommended number of workers for job " << job_id << ": "
+            << num_workers;
+    metrics::RecordTFDataServiceRecommendedNumWorkers(job_id, num_workers);
+  }
+  return recommended_num_workers;
+}
+
 Status DataServiceDispatcherImpl::ReleaseMissingClients()
     TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
   int64_t now = env_->NowMicros();
@@ -1208,6 +1279,7 @@ Status DataServiceDispatcherImpl::ReleaseMissingClients()
       release_client->set_iteration_client_id(client_id);
       release_client->set_time_micros(now);
       TF_RETURN_IF_ERROR(Apply(update));
+      auto_scaler_.RemoveClient(client_id);
     }
   }
   return OkStatus();
@@ -1222,6 +1294,7 @@ void DataServiceDispatcherImpl::DetectMissingWorkers()
     if (absl::FromUnixMicros(now) >
         it->second + absl::Milliseconds(config_.worker_timeout_ms())) {
       LOG(INFO) << "Lost worker " << it->first << " due to timeout";
+      auto_scaler_.RemoveWorker(it->first);
       latest_worker_heartbeats_time_.erase(it++);
     } else {
       ++it;
@@ -1242,6 +1315,7 @@ Status DataServiceDispatcherImpl::GcOldIterations()
     update.mutable_garbage_collect_iteration()->set_iteration_id(
         iteration->iteration_id);
     TF_RETURN_IF_ERROR(state_.Apply(update));
+    auto_scaler_.RemoveJob(iteration->job->id);
     LOG(INFO) << "Garbage collected iteration " << iteration->DebugString();
   }
   return OkStatus();
@@ -25,6 +25,7 @@ limitations under the License.
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/time/time.h"
+#include "tensorflow/core/data/service/auto_scaler.h"
 #include "tensorflow/core/data/service/common.pb.h"
 #include "tensorflow/core/data/service/dataset_store.h"
 #include "tensorflow/core/data/service/dispatcher.pb.h"
@@ -189,12 +190,12 @@ class DataServiceDispatcherImpl {
   // release, workers to consider missing, and snapshot streams to reassign.
   void MaintenanceThread();
 
-  // Restores split providers from the state in `iteration` and stores them in
-  // `restored`.
+  // Restores the split providers of the iteration `iteration_id` from its
+  // distributed epoch state and stores them in `restored`.
   Status RestoreSplitProviders(
-      const DispatcherState::Iteration& iteration,
+      int64_t iteration_id,
       std::vector<std::unique_ptr<SplitProvider>>& restored)
-      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+      TF_LOCKS_EXCLUDED(mu_);
   // Makes split providers for the specified `dataset_id`, and stores them in
   // `split_providers`.
   Status MakeSplitProviders(
@@ -313,6 +314,10 @@ class DataServiceDispatcherImpl {
   void DetectMissingWorkers() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
   // Scans for old iterations and marks them as finished.
   Status GcOldIterations() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  // Records the recommended number of workers of the jobs, and returns them
+  // keyed by job id.
+  absl::flat_hash_map<int64_t, int64_t> UpdateRecommendedNumWorkers()
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
   // Returns true if an iteration should be garbage collected.
   bool ShouldGcIteration(const DispatcherState::Iteration& iteration,
                          int64_t now_us) const;
@@ -339,8 +344,25 @@ class DataServiceDispatcherImpl {
       worker_stubs_ TF_GUARDED_BY(mu_);
   // Store of dataset definitions.
   std::unique_ptr<DatasetStore> dataset_store_ TF_GUARDED_BY(mu_);
+  // The split providers of an iteration. `mu` serializes the `GetSplit` calls
+  // for the iteration, which only hold `mu_` to read and update the dispatcher
+  // state, so that the calls for different iterations don't wait for each
+  // other's split providers.
+  struct IterationSplitProviders {
+    IterationSplitProviders() = default;
+    explicit IterationSplitProviders(
+        std::vector<std::unique_ptr<SplitProvider>> split_providers)
+        : initialized(true), split_providers(std::move(split_providers)) {}
+
+    mutex mu;
+    // False until the split providers of an iteration recovered from the
+    // journal are restored.
+    bool initialized TF_GUARDED_BY(mu) = false;
+    std::vector<std::unique_ptr<SplitProvider>> split_providers
+        TF_GUARDED_BY(mu);
+  };
   // Mapping from iteration id to the split providers for the iteration.
-  absl::flat_hash_map<int64_t, std::vector<std::unique_ptr<SplitProvider>>>
+  absl::flat_hash_map<int64_t, std::shared_ptr<IterationSplitProviders>>
       split_providers_ TF_GUARDED_BY(mu_);
   // Mapping from round robin iteration id to the round the iteration is
   // currently on. This is based on the data provided by client heartbeats,
@@ -355,6 +377,9 @@ class DataServiceDispatcherImpl {
   // Map from worker address to the time of the worker's last heartbeat.
   absl::flat_hash_map<std::string, absl::Time> latest_worker_heartbeats_time_
       TF_GUARDED_BY(mu_);
+  // Recommends the number of workers of the jobs from the client wait times
+  // and the worker buffer occupancies reported in heartbeats.
+  AutoScaler auto_scaler_;
 
   // Managers for all snapshot processes created or recovered during the
   // lifetime of this dispatcher instance.
@@ -0,0 +1,599 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/service/shm_data_transfer.h"
+
+#if defined(__linux__)
+
+#include <errno.h>
+#include <stddef.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/memory/memory.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/data/service/data_transfer.h"
+#include "tensorflow/core/data/service/worker.pb.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor.pb.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/host_info.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/random.h"
+#include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/platform/statusor.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+constexpr char kSocketNamePrefix[] = "tf_data_service_shm_";
+constexpr int kMaxBindAttempts = 100;
+constexpr uint64 kMinSegmentBytes = 16 << 20;  // 16MB.
+constexpr uint64 kBufferAlignment = 64;
+
+uint64 AlignedOffset(uint64 offset) {
+  return (offset + kBufferAlignment - 1) / kBufferAlignment * kBufferAlignment;
+}
+
+// Fills the abstract socket address of the server with `port`.
+socklen_t SocketAddress(int port, sockaddr_un* address) {
+  memset(address, 0, sizeof(*address));
+  address->sun_family = AF_UNIX;
+  const std::string name = absl::StrCat(kSocketNamePrefix, port);
+  // The leading NUL byte of `sun_path` puts the name in the abstract
+  // namespace, so there is no socket file to clean up.
+  memcpy(address->sun_path + 1, name.data(), name.size());
+  return offsetof(sockaddr_un, sun_path) + 1 + name.size();
+}
+
+Status WriteAll(int socket, const char* data, size_t size) {
+  while (size > 0) {
+    const ssize_t written = send(socket, data, size, MSG_NOSIGNAL);
+    if (written < 0) {
+      if (errno == EINTR) continue;
+      return errors::Unavailable("Failed to write to shm transfer socket: ",
+                                 strerror(errno));
+    }
+    data += written;
+    size -= written;
+  }
+  return OkStatus();
+}
+
+Status ReadAll(int socket, char* data, size_t size) {
+  while (size > 0) {
+    const ssize_t read = recv(socket, data, size, 0);
+    if (read < 0 && errno == EINTR) continue;
+    if (read <= 0) {
+      return errors::Unavailable("Failed to read from shm transfer socket: ",
+                                 read == 0 ? "connection closed"
+                                           : strerror(errno));
+    }
+    data += read;
+    size -= read;
+  }
+  return OkStatus();
+}
+
+// Messages are a uint64 size followed by the payload. If `fd` is not negative,
+// it is passed to the peer along with the size.
+Status SendMessage(int socket, absl::string_view payload, int fd = -1) {
+  uint64 size = payload.size();
+  iovec iov = {&size, sizeof(size)};
+  msghdr msg = {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+  if (fd >= 0) {
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+    memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+  }
+  ssize_t sent;
+  do {
+    sent = sendmsg(socket, &msg, MSG_NOSIGNAL);
+  } while (sent < 0 && errno == EINTR);
+  if (sent < 0) {
+    return errors::Unavailable("Failed to write to shm transfer socket: ",
+                               strerror(errno));
+  }
+  TF_RETURN_IF_ERROR(WriteAll(socket, reinterpret_cast<char*>(&size) + sent,
+                              sizeof(size) - sent));
+  return WriteAll(socket, payload.data(), payload.size());
+}
+
+// Receives a message sent by `SendMessage`. Sets `*fd` to the passed file
+// descriptor, which the caller then owns, or to -1.
+Status ReceiveMessage(int socket, std::string* payload, int* fd) {
+  *fd = -1;
+  uint64 size = 0;
+  iovec iov = {&size, sizeof(size)};
+  msghdr msg = {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+  ssize_t received;
+  do {
+    received = recvmsg(socket, &msg, MSG_CMSG_CLOEXEC);
+  } while (received < 0 && errno == EINTR);
+  if (received <= 0) {
+    return errors::Unavailable("Failed to read from shm transfer socket: ",
+                               received == 0 ? "connection closed"
+                                             : strerror(errno));
+  }
+  for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr;
+       cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+    if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+      memcpy(fd, CMSG_DATA(cmsg), sizeof(int));
+    }
+  }
+  Status s = ReadAll(socket, reinterpret_cast<char*>(&size) + received,
+                     sizeof(size) - received);
+  if (s.ok()) {
+    payload->resize(size);
+    s = ReadAll(socket, payload->data(), size);
+  }
+  if (!s.ok() && *fd >= 0) {
+    close(*fd);
+    *fd = -1;
+  }
+  return s;
+}
+
+// A shared memory segment, mapped in both the server and the client.
+class Segment {
+ public:
+  static StatusOr<std::unique_ptr<Segment>> Create(uint64 size) {
+    const int fd = memfd_create("tf_data_service_shm", MFD_CLOEXEC);
+    if (fd < 0) {
+      return errors::Internal("memfd_create failed: ", strerror(errno));
+    }
+    if (ftruncate(fd, size) != 0) {
+      const int error = errno;
+      close(fd);
+      return errors::ResourceExhausted("Failed to size shm segment to ", size,
+                                       " bytes: ", strerror(error));
+    }
+    return Map(fd, size, PROT_READ | PROT_WRITE);
+  }
+
+  // Takes ownership of `fd`.
+  static StatusOr<std::unique_ptr<Segment>> Map(int fd, uint64 size,
+                                                int protection) {
+    void* data = mmap(nullptr, size, protection, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED) {
+      const int error = errno;
+      close(fd);
+      return errors::ResourceExhausted("Failed to map shm segment of ", size,
+                                       " bytes: ", strerror(error));
+    }
+    return absl::WrapUnique(new Segment(fd, static_cast<char*>(data), size));
+  }
+
+  ~Segment() {
+    munmap(data_, size_);
+    close(fd_);
+  }
+
+  int fd() const { return fd_; }
+  char* data() const { return data_; }
+  uint64 size() const { return size_; }
+
+ private:
+  Segment(int fd, char* data, uint64 size)
+      : fd_(fd), data_(data), size_(size) {}
+
+  const int fd_;
+  char* const data_;
+  const uint64 size_;
+};
+
+// Precedes the serialized `GetElementResponse`, or the error message, in the
+// responses of the server.
+struct ResponseHeader {
+  int32 code;
+  // If true, the segment of the connection was replaced with the one whose
+  // file descriptor is attached to the response.
+  bool new_segment;
+  uint64 segment_size;
+};
+
+class ShmDataTransferServer : public DataTransferServer {
+ public:
+  explicit ShmDataTransferServer(GetElementT get_element)
+      : get_element_(std::move(get_element)) {}
+
+  ~ShmDataTransferServer() override {
+    {
+      mutex_lock l(mu_);
+      stopping_ = true;
+      for (int socket : connection_sockets_) shutdown(socket, SHUT_RDWR);
+    }
+    if (listen_socket_ >= 0) shutdown(listen_socket_, SHUT_RDWR);
+    // Joins the threads.
+    accept_thread_.reset();
+    std::vector<std::unique_ptr<Thread>> connection_threads;
+    {
+      mutex_lock l(mu_);
+      connection_threads.swap(connection_threads_);
+    }
+    connection_threads.clear();
+    if (listen_socket_ >= 0) close(listen_socket_);
+  }
+
+  Status Start() override {
+    listen_socket_ = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_socket_ < 0) {
+      return errors::Internal("Failed to create shm transfer socket: ",
+                              strerror(errno));
+    }
+    for (int attempt = 0; port_ == 0 && attempt < kMaxBindAttempts;
+         ++attempt) {
+      const int port = 1 + random::New64() % (kint32max - 1);
+      sockaddr_un address;
+      const socklen_t length = SocketAddress(port, &address);
+      if (bind(listen_socket_, reinterpret_cast<sockaddr*>(&address),
+               length) == 0) {
+        port_ = port;
+      } else if (errno != EADDRINUSE) {
+        return errors::Internal("Failed to bind shm transfer socket: ",
+                                strerror(errno));
+      }
+    }
+    if (port_ == 0) {
+      return errors::Unavailable("Failed to find a free shm transfer socket.");
+    }
+    if (listen(listen_socket_, SOMAXCONN) != 0) {
+      return errors::Internal("Failed to listen on shm transfer socket: ",
+                              strerror(errno));
+    }
+    accept_thread_ = absl::WrapUnique(Env::Default()->StartThread(
+        {}, "tf_data_service_shm_accept", [this] { AcceptLoop(); }));
+    return OkStatus();
+  }
+
+  int get_port() override { return port_; }
+
+  StatusOr<std::string> GetCompatibilityInfo() const override {
+    return port::Hostname();
+  }
+
+ private:
+  void AcceptLoop() {
+    while (true) {
+      const int socket = accept4(listen_socket_, nullptr, nullptr, SOCK_CLOEXEC);
+      if (socket < 0) {
+        if (errno == EINTR || errno == ECONNABORTED) continue;
+        return;
+      }
+      mutex_lock l(mu_);
+      if (stopping_) {
+        close(socket);
+        return;
+      }
+      connection_sockets_.insert(socket);
+      connection_threads_.push_back(absl::WrapUnique(Env::Default()->StartThread(
+          {}, "tf_data_service_shm_connection",
+          [this, socket] { ServeConnection(socket); })));
+    }
+  }
+
+  void ServeConnection(int socket) {
+    std::unique_ptr<Segment> segment;
+    while (true) {
+      std::string request_bytes;
+      int unused_fd;
+      if (!ReceiveMessage(socket, &request_bytes, &unused_fd).ok()) break;
+      if (unused_fd >= 0) close(unused_fd);
+
+      ResponseHeader header = {};
+      std::string body;
+      Status s = ProcessRequest(request_bytes, segment, &header, &body);
+      header.code = static_cast<int32>(s.code());
+      if (!s.ok()) body = std::string(s.message());
+      std::string payload(reinterpret_cast<const char*>(&header),
+                          sizeof(header));
+      payload.append(body);
+      if (!SendMessage(socket, payload, header.new_segment ? segment->fd() : -1)
+               .ok()) {
+        break;
+      }
+    }
+    mutex_lock l(mu_);
+    connection_sockets_.erase(socket);
+    close(socket);
+  }
+
+  // Fetches the element for the serialized `GetElementRequest` and copies it to
+  // `segment`, which is replaced if it is too small.
+  Status ProcessRequest(const std::string& request_bytes,
+                        std::unique_ptr<Segment>& segment,
+                        ResponseHeader* header, std::string* body) {
+    GetElementRequest request;
+    if (!request.ParseFromString(request_bytes)) {
+      return errors::InvalidArgument("Failed to parse GetElementRequest.");
+    }
+    GetElementResult result;
+    TF_RETURN_IF_ERROR(get_element_(&request, &result));
+
+    GetElementResponse response;
+    response.set_element_index(result.element_index);
+    response.set_end_of_sequence(result.end_of_sequence);
+    response.set_skip_task(result.skip);
+    uint64 segment_bytes = 0;
+    for (const Tensor& component : result.components) {
+      TensorProto* proto = response.mutable_uncompressed()->add_components();
+      if (DataTypeCanUseMemcpy(component.dtype())) {
+        proto->set_dtype(component.dtype());
+        component.shape().AsProto(proto->mutable_tensor_shape());
+        segment_bytes = AlignedOffset(segment_bytes) + component.TotalBytes();
+      } else {
+        component.AsProtoTensorContent(proto);
+      }
+    }
+    if (segment == nullptr || segment->size() < segment_bytes) {
+      segment.reset();
+      TF_ASSIGN_OR_RETURN(
+          segment, Segment::Create(std::max(kMinSegmentBytes,
+                                            AlignedOffset(2 * segment_bytes))));
+      header->new_segment = true;
+      header->segment_size = segment->size();
+    }
+    uint64 offset = 0;
+    for (const Tensor& component : result.components) {
+      if (!DataTypeCanUseMemcpy(component.dtype())) continue;
+      offset = AlignedOffset(offset);
+      const StringPiece data = component.tensor_data();
+      memcpy(segment->data() + offset, data.data(), data.size());
+      offset += data.size();
+    }
+    if (!response.SerializeToString(body)) {
+      return errors::Internal("Failed to serialize GetElementResponse.");
+    }
+    return OkStatus();
+  }
+
+  const GetElementT get_element_;
+  int listen_socket_ = -1;
+  int port_ = 0;
+  std::unique_ptr<Thread> accept_thread_;
+
+  mutex mu_;
+  bool stopping_ TF_GUARDED_BY(mu_) = false;
+  absl::flat_hash_set<int> connection_sockets_ TF_GUARDED_BY(mu_);
+  std::vector<std::unique_ptr<Thread>> connection_threads_ TF_GUARDED_BY(mu_);
+};
+
+class ShmDataTransferClient : public DataTransferClient {
+ public:
+  explicit ShmDataTransferClient(int port) : port_(port) {}
+
+  ~ShmDataTransferClient() override {
+    mutex_lock l(mu_);
+    for (Connection* connection : idle_connections_) delete connection;
+  }
+
+  // Opens a first connection, so that unreachable servers are detected when
+  // the client is built.
+  Status Connect() {
+    TF_ASSIGN_OR_RETURN(Connection * connection, NewConnection());
+    mutex_lock l(mu_);
+    idle_connections_.push_back(connection);
+    return OkStatus();
+  }
+
+  Status GetElement(const GetElementRequest& req,
+                    GetElementResult& result) override {
+    VLOG(3) << "GetElement for task " << req.task_id() << " from shm worker "
+            << "server.";
+    Connection* connection = nullptr;
+    {
+      mutex_lock l(mu_);
+      if (cancelled_) return errors::Cancelled("Client was cancelled.");
+      if (!idle_connections_.empty()) {
+        connection = idle_connections_.back();
+        idle_connections_.pop_back();
+      }
+    }
+    if (connection == nullptr) {
+      TF_ASSIGN_OR_RETURN(connection, NewConnection());
+    }
+    {
+      mutex_lock l(mu_);
+      active_sockets_.insert(connection->socket);
+    }
+    Status s = GetElement(connection, req, result);
+    mutex_lock l(mu_);
+    active_sockets_.erase(connection->socket);
+    if (cancelled_) {
+      delete connection;
+      return errors::Cancelled("Client was cancelled.");
+    }
+    if (s.ok() || !errors::IsUnavailable(s)) {
+      idle_connections_.push_back(connection);
+    } else {
+      delete connection;
+    }
+    return s;
+  }
+
+  void TryCancel() override {
+    VLOG(2) << "Cancel ShmDataTransferClient.";
+    mutex_lock l(mu_);
+    cancelled_ = true;
+    for (int socket : active_sockets_) shutdown(socket, SHUT_RDWR);
+  }
+
+  Status CheckCompatibility(
+      const std::string& compatibility_info) const override {
+    if (compatibility_info != port::Hostname()) {
+      return errors::FailedPrecondition(
+          "The shm data transfer server runs on host ", compatibility_info,
+          " but the client runs on host ", port::Hostname(), ".");
+    }
+    return OkStatus();
+  }
+
+ private:
+  struct Connection {
+    ~Connection() { close(socket); }
+
+    int socket = -1;
+    std::unique_ptr<Segment> segment;
+  };
+
+  StatusOr<Connection*> NewConnection() {
+    auto connection = std::make_unique<Connection>();
+    connection->socket = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (connection->socket < 0) {
+      return errors::Internal("Failed to create shm transfer socket: ",
+                              strerror(errno));
+    }
+    sockaddr_un address;
+    const socklen_t length = SocketAddress(port_, &address);
+    if (connect(connection->socket, reinterpret_cast<sockaddr*>(&address),
+                length) != 0) {
+      return errors::Unavailable("Failed to connect to shm transfer server ",
+                                 port_, ": ", strerror(errno));
+    }
+    return connection.release();
+  }
+
+  Status GetElement(Connection* connection, const GetElementRequest& req,
+                    GetElementResult& result) {
+    TF_RETURN_IF_ERROR(
+        SendMessage(connection->socket, req.SerializeAsString()));
+    std::string payload;
+    int fd;
+    TF_RETURN_IF_ERROR(ReceiveMessage(connection->socket, &payload, &fd));
+    ResponseHeader header;
+    if (payload.size() < sizeof(header)) {
+      if (fd >= 0) close(fd);
+      return errors::Internal("Truncated shm transfer response.");
+    }
+    memcpy(&header, payload.data(), sizeof(header));
+    const absl::string_view body =
+        absl::string_view(payload).substr(sizeof(header));
+    if (header.new_segment) {
+      if (fd < 0) {
+        return errors::Internal("Missing shm segment in transfer response.");
+      }
+      connection->segment.reset();
+      TF_ASSIGN_OR_RETURN(connection->segment,
+                          Segment::Map(fd, header.segment_size, PROT_READ));
+    } else if (fd >= 0) {
+      close(fd);
+    }
+    if (header.code != static_cast<int32>(absl::StatusCode::kOk)) {
+      return Status(static_cast<absl::StatusCode>(header.code), body);
+    }
+
+    GetElementResponse response;
+    if (!response.ParseFromArray(body.data(), body.size())) {
+      return errors::Internal("Failed to parse GetElementResponse.");
+    }
+    result.element_index = response.element_index();
+    result.end_of_sequence = response.end_of_sequence();
+    result.skip = response.skip_task();
+    uint64 offset = 0;
+    for (const TensorProto& proto : response.uncompressed().components()) {
+      if (!DataTypeCanUseMemcpy(proto.dtype())) {
+        result.components.emplace_back();
+        if (!result.components.back().FromProto(proto)) {
+          return errors::Internal("Failed to parse tensor.");
+        }
+        continue;
+      }
+      TensorShape shape;
+      TF_RETURN_IF_ERROR(
+          TensorShape::BuildTensorShape(proto.tensor_shape(), &shape));
+      Tensor component(proto.dtype(), shape);
+      offset = AlignedOffset(offset);
+      const uint64 size = component.TotalBytes();
+      if (connection->segment == nullptr ||
+          offset + size > connection->segment->size()) {
+        return errors::Internal("Shm transfer response exceeds its segment.");
+      }
+      memcpy(component.data(), connection->segment->data() + offset, size);
+      offset += size;
+      result.components.push_back(std::move(component));
+    }
+    return OkStatus();
+  }
+
+  const int port_;
+
+  mutex mu_;
+  std::vector<Connection*> idle_connections_ TF_GUARDED_BY(mu_);
+  absl::flat_hash_set<int> active_sockets_ TF_GUARDED_BY(mu_);
+  bool cancelled_ TF_GUARDED_BY(mu_) = false;
+};
+
+class ShmTransferRegistrar {
+ public:
+  ShmTransferRegistrar() {
+    DataTransferServer::Register(
+        kShmTransferProtocol,
+        [](DataTransferServer::GetElementT get_element,
+           std::shared_ptr<DataTransferServer>* out) {
+          *out = std::make_shared<ShmDataTransferServer>(std::move(get_element));
+          return OkStatus();
+        });
+    DataTransferClient::Register(
+        kShmTransferProtocol, [](DataTransferClient::Config config,
+                                 std::unique_ptr<DataTransferClient>* out) {
+          int port;
+          const size_t colon = config.address.rfind(':');
+          if (colon == std::string::npos ||
+              !absl::SimpleAtoi(config.address.substr(colon + 1), &port)) {
+            return errors::InvalidArgument(
+                "Invalid shm data transfer address: ", config.address);
+          }
+          auto client = std::make_unique<ShmDataTransferClient>(port);
+          TF_RETURN_IF_ERROR(client->Connect());
+          *out = std::move(client);
+          return OkStatus();
+        });
+  }
+};
+static ShmTransferRegistrar shm_transfer_registrar;
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // defined(__linux__)
@@ -0,0 +1,40 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_DATA_SERVICE_SHM_DATA_TRANSFER_H_
+#define TENSORFLOW_CORE_DATA_SERVICE_SHM_DATA_TRANSFER_H_
+
+namespace tensorflow {
+namespace data {
+
+// Data transfer protocol for clients and workers on the same host, registered
+// with `DataTransferServer` and `DataTransferClient` on Linux.
+//
+// The server listens on an abstract Unix domain socket named after its
+// "port", which replaces "%port%" in the worker's `data_transfer_address`.
+// Each client connection carries requests and element metadata, and owns a
+// shared memory segment that the server passes to the client and into which
+// it copies the buffers of the components with memcpy-able types. Elements
+// are thus transferred without serialization; other components, e.g.
+// compressed elements, are sent as `TensorProto`s. Clients issue concurrent
+// requests on separate connections, i.e. separate segments.
+//
+// Clients on other hosts fail the compatibility check (or cannot connect) and
+// fall back to gRPC.
+constexpr const char kShmTransferProtocol[] = "shm";
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DATA_SERVICE_SHM_DATA_TRANSFER_H_
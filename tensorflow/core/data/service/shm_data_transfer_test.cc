@@ -0,0 +1,144 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/service/shm_data_transfer.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/data/service/data_transfer.h"
+#include "tensorflow/core/data/service/worker.pb.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/host_info.h"
+#include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+std::shared_ptr<DataTransferServer> StartServer(
+    DataTransferServer::GetElementT get_element) {
+  std::shared_ptr<DataTransferServer> server;
+  TF_CHECK_OK(DataTransferServer::Build(kShmTransferProtocol,
+                                        std::move(get_element), &server));
+  TF_CHECK_OK(server->Start());
+  return server;
+}
+
+std::unique_ptr<DataTransferClient> BuildClient(DataTransferServer& server) {
+  std::unique_ptr<DataTransferClient> client;
+  TF_CHECK_OK(DataTransferClient::Build(
+      kShmTransferProtocol,
+      {"grpc", absl::StrCat("localhost:", server.get_port())}, &client));
+  return client;
+}
+
+TEST(ShmDataTransferTest, GetElement) {
+  std::shared_ptr<DataTransferServer> server =
+      StartServer([](const GetElementRequest* request,
+                     GetElementResult* result) {
+        result->element_index = request->task_id();
+        result->components.push_back(
+            test::AsTensor<float>({1.0, 2.0, 3.0}, TensorShape({3})));
+        result->components.push_back(test::AsScalar<tstring>("hello"));
+        result->components.push_back(test::AsTensor<int64_t>(
+            std::vector<int64_t>(1 << 20, request->task_id())));
+        return OkStatus();
+      });
+  std::unique_ptr<DataTransferClient> client = BuildClient(*server);
+  TF_ASSERT_OK(
+      client->CheckCompatibility(server->GetCompatibilityInfo().value()));
+
+  for (int64_t task_id : {1, 2}) {
+    GetElementRequest request;
+    request.set_task_id(task_id);
+    GetElementResult result;
+    TF_ASSERT_OK(client->GetElement(request, result));
+    EXPECT_EQ(result.element_index, task_id);
+    EXPECT_FALSE(result.end_of_sequence);
+    ASSERT_EQ(result.components.size(), 3);
+    test::ExpectEqual(result.components[0], test::AsTensor<float>(
+                                                {1.0, 2.0, 3.0},
+                                                TensorShape({3})));
+    test::ExpectEqual(result.components[1], test::AsScalar<tstring>("hello"));
+    test::ExpectEqual(result.components[2],
+                      test::AsTensor<int64_t>(
+                          std::vector<int64_t>(1 << 20, task_id)));
+  }
+}
+
+TEST(ShmDataTransferTest, EndOfSequence) {
+  std::shared_ptr<DataTransferServer> server = StartServer(
+      [](const GetElementRequest* request, GetElementResult* result) {
+        result->end_of_sequence = true;
+        return OkStatus();
+      });
+  std::unique_ptr<DataTransferClient> client = BuildClient(*server);
+  GetElementResult result;
+  TF_ASSERT_OK(client->GetElement(GetElementRequest(), result));
+  EXPECT_TRUE(result.end_of_sequence);
+  EXPECT_TRUE(result.components.empty());
+}
+
+TEST(ShmDataTransferTest, Error) {
+  std::shared_ptr<DataTransferServer> server = StartServer(
+      [](const GetElementRequest* request, GetElementResult* result) {
+        return errors::NotFound("No task");
+      });
+  std::unique_ptr<DataTransferClient> client = BuildClient(*server);
+  GetElementResult result;
+  Status s = client->GetElement(GetElementRequest(), result);
+  EXPECT_TRUE(errors::IsNotFound(s)) << s;
+  EXPECT_EQ(s.message(), "No task");
+}
+
+TEST(ShmDataTransferTest, Cancel) {
+  std::shared_ptr<DataTransferServer> server = StartServer(
+      [](const GetElementRequest* request, GetElementResult* result) {
+        return OkStatus();
+      });
+  std::unique_ptr<DataTransferClient> client = BuildClient(*server);
+  client->TryCancel();
+  GetElementResult result;
+  EXPECT_TRUE(
+      errors::IsCancelled(client->GetElement(GetElementRequest(), result)));
+}
+
+TEST(ShmDataTransferTest, IncompatibleHost) {
+  std::shared_ptr<DataTransferServer> server = StartServer(
+      [](const GetElementRequest* request, GetElementResult* result) {
+        return OkStatus();
+      });
+  std::unique_ptr<DataTransferClient> client = BuildClient(*server);
+  EXPECT_TRUE(errors::IsFailedPrecondition(
+      client->CheckCompatibility(absl::StrCat(port::Hostname(), "-other"))));
+}
+
+TEST(ShmDataTransferTest, NoServer) {
+  std::unique_ptr<DataTransferClient> client;
+  EXPECT_TRUE(errors::IsUnavailable(DataTransferClient::Build(
+      kShmTransferProtocol, {"grpc", "localhost:1"}, &client)));
+}
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
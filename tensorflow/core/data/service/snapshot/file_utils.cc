@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/data/service/snapshot/file_utils.h"
 
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -37,6 +38,11 @@ namespace {
 
 constexpr const char kTempFileSuffix[] = ".tmp";
 
+// The prefix of chunk references. Chunk files can't start with it: TFRecord
+// files start with a record length, and compressed files with a header.
+constexpr absl::string_view kChunkReferencePrefix =
+    "tf.data snapshot chunk reference: ";
+
 tsl::Status AtomicallyWrite(
     absl::string_view filename, tsl::Env* env,
     absl::FunctionRef<tsl::Status(const std::string&)> nonatomically_write) {
@@ -111,6 +117,32 @@ tsl::Status AtomicallyWriteTFRecords(absl::string_view filename,
   return tsl::OkStatus();
 }
 
+tsl::Status AtomicallyWriteChunkReference(absl::string_view reference_file,
+                                          absl::string_view chunk_file,
+                                          tsl::Env* env) {
+  return AtomicallyWriteStringToFile(
+      reference_file, absl::StrCat(kChunkReferencePrefix, chunk_file), env);
+}
+
+tsl::StatusOr<std::string> ResolveChunkFile(const std::string& chunk_file,
+                                            tsl::Env* env) {
+  std::unique_ptr<tsl::RandomAccessFile> file;
+  TF_RETURN_IF_ERROR(env->NewRandomAccessFile(chunk_file, &file));
+  std::string scratch(kChunkReferencePrefix.size(), '\0');
+  absl::string_view prefix;
+  tsl::Status status =
+      file->Read(/*offset=*/0, kChunkReferencePrefix.size(), &prefix,
+                 scratch.data());
+  if (tsl::errors::IsOutOfRange(status) ||
+      (status.ok() && prefix != kChunkReferencePrefix)) {
+    return chunk_file;
+  }
+  TF_RETURN_IF_ERROR(status);
+  std::string reference;
+  TF_RETURN_IF_ERROR(tsl::ReadFileToString(env, chunk_file, &reference));
+  return reference.substr(kChunkReferencePrefix.size());
+}
+
 tsl::StatusOr<std::vector<std::string>> GetChildren(absl::string_view directory,
                                                     tsl::Env* env) {
   std::vector<std::string> files, result;
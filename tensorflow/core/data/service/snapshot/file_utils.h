@@ -51,6 +51,18 @@ tsl::Status AtomicallyWriteTFRecords(absl::string_view filename,
                                      absl::string_view compression,
                                      tsl::Env* env);
 
+// Atomically writes a reference to `chunk_file` to `reference_file`. The
+// snapshots with a chunk store commit references to the chunk store files
+// instead of chunk files.
+tsl::Status AtomicallyWriteChunkReference(absl::string_view reference_file,
+                                          absl::string_view chunk_file,
+                                          tsl::Env* env);
+
+// Returns the chunk file referenced by `chunk_file` if it is a chunk reference,
+// or `chunk_file` otherwise.
+tsl::StatusOr<std::string> ResolveChunkFile(const std::string& chunk_file,
+                                            tsl::Env* env);
+
 // Returns the relative paths of the children of `directory`, ignoring temporary
 // files. Returns an empty vector if the directory does not have any children.
 tsl::StatusOr<std::vector<std::string>> GetChildren(absl::string_view directory,
@@ -110,6 +110,34 @@ TEST(FileUtilsTest, AtomicallyWriteTFRecord) {
   EXPECT_EQ(out.DebugString(), in.front().DebugString());
 }
 
+TEST(FileUtilsTest, ResolveChunkReference) {
+  TF_ASSERT_OK_AND_ASSIGN(std::string directory, CreateTestDirectory());
+  std::string chunk_file = tsl::io::JoinPath(directory, "chunk");
+  std::string reference_file = tsl::io::JoinPath(directory, "reference");
+  TF_ASSERT_OK(AtomicallyWriteChunkReference(reference_file, chunk_file,
+                                             tsl::Env::Default()));
+  EXPECT_THAT(ResolveChunkFile(reference_file, tsl::Env::Default()),
+              IsOkAndHolds(chunk_file));
+}
+
+TEST(FileUtilsTest, ResolveChunkFile) {
+  TF_ASSERT_OK_AND_ASSIGN(std::string directory, CreateTestDirectory());
+  std::string chunk_file = tsl::io::JoinPath(directory, "chunk");
+  std::vector<Tensor> tensors = {CreateTensor<int64_t>(TensorShape({1}), {1})};
+  TF_ASSERT_OK(AtomicallyWriteTFRecords(chunk_file, tensors,
+                                        tsl::io::compression::kNone,
+                                        tsl::Env::Default()));
+  EXPECT_THAT(ResolveChunkFile(chunk_file, tsl::Env::Default()),
+              IsOkAndHolds(chunk_file));
+}
+
+TEST(FileUtilsTest, ResolveMissingChunkFile) {
+  TF_ASSERT_OK_AND_ASSIGN(std::string directory, CreateTestDirectory());
+  EXPECT_THAT(ResolveChunkFile(tsl::io::JoinPath(directory, "chunk"),
+                               tsl::Env::Default()),
+              StatusIs(tsl::error::NOT_FOUND));
+}
+
 TEST(FileUtilsTest, GetChildren) {
   TF_ASSERT_OK_AND_ASSIGN(std::string directory, CreateTestDirectory());
   std::string test_file = tsl::io::JoinPath(directory, "test_file");
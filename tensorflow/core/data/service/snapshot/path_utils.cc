@@ -229,5 +229,12 @@ std::string UncommittedChunksDirectory(absl::string_view snapshot_path,
   return tsl::io::JoinPath(StreamDirectory(snapshot_path, stream_index),
                            kUncommittedChunksDirectoryName);
 }
+
+std::string ChunkStoreFilePath(absl::string_view chunk_store_path,
+                               uint64_t fingerprint) {
+  return tsl::io::JoinPath(
+      chunk_store_path,
+      absl::StrCat("chunk_", absl::Hex(fingerprint, absl::kZeroPad16)));
+}
 }  // namespace data
 }  // namespace tensorflow
@@ -125,6 +125,11 @@ std::string CommittedChunksDirectory(absl::string_view snapshot_path);
 std::string UncommittedChunksDirectory(absl::string_view snapshot_path,
                                        int64_t stream_index);
 
+// Returns the path of the chunk with contents fingerprint `fingerprint` in the
+// chunk store at `chunk_store_path`.
+std::string ChunkStoreFilePath(absl::string_view chunk_store_path,
+                               uint64_t fingerprint);
+
 }  // namespace data
 }  // namespace tensorflow
 
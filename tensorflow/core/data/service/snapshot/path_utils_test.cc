@@ -258,6 +258,11 @@ TEST(PathUtilsTest, UncommittedChunksDirectory) {
       MatchesRegex("/path/to/snapshot.streams.stream_0.uncommitted_chunks"));
 }
 
+TEST(PathUtilsTest, ChunkStoreFilePath) {
+  EXPECT_THAT(ChunkStoreFilePath("/path/to/chunk_store", 0xabc),
+              MatchesRegex("/path/to/chunk_store.chunk_0000000000000abc"));
+}
+
 }  // namespace
 }  // namespace data
 }  // namespace tensorflow
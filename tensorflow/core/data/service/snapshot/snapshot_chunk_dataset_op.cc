@@ -19,6 +19,7 @@ limitations under the License.
 #include <vector>
 
 #include "tensorflow/core/data/name_utils.h"
+#include "tensorflow/core/data/service/snapshot/file_utils.h"
 #include "tensorflow/core/data/snapshot_utils.h"
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/framework/op_kernel.h"
@@ -28,6 +29,7 @@ limitations under the License.
 #include "tensorflow/tsl/platform/env.h"
 #include "tensorflow/tsl/platform/errors.h"
 #include "tensorflow/tsl/platform/status.h"
+#include "tensorflow/tsl/platform/statusor.h"
 #include "tensorflow/tsl/platform/tstring.h"
 
 namespace tensorflow {
@@ -115,8 +117,11 @@ class SnapshotChunkDatasetOp::Dataset : public DatasetBase {
         : DatasetIterator<Dataset>(params) {}
 
     Status Initialize(IteratorContext* ctx) override {
+      // Chunks of snapshots with a chunk store reference the chunk store files.
+      TF_ASSIGN_OR_RETURN(std::string chunk_file,
+                          ResolveChunkFile(dataset()->chunk_file_, ctx->env()));
       reader_ = std::make_unique<snapshot_util::TFRecordReader>(
-          dataset()->chunk_file_, dataset()->compression_, dataset()->dtypes_,
+          chunk_file, dataset()->compression_, dataset()->dtypes_,
           kTFRecordReaderOutputBufferSize);
       return reader_->Initialize(ctx->env());
     }
@@ -17,6 +17,7 @@ limitations under the License.
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <memory>
 #include <optional>
 #include <string>
@@ -37,11 +38,13 @@ limitations under the License.
 #include "tensorflow/core/framework/types.pb.h"
 #include "tensorflow/tsl/platform/env.h"
 #include "tensorflow/tsl/platform/errors.h"
+#include "tensorflow/tsl/platform/hash.h"
 #include "tensorflow/tsl/platform/mutex.h"
 #include "tensorflow/tsl/platform/path.h"
 #include "tensorflow/tsl/platform/regexp.h"
 #include "tensorflow/tsl/platform/status.h"
 #include "tensorflow/tsl/platform/statusor.h"
+#include "tensorflow/tsl/platform/threadpool.h"
 #include "tensorflow/tsl/profiler/lib/traceme.h"
 
 namespace tensorflow {
@@ -65,6 +68,42 @@ StatusOr<int64_t> GetFileIndex(const std::string& filename,
   return index;
 }
 
+// Combines the fingerprint of `element` into `fingerprint`. Resets
+// `fingerprint` if the element can't be fingerprinted, in which case the chunk
+// is not deduplicated.
+void FingerprintElement(const std::vector<Tensor>& element,
+                        std::optional<uint64_t>& fingerprint) {
+  if (!fingerprint.has_value()) {
+    return;
+  }
+  uint64_t hash = tsl::Hash64Combine(*fingerprint, element.size());
+  for (const Tensor& tensor : element) {
+    hash = tsl::Hash64Combine(hash, tensor.dtype());
+    hash = tsl::Hash64Combine(hash, tensor.shape().dims());
+    for (int64_t dim_size : tensor.shape().dim_sizes()) {
+      hash = tsl::Hash64Combine(hash, dim_size);
+    }
+    switch (tensor.dtype()) {
+      case DT_RESOURCE:
+      case DT_VARIANT:
+        fingerprint.reset();
+        return;
+      case DT_STRING: {
+        auto strings = tensor.flat<tstring>();
+        for (int64_t i = 0; i < strings.size(); ++i) {
+          hash = tsl::Hash64Combine(hash, tsl::Hash64(strings(i)));
+        }
+        break;
+      }
+      default: {
+        StringPiece data = tensor.tensor_data();
+        hash = tsl::Hash64Combine(hash, tsl::Hash64(data.data(), data.size()));
+      }
+    }
+  }
+  fingerprint = hash;
+}
+
 }  // namespace
 
 SnapshotStreamWriter::SnapshotStreamWriter(
@@ -110,8 +149,12 @@ Status SnapshotStreamWriter::WriteSnapshot() TF_LOCKS_EXCLUDED(mu_) {
   // TODO(b/258691097): Write the "LEASE" file periodically.
   TF_RETURN_IF_ERROR(InitializeDirectories());
   TF_RETURN_IF_ERROR(Restore());
-  while (ShouldWriteChunk()) {
-    TF_RETURN_IF_ERROR(WriteChunk());
+  if (params_.num_writer_threads > 1) {
+    TF_RETURN_IF_ERROR(WriteChunksInParallel());
+  } else {
+    while (ShouldWriteChunk()) {
+      TF_RETURN_IF_ERROR(WriteChunk());
+    }
   }
   mutex_lock l(mu_);
   return completed_.status();
@@ -128,6 +171,10 @@ Status SnapshotStreamWriter::InitializeDirectories() {
       params_.env->RecursivelyCreateDir(params_.UncommittedChunksDirectory()));
   TF_RETURN_IF_ERROR(
       params_.env->RecursivelyCreateDir(params_.CheckpointsDirectory()));
+  if (!params_.chunk_store_path.empty()) {
+    TF_RETURN_IF_ERROR(
+        params_.env->RecursivelyCreateDir(params_.chunk_store_path));
+  }
   return OkStatus();
 }
 
@@ -141,7 +188,8 @@ Status SnapshotStreamWriter::WriteChunk() {
             << ", stream " << params_.stream_index << ", chunk " << chunk_index_
             << ".";
 
-  std::string chunk_file_path = GetChunkFilePath();
+  std::string chunk_file_path = GetChunkFilePath(chunk_index_);
+  chunk_fingerprint_ = InitialChunkFingerprint();
   snapshot_util::TFRecordWriter writer(chunk_file_path, params_.compression);
   TF_RETURN_IF_ERROR(writer.Initialize(params_.env));
   while (ShouldWriteRecord()) {
@@ -151,6 +199,99 @@ Status SnapshotStreamWriter::WriteChunk() {
   return CommitChunk();
 }
 
+Status SnapshotStreamWriter::WriteChunksInParallel() {
+  // Chunks are committed in order, after the chunks before them, so that the
+  // uncommitted chunks up to the last checkpoint are always complete.
+  std::deque<std::shared_ptr<PendingChunk>> pending_chunks;
+  tsl::thread::ThreadPool thread_pool(
+      params_.env, "tf_data_service_snapshot_writer",
+      static_cast<int>(params_.num_writer_threads));
+  Status status;
+  while (status.ok() && ShouldWriteChunk()) {
+    auto chunk = std::make_shared<PendingChunk>();
+    status = ReadChunk(*chunk);
+    if (!status.ok()) {
+      break;
+    }
+    thread_pool.Schedule([this, chunk]() {
+      chunk->status = WriteChunkFile(*chunk);
+      chunk->elements.clear();
+      chunk->written.Notify();
+    });
+    pending_chunks.push_back(std::move(chunk));
+    while (status.ok() && static_cast<int64_t>(pending_chunks.size()) >=
+                              params_.num_writer_threads) {
+      status = CommitPendingChunk(*pending_chunks.front());
+      pending_chunks.pop_front();
+    }
+  }
+  while (status.ok() && !pending_chunks.empty()) {
+    status = CommitPendingChunk(*pending_chunks.front());
+    pending_chunks.pop_front();
+  }
+  // If an error happened, the thread pool waits for the remaining chunk files
+  // to be written; they are not committed.
+  return status;
+}
+
+Status SnapshotStreamWriter::ReadChunk(PendingChunk& chunk) {
+  chunk.chunk_index = chunk_index_;
+  while (ShouldWriteRecord()) {
+    std::vector<Tensor> element;
+    TF_RETURN_IF_ERROR(iterator_->GetNext(element, end_of_sequence_));
+    if (end_of_sequence_) {
+      break;
+    }
+    chunk_size_bytes_ += EstimatedSizeBytes(element);
+    ++chunk_num_elements_;
+    chunk.elements.push_back(std::move(element));
+  }
+  chunk.num_elements = chunk_num_elements_;
+  chunk.size_bytes = chunk_size_bytes_;
+  // The iterator moves on to the next chunks before this one is committed, so
+  // its checkpoint is taken now.
+  if (ShouldSave()) {
+    TF_ASSIGN_OR_RETURN(chunk.checkpoint, iterator_->Save());
+    last_checkpoint_time_ = absl::FromUnixMicros(params_.env->NowMicros());
+  }
+  ++chunk_index_;
+  chunk_size_bytes_ = 0;
+  chunk_num_elements_ = 0;
+  return OkStatus();
+}
+
+Status SnapshotStreamWriter::WriteChunkFile(PendingChunk& chunk) {
+  LOG(INFO) << "Writing distributed tf.data snapshot " << params_.snapshot_path
+            << ", stream " << params_.stream_index << ", chunk "
+            << chunk.chunk_index << ".";
+  tsl::profiler::TraceMe activity("SnapshotWriteChunk",
+                                  tsl::profiler::TraceMeLevel::kInfo);
+  snapshot_util::TFRecordWriter writer(GetChunkFilePath(chunk.chunk_index),
+                                       params_.compression);
+  TF_RETURN_IF_ERROR(writer.Initialize(params_.env));
+  chunk.fingerprint = InitialChunkFingerprint();
+  for (const std::vector<Tensor>& element : chunk.elements) {
+    TF_RETURN_IF_ERROR(writer.WriteTensors(element));
+    FingerprintElement(element, chunk.fingerprint);
+  }
+  return writer.Close();
+}
+
+Status SnapshotStreamWriter::CommitPendingChunk(PendingChunk& chunk) {
+  chunk.written.WaitForNotification();
+  TF_RETURN_IF_ERROR(chunk.status);
+  if (chunk.checkpoint.has_value()) {
+    TF_RETURN_IF_ERROR(WriteCheckpoint(chunk.chunk_index, chunk.num_elements,
+                                       *chunk.checkpoint));
+  }
+  TF_RETURN_IF_ERROR(CommitChunkFile(
+      GetChunkFilePath(chunk.chunk_index),
+      GetCommittedChunkFilePath(chunk.chunk_index, chunk.num_elements),
+      chunk.fingerprint));
+  metrics::RecordTFDataServiceSnapshotBytesCommitted(chunk.size_bytes);
+  return OkStatus();
+}
+
 Status SnapshotStreamWriter::CommitChunk() {
   // Writes the checkpoint before committing the chunk. If the worker fails in
   // between, the restarted worker will synchronize the checkpoint with the
@@ -158,25 +299,58 @@ Status SnapshotStreamWriter::CommitChunk() {
   if (ShouldSave()) {
     TF_RETURN_IF_ERROR(Save());
   }
-  TF_RETURN_IF_ERROR(
-      params_.env->RenameFile(GetChunkFilePath(), GetCommittedChunkFilePath()));
+  TF_RETURN_IF_ERROR(CommitChunkFile(
+      GetChunkFilePath(chunk_index_),
+      GetCommittedChunkFilePath(chunk_index_, chunk_num_elements_),
+      chunk_fingerprint_));
   ++chunk_index_;
   metrics::RecordTFDataServiceSnapshotBytesCommitted(chunk_size_bytes_);
   chunk_size_bytes_ = 0;
   chunk_num_elements_ = 0;
+  chunk_fingerprint_.reset();
   return OkStatus();
 }
 
-std::string SnapshotStreamWriter::GetChunkFilePath() const {
+Status SnapshotStreamWriter::CommitChunkFile(
+    const std::string& chunk_file, const std::string& committed_chunk_file,
+    std::optional<uint64_t> fingerprint) {
+  if (params_.chunk_store_path.empty() || !fingerprint.has_value()) {
+    return params_.env->RenameFile(chunk_file, committed_chunk_file);
+  }
+  // The reference is committed before the chunk file is moved: if the worker
+  // fails in between, the restarted worker commits the uncommitted chunk file
+  // over the reference. Snapshots are only read after they are done, so the
+  // reference is not read before the chunk store file exists.
+  std::string chunk_store_file =
+      ChunkStoreFilePath(params_.chunk_store_path, *fingerprint);
+  bool chunk_stored = params_.env->FileExists(chunk_store_file).ok();
+  TF_RETURN_IF_ERROR(AtomicallyWriteChunkReference(
+      committed_chunk_file, chunk_store_file, params_.env));
+  if (chunk_stored) {
+    return params_.env->DeleteFile(chunk_file);
+  }
+  return params_.env->RenameFile(chunk_file, chunk_store_file);
+}
+
+std::optional<uint64_t> SnapshotStreamWriter::InitialChunkFingerprint() const {
+  if (params_.chunk_store_path.empty()) {
+    return std::nullopt;
+  }
+  // Chunks with different compressions have different file contents.
+  return tsl::Hash64(params_.compression);
+}
+
+std::string SnapshotStreamWriter::GetChunkFilePath(int64_t chunk_index) const {
   return tsl::io::JoinPath(params_.UncommittedChunksDirectory(),
-                           absl::StrCat("chunk_", chunk_index_));
+                           absl::StrCat("chunk_", chunk_index));
 }
 
-std::string SnapshotStreamWriter::GetCommittedChunkFilePath() const {
+std::string SnapshotStreamWriter::GetCommittedChunkFilePath(
+    int64_t chunk_index, int64_t chunk_num_elements) const {
   return tsl::io::JoinPath(
       params_.CommittedChunksDirectory(),
-      absl::StrCat("chunk_", params_.stream_index, "_", chunk_index_, "_",
-                   chunk_num_elements_));
+      absl::StrCat("chunk_", params_.stream_index, "_", chunk_index, "_",
+                   chunk_num_elements));
 }
 
 bool SnapshotStreamWriter::ShouldWriteRecord() const TF_LOCKS_EXCLUDED(mu_) {
@@ -195,6 +369,7 @@ Status SnapshotStreamWriter::WriteRecord(
   tsl::profiler::TraceMe activity("SnapshotWriteRecord",
                                   tsl::profiler::TraceMeLevel::kInfo);
   TF_RETURN_IF_ERROR(writer.WriteTensors(element));
+  FingerprintElement(element, chunk_fingerprint_);
   chunk_size_bytes_ += EstimatedSizeBytes(element);
   ++chunk_num_elements_;
   return OkStatus();
@@ -274,13 +449,19 @@ Status SnapshotStreamWriter::Save() {
             << params_.stream_index << ", chunk " << chunk_index_
             << ", chunk size in bytes: " << chunk_size_bytes_
             << ", number of elements in chunk: " << chunk_num_elements_ << ".";
+  TF_ASSIGN_OR_RETURN(std::vector<Tensor> serialized_iterator,
+                      iterator_->Save());
+  return WriteCheckpoint(chunk_index_, chunk_num_elements_,
+                         serialized_iterator);
+}
+
+Status SnapshotStreamWriter::WriteCheckpoint(
+    int64_t chunk_index, int64_t chunk_num_elements,
+    const std::vector<Tensor>& serialized_iterator) {
   tsl::profiler::TraceMe activity("SnapshotCheckpoint",
                                   tsl::profiler::TraceMeLevel::kInfo);
   absl::Time start_time = absl::FromUnixMicros(params_.env->NowMicros());
-  std::string checkpoint_path =
-      CheckpointPath(chunk_index_, chunk_num_elements_);
-  TF_ASSIGN_OR_RETURN(std::vector<Tensor> serialized_iterator,
-                      iterator_->Save());
+  std::string checkpoint_path = CheckpointPath(chunk_index, chunk_num_elements);
   TF_RETURN_IF_ERROR(AtomicallyWriteTFRecords(
       checkpoint_path, serialized_iterator, params_.compression, params_.env));
   absl::Time end_time = absl::FromUnixMicros(params_.env->NowMicros());
@@ -288,10 +469,10 @@ Status SnapshotStreamWriter::Save() {
             << "Checkpointing distributed tf.data snapshot writer took "
             << (end_time - start_time);
   last_checkpoint_time_ = end_time;
-  return DeleteOutdatedCheckpoints();
+  return DeleteOutdatedCheckpoints(chunk_index);
 }
 
-Status SnapshotStreamWriter::DeleteOutdatedCheckpoints() {
+Status SnapshotStreamWriter::DeleteOutdatedCheckpoints(int64_t chunk_index) {
   if (params_.test_only_keep_temp_files) {
     return OkStatus();
   }
@@ -310,7 +491,7 @@ Status SnapshotStreamWriter::DeleteOutdatedCheckpoints() {
     TF_ASSIGN_OR_RETURN(auto checkpoint_filename_tokens,
                         ParseCheckpointFilename(checkpoint_filename));
     auto [checkpoint_index, unused] = checkpoint_filename_tokens;
-    if (checkpoint_index < chunk_index_) {
+    if (checkpoint_index < chunk_index) {
       TF_RETURN_IF_ERROR(params_.env->DeleteFile(checkpoint_filepath));
     }
   }
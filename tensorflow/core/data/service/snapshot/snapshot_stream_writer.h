@@ -21,6 +21,7 @@ limitations under the License.
 #include <optional>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/strings/substitute.h"
 #include "absl/time/time.h"
@@ -29,9 +30,11 @@ limitations under the License.
 #include "tensorflow/core/data/service/task_runner.h"
 #include "tensorflow/core/data/service/worker.pb.h"
 #include "tensorflow/core/data/snapshot_utils.h"
+#include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/protobuf/service_config.pb.h"
 #include "tensorflow/tsl/platform/env.h"
 #include "tensorflow/tsl/platform/mutex.h"
+#include "tensorflow/tsl/platform/notification.h"
 #include "tensorflow/tsl/platform/status.h"
 #include "tensorflow/tsl/platform/statusor.h"
 #include "tensorflow/tsl/platform/thread_annotations.h"
@@ -41,6 +44,7 @@ namespace data {
 
 constexpr int64_t kDefaultMaxChunkSizeBytes = 2 * (size_t{1} << 30);  // 2GB
 constexpr absl::Duration kDefaultCheckpointInterval = absl::Minutes(20);
+constexpr int64_t kDefaultNumWriterThreads = 1;
 
 struct SnapshotWriterParams {
   // The directory path of the snapshot. See the comment on SnapshotStreamWriter
@@ -63,6 +67,18 @@ struct SnapshotWriterParams {
   // How often should checkpoints be written.
   absl::Duration checkpoint_interval = kDefaultCheckpointInterval;
 
+  // The number of threads that compress and write chunk files. If greater than
+  // 1, chunks are written concurrently while the next chunk is being produced,
+  // and committed in order. This holds up to `num_writer_threads + 1` chunks in
+  // memory.
+  int64_t num_writer_threads = kDefaultNumWriterThreads;
+
+  // If not empty, the chunk files are stored in this directory under the
+  // fingerprint of their contents, and the committed chunks reference them.
+  // Identical chunks are stored once. Must be on the same file system as the
+  // snapshot.
+  std::string chunk_store_path;
+
   // If true, keep temporary files (e.g., checkpoints) after completing the
   // snapshot. Used only for unit testing.
   bool test_only_keep_temp_files = false;
@@ -158,12 +174,54 @@ class SnapshotStreamWriter {
   // Writes the next chunk.
   Status WriteChunk();
 
+  // A chunk read from the iterator and written by a writer thread.
+  struct PendingChunk {
+    int64_t chunk_index = 0;
+    int64_t num_elements = 0;
+    int64_t size_bytes = 0;
+    std::vector<std::vector<Tensor>> elements;
+    // The fingerprint of the chunk file contents, set by the writer thread if
+    // the chunk can be stored in the chunk store.
+    std::optional<uint64_t> fingerprint;
+    // The iterator checkpoint after the last element of the chunk, if one
+    // should be written before committing the chunk.
+    std::optional<std::vector<Tensor>> checkpoint;
+    Status status;
+    tsl::Notification written;
+  };
+
+  // Writes the chunks using `params_.num_writer_threads` threads.
+  Status WriteChunksInParallel();
+
+  // Reads the next chunk from the iterator into `chunk`.
+  Status ReadChunk(PendingChunk& chunk);
+
+  // Writes the chunk file of `chunk`, and sets its fingerprint.
+  Status WriteChunkFile(PendingChunk& chunk);
+
+  // Waits for the chunk file of `chunk` to be written, then writes its
+  // checkpoint, if any, and commits it.
+  Status CommitPendingChunk(PendingChunk& chunk);
+
   // Commits the current chunk.
   Status CommitChunk();
 
-  // Returns the path of the current chunk.
-  std::string GetChunkFilePath() const;
-  std::string GetCommittedChunkFilePath() const;
+  // Moves `chunk_file` to `committed_chunk_file`. If there is a chunk store and
+  // the chunk has a `fingerprint`, the chunk file is moved to the chunk store
+  // (or deleted if the store already has it), and `committed_chunk_file`
+  // references it.
+  Status CommitChunkFile(const std::string& chunk_file,
+                         const std::string& committed_chunk_file,
+                         std::optional<uint64_t> fingerprint);
+
+  // Returns the initial fingerprint of a chunk, or nullopt if there is no chunk
+  // store.
+  std::optional<uint64_t> InitialChunkFingerprint() const;
+
+  // Returns the path of the chunk `chunk_index`.
+  std::string GetChunkFilePath(int64_t chunk_index) const;
+  std::string GetCommittedChunkFilePath(int64_t chunk_index,
+                                        int64_t chunk_num_elements) const;
 
   // Returns true if the writer should write the next record to the current
   // chunk.
@@ -184,8 +242,14 @@ class SnapshotStreamWriter {
   // Saves an iterator checkpoint.
   Status Save();
 
-  // After committing a checkpoint, deletes the previous checkpoints.
-  Status DeleteOutdatedCheckpoints();
+  // Writes `serialized_iterator` as the checkpoint for `chunk_index` with
+  // `chunk_num_elements`.
+  Status WriteCheckpoint(int64_t chunk_index, int64_t chunk_num_elements,
+                         const std::vector<Tensor>& serialized_iterator);
+
+  // After committing the checkpoint for `chunk_index`, deletes the previous
+  // checkpoints.
+  Status DeleteOutdatedCheckpoints(int64_t chunk_index);
 
   // Deletes all checkpoints.
   Status DeleteCheckpoints();
@@ -222,6 +286,8 @@ class SnapshotStreamWriter {
   int64_t chunk_size_bytes_ = 0;
   // Number of elements in current chunk.
   int64_t chunk_num_elements_ = 0;
+  // Fingerprint of the elements in current chunk.
+  std::optional<uint64_t> chunk_fingerprint_;
   // Timestamp when the last checkpoint is taken.
   absl::Time last_checkpoint_time_ = absl::Now();
 
@@ -23,6 +23,7 @@ limitations under the License.
 
 #include "absl/strings/str_cat.h"
 #include "tensorflow/core/data/service/common.pb.h"
+#include "tensorflow/core/data/service/snapshot/file_utils.h"
 #include "tensorflow/core/data/service/snapshot/path_utils.h"
 #include "tensorflow/core/data/service/task_runner.h"
 #include "tensorflow/core/data/service/test_util.h"
@@ -230,6 +231,70 @@ TEST_P(SnapshotStreamWriterParameterizedTest, WriteSnapshotChunks) {
   }
 }
 
+TEST_P(SnapshotStreamWriterParameterizedTest, WriteSnapshotChunksInParallel) {
+  int64_t range = 10;
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<StandaloneTaskIterator> iterator,
+                          TestIterator(testing::RangeDataset(range)));
+
+  std::string compression = GetParam();
+  TF_ASSERT_OK_AND_ASSIGN(std::string snapshot_path, CreateSnapshotDirectory());
+  SnapshotWriterParams writer_params{snapshot_path, /*stream_index=*/0,
+                                     compression, Env::Default(),
+                                     /*max_chunk_size_bytes=*/1};
+  writer_params.num_writer_threads = 3;
+  SnapshotStreamWriter snapshot_writer(writer_params, std::move(iterator));
+  EXPECT_THAT(snapshot_writer.Wait(), IsOkAndHolds(true));
+
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_THAT(ReadSnapshot<int64_t>(
+                    tsl::io::JoinPath(writer_params.CommittedChunksDirectory(),
+                                      absl::StrCat("chunk_0_", i, "_1")),
+                    compression,
+                    /*num_elements=*/1),
+                IsOkAndHolds(ElementsAre(i)));
+  }
+}
+
+TEST_P(SnapshotStreamWriterParameterizedTest, DeduplicateChunks) {
+  std::string compression = GetParam();
+  TF_ASSERT_OK_AND_ASSIGN(std::string chunk_store_path,
+                          CreateSnapshotDirectory());
+  // Writes the same dataset to two snapshots sharing a chunk store, serially
+  // and in parallel.
+  for (int64_t num_writer_threads : {1, 3}) {
+    TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<StandaloneTaskIterator> iterator,
+                            TestIterator(testing::RangeDataset(10)));
+    TF_ASSERT_OK_AND_ASSIGN(std::string snapshot_path,
+                            CreateSnapshotDirectory());
+    SnapshotWriterParams writer_params{snapshot_path, /*stream_index=*/0,
+                                       compression, Env::Default(),
+                                       /*max_chunk_size_bytes=*/1};
+    writer_params.num_writer_threads = num_writer_threads;
+    writer_params.chunk_store_path = chunk_store_path;
+    SnapshotStreamWriter snapshot_writer(writer_params, std::move(iterator));
+    EXPECT_THAT(snapshot_writer.Wait(), IsOkAndHolds(true));
+
+    for (int i = 0; i < 10; ++i) {
+      TF_ASSERT_OK_AND_ASSIGN(
+          std::string chunk_file,
+          ResolveChunkFile(
+              tsl::io::JoinPath(writer_params.CommittedChunksDirectory(),
+                                absl::StrCat("chunk_0_", i, "_1")),
+              Env::Default()));
+      EXPECT_THAT(chunk_file, HasSubstr(chunk_store_path));
+      EXPECT_THAT(ReadSnapshot<int64_t>(chunk_file, compression,
+                                        /*num_elements=*/1),
+                  IsOkAndHolds(ElementsAre(i)));
+    }
+    EXPECT_THAT(GetChildren(writer_params.UncommittedChunksDirectory(),
+                            Env::Default()),
+                IsOkAndHolds(IsEmpty()));
+  }
+  TF_ASSERT_OK_AND_ASSIGN(std::vector<std::string> stored_chunks,
+                          GetChildren(chunk_store_path, Env::Default()));
+  EXPECT_EQ(stored_chunks.size(), 10);
+}
+
 TEST_P(SnapshotStreamWriterParameterizedTest, WriteDoneFile) {
   int64_t range = 10;
   TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<StandaloneTaskIterator> iterator,
@@ -16,9 +16,12 @@ limitations under the License.
 
 #include <algorithm>
 #include <memory>
+#include <optional>
+#include <string>
 #include <utility>
 #include <vector>
 
+#include "absl/strings/string_view.h"
 #include "tensorflow/core/data/service/common.h"
 #include "tensorflow/core/data/service/cross_trainer_cache.h"
 #include "tensorflow/core/data/service/data_transfer.h"
@@ -29,6 +32,7 @@ limitations under the License.
 #include "tensorflow/core/framework/cancellation.h"
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor.pb.h"
 #include "tensorflow/core/framework/tensor_util.h"
 #include "tensorflow/core/lib/gtl/cleanup.h"
 #include "tensorflow/core/platform/env.h"
@@ -94,8 +98,12 @@ Status TaskRunner::Create(const experimental::WorkerConfig& worker_config,
         worker_config.cross_trainer_cache_size_bytes() > 0
             ? worker_config.cross_trainer_cache_size_bytes()
             : kDefaultCrossTrainerCacheSizeBytes;
-    out = std::make_unique<CachingTaskRunner>(std::move(iterator),
-                                              max_cache_size_bytes);
+    CrossTrainerCacheSpillOptions spill_options;
+    spill_options.directory = worker_config.cross_trainer_cache_spill_directory();
+    spill_options.max_spill_size_bytes =
+        worker_config.cross_trainer_cache_spill_size_bytes();
+    out = std::make_unique<CachingTaskRunner>(
+        std::move(iterator), max_cache_size_bytes, spill_options);
   } else {
     out = std::make_unique<FirstComeFirstServedTaskRunner>(std::move(iterator));
   }
@@ -120,6 +128,20 @@ Status FirstComeFirstServedTaskRunner::GetNext(GetElementResult& result) {
   return OkStatus();
 }
 
+Status FirstComeFirstServedTaskRunner::GetNextIfReady(
+    const GetElementRequest& req, GetElementResult& result, bool& ready) {
+  TF_ASSIGN_OR_RETURN(std::optional<GetElementResult> next, buffer_.TryPop());
+  ready = next.has_value();
+  if (ready) {
+    result = std::move(*next);
+  }
+  return OkStatus();
+}
+
+std::optional<double> FirstComeFirstServedTaskRunner::GetBufferOccupancy() {
+  return buffer_.Occupancy();
+}
+
 Status FirstComeFirstServedTaskRunner::PrefetchFn() {
   while (true) {
     TF_RETURN_IF_ERROR(buffer_.Push(GetNextFromInputIterator()));
@@ -163,11 +185,13 @@ void FirstComeFirstServedTaskRunner::Cancel() {
   buffer_.Cancel(errors::Cancelled("tf.data service FCFS task is cancelled."));
 }
 
-CachingTaskRunner::CachingTaskRunner(std::unique_ptr<TaskIterator> iterator,
-                                     size_t max_cache_size_bytes)
+CachingTaskRunner::CachingTaskRunner(
+    std::unique_ptr<TaskIterator> iterator, size_t max_cache_size_bytes,
+    const CrossTrainerCacheSpillOptions& spill_options)
     : fcfs_task_runner_(std::move(iterator)),
       cache_(max_cache_size_bytes,
-             std::make_unique<GetElementResultSequence>(fcfs_task_runner_)) {
+             std::make_unique<GetElementResultSequence>(fcfs_task_runner_),
+             spill_options) {
   LOG(INFO) << "Initialized tf.data service cross-trainer cache with "
             << FormatBytes(max_cache_size_bytes) << " of memory.";
 }
@@ -203,6 +227,49 @@ size_t CachingTaskRunner::GetElementResultSequence::GetElementSizeBytes(
   return element.EstimatedMemoryUsageBytes();
 }
 
+StatusOr<std::string>
+CachingTaskRunner::GetElementResultSequence::SerializeElement(
+    const GetElementResult& element) const {
+  GetElementResponse response;
+  UncompressedElement* uncompressed = response.mutable_uncompressed();
+  for (const Tensor& component : element.components) {
+    component.AsProtoTensorContent(uncompressed->add_components());
+  }
+  response.set_element_index(element.element_index);
+  response.set_end_of_sequence(element.end_of_sequence);
+  response.set_skip_task(element.skip);
+  std::string serialized;
+  if (!response.SerializeToString(&serialized)) {
+    return errors::Internal(
+        "Failed to serialize a tf.data service cross-trainer cache element.");
+  }
+  return serialized;
+}
+
+StatusOr<GetElementResult>
+CachingTaskRunner::GetElementResultSequence::DeserializeElement(
+    absl::string_view serialized) const {
+  GetElementResponse response;
+  if (!response.ParseFromArray(serialized.data(), serialized.size())) {
+    return errors::DataLoss(
+        "Failed to parse a tf.data service cross-trainer cache element.");
+  }
+  GetElementResult result;
+  for (const TensorProto& proto : response.uncompressed().components()) {
+    Tensor component;
+    if (!component.FromProto(proto)) {
+      return errors::DataLoss(
+          "Failed to parse a tf.data service cross-trainer cache element "
+          "component.");
+    }
+    result.components.push_back(std::move(component));
+  }
+  result.element_index = response.element_index();
+  result.end_of_sequence = response.end_of_sequence();
+  result.skip = response.skip_task();
+  return result;
+}
+
 void CachingTaskRunner::Cancel() {
   VLOG(2) << "Cancelling tf.data service cross-trainer cache task.";
   if (!cache_.IsCancelled()) {
@@ -16,8 +16,11 @@ limitations under the License.
 #define TENSORFLOW_CORE_DATA_SERVICE_TASK_RUNNER_H_
 
 #include <memory>
+#include <optional>
+#include <string>
 #include <vector>
 
+#include "absl/strings/string_view.h"
 #include "tensorflow/core/data/service/common.pb.h"
 #include "tensorflow/core/data/service/cross_trainer_cache.h"
 #include "tensorflow/core/data/service/data_transfer.h"
@@ -93,6 +96,17 @@ class TaskRunner {
   // Gets the next element for the given request.
   virtual Status GetNext(const GetElementRequest& req,
                          GetElementResult& result) = 0;
+  // Gets the next element for the given request if it is ready, without
+  // blocking. `ready` is set to false if no element is ready. Task runners that
+  // don't support this return no element.
+  virtual Status GetNextIfReady(const GetElementRequest& req,
+                                GetElementResult& result, bool& ready) {
+    ready = false;
+    return OkStatus();
+  }
+  // Returns the fraction of the element buffer of the task runner that is
+  // full, or std::nullopt if the task runner doesn't buffer elements.
+  virtual std::optional<double> GetBufferOccupancy() { return std::nullopt; }
   // Cancels in-progress `GetNext` requests.
   virtual void Cancel() = 0;
 };
@@ -110,6 +124,12 @@ class FirstComeFirstServedTaskRunner : public TaskRunner {
                  GetElementResult& result) override;
   Status GetNext(GetElementResult& result);
 
+  // Gets the next element if it has been prefetched.
+  Status GetNextIfReady(const GetElementRequest& req, GetElementResult& result,
+                        bool& ready) override;
+
+  std::optional<double> GetBufferOccupancy() override;
+
   void Cancel() override;
 
  private:
@@ -140,8 +160,9 @@ class FirstComeFirstServedTaskRunner : public TaskRunner {
 // read the full dataset.
 class CachingTaskRunner : public TaskRunner {
  public:
-  explicit CachingTaskRunner(std::unique_ptr<TaskIterator> iterator,
-                             size_t max_cache_size_bytes);
+  explicit CachingTaskRunner(
+      std::unique_ptr<TaskIterator> iterator, size_t max_cache_size_bytes,
+      const CrossTrainerCacheSpillOptions& spill_options = {});
   ~CachingTaskRunner() override;
 
   // Gets the next element from the cross-trainer cache, blocking if the data is
@@ -164,6 +185,10 @@ class CachingTaskRunner : public TaskRunner {
         FirstComeFirstServedTaskRunner& fcfs_task_runner);
     StatusOr<GetElementResult> GetNext() override;
     size_t GetElementSizeBytes(const GetElementResult& element) const override;
+    StatusOr<std::string> SerializeElement(
+        const GetElementResult& element) const override;
+    StatusOr<GetElementResult> DeserializeElement(
+        absl::string_view serialized) const override;
 
    private:
     FirstComeFirstServedTaskRunner& fcfs_task_runner_;
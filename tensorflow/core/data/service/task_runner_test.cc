@@ -210,6 +210,29 @@ TEST(FirstComeFirstServedTaskRunnerTest, GetNext) {
   EXPECT_TRUE(result.end_of_sequence);
 }
 
+TEST(FirstComeFirstServedTaskRunnerTest, GetNextIfReady) {
+  size_t range = 10;
+  FirstComeFirstServedTaskRunner runner(
+      std::make_unique<RangeIterator>(range, /*repeat=*/false));
+  std::vector<int64_t> output;
+  while (output.size() < range) {
+    GetElementResult result;
+    bool ready = false;
+    TF_ASSERT_OK(runner.GetNextIfReady(GetElementRequest(), result, ready));
+    if (!ready) {
+      Env::Default()->SleepForMicroseconds(1000);
+      continue;
+    }
+    ASSERT_FALSE(result.end_of_sequence);
+    output.push_back(result.components[0].flat<int64_t>()(0));
+  }
+  EXPECT_THAT(output, ElementsAreArray(GetRange(range)));
+
+  GetElementResult result;
+  TF_ASSERT_OK(runner.GetNext(GetElementRequest(), result));
+  EXPECT_TRUE(result.end_of_sequence);
+}
+
 TEST(FirstComeFirstServedTaskRunnerTest, EmptyDataset) {
   FirstComeFirstServedTaskRunner runner(
       std::make_unique<RangeIterator>(/*range=*/0, /*repeat=*/false));
@@ -16,6 +16,7 @@ limitations under the License.
 #define TENSORFLOW_CORE_DATA_SERVICE_THREAD_SAFE_BUFFER_H_
 
 #include <deque>
+#include <optional>
 #include <utility>
 
 #include "tensorflow/core/platform/macros.h"
@@ -38,10 +39,18 @@ class ThreadSafeBuffer final {
   // a non-OK status was pushed or the buffer has been cancelled.
   StatusOr<T> Pop();
 
+  // Gets the next element if the buffer is not empty, or returns std::nullopt
+  // without blocking. Returns an error if a non-OK status was pushed or the
+  // buffer has been cancelled.
+  StatusOr<std::optional<T>> TryPop();
+
   // Writes the next element. Blocks if the buffer is full. Returns an error if
   // the buffer has been cancelled.
   Status Push(StatusOr<T> value);
 
+  // Returns the fraction of the buffer that is full.
+  double Occupancy();
+
   // Cancels the buffer with `status` and notifies waiting threads. After
   // cancelling, all `Push` and `Pop` calls will return `status`.
   // REQUIRES: !status.ok()
@@ -82,6 +91,22 @@ StatusOr<T> ThreadSafeBuffer<T>::Pop() {
   return result;
 }
 
+template <class T>
+StatusOr<std::optional<T>> ThreadSafeBuffer<T>::TryPop() {
+  mutex_lock l(mu_);
+  if (!status_.ok()) {
+    return status_;
+  }
+  if (results_.empty()) {
+    return std::optional<T>();
+  }
+  StatusOr<T> result = std::move(results_.front());
+  results_.pop_front();
+  ready_to_push_.notify_one();
+  TF_RETURN_IF_ERROR(result.status());
+  return std::optional<T>(std::move(result).value());
+}
+
 template <class T>
 Status ThreadSafeBuffer<T>::Push(StatusOr<T> value) {
   mutex_lock l(mu_);
@@ -96,6 +121,12 @@ Status ThreadSafeBuffer<T>::Push(StatusOr<T> value) {
   return OkStatus();
 }
 
+template <class T>
+double ThreadSafeBuffer<T>::Occupancy() {
+  mutex_lock l(mu_);
+  return static_cast<double>(results_.size()) / buffer_size_;
+}
+
 template <class T>
 void ThreadSafeBuffer<T>::Cancel(Status status) {
   DCHECK(!status.ok())
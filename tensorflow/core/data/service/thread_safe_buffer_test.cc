@@ -15,6 +15,7 @@ limitations under the License.
 #include "tensorflow/core/data/service/thread_safe_buffer.h"
 
 #include <memory>
+#include <optional>
 #include <tuple>
 #include <vector>
 
@@ -180,6 +181,32 @@ TEST_P(ThreadSafeBufferTest, BlockWriterWhenBufferIsFull) {
   EXPECT_LE(pop_time, push_time);
 }
 
+TEST_P(ThreadSafeBufferTest, TryPop) {
+  ThreadSafeBuffer<int> buffer(GetBufferSize());
+  TF_ASSERT_OK_AND_ASSIGN(std::optional<int> next, buffer.TryPop());
+  EXPECT_FALSE(next.has_value());
+  for (int i = 0; i < GetBufferSize(); ++i) {
+    ASSERT_THAT(buffer.Push(i), IsOk());
+  }
+  for (int i = 0; i < GetBufferSize(); ++i) {
+    TF_ASSERT_OK_AND_ASSIGN(next, buffer.TryPop());
+    EXPECT_EQ(next, i);
+  }
+  TF_ASSERT_OK_AND_ASSIGN(next, buffer.TryPop());
+  EXPECT_FALSE(next.has_value());
+  buffer.Cancel(errors::Cancelled("Cancelled"));
+  EXPECT_THAT(buffer.TryPop(), StatusIs(error::CANCELLED));
+}
+
+TEST_P(ThreadSafeBufferTest, Occupancy) {
+  ThreadSafeBuffer<int> buffer(GetBufferSize());
+  EXPECT_EQ(buffer.Occupancy(), 0.0);
+  ASSERT_THAT(buffer.Push(0), IsOk());
+  EXPECT_DOUBLE_EQ(buffer.Occupancy(), 1.0 / GetBufferSize());
+  TF_ASSERT_OK(buffer.Pop().status());
+  EXPECT_EQ(buffer.Occupancy(), 0.0);
+}
+
 TEST_P(ThreadSafeBufferTest, CancelReaders) {
   ThreadSafeBuffer<int> buffer(GetBufferSize());
   std::vector<std::unique_ptr<Thread>> threads;
@@ -72,6 +72,13 @@ Status DataServiceWorkerClient::GetElement(const GetElementRequest& req,
   return client_->GetElement(req, result);
 }
 
+Status DataServiceWorkerClient::GetElements(
+    const GetElementRequest& req, int64_t max_elements,
+    std::vector<GetElementResult>& results) {
+  TF_RETURN_IF_ERROR(EnsureInitialized());
+  return client_->GetElements(req, max_elements, results);
+}
+
 Status DataServiceWorkerClient::EnsureInitialized() {
   mutex_lock l(mu_);
   if (client_) {
@@ -106,6 +113,52 @@ class GrpcDataTransferClient : public DataTransferClient {
                     GetElementResult& result) override {
     VLOG(3) << "GetElement for task " << req.task_id() << " from gRPC worker "
             << "server.";
+    GetElementResponse resp;
+    TF_RETURN_IF_ERROR(CallWorker(
+        [&](grpc::ClientContext& ctx) {
+          return stub_->GetElement(&ctx, req, &resp);
+        },
+        "Failed to get element"));
+    return ResponseToResult(resp, result);
+  }
+
+  Status GetElements(const GetElementRequest& req, int64_t max_elements,
+                     std::vector<GetElementResult>& results) override {
+    VLOG(3) << "GetElements for task " << req.task_id()
+            << " from gRPC worker server.";
+    GetElementsRequest elements_req;
+    *elements_req.mutable_request() = req;
+    elements_req.set_max_elements(max_elements);
+    GetElementsResponse resp;
+    TF_RETURN_IF_ERROR(CallWorker(
+        [&](grpc::ClientContext& ctx) {
+          return stub_->GetElements(&ctx, elements_req, &resp);
+        },
+        "Failed to get elements"));
+    if (resp.elements().empty()) {
+      return errors::Internal("GetElements returned no element for task ",
+                              req.task_id());
+    }
+    results.clear();
+    for (GetElementResponse& element : *resp.mutable_elements()) {
+      TF_RETURN_IF_ERROR(ResponseToResult(element, results.emplace_back()));
+    }
+    return OkStatus();
+  }
+
+  void TryCancel() override {
+    VLOG(2) << "Cancel GrpcDataTransferClient.";
+    mutex_lock l(mu_);
+    cancelled_ = true;
+    for (const auto& ctx : active_contexts_) {
+      ctx->TryCancel();
+    }
+  }
+
+ private:
+  // Calls `rpc` with a context that can be cancelled by `TryCancel`.
+  Status CallWorker(std::function<grpc::Status(grpc::ClientContext&)> rpc,
+                    absl::string_view error_message) {
     {
       mutex_lock l(mu_);
       if (cancelled_) {
@@ -122,13 +175,18 @@ class GrpcDataTransferClient : public DataTransferClient {
         active_contexts_.erase(&ctx);
       });
     }
-    GetElementResponse resp;
-    grpc::Status s = stub_->GetElement(&ctx, req, &resp);
+    grpc::Status s = rpc(ctx);
     if (!s.ok()) {
-      return grpc_util::WrapError("Failed to get element", s);
+      return grpc_util::WrapError(std::string(error_message), s);
     }
+    return OkStatus();
+  }
+
+  static Status ResponseToResult(GetElementResponse& resp,
+                                 GetElementResult& result) {
     result.end_of_sequence = resp.end_of_sequence();
     result.skip = resp.skip_task();
+    result.element_index = resp.element_index();
     switch (resp.element_case()) {
       case GetElementResponse::kCompressed: {
         Tensor tensor(DT_VARIANT, TensorShape{});
@@ -150,16 +208,6 @@ class GrpcDataTransferClient : public DataTransferClient {
     return OkStatus();
   }
 
-  void TryCancel() override {
-    VLOG(2) << "Cancel GrpcDataTransferClient.";
-    mutex_lock l(mu_);
-    cancelled_ = true;
-    for (const auto& ctx : active_contexts_) {
-      ctx->TryCancel();
-    }
-  }
-
- private:
   mutex mu_;
   std::unique_ptr<WorkerService::Stub> stub_;
   // Set of all currently active clients contexts. Used to support
@@ -205,6 +253,16 @@ class LocalDataTransferClient : public DataTransferClient {
     return worker->GetElementResult(&req, &result);
   }
 
+  Status GetElements(const GetElementRequest& req, int64_t max_elements,
+                     std::vector<GetElementResult>& results) override {
+    VLOG(3) << "GetElements for task " << req.task_id()
+            << " from local worker.";
+    TF_RETURN_IF_ERROR(VerifyClientIsNotCancelled());
+    TF_ASSIGN_OR_RETURN(std::shared_ptr<DataServiceWorkerImpl> worker,
+                        GetWorker(req));
+    return worker->GetElementResults(&req, max_elements, &results);
+  }
+
   void TryCancel() override {
     VLOG(2) << "Cancel LocalDataTransferClient for worker " << worker_address_
             << ".";
@@ -14,8 +14,10 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/data/service/worker_impl.h"
 
+#include <algorithm>
 #include <iterator>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -115,6 +117,9 @@ WorkerConfig ApplyWorkerDefaults(const WorkerConfig& config) {
   if (new_config.snapshot_max_chunk_size_bytes() == 0) {
     new_config.set_snapshot_max_chunk_size_bytes(kDefaultMaxChunkSizeBytes);
   }
+  if (new_config.snapshot_num_writer_threads() == 0) {
+    new_config.set_snapshot_num_writer_threads(kDefaultNumWriterThreads);
+  }
   return new_config;
 }
 
@@ -253,6 +258,17 @@ DataServiceWorkerImpl::CreateDispatcherClient() const TF_LOCKS_EXCLUDED(mu_) {
 
 Status DataServiceWorkerImpl::GetElementResult(
     const GetElementRequest* request, struct GetElementResult* result) {
+  std::vector<struct GetElementResult> results;
+  TF_RETURN_IF_ERROR(
+      GetElementResults(request, /*max_elements=*/1, &results));
+  *result = std::move(results.front());
+  return OkStatus();
+}
+
+Status DataServiceWorkerImpl::GetElementResults(
+    const GetElementRequest* request, int64_t max_elements,
+    std::vector<struct GetElementResult>* results) {
+  results->clear();
   Task* task = nullptr;
   {
     mutex_lock l(mu_);
@@ -278,8 +294,9 @@ Status DataServiceWorkerImpl::GetElementResult(
       }
       if (finished_tasks_.contains(request->task_id())) {
         VLOG(3) << "Task is already finished";
-        result->end_of_sequence = true;
-        result->skip = false;
+        struct GetElementResult& result = results->emplace_back();
+        result.end_of_sequence = true;
+        result.skip = false;
         return OkStatus();
       }
       // Perhaps the worker hasn't gotten the task from the dispatcher yet.
@@ -295,9 +312,23 @@ Status DataServiceWorkerImpl::GetElementResult(
     cv_.notify_all();
   });
   TF_RETURN_IF_ERROR(EnsureTaskInitialized(*task));
-  TF_RETURN_IF_ERROR(task->task_runner->GetNext(*request, *result));
+  TF_RETURN_IF_ERROR(
+      task->task_runner->GetNext(*request, results->emplace_back()));
+  // Only returns the following elements if they are ready, so that batching
+  // does not delay the first element.
+  while (results->size() < max_elements && !results->back().end_of_sequence &&
+         !results->back().skip) {
+    struct GetElementResult result;
+    bool ready = false;
+    TF_RETURN_IF_ERROR(
+        task->task_runner->GetNextIfReady(*request, result, ready));
+    if (!ready) {
+      break;
+    }
+    results->push_back(std::move(result));
+  }
 
-  if (result->end_of_sequence) {
+  if (results->back().end_of_sequence) {
     mutex_lock l(mu_);
     VLOG(3) << "Reached end_of_sequence for task " << request->task_id();
     pending_completed_tasks_.insert(request->task_id());
@@ -449,6 +480,29 @@ Status DataServiceWorkerImpl::GetElement(const GetElementRequest* request,
   return OkStatus();
 }
 
+Status DataServiceWorkerImpl::GetElements(const GetElementsRequest* request,
+                                          GetElementsResponse* response) {
+  VLOG(3) << "Received GetElements request for task "
+          << request->request().task_id();
+  std::vector<struct GetElementResult> results;
+  TF_RETURN_IF_ERROR(GetElementResults(
+      &request->request(), std::max<int64_t>(request->max_elements(), 1),
+      &results));
+  for (struct GetElementResult& result : results) {
+    GetElementResponse* element = response->add_elements();
+    element->set_end_of_sequence(result.end_of_sequence);
+    element->set_skip_task(result.skip);
+    element->set_element_index(result.element_index);
+    if (!element->end_of_sequence() && !element->skip_task()) {
+      TF_RETURN_IF_ERROR(
+          MoveElementToResponse(std::move(result.components), *element));
+    }
+  }
+  VLOG(3) << "Producing " << results.size() << " elements for task "
+          << request->request().task_id();
+  return OkStatus();
+}
+
 Status DataServiceWorkerImpl::GetWorkerTasks(
     const GetWorkerTasksRequest* request, GetWorkerTasksResponse* response) {
   mutex_lock l(mu_);
@@ -558,10 +612,12 @@ Status DataServiceWorkerImpl::Heartbeat() {
 WorkerHeartbeatRequest DataServiceWorkerImpl::BuildWorkerHeartbeatRequest()
     const TF_LOCKS_EXCLUDED(mu_) {
   std::vector<int64_t> current_tasks;
+  std::vector<std::shared_ptr<Task>> tasks;
   {
     mutex_lock l(mu_);
     for (const auto& task : tasks_) {
       current_tasks.push_back(task.first);
+      tasks.push_back(task.second);
     }
   }
 
@@ -573,6 +629,21 @@ WorkerHeartbeatRequest DataServiceWorkerImpl::BuildWorkerHeartbeatRequest()
   request.set_worker_uid(worker_uid_);
   *request.mutable_current_tasks() = {current_tasks.begin(),
                                       current_tasks.end()};
+  for (const std::shared_ptr<Task>& task : tasks) {
+    // Skips the tasks being initialized, to not delay the heartbeat.
+    if (!task->mu.try_lock()) {
+      continue;
+    }
+    std::optional<double> occupancy;
+    if (task->initialized && task->task_runner) {
+      occupancy = task->task_runner->GetBufferOccupancy();
+    }
+    task->mu.unlock();
+    if (occupancy.has_value()) {
+      (*request.mutable_task_buffer_occupancy())[task->task_def.task_id()] =
+          *occupancy;
+    }
+  }
   for (const auto& snapshot_task_progress : GetSnapshotTaskProgress()) {
     request.mutable_snapshot_task_progress()->insert(
         {snapshot_task_progress.snapshot_task().base_path(),
@@ -655,15 +726,18 @@ Status DataServiceWorkerImpl::UpdateSnapshotWriters(
         &dataset_def));
     TF_ASSIGN_OR_RETURN(std::unique_ptr<StandaloneTaskIterator> iterator,
                         MakeSnapshotTaskIterator(snapshot_task, dataset_def));
+    SnapshotWriterParams writer_params{
+        snapshot_task.base_path(), snapshot_task.stream_index(),
+        snapshot_task.metadata().compression(), Env::Default(),
+        config_.snapshot_max_chunk_size_bytes()};
+    writer_params.num_writer_threads = config_.snapshot_num_writer_threads();
+    writer_params.chunk_store_path =
+        snapshot_task.metadata().chunk_store_path();
     mutex_lock l(mu_);
     snapshot_writers_.emplace(
         snapshot_task_key,
-        std::make_unique<SnapshotStreamWriter>(
-            SnapshotWriterParams{
-                snapshot_task.base_path(), snapshot_task.stream_index(),
-                snapshot_task.metadata().compression(), Env::Default(),
-                config_.snapshot_max_chunk_size_bytes()},
-            std::move(iterator)));
+        std::make_unique<SnapshotStreamWriter>(writer_params,
+                                               std::move(iterator)));
   }
 
   // Cancel writers for snapshots that are no longer assigned by the dispatcher.
@@ -69,6 +69,12 @@ class DataServiceWorkerImpl {
   Status GetElementResult(const GetElementRequest* request,
                           GetElementResult* result);
 
+  // Serves a GetElements request, storing at most `max_elements` results in
+  // `*results`. See worker.proto for GetElements API documentation.
+  Status GetElementResults(const GetElementRequest* request,
+                           int64_t max_elements,
+                           std::vector<struct GetElementResult>* results);
+
   // Deletes the local task and iterator. Only called by local clients to delete
   // unused task iterators assuming the task is not read by remote clients. This
   // method is not visible to gRPC clients.
@@ -83,6 +89,8 @@ class DataServiceWorkerImpl {
   /// Client-facing API.
   Status GetElement(const GetElementRequest* request,
                     GetElementResponse* response);
+  Status GetElements(const GetElementsRequest* request,
+                     GetElementsResponse* response);
   Status GetWorkerTasks(const GetWorkerTasksRequest* request,
                         GetWorkerTasksResponse* response);
   Status GetSnapshotTaskProgresses(
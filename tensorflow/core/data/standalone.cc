@@ -178,6 +178,12 @@ Status Dataset::FromGraph(Params params, const GraphDef& graph_def,
 Status Dataset::MakeIterator(
     std::vector<std::unique_ptr<SplitProvider>> split_providers,
     std::unique_ptr<Iterator>* result) {
+  return MakeIterator(std::move(split_providers), /*model=*/nullptr, result);
+}
+
+Status Dataset::MakeIterator(
+    std::vector<std::unique_ptr<SplitProvider>> split_providers,
+    std::shared_ptr<model::Model> model, std::unique_ptr<Iterator>* result) {
   // Create an `IteratorContext`, which bundles together the necessary runtime
   // support to create and get elements from an iterator.
   std::unique_ptr<IteratorContext> ctx;
@@ -195,6 +201,7 @@ Status Dataset::MakeIterator(
             std::back_inserter(params.split_providers));
   params.thread_factory = unbounded_thread_pool_.get_thread_factory();
   params.thread_pool = &unbounded_thread_pool_;
+  params.model = std::move(model);
   ctx = std::make_unique<IteratorContext>(std::move(params));
   SerializationContext::Params serialization_params(&op_ctx);
   auto serialization_ctx =
@@ -26,6 +26,7 @@ limitations under the License.
 #include "tensorflow/core/framework/function.h"
 #include "tensorflow/core/framework/function_handle_cache.h"
 #include "tensorflow/core/framework/graph.pb.h"
+#include "tensorflow/core/framework/model.h"
 #include "tensorflow/core/framework/resource_mgr.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/lib/core/threadpool.h"
@@ -122,6 +123,12 @@ class Dataset {
       std::vector<std::unique_ptr<SplitProvider>> split_providers,
       std::unique_ptr<Iterator>* result);
 
+  // Creates an iterator which records its performance in `model`. The autotune
+  // optimization of the dataset is not run: the caller may run it on `model`.
+  Status MakeIterator(
+      std::vector<std::unique_ptr<SplitProvider>> split_providers,
+      std::shared_ptr<model::Model> model, std::unique_ptr<Iterator>* result);
+
   // Creates split providers for this dataset.
   Status MakeSplitProviders(
       std::vector<std::unique_ptr<SplitProvider>>* result);
@@ -19,6 +19,7 @@ limitations under the License.
 #include <vector>
 
 #include "tensorflow/core/framework/graph.pb.h"
+#include "tensorflow/core/framework/model.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/platform/test.h"
 
@@ -301,6 +302,25 @@ TEST(Scalar, Standalone) {
   }
 }
 
+TEST(Scalar, StandaloneWithModel) {
+  GraphDef graph_def;
+  protobuf::TextFormat::ParseFromString(kRangeGraphProto, &graph_def);
+  std::unique_ptr<Dataset> dataset;
+  TF_ASSERT_OK(Dataset::FromGraph({}, graph_def, &dataset));
+  auto model = std::make_shared<model::Model>();
+  std::unique_ptr<Iterator> iterator;
+  TF_ASSERT_OK(
+      dataset->MakeIterator(/*split_providers=*/{}, model, &iterator));
+  bool end_of_input = false;
+  while (!end_of_input) {
+    std::vector<tensorflow::Tensor> outputs;
+    TF_ASSERT_OK(iterator->GetNext(&outputs, &end_of_input));
+  }
+  // The iterator records its elements in `model`.
+  ASSERT_NE(model->output(), nullptr);
+  EXPECT_EQ(model->output()->num_elements(), 10);
+}
+
 }  // namespace
 }  // namespace standalone
 }  // namespace data
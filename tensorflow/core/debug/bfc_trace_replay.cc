@@ -0,0 +1,229 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Replays an allocation trace recorded with TF_BFC_ALLOCATION_TRACE against a
+// BFCAllocator configured with different options, and reports the peak memory
+// and fragmentation the allocator would have reached.
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "tensorflow/core/common_runtime/bfc_allocator.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/init_main.h"
+#include "tensorflow/core/protobuf/bfc_memory_map.pb.h"
+#include "tensorflow/core/util/command_line_flags.h"
+
+namespace tensorflow {
+namespace {
+
+// Hands out disjoint address ranges without backing them with memory. The
+// BFCAllocator never touches the memory it manages, so this is enough to
+// simulate it.
+class SimulatedSubAllocator : public SubAllocator {
+ public:
+  SimulatedSubAllocator() : SubAllocator({}, {}) {}
+
+  void* Alloc(size_t alignment, size_t num_bytes,
+              size_t* bytes_received) override {
+    // Leave a gap between regions so that they never look adjacent.
+    constexpr uint64 kRegionAlignment = 2 << 20;
+    *bytes_received = num_bytes;
+    void* ptr = reinterpret_cast<void*>(next_address_);
+    next_address_ += (num_bytes / kRegionAlignment + 2) * kRegionAlignment;
+    return ptr;
+  }
+
+  void Free(void* ptr, size_t num_bytes) override {}
+
+  bool SupportsCoalescing() const override { return false; }
+
+  AllocatorMemoryType GetMemoryType() const override {
+    return AllocatorMemoryType::kDevice;
+  }
+
+ private:
+  uint64 next_address_ = uint64{1} << 40;
+};
+
+struct ReplayResult {
+  int64_t num_allocs = 0;
+  int64_t num_deallocs = 0;
+  int64_t num_failed_allocs = 0;
+  int64_t num_failed_allocs_in_trace = 0;
+  int64_t peak_bytes_in_use = 0;
+  int64_t peak_pool_bytes = 0;
+  double peak_fragmentation = 0;
+  int64_t first_failure_event = -1;
+};
+
+AllocationTrace ReadTraceFile(const string& fname) {
+  string contents;
+  Status status = ReadFileToString(Env::Default(), fname, &contents);
+  if (!status.ok()) {
+    LOG(ERROR) << "read from file " << fname << " failed " << status;
+    exit(1);
+  }
+  AllocationTrace trace;
+  if (!trace.ParseFromString(contents)) {
+    LOG(ERROR) << "failed to parse allocation trace " << fname;
+    exit(1);
+  }
+  return trace;
+}
+
+ReplayResult Replay(const AllocationTrace& trace, size_t memory_limit,
+                    const BFCAllocator::Options& opts) {
+  BFCAllocator a(std::make_unique<SimulatedSubAllocator>(), memory_limit,
+                 trace.allocator_name() + "_replay", opts);
+  ReplayResult result;
+  absl::flat_hash_map<int64_t, void*> live;
+  for (int i = 0; i < trace.event_size(); ++i) {
+    const AllocationTraceEvent& event = trace.event(i);
+    if (event.num_bytes() == 0) {
+      auto it = live.find(event.allocation_id());
+      // The allocation did not fit during this replay.
+      if (it == live.end()) continue;
+      a.DeallocateRaw(it->second);
+      live.erase(it);
+      ++result.num_deallocs;
+      continue;
+    }
+
+    ++result.num_allocs;
+    AllocationAttributes attr;
+    attr.retry_on_failure = false;
+    void* ptr = a.AllocateRaw(Allocator::kAllocatorAlignment,
+                              event.num_bytes(), attr);
+    if (event.allocation_id() == 0) {
+      // The allocation failed when the trace was recorded, so the client never
+      // used it; release it right away.
+      ++result.num_failed_allocs_in_trace;
+      if (ptr != nullptr) a.DeallocateRaw(ptr);
+    } else if (ptr != nullptr) {
+      live[event.allocation_id()] = ptr;
+    }
+    if (ptr == nullptr) {
+      ++result.num_failed_allocs;
+      if (result.first_failure_event < 0) result.first_failure_event = i;
+    }
+
+    std::optional<AllocatorStats> stats = a.GetStats();
+    result.peak_bytes_in_use =
+        std::max(result.peak_bytes_in_use, stats->bytes_in_use);
+    result.peak_pool_bytes =
+        std::max(result.peak_pool_bytes, stats->pool_bytes.value_or(0));
+    const int64_t bytes_free =
+        stats->pool_bytes.value_or(0) - stats->bytes_in_use;
+    if (bytes_free > 0) {
+      result.peak_fragmentation = std::max(
+          result.peak_fragmentation,
+          static_cast<double>(bytes_free - stats->largest_free_block_bytes) /
+              bytes_free);
+    }
+  }
+  for (const auto& it : live) {
+    a.DeallocateRaw(it.second);
+  }
+  return result;
+}
+
+void PrintTraceSummary(const AllocationTrace& trace) {
+  int64_t duration_us = 0;
+  for (const auto& event : trace.event()) {
+    duration_us += event.timestamp_delta_us();
+  }
+  printf("Allocator %s, memory limit %" PRId64 " bytes\n",
+         trace.allocator_name().c_str(),
+         static_cast<int64_t>(trace.memory_limit()));
+  printf("\t%d events over %" PRId64 " us, %d distinct ops\n",
+         trace.event_size(), duration_us, trace.op_name_size());
+}
+
+void PrintReplayResult(const AllocationTrace& trace,
+                       const ReplayResult& result) {
+  printf("------------Replay Result--------\n");
+  printf("\tallocations: %" PRId64 ", deallocations: %" PRId64 "\n",
+         result.num_allocs, result.num_deallocs);
+  printf("\tfailed allocations: %" PRId64 " (%" PRId64 " in the trace)\n",
+         result.num_failed_allocs, result.num_failed_allocs_in_trace);
+  if (result.first_failure_event >= 0) {
+    const AllocationTraceEvent& event =
+        trace.event(result.first_failure_event);
+    printf("\tfirst failure: event %" PRId64 ", %" PRId64
+           " bytes, op %s, step %" PRIu64 "\n",
+           result.first_failure_event,
+           static_cast<int64_t>(event.num_bytes()),
+           event.op_name_index() >= 0
+               ? trace.op_name(event.op_name_index()).c_str()
+               : "UNKNOWN",
+           static_cast<uint64_t>(event.step_id()));
+  }
+  printf("\tpeak bytes in use: %" PRId64 "\n", result.peak_bytes_in_use);
+  printf("\tpeak pool bytes: %" PRId64 "\n", result.peak_pool_bytes);
+  printf("\tpeak fragmentation: %.4f\n", result.peak_fragmentation);
+}
+
+}  // namespace
+}  // namespace tensorflow
+
+int main(int argc, char** argv) {
+  std::string path = "";
+  int64_t memory_limit = 0;
+  bool allow_growth = true;
+  bool garbage_collection = false;
+  float fragmentation_fraction = 0;
+  std::vector<tensorflow::Flag> flag_list = {
+      tensorflow::Flag("path", &path,
+                       "Path of a BFCAllocator allocation trace file, as "
+                       "written with TF_BFC_ALLOCATION_TRACE"),
+      tensorflow::Flag("memory_limit", &memory_limit,
+                       "Bytes available to the replayed allocator. Defaults "
+                       "to the limit of the traced allocator."),
+      tensorflow::Flag("allow_growth", &allow_growth,
+                       "Whether regions start small and grow on demand, "
+                       "instead of reserving memory_limit up front."),
+      tensorflow::Flag("garbage_collection", &garbage_collection,
+                       "Whether free regions are released to avoid OOM due "
+                       "to fragmentation."),
+      tensorflow::Flag("fragmentation_fraction", &fragmentation_fraction,
+                       "Fraction of the memory limit a chunk may exceed the "
+                       "request by before it is split."),
+  };
+  bool parse_result = tensorflow::Flags::Parse(&argc, argv, flag_list);
+  if (!parse_result || path.empty()) {
+    std::cerr << tensorflow::Flags::Usage(argv[0], flag_list);
+    return -1;
+  }
+  tensorflow::port::InitMain(argv[0], &argc, &argv);
+  tensorflow::AllocationTrace trace = tensorflow::ReadTraceFile(path);
+  tensorflow::PrintTraceSummary(trace);
+
+  tensorflow::BFCAllocator::Options opts;
+  opts.allow_growth = allow_growth;
+  opts.allow_retry_on_failure = false;
+  opts.garbage_collection = garbage_collection;
+  opts.fragmentation_fraction = fragmentation_fraction;
+  const size_t limit = memory_limit > 0 ? memory_limit : trace.memory_limit();
+  tensorflow::ReplayResult result = tensorflow::Replay(trace, limit, opts);
+  tensorflow::PrintReplayResult(trace, result);
+}
@@ -0,0 +1,110 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/distributed_runtime/eager/streaming_enqueue_batcher.h"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/logging.h"
+
+namespace tensorflow {
+namespace eager {
+
+StreamingEnqueueBatcher::StreamingEnqueueBatcher(int64_t max_batch_size,
+                                                 SendFunction send)
+    : max_batch_size_(max_batch_size), send_(std::move(send)) {}
+
+void StreamingEnqueueBatcher::Enqueue(const EnqueueRequest& request,
+                                      EnqueueResponse* response,
+                                      StatusCallback done) {
+  {
+    mutex_lock l(mu_);
+    if (batch_in_flight_) {
+      if (pending_batches_.empty() ||
+          pending_batches_.back()->request.queue_size() + request.queue_size() >
+              max_batch_size_) {
+        pending_batches_.push_back(std::make_unique<Batch>());
+        pending_batches_.back()->request.set_context_id(request.context_id());
+      }
+      Batch* batch = pending_batches_.back().get();
+      batch->request.mutable_queue()->MergeFrom(request.queue());
+      batch->members.push_back({response, request.queue_size(),
+                                std::move(done)});
+      return;
+    }
+    batch_in_flight_ = true;
+  }
+
+  // Nothing is in flight: send the request as is, to not pay for copying it.
+  Ref();
+  send_(&request, response, [this, done = std::move(done)](const Status& s) {
+    done(s);
+    SendNextBatch();
+    Unref();
+  });
+}
+
+void StreamingEnqueueBatcher::SendBatch(std::shared_ptr<Batch> batch) {
+  VLOG(3) << "Sending a batch of " << batch->members.size()
+          << " enqueue requests with " << batch->request.queue_size()
+          << " queue items";
+  Ref();
+  send_(&batch->request, &batch->response, [this, batch](const Status& s) {
+    BatchDone(batch.get(), s);
+    SendNextBatch();
+    Unref();
+  });
+}
+
+void StreamingEnqueueBatcher::BatchDone(Batch* batch, const Status& status) {
+  int begin = 0;
+  const int num_responses = batch->response.queue_response_size();
+  for (Member& member : batch->members) {
+    const int end = begin + member.num_items;
+    for (int i = begin; i < std::min(end, num_responses); ++i) {
+      member.response->add_queue_response()->Swap(
+          batch->response.mutable_queue_response(i));
+    }
+    if (status.ok() && end > num_responses) {
+      member.done(errors::Internal(
+          "Expected ", member.num_items,
+          " queue responses for an enqueue request, but got ",
+          member.response->queue_response_size()));
+    } else {
+      member.done(status);
+    }
+    begin = end;
+  }
+}
+
+void StreamingEnqueueBatcher::SendNextBatch() {
+  std::shared_ptr<Batch> batch;
+  {
+    mutex_lock l(mu_);
+    if (pending_batches_.empty()) {
+      batch_in_flight_ = false;
+      return;
+    }
+    batch = std::move(pending_batches_.front());
+    pending_batches_.pop_front();
+  }
+  SendBatch(std::move(batch));
+}
+
+}  // namespace eager
+}  // namespace tensorflow
@@ -0,0 +1,101 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_EAGER_STREAMING_ENQUEUE_BATCHER_H_
+#define TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_EAGER_STREAMING_ENQUEUE_BATCHER_H_
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/refcount.h"
+#include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/protobuf/eager_service.pb.h"
+
+namespace tensorflow {
+namespace eager {
+
+// Coalesces the EnqueueRequests sent to the same remote eager context into
+// fewer, larger requests.
+//
+// At most one batched request is in flight at any time. While it is, the
+// requests passed to Enqueue() are appended to a pending batch, which is sent
+// as a single request as soon as the in-flight one completes. When the remote
+// ops are small, this turns a stream of per-op round trips into a few larger
+// ones, while the callers still get their responses asynchronously and may
+// keep enqueueing in the meantime. A request issued while nothing is in flight
+// is sent right away, so batching adds no latency to an idle stream.
+//
+// The batcher is transparent to the callers: every request still gets its own
+// response, with one queue response per queue item, and its own callback. The
+// requests are sent, and their callbacks invoked, in the order in which they
+// were enqueued. Since the remote side stops processing a request at its first
+// failing item, a failure is reported to all the requests of the batch.
+//
+// This class is thread-safe.
+class StreamingEnqueueBatcher : public core::RefCounted {
+ public:
+  // Sends `request`, fills `response` and invokes `done` once the response is
+  // received. `request` can be deleted as soon as the function returns.
+  using SendFunction = std::function<void(
+      const EnqueueRequest* request, EnqueueResponse* response,
+      StatusCallback done)>;
+
+  // `max_batch_size` is the maximum number of queue items of a batched
+  // request. A single request larger than that is sent on its own.
+  StreamingEnqueueBatcher(int64_t max_batch_size, SendFunction send);
+
+  // Sends `request`, possibly merged with other requests, and invokes `done`
+  // once `response` is filled. Has the same contract as
+  // EagerClient::StreamingEnqueueAsync.
+  void Enqueue(const EnqueueRequest& request, EnqueueResponse* response,
+               StatusCallback done);
+
+ private:
+  struct Member {
+    EnqueueResponse* response;
+    int num_items;
+    StatusCallback done;
+  };
+
+  struct Batch {
+    EnqueueRequest request;
+    EnqueueResponse response;
+    std::vector<Member> members;
+  };
+
+  void SendBatch(std::shared_ptr<Batch> batch);
+
+  // Splits the response of `batch` between its members and notifies them.
+  void BatchDone(Batch* batch, const Status& status);
+
+  // Sends the next pending batch, if any.
+  void SendNextBatch();
+
+  const int64_t max_batch_size_;
+  const SendFunction send_;
+
+  mutex mu_;
+  bool batch_in_flight_ TF_GUARDED_BY(mu_) = false;
+  std::deque<std::unique_ptr<Batch>> pending_batches_ TF_GUARDED_BY(mu_);
+};
+
+}  // namespace eager
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_EAGER_STREAMING_ENQUEUE_BATCHER_H_
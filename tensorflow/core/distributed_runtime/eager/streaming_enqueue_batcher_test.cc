@@ -0,0 +1,195 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/distributed_runtime/eager/streaming_enqueue_batcher.h"
+
+#include <deque>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace eager {
+namespace {
+
+// Records the sent requests, which are completed explicitly by the test. Every
+// queue item is answered with a queue response holding the item's op id.
+class FakeStream {
+ public:
+  StreamingEnqueueBatcher::SendFunction SendFunction() {
+    return [this](const EnqueueRequest* request, EnqueueResponse* response,
+                  StatusCallback done) {
+      sent_.push_back({*request, response, std::move(done)});
+    };
+  }
+
+  int num_sent() const { return sent_.size(); }
+
+  const EnqueueRequest& request(int i) const { return sent_[i].request; }
+
+  void Complete(int i, const Status& status = OkStatus()) {
+    for (const QueueItem& item : sent_[i].request.queue()) {
+      QueueResponse* queue_response = sent_[i].response->add_queue_response();
+      queue_response->add_shape()->add_dim()->set_size(item.operation().id());
+    }
+    sent_[i].done(status);
+  }
+
+ private:
+  struct Sent {
+    EnqueueRequest request;
+    EnqueueResponse* response;
+    StatusCallback done;
+  };
+  // Completing a request may send the next one, which must not invalidate the
+  // request being completed.
+  std::deque<Sent> sent_;
+};
+
+EnqueueRequest MakeRequest(const std::vector<int64_t>& op_ids) {
+  EnqueueRequest request;
+  request.set_context_id(1);
+  for (int64_t op_id : op_ids) {
+    request.add_queue()->mutable_operation()->set_id(op_id);
+  }
+  return request;
+}
+
+struct Result {
+  EnqueueResponse response;
+  Status status;
+  bool done = false;
+
+  StatusCallback Done() {
+    return [this](const Status& s) {
+      status = s;
+      done = true;
+    };
+  }
+
+  std::vector<int64_t> OpIds() const {
+    std::vector<int64_t> op_ids;
+    for (const QueueResponse& queue_response : response.queue_response()) {
+      op_ids.push_back(queue_response.shape(0).dim(0).size());
+    }
+    return op_ids;
+  }
+};
+
+TEST(StreamingEnqueueBatcherTest, SendsRightAwayWhenIdle) {
+  FakeStream stream;
+  core::RefCountPtr<StreamingEnqueueBatcher> batcher(
+      new StreamingEnqueueBatcher(/*max_batch_size=*/8, stream.SendFunction()));
+
+  Result result;
+  batcher->Enqueue(MakeRequest({1, 2}), &result.response, result.Done());
+  ASSERT_EQ(stream.num_sent(), 1);
+  EXPECT_EQ(stream.request(0).queue_size(), 2);
+
+  stream.Complete(0);
+  ASSERT_TRUE(result.done);
+  TF_EXPECT_OK(result.status);
+  EXPECT_EQ(result.OpIds(), std::vector<int64_t>({1, 2}));
+}
+
+TEST(StreamingEnqueueBatcherTest, CoalescesRequestsWhileInFlight) {
+  FakeStream stream;
+  core::RefCountPtr<StreamingEnqueueBatcher> batcher(
+      new StreamingEnqueueBatcher(/*max_batch_size=*/8, stream.SendFunction()));
+
+  std::vector<Result> results(4);
+  batcher->Enqueue(MakeRequest({1}), &results[0].response, results[0].Done());
+  batcher->Enqueue(MakeRequest({2, 3}), &results[1].response,
+                   results[1].Done());
+  batcher->Enqueue(MakeRequest({4}), &results[2].response, results[2].Done());
+  batcher->Enqueue(MakeRequest({5, 6}), &results[3].response,
+                   results[3].Done());
+  ASSERT_EQ(stream.num_sent(), 1);
+
+  // The requests issued while the first one was in flight are sent together.
+  stream.Complete(0);
+  ASSERT_EQ(stream.num_sent(), 2);
+  EXPECT_EQ(stream.request(1).context_id(), 1);
+  EXPECT_EQ(stream.request(1).queue_size(), 5);
+  EXPECT_TRUE(results[0].done);
+  EXPECT_FALSE(results[1].done);
+
+  stream.Complete(1);
+  for (const Result& result : results) {
+    ASSERT_TRUE(result.done);
+    TF_EXPECT_OK(result.status);
+  }
+  EXPECT_EQ(results[1].OpIds(), std::vector<int64_t>({2, 3}));
+  EXPECT_EQ(results[2].OpIds(), std::vector<int64_t>({4}));
+  EXPECT_EQ(results[3].OpIds(), std::vector<int64_t>({5, 6}));
+
+  // The batcher is idle again.
+  Result result;
+  batcher->Enqueue(MakeRequest({7}), &result.response, result.Done());
+  ASSERT_EQ(stream.num_sent(), 3);
+  stream.Complete(2);
+  EXPECT_TRUE(result.done);
+}
+
+TEST(StreamingEnqueueBatcherTest, RespectsMaxBatchSize) {
+  FakeStream stream;
+  core::RefCountPtr<StreamingEnqueueBatcher> batcher(
+      new StreamingEnqueueBatcher(/*max_batch_size=*/2, stream.SendFunction()));
+
+  std::vector<Result> results(4);
+  for (int i = 0; i < static_cast<int>(results.size()); ++i) {
+    batcher->Enqueue(MakeRequest({i}), &results[i].response,
+                     results[i].Done());
+  }
+  stream.Complete(0);
+  ASSERT_EQ(stream.num_sent(), 2);
+  EXPECT_EQ(stream.request(1).queue_size(), 2);
+  stream.Complete(1);
+  ASSERT_EQ(stream.num_sent(), 3);
+  EXPECT_EQ(stream.request(2).queue_size(), 1);
+  stream.Complete(2);
+  for (int i = 0; i < static_cast<int>(results.size()); ++i) {
+    ASSERT_TRUE(results[i].done);
+    EXPECT_EQ(results[i].OpIds(), std::vector<int64_t>({i}));
+  }
+}
+
+TEST(StreamingEnqueueBatcherTest, FailureIsReportedToTheWholeBatch) {
+  FakeStream stream;
+  core::RefCountPtr<StreamingEnqueueBatcher> batcher(
+      new StreamingEnqueueBatcher(/*max_batch_size=*/8, stream.SendFunction()));
+
+  std::vector<Result> results(3);
+  for (int i = 0; i < static_cast<int>(results.size()); ++i) {
+    batcher->Enqueue(MakeRequest({i}), &results[i].response,
+                     results[i].Done());
+  }
+  stream.Complete(0);
+  stream.Complete(1, errors::Internal("Remote op failed"));
+  for (const Result& result : results) {
+    ASSERT_TRUE(result.done);
+  }
+  TF_EXPECT_OK(results[0].status);
+  EXPECT_TRUE(errors::IsInternal(results[1].status));
+  EXPECT_TRUE(errors::IsInternal(results[2].status));
+}
+
+}  // namespace
+}  // namespace eager
+}  // namespace tensorflow
@@ -0,0 +1,138 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/distributed_runtime/recv_tensor_compression.h"
+
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_split.h"
+#include "tensorflow/core/framework/bfloat16.h"
+#include "tensorflow/core/framework/tensor_shape.pb.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/monitoring/counter.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/snappy.h"
+#include "tensorflow/core/util/env_var.h"
+
+namespace tensorflow {
+
+namespace {
+
+auto* recv_tensor_compression_bytes = monitoring::Counter<1>::New(
+    "/tensorflow/rpc/recv_tensor_compression_bytes",
+    "Tensor content bytes sent with RecvTensor compression, before "
+    "(\"uncompressed\") and after (\"compressed\") encoding.",
+    "stage");
+
+}  // namespace
+
+const RecvTensorCompression& AcceptedRecvTensorCompression() {
+  static const RecvTensorCompression* accepted = [] {
+    auto* accepted = new RecvTensorCompression;
+    std::string encodings;
+    TF_CHECK_OK(
+        ReadStringFromEnvVar("TF_RECV_TENSOR_COMPRESSION", "", &encodings));
+    for (absl::string_view encoding :
+         absl::StrSplit(encodings, ',', absl::SkipWhitespace())) {
+      if (encoding == "snappy") {
+        accepted->set_snappy(true);
+      } else if (encoding == "bfloat16") {
+        accepted->set_bfloat16(true);
+      } else {
+        LOG(WARNING) << "Ignoring unknown RecvTensor compression " << encoding;
+      }
+    }
+    int64_t min_bytes;
+    TF_CHECK_OK(ReadInt64FromEnvVar("TF_RECV_TENSOR_COMPRESSION_MIN_BYTES",
+                                    64 << 10, &min_bytes));
+    accepted->set_min_bytes(min_bytes);
+    return accepted;
+  }();
+  return *accepted;
+}
+
+bool CompressRecvTensorResponse(const RecvTensorCompression& accepted,
+                                const Tensor& val,
+                                RecvTensorResponse* response) {
+  if (!IsRecvTensorCompressionEnabled(accepted) ||
+      !DataTypeCanUseMemcpy(val.dtype()) ||
+      val.TotalBytes() < static_cast<size_t>(accepted.min_bytes())) {
+    return false;
+  }
+  RecvTensorCompression compression;
+  StringPiece content = val.tensor_data();
+  std::vector<bfloat16> rounded;
+  if (accepted.bfloat16() && val.dtype() == DT_FLOAT) {
+    rounded.resize(val.NumElements());
+    RoundFloatToBFloat16(val.flat<float>().data(), rounded.data(),
+                         rounded.size());
+    content = StringPiece(reinterpret_cast<const char*>(rounded.data()),
+                          rounded.size() * sizeof(bfloat16));
+    compression.set_bfloat16(true);
+  }
+  std::string compressed;
+  if (accepted.snappy() &&
+      port::Snappy_Compress(content.data(), content.size(), &compressed) &&
+      compressed.size() < content.size()) {
+    content = compressed;
+    compression.set_snappy(true);
+  }
+  if (!IsRecvTensorCompressionEnabled(compression)) return false;
+
+  TensorProto* proto = response->mutable_tensor();
+  proto->set_dtype(val.dtype());
+  val.shape().AsProto(proto->mutable_tensor_shape());
+  proto->set_tensor_content(content.data(), content.size());
+  *response->mutable_compression() = compression;
+  recv_tensor_compression_bytes->GetCell("uncompressed")
+      ->IncrementBy(val.TotalBytes());
+  recv_tensor_compression_bytes->GetCell("compressed")
+      ->IncrementBy(content.size());
+  return true;
+}
+
+Status DecompressTensorContent(const RecvTensorCompression& compression,
+                               TensorProto* tensor) {
+  if (compression.snappy()) {
+    const std::string& content = tensor->tensor_content();
+    size_t uncompressed_bytes;
+    if (!port::Snappy_GetUncompressedLength(content.data(), content.size(),
+                                            &uncompressed_bytes)) {
+      return errors::DataLoss("Invalid snappy tensor content");
+    }
+    std::string uncompressed(uncompressed_bytes, '\0');
+    if (!port::Snappy_Uncompress(content.data(), content.size(),
+                                 &uncompressed[0])) {
+      return errors::DataLoss("Invalid snappy tensor content");
+    }
+    tensor->set_tensor_content(std::move(uncompressed));
+  }
+  if (compression.bfloat16()) {
+    if (tensor->dtype() != DT_FLOAT ||
+        tensor->tensor_content().size() % sizeof(bfloat16) != 0) {
+      return errors::DataLoss("Invalid bfloat16 tensor content");
+    }
+    const std::string& content = tensor->tensor_content();
+    const int64_t num_elements = content.size() / sizeof(bfloat16);
+    std::string widened(num_elements * sizeof(float), '\0');
+    BFloat16ToFloat(reinterpret_cast<const bfloat16*>(content.data()),
+                    reinterpret_cast<float*>(&widened[0]), num_elements);
+    tensor->set_tensor_content(std::move(widened));
+  }
+  return OkStatus();
+}
+
+}  // namespace tensorflow
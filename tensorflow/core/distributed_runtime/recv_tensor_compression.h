@@ -0,0 +1,56 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_RECV_TENSOR_COMPRESSION_H_
+#define TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_RECV_TENSOR_COMPRESSION_H_
+
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor.pb.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/protobuf/worker.pb.h"
+
+namespace tensorflow {
+
+// Returns the encodings that this process accepts for received tensors, as
+// set by the environment variables
+//
+//   TF_RECV_TENSOR_COMPRESSION: a comma-separated list of "snappy" and
+//     "bfloat16". Empty (the default) disables compression.
+//   TF_RECV_TENSOR_COMPRESSION_MIN_BYTES: tensors whose content is smaller
+//     than this are sent uncompressed. Defaults to 64KiB.
+const RecvTensorCompression& AcceptedRecvTensorCompression();
+
+// Returns true if `compression` enables any encoding.
+inline bool IsRecvTensorCompressionEnabled(
+    const RecvTensorCompression& compression) {
+  return compression.snappy() || compression.bfloat16();
+}
+
+// Encodes `val` into `response->tensor()` with the subset of `accepted` that
+// applies to it, and records the encoding in `response->compression()`.
+// Returns false, leaving `response` untouched, if no encoding applies or
+// compression does not reduce the size.
+bool CompressRecvTensorResponse(const RecvTensorCompression& accepted,
+                                const Tensor& val,
+                                RecvTensorResponse* response);
+
+// Decodes `tensor->tensor_content()` in place, given the `compression` set on
+// the RecvTensorResponse that holds `tensor`.
+Status DecompressTensorContent(const RecvTensorCompression& compression,
+                               TensorProto* tensor);
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_RECV_TENSOR_COMPRESSION_H_
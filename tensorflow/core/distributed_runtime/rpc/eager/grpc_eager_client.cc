@@ -19,6 +19,7 @@ limitations under the License.
 
 #include "grpcpp/generic/generic_stub.h"
 #include "tensorflow/core/distributed_runtime/call_options.h"
+#include "tensorflow/core/distributed_runtime/eager/streaming_enqueue_batcher.h"
 #include "tensorflow/core/distributed_runtime/rpc/eager/grpc_eager_service.h"
 #include "tensorflow/core/distributed_runtime/rpc/grpc_client_cq_tag.h"
 #include "tensorflow/core/distributed_runtime/rpc/grpc_state.h"
@@ -72,6 +73,20 @@ bool EnableStreaming() {
   return result;
 }
 
+/* Setting environment variable "TF_EAGER_CLIENT_STREAMING_ENQUEUE_BATCH_SIZE"
+ * to a value larger than 1 coalesces the requests sent through streaming
+ * enqueue while a previous request is in flight into a single request of at
+ * most that many queue items (see StreamingEnqueueBatcher). This reduces the
+ * number of round trips when many small ops are executed remotely, e.g. on
+ * parameter servers.
+ */
+int64_t StreamingEnqueueBatchSize() {
+  int64_t result;
+  TF_CHECK_OK(ReadInt64FromEnvVar("TF_EAGER_CLIENT_STREAMING_ENQUEUE_BATCH_SIZE",
+                                  1, &result));
+  return result;
+}
+
 // Ref-counted thread to handle callbacks for completed requests a GRPC
 // completion queue. The thread might be shared by multiple eager clients, and
 // each one of them should hold a reference count to ensure that the thread
@@ -178,6 +193,7 @@ class GrpcEagerClient : public EagerClient {
             << request->DebugString();
 
     mutex_lock l(mu_);
+    enqueue_batchers_.erase(request->context_id());
     const auto& it = enqueue_dispatchers_.find(request->context_id());
     if (it != enqueue_dispatchers_.end()) {
       it->second.CancelCall();
@@ -199,19 +215,30 @@ class GrpcEagerClient : public EagerClient {
     // 2. The flag set in the eager executor.
     // Streaming enqueue is allowed only when the both are enabled.
     if (EnableStreaming() && enable_streaming_enqueue) {
-      mutex_lock l(mu_);
-      auto it = enqueue_dispatchers_.find(request->context_id());
-      if (it == enqueue_dispatchers_.end()) {
-        auto it_and_bool = enqueue_dispatchers_.emplace(
-            std::piecewise_construct,
-            std::forward_as_tuple(request->context_id()),
-            std::forward_as_tuple(
-                &stub_, cq_,
-                "/tensorflow.eager.EagerService/StreamingEnqueue"));
-        it = it_and_bool.first;
+      const int64_t batch_size = StreamingEnqueueBatchSize();
+      if (batch_size > 1) {
+        core::RefCountPtr<StreamingEnqueueBatcher> batcher;
+        {
+          mutex_lock l(mu_);
+          auto& batcher_in_map = enqueue_batchers_[request->context_id()];
+          if (batcher_in_map == nullptr) {
+            // The batcher only sends requests while some of its callers wait
+            // for their (wrapped) callbacks, which keeps `this` alive.
+            batcher_in_map.reset(new StreamingEnqueueBatcher(
+                batch_size,
+                [this](const EnqueueRequest* request, EnqueueResponse* response,
+                       StatusCallback done) {
+                  SendNextStreamingRequest(*request, response,
+                                           std::move(done));
+                }));
+          }
+          batcher_in_map->Ref();
+          batcher.reset(batcher_in_map.get());
+        }
+        batcher->Enqueue(*request, response, std::move(done_wrapped));
+      } else {
+        SendNextStreamingRequest(*request, response, std::move(done_wrapped));
       }
-      // TODO(haoyuzhang): Consider supporting cancellation for streaming RPC?
-      it->second.SendNextRequest(*request, response, std::move(done_wrapped));
     } else {
       Notification n;
       Status status;
@@ -237,6 +264,26 @@ class GrpcEagerClient : public EagerClient {
   std::unordered_map<uint64, StreamingRPCDispatcher<EnqueueResponse>>
       enqueue_dispatchers_ TF_GUARDED_BY(mu_);
 
+  std::unordered_map<uint64, core::RefCountPtr<StreamingEnqueueBatcher>>
+      enqueue_batchers_ TF_GUARDED_BY(mu_);
+
+  // Feeds `request` into the StreamingEnqueue call of its context.
+  void SendNextStreamingRequest(const EnqueueRequest& request,
+                                EnqueueResponse* response,
+                                StatusCallback done) {
+    mutex_lock l(mu_);
+    auto it = enqueue_dispatchers_.find(request.context_id());
+    if (it == enqueue_dispatchers_.end()) {
+      auto it_and_bool = enqueue_dispatchers_.emplace(
+          std::piecewise_construct, std::forward_as_tuple(request.context_id()),
+          std::forward_as_tuple(
+              &stub_, cq_, "/tensorflow.eager.EagerService/StreamingEnqueue"));
+      it = it_and_bool.first;
+    }
+    // TODO(haoyuzhang): Consider supporting cancellation for streaming RPC?
+    it->second.SendNextRequest(request, response, std::move(done));
+  }
+
   StatusCallback callback_wrapper(StatusCallback done) {
     Ref();
     return [this, done = std::move(done)](const Status& status) {
@@ -18,6 +18,7 @@ limitations under the License.
 #include "grpcpp/support/byte_buffer.h"
 #include "grpcpp/support/slice.h"
 #include "tensorflow/core/common_runtime/dma_helper.h"
+#include "tensorflow/core/distributed_runtime/recv_tensor_compression.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor.pb.h"
 #include "tensorflow/core/framework/tensor_reference.h"
@@ -250,5 +251,20 @@ void EncodeTensorToByteBuffer(bool is_dead, const Tensor& val, bool require_ack,
   }
 }
 
+void EncodeTensorToByteBuffer(bool is_dead, const Tensor& val, bool require_ack,
+                              const RecvTensorCompression& accept_compression,
+                              ::grpc::ByteBuffer* result) {
+  if (!is_dead && IsRecvTensorCompressionEnabled(accept_compression)) {
+    RecvTensorResponse response;
+    if (CompressRecvTensorResponse(accept_compression, val, &response)) {
+      response.set_require_ack(require_ack);
+      response.set_send_start_micros(Env::Default()->NowMicros());
+      EncodeRecvTensorResponseToByteBuffer(response, result);
+      return;
+    }
+  }
+  EncodeTensorToByteBuffer(is_dead, val, require_ack, result);
+}
+
 }  // namespace grpc
 }  // namespace tensorflow
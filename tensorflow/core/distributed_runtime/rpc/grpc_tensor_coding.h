@@ -20,6 +20,7 @@ limitations under the License.
 
 namespace tensorflow {
 class Tensor;
+class RecvTensorCompression;
 class RecvTensorResponse;
 
 // TODO(jeff,sanjay): this should not be grpc specific.  Instead of
@@ -49,6 +50,13 @@ void EncodeRecvTensorResponseToByteBuffer(const RecvTensorResponse& proto,
 void EncodeTensorToByteBuffer(bool is_dead, const Tensor& val, bool require_ack,
                               ::grpc::ByteBuffer* result);
 
+// As above, but encodes the tensor content with the subset of
+// "accept_compression" that applies to "val" (see
+// recv_tensor_compression.h).
+void EncodeTensorToByteBuffer(bool is_dead, const Tensor& val, bool require_ack,
+                              const RecvTensorCompression& accept_compression,
+                              ::grpc::ByteBuffer* result);
+
 }  // namespace grpc
 }  // namespace tensorflow
 
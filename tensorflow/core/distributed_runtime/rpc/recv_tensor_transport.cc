@@ -0,0 +1,49 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/distributed_runtime/rpc/recv_tensor_transport.h"
+
+#include <utility>
+
+#include "tensorflow/core/platform/logging.h"
+
+namespace tensorflow {
+
+/*static*/ RecvTensorTransportRegistry* RecvTensorTransportRegistry::Global() {
+  static RecvTensorTransportRegistry* registry =
+      new RecvTensorTransportRegistry;
+  return registry;
+}
+
+void RecvTensorTransportRegistry::Register(const std::string& name,
+                                           Factory factory) {
+  mutex_lock l(mu_);
+  CHECK(factories_.emplace(name, std::move(factory)).second)
+      << "RecvTensor transport " << name << " registered twice";
+}
+
+std::unique_ptr<RecvTensorTransport> RecvTensorTransportRegistry::Create(
+    const std::string& name, const WorkerEnv* env) const {
+  Factory factory;
+  {
+    mutex_lock l(mu_);
+    auto it = factories_.find(name);
+    if (it == factories_.end()) return nullptr;
+    factory = it->second;
+  }
+  return factory(env);
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,114 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_RPC_RECV_TENSOR_TRANSPORT_H_
+#define TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_RPC_RECV_TENSOR_TRANSPORT_H_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "tensorflow/core/distributed_runtime/base_rendezvous_mgr.h"
+#include "tensorflow/core/distributed_runtime/worker_env.h"
+#include "tensorflow/core/distributed_runtime/worker_interface.h"
+#include "tensorflow/core/framework/rendezvous.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+
+class Device;
+
+// A transport that moves the payload of cross-process RecvTensor calls out of
+// band, typically through RDMA (ibverbs, UCX, GPUDirect), while gRPC keeps
+// carrying the control traffic of the worker service.
+//
+// `RpcRendezvousMgr` uses the transport registered under the name in the
+// environment variable `TF_RECV_TENSOR_TRANSPORT`, and falls back to the gRPC
+// RecvTensor call for every transfer the transport declines.
+//
+// Implementations own their connection management and remote side, e.g. an
+// extra service added with `GrpcServer::ExtraServices()` that exchanges
+// memory keys. Buffers that are transferred without copies can be registered
+// with the NIC as they are allocated, by adding `SubAllocator::Visitor`s
+// through `ProcessState::AddCPUAllocVisitor()` and
+// `GPUProcessState::AddGPUAllocVisitor()` before the first allocation.
+class RecvTensorTransport {
+ public:
+  // A single transfer. Once `Start()`'s callback runs with an OK `status()`,
+  // `tensor()` and `is_dead()` hold the received value.
+  class Call : public BaseRecvTensorCall {
+   public:
+    virtual const Tensor& tensor() const = 0;
+    virtual bool is_dead() const = 0;
+  };
+
+  virtual ~RecvTensorTransport() {}
+
+  // Returns a new call that receives the tensor `parsed` from the worker
+  // `src_worker`, whose control channel is `wi`, into `dst_device`, or
+  // nullptr if this transport cannot serve this transfer.
+  virtual std::unique_ptr<Call> CreateCall(WorkerInterface* wi,
+                                           const std::string& src_worker,
+                                           int64_t step_id,
+                                           const Rendezvous::ParsedKey& parsed,
+                                           const Rendezvous::Args& recv_args,
+                                           Device* dst_device) = 0;
+};
+
+class RecvTensorTransportRegistry {
+ public:
+  typedef std::function<std::unique_ptr<RecvTensorTransport>(
+      const WorkerEnv*)>
+      Factory;
+
+  static RecvTensorTransportRegistry* Global();
+
+  void Register(const std::string& name, Factory factory);
+
+  // Returns a new transport, or nullptr if `name` is not registered.
+  std::unique_ptr<RecvTensorTransport> Create(const std::string& name,
+                                              const WorkerEnv* env) const;
+
+ private:
+  mutable mutex mu_;
+  std::unordered_map<std::string, Factory> factories_ TF_GUARDED_BY(mu_);
+};
+
+namespace recv_tensor_transport_registration {
+
+class Registrar {
+ public:
+  Registrar(const std::string& name,
+            RecvTensorTransportRegistry::Factory factory) {
+    RecvTensorTransportRegistry::Global()->Register(name, std::move(factory));
+  }
+};
+
+}  // namespace recv_tensor_transport_registration
+
+#define REGISTER_RECV_TENSOR_TRANSPORT(name, factory) \
+  REGISTER_RECV_TENSOR_TRANSPORT_UNIQ_HELPER(__COUNTER__, name, factory)
+#define REGISTER_RECV_TENSOR_TRANSPORT_UNIQ_HELPER(ctr, name, factory) \
+  REGISTER_RECV_TENSOR_TRANSPORT_UNIQ(ctr, name, factory)
+#define REGISTER_RECV_TENSOR_TRANSPORT_UNIQ(ctr, name, factory) \
+  static ::tensorflow::recv_tensor_transport_registration::Registrar \
+      recv_tensor_transport_registrar__body__##ctr##__object(name, factory)
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_RPC_RECV_TENSOR_TRANSPORT_H_
@@ -19,7 +19,9 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/device_mgr.h"
 #include "tensorflow/core/common_runtime/dma_helper.h"
 #include "tensorflow/core/common_runtime/process_util.h"
+#include "tensorflow/core/distributed_runtime/recv_tensor_compression.h"
 #include "tensorflow/core/distributed_runtime/request_id.h"
+#include "tensorflow/core/distributed_runtime/rpc/recv_tensor_transport.h"
 #include "tensorflow/core/distributed_runtime/tensor_coding.h"
 #include "tensorflow/core/distributed_runtime/worker_cache.h"
 #include "tensorflow/core/distributed_runtime/worker_interface.h"
@@ -31,6 +33,7 @@ limitations under the License.
 #include "tensorflow/core/platform/macros.h"
 #include "tensorflow/core/platform/notification.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 
@@ -38,8 +41,9 @@ namespace {
 
 class RpcRemoteRendezvous : public BaseRemoteRendezvous {
  public:
-  RpcRemoteRendezvous(const WorkerEnv* env, int64_t step_id)
-      : BaseRemoteRendezvous(env, step_id) {}
+  RpcRemoteRendezvous(const WorkerEnv* env, int64_t step_id,
+                      RecvTensorTransport* transport)
+      : BaseRemoteRendezvous(env, step_id), transport_(transport) {}
 
  protected:
   void RecvFromRemoteAsync(const Rendezvous::ParsedKey& parsed,
@@ -49,6 +53,15 @@ class RpcRemoteRendezvous : public BaseRemoteRendezvous {
  private:
   ~RpcRemoteRendezvous() override {}
 
+  // Receives through `transport_`. Returns false, without invoking `done`, if
+  // the transport declines the transfer.
+  bool MaybeRecvWithTransport(const Rendezvous::ParsedKey& parsed,
+                              const Rendezvous::Args& recv_args,
+                              const string& src_worker, WorkerInterface* rwi,
+                              Device* dst_device, DoneCallback* done);
+
+  RecvTensorTransport* const transport_;  // Not owned. May be null.
+
   TF_DISALLOW_COPY_AND_ASSIGN(RpcRemoteRendezvous);
 };
 
@@ -68,6 +81,10 @@ class RpcRecvTensorCall : public BaseRecvTensorCall {
     req_.set_step_id(step_id);
     req_.set_rendezvous_key(key.data(), key.size());
     req_.set_request_id(GetUniqueRequestId());
+    const RecvTensorCompression& compression = AcceptedRecvTensorCompression();
+    if (IsRecvTensorCompressionEnabled(compression)) {
+      *req_.mutable_accept_compression() = compression;
+    }
   }
 
   void Reset() {
@@ -267,6 +284,13 @@ void RpcRemoteRendezvous::RecvFromRemoteAsync(
     return;
   }
 
+  if (transport_ != nullptr &&
+      MaybeRecvWithTransport(parsed, recv_args, call->src_worker_, rwi,
+                             dst_device, &done)) {
+    get_call_freelist()->Release(call);
+    return;
+  }
+
   call->Init(rwi, step_id_, parsed.FullKey(), recv_args.alloc_attrs, dst_device,
              recv_args, std::move(done));
 
@@ -303,15 +327,64 @@ void RpcRemoteRendezvous::RecvFromRemoteAsync(
   });
 }
 
+bool RpcRemoteRendezvous::MaybeRecvWithTransport(
+    const Rendezvous::ParsedKey& parsed, const Rendezvous::Args& recv_args,
+    const string& src_worker, WorkerInterface* rwi, Device* dst_device,
+    DoneCallback* done) {
+  std::unique_ptr<RecvTensorTransport::Call> owned_call = transport_->CreateCall(
+      rwi, src_worker, step_id_, parsed, recv_args, dst_device);
+  if (owned_call == nullptr) return false;
+  RecvTensorTransport::Call* call = owned_call.release();
+  WorkerSession* sess = session();
+
+  // Record "call" in calls_ so that it can be aborted cleanly.
+  RegisterCall(call, recv_args);
+  if (!call->status().ok()) {
+    DeregisterCall(call, recv_args);
+    sess->worker_cache()->ReleaseWorker(src_worker, rwi);
+    (*done)(call->status(), Args(), Args(), Tensor(), false);
+    delete call;
+    return true;
+  }
+
+  Ref();
+  call->Start([this, call, recv_args, src_worker, rwi,
+               done = std::move(*done)]() {
+    DeregisterCall(call, recv_args);
+    Status s = call->status();
+    // NOTE: `*session()` can potentially be deleted before we return from
+    // `done(...)`, so we must release the worker before calling the callback.
+    session()->worker_cache()->ReleaseWorker(src_worker, rwi);
+    done(s, Args(), recv_args, call->tensor(), call->is_dead());
+    delete call;
+    Unref();
+  });
+  return true;
+}
+
 }  // namespace
 
 RpcRendezvousMgr::RpcRendezvousMgr(const WorkerEnv* env)
-    : BaseRendezvousMgr(env) {}
+    : BaseRendezvousMgr(env) {
+  string transport_name;
+  TF_CHECK_OK(ReadStringFromEnvVar("TF_RECV_TENSOR_TRANSPORT", "",
+                                   &transport_name));
+  if (!transport_name.empty()) {
+    transport_ =
+        RecvTensorTransportRegistry::Global()->Create(transport_name, env);
+    if (transport_ == nullptr) {
+      LOG(WARNING) << "Unknown RecvTensor transport " << transport_name
+                   << "; tensors will be received through gRPC.";
+    }
+  }
+}
+
+RpcRendezvousMgr::~RpcRendezvousMgr() {}
 
 tsl::core::RefCountPtr<BaseRemoteRendezvous> RpcRendezvousMgr::Create(
     int64_t step_id, const WorkerEnv* worker_env) {
   return tsl::core::RefCountPtr<BaseRemoteRendezvous>(
-      new RpcRemoteRendezvous(worker_env, step_id));
+      new RpcRemoteRendezvous(worker_env, step_id, transport_.get()));
 }
 
 }  // end namespace tensorflow
@@ -15,7 +15,10 @@ limitations under the License.
 
 #include "tensorflow/core/distributed_runtime/rpc/rpc_rendezvous_mgr.h"
 
+#include <stdlib.h>
+
 #include "tensorflow/core/common_runtime/process_util.h"
+#include "tensorflow/core/distributed_runtime/rpc/recv_tensor_transport.h"
 #include "tensorflow/core/distributed_runtime/test_utils.h"
 #include "tensorflow/core/framework/cancellation.h"
 #include "tensorflow/core/framework/control_flow.h"
@@ -99,6 +102,38 @@ class DummyWorkerCache : public WorkerCacheInterface {
   DummyWorker* dummy_remote_worker_ = nullptr;
 };
 
+// A transport that serves the tensors whose name is "fast" with a constant.
+class FakeTransport : public RecvTensorTransport {
+ public:
+  class FakeCall : public Call {
+   public:
+    void Start(std::function<void()> recv_done) override {
+      SchedClosure(std::move(recv_done));
+    }
+    void StartAbort(const Status& s) override {}
+    Status status() const override { return OkStatus(); }
+    const Tensor& tensor() const override { return tensor_; }
+    bool is_dead() const override { return false; }
+
+   private:
+    const Tensor tensor_ = V("transport");
+  };
+
+  std::unique_ptr<Call> CreateCall(WorkerInterface* wi,
+                                   const std::string& src_worker,
+                                   int64_t step_id,
+                                   const Rendezvous::ParsedKey& parsed,
+                                   const Rendezvous::Args& recv_args,
+                                   Device* dst_device) override {
+    if (parsed.edge_name != "fast") return nullptr;
+    return std::make_unique<FakeCall>();
+  }
+};
+
+REGISTER_RECV_TENSOR_TRANSPORT("fake", [](const WorkerEnv*) {
+  return std::make_unique<FakeTransport>();
+});
+
 static Device* CreateDevice(const char* type, const char* name) {
   class FakeDevice : public Device {
    public:
@@ -342,4 +377,32 @@ TEST_F(RpcRendezvousMgrTest, RemoteRecvAsyncMany) {
   rmgr_.Cleanup(step_id);
 }
 
+TEST_F(RpcRendezvousMgrTest, RemoteRecvWithTransport) {
+  setenv("TF_RECV_TENSOR_TRANSPORT", "fake", 1);
+  RpcRendezvousMgr rmgr(&env);
+  unsetenv("TF_RECV_TENSOR_TRANSPORT");
+  const int64_t step_id = 123;
+  const Rendezvous::ParsedKey fast_key = MakeKey(Rendezvous::CreateKey(
+      "/job:worker/replica:1/task:2/cpu:0", 7890,
+      "/job:mnist/replica:1/task:2/cpu:1", "fast", FrameAndIter(0, 0)));
+  const Rendezvous::ParsedKey slow_key = MakeKey(Rendezvous::CreateKey(
+      "/job:worker/replica:1/task:2/cpu:0", 7890,
+      "/job:mnist/replica:1/task:2/cpu:1", "slow", FrameAndIter(0, 0)));
+  {
+    tsl::core::RefCountPtr<RemoteRendezvous> rendez = rmgr.Find(step_id);
+    TF_ASSERT_OK(rendez->Initialize(&worker_session_));
+    Rendezvous::Args args;
+
+    Tensor val(DT_STRING);
+    bool val_dead = false;
+    TF_ASSERT_OK(rendez->Recv(fast_key, args, &val, &val_dead));
+    EXPECT_EQ(V(val), "transport");
+    EXPECT_FALSE(val_dead);
+
+    // Transfers declined by the transport go through RecvTensor.
+    TF_ASSERT_OK(rendez->Recv(slow_key, args, &val, &val_dead));
+  }
+  rmgr.Cleanup(step_id);
+}
+
 }  // namespace tensorflow
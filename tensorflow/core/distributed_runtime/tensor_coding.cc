@@ -18,6 +18,7 @@ limitations under the License.
 #include "google/protobuf/any.pb.h"
 
 #include "tensorflow/core/common_runtime/device.h"
+#include "tensorflow/core/distributed_runtime/recv_tensor_compression.h"
 #include "tensorflow/core/framework/tensor.pb.h"
 #include "tensorflow/core/framework/tensor_shape.pb.h"
 
@@ -53,6 +54,10 @@ void TensorResponse::InitAlloc(DeviceBase* d, const AllocatorAttributes& aa) {
 Status TensorResponse::InitFrom(RecvTensorResponse* response) {
   Status s;
   meta_.Swap(response);
+  if (meta_.has_compression()) {
+    TF_RETURN_IF_ERROR(
+        DecompressTensorContent(meta_.compression(), meta_.mutable_tensor()));
+  }
   if (on_host_) {
     if (!tensor_.FromProto(allocator_, meta_.tensor())) {
       s = errors::InvalidArgument("Cannot parse tensor from response");
@@ -87,6 +92,10 @@ Status TensorResponse::ParseFrom(Source* source) {
     if (!meta_.ParseFromCodedStream(&input) || !input.ConsumedEntireMessage()) {
       return errors::InvalidArgument("Cannot parse tensor from response");
     }
+    if (meta_.has_compression()) {
+      TF_RETURN_IF_ERROR(
+          DecompressTensorContent(meta_.compression(), meta_.mutable_tensor()));
+    }
     Status s =
         device_->MakeTensorFromProto(meta_.tensor(), alloc_attrs_, &tensor_);
     // Reduce memory usage for big tensors.
@@ -185,8 +194,9 @@ bool TensorResponse::ParseTensorSubmessage(
       }
       case TensorProto::kTensorContentFieldNumber: {
         // If we haven't seen the dtype and tensor_shape data first, we can't
-        // deal with this in the fast path.
-        if (seen_tensor_content) return false;
+        // deal with this in the fast path. Compressed content is decoded on
+        // the slow path.
+        if (seen_tensor_content || meta_.has_compression()) return false;
         if (wt != WIRETYPE_LENGTH_DELIMITED ||
             !tensor_meta->has_tensor_shape()) {
           return false;
@@ -265,6 +275,12 @@ bool TensorResponse::ParseFast(Source* source) {
         meta_.set_require_ack(v != 0);
         break;
       }
+      case RecvTensorResponse::kCompressionFieldNumber: {
+        if ((wt != WIRETYPE_LENGTH_DELIMITED) ||
+            !ReadNestedMessage(&input, meta_.mutable_compression()))
+          return false;
+        break;
+      }
       default: {
         // Unknown tag, so don't handle we can't handle on the fast path
         return false;
@@ -279,6 +295,11 @@ bool TensorResponse::ParseSlow(Source* source) {
   if (!meta_.ParseFromZeroCopyStream(source->contents())) {
     return false;
   }
+  if (meta_.has_compression() &&
+      !DecompressTensorContent(meta_.compression(), meta_.mutable_tensor())
+           .ok()) {
+    return false;
+  }
 
   Tensor parsed(meta_.tensor().dtype());
   if (!parsed.FromProto(allocator_, meta_.tensor())) {
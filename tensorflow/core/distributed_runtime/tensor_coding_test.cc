@@ -15,10 +15,12 @@ limitations under the License.
 
 #include "tensorflow/core/distributed_runtime/tensor_coding.h"
 
+#include "tensorflow/core/distributed_runtime/recv_tensor_compression.h"
 #include "tensorflow/core/framework/device_attributes.pb.h"
 #include "tensorflow/core/framework/device_base.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/env.h"
@@ -156,6 +158,36 @@ TEST_F(TensorResponseTest, Simple) {
 
 TEST_F(TensorResponseTest, StringTensor) { DoTestForStrings(DT_STRING); }
 
+TEST_F(TensorResponseTest, CompressedTensor) {
+  // Small integers are exactly representable in bfloat16.
+  Tensor src(DT_FLOAT, TensorShape({256, 256}));
+  auto flat = src.flat<float>();
+  for (int i = 0; i < flat.size(); ++i) flat(i) = i % 64;
+
+  RecvTensorCompression accepted;
+  accepted.set_snappy(true);
+  accepted.set_bfloat16(true);
+  RecvTensorResponse proto;
+  ASSERT_TRUE(CompressRecvTensorResponse(accepted, src, &proto));
+  EXPECT_TRUE(proto.compression().bfloat16());
+  EXPECT_LE(proto.tensor().tensor_content().size(), src.TotalBytes() / 2);
+  string encoded;
+  proto.AppendToString(&encoded);
+
+  StringSource source(&encoded, 1024);
+  TensorResponse response;
+  DummyDevice cpu_device(Env::Default());
+  response.InitAlloc(&cpu_device, AllocatorAttributes());
+  TF_ASSERT_OK(response.ParseFrom(&source));
+  test::ExpectTensorEqual<float>(response.tensor(), src);
+
+  // Tensors below the size threshold are not compressed.
+  accepted.set_min_bytes(src.TotalBytes() + 1);
+  RecvTensorResponse uncompressed;
+  EXPECT_FALSE(CompressRecvTensorResponse(accepted, src, &uncompressed));
+  EXPECT_FALSE(uncompressed.has_compression());
+}
+
 string MakeFloatTensorTestCase(int num_elems) {
   std::vector<int8> v(num_elems);
   for (int i = 0; i < num_elems; i++) {
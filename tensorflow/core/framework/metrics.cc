@@ -174,11 +174,52 @@ auto* tf_data_service_cross_trainer_cache_size_bytes =
         "/tensorflow/data/service/cross_trainer_cache_size_bytes",
         "tf.data service cross-trainer cache memory usage in bytes.");
 
+auto* tf_data_service_cross_trainer_cache_evictions_counter =
+    tsl::monitoring::Counter<1>::New(
+        "/tensorflow/data/service/cross_trainer_cache_evictions",
+        "tf.data service cross-trainer cache elements evicted from memory.",
+        "spilled");
+
+auto* tf_data_service_cross_trainer_cache_spill_discards_counter =
+    tsl::monitoring::Counter<0>::New(
+        "/tensorflow/data/service/cross_trainer_cache_spill_discards",
+        "tf.data service cross-trainer cache elements discarded from disk.");
+
+auto* tf_data_service_cross_trainer_cache_spill_size_bytes =
+    tsl::monitoring::Gauge<int64_t, 0>::New(
+        "/tensorflow/data/service/cross_trainer_cache_spill_size_bytes",
+        "tf.data service cross-trainer cache disk usage in bytes.");
+
 auto* tf_data_service_snapshot_bytes_committed =
     tsl::monitoring::Counter<0>::New(
         "/tensorflow/data/service/snapshot_bytes_committed",
         "tf.data service distributed snapshot committed bytes.");
 
+auto* tf_data_service_client_wait_time_usecs_histogram =
+    tsl::monitoring::Sampler<0>::New(
+        {"/tensorflow/data/service/client_wait_time",
+         "Average microseconds tf.data service clients waited for an element, "
+         "as reported to the dispatcher."},
+        // Power of 2 with bucket count 25 (from 1 microsecond to about 16
+        // seconds).
+        {tsl::monitoring::Buckets::Exponential(1, 2, 25)});
+
+auto* tf_data_service_worker_buffer_occupancy_histogram =
+    tsl::monitoring::Sampler<0>::New(
+        {"/tensorflow/data/service/worker_buffer_occupancy",
+         "Fraction of the buffers of tf.data service tasks that is full, as "
+         "reported to the dispatcher."},
+        // Uniform linear buckets with count 10 from 0 to 1
+        {tsl::monitoring::Buckets::Explicit(
+            {0.0, 0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8, 0.9, 1.0})});
+
+auto* tf_data_service_recommended_num_workers =
+    tsl::monitoring::Gauge<int64_t, 1>::New(
+        "/tensorflow/data/service/recommended_num_workers",
+        "Number of workers the tf.data service dispatcher recommends for a "
+        "job.",
+        "job_id");
+
 auto* tf_data_service_data_transfer_protocol_used =
     tsl::monitoring::Counter<1>::New(
         "/tensorflow/data/service/data_transfer_protocol_used",
@@ -525,10 +566,41 @@ void RecordTFDataServiceCrossTrainerCacheSizeBytes(size_t bytes) {
       static_cast<int64_t>(bytes));
 }
 
+void RecordTFDataServiceCrossTrainerCacheEviction(bool spilled) {
+  tf_data_service_cross_trainer_cache_evictions_counter
+      ->GetCell(spilled ? "true" : "false")
+      ->IncrementBy(1);
+}
+
+void RecordTFDataServiceCrossTrainerCacheSpillDiscard() {
+  tf_data_service_cross_trainer_cache_spill_discards_counter->GetCell()
+      ->IncrementBy(1);
+}
+
+void RecordTFDataServiceCrossTrainerCacheSpillSizeBytes(size_t bytes) {
+  tf_data_service_cross_trainer_cache_spill_size_bytes->GetCell()->Set(
+      static_cast<int64_t>(bytes));
+}
+
 void RecordTFDataServiceSnapshotBytesCommitted(int64_t bytes) {
   tf_data_service_snapshot_bytes_committed->GetCell()->IncrementBy(bytes);
 }
 
+void RecordTFDataServiceClientWaitTime(int64_t wait_time_usec) {
+  tf_data_service_client_wait_time_usecs_histogram->GetCell()->Add(
+      static_cast<double>(wait_time_usec));
+}
+
+void RecordTFDataServiceWorkerBufferOccupancy(double occupancy) {
+  tf_data_service_worker_buffer_occupancy_histogram->GetCell()->Add(occupancy);
+}
+
+void RecordTFDataServiceRecommendedNumWorkers(int64_t job_id,
+                                              int64_t num_workers) {
+  tf_data_service_recommended_num_workers->GetCell(absl::StrCat(job_id))
+      ->Set(num_workers);
+}
+
 void RecordTFDataFilename(const string& name, const string& filename) {
   tf_data_filename_counter->GetCell(name, filename)->IncrementBy(1);
 }
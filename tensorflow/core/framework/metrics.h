@@ -159,9 +159,33 @@ void RecordTFDataServiceCrossTrainerCacheQuery(bool cache_hit);
 // Records tf.data service cross-trainer cache memory usage in bytes.
 void RecordTFDataServiceCrossTrainerCacheSizeBytes(size_t bytes);
 
+// Records an element evicted from the memory of the tf.data service
+// cross-trainer cache, which is either spilled to disk or discarded.
+void RecordTFDataServiceCrossTrainerCacheEviction(bool spilled);
+
+// Records a spilled element discarded from the disk of the tf.data service
+// cross-trainer cache.
+void RecordTFDataServiceCrossTrainerCacheSpillDiscard();
+
+// Records tf.data service cross-trainer cache disk usage in bytes.
+void RecordTFDataServiceCrossTrainerCacheSpillSizeBytes(size_t bytes);
+
 // Records distributed tf.data snapshot bytes committed.
 void RecordTFDataServiceSnapshotBytesCommitted(int64_t bytes);
 
+// Records the average time a tf.data service client waited for an element, as
+// reported to the dispatcher.
+void RecordTFDataServiceClientWaitTime(int64_t wait_time_usec);
+
+// Records the fraction of the buffer of a tf.data service task that is full,
+// as reported to the dispatcher.
+void RecordTFDataServiceWorkerBufferOccupancy(double occupancy);
+
+// Records the number of workers the dispatcher recommends for a tf.data
+// service job.
+void RecordTFDataServiceRecommendedNumWorkers(int64_t job_id,
+                                              int64_t num_workers);
+
 // Records the file name read by a tf.data Dataset.
 //
 // The `name` argument identifies the Dataset type (e.g. "TFRecordDataset").
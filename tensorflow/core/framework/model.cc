@@ -1914,6 +1914,23 @@ void Node::CollectBufferParametersToUpsize(
   }
 }
 
+Parameter* Node::CollectBufferParameterToShrink(double* element_bytes) {
+  Parameter* buffer_parameter = nullptr;
+  {
+    tf_shared_lock l(mu_);
+    auto* parameter = gtl::FindOrNull(parameters_, kBufferSize);
+    if (parameter == nullptr || (*parameter)->state == nullptr ||
+        !(*parameter)->state->tunable) {
+      return nullptr;
+    }
+    buffer_parameter = parameter->get();
+    *element_bytes = AverageBufferedElementSize();
+  }
+  tf_shared_lock l(*buffer_parameter->state->mu);
+  buffer_parameter->value = buffer_parameter->state->value;
+  return buffer_parameter;
+}
+
 Node::NodeVector Node::CollectNodesLocked(
     TraversalOrder order, bool collect_node(const std::shared_ptr<Node>)) const
     TF_SHARED_LOCKS_REQUIRED(mu_) {
@@ -2175,6 +2192,37 @@ Status Node::FromProto(ModelProto::Node node_proto,
   return FromProtoHelper(node_proto, *node);
 }
 
+BufferedBytesRegistry* BufferedBytesRegistry::Global() {
+  static BufferedBytesRegistry* registry = new BufferedBytesRegistry;
+  return registry;
+}
+
+int64_t BufferedBytesRegistry::Update(const void* owner, int64_t bytes,
+                                      int64_t ram_budget) {
+  mutex_lock l(mu_);
+  int64_t& owner_bytes = bytes_[owner];
+  total_bytes_ += bytes - owner_bytes;
+  owner_bytes = bytes;
+  const int64_t other_bytes = total_bytes_ - owner_bytes;
+  const int64_t even_share = ram_budget / static_cast<int64_t>(bytes_.size());
+  return std::max(even_share, ram_budget - other_bytes);
+}
+
+void BufferedBytesRegistry::Remove(const void* owner) {
+  mutex_lock l(mu_);
+  auto it = bytes_.find(owner);
+  if (it == bytes_.end()) {
+    return;
+  }
+  total_bytes_ -= it->second;
+  bytes_.erase(it);
+}
+
+int64_t BufferedBytesRegistry::TotalBytes() const {
+  tf_shared_lock l(mu_);
+  return total_bytes_;
+}
+
 Model::Model()
     : optimization_period_ms_(kOptimizationPeriodMinMs),
       safe_to_collect_metrics_(std::make_shared<GuardedBool>(true)) {
@@ -2208,6 +2256,7 @@ Model::Model()
 }
 
 Model::~Model() {
+  BufferedBytesRegistry::Global()->Remove(this);
   mutex_lock l(safe_to_collect_metrics_->mu);
   safe_to_collect_metrics_->val = false;
 }
@@ -2260,9 +2309,14 @@ void Model::Optimize(AutotuneAlgorithm algorithm, int64_t cpu_budget,
     tf_shared_lock l(mu_);
     snapshot = output_->Snapshot();
   }
+  const double max_buffered_bytes = TotalMaximumBufferedBytes(snapshot);
   if (!port::JobName().empty()) {
-    RecordAutotuneRamUsage(ram_budget, TotalMaximumBufferedBytes(snapshot));
+    RecordAutotuneRamUsage(ram_budget, max_buffered_bytes);
   }
+  // The RAM budget is shared by all input pipelines of the process, so that
+  // the buffers of concurrent iterators do not exceed it together.
+  ram_budget = BufferedBytesRegistry::Global()->Update(
+      this, static_cast<int64_t>(max_buffered_bytes), ram_budget);
   OptimizationParams optimization_params;
   optimization_params.set_algorithm(algorithm);
   optimization_params.set_cpu_budget(cpu_budget);
@@ -2292,6 +2346,12 @@ void Model::Optimize(AutotuneAlgorithm algorithm, int64_t cpu_budget,
   if (experiments_.contains("autotune_buffer_optimization")) {
     OptimizeBuffers(snapshot, optimization_params.ram_budget());
   }
+  if (ShrinkBuffers(snapshot, optimization_params.ram_budget())) {
+    ResetBufferWatermarks();
+  }
+  BufferedBytesRegistry::Global()->Update(
+      this, static_cast<int64_t>(TotalMaximumBufferedBytes(snapshot)),
+      optimization_params.ram_budget());
   {
     // Save the snapshot of the model proto including the parameters used by
     // autotune. This will be used as the model proto returned in `tfstreamz`.
@@ -2332,6 +2392,79 @@ bool Model::DownsizeBuffers(std::shared_ptr<Node> snapshot) {
   return downsized;
 }
 
+bool Model::ShrinkBuffers(std::shared_ptr<Node> snapshot, int64_t ram_budget) {
+  double excess_bytes =
+      TotalMaximumBufferedBytes(snapshot) - static_cast<double>(ram_budget);
+  if (excess_bytes <= 0) {
+    return false;
+  }
+  struct Buffer {
+    Node* node;
+    Parameter* parameter;
+    double element_bytes;
+    // Share of the buffer that held elements the consumer did not need since
+    // the watermarks were last reset.
+    double unused_share;
+  };
+  Node::NodeVector nodes =
+      snapshot->CollectNodes(TraversalOrder::BFS, IsAnyNode);
+  nodes.push_back(snapshot);
+  std::vector<Buffer> buffers;
+  for (auto& node : nodes) {
+    if (!node->IsAsync()) {
+      continue;
+    }
+    double element_bytes = 0;
+    Parameter* parameter = node->CollectBufferParameterToShrink(&element_bytes);
+    if (parameter == nullptr || element_bytes <= 0 || parameter->value <= 1) {
+      continue;
+    }
+    const int64_t low = node->buffered_elements_low();
+    const int64_t high = node->buffered_elements_high();
+    // If no element was stored in the buffer yet, none of it was needed.
+    const double unused_share =
+        low > high ? 1.0
+                   : std::min(1.0, static_cast<double>(low) / parameter->value);
+    buffers.push_back({node.get(), parameter, element_bytes, unused_share});
+  }
+  // Shrink the least useful buffers first and, among equally useful ones, the
+  // largest ones.
+  std::stable_sort(buffers.begin(), buffers.end(),
+                   [](const Buffer& a, const Buffer& b) {
+                     if (a.unused_share != b.unused_share) {
+                       return a.unused_share > b.unused_share;
+                     }
+                     return a.element_bytes * a.parameter->value >
+                            b.element_bytes * b.parameter->value;
+                   });
+  bool shrunk = false;
+  for (auto& buffer : buffers) {
+    if (excess_bytes <= 0) {
+      break;
+    }
+    Parameter* parameter = buffer.parameter;
+    const double old_value = parameter->value;
+    parameter->value = std::max(
+        std::max(1.0, parameter->min),
+        old_value - std::ceil(excess_bytes / buffer.element_bytes));
+    if (parameter->value >= old_value) {
+      parameter->value = old_value;
+      continue;
+    }
+    excess_bytes -= (old_value - parameter->value) * buffer.element_bytes;
+    VLOG(2) << "Shrink buffer " << buffer.node->long_name()
+            << "::" << parameter->name << " from " << old_value << " to "
+            << parameter->value << " to fit in the RAM budget";
+    {
+      mutex_lock l(*parameter->state->mu);
+      parameter->state->value = parameter->value;
+      parameter->state->cond_var->notify_all();
+    }
+    shrunk = true;
+  }
+  return shrunk;
+}
+
 absl::flat_hash_map<Node*, Parameter*> Model::CollectBufferParametersToUpsize(
     std::shared_ptr<Node> snapshot) {
   Node::NodeVector nodes =
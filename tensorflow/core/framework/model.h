@@ -72,6 +72,34 @@ enum class TraversalOrder {
   REVERSE_BFS = 1,
 };
 
+// Records the maximum number of bytes that the buffers of each autotuned input
+// pipeline of the process may hold, so that concurrent pipelines share a single
+// RAM budget instead of each of them assuming that the whole budget is its
+// own.
+//
+// BufferedBytesRegistry is thread safe.
+class BufferedBytesRegistry {
+ public:
+  static BufferedBytesRegistry* Global();
+
+  // Records that the buffers of `owner` may hold up to `bytes`, and returns the
+  // share of `ram_budget` that `owner` may use: whatever the other owners leave
+  // over, but no less than an even split of `ram_budget` between all owners.
+  int64_t Update(const void* owner, int64_t bytes, int64_t ram_budget)
+      TF_LOCKS_EXCLUDED(mu_);
+
+  // Forgets `owner`, e.g. when its input pipeline is destroyed.
+  void Remove(const void* owner) TF_LOCKS_EXCLUDED(mu_);
+
+  // Returns the bytes recorded for all owners.
+  int64_t TotalBytes() const TF_LOCKS_EXCLUDED(mu_);
+
+ private:
+  mutable mutex mu_;
+  absl::flat_hash_map<const void*, int64_t> bytes_ TF_GUARDED_BY(mu_);
+  int64_t total_bytes_ TF_GUARDED_BY(mu_) = 0;
+};
+
 // Represents thread-safe state that can be shared between an input pipeline and
 // the performance model.
 struct SharedState {
@@ -498,6 +526,11 @@ class Node {
   void CollectBufferParametersToUpsize(
       absl::flat_hash_map<Node*, Parameter*>& node_parameters);
 
+  // Returns the tunable buffer parameter of this node, with its value synced to
+  // the input pipeline, or nullptr if there is none. Sets `element_bytes` to
+  // the average size of the buffered elements.
+  Parameter* CollectBufferParameterToShrink(double* element_bytes);
+
  protected:
   // Used for (incrementally) recording metrics. The class is thread-safe.
   class Metrics {
@@ -885,6 +918,12 @@ class Model {
   // respecting the ram budget. Returns true if any buffer is upsized.
   bool UpsizeBuffers(std::shared_ptr<Node> snapshot, int64_t ram_budget);
 
+  // Shrinks buffers of the nodes rooted at `snapshot` until their maximum
+  // buffered bytes fit in `ram_budget`, starting with the least useful ones,
+  // i.e. those whose elements are consumed the least. Returns true if any
+  // buffer is shrunk.
+  bool ShrinkBuffers(std::shared_ptr<Node> snapshot, int64_t ram_budget);
+
   // Reset buffer watermarks of all asynchronous nodes to their buffered
   // elements.
   void ResetBufferWatermarks();
@@ -808,7 +808,30 @@ Status OpKernelContext::allocate_output(int index, const TensorShape& shape,
       op_kernel().name_view().data(), step_id(), "output", type,
       [&shape]() { return shape.DebugString(); });
   auto output_tensor = std::make_unique<Tensor>();
-  Status s = allocate_tensor(type, shape, output_tensor.get(), attr);
+  Status s;
+  if (TF_PREDICT_FALSE(params_->planned_output_allocator_array != nullptr &&
+                       params_->planned_output_allocator_array[index] !=
+                           nullptr &&
+                       !track_allocations() &&
+                       attr.value == output_alloc_attr(index).value &&
+                       attr.scope_id == 0)) {
+    Tensor new_tensor(params_->planned_output_allocator_array[index], type,
+                      shape,
+                      AllocationAttributes(/*retry_on_failure=*/true,
+                                           /*allocation_will_be_logged=*/true,
+                                           /*freed_by_func=*/nullptr));
+    if (new_tensor.IsInitialized()) {
+      if (params_->log_memory) {
+        LogMemory::RecordTensorAllocation(params_->op_kernel->name(),
+                                          params_->step_id, new_tensor);
+      }
+      *output_tensor = std::move(new_tensor);
+    } else {
+      s = allocate_tensor(type, shape, output_tensor.get(), attr);
+    }
+  } else {
+    s = allocate_tensor(type, shape, output_tensor.get(), attr);
+  }
   if (s.ok()) {
     outputs_[index] = TensorValue(output_tensor.release());
     *output = outputs_[index].tensor;
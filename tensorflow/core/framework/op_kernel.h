@@ -620,6 +620,12 @@ class OpKernelContext {
     // Array indexed by output number for this node
     const AllocatorAttributes* output_attr_array = nullptr;
 
+    // Optional array indexed by output number for this node. A non-null entry
+    // is the allocator used by `allocate_output()` for that output when it is
+    // called with the attributes in `output_attr_array`. Used by the
+    // executor's static memory planner.
+    Allocator* const* planned_output_allocator_array = nullptr;
+
     // Shared resources accessible by this op kernel invocation.
     ResourceMgr* resource_manager = nullptr;
 
@@ -71,11 +71,17 @@ class RendezvousInterface {
     ParsedKey& operator=(const ParsedKey& b);
     StringPiece FullKey() const { return buf_; }
 
+    // Returns the hash of FullKey(), which is computed once by ParseKey(), so
+    // that the Send and Recv kernels of static graphs do not hash their keys
+    // on every step.
+    uint64 FullKeyHash() const { return hash_; }
+
    private:
     friend class Rendezvous;
     friend class SendOp;
     friend class RecvOp;
     std::string buf_;
+    uint64 hash_ = 0;
   };
 
   // The caller is a tensor producer and it sends a message (a tensor
@@ -128,10 +128,22 @@ ResourceMgr::ResourceAndName& ResourceMgr::ResourceAndName::operator=(
   return *this;
 }
 
-ResourceMgr::ResourceMgr() : default_container_("localhost") {}
+// Returns a new version, distinct from the versions of all ResourceMgrs.
+static uint64 NextResourceMgrVersion() {
+  static std::atomic<uint64> next_version(1);
+  return next_version.fetch_add(1, std::memory_order_relaxed);
+}
+
+ResourceMgr::ResourceMgr()
+    : default_container_("localhost"), version_(NextResourceMgrVersion()) {}
 
 ResourceMgr::ResourceMgr(const string& default_container)
-    : default_container_(default_container) {}
+    : default_container_(default_container),
+      version_(NextResourceMgrVersion()) {}
+
+void ResourceMgr::UpdateVersion() {
+  version_.store(NextResourceMgrVersion(), std::memory_order_release);
+}
 
 ResourceMgr::~ResourceMgr() { Clear(); }
 
@@ -142,6 +154,7 @@ void ResourceMgr::Clear() {
   {
     mutex_lock l(mu_);
     tmp_containers = std::move(containers_);
+    UpdateVersion();
   }
   for (const auto& p : tmp_containers) {
     delete p.second;
@@ -205,6 +218,7 @@ Status ResourceMgr::DoCreate(const string& container_name, TypeIndex type,
       auto iter = container->find({type.hash_code(), borrowed_name});
       if (iter != container->end()) {
         container->erase(iter);
+        UpdateVersion();
       }
     };
     resource_and_name.resource =
@@ -240,6 +254,22 @@ Status ResourceMgr::DoLookup(const string& container, uint64 type_hash_code,
                              const string& type_name,
                              const string& resource_name,
                              ResourceBase** resource) const {
+  bool owned;
+  return DoLookup(container, type_hash_code, type_name, resource_name,
+                  resource, &owned);
+}
+
+Status ResourceMgr::DoLookup(const string& container, TypeIndex type,
+                             const string& name, ResourceBase** resource,
+                             bool* owned) const {
+  return DoLookup(container, type.hash_code(), type.name(), name, resource,
+                  owned);
+}
+
+Status ResourceMgr::DoLookup(const string& container, uint64 type_hash_code,
+                             const string& type_name,
+                             const string& resource_name,
+                             ResourceBase** resource, bool* owned) const {
   const Container* b = gtl::FindPtrOrNull(containers_, container);
   if (b == nullptr) {
     return errors::NotFound("Container ", container,
@@ -257,6 +287,8 @@ Status ResourceMgr::DoLookup(const string& container, uint64 type_hash_code,
                             type_name, " has been destroyed.");
   }
   *resource = ptr;
+  *owned = absl::holds_alternative<core::RefCountPtr<ResourceBase>>(
+      iter->second.resource);
   return OkStatus();
 }
 
@@ -277,6 +309,7 @@ Status ResourceMgr::PopResourceAndName(const string& container,
   }
   std::swap(resource_and_name, iter->second);
   b->erase(iter);
+  UpdateVersion();
   return OkStatus();
 }
 
@@ -326,6 +359,7 @@ Status ResourceMgr::Cleanup(const string& container) {
     }
     b = iter->second;
     containers_.erase(iter);
+    UpdateVersion();
   }
   CHECK(b != nullptr);
   delete b;
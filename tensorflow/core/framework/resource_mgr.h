@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_FRAMEWORK_RESOURCE_MGR_H_
 #define TENSORFLOW_CORE_FRAMEWORK_RESOURCE_MGR_H_
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <typeindex>
@@ -237,7 +238,14 @@ class ResourceMgr {
   // Returns a text description for all resources.
   std::string DebugString() const;
 
+  // Returns the version of the resources in *this, which changes whenever a
+  // resource is removed. The versions of different ResourceMgrs are distinct.
+  uint64 version() const { return version_.load(std::memory_order_acquire); }
+
  private:
+  template <typename T>
+  friend class ResourceLookupCache;
+
   typedef std::pair<uint64, StringPiece> Key;
   struct KeyHash {
     std::size_t operator()(const Key& k) const {
@@ -274,6 +282,10 @@ class ResourceMgr {
   const std::string default_container_;
   mutable mutex mu_;
   absl::flat_hash_map<string, Container*> containers_ TF_GUARDED_BY(mu_);
+  std::atomic<uint64> version_;
+
+  // Changes the version after resources were removed from `containers_`.
+  void UpdateVersion() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
   template <typename T, bool use_dynamic_cast = false>
   Status LookupInternal(const std::string& container, const std::string& name,
@@ -297,6 +309,18 @@ class ResourceMgr {
                   ResourceBase** resource) const
       TF_SHARED_LOCKS_REQUIRED(mu_) TF_MUST_USE_RESULT;
 
+  // Like DoLookup, and sets "*owned" to whether *this owns a reference on
+  // "*resource", i.e. whether it was not created by CreateUnowned.
+  Status DoLookup(const std::string& container, TypeIndex type,
+                  const std::string& name, ResourceBase** resource,
+                  bool* owned) const
+      TF_SHARED_LOCKS_REQUIRED(mu_) TF_MUST_USE_RESULT;
+  Status DoLookup(const std::string& container, uint64 type_hash_code,
+                  const std::string& type_name,
+                  const std::string& resource_name, ResourceBase** resource,
+                  bool* owned) const
+      TF_SHARED_LOCKS_REQUIRED(mu_) TF_MUST_USE_RESULT;
+
   Status DoDelete(const std::string& container, uint64 type_hash_code,
                   const std::string& resource_name,
                   const std::string& type_name) TF_MUST_USE_RESULT;
@@ -397,6 +421,36 @@ template <typename T>
 Status LookupResources(OpKernelContext* ctx, absl::Span<ResourceHandle const> p,
                        std::vector<core::RefCountPtr<T>>* values);
 
+// Caches the resource looked up for a resource handle, so that the repeated
+// lookups of the same handle, e.g. by a kernel reading a variable on every
+// step, take neither the lock of the ResourceMgr nor hash the resource name.
+// The cached resource is looked up again once a resource is removed from the
+// ResourceMgr.
+//
+// The cache holds a reference to its resource until the next lookup finds out
+// the resource was removed, or until the cache is destroyed, like the
+// resources held by ResourceOpKernel. Resources created by CreateUnowned and
+// ref-counting handles are not cached.
+template <typename T>
+class ResourceLookupCache {
+ public:
+  ResourceLookupCache() = default;
+
+  // Same as LookupResource(ctx, p, value).
+  Status Lookup(OpKernelContext* ctx, const ResourceHandle& p,
+                core::RefCountPtr<T>* value) TF_MUST_USE_RESULT;
+
+ private:
+  mutex mu_;
+  const ResourceMgr* resource_mgr_ TF_GUARDED_BY(mu_) = nullptr;
+  uint64 version_ TF_GUARDED_BY(mu_) = 0;
+  std::string container_ TF_GUARDED_BY(mu_);
+  std::string name_ TF_GUARDED_BY(mu_);
+  core::RefCountPtr<T> resource_ TF_GUARDED_BY(mu_);
+
+  TF_DISALLOW_COPY_AND_ASSIGN(ResourceLookupCache);
+};
+
 // Looks up or creates a resource.
 //
 // If successful, the caller takes the ownership of one ref on `*value`, and
@@ -819,6 +873,49 @@ Status LookupResource(OpKernelContext* ctx, const ResourceHandle& p,
   return OkStatus();
 }
 
+template <typename T>
+Status ResourceLookupCache<T>::Lookup(OpKernelContext* ctx,
+                                      const ResourceHandle& p,
+                                      core::RefCountPtr<T>* value) {
+  if (p.IsRefCounting()) {
+    return LookupResource(ctx, p, value);
+  }
+  TF_RETURN_IF_ERROR(internal::ValidateDeviceAndType<T>(ctx, p));
+  const ResourceMgr* rm = ctx->resource_manager();
+  // The version is read before the lookup, so that a resource removed during
+  // the lookup invalidates the cached resource.
+  const uint64 version = rm->version();
+  {
+    tf_shared_lock l(mu_);
+    if (resource_ != nullptr && resource_mgr_ == rm && version_ == version &&
+        name_ == p.name() && container_ == p.container()) {
+      resource_->Ref();
+      value->reset(resource_.get());
+      return OkStatus();
+    }
+  }
+
+  ResourceBase* found = nullptr;
+  bool owned = false;
+  {
+    tf_shared_lock l(rm->mu_);
+    TF_RETURN_IF_ERROR(rm->DoLookup(p.container(), TypeIndex::Make<T>(),
+                                    p.name(), &found, &owned));
+  }
+  T* resource = static_cast<T*>(found);
+  value->reset(resource);
+  if (owned) {
+    mutex_lock l(mu_);
+    resource->Ref();
+    resource_.reset(resource);
+    resource_mgr_ = rm;
+    version_ = version;
+    container_ = p.container();
+    name_ = p.name();
+  }
+  return OkStatus();
+}
+
 // Similar to Lookup, but looks up multiple resources at once, with only a
 // single lock acquisition.
 template <typename T>
@@ -468,4 +468,46 @@ TEST(ResourceHandleTest, DeleteUsingResourceHandle) {
   EXPECT_NE(LookupResource<StubResource>(&ctx, p, &lookup_r).ok(), true);
 }
 
+TEST(ResourceHandleTest, LookupCache) {
+  ResourceMgr resource_mgr("");
+  OpKernelContext::Params params;
+  params.resource_manager = &resource_mgr;
+  StubDevice device("device_name");
+  params.device = &device;
+  OpKernelContext ctx(&params, 0);
+
+  ResourceHandle p =
+      MakeResourceHandle<StubResource>(&ctx, "container", "name");
+  ResourceHandle other =
+      MakeResourceHandle<StubResource>(&ctx, "container", "other");
+  StubResource* r = new StubResource;
+  TF_ASSERT_OK(CreateResource(&ctx, p, r));
+  StubResource* other_r = new StubResource;
+  TF_ASSERT_OK(CreateResource(&ctx, other, other_r));
+
+  ResourceLookupCache<StubResource> cache;
+  for (int i = 0; i < 2; ++i) {
+    core::RefCountPtr<StubResource> lookup_r;
+    TF_ASSERT_OK(cache.Lookup(&ctx, p, &lookup_r));
+    EXPECT_EQ(lookup_r.get(), r);
+  }
+  {
+    core::RefCountPtr<StubResource> lookup_r;
+    TF_ASSERT_OK(cache.Lookup(&ctx, other, &lookup_r));
+    EXPECT_EQ(lookup_r.get(), other_r);
+  }
+
+  // The deletion of the resource invalidates the cache, and the resource
+  // created again under the same name is looked up.
+  const uint64 version = resource_mgr.version();
+  TF_ASSERT_OK(DeleteResource(&ctx, other));
+  EXPECT_NE(resource_mgr.version(), version);
+  core::RefCountPtr<StubResource> lookup_r;
+  EXPECT_TRUE(errors::IsNotFound(cache.Lookup(&ctx, other, &lookup_r)));
+  StubResource* new_r = new StubResource;
+  TF_ASSERT_OK(CreateResource(&ctx, other, new_r));
+  TF_ASSERT_OK(cache.Lookup(&ctx, other, &lookup_r));
+  EXPECT_EQ(lookup_r.get(), new_r);
+}
+
 }  // end namespace tensorflow
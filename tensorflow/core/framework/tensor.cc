@@ -547,6 +547,42 @@ Buffer<T>::~Buffer() {
   }
 }
 
+// A host buffer of at most kMaxBytes bytes, which are allocated together with
+// the buffer rather than by an Allocator. Tensor uses it for the small tensors
+// of simple types on the default CPU allocator, which saves the allocator call
+// and the second heap allocation.
+class SmallHostBuffer : public TensorBuffer {
+ public:
+  static constexpr size_t kMaxBytes = 16;
+
+  explicit SmallHostBuffer(size_t size) : TensorBuffer(data_), size_(size) {
+    DCHECK_LE(size, kMaxBytes);
+  }
+
+  size_t size() const override { return size_; }
+  TensorBuffer* root_buffer() override { return this; }
+
+  bool GetAllocatedBytes(size_t* out_bytes) const override { return false; }
+
+  void FillAllocationDescription(AllocationDescription* proto) const override {
+    proto->set_requested_bytes(size_);
+    proto->set_allocator_name("SmallHostBuffer");
+    proto->set_ptr(reinterpret_cast<uintptr_t>(data()));
+  }
+
+  AllocatorMemoryType GetMemoryType() const override {
+    return AllocatorMemoryType::kHostPageable;
+  }
+
+ private:
+  ~SmallHostBuffer() override = default;
+
+  alignas(EIGEN_MAX_ALIGN_BYTES) char data_[kMaxBytes];
+  const size_t size_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(SmallHostBuffer);
+};
+
 // Allocates a T[n] buffer. Fills in the buffer with repeated values
 // in "in".  If "in" has less values than "n", fills the rest of T[n]
 // with the last value. If "in" has no values, fills T[n] with the
@@ -888,11 +924,42 @@ int Tensor::RefCount() const {
   CASES_WITH_DEFAULT(TYPE_ENUM, STMTS, LOG(FATAL) << "Type not set"; \
                      , LOG(FATAL) << "Unexpected type: " << TYPE_ENUM;)
 
+// NOTE(mrry): The default allocator for a Tensor (when none is specified) is
+// the default CPU allocator for NUMA zone 0. Accessing that currently involves
+// acquiring a lock, which guards initialization of the per-NUMA zone
+// allocators, and becomes highly contended.
+//
+// Note also that it would be better if all Tensor allocations required the user
+// to specify an allocator, for purposes of accounting, etc. However, the
+// default allocator is widely used throughout the codebase and in client code.
+static Allocator* get_default_cpu_allocator() {
+  static Allocator* default_cpu_allocator =
+      cpu_allocator(tsl::port::kNUMANoAffinity);
+  return default_cpu_allocator;
+}
+
+// Returns a SmallHostBuffer for a tensor of `type` with `num_elements`
+// elements on allocator `a`, or nullptr if the tensor must be allocated by `a`.
+// Memory logging and the CPU allocator stats account the allocations of the
+// allocator, so they disable the small buffers.
+static TensorBuffer* NewSmallHostBuffer(Allocator* a, DataType type,
+                                        int64_t num_elements) {
+  if (a != get_default_cpu_allocator() || num_elements <= 0 ||
+      !DataTypeCanUseMemcpy(type) ||
+      num_elements * DataTypeSize(type) > SmallHostBuffer::kMaxBytes ||
+      MemoryLoggingEnabled() || CPUAllocatorStatsEnabled()) {
+    return nullptr;
+  }
+  return new SmallHostBuffer(num_elements * DataTypeSize(type));
+}
+
 Tensor::Tensor(Allocator* a, DataType type, const TensorShape& shape)
     : shape_(shape), buf_(nullptr) {
   set_dtype(type);
   CHECK_NOTNULL(a);
-  if (shape_.num_elements() > 0 || a->AllocatesOpaqueHandle()) {
+  buf_ = NewSmallHostBuffer(a, type, shape_.num_elements());
+  if (buf_ == nullptr &&
+      (shape_.num_elements() > 0 || a->AllocatesOpaqueHandle())) {
     CASES(type, buf_ = new Buffer<T>(a, shape.num_elements()));
   }
   if (MemoryLoggingEnabled() && buf_ != nullptr && buf_->data() != nullptr) {
@@ -906,7 +973,9 @@ Tensor::Tensor(Allocator* a, DataType type, const TensorShape& shape,
     : shape_(shape), buf_(nullptr) {
   set_dtype(type);
   CHECK_NOTNULL(a);
-  if (shape_.num_elements() > 0 || a->AllocatesOpaqueHandle()) {
+  buf_ = NewSmallHostBuffer(a, type, shape_.num_elements());
+  if (buf_ == nullptr &&
+      (shape_.num_elements() > 0 || a->AllocatesOpaqueHandle())) {
     CASES(type, buf_ = new Buffer<T>(a, shape.num_elements(), allocation_attr));
   }
   if (MemoryLoggingEnabled() && !allocation_attr.allocation_will_be_logged &&
@@ -926,20 +995,6 @@ Status Tensor::BuildTensor(DataType type, const TensorShape& shape,
   return OkStatus();
 }
 
-// NOTE(mrry): The default allocator for a Tensor (when none is specified) is
-// the default CPU allocator for NUMA zone 0. Accessing that currently involves
-// acquiring a lock, which guards initialization of the per-NUMA zone
-// allocators, and becomes highly contended.
-//
-// Note also that it would be better if all Tensor allocations required the user
-// to specify an allocator, for purposes of accounting, etc. However, the
-// default allocator is widely used throughout the codebase and in client code.
-static Allocator* get_default_cpu_allocator() {
-  static Allocator* default_cpu_allocator =
-      cpu_allocator(tsl::port::kNUMANoAffinity);
-  return default_cpu_allocator;
-}
-
 Tensor::Tensor(DataType type, const TensorShape& shape)
     : Tensor(get_default_cpu_allocator(), type, shape) {}
 
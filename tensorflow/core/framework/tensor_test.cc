@@ -1060,6 +1060,38 @@ TEST(Tensor_HostScalar, Basics) {
   }
 }
 
+TEST(Tensor_SmallHost, Basics) {
+  Tensor t(DT_INT32, TensorShape({2, 2}));
+  EXPECT_TRUE(t.IsAligned());
+  t.flat<int32>().setValues({1, 2, 3, 4});
+  test::ExpectTensorEqual<int32>(t,
+                                 test::AsTensor<int32>({1, 2, 3, 4}, {2, 2}));
+  Tensor copy = t;
+  EXPECT_TRUE(copy.SharesBufferWith(t));
+  EXPECT_EQ(t.Slice(1, 2).matrix<int32>()(0, 1), 4);
+  TestCopies<int32>(t);
+  EXPECT_EQ(t.AllocatedBytes(), 16);
+
+  // The small buffers are only used when the CPU allocator does not account
+  // its allocations.
+  if (!CPUAllocatorStatsEnabled()) {
+    TensorDescription small;
+    t.FillDescription(&small);
+    EXPECT_EQ(small.allocation_description().allocator_name(),
+              "SmallHostBuffer");
+    // The tensors of more than 16 bytes, or of non-simple types, are
+    // allocated by the allocator.
+    TensorDescription large;
+    Tensor(DT_INT32, TensorShape({5})).FillDescription(&large);
+    EXPECT_EQ(large.allocation_description().allocator_name(),
+              cpu_allocator()->Name());
+    TensorDescription str;
+    Tensor(DT_STRING, TensorShape({})).FillDescription(&str);
+    EXPECT_EQ(str.allocation_description().allocator_name(),
+              cpu_allocator()->Name());
+  }
+}
+
 TEST(Tensor_Float, Reshape_And_Slice_Assignment) {
   // A test to experiment with a way to assign to a subset of a tensor
   Tensor t(DT_FLOAT, TensorShape({10, 4, 3, 2}));
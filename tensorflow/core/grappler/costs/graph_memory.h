@@ -46,6 +46,10 @@ class GraphMemory {
   Status InferStatically(
       const std::unordered_map<string, DeviceProperties>& devices);
   Status InferDynamically(Cluster* cluster);
+  // Infers the memory usage from the measured timeline of a previous run of
+  // the graph, such as the step_stats of a RunMetadata collected with
+  // RunOptions::FULL_TRACE.
+  void InferFromTrace(const StepStats& timeline);
 
   // Worst case memory usage in bytes, or -1 if the usage is unknown. If there
   // are multiple devices, returns the highest per device memory usage.
@@ -67,8 +71,6 @@ class GraphMemory {
   int64_t InferMemUsageForNeighbors(
       const std::vector<OpInfo::TensorProperties>& props) const;
 
-  void InferFromTrace(const StepStats& timeline);
-
   const GrapplerItem& item_;
   std::unordered_map<string, int64_t> worst_case_memory_usage_;
   std::unordered_map<string, MemoryUsage> peak_usage_;
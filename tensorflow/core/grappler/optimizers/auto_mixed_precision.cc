@@ -105,6 +105,18 @@ std::pair<int, int> GetDeviceGPUArch(
 }
 #endif
 
+#if TENSORFLOW_USE_ROCM
+// Returns the gfx arch of an AMD GPU, e.g. "gfx90a" for an architecture of
+// "gfx90a:sramecc+:xnack-".
+std::string GetDeviceGfxArch(const DeviceProperties& props) {
+  if (props.type() != "GPU") return "";
+  auto it = props.environment().find("architecture");
+  if (it == props.environment().end()) return "";
+  std::vector<std::string> gpu_arch = absl::StrSplit(it->second, ':');
+  return gpu_arch.empty() ? "" : gpu_arch[0];
+}
+#endif
+
 // Returns true if FP16Support is valid
 // For CUDA, We compare the GPUArch with the kMinGPUArch, if GPUArch is >= min,
 // return true. For AMD the corresponding gfx arch string for the detected AMD
@@ -114,16 +126,26 @@ bool HasFastFP16Support(const DeviceProperties& props) {
   return GetDeviceGPUArch(props) >= kMinGPUArch;
 #elif TENSORFLOW_USE_ROCM
   absl::flat_hash_set<std::string> FP16SupportedDevices = {
-      {"gfx906"}, {"gfx908"}, {"gfx90a"}, {"gfx910"}, {"gfx1010"}, {"gfx1012"},
-      {"gfx1030"}, {"gfx1100"}
+      {"gfx906"}, {"gfx908"}, {"gfx90a"}, {"gfx910"}, {"gfx940"}, {"gfx941"},
+      {"gfx942"}, {"gfx1010"}, {"gfx1012"}, {"gfx1030"}, {"gfx1100"}
   };
-  std::string gcnArchName = props.environment().at("architecture");
-  std::vector<std::string> gpu_arch = absl::StrSplit(gcnArchName, ":");
-  return !gpu_arch.empty() && FP16SupportedDevices.contains(gpu_arch[0]);
+  return FP16SupportedDevices.contains(GetDeviceGfxArch(props));
 #endif
   return ShouldSimulateGpu();
 }
 
+// Returns true if the GPU multiplies bfloat16 matrices as fast as float16 ones.
+// This is the case for AMD GPUs whose matrix cores (MFMA) process bfloat16 at
+// the full float16 rate, starting with gfx90a (MI200) and the MI300 series.
+bool HasFastBF16Support(const DeviceProperties& props) {
+#if TENSORFLOW_USE_ROCM
+  absl::flat_hash_set<std::string> BF16SupportedDevices = {
+      {"gfx90a"}, {"gfx940"}, {"gfx941"}, {"gfx942"}};
+  return BF16SupportedDevices.contains(GetDeviceGfxArch(props));
+#endif
+  return false;
+}
+
 // Instances of this class represent unique type attribute identifiers within a
 // node. It handles regular type attributes, list type attributes (where
 // type_index is set to the index in the type list), and fixed types.
@@ -1030,6 +1052,38 @@ std::unordered_map<string, DeviceProperties> GetDevices(Cluster* cluster) {
   return devices;
 }
 
+// Returns the type that nodes on GPUs are converted to. This is bfloat16 if all
+// suitable GPUs process it as fast as float16, since bfloat16 has the range of
+// float32 and does not require loss scaling, and float16 otherwise. On ROCm the
+// type may be forced by setting TF_AUTO_MIXED_PRECISION_GRAPH_REWRITE_GPU_DTYPE
+// to "float16" or "bfloat16".
+DataType GetGpuTargetDataType(
+    const std::unordered_map<string, DeviceProperties>& devices) {
+#if TENSORFLOW_USE_ROCM
+  string dtype;
+  TF_CHECK_OK(ReadStringFromEnvVar(
+      "TF_AUTO_MIXED_PRECISION_GRAPH_REWRITE_GPU_DTYPE", "", &dtype));
+  dtype = absl::AsciiStrToLower(dtype);
+  if (dtype == "float16") return DT_HALF;
+  if (dtype == "bfloat16") return DT_BFLOAT16;
+  if (!dtype.empty()) {
+    LOG(WARNING) << "Ignoring invalid value of "
+                 << "TF_AUTO_MIXED_PRECISION_GRAPH_REWRITE_GPU_DTYPE: " << dtype;
+  }
+#endif
+  bool has_gpu = false;
+  for (const auto& device : devices) {
+    const DeviceProperties& device_properties = device.second;
+    if (device_properties.type() != "GPU" ||
+        !HasFastFP16Support(device_properties)) {
+      continue;
+    }
+    if (!HasFastBF16Support(device_properties)) return DT_HALF;
+    has_gpu = true;
+  }
+  return has_gpu ? DT_BFLOAT16 : DT_HALF;
+}
+
 class AutoMixedPrecisionImpl {
  public:
   // CastType indicates the type of inserted Cast op
@@ -1052,10 +1106,10 @@ class AutoMixedPrecisionImpl {
         cudnn_version_(GetCudnnVersion(devices_)),
         num_nonvar_casts_to_f16_(0),
         mode_(mode),
-        target_dtype_((mode_ == AutoMixedPrecisionMode::CUDA ||
-                       mode_ == AutoMixedPrecisionMode::CPU)
-                          ? DT_HALF
-                          : DT_BFLOAT16) {}
+        target_dtype_(mode_ == AutoMixedPrecisionMode::CUDA
+                          ? GetGpuTargetDataType(devices_)
+                      : mode_ == AutoMixedPrecisionMode::CPU ? DT_HALF
+                                                             : DT_BFLOAT16) {}
 
   Status Optimize();
 
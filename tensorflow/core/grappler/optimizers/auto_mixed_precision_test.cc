@@ -1455,6 +1455,40 @@ TEST_F(AutoMixedPrecisionSimulateGpuTest, Simple_SimulatedGpu_CpuScope) {
              /* is_optimized= */ false);
 }
 
+#if TENSORFLOW_USE_ROCM
+// On AMD GPUs with full-rate bfloat16 matrix cores, bfloat16 is preferred.
+TEST(AutoMixedPrecisionRocmTest, UsesBF16OnMI200) {
+  DeviceProperties device_properties;
+  device_properties.set_type("GPU");
+  device_properties.mutable_environment()->insert(
+      {"architecture", "gfx90a:sramecc+:xnack-"});
+  VirtualCluster cluster({{"/GPU:1", device_properties}});
+  TF_CHECK_OK(cluster.Provision());
+
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  Output input = ops::Const(s.WithOpName("input"), 1.f / 32, {32, 32});
+  Output allow1 = ops::MatMul(s.WithOpName("allow1"), input, input);
+  Output fetch = ops::Identity(s.WithOpName("fetch"), allow1);
+  GrapplerItem item;
+  item.fetch = {"fetch"};
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+
+  for (const auto& [dtype, expected] :
+       std::vector<std::pair<string, DataType>>{{"", DT_BFLOAT16},
+                                                {"float16", DT_HALF}}) {
+    setenv("TF_AUTO_MIXED_PRECISION_GRAPH_REWRITE_GPU_DTYPE", dtype.c_str(),
+           1 /* replace */);
+    AutoMixedPrecision optimizer;
+    GraphDef output;
+    TF_ASSERT_OK(optimizer.Optimize(&cluster, item, &output));
+    GraphView output_view(&output);
+    EXPECT_EQ(output_view.GetNode("allow1")->attr().at("T").type(), expected);
+  }
+  unsetenv("TF_AUTO_MIXED_PRECISION_GRAPH_REWRITE_GPU_DTYPE");
+  TF_CHECK_OK(cluster.Shutdown());
+}
+#endif  // TENSORFLOW_USE_ROCM
+
 #endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 
 #if INTEL_MKL
@@ -0,0 +1,342 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/data/map_vectorization.h"
+
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/algorithm/container.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/framework/attr_value.pb.h"
+#include "tensorflow/core/framework/function.h"
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/framework/node_def_util.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/grappler/clusters/cluster.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/grappler/mutable_graph_view.h"
+#include "tensorflow/core/grappler/op_types.h"
+#include "tensorflow/core/grappler/optimizers/custom_graph_optimizer_registry.h"
+#include "tensorflow/core/grappler/optimizers/data/function_utils.h"
+#include "tensorflow/core/grappler/optimizers/data/graph_utils.h"
+#include "tensorflow/core/grappler/utils.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+constexpr char kMapAndBatchDataset[] = "MapAndBatchDataset";
+constexpr char kBatchDatasetV2[] = "BatchDatasetV2";
+constexpr char kParallelMapDatasetV2[] = "ParallelMapDatasetV2";
+constexpr char kMapDefun[] = "MapDefun";
+
+bool IsUnaryElementwiseOp(const string& op) {
+  static const auto* const kOps = new absl::flat_hash_set<string>(
+      {"Abs", "Cast", "Ceil", "Cos", "Exp", "Floor", "Identity", "IsFinite",
+       "IsNan", "Log", "Log1p", "LogicalNot", "Neg", "Reciprocal", "Round",
+       "Rsqrt", "Sigmoid", "Sign", "Sin", "Sqrt", "Square", "Tanh"});
+  return kOps->contains(op);
+}
+
+bool IsBinaryElementwiseOp(const string& op) {
+  static const auto* const kOps = new absl::flat_hash_set<string>(
+      {"Add", "AddV2", "Div", "Equal", "FloorDiv", "FloorMod", "Greater",
+       "GreaterEqual", "Less", "LessEqual", "LogicalAnd", "LogicalOr",
+       "Maximum", "Minimum", "Mul", "NotEqual", "Pow", "RealDiv",
+       "SquaredDifference", "Sub"});
+  return kOps->contains(op);
+}
+
+// A tensor of the map function, when the function is applied to a batch.
+// Tensors that are derived from the function inputs have a leading batch
+// dimension, followed by `element_shape`; other tensors are scalars.
+struct VectorizedTensor {
+  bool batched;
+  PartialTensorShape element_shape;
+};
+
+// Returns the vectorized output of `node` for the given vectorized inputs, or
+// `std::nullopt` if applying `node` to a batch is not equivalent to applying
+// it to each element and batching the results.
+std::optional<VectorizedTensor> VectorizeNode(
+    const NodeDef& node, const std::vector<const VectorizedTensor*>& inputs) {
+  if (IsConstant(node)) {
+    const TensorShapeProto& shape =
+        node.attr().at("value").tensor().tensor_shape();
+    if (shape.unknown_rank() || shape.dim_size() != 0) return std::nullopt;
+    return VectorizedTensor{false, PartialTensorShape({})};
+  }
+  if (IsUnaryElementwiseOp(node.op()) && inputs.size() == 1) {
+    return *inputs[0];
+  }
+  if (IsBinaryElementwiseOp(node.op()) && inputs.size() == 2) {
+    const VectorizedTensor& x = *inputs[0];
+    const VectorizedTensor& y = *inputs[1];
+    if (x.batched && y.batched) {
+      // Broadcasting between elements of different shapes does not carry over
+      // to batches, e.g. [2] and [] broadcast but [B, 2] and [B] do not.
+      if (!x.element_shape.IsIdenticalTo(y.element_shape)) return std::nullopt;
+      return x;
+    }
+    return x.batched ? x : y;
+  }
+  return std::nullopt;
+}
+
+// Returns whether `function` can be applied to a batch of elements with the
+// given (fully defined) shapes directly, i.e. whether it only consists of
+// elementwise ops whose operands are the inputs or scalar constants.
+bool IsVectorizableAsIs(const FunctionDef& function,
+                        const std::vector<PartialTensorShape>& input_shapes) {
+  if (function.signature().input_arg_size() != input_shapes.size()) {
+    return false;
+  }
+  absl::flat_hash_map<string, VectorizedTensor> tensors;
+  for (int i = 0; i < input_shapes.size(); ++i) {
+    tensors[function.signature().input_arg(i).name()] = {true,
+                                                         input_shapes[i]};
+  }
+  // The nodes of a function are not necessarily topologically sorted, so visit
+  // them until every node has been vectorized.
+  std::vector<const NodeDef*> pending;
+  for (const NodeDef& node : function.node_def()) pending.push_back(&node);
+  while (!pending.empty()) {
+    std::vector<const NodeDef*> blocked;
+    for (const NodeDef* node : pending) {
+      std::vector<const VectorizedTensor*> inputs;
+      bool ready = true;
+      for (const string& input : node->input()) {
+        if (IsControlInput(input)) continue;
+        auto it = tensors.find(input.substr(0, input.find(':')));
+        if (it == tensors.end()) {
+          ready = false;
+          break;
+        }
+        inputs.push_back(&it->second);
+      }
+      if (!ready) {
+        blocked.push_back(node);
+        continue;
+      }
+      std::optional<VectorizedTensor> output = VectorizeNode(*node, inputs);
+      if (!output.has_value()) return false;
+      tensors[node->name()] = *std::move(output);
+    }
+    if (blocked.size() == pending.size()) return false;
+    pending = std::move(blocked);
+  }
+  for (const auto& ret : function.ret()) {
+    auto it = tensors.find(ret.second.substr(0, ret.second.find(':')));
+    if (it == tensors.end() || !it->second.batched) return false;
+  }
+  return true;
+}
+
+// Returns the shape of the elements of a batch of the given shape.
+PartialTensorShape ElementShape(const TensorShapeProto& batched_shape) {
+  PartialTensorShape shape(batched_shape);
+  if (shape.unknown_rank() || shape.dims() == 0) return PartialTensorShape();
+  PartialTensorShape element_shape({});
+  for (int i = 1; i < shape.dims(); ++i) {
+    element_shape = element_shape.Concatenate(shape.dim_size(i));
+  }
+  return element_shape;
+}
+
+// Adds a function to `library` that applies the map function of
+// `map_and_batch_node` to a batch with `MapDefun`.
+const FunctionDef* AddMapDefunFunction(const NodeDef& map_and_batch_node,
+                                       const DataTypeVector& input_types,
+                                       FunctionDefLibrary* library) {
+  FunctionDef* function = library->add_function();
+  graph_utils::SetUniqueGraphFunctionName(
+      absl::StrCat("vectorized_",
+                   map_and_batch_node.attr().at("f").func().name()),
+      library, function);
+
+  std::vector<string> inputs;
+  for (int i = 0; i < input_types.size(); ++i) {
+    inputs.push_back(absl::StrCat("args_", i));
+    function_utils::AddFunctionInput(inputs.back(), function, input_types[i]);
+  }
+  const AttrValue& captured_types = map_and_batch_node.attr().at("Targuments");
+  for (int i = 0; i < captured_types.list().type_size(); ++i) {
+    inputs.push_back(absl::StrCat("captured_args_", i));
+    function_utils::AddFunctionInput(inputs.back(), function,
+                                     captured_types.list().type(i));
+  }
+
+  AttrValue argument_types;
+  for (DataType type : input_types) {
+    argument_types.mutable_list()->add_type(type);
+  }
+  AttrValue output_shapes;
+  for (const TensorShapeProto& shape :
+       map_and_batch_node.attr().at("output_shapes").list().shape()) {
+    ElementShape(shape).AsProto(output_shapes.mutable_list()->add_shape());
+  }
+  const AttrValue& output_types = map_and_batch_node.attr().at("output_types");
+  NodeDef* map_defun = function_utils::AddNode(
+      /*name=*/"", kMapDefun, inputs,
+      {{"Targuments", argument_types},
+       {"Tcaptured", captured_types},
+       {"output_types", output_types},
+       {"output_shapes", output_shapes},
+       {"f", map_and_batch_node.attr().at("f")}},
+      function);
+
+  for (int i = 0; i < output_types.list().type_size(); ++i) {
+    OpDef_ArgDef* output = function->mutable_signature()->add_output_arg();
+    output->set_name(absl::StrCat("output_", i));
+    output->set_type(output_types.list().type(i));
+    (*function->mutable_ret())[output->name()] =
+        absl::StrCat(map_defun->name(), ":output:", i);
+  }
+  return function;
+}
+
+NodeDef MakeBatchNode(const NodeDef& map_and_batch_node,
+                      const NodeDef& input_node, MutableGraphView* graph) {
+  const int num_other_args =
+      map_and_batch_node.attr().at("Targuments").list().type_size();
+  NodeDef batch_node;
+  batch_node.set_op(kBatchDatasetV2);
+  graph_utils::SetUniqueGraphNodeName(kBatchDatasetV2, graph->graph(),
+                                      &batch_node);
+  batch_node.add_input(map_and_batch_node.input(0));
+  batch_node.add_input(map_and_batch_node.input(1 + num_other_args));
+  batch_node.add_input(map_and_batch_node.input(3 + num_other_args));
+
+  AttrValue output_shapes;
+  for (const TensorShapeProto& shape :
+       input_node.attr().at("output_shapes").list().shape()) {
+    PartialTensorShape batched_shape({-1});
+    batched_shape.Concatenate(PartialTensorShape(shape))
+        .AsProto(output_shapes.mutable_list()->add_shape());
+  }
+  (*batch_node.mutable_attr())["output_shapes"] = output_shapes;
+  graph_utils::CopyAttribute("output_types", input_node, &batch_node);
+  AddNodeAttr("parallel_copy", false, &batch_node);
+  return batch_node;
+}
+
+NodeDef MakeParallelMapNode(const NodeDef& map_and_batch_node,
+                            const NodeDef& batch_node,
+                            const string& function_name,
+                            MutableGraphView* graph) {
+  const int num_other_args =
+      map_and_batch_node.attr().at("Targuments").list().type_size();
+  NodeDef map_node;
+  map_node.set_op(kParallelMapDatasetV2);
+  graph_utils::SetUniqueGraphNodeName(kParallelMapDatasetV2, graph->graph(),
+                                      &map_node);
+  map_node.add_input(batch_node.name());
+  for (int i = 0; i < num_other_args; ++i) {
+    map_node.add_input(map_and_batch_node.input(i + 1));
+  }
+  map_node.add_input(map_and_batch_node.input(2 + num_other_args));
+
+  AttrValue f = map_and_batch_node.attr().at("f");
+  f.mutable_func()->set_name(function_name);
+  (*map_node.mutable_attr())["f"] = f;
+  graph_utils::CopyAttribute("Targuments", map_and_batch_node, &map_node);
+  graph_utils::CopyShapesAndTypesAttrs(map_and_batch_node, &map_node);
+  AddNodeAttr("deterministic", "default", &map_node);
+  for (auto key : {"preserve_cardinality", "metadata"}) {
+    if (gtl::FindOrNull(map_and_batch_node.attr(), key)) {
+      graph_utils::CopyAttribute(key, map_and_batch_node, &map_node);
+    }
+  }
+  return map_node;
+}
+
+}  // namespace
+
+Status MapVectorization::OptimizeAndCollectStats(Cluster* cluster,
+                                                 const GrapplerItem& item,
+                                                 GraphDef* output,
+                                                 OptimizationStats* stats) {
+  *output = item.graph;
+  MutableGraphView graph(output);
+  absl::flat_hash_set<string> nodes_to_delete;
+  FunctionLibraryDefinition function_library(OpRegistry::Global(),
+                                             item.graph.library());
+
+  for (const NodeDef& node : item.graph.node()) {
+    if (node.op() != kMapAndBatchDataset) continue;
+    const NodeDef& map_and_batch_node = node;
+    const NodeDef* input_node =
+        graph_utils::GetInputNode(map_and_batch_node, graph);
+    DataTypeVector input_types;
+    if (input_node == nullptr ||
+        !gtl::FindOrNull(input_node->attr(), "output_shapes") ||
+        !graph_utils::GetDatasetOutputTypesAttr(*input_node, &input_types)
+             .ok()) {
+      continue;
+    }
+    std::vector<PartialTensorShape> input_shapes;
+    for (const TensorShapeProto& shape :
+         input_node->attr().at("output_shapes").list().shape()) {
+      input_shapes.emplace_back(shape);
+    }
+    if (input_shapes.size() != input_types.size() ||
+        !absl::c_all_of(input_shapes, [](const PartialTensorShape& shape) {
+          return shape.IsFullyDefined();
+        })) {
+      VLOG(2) << "Not vectorizing " << map_and_batch_node.name()
+              << " because its input element shapes are not fully defined.";
+      continue;
+    }
+
+    const FunctionDef* function =
+        function_library.Find(map_and_batch_node.attr().at("f").func().name());
+    if (function == nullptr ||
+        function_utils::IsFunctionStateful(function_library, *function,
+                                           /*skip_assert=*/true)) {
+      continue;
+    }
+    string function_name = function->signature().name();
+    const bool has_captured_inputs =
+        map_and_batch_node.attr().at("Targuments").list().type_size() > 0;
+    if (has_captured_inputs || !IsVectorizableAsIs(*function, input_shapes)) {
+      const FunctionDef* vectorized_function = AddMapDefunFunction(
+          map_and_batch_node, input_types, output->mutable_library());
+      TF_RETURN_IF_ERROR(function_library.AddFunctionDef(*vectorized_function));
+      function_name = vectorized_function->signature().name();
+    }
+
+    NodeDef* batch_node = graph.AddNode(
+        MakeBatchNode(map_and_batch_node, *input_node, &graph));
+    NodeDef* map_node = graph.AddNode(MakeParallelMapNode(
+        map_and_batch_node, *batch_node, function_name, &graph));
+    TF_RETURN_IF_ERROR(
+        graph.UpdateFanouts(map_and_batch_node.name(), map_node->name()));
+    nodes_to_delete.insert(map_and_batch_node.name());
+    stats->num_changes++;
+  }
+
+  TF_RETURN_IF_ERROR(graph.DeleteNodes(nodes_to_delete));
+  return OkStatus();
+}
+
+REGISTER_GRAPH_OPTIMIZER_AS(MapVectorization, "map_vectorization");
+
+}  // namespace grappler
+}  // namespace tensorflow
@@ -0,0 +1,145 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/data/map_vectorization.h"
+
+#include "tensorflow/core/framework/attr_value_util.h"
+#include "tensorflow/core/framework/function_testlib.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/grappler/optimizers/data/graph_test_utils.h"
+#include "tensorflow/core/grappler/optimizers/data/graph_utils.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+using test::function::NDef;
+
+// Returns a `range -> map_and_batch -> Sink` pipeline, whose range elements
+// have the shape `element_shape`.
+GrapplerItem MakeMapAndBatchItem(const string& function_name,
+                                 const PartialTensorShape& element_shape) {
+  GrapplerItem item;
+  item.graph = test::function::GDef(
+      {NDef("start", "Const", {}, {{"value", 0}, {"dtype", DT_INT64}}),
+       NDef("stop", "Const", {}, {{"value", 10}, {"dtype", DT_INT64}}),
+       NDef("step", "Const", {}, {{"value", 1}, {"dtype", DT_INT64}}),
+       NDef("range", "RangeDataset", {"start", "stop", "step"},
+            {{"output_shapes", gtl::ArraySlice<PartialTensorShape>{
+                                   element_shape}},
+             {"output_types", gtl::ArraySlice<DataType>{DT_INT64}}}),
+       NDef("batch_size", "Const", {}, {{"value", 4}, {"dtype", DT_INT64}}),
+       NDef("num_parallel_calls", "Const", {},
+            {{"value", 2}, {"dtype", DT_INT64}}),
+       NDef("drop_remainder", "Const", {},
+            {{"value", true}, {"dtype", DT_BOOL}}),
+       NDef("map_and_batch", "MapAndBatchDataset",
+            {"range", "batch_size", "num_parallel_calls", "drop_remainder"},
+            {{"f", FunctionDefHelper::FunctionRef(function_name,
+                                                  {{"T", DT_INT64}})},
+             {"Targuments", gtl::ArraySlice<DataType>{}},
+             {"output_shapes",
+              gtl::ArraySlice<PartialTensorShape>{PartialTensorShape({4})}},
+             {"output_types", gtl::ArraySlice<DataType>{DT_INT64}}}),
+       NDef("Sink", "Identity", {"map_and_batch"}, {})},
+      // FunctionLib
+      {
+          test::function::XTimesTwo(),
+          test::function::XTimesFour(),
+          test::function::RandomUniform(),
+      });
+  item.fetch.push_back("Sink");
+  return item;
+}
+
+TEST(MapVectorizationTest, ElementwiseFunction) {
+  GrapplerItem item = MakeMapAndBatchItem("XTimesTwo", PartialTensorShape({}));
+  MapVectorization optimizer;
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  EXPECT_FALSE(graph_utils::ContainsNodeWithOp("MapAndBatchDataset", output));
+  ASSERT_TRUE(graph_utils::ContainsNodeWithOp("BatchDatasetV2", output));
+  ASSERT_TRUE(graph_utils::ContainsNodeWithOp("ParallelMapDatasetV2", output));
+  const NodeDef& batch_node = output.node(
+      graph_utils::FindGraphNodeWithOp("BatchDatasetV2", output));
+  const NodeDef& map_node = output.node(
+      graph_utils::FindGraphNodeWithOp("ParallelMapDatasetV2", output));
+  EXPECT_EQ(batch_node.input(0), "range");
+  EXPECT_EQ(batch_node.input(1), "batch_size");
+  EXPECT_EQ(batch_node.input(2), "drop_remainder");
+  EXPECT_EQ(map_node.input(0), batch_node.name());
+  EXPECT_EQ(map_node.input(1), "num_parallel_calls");
+  // The elementwise function is applied to the batch as is.
+  EXPECT_EQ(map_node.attr().at("f").func().name(), "XTimesTwo");
+  EXPECT_EQ(output.library().function_size(),
+            item.graph.library().function_size());
+
+  const NodeDef& sink_node =
+      output.node(graph_utils::FindGraphNodeWithName("Sink", output));
+  EXPECT_EQ(sink_node.input(0), map_node.name());
+}
+
+TEST(MapVectorizationTest, NonElementwiseFunction) {
+  GrapplerItem item = MakeMapAndBatchItem("XTimesFour", PartialTensorShape({}));
+  MapVectorization optimizer;
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  EXPECT_FALSE(graph_utils::ContainsNodeWithOp("MapAndBatchDataset", output));
+  ASSERT_TRUE(graph_utils::ContainsNodeWithOp("ParallelMapDatasetV2", output));
+  const NodeDef& map_node = output.node(
+      graph_utils::FindGraphNodeWithOp("ParallelMapDatasetV2", output));
+  // `XTimesFour` calls another function, so it is wrapped in a `MapDefun`.
+  const string& function_name = map_node.attr().at("f").func().name();
+  int index = graph_utils::FindGraphFunctionWithName(function_name,
+                                                     output.library());
+  ASSERT_GE(index, 0);
+  const FunctionDef& function = output.library().function(index);
+  ASSERT_EQ(function.node_def_size(), 1);
+  const NodeDef& map_defun = function.node_def(0);
+  EXPECT_EQ(map_defun.op(), "MapDefun");
+  EXPECT_EQ(map_defun.attr().at("f").func().name(), "XTimesFour");
+  ASSERT_EQ(map_defun.attr().at("output_shapes").list().shape_size(), 1);
+  EXPECT_EQ(map_defun.attr().at("output_shapes").list().shape(0).dim_size(),
+            0);
+}
+
+TEST(MapVectorizationTest, StatefulFunction) {
+  GrapplerItem item =
+      MakeMapAndBatchItem("RandomUniformFn", PartialTensorShape({}));
+  MapVectorization optimizer;
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+  EXPECT_TRUE(graph_utils::ContainsGraphNodeWithName("map_and_batch", output));
+  EXPECT_FALSE(graph_utils::ContainsNodeWithOp("BatchDatasetV2", output));
+}
+
+TEST(MapVectorizationTest, PartiallyDefinedInputShape) {
+  GrapplerItem item =
+      MakeMapAndBatchItem("XTimesTwo", PartialTensorShape({-1}));
+  MapVectorization optimizer;
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+  EXPECT_TRUE(graph_utils::ContainsGraphNodeWithName("map_and_batch", output));
+  EXPECT_FALSE(graph_utils::ContainsNodeWithOp("BatchDatasetV2", output));
+}
+
+}  // namespace
+}  // namespace grappler
+}  // namespace tensorflow
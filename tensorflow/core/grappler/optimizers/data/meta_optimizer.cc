@@ -36,7 +36,7 @@ using ConfigMap =
     std::map<string, tensorflow::RewriterConfig_CustomGraphOptimizer>;
 
 // tf.data optimizations, in the order we want to perform them.
-constexpr std::array<const char*, 19> kTFDataOptimizations = {
+constexpr std::array<const char*, 20> kTFDataOptimizations = {
     "noop_elimination",
     "disable_intra_op_parallelism",
     "use_private_thread_pool",
@@ -46,6 +46,7 @@ constexpr std::array<const char*, 19> kTFDataOptimizations = {
     "map_and_filter_fusion",
     "map_parallelization",
     "map_and_batch_fusion",
+    "map_vectorization",
     "batch_parallelization",
     "filter_parallelization",
     "make_sloppy",
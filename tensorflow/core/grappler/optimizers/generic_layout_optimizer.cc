@@ -16,8 +16,11 @@ limitations under the License.
 #include "tensorflow/core/grappler/optimizers/generic_layout_optimizer.h"
 
 #include <utility>
+#include <vector>
 
+#include "absl/algorithm/container.h"
 #include "absl/memory/memory.h"
+#include "absl/strings/match.h"
 #include "absl/strings/string_view.h"
 #include "tensorflow/core/framework/attr_value.pb.h"
 #include "tensorflow/core/framework/node_def_util.h"
@@ -50,6 +53,18 @@ struct MutableNodeViewFormatter {
   }
 };
 
+#if TENSORFLOW_USE_ROCM
+// MIOpen's NHWC convolution kernels vectorize along the channel dimensions and
+// fall back to much slower generic kernels when the number of input or output
+// channels is not a multiple of this.
+constexpr int kMIOpenNhwcChannelAlignment = 8;
+
+// Returns the gfx arch of an AMD GPU, e.g. "gfx90a" for "gfx90a:sramecc+".
+absl::string_view GetGfxArch(absl::string_view architecture) {
+  return architecture.substr(0, architecture.find(':'));
+}
+#endif
+
 struct GpuStats {
   int num_gpus;
   int num_voltas;
@@ -66,16 +81,21 @@ inline GpuStats GetNumGPUs(const Cluster& cluster) {
     gpu_stats.num_gpus++;
     auto compute_capability_it =
         device.second.environment().find("architecture");
-#if TENSORFLOW_USE_ROCM
-    bool is_enabled = se::gpu::UseNhwcLayoutForRocm();
-    if ((compute_capability_it->second == "gfx908" ||
-         compute_capability_it->second == "gfx90a") && is_enabled) {
-       gpu_stats.num_voltas++;
-    }
-#endif
     if (compute_capability_it == device.second.environment().end()) {
       continue;
     }
+#if TENSORFLOW_USE_ROCM
+    // MIOpen has fast NHWC kernels for the matrix cores of MI100 and newer,
+    // which process bfloat16 at the float16 rate from MI200 on. These are only
+    // used by the convolution kernels if NHWC is enabled for ROCm.
+    if (se::gpu::UseNhwcLayoutForRocm()) {
+      const absl::string_view arch = GetGfxArch(compute_capability_it->second);
+      const bool is_mi200_or_newer =
+          arch == "gfx90a" || absl::StartsWith(arch, "gfx94");
+      if (arch == "gfx908" || is_mi200_or_newer) gpu_stats.num_voltas++;
+      if (is_mi200_or_newer) gpu_stats.num_amperes++;
+    }
+#endif
 #if GOOGLE_CUDA
     double compute_capability = 0.0;
     if (absl::SimpleAtod(compute_capability_it->second, &compute_capability)) {
@@ -119,6 +139,55 @@ inline bool ConvBackpropExists(const TransposeContext& context,
   return false;
 }
 
+#if TENSORFLOW_USE_ROCM
+// Returns true if the input and output channels of `node`, a convolution, are
+// suitable for MIOpen's NHWC kernels. Unknown channels are assumed suitable.
+bool HasMIOpenNhwcChannels(const TransposeContext& context,
+                           const utils::MutableNodeView& node) {
+  const auto& input_properties =
+      context.graph_properties->GetInputProperties(node.GetName());
+  if (input_properties.size() < 2) return true;
+  const TensorShapeProto& filter_shape = input_properties[1].shape();
+  const int rank = filter_shape.dim_size();
+  if (filter_shape.unknown_rank() || rank < 2) return true;
+  for (int i = rank - 2; i < rank; ++i) {
+    const int64_t channels = filter_shape.dim(i).size();
+    if (channels > 0 && channels % kMIOpenNhwcChannelAlignment != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns the number of multiply-adds performed by `node`, a convolution, or
+// -1 if its shapes are not fully known.
+double GetConvCost(const TransposeContext& context,
+                   const utils::MutableNodeView& node) {
+  const auto& input_properties =
+      context.graph_properties->GetInputProperties(node.GetName());
+  const auto& output_properties =
+      context.graph_properties->GetOutputProperties(node.GetName());
+  if (input_properties.size() < 2 || output_properties.empty()) return -1;
+  const TensorShapeProto& filter_shape = input_properties[1].shape();
+  const TensorShapeProto& output_shape = output_properties[0].shape();
+  if (filter_shape.unknown_rank() || output_shape.unknown_rank() ||
+      filter_shape.dim_size() < 1) {
+    return -1;
+  }
+  // Each output element takes all filter elements of one output channel.
+  double cost = 1;
+  for (const auto& dim : output_shape.dim()) {
+    if (dim.size() < 0) return -1;
+    cost *= dim.size();
+  }
+  for (int i = 0; i < filter_shape.dim_size() - 1; ++i) {
+    if (filter_shape.dim(i).size() < 0) return -1;
+    cost *= filter_shape.dim(i).size();
+  }
+  return cost;
+}
+#endif
+
 inline std::pair<string, string> GetSrcAndDstDataFormats(
     const TransposeContext& context, GpuStats gpu_stats) {
   string src_format = kNHWC;
@@ -138,9 +207,16 @@ inline std::pair<string, string> GetSrcAndDstDataFormats(
   //   (2): TF32-dtype with TensorCores enabled and tuning for Ampere+ GPUs
   //        (but only if no backward conv in fp32 exists)
   //   (3): blfoat16-dtype and tuning for Ampere+ GPUs
-  int num_conv_gpu = 0;
-  int num_conv_gpu_prefer_swap = 0;
+  // On ROCm, the Volta and Ampere counts refer to GPUs with fast float16 and
+  // bfloat16 NHWC kernels in MIOpen, which also require aligned channels and
+  // have no TF32 mode. Since the benefit of NHWC grows with the size of the
+  // convolution, each convolution is weighted by its cost there, so that the
+  // layout of the whole graph is chosen for the convolutions that dominate
+  // its run time rather than for the most common ones.
+  std::vector<std::pair<double, bool>> conv_gpu_costs;
+#if !TENSORFLOW_USE_ROCM
   bool fp32_backprop = ConvBackpropExists(context, kGPU, DT_FLOAT);
+#endif
 
   for (const auto& node : context.graph_view->GetNodes()) {
     const auto* node_def = node.node();
@@ -155,25 +231,45 @@ inline std::pair<string, string> GetSrcAndDstDataFormats(
                            absl::AsciiStrToLower(kGPU))) {
       continue;
     }
-    num_conv_gpu++;
+#if TENSORFLOW_USE_ROCM
+    const double cost = GetConvCost(context, node);
+#else
+    const double cost = 1;
+#endif
     const auto* t_attr = node.GetAttr("T");
     if (t_attr == nullptr) {
+      conv_gpu_costs.emplace_back(cost, false);
       continue;
     }
     const DataType dtype = t_attr->type();
-    if ((volta_ready && dtype == DT_HALF) ||
+#if TENSORFLOW_USE_ROCM
+    const bool prefer_swap = ((volta_ready && dtype == DT_HALF) ||
+                              (ampere_ready && dtype == DT_BFLOAT16)) &&
+                             HasMIOpenNhwcChannels(context, node);
+#else
+    const bool prefer_swap =
+        (volta_ready && dtype == DT_HALF) ||
         (ampere_ready && dtype == DT_BFLOAT16) ||
         (ampere_ready && dtype == DT_FLOAT &&
-         tsl::tensor_float_32_execution_enabled() && !fp32_backprop)) {
-      num_conv_gpu_prefer_swap++;
-    }
+         tsl::tensor_float_32_execution_enabled() && !fp32_backprop);
+#endif
+    conv_gpu_costs.emplace_back(cost, prefer_swap);
   }
 
-  // Check ratio of ops preferring swap.
+  // Check ratio of ops preferring swap. If the cost of any convolution is
+  // unknown, all of them are weighted equally.
+  const bool has_unknown_cost = absl::c_any_of(
+      conv_gpu_costs, [](const auto& cost) { return cost.first < 0; });
+  double conv_gpu_cost = 0;
+  double conv_gpu_prefer_swap_cost = 0;
+  for (const auto& [cost, prefer_swap] : conv_gpu_costs) {
+    const double weight = has_unknown_cost ? 1 : cost;
+    conv_gpu_cost += weight;
+    if (prefer_swap) conv_gpu_prefer_swap_cost += weight;
+  }
   const bool should_swap =
-      num_conv_gpu > 0 &&
-      (static_cast<float>(num_conv_gpu_prefer_swap) /
-       static_cast<float>(num_conv_gpu)) >= kConvGPUExpectedDtypeThreshold;
+      conv_gpu_cost > 0 && conv_gpu_prefer_swap_cost / conv_gpu_cost >=
+                               kConvGPUExpectedDtypeThreshold;
 
   // We swap only if NHWC is enforced or no layout is enforced and the devices
   // config meet the thresholds
@@ -41,8 +41,10 @@ limitations under the License.
 #include "tensorflow/core/grappler/utils/traversal.h"
 #include "tensorflow/core/lib/math/math_util.h"
 #include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/protobuf/rewriter_config.pb.h"
 #include "tensorflow/core/util/device_name_utils.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 namespace grappler {
@@ -802,6 +804,61 @@ struct SwapInfo {
   Costs::NanoSeconds time_to_swap = 0;
 };
 
+// Returns the time it takes to copy `bytes` between the host and a GPU.
+static Costs::NanoSeconds TimeToSwap(int64_t bytes) {
+  // Let's assume we're going to swap over PCIe running at 16 GBps.
+  return Costs::NanoSeconds(bytes / 16);
+}
+
+// Returns the completion time of each node in the timeline.
+static std::unordered_map<string, Costs::NanoSeconds> CompletionTimes(
+    const StepStats& timeline) {
+  std::unordered_map<string, Costs::NanoSeconds> completion_times;
+  for (const auto& dev_stats : timeline.dev_stats()) {
+    for (const auto& node_stats : dev_stats.node_stats()) {
+      Costs::NanoSeconds exec_time =
+          Costs::NanoSeconds(1) +
+          Costs::MicroSeconds(node_stats.all_start_micros() +
+                              node_stats.op_end_rel_micros());
+      completion_times.emplace(node_stats.node_name(), exec_time);
+    }
+  }
+  return completion_times;
+}
+
+// Same as EstimateEarliestExecutionTimes(), but uses the times measured in a
+// previous run of the graph. Nodes that weren't measured, such as the swap
+// nodes added by previous passes, are assumed to complete right after their
+// last fanin.
+static Status MeasuredExecutionTimes(
+    const GrapplerItem& item, const StepStats& profile,
+    std::unordered_map<const NodeDef*, Costs::NanoSeconds>* execution_times) {
+  const std::unordered_map<string, Costs::NanoSeconds> completion_times =
+      CompletionTimes(profile);
+  std::vector<const NodeDef*> topo_order;
+  TF_RETURN_IF_ERROR(ComputeTopologicalOrder(item.graph, &topo_order));
+
+  std::unordered_map<string, Costs::NanoSeconds> times_by_name;
+  for (const NodeDef* node : topo_order) {
+    Costs::NanoSeconds time(0);
+    auto it = completion_times.find(node->name());
+    if (it != completion_times.end()) {
+      time = it->second;
+    } else {
+      for (const string& input : node->input()) {
+        auto fanin = times_by_name.find(NodeName(input));
+        if (fanin != times_by_name.end()) {
+          time = std::max(time, fanin->second);
+        }
+      }
+      time += Costs::NanoSeconds(1);
+    }
+    times_by_name[node->name()] = time;
+    (*execution_times)[node] = time;
+  }
+  return OkStatus();
+}
+
 static const NodeDef* FindSwapInTrigger(
     const NodeDef* node, const SwapInfo& swap_info,
     const std::unordered_map<string, const NodeDef*>& name_map,
@@ -978,11 +1035,17 @@ struct MemInfo {
 };
 
 static bool IdentifySwappingCandidates(
-    Cluster* cluster, GrapplerItem* item,
+    Cluster* cluster, GrapplerItem* item, const StepStats* profile,
     std::unique_ptr<GraphMemory>* memory_ptr,
     std::unordered_set<string>* skip_list,
     std::unordered_map<NodeDef*, SwapInfo>* nodes_to_swap) {
-  if ((*memory_ptr) == nullptr) {
+  // The memory usage inferred from a profile is only valid for the graph the
+  // profile was collected on, so don't share it with the other passes.
+  std::unique_ptr<GraphMemory> measured_memory;
+  if (profile != nullptr) {
+    measured_memory.reset(new GraphMemory(*item));
+    measured_memory->InferFromTrace(*profile);
+  } else if ((*memory_ptr) == nullptr) {
     memory_ptr->reset(new GraphMemory(*item));
     Status s = (*memory_ptr)->InferStatically(cluster->GetDevices());
     if (!s.ok()) {
@@ -991,7 +1054,8 @@ static bool IdentifySwappingCandidates(
       return false;
     }
   }
-  const GraphMemory& memory = **memory_ptr;
+  const GraphMemory& memory =
+      profile != nullptr ? *measured_memory : **memory_ptr;
 
   bool updated_graph = false;
   for (const auto& device : cluster->GetDevices()) {
@@ -1012,7 +1076,9 @@ static bool IdentifySwappingCandidates(
     int64_t required_savings = mem_usage.used_memory - prop.memory_size();
 
     std::unordered_map<string, Costs::NanoSeconds> op_completion_times;
-    {
+    if (profile != nullptr) {
+      op_completion_times = CompletionTimes(*profile);
+    } else {
       VirtualCluster vcluster(cluster->GetDevices());
       if (!vcluster.Provision().ok()) {
         return false;
@@ -1025,16 +1091,7 @@ static bool IdentifySwappingCandidates(
       if (!s.ok() && s.code() != error::RESOURCE_EXHAUSTED) {
         return false;
       }
-
-      for (const auto& dev_stats : metadata.step_stats().dev_stats()) {
-        for (const auto& node_stats : dev_stats.node_stats()) {
-          Costs::NanoSeconds exec_time =
-              Costs::NanoSeconds(1) +
-              Costs::MicroSeconds(node_stats.all_start_micros() +
-                                  node_stats.op_end_rel_micros());
-          op_completion_times.emplace(node_stats.node_name(), exec_time);
-        }
-      }
+      op_completion_times = CompletionTimes(metadata.step_stats());
     }
 
     Costs::Duration peak_time = -1;
@@ -1103,6 +1160,18 @@ static bool IdentifySwappingCandidates(
         mem_info.uses_left.emplace_back(input);
         earliest_use = std::min(earliest_use, it->second);
       }
+      if (valid && profile != nullptr) {
+        // The tensor must be copied to the host between its allocation and the
+        // peak, and back between the peak and its next use. Only swap it if
+        // the measured compute is long enough to hide both transfers.
+        const Costs::NanoSeconds time_to_swap =
+            TimeToSwap(live_tensor.memory_used);
+        if (peak_time - allocation_time < time_to_swap ||
+            earliest_use - peak_time < time_to_swap) {
+          VLOG(1) << "Transfers can't be hidden: skipping " << live_tensor.node;
+          valid = false;
+        }
+      }
       if (valid && !mem_info.uses_left.empty()) {
         // Compute the fitness: we need the tensor to be generated way away of
         // the time of peak memory usage (to ensure there is enough time to swap
@@ -1147,14 +1216,15 @@ static bool IdentifySwappingCandidates(
 }
 
 bool SwappingPass(RewriterConfig::MemOptType optimization_level,
-                  Cluster* cluster, std::unique_ptr<GraphMemory>* memory,
-                  GrapplerItem* item, std::unordered_set<string>* skip_list) {
+                  Cluster* cluster, const StepStats* profile,
+                  std::unique_ptr<GraphMemory>* memory, GrapplerItem* item,
+                  std::unordered_set<string>* skip_list) {
   std::unordered_map<NodeDef*, SwapInfo> nodes_to_swap;
   if (optimization_level == RewriterConfig::DEFAULT_MEM_OPT ||
       optimization_level == RewriterConfig::SWAPPING_HEURISTICS ||
       optimization_level == RewriterConfig::HEURISTICS) {
     // Use heuristics to figure out what needs to be swapped;
-    IdentifySwappingCandidates(cluster, item, memory, skip_list,
+    IdentifySwappingCandidates(cluster, item, profile, memory, skip_list,
                                &nodes_to_swap);
   }
   // Look for manual annotations in the graph.
@@ -1196,12 +1266,15 @@ bool SwappingPass(RewriterConfig::MemOptType optimization_level,
       const OpInfo::TensorProperties& t = props[input_id];
       bytes_to_swap += CalculateTensorSize(t);
     }
-    // Let's assume we're going to swap over PCIe running at 16 GBps.
-    swap_info.time_to_swap = bytes_to_swap / 16;
+    swap_info.time_to_swap = TimeToSwap(bytes_to_swap);
   }
 
   std::unordered_map<const NodeDef*, Costs::NanoSeconds> execution_times;
-  if (!EstimateEarliestExecutionTimes(*item, cluster, &execution_times).ok()) {
+  Status status =
+      profile != nullptr
+          ? MeasuredExecutionTimes(*item, *profile, &execution_times)
+          : EstimateEarliestExecutionTimes(*item, cluster, &execution_times);
+  if (!status.ok()) {
     return false;
   }
 
@@ -1378,6 +1451,41 @@ Status FindAssignNodesToRelax(const GraphDef& graph,
 
 }  // namespace
 
+// Returns the profile named by TF_GRAPPLER_MEMORY_OPTIMIZER_PROFILE, if any.
+static const StepStats* ProfileFromEnv() {
+  static const StepStats* profile = []() -> const StepStats* {
+    string path;
+    TF_CHECK_OK(ReadStringFromEnvVar("TF_GRAPPLER_MEMORY_OPTIMIZER_PROFILE",
+                                     /*default_val=*/"", &path));
+    if (path.empty()) return nullptr;
+    RunMetadata run_metadata;
+    Status s = ReadBinaryProto(Env::Default(), path, &run_metadata);
+    if (!s.ok()) {
+      s = ReadTextProto(Env::Default(), path, &run_metadata);
+    }
+    if (!s.ok()) {
+      LOG(WARNING) << "Failed to read the memory optimizer profile " << path
+                   << ": " << s;
+      return nullptr;
+    }
+    return new StepStats(run_metadata.step_stats());
+  }();
+  return profile;
+}
+
+// Returns true if most nodes of the graph were measured in the profile, i.e. if
+// the profile was likely collected on this graph.
+static bool ProfileMatchesGraph(const StepStats& profile,
+                                const GraphDef& graph) {
+  const std::unordered_map<string, Costs::NanoSeconds> completion_times =
+      CompletionTimes(profile);
+  int num_measured = 0;
+  for (const NodeDef& node : graph.node()) {
+    num_measured += completion_times.count(node.name());
+  }
+  return num_measured > 0 && 2 * num_measured >= graph.node_size();
+}
+
 Status MemoryOptimizer::Optimize(Cluster* cluster, const GrapplerItem& item,
                                  GraphDef* optimized_graph) {
   std::set<int> nodes_to_relax;
@@ -1406,6 +1514,13 @@ Status MemoryOptimizer::Optimize(Cluster* cluster, const GrapplerItem& item,
   // SchedulingPass() and SwappingPass() rely on defined fetches in order to
   // infer the memory usage, so skip optimization if there are no fetches.
   std::unique_ptr<GraphMemory> memory;
+  const StepStats* profile =
+      profile_.has_value() ? &profile_.value() : ProfileFromEnv();
+  if (profile != nullptr && !ProfileMatchesGraph(*profile, item.graph)) {
+    VLOG(1) << "Ignoring a profile that wasn't collected on this graph";
+    profile = nullptr;
+  }
+  RewriterConfig::MemOptType swapping_level = optimization_level_;
   if (!item.fetch.empty() && cluster != nullptr) {
     bool updated_graph = true;
     for (int i = 0; i < 25 && updated_graph; ++i) {
@@ -1428,12 +1543,17 @@ Status MemoryOptimizer::Optimize(Cluster* cluster, const GrapplerItem& item,
            optimization_level_ == RewriterConfig::HEURISTICS ||
            optimization_level_ == RewriterConfig::MANUAL) &&
           cluster != nullptr) {
-        if (SwappingPass(optimization_level_, cluster, &memory, &optimized_item,
-                         &skip_list)) {
+        if (SwappingPass(swapping_level, cluster, profile, &memory,
+                         &optimized_item, &skip_list)) {
           // Reset the inferred memory usage since the graph changed.
           memory.reset();
           updated_graph = true;
         }
+        if (profile != nullptr) {
+          // The profile describes the memory usage of the original graph, so
+          // it can only be used to pick the tensors to swap once.
+          swapping_level = RewriterConfig::MANUAL;
+        }
       }
     }
   }
@@ -16,10 +16,14 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_MEMORY_OPTIMIZER_H_
 #define TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_MEMORY_OPTIMIZER_H_
 
+#include <optional>
 #include <string>
+
+#include "tensorflow/core/framework/step_stats.pb.h"
 #include "tensorflow/core/grappler/clusters/cluster.h"
 #include "tensorflow/core/grappler/grappler_item.h"
 #include "tensorflow/core/grappler/optimizers/graph_optimizer.h"
+#include "tensorflow/core/protobuf/config.pb.h"
 #include "tensorflow/core/protobuf/rewriter_config.pb.h"
 
 namespace tensorflow {
@@ -42,6 +46,16 @@ class MemoryOptimizer : public GraphOptimizer {
 
   string name() const override { return "memory_optimizer"; };
 
+  // Makes the swapping heuristics use the timeline measured in a previous run
+  // of the graph (collected with RunOptions::FULL_TRACE) instead of a
+  // simulation: tensors are only swapped if the transfers can be hidden behind
+  // the measured compute. The profile can also be read from a RunMetadata
+  // proto file named by the TF_GRAPPLER_MEMORY_OPTIMIZER_PROFILE environment
+  // variable. It is ignored if it was not collected for the optimized graph.
+  void SetProfile(const RunMetadata& run_metadata) {
+    profile_ = run_metadata.step_stats();
+  }
+
   bool UsesFunctionLibrary() const override { return false; }
 
   Status Optimize(Cluster* cluster, const GrapplerItem& item,
@@ -50,6 +64,7 @@ class MemoryOptimizer : public GraphOptimizer {
  private:
   RewriterConfig::MemOptType optimization_level_;
   string recomputation_targets_name_scope_;
+  std::optional<StepStats> profile_;
 };
 
 }  // end namespace grappler
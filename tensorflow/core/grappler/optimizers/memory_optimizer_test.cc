@@ -30,6 +30,7 @@ limitations under the License.
 #include "tensorflow/core/grappler/utils.h"
 #include "tensorflow/core/grappler/utils/grappler_test.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow/core/protobuf/device_properties.pb.h"
 
@@ -346,6 +347,54 @@ TEST_F(MemoryOptimizerTest, SwappingHeuristics) {
 #endif
 }
 
+TEST_F(MemoryOptimizerTest, ProfileGuidedSwapping) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  Output v = ops::Variable(s.WithOpName("v").WithDevice("/gpu:0"),
+                           {128, 128, 8}, DT_FLOAT);
+  Output a = ops::Identity(s.WithOpName("a").WithDevice("/gpu:0"), v);
+  Output b = ops::Square(s.WithOpName("b").WithDevice("/gpu:0"), v);
+  Output c = ops::Sqrt(s.WithOpName("c").WithDevice("/gpu:0"), a);
+  Output d = ops::Identity(s.WithOpName("d").WithDevice("/gpu:0"), b);
+  Output axis = ops::Const(s.WithOpName("axis"), 0);
+  Output e =
+      ops::Concat(s.WithOpName("e").WithDevice("/gpu:0"), {a, b, c, d}, axis);
+  Output f = ops::Square(s.WithOpName("f").WithDevice("/gpu:0"), a);
+  Output g = ops::Sqrt(s.WithOpName("g").WithDevice("/gpu:0"), b);
+  Output h = ops::Exp(s.WithOpName("h").WithDevice("/gpu:0"), c);
+  Output i = ops::Log(s.WithOpName("i").WithDevice("/gpu:0"), d);
+
+  GrapplerItem item;
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+  item.fetch = {"e", "f", "g", "h", "i"};
+
+  // Use a simulated run as the profile, slowed down so that the compute is
+  // long enough to hide the transfers.
+  std::unique_ptr<VirtualCluster> cluster(CreateVirtualCluster());
+  TF_ASSERT_OK(cluster->Initialize(item));
+  RunMetadata metadata;
+  Status status = cluster->Run(item, &metadata);
+  ASSERT_TRUE(status.ok() || errors::IsResourceExhausted(status)) << status;
+  for (auto& dev_stats : *metadata.mutable_step_stats()->mutable_dev_stats()) {
+    for (auto& node_stats : *dev_stats.mutable_node_stats()) {
+      node_stats.set_all_start_micros(1000 * node_stats.all_start_micros());
+      node_stats.set_op_end_rel_micros(1000 * node_stats.op_end_rel_micros());
+    }
+  }
+
+  MemoryOptimizer optimizer(RewriterConfig::SWAPPING_HEURISTICS);
+  optimizer.SetProfile(metadata);
+  GraphDef output;
+  TF_EXPECT_OK(optimizer.Optimize(cluster.get(), item, &output));
+
+  int num_swap_in_nodes = 0;
+  for (const auto& node : output.node()) {
+    if (node.op() == "_CopyFromHostToGpu") {
+      ++num_swap_in_nodes;
+    }
+  }
+  EXPECT_GT(num_swap_in_nodes, 0);
+}
+
 TEST_F(MemoryOptimizerTest, UnswappableInputs) {
   tensorflow::Scope s = tensorflow::Scope::NewRootScope();
   Output v = ops::Variable(s.WithOpName("v").WithDevice("/gpu:0"),
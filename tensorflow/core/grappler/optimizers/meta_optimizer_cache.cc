@@ -0,0 +1,214 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/meta_optimizer_cache.h"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/framework/tensor.pb.h"
+#include "tensorflow/core/lib/strings/proto_serialization.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/fingerprint.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/util/env_var.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+void AppendProto(const protobuf::MessageLite& proto, std::string* data) {
+  std::string serialized;
+  SerializeToStringDeterministic(proto, &serialized);
+  absl::StrAppend(data, serialized.size(), ":", serialized, ";");
+}
+
+void AppendStrings(std::vector<std::string> strings, bool sort,
+                   std::string* data) {
+  if (sort) std::sort(strings.begin(), strings.end());
+  absl::StrAppend(data, strings.size(), ":");
+  for (const std::string& s : strings) {
+    absl::StrAppend(data, s.size(), ":", s, ";");
+  }
+}
+
+}  // namespace
+
+MetaOptimizerCache::MetaOptimizerCache(int64_t capacity_bytes,
+                                       std::string directory)
+    : capacity_bytes_(capacity_bytes), directory_(std::move(directory)) {}
+
+/*static*/ MetaOptimizerCache* MetaOptimizerCache::Global() {
+  static MetaOptimizerCache* cache = []() -> MetaOptimizerCache* {
+    int64_t capacity_mb;
+    TF_CHECK_OK(ReadInt64FromEnvVar("TF_GRAPPLER_CACHE_MB",
+                                    /*default_val=*/256, &capacity_mb));
+    std::string directory;
+    TF_CHECK_OK(ReadStringFromEnvVar("TF_GRAPPLER_CACHE_DIR",
+                                     /*default_val=*/"", &directory));
+    if (capacity_mb <= 0) return nullptr;
+    return new MetaOptimizerCache(capacity_mb << 20, std::move(directory));
+  }();
+  return cache;
+}
+
+/*static*/ std::string MetaOptimizerCache::Key(const GrapplerItem& item,
+                                               const ConfigProto& config,
+                                               const Cluster* cluster) {
+  std::string data;
+  AppendProto(config, &data);
+  AppendProto(item.graph, &data);
+
+  std::vector<std::string> feeds;
+  feeds.reserve(item.feed.size());
+  for (const auto& feed : item.feed) {
+    TensorProto tensor;
+    feed.second.AsProtoTensorContent(&tensor);
+    std::string serialized;
+    SerializeToStringDeterministic(tensor, &serialized);
+    feeds.push_back(absl::StrCat(feed.first, "=", serialized));
+  }
+  AppendStrings(std::move(feeds), /*sort=*/false, &data);
+  AppendStrings(item.fetch, /*sort=*/false, &data);
+  AppendStrings(item.init_ops, /*sort=*/false, &data);
+  AppendStrings(item.keep_ops, /*sort=*/false, &data);
+  AppendStrings({item.save_op, item.restore_op, item.save_restore_loc_tensor},
+                /*sort=*/false, &data);
+  for (const QueueRunnerDef& queue_runner : item.queue_runners) {
+    AppendProto(queue_runner, &data);
+  }
+  AppendStrings(std::vector<std::string>(item.devices().begin(),
+                                         item.devices().end()),
+                /*sort=*/true, &data);
+
+  const GrapplerItem::OptimizationOptions& options =
+      item.optimization_options();
+  absl::StrAppend(&data, int{options.allow_non_differentiable_rewrites},
+                  int{options.allow_pruning_stateful_and_dataset_ops},
+                  int{options.optimize_function_library},
+                  int{options.is_eager_mode}, ";");
+
+  if (cluster != nullptr) {
+    std::vector<std::string> devices;
+    for (const auto& device : cluster->GetDevices()) {
+      std::string properties;
+      SerializeToStringDeterministic(device.second, &properties);
+      devices.push_back(absl::StrCat(device.first, "=", properties));
+    }
+    AppendStrings(std::move(devices), /*sort=*/true, &data);
+  }
+
+  const Fprint128 fingerprint = Fingerprint128(data);
+  return absl::StrCat(absl::Hex(fingerprint.high64, absl::kZeroPad16),
+                      absl::Hex(fingerprint.low64, absl::kZeroPad16));
+}
+
+std::string MetaOptimizerCache::Path(const std::string& key) const {
+  return io::JoinPath(directory_, absl::StrCat(key, ".pb"));
+}
+
+bool MetaOptimizerCache::Lookup(const std::string& key, GraphDef* graph) {
+  {
+    absl::MutexLock lock(&mu_);
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+      lru_.splice(lru_.begin(), lru_, it->second);
+      *graph = it->second->graph;
+      VLOG(2) << "Meta optimizer cache hit: " << key;
+      return true;
+    }
+  }
+  if (directory_.empty()) return false;
+
+  Env* env = Env::Default();
+  const std::string path = Path(key);
+  if (!env->FileExists(path).ok()) return false;
+  if (Status status = ReadBinaryProto(env, path, graph); !status.ok()) {
+    LOG(WARNING) << "Failed to read cached graph " << path << ": " << status;
+    return false;
+  }
+  VLOG(2) << "Meta optimizer cache hit: " << path;
+  absl::MutexLock lock(&mu_);
+  InsertLocked(key, *graph);
+  return true;
+}
+
+void MetaOptimizerCache::Insert(const std::string& key, const GraphDef& graph) {
+  {
+    absl::MutexLock lock(&mu_);
+    InsertLocked(key, graph);
+  }
+  if (directory_.empty()) return;
+
+  Env* env = Env::Default();
+  if (Status status = env->RecursivelyCreateDir(directory_);
+      !status.ok() && !errors::IsAlreadyExists(status)) {
+    LOG(WARNING) << "Failed to create meta optimizer cache directory "
+                 << directory_ << ": " << status;
+    return;
+  }
+  // Write to a unique temporary file first, so that concurrent readers never
+  // see a partially written graph.
+  const std::string path = Path(key);
+  std::string temp_path = path;
+  if (!env->CreateUniqueFileName(&temp_path, ".tmp")) {
+    LOG(WARNING) << "Failed to create a temporary file name for " << path;
+    return;
+  }
+  Status status = WriteBinaryProto(env, temp_path, graph);
+  if (status.ok()) status = env->RenameFile(temp_path, path);
+  if (!status.ok()) {
+    LOG(WARNING) << "Failed to store graph " << path << ": " << status;
+    env->DeleteFile(temp_path).IgnoreError();
+  }
+}
+
+void MetaOptimizerCache::InsertLocked(const std::string& key,
+                                      const GraphDef& graph) {
+  const int64_t size_bytes = graph.ByteSizeLong();
+  if (size_bytes > capacity_bytes_) return;
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    size_bytes_ -= it->second->size_bytes;
+    lru_.erase(it->second);
+    entries_.erase(it);
+  }
+  while (size_bytes_ + size_bytes > capacity_bytes_) {
+    size_bytes_ -= lru_.back().size_bytes;
+    entries_.erase(lru_.back().key);
+    lru_.pop_back();
+  }
+  lru_.push_front(Entry{key, graph, size_bytes});
+  entries_[key] = lru_.begin();
+  size_bytes_ += size_bytes;
+}
+
+int64_t MetaOptimizerCache::size_bytes() const {
+  absl::MutexLock lock(&mu_);
+  return size_bytes_;
+}
+
+int64_t MetaOptimizerCache::num_entries() const {
+  absl::MutexLock lock(&mu_);
+  return entries_.size();
+}
+
+}  // namespace grappler
+}  // namespace tensorflow
@@ -0,0 +1,94 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_META_OPTIMIZER_CACHE_H_
+#define TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_META_OPTIMIZER_CACHE_H_
+
+#include <cstdint>
+#include <list>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorflow/core/framework/graph.pb.h"
+#include "tensorflow/core/grappler/clusters/cluster.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/protobuf/config.pb.h"
+
+namespace tensorflow {
+namespace grappler {
+
+// A cache of the graphs produced by the meta optimizer, so that identical
+// graphs and function bodies are optimized only once. This is common when the
+// same functions are instantiated many times, and when sessions with the same
+// graph are created repeatedly.
+//
+// Entries are keyed on a fingerprint of everything that determines the result
+// of the optimization: the graph and its function library, the other fields of
+// the GrapplerItem, the ConfigProto and the devices of the cluster. The cache
+// holds up to `capacity_bytes` bytes of optimized graphs in memory, evicting
+// the least recently used ones. If `directory` is non-empty, entries are also
+// stored as one file per key in `directory`, so that they outlive the process.
+// Errors reading or writing the directory are logged and otherwise ignored.
+class MetaOptimizerCache {
+ public:
+  MetaOptimizerCache(int64_t capacity_bytes, std::string directory);
+
+  // Returns the process-wide cache configured by the environment variables
+  // TF_GRAPPLER_CACHE_MB (the in-memory capacity in MiB, 256 by default) and
+  // TF_GRAPPLER_CACHE_DIR (the on-disk location, none by default). Returns
+  // nullptr if TF_GRAPPLER_CACHE_MB is 0.
+  static MetaOptimizerCache* Global();
+
+  // Returns the key of the result of optimizing `item` on `cluster` (which
+  // may be null) with `config`.
+  static std::string Key(const GrapplerItem& item, const ConfigProto& config,
+                         const Cluster* cluster);
+
+  // Returns true and sets `*graph` to the cached graph for `key`, if any.
+  bool Lookup(const std::string& key, GraphDef* graph);
+
+  // Stores `graph` as the graph for `key`.
+  void Insert(const std::string& key, const GraphDef& graph);
+
+  int64_t size_bytes() const;
+  int64_t num_entries() const;
+
+ private:
+  struct Entry {
+    std::string key;
+    GraphDef graph;
+    int64_t size_bytes;
+  };
+
+  std::string Path(const std::string& key) const;
+  void InsertLocked(const std::string& key, const GraphDef& graph)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  const int64_t capacity_bytes_;
+  const std::string directory_;
+
+  mutable absl::Mutex mu_;
+  // Entries in order of use, the most recently used first.
+  std::list<Entry> lru_ ABSL_GUARDED_BY(mu_);
+  absl::flat_hash_map<std::string, std::list<Entry>::iterator> entries_
+      ABSL_GUARDED_BY(mu_);
+  int64_t size_bytes_ ABSL_GUARDED_BY(mu_) = 0;
+};
+
+}  // namespace grappler
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_META_OPTIMIZER_CACHE_H_
@@ -0,0 +1,115 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/meta_optimizer_cache.h"
+
+#include <string>
+
+#include "tensorflow/cc/ops/standard_ops.h"
+#include "tensorflow/core/framework/graph.pb.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/protobuf/config.pb.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+GrapplerItem MakeItem(float value) {
+  Scope s = Scope::NewRootScope();
+  Output a = ops::Const(s.WithOpName("a"), value, {4});
+  Output b = ops::Square(s.WithOpName("b"), a);
+  GrapplerItem item;
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+  item.fetch = {"b"};
+  return item;
+}
+
+TEST(MetaOptimizerCacheTest, KeyDependsOnItemAndConfig) {
+  auto key_of = [](const GrapplerItem& item,
+                   const ConfigProto& config = ConfigProto()) {
+    return MetaOptimizerCache::Key(item, config, /*cluster=*/nullptr);
+  };
+  const std::string key = key_of(MakeItem(1.0f));
+  EXPECT_EQ(key, key_of(MakeItem(1.0f)));
+  EXPECT_NE(key, key_of(MakeItem(2.0f)));
+
+  GrapplerItem other_fetch = MakeItem(1.0f);
+  other_fetch.fetch = {"a"};
+  EXPECT_NE(key, key_of(other_fetch));
+
+  GrapplerItem other_options = MakeItem(1.0f);
+  other_options.optimization_options().allow_pruning_stateful_and_dataset_ops =
+      false;
+  EXPECT_NE(key, key_of(other_options));
+
+  ConfigProto other_config;
+  other_config.mutable_graph_options()
+      ->mutable_rewrite_options()
+      ->set_constant_folding(RewriterConfig::OFF);
+  EXPECT_NE(key, key_of(MakeItem(1.0f), other_config));
+}
+
+TEST(MetaOptimizerCacheTest, InsertAndLookup) {
+  MetaOptimizerCache cache(/*capacity_bytes=*/1 << 20, /*directory=*/"");
+  GrapplerItem item = MakeItem(1.0f);
+  GraphDef graph;
+  EXPECT_FALSE(cache.Lookup("key", &graph));
+
+  cache.Insert("key", item.graph);
+  ASSERT_TRUE(cache.Lookup("key", &graph));
+  EXPECT_EQ(graph.DebugString(), item.graph.DebugString());
+  EXPECT_EQ(cache.num_entries(), 1);
+  EXPECT_EQ(cache.size_bytes(), item.graph.ByteSizeLong());
+}
+
+TEST(MetaOptimizerCacheTest, EvictsLeastRecentlyUsed) {
+  GrapplerItem item = MakeItem(1.0f);
+  const int64_t size = item.graph.ByteSizeLong();
+  MetaOptimizerCache cache(/*capacity_bytes=*/2 * size, /*directory=*/"");
+  cache.Insert("a", item.graph);
+  cache.Insert("b", item.graph);
+  GraphDef graph;
+  ASSERT_TRUE(cache.Lookup("a", &graph));
+  cache.Insert("c", item.graph);
+
+  EXPECT_EQ(cache.num_entries(), 2);
+  EXPECT_LE(cache.size_bytes(), 2 * size);
+  EXPECT_TRUE(cache.Lookup("a", &graph));
+  EXPECT_FALSE(cache.Lookup("b", &graph));
+  EXPECT_TRUE(cache.Lookup("c", &graph));
+}
+
+TEST(MetaOptimizerCacheTest, PersistsToDirectory) {
+  const std::string directory =
+      io::JoinPath(testing::TmpDir(), "meta_optimizer_cache_persists");
+  GrapplerItem item = MakeItem(3.0f);
+  {
+    MetaOptimizerCache cache(/*capacity_bytes=*/1 << 20, directory);
+    cache.Insert("key", item.graph);
+  }
+  MetaOptimizerCache cache(/*capacity_bytes=*/1 << 20, directory);
+  GraphDef graph;
+  ASSERT_TRUE(cache.Lookup("key", &graph));
+  EXPECT_EQ(graph.DebugString(), item.graph.DebugString());
+  EXPECT_EQ(cache.num_entries(), 1);
+  EXPECT_FALSE(cache.Lookup("other key", &graph));
+}
+
+}  // namespace
+}  // namespace grappler
+}  // namespace tensorflow
@@ -16,8 +16,10 @@ limitations under the License.
 #include "tensorflow/core/grappler/optimizers/meta_optimizer.h"
 
 #include <atomic>
+#include <vector>
 
 #include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/substitute.h"
 #include "tensorflow/cc/ops/standard_ops.h"
 #include "tensorflow/core/framework/dataset.h"
@@ -703,6 +705,50 @@ TEST_F(MetaOptimizerTest, OptimizeFunctionLibraryWithRestrictions) {
       optimization_options_my_mul_2->allow_non_differentiable_rewrites);
 }
 
+TEST_F(MetaOptimizerTest, OptimizeFunctionLibraryInParallel) {
+  using test::function::NDef;
+
+  ConfigProto config_proto;
+  auto& rewriter_config =
+      *config_proto.mutable_graph_options()->mutable_rewrite_options();
+  rewriter_config.set_min_graph_nodes(-1);
+
+  MetaOptimizer optimizer(nullptr, config_proto);
+
+  // Many independent functions, each called once from the main graph.
+  constexpr int kNumFunctions = 16;
+  std::vector<FunctionDef> funcs;
+  std::vector<NodeDef> nodes = {
+      NDef("x0", "Placeholder", {}, {{"dtype", DT_FLOAT}}, kDevice),
+      NDef("x1", "Placeholder", {}, {{"dtype", DT_FLOAT}}, kDevice)};
+  GrapplerItem item;
+  item.id = "main";
+  for (int i = 0; i < kNumFunctions; ++i) {
+    const string name = absl::StrCat("MyMul", i);
+    funcs.push_back(FunctionDefHelper::Create(
+        name, {"x:float", "y:float"}, {"z:float"}, {},
+        {{{"mul"}, "Mul", {"x", "y"}, {{"T", DT_FLOAT}}}},
+        /*ret_def=*/
+        {{"z", "mul:z:0"}}));
+    nodes.push_back(
+        NDef(absl::StrCat("mul_", i), name, {"x0", "x1"}, {}, kDevice));
+    item.fetch.push_back(absl::StrCat("mul_", i));
+  }
+  item.graph = test::function::GDef(nodes, funcs);
+
+  GraphDef output;
+  TF_EXPECT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  // Every function is optimized and merged back into the library.
+  ASSERT_EQ(output.library().function_size(), kNumFunctions);
+  FunctionLibraryDefinition flib(OpRegistry::Global(), output.library());
+  for (int i = 0; i < kNumFunctions; ++i) {
+    const FunctionDef* func = flib.Find(absl::StrCat("MyMul", i));
+    ASSERT_NE(func, nullptr);
+    EXPECT_EQ(func->node_def_size(), 1);
+  }
+}
+
 class SleepingOptimizer : public CustomGraphOptimizer {
  public:
   SleepingOptimizer() {}
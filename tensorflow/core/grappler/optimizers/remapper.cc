@@ -68,6 +68,12 @@ namespace grappler {
 //
 // Sigmoid + Mul -> _MklSwish  // This fusion only works on Intel CPU.
 //
+// Gather + SparseSegment{Sum,Mean,SqrtN}[WithNumSegments]:
+//   (1) GatherV2 + SparseSegmentReduction -> SparseSegmentReduction reading
+//       the gathered rows directly from the params.
+//   (2) ResourceGather + SparseSegmentReduction ->
+//       _ResourceSparseSegmentReduction.
+//
 //
 // In all cases, the supported activation functions are Relu, Relu6, and Elu.
 //
@@ -86,6 +92,14 @@ constexpr char kFusedDepthwiseConv2dNative[] = "_FusedDepthwiseConv2dNative";
 constexpr char kFusedBatchNormEx[] = "_FusedBatchNormEx";
 constexpr char kFusedBatchNormGradEx[] = "_FusedBatchNormGradEx";
 constexpr char kTensorToHashBucket[] = "_TensorToHashBucketFast";
+constexpr char kFusedElementwise[] = "_FusedElementwise";
+constexpr char kFusedBiasActivationDropout[] = "_FusedBiasActivationDropout";
+constexpr char kFusedBiasActivationDropoutGrad[] =
+    "_FusedBiasActivationDropoutGrad";
+constexpr char kResourceSparseSegmentReduction[] =
+    "_ResourceSparseSegmentReduction";
+constexpr char kResourceApplyAdamMultiTensor[] =
+    "_ResourceApplyAdamMultiTensor";
 constexpr char kLeakyRelu[] = "LeakyRelu";
 constexpr char kMklFusedMish[] = "_MklFusedMish";
 constexpr char kRelu[] = "Relu";
@@ -161,6 +175,41 @@ struct TensorToHashBucket {
   int string_to_hash_bucket = kMissingIndex;
 };
 
+// Gather or ResourceGather followed by a SparseSegment{Sum,Mean,SqrtN}.
+struct GatherWithSparseSegmentReduction {
+  GatherWithSparseSegmentReduction() = default;
+  GatherWithSparseSegmentReduction(int gather, int sparse_segment_reduction)
+      : gather(gather), sparse_segment_reduction(sparse_segment_reduction) {}
+
+  int gather = kMissingIndex;
+  int sparse_segment_reduction = kMissingIndex;
+};
+
+// Chain of elementwise ops of the same shape that can be replaced with a
+// _FusedElementwise.
+struct ElementwiseChain {
+  // The nodes of the chain, from the first to the last op.
+  std::vector<int> nodes;
+  // The input port of the previous op of the chain in each node.
+  std::vector<int> chain_ports;
+};
+
+// The maximum number of ops of a _FusedElementwise.
+constexpr int kMaxElementwiseChainLength = 8;
+
+// Dropout(Activation(BiasAdd)), and optionally the gradients of these ops:
+// BiasAddGrad(ActivationGrad(DropoutGrad)).
+struct BiasActivationDropout {
+  int bias_add = kMissingIndex;
+  int activation = kMissingIndex;
+  int dropout = kMissingIndex;
+  // The Shape of the activation that is the noise shape of the dropout.
+  int noise_shape = kMissingIndex;
+  int dropout_grad = kMissingIndex;
+  int activation_grad = kMissingIndex;
+  int bias_add_grad = kMissingIndex;
+};
+
 // Pad followed by Conv3D/FusedConv3D
 struct PadWithConv3D {
   PadWithConv3D() = default;
@@ -2064,6 +2113,25 @@ bool BatchnormSpatialPersistentEnabled() {
 #endif
 }
 
+// On ROCm the training mode FusedBatchNorm with side input and activation runs
+// the MIOpen BatchNorm(+Relu) fusion plan followed by an elementwise kernel, so
+// unlike cuDNN there are no layout, channel or persistent mode restrictions.
+// The fusion can be disabled with TF_ROCM_FUSED_BATCHNORM_TRAINING=0.
+bool RocmFusedBatchNormTrainingEnabled() {
+#if TENSORFLOW_USE_ROCM
+  static bool is_enabled = [] {
+    bool is_enabled = true;
+    TF_CHECK_OK(tensorflow::ReadBoolFromEnvVar(
+        "TF_ROCM_FUSED_BATCHNORM_TRAINING",
+        /*default_val=*/true, &is_enabled));
+    return is_enabled;
+  }();
+  return is_enabled;
+#else
+  return false;
+#endif
+}
+
 bool FindFusedBatchNormEx(const RemapperContext& ctx, int node_index,
                           FusedBatchNormEx* matched) {
   // Root of the pattern must be a Relu.
@@ -2111,7 +2179,10 @@ bool FindFusedBatchNormEx(const RemapperContext& ctx, int node_index,
     // In training mode we rely on cuDNN for computing FusedBatchNorm with side
     // inputs and activation, and it has its own limitations. In inference mode
     // we have a custom CUDA kernel that doesn't not have these constraints.
-    if (is_training && NodeIsOnGpu(fused_batch_norm_node_def)) {
+    // On ROCm, MIOpen handles both data layouts and the data types checked
+    // above.
+    if (is_training && NodeIsOnGpu(fused_batch_norm_node_def) &&
+        !RocmFusedBatchNormTrainingEnabled()) {
       // cuDNN only supports NHWC data layout.
       if (data_format != "NHWC") return false;
 
@@ -2223,26 +2294,33 @@ bool FindFusedBatchNormGradEx(const RemapperContext& ctx, int node_index,
     if (!GetNodeAttr(*node_def, kIsTraining, &is_training).ok() || !is_training)
       return false;
 
-    // Data type must be DT_HALF.
     DataType t_dtype = GetDataTypeFromAttr(*node_def, "T");
-    if (t_dtype != DT_HALF) return false;
-
-    // We rely on cuDNN for computing FusedBatchNormGrad with side
-    // outputs and activation. cuDNN only supports NHWC data layout.
     string data_format;
     if (!GetNodeAttr(*node_def, kDataFormat, &data_format).ok()) return false;
-    if (data_format != "NHWC") return false;
 
-    // Channel dimension must be a multiple of 4.
-    const auto& props =
-        ctx.graph_properties.GetInputProperties(node_def->name());
-    const bool valid_channel_dim = !props.empty() &&
-                                   props[0].shape().dim_size() == 4 &&
-                                   props[0].shape().dim(3).size() % 4 == 0;
-    if (!valid_channel_dim) return false;
+    if (RocmFusedBatchNormTrainingEnabled()) {
+      // MIOpen supports float and half in both data layouts.
+      if (t_dtype != DT_FLOAT && t_dtype != DT_HALF) return false;
+      if (data_format != "NHWC" && data_format != "NCHW") return false;
+    } else {
+      // Data type must be DT_HALF.
+      if (t_dtype != DT_HALF) return false;
 
-    // cuDNN must support CUDNN_BATCHNORM_SPATIAL_PERSISTENT mode.
-    if (!BatchnormSpatialPersistentEnabled()) return false;
+      // We rely on cuDNN for computing FusedBatchNormGrad with side
+      // outputs and activation. cuDNN only supports NHWC data layout.
+      if (data_format != "NHWC") return false;
+
+      // Channel dimension must be a multiple of 4.
+      const auto& props =
+          ctx.graph_properties.GetInputProperties(node_def->name());
+      const bool valid_channel_dim = !props.empty() &&
+                                     props[0].shape().dim_size() == 4 &&
+                                     props[0].shape().dim(3).size() % 4 == 0;
+      if (!valid_channel_dim) return false;
+
+      // cuDNN must support CUDNN_BATCHNORM_SPATIAL_PERSISTENT mode.
+      if (!BatchnormSpatialPersistentEnabled()) return false;
+    }
 
     // FusedBatchNormV2 and V3 have an extra type parameter.
     if (node_def->op() != "FusedBatchNorm" &&
@@ -2390,6 +2468,284 @@ bool FindTensorToHashBucket(const RemapperContext& ctx, int node_index,
   return true;
 }
 
+bool IsSparseSegmentReduction(const NodeDef& node) {
+  const auto& op = node.op();
+  return op == "SparseSegmentSum" || op == "SparseSegmentMean" ||
+         op == "SparseSegmentSqrtN" ||
+         op == "SparseSegmentSumWithNumSegments" ||
+         op == "SparseSegmentMeanWithNumSegments" ||
+         op == "SparseSegmentSqrtNWithNumSegments";
+}
+
+// Returns the combiner of _ResourceSparseSegmentReduction that corresponds to a
+// SparseSegment{Sum,Mean,SqrtN} without num_segments, or nullptr.
+const char* GetSparseSegmentReductionCombiner(const NodeDef& node) {
+  const auto& op = node.op();
+  if (op == "SparseSegmentSum") return "sum";
+  if (op == "SparseSegmentMean") return "mean";
+  if (op == "SparseSegmentSqrtN") return "sqrtn";
+  return nullptr;
+}
+
+bool FindGatherWithSparseSegmentReduction(
+    const RemapperContext& ctx, int node_index,
+    bool allow_non_differentiable_rewrites,
+    GatherWithSparseSegmentReduction* matched) {
+  // Root of the pattern must be a SparseSegment{Sum,Mean,SqrtN}.
+  const auto* node_view = ctx.graph_view.GetNode(node_index);
+  const auto* node_def = node_view->node();
+  if (!IsSparseSegmentReduction(*node_def) ||
+      HasControlFaninOrFanout(*node_view) || node_view->NumRegularFanins() < 3)
+    return false;
+
+  // Its data must be the output of a Gather of rows that is not used elsewhere,
+  // so that it does not have to be materialized.
+  const auto* gather_node_view = node_view->GetRegularFanin(0).node_view();
+  const auto* gather_node_def = gather_node_view->node();
+  const bool is_gather_v2 = gather_node_def->op() == "GatherV2";
+  const bool is_resource_gather = gather_node_def->op() == "ResourceGather";
+  if ((!is_gather_v2 && !is_resource_gather) ||
+      HasControlFaninOrFanout(*gather_node_view) ||
+      !HasAtMostOneFanoutAtPort0(*gather_node_view) ||
+      IsInPreserveSet(ctx, gather_node_def) ||
+      gather_node_def->device() != node_def->device())
+    return false;
+
+  int batch_dims = 0;
+  if (TryGetNodeAttr(*gather_node_def, "batch_dims", &batch_dims) &&
+      batch_dims != 0)
+    return false;
+
+  // The gathered ids must be a vector, so that the rows of the gathered data
+  // are rows of the params.
+  if (!ctx.inferred_graph_properties) return false;
+  const auto& gather_props =
+      ctx.graph_properties.GetInputProperties(gather_node_def->name());
+  if (gather_props.size() < 2 || gather_props[1].shape().unknown_rank() ||
+      gather_props[1].shape().dim_size() != 1)
+    return false;
+
+  const DataType ids_dtype = GetDataTypeFromAttr(*gather_node_def, "Tindices");
+  if (is_gather_v2) {
+    // The rows must be gathered along axis 0, and the composed indices must
+    // have the type of the reduction's indices.
+    if (gather_node_view->NumRegularFanins() < 3) return false;
+    const auto* axis_node_def =
+        gather_node_view->GetRegularFanin(2).node_view()->node();
+    Tensor axis;
+    if (!IsConstant(*axis_node_def) ||
+        !axis.FromProto(axis_node_def->attr().at("value").tensor()) ||
+        axis.NumElements() != 1 ||
+        (axis.dtype() == DT_INT32 ? axis.flat<int32>()(0)
+                                  : axis.flat<int64_t>()(0)) != 0)
+      return false;
+    if (ids_dtype != GetDataTypeFromAttr(*node_def, "Tidx")) return false;
+  } else {
+    // _ResourceSparseSegmentReduction has no gradient and no num_segments.
+    if (!allow_non_differentiable_rewrites ||
+        GetSparseSegmentReductionCombiner(*node_def) == nullptr)
+      return false;
+    const DataType dtype = GetDataTypeFromAttr(*gather_node_def, "dtype");
+    if (dtype != DT_HALF && dtype != DT_BFLOAT16 && dtype != DT_FLOAT &&
+        dtype != DT_DOUBLE)
+      return false;
+#if GOOGLE_CUDA
+    if (!NodeIsOnCpu(node_def) && !NodeIsOnGpu(node_def)) return false;
+#else
+    if (!NodeIsOnCpu(node_def)) return false;
+#endif  // GOOGLE_CUDA
+  }
+
+  *matched = GatherWithSparseSegmentReduction(gather_node_view->node_index(),
+                                              node_index);
+  return true;
+}
+
+bool IsFusableBinaryElementwise(const NodeDef& node) {
+  return IsAdd(node) || IsSub(node) || IsMul(node) || IsMaximum(node) ||
+         IsMinimum(node);
+}
+
+bool IsFusableElementwise(const NodeDef& node) {
+  return IsFusableBinaryElementwise(node) || IsNeg(node) || IsRelu(node) ||
+         IsRelu6(node) || IsSigmoid(node) || IsSquare(node) || IsTanh(node);
+}
+
+// Returns true if `node_view` is an op that _FusedElementwise supports on GPU,
+// whose inputs have the same shape.
+bool IsElementwiseChainCandidate(const RemapperContext& ctx,
+                                 const utils::MutableNodeView& node_view) {
+  const auto* node_def = node_view.node();
+  if (!IsFusableElementwise(*node_def) || !NodeIsOnGpu(node_def) ||
+      HasControlFaninOrFanout(node_view))
+    return false;
+  const DataType dtype = GetDataTypeFromAttr(*node_def, "T");
+  if (dtype != DT_HALF && dtype != DT_FLOAT && dtype != DT_DOUBLE)
+    return false;
+  if (!IsFusableBinaryElementwise(*node_def)) return true;
+
+  // The fused ops don't broadcast. The shapes may be symbolic, as in the
+  // graphs with dynamic shapes.
+  const auto& props = ctx.graph_properties.GetInputProperties(node_def->name());
+  return props.size() == 2 && !props[0].shape().unknown_rank() &&
+         ShapesSymbolicallyEqual(props[0].shape(), props[1].shape());
+}
+
+bool FindElementwiseChain(const RemapperContext& ctx, int node_index,
+                          ElementwiseChain* matched) {
+  if (ctx.xla_auto_clustering_on || !ctx.inferred_graph_properties)
+    return false;
+  // Root of the pattern is the last op of the chain.
+  const auto* node_view = ctx.graph_view.GetNode(node_index);
+  if (!IsElementwiseChainCandidate(ctx, *node_view)) return false;
+  const NodeDef* node_def = node_view->node();
+
+  // Follows the inputs of the ops while they are ops of the chain that are
+  // only used by the next op.
+  std::vector<int> nodes = {node_index};
+  std::vector<int> chain_ports;
+  const auto* last_view = node_view;
+  while (nodes.size() < static_cast<size_t>(kMaxElementwiseChainLength)) {
+    const auto is_previous_op = [&](int port) {
+      if (port >= last_view->NumRegularFanins()) return false;
+      const auto* fanin_view = last_view->GetRegularFanin(port).node_view();
+      const auto* fanin_def = fanin_view->node();
+      return IsElementwiseChainCandidate(ctx, *fanin_view) &&
+             HasAtMostOneFanoutAtPort0(*fanin_view) &&
+             !IsInPreserveSet(ctx, fanin_def) &&
+             fanin_def->device() == node_def->device() &&
+             GetDataTypeFromAttr(*fanin_def, "T") ==
+                 GetDataTypeFromAttr(*node_def, "T");
+    };
+    // The fused binary ops take the result of the previous ops as their first
+    // operand, so the chain only goes through the second operand of the
+    // commutative ops.
+    const auto* last_def = last_view->node();
+    int port = -1;
+    if (is_previous_op(0)) {
+      port = 0;
+    } else if (!IsSub(*last_def) && IsFusableBinaryElementwise(*last_def) &&
+               is_previous_op(1)) {
+      port = 1;
+    }
+    if (port < 0) break;
+    chain_ports.push_back(port);
+    last_view = last_view->GetRegularFanin(port).node_view();
+    nodes.push_back(last_view->node_index());
+  }
+  if (nodes.size() < 2) return false;
+  // The first op of the chain takes the chain input as its first operand.
+  chain_ports.push_back(0);
+
+  std::reverse(nodes.begin(), nodes.end());
+  std::reverse(chain_ports.begin(), chain_ports.end());
+  matched->nodes = std::move(nodes);
+  matched->chain_ports = std::move(chain_ports);
+  return true;
+}
+
+bool FindBiasActivationDropout(const RemapperContext& ctx, int node_index,
+                               BiasActivationDropout* matched) {
+  if (ctx.xla_auto_clustering_on) return false;
+  // Root of the pattern must be a Dropout on GPU.
+  const auto* dropout_view = ctx.graph_view.GetNode(node_index);
+  const auto* dropout_def = dropout_view->node();
+  if (dropout_def->op() != "Dropout" || !NodeIsOnGpu(dropout_def) ||
+      HasControlFaninOrFanout(*dropout_view))
+    return false;
+  const DataType dtype = GetDataTypeFromAttr(*dropout_def, "T");
+  if (dtype != DT_HALF && dtype != DT_FLOAT && dtype != DT_DOUBLE)
+    return false;
+
+  // The other ops must be on the same device, and must not be fetched or
+  // depend on control edges.
+  const auto is_fusable = [&](const utils::MutableNodeView& node_view) {
+    const auto* node_def = node_view.node();
+    return node_def->device() == dropout_def->device() &&
+           !HasControlFaninOrFanout(node_view) &&
+           !IsInPreserveSet(ctx, node_def);
+  };
+  const auto is_channel_last = [](const NodeDef& node_def) {
+    return !node_def.attr().contains(kDataFormat) ||
+           node_def.attr().at(kDataFormat).s() == "NHWC";
+  };
+
+  const auto* activation_view = dropout_view->GetRegularFanin(0).node_view();
+  const auto* activation_def = activation_view->node();
+  if ((!IsRelu(*activation_def) && !IsRelu6(*activation_def)) ||
+      !is_fusable(*activation_view))
+    return false;
+  const auto* bias_add_view = activation_view->GetRegularFanin(0).node_view();
+  const auto* bias_add_def = bias_add_view->node();
+  if (!IsBiasAdd(*bias_add_def) || !is_channel_last(*bias_add_def) ||
+      !is_fusable(*bias_add_view) || !HasAtMostOneFanoutAtPort0(*bias_add_view))
+    return false;
+
+  // Besides the dropout, the activation may be used by the Shape computing the
+  // noise shape, and by its gradient.
+  BiasActivationDropout pattern;
+  pattern.bias_add = bias_add_view->node_index();
+  pattern.activation = activation_view->node_index();
+  pattern.dropout = node_index;
+  for (const auto& fanout : activation_view->GetRegularFanout(0)) {
+    const auto* fanout_view = fanout.node_view();
+    const auto* fanout_def = fanout_view->node();
+    if (fanout_view == dropout_view && fanout.index() == 0) continue;
+    if (IsShape(*fanout_def) && pattern.noise_shape == kMissingIndex &&
+        is_fusable(*fanout_view) && fanout_view->NumRegularFanins() == 1 &&
+        fanout_view->GetRegularFanout(0).size() == 1 &&
+        fanout_view->GetRegularFanout(0)[0].node_view() == dropout_view &&
+        fanout_view->GetRegularFanout(0)[0].index() == 2) {
+      pattern.noise_shape = fanout_view->node_index();
+    } else if (IsReluGrad(*fanout_def) && IsRelu(*activation_def) &&
+               fanout.index() == 1 &&
+               pattern.activation_grad == kMissingIndex &&
+               is_fusable(*fanout_view)) {
+      pattern.activation_grad = fanout_view->node_index();
+    } else {
+      return false;
+    }
+  }
+
+  // The mask is only used by the gradient of the dropout, which must be the
+  // gradient of the activation.
+  const auto& mask_fanouts = dropout_view->GetRegularFanout(1);
+  if (pattern.activation_grad == kMissingIndex) {
+    if (!mask_fanouts.empty()) return false;
+    *matched = pattern;
+    return true;
+  }
+  if (mask_fanouts.size() != 1 || mask_fanouts[0].index() != 2) return false;
+  const auto* dropout_grad_view = mask_fanouts[0].node_view();
+  const auto* dropout_grad_def = dropout_grad_view->node();
+  const auto* activation_grad_view =
+      ctx.graph_view.GetNode(pattern.activation_grad);
+  if (dropout_grad_def->op() != "DropoutGrad" ||
+      dropout_grad_def->input(1) != dropout_def->input(1) ||
+      !is_fusable(*dropout_grad_view) ||
+      !HasAtMostOneFanoutAtPort0(*dropout_grad_view) ||
+      activation_grad_view->GetRegularFanin(0).node_view() != dropout_grad_view)
+    return false;
+  pattern.dropout_grad = dropout_grad_view->node_index();
+
+  // The gradient of the activation is also the gradient of the input of the
+  // BiasAdd, so that it may have other uses than the BiasAddGrad.
+  for (const auto& fanout : activation_grad_view->GetRegularFanout(0)) {
+    const auto* fanout_view = fanout.node_view();
+    const auto* fanout_def = fanout_view->node();
+    if (IsBiasAddGrad(*fanout_def) && is_channel_last(*fanout_def) &&
+        fanout_def->device() == dropout_def->device() &&
+        !HasControlFaninOrFanout(*fanout_view)) {
+      if (pattern.bias_add_grad != kMissingIndex) return false;
+      pattern.bias_add_grad = fanout_view->node_index();
+    }
+  }
+  if (pattern.bias_add_grad == kMissingIndex) return false;
+
+  *matched = pattern;
+  return true;
+}
+
 bool FindFusedBatchMatMul(RemapperContext* ctx, int node_index,
                           std::map<string, int>* matched_nodes_map,
                           std::set<int>* remove_node_indices,
@@ -3903,6 +4259,325 @@ Status AddTensorToHashBucketNode(RemapperContext* ctx,
   return OkStatus();
 }
 
+Status AddGatherWithSparseSegmentReductionNodes(
+    RemapperContext* ctx, const GatherWithSparseSegmentReduction& matched,
+    std::vector<bool>* invalidated_nodes, std::vector<bool>* nodes_to_delete) {
+  const GraphDef* graph = ctx->graph_view.graph();
+  const NodeDef& gather = graph->node(matched.gather);
+  const NodeDef& reduction = graph->node(matched.sparse_segment_reduction);
+  const bool is_resource_gather = gather.op() == "ResourceGather";
+  VLOG(2) << "Fuse " << gather.op() << " with " << reduction.op() << ":"
+          << " gather=" << gather.name() << " reduction=" << reduction.name();
+
+  utils::Mutation* mutation = ctx->graph_view.GetMutationBuilder();
+  Status status;
+
+  // The reduction reads params[ids[indices[i]]], so the (small) ids are
+  // gathered instead of the (large) rows of the params.
+  string axis_input;
+  if (is_resource_gather) {
+    // The axis is anchored to the indices, so that it is in their frame.
+    NodeDef axis;
+    axis.set_name(absl::StrCat(reduction.name(), "/ids_axis"));
+    axis.set_op("Const");
+    axis.set_device(reduction.device());
+    axis.add_input(AsControlDependency(NodeName(reduction.input(1))));
+    AddNodeAttr("dtype", DT_INT32, &axis);
+    Tensor axis_value(DT_INT32, TensorShape({}));
+    axis_value.scalar<int32>()() = 0;
+    axis_value.AsProtoTensorContent(
+        (*axis.mutable_attr())["value"].mutable_tensor());
+    axis_input = axis.name();
+    mutation->AddNode(std::move(axis), &status);
+    TF_RETURN_IF_ERROR(status);
+  } else {
+    axis_input = gather.input(2);
+  }
+
+  NodeDef ids;
+  ids.set_name(absl::StrCat(reduction.name(), "/ids"));
+  ids.set_op("GatherV2");
+  ids.set_device(reduction.device());
+  ids.add_input(gather.input(1));     // 0: params (the ids)
+  ids.add_input(reduction.input(1));  // 1: indices
+  ids.add_input(axis_input);          // 2: axis
+  auto* ids_attr = ids.mutable_attr();
+  (*ids_attr)["Tparams"] = gather.attr().at("Tindices");
+  (*ids_attr)["Tindices"] = reduction.attr().at("Tidx");
+  if (is_resource_gather) {
+    AddNodeAttr("Taxis", DT_INT32, &ids);
+  } else {
+    (*ids_attr)["Taxis"] = gather.attr().at("Taxis");
+  }
+  AddNodeAttr("batch_dims", 0, &ids);
+  const string ids_name = ids.name();
+  mutation->AddNode(std::move(ids), &status);
+  TF_RETURN_IF_ERROR(status);
+
+  NodeDef fused_op;
+  fused_op.set_name(reduction.name());
+  fused_op.set_device(reduction.device());
+  fused_op.add_input(gather.input(0));  // 0: params or resource
+  fused_op.add_input(ids_name);         // 1: indices
+  for (int i = 2; i < reduction.input_size(); ++i) {
+    fused_op.add_input(reduction.input(i));  // 2: segment_ids, ...
+  }
+  if (is_resource_gather) {
+    fused_op.set_op(kResourceSparseSegmentReduction);
+    auto* attr = fused_op.mutable_attr();
+    (*attr)["dtype"] = gather.attr().at("dtype");
+    (*attr)["Tidx"] = gather.attr().at("Tindices");
+    (*attr)["Tsegmentids"] = reduction.attr().at("Tsegmentids");
+    SetAttrValue(GetSparseSegmentReductionCombiner(reduction),
+                 &(*attr)["combiner"]);
+  } else {
+    fused_op.set_op(reduction.op());
+    *fused_op.mutable_attr() = reduction.attr();
+  }
+  mutation->AddNode(std::move(fused_op), &status);
+  TF_RETURN_IF_ERROR(status);
+  TF_RETURN_IF_ERROR(mutation->Apply());
+
+  (*invalidated_nodes)[matched.sparse_segment_reduction] = true;
+  (*nodes_to_delete)[matched.gather] = true;
+
+  return OkStatus();
+}
+
+Status AddFusedBiasActivationDropoutNodes(
+    RemapperContext* ctx, const BiasActivationDropout& matched,
+    std::vector<bool>* invalidated_nodes, std::vector<bool>* nodes_to_delete) {
+  const GraphDef* graph = ctx->graph_view.graph();
+  const NodeDef& bias_add = graph->node(matched.bias_add);
+  const NodeDef& activation = graph->node(matched.activation);
+  const NodeDef& dropout = graph->node(matched.dropout);
+  VLOG(2) << "Fuse " << bias_add.op() << " with " << activation.op()
+          << " and Dropout: dropout=" << dropout.name()
+          << " with_gradient=" << (matched.activation_grad != kMissingIndex);
+
+  utils::Mutation* mutation = ctx->graph_view.GetMutationBuilder();
+  Status status;
+
+  // The fused op takes the name of the dropout, so that its outputs are the
+  // output and the mask of the dropout.
+  NodeDef fused_op;
+  fused_op.set_name(dropout.name());
+  fused_op.set_op(kFusedBiasActivationDropout);
+  fused_op.set_device(dropout.device());
+  fused_op.add_input(bias_add.input(0));  // 0: value
+  fused_op.add_input(bias_add.input(1));  // 1: bias
+  fused_op.add_input(dropout.input(1));   // 2: rate
+  fused_op.add_input(dropout.input(3));   // 3: seed1
+  fused_op.add_input(dropout.input(4));   // 4: seed2
+  auto* attr = fused_op.mutable_attr();
+  (*attr)["T"] = dropout.attr().at("T");
+  (*attr)["Tseed"] = dropout.attr().at("Tseed");
+  SetAttrValue(activation.op(), &(*attr)["activation"]);
+  mutation->AddNode(std::move(fused_op), &status);
+  TF_RETURN_IF_ERROR(status);
+  (*invalidated_nodes)[matched.dropout] = true;
+  (*nodes_to_delete)[matched.bias_add] = true;
+  (*nodes_to_delete)[matched.activation] = true;
+  if (matched.noise_shape != kMissingIndex) {
+    (*nodes_to_delete)[matched.noise_shape] = true;
+  }
+
+  if (matched.activation_grad != kMissingIndex) {
+    const NodeDef& dropout_grad = graph->node(matched.dropout_grad);
+    const NodeDef& activation_grad = graph->node(matched.activation_grad);
+    const NodeDef& bias_add_grad = graph->node(matched.bias_add_grad);
+
+    // The fused gradient takes the name of the gradient of the activation,
+    // which is the gradient of the value.
+    NodeDef fused_grad;
+    fused_grad.set_name(activation_grad.name());
+    fused_grad.set_op(kFusedBiasActivationDropoutGrad);
+    fused_grad.set_device(activation_grad.device());
+    fused_grad.add_input(dropout_grad.input(0));               // 0: gradients
+    fused_grad.add_input(dropout.name());                      // 1: output
+    fused_grad.add_input(dropout.input(1));                    // 2: rate
+    fused_grad.add_input(absl::StrCat(dropout.name(), ":1"));  // 3: mask
+    auto* grad_attr = fused_grad.mutable_attr();
+    (*grad_attr)["T"] = dropout.attr().at("T");
+    SetAttrValue(activation.op(), &(*grad_attr)["activation"]);
+
+    // The BiasAddGrad is replaced by the gradient of the bias.
+    NodeDef bias_backprop;
+    bias_backprop.set_name(bias_add_grad.name());
+    bias_backprop.set_op("Identity");
+    bias_backprop.set_device(bias_add_grad.device());
+    bias_backprop.add_input(absl::StrCat(activation_grad.name(), ":1"));
+    (*bias_backprop.mutable_attr())["T"] = bias_add_grad.attr().at("T");
+
+    mutation->AddNode(std::move(fused_grad), &status);
+    TF_RETURN_IF_ERROR(status);
+    mutation->AddNode(std::move(bias_backprop), &status);
+    TF_RETURN_IF_ERROR(status);
+    (*invalidated_nodes)[matched.activation_grad] = true;
+    (*invalidated_nodes)[matched.bias_add_grad] = true;
+    (*nodes_to_delete)[matched.dropout_grad] = true;
+  }
+
+  return mutation->Apply();
+}
+
+Status AddFusedElementwiseNode(RemapperContext* ctx,
+                               const ElementwiseChain& matched,
+                               std::vector<bool>* invalidated_nodes,
+                               std::vector<bool>* nodes_to_delete) {
+  const GraphDef* graph = ctx->graph_view.graph();
+  const NodeDef& last = graph->node(matched.nodes.back());
+  VLOG(2) << "Fuse " << matched.nodes.size()
+          << " elementwise ops into a _FusedElementwise: last=" << last.name();
+
+  NodeDef fused_op;
+  fused_op.set_name(last.name());
+  fused_op.set_op(kFusedElementwise);
+  fused_op.set_device(last.device());
+  std::vector<string> fused_ops;
+  for (int i = 0; i < matched.nodes.size(); ++i) {
+    const NodeDef& node = graph->node(matched.nodes[i]);
+    const int chain_port = matched.chain_ports[i];
+    // The input of the first op, then the other operands of the binary ops.
+    if (i == 0) fused_op.add_input(node.input(chain_port));
+    if (IsFusableBinaryElementwise(node)) {
+      fused_op.add_input(node.input(1 - chain_port));
+    }
+    fused_ops.push_back(node.op());
+  }
+  auto* attr = fused_op.mutable_attr();
+  (*attr)["T"] = last.attr().at("T");
+  SetAttrValue(fused_op.input_size(), &(*attr)["N"]);
+  SetAttrValue(fused_ops, &(*attr)["fused_ops"]);
+
+  utils::Mutation* mutation = ctx->graph_view.GetMutationBuilder();
+  Status status;
+  mutation->AddNode(std::move(fused_op), &status);
+  TF_RETURN_IF_ERROR(status);
+  TF_RETURN_IF_ERROR(mutation->Apply());
+
+  (*invalidated_nodes)[matched.nodes.back()] = true;
+  for (int i = 0; i + 1 < matched.nodes.size(); ++i) {
+    (*nodes_to_delete)[matched.nodes[i]] = true;
+  }
+  return OkStatus();
+}
+
+// Returns the key shared by the ResourceApplyAdam ops that may be grouped with
+// `node_view` into a _ResourceApplyAdamMultiTensor, or an empty string if it
+// may not be grouped.
+string ResourceApplyAdamGroupKey(const RemapperContext& ctx,
+                                 const utils::MutableNodeView& node_view) {
+  const NodeDef* node_def = node_view.node();
+  if (node_def->op() != "ResourceApplyAdam" || !NodeIsOnGpu(node_def) ||
+      IsInPreserveSet(ctx, node_def) || node_view.NumRegularFanins() != 10) {
+    return "";
+  }
+  // The grouped ops have the same attributes and hyperparameters (inputs 3 to
+  // 8), which also places them in the same frame.
+  string key = absl::StrCat(node_def->device(), ";",
+                            GetDataTypeFromAttr(*node_def, "T"));
+  for (const char* attr : {"use_locking", "use_nesterov"}) {
+    bool value = false;
+    TryGetNodeAttr(*node_def, attr, &value);
+    absl::StrAppend(&key, ";", value);
+  }
+  for (int i = 3; i < 9; ++i) {
+    const auto& fanin = node_view.GetRegularFanin(i);
+    absl::StrAppend(&key, ";", fanin.node_view()->GetName(), ":",
+                    fanin.index());
+  }
+  return key;
+}
+
+// Groups the ResourceApplyAdam ops on GPU that share their hyperparameters into
+// _ResourceApplyAdamMultiTensor ops, which update all their variables with a
+// single kernel. Launching a kernel per variable dominates the optimizer step
+// of models with many small variables. The graph must be sorted topologically.
+Status AddResourceApplyAdamMultiTensorNodes(RemapperContext* ctx,
+                                            bool* changed) {
+  *changed = false;
+  utils::MutableGraphView* graph_view = &ctx->graph_view;
+  const int num_nodes = graph_view->NumNodes();
+
+  // An op is only grouped if none of the candidates is among its ancestors,
+  // so that the grouped op can't be its own ancestor.
+  std::vector<string> keys(num_nodes);
+  std::vector<bool> has_candidate_ancestor(num_nodes);
+  std::map<string, std::vector<int>> groups;
+  for (int i = 0; i < num_nodes; ++i) {
+    const utils::MutableNodeView* node_view = graph_view->GetNode(i);
+    bool after_candidate = false;
+    auto visit_fanin = [&](const utils::MutableFanoutView& fanin) {
+      const int fanin_index = fanin.node_index();
+      after_candidate |=
+          has_candidate_ancestor[fanin_index] || !keys[fanin_index].empty();
+    };
+    for (const auto& fanin : node_view->GetRegularFanins()) visit_fanin(fanin);
+    for (const auto& fanin : node_view->GetControllingFanins()) {
+      visit_fanin(fanin);
+    }
+    has_candidate_ancestor[i] = after_candidate;
+    keys[i] = ResourceApplyAdamGroupKey(*ctx, *node_view);
+    if (!keys[i].empty() && !after_candidate) groups[keys[i]].push_back(i);
+  }
+
+  utils::Mutation* mutation = graph_view->GetMutationBuilder();
+  Status status;
+  for (const auto& group : groups) {
+    const std::vector<int>& members = group.second;
+    if (members.size() < 2) continue;
+    const NodeDef& first = *graph_view->GetNode(members[0])->node();
+    VLOG(2) << "Group " << members.size()
+            << " ResourceApplyAdam ops: first=" << first.name();
+
+    // The grouped op takes the name of the first op, the others being removed.
+    NodeDef fused_op;
+    fused_op.set_name(first.name());
+    fused_op.set_op(kResourceApplyAdamMultiTensor);
+    fused_op.set_device(first.device());
+    for (int input = 0; input < 3; ++input) {
+      for (int member : members) {
+        fused_op.add_input(graph_view->GetNode(member)->node()->input(input));
+      }
+    }
+    for (int input = 3; input < 9; ++input) {
+      fused_op.add_input(first.input(input));
+    }
+    for (int member : members) {
+      fused_op.add_input(graph_view->GetNode(member)->node()->input(9));
+    }
+    std::set<string> controlling_fanins;
+    for (int member : members) {
+      for (const auto& fanin :
+           graph_view->GetNode(member)->GetControllingFanins()) {
+        controlling_fanins.insert(fanin.node_view()->GetName());
+      }
+    }
+    for (const string& fanin : controlling_fanins) {
+      fused_op.add_input(AsControlDependency(fanin));
+    }
+    auto* attr = fused_op.mutable_attr();
+    for (const char* name : {"T", "use_locking", "use_nesterov"}) {
+      if (first.attr().count(name)) (*attr)[name] = first.attr().at(name);
+    }
+    AddNodeAttr("N", static_cast<int>(members.size()), &fused_op);
+
+    for (size_t i = 1; i < members.size(); ++i) {
+      utils::MutableNodeView* member = graph_view->GetNode(members[i]);
+      for (const auto& fanout : member->GetControlledFanouts()) {
+        mutation->RemoveControllingFanin(fanout.node_view(), member->GetName());
+        mutation->AddControllingFanin(fanout.node_view(), first.name());
+      }
+      mutation->RemoveNode(member);
+    }
+    mutation->AddNode(std::move(fused_op), &status);
+    TF_RETURN_IF_ERROR(status);
+    *changed = true;
+  }
+  return mutation->Apply();
+}
+
 Status AddFusedBatchMatMul(RemapperContext* ctx,
                            const std::map<string, int>& matched_nodes_map,
                            const std::set<int>& remove_node_indices,
@@ -4360,16 +5035,45 @@ bool RequiresInferredShapes(const RemapperContext& ctx, int node_index,
     return true;
   };
 
+  // Candidate for a Gather + SparseSegmentReduction fusion, which needs the
+  // shape of the gathered ids.
+  const auto is_gather_sparse_segment_reduction_candidate = [&]() -> bool {
+    if (!IsSparseSegmentReduction(*node_def)) return false;
+    if (node_view->NumRegularFanins() < 1) return false;
+    const auto* gather_node_def =
+        node_view->GetRegularFanin(0).node_view()->node();
+    return gather_node_def->op() == "GatherV2" ||
+           gather_node_def->op() == "ResourceGather";
+  };
+
+  // Candidate for an elementwise chain fusion, which needs the shapes of the
+  // operands of the binary ops.
+  const auto is_elementwise_chain_candidate = [&]() -> bool {
+    if (ctx.xla_auto_clustering_on || !IsFusableElementwise(*node_def) ||
+        !NodeIsOnGpu(node_def))
+      return false;
+    for (int port = 0; port < node_view->NumRegularFanins() && port < 2;
+         ++port) {
+      if (IsFusableElementwise(*node_view->GetRegularFanin(port).node_view()
+                                     ->node()))
+        return true;
+    }
+    return false;
+  };
+
   if (IsMKLEnabled())
     return is_batch_norm_candidate() || is_batch_norm_fusion_candidate() ||
            IsContractionWithAdd(ctx, node_index) ||
-           is_act_biasadd_conv_candidate();
+           is_act_biasadd_conv_candidate() ||
+           is_gather_sparse_segment_reduction_candidate();
 
   return is_act_biasadd_conv_candidate() || is_batch_norm_candidate() ||
          is_batch_norm_fusion_candidate() ||
          is_batch_norm_grad_fusion_candidate() ||
          is_matmul_gelu_exact_fusion_candidate() ||
-         is_act_biasadd_matmul_candidate();
+         is_act_biasadd_matmul_candidate() ||
+         is_gather_sparse_segment_reduction_candidate() ||
+         is_elementwise_chain_candidate();
 }
 }  // namespace
 
@@ -4385,7 +5089,19 @@ Status Remapper::Optimize(Cluster* cluster, const GrapplerItem& item,
   TF_RETURN_IF_ERROR(
       ctx.graph_view.SortTopologically(/*ignore_cycles=*/false, {}));
 
-  const int num_nodes = item.graph.node_size();
+  // The apply ops are grouped first, as the remapping below relies on the
+  // topological order of the nodes. The grouped ops have no XLA kernel.
+  if (!ctx.xla_auto_clustering_on) {
+    bool grouped_apply_ops;
+    TF_RETURN_IF_ERROR(
+        AddResourceApplyAdamMultiTensorNodes(&ctx, &grouped_apply_ops));
+    if (grouped_apply_ops) {
+      TF_RETURN_IF_ERROR(
+          ctx.graph_view.SortTopologically(/*ignore_cycles=*/false, {}));
+    }
+  }
+
+  const int num_nodes = ctx.graph_view.NumNodes();
   // Skip nodes that were invalidated by a remapper, e.g. do not process BiasAdd
   // and Activation nodes that were fused into a Conv2D node.
   std::vector<bool> invalidated_nodes(num_nodes);
@@ -4642,6 +5358,18 @@ Status Remapper::Optimize(Cluster* cluster, const GrapplerItem& item,
       continue;
     }
 
+    // Remap {GatherV2,ResourceGather}+SparseSegment{Sum,Mean,SqrtN} so that
+    // the gathered rows are not materialized.
+    GatherWithSparseSegmentReduction gather_with_sparse_segment_reduction;
+    if (FindGatherWithSparseSegmentReduction(
+            ctx, i, allow_non_differentiable_rewrites,
+            &gather_with_sparse_segment_reduction)) {
+      TF_RETURN_IF_ERROR(AddGatherWithSparseSegmentReductionNodes(
+          &ctx, gather_with_sparse_segment_reduction, &invalidated_nodes,
+          &nodes_to_delete));
+      continue;
+    }
+
     TensorToHashBucket tensor_to_hash_bucket;
     if (allow_non_differentiable_rewrites &&
         FindTensorToHashBucket(ctx, i, &tensor_to_hash_bucket)) {
@@ -4650,6 +5378,36 @@ Status Remapper::Optimize(Cluster* cluster, const GrapplerItem& item,
       continue;
     }
 
+    // Remap Dropout(Activation(BiasAdd)) on GPU, and the gradients of these
+    // ops, into a _FusedBiasActivationDropout. The gradients are visited
+    // before the Dropout, so they must not have been rewritten already.
+    BiasActivationDropout bias_activation_dropout;
+    if (allow_non_differentiable_rewrites &&
+        FindBiasActivationDropout(ctx, i, &bias_activation_dropout) &&
+        absl::c_none_of(
+            std::vector<int>{bias_activation_dropout.dropout_grad,
+                             bias_activation_dropout.activation_grad,
+                             bias_activation_dropout.bias_add_grad},
+            [&](int index) {
+              return index != kMissingIndex &&
+                     (invalidated_nodes[index] || nodes_to_delete[index]);
+            })) {
+      TF_RETURN_IF_ERROR(AddFusedBiasActivationDropoutNodes(
+          &ctx, bias_activation_dropout, &invalidated_nodes,
+          &nodes_to_delete));
+      continue;
+    }
+
+    // Remap chains of elementwise ops on GPU into a _FusedElementwise. This is
+    // tried after the patterns above, which may also fuse these ops.
+    ElementwiseChain elementwise_chain;
+    if (allow_non_differentiable_rewrites &&
+        FindElementwiseChain(ctx, i, &elementwise_chain)) {
+      TF_RETURN_IF_ERROR(AddFusedElementwiseNode(
+          &ctx, elementwise_chain, &invalidated_nodes, &nodes_to_delete));
+      continue;
+    }
+
     // During inference, most of the inputs to FusedBatchNorm are constant, and
     // we can therefore replace the op with a much cheaper set of primitives.
     FusedBatchNorm fused_batch_norm;
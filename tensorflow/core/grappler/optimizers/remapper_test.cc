@@ -15,7 +15,11 @@ limitations under the License.
 
 #include "tensorflow/core/grappler/optimizers/remapper.h"
 
+#include <set>
+
+#include "absl/strings/str_cat.h"
 #include "tensorflow/cc/ops/nn_ops_internal.h"
+#include "tensorflow/cc/ops/resource_variable_ops.h"
 #include "tensorflow/cc/ops/standard_ops.h"
 #include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/framework/types.h"
@@ -119,7 +123,8 @@ TEST_F(RemapperTest, FuseBatchNormWithRelu) {
   for (bool is_training : {true, false}) {
     tensorflow::Scope s = tensorflow::Scope::NewRootScope();
 
-#if !defined(GOOGLE_CUDA) || !(CUDNN_VERSION >= 7402)
+#if !TENSORFLOW_USE_ROCM && \
+    (!defined(GOOGLE_CUDA) || !(CUDNN_VERSION >= 7402))
     if (is_training) {
       LOG(INFO) << "Skip FuseBatchNormWithRelu"
                 << "[is_training=" << is_training << "] "
@@ -219,7 +224,7 @@ TEST_F(RemapperTest, FuseBatchNormWithRelu) {
   }
 }
 
-#if defined(GOOGLE_CUDA) && CUDNN_VERSION >= 7402
+#if (defined(GOOGLE_CUDA) && CUDNN_VERSION >= 7402) || TENSORFLOW_USE_ROCM
 TEST_F(RemapperTest, FuseBatchNormGradWithReluGrad) {
   if (IsMKLEnabled()) GTEST_SKIP() << "Fusion not available with oneDNN.";
   using ::tensorflow::ops::Placeholder;
@@ -342,7 +347,8 @@ TEST_F(RemapperTest, FuseBatchNormGradWithReluGrad) {
     test::ExpectClose(tensors[2], tensors_expected[2], 1e-2, /*rtol=*/1e-2);
   }
 }
-#endif  // defined(GOOGLE_CUDA) && CUDNN_VERSION >= 7402
+#endif  // (defined(GOOGLE_CUDA) && CUDNN_VERSION >= 7402) ||
+        // TENSORFLOW_USE_ROCM
 
 TEST_F(RemapperTest, FuseBatchNormWithAddAndRelu) {
   using ::tensorflow::ops::Placeholder;
@@ -350,7 +356,8 @@ TEST_F(RemapperTest, FuseBatchNormWithAddAndRelu) {
   for (bool is_training : {true, false}) {
     tensorflow::Scope s = tensorflow::Scope::NewRootScope();
 
-#if !defined(GOOGLE_CUDA) || !(CUDNN_VERSION >= 7402)
+#if !TENSORFLOW_USE_ROCM && \
+    (!defined(GOOGLE_CUDA) || !(CUDNN_VERSION >= 7402))
     if (is_training) {
       LOG(INFO) << "Skip FuseBatchNormWithAddAndRelu"
                 << "[is_training=" << is_training << "] "
@@ -456,7 +463,7 @@ TEST_F(RemapperTest, FuseBatchNormWithAddAndRelu) {
   }
 }
 
-#if defined(GOOGLE_CUDA) && CUDNN_VERSION >= 7402
+#if (defined(GOOGLE_CUDA) && CUDNN_VERSION >= 7402) || TENSORFLOW_USE_ROCM
 TEST_F(RemapperTest, FuseBatchNormGradWithAddAndReluGrad) {
   if (IsMKLEnabled()) GTEST_SKIP() << "Fusion not available with oneDNN.";
   using ::tensorflow::ops::Placeholder;
@@ -624,7 +631,8 @@ TEST_F(RemapperTest, FuseBatchNormGradWithAddAndReluGrad) {
     test::ExpectClose(tensors[5], tensors_expected[5], 1e-2, /*rtol=*/1e-2);
   }
 }
-#endif  // defined(GOOGLE_CUDA) && CUDNN_VERSION >= 7402
+#endif  // (defined(GOOGLE_CUDA) && CUDNN_VERSION >= 7402) ||
+        // TENSORFLOW_USE_ROCM
 
 class RemapperFuseConvWithBias : public RemapperTest {
  public:
@@ -1473,6 +1481,307 @@ TEST_F(RemapperTensorToHashBucketTest, I32) { RunTest<DT_INT32>(); }
 
 TEST_F(RemapperTensorToHashBucketTest, I64) { RunTest<DT_INT64>(); }
 
+TEST_F(RemapperTest, FuseGatherWithSparseSegmentReduction) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope().WithDevice(
+      "/device:CPU:0");
+  auto params = ops::Placeholder(s.WithOpName("params"), DT_FLOAT,
+                                 ops::Placeholder::Shape({16, 8}));
+  auto ids = ops::Placeholder(s.WithOpName("ids"), DT_INT32,
+                              ops::Placeholder::Shape({6}));
+  auto axis = ops::Const(s.WithOpName("axis"), 0);
+  auto gather = ops::GatherV2(s.WithOpName("gather"), params, ids, axis);
+  auto indices = ops::Const(s.WithOpName("indices"), {0, 1, 2, 2, 4, 5});
+  auto segment_ids =
+      ops::Const(s.WithOpName("segment_ids"), {0, 0, 1, 3, 3, 3});
+  auto sum = ops::SparseSegmentSum(s.WithOpName("sum"), gather, indices,
+                                   segment_ids);
+  auto fetch = ops::Identity(s.WithOpName("fetch"), sum);
+
+  auto params_t = GenerateRandomTensor<DT_FLOAT>({16, 8});
+  Tensor ids_t = test::AsTensor<int32>({3, 15, 0, 7, 7, 9});
+  GrapplerItem item;
+  item.fetch = {"fetch"};
+  item.feed = {{"params", params_t}, {"ids", ids_t}};
+  TF_ASSERT_OK(s.ToGraphDef(&item.graph));
+
+  Remapper optimizer(RewriterConfig::ON);
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  int found = 0;
+  for (const NodeDef& node : output.node()) {
+    EXPECT_NE(node.name(), "gather");
+    if (node.name() == "sum") {
+      EXPECT_EQ(node.op(), "SparseSegmentSum");
+      ASSERT_EQ(node.input_size(), 3);
+      EXPECT_EQ(node.input(0), "params");
+      EXPECT_EQ(node.input(1), "sum/ids");
+      EXPECT_EQ(node.input(2), "segment_ids");
+      found++;
+    }
+    if (node.name() == "sum/ids") {
+      EXPECT_EQ(node.op(), "GatherV2");
+      ASSERT_EQ(node.input_size(), 3);
+      EXPECT_EQ(node.input(0), "ids");
+      EXPECT_EQ(node.input(1), "indices");
+      EXPECT_EQ(node.input(2), "axis");
+      found++;
+    }
+  }
+  EXPECT_EQ(found, 2);
+
+  auto tensors_expected = EvaluateNodes(item.graph, item.fetch, item.feed);
+  ASSERT_EQ(tensors_expected.size(), 1);
+  auto tensors = EvaluateNodes(output, item.fetch, item.feed);
+  ASSERT_EQ(tensors.size(), 1);
+  test::ExpectTensorNear<float>(tensors[0], tensors_expected[0], 1e-6);
+}
+
+TEST_F(RemapperTest, FuseResourceGatherWithSparseSegmentReduction) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope().WithDevice(
+      "/device:CPU:0");
+  auto params = ops::VarHandleOp(s.WithOpName("params"), DT_FLOAT, {16, 8});
+  auto ids = ops::Placeholder(s.WithOpName("ids"), DT_INT64,
+                              ops::Placeholder::Shape({6}));
+  auto gather =
+      ops::ResourceGather(s.WithOpName("gather"), params, ids, DT_FLOAT);
+  auto indices = ops::Placeholder(s.WithOpName("indices"), DT_INT32,
+                                  ops::Placeholder::Shape({6}));
+  auto segment_ids = ops::Placeholder(s.WithOpName("segment_ids"), DT_INT32,
+                                      ops::Placeholder::Shape({6}));
+  auto mean = ops::SparseSegmentMean(s.WithOpName("mean"), gather, indices,
+                                     segment_ids);
+  auto fetch = ops::Identity(s.WithOpName("fetch"), mean);
+
+  GrapplerItem item;
+  item.fetch = {"fetch"};
+  TF_ASSERT_OK(s.ToGraphDef(&item.graph));
+
+  Remapper optimizer(RewriterConfig::ON);
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  int found = 0;
+  for (const NodeDef& node : output.node()) {
+    EXPECT_NE(node.name(), "gather");
+    if (node.name() == "mean") {
+      EXPECT_EQ(node.op(), "_ResourceSparseSegmentReduction");
+      ASSERT_EQ(node.input_size(), 3);
+      EXPECT_EQ(node.input(0), "params");
+      EXPECT_EQ(node.input(1), "mean/ids");
+      EXPECT_EQ(node.input(2), "segment_ids");
+      EXPECT_EQ(node.attr().at("combiner").s(), "mean");
+      EXPECT_EQ(node.attr().at("Tidx").type(), DT_INT64);
+      found++;
+    }
+    if (node.name() == "mean/ids") {
+      EXPECT_EQ(node.op(), "GatherV2");
+      ASSERT_EQ(node.input_size(), 3);
+      EXPECT_EQ(node.input(0), "ids");
+      EXPECT_EQ(node.input(1), "indices");
+      EXPECT_EQ(node.input(2), "mean/ids_axis");
+      found++;
+    }
+  }
+  EXPECT_EQ(found, 2);
+}
+
+TEST_F(RemapperTest, GroupResourceApplyAdam) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope().WithDevice(
+      "/device:GPU:0");
+  auto scalar = [&s](const string& name, float value) {
+    return ops::Const(s.WithOpName(name), value);
+  };
+  auto beta1_power = scalar("beta1_power", 0.9f);
+  auto beta2_power = scalar("beta2_power", 0.999f);
+  auto lr = scalar("lr", 0.01f);
+  auto other_lr = scalar("other_lr", 0.02f);
+  auto beta1 = scalar("beta1", 0.9f);
+  auto beta2 = scalar("beta2", 0.999f);
+  auto epsilon = scalar("epsilon", 1e-7f);
+
+  auto apply = [&](const string& name, Output lr, const Scope& scope) {
+    auto handle = [&](const string& slot) {
+      return ops::VarHandleOp(s.WithOpName(absl::StrCat(slot, "_", name)),
+                              DT_FLOAT, {4});
+    };
+    auto grad = ops::Placeholder(s.WithOpName(absl::StrCat("grad_", name)),
+                                 DT_FLOAT, ops::Placeholder::Shape({4}));
+    return ops::ResourceApplyAdam(scope.WithOpName(name), handle("var"),
+                                  handle("m"), handle("v"), beta1_power,
+                                  beta2_power, lr, beta1, beta2, epsilon, grad)
+        .operation;
+  };
+  auto a = apply("a", lr, s);
+  auto b = apply("b", lr, s);
+  // Different hyperparameters.
+  auto c = apply("c", other_lr, s);
+  // Depends on a.
+  auto d = apply("d", lr, s.WithControlDependencies(a));
+  ops::NoOp(s.WithOpName("train").WithControlDependencies({a, b, c, d}));
+
+  GrapplerItem item;
+  item.fetch = {"train"};
+  TF_ASSERT_OK(s.ToGraphDef(&item.graph));
+
+  Remapper optimizer(RewriterConfig::ON);
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  int found = 0;
+  for (const NodeDef& node : output.node()) {
+    EXPECT_NE(node.name(), "b");
+    if (node.name() == "a") {
+      EXPECT_EQ(node.op(), "_ResourceApplyAdamMultiTensor");
+      EXPECT_EQ(node.attr().at("N").i(), 2);
+      EXPECT_EQ(node.attr().at("T").type(), DT_FLOAT);
+      ASSERT_EQ(node.input_size(), 14);
+      EXPECT_EQ(node.input(0), "var_a");
+      EXPECT_EQ(node.input(1), "var_b");
+      EXPECT_EQ(node.input(2), "m_a");
+      EXPECT_EQ(node.input(3), "m_b");
+      EXPECT_EQ(node.input(4), "v_a");
+      EXPECT_EQ(node.input(5), "v_b");
+      EXPECT_EQ(node.input(6), "beta1_power");
+      EXPECT_EQ(node.input(8), "lr");
+      EXPECT_EQ(node.input(11), "epsilon");
+      EXPECT_EQ(node.input(12), "grad_a");
+      EXPECT_EQ(node.input(13), "grad_b");
+      found++;
+    }
+    if (node.name() == "c" || node.name() == "d") {
+      EXPECT_EQ(node.op(), "ResourceApplyAdam");
+      found++;
+    }
+    if (node.name() == "train") {
+      std::set<string> inputs(node.input().begin(), node.input().end());
+      EXPECT_EQ(inputs, std::set<string>({"^a", "^c", "^d"}));
+      found++;
+    }
+  }
+  EXPECT_EQ(found, 4);
+}
+
+TEST_F(RemapperTest, FuseBiasActivationDropout) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope().WithDevice(
+      "/device:GPU:0");
+  auto value = ops::Placeholder(s.WithOpName("value"), DT_FLOAT,
+                                ops::Placeholder::Shape({-1, 16}));
+  auto bias = ops::Placeholder(s.WithOpName("bias"), DT_FLOAT,
+                               ops::Placeholder::Shape({16}));
+  auto bias_add = ops::BiasAdd(s.WithOpName("bias_add"), value, bias);
+  auto relu = ops::Relu(s.WithOpName("relu"), bias_add);
+  auto rate = ops::Const(s.WithOpName("rate"), 0.1f);
+  auto noise_shape = ops::Shape(s.WithOpName("noise_shape"), relu);
+  auto seed = ops::Const(s.WithOpName("seed"), 0);
+  auto dropout = ops::Dropout(s.WithOpName("dropout"), relu, rate,
+                              noise_shape, seed, seed);
+  auto grad = ops::Placeholder(s.WithOpName("grad"), DT_FLOAT,
+                               ops::Placeholder::Shape({-1, 16}));
+  auto dropout_grad = ops::DropoutGrad(s.WithOpName("dropout_grad"), grad,
+                                       rate, dropout.mask);
+  auto relu_grad =
+      ops::internal::ReluGrad(s.WithOpName("relu_grad"), dropout_grad, relu);
+  auto bias_add_grad =
+      ops::BiasAddGrad(s.WithOpName("bias_add_grad"), relu_grad);
+  auto fetch_output = ops::Identity(s.WithOpName("fetch_output"),
+                                    dropout.output);
+  auto fetch_value_grad =
+      ops::Identity(s.WithOpName("fetch_value_grad"), relu_grad);
+  auto fetch_bias_grad =
+      ops::Identity(s.WithOpName("fetch_bias_grad"), bias_add_grad);
+
+  GrapplerItem item;
+  item.fetch = {"fetch_output", "fetch_value_grad", "fetch_bias_grad"};
+  TF_ASSERT_OK(s.ToGraphDef(&item.graph));
+
+  Remapper optimizer(RewriterConfig::ON);
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  int found = 0;
+  for (const NodeDef& node : output.node()) {
+    EXPECT_NE(node.name(), "bias_add");
+    EXPECT_NE(node.name(), "relu");
+    EXPECT_NE(node.name(), "noise_shape");
+    EXPECT_NE(node.name(), "dropout_grad");
+    if (node.name() == "dropout") {
+      EXPECT_EQ(node.op(), "_FusedBiasActivationDropout");
+      EXPECT_EQ(node.attr().at("activation").s(), "Relu");
+      ASSERT_EQ(node.input_size(), 5);
+      EXPECT_EQ(node.input(0), "value");
+      EXPECT_EQ(node.input(1), "bias");
+      EXPECT_EQ(node.input(2), "rate");
+      EXPECT_EQ(node.input(3), "seed");
+      EXPECT_EQ(node.input(4), "seed");
+      found++;
+    }
+    if (node.name() == "relu_grad") {
+      EXPECT_EQ(node.op(), "_FusedBiasActivationDropoutGrad");
+      ASSERT_EQ(node.input_size(), 4);
+      EXPECT_EQ(node.input(0), "grad");
+      EXPECT_EQ(node.input(1), "dropout");
+      EXPECT_EQ(node.input(2), "rate");
+      EXPECT_EQ(node.input(3), "dropout:1");
+      found++;
+    }
+    if (node.name() == "bias_add_grad") {
+      EXPECT_EQ(node.op(), "Identity");
+      ASSERT_EQ(node.input_size(), 1);
+      EXPECT_EQ(node.input(0), "relu_grad:1");
+      found++;
+    }
+  }
+  EXPECT_EQ(found, 3);
+}
+
+TEST_F(RemapperTest, FuseElementwiseChain) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope().WithDevice(
+      "/device:GPU:0");
+  auto placeholder = [&s](const string& name) {
+    return ops::Placeholder(s.WithOpName(name), DT_FLOAT,
+                            ops::Placeholder::Shape({4, 8}));
+  };
+  auto x = placeholder("x");
+  auto scale = placeholder("scale");
+  auto offset = placeholder("offset");
+  auto mul = ops::Mul(s.WithOpName("mul"), x, scale);
+  // The chain goes through the second operand of the commutative ops.
+  auto add = ops::AddV2(s.WithOpName("add"), offset, mul);
+  auto relu = ops::Relu(s.WithOpName("relu"), add);
+  auto fetch = ops::Identity(s.WithOpName("fetch"), relu);
+
+  GrapplerItem item;
+  item.fetch = {"fetch"};
+  TF_ASSERT_OK(s.ToGraphDef(&item.graph));
+
+  Remapper optimizer(RewriterConfig::ON);
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  int found = 0;
+  for (const NodeDef& node : output.node()) {
+    EXPECT_NE(node.name(), "mul");
+    EXPECT_NE(node.name(), "add");
+    if (node.name() == "relu") {
+      EXPECT_EQ(node.op(), "_FusedElementwise");
+      EXPECT_EQ(node.attr().at("T").type(), DT_FLOAT);
+      EXPECT_EQ(node.attr().at("N").i(), 3);
+      const auto& fused_ops = node.attr().at("fused_ops").list().s();
+      ASSERT_EQ(fused_ops.size(), 3);
+      EXPECT_EQ(fused_ops[0], "Mul");
+      EXPECT_EQ(fused_ops[1], "AddV2");
+      EXPECT_EQ(fused_ops[2], "Relu");
+      ASSERT_EQ(node.input_size(), 3);
+      EXPECT_EQ(node.input(0), "x");
+      EXPECT_EQ(node.input(1), "scale");
+      EXPECT_EQ(node.input(2), "offset");
+      found++;
+    }
+  }
+  EXPECT_EQ(found, 1);
+}
+
 class RemapperFuseMatMulWithBiasTest : public RemapperTest {
  public:
   template <DataType DTYPE>
@@ -891,7 +891,7 @@ class UnaryElementwiseRewriter : public ScopedAllocatorOptimizer::Rewriter {
 
 ScopedAllocatorOptimizer::ScopedAllocatorOptimizer(
     RewriterConfig::Toggle opt_level, const ScopedAllocatorOptions& opts)
-    : opt_level_(opt_level) {
+    : opt_level_(opt_level), max_group_bytes_(opts.max_group_bytes()) {
   VLOG(1) << "ScopedAllocatorOptimizer::ScopedAllocatorOptimizer";
   Rewriter* r = new UnaryElementwiseRewriter();
   to_delete_.push_back(r);
@@ -1124,7 +1124,8 @@ Status ScopedAllocatorOptimizer::ProcessGraphDef(
         // in the same Tree struct.  Split those groups into subgroups that
         // share identical loop nesting.
         status = ApplyToAll(root.get(), [this, rewriter, graph, &frame_view,
-                                         &op_name, invocation_count](Tree* t) {
+                                         &graph_properties, &op_name,
+                                         invocation_count](Tree* t) {
           VLOG(2) << "applied to tree node " << t->edge_ << " at depth "
                   << t->depth_ << " of size " << t->nodes_.size();
           if (t->nodes_.size() > 1) {
@@ -1132,13 +1133,18 @@ Status ScopedAllocatorOptimizer::ProcessGraphDef(
             PartitionByLoopStructure(frame_view, t->nodes_, &loop_groups);
             for (auto& lg : loop_groups) {
               if (lg.size() > 1) {
-                bool applied = false;
                 Status s = OrderNodeSet(&lg);
                 TF_RETURN_IF_ERROR(s);
-                VLOG(1) << "Applying Rewriter for " << op_name;
-                s = rewriter->Rewrite(this, invocation_count, graph, op_name,
-                                      lg, &applied);
-                LOG_WARNING_AND_RETURN_IF_ERROR(s);
+                for (const auto& bucket :
+                     SplitIntoBuckets(graph_properties, lg)) {
+                  if (bucket.size() <= 1) continue;
+                  bool applied = false;
+                  VLOG(1) << "Applying Rewriter for " << op_name
+                          << " to a bucket of size " << bucket.size();
+                  s = rewriter->Rewrite(this, invocation_count, graph, op_name,
+                                        bucket, &applied);
+                  LOG_WARNING_AND_RETURN_IF_ERROR(s);
+                }
               }
             }
           }
@@ -1207,6 +1213,36 @@ Status ScopedAllocatorOptimizer::OrderNodeSet(
   return OkStatus();
 }
 
+std::vector<std::vector<NodeDef*>> ScopedAllocatorOptimizer::SplitIntoBuckets(
+    const GraphProperties& graph_properties,
+    const std::vector<NodeDef*>& nodes) const {
+  std::vector<std::vector<NodeDef*>> buckets;
+  if (max_group_bytes_ <= 0) {
+    buckets.push_back(nodes);
+    return buckets;
+  }
+  int64_t bucket_bytes = 0;
+  for (NodeDef* node : nodes) {
+    // Nodes whose input size is unknown are not rewritten, so they do not
+    // count towards the bucket size.
+    int64_t bytes = 0;
+    const std::vector<OpInfo::TensorProperties>& inputs =
+        graph_properties.GetInputProperties(node->name());
+    if (!inputs.empty() && !inputs[0].shape().unknown_rank() &&
+        TensorShape::IsValid(inputs[0].shape())) {
+      bytes = TensorShape(inputs[0].shape()).num_elements() *
+              DataTypeSize(inputs[0].dtype());
+    }
+    if (buckets.empty() || bucket_bytes + bytes > max_group_bytes_) {
+      buckets.emplace_back();
+      bucket_bytes = 0;
+    }
+    buckets.back().push_back(node);
+    bucket_bytes += bytes;
+  }
+  return buckets;
+}
+
 }  // namespace grappler
 }  // namespace tensorflow
 
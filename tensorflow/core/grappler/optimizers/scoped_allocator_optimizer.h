@@ -107,7 +107,16 @@ class ScopedAllocatorOptimizer : public GraphOptimizer {
 
   Status OrderNodeSet(std::vector<NodeDef*>* nodes) const;
 
+  // Splits the ordered `nodes` into consecutive buckets of at most
+  // `max_group_bytes_` input bytes, or returns a single bucket if bucketing is
+  // disabled.
+  std::vector<std::vector<NodeDef*>> SplitIntoBuckets(
+      const GraphProperties& graph_properties,
+      const std::vector<NodeDef*>& nodes) const;
+
   RewriterConfig::Toggle opt_level_;
+  // ScopedAllocatorOptions::max_group_bytes.
+  int64_t max_group_bytes_;
   std::unordered_set<string> nodes_to_preserve_;
   OpNameSet op_name_set_;
   absl::flat_hash_map<string, Rewriter*> rewriters_;
@@ -414,6 +414,30 @@ TEST_F(ScopedAllocatorOptimizerTest, UnaryRewriteOnly) {
   }
 }
 
+TEST_F(ScopedAllocatorOptimizerTest, MaxGroupBytes) {
+  // Tests that ops whose inputs do not fit together in `max_group_bytes` are
+  // not rewritten to share a ScopedAllocator.
+  for (int64_t max_group_bytes : {16, 32}) {
+    GrapplerItem item;
+    BuildAbsGraph(&item.graph, false);
+    SetShapes(&item.graph);
+
+    ScopedAllocatorOptions opts;
+    opts.add_enable_op("Abs");
+    opts.set_max_group_bytes(max_group_bytes);
+    ScopedAllocatorOptimizer sao(RewriterConfig::ON, opts);
+
+    GraphDef optimized_graph;
+    TF_ASSERT_OK(sao.Optimize(nullptr /*cluster*/, item, &optimized_graph));
+
+    // Each Abs input is a 2x2 float tensor, i.e. 16 bytes.
+    NodeMap node_map(&optimized_graph);
+    EXPECT_EQ(max_group_bytes >= 32,
+              node_map.GetNode("scoped_allocator_1_1") != nullptr)
+        << "max_group_bytes=" << max_group_bytes;
+  }
+}
+
 TEST_F(ScopedAllocatorOptimizerTest, UnaryExecute) {
   // Builds the same graph as UnaryRewriteOnly but also executes it and
   // validates the output.
@@ -22,9 +22,11 @@ limitations under the License.
 #include <memory>
 #include <random>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "absl/types/optional.h"
+#include "tensorflow/core/kernels/batching_util/batch_latency_slo_tuner.h"
 #include "tensorflow/core/kernels/batching_util/batch_scheduler.h"
 #include "tensorflow/core/kernels/batching_util/periodic_function.h"
 #include "tensorflow/core/lib/core/errors.h"
@@ -171,6 +173,15 @@ class AdaptiveSharedBatchScheduler
 
     // If true, the padding will not be appended.
     bool disable_padding = false;
+
+    // If positive, the queue picks the size at which batches are closed (up
+    // to max_batch_size) and the batch timeout itself, from the processing
+    // times it measures, so that `latency_slo_percentile` percent of the tasks
+    // are processed within this target (see batch_latency_slo_tuner.h).
+    // max_batch_size and batch_timeout_micros are used until enough batches
+    // have been processed.
+    int64_t latency_slo_micros = 0;
+    double latency_slo_percentile = 99;
   };
 
   using BatchProcessor = std::function<void(std::unique_ptr<Batch<TaskType>>)>;
@@ -299,8 +310,10 @@ class ASBSQueue : public BatchScheduler<TaskType> {
   using QueueOptions =
       typename AdaptiveSharedBatchScheduler<TaskType>::QueueOptions;
 
+  // `slo_tuner` is null unless options.latency_slo_micros is set.
   ASBSQueue(std::shared_ptr<AdaptiveSharedBatchScheduler<TaskType>> scheduler,
-            const QueueOptions& options);
+            const QueueOptions& options,
+            std::shared_ptr<BatchLatencySloTuner> slo_tuner);
 
   ~ASBSQueue() override;
 
@@ -331,6 +344,7 @@ class ASBSQueue : public BatchScheduler<TaskType> {
 
   std::shared_ptr<AdaptiveSharedBatchScheduler<TaskType>> scheduler_;
   const QueueOptions options_;
+  const std::shared_ptr<BatchLatencySloTuner> slo_tuner_;
   // Owned by scheduler_.
   ASBSBatch<TaskType>* current_batch_ TF_GUARDED_BY(mu_) = nullptr;
   int64_t num_enqueued_batches_ TF_GUARDED_BY(mu_) = 0;
@@ -344,11 +358,13 @@ template <typename TaskType>
 class ASBSBatch : public Batch<TaskType> {
  public:
   ASBSBatch(ASBSQueue<TaskType>* queue, int64_t creation_time_micros,
-            int64_t batch_timeout_micros, uint64 traceme_context_id)
+            int64_t batch_timeout_micros, uint64 traceme_context_id,
+            std::shared_ptr<BatchLatencySloTuner> slo_tuner = nullptr)
       : queue_(queue),
         creation_time_micros_(creation_time_micros),
         schedulable_time_micros_(creation_time_micros + batch_timeout_micros),
-        traceme_context_id_(traceme_context_id) {}
+        traceme_context_id_(traceme_context_id),
+        slo_tuner_(std::move(slo_tuner)) {}
 
   ~ASBSBatch() override {}
 
@@ -360,11 +376,18 @@ class ASBSBatch : public Batch<TaskType> {
 
   uint64 traceme_context_id() const { return traceme_context_id_; }
 
+  // The tuner of the queue, which outlives the queue while the batch is
+  // processed.
+  const std::shared_ptr<BatchLatencySloTuner>& slo_tuner() const {
+    return slo_tuner_;
+  }
+
  private:
   ASBSQueue<TaskType>* queue_;
   const int64_t creation_time_micros_;
   const int64_t schedulable_time_micros_;
   const uint64 traceme_context_id_;
+  const std::shared_ptr<BatchLatencySloTuner> slo_tuner_;
   TF_DISALLOW_COPY_AND_ASSIGN(ASBSBatch);
 };
 }  // namespace internal
@@ -455,6 +478,10 @@ Status AdaptiveSharedBatchScheduler<TaskType>::AddQueue(
         "max_enqueued_batches must be positive; was ",
         options.max_enqueued_batches);
   }
+  if (options.latency_slo_micros < 0) {
+    return errors::InvalidArgument("latency_slo_micros can't be negative; was ",
+                                   options.latency_slo_micros);
+  }
   if (options.max_input_task_size.has_value()) {
     if (options.max_input_task_size.value() < options.max_batch_size) {
       return errors::InvalidArgument(
@@ -464,9 +491,19 @@ Status AdaptiveSharedBatchScheduler<TaskType>::AddQueue(
           options.max_batch_size);
     }
   }
+  std::unique_ptr<BatchLatencySloTuner> slo_tuner;
+  if (options.latency_slo_micros != 0) {
+    BatchLatencySloTuner::Options tuner_options;
+    tuner_options.latency_slo_micros = options.latency_slo_micros;
+    tuner_options.latency_slo_percentile = options.latency_slo_percentile;
+    tuner_options.max_batch_size = options.max_batch_size;
+    tuner_options.initial_batch_size = options.max_batch_size;
+    tuner_options.initial_batch_timeout_micros = options.batch_timeout_micros;
+    TF_RETURN_IF_ERROR(BatchLatencySloTuner::Create(tuner_options, &slo_tuner));
+  }
   internal::ASBSQueue<TaskType>* asbs_queue_raw;
   queue->reset(asbs_queue_raw = new internal::ASBSQueue<TaskType>(
-                   this->shared_from_this(), options));
+                   this->shared_from_this(), options, std::move(slo_tuner)));
   mutex_lock l(mu_);
   queues_and_callbacks_[asbs_queue_raw] = process_batch_callback;
   return OkStatus();
@@ -639,9 +676,17 @@ void AdaptiveSharedBatchScheduler<TaskType>::CallbackWrapper(
       profiler::ContextType::kAdaptiveSharedBatchScheduler,
       batch->traceme_context_id());
   const int64_t start_time = batch->creation_time_micros();
+  // The callback takes ownership of the batch.
+  const std::shared_ptr<BatchLatencySloTuner> slo_tuner = batch->slo_tuner();
+  const int64_t batch_size = batch->size();
+  const int64_t processing_start_time = GetEnv()->NowMicros();
   callback(std::unique_ptr<Batch<TaskType>>(
       const_cast<internal::ASBSBatch<TaskType>*>(batch)));
   int64_t end_time = GetEnv()->NowMicros();
+  if (slo_tuner != nullptr) {
+    slo_tuner->RecordBatch(batch_size, end_time - processing_start_time,
+                           end_time);
+  }
   mutex_lock l(mu_);
   if (is_express) {
     in_flight_express_batches_--;
@@ -706,8 +751,11 @@ namespace internal {
 template <typename TaskType>
 ASBSQueue<TaskType>::ASBSQueue(
     std::shared_ptr<AdaptiveSharedBatchScheduler<TaskType>> scheduler,
-    const QueueOptions& options)
-    : scheduler_(scheduler), options_(options) {}
+    const QueueOptions& options,
+    std::shared_ptr<BatchLatencySloTuner> slo_tuner)
+    : scheduler_(scheduler),
+      options_(options),
+      slo_tuner_(std::move(slo_tuner)) {}
 
 template <typename TaskType>
 ASBSQueue<TaskType>::~ASBSQueue() {
@@ -741,6 +789,13 @@ Status ASBSQueue<TaskType>::Schedule(std::unique_ptr<TaskType>* task) {
                                    options_.max_input_task_size.value());
   }
 
+  // The size at which batches are closed, and their timeout.
+  const int max_batch_size = slo_tuner_ != nullptr ? slo_tuner_->batch_size()
+                                                   : options_.max_batch_size;
+  const int64_t batch_timeout_micros = slo_tuner_ != nullptr
+                                           ? slo_tuner_->batch_timeout_micros()
+                                           : options_.batch_timeout_micros;
+
   std::vector<std::unique_ptr<TaskType>> tasks_to_schedule;
   std::vector<ASBSBatch<TaskType>*> new_batches;
   bool closed_batch = false;
@@ -749,11 +804,21 @@ Status ASBSQueue<TaskType>::Schedule(std::unique_ptr<TaskType>* task) {
     if (size > SchedulingCapacityLocked()) {
       return errors::Unavailable("The batch scheduling queue is full");
     }
+    if (slo_tuner_ != nullptr) {
+      slo_tuner_->RecordTask(size);
+      // The batch size may have been lowered since the current batch was
+      // created.
+      if (current_batch_ && current_batch_->size() >= max_batch_size) {
+        current_batch_->Close();
+        closed_batch = true;
+        current_batch_ = nullptr;
+      }
+    }
 
     int remaining_batch_size =
         current_batch_ == nullptr
-            ? options_.max_batch_size
-            : options_.max_batch_size - current_batch_->size();
+            ? max_batch_size
+            : max_batch_size - current_batch_->size();
     if (options_.split_input_task_func == nullptr ||
         size <= remaining_batch_size) {
       // Either we don't allow task splitting or task fits within the current
@@ -764,13 +829,12 @@ Status ASBSQueue<TaskType>::Schedule(std::unique_ptr<TaskType>* task) {
       // Beyond this point Schedule should not fail, as the caller has been
       // promised that all of the split tasks will be scheduled.
       TF_RETURN_IF_ERROR(options_.split_input_task_func(
-          task, remaining_batch_size, options_.max_batch_size,
-          &tasks_to_schedule));
+          task, remaining_batch_size, max_batch_size, &tasks_to_schedule));
     }
     for (auto& task : tasks_to_schedule) {
       // Can't fit within current batch, close it off and try to create another.
       if (current_batch_ &&
-          current_batch_->size() + task->size() > options_.max_batch_size) {
+          current_batch_->size() + task->size() > max_batch_size) {
         current_batch_->Close();
         closed_batch = true;
         current_batch_ = nullptr;
@@ -782,8 +846,8 @@ Status ASBSQueue<TaskType>::Schedule(std::unique_ptr<TaskType>* task) {
         // When multiple calls to "ASBS::Schedule" accumulate to one batch, they
         // are processed in the same batch and should share traceme_context_id.
         current_batch_ = new ASBSBatch<TaskType>(
-            this, scheduler_->GetEnv()->NowMicros(),
-            options_.batch_timeout_micros, NewTraceMeContextIdForBatch());
+            this, scheduler_->GetEnv()->NowMicros(), batch_timeout_micros,
+            NewTraceMeContextIdForBatch(), slo_tuner_);
         new_batches.push_back(current_batch_);
       }
 
@@ -803,8 +867,7 @@ Status ASBSQueue<TaskType>::Schedule(std::unique_ptr<TaskType>* task) {
       bool reached_max_tasks =
           (options_.max_tasks_per_batch.has_value() &&
            current_batch_->num_tasks() >= options_.max_tasks_per_batch.value());
-      if (current_batch_->size() == options_.max_batch_size ||
-          reached_max_tasks) {
+      if (current_batch_->size() >= max_batch_size || reached_max_tasks) {
         current_batch_->Close();
         closed_batch = true;
         current_batch_ = nullptr;
@@ -0,0 +1,179 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/kernels/batching_util/batch_latency_slo_tuner.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/logging.h"
+
+namespace tensorflow {
+namespace serving {
+
+Status BatchLatencySloTuner::Create(
+    const Options& options, std::unique_ptr<BatchLatencySloTuner>* tuner) {
+  if (options.latency_slo_micros <= 0) {
+    return errors::InvalidArgument("latency_slo_micros must be positive; was ",
+                                   options.latency_slo_micros);
+  }
+  if (options.latency_slo_percentile <= 0 ||
+      options.latency_slo_percentile > 100) {
+    return errors::InvalidArgument(
+        "latency_slo_percentile must be in (0, 100]; was ",
+        options.latency_slo_percentile);
+  }
+  if (options.max_batch_size <= 0) {
+    return errors::InvalidArgument("max_batch_size must be positive; was ",
+                                   options.max_batch_size);
+  }
+  if (options.initial_batch_size <= 0 ||
+      options.initial_batch_size > options.max_batch_size) {
+    return errors::InvalidArgument(
+        "initial_batch_size must be in [1, max_batch_size]; was ",
+        options.initial_batch_size);
+  }
+  if (options.initial_batch_timeout_micros < 0) {
+    return errors::InvalidArgument(
+        "initial_batch_timeout_micros can't be negative; was ",
+        options.initial_batch_timeout_micros);
+  }
+  if (options.num_samples_per_bucket <= 0 ||
+      options.num_batches_per_adjustment <= 0) {
+    return errors::InvalidArgument(
+        "num_samples_per_bucket and num_batches_per_adjustment must be "
+        "positive; were ",
+        options.num_samples_per_bucket, " and ",
+        options.num_batches_per_adjustment);
+  }
+  tuner->reset(new BatchLatencySloTuner(options));
+  return OkStatus();
+}
+
+BatchLatencySloTuner::BatchLatencySloTuner(const Options& options)
+    : options_(options),
+      batch_size_(options.initial_batch_size),
+      batch_timeout_micros_(options.initial_batch_timeout_micros) {
+  for (int64_t size = 1; size < options.max_batch_size; size *= 2) {
+    bucket_sizes_.push_back(size);
+  }
+  bucket_sizes_.push_back(options.max_batch_size);
+  processing_micros_.resize(bucket_sizes_.size());
+}
+
+int BatchLatencySloTuner::BucketIndex(int64_t batch_size) const {
+  auto it =
+      std::lower_bound(bucket_sizes_.begin(), bucket_sizes_.end(), batch_size);
+  if (it == bucket_sizes_.end()) --it;
+  return it - bucket_sizes_.begin();
+}
+
+int64_t BatchLatencySloTuner::ProcessingTimePercentile(
+    const std::deque<int64_t>& bucket) const {
+  std::vector<int64_t> samples(bucket.begin(), bucket.end());
+  const size_t index = std::min(
+      samples.size() - 1,
+      static_cast<size_t>(std::ceil(options_.latency_slo_percentile / 100 *
+                                    samples.size())) -
+          1);
+  std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+  return samples[index];
+}
+
+void BatchLatencySloTuner::RecordTask(int64_t size) {
+  mutex_lock l(mu_);
+  num_arrived_ += size;
+}
+
+void BatchLatencySloTuner::RecordBatch(int64_t batch_size,
+                                       int64_t processing_micros,
+                                       int64_t now_micros) {
+  mutex_lock l(mu_);
+  std::deque<int64_t>& bucket = processing_micros_[BucketIndex(batch_size)];
+  bucket.push_back(processing_micros);
+  if (bucket.size() > static_cast<size_t>(options_.num_samples_per_bucket)) {
+    bucket.pop_front();
+  }
+  if (last_adjustment_micros_ < 0) {
+    // The arrival rate is measured from the first processed batch on.
+    last_adjustment_micros_ = now_micros;
+    num_arrived_ = 0;
+    return;
+  }
+  if (++num_batches_since_adjustment_ >= options_.num_batches_per_adjustment &&
+      now_micros > last_adjustment_micros_) {
+    Adjust(now_micros);
+  }
+}
+
+void BatchLatencySloTuner::Adjust(int64_t now_micros) {
+  // Tasks (of size 1) per microsecond.
+  const double arrival_rate = static_cast<double>(num_arrived_) /
+                              (now_micros - last_adjustment_micros_);
+  num_arrived_ = 0;
+  num_batches_since_adjustment_ = 0;
+  last_adjustment_micros_ = now_micros;
+
+  int best_size = -1;
+  int64_t best_timeout_micros = 0;
+  double best_expected_size = -1;
+  auto consider = [&](int size, int64_t processing_micros) {
+    const int64_t timeout_micros =
+        options_.latency_slo_micros - processing_micros;
+    if (timeout_micros < 0) return;
+    const double expected_size =
+        std::min<double>(size, arrival_rate * timeout_micros);
+    if (expected_size > best_expected_size) {
+      best_size = size;
+      best_timeout_micros = timeout_micros;
+      best_expected_size = expected_size;
+    }
+  };
+
+  int smallest_measured = -1;
+  int largest_measured = -1;
+  int64_t largest_measured_micros = 0;
+  for (int i = 0; i < static_cast<int>(bucket_sizes_.size()); ++i) {
+    if (processing_micros_[i].empty()) continue;
+    const int64_t processing_micros =
+        ProcessingTimePercentile(processing_micros_[i]);
+    consider(bucket_sizes_[i], processing_micros);
+    if (smallest_measured < 0) smallest_measured = i;
+    largest_measured = i;
+    largest_measured_micros = processing_micros;
+  }
+  if (largest_measured < 0) return;
+  if (largest_measured + 1 < static_cast<int>(bucket_sizes_.size())) {
+    const int next_size = bucket_sizes_[largest_measured + 1];
+    consider(next_size, largest_measured_micros * next_size /
+                            bucket_sizes_[largest_measured]);
+  }
+
+  if (best_size < 0) {
+    // The target can't be met: minimize the latency.
+    best_size = bucket_sizes_[smallest_measured];
+    best_timeout_micros = 0;
+  }
+  VLOG(2) << "Arrival rate: " << arrival_rate * 1e6
+          << " tasks/s, picked batch size " << best_size
+          << " and batch timeout " << best_timeout_micros << "us";
+  batch_size_.store(best_size, std::memory_order_relaxed);
+  batch_timeout_micros_.store(best_timeout_micros, std::memory_order_relaxed);
+}
+
+}  // namespace serving
+}  // namespace tensorflow
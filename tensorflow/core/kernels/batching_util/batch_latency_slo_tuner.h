@@ -0,0 +1,126 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_KERNELS_BATCHING_UTIL_BATCH_LATENCY_SLO_TUNER_H_
+#define TENSORFLOW_CORE_KERNELS_BATCHING_UTIL_BATCH_LATENCY_SLO_TUNER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+namespace serving {
+
+// Picks the batch size and the batch timeout of a batching queue so that the
+// latency of its tasks stays within a target, instead of relying on a
+// hand-tuned batch_timeout_micros.
+//
+// The tuner measures the processing time of the batches per batch size
+// bucket (powers of two up to the maximum batch size), as well as the rate at
+// which tasks arrive. Periodically, for every bucket it knows the processing
+// time of, it computes the time a batch of that size can wait for more tasks
+// without exceeding the target: the target minus the requested percentile of
+// the processing time. It then picks the bucket which is expected to form the
+// largest batches given the arrival rate, i.e. which maximizes
+//   min(bucket size, arrival rate * allowed waiting time),
+// and uses the bucket size as the size at which batches are closed and the
+// allowed waiting time as the batch timeout. The next larger bucket is
+// considered too, with a processing time extrapolated linearly from the
+// largest measured one, so that the tuner grows the batches when traffic
+// increases.
+//
+// Only the waiting and processing times of a batch are modeled: the time
+// spent waiting for a batch thread once the batch is schedulable isn't, so the
+// target should leave some headroom for it.
+//
+// This class is thread-safe.
+class BatchLatencySloTuner {
+ public:
+  struct Options {
+    // Target latency of the tasks.
+    int64_t latency_slo_micros = 0;
+    // Percentile of the processing time that must fit within the target.
+    double latency_slo_percentile = 99;
+    // Largest batch size that can be picked.
+    int max_batch_size = 0;
+    // Batch size and timeout used until enough batches have been measured.
+    int initial_batch_size = 0;
+    int64_t initial_batch_timeout_micros = 0;
+    // Number of most recent processing times kept per batch size bucket.
+    int num_samples_per_bucket = 100;
+    // Number of processed batches between two adjustments.
+    int num_batches_per_adjustment = 32;
+  };
+
+  static Status Create(const Options& options,
+                       std::unique_ptr<BatchLatencySloTuner>* tuner);
+
+  // Records that a task of `size` was scheduled.
+  void RecordTask(int64_t size);
+
+  // Records that a batch of `batch_size` took `processing_micros` to process,
+  // and adjusts the batch size and timeout every num_batches_per_adjustment
+  // batches.
+  void RecordBatch(int64_t batch_size, int64_t processing_micros,
+                   int64_t now_micros);
+
+  // The size at which batches should be closed.
+  int batch_size() const { return batch_size_.load(std::memory_order_relaxed); }
+
+  // How long non-full batches should wait before becoming schedulable.
+  int64_t batch_timeout_micros() const {
+    return batch_timeout_micros_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  explicit BatchLatencySloTuner(const Options& options);
+
+  // Returns the index of the smallest bucket holding `batch_size`.
+  int BucketIndex(int64_t batch_size) const;
+
+  // Returns the latency_slo_percentile percentile of the processing times of
+  // `bucket`, which must not be empty.
+  int64_t ProcessingTimePercentile(const std::deque<int64_t>& bucket) const;
+
+  void Adjust(int64_t now_micros) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  const Options options_;
+
+  // Upper bounds of the batch size buckets, in increasing order.
+  std::vector<int> bucket_sizes_;
+
+  std::atomic<int> batch_size_;
+  std::atomic<int64_t> batch_timeout_micros_;
+
+  mutex mu_;
+  // The most recent processing times, per bucket.
+  std::vector<std::deque<int64_t>> processing_micros_ TF_GUARDED_BY(mu_);
+  // Total size of the tasks scheduled since the last adjustment.
+  int64_t num_arrived_ TF_GUARDED_BY(mu_) = 0;
+  int64_t num_batches_since_adjustment_ TF_GUARDED_BY(mu_) = 0;
+  // Time of the last adjustment, or -1 until the first batch is recorded.
+  int64_t last_adjustment_micros_ TF_GUARDED_BY(mu_) = -1;
+};
+
+}  // namespace serving
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_BATCHING_UTIL_BATCH_LATENCY_SLO_TUNER_H_
@@ -0,0 +1,147 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/kernels/batching_util/batch_latency_slo_tuner.h"
+
+#include <memory>
+
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace serving {
+namespace {
+
+std::unique_ptr<BatchLatencySloTuner> CreateTuner() {
+  BatchLatencySloTuner::Options options;
+  options.latency_slo_micros = 10000;
+  options.max_batch_size = 8;
+  options.initial_batch_size = 8;
+  options.initial_batch_timeout_micros = 100;
+  options.num_batches_per_adjustment = 4;
+  std::unique_ptr<BatchLatencySloTuner> tuner;
+  TF_CHECK_OK(BatchLatencySloTuner::Create(options, &tuner));
+  return tuner;
+}
+
+TEST(BatchLatencySloTunerTest, InitialValues) {
+  std::unique_ptr<BatchLatencySloTuner> tuner = CreateTuner();
+  EXPECT_EQ(tuner->batch_size(), 8);
+  EXPECT_EQ(tuner->batch_timeout_micros(), 100);
+}
+
+TEST(BatchLatencySloTunerTest, HighTrafficPicksLargestBatchWithinTarget) {
+  std::unique_ptr<BatchLatencySloTuner> tuner = CreateTuner();
+  tuner->RecordBatch(1, 1000, /*now_micros=*/0);
+  // One task per microsecond.
+  tuner->RecordTask(1000);
+  tuner->RecordBatch(2, 2000, 100);
+  tuner->RecordBatch(4, 4000, 200);
+  // Batches of 8 take longer than the target.
+  tuner->RecordBatch(8, 12000, 300);
+  EXPECT_EQ(tuner->batch_size(), 8);
+  tuner->RecordBatch(1, 1000, 1000);
+
+  EXPECT_EQ(tuner->batch_size(), 4);
+  EXPECT_EQ(tuner->batch_timeout_micros(), 6000);
+}
+
+TEST(BatchLatencySloTunerTest, LowTrafficWaitsLongerForSmallerBatches) {
+  std::unique_ptr<BatchLatencySloTuner> tuner = CreateTuner();
+  tuner->RecordBatch(1, 1000, /*now_micros=*/0);
+  // 2 tasks per 10ms: a batch of 2 can wait 8ms and is expected to hold 1.6
+  // tasks, while a batch of 4 can only wait 6ms, i.e. 1.2 tasks.
+  tuner->RecordTask(2);
+  tuner->RecordBatch(2, 2000, 1000);
+  tuner->RecordBatch(4, 4000, 2000);
+  tuner->RecordBatch(8, 8000, 3000);
+  tuner->RecordBatch(1, 1000, 10000);
+
+  EXPECT_EQ(tuner->batch_size(), 2);
+  EXPECT_EQ(tuner->batch_timeout_micros(), 8000);
+}
+
+TEST(BatchLatencySloTunerTest, ExploresLargerBatches) {
+  std::unique_ptr<BatchLatencySloTuner> tuner = CreateTuner();
+  tuner->RecordBatch(1, 1000, /*now_micros=*/0);
+  tuner->RecordTask(1000);
+  tuner->RecordBatch(2, 2000, 100);
+  tuner->RecordBatch(1, 1000, 200);
+  tuner->RecordBatch(2, 2000, 300);
+  tuner->RecordBatch(1, 1000, 1000);
+
+  // Batches of 4 are expected to take 4ms.
+  EXPECT_EQ(tuner->batch_size(), 4);
+  EXPECT_EQ(tuner->batch_timeout_micros(), 6000);
+}
+
+TEST(BatchLatencySloTunerTest, UnreachableTargetMinimizesLatency) {
+  std::unique_ptr<BatchLatencySloTuner> tuner = CreateTuner();
+  tuner->RecordBatch(2, 20000, /*now_micros=*/0);
+  tuner->RecordTask(1000);
+  for (int i = 1; i <= 4; ++i) {
+    tuner->RecordBatch(4, 40000, i * 1000);
+  }
+
+  EXPECT_EQ(tuner->batch_size(), 2);
+  EXPECT_EQ(tuner->batch_timeout_micros(), 0);
+}
+
+TEST(BatchLatencySloTunerTest, UsesPercentileOfProcessingTimes) {
+  BatchLatencySloTuner::Options options;
+  options.latency_slo_micros = 10000;
+  options.max_batch_size = 8;
+  options.initial_batch_size = 8;
+  options.num_batches_per_adjustment = 100;
+  std::unique_ptr<BatchLatencySloTuner> tuner;
+  TF_ASSERT_OK(BatchLatencySloTuner::Create(options, &tuner));
+
+  tuner->RecordBatch(8, 1000, /*now_micros=*/0);
+  tuner->RecordTask(100000);
+  // The 99th percentile of the processing time of batches of 8 is above the
+  // target, even though their average is well below it.
+  for (int i = 1; i <= 97; ++i) {
+    tuner->RecordBatch(8, 1000, i);
+  }
+  tuner->RecordBatch(8, 20000, 98);
+  tuner->RecordBatch(8, 20000, 99);
+  EXPECT_EQ(tuner->batch_size(), 8);
+  tuner->RecordBatch(4, 1000, 1000);
+
+  EXPECT_EQ(tuner->batch_size(), 4);
+  EXPECT_EQ(tuner->batch_timeout_micros(), 9000);
+}
+
+TEST(BatchLatencySloTunerTest, InvalidOptions) {
+  BatchLatencySloTuner::Options options;
+  options.max_batch_size = 8;
+  options.initial_batch_size = 8;
+  std::unique_ptr<BatchLatencySloTuner> tuner;
+  EXPECT_FALSE(BatchLatencySloTuner::Create(options, &tuner).ok());
+
+  options.latency_slo_micros = 1000;
+  TF_EXPECT_OK(BatchLatencySloTuner::Create(options, &tuner));
+
+  options.latency_slo_percentile = 0;
+  EXPECT_FALSE(BatchLatencySloTuner::Create(options, &tuner).ok());
+  options.latency_slo_percentile = 99;
+
+  options.initial_batch_size = 16;
+  EXPECT_FALSE(BatchLatencySloTuner::Create(options, &tuner).ok());
+}
+
+}  // namespace
+}  // namespace serving
+}  // namespace tensorflow
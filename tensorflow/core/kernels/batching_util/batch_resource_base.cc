@@ -224,6 +224,33 @@ const string& GetModelName(OpKernelContext* ctx) {
   return ctx->session_metadata()->name();
 }
 
+// Splits `tensor` along its 0th dimension. The splits are slices sharing the
+// buffer of `tensor` when they are all aligned, which avoids copying large
+// batched outputs. Otherwise, they are copies.
+Status SplitOutputTensor(const Tensor& tensor,
+                         const std::vector<int64_t>& sizes,
+                         std::vector<Tensor>* splits) {
+  if (DataTypeCanUseMemcpy(tensor.dtype())) {
+    std::vector<Tensor> slices;
+    slices.reserve(sizes.size());
+    bool aligned = true;
+    int64_t start = 0;
+    for (int64_t size : sizes) {
+      slices.push_back(tensor.Slice(start, start + size));
+      if (!slices.back().IsAligned()) {
+        aligned = false;
+        break;
+      }
+      start += size;
+    }
+    if (aligned && start == tensor.dim_size(0)) {
+      *splits = std::move(slices);
+      return OkStatus();
+    }
+  }
+  return tensor::Split(tensor, sizes, splits);
+}
+
 }  // namespace
 
 std::unique_ptr<BatchResourceBase::BatchTask>
@@ -485,6 +512,13 @@ Status BatchResourceBase::ConcatInputTensors(
   const int num_inputs = batch.task(0).inputs.size();
   concatenated_tensors->reserve(num_inputs);
 
+  // A single task without padding is already a batch: use its inputs as is
+  // instead of copying them.
+  if (batch.num_tasks() == 1 && (padding_amount == 0 || disable_padding_)) {
+    *concatenated_tensors = batch.task(0).inputs;
+    return OkStatus();
+  }
+
   // Process each input one at a time (the typical case has just one).
   for (int i = 0; i < num_inputs; ++i) {
     // Concatenate the tasks ith input tensors into a big output tensor.
@@ -664,7 +698,7 @@ Status BatchResourceBase::SplitOutputTensors(
     }
 
     std::vector<Tensor> split_tensor;
-    const Status split_status = tensor::Split(
+    const Status split_status = SplitOutputTensor(
         output_tensor, task_sizes_plus_optional_padding, &split_tensor);
     DCHECK(split_status.ok()) << split_status.ToString();
     if (!split_status.ok()) {
@@ -64,6 +64,12 @@ class BatchTask {
   // Returns the size of the task, in terms of how much it contributes to the
   // size of a batch. (A batch's size is the sum of its task sizes.)
   virtual size_t size() const = 0;
+
+  // Returns true iff the task can tolerate more latency than the other tasks,
+  // e.g. because it is part of a bulk job rather than of online traffic.
+  // Schedulers which support priorities may delay such tasks in favor of the
+  // others.
+  virtual bool is_low_priority() const { return false; }
 };
 
 // A thread-safe collection of BatchTasks, to be executed together in some
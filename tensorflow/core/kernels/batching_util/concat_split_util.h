@@ -73,6 +73,12 @@ Status Concat(OpKernelContext* context, const gtl::ArraySlice<Tensor> inputs,
   output_shape.set_dim(0, output_dim0);
   AllocatorAttributes attr;
   attr.set_on_host(true);
+  // When the batch is to be processed on an accelerator, allocate it in pinned
+  // memory, so that copying it to the device is a single asynchronous DMA
+  // instead of going through a staging buffer.
+  if (context->device()->tensorflow_accelerator_device_info() != nullptr) {
+    attr.set_gpu_compatible(true);
+  }
   TF_RETURN_IF_ERROR(context->allocate_temp(DataTypeToEnum<T>::value,
                                             output_shape, output, attr));
   if (output->NumElements() > 0) {
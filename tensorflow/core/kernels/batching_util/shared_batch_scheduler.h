@@ -100,6 +100,13 @@ namespace serving {
 // For bulk processing jobs and throughput-oriented benchmarks, you may want to
 // set the maximum queue size to a large value.
 //
+// When latency sensitive and bulk traffic share a queue, the queue can be
+// configured with `enable_priority_queue`, in which case the low priority tasks
+// (see BatchTask::is_low_priority()) only use the capacity the other tasks
+// leave: they fill the room left in the batches of high priority tasks, and are
+// batched on their own only when the queue has no other batch to schedule.
+// Batches already being processed are never preempted.
+//
 // TODO(b/26539183): Support queue servicing policies other than round-robin.
 // E.g. let each queue specify a "share" (an int >= 1), so e.g. with queues A
 // and B having shares 1 and 2 respectively, the servicing pattern is ABBABB...
@@ -221,6 +228,34 @@ class SharedBatchScheduler
 
     // If true, the padding will not be appended.
     bool disable_padding = false;
+
+    // If true, the low priority tasks (see BatchTask::is_low_priority()) are
+    // kept in a lane of their own instead of being batched in arrival order
+    // with the other tasks:
+    //  - a batch of high priority tasks is scheduled as in a queue without
+    //    priorities, and when it is closed, the room left in it is filled
+    //    with low priority tasks;
+    //  - batches of low priority tasks only are scheduled when the queue has
+    //    no batch of high priority tasks to schedule.
+    //
+    // Must be false if `enable_lazy_split` is true; elsewise errors will be
+    // returned at queue creation time.
+    bool enable_priority_queue = false;
+
+    // The options of the lane of the low priority tasks, used iff
+    // `enable_priority_queue` is true.
+    struct LowPriorityQueueOptions {
+      // Same as `batch_timeout_micros`, for the batches of low priority tasks
+      // only.
+      int64_t batch_timeout_micros = 0;
+
+      // The maximum allowable number of enqueued low priority tasks, in terms
+      // of batches of `max_execution_batch_size`. If this limit is reached,
+      // Schedule() returns an UNAVAILABLE error for low priority tasks. Must
+      // be positive.
+      size_t max_enqueued_batches = 10;
+    };
+    LowPriorityQueueOptions low_priority_queue_options;
   };
   Status AddQueue(const QueueOptions& options,
                   std::function<void(std::unique_ptr<Batch<TaskType>>)>
@@ -325,6 +360,10 @@ class Queue {
   // processed by `Queue<TaskType>::ProcessBatch`
   Status ScheduleWithoutOrEagerSplit(std::unique_ptr<TaskType>* task);
 
+  // Enqueue `task` into the lane of the low priority tasks. Used iff
+  // `QueueOptions.enable_priority_queue` is true.
+  Status ScheduleLowPriorityTask(std::unique_ptr<TaskType>* task);
+
   // Enqueue `task` along with the batch queue metadata.
   // Batches are formed by the time `ScheduleWithLazySplit` returns; and each
   // batch in the deque could evaluate to a batch to be processed after it's
@@ -399,6 +438,15 @@ class Queue {
       std::vector<std::unique_ptr<TaskType>>* output_tasks)
       TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
+  // Moves the oldest low priority tasks into `batch`, as long as they fit
+  // within `max_execution_batch_size_`.
+  void AddLowPriorityTasks(Batch<TaskType>* batch)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Determines whether a batch of the enqueued low priority tasks is currently
+  // schedulable.
+  bool IsLowPriorityBatchSchedulable() const TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
   // Determines whether the open batch residing at the back of 'batches_' is
   // currently schedulable.
   bool IsOpenBatchSchedulable() const TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
@@ -465,6 +513,16 @@ class Queue {
   std::deque<std::unique_ptr<Batch<BatchInputTaskHandle<TaskType>>>>
       task_handle_batches_ TF_GUARDED_BY(mu_);
 
+  // The enqueued low priority tasks, in arrival order, along with the times at
+  // which they were enqueued.
+  //
+  // Used iff `QueueOptions.enable_priority_queue` is true.
+  std::deque<std::pair<uint64, std::unique_ptr<TaskType>>> low_priority_tasks_
+      TF_GUARDED_BY(mu_);
+
+  // The sum of the sizes of the tasks in 'low_priority_tasks_'.
+  size_t low_priority_tasks_size_ TF_GUARDED_BY(mu_) = 0;
+
   // The counter of the TraceMe context ids.
   uint64 traceme_context_id_counter_ TF_GUARDED_BY(mu_) = 0;
 
@@ -606,6 +664,25 @@ Status SharedBatchScheduler<TaskType>::AddQueueAfterRewritingOptions(
         "enable_large_batch_splitting is enabled.");
   }
 
+  if (options.enable_priority_queue) {
+    if (options.enable_lazy_split) {
+      return errors::InvalidArgument(
+          "enable_priority_queue should be enabled only if enable_lazy_split "
+          "is disabled.");
+    }
+    if (options.low_priority_queue_options.batch_timeout_micros < 0) {
+      return errors::InvalidArgument(
+          "low_priority_queue_options.batch_timeout_micros must be "
+          "non-negative; was ",
+          options.low_priority_queue_options.batch_timeout_micros);
+    }
+    if (options.low_priority_queue_options.max_enqueued_batches == 0) {
+      return errors::InvalidArgument(
+          "low_priority_queue_options.max_enqueued_batches must be positive; "
+          "was 0");
+    }
+  }
+
   if (options.enable_large_batch_splitting &&
       (options.input_batch_size_limit < options.max_execution_batch_size)) {
     return errors::InvalidArgument(
@@ -799,12 +876,71 @@ Status Queue<TaskType>::Schedule(std::unique_ptr<TaskType>* task) {
                                    " is larger than maximum input batch size ",
                                    options_.input_batch_size_limit);
   }
+  if (options_.enable_priority_queue && (*task)->is_low_priority()) {
+    return ScheduleLowPriorityTask(task);
+  }
   if (options_.enable_lazy_split) {
     return ScheduleWithLazySplit(std::move(task));
   }
   return ScheduleWithoutOrEagerSplit(std::move(task));
 }
 
+template <typename TaskType>
+Status Queue<TaskType>::ScheduleLowPriorityTask(
+    std::unique_ptr<TaskType>* task) {
+  profiler::TraceMe trace_me([task] {
+    return profiler::TraceMeEncode(
+        "ScheduleLowPriorityTask",
+        {{"batching_input_task_size", (*task)->size()}});
+  });
+
+  bool notify_of_schedulable_batch = false;
+  {
+    mutex_lock l(mu_);
+
+    DCHECK(!closed_);
+
+    const size_t capacity =
+        options_.low_priority_queue_options.max_enqueued_batches *
+        max_execution_batch_size();
+    if (low_priority_tasks_size_ + (*task)->size() > capacity) {
+      return errors::Unavailable(
+          "The low priority tasks of the batch scheduling queue to which this "
+          "task was submitted are full; task size is ",
+          (*task)->size(), " but ", low_priority_tasks_size_,
+          " are already enqueued out of ", capacity);
+    }
+
+    std::vector<std::unique_ptr<TaskType>> output_tasks;
+    if ((*task)->size() > max_execution_batch_size()) {
+      // Only possible with `enable_large_batch_splitting`, since the task size
+      // is otherwise bounded by `input_batch_size_limit`.
+      TF_RETURN_IF_ERROR(options_.split_input_task_func(
+          task, max_execution_batch_size(), max_execution_batch_size(),
+          &output_tasks));
+    } else {
+      output_tasks.push_back(std::move(*task));
+    }
+
+    const uint64 now_micros = env_->NowMicros();
+    for (auto& output_task : output_tasks) {
+      low_priority_tasks_size_ += output_task->size();
+      low_priority_tasks_.emplace_back(now_micros, std::move(output_task));
+    }
+
+    if (!schedulable_batch_ && IsLowPriorityBatchSchedulable()) {
+      schedulable_batch_ = true;
+      notify_of_schedulable_batch = true;
+    }
+  }
+
+  if (notify_of_schedulable_batch) {
+    schedulable_batch_callback_();
+  }
+
+  return OkStatus();
+}
+
 template <typename TaskType>
 Status Queue<TaskType>::ScheduleWithLazySplit(std::unique_ptr<TaskType>* task) {
   profiler::TraceMe trace_me([task] {
@@ -956,7 +1092,7 @@ size_t Queue<TaskType>::NumEnqueuedTasks() const {
   for (const auto& batch : batches_) {
     num_enqueued_tasks += batch->num_tasks();
   }
-  return num_enqueued_tasks;
+  return num_enqueued_tasks + low_priority_tasks_.size();
 }
 
 template <typename TaskType>
@@ -1030,8 +1166,10 @@ Queue<TaskType>::ScheduleBatchWithEagerSplit() {
   {
     mutex_lock l(mu_);
 
-    // Consider closing the open batch at this time, to schedule it.
+    // Consider closing the open batch at this time, to schedule it. Low
+    // priority tasks, if any, fill the room left in it.
     if (batches_.size() == 1 && IsOpenBatchSchedulable()) {
+      AddLowPriorityTasks(batches_.back().get());
       StartNewBatch();
     }
 
@@ -1040,6 +1178,14 @@ Queue<TaskType>::ScheduleBatchWithEagerSplit() {
       ++num_batches_being_processed_;
       batch_to_schedule = std::move(batches_.front());
       batches_.pop_front();
+    } else if (IsLowPriorityBatchSchedulable()) {
+      // No batch of high priority tasks is ready, so the low priority tasks
+      // can use the batch thread.
+      ++num_batches_being_processed_;
+      batch_to_schedule =
+          std::make_unique<Batch<TaskType>>(++traceme_context_id_counter_);
+      AddLowPriorityTasks(batch_to_schedule.get());
+      batch_to_schedule->Close();
     } else {
       schedulable_batch_ = false;
     }
@@ -1131,7 +1277,7 @@ bool Queue<TaskType>::IsEmptyInternal() const {
            task_handle_batches_.back()->empty();
   }
   return num_batches_being_processed_ == 0 && batches_.size() == 1 &&
-         batches_.back()->empty();
+         batches_.back()->empty() && low_priority_tasks_.empty();
 }
 
 template <typename TaskType>
@@ -1157,6 +1303,37 @@ Status Queue<TaskType>::SplitInputBatchIntoSubtasks(
       max_execution_batch_size(), std::move(output_tasks));
 }
 
+template <typename TaskType>
+void Queue<TaskType>::AddLowPriorityTasks(Batch<TaskType>* batch) {
+  while (!low_priority_tasks_.empty() &&
+         batch->size() + low_priority_tasks_.front().second->size() <=
+             max_execution_batch_size()) {
+    std::unique_ptr<TaskType> task =
+        std::move(low_priority_tasks_.front().second);
+    low_priority_tasks_.pop_front();
+    low_priority_tasks_size_ -= task->size();
+    profiler::TraceMeProducer trace_me(
+        [size = task->size()] {
+          return profiler::TraceMeEncode("ScheduleLowPriorityOutputTask",
+                                         {{"size", size}});
+        },
+        profiler::ContextType::kSharedBatchScheduler,
+        batch->traceme_context_id());
+    batch->AddTask(std::move(task));
+  }
+}
+
+template <typename TaskType>
+bool Queue<TaskType>::IsLowPriorityBatchSchedulable() const {
+  if (low_priority_tasks_.empty()) {
+    return false;
+  }
+  return closed_ || low_priority_tasks_size_ >= max_execution_batch_size() ||
+         env_->NowMicros() >=
+             low_priority_tasks_.front().first +
+                 options_.low_priority_queue_options.batch_timeout_micros;
+}
+
 template <typename TaskType>
 bool Queue<TaskType>::IsOpenBatchSchedulableAfterEagerSplit() const {
   Batch<TaskType>* open_batch = batches_.back().get();
@@ -44,14 +44,18 @@ using ::testing::HasSubstr;
 
 class FakeTask : public BatchTask {
  public:
-  explicit FakeTask(size_t size) : size_(size) {}
+  explicit FakeTask(size_t size, bool is_low_priority = false)
+      : size_(size), is_low_priority_(is_low_priority) {}
 
   ~FakeTask() override = default;
 
   size_t size() const override { return size_; }
 
+  bool is_low_priority() const override { return is_low_priority_; }
+
  private:
   const size_t size_;
+  const bool is_low_priority_;
 
   TF_DISALLOW_COPY_AND_ASSIGN(FakeTask);
 };
@@ -66,8 +70,9 @@ using SplitFunc =
 
 // Creates a FakeTask of size 'task_size', and calls 'scheduler->Schedule()' on
 // that task. Returns the resulting status.
-Status ScheduleTask(size_t task_size, BatchScheduler<FakeTask>* scheduler) {
-  std::unique_ptr<FakeTask> task(new FakeTask(task_size));
+Status ScheduleTask(size_t task_size, BatchScheduler<FakeTask>* scheduler,
+                    bool is_low_priority = false) {
+  std::unique_ptr<FakeTask> task(new FakeTask(task_size, is_low_priority));
   Status status = scheduler->Schedule(&task);
   // Schedule() should have consumed 'task' iff it returned Status::OK.
   CHECK_EQ(status.ok(), task == nullptr);
@@ -804,6 +809,168 @@ INSTANTIATE_TEST_SUITE_P(
                       std::make_tuple(/*enable_input_batch_split=*/false,
                                       /*enable_lazy_split=*/false)));
 
+// Creates QueueOptions for a queue with a lane of low priority tasks.
+QueueOptions CreatePriorityQueueOptions(
+    size_t max_execution_batch_size, int64_t batch_timeout_micros,
+    int64_t low_priority_batch_timeout_micros,
+    size_t low_priority_max_enqueued_batches) {
+  QueueOptions options;
+  options.input_batch_size_limit = max_execution_batch_size;
+  options.max_execution_batch_size = max_execution_batch_size;
+  options.batch_timeout_micros = batch_timeout_micros;
+  options.max_enqueued_batches = 2;
+  options.enable_priority_queue = true;
+  options.low_priority_queue_options.batch_timeout_micros =
+      low_priority_batch_timeout_micros;
+  options.low_priority_queue_options.max_enqueued_batches =
+      low_priority_max_enqueued_batches;
+  return options;
+}
+
+// Returns the sizes of the tasks of `batch`, with low priority tasks negated.
+std::vector<int> TaskSizes(const Batch<FakeTask>& batch) {
+  std::vector<int> sizes;
+  for (int i = 0; i < batch.num_tasks(); ++i) {
+    const int size = batch.task(i).size();
+    sizes.push_back(batch.task(i).is_low_priority() ? -size : size);
+  }
+  return sizes;
+}
+
+TEST(SharedBatchSchedulerPriorityTest, LowPriorityTasksFillHighPriorityBatch) {
+  test_util::FakeClockEnv env(Env::Default());
+  Notification start_teardown, stop_teardown;
+  std::unique_ptr<Thread> teardown_thread =
+      CreateFakeClockAdvancerThread(&env, &start_teardown, &stop_teardown);
+  {
+    mutex mu;
+    std::vector<std::vector<int>> batches;
+    Notification batch_processed;
+    auto callback = [&](std::unique_ptr<Batch<FakeTask>> batch) {
+      ASSERT_TRUE(batch->IsClosed());
+      mutex_lock l(mu);
+      batches.push_back(TaskSizes(*batch));
+      batch_processed.Notify();
+    };
+    auto scheduler = CreateSharedBatchScheduler(1, &env);
+    auto queue = CreateQueue(
+        scheduler,
+        CreatePriorityQueueOptions(
+            /*max_execution_batch_size=*/10, /*batch_timeout_micros=*/10,
+            /*low_priority_batch_timeout_micros=*/1000 * 1000,
+            /*low_priority_max_enqueued_batches=*/2),
+        callback);
+
+    TF_ASSERT_OK(ScheduleTask(3, queue.get(), /*is_low_priority=*/true));
+    TF_ASSERT_OK(ScheduleTask(6, queue.get(), /*is_low_priority=*/true));
+    TF_ASSERT_OK(ScheduleTask(2, queue.get()));
+    EXPECT_EQ(queue->NumEnqueuedTasks(), 3);
+    Env::Default()->SleepForMicroseconds(10 * 1000 /* 10 milliseconds */);
+    EXPECT_FALSE(batch_processed.HasBeenNotified());
+
+    // The high priority batch times out, and takes as many low priority tasks
+    // as fit.
+    env.AdvanceByMicroseconds(10);
+    batch_processed.WaitForNotification();
+    {
+      mutex_lock l(mu);
+      EXPECT_EQ(batches, std::vector<std::vector<int>>({{2, -3}}));
+    }
+    EXPECT_EQ(queue->NumEnqueuedTasks(), 1);
+    start_teardown.Notify();
+  }
+  stop_teardown.Notify();
+}
+
+TEST(SharedBatchSchedulerPriorityTest, HighPriorityBatchesAreScheduledFirst) {
+  mutex mu;
+  std::vector<std::vector<int>> batches;
+  Notification first_batch_started, finish_first_batch;
+  auto callback = [&](std::unique_ptr<Batch<FakeTask>> batch) {
+    ASSERT_TRUE(batch->IsClosed());
+    bool first_batch;
+    {
+      mutex_lock l(mu);
+      batches.push_back(TaskSizes(*batch));
+      first_batch = batches.size() == 1;
+    }
+    if (first_batch) {
+      first_batch_started.Notify();
+      finish_first_batch.WaitForNotification();
+    }
+  };
+  {
+    auto scheduler = CreateSharedBatchScheduler(1);
+    auto queue = CreateQueue(
+        scheduler,
+        CreatePriorityQueueOptions(
+            /*max_execution_batch_size=*/5, /*batch_timeout_micros=*/0,
+            /*low_priority_batch_timeout_micros=*/0,
+            /*low_priority_max_enqueued_batches=*/2),
+        callback);
+
+    // Keep the only batch thread busy while tasks of both priorities are
+    // enqueued.
+    TF_ASSERT_OK(ScheduleTask(1, queue.get()));
+    first_batch_started.WaitForNotification();
+    TF_ASSERT_OK(ScheduleTask(5, queue.get(), /*is_low_priority=*/true));
+    TF_ASSERT_OK(ScheduleTask(4, queue.get()));
+    finish_first_batch.Notify();
+  }
+  mutex_lock l(mu);
+  EXPECT_EQ(batches, std::vector<std::vector<int>>({{1}, {4}, {-5}}));
+}
+
+TEST(SharedBatchSchedulerPriorityTest, LowPriorityCapacity) {
+  auto callback = [](std::unique_ptr<Batch<FakeTask>> batch) {
+    // do nothing.
+  };
+  auto scheduler = CreateSharedBatchScheduler(1);
+  auto queue = CreateQueue(
+      scheduler,
+      CreatePriorityQueueOptions(
+          /*max_execution_batch_size=*/10, /*batch_timeout_micros=*/0,
+          /*low_priority_batch_timeout_micros=*/100 * 1000 * 1000,
+          /*low_priority_max_enqueued_batches=*/1),
+      callback);
+
+  TF_ASSERT_OK(ScheduleTask(4, queue.get(), /*is_low_priority=*/true));
+  EXPECT_THAT(ScheduleTask(7, queue.get(), /*is_low_priority=*/true),
+              testing::StatusIs(error::UNAVAILABLE));
+  // High priority tasks don't share the capacity of the low priority ones.
+  TF_EXPECT_OK(ScheduleTask(7, queue.get()));
+}
+
+TEST(SharedBatchSchedulerPriorityTest, InvalidPriorityQueueOptions) {
+  auto callback = [](std::unique_ptr<Batch<FakeTask>> batch) {
+    // do nothing.
+  };
+  auto scheduler = CreateSharedBatchScheduler(1);
+  std::unique_ptr<Queue> queue;
+
+  QueueOptions options = CreateQueueOptions(
+      /*max_execution_batch_size=*/10, /*input_batch_size_limit=*/10,
+      /*batch_timeout_micros=*/0, /*max_enqueued_batches=*/2,
+      /*enable_large_batch_splitting=*/true, /*enable_lazy_split=*/true,
+      [](std::unique_ptr<FakeTask>* input_task, int first_output_task_size,
+         int input_batch_size_limit,
+         std::vector<std::unique_ptr<FakeTask>>* output_tasks) {
+        return OkStatus();
+      });
+  options.enable_priority_queue = true;
+  EXPECT_THAT(scheduler->AddQueue(options, callback, &queue),
+              testing::StatusIs(error::INVALID_ARGUMENT,
+                                HasSubstr("enable_lazy_split")));
+
+  options = CreatePriorityQueueOptions(
+      /*max_execution_batch_size=*/10, /*batch_timeout_micros=*/0,
+      /*low_priority_batch_timeout_micros=*/0,
+      /*low_priority_max_enqueued_batches=*/0);
+  EXPECT_THAT(scheduler->AddQueue(options, callback, &queue),
+              testing::StatusIs(error::INVALID_ARGUMENT,
+                                HasSubstr("max_enqueued_batches")));
+}
+
 #ifdef PLATFORM_GOOGLE
 // This benchmark relies on https://github.com/google/benchmark features,
 // (in particular, `Benchmark::ThreadRange`) not available in open-sourced TF
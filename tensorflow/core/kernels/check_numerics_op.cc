@@ -20,6 +20,7 @@ limitations under the License.
 
 #include <math.h>  // NOLINT
 #include <algorithm>  // NOLINT
+#include <limits>  // NOLINT
 #include <numeric>  // NOLINT
 // clang-format on
 
@@ -63,6 +64,16 @@ struct CheckNumericsLaunchV2 {
 extern template struct CheckNumericsLaunchV2<Eigen::half>;
 extern template struct CheckNumericsLaunchV2<float>;
 extern template struct CheckNumericsLaunchV2<double>;
+
+template <typename T>
+struct CheckNumericsNLaunch {
+  void Run(const GPUDevice& d, const T* const* data, const int* sizes,
+           int num_tensors, int* abnormal_detected);
+};
+
+extern template struct CheckNumericsNLaunch<Eigen::half>;
+extern template struct CheckNumericsNLaunch<float>;
+extern template struct CheckNumericsNLaunch<double>;
 #endif
 
 namespace {
@@ -137,7 +148,6 @@ class CheckNumericsOp<CPUDevice, T> : public OpKernel {
     return status;
   }
 
- private:
   string message_;
 };
 
@@ -189,6 +199,39 @@ class CheckNumericsV2Op<CPUDevice, T> : public CheckNumericsOp<CPUDevice, T> {
   }
 };
 
+template <typename Device, typename T>
+class CheckNumericsNOp;
+
+// Partial specialization for CPU: the multi-tensor version of v2, which reports
+// the first tensor that has NaN or Inf values.
+template <typename T>
+class CheckNumericsNOp<CPUDevice, T> : public CheckNumericsV2Op<CPUDevice, T> {
+ public:
+  explicit CheckNumericsNOp(OpKernelConstruction* context)
+      : CheckNumericsV2Op<CPUDevice, T>(context) {}
+
+  void Compute(OpKernelContext* context) override {
+    for (int i = 0; i < context->num_inputs(); ++i) {
+      context->set_output(i, context->input(i));
+    }
+    for (int i = 0; i < context->num_inputs(); ++i) {
+      auto in = context->input(i).flat<T>();
+      const T* data = in.data();
+      const int64_t size = in.size();
+      int fp_props = std::accumulate(
+          data, data + size, 0, [this](const int x, const T& y) {
+            return this->checkFloatingElement(x, y);
+          });
+      if (fp_props != 0) {
+        context->SetStatus(errors::InvalidArgument(
+            this->message_, " : Tensor ", i, " had ",
+            this->getErrorString(fp_props), " values"));
+        return;
+      }
+    }
+  }
+};
+
 #if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 // Partial specialization for GPU
 template <typename T>
@@ -357,6 +400,134 @@ class CheckNumericsV2Op<GPUDevice, T> : public CheckNumericsOp<GPUDevice, T> {
   static constexpr int abnormal_detected_size = 3;
 };
 
+// Partial specialization for GPU: all the tensors are checked by one kernel
+// launch (per kCheckNumericsNMaxTensorsPerLaunch tensors), and their results
+// are copied to the host at once.
+template <typename T>
+class CheckNumericsNOp<GPUDevice, T> : public AsyncOpKernel {
+ public:
+  explicit CheckNumericsNOp(OpKernelConstruction* context)
+      : AsyncOpKernel(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("message", &message_));
+  }
+
+  void ComputeAsync(OpKernelContext* context, DoneCallback done) override {
+    // pass along the inputs to the outputs, and collect the non-empty ones.
+    std::vector<const T*> data;
+    std::vector<int> sizes;
+    std::vector<int> tensor_indices;
+    for (int i = 0; i < context->num_inputs(); ++i) {
+      context->set_output(i, context->input(i));
+      const int64_t size = context->input(i).NumElements();
+      if (size == 0) continue;
+      OP_REQUIRES_ASYNC(
+          context, size <= std::numeric_limits<int>::max(),
+          errors::InvalidArgument("Tensor ", i, " has too many elements: ",
+                                  size),
+          done);
+      data.push_back(context->input(i).flat<T>().data());
+      sizes.push_back(static_cast<int>(size));
+      tensor_indices.push_back(i);
+    }
+    if (data.empty()) {
+      done();
+      return;
+    }
+
+    // Allocate and initialize the elements to hold the check results, 3 per
+    // tensor.
+    const int abnormal_detected_size = 3 * data.size();
+    Tensor abnormal_detected;
+    OP_REQUIRES_OK_ASYNC(
+        context,
+        context->allocate_temp(DT_INT32, TensorShape({abnormal_detected_size}),
+                               &abnormal_detected),
+        done);
+
+    auto* stream = context->op_device_context()->stream();
+    OP_REQUIRES_ASYNC(context, stream != nullptr,
+                      errors::Internal("No GPU stream available."), done);
+
+    se::DeviceMemoryBase abnormal_detected_ptr(
+        abnormal_detected.flat<int>().data(),
+        abnormal_detected.flat<int>().size());
+    stream->ThenMemset32(&abnormal_detected_ptr, 0,
+                         abnormal_detected_size * sizeof(int));
+
+    const GPUDevice& d = context->eigen_device<GPUDevice>();
+    CheckNumericsNLaunch<T>().Run(d, data.data(), sizes.data(), data.size(),
+                                  abnormal_detected.flat<int>().data());
+
+    // Copy the results from device to host
+    AllocatorAttributes attr;
+    attr.set_on_host(true);
+    attr.set_gpu_compatible(true);
+    Tensor abnormal_detected_host;
+    OP_REQUIRES_OK_ASYNC(
+        context,
+        context->allocate_temp(DT_INT32, TensorShape({abnormal_detected_size}),
+                               &abnormal_detected_host, attr),
+        done);
+    OP_REQUIRES_ASYNC(
+        context,
+        stream
+            ->ThenMemcpy(abnormal_detected_host.flat<int>().data(),
+                         abnormal_detected_ptr,
+                         abnormal_detected_size * sizeof(int))
+            .ok(),
+        errors::Internal("GPU memcpy from device to host failed"), done);
+
+    TensorReference abnormal_detected_ref(abnormal_detected);
+    auto check_cb = [this, stream, abnormal_detected_ref,
+                     abnormal_detected_host,
+                     tensor_indices = std::move(tensor_indices), context,
+                     done]() {
+#if GOOGLE_CUDA
+      se::cuda::ScopedActivateExecutorContext scoped_activation{
+          stream->parent()};
+#elif TENSORFLOW_USE_ROCM
+      se::rocm::ScopedActivateExecutorContext scoped_activation{
+          stream->parent()};
+#endif
+      TTypes<const int>::Vec abnormal_detected_host_flat =
+          abnormal_detected_host.flat<int>();
+      abnormal_detected_ref.Unref();
+      for (int i = 0; i < tensor_indices.size(); ++i) {
+        const int is_nan = abnormal_detected_host_flat(3 * i);
+        const int is_negative_inf = abnormal_detected_host_flat(3 * i + 1);
+        const int is_positive_inf = abnormal_detected_host_flat(3 * i + 2);
+        if (is_nan || is_negative_inf || is_positive_inf) {
+          std::vector<string> anomalies;
+          if (is_negative_inf) anomalies.push_back("-Inf");
+          if (is_positive_inf) anomalies.push_back("+Inf");
+          if (is_nan) anomalies.push_back("NaN");
+          string all_anomalies;
+          if (anomalies.size() == 3) {
+            all_anomalies = strings::StrCat(anomalies[0], ", ", anomalies[1],
+                                            ", and ", anomalies[2]);
+          } else if (anomalies.size() == 2) {
+            all_anomalies =
+                strings::StrCat(anomalies[0], " and ", anomalies[1]);
+          } else {
+            all_anomalies = anomalies[0];
+          }
+          context->SetStatus(errors::InvalidArgument(
+              message_, " : Tensor ", tensor_indices[i], " had ",
+              all_anomalies, " values"));
+          break;
+        }
+      }
+      done();
+    };
+    context->device()
+        ->tensorflow_accelerator_device_info()
+        ->event_mgr->ThenExecute(stream, std::move(check_cb));
+  }
+
+ private:
+  string message_;
+};
+
 #endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 
 }  // namespace
@@ -379,6 +550,15 @@ TF_CALL_bfloat16(REGISTER_V2_CPU_KERNEL);
 TF_CALL_float(REGISTER_V2_CPU_KERNEL);
 TF_CALL_double(REGISTER_V2_CPU_KERNEL);
 
+#define REGISTER_N_CPU_KERNEL(T)                                        \
+  REGISTER_KERNEL_BUILDER(                                              \
+      Name("CheckNumericsN").Device(DEVICE_CPU).TypeConstraint<T>("T"), \
+      CheckNumericsNOp<CPUDevice, T>);
+TF_CALL_half(REGISTER_N_CPU_KERNEL);
+TF_CALL_bfloat16(REGISTER_N_CPU_KERNEL);
+TF_CALL_float(REGISTER_N_CPU_KERNEL);
+TF_CALL_double(REGISTER_N_CPU_KERNEL);
+
 #if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 REGISTER_KERNEL_BUILDER(
     Name("CheckNumerics").Device(DEVICE_GPU).TypeConstraint<Eigen::half>("T"),
@@ -399,6 +579,16 @@ REGISTER_KERNEL_BUILDER(
 REGISTER_KERNEL_BUILDER(
     Name("CheckNumericsV2").Device(DEVICE_GPU).TypeConstraint<double>("T"),
     CheckNumericsV2Op<GPUDevice, double>);
+
+REGISTER_KERNEL_BUILDER(
+    Name("CheckNumericsN").Device(DEVICE_GPU).TypeConstraint<Eigen::half>("T"),
+    CheckNumericsNOp<GPUDevice, Eigen::half>);
+REGISTER_KERNEL_BUILDER(
+    Name("CheckNumericsN").Device(DEVICE_GPU).TypeConstraint<float>("T"),
+    CheckNumericsNOp<GPUDevice, float>);
+REGISTER_KERNEL_BUILDER(
+    Name("CheckNumericsN").Device(DEVICE_GPU).TypeConstraint<double>("T"),
+    CheckNumericsNOp<GPUDevice, double>);
 #endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 
 }  // namespace tensorflow
@@ -77,6 +77,41 @@ __global__ void CheckNumericsKernelV2(const T* __restrict__ data, int size,
   }
 }
 
+// The number of tensors checked by one launch of CheckNumericsNKernel, whose
+// pointers and sizes are passed as kernel arguments.
+constexpr int kCheckNumericsNMaxTensorsPerLaunch = 32;
+
+template <typename T>
+struct CheckNumericsNArgs {
+  const T* data[kCheckNumericsNMaxTensorsPerLaunch];
+  int size[kCheckNumericsNMaxTensorsPerLaunch];
+};
+
+// The multi-tensor version of CheckNumericsKernelV2. blockIdx.y selects the
+// tensor, and the 3 elements of `abnormal_detected` starting at 3 * blockIdx.y
+// signify NaN, -Inf and +Inf in that tensor.
+template <typename T>
+__global__ void CheckNumericsNKernel(CheckNumericsNArgs<T> args,
+                                     int* abnormal_detected) {
+  const T* __restrict__ data = args.data[blockIdx.y];
+  const int size = args.size[blockIdx.y];
+  int* tensor_abnormal_detected = abnormal_detected + 3 * blockIdx.y;
+  const int32 thread_id = blockIdx.x * blockDim.x + threadIdx.x;
+  const int32 total_thread_count = gridDim.x * blockDim.x;
+
+  int32 offset = thread_id;
+
+  while (offset < size) {
+    if (isnan(data[offset])) {
+      tensor_abnormal_detected[0] = 1;
+    }
+    if (isinf(data[offset])) {
+      tensor_abnormal_detected[data[offset] < static_cast<T>(0.f) ? 1 : 2] = 1;
+    }
+    offset += total_thread_count;
+  }
+}
+
 }  // namespace
 
 // A simple launch pad to launch the Cuda kernels that checks the numerical
@@ -118,5 +153,41 @@ template struct CheckNumericsLaunchV2<Eigen::half>;
 template struct CheckNumericsLaunchV2<float>;
 template struct CheckNumericsLaunchV2<double>;
 
+template <typename T>
+struct CheckNumericsNLaunch {
+  void Run(const GPUDevice& d, const T* const* data, const int* sizes,
+           int num_tensors, int* abnormal_detected) {
+    const int32 block_size = d.maxGpuThreadsPerBlock();
+    const int32 max_num_blocks =
+        (d.getNumGpuMultiProcessors() * d.maxGpuThreadsPerMultiProcessor()) /
+        block_size;
+
+    for (int begin = 0; begin < num_tensors;
+         begin += kCheckNumericsNMaxTensorsPerLaunch) {
+      const int count =
+          std::min(kCheckNumericsNMaxTensorsPerLaunch, num_tensors - begin);
+      CheckNumericsNArgs<T> args;
+      int max_size = 0;
+      for (int i = 0; i < count; ++i) {
+        args.data[i] = data[begin + i];
+        args.size[i] = sizes[begin + i];
+        max_size = std::max(max_size, sizes[begin + i]);
+      }
+      // The blocks that fill the device are split between the tensors.
+      const int32 num_blocks_per_tensor =
+          std::max(1, std::min(max_num_blocks / count,
+                               Eigen::divup(max_size, block_size)));
+      TF_CHECK_OK(GpuLaunchKernel(CheckNumericsNKernel<T>,
+                                  dim3(num_blocks_per_tensor, count),
+                                  block_size, 0, d.stream(), args,
+                                  abnormal_detected + 3 * begin));
+    }
+  }
+};
+
+template struct CheckNumericsNLaunch<Eigen::half>;
+template struct CheckNumericsNLaunch<float>;
+template struct CheckNumericsNLaunch<double>;
+
 }  // namespace tensorflow
 #endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
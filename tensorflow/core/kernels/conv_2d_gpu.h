@@ -261,6 +261,20 @@ __global__ void ShuffleInTensor3SimpleVector(int nthreads,
   }
 }
 
+// The number of elements padding each row of the shared memory tile of
+// SwapDimension1And2InTensor3UsingTiles, so that the elements of a column of
+// the tile are in different banks. The LDS banks of AMD GPUs are 4 bytes wide,
+// so the rows of 1 and 2 byte elements are padded by 4 bytes to make their
+// stride an odd number of banks.
+template <typename T>
+constexpr int TileRowPadding() {
+#if TENSORFLOW_USE_ROCM
+  return sizeof(T) < 4 ? 4 / sizeof(T) : 1;
+#else
+  return 1;
+#endif
+}
+
 // Use shared memory tiles to swap dimension-1 and dimension-2 of a 3D tensor,
 // where dimensions are zero-based: output[i][j][k] = input[i][k][j].
 //
@@ -294,7 +308,7 @@ __global__ void SwapDimension1And2InTensor3UsingTiles(
   SharedMemoryTile shared_memory_tile =
       reinterpret_cast<SharedMemoryTile>(shared_mem_raw);
 #elif TENSORFLOW_USE_ROCM
-  __shared__ T shared_memory_tile[TileSizeI][TileSizeJ + 1];
+  __shared__ T shared_memory_tile[TileSizeI][TileSizeJ + TileRowPadding<T>()];
 #endif
 
   int x = threadIdx.x;
@@ -990,6 +1004,30 @@ void SwapDimension1And2InTensor3WithNarrowMatrices(
       reinterpret_cast<ElemType*>(output));
 }
 
+// Launches SwapDimension1And2InTensor3UsingTiles with square tiles of
+// TileSize x TileSize and blocks of 256 threads.
+template <typename T, int TileSize, bool conjugate>
+void LaunchSwapDimension1And2InTensor3UsingTiles(const GPUDevice& d,
+                                                 const T* input,
+                                                 const Dimension<3>& input_dims,
+                                                 T* output) {
+  constexpr int kNumThreads = 256;
+
+  Dimension<3> input_dims_in_tiles = {
+      input_dims[0],
+      MathUtil::CeilOfRatio<int>(input_dims[1], TileSize),
+      MathUtil::CeilOfRatio<int>(input_dims[2], TileSize),
+  };
+
+  int total_tiles_count =
+      input_dims_in_tiles[0] * input_dims_in_tiles[1] * input_dims_in_tiles[2];
+  TF_CHECK_OK(GpuLaunchKernel(
+      SwapDimension1And2InTensor3UsingTiles<T, kNumThreads, TileSize, TileSize,
+                                            conjugate>,
+      total_tiles_count, kNumThreads, 0, d.stream(), input, input_dims,
+      output));
+}
+
 // Launch the GPU kernel that would swap dimension-1 and dimension-2 in a
 // 3D tensor. It looks at the shape of the incoming data, and decides the best
 // strategy to launch.
@@ -1010,23 +1048,19 @@ void RunSwapDimension1And2InTensor3(const GPUDevice& d, const T* input,
     // We get best performance when kTileSize is the number of threads in a warp
     // (32 on our GPUs) and NumSubTiles is 8, so our block size is 8 * 32 = 256
     // threads.
-    constexpr int kTileSize = 32;
-    constexpr int kNumThreads = 256;
-
-    Dimension<3> input_dims_in_tiles = {
-        input_dims[0],
-        MathUtil::CeilOfRatio<int>(input_dims[1], kTileSize),
-        MathUtil::CeilOfRatio<int>(input_dims[2], kTileSize),
-    };
-
-    int total_tiles_count = input_dims_in_tiles[0] * input_dims_in_tiles[1] *
-                            input_dims_in_tiles[2];
-    TF_CHECK_OK(GpuLaunchKernel(
-        SwapDimension1And2InTensor3UsingTiles<T, kNumThreads, kTileSize,
-                                              kTileSize, conjugate>,
-        total_tiles_count, kNumThreads, 0, d.stream(), input, input_dims,
-        output));
-
+#if TENSORFLOW_USE_ROCM
+    // On AMD GPUs, the tiles of elements of up to 4 bytes match the 64 threads
+    // of a wavefront, if the matrices are large enough to fill them.
+    if constexpr (sizeof(T) <= 4) {
+      if (input_dims[1] >= 64 && input_dims[2] >= 64) {
+        LaunchSwapDimension1And2InTensor3UsingTiles<T, 64, conjugate>(
+            d, input, input_dims, output);
+        return;
+      }
+    }
+#endif
+    LaunchSwapDimension1And2InTensor3UsingTiles<T, 32, conjugate>(
+        d, input, input_dims, output);
   } else if (narrow_matrix) {
     SwapDimension1And2InTensor3WithNarrowMatrices<T, conjugate>(
         d, input, input_dims, output, kMinDimensionToUseTiles);
@@ -19,6 +19,7 @@ limitations under the License.
 #define EIGEN_USE_GPU
 #endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 
+#include <algorithm>
 #include <utility>
 
 #include "tensorflow/core/framework/bounds_check.h"
@@ -26,8 +27,10 @@ limitations under the License.
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/register_types.h"
 #include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/lib/core/bits.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/util/ctc/ctc_loss_calculator.h"
 #include "tensorflow/core/util/sparse/sparse_tensor.h"
 
@@ -65,6 +68,52 @@ void DoHistogram(OpKernelContext* ctx, const Tensor* labels_indices,
   }
 }
 
+// Provides the workspace of the cuDNN/MIOpen CTC loss from a buffer that the
+// kernel keeps across steps. The workspace size depends on the label lengths of
+// the batch, so the buffer is allocated with the size rounded up to a power of
+// two, and is only reallocated when a batch needs a larger bucket.
+class CtcWorkspaceAllocator : public se::ScratchAllocator {
+ public:
+  CtcWorkspaceAllocator(int64_t memory_limit, OpKernelContext* context,
+                        Tensor* workspace)
+      : memory_limit_(memory_limit), context_(context), workspace_(workspace) {}
+
+  int64 GetMemoryLimitInBytes() override { return memory_limit_; }
+
+  tsl::StatusOr<se::DeviceMemory<uint8>> AllocateBytes(
+      int64_t byte_size) override {
+    if (byte_size < 0) {
+      return errors::InvalidArgument("Requested negative byte size!");
+    }
+    if (byte_size > memory_limit_) {
+      return errors::Unavailable("Requested memory size (", byte_size,
+                                 ") exceeds the max memory limit (",
+                                 memory_limit_, ").");
+    }
+    if (!workspace_->IsInitialized() || workspace_->NumElements() < byte_size) {
+      const int64_t bucket_size = std::min<int64_t>(
+          memory_limit_, NextPowerOfTwo64(static_cast<uint64>(byte_size)));
+      AllocationAttributes allocation_attr;
+      allocation_attr.retry_on_failure = false;
+      Tensor new_workspace;
+      Status allocation_status = context_->allocate_temp(
+          DT_UINT8, TensorShape({bucket_size}), &new_workspace,
+          AllocatorAttributes(), allocation_attr);
+      if (!allocation_status.ok()) {
+        return errors::Unavailable(
+            "Failed to allocate the requested memory size (", byte_size, ").");
+      }
+      *workspace_ = std::move(new_workspace);
+    }
+    return AsDeviceMemory(workspace_->flat<uint8>().data(), byte_size);
+  }
+
+ private:
+  const int64_t memory_limit_;
+  OpKernelContext* context_;
+  Tensor* workspace_;  // Not owned.
+};
+
 }  // end namespace
 #endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 
@@ -353,10 +402,18 @@ class CTCLossOpGPU : public OpKernel {
     auto costs_data = StreamExecutorUtil::AsDeviceMemory<float>(*loss);
     auto grads_data = StreamExecutorUtil::AsDeviceMemory<float>(*gradient);
 
+    Stream* stream = ctx->op_device_context()->stream();
+
+    // The workspace is reused by the steps that run on the same stream, which
+    // are ordered on the device.
+    mutex_lock l(mu_);
+    if (workspace_stream_ != stream) {
+      workspace_ = Tensor();
+      workspace_stream_ = stream;
+    }
     // Set the memory limitation to 4GB for workspace memory.
-    DnnScratchAllocator workspace_allocator(1LL << 32, ctx);
+    CtcWorkspaceAllocator workspace_allocator(1LL << 32, ctx, &workspace_);
 
-    Stream* stream = ctx->op_device_context()->stream();
     bool cudnn_launch_status =
         stream
             ->ThenCtcLoss(*probs_desc, probs_data, labels_data,
@@ -371,6 +428,10 @@ class CTCLossOpGPU : public OpKernel {
   }
 
  private:
+  mutex mu_;
+  Tensor workspace_ TF_GUARDED_BY(mu_);
+  Stream* workspace_stream_ TF_GUARDED_BY(mu_) = nullptr;
+
   TF_DISALLOW_COPY_AND_ASSIGN(CTCLossOpGPU);
 };
 
@@ -556,6 +556,13 @@ struct CudnnRnnConfigComparator {
   }
 };
 
+// The largest models that use the persistent RNN algorithm by default, whose
+// recurrent weights fit on chip for the whole sequence. The persistent kernels
+// run all the time steps in one launch, which is where the time goes for the
+// many short sequences of the batch-1 inference of speech models.
+constexpr int kPersistentRnnMaxNumUnits = 256;
+constexpr int kPersistentRnnMaxBatchSize = 1;
+
 // Pointers to RNN scratch space for a specific set of shape parameters (used as
 // a hash table value in CudnnRNNForwardOp and CudnnRNNBackwardOp).
 struct RnnScratchSpace {
@@ -1687,6 +1694,9 @@ class CudnnRNNForwardOp<GPUDevice, T> : public CudnnRNNKernelCommon {
     is_debug_mode_ = DebugCudnnRnn();
     debug_cudnn_rnn_algo_ = DebugCudnnRnnAlgo();
     debug_use_tensor_ops_ = DebugCudnnRnnUseTensorOps();
+    OP_REQUIRES_OK(context,
+                   ReadBoolFromEnvVar("TF_CUDNN_RNN_USE_PERSISTENT_KERNELS",
+                                      true, &use_persistent_kernels_));
   }
 
   void Compute(OpKernelContext* context) override {
@@ -1755,6 +1765,9 @@ class CudnnRNNForwardOp<GPUDevice, T> : public CudnnRNNKernelCommon {
     Status launch_status;
     {
       mutex_lock l(mu_);
+      const bool use_persistent_algorithm =
+          MaybeUsePersistentAlgorithm(context, model_shapes,
+                                      output_algo_config);
       RnnDescriptor* rnn_desc_ptr = nullptr;
       OP_REQUIRES_OK(context,
                      GetCachedRnnDescriptor<T>(
@@ -1765,6 +1778,24 @@ class CudnnRNNForwardOp<GPUDevice, T> : public CudnnRNNKernelCommon {
           input_c, params, is_training_, output, output_h, output_c,
           sequence_lengths, time_major, &reserve_space_allocator,
           &workspace_allocator, /*output_profile_result=*/nullptr);
+      if (!launch_status.ok() && use_persistent_algorithm) {
+        // Not every model and device runs the persistent algorithm. As the
+        // inference doesn't write the reserve space, the call can be redone
+        // with the default algorithm, which the later calls use too.
+        VLOG(1) << "The persistent RNN algorithm failed, falling back to the "
+                << "default algorithm: " << launch_status;
+        persistent_algorithm_failed_ = true;
+        *output_algo_config = AlgorithmConfig();
+        OP_REQUIRES_OK(context, GetCachedRnnDescriptor<T>(
+                                    context, model_shapes, input_mode,
+                                    *output_algo_config, &rnn_state_cache_,
+                                    &rnn_desc_ptr, use_padded_io));
+        launch_status = DoForward<T>(
+            context, *rnn_desc_ptr, model_types(), model_shapes, input,
+            input_h, input_c, params, is_training_, output, output_h,
+            output_c, sequence_lengths, time_major, &reserve_space_allocator,
+            &workspace_allocator, /*output_profile_result=*/nullptr);
+      }
     }
     OP_REQUIRES_OK(context, launch_status);
   }
@@ -1789,6 +1820,25 @@ class CudnnRNNForwardOp<GPUDevice, T> : public CudnnRNNKernelCommon {
   int64_t debug_cudnn_rnn_algo_;
 
  private:
+  // Sets the persistent algorithm in `algo_config` for the inference of small
+  // models when no algorithm was picked, and returns whether it did.
+  bool MaybeUsePersistentAlgorithm(OpKernelContext* context,
+                                   const CudnnRnnModelShapes& model_shapes,
+                                   AlgorithmConfig* algo_config)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    if (!use_persistent_kernels_ || persistent_algorithm_failed_ ||
+        is_training_ || algo_config->algorithm().has_value() ||
+        model_shapes.num_units > kPersistentRnnMaxNumUnits ||
+        model_shapes.batch_size > kPersistentRnnMaxBatchSize) {
+      return false;
+    }
+    AlgorithmDesc algorithm;
+    StreamExecutor* executor = context->op_device_context()->stream()->parent();
+    if (!executor->GetPersistentRnnAlgorithm(&algorithm)) return false;
+    algo_config->set_algorithm(algorithm);
+    return true;
+  }
+
   Status AllocateOutputs(OpKernelContext* context,
                          const CudnnRnnModelShapes& model_shapes,
                          Tensor** output, Tensor** output_h,
@@ -1817,6 +1867,8 @@ class CudnnRNNForwardOp<GPUDevice, T> : public CudnnRNNKernelCommon {
 
   mutex mu_;
   bool is_training_;
+  bool use_persistent_kernels_;
+  bool persistent_algorithm_failed_ TF_GUARDED_BY(mu_) = false;
   RnnStateCache rnn_state_cache_ TF_GUARDED_BY(mu_);
 };
 
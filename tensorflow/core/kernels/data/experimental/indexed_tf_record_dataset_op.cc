@@ -0,0 +1,351 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/kernels/data/experimental/indexed_tf_record_dataset_op.h"
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "tensorflow/core/data/name_utils.h"
+#include "tensorflow/core/data/utils.h"
+#include "tensorflow/core/framework/partial_tensor_shape.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/kernels/data/random_seed_ops.h"
+#include "tensorflow/core/lib/io/record_index.h"
+#include "tensorflow/core/lib/io/record_reader.h"
+#include "tensorflow/core/lib/random/philox_random.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/mutex.h"
+
+namespace tensorflow {
+namespace data {
+namespace experimental {
+
+/* static */ constexpr const char* const IndexedTFRecordDatasetOp::kDatasetType;
+/* static */ constexpr const char* const IndexedTFRecordDatasetOp::kFileNames;
+/* static */ constexpr const char* const IndexedTFRecordDatasetOp::kSeed;
+/* static */ constexpr const char* const IndexedTFRecordDatasetOp::kSeed2;
+/* static */ constexpr const char* const IndexedTFRecordDatasetOp::kShuffle;
+
+namespace {
+
+constexpr char kNextIndex[] = "next_index";
+
+// A pseudorandom permutation of [0, size), which maps the indices one at a
+// time, so that shuffling the records takes no memory.
+//
+// The permutation is a 4-round Feistel network on the smallest even number of
+// bits that holds `size` values. The values out of [0, size) are mapped again
+// until they are in range ("cycle walking"), which takes fewer than 4 rounds on
+// average since the domain of the network holds fewer than 4 * `size` values.
+class IndexPermutation {
+ public:
+  IndexPermutation(int64_t size, int64_t seed, int64_t seed2) : size_(size) {
+    int bits = 0;
+    while (bits < 63 && (int64_t{1} << bits) < size) ++bits;
+    half_bits_ = std::max(1, (bits + 1) / 2);
+    half_mask_ = (uint64{1} << half_bits_) - 1;
+    random::PhiloxRandom generator(seed, seed2);
+    for (int i = 0; i < keys_.size(); i += 2) {
+      const random::PhiloxRandom::ResultType samples = generator();
+      keys_[i] = (static_cast<uint64>(samples[0]) << 32) | samples[1];
+      keys_[i + 1] = (static_cast<uint64>(samples[2]) << 32) | samples[3];
+    }
+  }
+
+  int64_t operator()(int64_t index) const {
+    uint64 value = index;
+    do {
+      value = Encrypt(value);
+    } while (value >= size_);
+    return value;
+  }
+
+ private:
+  uint64 Encrypt(uint64 value) const {
+    uint64 left = value >> half_bits_;
+    uint64 right = value & half_mask_;
+    for (uint64 key : keys_) {
+      const uint64 next = left ^ (Mix(right ^ key) & half_mask_);
+      left = right;
+      right = next;
+    }
+    return (left << half_bits_) | right;
+  }
+
+  // The finalizer of SplitMix64.
+  static uint64 Mix(uint64 value) {
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+    return value ^ (value >> 31);
+  }
+
+  const uint64 size_;
+  int half_bits_;
+  uint64 half_mask_;
+  std::array<uint64, 4> keys_;
+};
+
+}  // namespace
+
+class IndexedTFRecordDatasetOp::Dataset : public DatasetBase {
+ public:
+  Dataset(OpKernelContext* ctx, std::vector<string> filenames,
+          std::vector<std::vector<uint64>> offsets, bool shuffle,
+          RandomSeeds&& seeds)
+      : DatasetBase(DatasetContext(ctx)),
+        filenames_(std::move(filenames)),
+        offsets_(std::move(offsets)),
+        shuffle_(shuffle),
+        seeds_(std::move(seeds)),
+        files_(filenames_.size()) {
+    int64_t num_records = 0;
+    file_ends_.reserve(offsets_.size());
+    for (const auto& file_offsets : offsets_) {
+      num_records += file_offsets.size();
+      file_ends_.push_back(num_records);
+    }
+  }
+
+  std::unique_ptr<IteratorBase> MakeIteratorInternal(
+      const string& prefix) const override {
+    return std::make_unique<Iterator>(Iterator::Params{
+        this, name_utils::IteratorPrefix(kDatasetType, prefix)});
+  }
+
+  const DataTypeVector& output_dtypes() const override {
+    static DataTypeVector* dtypes = new DataTypeVector({DT_STRING});
+    return *dtypes;
+  }
+
+  const std::vector<PartialTensorShape>& output_shapes() const override {
+    static std::vector<PartialTensorShape>* shapes =
+        new std::vector<PartialTensorShape>({{}});
+    return *shapes;
+  }
+
+  string DebugString() const override {
+    return name_utils::DatasetDebugString(kDatasetType);
+  }
+
+  int64_t CardinalityInternal(CardinalityOptions options) const override {
+    return num_records();
+  }
+
+  Status InputDatasets(std::vector<const DatasetBase*>* inputs) const override {
+    return OkStatus();
+  }
+
+  Status CheckExternalState() const override { return OkStatus(); }
+
+  Status Get(OpKernelContext* ctx, int64 index,
+             std::vector<Tensor>* out_tensors) const override {
+    TF_RETURN_IF_ERROR(CheckRandomAccessCompatible(index));
+    out_tensors->clear();
+    out_tensors->emplace_back(ctx->get_allocator({}), DT_STRING,
+                              TensorShape({}));
+    return ReadRecord(ctx->env(), index,
+                      &out_tensors->back().scalar<tstring>()());
+  }
+
+ protected:
+  Status AsGraphDefInternal(SerializationContext* ctx,
+                            DatasetGraphDefBuilder* b,
+                            Node** output) const override {
+    Node* filenames = nullptr;
+    TF_RETURN_IF_ERROR(b->AddVector(filenames_, &filenames));
+    Node* seed = nullptr;
+    TF_RETURN_IF_ERROR(b->AddScalar(seeds_.input_seed(), &seed));
+    Node* seed2 = nullptr;
+    TF_RETURN_IF_ERROR(b->AddScalar(seeds_.input_seed2(), &seed2));
+    AttrValue shuffle;
+    b->BuildAttrValue(shuffle_, &shuffle);
+    return b->AddDataset(this, {filenames, seed, seed2},
+                         {std::make_pair(kShuffle, shuffle)}, output);
+  }
+
+ private:
+  class Iterator : public DatasetIterator<Dataset> {
+   public:
+    explicit Iterator(const Params& params)
+        : DatasetIterator<Dataset>(params) {}
+
+    bool SymbolicCheckpointCompatible() const override { return true; }
+
+    Status Initialize(IteratorContext* ctx) override {
+      mutex_lock l(mu_);
+      seed_ = dataset()->seeds_.seed();
+      seed2_ = dataset()->seeds_.seed2();
+      ResetPermutation();
+      return OkStatus();
+    }
+
+    Status GetNextInternal(IteratorContext* ctx,
+                           std::vector<Tensor>* out_tensors,
+                           bool* end_of_sequence) override {
+      mutex_lock l(mu_);
+      if (next_index_ >= dataset()->num_records()) {
+        *end_of_sequence = true;
+        return OkStatus();
+      }
+      const int64_t index =
+          permutation_ ? (*permutation_)(next_index_) : next_index_;
+      out_tensors->emplace_back(ctx->allocator({}), DT_STRING,
+                                TensorShape({}));
+      Status s = dataset()->ReadRecord(ctx->env(), index,
+                                       &out_tensors->back().scalar<tstring>()());
+      // The failed records are skipped, so that iteration continues with
+      // `ignore_errors`.
+      ++next_index_;
+      if (!s.ok()) {
+        out_tensors->pop_back();
+        return s;
+      }
+      *end_of_sequence = false;
+      return OkStatus();
+    }
+
+   protected:
+    std::shared_ptr<model::Node> CreateNode(
+        IteratorContext* ctx, model::Node::Args args) const override {
+      return model::MakeSourceNode(std::move(args));
+    }
+
+    Status SaveInternal(SerializationContext* ctx,
+                        IteratorStateWriter* writer) override {
+      mutex_lock l(mu_);
+      TF_RETURN_IF_ERROR(
+          writer->WriteScalar(full_name(kNextIndex), next_index_));
+      TF_RETURN_IF_ERROR(writer->WriteScalar(full_name(kSeed), seed_));
+      TF_RETURN_IF_ERROR(writer->WriteScalar(full_name(kSeed2), seed2_));
+      return OkStatus();
+    }
+
+    Status RestoreInternal(IteratorContext* ctx,
+                           IteratorStateReader* reader) override {
+      mutex_lock l(mu_);
+      TF_RETURN_IF_ERROR(
+          reader->ReadScalar(full_name(kNextIndex), &next_index_));
+      TF_RETURN_IF_ERROR(reader->ReadScalar(full_name(kSeed), &seed_));
+      TF_RETURN_IF_ERROR(reader->ReadScalar(full_name(kSeed2), &seed2_));
+      ResetPermutation();
+      return OkStatus();
+    }
+
+   private:
+    void ResetPermutation() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      if (dataset()->shuffle_) {
+        permutation_ = std::make_unique<IndexPermutation>(
+            dataset()->num_records(), seed_, seed2_);
+      }
+    }
+
+    mutex mu_;
+    int64_t next_index_ TF_GUARDED_BY(mu_) = 0;
+    int64_t seed_ TF_GUARDED_BY(mu_) = 0;
+    int64_t seed2_ TF_GUARDED_BY(mu_) = 0;
+    std::unique_ptr<IndexPermutation> permutation_ TF_GUARDED_BY(mu_);
+  };
+
+  int64_t num_records() const {
+    return file_ends_.empty() ? 0 : file_ends_.back();
+  }
+
+  // Reads the record at `index` among the records of all the files.
+  Status ReadRecord(Env* env, int64_t index, tstring* record) const {
+    const size_t file_index =
+        std::upper_bound(file_ends_.begin(), file_ends_.end(), index) -
+        file_ends_.begin();
+    const int64_t file_begin =
+        file_index == 0 ? 0 : file_ends_[file_index - 1];
+    RandomAccessFile* file;
+    TF_RETURN_IF_ERROR(GetFile(env, file_index, &file));
+    // The reader does not buffer, so that a record is read in 2 reads of the
+    // file, and it is cheap enough to create for each record. Unlike the
+    // reader, the file can be shared by concurrent reads.
+    io::RecordReader reader(file, io::RecordReaderOptions());
+    uint64 offset = offsets_[file_index][index - file_begin];
+    return reader.ReadRecord(&offset, record);
+  }
+
+  // Returns the file at `file_index`, which is opened on its first read.
+  Status GetFile(Env* env, size_t file_index, RandomAccessFile** file) const {
+    mutex_lock l(mu_);
+    std::unique_ptr<RandomAccessFile>& opened_file = files_[file_index];
+    if (!opened_file) {
+      TF_RETURN_IF_ERROR(env->NewRandomAccessFile(
+          TranslateFileName(filenames_[file_index]), &opened_file));
+    }
+    *file = opened_file.get();
+    return OkStatus();
+  }
+
+  const std::vector<string> filenames_;
+  // The offsets of the records of each file.
+  const std::vector<std::vector<uint64>> offsets_;
+  const bool shuffle_;
+  const RandomSeeds seeds_;
+  // The number of records in the files up to, and including, each file.
+  std::vector<int64_t> file_ends_;
+  mutable mutex mu_;
+  mutable std::vector<std::unique_ptr<RandomAccessFile>> files_
+      TF_GUARDED_BY(mu_);
+};
+
+IndexedTFRecordDatasetOp::IndexedTFRecordDatasetOp(OpKernelConstruction* ctx)
+    : DatasetOpKernel(ctx) {
+  OP_REQUIRES_OK(ctx, ctx->GetAttr(kShuffle, &shuffle_));
+}
+
+void IndexedTFRecordDatasetOp::MakeDataset(OpKernelContext* ctx,
+                                           DatasetBase** output) {
+  const Tensor* filenames_tensor;
+  OP_REQUIRES_OK(ctx, ctx->input(kFileNames, &filenames_tensor));
+  OP_REQUIRES(
+      ctx, filenames_tensor->dims() <= 1,
+      errors::InvalidArgument("`filenames` must be a scalar or a vector."));
+
+  std::vector<string> filenames;
+  std::vector<std::vector<uint64>> offsets(filenames_tensor->NumElements());
+  filenames.reserve(filenames_tensor->NumElements());
+  for (int i = 0; i < filenames_tensor->NumElements(); ++i) {
+    filenames.push_back(filenames_tensor->flat<tstring>()(i));
+    OP_REQUIRES_OK(
+        ctx, io::ReadRecordIndex(
+                 ctx->env(),
+                 io::RecordIndexFilename(TranslateFileName(filenames[i])),
+                 &offsets[i]));
+  }
+
+  int64_t seed;
+  OP_REQUIRES_OK(ctx, ParseScalarArgument<int64_t>(ctx, kSeed, &seed));
+  int64_t seed2;
+  OP_REQUIRES_OK(ctx, ParseScalarArgument<int64_t>(ctx, kSeed2, &seed2));
+
+  *output = new Dataset(ctx, std::move(filenames), std::move(offsets),
+                        shuffle_, RandomSeeds(seed, seed2));
+}
+
+namespace {
+REGISTER_KERNEL_BUILDER(Name("IndexedTFRecordDataset").Device(DEVICE_CPU),
+                        IndexedTFRecordDatasetOp);
+}  // namespace
+
+}  // namespace experimental
+}  // namespace data
+}  // namespace tensorflow
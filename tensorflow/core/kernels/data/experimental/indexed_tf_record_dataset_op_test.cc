@@ -0,0 +1,163 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/kernels/data/experimental/indexed_tf_record_dataset_op.h"
+
+#include "tensorflow/core/data/dataset_test_base.h"
+#include "tensorflow/core/lib/io/record_index.h"
+#include "tensorflow/core/lib/io/record_writer.h"
+
+namespace tensorflow {
+namespace data {
+namespace experimental {
+namespace {
+
+constexpr char kNodeName[] = "indexed_tf_record_dataset";
+
+class IndexedTFRecordDatasetParams : public DatasetParams {
+ public:
+  IndexedTFRecordDatasetParams(std::vector<tstring> filenames, bool shuffle,
+                               int64_t seed, int64_t seed2, string node_name)
+      : DatasetParams({DT_STRING}, {PartialTensorShape({})},
+                      std::move(node_name)),
+        filenames_(std::move(filenames)),
+        shuffle_(shuffle),
+        seed_(seed),
+        seed2_(seed2) {}
+
+  std::vector<Tensor> GetInputTensors() const override {
+    int num_files = filenames_.size();
+    return {CreateTensor<tstring>(TensorShape({num_files}), filenames_),
+            CreateTensor<int64_t>(TensorShape({}), {seed_}),
+            CreateTensor<int64_t>(TensorShape({}), {seed2_})};
+  }
+
+  Status GetInputNames(std::vector<string>* input_names) const override {
+    *input_names = {IndexedTFRecordDatasetOp::kFileNames,
+                    IndexedTFRecordDatasetOp::kSeed,
+                    IndexedTFRecordDatasetOp::kSeed2};
+    return OkStatus();
+  }
+
+  Status GetAttributes(AttributeVector* attr_vector) const override {
+    *attr_vector = {{IndexedTFRecordDatasetOp::kShuffle, shuffle_},
+                    {"metadata", ""}};
+    return OkStatus();
+  }
+
+  string dataset_type() const override {
+    return IndexedTFRecordDatasetOp::kDatasetType;
+  }
+
+ private:
+  std::vector<tstring> filenames_;
+  bool shuffle_;
+  int64_t seed_;
+  int64_t seed2_;
+};
+
+class IndexedTFRecordDatasetOpTest : public DatasetOpsTestBase {};
+
+Status CreateTestFiles(const std::vector<tstring>& filenames,
+                       const std::vector<std::vector<string>>& contents,
+                       bool write_index = true) {
+  for (int i = 0; i < filenames.size(); ++i) {
+    std::unique_ptr<WritableFile> file;
+    TF_RETURN_IF_ERROR(Env::Default()->NewWritableFile(filenames[i], &file));
+    io::RecordWriterOptions options;
+    if (write_index) {
+      options.index_filename = io::RecordIndexFilename(filenames[i]);
+    }
+    io::RecordWriter writer(file.get(), options);
+    for (const string& record : contents[i]) {
+      TF_RETURN_IF_ERROR(writer.WriteRecord(record));
+    }
+    TF_RETURN_IF_ERROR(writer.Close());
+    TF_RETURN_IF_ERROR(file->Close());
+  }
+  return OkStatus();
+}
+
+IndexedTFRecordDatasetParams MakeDatasetParams(bool shuffle) {
+  std::vector<tstring> filenames = {
+      absl::StrCat(testing::TmpDir(), "/indexed_tf_record_1"),
+      absl::StrCat(testing::TmpDir(), "/indexed_tf_record_2")};
+  std::vector<std::vector<string>> contents = {{"1", "22", "333"},
+                                               {"a", "bb", "ccc"}};
+  if (!CreateTestFiles(filenames, contents).ok()) {
+    VLOG(WARNING) << "Failed to create the test files: "
+                  << absl::StrJoin(filenames, ", ");
+  }
+  return IndexedTFRecordDatasetParams(filenames, shuffle, /*seed=*/1,
+                                      /*seed2=*/2, kNodeName);
+}
+
+std::vector<Tensor> ExpectedOutputs() {
+  return CreateTensors<tstring>(
+      TensorShape({}), {{"1"}, {"22"}, {"333"}, {"a"}, {"bb"}, {"ccc"}});
+}
+
+std::vector<GetNextTestCase<IndexedTFRecordDatasetParams>> GetNextTestCases() {
+  return {{/*dataset_params=*/MakeDatasetParams(/*shuffle=*/false),
+           /*expected_outputs=*/ExpectedOutputs()},
+          {/*dataset_params=*/MakeDatasetParams(/*shuffle=*/true),
+           /*expected_outputs=*/ExpectedOutputs(),
+           /*compare_order=*/false}};
+}
+
+ITERATOR_GET_NEXT_TEST_P(IndexedTFRecordDatasetOpTest,
+                         IndexedTFRecordDatasetParams, GetNextTestCases())
+
+TEST_F(IndexedTFRecordDatasetOpTest, DatasetTypeString) {
+  auto dataset_params = MakeDatasetParams(/*shuffle=*/false);
+  TF_ASSERT_OK(Initialize(dataset_params));
+  TF_ASSERT_OK(CheckDatasetTypeString(
+      name_utils::OpName(IndexedTFRecordDatasetOp::kDatasetType)));
+}
+
+TEST_F(IndexedTFRecordDatasetOpTest, Cardinality) {
+  auto dataset_params = MakeDatasetParams(/*shuffle=*/true);
+  TF_ASSERT_OK(Initialize(dataset_params));
+  TF_ASSERT_OK(CheckDatasetCardinality(6));
+}
+
+TEST_F(IndexedTFRecordDatasetOpTest, MissingIndex) {
+  std::vector<tstring> filenames = {
+      absl::StrCat(testing::TmpDir(), "/indexed_tf_record_no_index")};
+  TF_ASSERT_OK(CreateTestFiles(filenames, {{"1"}}, /*write_index=*/false));
+  IndexedTFRecordDatasetParams dataset_params(filenames, /*shuffle=*/false,
+                                              /*seed=*/0, /*seed2=*/0,
+                                              kNodeName);
+  EXPECT_TRUE(errors::IsNotFound(Initialize(dataset_params)));
+}
+
+std::vector<IteratorSaveAndRestoreTestCase<IndexedTFRecordDatasetParams>>
+IteratorSaveAndRestoreTestCases() {
+  return {{/*dataset_params=*/MakeDatasetParams(/*shuffle=*/false),
+           /*breakpoints=*/{0, 2, 7},
+           /*expected_outputs=*/ExpectedOutputs()},
+          {/*dataset_params=*/MakeDatasetParams(/*shuffle=*/true),
+           /*breakpoints=*/{0, 2, 7},
+           /*expected_outputs=*/ExpectedOutputs(),
+           /*compare_order=*/false}};
+}
+
+ITERATOR_SAVE_AND_RESTORE_TEST_P(IndexedTFRecordDatasetOpTest,
+                                 IndexedTFRecordDatasetParams,
+                                 IteratorSaveAndRestoreTestCases())
+
+}  // namespace
+}  // namespace experimental
+}  // namespace data
+}  // namespace tensorflow
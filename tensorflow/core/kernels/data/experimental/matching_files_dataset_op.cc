@@ -28,7 +28,6 @@ limitations under the License.
 #include "tensorflow/core/lib/io/record_reader.h"
 #include "tensorflow/core/lib/io/zlib_compression_options.h"
 #include "tensorflow/core/lib/io/zlib_inputstream.h"
-#include "tensorflow/core/platform/blocking_counter.h"
 #include "tensorflow/core/platform/env.h"
 
 namespace tensorflow {
@@ -308,55 +307,29 @@ class MatchingFilesDatasetOp : public DatasetOpKernel {
             return ret;
           }
 
-          // children_dir_status holds is_dir status for children. It can have
-          // three possible values: OK for true; FAILED_PRECONDITION for false;
-          // CANCELLED if we don't calculate IsDirectory (we might do that
-          // because there isn't any point in exploring that child path).
-          std::vector<Status> children_dir_status;
-          children_dir_status.resize(children.size());
-
-          // This IsDirectory call can be expensive for some FS. Parallelizing
-          // it.
-          auto is_directory_fn = [fs, current_dir, &children, &fixed_prefix,
-                                  &children_dir_status](int i) {
-            const string child_path = io::JoinPath(current_dir, children[i]);
-            // In case the child_path doesn't start with the fixed_prefix, then
-            // we don't need to explore this path.
-            if (!absl::StartsWith(child_path, fixed_prefix)) {
-              children_dir_status[i] =
-                  errors::Cancelled("Operation not needed");
-            } else {
-              children_dir_status[i] = fs->IsDirectory(child_path);
+          // Only the children that start with the fixed prefix need to be
+          // explored. Their statistics are read in a single batch, which the
+          // file system may parallelize or serve from directory listings.
+          std::vector<string> child_paths;
+          for (const string& child : children) {
+            string child_path = io::JoinPath(current_dir, child);
+            if (absl::StartsWith(child_path, fixed_prefix)) {
+              child_paths.push_back(std::move(child_path));
             }
-          };
-
-          BlockingCounter counter(children.size());
-          for (int i = 0; i < children.size(); i++) {
-            (*ctx->runner())([&is_directory_fn, &counter, i] {
-              is_directory_fn(i);
-              counter.DecrementCount();
-            });
           }
-          counter.Wait();
-
-          for (int i = 0; i < children.size(); i++) {
-            const string& child_dir_path =
-                io::JoinPath(current_dir, children[i]);
-            const Status& child_dir_status = children_dir_status[i];
-
-            // If the IsDirectory call was cancelled we bail.
-            if (child_dir_status.code() == tensorflow::error::CANCELLED) {
-              continue;
-            }
+          std::vector<FileStatistics> child_stats;
+          std::vector<Status> child_status;
+          fs->StatMany(child_paths, &child_stats, &child_status);
 
-            if (child_dir_status.ok()) {
+          for (int i = 0; i < child_paths.size(); i++) {
+            if (child_status[i].ok() && child_stats[i].is_directory) {
               // push the child dir for next search
-              filepath_queue_.push(PathStatus(child_dir_path, true));
+              filepath_queue_.push(PathStatus(child_paths[i], true));
             } else {
               // This case will be a file: if the file matches the pattern, push
               // it to the heap; otherwise, ignore it.
-              if (ctx->env()->MatchPath(child_dir_path, eval_pattern)) {
-                filepath_queue_.push(PathStatus(child_dir_path, false));
+              if (ctx->env()->MatchPath(child_paths[i], eval_pattern)) {
+                filepath_queue_.push(PathStatus(child_paths[i], false));
               }
             }
           }
@@ -14,8 +14,11 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/kernels/data/parallel_map_dataset_op.h"
 
+#include <algorithm>
+#include <atomic>
 #include <deque>
 #include <functional>
+#include <limits>
 #include <memory>
 #include <string>
 #include <utility>
@@ -25,6 +28,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/input_colocation_exemption_registry.h"
 #include "tensorflow/core/data/dataset_utils.h"
 #include "tensorflow/core/data/name_utils.h"
+#include "tensorflow/core/data/ring_buffer.h"
 #include "tensorflow/core/data/stats_utils.h"
 #include "tensorflow/core/framework/metrics.h"
 #include "tensorflow/core/framework/model.h"
@@ -232,8 +236,9 @@ class ParallelMapDatasetOp::Dataset : public DatasetBase {
    public:
     explicit Iterator(const Params& params)
         : DatasetIterator<Dataset>(params),
-          mu_(std::make_shared<mutex>()),
-          cond_var_(std::make_shared<condition_variable>()),
+          call_state_(std::make_shared<CallState>()),
+          mu_(call_state_, &call_state_->mu),
+          cond_var_(call_state_, &call_state_->cond_var),
           num_parallel_calls_(std::make_shared<model::SharedState>(
               params.dataset->num_parallel_calls_, mu_, cond_var_)),
           deterministic_(params.dataset->deterministic_.IsDeterministic() ||
@@ -258,6 +263,14 @@ class ParallelMapDatasetOp::Dataset : public DatasetBase {
       if (num_parallel_calls_->value == model::kAutotune) {
         num_parallel_calls_->value = GetAutotuneDefaultParallelism(ctx);
       }
+      if (deterministic_) {
+        // Autotuning keeps the parallelism within the size of the runner
+        // threadpool.
+        ordered_results_ =
+            std::make_unique<RingBuffer<std::shared_ptr<InvocationResult>>>(
+                std::max<int64_t>(num_parallel_calls_->value,
+                                  ctx->runner_threadpool_size()));
+      }
       cancellation_manager_ = std::make_unique<CancellationManager>();
       TF_RETURN_IF_ERROR(RegisterCancellationCallback(
           ctx->cancellation_manager(),
@@ -280,7 +293,7 @@ class ParallelMapDatasetOp::Dataset : public DatasetBase {
                            std::vector<Tensor>* out_tensors,
                            bool* end_of_sequence) override {
       std::shared_ptr<InvocationResult> result;
-      {
+      if (!TryPopOrderedResult(&result)) {
         mutex_lock l(*mu_);
         EnsureThreadsStarted(ctx);
         while (ShouldWait(&result)) {
@@ -322,19 +335,22 @@ class ParallelMapDatasetOp::Dataset : public DatasetBase {
       }
       mutex_lock l(*mu_);
       // Wait for all in-flight calls to complete.
-      while (num_calls_ > 0) {
+      call_state_->num_waiters++;
+      while (call_state_->num_calls > 0) {
         cond_var_->wait(l);
       }
-      if (num_calls_ != 0) {
+      call_state_->num_waiters--;
+      if (call_state_->num_calls != 0) {
         return errors::FailedPrecondition(
             "Unexpected outstanding calls encountered.");
       }
       TF_RETURN_IF_ERROR(SaveInput(ctx, writer, input_impl_));
+      const size_t num_results = NumResults();
       TF_RETURN_IF_ERROR(writer->WriteScalar(
           full_name(absl::StrCat(kInvocationResults, "_", kSize)),
-          invocation_results_.size()));
-      for (size_t i = 0; i < invocation_results_.size(); i++) {
-        const auto& result = *(invocation_results_[i]);
+          num_results));
+      for (size_t i = 0; i < num_results; i++) {
+        const auto& result = *ResultAt(i);
         std::string element_prefix =
             absl::StrCat(prefix(), "_", kInvocationResults, "[", i, "]");
         TF_RETURN_IF_ERROR(
@@ -361,10 +377,15 @@ class ParallelMapDatasetOp::Dataset : public DatasetBase {
       TF_RETURN_IF_ERROR(reader->ReadScalar(
           full_name(absl::StrCat(kInvocationResults, "_", kSize)),
           &invocation_results_size));
-      DCHECK(invocation_results_.empty());
+      DCHECK_EQ(NumResults(), 0);
       for (size_t i = 0; i < invocation_results_size; i++) {
-        invocation_results_.push_back(std::make_shared<InvocationResult>(ctx));
-        auto& result = *invocation_results_.back();
+        auto result_ptr = std::make_shared<InvocationResult>(ctx);
+        auto& result = *result_ptr;
+        if (!PushResult(std::move(result_ptr))) {
+          return errors::FailedPrecondition(
+              "Checkpointed ", invocation_results_size,
+              " invocation results, which is more than the buffer can hold.");
+        }
         std::string element_prefix =
             absl::StrCat(prefix(), "_", kInvocationResults, "[", i, "]");
         TF_RETURN_IF_ERROR(
@@ -435,15 +456,80 @@ class ParallelMapDatasetOp::Dataset : public DatasetBase {
       MemoryCheckpoint checkpoint;
     };
 
+    // Synchronization state shared between the iterator and its in-flight
+    // calls. A completing call decrements `num_calls` without holding `mu`, at
+    // which point the iterator may be destroyed, so the call keeps this state
+    // alive until it has notified the waiters.
+    struct CallState {
+      mutex mu;
+      condition_variable cond_var;
+      // Counts the number of outstanding calls.
+      std::atomic<int64_t> num_calls{0};
+      // Counts the threads waiting on `cond_var` for `num_calls` to decrease
+      // or for buffer slots to free up. A thread must increment it before it
+      // checks its wait condition, so that either it observes the update or
+      // the updating thread observes it and notifies `cond_var`.
+      std::atomic<int64_t> num_waiters{0};
+    };
+
     void CancelThreads(bool wait) TF_LOCKS_EXCLUDED(mu_) {
       cancellation_manager_->StartCancel();
       mutex_lock l(*mu_);
       cancelled_ = true;
       cond_var_->notify_all();
       // Wait for all in-flight calls to complete.
-      while (wait && num_calls_ > 0) {
+      call_state_->num_waiters++;
+      while (wait && call_state_->num_calls > 0) {
         cond_var_->wait(l);
       }
+      call_state_->num_waiters--;
+    }
+
+    // Returns the number of scheduled results that have not been consumed.
+    size_t NumResults() const TF_EXCLUSIVE_LOCKS_REQUIRED(*mu_) {
+      return deterministic_ ? ordered_results_->size()
+                            : invocation_results_.size();
+    }
+
+    // Returns the maximum number of scheduled results.
+    int64_t MaxNumResults() const TF_EXCLUSIVE_LOCKS_REQUIRED(*mu_) {
+      return deterministic_ ? ordered_results_->capacity()
+                            : std::numeric_limits<int64_t>::max();
+    }
+
+    // Appends `result` to the scheduled results. Returns false if the buffer
+    // is full.
+    bool PushResult(std::shared_ptr<InvocationResult> result)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(*mu_) {
+      if (deterministic_) return ordered_results_->TryPush(std::move(result));
+      invocation_results_.push_back(std::move(result));
+      return true;
+    }
+
+    // Returns the `index`-th scheduled result. Requires that no result is
+    // consumed concurrently.
+    const std::shared_ptr<InvocationResult>& ResultAt(size_t index) const
+        TF_EXCLUSIVE_LOCKS_REQUIRED(*mu_) {
+      return deterministic_ ? ordered_results_->at(index)
+                            : invocation_results_[index];
+    }
+
+    // Pops the next result without acquiring `mu_`, if results are returned
+    // in order and the next one has been scheduled. Upon returning true,
+    // `result` will point to the result.
+    bool TryPopOrderedResult(std::shared_ptr<InvocationResult>* result)
+        TF_LOCKS_EXCLUDED(*mu_) {
+      if (!deterministic_ || cancellation_manager_->IsCancelled() ||
+          !ordered_results_->TryPop(result)) {
+        return false;
+      }
+      // Orders the pop before reading `num_waiters`, see `CallState`.
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (call_state_->num_waiters > 0) {
+        mutex_lock l(*mu_);
+        cond_var_->notify_all();
+      }
+      return true;
     }
 
     void EnsureThreadsStarted(IteratorContext* ctx)
@@ -464,10 +550,17 @@ class ParallelMapDatasetOp::Dataset : public DatasetBase {
     void CallCompleted(const std::shared_ptr<IteratorContext>& ctx,
                        const std::shared_ptr<InvocationResult>& result)
         TF_LOCKS_EXCLUDED(*mu_) {
-      mutex_lock l(*mu_);
-      num_calls_--;
+      // In deterministic mode, the consumer waits for `result->notification`,
+      // so only threads that wait for a free call slot need to be notified.
+      const bool notify_consumer = !deterministic_;
+      std::shared_ptr<CallState> call_state = call_state_;
       result->notification.Notify();
-      cond_var_->notify_all();
+      // N.B. The iterator may be destroyed once `num_calls` is decremented.
+      call_state->num_calls--;
+      if (notify_consumer || call_state->num_waiters > 0) {
+        mutex_lock l(call_state->mu);
+        call_state->cond_var.notify_all();
+      }
     }
 
     void CallFunction(const std::shared_ptr<IteratorContext>& ctx,
@@ -568,25 +661,28 @@ class ParallelMapDatasetOp::Dataset : public DatasetBase {
       }
       auto busy = [this]() TF_EXCLUSIVE_LOCKS_REQUIRED(*mu_) -> bool {
         int64_t num_parallel_calls = num_parallel_calls_->value;
-        return num_calls_ >= num_parallel_calls ||
-               invocation_results_.size() >= num_parallel_calls;
+        return call_state_->num_calls >= num_parallel_calls ||
+               NumResults() >=
+                   std::min<int64_t>(num_parallel_calls, MaxNumResults());
       };
       while (true) {
         {
           mutex_lock l(*mu_);
+          call_state_->num_waiters++;
           while (!cancelled_ && busy()) {
             RecordStop(ctx.get());
             cond_var_->wait(l);
             RecordStart(ctx.get());
           }
+          call_state_->num_waiters--;
           if (cancelled_) {
             return;
           }
           while (!busy()) {
-            invocation_results_.push_back(
-                std::make_shared<InvocationResult>(ctx.get()));
-            new_calls.push_back(invocation_results_.back());
-            num_calls_++;
+            auto result = std::make_shared<InvocationResult>(ctx.get());
+            new_calls.push_back(result);
+            PushResult(std::move(result));
+            call_state_->num_calls++;
           }
           cond_var_->notify_all();
         }
@@ -620,9 +716,7 @@ class ParallelMapDatasetOp::Dataset : public DatasetBase {
             return false;
           }
         }
-      } else if (!invocation_results_.empty()) {
-        std::swap(*result, invocation_results_.front());
-        invocation_results_.pop_front();
+      } else if (ordered_results_->TryPop(result)) {
         cond_var_->notify_all();
         return false;
       }
@@ -643,7 +737,7 @@ class ParallelMapDatasetOp::Dataset : public DatasetBase {
           if (cancelled_) {
             return;
           }
-          num_calls = num_calls_;
+          num_calls = call_state_->num_calls;
           num_parallel_calls = num_parallel_calls_->value;
         }
         if (num_parallel_calls == 0) {
@@ -691,6 +785,8 @@ class ParallelMapDatasetOp::Dataset : public DatasetBase {
       return OkStatus();
     }
 
+    // Owns `mu_` and `cond_var_`, see `CallState`.
+    const std::shared_ptr<CallState> call_state_;
     // Used for coordination between the main thread and the runner thread.
     const std::shared_ptr<mutex> mu_;
     // Used for coordination between the main thread and the runner thread. In
@@ -704,8 +800,6 @@ class ParallelMapDatasetOp::Dataset : public DatasetBase {
     const bool deterministic_;
     const bool preserve_cardinality_;
     const bool autotune_;
-    // Counts the number of outstanding calls.
-    int64_t num_calls_ TF_GUARDED_BY(*mu_) = 0;
     // Controls cancellation of `input_impl_`. Must be ordered before
     // `input_impl_` so that `input_impl_` is destroyed first.
     std::unique_ptr<CancellationManager> cancellation_manager_;
@@ -713,9 +807,15 @@ class ParallelMapDatasetOp::Dataset : public DatasetBase {
     // Must be ordered after `cancellation_manager_` so that `input_impl_` is
     // destroyed first.
     std::unique_ptr<IteratorBase> input_impl_;
-    // Buffer for storing the invocation results.
+    // Buffer for storing the invocation results, if they may be returned out
+    // of order.
     std::deque<std::shared_ptr<InvocationResult>> invocation_results_
         TF_GUARDED_BY(*mu_);
+    // Buffer for storing the invocation results, if they are returned in
+    // order. The runner thread appends results under `mu_`, and the consumer
+    // pops them without acquiring `mu_` unless the buffer is empty.
+    std::unique_ptr<RingBuffer<std::shared_ptr<InvocationResult>>>
+        ordered_results_;
     bool cancelled_ TF_GUARDED_BY(*mu_) = false;
     std::unique_ptr<Thread> runner_thread_ TF_GUARDED_BY(*mu_);
     std::unique_ptr<Thread> stats_thread_ TF_GUARDED_BY(*mu_);
@@ -21,14 +21,44 @@ namespace tensorflow {
 namespace data {
 
 PrefetchAutotuner::PrefetchAutotuner(int64_t initial_buffer_size,
-                                     int64_t buffer_size_min)
-    : buffer_limit_(initial_buffer_size) {
+                                     int64_t buffer_size_min,
+                                     int64_t ram_budget)
+    : buffer_limit_(initial_buffer_size), ram_budget_(ram_budget) {
   if (initial_buffer_size == model::kAutotune) {
     mode_ = Mode::kUpswing;
     buffer_limit_ = std::max(int64_t{1}, buffer_size_min);
   }
 }
 
+PrefetchAutotuner::~PrefetchAutotuner() {
+  if (ram_budget_ > 0) {
+    model::BufferedBytesRegistry::Global()->Remove(this);
+  }
+}
+
+void PrefetchAutotuner::RecordElementSize(int64_t bytes) {
+  if (mode_ == Mode::kDisabled || ram_budget_ <= 0) {
+    return;
+  }
+  // Cumulative average, which stops adapting after a while; element sizes of a
+  // given input pipeline are expected to be fairly stable.
+  ++num_elements_;
+  element_bytes_ += (bytes - element_bytes_) / num_elements_;
+}
+
+int64_t PrefetchAutotuner::CapToRamBudget(int64_t new_limit) {
+  if (ram_budget_ <= 0 || element_bytes_ <= 0) {
+    return new_limit;
+  }
+  auto* registry = model::BufferedBytesRegistry::Global();
+  const int64_t budget =
+      registry->Update(this, buffer_limit_ * element_bytes_, ram_budget_);
+  new_limit =
+      std::min(new_limit, std::max(buffer_limit_, budget / element_bytes_));
+  registry->Update(this, new_limit * element_bytes_, ram_budget_);
+  return new_limit;
+}
+
 namespace {
 // Determines what strategy to use for increasing the buffer size limit. For
 // limits less than the threshold, an exponential increase is used, while for
@@ -47,12 +77,17 @@ void PrefetchAutotuner::RecordConsumption(size_t current_buffer_size) {
       return;
     case Mode::kDownswing:
       if (current_buffer_size == 0) {
+        int64_t new_limit;
         if (buffer_limit_ >= static_cast<int64_t>(kBufferLimitThreshold)) {
-          buffer_limit_ += kBufferLimitThreshold;
+          new_limit = buffer_limit_ + kBufferLimitThreshold;
         } else {
-          buffer_limit_ *= 2;
+          new_limit = buffer_limit_ * 2;
+        }
+        new_limit = CapToRamBudget(new_limit);
+        if (new_limit > buffer_limit_) {
+          buffer_limit_ = new_limit;
+          mode_ = Mode::kUpswing;
         }
-        mode_ = Mode::kUpswing;
       }
       return;
   }
@@ -33,6 +33,12 @@ namespace data {
 // if the prefetching thread is able to successfully fill the buffer at its
 // current size.
 //
+// If given a positive `ram_budget`, PrefetchAutotuner also accounts for the
+// size of the buffered elements, reported through `RecordElementSize()`, and
+// only increases the buffer_limit while the buffers of all prefetch iterators
+// and autotuned input pipelines of the process fit in that budget (see
+// `model::BufferedBytesRegistry`).
+//
 // Note: in the current implementation, we never decrease the buffer_limit().
 // This should change in the future!
 //
@@ -40,13 +46,17 @@ namespace data {
 class PrefetchAutotuner {
  public:
   explicit PrefetchAutotuner(int64_t initial_buffer_size,
-                             int64_t buffer_size_min);
+                             int64_t buffer_size_min, int64_t ram_budget = 0);
+  ~PrefetchAutotuner();
 
   int64_t buffer_limit() const { return buffer_limit_; }
 
   void RecordConsumption(size_t current_buffer_size);
   void RecordEmpty() { RecordConsumption(0); }
 
+  // Records the size of an element added to the buffer, in bytes.
+  void RecordElementSize(int64_t bytes);
+
  private:
   // PrefetchAutotuner operates as a state machine.
   enum class Mode {
@@ -62,8 +72,16 @@ class PrefetchAutotuner {
     kDownswing,
   };
 
+  // Returns the largest buffer limit that fits in this iterator's share of the
+  // RAM budget, or `new_limit` if it fits or the element size is unknown.
+  int64_t CapToRamBudget(int64_t new_limit);
+
   int64_t buffer_limit_;
   Mode mode_ = Mode::kDisabled;
+  const int64_t ram_budget_;
+  // Average size of the buffered elements, in bytes.
+  int64_t element_bytes_ = 0;
+  int64_t num_elements_ = 0;
 };
 
 }  // namespace data
@@ -103,6 +103,37 @@ TEST(PrefetchAutotuner, StartWithMin) {
   }
 }
 
+TEST(PrefetchAutotuner, CappedByRamBudget) {
+  PrefetchAutotuner t(model::kAutotune, 0, /*ram_budget=*/300);
+  t.RecordElementSize(100);
+  EXPECT_EQ(1, t.buffer_limit());
+  t.RecordConsumption(1);
+  t.RecordConsumption(0);  // Expect buffer limit to increase.
+  EXPECT_EQ(2, t.buffer_limit());
+  t.RecordConsumption(2);
+  t.RecordConsumption(0);  // Expect buffer limit to increase to the budget.
+  EXPECT_EQ(3, t.buffer_limit());
+  t.RecordConsumption(3);
+  t.RecordConsumption(0);  // Expect buffer limit to stay the same!
+  EXPECT_EQ(3, t.buffer_limit());
+}
+
+TEST(PrefetchAutotuner, SharedRamBudget) {
+  PrefetchAutotuner t1(model::kAutotune, 4, /*ram_budget=*/1000);
+  PrefetchAutotuner t2(model::kAutotune, 4, /*ram_budget=*/1000);
+  t1.RecordElementSize(100);
+  t2.RecordElementSize(100);
+  t1.RecordConsumption(4);
+  t1.RecordConsumption(0);  // Expect buffer limit to increase.
+  EXPECT_EQ(8, t1.buffer_limit());
+  t2.RecordConsumption(4);
+  t2.RecordConsumption(0);  // Expect buffer limit to increase to its share.
+  EXPECT_EQ(5, t2.buffer_limit());
+  t1.RecordConsumption(8);
+  t1.RecordConsumption(0);  // Expect buffer limit to stay the same!
+  EXPECT_EQ(8, t1.buffer_limit());
+}
+
 }  // namespace
 }  // namespace data
 }  // namespace tensorflow
@@ -25,6 +25,7 @@ limitations under the License.
 #include "tensorflow/core/lib/io/record_reader.h"
 #include "tensorflow/core/lib/io/zlib_compression_options.h"
 #include "tensorflow/core/lib/io/zlib_inputstream.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 namespace data {
@@ -52,6 +53,56 @@ bool is_cloud_tpu_gcs_fs() {
   return false;
 }
 
+// Returns true if uncompressed files should be read through a memory mapping,
+// as set by the environment variable `TF_RECORD_DATASET_USE_MMAP`.
+bool UseMemoryMappedFiles() {
+  static const bool use_mmap = [] {
+    bool use_mmap;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_RECORD_DATASET_USE_MMAP",
+                                   /*default_val=*/false, &use_mmap));
+    return use_mmap;
+  }();
+  return use_mmap;
+}
+
+// A `RandomAccessFile` that serves reads from a memory mapping of the file,
+// returning pieces of the mapping instead of copying into `scratch`.
+//
+// Read without buffering, a record is copied once, from the page cache into
+// its output tensor, instead of into the read buffer by `pread` and then into
+// the tensor.
+class MemoryMappedFile : public RandomAccessFile {
+ public:
+  MemoryMappedFile(const string& filename,
+                   std::unique_ptr<ReadOnlyMemoryRegion> region)
+      : filename_(filename), region_(std::move(region)) {}
+
+  Status Name(StringPiece* result) const override {
+    *result = filename_;
+    return OkStatus();
+  }
+
+  Status Read(uint64 offset, size_t n, StringPiece* result,
+              char* scratch) const override {
+    const uint64 length = region_->length();
+    if (offset >= length) {
+      *result = StringPiece();
+      return errors::OutOfRange("Read less bytes than requested");
+    }
+    const size_t available = std::min<uint64>(n, length - offset);
+    *result = StringPiece(static_cast<const char*>(region_->data()) + offset,
+                          available);
+    if (available < n) {
+      return errors::OutOfRange("Read less bytes than requested");
+    }
+    return OkStatus();
+  }
+
+ private:
+  const string filename_;
+  const std::unique_ptr<ReadOnlyMemoryRegion> region_;
+};
+
 class TFRecordDatasetOp::Dataset : public DatasetBase {
  public:
   explicit Dataset(OpKernelContext* ctx, std::vector<string> filenames,
@@ -249,9 +300,28 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
       }
 
       // Actually move on to next file.
-      TF_RETURN_IF_ERROR(env->NewRandomAccessFile(
-          TranslateFileName(dataset()->filenames_[current_file_index_]),
-          &file_));
+      const string filename =
+          TranslateFileName(dataset()->filenames_[current_file_index_]);
+      if (dataset()->options_.compression_type ==
+              io::RecordReaderOptions::NONE &&
+          UseMemoryMappedFiles()) {
+        std::unique_ptr<ReadOnlyMemoryRegion> region;
+        Status s = env->NewReadOnlyMemoryRegionFromFile(filename, &region);
+        if (s.ok()) {
+          file_ = std::make_unique<MemoryMappedFile>(filename,
+                                                     std::move(region));
+          // The mapping is already in memory, so reads need no buffer.
+          io::RecordReaderOptions options = dataset()->options_;
+          options.buffer_size = 0;
+          reader_ =
+              std::make_unique<io::SequentialRecordReader>(file_.get(), options);
+          return OkStatus();
+        }
+        // E.g. empty files, or file systems without memory mapping support.
+        VLOG(2) << "Falling back to reading " << filename
+                << " without a memory mapping: " << s;
+      }
+      TF_RETURN_IF_ERROR(env->NewRandomAccessFile(filename, &file_));
       reader_ = std::make_unique<io::SequentialRecordReader>(
           file_.get(), dataset()->options_);
       return OkStatus();
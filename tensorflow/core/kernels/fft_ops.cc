@@ -31,6 +31,10 @@ limitations under the License.
 
 #if (defined(GOOGLE_CUDA) && GOOGLE_CUDA) || \
     (defined(TENSORFLOW_USE_ROCM) && TENSORFLOW_USE_ROCM)
+#include <list>
+#include <utility>
+#include <vector>
+
 #include "absl/container/flat_hash_map.h"
 #include "tensorflow/core/platform/stream_executor.h"
 #endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
@@ -357,6 +361,8 @@ namespace {
 
 // Info required for caching an FFT plan.
 struct FftPlanInfo {
+  // Plans are created for a device, so they are not shared between devices.
+  const se::StreamExecutor* executor = nullptr;
   int rank = 0;
   gtl::InlinedVector<uint64_t, 3> shape{};
   gtl::InlinedVector<uint64_t, 3> input_embed{};
@@ -372,15 +378,16 @@ struct FftPlanInfo {
 
   template <typename H>
   friend inline H AbslHashValue(H h, const FftPlanInfo& key) {
-    return H::combine(std::move(h), key.rank, key.shape, key.input_embed,
-                      key.input_stride, key.input_distance, key.output_embed,
-                      key.output_stride, key.output_distance, key.type,
-                      key.batch);
+    return H::combine(std::move(h), key.executor, key.rank, key.shape,
+                      key.input_embed, key.input_stride, key.input_distance,
+                      key.output_embed, key.output_stride, key.output_distance,
+                      key.type, key.batch);
   }
 
   friend inline bool operator==(const FftPlanInfo& lhs,
                                 const FftPlanInfo& rhs) {
-    return lhs.rank == rhs.rank && lhs.shape == rhs.shape &&
+    return lhs.executor == rhs.executor && lhs.rank == rhs.rank &&
+           lhs.shape == rhs.shape &&
            lhs.input_embed == rhs.input_embed &&
            lhs.input_stride == rhs.input_stride &&
            lhs.input_distance == rhs.input_distance &&
@@ -391,13 +398,14 @@ struct FftPlanInfo {
   }
 
   // Create a key to be used for caching plans.
-  static FftPlanInfo Create(int rank, const uint64_t* shape,
-                            const uint64_t* input_embed, uint64_t input_stride,
-                            uint64_t input_distance,
+  static FftPlanInfo Create(const se::StreamExecutor* executor, int rank,
+                            const uint64_t* shape, const uint64_t* input_embed,
+                            uint64_t input_stride, uint64_t input_distance,
                             const uint64_t* output_embed,
                             uint64_t output_stride, uint64_t output_distance,
                             se::fft::Type type, int batch) {
     FftPlanInfo info;
+    info.executor = executor;
     info.rank = rank;
     info.shape.reserve(rank);
     for (int i = 0; i < rank; ++i) {
@@ -425,12 +433,12 @@ struct FftPlanInfo {
   }
 };
 
-// Multimap for storing FFT plans.
+// LRU multimap for storing FFT plans.
 //
-// Plans can be inserted into the cache as long as there is capacity.  They
-// can only be extracted from the cache for use.  The multimap is to allow
-// inserting multiple identical plans, since each can only have one simultaneous
-// user.
+// Plans can only be extracted from the cache for use, and are inserted back
+// after use.  When the cache is full, inserting a plan evicts the least
+// recently inserted one.  The multimap is to allow inserting multiple identical
+// plans, since each can only have one simultaneous user.
 //
 // Thread-safe after initialization.
 class FftPlanCache {
@@ -438,8 +446,7 @@ class FftPlanCache {
   using Key = FftPlanInfo;
   using Value = std::unique_ptr<se::fft::Plan>;
 
-  FftPlanCache(size_t capacity)
-      : mutex_(), size_(0), capacity_(capacity), cache_() {}
+  FftPlanCache(size_t capacity) : mutex_(), capacity_(capacity), cache_() {}
 
   // Finds and removes a plan from the cache if it exists.  Otherwise,
   // returns std::nullopt.
@@ -449,29 +456,41 @@ class FftPlanCache {
     if (it == cache_.end()) {
       return std::nullopt;
     }
-    Value value = std::move(it->second.back());
+    // Takes the most recently inserted plan, whose scratch space is the most
+    // likely to be in use by the allocator already.
+    auto entry = it->second.back();
     it->second.pop_back();
     if (it->second.empty()) {
       cache_.erase(it);
     }
-    --size_;
+    Value value = std::move(entry->second);
+    lru_.erase(entry);
     // Explicitly create an optional to avoid a compiler bug with gcc-7.
     return std::optional<Value>(std::move(value));
   }
 
-  // Inserts a plan into the cache as long as there is still capacity.
+  // Inserts a plan into the cache, and evicts the least recently inserted plan
+  // if the cache is over capacity.
   void Insert(Key key, Value value) {
     tsl::mutex_lock lock(mutex_);
-    if (size_ < capacity_) {
-      auto it_inserted = cache_.try_emplace(std::move(key));
-      it_inserted.first->second.push_back(std::move(value));
-      ++size_;
-    } else {
+    lru_.emplace_front(key, std::move(value));
+    cache_[std::move(key)].push_back(lru_.begin());
+    if (lru_.size() > capacity_) {
+      // The least recently inserted plan of a key is the first of its entries.
+      auto it = cache_.find(lru_.back().first);
+      DCHECK(it != cache_.end());
+      it->second.erase(it->second.begin());
+      if (it->second.empty()) {
+        cache_.erase(it);
+      }
+      lru_.pop_back();
+
       static bool already_warned = false;
       if (!already_warned) {
-        LOG(WARNING) << "The CUDA FFT plan cache capacity of " << capacity_
-                     << " has been exceeded. This may lead to extra time being"
-                     << " spent constantly creating new plans."
+        LOG(WARNING) << "The GPU FFT plan cache capacity of " << capacity_
+                     << " has been exceeded. The least recently used plans are"
+                     << " evicted, which may lead to extra time being spent"
+                     << " creating new plans."
 #if defined(CUDA_VERSION) && CUDA_VERSION >= 11000 && CUDA_VERSION < 12000
                      << " For CUDA 11.x, there is also a memory leak in cuFFT "
                      << " plan creation which may cause GPU memory usage to "
@@ -488,10 +507,15 @@ class FftPlanCache {
   }
 
  private:
+  using Entry = std::pair<Key, Value>;
+
   tsl::mutex mutex_;
-  size_t size_ TF_GUARDED_BY(mutex_);
   size_t capacity_ TF_GUARDED_BY(mutex_);
-  absl::flat_hash_map<Key, std::vector<Value>> cache_ TF_GUARDED_BY(mutex_);
+  // The plans, from the most to the least recently inserted.
+  std::list<Entry> lru_ TF_GUARDED_BY(mutex_);
+  // The entries of each key, from the least to the most recently inserted.
+  absl::flat_hash_map<Key, std::vector<std::list<Entry>::iterator>> cache_
+      TF_GUARDED_BY(mutex_);
 };
 
 template <typename T>
@@ -577,8 +601,9 @@ class FFTGPUBase : public FFTBase {
  protected:
   static const int64_t kCufftScratchSize;
   // Capacity is somewhat arbitrary.  Plans don't take up any GPU memory
-  // since the scratch space is provided externally.  We don't anticipate
-  // ever hitting this limit in practice.
+  // since the scratch space is provided externally.  Models with many FFT
+  // shapes may hit this limit, in which case the least recently used plans
+  // are evicted.
   static constexpr size_t kFftPlanCacheCapacity = 512;
 
   void DoFFT(OpKernelContext* ctx, const Tensor& in, uint64* fft_shape,
@@ -631,8 +656,9 @@ class FFTGPUBase : public FFTBase {
 
     // Look for plan in cache.
     FftPlanInfo plan_info = FftPlanInfo::Create(
-        fft_rank, fft_shape, input_embed, input_stride, input_distance,
-        output_embed, output_stride, output_distance, kFftType, batch_size);
+        stream->parent(), fft_rank, fft_shape, input_embed, input_stride,
+        input_distance, output_embed, output_stride, output_distance, kFftType,
+        batch_size);
     std::unique_ptr<se::fft::Plan> plan = nullptr;
     {
       auto plan_or = plan_cache->Extract(plan_info);
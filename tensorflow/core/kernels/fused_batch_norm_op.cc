@@ -899,6 +899,7 @@ struct FusedBatchNormImplGPU {
 
     Tensor x_maybe_transformed = x;
     Tensor x_transformed;
+    Tensor side_input_transformed;
     Tensor y_transformed;
     se::DeviceMemory<T> y_ptr;
     if (tensor_format == compute_format) {
@@ -917,6 +918,16 @@ struct FusedBatchNormImplGPU {
           x_transformed.tensor<T, 4>());
       x_maybe_transformed = x_transformed;
 
+      if (side_input != nullptr) {
+        OP_REQUIRES_OK(context, context->allocate_temp(
+                                    DataTypeToEnum<T>::value,
+                                    x_transformed_shape, &side_input_transformed));
+        functor::NHWCToNCHW<GPUDevice, T, 4>()(
+            context->eigen_device<GPUDevice>(), side_input->tensor<T, 4>(),
+            side_input_transformed.tensor<T, 4>());
+        side_input = &side_input_transformed;
+      }
+
       TensorShape y_transformed_shape;
       OP_REQUIRES_OK(context, ShapeFromFormatWithStatus(
                                   compute_format, batch_size, height, width,
@@ -1163,6 +1174,10 @@ struct FusedBatchNormGradImplGPU {
     Tensor y_backprop_transformed;
     Tensor x_transformed;
 
+    // Inputs and outputs of the fused activation and side input, if any.
+    Tensor y_transformed;
+    Tensor side_input_backprop_transformed;
+
     // Outputs
     Tensor x_backprop_transformed;
     se::DeviceMemory<T> x_backprop_ptr;
@@ -1210,6 +1225,22 @@ struct FusedBatchNormGradImplGPU {
                                             &x_backprop_transformed));
       x_backprop_ptr =
           StreamExecutorUtil::AsDeviceMemory<T>(x_backprop_transformed);
+
+      if (y != nullptr) {
+        OP_REQUIRES_OK(context, context->allocate_temp(
+                                    DataTypeToEnum<T>::value,
+                                    x_transformed_shape, &y_transformed));
+        functor::NHWCToNCHW<GPUDevice, T, 4>()(
+            context->eigen_device<GPUDevice>(), y->tensor<T, 4>(),
+            y_transformed.tensor<T, 4>());
+        y = &y_transformed;
+      }
+      if (side_input_backprop != nullptr) {
+        OP_REQUIRES_OK(context, context->allocate_temp(
+                                    DataTypeToEnum<T>::value,
+                                    x_transformed_shape,
+                                    &side_input_backprop_transformed));
+      }
     } else {
       context->SetStatus(errors::Internal(
           "Unsupported tensor format: ", ToString(tensor_format),
@@ -1250,9 +1281,14 @@ struct FusedBatchNormGradImplGPU {
         StreamExecutorUtil::AsDeviceMemory<U>(*scale_backprop);
     auto offset_backprop_ptr =
         StreamExecutorUtil::AsDeviceMemory<U>(*offset_backprop);
+    Tensor* side_input_backprop_maybe_transformed =
+        side_input_backprop_transformed.IsInitialized()
+            ? &side_input_backprop_transformed
+            : side_input_backprop;
     auto side_input_backprop_ptr =
-        side_input_backprop != nullptr
-            ? StreamExecutorUtil::AsDeviceMemory<T>(*side_input_backprop)
+        side_input_backprop_maybe_transformed != nullptr
+            ? StreamExecutorUtil::AsDeviceMemory<T>(
+                  *side_input_backprop_maybe_transformed)
             : se::DeviceMemory<T>();
 
     std::unique_ptr<functor::CudnnBatchNormAllocatorInTemp<uint8>>
@@ -1296,6 +1332,13 @@ struct FusedBatchNormGradImplGPU {
           context->eigen_device<GPUDevice>(),
           const_cast<const Tensor&>(x_backprop_transformed).tensor<T, 4>(),
           x_backprop->tensor<T, 4>());
+      if (side_input_backprop_transformed.IsInitialized()) {
+        functor::NCHWToNHWC<GPUDevice, T, 4>()(
+            context->eigen_device<GPUDevice>(),
+            const_cast<const Tensor&>(side_input_backprop_transformed)
+                .tensor<T, 4>(),
+            side_input_backprop->tensor<T, 4>());
+      }
     }
   }
 };
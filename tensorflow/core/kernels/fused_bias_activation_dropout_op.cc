@@ -0,0 +1,301 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// See docs in ../ops/nn_ops.cc.
+
+#define EIGEN_USE_THREADS
+
+#include "tensorflow/core/kernels/fused_bias_activation_dropout_op.h"
+
+#include <algorithm>
+#include <limits>
+#include <string>
+
+#include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/register_types.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/kernels/fill_functor.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/platform/random.h"
+#include "tensorflow/core/util/guarded_philox_random.h"
+
+namespace tensorflow {
+
+typedef Eigen::ThreadPoolDevice CPUDevice;
+typedef Eigen::GpuDevice GPUDevice;
+
+namespace functor {
+
+template <typename T>
+struct FusedBiasActivationDropout<CPUDevice, T> {
+  void operator()(const CPUDevice& d, const T* value, const T* bias,
+                  int64_t num_elements, int64_t channels,
+                  FusedBiasActivationType activation,
+                  const DropoutParams& dropout, random::PhiloxRandom gen,
+                  T* output, uint8* mask) {
+    const int64_t num_bytes =
+        (num_elements + kDropoutMaskBits - 1) / kDropoutMaskBits;
+    const Eigen::TensorOpCost cost(
+        2 * kDropoutMaskBits * sizeof(T), kDropoutMaskBits * sizeof(T) + 1,
+        kDropoutMaskBits * 10 * Eigen::TensorOpCost::AddCost<T>());
+    d.parallelFor(num_bytes, cost, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; ++i) {
+        mask[i] = FusedBiasActivationDropoutByte(i, value, bias, num_elements,
+                                                 channels, activation, dropout,
+                                                 gen, output);
+      }
+    });
+  }
+};
+
+template <typename T>
+struct FusedBiasActivationDropoutGrad<CPUDevice, T> {
+  void operator()(const CPUDevice& d, const T* gradients, const T* output,
+                  const uint8* mask, int64_t num_elements, int64_t channels,
+                  FusedBiasActivationType activation,
+                  const DropoutParams& dropout, T* value_backprop,
+                  T* bias_backprop) {
+    const Eigen::TensorOpCost cost(2 * sizeof(T) + 1, sizeof(T),
+                                   2 * Eigen::TensorOpCost::MulCost<T>());
+    d.parallelFor(num_elements, cost, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; ++i) {
+        const bool keep =
+            (mask[i / kDropoutMaskBits] >> (i % kDropoutMaskBits)) & 1;
+        value_backprop[i] = FusedBiasActivationDropoutGradElement(
+            gradients[i], output[i], keep, activation, dropout);
+      }
+    });
+
+    using Accum = typename std::conditional<
+        std::is_same<T, Eigen::half>::value, float, T>::type;
+    typename TTypes<T, 2>::ConstTensor backprop(
+        value_backprop, num_elements / channels, channels);
+    typename TTypes<T>::Tensor bias_grad(bias_backprop, channels);
+    const Eigen::array<Eigen::DenseIndex, 1> kRows{0};
+    bias_grad.device(d) =
+        backprop.template cast<Accum>().sum(kRows).template cast<T>();
+  }
+};
+
+}  // namespace functor
+
+namespace {
+
+Status GetFusedBiasActivationType(const string& name,
+                                  functor::FusedBiasActivationType* type) {
+  if (name == "Relu") {
+    *type = functor::FusedBiasActivationType::kRelu;
+  } else if (name == "Relu6") {
+    *type = functor::FusedBiasActivationType::kRelu6;
+  } else {
+    return errors::InvalidArgument("Unsupported activation: ", name);
+  }
+  return OkStatus();
+}
+
+// Returns the parameters of the dropout at `rate_t`, a scalar in [0, 1).
+template <typename T>
+Status GetDropoutParams(const Tensor& rate_t, functor::DropoutParams* params) {
+  if (!TensorShapeUtils::IsScalar(rate_t.shape())) {
+    return errors::InvalidArgument("Dropout rate must be a scalar tensor: ",
+                                   rate_t.shape().DebugString());
+  }
+  const double rate = static_cast<double>(rate_t.scalar<T>()());
+  if (!(rate >= 0 && rate < 1)) {
+    return errors::InvalidArgument("Dropout rate must be in [0, 1): ", rate);
+  }
+  params->threshold = static_cast<uint32>(
+      std::min(rate * 4294967296.0,
+               static_cast<double>(std::numeric_limits<uint32>::max())));
+  params->scale = 1 / (1 - rate);
+  return OkStatus();
+}
+
+int64_t GetSeed(const Tensor& seed_t) {
+  return seed_t.dtype() == DT_INT32 ? seed_t.scalar<int32>()()
+                                    : seed_t.scalar<int64_t>()();
+}
+
+}  // namespace
+
+template <typename Device, typename T>
+class FusedBiasActivationDropoutOp : public OpKernel {
+ public:
+  explicit FusedBiasActivationDropoutOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    string activation;
+    OP_REQUIRES_OK(context, context->GetAttr("activation", &activation));
+    OP_REQUIRES_OK(context,
+                   GetFusedBiasActivationType(activation, &activation_));
+    generator_.Init(0, 0);
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor& value = context->input(0);
+    const Tensor& bias = context->input(1);
+    OP_REQUIRES(context, TensorShapeUtils::IsMatrixOrHigher(value.shape()),
+                errors::InvalidArgument("Input tensor must be at least 2D: ",
+                                        value.shape().DebugString()));
+    OP_REQUIRES(context, TensorShapeUtils::IsVector(bias.shape()),
+                errors::InvalidArgument("Biases must be 1D: ",
+                                        bias.shape().DebugString()));
+    const int64_t channels = value.dim_size(value.dims() - 1);
+    OP_REQUIRES(context, bias.dim_size(0) == channels,
+                errors::InvalidArgument(
+                    "Must provide as many biases as the last dimension "
+                    "of the input tensor: ",
+                    bias.shape().DebugString(), " vs. ",
+                    value.shape().DebugString()));
+    functor::DropoutParams dropout;
+    OP_REQUIRES_OK(context, GetDropoutParams<T>(context->input(2), &dropout));
+    const Tensor& seed1 = context->input(3);
+    const Tensor& seed2 = context->input(4);
+    OP_REQUIRES(context,
+                TensorShapeUtils::IsScalar(seed1.shape()) &&
+                    TensorShapeUtils::IsScalar(seed2.shape()),
+                errors::InvalidArgument("Dropout seeds must be scalars: ",
+                                        seed1.shape().DebugString(), " and ",
+                                        seed2.shape().DebugString()));
+
+    const int64_t num_elements = value.NumElements();
+    const int64_t num_bytes = (num_elements + functor::kDropoutMaskBits - 1) /
+                              functor::kDropoutMaskBits;
+    Tensor* output = nullptr;
+    OP_REQUIRES_OK(context, context->forward_input_or_allocate_output(
+                                {0}, 0, value.shape(), &output));
+    Tensor* mask = nullptr;
+    OP_REQUIRES_OK(context, context->allocate_output(
+                                1, TensorShape({num_bytes}), &mask));
+    if (num_elements == 0) return;
+
+    // As in the Dropout op, the seeds are reset at every call unless seed1 is
+    // 0, so that the masks of the seeded ops are the same at every step.
+    const int64_t seed = GetSeed(seed1);
+    generator_.ResetSeeds(seed != 0 ? seed : random::New64(), GetSeed(seed2));
+    random::PhiloxRandom gen =
+        generator_.ReserveSamples32(num_bytes * functor::kDropoutMaskBits);
+
+    functor::FusedBiasActivationDropout<Device, T>()(
+        context->eigen_device<Device>(), value.flat<T>().data(),
+        bias.flat<T>().data(), num_elements, channels, activation_, dropout,
+        gen, output->flat<T>().data(), mask->flat<uint8>().data());
+  }
+
+ private:
+  functor::FusedBiasActivationType activation_;
+  GuardedPhiloxRandom generator_;
+};
+
+template <typename Device, typename T>
+class FusedBiasActivationDropoutGradOp : public OpKernel {
+ public:
+  explicit FusedBiasActivationDropoutGradOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    string activation;
+    OP_REQUIRES_OK(context, context->GetAttr("activation", &activation));
+    OP_REQUIRES_OK(context,
+                   GetFusedBiasActivationType(activation, &activation_));
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor& gradients = context->input(0);
+    const Tensor& output = context->input(1);
+    OP_REQUIRES(context, TensorShapeUtils::IsMatrixOrHigher(gradients.shape()),
+                errors::InvalidArgument("Gradients must be at least 2D: ",
+                                        gradients.shape().DebugString()));
+    OP_REQUIRES(context, gradients.shape() == output.shape(),
+                errors::InvalidArgument(
+                    "Gradients and output must have the same shape: ",
+                    gradients.shape().DebugString(), " vs. ",
+                    output.shape().DebugString()));
+    functor::DropoutParams dropout;
+    OP_REQUIRES_OK(context, GetDropoutParams<T>(context->input(2), &dropout));
+    const Tensor& mask = context->input(3);
+    const int64_t num_elements = gradients.NumElements();
+    const int64_t num_bytes = (num_elements + functor::kDropoutMaskBits - 1) /
+                              functor::kDropoutMaskBits;
+    OP_REQUIRES(context, mask.NumElements() == num_bytes,
+                errors::InvalidArgument("The mask of ", num_elements,
+                                        " elements must have ", num_bytes,
+                                        " bytes, got ", mask.NumElements()));
+    const int64_t channels = gradients.dim_size(gradients.dims() - 1);
+    OP_REQUIRES(context,
+                num_elements <= std::numeric_limits<int32>::max() &&
+                    channels <= std::numeric_limits<int32>::max(),
+                errors::InvalidArgument("Gradients are too large: ",
+                                        gradients.shape().DebugString()));
+
+    Tensor* value_backprop = nullptr;
+    OP_REQUIRES_OK(context, context->forward_input_or_allocate_output(
+                                {0}, 0, gradients.shape(), &value_backprop));
+    Tensor* bias_backprop = nullptr;
+    OP_REQUIRES_OK(context, context->allocate_output(
+                                1, TensorShape({channels}), &bias_backprop));
+    const Device& d = context->eigen_device<Device>();
+    if (num_elements == 0) {
+      functor::SetZeroFunctor<Device, T>()(d, bias_backprop->flat<T>());
+      return;
+    }
+
+    functor::FusedBiasActivationDropoutGrad<Device, T>()(
+        d, gradients.flat<T>().data(), output.flat<T>().data(),
+        mask.flat<uint8>().data(), num_elements, channels, activation_,
+        dropout, value_backprop->flat<T>().data(),
+        bias_backprop->flat<T>().data());
+  }
+
+ private:
+  functor::FusedBiasActivationType activation_;
+};
+
+#define REGISTER_KERNELS(T)                                                \
+  REGISTER_KERNEL_BUILDER(Name("_FusedBiasActivationDropout")              \
+                              .Device(DEVICE_CPU)                          \
+                              .TypeConstraint<T>("T"),                     \
+                          FusedBiasActivationDropoutOp<CPUDevice, T>);     \
+  REGISTER_KERNEL_BUILDER(Name("_FusedBiasActivationDropoutGrad")          \
+                              .Device(DEVICE_CPU)                          \
+                              .TypeConstraint<T>("T"),                     \
+                          FusedBiasActivationDropoutGradOp<CPUDevice, T>);
+TF_CALL_half(REGISTER_KERNELS);
+TF_CALL_float(REGISTER_KERNELS);
+TF_CALL_double(REGISTER_KERNELS);
+#undef REGISTER_KERNELS
+
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+
+#define REGISTER_KERNELS(T)                                            \
+  REGISTER_KERNEL_BUILDER(Name("_FusedBiasActivationDropout")          \
+                              .Device(DEVICE_GPU)                      \
+                              .TypeConstraint<T>("T")                  \
+                              .HostMemory("rate")                      \
+                              .HostMemory("seed1")                     \
+                              .HostMemory("seed2"),                    \
+                          FusedBiasActivationDropoutOp<GPUDevice, T>); \
+  REGISTER_KERNEL_BUILDER(Name("_FusedBiasActivationDropoutGrad")      \
+                              .Device(DEVICE_GPU)                      \
+                              .TypeConstraint<T>("T")                  \
+                              .HostMemory("rate"),                     \
+                          FusedBiasActivationDropoutGradOp<GPUDevice, T>);
+TF_CALL_half(REGISTER_KERNELS);
+TF_CALL_float(REGISTER_KERNELS);
+TF_CALL_double(REGISTER_KERNELS);
+#undef REGISTER_KERNELS
+
+#endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+
+}  // namespace tensorflow
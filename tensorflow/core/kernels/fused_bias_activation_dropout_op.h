@@ -0,0 +1,125 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_KERNELS_FUSED_BIAS_ACTIVATION_DROPOUT_OP_H_
+#define TENSORFLOW_CORE_KERNELS_FUSED_BIAS_ACTIVATION_DROPOUT_OP_H_
+
+#include <type_traits>
+
+#include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/lib/random/philox_random.h"
+
+namespace tensorflow {
+namespace functor {
+
+enum class FusedBiasActivationType : int8 { kRelu, kRelu6 };
+
+// Each byte of the dropout mask holds the bits of 8 consecutive elements, the
+// lowest bit for the first one. Bit k of byte i is set if element 8 * i + k
+// is kept, which is decided by the 32-bit Philox sample 8 * i + k, so that the
+// masks don't depend on the device or on the partitioning of the elements.
+constexpr int kDropoutMaskBits = 8;
+
+// The parameters of the dropout: an element is kept if its 32-bit random
+// sample is at least `threshold`, and the kept elements are multiplied by
+// `scale`.
+struct DropoutParams {
+  uint32 threshold;
+  float scale;
+};
+
+// Computes the elements [8 * i, min(8 * i + 8, num_elements)) of the output
+// of the fused op, and returns their byte of the dropout mask. `gen` must be
+// at the start of the reserved samples.
+template <typename T>
+EIGEN_DEVICE_FUNC EIGEN_ALWAYS_INLINE uint8 FusedBiasActivationDropoutByte(
+    int64_t i, const T* value, const T* bias, int64_t num_elements,
+    int64_t channels, FusedBiasActivationType activation,
+    const DropoutParams& dropout, random::PhiloxRandom gen, T* output) {
+  using Compute =
+      typename std::conditional<std::is_same<T, Eigen::half>::value, float,
+                                T>::type;
+  gen.Skip(i * kDropoutMaskBits / 4);
+  const auto samples_lo = gen();
+  const auto samples_hi = gen();
+  uint8 mask = 0;
+  const int64_t begin = i * kDropoutMaskBits;
+  int64_t c = begin % channels;
+  for (int k = 0; k < kDropoutMaskBits && begin + k < num_elements; ++k) {
+    Compute x = static_cast<Compute>(value[begin + k]) +
+                static_cast<Compute>(bias[c]);
+    x = Eigen::numext::maxi(x, Compute(0));
+    if (activation == FusedBiasActivationType::kRelu6) {
+      x = Eigen::numext::mini(x, Compute(6));
+    }
+    const uint32 sample = k < 4 ? samples_lo[k] : samples_hi[k - 4];
+    const bool keep = sample >= dropout.threshold;
+    output[begin + k] =
+        static_cast<T>(keep ? x * static_cast<Compute>(dropout.scale) : 0);
+    mask |= static_cast<uint8>(keep) << k;
+    if (++c == channels) c = 0;
+  }
+  return mask;
+}
+
+// Returns the gradient of the fused op with respect to its input `value` at
+// an element, given the element of its output and its bit of the mask.
+template <typename T>
+EIGEN_DEVICE_FUNC EIGEN_ALWAYS_INLINE T FusedBiasActivationDropoutGradElement(
+    T gradient, T output, bool keep, FusedBiasActivationType activation,
+    const DropoutParams& dropout) {
+  using Compute =
+      typename std::conditional<std::is_same<T, Eigen::half>::value, float,
+                                T>::type;
+  // The output of the kept elements is the activation times the scale, which
+  // is enough to tell where the activation is not saturated.
+  const Compute y = static_cast<Compute>(output);
+  bool active = keep && y > Compute(0);
+  if (activation == FusedBiasActivationType::kRelu6) {
+    active = active && y < static_cast<Compute>(6 * dropout.scale);
+  }
+  return static_cast<T>(
+      active ? static_cast<Compute>(gradient) *
+                   static_cast<Compute>(dropout.scale)
+             : Compute(0));
+}
+
+// Computes output = dropout(activation(value + bias)), where bias is added to
+// the last dimension of value, and writes the bits of the dropout mask.
+template <typename Device, typename T>
+struct FusedBiasActivationDropout {
+  void operator()(const Device& d, const T* value, const T* bias,
+                  int64_t num_elements, int64_t channels,
+                  FusedBiasActivationType activation,
+                  const DropoutParams& dropout, random::PhiloxRandom gen,
+                  T* output, uint8* mask);
+};
+
+// Computes the gradients of FusedBiasActivationDropout with respect to its
+// value and its bias from the gradients and the output of the forward op.
+template <typename Device, typename T>
+struct FusedBiasActivationDropoutGrad {
+  void operator()(const Device& d, const T* gradients, const T* output,
+                  const uint8* mask, int64_t num_elements, int64_t channels,
+                  FusedBiasActivationType activation,
+                  const DropoutParams& dropout, T* value_backprop,
+                  T* bias_backprop);
+};
+
+}  // namespace functor
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_FUSED_BIAS_ACTIVATION_DROPOUT_OP_H_
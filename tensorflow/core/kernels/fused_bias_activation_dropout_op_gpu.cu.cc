@@ -0,0 +1,117 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+
+#define EIGEN_USE_GPU
+
+#include "tensorflow/core/framework/register_types.h"
+#include "tensorflow/core/kernels/bias_op_gpu.h"
+#include "tensorflow/core/kernels/fused_bias_activation_dropout_op.h"
+#include "tensorflow/core/util/gpu_kernel_helper.h"
+#include "tensorflow/core/util/tensor_format.h"
+
+namespace tensorflow {
+
+typedef Eigen::GpuDevice GPUDevice;
+
+namespace functor {
+
+namespace {
+
+// Each thread computes the 8 elements of a byte of the mask, which are read and
+// written in a single pass, and draws their random samples in 2 Philox calls.
+template <typename T>
+__global__ void FusedBiasActivationDropoutKernel(
+    int64_t num_bytes, const T* __restrict__ value, const T* __restrict__ bias,
+    int64_t num_elements, int64_t channels, FusedBiasActivationType activation,
+    DropoutParams dropout, random::PhiloxRandom gen, T* __restrict__ output,
+    uint8* __restrict__ mask) {
+  GPU_1D_KERNEL_LOOP(i, num_bytes) {
+    mask[i] = FusedBiasActivationDropoutByte(i, value, bias, num_elements,
+                                             channels, activation, dropout,
+                                             gen, output);
+  }
+}
+
+template <typename T>
+__global__ void FusedBiasActivationDropoutGradKernel(
+    int64_t num_elements, const T* __restrict__ gradients,
+    const T* __restrict__ output, const uint8* __restrict__ mask,
+    FusedBiasActivationType activation, DropoutParams dropout,
+    T* __restrict__ value_backprop) {
+  GPU_1D_KERNEL_LOOP(i, num_elements) {
+    const bool keep =
+        (mask[i / kDropoutMaskBits] >> (i % kDropoutMaskBits)) & 1;
+    value_backprop[i] = FusedBiasActivationDropoutGradElement(
+        gradients[i], output[i], keep, activation, dropout);
+  }
+}
+
+}  // namespace
+
+template <typename T>
+struct FusedBiasActivationDropout<GPUDevice, T> {
+  void operator()(const GPUDevice& d, const T* value, const T* bias,
+                  int64_t num_elements, int64_t channels,
+                  FusedBiasActivationType activation,
+                  const DropoutParams& dropout, random::PhiloxRandom gen,
+                  T* output, uint8* mask) {
+    const int64_t num_bytes =
+        (num_elements + kDropoutMaskBits - 1) / kDropoutMaskBits;
+    GpuLaunchConfig config = GetGpuLaunchConfig(
+        num_bytes, d, FusedBiasActivationDropoutKernel<T>, 0, 0);
+    TF_CHECK_OK(GpuLaunchKernel(FusedBiasActivationDropoutKernel<T>,
+                                config.block_count, config.thread_per_block, 0,
+                                d.stream(), num_bytes, value, bias,
+                                num_elements, channels, activation, dropout,
+                                gen, output, mask));
+  }
+};
+
+template <typename T>
+struct FusedBiasActivationDropoutGrad<GPUDevice, T> {
+  void operator()(const GPUDevice& d, const T* gradients, const T* output,
+                  const uint8* mask, int64_t num_elements, int64_t channels,
+                  FusedBiasActivationType activation,
+                  const DropoutParams& dropout, T* value_backprop,
+                  T* bias_backprop) {
+    GpuLaunchConfig config = GetGpuLaunchConfig(
+        num_elements, d, FusedBiasActivationDropoutGradKernel<T>, 0, 0);
+    TF_CHECK_OK(GpuLaunchKernel(FusedBiasActivationDropoutGradKernel<T>,
+                                config.block_count, config.thread_per_block, 0,
+                                d.stream(), num_elements, gradients, output,
+                                mask, activation, dropout, value_backprop));
+    // The gradients of the bias are reduced as in BiasAddGrad. The op checked
+    // that the sizes fit in 32 bits.
+    BiasGradGPU<T>::compute(d, value_backprop, bias_backprop,
+                            static_cast<int32>(num_elements / channels),
+                            /*height=*/1, /*width=*/1, /*depth=*/1,
+                            static_cast<int32>(channels), FORMAT_NHWC);
+  }
+};
+
+#define DEFINE_GPU_SPECS(T)                                 \
+  template struct FusedBiasActivationDropout<GPUDevice, T>; \
+  template struct FusedBiasActivationDropoutGrad<GPUDevice, T>;
+TF_CALL_half(DEFINE_GPU_SPECS);
+TF_CALL_float(DEFINE_GPU_SPECS);
+TF_CALL_double(DEFINE_GPU_SPECS);
+#undef DEFINE_GPU_SPECS
+
+}  // namespace functor
+}  // namespace tensorflow
+
+#endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
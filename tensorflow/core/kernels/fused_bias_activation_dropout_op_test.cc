@@ -0,0 +1,150 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+
+class FusedBiasActivationDropoutOpTest : public OpsTestBase {
+ protected:
+  Status InitForward(const string& activation) {
+    TF_RETURN_IF_ERROR(NodeDefBuilder("fused", "_FusedBiasActivationDropout")
+                           .Input(FakeInput(DT_FLOAT))
+                           .Input(FakeInput(DT_FLOAT))
+                           .Input(FakeInput(DT_FLOAT))
+                           .Input(FakeInput(DT_INT64))
+                           .Input(FakeInput(DT_INT64))
+                           .Attr("activation", activation)
+                           .Finalize(node_def()));
+    return InitOp();
+  }
+
+  Status InitGrad(const string& activation) {
+    TF_RETURN_IF_ERROR(
+        NodeDefBuilder("fused_grad", "_FusedBiasActivationDropoutGrad")
+            .Input(FakeInput(DT_FLOAT))
+            .Input(FakeInput(DT_FLOAT))
+            .Input(FakeInput(DT_FLOAT))
+            .Input(FakeInput(DT_UINT8))
+            .Attr("activation", activation)
+            .Finalize(node_def()));
+    return InitOp();
+  }
+
+  void AddSeeds(int64_t seed1, int64_t seed2) {
+    AddInputFromArray<int64_t>(TensorShape({}), {seed1});
+    AddInputFromArray<int64_t>(TensorShape({}), {seed2});
+  }
+};
+
+TEST_F(FusedBiasActivationDropoutOpTest, NoDropout) {
+  TF_ASSERT_OK(InitForward("Relu6"));
+  AddInputFromArray<float>(TensorShape({2, 5}),
+                           {-2, -1, 0, 1, 2, 3, 4, 5, 6, 7});
+  AddInputFromArray<float>(TensorShape({5}), {1, 1, 1, 1, 1});
+  AddInputFromArray<float>(TensorShape({}), {0});
+  AddSeeds(0, 0);
+  TF_ASSERT_OK(RunOpKernel());
+
+  Tensor expected(allocator(), DT_FLOAT, TensorShape({2, 5}));
+  test::FillValues<float>(&expected, {0, 0, 1, 2, 3, 4, 5, 6, 6, 6});
+  test::ExpectTensorEqual<float>(expected, *GetOutput(0));
+  // The bits of the 10 elements, 8 per byte.
+  Tensor expected_mask(allocator(), DT_UINT8, TensorShape({2}));
+  test::FillValues<uint8>(&expected_mask, {0xff, 0x03});
+  test::ExpectTensorEqual<uint8>(expected_mask, *GetOutput(1));
+}
+
+TEST_F(FusedBiasActivationDropoutOpTest, DropoutMatchesMask) {
+  TF_ASSERT_OK(InitForward("Relu"));
+  constexpr int kNumElements = 1000;
+  std::vector<float> value(kNumElements);
+  for (int i = 0; i < kNumElements; ++i) value[i] = i % 7 - 2;
+  AddInputFromArray<float>(TensorShape({kNumElements / 4, 4}), value);
+  AddInputFromArray<float>(TensorShape({4}), {0, 1, 2, 3});
+  AddInputFromArray<float>(TensorShape({}), {0.5});
+  AddSeeds(1, 2);
+  TF_ASSERT_OK(RunOpKernel());
+
+  const auto output = GetOutput(0)->flat<float>();
+  const auto mask = GetOutput(1)->flat<uint8>();
+  ASSERT_EQ(mask.size(), kNumElements / 8);
+  int num_kept = 0;
+  for (int i = 0; i < kNumElements; ++i) {
+    const bool keep = (mask(i / 8) >> (i % 8)) & 1;
+    const float activation = std::max(value[i] + i % 4, 0.0f);
+    EXPECT_EQ(output(i), keep ? 2 * activation : 0) << i;
+    num_kept += keep;
+  }
+  EXPECT_GT(num_kept, kNumElements * 0.4);
+  EXPECT_LT(num_kept, kNumElements * 0.6);
+
+  // The masks of the seeded ops are the same at every call.
+  const Tensor first_mask = *GetOutput(1);
+  TF_ASSERT_OK(RunOpKernel());
+  test::ExpectTensorEqual<uint8>(first_mask, *GetOutput(1));
+}
+
+TEST_F(FusedBiasActivationDropoutOpTest, Grad) {
+  TF_ASSERT_OK(InitGrad("Relu6"));
+  AddInputFromArray<float>(TensorShape({3, 3}), {1, 2, 3, 4, 5, 6, 7, 8, 9});
+  // The output of a dropout of rate 0.5: the activations are doubled.
+  AddInputFromArray<float>(TensorShape({3, 3}), {2, 0, 4, 0, 12, 6, 8, 2, 0});
+  AddInputFromArray<float>(TensorShape({}), {0.5});
+  // Elements 1 and 3 are dropped.
+  AddInputFromArray<uint8>(TensorShape({2}), {0xf5, 0x01});
+  TF_ASSERT_OK(RunOpKernel());
+
+  Tensor expected_value(allocator(), DT_FLOAT, TensorShape({3, 3}));
+  test::FillValues<float>(&expected_value, {2, 0, 6, 0, 0, 12, 14, 16, 0});
+  test::ExpectTensorEqual<float>(expected_value, *GetOutput(0));
+  Tensor expected_bias(allocator(), DT_FLOAT, TensorShape({3}));
+  test::FillValues<float>(&expected_bias, {16, 16, 18});
+  test::ExpectTensorEqual<float>(expected_bias, *GetOutput(1));
+}
+
+TEST_F(FusedBiasActivationDropoutOpTest, RejectsInvalidRate) {
+  TF_ASSERT_OK(InitForward("Relu"));
+  AddInputFromArray<float>(TensorShape({1, 2}), {1, 2});
+  AddInputFromArray<float>(TensorShape({2}), {1, 1});
+  AddInputFromArray<float>(TensorShape({}), {1});
+  AddSeeds(0, 0);
+  Status s = RunOpKernel();
+  EXPECT_TRUE(errors::IsInvalidArgument(s)) << s;
+}
+
+TEST_F(FusedBiasActivationDropoutOpTest, RejectsMaskOfWrongSize) {
+  TF_ASSERT_OK(InitGrad("Relu"));
+  AddInputFromArray<float>(TensorShape({3, 3}), {1, 2, 3, 4, 5, 6, 7, 8, 9});
+  AddInputFromArray<float>(TensorShape({3, 3}), {1, 2, 3, 4, 5, 6, 7, 8, 9});
+  AddInputFromArray<float>(TensorShape({}), {0});
+  AddInputFromArray<uint8>(TensorShape({1}), {0xff});
+  Status s = RunOpKernel();
+  EXPECT_TRUE(errors::IsInvalidArgument(s)) << s;
+}
+
+}  // namespace tensorflow
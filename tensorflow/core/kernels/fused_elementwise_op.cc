@@ -0,0 +1,179 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// See docs in ../ops/math_ops.cc.
+
+#define EIGEN_USE_THREADS
+
+#include "tensorflow/core/kernels/fused_elementwise_op.h"
+
+#include <string>
+#include <vector>
+
+#include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/register_types.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/lib/core/errors.h"
+
+namespace tensorflow {
+
+typedef Eigen::ThreadPoolDevice CPUDevice;
+typedef Eigen::GpuDevice GPUDevice;
+
+namespace functor {
+
+template <typename T>
+struct FusedElementwise<CPUDevice, T> {
+  void operator()(const CPUDevice& d, const FusedElementwiseProgram& program,
+                  const FusedElementwiseArgs<T>& args, int64_t size,
+                  T* output) {
+    // The cost of an op is about the cost of the Eigen cwise ops.
+    const Eigen::TensorOpCost cost(
+        sizeof(T) * (program.num_ops + 1), sizeof(T),
+        program.num_ops * Eigen::TensorOpCost::AddCost<T>());
+    d.parallelFor(size, cost, [&program, &args, output](int64_t begin,
+                                                        int64_t end) {
+      for (int64_t i = begin; i < end; ++i) {
+        output[i] = EvaluateFusedElementwise(program, args, i);
+      }
+    });
+  }
+};
+
+}  // namespace functor
+
+namespace {
+
+// Returns the op of _FusedElementwise named `name`, and whether it is binary.
+Status GetFusedElementwiseOpType(const string& name,
+                                 functor::FusedElementwiseOpType* op,
+                                 bool* is_binary) {
+  using functor::FusedElementwiseOpType;
+  *is_binary = true;
+  if (name == "Add" || name == "AddV2") {
+    *op = FusedElementwiseOpType::kAdd;
+  } else if (name == "Sub") {
+    *op = FusedElementwiseOpType::kSub;
+  } else if (name == "Mul") {
+    *op = FusedElementwiseOpType::kMul;
+  } else if (name == "Maximum") {
+    *op = FusedElementwiseOpType::kMaximum;
+  } else if (name == "Minimum") {
+    *op = FusedElementwiseOpType::kMinimum;
+  } else {
+    *is_binary = false;
+    if (name == "Neg") {
+      *op = FusedElementwiseOpType::kNeg;
+    } else if (name == "Relu") {
+      *op = FusedElementwiseOpType::kRelu;
+    } else if (name == "Relu6") {
+      *op = FusedElementwiseOpType::kRelu6;
+    } else if (name == "Sigmoid") {
+      *op = FusedElementwiseOpType::kSigmoid;
+    } else if (name == "Square") {
+      *op = FusedElementwiseOpType::kSquare;
+    } else if (name == "Tanh") {
+      *op = FusedElementwiseOpType::kTanh;
+    } else {
+      return errors::InvalidArgument("Unsupported fused elementwise op: ",
+                                     name);
+    }
+  }
+  return OkStatus();
+}
+
+}  // namespace
+
+template <typename Device, typename T>
+class FusedElementwiseOp : public OpKernel {
+ public:
+  explicit FusedElementwiseOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    std::vector<string> fused_ops;
+    OP_REQUIRES_OK(context, context->GetAttr("fused_ops", &fused_ops));
+    const int num_ops = fused_ops.size();
+    OP_REQUIRES(context,
+                num_ops > 0 && num_ops <= functor::kMaxFusedElementwiseOps,
+                errors::InvalidArgument(
+                    "_FusedElementwise must fuse between 1 and ",
+                    functor::kMaxFusedElementwiseOps, " ops, got ", num_ops));
+    int num_args = 1;
+    for (const string& fused_op : fused_ops) {
+      bool is_binary;
+      OP_REQUIRES_OK(context, GetFusedElementwiseOpType(
+                                  fused_op, &program_.ops[program_.num_ops],
+                                  &is_binary));
+      ++program_.num_ops;
+      if (is_binary) ++num_args;
+    }
+    OP_REQUIRES(context, num_args == context->num_inputs(),
+                errors::InvalidArgument("The fused ops take ", num_args,
+                                        " arguments, got ",
+                                        context->num_inputs()));
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor& input = context->input(0);
+    functor::FusedElementwiseArgs<T> args;
+    for (int i = 0; i < context->num_inputs(); ++i) {
+      const Tensor& arg = context->input(i);
+      // The fused ops don't broadcast.
+      OP_REQUIRES(context, arg.shape() == input.shape(),
+                  errors::InvalidArgument(
+                      "All the arguments of _FusedElementwise must have the "
+                      "same shape, got ",
+                      input.shape().DebugString(), " and ",
+                      arg.shape().DebugString(), " for argument ", i));
+      args.args[i] = arg.flat<T>().data();
+    }
+
+    Tensor* output = nullptr;
+    OP_REQUIRES_OK(context, context->forward_input_or_allocate_output(
+                                {0}, 0, input.shape(), &output));
+    if (input.NumElements() == 0) return;
+    functor::FusedElementwise<Device, T>()(
+        context->eigen_device<Device>(), program_, args, input.NumElements(),
+        output->flat<T>().data());
+  }
+
+ private:
+  functor::FusedElementwiseProgram program_;
+};
+
+#define REGISTER_KERNEL(T)                                                \
+  REGISTER_KERNEL_BUILDER(                                                \
+      Name("_FusedElementwise").Device(DEVICE_CPU).TypeConstraint<T>("T"), \
+      FusedElementwiseOp<CPUDevice, T>);
+TF_CALL_half(REGISTER_KERNEL);
+TF_CALL_bfloat16(REGISTER_KERNEL);
+TF_CALL_float(REGISTER_KERNEL);
+TF_CALL_double(REGISTER_KERNEL);
+#undef REGISTER_KERNEL
+
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+
+#define REGISTER_KERNEL(T)                                                \
+  REGISTER_KERNEL_BUILDER(                                                \
+      Name("_FusedElementwise").Device(DEVICE_GPU).TypeConstraint<T>("T"), \
+      FusedElementwiseOp<GPUDevice, T>);
+TF_CALL_half(REGISTER_KERNEL);
+TF_CALL_float(REGISTER_KERNEL);
+TF_CALL_double(REGISTER_KERNEL);
+#undef REGISTER_KERNEL
+
+#endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+
+}  // namespace tensorflow
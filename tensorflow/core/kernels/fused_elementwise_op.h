@@ -0,0 +1,121 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_KERNELS_FUSED_ELEMENTWISE_OP_H_
+#define TENSORFLOW_CORE_KERNELS_FUSED_ELEMENTWISE_OP_H_
+
+#include <type_traits>
+
+#include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
+#include "tensorflow/core/framework/types.h"
+
+namespace tensorflow {
+namespace functor {
+
+// The elementwise ops that can be fused by _FusedElementwise. The binary ops
+// take the result of the previous ops as their first operand.
+enum class FusedElementwiseOpType : int8 {
+  kAdd,
+  kSub,
+  kMul,
+  kMaximum,
+  kMinimum,
+  kNeg,
+  kRelu,
+  kRelu6,
+  kSigmoid,
+  kSquare,
+  kTanh,
+};
+
+// The maximum number of ops of a _FusedElementwise, so that its program and
+// arguments can be passed by value to the GPU kernel.
+constexpr int kMaxFusedElementwiseOps = 8;
+
+// The chain of ops of a _FusedElementwise, applied to its first argument.
+struct FusedElementwiseProgram {
+  int num_ops = 0;
+  FusedElementwiseOpType ops[kMaxFusedElementwiseOps];
+};
+
+// The arguments of a _FusedElementwise, in the order in which they are used:
+// the input of the chain, then the second operands of the binary ops.
+template <typename T>
+struct FusedElementwiseArgs {
+  const T* args[kMaxFusedElementwiseOps + 1];
+};
+
+// Evaluates `program` on element `i` of `args`. Half precision values are
+// computed in float.
+template <typename T>
+EIGEN_DEVICE_FUNC EIGEN_ALWAYS_INLINE T
+EvaluateFusedElementwise(const FusedElementwiseProgram& program,
+                         const FusedElementwiseArgs<T>& args, int64_t i) {
+  using Compute =
+      typename std::conditional<std::is_same<T, Eigen::half>::value ||
+                                    std::is_same<T, bfloat16>::value,
+                                float, T>::type;
+  Compute x = static_cast<Compute>(args.args[0][i]);
+  int arg = 1;
+  for (int k = 0; k < program.num_ops; ++k) {
+    switch (program.ops[k]) {
+      case FusedElementwiseOpType::kAdd:
+        x += static_cast<Compute>(args.args[arg++][i]);
+        break;
+      case FusedElementwiseOpType::kSub:
+        x -= static_cast<Compute>(args.args[arg++][i]);
+        break;
+      case FusedElementwiseOpType::kMul:
+        x *= static_cast<Compute>(args.args[arg++][i]);
+        break;
+      case FusedElementwiseOpType::kMaximum:
+        x = Eigen::numext::maxi(x, static_cast<Compute>(args.args[arg++][i]));
+        break;
+      case FusedElementwiseOpType::kMinimum:
+        x = Eigen::numext::mini(x, static_cast<Compute>(args.args[arg++][i]));
+        break;
+      case FusedElementwiseOpType::kNeg:
+        x = -x;
+        break;
+      case FusedElementwiseOpType::kRelu:
+        x = Eigen::numext::maxi(x, Compute(0));
+        break;
+      case FusedElementwiseOpType::kRelu6:
+        x = Eigen::numext::mini(Eigen::numext::maxi(x, Compute(0)), Compute(6));
+        break;
+      case FusedElementwiseOpType::kSigmoid:
+        x = Compute(1) / (Compute(1) + Eigen::numext::exp(-x));
+        break;
+      case FusedElementwiseOpType::kSquare:
+        x *= x;
+        break;
+      case FusedElementwiseOpType::kTanh:
+        x = Eigen::numext::tanh(x);
+        break;
+    }
+  }
+  return static_cast<T>(x);
+}
+
+template <typename Device, typename T>
+struct FusedElementwise {
+  void operator()(const Device& d, const FusedElementwiseProgram& program,
+                  const FusedElementwiseArgs<T>& args, int64_t size, T* output);
+};
+
+}  // namespace functor
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_FUSED_ELEMENTWISE_OP_H_
@@ -0,0 +1,76 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+
+#define EIGEN_USE_GPU
+
+#include "tensorflow/core/framework/register_types.h"
+#include "tensorflow/core/kernels/fused_elementwise_op.h"
+#include "tensorflow/core/util/gpu_kernel_helper.h"
+
+namespace tensorflow {
+
+typedef Eigen::GpuDevice GPUDevice;
+
+namespace functor {
+
+namespace {
+
+// The program and the argument pointers are passed by value, so that they are
+// in the constant memory of the kernel. Each thread computes kUnroll elements
+// kUnroll * blockDim.x apart, to have several loads of each argument in flight.
+template <typename T, int kUnroll>
+__global__ void FusedElementwiseKernel(const FusedElementwiseProgram program,
+                                       const FusedElementwiseArgs<T> args,
+                                       int64_t size, T* __restrict__ output) {
+  const int64_t block_size = kUnroll * blockDim.x;
+  for (int64_t base = blockIdx.x * block_size + threadIdx.x; base < size;
+       base += gridDim.x * block_size) {
+#pragma unroll
+    for (int k = 0; k < kUnroll; ++k) {
+      const int64_t i = base + k * blockDim.x;
+      if (i < size) output[i] = EvaluateFusedElementwise(program, args, i);
+    }
+  }
+}
+
+}  // namespace
+
+template <typename T>
+struct FusedElementwise<GPUDevice, T> {
+  void operator()(const GPUDevice& d, const FusedElementwiseProgram& program,
+                  const FusedElementwiseArgs<T>& args, int64_t size,
+                  T* output) {
+    constexpr int kUnroll = 4;
+    GpuLaunchConfig config =
+        GetGpuLaunchConfig((size + kUnroll - 1) / kUnroll, d,
+                           FusedElementwiseKernel<T, kUnroll>, 0, 0);
+    TF_CHECK_OK(GpuLaunchKernel(FusedElementwiseKernel<T, kUnroll>,
+                                config.block_count, config.thread_per_block, 0,
+                                d.stream(), program, args, size, output));
+  }
+};
+
+#define DEFINE_GPU_SPEC(T) template struct FusedElementwise<GPUDevice, T>;
+TF_CALL_half(DEFINE_GPU_SPEC);
+TF_CALL_float(DEFINE_GPU_SPEC);
+TF_CALL_double(DEFINE_GPU_SPEC);
+#undef DEFINE_GPU_SPEC
+
+}  // namespace functor
+}  // namespace tensorflow
+
+#endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
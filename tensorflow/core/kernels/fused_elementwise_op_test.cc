@@ -0,0 +1,94 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+
+class FusedElementwiseOpTest : public OpsTestBase {
+ protected:
+  Status Init(const std::vector<string>& fused_ops, int num_args) {
+    TF_RETURN_IF_ERROR(
+        NodeDefBuilder("fused_elementwise", "_FusedElementwise")
+            .Input(FakeInput(num_args, DT_FLOAT))
+            .Attr("fused_ops", fused_ops)
+            .Finalize(node_def()));
+    return InitOp();
+  }
+};
+
+TEST_F(FusedElementwiseOpTest, MulAddRelu) {
+  TF_ASSERT_OK(Init({"Mul", "AddV2", "Relu"}, 3));
+  AddInputFromArray<float>(TensorShape({2, 2}), {1, -2, 3, -4});
+  AddInputFromArray<float>(TensorShape({2, 2}), {2, 2, -1, -1});
+  AddInputFromArray<float>(TensorShape({2, 2}), {1, 1, 1, 1});
+  TF_ASSERT_OK(RunOpKernel());
+
+  Tensor expected(allocator(), DT_FLOAT, TensorShape({2, 2}));
+  test::FillValues<float>(&expected, {3, 0, 0, 5});
+  test::ExpectTensorEqual<float>(expected, *GetOutput(0));
+}
+
+TEST_F(FusedElementwiseOpTest, UnaryOps) {
+  TF_ASSERT_OK(Init({"Neg", "Square", "Tanh", "Sigmoid"}, 1));
+  AddInputFromArray<float>(TensorShape({3}), {0, 0.5, -2});
+  TF_ASSERT_OK(RunOpKernel());
+
+  Tensor expected(allocator(), DT_FLOAT, TensorShape({3}));
+  const auto f = [](float x) {
+    return 1 / (1 + std::exp(-std::tanh(x * x)));
+  };
+  test::FillValues<float>(&expected, {f(0), f(-0.5), f(2)});
+  test::ExpectTensorNear<float>(expected, *GetOutput(0), 1e-6);
+}
+
+TEST_F(FusedElementwiseOpTest, SubMaximumMinimumRelu6) {
+  TF_ASSERT_OK(Init({"Sub", "Maximum", "Minimum", "Relu6"}, 4));
+  AddInputFromArray<float>(TensorShape({4}), {10, -3, 2, 4});
+  AddInputFromArray<float>(TensorShape({4}), {1, 1, 1, 1});
+  AddInputFromArray<float>(TensorShape({4}), {0, -5, 2, 0});
+  AddInputFromArray<float>(TensorShape({4}), {20, 20, 20, 2});
+  TF_ASSERT_OK(RunOpKernel());
+
+  Tensor expected(allocator(), DT_FLOAT, TensorShape({4}));
+  test::FillValues<float>(&expected, {6, 0, 2, 2});
+  test::ExpectTensorEqual<float>(expected, *GetOutput(0));
+}
+
+TEST_F(FusedElementwiseOpTest, RejectsDifferentShapes) {
+  TF_ASSERT_OK(Init({"Add"}, 2));
+  AddInputFromArray<float>(TensorShape({2}), {1, 2});
+  AddInputFromArray<float>(TensorShape({1}), {1});
+  Status s = RunOpKernel();
+  EXPECT_TRUE(errors::IsInvalidArgument(s)) << s;
+}
+
+TEST_F(FusedElementwiseOpTest, RejectsUnsupportedOps) {
+  EXPECT_TRUE(errors::IsInvalidArgument(Init({"Exp"}, 1)));
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,267 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// See docs in ../ops/image_ops.cc
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/lib/jpeg/jpeg_mem.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/util/work_sharder.h"
+
+namespace tensorflow {
+namespace {
+
+// Source coordinate and interpolation weight for one output row or column.
+struct Interpolation {
+  int64_t lower;
+  int64_t upper;
+  float lerp;
+};
+
+// Computes the bilinear (half-pixel centers) interpolation of `out_size`
+// samples of the window [`crop_start`, `crop_start + crop_size`) of the
+// original image, read from a buffer that holds the pixels of the image
+// decoded at 1/`ratio` scale, starting at scaled pixel `decoded_start` and
+// spanning `decoded_size` pixels.
+void ComputeInterpolation(int64_t crop_start, int64_t crop_size,
+                          int64_t out_size, int ratio, int64_t decoded_start,
+                          int64_t decoded_size, Interpolation* interpolation) {
+  const float scale = static_cast<float>(crop_size) / out_size;
+  for (int64_t i = 0; i < out_size; ++i) {
+    // Scaled pixel `j` covers the original pixels [j * ratio, (j + 1) * ratio),
+    // so its center is at original coordinate (j + 0.5) * ratio.
+    float in = (crop_start + (i + 0.5f) * scale) / ratio - 0.5f -
+               static_cast<float>(decoded_start);
+    in = std::min(std::max(in, 0.0f), static_cast<float>(decoded_size - 1));
+    interpolation[i].lower = static_cast<int64_t>(std::floor(in));
+    interpolation[i].upper =
+        std::min(interpolation[i].lower + 1, decoded_size - 1);
+    interpolation[i].lerp = in - interpolation[i].lower;
+  }
+}
+
+// Decodes a crop of a JPEG image and resizes it with bilinear interpolation.
+//
+// Instead of decoding the crop at full resolution and downscaling it
+// afterwards, the kernel lets libjpeg downscale the crop during the inverse
+// DCT by the largest ratio (1, 2, 4, or 8) that keeps the decoded crop at
+// least as large as the requested size. This reduces both the decode and the
+// resize cost of input pipelines that shrink large images.
+class DecodeCropAndResizeJpegOp : public OpKernel {
+ public:
+  explicit DecodeCropAndResizeJpegOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("channels", &channels_));
+    OP_REQUIRES(context, channels_ == 0 || channels_ == 1 || channels_ == 3,
+                errors::InvalidArgument("channels must be 0, 1, or 3, got ",
+                                        channels_));
+    OP_REQUIRES_OK(context,
+                   context->GetAttr("fancy_upscaling", &flags_.fancy_upscaling));
+    OP_REQUIRES_OK(context, context->GetAttr("try_recover_truncated",
+                                             &flags_.try_recover_truncated_jpeg));
+    OP_REQUIRES_OK(context, context->GetAttr("acceptable_fraction",
+                                             &flags_.min_acceptable_fraction));
+    string dct_method;
+    OP_REQUIRES_OK(context, context->GetAttr("dct_method", &dct_method));
+    OP_REQUIRES(
+        context,
+        (dct_method.empty() || dct_method == "INTEGER_FAST" ||
+         dct_method == "INTEGER_ACCURATE"),
+        errors::InvalidArgument("dct_method must be one of "
+                                "{'', 'INTEGER_FAST', 'INTEGER_ACCURATE'}"));
+    // Same default as `DecodeJpeg`, which sacrifices image quality for speed.
+    if (dct_method.empty() || dct_method == "INTEGER_FAST") {
+      flags_.dct_method = JDCT_IFAST;
+    } else if (dct_method == "INTEGER_ACCURATE") {
+      flags_.dct_method = JDCT_ISLOW;
+    }
+    flags_.components = channels_;
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor& contents = context->input(0);
+    OP_REQUIRES(
+        context, TensorShapeUtils::IsScalar(contents.shape()),
+        errors::InvalidArgument("`contents` must be scalar but got shape",
+                                contents.shape().DebugString()));
+    const StringPiece input = contents.scalar<tstring>()();
+    OP_REQUIRES(context, input.size() <= std::numeric_limits<int>::max(),
+                errors::InvalidArgument(
+                    "JPEG contents are too large for int: ", input.size()));
+
+    const Tensor& crop_window = context->input(1);
+    OP_REQUIRES(context,
+                crop_window.dims() == 1 && crop_window.dim_size(0) == 4,
+                errors::InvalidArgument(
+                    "crop_window must be 1-D with four elements, got shape ",
+                    crop_window.shape().DebugString()));
+    auto crop_window_vec = crop_window.vec<int32>();
+    const int64_t crop_y = crop_window_vec(0);
+    const int64_t crop_x = crop_window_vec(1);
+    const int64_t crop_height = crop_window_vec(2);
+    const int64_t crop_width = crop_window_vec(3);
+
+    const Tensor& size = context->input(2);
+    OP_REQUIRES(context, size.dims() == 1 && size.dim_size(0) == 2,
+                errors::InvalidArgument(
+                    "size must be 1-D with two elements, got shape ",
+                    size.shape().DebugString()));
+    const int64_t out_height = size.vec<int32>()(0);
+    const int64_t out_width = size.vec<int32>()(1);
+    OP_REQUIRES(context, out_height > 0 && out_width > 0,
+                errors::InvalidArgument("size must be positive, got [",
+                                        out_height, ", ", out_width, "]"));
+
+    int width, height, components;
+    OP_REQUIRES(context,
+                jpeg::GetImageInfo(input.data(), input.size(), &width, &height,
+                                   &components),
+                errors::InvalidArgument("Invalid JPEG data, size ",
+                                        input.size()));
+    OP_REQUIRES(context,
+                crop_y >= 0 && crop_x >= 0 && crop_height > 0 &&
+                    crop_width > 0 && crop_y + crop_height <= height &&
+                    crop_x + crop_width <= width,
+                errors::InvalidArgument(
+                    "Invalid crop window: [", crop_y, ", ", crop_x, ", ",
+                    crop_height, ", ", crop_width, "] for image of size ",
+                    height, "x", width));
+
+    // Pick the largest ratio that does not decode the crop to fewer pixels
+    // than the output has along either dimension.
+    int ratio = 1;
+    for (int candidate : {8, 4, 2}) {
+      if (crop_height >= candidate * out_height &&
+          crop_width >= candidate * out_width) {
+        ratio = candidate;
+        break;
+      }
+    }
+
+    // libjpeg crops in the coordinates of the scaled image, whose dimensions
+    // are rounded up. Decode the smallest scaled window that covers the crop.
+    const int64_t scaled_height = (height + ratio - 1) / ratio;
+    const int64_t scaled_width = (width + ratio - 1) / ratio;
+    const int64_t decoded_y = crop_y / ratio;
+    const int64_t decoded_x = crop_x / ratio;
+    const int64_t decoded_height =
+        std::min((crop_y + crop_height + ratio - 1) / ratio, scaled_height) -
+        decoded_y;
+    const int64_t decoded_width =
+        std::min((crop_x + crop_width + ratio - 1) / ratio, scaled_width) -
+        decoded_x;
+
+    // Use a local copy of the flags, as the member is shared among
+    // concurrent invocations.
+    jpeg::UncompressFlags flags = flags_;
+    flags.ratio = ratio;
+    flags.crop = true;
+    flags.crop_y = decoded_y;
+    flags.crop_x = decoded_x;
+    flags.crop_height = decoded_height;
+    flags.crop_width = decoded_width;
+
+    Tensor decoded;
+    uint8* buffer = jpeg::Uncompress(
+        input.data(), input.size(), flags, nullptr /* nwarn */,
+        [&](int decoded_w, int decoded_h, int decoded_c) -> uint8* {
+          Status status = context->allocate_temp(
+              DT_UINT8, TensorShape({decoded_h, decoded_w, decoded_c}),
+              &decoded);
+          if (!status.ok()) {
+            VLOG(1) << status;
+            context->SetStatus(status);
+            return nullptr;
+          }
+          return decoded.flat<uint8>().data();
+        });
+    OP_REQUIRES(
+        context, buffer,
+        errors::InvalidArgument(
+            "jpeg::Uncompress failed. Invalid JPEG data or crop window."));
+    OP_REQUIRES(context,
+                decoded.dim_size(0) == decoded_height &&
+                    decoded.dim_size(1) == decoded_width,
+                errors::Internal("Decoded a ", decoded.dim_size(0), "x",
+                                 decoded.dim_size(1), " crop, expected ",
+                                 decoded_height, "x", decoded_width));
+    const int64_t channels = decoded.dim_size(2);
+
+    Tensor* output = nullptr;
+    OP_REQUIRES_OK(context,
+                   context->allocate_output(
+                       0, TensorShape({out_height, out_width, channels}),
+                       &output));
+
+    std::vector<Interpolation> ys(out_height);
+    std::vector<Interpolation> xs(out_width);
+    ComputeInterpolation(crop_y, crop_height, out_height, ratio, decoded_y,
+                         decoded_height, ys.data());
+    ComputeInterpolation(crop_x, crop_width, out_width, ratio, decoded_x,
+                         decoded_width, xs.data());
+
+    const uint8* in_data = decoded.flat<uint8>().data();
+    float* out_data = output->flat<float>().data();
+    const int64_t in_row_size = decoded_width * channels;
+    const int64_t out_row_size = out_width * channels;
+    auto resize_rows = [&](int64_t start, int64_t limit) {
+      for (int64_t y = start; y < limit; ++y) {
+        const uint8* top = in_data + ys[y].lower * in_row_size;
+        const uint8* bottom = in_data + ys[y].upper * in_row_size;
+        const float y_lerp = ys[y].lerp;
+        float* out_row = out_data + y * out_row_size;
+        for (int64_t x = 0; x < out_width; ++x) {
+          const int64_t left = xs[x].lower * channels;
+          const int64_t right = xs[x].upper * channels;
+          const float x_lerp = xs[x].lerp;
+          for (int64_t c = 0; c < channels; ++c) {
+            const float top_value =
+                top[left + c] + (top[right + c] - top[left + c]) * x_lerp;
+            const float bottom_value =
+                bottom[left + c] +
+                (bottom[right + c] - bottom[left + c]) * x_lerp;
+            out_row[x * channels + c] =
+                top_value + (bottom_value - top_value) * y_lerp;
+          }
+        }
+      }
+    };
+    const auto& worker_threads =
+        *context->device()->tensorflow_cpu_worker_threads();
+    // Roughly 8 flops per output value.
+    Shard(worker_threads.num_threads, worker_threads.workers, out_height,
+          8 * out_row_size, resize_rows);
+  }
+
+ private:
+  int channels_;
+  jpeg::UncompressFlags flags_;
+};
+
+}  // namespace
+
+REGISTER_KERNEL_BUILDER(Name("DecodeCropAndResizeJpeg").Device(DEVICE_CPU),
+                        DecodeCropAndResizeJpegOp);
+
+}  // namespace tensorflow
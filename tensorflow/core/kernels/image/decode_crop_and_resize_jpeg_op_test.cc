@@ -0,0 +1,169 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/jpeg/jpeg_mem.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+constexpr int kImageSize = 256;
+constexpr int kChannels = 3;
+
+class DecodeCropAndResizeJpegOpTest : public OpsTestBase {
+ protected:
+  void SetUp() override {
+    // A smooth image, so that decoding at a reduced scale stays close to
+    // decoding at full scale.
+    std::vector<uint8> pixels(kImageSize * kImageSize * kChannels);
+    for (int y = 0; y < kImageSize; ++y) {
+      for (int x = 0; x < kImageSize; ++x) {
+        uint8* pixel = &pixels[(y * kImageSize + x) * kChannels];
+        pixel[0] = y;
+        pixel[1] = x;
+        pixel[2] = (x + y) / 2;
+      }
+    }
+    jpeg::CompressFlags flags;
+    flags.format = jpeg::FORMAT_RGB;
+    flags.quality = 100;
+    jpeg_ = jpeg::Compress(pixels.data(), kImageSize, kImageSize, flags);
+    ASSERT_FALSE(jpeg_.empty());
+
+    jpeg::UncompressFlags uncompress_flags;
+    uncompress_flags.dct_method = JDCT_IFAST;
+    int width, height, components;
+    decoded_.reset(jpeg::Uncompress(jpeg_.data(), jpeg_.size(),
+                                    uncompress_flags, &width, &height,
+                                    &components, nullptr));
+    ASSERT_NE(decoded_, nullptr);
+    ASSERT_EQ(width, kImageSize);
+    ASSERT_EQ(height, kImageSize);
+    ASSERT_EQ(components, kChannels);
+
+    TF_ASSERT_OK(NodeDefBuilder("decode_op", "DecodeCropAndResizeJpeg")
+                     .Input(FakeInput(DT_STRING))
+                     .Input(FakeInput(DT_INT32))
+                     .Input(FakeInput(DT_INT32))
+                     .Attr("channels", kChannels)
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+  }
+
+  // Returns the bilinear (half-pixel centers) resize of the given crop of the
+  // fully decoded image.
+  Tensor ExpectedImage(int crop_y, int crop_x, int crop_height, int crop_width,
+                       int out_height, int out_width) {
+    Tensor expected(DT_FLOAT, TensorShape({out_height, out_width, kChannels}));
+    auto expected_tensor = expected.tensor<float, 3>();
+    auto source = [&](int out, int out_size, int crop_start, int crop_size,
+                      int* lower, int* upper, float* lerp) {
+      float in = (out + 0.5f) * crop_size / out_size - 0.5f;
+      in = std::min(std::max(in, 0.0f), crop_size - 1.0f);
+      *lower = static_cast<int>(std::floor(in));
+      *upper = std::min(*lower + 1, crop_size - 1);
+      *lerp = in - *lower;
+      *lower += crop_start;
+      *upper += crop_start;
+    };
+    auto pixel = [&](int y, int x, int c) -> float {
+      return decoded_[(y * kImageSize + x) * kChannels + c];
+    };
+    for (int y = 0; y < out_height; ++y) {
+      int top, bottom;
+      float y_lerp;
+      source(y, out_height, crop_y, crop_height, &top, &bottom, &y_lerp);
+      for (int x = 0; x < out_width; ++x) {
+        int left, right;
+        float x_lerp;
+        source(x, out_width, crop_x, crop_width, &left, &right, &x_lerp);
+        for (int c = 0; c < kChannels; ++c) {
+          const float top_value =
+              pixel(top, left, c) +
+              (pixel(top, right, c) - pixel(top, left, c)) * x_lerp;
+          const float bottom_value =
+              pixel(bottom, left, c) +
+              (pixel(bottom, right, c) - pixel(bottom, left, c)) * x_lerp;
+          expected_tensor(y, x, c) =
+              top_value + (bottom_value - top_value) * y_lerp;
+        }
+      }
+    }
+    return expected;
+  }
+
+  void AddInputs(const std::vector<int32>& crop_window,
+                 const std::vector<int32>& size) {
+    AddInputFromArray<tstring>(TensorShape({}), {jpeg_});
+    AddInputFromArray<int32>(TensorShape({4}), crop_window);
+    AddInputFromArray<int32>(TensorShape({2}), size);
+  }
+
+  tstring jpeg_;
+  std::unique_ptr<uint8[]> decoded_;
+};
+
+TEST_F(DecodeCropAndResizeJpegOpTest, FullScale) {
+  // The crop is less than twice as large as the output, so it is decoded at
+  // full scale and the result matches decoding and then resizing.
+  AddInputs({10, 20, 100, 90}, {50, 60});
+  TF_ASSERT_OK(RunOpKernel());
+  test::ExpectTensorNear<float>(*GetOutput(0),
+                                ExpectedImage(10, 20, 100, 90, 50, 60), 1e-3);
+}
+
+TEST_F(DecodeCropAndResizeJpegOpTest, ReducedScale) {
+  // The crop is eight times as large as the output, so it is decoded at 1/8
+  // scale.
+  AddInputs({16, 32, 192, 160}, {24, 20});
+  TF_ASSERT_OK(RunOpKernel());
+  test::ExpectTensorNear<float>(*GetOutput(0),
+                                ExpectedImage(16, 32, 192, 160, 24, 20), 4.0);
+}
+
+TEST_F(DecodeCropAndResizeJpegOpTest, UnalignedCrop) {
+  // The crop does not start or end on a multiple of the decoding ratio.
+  AddInputs({3, 5, 201, 117}, {50, 29});
+  TF_ASSERT_OK(RunOpKernel());
+  test::ExpectTensorNear<float>(*GetOutput(0),
+                                ExpectedImage(3, 5, 201, 117, 50, 29), 4.0);
+}
+
+TEST_F(DecodeCropAndResizeJpegOpTest, InvalidCropWindow) {
+  AddInputs({200, 0, 100, 100}, {10, 10});
+  Status status = RunOpKernel();
+  EXPECT_TRUE(errors::IsInvalidArgument(status)) << status;
+}
+
+TEST_F(DecodeCropAndResizeJpegOpTest, InvalidSize) {
+  AddInputs({0, 0, 100, 100}, {0, 10});
+  Status status = RunOpKernel();
+  EXPECT_TRUE(errors::IsInvalidArgument(status)) << status;
+}
+
+}  // namespace
+}  // namespace tensorflow
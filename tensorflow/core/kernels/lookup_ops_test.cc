@@ -20,6 +20,7 @@ limitations under the License.
 #include "tensorflow/core/framework/node_def_builder.h"
 #include "tensorflow/core/framework/op.h"
 #include "tensorflow/core/framework/shape_inference_testutil.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/kernels/lookup_table_op.h"
 #include "tensorflow/core/kernels/ops_testutil.h"
@@ -100,5 +101,54 @@ TEST_F(LookupOpsTest, AnonymousHashTable_RefCounting) {
   EXPECT_FALSE(alive);
 }
 
+TEST_F(LookupOpsTest, DynamicEmbeddingTable_CreatesAndEvictsKeys) {
+  TF_ASSERT_OK(
+      NodeDefBuilder("dynamic_embedding_table",
+                     "_AnonymousDynamicEmbeddingTable")
+          .Attr("key_dtype", DT_INT64)
+          .Attr("value_dtype", DT_FLOAT)
+          .Attr("value_shape", TensorShape({2}))
+          .Attr("max_size", 8)
+          .Finalize(node_def()));
+  TF_ASSERT_OK(InitOp());
+  TF_ASSERT_OK(RunOpKernel());
+  auto resource_or =
+      GetOutput(0)->scalar<ResourceHandle>()().GetResource<
+          lookup::LookupInterface>();
+  TF_ASSERT_OK(resource_or.status());
+  auto* table =
+      dynamic_cast<lookup::ScatterAddLookupInterface*>(resource_or.value());
+  ASSERT_NE(table, nullptr);
+
+  // Finding the missing keys inserts their default value.
+  Tensor keys = test::AsTensor<int64_t>({1, 2});
+  Tensor default_value = test::AsTensor<float>({0.5, -0.5});
+  Tensor values(DT_FLOAT, TensorShape({2, 2}));
+  TF_ASSERT_OK(table->Find(context_.get(), keys, &values, default_value));
+  test::ExpectTensorEqual<float>(
+      values, test::AsTensor<float>({0.5, -0.5, 0.5, -0.5}, {2, 2}));
+  EXPECT_EQ(table->size(), 2);
+
+  TF_ASSERT_OK(table->ScatterAdd(
+      context_.get(), test::AsTensor<int64_t>({2, 3}),
+      test::AsTensor<float>({1, 2, 3, 4}, {2, 2})));
+  TF_ASSERT_OK(table->Find(context_.get(), test::AsTensor<int64_t>({2, 3}),
+                           &values, default_value));
+  test::ExpectTensorEqual<float>(
+      values, test::AsTensor<float>({1.5, 1.5, 3, 4}, {2, 2}));
+
+  // Growing past max_size evicts the least recently used keys, down to 7/8 of
+  // max_size.
+  Tensor new_keys = test::AsTensor<int64_t>({10, 11, 12, 13, 14, 15});
+  Tensor new_values(DT_FLOAT, TensorShape({6, 2}));
+  new_values.flat<float>().setZero();
+  TF_ASSERT_OK(table->Insert(context_.get(), new_keys, new_values));
+  EXPECT_EQ(table->size(), 7);
+  Tensor value(DT_FLOAT, TensorShape({1, 2}));
+  TF_ASSERT_OK(table->Find(context_.get(), test::AsTensor<int64_t>({1}),
+                           &value, test::AsTensor<float>({0, 0})));
+  test::ExpectTensorEqual<float>(value, test::AsTensor<float>({0, 0}, {1, 2}));
+}
+
 }  // namespace
 }  // namespace tensorflow
@@ -16,9 +16,17 @@ limitations under the License.
 #include "tensorflow/core/kernels/lookup_table_op.h"
 #define EIGEN_USE_THREADS
 
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+#define EIGEN_USE_GPU
+#include "tensorflow/core/kernels/lookup_table_op_gpu.h"
+#include "tensorflow/core/platform/stream_executor.h"
+#endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+
+#include <algorithm>
 #include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "tensorflow/core/framework/register_types.h"
 #include "tensorflow/core/framework/types.h"
@@ -408,6 +416,211 @@ class MutableHashTableOfTensors final : public LookupInterface {
   std::unordered_map<K, ValueArray> table_ TF_GUARDED_BY(mu_);
 };
 
+// Lookup table of vectors for embeddings whose set of keys is not known up
+// front. Find creates the missing keys with their default value, so that the
+// embedding rows are initialized on demand, and ScatterAdd applies the
+// gradients to them.
+//
+// If max_size is positive, the least recently used keys are evicted when the
+// table grows past max_size, down to 7/8 of max_size so that the eviction is
+// amortized over several steps. The keys are aged by the number of operations
+// on the table since they were last used, as a proxy for the training steps.
+template <class K, class V>
+class DynamicEmbeddingTable final : public ScatterAddLookupInterface {
+ public:
+  DynamicEmbeddingTable(OpKernelContext* ctx, OpKernel* kernel) {
+    OP_REQUIRES_OK(ctx,
+                   GetNodeAttr(kernel->def(), "value_shape", &value_shape_));
+    OP_REQUIRES(
+        ctx, TensorShapeUtils::IsVector(value_shape_),
+        errors::InvalidArgument("Default value must be a vector, got shape ",
+                                value_shape_.DebugString()));
+    OP_REQUIRES_OK(ctx, GetNodeAttr(kernel->def(), "max_size", &max_size_));
+    OP_REQUIRES(ctx, max_size_ >= 0,
+                errors::InvalidArgument("max_size must be non-negative, got: ",
+                                        max_size_));
+  }
+
+  size_t size() const override {
+    tf_shared_lock l(mu_);
+    return table_.size();
+  }
+
+  Status Find(OpKernelContext* ctx, const Tensor& key, Tensor* value,
+              const Tensor& default_value) override {
+    const auto default_flat = default_value.flat_inner_dims<V, 2>();
+    const auto key_values = key.flat<K>();
+    auto value_values = value->flat_inner_dims<V, 2>();
+    const int64_t value_dim = value_shape_.dim_size(0);
+    const bool is_full_size_default =
+        (value_values.size() == default_flat.size());
+
+    mutex_lock l(mu_);
+    ++clock_;
+    for (int64_t i = 0; i < key_values.size(); ++i) {
+      auto result = table_.try_emplace(SubtleMustCopyIfIntegral(key_values(i)));
+      Entry& entry = result.first->second;
+      if (result.second) {
+        const int64_t default_row = is_full_size_default ? i : 0;
+        entry.value.resize(value_dim);
+        for (int64_t j = 0; j < value_dim; ++j) {
+          entry.value[j] = default_flat(default_row, j);
+        }
+      }
+      entry.last_used = clock_;
+      for (int64_t j = 0; j < value_dim; ++j) {
+        value_values(i, j) = entry.value[j];
+      }
+    }
+    MaybeEvict();
+    return OkStatus();
+  }
+
+  Status Insert(OpKernelContext* ctx, const Tensor& keys,
+                const Tensor& values) override {
+    mutex_lock l(mu_);
+    DoInsert(keys, values);
+    return OkStatus();
+  }
+
+  Status ScatterAdd(OpKernelContext* ctx, const Tensor& keys,
+                    const Tensor& updates) override {
+    const auto key_values = keys.flat<K>();
+    const auto update_values = updates.flat_inner_dims<V, 2>();
+    const int64_t value_dim = value_shape_.dim_size(0);
+
+    mutex_lock l(mu_);
+    ++clock_;
+    for (int64_t i = 0; i < key_values.size(); ++i) {
+      Entry& entry = table_[SubtleMustCopyIfIntegral(key_values(i))];
+      if (entry.value.empty()) entry.value.resize(value_dim, V());
+      entry.last_used = clock_;
+      for (int64_t j = 0; j < value_dim; ++j) {
+        entry.value[j] += update_values(i, j);
+      }
+    }
+    MaybeEvict();
+    return OkStatus();
+  }
+
+  Status Remove(OpKernelContext* ctx, const Tensor& keys) override {
+    const auto key_values = keys.flat<K>();
+
+    mutex_lock l(mu_);
+    for (int64_t i = 0; i < key_values.size(); ++i) {
+      table_.erase(SubtleMustCopyIfIntegral(key_values(i)));
+    }
+    return OkStatus();
+  }
+
+  Status ImportValues(OpKernelContext* ctx, const Tensor& keys,
+                      const Tensor& values) override {
+    mutex_lock l(mu_);
+    table_.clear();
+    DoInsert(keys, values);
+    return OkStatus();
+  }
+
+  Status ExportValues(OpKernelContext* ctx) override {
+    tf_shared_lock l(mu_);
+    const int64_t size = table_.size();
+    const int64_t value_dim = value_shape_.dim_size(0);
+
+    Tensor* keys;
+    Tensor* values;
+    TF_RETURN_IF_ERROR(
+        ctx->allocate_output("keys", TensorShape({size}), &keys));
+    TF_RETURN_IF_ERROR(ctx->allocate_output(
+        "values", TensorShape({size, value_dim}), &values));
+    auto keys_data = keys->flat<K>();
+    auto values_data = values->matrix<V>();
+    int64_t i = 0;
+    for (const auto& it : table_) {
+      keys_data(i) = it.first;
+      for (int64_t j = 0; j < value_dim; ++j) {
+        values_data(i, j) = it.second.value[j];
+      }
+      ++i;
+    }
+    return OkStatus();
+  }
+
+  DataType key_dtype() const override { return DataTypeToEnum<K>::v(); }
+
+  DataType value_dtype() const override { return DataTypeToEnum<V>::v(); }
+
+  TensorShape key_shape() const final { return TensorShape(); }
+
+  TensorShape value_shape() const override { return value_shape_; }
+
+  int64_t MemoryUsed() const override {
+    tf_shared_lock l(mu_);
+    return sizeof(DynamicEmbeddingTable) +
+           table_.capacity() * sizeof(typename Table::value_type) +
+           table_.size() * value_shape_.dim_size(0) * sizeof(V);
+  }
+
+ private:
+  struct Entry {
+    std::vector<V> value;
+    // The value of clock_ when the key was last found or updated.
+    uint64 last_used = 0;
+  };
+  typedef absl::flat_hash_map<K, Entry> Table;
+
+  void DoInsert(const Tensor& keys, const Tensor& values)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    const auto key_values = keys.flat<K>();
+    const V* value_values = values.flat<V>().data();
+    const int64_t value_dim = value_shape_.dim_size(0);
+
+    ++clock_;
+    for (int64_t i = 0; i < key_values.size(); ++i) {
+      Entry& entry = table_[SubtleMustCopyIfIntegral(key_values(i))];
+      entry.value.assign(value_values + i * value_dim,
+                         value_values + (i + 1) * value_dim);
+      entry.last_used = clock_;
+    }
+    MaybeEvict();
+  }
+
+  // Evicts the least recently used keys if the table is larger than
+  // max_size_.
+  void MaybeEvict() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    const int64_t size = table_.size();
+    if (max_size_ == 0 || size <= max_size_) return;
+    const int64_t num_evicted = size - (max_size_ - max_size_ / 8);
+    std::vector<uint64> last_used;
+    last_used.reserve(size);
+    for (const auto& it : table_) last_used.push_back(it.second.last_used);
+    std::nth_element(last_used.begin(), last_used.begin() + num_evicted - 1,
+                     last_used.end());
+    // Evicts the keys used before the threshold, and as many keys used at the
+    // threshold as needed.
+    const uint64 threshold = last_used[num_evicted - 1];
+    int64_t num_at_threshold =
+        num_evicted - std::count_if(last_used.begin(),
+                                    last_used.begin() + num_evicted,
+                                    [threshold](uint64 t) {
+                                      return t < threshold;
+                                    });
+    for (auto it = table_.begin(); it != table_.end();) {
+      const uint64 t = it->second.last_used;
+      if (t < threshold || (t == threshold && num_at_threshold-- > 0)) {
+        table_.erase(it++);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  TensorShape value_shape_;
+  int64_t max_size_;
+  mutable mutex mu_;
+  uint64 clock_ TF_GUARDED_BY(mu_) = 0;
+  Table table_ TF_GUARDED_BY(mu_);
+};
+
 namespace {
 
 template <typename T>
@@ -878,6 +1091,268 @@ class MutableDenseHashTable final : public LookupInterface {
   uint64 deleted_key_hash_;
 };
 
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+
+// A MutableDenseHashTable of scalar keys whose buckets are resident in GPU
+// memory, so that the keys and values don't need to be copied to the host.
+// The buckets have the layout and the probing of MutableDenseHashTable, so
+// that the exported tables can be imported on either device.
+//
+// Find is asynchronous. Insert, Remove and ImportValues block until their
+// kernels are done, to know the number of entries used by size() and to grow
+// the table. The deleted buckets are only reused when the table is grown, and
+// the keys equal to the empty or deleted key are ignored instead of failing.
+template <class K, class V>
+class MutableDenseHashTableGpu final : public LookupInterface {
+ public:
+  MutableDenseHashTableGpu(OpKernelContext* ctx, OpKernel* kernel) {
+    OP_REQUIRES_OK(
+        ctx, GetNodeAttr(kernel->def(), "max_load_factor", &max_load_factor_));
+    OP_REQUIRES(ctx, max_load_factor_ > 0 && max_load_factor_ < 1,
+                errors::InvalidArgument(
+                    "max_load_factor must be between 0 and 1, got: ",
+                    max_load_factor_));
+
+    OP_REQUIRES_OK(ctx,
+                   GetNodeAttr(kernel->def(), "value_shape", &value_shape_));
+    OP_REQUIRES(ctx,
+                TensorShapeUtils::IsScalar(value_shape_) ||
+                    TensorShapeUtils::IsVector(value_shape_),
+                errors::InvalidArgument(
+                    "Empty value must be a scalar or a vector, got shape ",
+                    value_shape_.DebugString()));
+
+    const Tensor* empty_key_input;
+    OP_REQUIRES_OK(ctx, ctx->input("empty_key", &empty_key_input));
+    OP_REQUIRES(ctx, TensorShapeUtils::IsScalar(empty_key_input->shape()),
+                errors::Unimplemented(
+                    "The GPU MutableDenseHashTable only supports scalar keys, "
+                    "got empty key of shape ",
+                    empty_key_input->shape().DebugString()));
+    empty_key_ = empty_key_input->scalar<K>()();
+
+    const Tensor* deleted_key_input;
+    OP_REQUIRES_OK(ctx, ctx->input("deleted_key", &deleted_key_input));
+    OP_REQUIRES(ctx, TensorShapeUtils::IsScalar(deleted_key_input->shape()),
+                errors::InvalidArgument(
+                    "Empty and deleted keys must have same shape, got shapes: ",
+                    empty_key_input->shape().DebugString(), " and ",
+                    deleted_key_input->shape().DebugString()));
+    deleted_key_ = deleted_key_input->scalar<K>()();
+    OP_REQUIRES(
+        ctx, empty_key_ != deleted_key_,
+        errors::InvalidArgument("Empty and deleted keys cannot be equal"));
+
+    OP_REQUIRES_OK(ctx, ctx->allocate_temp(DT_INT64, TensorShape({2}),
+                                           &device_counters_));
+    int64_t initial_num_buckets;
+    OP_REQUIRES_OK(ctx, GetNodeAttr(kernel->def(), "initial_num_buckets",
+                                    &initial_num_buckets));
+    mutex_lock l(mu_);
+    OP_REQUIRES_OK(ctx, AllocateBuckets(ctx, initial_num_buckets));
+  }
+
+  size_t size() const override TF_LOCKS_EXCLUDED(mu_) {
+    tf_shared_lock l(mu_);
+    return num_entries_;
+  }
+
+  Status Find(OpKernelContext* ctx, const Tensor& key, Tensor* value,
+              const Tensor& default_value) override TF_LOCKS_EXCLUDED(mu_) {
+    const int64_t num_elements = key.NumElements();
+    const int64_t value_size = value_shape_.num_elements();
+    tf_shared_lock l(mu_);
+    return functor::DenseHashTableFind<K, V>()(
+        ctx->eigen_device<GPUDevice>(), num_elements, key.flat<K>().data(),
+        value_size, default_value.flat<V>().data(), num_buckets_,
+        key_buckets_.flat<K>().data(), value_buckets_.flat<V>().data(),
+        empty_key_, deleted_key_, value->flat<V>().data());
+  }
+
+  Status Insert(OpKernelContext* ctx, const Tensor& key,
+                const Tensor& value) override TF_LOCKS_EXCLUDED(mu_) {
+    const int64_t batch_size = key.NumElements();
+    mutex_lock l(mu_);
+    // As in MutableDenseHashTable, all the keys are assumed to be new. The
+    // deleted buckets count as used until the table is rebucketed.
+    if (num_entries_ + num_deleted_ + batch_size >
+        num_buckets_ * max_load_factor_) {
+      int64_t new_num_buckets = num_buckets_;
+      while (num_entries_ + batch_size > new_num_buckets * max_load_factor_) {
+        new_num_buckets <<= 1;
+      }
+      TF_RETURN_IF_ERROR(Rebucket(ctx, new_num_buckets));
+    }
+    TF_RETURN_IF_ERROR(functor::DenseHashTableInsert<K, V>()(
+        ctx->eigen_device<GPUDevice>(), batch_size, key.flat<K>().data(),
+        value_shape_.num_elements(), value.flat<V>().data(), num_buckets_,
+        key_buckets_.flat<K>().data(), value_buckets_.flat<V>().data(),
+        empty_key_, deleted_key_, device_counters_.flat<int64_t>().data()));
+    return SyncCounters(ctx);
+  }
+
+  Status Remove(OpKernelContext* ctx, const Tensor& key) override
+      TF_LOCKS_EXCLUDED(mu_) {
+    mutex_lock l(mu_);
+    int64_t* counters = device_counters_.flat<int64_t>().data();
+    TF_RETURN_IF_ERROR(functor::DenseHashTableRemove<K>()(
+        ctx->eigen_device<GPUDevice>(), key.NumElements(),
+        key.flat<K>().data(), num_buckets_, key_buckets_.flat<K>().data(),
+        empty_key_, deleted_key_, counters, counters + 1));
+    return SyncCounters(ctx);
+  }
+
+  Status ImportValues(OpKernelContext* ctx, const Tensor& keys,
+                      const Tensor& values) override TF_LOCKS_EXCLUDED(mu_) {
+    const int64_t num_buckets = keys.dim_size(0);
+    if (num_buckets < 4 || (num_buckets & (num_buckets - 1)) != 0) {
+      return errors::InvalidArgument(
+          "Number of buckets must be at least 4 and a power of 2, got: ",
+          num_buckets);
+    }
+    mutex_lock l(mu_);
+    num_buckets_ = num_buckets;
+    key_buckets_ = keys;
+    value_buckets_ = values;
+    TF_RETURN_IF_ERROR(ZeroCounters(ctx));
+    int64_t* counters = device_counters_.flat<int64_t>().data();
+    TF_RETURN_IF_ERROR(functor::DenseHashTableCount<K>()(
+        ctx->eigen_device<GPUDevice>(), num_buckets_,
+        key_buckets_.flat<K>().data(), empty_key_, deleted_key_, counters,
+        counters + 1));
+    return SyncCounters(ctx);
+  }
+
+  Status ExportValues(OpKernelContext* ctx) override TF_LOCKS_EXCLUDED(mu_) {
+    tf_shared_lock l(mu_);
+    TF_RETURN_IF_ERROR(ctx->set_output("keys", key_buckets_));
+    TF_RETURN_IF_ERROR(ctx->set_output("values", value_buckets_));
+    return OkStatus();
+  }
+
+  Status CheckKeyAndValueTensorsForImport(const Tensor& keys,
+                                          const Tensor& values) override {
+    TF_RETURN_IF_ERROR(CheckKeyAndValueTypes(keys, values));
+    TF_RETURN_IF_ERROR(CheckKeyShape(keys.shape()));
+
+    // The buckets are stored as in MutableDenseHashTable, with keys of shape
+    // [num_buckets, 1].
+    TensorShape expected_key_shape({keys.dim_size(0), 1});
+    TensorShape expected_value_shape({keys.dim_size(0)});
+    expected_value_shape.AppendShape(MaybeVectorizeShape(value_shape_));
+    if (keys.shape() != expected_key_shape) {
+      return errors::InvalidArgument("Expected shape ",
+                                     expected_key_shape.DebugString(),
+                                     " for keys, got ",
+                                     keys.shape().DebugString());
+    }
+    if (values.shape() != expected_value_shape) {
+      return errors::InvalidArgument(
+          "Expected shape ", expected_value_shape.DebugString(),
+          " for value, got ", values.shape().DebugString());
+    }
+    return OkStatus();
+  }
+
+  DataType key_dtype() const override { return DataTypeToEnum<K>::v(); }
+
+  DataType value_dtype() const override { return DataTypeToEnum<V>::v(); }
+
+  TensorShape key_shape() const override { return TensorShape(); }
+
+  TensorShape value_shape() const override { return value_shape_; }
+
+  int64_t MemoryUsed() const override TF_LOCKS_EXCLUDED(mu_) {
+    tf_shared_lock l(mu_);
+    return sizeof(MutableDenseHashTableGpu) + key_buckets_.AllocatedBytes() +
+           value_buckets_.AllocatedBytes() + device_counters_.AllocatedBytes();
+  }
+
+ private:
+  typedef Eigen::GpuDevice GPUDevice;
+
+  Status AllocateBuckets(OpKernelContext* ctx, int64_t new_num_buckets)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    if (new_num_buckets < 4 ||
+        ((new_num_buckets & (new_num_buckets - 1)) != 0)) {
+      return errors::InvalidArgument(
+          "Number of buckets must be at least 4 and a power of 2, got: ",
+          new_num_buckets);
+    }
+    num_buckets_ = new_num_buckets;
+    const int64_t value_size = value_shape_.num_elements();
+    TF_RETURN_IF_ERROR(ctx->allocate_temp(
+        key_dtype(), TensorShape({num_buckets_, 1}), &key_buckets_));
+    TF_RETURN_IF_ERROR(ctx->allocate_temp(
+        value_dtype(), TensorShape({num_buckets_, value_size}),
+        &value_buckets_));
+    TF_RETURN_IF_ERROR(functor::DenseHashTableClear<K, V>()(
+        ctx->eigen_device<GPUDevice>(), num_buckets_, value_size, empty_key_,
+        key_buckets_.flat<K>().data(), value_buckets_.flat<V>().data()));
+    return ZeroCounters(ctx);
+  }
+
+  Status Rebucket(OpKernelContext* ctx, int64_t num_new_buckets)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    Tensor old_key_buckets = key_buckets_;
+    Tensor old_value_buckets = value_buckets_;
+    const int64_t old_num_buckets = num_buckets_;
+    TF_RETURN_IF_ERROR(AllocateBuckets(ctx, num_new_buckets));
+    // The empty and deleted buckets are skipped by the insertion.
+    return functor::DenseHashTableInsert<K, V>()(
+        ctx->eigen_device<GPUDevice>(), old_num_buckets,
+        old_key_buckets.flat<K>().data(), value_shape_.num_elements(),
+        old_value_buckets.flat<V>().data(), num_buckets_,
+        key_buckets_.flat<K>().data(), value_buckets_.flat<V>().data(),
+        empty_key_, deleted_key_, device_counters_.flat<int64_t>().data());
+  }
+
+  Status ZeroCounters(OpKernelContext* ctx) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    se::DeviceMemoryBase counters(device_counters_.flat<int64_t>().data(),
+                                  device_counters_.TotalBytes());
+    if (!ctx->op_device_context()
+             ->stream()
+             ->ThenMemZero(&counters, device_counters_.TotalBytes())
+             .ok()) {
+      return errors::Internal("Failed to clear the hash table counters");
+    }
+    num_entries_ = 0;
+    num_deleted_ = 0;
+    return OkStatus();
+  }
+
+  // Copies the number of entries and deleted buckets to the host.
+  Status SyncCounters(OpKernelContext* ctx) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    se::Stream* stream = ctx->op_device_context()->stream();
+    int64_t counters[2];
+    se::DeviceMemoryBase device_counters(
+        device_counters_.flat<int64_t>().data(), sizeof(counters));
+    if (!stream->ThenMemcpy(counters, device_counters, sizeof(counters))
+             .ok()) {
+      return errors::Internal("Failed to copy the hash table counters");
+    }
+    TF_RETURN_IF_ERROR(stream->BlockHostUntilDone());
+    num_entries_ = counters[0];
+    num_deleted_ = counters[1];
+    return OkStatus();
+  }
+
+  TensorShape value_shape_;
+  float max_load_factor_;
+  K empty_key_;
+  K deleted_key_;
+  mutable mutex mu_;
+  int64_t num_entries_ TF_GUARDED_BY(mu_) = 0;
+  int64_t num_deleted_ TF_GUARDED_BY(mu_) = 0;
+  int64_t num_buckets_ TF_GUARDED_BY(mu_) = 0;
+  Tensor key_buckets_ TF_GUARDED_BY(mu_);
+  Tensor value_buckets_ TF_GUARDED_BY(mu_);
+  // The number of entries and deleted buckets, in GPU memory.
+  Tensor device_counters_ TF_GUARDED_BY(mu_);
+};
+
+#endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+
 }  // namespace lookup
 
 // Base class for kernels that take a LookupTable handle as the 0th input.
@@ -1076,6 +1551,43 @@ REGISTER_KERNEL_BUILDER(Name("LookupTableImport").Device(DEVICE_CPU),
 REGISTER_KERNEL_BUILDER(Name("LookupTableImportV2").Device(DEVICE_CPU),
                         LookupTableImportOp);
 
+// Op that adds updates to the values of the given keys.
+class LookupTableScatterAddOp : public LookupTableOpKernel {
+ public:
+  using LookupTableOpKernel::LookupTableOpKernel;
+
+  void Compute(OpKernelContext* ctx) override {
+    lookup::LookupInterface* table;
+    OP_REQUIRES_OK(ctx, GetTable(ctx, &table));
+    core::ScopedUnref unref_me(table);
+    auto* scatter_add_table =
+        dynamic_cast<lookup::ScatterAddLookupInterface*>(table);
+    OP_REQUIRES(ctx, scatter_add_table != nullptr,
+                errors::Unimplemented("The table does not support ScatterAdd"));
+
+    DataTypeVector expected_inputs = {expected_input_0_, table->key_dtype(),
+                                      table->value_dtype()};
+    OP_REQUIRES_OK(ctx, ctx->MatchSignature(expected_inputs, {}));
+
+    const Tensor& keys = ctx->input(1);
+    const Tensor& updates = ctx->input(2);
+    OP_REQUIRES_OK(ctx, table->CheckKeyAndValueTensorsForInsert(keys, updates));
+
+    int64_t memory_used_before = 0;
+    if (ctx->track_allocations()) {
+      memory_used_before = table->MemoryUsed();
+    }
+    OP_REQUIRES_OK(ctx, scatter_add_table->ScatterAdd(ctx, keys, updates));
+    if (ctx->track_allocations()) {
+      ctx->record_persistent_memory_allocation(table->MemoryUsed() -
+                                               memory_used_before);
+    }
+  }
+};
+
+REGISTER_KERNEL_BUILDER(Name("_LookupTableScatterAdd").Device(DEVICE_CPU),
+                        LookupTableScatterAddOp);
+
 // Register the HashTable op with the currently supported key and value types.
 #define REGISTER_KERNEL(key_dtype, value_dtype)                           \
   REGISTER_KERNEL_BUILDER(                                                \
@@ -1201,6 +1713,33 @@ REGISTER_KERNEL(tstring, int64_t);
 
 #undef REGISTER_KERNEL
 
+// Register the DynamicEmbeddingTable op.
+#define REGISTER_KERNEL(key_dtype, value_dtype)                            \
+  REGISTER_KERNEL_BUILDER(                                                 \
+      Name("_DynamicEmbeddingTable")                                       \
+          .Device(DEVICE_CPU)                                              \
+          .TypeConstraint<key_dtype>("key_dtype")                          \
+          .TypeConstraint<value_dtype>("value_dtype"),                     \
+      LookupTableOp<lookup::DynamicEmbeddingTable<key_dtype, value_dtype>, \
+                    key_dtype, value_dtype>)                               \
+  REGISTER_KERNEL_BUILDER(                                                 \
+      Name("_AnonymousDynamicEmbeddingTable")                              \
+          .Device(DEVICE_CPU)                                              \
+          .TypeConstraint<key_dtype>("key_dtype")                          \
+          .TypeConstraint<value_dtype>("value_dtype"),                     \
+      AnonymousLookupTableOp<                                              \
+          lookup::DynamicEmbeddingTable<key_dtype, value_dtype>, key_dtype, \
+          value_dtype>)
+
+REGISTER_KERNEL(int32, double);
+REGISTER_KERNEL(int32, float);
+REGISTER_KERNEL(int64_t, double);
+REGISTER_KERNEL(int64_t, float);
+REGISTER_KERNEL(tstring, double);
+REGISTER_KERNEL(tstring, float);
+
+#undef REGISTER_KERNEL
+
 // Register the MutableDenseHashTable op.
 #define REGISTER_KERNEL(key_dtype, value_dtype)                             \
   REGISTER_KERNEL_BUILDER(                                                  \
@@ -1244,4 +1783,76 @@ REGISTER_KERNEL(tstring, ResourceHandle);
 
 #undef REGISTER_KERNEL
 
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+
+// Register the GPU MutableDenseHashTable. Only int64 keys are supported, as the
+// int32 tensors are kept in host memory on GPU.
+#define REGISTER_KERNEL(key_dtype, value_dtype)                              \
+  REGISTER_KERNEL_BUILDER(                                                   \
+      Name("MutableDenseHashTableV2")                                        \
+          .Device(DEVICE_GPU)                                                \
+          .HostMemory("empty_key")                                           \
+          .HostMemory("deleted_key")                                         \
+          .HostMemory("table_handle")                                        \
+          .TypeConstraint<key_dtype>("key_dtype")                            \
+          .TypeConstraint<value_dtype>("value_dtype"),                       \
+      LookupTableOp<lookup::MutableDenseHashTableGpu<key_dtype, value_dtype>, \
+                    key_dtype, value_dtype>)                                 \
+  REGISTER_KERNEL_BUILDER(                                                   \
+      Name("AnonymousMutableDenseHashTable")                                 \
+          .Device(DEVICE_GPU)                                                \
+          .HostMemory("empty_key")                                           \
+          .HostMemory("deleted_key")                                         \
+          .HostMemory("table_handle")                                        \
+          .TypeConstraint<key_dtype>("key_dtype")                            \
+          .TypeConstraint<value_dtype>("value_dtype"),                       \
+      AnonymousLookupTableOp<                                                \
+          lookup::MutableDenseHashTableGpu<key_dtype, value_dtype>,          \
+          key_dtype, value_dtype>)
+
+REGISTER_KERNEL(int64_t, double);
+REGISTER_KERNEL(int64_t, float);
+REGISTER_KERNEL(int64_t, int64_t);
+
+#undef REGISTER_KERNEL
+
+#define REGISTER_KERNEL(key_dtype)                                       \
+  REGISTER_KERNEL_BUILDER(Name("LookupTableFindV2")                      \
+                              .Device(DEVICE_GPU)                        \
+                              .HostMemory("table_handle")                \
+                              .TypeConstraint<key_dtype>("Tin"),         \
+                          LookupTableFindOp);                            \
+  REGISTER_KERNEL_BUILDER(Name("LookupTableInsertV2")                    \
+                              .Device(DEVICE_GPU)                        \
+                              .HostMemory("table_handle")                \
+                              .TypeConstraint<key_dtype>("Tin"),         \
+                          LookupTableInsertOp);                          \
+  REGISTER_KERNEL_BUILDER(Name("LookupTableRemoveV2")                    \
+                              .Device(DEVICE_GPU)                        \
+                              .HostMemory("table_handle")                \
+                              .TypeConstraint<key_dtype>("Tin"),         \
+                          LookupTableRemoveOp);                          \
+  REGISTER_KERNEL_BUILDER(Name("LookupTableExportV2")                    \
+                              .Device(DEVICE_GPU)                        \
+                              .HostMemory("table_handle")                \
+                              .TypeConstraint<key_dtype>("Tkeys"),       \
+                          LookupTableExportOp);                          \
+  REGISTER_KERNEL_BUILDER(Name("LookupTableImportV2")                    \
+                              .Device(DEVICE_GPU)                        \
+                              .HostMemory("table_handle")                \
+                              .TypeConstraint<key_dtype>("Tin"),         \
+                          LookupTableImportOp);
+
+REGISTER_KERNEL(int64_t);
+
+#undef REGISTER_KERNEL
+
+REGISTER_KERNEL_BUILDER(Name("LookupTableSizeV2")
+                            .Device(DEVICE_GPU)
+                            .HostMemory("table_handle")
+                            .HostMemory("size"),
+                        LookupTableSizeOp);
+
+#endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+
 }  // namespace tensorflow
@@ -45,9 +45,12 @@ class LookupTableOp : public OpKernel {
   explicit LookupTableOp(OpKernelConstruction* ctx)
       : OpKernel(ctx), table_set_(false) {
     if (ctx->output_type(0) == DT_RESOURCE) {
-      OP_REQUIRES_OK(ctx,
-                     ctx->allocate_temp(tensorflow::DT_RESOURCE,
-                                        tensorflow::TensorShape({}), &table_));
+      // The handle is always in host memory, including for the GPU tables.
+      AllocatorAttributes attr;
+      attr.set_on_host(true);
+      OP_REQUIRES_OK(ctx, ctx->allocate_temp(tensorflow::DT_RESOURCE,
+                                             tensorflow::TensorShape({}),
+                                             &table_, attr));
     } else {
       OP_REQUIRES_OK(ctx,
                      ctx->allocate_temp(tensorflow::DT_STRING,
@@ -150,9 +153,11 @@ class AnonymousLookupTableOp : public OpKernel {
       return;
     }
     Tensor table_tensor;
-    OP_REQUIRES_OK(
-        ctx, ctx->allocate_temp(tensorflow::DT_RESOURCE,
-                                tensorflow::TensorShape({}), &table_tensor));
+    AllocatorAttributes attr;
+    attr.set_on_host(true);
+    OP_REQUIRES_OK(ctx, ctx->allocate_temp(tensorflow::DT_RESOURCE,
+                                           tensorflow::TensorShape({}),
+                                           &table_tensor, attr));
     if (ctx->track_allocations()) {
       ctx->record_persistent_memory_allocation(table->MemoryUsed() +
                                                table_tensor.AllocatedBytes());
@@ -200,6 +205,15 @@ inline const ResourceHandle& SubtleMustCopyIfIntegral(
 // Returns a unique node name starting with "base".
 std::string UniqueNodeName(const std::string& base);
 
+// A lookup table that can be updated in place with ScatterAdd.
+class ScatterAddLookupInterface : public LookupInterface {
+ public:
+  // Adds `updates` [keys..., value_shape] to the values of `keys`, the values
+  // of missing keys starting at zero.
+  virtual Status ScatterAdd(OpKernelContext* ctx, const Tensor& keys,
+                            const Tensor& updates) = 0;
+};
+
 // Lookup table that wraps an flat_hash_map, where the key and value data type
 // is specified.
 //
@@ -0,0 +1,233 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+
+#define EIGEN_USE_GPU
+
+#include "tensorflow/core/kernels/lookup_table_op_gpu.h"
+
+#include "tensorflow/core/util/gpu_kernel_helper.h"
+
+namespace tensorflow {
+namespace functor {
+
+namespace {
+
+template <typename K>
+__device__ K AtomicCasKey(K* ptr, K compare, K value) {
+  using U = detail::CudaSupportedType<K>;
+  return static_cast<K>(atomicCAS(detail::ToCudaSupportedPtr(ptr),
+                                  static_cast<U>(compare),
+                                  static_cast<U>(value)));
+}
+
+// Returns the bucket holding key, or -1 if it is not in the table.
+template <typename K>
+__device__ int64_t FindBucket(K key, int64_t bit_mask, const K* key_buckets,
+                              K empty_key) {
+  int64_t bucket = static_cast<uint64>(key) & bit_mask;
+  for (int64_t num_probes = 1; num_probes <= bit_mask + 1; ++num_probes) {
+    const K bucket_key = key_buckets[bucket];
+    if (bucket_key == key) return bucket;
+    if (bucket_key == empty_key) return -1;
+    bucket = (bucket + num_probes) & bit_mask;  // quadratic probing
+  }
+  return -1;
+}
+
+template <typename K, typename V>
+__global__ void DenseHashTableFindKernel(
+    int64_t num_keys, const K* __restrict__ keys, int64_t value_size,
+    const V* __restrict__ default_value, int64_t bit_mask,
+    const K* __restrict__ key_buckets, const V* __restrict__ value_buckets,
+    K empty_key, K deleted_key, V* __restrict__ values) {
+  GPU_1D_KERNEL_LOOP(i, num_keys) {
+    const K key = keys[i];
+    int64_t bucket = -1;
+    if (key != empty_key && key != deleted_key) {
+      bucket = FindBucket(key, bit_mask, key_buckets, empty_key);
+    }
+    const V* value =
+        bucket < 0 ? default_value : value_buckets + bucket * value_size;
+    for (int64_t j = 0; j < value_size; ++j) {
+      values[i * value_size + j] = value[j];
+    }
+  }
+}
+
+template <typename K, typename V>
+__global__ void DenseHashTableInsertKernel(
+    int64_t num_keys, const K* __restrict__ keys, int64_t value_size,
+    const V* __restrict__ values, int64_t bit_mask, K* key_buckets,
+    V* value_buckets, K empty_key, K deleted_key, int64_t* num_entries) {
+  GPU_1D_KERNEL_LOOP(i, num_keys) {
+    const K key = keys[i];
+    if (key == empty_key || key == deleted_key) continue;
+    int64_t bucket = static_cast<uint64>(key) & bit_mask;
+    for (int64_t num_probes = 1; num_probes <= bit_mask + 1; ++num_probes) {
+      // The buckets only go from empty to holding a key during insertions,
+      // so a stale read of an empty bucket only falls back to the CAS.
+      K bucket_key = key_buckets[bucket];
+      if (bucket_key == empty_key) {
+        bucket_key = AtomicCasKey(key_buckets + bucket, empty_key, key);
+        if (bucket_key == empty_key) {
+          GpuAtomicAdd(num_entries, int64_t{1});
+          bucket_key = key;
+        }
+      }
+      if (bucket_key == key) {
+        for (int64_t j = 0; j < value_size; ++j) {
+          value_buckets[bucket * value_size + j] = values[i * value_size + j];
+        }
+        break;
+      }
+      bucket = (bucket + num_probes) & bit_mask;  // quadratic probing
+    }
+  }
+}
+
+template <typename K>
+__global__ void DenseHashTableRemoveKernel(int64_t num_keys,
+                                           const K* __restrict__ keys,
+                                           int64_t bit_mask, K* key_buckets,
+                                           K empty_key, K deleted_key,
+                                           int64_t* num_entries,
+                                           int64_t* num_deleted) {
+  GPU_1D_KERNEL_LOOP(i, num_keys) {
+    const K key = keys[i];
+    if (key == empty_key || key == deleted_key) continue;
+    const int64_t bucket = FindBucket(key, bit_mask, key_buckets, empty_key);
+    // The CAS only lets one of the repetitions of a key count its removal.
+    if (bucket >= 0 &&
+        AtomicCasKey(key_buckets + bucket, key, deleted_key) == key) {
+      GpuAtomicAdd(num_entries, int64_t{-1});
+      GpuAtomicAdd(num_deleted, int64_t{1});
+    }
+  }
+}
+
+template <typename K>
+__global__ void DenseHashTableCountKernel(int64_t num_buckets,
+                                          const K* __restrict__ key_buckets,
+                                          K empty_key, K deleted_key,
+                                          int64_t* num_entries,
+                                          int64_t* num_deleted) {
+  int64_t thread_num_entries = 0;
+  int64_t thread_num_deleted = 0;
+  GPU_1D_KERNEL_LOOP(i, num_buckets) {
+    const K key = key_buckets[i];
+    if (key == deleted_key) {
+      ++thread_num_deleted;
+    } else if (key != empty_key) {
+      ++thread_num_entries;
+    }
+  }
+  if (thread_num_entries > 0) GpuAtomicAdd(num_entries, thread_num_entries);
+  if (thread_num_deleted > 0) GpuAtomicAdd(num_deleted, thread_num_deleted);
+}
+
+}  // namespace
+
+template <typename K, typename V>
+Status DenseHashTableClear<K, V>::operator()(const GPUDevice& d,
+                                             int64_t num_buckets,
+                                             int64_t value_size, K empty_key,
+                                             K* key_buckets, V* value_buckets) {
+  if (num_buckets == 0) return OkStatus();
+  GpuLaunchConfig config = GetGpuLaunchConfig(num_buckets, d);
+  TF_RETURN_IF_ERROR(GpuLaunchKernel(SetToValue<K>, config.block_count,
+                                     config.thread_per_block, 0, d.stream(),
+                                     num_buckets, key_buckets, empty_key));
+  config = GetGpuLaunchConfig(num_buckets * value_size, d);
+  return GpuLaunchKernel(SetZero<V>, config.block_count,
+                         config.thread_per_block, 0, d.stream(),
+                         num_buckets * value_size, value_buckets);
+}
+
+template <typename K, typename V>
+Status DenseHashTableFind<K, V>::operator()(
+    const GPUDevice& d, int64_t num_keys, const K* keys, int64_t value_size,
+    const V* default_value, int64_t num_buckets, const K* key_buckets,
+    const V* value_buckets, K empty_key, K deleted_key, V* values) {
+  if (num_keys == 0) return OkStatus();
+  GpuLaunchConfig config = GetGpuLaunchConfig(num_keys, d);
+  return GpuLaunchKernel(DenseHashTableFindKernel<K, V>, config.block_count,
+                         config.thread_per_block, 0, d.stream(), num_keys,
+                         keys, value_size, default_value, num_buckets - 1,
+                         key_buckets, value_buckets, empty_key, deleted_key,
+                         values);
+}
+
+template <typename K, typename V>
+Status DenseHashTableInsert<K, V>::operator()(
+    const GPUDevice& d, int64_t num_keys, const K* keys, int64_t value_size,
+    const V* values, int64_t num_buckets, K* key_buckets, V* value_buckets,
+    K empty_key, K deleted_key, int64_t* num_entries) {
+  if (num_keys == 0) return OkStatus();
+  GpuLaunchConfig config = GetGpuLaunchConfig(num_keys, d);
+  return GpuLaunchKernel(DenseHashTableInsertKernel<K, V>, config.block_count,
+                         config.thread_per_block, 0, d.stream(), num_keys,
+                         keys, value_size, values, num_buckets - 1,
+                         key_buckets, value_buckets, empty_key, deleted_key,
+                         num_entries);
+}
+
+template <typename K>
+Status DenseHashTableRemove<K>::operator()(const GPUDevice& d, int64_t num_keys,
+                                          const K* keys, int64_t num_buckets,
+                                          K* key_buckets, K empty_key,
+                                          K deleted_key, int64_t* num_entries,
+                                          int64_t* num_deleted) {
+  if (num_keys == 0) return OkStatus();
+  GpuLaunchConfig config = GetGpuLaunchConfig(num_keys, d);
+  return GpuLaunchKernel(DenseHashTableRemoveKernel<K>, config.block_count,
+                         config.thread_per_block, 0, d.stream(), num_keys,
+                         keys, num_buckets - 1, key_buckets, empty_key,
+                         deleted_key, num_entries, num_deleted);
+}
+
+template <typename K>
+Status DenseHashTableCount<K>::operator()(const GPUDevice& d,
+                                         int64_t num_buckets,
+                                         const K* key_buckets, K empty_key,
+                                         K deleted_key, int64_t* num_entries,
+                                         int64_t* num_deleted) {
+  if (num_buckets == 0) return OkStatus();
+  GpuLaunchConfig config = GetGpuLaunchConfig(num_buckets, d);
+  return GpuLaunchKernel(DenseHashTableCountKernel<K>, config.block_count,
+                         config.thread_per_block, 0, d.stream(), num_buckets,
+                         key_buckets, empty_key, deleted_key, num_entries,
+                         num_deleted);
+}
+
+#define DEFINE_GPU_SPECS(K, V)               \
+  template struct DenseHashTableClear<K, V>; \
+  template struct DenseHashTableFind<K, V>;  \
+  template struct DenseHashTableInsert<K, V>;
+
+DEFINE_GPU_SPECS(int64_t, double);
+DEFINE_GPU_SPECS(int64_t, float);
+DEFINE_GPU_SPECS(int64_t, int64_t);
+
+#undef DEFINE_GPU_SPECS
+
+template struct DenseHashTableRemove<int64_t>;
+template struct DenseHashTableCount<int64_t>;
+
+}  // namespace functor
+}  // namespace tensorflow
+
+#endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
@@ -0,0 +1,94 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_KERNELS_LOOKUP_TABLE_OP_GPU_H_
+#define TENSORFLOW_CORE_KERNELS_LOOKUP_TABLE_OP_GPU_H_
+
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+
+#define EIGEN_USE_GPU
+
+#include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/lib/core/status.h"
+
+namespace tensorflow {
+namespace functor {
+
+typedef Eigen::GpuDevice GPUDevice;
+
+// Functors operating on the buckets of a MutableDenseHashTable resident in GPU
+// memory: key_buckets is [num_buckets, 1] and value_buckets is
+// [num_buckets, value_size]. num_buckets is a power of 2 and the buckets are
+// probed as in the CPU table (identity hash and quadratic probing), so that
+// the exported buckets can be imported by either implementation. The keys
+// equal to empty_key or deleted_key are ignored, as their lookups return the
+// default value.
+
+// Sets all the key buckets to empty_key and the value buckets to zero.
+template <typename K, typename V>
+struct DenseHashTableClear {
+  Status operator()(const GPUDevice& d, int64_t num_buckets, int64_t value_size,
+                    K empty_key, K* key_buckets, V* value_buckets);
+};
+
+// Looks up keys [num_keys] and writes their values, or default_value
+// [value_size] if they are not in the table, to values [num_keys, value_size].
+template <typename K, typename V>
+struct DenseHashTableFind {
+  Status operator()(const GPUDevice& d, int64_t num_keys, const K* keys,
+                    int64_t value_size, const V* default_value,
+                    int64_t num_buckets, const K* key_buckets,
+                    const V* value_buckets, K empty_key, K deleted_key,
+                    V* values);
+};
+
+// Inserts or updates keys [num_keys] with values [num_keys, value_size],
+// adding the number of new keys to *num_entries. Only empty buckets are
+// claimed, with an atomic compare-and-swap, so that concurrent insertions of
+// the same key end up in a single bucket. Which of the values of a key that
+// is repeated in keys is kept is unspecified.
+template <typename K, typename V>
+struct DenseHashTableInsert {
+  Status operator()(const GPUDevice& d, int64_t num_keys, const K* keys,
+                    int64_t value_size, const V* values, int64_t num_buckets,
+                    K* key_buckets, V* value_buckets, K empty_key,
+                    K deleted_key, int64_t* num_entries);
+};
+
+// Replaces the buckets of keys [num_keys] by deleted_key, subtracting the
+// number of removed keys from *num_entries and adding it to *num_deleted.
+template <typename K>
+struct DenseHashTableRemove {
+  Status operator()(const GPUDevice& d, int64_t num_keys, const K* keys,
+                    int64_t num_buckets, K* key_buckets, K empty_key,
+                    K deleted_key, int64_t* num_entries, int64_t* num_deleted);
+};
+
+// Adds the number of buckets holding a key to *num_entries and the number of
+// deleted buckets to *num_deleted.
+template <typename K>
+struct DenseHashTableCount {
+  Status operator()(const GPUDevice& d, int64_t num_buckets,
+                    const K* key_buckets, K empty_key, K deleted_key,
+                    int64_t* num_entries, int64_t* num_deleted);
+};
+
+}  // namespace functor
+}  // namespace tensorflow
+
+#endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+
+#endif  // TENSORFLOW_CORE_KERNELS_LOOKUP_TABLE_OP_GPU_H_
@@ -324,10 +324,12 @@ def _gen_kernel_library(
     all_kernels = aot_kernels + all_jit_kernels + all_paratial_jit_kernels
     if cuda_gpu_architectures() or rocm_gpu_architectures():
         for (type, output_type, jit, jit_i64_indexed_for_large_tensors) in all_kernels:
-            # Disable unrolling for integer types while LLVM does not vectorize these.
-            # See b/182343395 for context.
+            # Disable unrolling for integer types while LLVM does not vectorize these
+            # for NVPTX. See b/182343395 for context. The AMDGPU backend merges the
+            # unrolled integer loads and stores into vector ones, so ROCm keeps it.
             integer_types = ["i1", "i8", "i16", "i32", "i64", "ui8", "ui16", "ui32", "ui64"]
-            typed_unroll_factors = None if type in integer_types else unroll_factors
+            disable_unrolling = type in integer_types and cuda_gpu_architectures()
+            typed_unroll_factors = None if disable_unrolling else unroll_factors
             typed_unroll_factors = _get_shape(typed_unroll_factors, type, unroll_factors_override)
             typed_tile_size = _get_shape(tile_size, type, tile_size_override)
             _gen_mlir_op(
@@ -133,12 +133,25 @@ Status CopyVariable(int output_idx, OpKernelContext* ctx, const Tensor* t) {
   return OkStatus();
 }
 
+// Switches `var` out of copy-on-read mode ahead of a read. Sparse updates in
+// copy-on-read mode write in place under a shared lock, so a read would have
+// to copy the whole variable. Outside of that mode the read shares the buffer
+// of the variable instead, and the next sparse update (see
+// EnsureSparseVariableAccess) copies the buffer only if the read output is
+// still alive.
+void LeaveCopyOnReadMode(Var* var) {
+  if (var->copy_on_read_mode.load()) {
+    mutex_lock ml(*var->mu());
+    var->copy_on_read_mode.store(false);
+  }
+}
+
 }  // namespace
 
 void ReadVariableOp::Compute(OpKernelContext* ctx) {
   core::RefCountPtr<Var> variable;
   const ResourceHandle& handle = HandleFromInput(ctx, 0);
-  const auto status = LookupResource(ctx, handle, &variable);
+  const auto status = variable_cache_.Lookup(ctx, handle, &variable);
   OP_REQUIRES(ctx, status.ok(),
               errors::FailedPrecondition(
                   "Could not find variable ", handle.name(), ". ",
@@ -147,10 +160,12 @@ void ReadVariableOp::Compute(OpKernelContext* ctx) {
                   "Debug info: container=", handle.container(),
                   ", status error message=", status.message()));
 
+  LeaveCopyOnReadMode(variable.get());
   tf_shared_lock ml(*variable->mu());
   // We're acquiring a reference to the underlying buffer while
   // holding a shared lock to guarantee ordering of reads and
-  // writes when in copy-on-write mode.
+  // writes when in copy-on-write mode. A sparse update may have switched the
+  // variable back to copy-on-read mode since, in which case it is copied.
   const Tensor* t = variable->tensor();
   if (!variable->copy_on_read_mode.load()) {
     OP_REQUIRES(
@@ -200,6 +215,7 @@ void ReadVariablesOp::Compute(OpKernelContext* ctx) {
     // We're acquiring a reference to the underlying buffer while
     // holding a shared lock to guarantee ordering of reads and
     // writes.
+    LeaveCopyOnReadMode(variables[i].get());
     tf_shared_lock ml(*variables[i]->mu());
     OP_REQUIRES(ctx, dtypes_[i] == variables[i]->tensor()->dtype(),
                 errors::InvalidArgument(
@@ -46,6 +46,7 @@ class ReadVariableOp : public OpKernel {
 
  private:
   DataType dtype_;
+  ResourceLookupCache<Var> variable_cache_;
 };
 
 class ReadVariablesOp : public OpKernel {
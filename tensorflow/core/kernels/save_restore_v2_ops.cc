@@ -15,6 +15,8 @@ limitations under the License.
 
 // See docs in ../ops/io_ops.cc.
 
+#include <algorithm>
+#include <numeric>
 #include <string>
 #include <vector>
 
@@ -27,7 +29,9 @@ limitations under the License.
 #include "tensorflow/core/kernels/checkpoint_callback_manager.h"
 #include "tensorflow/core/kernels/save_restore_tensor.h"
 #include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/types.h"
@@ -87,6 +91,114 @@ void ValidateInputs(bool is_save_op, OpKernelContext* context,
   }
 }
 
+// Checkpoints at least this large are written as several shards in parallel,
+// since a single sequential writer is far from saturating the bandwidth of
+// distributed file systems.
+const int64_t kParallelSaveThreshold = static_cast<int64_t>(1) << 28;
+// Maximum number of shards written in parallel by a single SaveV2 op.
+const int kMaxParallelSaveShards = 8;
+
+// Partitions the tensors to save into shards of roughly equal sizes, each
+// holding the indices of its tensors, in order. Returns a single shard for
+// small checkpoints.
+std::vector<std::vector<int>> PartitionTensorsForSave(OpKernelContext* context,
+                                                      int num_tensors) {
+  const int kFixedInputs = 3;  // Prefix, tensor names, shape_and_slices.
+  int64_t total_bytes = 0;
+  for (int i = 0; i < num_tensors; ++i) {
+    total_bytes += context->input(i + kFixedInputs).TotalBytes();
+  }
+  const int num_shards =
+      total_bytes < kParallelSaveThreshold
+          ? 1
+          : std::min(num_tensors, kMaxParallelSaveShards);
+  std::vector<std::vector<int>> shards(num_shards);
+  if (num_shards == 1) {
+    shards[0].resize(num_tensors);
+    std::iota(shards[0].begin(), shards[0].end(), 0);
+    return shards;
+  }
+
+  // Assigns the largest tensors first, each to the smallest shard so far.
+  std::vector<int> order(num_tensors);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [context](int a, int b) {
+    return context->input(a + kFixedInputs).TotalBytes() >
+           context->input(b + kFixedInputs).TotalBytes();
+  });
+  std::vector<int64_t> shard_bytes(num_shards, 0);
+  for (int i : order) {
+    const int shard = std::min_element(shard_bytes.begin(), shard_bytes.end()) -
+                      shard_bytes.begin();
+    shards[shard].push_back(i);
+    shard_bytes[shard] += context->input(i + kFixedInputs).TotalBytes();
+  }
+  for (auto& shard : shards) {
+    std::sort(shard.begin(), shard.end());
+  }
+  return shards;
+}
+
+// Writes the tensors of the SaveV2 op at `indices` into a bundle at `prefix`.
+Status SaveTensors(OpKernelContext* context, const string& prefix,
+                   const std::vector<int>& indices) {
+  const int kFixedInputs = 3;  // Prefix, tensor names, shape_and_slices.
+  const auto& tensor_names_flat = context->input(1).flat<tstring>();
+  const auto& shape_and_slices_flat = context->input(2).flat<tstring>();
+
+  BundleWriter writer(Env::Default(), prefix);
+  TF_RETURN_IF_ERROR(writer.status());
+  VLOG(1) << "BundleWriter, prefix_string: " << prefix;
+
+  for (int i : indices) {
+    const string& tensor_name = tensor_names_flat(i);
+    const Tensor& tensor = context->input(i + kFixedInputs);
+    VLOG(2) << "Starting save of " << tensor_name;
+
+    if (!shape_and_slices_flat(i).empty()) {
+      const string& shape_spec = shape_and_slices_flat(i);
+      TensorShape shape;
+      TensorSlice slice(tensor.dims());
+      TensorShape slice_shape;
+
+      TF_RETURN_IF_ERROR(checkpoint::ParseShapeAndSlice(shape_spec, &shape,
+                                                        &slice, &slice_shape));
+      if (!slice_shape.IsSameSize(tensor.shape())) {
+        return errors::InvalidArgument(
+            "Slice in shape_and_slice specification does not match the shape "
+            "of the tensor to  save: ",
+            shape_spec, ", tensor: ", tensor.shape().DebugString());
+      }
+
+      TF_RETURN_IF_ERROR(writer.AddSlice(tensor_name, shape, slice, tensor));
+    } else {
+      TF_RETURN_IF_ERROR(writer.Add(tensor_name, tensor));
+    }
+
+    if (VLOG_IS_ON(5)) {
+      if (tensor.dtype() == DT_FLOAT) {
+        const float* t_data = tensor.flat<float>().data();
+        float min = std::numeric_limits<float>::infinity();
+        float max = -std::numeric_limits<float>::infinity();
+        double avg = 0.0;
+        for (int i = 0; i < tensor.NumElements(); ++i) {
+          if (t_data[i] < min) min = t_data[i];
+          if (t_data[i] > max) max = t_data[i];
+          avg += t_data[i];
+        }
+        VLOG(5) << " min " << min << " max " << max << " avg "
+                << avg / tensor.NumElements() << " total elts "
+                << tensor.NumElements();
+      }
+    }
+
+    VLOG(2) << "Done save of " << tensor_name;
+  }
+  TF_RETURN_IF_ERROR(writer.Finish());
+  VLOG(1) << "Done BundleWriter, prefix_string: " << prefix;
+  return OkStatus();
+}
+
 }  // namespace
 
 // Saves a list of named tensors using the tensor bundle library.
@@ -102,63 +214,37 @@ class SaveV2 : public OpKernel {
                    shape_and_slices);
     if (!context->status().ok()) return;
 
-    const int kFixedInputs = 3;  // Prefix, tensor names, shape_and_slices.
     const int num_tensors = static_cast<int>(tensor_names.NumElements());
     const string& prefix_string = prefix.scalar<tstring>()();
-    const auto& tensor_names_flat = tensor_names.flat<tstring>();
-    const auto& shape_and_slices_flat = shape_and_slices.flat<tstring>();
-
-    BundleWriter writer(Env::Default(), prefix_string);
-    OP_REQUIRES_OK(context, writer.status());
-    VLOG(1) << "BundleWriter, prefix_string: " << prefix_string;
-
-    for (int i = 0; i < num_tensors; ++i) {
-      const string& tensor_name = tensor_names_flat(i);
-      const Tensor& tensor = context->input(i + kFixedInputs);
-      VLOG(2) << "Starting save of " << tensor_name;
-
-      if (!shape_and_slices_flat(i).empty()) {
-        const string& shape_spec = shape_and_slices_flat(i);
-        TensorShape shape;
-        TensorSlice slice(tensor.dims());
-        TensorShape slice_shape;
-
-        OP_REQUIRES_OK(context, checkpoint::ParseShapeAndSlice(
-                                    shape_spec, &shape, &slice, &slice_shape));
-        OP_REQUIRES(context, slice_shape.IsSameSize(tensor.shape()),
-                    errors::InvalidArgument("Slice in shape_and_slice "
-                                            "specification does not match the "
-                                            "shape of the tensor to  save: ",
-                                            shape_spec, ", tensor: ",
-                                            tensor.shape().DebugString()));
-
-        OP_REQUIRES_OK(context,
-                       writer.AddSlice(tensor_name, shape, slice, tensor));
-      } else {
-        OP_REQUIRES_OK(context, writer.Add(tensor_name, tensor));
-      }
 
-      if (VLOG_IS_ON(5)) {
-        if (tensor.dtype() == DT_FLOAT) {
-          const float* t_data = tensor.flat<float>().data();
-          float min = std::numeric_limits<float>::infinity();
-          float max = -std::numeric_limits<float>::infinity();
-          double avg = 0.0;
-          for (int i = 0; i < tensor.NumElements(); ++i) {
-            if (t_data[i] < min) min = t_data[i];
-            if (t_data[i] > max) max = t_data[i];
-            avg += t_data[i];
-          }
-          VLOG(5) << " min " << min << " max " << max << " avg "
-                  << avg / tensor.NumElements() << " total elts "
-                  << tensor.NumElements();
+    const std::vector<std::vector<int>> shards =
+        PartitionTensorsForSave(context, num_tensors);
+    if (shards.size() == 1) {
+      OP_REQUIRES_OK(context, SaveTensors(context, prefix_string, shards[0]));
+    } else {
+      // Writes the shards in parallel as separate bundles, then merges them
+      // into a single bundle with one data file per shard.
+      const int num_shards = shards.size();
+      std::vector<tstring> shard_prefixes;
+      for (int i = 0; i < num_shards; ++i) {
+        shard_prefixes.push_back(
+            strings::StrCat(prefix_string, "_part-", i, "-of-", num_shards));
+      }
+      std::vector<Status> statuses(num_shards);
+      {
+        thread::ThreadPool pool(Env::Default(), "save_tensors", num_shards);
+        for (int i = 0; i < num_shards; ++i) {
+          pool.Schedule([&, i]() {
+            statuses[i] = SaveTensors(context, shard_prefixes[i], shards[i]);
+          });
         }
       }
-
-      VLOG(2) << "Done save of " << tensor_name;
+      for (const Status& status : statuses) {
+        OP_REQUIRES_OK(context, status);
+      }
+      OP_REQUIRES_OK(context, MergeBundles(Env::Default(), shard_prefixes,
+                                           prefix_string));
     }
-    OP_REQUIRES_OK(context, writer.Finish());
-    VLOG(1) << "Done BundleWriter, prefix_string: " << prefix_string;
 
     ResourceMgr* resource_manager = context->resource_manager();
     if (resource_manager != nullptr) {
@@ -224,6 +224,19 @@ __global__ void UnsortedSegmentCustomKernel(
   }
 }
 
+// Maps the segment IDs outside of [0, nsegments) to nsegments, so that they
+// can be sorted on the bits of nsegments only and are still ignored by the
+// segmented reduction.
+template <typename Index>
+__global__ void ClipSegmentIdsKernel(const int64_t size, const Index nsegments,
+                                     const Index* __restrict__ segment_ids,
+                                     Index* __restrict__ clipped_segment_ids) {
+  GPU_1D_KERNEL_LOOP(i, size) {
+    const Index id = ldg(segment_ids + i);
+    clipped_segment_ids[i] = (id < 0 || id >= nsegments) ? nsegments : id;
+  }
+}
+
 template <typename Tindex, typename Tsegmentids>
 __global__ void SegmentOffsetsKernel(
     Tindex size, Tsegmentids nsegments,
@@ -824,6 +837,20 @@ void SegmentReductionFunctor<
   }
 }
 
+// Returns true if sorting the segment IDs and reducing the contiguous
+// segments is expected to be faster than updating the output with atomics.
+// That is the case when many narrow rows are reduced into few segments, the
+// atomic updates of the same output elements being serialized.
+template <typename Index>
+bool UnsortedSegmentReductionPrefersSort(Index nouter, Index ninner,
+                                         Index nsegments) {
+  constexpr int64_t kMinOuterDimSize = 1 << 14;
+  constexpr int64_t kMaxInnerDimSize = 64;
+  constexpr int64_t kMinRowsPerSegment = 32;
+  return nouter >= kMinOuterDimSize && ninner <= kMaxInnerDimSize &&
+         nouter >= kMinRowsPerSegment * static_cast<int64_t>(nsegments);
+}
+
 template <typename T, typename Index, typename InitialValueF,
           typename ReductionF>
 struct UnsortedSegmentFunctor<GPUDevice, T, Index, InitialValueF, ReductionF> {
@@ -861,12 +888,19 @@ struct UnsortedSegmentFunctor<GPUDevice, T, Index, InitialValueF, ReductionF> {
     const Index output_outer_dim_size = output.dimension(0);
     const Index num_segments = output.size() / input_inner_dim_size;
 
+    // The deterministic kernels, which don't use atomics, are also used when
+    // the atomics would contend heavily.
+    const bool use_sorted_kernels =
+        use_deterministic_kernels ||
+        UnsortedSegmentReductionPrefersSort(
+            input_outer_dim_size, input_inner_dim_size, num_segments);
+
     // TODO(benbarsdell): If there are no performance concerns with the new
     // deterministic kernels, remove this runtime check and the old
     // non-deterministic kernels.
-    if (!use_deterministic_kernels) {
+    GPUDevice d = ctx->template eigen_device<GPUDevice>();
+    if (!use_sorted_kernels) {
       // Set 'output' to initial value.
-      GPUDevice d = ctx->template eigen_device<GPUDevice>();
       GpuLaunchConfig config = GetGpuLaunchConfig(output.size(), d);
       TF_CHECK_OK(GpuLaunchKernel(
           SetToValue<T>, config.block_count, config.thread_per_block, 0,
@@ -884,7 +918,24 @@ struct UnsortedSegmentFunctor<GPUDevice, T, Index, InitialValueF, ReductionF> {
           unsorted_segment_ids.data(), data.data(), output.data()));
     } else {
       // Allocate temporary space and sort segment_ids, then call the sorted
-      // implem.
+      // implem. The out-of-range (e.g., negative) IDs are first clipped to
+      // num_segments so that only the bits of num_segments need to be sorted.
+      Tensor clipped_segment_ids;
+      OP_REQUIRES_OK(
+          ctx, ctx->allocate_temp(
+                   DataTypeToEnum<Index>::value,
+                   TensorShape({static_cast<int64_t>(input_outer_dim_size)}),
+                   &clipped_segment_ids));
+      Index* clipped_segment_ids_ptr = clipped_segment_ids.flat<Index>().data();
+      if (input_outer_dim_size > 0) {
+        GpuLaunchConfig config = GetGpuLaunchConfig(input_outer_dim_size, d);
+        OP_REQUIRES_OK(
+            ctx, GpuLaunchKernel(ClipSegmentIdsKernel<Index>,
+                                 config.block_count, config.thread_per_block,
+                                 0, d.stream(), input_outer_dim_size,
+                                 num_segments, unsorted_segment_ids.data(),
+                                 clipped_segment_ids_ptr));
+      }
       Tensor segment_ids;
       OP_REQUIRES_OK(
           ctx, ctx->allocate_temp(
@@ -899,14 +950,14 @@ struct UnsortedSegmentFunctor<GPUDevice, T, Index, InitialValueF, ReductionF> {
                    TensorShape({static_cast<int64_t>(input_outer_dim_size)}),
                    &sorted_indices));
       Index* sorted_indices_ptr = sorted_indices.flat<Index>().data();
-      // Note: We must sort using all bits here because unsorted_segment_ids
-      // may contain negative values.
       OP_REQUIRES_OK(
           ctx, GpuRadixSort(ctx, input_outer_dim_size,
-                            /*keys_in=*/unsorted_segment_ids.data(),
+                            /*keys_in=*/clipped_segment_ids_ptr,
                             /*keys_out=*/segment_ids_ptr,
                             /*indices_in=*/static_cast<const Index*>(nullptr),
-                            /*indices_out=*/sorted_indices_ptr));
+                            /*indices_out=*/sorted_indices_ptr,
+                            /*num_bits=*/Log2Ceiling64(
+                                static_cast<uint64_t>(num_segments) + 1)));
       using Treduce = typename ReduceType<ReductionF, T>::type;
       OP_REQUIRES_OK(
           ctx,
@@ -527,7 +527,14 @@ class SparseSegmentReductionOpBase : public OpKernel {
         default_value_(default_value) {}
 
   void Compute(OpKernelContext* context) override {
-    const Tensor& input = context->input(0);
+    ComputeWithInput(context, context->input(0));
+  }
+
+ protected:
+  // Reduces the rows of `input` selected by the indices and segment ids in
+  // inputs 1 and 2. Ops that read the data from elsewhere than input 0 call
+  // this directly.
+  void ComputeWithInput(OpKernelContext* context, const Tensor& input) {
     const Tensor& indices = context->input(1);
     const Tensor& segment_ids = context->input(2);
 
@@ -870,7 +877,15 @@ class SparseSegmentReductionOpBase<GPUDevice, T, Index, SegmentId>
         default_value_(default_value) {}
 
   void ComputeAsync(OpKernelContext* context, DoneCallback done) override {
-    const Tensor& input = context->input(0);
+    ComputeAsyncWithInput(context, context->input(0), std::move(done));
+  }
+
+ protected:
+  // Reduces the rows of `input` selected by the indices and segment ids in
+  // inputs 1 and 2. Ops that read the data from elsewhere than input 0 call
+  // this directly.
+  void ComputeAsyncWithInput(OpKernelContext* context, const Tensor& input,
+                             DoneCallback done) {
     const Tensor& indices = context->input(1);
     const Tensor& segment_ids = context->input(2);
 
@@ -0,0 +1,136 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// See docs in ../ops/resource_variable_ops.cc.
+#include "tensorflow/core/kernels/segment_reduction_ops_impl.h"
+
+#include "tensorflow/core/framework/resource_mgr.h"
+#include "tensorflow/core/framework/resource_var.h"
+#include "tensorflow/core/kernels/training_op_helpers.h"
+
+namespace tensorflow {
+
+namespace {
+
+bool CombinerIs(OpKernelConstruction* context, const char* combiner) {
+  string attr;
+  return context->GetAttr("combiner", &attr).ok() && attr == combiner;
+}
+
+}  // namespace
+
+// Reduces by segment the rows of a resource variable that are selected by
+// indices, without gathering them into a temporary tensor first. This is the
+// fusion of ResourceGather with SparseSegment{Sum,Mean,SqrtN} created by the
+// remapper.
+template <typename Device, class T, typename Index, typename SegmentId>
+class ResourceSparseSegmentReductionOp
+    : public SparseSegmentReductionOpBase<Device, T, Index, SegmentId> {
+ public:
+  explicit ResourceSparseSegmentReductionOp(OpKernelConstruction* context)
+      : SparseSegmentReductionOpBase<Device, T, Index, SegmentId>(
+            context, CombinerIs(context, "mean"), CombinerIs(context, "sqrtn"),
+            false /* has_num_segments */, T(0) /* default_value */) {}
+
+  void Compute(OpKernelContext* context) override {
+    core::RefCountPtr<Var> v;
+    OP_REQUIRES_OK(context,
+                   LookupResource(context, HandleFromInput(context, 0), &v));
+    OP_REQUIRES_OK(context,
+                   EnsureSparseVariableAccess<Device, T>(context, v.get()));
+    // As in ResourceGather, hold the lock for the whole reduction instead of
+    // increasing the reference count of v->tensor(), so that writes to the
+    // variable do not copy it.
+    tf_shared_lock ml(*v->mu());
+    this->ComputeWithInput(context, *v->tensor());
+  }
+};
+
+#define REGISTER_CPU_SPARSE_KERNELS(type, index_type, segment_ids_type)      \
+  REGISTER_KERNEL_BUILDER(                                                   \
+      Name("_ResourceSparseSegmentReduction")                                \
+          .Device(DEVICE_CPU)                                                \
+          .TypeConstraint<type>("dtype")                                     \
+          .TypeConstraint<index_type>("Tidx")                                \
+          .TypeConstraint<segment_ids_type>("Tsegmentids"),                  \
+      ResourceSparseSegmentReductionOp<CPUDevice, type, index_type,          \
+                                       segment_ids_type>);
+#define REGISTER_CPU_SPARSE_KERNELS_FOR_EACH_SEGMENT_ID_TYPE(type, index_type) \
+  REGISTER_CPU_SPARSE_KERNELS(type, index_type, int32)                         \
+  REGISTER_CPU_SPARSE_KERNELS(type, index_type, int64_t)
+#define REGISTER_CPU_SPARSE_KERNELS_FOR_EACH_INDEX_TYPE(type)       \
+  REGISTER_CPU_SPARSE_KERNELS_FOR_EACH_SEGMENT_ID_TYPE(type, int32) \
+  REGISTER_CPU_SPARSE_KERNELS_FOR_EACH_SEGMENT_ID_TYPE(type, int64_t)
+TF_CALL_FLOAT_TYPES(REGISTER_CPU_SPARSE_KERNELS_FOR_EACH_INDEX_TYPE);
+#undef REGISTER_CPU_SPARSE_KERNELS_FOR_EACH_INDEX_TYPE
+#undef REGISTER_CPU_SPARSE_KERNELS_FOR_EACH_SEGMENT_ID_TYPE
+#undef REGISTER_CPU_SPARSE_KERNELS
+
+#if GOOGLE_CUDA
+
+// The GPU reduction is asynchronous, so the lock cannot be held until it
+// completes. Instead the kernel keeps a reference to the variable's buffer,
+// which is only copied if it is assigned to before the reduction is launched.
+template <class T, typename Index, typename SegmentId>
+class ResourceSparseSegmentReductionOp<GPUDevice, T, Index, SegmentId>
+    : public SparseSegmentReductionOpBase<GPUDevice, T, Index, SegmentId> {
+ public:
+  explicit ResourceSparseSegmentReductionOp(OpKernelConstruction* context)
+      : SparseSegmentReductionOpBase<GPUDevice, T, Index, SegmentId>(
+            context, CombinerIs(context, "mean"), CombinerIs(context, "sqrtn"),
+            false /* has_num_segments */, T(0) /* default_value */) {}
+
+  void ComputeAsync(OpKernelContext* context,
+                    AsyncOpKernel::DoneCallback done) override {
+    core::RefCountPtr<Var> v;
+    OP_REQUIRES_OK_ASYNC(
+        context, LookupResource(context, HandleFromInput(context, 0), &v),
+        done);
+    OP_REQUIRES_OK_ASYNC(
+        context, EnsureSparseVariableAccess<GPUDevice, T>(context, v.get()),
+        done);
+    Tensor params;
+    {
+      tf_shared_lock ml(*v->mu());
+      params = *v->tensor();
+    }
+    this->ComputeAsyncWithInput(context, params, std::move(done));
+  }
+};
+
+#define REGISTER_GPU_SPARSE_KERNELS(type, index_type, segment_ids_type)      \
+  REGISTER_KERNEL_BUILDER(                                                   \
+      Name("_ResourceSparseSegmentReduction")                                \
+          .Device(DEVICE_GPU)                                                \
+          .HostMemory("resource")                                            \
+          .TypeConstraint<type>("dtype")                                     \
+          .TypeConstraint<index_type>("Tidx")                                \
+          .TypeConstraint<segment_ids_type>("Tsegmentids"),                  \
+      ResourceSparseSegmentReductionOp<GPUDevice, type, index_type,          \
+                                       segment_ids_type>);
+#define REGISTER_GPU_SPARSE_KERNELS_FOR_EACH_SEGMENT_ID_TYPE(type, index_type) \
+  REGISTER_GPU_SPARSE_KERNELS(type, index_type, int32)                         \
+  REGISTER_GPU_SPARSE_KERNELS(type, index_type, int64_t)
+#define REGISTER_GPU_SPARSE_KERNELS_FOR_EACH_INDEX_TYPE(type)       \
+  REGISTER_GPU_SPARSE_KERNELS_FOR_EACH_SEGMENT_ID_TYPE(type, int32) \
+  REGISTER_GPU_SPARSE_KERNELS_FOR_EACH_SEGMENT_ID_TYPE(type, int64_t)
+TF_CALL_GPU_NUMBER_TYPES(REGISTER_GPU_SPARSE_KERNELS_FOR_EACH_INDEX_TYPE);
+#undef REGISTER_GPU_SPARSE_KERNELS_FOR_EACH_INDEX_TYPE
+#undef REGISTER_GPU_SPARSE_KERNELS_FOR_EACH_SEGMENT_ID_TYPE
+#undef REGISTER_GPU_SPARSE_KERNELS
+
+#endif  // GOOGLE_CUDA
+
+}  // namespace tensorflow
@@ -23,6 +23,11 @@ limitations under the License.
 #include "tensorflow/core/util/determinism.h"
 #include "tensorflow/core/util/gpu_kernel_helper.h"
 
+#if TENSORFLOW_USE_ROCM
+#include "tensorflow/core/kernels/gpu_prim_helpers.h"
+#include "tensorflow/core/util/cuda_sparse.h"
+#endif  // TENSORFLOW_USE_ROCM
+
 namespace tensorflow {
 
 typedef Eigen::GpuDevice GPUDevice;
@@ -77,6 +82,155 @@ __global__ void SparseTensorDenseMatMulKernel(
   }
 }
 
+#if TENSORFLOW_USE_ROCM && TF_ROCM_VERSION >= 50000
+// The hipSPARSE data type of T, for the types that hipSPARSE SpMM supports.
+template <typename T>
+struct HipsparseDataType {
+  static constexpr bool kSupported = false;
+};
+
+#define DEFINE_HIPSPARSE_DATA_TYPE(T, dtype)                \
+  template <>                                               \
+  struct HipsparseDataType<T> {                             \
+    static constexpr bool kSupported = true;                \
+    static constexpr hipDataType type = dtype;              \
+  };
+
+DEFINE_HIPSPARSE_DATA_TYPE(float, HIP_R_32F);
+DEFINE_HIPSPARSE_DATA_TYPE(double, HIP_R_64F);
+DEFINE_HIPSPARSE_DATA_TYPE(complex64, HIP_C_32F);
+DEFINE_HIPSPARSE_DATA_TYPE(complex128, HIP_C_64F);
+
+#undef DEFINE_HIPSPARSE_DATA_TYPE
+
+// Counts the nonzeros in each row of op(A). The entries with an out of bounds
+// row are counted in row 0, where they are stored as zeros.
+template <typename Tindices, bool ADJ_A>
+__global__ void SparseTensorDenseMatMulCountRowsKernel(
+    int nnz, int m, const Tindices* __restrict__ a_indices,
+    int* __restrict__ row_counts) {
+  GPU_1D_KERNEL_LOOP(a_ix, nnz) {
+    int i = ldg(a_indices + 2 * a_ix + ((ADJ_A) ? 1 : 0));
+    if (!FastBoundsCheck(i, m)) i = 0;
+    GpuAtomicAdd(row_counts + i, 1);
+  }
+}
+
+// Scatters the nonzeros of op(A) into CSR form, using row_cursor (initialized
+// to the CSR row pointer) to find the position of each nonzero in its row.
+template <typename T, typename Tindices, bool ADJ_A>
+__global__ void SparseTensorDenseMatMulToCsrKernel(
+    int nnz, int m, int n, const Tindices* __restrict__ a_indices,
+    const T* __restrict__ a_values, int* __restrict__ row_cursor,
+    int* __restrict__ col_ind, T* __restrict__ values) {
+  GPU_1D_KERNEL_LOOP(a_ix, nnz) {
+    const int i = ldg(a_indices + 2 * a_ix + ((ADJ_A) ? 1 : 0));
+    const int k = ldg(a_indices + 2 * a_ix + ((ADJ_A) ? 0 : 1));
+    if (!FastBoundsCheck(i, m)) {
+      // Matches the atomic kernel, which ignores these entries.
+      const int pos = GpuAtomicAdd(row_cursor, 1);
+      col_ind[pos] = 0;
+      values[pos] = T(0);
+      continue;
+    }
+    const int pos = GpuAtomicAdd(row_cursor + i, 1);
+    if (!FastBoundsCheck(k, n)) {
+      // Makes the whole output row NaN, like the atomic kernel.
+      col_ind[pos] = 0;
+      values[pos] = OutOfBoundsValue<T>::value();
+      continue;
+    }
+    const T a_input = ldg(a_values + a_ix);
+    col_ind[pos] = k;
+    values[pos] = ADJ_A ? Eigen::numext::conj(a_input) : a_input;
+  }
+}
+
+// Computes out = op(A) * b with hipSPARSE SpMM, after converting op(A) from
+// COO to CSR. This avoids the atomics of SparseTensorDenseMatMulKernel, whose
+// cost grows with nnz * p regardless of the sparsity pattern.
+template <typename T, typename Tindices, bool ADJ_A>
+Status SparseTensorDenseMatMulHipsparse(
+    OpKernelContext* ctx, typename TTypes<T>::Matrix out,
+    typename TTypes<Tindices>::ConstMatrix a_indices,
+    typename TTypes<T>::ConstVec a_values, typename TTypes<T>::ConstMatrix b) {
+  const GPUDevice& d = ctx->eigen_device<GPUDevice>();
+  const int nnz = a_values.size();
+  // out = op(A) * B, op(A) is [m x n] and B is [n x p], out is [m x p]
+  const int m = out.dimension(0);
+  const int p = out.dimension(1);
+  const int n = b.dimension(0);
+
+  Tensor row_ptr_t;
+  TF_RETURN_IF_ERROR(
+      ctx->allocate_temp(DT_INT32, TensorShape({m + 1}), &row_ptr_t));
+  Tensor row_counts_t;
+  TF_RETURN_IF_ERROR(
+      ctx->allocate_temp(DT_INT32, TensorShape({m}), &row_counts_t));
+  Tensor col_ind_t;
+  TF_RETURN_IF_ERROR(
+      ctx->allocate_temp(DT_INT32, TensorShape({nnz}), &col_ind_t));
+  Tensor values_t;
+  TF_RETURN_IF_ERROR(ctx->allocate_temp(DataTypeToEnum<T>::value,
+                                        TensorShape({nnz}), &values_t));
+  int* row_ptr = row_ptr_t.flat<int>().data();
+  int* row_counts = row_counts_t.flat<int>().data();
+
+  d.memset(row_counts, 0, m * sizeof(int));
+  d.memset(row_ptr, 0, sizeof(int));
+  GpuLaunchConfig config = GetGpuLaunchConfig(nnz, d);
+  TF_CHECK_OK(GpuLaunchKernel(
+      SparseTensorDenseMatMulCountRowsKernel<Tindices, ADJ_A>,
+      config.block_count, config.thread_per_block, 0, d.stream(), nnz, m,
+      a_indices.data(), row_counts));
+  TF_RETURN_IF_ERROR(
+      GpuInclusivePrefixSum(ctx, m, row_counts, row_ptr + 1));
+  // The counts are no longer needed, so they are reused as the row cursors.
+  d.memcpy(row_counts, row_ptr, m * sizeof(int));
+  TF_CHECK_OK(GpuLaunchKernel(
+      SparseTensorDenseMatMulToCsrKernel<T, Tindices, ADJ_A>,
+      config.block_count, config.thread_per_block, 0, d.stream(), nnz, m, n,
+      a_indices.data(), a_values.data(), row_counts,
+      col_ind_t.flat<int>().data(), values_t.flat<T>().data()));
+
+  GpuSparse gpu_sparse(ctx);
+  TF_RETURN_IF_ERROR(gpu_sparse.Initialize());
+
+  const T alpha = 1;
+  const T beta = 0;
+  constexpr hipDataType kDataType = HipsparseDataType<T>::type;
+  gpusparseSpMatDescr_t matA;
+  gpusparseDnMatDescr_t matB, matC;
+  TF_RETURN_IF_GPUSPARSE_ERROR(se::wrap::hipsparseCreateCsr(
+      &matA, m, n, nnz, row_ptr, col_ind_t.flat<int>().data(),
+      values_t.flat<T>().data(), HIPSPARSE_INDEX_32I, HIPSPARSE_INDEX_32I,
+      HIPSPARSE_INDEX_BASE_ZERO, kDataType));
+  // B and out are row major, which spares transposing them.
+  TF_RETURN_IF_GPUSPARSE_ERROR(se::wrap::hipsparseCreateDnMat(
+      &matB, n, p, p, const_cast<T*>(b.data()), kDataType,
+      HIPSPARSE_ORDER_ROW));
+  TF_RETURN_IF_GPUSPARSE_ERROR(se::wrap::hipsparseCreateDnMat(
+      &matC, m, p, p, out.data(), kDataType, HIPSPARSE_ORDER_ROW));
+
+  const gpusparseOperation_t trans = HIPSPARSE_OPERATION_NON_TRANSPOSE;
+  size_t buffer_size = 0;
+  TF_RETURN_IF_ERROR(gpu_sparse.SpMMBufferSize(
+      trans, trans, &alpha, matA, matB, &beta, matC, HIPSPARSE_MM_ALG_DEFAULT,
+      &buffer_size));
+  Tensor buffer;
+  TF_RETURN_IF_ERROR(ctx->allocate_temp(
+      DT_INT8, TensorShape({static_cast<int64_t>(buffer_size)}), &buffer));
+  TF_RETURN_IF_ERROR(gpu_sparse.SpMM(trans, trans, &alpha, matA, matB, &beta,
+                                     matC, HIPSPARSE_MM_ALG_DEFAULT,
+                                     buffer.flat<int8>().data()));
+
+  TF_RETURN_IF_GPUSPARSE_ERROR(se::wrap::hipsparseDestroyDnMat(matB));
+  TF_RETURN_IF_GPUSPARSE_ERROR(se::wrap::hipsparseDestroyDnMat(matC));
+  TF_RETURN_IF_GPUSPARSE_ERROR(se::wrap::hipsparseDestroySpMat(matA));
+  return OkStatus();
+}
+#endif  // TENSORFLOW_USE_ROCM && TF_ROCM_VERSION >= 50000
+
 namespace functor {
 
 template <typename T, typename Tindices, bool ADJ_A, bool ADJ_B>
@@ -93,6 +247,19 @@ struct SparseTensorDenseMatMulFunctor<GPUDevice, T, Tindices, ADJ_A, ADJ_B> {
     int b_rows = b.dimension(0);
     int b_cols = b.dimension(1);
 
+    if (OpDeterminismRequired()) {
+      return errors::Unimplemented(
+          "A deterministic GPU implementation of "
+          "SparseTensorDenseMatmulOp is not currently available.");
+    }
+
+#if TENSORFLOW_USE_ROCM && TF_ROCM_VERSION >= 50000
+    if constexpr (HipsparseDataType<T>::kSupported && !ADJ_B) {
+      return SparseTensorDenseMatMulHipsparse<T, Tindices, ADJ_A>(
+          ctx, out, a_indices, a_values, b);
+    }
+#endif
+
     const GPUDevice& d = ctx->eigen_device<GPUDevice>();
     using Tsum = typename SumType<T>::type;
     Tsum* maybe_temp_out_data = nullptr;
@@ -116,12 +283,6 @@ struct SparseTensorDenseMatMulFunctor<GPUDevice, T, Tindices, ADJ_A, ADJ_B> {
     // out.size()?  Perhaps p * nnz ?
     GpuLaunchConfig config = GetGpuLaunchConfig(p * nnz, d);
 
-    if (OpDeterminismRequired()) {
-      return errors::Unimplemented(
-          "A deterministic GPU implementation of "
-          "SparseTensorDenseMatmulOp is not currently available.");
-    }
-
     TF_CHECK_OK(GpuLaunchKernel(
         SparseTensorDenseMatMulKernel<T, Tsum, Tindices, ADJ_A, ADJ_B>,
         config.block_count, config.thread_per_block, 0, d.stream(), nnz, m,
@@ -161,8 +161,8 @@ struct SparseXentFunctor {
 };
 
 // Eigen code implementing SparseXentFunctor::operator().
-// This code works for both CPU and GPU and is used by the functor
-// specializations for both device types.
+// This code works for both CPU and GPU and is used by the CPU functor
+// specialization, the GPU one computing each row in a single kernel.
 template <typename Device, typename T, typename Index>
 struct SparseXentEigenImpl {
   static void Compute(OpKernelContext* ctx,
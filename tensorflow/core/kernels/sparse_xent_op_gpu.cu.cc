@@ -19,52 +19,118 @@ limitations under the License.
 
 #include "tensorflow/core/framework/tensor_types.h"
 #include "tensorflow/core/kernels/gpu_prim.h"
-#include "tensorflow/core/kernels/reduction_gpu_kernels.cu.h"
-#include "tensorflow/core/kernels/reduction_ops_common.h"
 #include "tensorflow/core/kernels/sparse_xent_op.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/gpu_kernel_helper.h"
 
 namespace tensorflow {
 
 typedef Eigen::GpuDevice GPUDevice;
 
-namespace functor {
+namespace {
+
+constexpr int kSparseXentThreadsPerBlock = 256;
+
+// The running maximum of the logits of a row and the sum of their exponentials
+// relative to that maximum, which are combined without a separate pass for
+// the maximum (the online log-sum-exp).
+struct MaxAndSumExp {
+  float max;
+  float sum;
+};
 
-// Partial specialization for a GPUDevice, that uses the CUB implementation
-// from reduction_gpu_kernels.cu.h.
-template <typename T>
-struct RowMaxReduction<GPUDevice, T> {
-  // Computes the maximum across the rows of logits
-  //
-  // logits: batch_size, num_classes.
-  // maximum: temporary tensor, dims: batch_size, 1
-  static inline void Compute(OpKernelContext* ctx,
-                             typename TTypes<T>::ConstMatrix logits,
-                             typename TTypes<T>::Vec maximum) {
-    const int kBatchDim = 0;
-    const int kClassDim = 1;
-    const int rows = logits.dimension(kBatchDim);
-    const int cols = logits.dimension(kClassDim);
-
-    typedef const Eigen::array<TTypes<float>::Tensor::Index, 1>& ReductionAxes;
-    Constants<GPUDevice> constants;
-    gpuprim::Max op;
-    functor::ReduceImpl<T, gpuprim::Max, T*, const T*, ReductionAxes>(
-        ctx, maximum.data(), logits.data(), 2, rows, cols, 1, 1, constants.kOne,
-        op);
+struct MaxAndSumExpOp {
+  __device__ MaxAndSumExp operator()(const MaxAndSumExp& a,
+                                     const MaxAndSumExp& b) const {
+    const float max = fmaxf(a.max, b.max);
+    // Both are empty, or only hold -inf logits.
+    if (max == -Eigen::NumTraits<float>::infinity()) return {max, 0.f};
+    return {max, a.sum * expf(a.max - max) + b.sum * expf(b.max - max)};
   }
 };
 
-// Partial specialization for a GPUDevice, that uses the Eigen implementation
-// from XentEigenImpl.
+// Computes the loss and the backprop of a row of logits per block, reading the
+// logits twice and writing the backprop once: the first pass reduces the
+// maximum and the sum of the exponentials together, and the second one writes
+// the probabilities minus the labels. backprop may alias logits. The
+// accumulation is done in float.
+template <typename T, typename Index>
+__global__ __launch_bounds__(kSparseXentThreadsPerBlock) void SparseXentKernel(
+    const T* logits, const Index* __restrict__ labels, int num_classes,
+    T* loss, T* backprop) {
+  typedef gpuprim::BlockReduce<MaxAndSumExp, kSparseXentThreadsPerBlock>
+      BlockReduce;
+  __shared__ typename BlockReduce::TempStorage temp_storage;
+  __shared__ MaxAndSumExp row_max_and_sum;
+
+  const int64_t row_offset = static_cast<int64_t>(blockIdx.x) * num_classes;
+  const T* row_logits = logits + row_offset;
+  T* row_backprop = backprop + row_offset;
+  const Index label = labels[blockIdx.x];
+  const bool valid_label = FastBoundsCheck(label, num_classes);
+  // Read before the backprop, which may alias the logits, is written.
+  const float label_logit =
+      valid_label ? static_cast<float>(row_logits[label]) : 0.f;
+
+  MaxAndSumExp thread_max_and_sum = {-Eigen::NumTraits<float>::infinity(),
+                                     0.f};
+  for (int i = threadIdx.x; i < num_classes; i += blockDim.x) {
+    const float logit = static_cast<float>(row_logits[i]);
+    if (logit > thread_max_and_sum.max) {
+      thread_max_and_sum.sum =
+          thread_max_and_sum.sum * expf(thread_max_and_sum.max - logit) + 1.f;
+      thread_max_and_sum.max = logit;
+    } else if (thread_max_and_sum.max !=
+               -Eigen::NumTraits<float>::infinity()) {
+      thread_max_and_sum.sum += expf(logit - thread_max_and_sum.max);
+    }
+  }
+  const MaxAndSumExp max_and_sum =
+      BlockReduce(temp_storage).Reduce(thread_max_and_sum, MaxAndSumExpOp());
+  if (threadIdx.x == 0) row_max_and_sum = max_and_sum;
+  __syncthreads();
+
+  const float max = row_max_and_sum.max;
+  const float sum = row_max_and_sum.sum;
+  if (!valid_label) {
+    for (int i = threadIdx.x; i < num_classes; i += blockDim.x) {
+      row_backprop[i] = Eigen::NumTraits<T>::quiet_NaN();
+    }
+    if (threadIdx.x == 0) loss[blockIdx.x] = Eigen::NumTraits<T>::quiet_NaN();
+    return;
+  }
+  const float inv_sum = 1.f / sum;
+  for (int i = threadIdx.x; i < num_classes; i += blockDim.x) {
+    const float logit = static_cast<float>(row_logits[i]);
+    const float prob = expf(logit - max) * inv_sum;
+    row_backprop[i] = static_cast<T>(i == label ? prob - 1.f : prob);
+  }
+  if (threadIdx.x == 0) {
+    loss[blockIdx.x] = static_cast<T>(logf(sum) - (label_logit - max));
+  }
+}
+
+}  // namespace
+
+namespace functor {
+
+// Partial specialization for a GPUDevice, that computes each row in a single
+// kernel instead of the several passes over the classes of XentEigenImpl.
 template <typename T, typename Index>
 struct SparseXentFunctor<GPUDevice, T, Index> {
   void operator()(OpKernelContext* ctx, typename TTypes<T>::ConstMatrix logits,
                   typename TTypes<Index>::ConstVec labels,
                   typename TTypes<T>::Vec scratch, typename TTypes<T>::Vec loss,
                   typename TTypes<T>::Matrix backprop) {
-    SparseXentEigenImpl<GPUDevice, T, Index>::Compute(ctx, logits, labels,
-                                                      scratch, loss, backprop);
+    const int batch_size = logits.dimension(0);
+    const int num_classes = logits.dimension(1);
+    if (batch_size == 0) return;
+    const GPUDevice& d = ctx->eigen_device<GPUDevice>();
+    OP_REQUIRES_OK(
+        ctx, GpuLaunchKernel(SparseXentKernel<T, Index>, batch_size,
+                             kSparseXentThreadsPerBlock, 0, d.stream(),
+                             logits.data(), labels.data(), num_classes,
+                             loss.data(), backprop.data()));
   }
 };
 }  // end namespace functor
@@ -72,12 +138,9 @@ struct SparseXentFunctor<GPUDevice, T, Index> {
 // Instantiate the GPU implementation for float.
 #define REGISTER(Index)                                                      \
   template struct functor::SparseXentFunctor<GPUDevice, float, Index>;       \
-  template class generator::SparseXentGradGenerator<float, Index>;           \
   template struct functor::SparseXentFunctor<GPUDevice, Eigen::half, Index>; \
-  template class generator::SparseXentGradGenerator<Eigen::half, Index>;     \
   template struct functor::SparseXentFunctor<GPUDevice, Eigen::bfloat16,     \
-                                             Index>;                         \
-  template class generator::SparseXentGradGenerator<Eigen::bfloat16, Index>;
+                                             Index>;
 REGISTER(int32)
 REGISTER(int64)
 #undef REGISTER
@@ -70,6 +70,10 @@ BM_SparseXentDev(32, 100000, gpu, float, DT_FLOAT);
 BM_SparseXentDev(64, 10000, gpu, float, DT_FLOAT);
 BM_SparseXentDev(64, 30000, gpu, float, DT_FLOAT);
 BM_SparseXentDev(64, 100000, gpu, float, DT_FLOAT);
+
+using Eigen::half;
+BM_SparseXentDev(32, 250000, gpu, float, DT_FLOAT);
+BM_SparseXentDev(32, 250000, gpu, half, DT_HALF);
 #endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 
 // CPU
@@ -17,6 +17,8 @@ limitations under the License.
 #include "tensorflow/core/kernels/training_ops.h"
 
 #include <algorithm>  // NOLINT
+#include <numeric>
+#include <vector>
 
 #include "tensorflow/core/framework/bounds_check.h"
 #include "tensorflow/core/framework/op_kernel.h"
@@ -27,6 +29,10 @@ limitations under the License.
 #include "tensorflow/core/platform/bfloat16.h"
 #include "tensorflow/core/util/util.h"
 
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+#include "tensorflow/core/kernels/gpu_device_array.h"
+#endif
+
 namespace tensorflow {
 
 using CPUDevice = Eigen::ThreadPoolDevice;
@@ -3654,6 +3660,187 @@ REGISTER_KERNELS(GPU, complex128);
 #undef REGISTER_CPU_KERNELS
 #undef REGISTER_KERNELS
 
+// Applies Adam to each of the `vars`, with the scalar hyperparameters starting
+// at input `scalars_input`.
+template <typename T>
+Status ApplyAdamToTensors(OpKernelContext* ctx, const CPUDevice& d,
+                          std::vector<Tensor>& vars, std::vector<Tensor>& ms,
+                          std::vector<Tensor>& vs, const OpInputList& grads,
+                          int scalars_input, bool use_nesterov) {
+  for (size_t i = 0; i < vars.size(); ++i) {
+    functor::ApplyAdam<CPUDevice, T>()(
+        d, vars[i].flat<T>(), ms[i].flat<T>(), vs[i].flat<T>(),
+        ctx->input(scalars_input).scalar<T>(),
+        ctx->input(scalars_input + 1).scalar<T>(),
+        ctx->input(scalars_input + 2).scalar<T>(),
+        ctx->input(scalars_input + 3).scalar<T>(),
+        ctx->input(scalars_input + 4).scalar<T>(),
+        ctx->input(scalars_input + 5).scalar<T>(), grads[i].flat<T>(),
+        use_nesterov);
+  }
+  return OkStatus();
+}
+
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+// Forward declarations of the functor specializations for GPU.
+namespace functor {
+#define DECLARE_GPU_SPEC(T)                                               \
+  template <>                                                             \
+  void ApplyAdamMultiTensor<GPUDevice, T>::operator()(                    \
+      const GPUDevice& d,                                                 \
+      const GpuDeviceArrayStruct<MultiTensorAdamEntry<T>>& entries,       \
+      int64_t num_chunks, typename TTypes<T>::ConstScalar beta1_power,    \
+      typename TTypes<T>::ConstScalar beta2_power,                        \
+      typename TTypes<T>::ConstScalar lr,                                 \
+      typename TTypes<T>::ConstScalar beta1,                              \
+      typename TTypes<T>::ConstScalar beta2,                              \
+      typename TTypes<T>::ConstScalar epsilon, bool use_nesterov);        \
+  extern template struct ApplyAdamMultiTensor<GPUDevice, T>;
+DECLARE_GPU_SPEC(Eigen::half);
+DECLARE_GPU_SPEC(float);
+DECLARE_GPU_SPEC(double);
+DECLARE_GPU_SPEC(complex64);
+DECLARE_GPU_SPEC(complex128);
+#undef DECLARE_GPU_SPEC
+}  // namespace functor
+
+// Same as above, updating all the tensors with a single kernel, from a table
+// of their chunks.
+template <typename T>
+Status ApplyAdamToTensors(OpKernelContext* ctx, const GPUDevice& d,
+                          std::vector<Tensor>& vars, std::vector<Tensor>& ms,
+                          std::vector<Tensor>& vs, const OpInputList& grads,
+                          int scalars_input, bool use_nesterov) {
+  int num_entries = 0;
+  for (const Tensor& var : vars) {
+    if (var.NumElements() > 0) ++num_entries;
+  }
+  GpuDeviceArrayOnHost<functor::MultiTensorAdamEntry<T>> entries(ctx,
+                                                                 num_entries);
+  TF_RETURN_IF_ERROR(entries.Init());
+  int64_t num_chunks = 0;
+  int entry = 0;
+  for (size_t i = 0; i < vars.size(); ++i) {
+    const int64_t size = vars[i].NumElements();
+    if (size == 0) continue;
+    entries.Set(entry++, {vars[i].flat<T>().data(), ms[i].flat<T>().data(),
+                          vs[i].flat<T>().data(), grads[i].flat<T>().data(),
+                          size, num_chunks});
+    num_chunks += Eigen::divup(size, functor::kMultiTensorChunkSize);
+  }
+  if (num_chunks > std::numeric_limits<int32>::max()) {
+    return errors::InvalidArgument("Too many elements to update: ",
+                                   num_chunks, " chunks of ",
+                                   functor::kMultiTensorChunkSize);
+  }
+  TF_RETURN_IF_ERROR(entries.Finalize());
+  functor::ApplyAdamMultiTensor<GPUDevice, T>()(
+      d, entries.data(), num_chunks, ctx->input(scalars_input).scalar<T>(),
+      ctx->input(scalars_input + 1).scalar<T>(),
+      ctx->input(scalars_input + 2).scalar<T>(),
+      ctx->input(scalars_input + 3).scalar<T>(),
+      ctx->input(scalars_input + 4).scalar<T>(),
+      ctx->input(scalars_input + 5).scalar<T>(), use_nesterov);
+  return OkStatus();
+}
+#endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+
+// Created by grappler from ResourceApplyAdam ops sharing their
+// hyperparameters, to update all their variables at once.
+template <typename Device, typename T>
+class ApplyAdamMultiTensorOp : public OpKernel {
+ public:
+  explicit ApplyAdamMultiTensorOp(OpKernelConstruction* ctx) : OpKernel(ctx) {
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("N", &num_tensors_));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("use_locking", &use_exclusive_lock_));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("use_nesterov", &use_nesterov_));
+  }
+
+  void Compute(OpKernelContext* ctx) override {
+    const bool sparse = false;
+    const int n = num_tensors_;
+    // The variables and their slots are the inputs [0, 3 * n).
+    std::vector<int> variable_inputs(3 * n);
+    std::iota(variable_inputs.begin(), variable_inputs.end(), 0);
+    auto locks = MaybeLockVariableInputMutexesInOrder<Device, T>(
+        ctx, use_exclusive_lock_, sparse, variable_inputs);
+
+    const int scalars_input = 3 * n;
+    static constexpr const char* kScalarNames[] = {
+        "beta1_power", "beta2_power", "lr", "beta1", "beta2", "epsilon"};
+    for (int i = 0; i < 6; ++i) {
+      const Tensor& scalar = ctx->input(scalars_input + i);
+      OP_REQUIRES(ctx, TensorShapeUtils::IsScalar(scalar.shape()),
+                  errors::InvalidArgument(kScalarNames[i], " is not a scalar: ",
+                                          scalar.shape().DebugString()));
+    }
+
+    OpInputList grads;
+    OP_REQUIRES_OK(ctx, ctx->input_list("grad", &grads));
+    std::vector<Tensor> vars(n), ms(n), vs(n);
+    for (int i = 0; i < n; ++i) {
+      Tensor* tensors[] = {&vars[i], &ms[i], &vs[i]};
+      for (int j = 0; j < 3; ++j) {
+        const int input = j * n + i;
+        OP_REQUIRES_OK(ctx,
+                       GetInputTensorFromVariable<Device, T>(
+                           ctx, input, use_exclusive_lock_, sparse, tensors[j]));
+        OP_REQUIRES(ctx, tensors[j]->IsInitialized(),
+                    errors::FailedPrecondition(
+                        "Attempting to use uninitialized variables: ",
+                        requested_input(input)));
+      }
+      OP_REQUIRES(
+          ctx, vars[i].shape().IsSameSize(ms[i].shape()),
+          errors::InvalidArgument("var and m do not have the same shape",
+                                  vars[i].shape().DebugString(), " ",
+                                  ms[i].shape().DebugString()));
+      OP_REQUIRES(
+          ctx, vars[i].shape().IsSameSize(vs[i].shape()),
+          errors::InvalidArgument("var and v do not have the same shape",
+                                  vars[i].shape().DebugString(), " ",
+                                  vs[i].shape().DebugString()));
+      OP_REQUIRES(
+          ctx, vars[i].shape().IsSameSize(grads[i].shape()),
+          errors::InvalidArgument("var and grad do not have the same shape",
+                                  vars[i].shape().DebugString(), " ",
+                                  grads[i].shape().DebugString()));
+    }
+
+    OP_REQUIRES_OK(ctx, ApplyAdamToTensors<T>(
+                            ctx, ctx->template eigen_device<Device>(), vars,
+                            ms, vs, grads, scalars_input, use_nesterov_));
+  }
+
+ private:
+  int num_tensors_;
+  bool use_exclusive_lock_;
+  bool use_nesterov_;
+};
+
+#define REGISTER_KERNELS(D, T)                                 \
+  REGISTER_KERNEL_BUILDER(Name("_ResourceApplyAdamMultiTensor") \
+                              .HostMemory("var")               \
+                              .HostMemory("m")                 \
+                              .HostMemory("v")                 \
+                              .Device(DEVICE_##D)              \
+                              .TypeConstraint<T>("T"),         \
+                          ApplyAdamMultiTensorOp<D##Device, T>);
+#define REGISTER_CPU_KERNELS(T) REGISTER_KERNELS(CPU, T);
+
+TF_CALL_FLOAT_TYPES(REGISTER_CPU_KERNELS);
+TF_CALL_COMPLEX_TYPES(REGISTER_CPU_KERNELS);
+
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+REGISTER_KERNELS(GPU, Eigen::half);
+REGISTER_KERNELS(GPU, float);
+REGISTER_KERNELS(GPU, double);
+REGISTER_KERNELS(GPU, complex64);
+REGISTER_KERNELS(GPU, complex128);
+#endif
+#undef REGISTER_CPU_KERNELS
+#undef REGISTER_KERNELS
+
 template <typename Device, typename T>
 class ApplyAdamWithAmsgradOp : public OpKernel {
  public:
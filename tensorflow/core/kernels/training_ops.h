@@ -21,6 +21,10 @@ limitations under the License.
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/platform/types.h"
 
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+#include "tensorflow/core/kernels/gpu_device_array_gpu.h"
+#endif
+
 namespace tensorflow {
 namespace functor {
 
@@ -245,6 +249,40 @@ struct ApplyAdam {
                   typename TTypes<T>::ConstFlat grad, bool use_nesterov);
 };
 
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+// The number of elements of a tensor updated by a block of the multi-tensor
+// apply kernels.
+constexpr int64_t kMultiTensorChunkSize = 1 << 15;
+
+// A tensor updated by ApplyAdamMultiTensor, whose chunks of
+// kMultiTensorChunkSize elements start at `first_chunk`, counted over all the
+// tensors.
+template <typename T>
+struct MultiTensorAdamEntry {
+  T* var;
+  T* m;
+  T* v;
+  const T* grad;
+  int64_t size;
+  int64_t first_chunk;
+};
+
+// Same as ApplyAdam, for several tensors at once: each of the `num_chunks`
+// chunks of the tensors is updated by a block of a single kernel.
+template <typename Device, typename T>
+struct ApplyAdamMultiTensor {
+  void operator()(
+      const Device& d,
+      const GpuDeviceArrayStruct<MultiTensorAdamEntry<T>>& entries,
+      int64_t num_chunks, typename TTypes<T>::ConstScalar beta1_power,
+      typename TTypes<T>::ConstScalar beta2_power,
+      typename TTypes<T>::ConstScalar lr,
+      typename TTypes<T>::ConstScalar beta1,
+      typename TTypes<T>::ConstScalar beta2,
+      typename TTypes<T>::ConstScalar epsilon, bool use_nesterov);
+};
+#endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+
 template <typename Device, typename T>
 struct ApplyAdamWithAmsgrad {
   void operator()(const Device& d, typename TTypes<T>::Flat var,
@@ -177,6 +177,29 @@ __global__ void SparseApplyFtrlKernel(T* var, T* accum, T* linear, const T* lr,
   }
 }
 
+// Updates the i-th element of var, m and v, as in ApplyAdam.
+template <typename T>
+__device__ __forceinline__ void ApplyAdamElement(
+    int64_t i, T* var, T* m, T* v, const T* grad, T mul_factor, T epsilon,
+    T beta1, T one_minus_beta1, T one_minus_beta2, bool use_nesterov) {
+  auto m_i = m[i];
+  auto g_i = grad[i];
+  auto v_i = v[i];
+
+  // Avoid += and -= due to std::complex<T> issues on device for MSVC.
+  m_i = m_i + one_minus_beta1 * (g_i - m_i);
+  v_i = v_i + one_minus_beta2 * (g_i * g_i - v_i);
+  if (use_nesterov) {
+    var[i] = var[i] - mul_factor * (m_i * beta1 + one_minus_beta1 * g_i) /
+                          (epsilon + Eigen::numext::sqrt(v_i));
+  } else {
+    var[i] = var[i] - mul_factor * m_i / (epsilon + Eigen::numext::sqrt(v_i));
+  }
+
+  m[i] = m_i;
+  v[i] = v_i;
+}
+
 template <typename T>
 __global__ __launch_bounds__(1024) void ApplyAdamKernel(
     int32 data_dim, T* var, T* m, T* v, const T* const beta1_power_,
@@ -199,22 +222,50 @@ __global__ __launch_bounds__(1024) void ApplyAdamKernel(
 
   for (int32 i = blockIdx.x * blockDim.x + threadIdx.x; i < data_dim;
        i += stripe) {
-    auto m_i = m[i];
-    auto g_i = grad[i];
-    auto v_i = v[i];
+    ApplyAdamElement(i, var, m, v, grad, mul_factor, epsilon, beta1,
+                     one_minus_beta1, one_minus_beta2, use_nesterov);
+  }
+}
 
-    // Avoid += and -= due to std::complex<T> issues on device for MSVC.
-    m_i = m_i + one_minus_beta1 * (g_i - m_i);
-    v_i = v_i + one_minus_beta2 * (g_i * g_i - v_i);
-    if (use_nesterov) {
-      var[i] = var[i] - mul_factor * (m_i * beta1 + one_minus_beta1 * g_i) /
-                            (epsilon + Eigen::numext::sqrt(v_i));
+// Each block updates a chunk of kMultiTensorChunkSize elements of one of the
+// tensors.
+template <typename T>
+__global__ __launch_bounds__(1024) void ApplyAdamMultiTensorKernel(
+    GpuDeviceArrayStruct<MultiTensorAdamEntry<T>> entries_array,
+    const T* const beta1_power_, const T* const beta2_power_,
+    const T* const lr_, const T* const beta1_, const T* const beta2_,
+    const T* const epsilon_, bool use_nesterov) {
+  const MultiTensorAdamEntry<T>* entries =
+      GetGpuDeviceArrayOnDevice(&entries_array);
+  const int64_t chunk = blockIdx.x;
+  // Finds the last tensor whose first chunk is not after this chunk.
+  int lo = 0;
+  int hi = entries_array.size - 1;
+  while (lo < hi) {
+    const int mid = (lo + hi + 1) / 2;
+    if (entries[mid].first_chunk <= chunk) {
+      lo = mid;
     } else {
-      var[i] = var[i] - mul_factor * m_i / (epsilon + Eigen::numext::sqrt(v_i));
+      hi = mid - 1;
     }
+  }
+  const MultiTensorAdamEntry<T> entry = entries[lo];
+
+  const T mul_factor =
+      (*lr_) * Eigen::numext::sqrt(static_cast<T>(1.0) - (*beta2_power_)) /
+      (static_cast<T>(1.0) - (*beta1_power_));
+  const T epsilon = (*epsilon_);
+  const T beta1 = (*beta1_);
+  const T one_minus_beta1 = static_cast<T>(1.0) - (beta1);
+  const T one_minus_beta2 = static_cast<T>(1.0) - (*beta2_);
 
-    m[i] = m_i;
-    v[i] = v_i;
+  const int64_t begin = (chunk - entry.first_chunk) * kMultiTensorChunkSize;
+  const int64_t end = Eigen::numext::mini(entry.size,
+                                          begin + kMultiTensorChunkSize);
+  for (int64_t i = begin + threadIdx.x; i < end; i += blockDim.x) {
+    ApplyAdamElement(i, entry.var, entry.m, entry.v, entry.grad, mul_factor,
+                     epsilon, beta1, one_minus_beta1, one_minus_beta2,
+                     use_nesterov);
   }
 }
 
@@ -890,6 +941,30 @@ struct ApplyAdam<GPUDevice, T> {
   }
 };
 
+template <typename T>
+struct ApplyAdamMultiTensor<GPUDevice, T> {
+  void operator()(
+      const GPUDevice& d,
+      const GpuDeviceArrayStruct<MultiTensorAdamEntry<T>>& entries,
+      int64_t num_chunks, typename TTypes<T>::ConstScalar beta1_power,
+      typename TTypes<T>::ConstScalar beta2_power,
+      typename TTypes<T>::ConstScalar lr,
+      typename TTypes<T>::ConstScalar beta1,
+      typename TTypes<T>::ConstScalar beta2,
+      typename TTypes<T>::ConstScalar epsilon, bool use_nesterov) {
+    if (num_chunks == 0) {
+      return;
+    }  // No work load.
+    eigen_assert(num_chunks <= std::numeric_limits<int32>::max());
+    constexpr int kThreadsPerBlock = 512;
+    TF_CHECK_OK(GpuLaunchKernel(
+        ApplyAdamMultiTensorKernel<T>, static_cast<int>(num_chunks),
+        kThreadsPerBlock, 0, d.stream(), entries, beta1_power.data(),
+        beta2_power.data(), lr.data(), beta1.data(), beta2.data(),
+        epsilon.data(), use_nesterov));
+  }
+};
+
 template <typename T>
 struct ApplyAdamWithAmsgrad<GPUDevice, T> {
   void operator()(const GPUDevice& d, typename TTypes<T>::Flat var,
@@ -1199,6 +1274,12 @@ template struct functor::ApplyAdam<GPUDevice, double>;
 template struct functor::ApplyAdam<GPUDevice, complex64>;
 template struct functor::ApplyAdam<GPUDevice, complex128>;
 
+template struct functor::ApplyAdamMultiTensor<GPUDevice, Eigen::half>;
+template struct functor::ApplyAdamMultiTensor<GPUDevice, float>;
+template struct functor::ApplyAdamMultiTensor<GPUDevice, double>;
+template struct functor::ApplyAdamMultiTensor<GPUDevice, complex64>;
+template struct functor::ApplyAdamMultiTensor<GPUDevice, complex128>;
+
 template struct functor::ApplyAdamWithAmsgrad<GPUDevice, Eigen::half>;
 template struct functor::ApplyAdamWithAmsgrad<GPUDevice, float>;
 template struct functor::ApplyAdamWithAmsgrad<GPUDevice, double>;
@@ -170,6 +170,118 @@ Status LookupAndScatterUniqueIds(const GPUDevice& d, int64_t input_size,
                          sorted_input_unique_ids, inv_sorted_unique_perm, idx);
 }
 
+// The hash table based implementation is used for large enough inputs, for
+// which it replaces the two radix sorts with a single pass of insertions. The
+// keys of less than 4 bytes are still sorted since they take few radix sort
+// passes. The table has two slots per input element, which bounds its size.
+constexpr int64_t kHashTableMinInputSize = 1 << 14;
+constexpr int64_t kHashTableMaxInputSize = 1 << 27;
+
+template <typename T>
+bool UseHashTable(int64_t input_size) {
+  return sizeof(T) >= 4 && input_size >= kHashTableMinInputSize &&
+         input_size <= kHashTableMaxInputSize;
+}
+
+// Marks the empty slots of the hash table, which holds the index of an input
+// element in each of the other slots.
+constexpr int kEmptySlot = -1;
+
+template <typename TIndex>
+__device__ TIndex AtomicCasIndex(TIndex* ptr, TIndex compare, TIndex value) {
+  using U = detail::CudaSupportedType<TIndex>;
+  return static_cast<TIndex>(
+      atomicCAS(detail::ToCudaSupportedPtr(ptr),
+                static_cast<U>(compare), static_cast<U>(value)));
+}
+
+template <typename T>
+__device__ uint64 HashValue(T value) {
+  // -0.0 and 0.0 are equal, so they must have the same hash.
+  if (value == T(0)) value = T(0);
+  uint64 bits = 0;
+  memcpy(&bits, &value, sizeof(T));
+  // The finalizer of MurmurHash3.
+  bits ^= bits >> 33;
+  bits *= 0xff51afd7ed558ccdULL;
+  bits ^= bits >> 33;
+  bits *= 0xc4ceb9fe1a85ec53ULL;
+  bits ^= bits >> 33;
+  return bits;
+}
+
+// Inserts the input elements in the hash table with linear probing, storing
+// the slot of each element in input_slots, the index of the first occurrence
+// of each slot's value in table_first and, if table_count is not nullptr, the
+// number of occurrences of each slot's value in table_count.
+template <typename T, typename TIndex>
+__global__ void HashTableInsertKernel(
+    int64_t input_size, const T* __restrict__ input, int64_t capacity_mask,
+    TIndex* table, TIndex* table_first, TIndex* table_count,
+    TIndex* __restrict__ input_slots) {
+  GPU_1D_KERNEL_LOOP(i, input_size) {
+    const T value = input[i];
+    int64_t slot = HashValue(value) & capacity_mask;
+    while (true) {
+      // A slot is never emptied, so a stale read only falls back to the CAS.
+      TIndex entry = table[slot];
+      if (entry == kEmptySlot) {
+        entry = AtomicCasIndex(table + slot, TIndex(kEmptySlot), TIndex(i));
+        if (entry == kEmptySlot) break;
+      }
+      if (input[entry] == value) break;
+      slot = (slot + 1) & capacity_mask;
+    }
+    input_slots[i] = static_cast<TIndex>(slot);
+    if (i < table_first[slot]) GpuAtomicMin(table_first + slot, TIndex(i));
+    if (table_count) GpuAtomicAdd(table_count + slot, TIndex(1));
+  }
+}
+
+// Returns 1 iff the input element at index i is the first occurrence of its
+// value.
+template <typename TIndex>
+struct FirstOccurrenceIndicatorFunctor {
+  const TIndex* __restrict__ input_slots_;
+  const TIndex* __restrict__ table_first_;
+  FirstOccurrenceIndicatorFunctor(const TIndex* input_slots,
+                                  const TIndex* table_first)
+      : input_slots_(input_slots), table_first_(table_first) {}
+  __device__ TIndex operator()(const TIndex& i) const {
+    return table_first_[input_slots_[i]] == i;
+  }
+};
+
+// Writes the first occurrences to output in order of appearance, using their
+// inclusive prefix sum in first_occurrence_ids, and the unique ID of each
+// slot's value to table_unique_ids.
+template <typename T, typename TIndex>
+__global__ void HashTableGatherOutputsKernel(
+    int64_t input_size, const T* __restrict__ input,
+    const TIndex* __restrict__ input_slots,
+    const TIndex* __restrict__ table_first,
+    const TIndex* __restrict__ table_count,
+    const TIndex* __restrict__ first_occurrence_ids, T* __restrict__ output,
+    TIndex* __restrict__ count, TIndex* __restrict__ table_unique_ids) {
+  GPU_1D_KERNEL_LOOP(i, input_size) {
+    const TIndex slot = input_slots[i];
+    if (table_first[slot] != i) continue;
+    const TIndex unique_id = first_occurrence_ids[i] - 1;
+    output[unique_id] = input[i];
+    if (count) count[unique_id] = table_count[slot];
+    table_unique_ids[slot] = unique_id;
+  }
+}
+
+template <typename TIndex>
+__global__ void HashTableLookupUniqueIdsKernel(
+    int64_t input_size, const TIndex* __restrict__ input_slots,
+    const TIndex* __restrict__ table_unique_ids, TIndex* __restrict__ idx) {
+  GPU_1D_KERNEL_LOOP(i, input_size) {
+    idx[i] = table_unique_ids[input_slots[i]];
+  }
+}
+
 }  // namespace unique_op_gpu
 
 // This only supports Unique[WithCounts], not Unique[WithCounts]V2.
@@ -225,6 +337,11 @@ class UniqueOpGPU : public AsyncOpKernel {
       return;
     }
 
+    if (unique_op_gpu::UseHashTable<T>(input_size)) {
+      ComputeAsyncWithHashTable(context, input_size, has_count_output, done);
+      return;
+    }
+
     // The algorithm implemented here is as follows:
     // input = [3, 5, 3, 4, 1, 4, 9, 8, 6, 3, 5, 7, 8, 8, 4, 6, 4, 2, 5, 6]
     // 1) Sort the input to group equal values together in segments.
@@ -448,6 +565,181 @@ class UniqueOpGPU : public AsyncOpKernel {
       done();
     };
 
+    context->device()
+        ->tensorflow_accelerator_device_info()
+        ->event_mgr->ThenExecute(stream, async_finish_computation);
+  }
+
+ private:
+  // Computes the outputs with a hash table instead of sorting:
+  // 1) Insert the input elements in a hash table with linear probing, keeping
+  //    the slot of each element, and per slot the index of the first occurrence
+  //    of its value and, if required, its number of occurrences.
+  // 2) Use prefix sum over the first occurrence indicator to compute the
+  //    unique ID of each value in order of appearance.
+  // 3) Gather the first occurrences to produce output and counts, and scatter
+  //    the unique IDs to the slots of the table.
+  // 4) Look up the unique ID of the slot of each element to produce idx.
+  void ComputeAsyncWithHashTable(OpKernelContext* context, int64_t input_size,
+                                 bool has_count_output, DoneCallback done) {
+    using namespace unique_op_gpu;
+    se::Stream* stream = context->op_device_context()->stream();
+    const GPUDevice& d = context->eigen_gpu_device();
+    const T* input_ptr = context->input(0).flat<T>().data();
+    const int64_t capacity = int64_t{1} << Log2Ceiling64(2 * input_size);
+
+    Tensor table;
+    TIndex* table_ptr = nullptr;
+    AllocateTemp(context, capacity, &table, &table_ptr, done);
+    if (!context->status().ok()) return;
+
+    Tensor table_first;
+    TIndex* table_first_ptr = nullptr;
+    AllocateTemp(context, capacity, &table_first, &table_first_ptr, done);
+    if (!context->status().ok()) return;
+
+    Tensor table_count;
+    TIndex* table_count_ptr = nullptr;
+    if (has_count_output) {
+      AllocateTemp(context, capacity, &table_count, &table_count_ptr, done);
+      if (!context->status().ok()) return;
+    }
+
+    Tensor input_slots;
+    TIndex* input_slots_ptr = nullptr;
+    AllocateTemp(context, input_size, &input_slots, &input_slots_ptr, done);
+    if (!context->status().ok()) return;
+
+    GpuLaunchConfig config = GetGpuLaunchConfig(capacity, d);
+    OP_REQUIRES_OK_ASYNC(
+        context,
+        GpuLaunchKernel(SetToValue<TIndex>, config.block_count,
+                        config.thread_per_block, 0, d.stream(), capacity,
+                        table_ptr, TIndex(kEmptySlot)),
+        done);
+    OP_REQUIRES_OK_ASYNC(
+        context,
+        GpuLaunchKernel(SetToValue<TIndex>, config.block_count,
+                        config.thread_per_block, 0, d.stream(), capacity,
+                        table_first_ptr, static_cast<TIndex>(input_size)),
+        done);
+    if (has_count_output) {
+      OP_REQUIRES_OK_ASYNC(
+          context,
+          GpuLaunchKernel(SetZero<TIndex>, config.block_count,
+                          config.thread_per_block, 0, d.stream(), capacity,
+                          table_count_ptr),
+          done);
+    }
+
+    config = GetGpuLaunchConfig(input_size, d,
+                                &HashTableInsertKernel<T, TIndex>,
+                                /*dynamic_shared_memory_size=*/0,
+                                /*block_size_limit=*/0);
+    OP_REQUIRES_OK_ASYNC(
+        context,
+        GpuLaunchKernel(HashTableInsertKernel<T, TIndex>, config.block_count,
+                        config.thread_per_block, 0, d.stream(), input_size,
+                        input_ptr, capacity - 1, table_ptr, table_first_ptr,
+                        table_count_ptr, input_slots_ptr),
+        done);
+
+    gpuprim::CountingInputIterator<TIndex> counting_iter(0);
+    gpuprim::TransformInputIterator<TIndex,
+                                    FirstOccurrenceIndicatorFunctor<TIndex>,
+                                    gpuprim::CountingInputIterator<TIndex>>
+        first_occurrence_indicator_iter(counting_iter,
+                                        {input_slots_ptr, table_first_ptr});
+
+    Tensor first_occurrence_ids;
+    TIndex* first_occurrence_ids_ptr = nullptr;
+    AllocateTemp(context, input_size, &first_occurrence_ids,
+                 &first_occurrence_ids_ptr, done);
+    if (!context->status().ok()) return;
+
+    OP_REQUIRES_OK_ASYNC(
+        context,
+        GpuInclusivePrefixSum(context, input_size,
+                              first_occurrence_indicator_iter,
+                              first_occurrence_ids_ptr),
+        done);
+
+    // Copy the last element of first_occurrence_ids back to the host to
+    // obtain uniq_size.
+    ScratchSpace<TIndex> uniq_size_host(context, 1, /*on_host=*/true);
+    OP_REQUIRES_ASYNC(
+        context,
+        stream
+            ->ThenMemcpy(uniq_size_host.mutable_data(),
+                         se::DeviceMemoryBase(
+                             first_occurrence_ids_ptr + (input_size - 1),
+                             sizeof(*uniq_size_host.data())),
+                         sizeof(*uniq_size_host.data()))
+            .ok(),
+        errors::Internal("Failed to copy uniq_size to host"), done);
+
+    auto async_finish_computation = [context, input_size, input_ptr, table,
+                                     table_ptr, table_first, table_first_ptr,
+                                     table_count, table_count_ptr, input_slots,
+                                     input_slots_ptr, first_occurrence_ids,
+                                     first_occurrence_ids_ptr, uniq_size_host,
+                                     has_count_output, done]() -> void {
+      const GPUDevice& device = context->eigen_gpu_device();
+      int64 uniq_size = *uniq_size_host.data();
+#if GOOGLE_CUDA
+      se::cuda::ScopedActivateExecutorContext scoped_activation{
+#else
+      se::gpu::ScopedActivateExecutorContext scoped_activation{
+#endif
+          context->op_device_context()->stream()->parent()};
+
+      Tensor* output = nullptr;
+      OP_REQUIRES_OK_ASYNC(
+          context,
+          context->allocate_output(0, TensorShape({uniq_size}), &output), done);
+      TIndex* count_ptr = nullptr;
+      if (has_count_output) {
+        Tensor* count = nullptr;
+        OP_REQUIRES_OK_ASYNC(
+            context,
+            context->allocate_output(2, TensorShape({uniq_size}), &count),
+            done);
+        count_ptr = count->flat<TIndex>().data();
+      }
+      Tensor* idx = nullptr;
+      OP_REQUIRES_OK_ASYNC(
+          context, context->allocate_output(1, TensorShape({input_size}), &idx),
+          done);
+
+      // The unique IDs are scattered to the table, whose entries are no
+      // longer needed.
+      GpuLaunchConfig config = GetGpuLaunchConfig(
+          input_size, device, &HashTableGatherOutputsKernel<T, TIndex>,
+          /*dynamic_shared_memory_size=*/0, /*block_size_limit=*/0);
+      OP_REQUIRES_OK_ASYNC(
+          context,
+          GpuLaunchKernel(HashTableGatherOutputsKernel<T, TIndex>,
+                          config.block_count, config.thread_per_block, 0,
+                          device.stream(), input_size, input_ptr,
+                          input_slots_ptr, table_first_ptr, table_count_ptr,
+                          first_occurrence_ids_ptr, output->flat<T>().data(),
+                          count_ptr, table_ptr),
+          done);
+
+      config = GetGpuLaunchConfig(
+          input_size, device, &HashTableLookupUniqueIdsKernel<TIndex>,
+          /*dynamic_shared_memory_size=*/0, /*block_size_limit=*/0);
+      OP_REQUIRES_OK_ASYNC(
+          context,
+          GpuLaunchKernel(HashTableLookupUniqueIdsKernel<TIndex>,
+                          config.block_count, config.thread_per_block, 0,
+                          device.stream(), input_size, input_slots_ptr,
+                          table_ptr, idx->flat<TIndex>().data()),
+          done);
+
+      done();
+    };
+
     context->device()
         ->tensorflow_accelerator_device_info()
         ->event_mgr->ThenExecute(stream, async_finish_computation);
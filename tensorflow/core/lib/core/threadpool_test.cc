@@ -285,6 +285,33 @@ TEST(ThreadPool, ParallelFor) {
   }
 }
 
+TEST(ThreadPool, ParallelForNumaPartitioned) {
+  // The threads are only partitioned on hosts with several NUMA nodes, and
+  // the pool behaves as usual otherwise.
+  ThreadOptions thread_options;
+  thread_options.numa_partitioned = true;
+  int64_t kHugeCost = 1 << 30;
+  for (int num_threads = 1; num_threads < kNumThreads; num_threads++) {
+    fprintf(stderr, "Testing with %d threads\n", num_threads);
+    const int kWorkItems = 100;
+    std::atomic<bool> work[kWorkItems];
+    ThreadPool pool(Env::Default(), thread_options, "test", num_threads,
+                    /*low_latency_hint=*/true, /*allocator=*/nullptr);
+    for (int i = 0; i < kWorkItems; i++) {
+      work[i] = false;
+    }
+    pool.ParallelFor(kWorkItems, kHugeCost,
+                     [&work](int64_t begin, int64_t end) {
+                       for (int64_t i = begin; i < end; ++i) {
+                         ASSERT_FALSE(work[i].exchange(true));
+                       }
+                     });
+    for (int i = 0; i < kWorkItems; i++) {
+      ASSERT_TRUE(work[i]);
+    }
+  }
+}
+
 TEST(ThreadPool, ParallelForWithAdaptiveSchedulingStrategy) {
   Context outer_context(ContextKind::kThread);
   // Make ParallelFor use as many threads as possible.
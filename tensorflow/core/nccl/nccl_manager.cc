@@ -79,8 +79,13 @@ struct NcclManager::NcclStream : public core::RefCounted {
   // The stream on which to run the nccl collective.
   // This is a different stream than the tensorflow compute stream.
 #if TENSORFLOW_USE_ROCM
-  // On ROCm, we borrow the nccl stream from the device context.
+  // On ROCm, the first nccl stream of each device is borrowed from the device
+  // context, where it is created next to the compute stream. Further streams
+  // for the same device, used when a device has several ranks in one
+  // communicator, are owned by `owned_stream`, since RCCL deadlocks if two
+  // ranks of a communicator share a stream.
   se::Stream* stream = nullptr;
+  std::unique_ptr<se::Stream> owned_stream;
 #else
   std::unique_ptr<se::Stream> stream;
 #endif
@@ -121,9 +126,18 @@ struct NcclManager::Communicator {
 
 namespace {
 
+// RCCL, and NCCL starting with 2.10, support bfloat16.
+#if TENSORFLOW_USE_ROCM || NCCL_VERSION_CODE >= 21000
+#define TF_NCCL_HAS_BFLOAT16 1
+#endif
+
 static constexpr DataTypeSet kValidDataTypes =
     ToSet(DT_HALF) | ToSet(DT_FLOAT) | ToSet(DT_DOUBLE) | ToSet(DT_INT32) |
-    ToSet(DT_INT64);
+    ToSet(DT_INT64)
+#if TF_NCCL_HAS_BFLOAT16
+    | ToSet(DT_BFLOAT16)
+#endif
+    ;
 
 ncclDataType_t ToNcclType(DataType t) {
   switch (t) {
@@ -137,6 +151,10 @@ ncclDataType_t ToNcclType(DataType t) {
       return ncclInt;
     case DT_INT64:
       return ncclInt64;
+#if TF_NCCL_HAS_BFLOAT16
+    case DT_BFLOAT16:
+      return ncclBfloat16;
+#endif
     default:
       return ncclFloat;
   }
@@ -178,7 +196,9 @@ struct NcclManager::Collective : public core::RefCounted {
     // or to manage one non-singleton NcclManager instance.
     // For example, the nccl_manager_test will use both paradigms in the same
     // executable, but not running concurrently (which would hang otherwise).
-    if (NcclManager::instance_count > 1) {
+    // Single-node collectives use their own communicators and are not
+    // affected, so that e.g. several collective executors can coexist.
+    if (!single_node && NcclManager::instance_count > 1) {
       status = errors::Internal(
           "ROCm cannot use multi-node NCCL collectives on a single node");
     }
@@ -367,7 +387,14 @@ Status NcclManager::GetCommunicator(NcclManager::Collective* collective,
       nccl_stream = new NcclStream();
       nccl_stream->executor = executor;
 #if TENSORFLOW_USE_ROCM
-      nccl_stream->stream = collective->participants[i]->context->nccl_stream();
+      if (streams.empty()) {
+        nccl_stream->stream =
+            collective->participants[i]->context->nccl_stream();
+      } else {
+        nccl_stream->owned_stream.reset(new se::Stream(executor));
+        nccl_stream->owned_stream->Init();
+        nccl_stream->stream = nccl_stream->owned_stream.get();
+      }
 #else
       nccl_stream->stream.reset(new se::Stream(executor));
       nccl_stream->stream->Init();
@@ -1408,6 +1408,21 @@ REGISTER_OP("CheckNumericsV2")
     .SetIsStateful()
     .SetShapeFn(shape_inference::UnchangedShape);
 
+// --------------------------------------------------------------------------
+REGISTER_OP("CheckNumericsN")
+    .Input("tensors: N * T")
+    .Output("outputs: N * T")
+    .Attr("N: int >= 1")
+    .Attr("T: {bfloat16, half, float, double}")
+    .Attr("message: string")
+    .SetIsStateful()
+    .SetShapeFn([](shape_inference::InferenceContext* c) {
+      for (int i = 0; i < c->num_inputs(); ++i) {
+        c->set_output(i, c->input(i));
+      }
+      return OkStatus();
+    });
+
 // --------------------------------------------------------------------------
 REGISTER_OP("Reshape")
     .Input("tensor: T")
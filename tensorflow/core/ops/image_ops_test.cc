@@ -171,6 +171,32 @@ TEST(ImageOpsTest, DecodeAndCropJpeg_InvalidCropWindow) {
   INFER_OK(op, "[];[?]", "[?,?,?]");
 }
 
+TEST(ImageOpsTest, DecodeCropAndResizeJpeg_ShapeFn) {
+  const char* op_name = "DecodeCropAndResizeJpeg";
+  ShapeInferenceTestOp op(op_name);
+
+  // Check the number of inputs.
+  INFER_ERROR("Wrong number of inputs passed: 2 while 3 expected", op,
+              "[];[4]");
+
+  TF_ASSERT_OK(NodeDefBuilder("test", op_name)
+                   .Input({"img", 0, DT_STRING})
+                   .Input({"crop_window", 1, DT_INT32})
+                   .Input({"size", 2, DT_INT32})
+                   .Attr("channels", 3)
+                   .Finalize(&op.node_def));
+  INFER_OK(op, "[];[4];[2]", "[?,?,3]");
+  INFER_ERROR("Shape must be rank 0 but is rank 1", op, "[1];[4];[2]");
+  INFER_ERROR("Dimension must be 4 but is 3", op, "[];[3];[2]");
+  INFER_ERROR("Dimension must be 2 but is 3", op, "[];[4];[3]");
+
+  // The output height and width are known when `size` is a constant.
+  Tensor size = test::AsTensor<int32>({224, 160});
+  op.input_tensors.resize(3);
+  op.input_tensors[2] = &size;
+  INFER_OK(op, "[];[4];[2]", "[224,160,3]");
+}
+
 TEST(ImageOpsTest, EncodeImage_ShapeFn) {
   for (const char* op_name : {"EncodeJpeg"}) {
     ShapeInferenceTestOp op(op_name);
@@ -212,6 +212,21 @@ REGISTER_OP("LookupTableInsertV2")
       return OkStatus();
     });
 
+REGISTER_OP("_LookupTableScatterAdd")
+    .Input("table_handle: resource")
+    .Input("keys: Tin")
+    .Input("updates: Tout")
+    .Attr("Tin: type")
+    .Attr("Tout: type")
+    .SetShapeFn([](InferenceContext* c) {
+      ShapeHandle handle;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 0, &handle));
+      return OkStatus();
+    })
+    .Doc(R"doc(
+Adds updates to the values of keys in a table, missing keys starting at zero.
+)doc");
+
 REGISTER_OP("LookupTableRemoveV2")
     .Input("table_handle: resource")
     .Input("keys: Tin")
@@ -441,6 +456,34 @@ REGISTER_OP("AnonymousMutableHashTableOfTensors")
     .SetIsStateful()
     .SetShapeFn(MutableHashTableOfTensorsShapeFn);
 
+REGISTER_OP("_DynamicEmbeddingTable")
+    .Output("table_handle: resource")
+    .Attr("container: string = ''")
+    .Attr("shared_name: string = ''")
+    .Attr("use_node_name_sharing: bool = false")
+    .Attr("key_dtype: type")
+    .Attr("value_dtype: {float, double}")
+    .Attr("value_shape: shape")
+    .Attr("max_size: int = 0")
+    .SetIsStateful()
+    .SetShapeFn(MutableHashTableOfTensorsShapeFn)
+    .Doc(R"doc(
+Creates a table of embedding vectors whose keys are created on demand.
+
+LookupTableFindV2 inserts the missing keys with their default value, and
+_LookupTableScatterAdd adds updates to the values. If max_size is positive, the
+least recently used keys are evicted when the table grows past max_size.
+)doc");
+
+REGISTER_OP("_AnonymousDynamicEmbeddingTable")
+    .Output("table_handle: resource")
+    .Attr("key_dtype: type")
+    .Attr("value_dtype: {float, double}")
+    .Attr("value_shape: shape")
+    .Attr("max_size: int = 0")
+    .SetIsStateful()
+    .SetShapeFn(MutableHashTableOfTensorsShapeFn);
+
 REGISTER_OP("MutableDenseHashTable")
     .Input("empty_key: key_dtype")
     .Output("table_handle: Ref(string)")
@@ -1143,6 +1143,34 @@ _FusedConv2D output.
 expected to create these operators.
 )doc");
 
+REGISTER_OP("_FusedElementwise")
+    .Input("args: N * T")
+    .Output("y: T")
+    .Attr("T: {bfloat16, half, float, double}")
+    .Attr("N: int >= 1")
+    .Attr("fused_ops: list(string)")
+    .SetShapeFn([](InferenceContext* c) {
+      ShapeHandle out = c->input(0);
+      for (int i = 1; i < c->num_inputs(); ++i) {
+        TF_RETURN_IF_ERROR(c->Merge(out, c->input(i), &out));
+      }
+      c->set_output(0, out);
+      return OkStatus();
+    })
+    .Doc(R"doc(
+Performs a chain of elementwise ops in a single pass over the elements.
+
+The ops are specified by the `fused_ops` attribute, a list of TF op names in
+{"Add", "AddV2", "Sub", "Mul", "Maximum", "Minimum", "Neg", "Relu", "Relu6",
+"Sigmoid", "Square", "Tanh"}. They are performed in order on the first of the
+`args`, the output of each op being the (first) input of the next one. The
+binary ops take their second input from the following `args`, in order. All the
+`args` must have the same shape, as the ops don't broadcast.
+
+*NOTE*: Do not invoke this operator directly in Python. Grappler is
+expected to create these operators.
+)doc");
+
 // --------------------------------------------------------------------------
 
 // For operations where the output is a reduction function along some
@@ -389,6 +389,65 @@ REGISTER_OP("DropoutGrad")
     .Attr("T: {float, half, double}")
     .SetShapeFn(shape_inference::UnchangedShape);
 
+REGISTER_OP("_FusedBiasActivationDropout")
+    .Input("value: T")
+    .Input("bias: T")
+    .Input("rate: T")
+    .Input("seed1: Tseed")
+    .Input("seed2: Tseed")
+    .Output("output: T")
+    .Output("mask: uint8")
+    .Attr("T: {float, half, double}")
+    .Attr("Tseed: {int32, int64}")
+    .Attr("activation: {'Relu', 'Relu6'} = 'Relu'")
+    .SetShapeFn([](InferenceContext* c) {
+      TF_RETURN_IF_ERROR(shape_inference::BiasAddShape(c));
+      // The mask holds the bits of 8 elements per byte.
+      ShapeHandle output = c->output(0);
+      DimensionHandle num_bytes = c->UnknownDim();
+      if (c->FullyDefined(output)) {
+        num_bytes = c->MakeDim((c->Value(c->NumElements(output)) + 7) / 8);
+      }
+      c->set_output(1, c->Vector(num_bytes));
+      return OkStatus();
+    })
+    .Doc(R"doc(
+Computes `Dropout(activation(BiasAdd(value, bias)), rate)` in a single pass.
+
+The bias is added to the last dimension of `value`. The `mask` output holds the
+bits of the dropout mask, 8 elements per byte, to be passed to
+_FusedBiasActivationDropoutGrad. The seeds are used as in Dropout.
+
+*NOTE*: Do not invoke this operator directly in Python. Grappler is
+expected to create these operators.
+)doc");
+
+REGISTER_OP("_FusedBiasActivationDropoutGrad")
+    .Input("gradients: T")
+    .Input("output: T")
+    .Input("rate: T")
+    .Input("mask: uint8")
+    .Output("value_backprop: T")
+    .Output("bias_backprop: T")
+    .Attr("T: {float, half, double}")
+    .Attr("activation: {'Relu', 'Relu6'} = 'Relu'")
+    .SetShapeFn([](InferenceContext* c) {
+      ShapeHandle value_backprop;
+      TF_RETURN_IF_ERROR(c->Merge(c->input(0), c->input(1), &value_backprop));
+      TF_RETURN_IF_ERROR(
+          c->WithRankAtLeast(value_backprop, 2, &value_backprop));
+      c->set_output(0, value_backprop);
+      c->set_output(1, c->Vector(c->Dim(value_backprop, -1)));
+      return OkStatus();
+    })
+    .Doc(R"doc(
+Computes the gradients of _FusedBiasActivationDropout with respect to its value
+and its bias, from its `output` and `mask`.
+
+*NOTE*: Do not invoke this operator directly in Python. Grappler is
+expected to create these operators.
+)doc");
+
 // --------------------------------------------------------------------------
 
 REGISTER_OP("Conv2D")
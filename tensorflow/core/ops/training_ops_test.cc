@@ -13,8 +13,11 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
 #include "tensorflow/core/framework/op.h"
 #include "tensorflow/core/framework/shape_inference_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/platform/test.h"
 
 namespace tensorflow {
@@ -289,6 +292,29 @@ TEST(TrainingOpsTest, ApplyAdam_ShapeFn) {
   INFER_ERROR(err, op, "?;?;?;?;?;?;?;?;[?];?");
 }
 
+TEST(TrainingOpsTest, ResourceApplyAdamMultiTensor_ShapeFn) {
+  ShapeInferenceTestOp op("_ResourceApplyAdamMultiTensor");
+  TF_ASSERT_OK(NodeDefBuilder("test", "_ResourceApplyAdamMultiTensor")
+                   .Input(FakeInput(2, DT_RESOURCE))
+                   .Input(FakeInput(2, DT_RESOURCE))
+                   .Input(FakeInput(2, DT_RESOURCE))
+                   .Input(FakeInput(DT_FLOAT))
+                   .Input(FakeInput(DT_FLOAT))
+                   .Input(FakeInput(DT_FLOAT))
+                   .Input(FakeInput(DT_FLOAT))
+                   .Input(FakeInput(DT_FLOAT))
+                   .Input(FakeInput(DT_FLOAT))
+                   .Input(FakeInput(2, DT_FLOAT))
+                   .Finalize(&op.node_def));
+
+  INFER_OK(op, "[];[];[];[];[];[];[];[];[];[];[];[];[1];[2,3]", "");
+
+  // beta1_power, beta2_power, lr, beta1, beta2, and epsilon must be scalars.
+  const char err[] = "Shape must be rank 0 but is rank 1";
+  INFER_ERROR(err, op, "?;?;?;?;?;?;[?];?;?;?;?;?;?;?");
+  INFER_ERROR(err, op, "?;?;?;?;?;?;?;?;?;?;?;[?];?;?");
+}
+
 TEST(TrainingOpsTest, ApplyRMSProp_ShapeFn) {
   ShapeInferenceTestOp op("ApplyRMSProp");
 
@@ -36,6 +36,8 @@ limitations under the License.
 #include "tensorflow/core/profiler/protobuf/op_metrics.pb.h"
 #include "tensorflow/core/profiler/protobuf/xplane.pb.h"
 #include "tensorflow/core/profiler/utils/cost_utils.h"
+#include "tensorflow/core/profiler/utils/gpu_event_stats.h"
+#include "tensorflow/core/profiler/utils/hlo_module_map.h"
 #include "tensorflow/core/profiler/utils/op_metrics_db_utils.h"
 #include "tensorflow/core/profiler/utils/op_utils.h"
 #include "tensorflow/core/profiler/utils/tf_op_utils.h"
@@ -366,6 +368,11 @@ OpMetricsDb ConvertTpuDeviceTraceXPlaneToOpMetricsDb(
 }
 
 OpMetricsDb ConvertDeviceTraceXPlaneToOpMetricsDb(const XPlane& device_trace) {
+  return ConvertDeviceTraceXPlaneToOpMetricsDb(device_trace, HloModuleMap());
+}
+
+OpMetricsDb ConvertDeviceTraceXPlaneToOpMetricsDb(
+    const XPlane& device_trace, const HloModuleMap& hlo_module_map) {
   OpMetricsDb result;
   DeviceOpMetricsDbBuilder device_op_metrics_db_builder(&result);
 
@@ -380,21 +387,27 @@ OpMetricsDb ConvertDeviceTraceXPlaneToOpMetricsDb(const XPlane& device_trace) {
       first_op_offset_ps = std::min(first_op_offset_ps, event.OffsetPs());
       last_op_offset_ps = std::max(last_op_offset_ps, event.EndOffsetPs());
 
-      absl::string_view tf_op_full_name;
-      bool is_eager = false;
-      event.ForEachStat([&](const XStatVisitor& stat) {
-        if (stat.Type() == StatType::kTfOp) {
-          tf_op_full_name = stat.StrOrRefValue();
-        } else if (stat.Type() == StatType::kIsEager) {
-          is_eager = stat.IntValue();
-        }
-      });
+      GpuEventStats stats(&event);
+      // The costs of the XLA ops come from the cost analysis of their HLO,
+      // which also knows the TF op of the ops that have no TF op stat.
+      const HloInstructionWrapper* hlo_instruction =
+          stats.IsXlaOp() ? GetHloInstruction(hlo_module_map, stats.program_id,
+                                              stats.hlo_op_names.back())
+                          : nullptr;
+      absl::string_view tf_op_full_name = stats.tf_op_fullname;
+      if (tf_op_full_name.empty() && hlo_instruction != nullptr) {
+        tf_op_full_name = hlo_instruction->op_full_name();
+      }
       if (tf_op_full_name.empty()) return;
       TfOp tf_op = ParseTfOpFullname(tf_op_full_name);
       TfOpRoofLineCostEstimator::OpRoofLineStats costs;
-      if (tf_op.category != Category::kUnknown) {
+      if (hlo_instruction != nullptr) {
+        costs.flops = hlo_instruction->flops();
+        costs.bytes_accessed = hlo_instruction->bytes_accessed();
+      } else if (tf_op.category != Category::kUnknown) {
         costs = op_level_cost_estimator.Predict(event);
       }
+      const bool is_eager = stats.is_eager;
       device_op_metrics_db_builder.EnterOp(
           /*program_id=*/0, absl::StrCat(tf_op.name, "/", event.Name()),
           tf_op.type, tf_op_full_name, is_eager,
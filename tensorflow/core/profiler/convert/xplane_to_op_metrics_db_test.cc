@@ -20,10 +20,12 @@ limitations under the License.
 
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "tensorflow/compiler/xla/service/hlo_parser.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow/core/profiler/protobuf/op_metrics.pb.h"
 #include "tensorflow/core/profiler/protobuf/xplane.pb.h"
+#include "tensorflow/core/profiler/utils/hlo_module_map.h"
 #include "tensorflow/core/profiler/utils/math_utils.h"
 #include "tensorflow/core/profiler/utils/op_metrics_db_utils.h"
 #include "tensorflow/core/profiler/utils/xplane_builder.h"
@@ -209,6 +211,51 @@ TEST(ConvertXPlaneToOpMetricsDb, DeviceOpMetricsDb) {
   EXPECT_EQ(NanoToPico(0), idle.time_ps());
 }
 
+TEST(ConvertXPlaneToOpMetricsDb, GpuXlaOpMetricsDb) {
+  constexpr char kHloText[] = R"(
+HloModule test_module
+
+ENTRY main {
+  p0 = f32[32,32] parameter(0)
+  p1 = f32[32,32] parameter(1)
+  ROOT dot = f32[32,32] dot(p0, p1), lhs_contracting_dims={1},
+      rhs_contracting_dims={0},
+      metadata={op_type="MatMul" op_name="dense/MatMul"}
+})";
+  constexpr uint64_t kProgramId = 1;
+  auto hlo_module = xla::ParseAndReturnUnverifiedModule(kHloText);
+  ASSERT_TRUE(hlo_module.ok());
+  HloModuleMap hlo_module_map;
+  hlo_module_map.try_emplace(
+      kProgramId, HloModuleWrapper(std::move(hlo_module).value(),
+                                   /*shape_func=*/nullptr));
+
+  XSpace xspace;
+  XPlane* xplane = GetOrCreateGpuXPlane(&xspace, /*device_ordinal=*/0);
+  XPlaneBuilder device_plane(xplane);
+  XLineBuilder stream = device_plane.GetOrCreateLine(/*line_id=*/10);
+  // The kernel of the XLA op has no TF op stat.
+  CreateXEvent(&device_plane, &stream, "gemm_kernel", /*offset_ps=*/0,
+               /*duration_ps=*/1000,
+               {{StatType::kHloOp, "dot"},
+                {StatType::kHloModule, "test_module"},
+                {StatType::kProgramId, kProgramId}});
+
+  OpMetricsDb op_metrics =
+      ConvertDeviceTraceXPlaneToOpMetricsDb(*xplane, hlo_module_map);
+
+  // gemm_kernel, Idle.
+  ASSERT_EQ(2, op_metrics.metrics_db_size());
+  const OpMetrics& op = op_metrics.metrics_db().at(0);
+  EXPECT_EQ("dense/MatMul/gemm_kernel", op.name());
+  EXPECT_EQ("MatMul", op.category());
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+  // The cost analysis counts one multiply and one add per step of the dot.
+  EXPECT_EQ(2 * 32 * 32 * 32, op.flops());
+  EXPECT_GT(op.bytes_accessed(), 0);
+#endif
+}
+
 TEST(ConvertXPlaneToOpMetricsDb, TpuDeviceOpMetricsDb) {
   XSpace xspace;
   XPlane* xplane = GetOrCreateTpuXPlane(&xspace, /*device_ordinal=*/0, "TPU V4",
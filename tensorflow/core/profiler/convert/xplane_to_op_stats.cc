@@ -36,6 +36,8 @@ limitations under the License.
 #include "tensorflow/core/profiler/utils/device_caps_utils.h"
 #include "tensorflow/core/profiler/utils/event_span.h"
 #include "tensorflow/core/profiler/utils/hardware_type_utils.h"
+#include "tensorflow/core/profiler/utils/hlo_module_map.h"
+#include "tensorflow/core/profiler/utils/hlo_proto_map.h"
 #include "tensorflow/core/profiler/utils/kernel_stats_utils.h"
 #include "tensorflow/core/profiler/utils/math_utils.h"
 #include "tensorflow/core/profiler/utils/tf_xplane_visitor.h"
@@ -77,8 +79,16 @@ PerfEnv MakePerfEnv(double peak_tera_flops_per_second,
 PerfEnv GetPerfEnvFromXPlane(const XPlane& device_plane) {
   DeviceCapabilities cap = GetDeviceCaps(device_plane);
   if (!absl::StartsWith(device_plane.name(), kTpuPlanePrefix)) {
+    double peak_tera_flops_per_second =
+        GigaToTera(GetFlopMaxThroughputPerSM(cap)) * cap.num_cores();
+    // The collectors report the peak of the GPUs for which the compute
+    // capability is not enough, such as the matrix cores of AMD GPUs.
+    XPlaneVisitor visitor = CreateTfXPlaneVisitor(&device_plane);
+    if (auto peak = visitor.GetStat(StatType::kDevCapPeakTeraflopsPerSecond)) {
+      peak_tera_flops_per_second = peak->DoubleValue();
+    }
     return MakePerfEnv(
-        GigaToTera(GetFlopMaxThroughputPerSM(cap)) * cap.num_cores(),
+        peak_tera_flops_per_second,
         // Ideally, the cap should report separate hbm BW, for now set to same.
         {UniToGiga(cap.memory_bandwidth()), UniToGiga(cap.memory_bandwidth()),
          UniToGiga(cap.memory_bandwidth()), UniToGiga(cap.memory_bandwidth())});
@@ -181,6 +191,17 @@ OpStats ConvertXSpaceToOpStats(const XSpace& space,
 
   KernelReportMap reports;
 
+  // The cost analysis of the XLA modules gives the FLOPs and the bytes
+  // accessed of the XLA ops on GPUs.
+  HloModuleMap hlo_module_map;
+  if (is_gpu && options.generate_op_metrics_db) {
+    HloProtoMap hlo_proto_map;
+    hlo_proto_map.AddHloProtosFromXSpace(space);
+    for (const auto& [program_id, hlo_proto] : hlo_proto_map) {
+      AddHloProto(hlo_module_map, program_id, *hlo_proto);
+    }
+  }
+
   // TODO(b/161942993) parallelize XPlane processing per thread.
   for (const XPlane* device_trace : device_planes) {
     if (options.generate_op_metrics_db) {
@@ -189,7 +210,8 @@ OpStats ConvertXSpaceToOpStats(const XSpace& space,
       }
       if (is_gpu) {
         OpMetricsDb device_op_metrics_db =
-            ConvertDeviceTraceXPlaneToOpMetricsDb(*device_trace);
+            ConvertDeviceTraceXPlaneToOpMetricsDb(*device_trace,
+                                                  hlo_module_map);
         op_metrics_db_combiner.Combine(device_op_metrics_db);
       } else {
         XPlane aggregated_xplane;
@@ -21,7 +21,7 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
-#if GOOGLE_CUDA
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 #include "tensorflow/compiler/xla/service/gpu/gpu_hlo_cost_analysis.h"
 #endif
 #include "tensorflow/compiler/xla/hlo/ir/hlo_instruction.h"
@@ -34,7 +34,7 @@ namespace profiler {
 
 namespace {
 
-#if GOOGLE_CUDA
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 int64_t ShapeSize(const xla::Shape& shape) {
   constexpr int64_t kPointerSize = 8;
   return xla::ShapeUtil::ByteSizeOf(shape, kPointerSize);
@@ -66,7 +66,7 @@ HloModuleWrapper::HloModuleWrapper(
   if (module_ == nullptr) return;
 
   const xla::HloCostAnalysis* cost_analysis = nullptr;
-#if GOOGLE_CUDA
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
   if (shape_func == nullptr) shape_func = ShapeSize;
   xla::HloCostAnalysis::Options options;
   options.shape_size = shape_func;
@@ -55,6 +55,7 @@ class SummaryFileWriter : public SummaryWriterInterface {
     string sep = absl::StartsWith(filename_suffix, ".") ? "" : ".";
     const string uniquified_filename_suffix = absl::StrCat(
         ".", pid, ".", file_id_counter.fetch_add(1), sep, filename_suffix);
+    mutex_lock writer_lock(writer_mu_);
     mutex_lock ml(mu_);
     events_writer_ =
         std::make_unique<EventsWriter>(io::JoinPath(logdir, "events"));
@@ -63,18 +64,37 @@ class SummaryFileWriter : public SummaryWriterInterface {
         "Could not initialize events writer.");
     last_flush_ = env_->NowMicros();
     is_initialized_ = true;
+    flush_thread_.reset(env_->StartThread(
+        ThreadOptions(), "SummaryFileWriter", [this]() { FlushLoop(); }));
     return OkStatus();
   }
 
   Status Flush() override {
-    mutex_lock ml(mu_);
-    if (!is_initialized_) {
-      return errors::FailedPrecondition("Class was not properly initialized.");
+    mutex_lock writer_lock(writer_mu_);
+    std::vector<std::unique_ptr<Event>> events;
+    Status status;
+    {
+      mutex_lock ml(mu_);
+      if (!is_initialized_) {
+        return errors::FailedPrecondition(
+            "Class was not properly initialized.");
+      }
+      events.swap(queue_);
+      status = flush_status_;
+      flush_status_ = OkStatus();
+      last_flush_ = env_->NowMicros();
     }
-    return InternalFlush();
+    status.Update(WriteEvents(events));
+    return status;
   }
 
   ~SummaryFileWriter() override {
+    {
+      mutex_lock ml(mu_);
+      shutdown_ = true;
+      flush_cv_.notify_one();
+    }
+    flush_thread_.reset();
     (void)Flush();  // Ignore errors.
   }
 
@@ -150,14 +170,22 @@ class SummaryFileWriter : public SummaryWriterInterface {
     return WriteEvent(std::move(e));
   }
 
+  // Queues `event`. The queue is written to file by a background thread when
+  // it holds more than max_queue events or flush_millis have elapsed since the
+  // last flush, so that the calling kernel doesn't wait for the file system.
+  // Returns the error of the last background flush, if any.
   Status WriteEvent(std::unique_ptr<Event> event) override {
     mutex_lock ml(mu_);
     queue_.emplace_back(std::move(event));
     if (queue_.size() > max_queue_ ||
         env_->NowMicros() - last_flush_ > 1000 * flush_millis_) {
-      return InternalFlush();
+      flush_requested_ = true;
+      last_flush_ = env_->NowMicros();
+      flush_cv_.notify_one();
     }
-    return OkStatus();
+    Status status = flush_status_;
+    flush_status_ = OkStatus();
+    return status;
   }
 
   string DebugString() const override { return "SummaryFileWriter"; }
@@ -167,26 +195,60 @@ class SummaryFileWriter : public SummaryWriterInterface {
     return static_cast<double>(env_->NowMicros()) / 1.0e6;
   }
 
-  Status InternalFlush() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
-    for (const std::unique_ptr<Event>& e : queue_) {
+  // Writes the queue to file whenever WriteEvent requests it, until the
+  // writer is destroyed.
+  void FlushLoop() {
+    while (true) {
+      {
+        mutex_lock ml(mu_);
+        while (!flush_requested_ && !shutdown_) {
+          flush_cv_.wait(ml);
+        }
+        if (shutdown_) return;
+      }
+      // The queue is taken under writer_mu_ so that the batches are written
+      // in order with those of concurrent calls to Flush().
+      mutex_lock writer_lock(writer_mu_);
+      std::vector<std::unique_ptr<Event>> events;
+      {
+        mutex_lock ml(mu_);
+        flush_requested_ = false;
+        events.swap(queue_);
+      }
+      Status status = WriteEvents(events);
+      mutex_lock ml(mu_);
+      flush_status_.Update(status);
+    }
+  }
+
+  Status WriteEvents(const std::vector<std::unique_ptr<Event>>& events)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(writer_mu_) {
+    for (const std::unique_ptr<Event>& e : events) {
       events_writer_->WriteEvent(*e);
     }
-    queue_.clear();
     TF_RETURN_WITH_CONTEXT_IF_ERROR(events_writer_->Flush(),
                                     "Could not flush events file.");
-    last_flush_ = env_->NowMicros();
     return OkStatus();
   }
 
   bool is_initialized_;
   const int max_queue_;
   const int flush_millis_;
-  uint64 last_flush_;
+  uint64 last_flush_ TF_GUARDED_BY(mu_);
   Env* env_;
+  // Serializes the writes to events_writer_. Acquired before mu_.
+  mutex writer_mu_;
   mutex mu_;
   std::vector<std::unique_ptr<Event>> queue_ TF_GUARDED_BY(mu_);
   // A pointer to allow deferred construction.
-  std::unique_ptr<EventsWriter> events_writer_ TF_GUARDED_BY(mu_);
+  std::unique_ptr<EventsWriter> events_writer_ TF_GUARDED_BY(writer_mu_);
+  condition_variable flush_cv_;
+  bool flush_requested_ TF_GUARDED_BY(mu_) = false;
+  bool shutdown_ TF_GUARDED_BY(mu_) = false;
+  // The error of the background flushes since the last call to WriteEvent or
+  // Flush.
+  Status flush_status_ TF_GUARDED_BY(mu_);
+  std::unique_ptr<Thread> flush_thread_;
   std::vector<std::pair<string, SummaryMetadata>> registered_summaries_
       TF_GUARDED_BY(mu_);
 };
@@ -259,6 +259,46 @@ TEST_F(SummaryFileWriterTest, WallTime) {
       [](const Event& e) { EXPECT_EQ(e.wall_time(), 7.023); }));
 }
 
+TEST_F(SummaryFileWriterTest, WritesEventsInOrder) {
+  // Keep unique with all other test names in this file.
+  const string test_name = "events_in_order_test";
+  const int num_events = 100;
+  {
+    SummaryWriterInterface* writer;
+    TF_CHECK_OK(CreateSummaryFileWriter(1, 1, testing::TmpDir(), test_name,
+                                        &env_, &writer));
+    core::ScopedUnref deleter(writer);
+    for (int i = 0; i < num_events; ++i) {
+      std::unique_ptr<Event> e{new Event};
+      e->set_step(i);
+      TF_CHECK_OK(writer->WriteEvent(std::move(e)));
+      // Interleaves the background flushes with the synchronous ones.
+      if (i % 10 == 0) TF_CHECK_OK(writer->Flush());
+    }
+  }
+
+  std::vector<string> files;
+  TF_CHECK_OK(env_.GetChildren(testing::TmpDir(), &files));
+  auto it = std::find_if(files.begin(), files.end(), [&](const string& f) {
+    return absl::StrContains(f, test_name);
+  });
+  ASSERT_NE(it, files.end());
+  std::unique_ptr<RandomAccessFile> read_file;
+  TF_CHECK_OK(env_.NewRandomAccessFile(io::JoinPath(testing::TmpDir(), *it),
+                                       &read_file));
+  io::RecordReader reader(read_file.get(), io::RecordReaderOptions());
+  tstring record;
+  uint64 offset = 0;
+  TF_CHECK_OK(reader.ReadRecord(&offset, &record));  // The file version event
+  for (int i = 0; i < num_events; ++i) {
+    TF_CHECK_OK(reader.ReadRecord(&offset, &record));
+    Event e;
+    e.ParseFromString(record);
+    EXPECT_EQ(e.step(), i);
+  }
+  EXPECT_TRUE(errors::IsOutOfRange(reader.ReadRecord(&offset, &record)));
+}
+
 TEST_F(SummaryFileWriterTest, AvoidFilenameCollision) {
   // Keep unique with all other test names in this file.
   string test_name = "avoid_filename_collision_test";
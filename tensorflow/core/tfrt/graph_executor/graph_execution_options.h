@@ -68,6 +68,12 @@ struct GraphExecutionOptions {
   // TODO(b/278298965): Maybe remove normalization.
   uint64_t online_cost_analysis_normalize_ratio = 1;
 
+  // If positive, the op costs are recorded again every this many requests to
+  // a client graph, and the client graph is re-compiled with them, so that the
+  // stream assignment follows the changes of the op costs. The compilation
+  // inputs of the client graphs are then kept in memory.
+  uint64_t online_cost_analysis_update_period = 0;
+
   // If true, the MLRT interpreter will be used instead of the BEF executor.
   // This option is experimental.
   bool enable_mlrt = false;
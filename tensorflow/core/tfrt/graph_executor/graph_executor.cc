@@ -27,7 +27,6 @@ limitations under the License.
 
 #include "learning/brain/experimental/tfrt/native_lowering/kernels/sync_context.h"
 #include "learning/brain/experimental/tfrt/native_lowering/saved_model/saved_model_translate.h"
-#include "absl/base/call_once.h"
 #include "absl/log/check.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
@@ -537,11 +536,13 @@ tensorflow::Status GraphExecutor::Run(
     flat_inputs.push_back(inputs.at(original_index).second);
   }
 
-  // Conduct cost analysis for the first request on this `loaded_client_graph`.
+  // Conduct cost analysis for the first request on this `loaded_client_graph`,
+  // and periodically after it if requested.
   std::unique_ptr<CostRecorder> cost_recorder;
   if (options_.enable_online_cost_analysis) {
     cost_recorder = loaded_client_graph.MaybeCreateCostRecorder(
-        options_.online_cost_analysis_normalize_ratio);
+        options_.online_cost_analysis_normalize_ratio,
+        options_.online_cost_analysis_update_period);
   }
 
   std::vector<tensorflow::Tensor> flat_outputs;
@@ -892,21 +893,37 @@ tensorflow::Status GraphExecutor::RunWithSyncInterpreter(
 
 std::unique_ptr<CostRecorder>
 GraphExecutor::LoadedClientGraph::MaybeCreateCostRecorder(
-    uint64_t normalize_ratio) const {
-  std::unique_ptr<CostRecorder> cost_recorder;
-  absl::call_once(create_cost_recorder_once_, [&]() {
-    cost_recorder = std::make_unique<CostRecorder>(normalize_ratio);
-  });
-  return cost_recorder;
+    uint64_t normalize_ratio, uint64_t update_period) const {
+  const uint64_t num_requests =
+      num_cost_recorder_requests_.fetch_add(1, std::memory_order_relaxed);
+  if (num_requests == 0 ||
+      (update_period > 0 && num_requests % update_period == 0)) {
+    return std::make_unique<CostRecorder>(normalize_ratio);
+  }
+  return nullptr;
 }
 
 Status GraphExecutor::LoadedClientGraph::UpdateCost(
     const CostRecorder& cost_recorder, const Runtime& runtime) {
   LOG(INFO) << "TFRT updating op costs of loaded client graph (" << this << ") "
             << name_;
-  // Move to function scope to reduce memory footprint.
-  auto tfrt_mlir = std::move(tfrt_mlir_);
-  auto tf_mlir_with_op_keys = std::move(tf_mlir_with_op_keys_);
+  tensorflow::mutex_lock update_lock(update_cost_mu_);
+  if (!tfrt_mlir_) {
+    // The costs were already updated and the modules were released.
+    return OkStatus();
+  }
+  // Move to function scope to reduce memory footprint, unless the costs are
+  // updated again later. The recompilation lowers the modules in place, so the
+  // kept modules are copied.
+  const bool keep_modules =
+      graph_executor_->options().online_cost_analysis_update_period > 0;
+  const auto take_module = [keep_modules](
+                               mlir::OwningOpRef<mlir::ModuleOp>& module) {
+    if (!module || !keep_modules) return std::move(module);
+    return mlir::OwningOpRef<mlir::ModuleOp>(module->clone());
+  };
+  auto tfrt_mlir = take_module(tfrt_mlir_);
+  auto tf_mlir_with_op_keys = take_module(tf_mlir_with_op_keys_);
   mlir::StatusScopedDiagnosticHandler diag_handler(
       tfrt_mlir.get().getContext());
   std::shared_ptr<ExecutableContext> new_executable_context = nullptr;
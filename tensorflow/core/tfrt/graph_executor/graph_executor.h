@@ -15,6 +15,7 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_TFRT_GRAPH_EXECUTOR_GRAPH_EXECUTOR_H_
 #define TENSORFLOW_CORE_TFRT_GRAPH_EXECUTOR_GRAPH_EXECUTOR_H_
 
+#include <atomic>
 #include <cstdint>
 #include <functional>
 #include <memory>
@@ -23,7 +24,6 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
-#include "absl/base/call_once.h"
 #include "absl/strings/string_view.h"
 #include "mlir/IR/BuiltinOps.h"  // from @llvm-project
 #include "mlir/IR/OwningOpRef.h"  // from @llvm-project
@@ -170,10 +170,11 @@ class GraphExecutor {
           tfrt_mlir_(std::move(tfrt_mlir)),
           executable_context_(std::move(executable_context)) {}
 
-    // Returns a `CostRecorder` if none has been created before for this
-    // `LoadedClientGraph`.
+    // Returns a `CostRecorder` for the first request to this
+    // `LoadedClientGraph`, and then for every `update_period` requests if
+    // `update_period` is positive. Returns nullptr for the other requests.
     std::unique_ptr<CostRecorder> MaybeCreateCostRecorder(
-        uint64_t normalize_ratio = 1) const;
+        uint64_t normalize_ratio = 1, uint64_t update_period = 0) const;
 
     // Updates the op cost values in this `LoadedClientGraph` with records from
     // `cost_recorder`.
@@ -199,15 +200,17 @@ class GraphExecutor {
     OpKernelRunnerTable runner_table_;
     tfd::FallbackResourceArray resource_array_;
     std::unique_ptr<mlir::MLIRContext> mlir_context_;
-    // Thread-safety resulted from `create_cost_recorder_once_`.
-    mlir::OwningOpRef<mlir::ModuleOp>
-        tf_mlir_with_op_keys_;                     // For recompilation in MLRT.
-    mlir::OwningOpRef<mlir::ModuleOp> tfrt_mlir_;  // For recompilation in TFRT.
+    tensorflow::mutex update_cost_mu_;
+    mlir::OwningOpRef<mlir::ModuleOp> tf_mlir_with_op_keys_ TF_GUARDED_BY(
+        update_cost_mu_);  // For recompilation in MLRT.
+    mlir::OwningOpRef<mlir::ModuleOp> tfrt_mlir_
+        TF_GUARDED_BY(update_cost_mu_);  // For recompilation in TFRT.
     mutable tensorflow::mutex executable_context_mu_;
     // Can be updated if online cost analysis is enabled.
     std::shared_ptr<ExecutableContext> executable_context_
         TF_GUARDED_BY(executable_context_mu_);
-    mutable absl::once_flag create_cost_recorder_once_;
+    // The number of requests that asked for a `CostRecorder`.
+    mutable std::atomic<uint64_t> num_cost_recorder_requests_{0};
     SyncResourceState sync_resource_state_;
   };
 
@@ -141,6 +141,43 @@ TEST_P(GraphExecutorTest, BasicWithOnlineCostAnalysis) {
               ::testing::ElementsAreArray({2}));
 }
 
+TEST_P(GraphExecutorTest, BasicWithPeriodicOnlineCostAnalysis) {
+  GraphDef graph_def;
+  TF_ASSERT_OK(GetSimpleGraphDef(graph_def));
+
+  auto runtime = DefaultTfrtRuntime(/*num_threads=*/1);
+  GraphExecutor::Options options(runtime.get());
+  options.enable_online_cost_analysis = true;
+  options.online_cost_analysis_update_period = 2;
+  options.enable_mlrt = GetParam();
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto fallback_state,
+      tensorflow::tfrt_stub::FallbackState::Create(
+          CreateDefaultSessionOptions(options), graph_def.library()));
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto graph_executor,
+      GraphExecutor::Create(options, *fallback_state, graph_def,
+                            GetKernelRegistry()));
+
+  // Set input 'x' to [[1, 1, 1]]
+  std::vector<std::pair<std::string, tensorflow::Tensor>> inputs;
+  inputs.push_back({"input", CreateTfTensor<int32_t>(
+                                 /*shape=*/{1, 3}, /*data=*/{1, 1, 1})});
+
+  // The first and the third runs record the costs and re-compile the graph.
+  for (int i = 0; i < 4; ++i) {
+    std::vector<tensorflow::Tensor> outputs;
+    TF_ASSERT_OK(graph_executor->Run(/*run_options=*/{}, inputs,
+                                     /*output_tensor_names=*/{"rank"},
+                                     /*target_tensor_names=*/{}, &outputs));
+    ASSERT_EQ(outputs.size(), 1);
+
+    EXPECT_THAT(GetTfTensorData<int32_t>(outputs[0]),
+                ::testing::ElementsAreArray({2}));
+  }
+}
+
 INSTANTIATE_TEST_SUITE_P(GraphExecutorTestSuite, GraphExecutorTest,
                          ::testing::Bool());
 
@@ -166,6 +203,28 @@ TEST_F(GraphExecutorTest, DoOnlineCostAnalysisExactlyOnce) {
   EXPECT_TRUE(loaded_client_graph_1.MaybeCreateCostRecorder() == nullptr);
 }
 
+TEST_F(GraphExecutorTest, DoOnlineCostAnalysisPeriodically) {
+  GraphExecutor::LoadedClientGraph loaded_client_graph(
+      "name", /*symbol_uids=*/{},
+      /*graph_executor=*/nullptr,
+      /*mlir_context=*/nullptr,
+      /*tf_mlir_with_op_keys=*/{}, /*tfrt_mlir=*/{},
+      /*executable_context=*/nullptr);
+
+  // A cost recorder is returned for the first request, and then for every
+  // third request.
+  std::vector<bool> has_cost_recorder;
+  for (int i = 0; i < 7; ++i) {
+    has_cost_recorder.push_back(
+        loaded_client_graph.MaybeCreateCostRecorder(/*normalize_ratio=*/1,
+                                                    /*update_period=*/3) !=
+        nullptr);
+  }
+  EXPECT_THAT(has_cost_recorder,
+              ::testing::ElementsAre(true, false, false, true, false, false,
+                                     true));
+}
+
 TEST_F(GraphExecutorTest, Extend) {
   GraphDef graph_def;
   {
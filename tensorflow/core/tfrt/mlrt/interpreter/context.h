@@ -110,12 +110,17 @@ void UnwindOnError(ExecutionContext& context, int64_t pc);
 
 class FunctionContext {
  public:
-  FunctionContext(bc::Function function, ExecutionContext* execution_context)
+  // `registers` is storage recycled from a returned function. Its values must
+  // have been destroyed.
+  FunctionContext(bc::Function function, ExecutionContext* execution_context,
+                  std::vector<Value> registers = {})
       : pc_(0),
-        registers_(function.num_regs()),
+        registers_(std::move(registers)),
         function_object_(function),
         execution_context_(execution_context) {
     DCHECK(execution_context);
+    DCHECK(registers_.empty());
+    registers_.resize(function.num_regs());
   }
 
   FunctionContext(const FunctionContext&) = delete;
@@ -269,7 +274,7 @@ class ExecutionContext {
   void Call(bc::Function function_object, bc::Span<uint8_t> last_uses,
             Args args, Results results) {
     auto& function_context =
-        function_stack_.emplace_back(function_object, this);
+        function_stack_.emplace_back(function_object, this, TakeRegisters());
     function_context.Call(last_uses, args, results);
     state_ = State::kReady;
   }
@@ -277,7 +282,7 @@ class ExecutionContext {
   template <typename Args, typename Results>
   void CallByMove(bc::Function function_object, Args args, Results results) {
     auto& function_context =
-        function_stack_.emplace_back(function_object, this);
+        function_stack_.emplace_back(function_object, this, TakeRegisters());
     function_context.CallByMove(args, results);
     state_ = State::kReady;
   }
@@ -448,7 +453,26 @@ class ExecutionContext {
   }
 
  private:
+  // Returns the register storage of a previously returned function, so that
+  // calls in loops do not allocate registers for every iteration.
+  std::vector<Value> TakeRegisters() {
+    if (free_registers_.empty()) return {};
+    std::vector<Value> registers = std::move(free_registers_.back());
+    free_registers_.pop_back();
+    return registers;
+  }
+
+  // Pops the current function and keeps its register storage for the next
+  // call.
+  void PopFunction() {
+    auto& registers = function_stack_.back().registers_;
+    registers.clear();
+    free_registers_.push_back(std::move(registers));
+    function_stack_.pop_back();
+  }
+
   absl::InlinedVector<FunctionContext, 2> function_stack_;
+  absl::InlinedVector<std::vector<Value>, 2> free_registers_;
 
   enum class State {
     // The function is pushed to the stack, and ready for execution.
@@ -77,7 +77,7 @@ void Execute(ExecutionContext& context) {
         break;
       case ExecutionContext::State::kReturn: {
         tsl::profiler::TraceMe trace_me("Execute::Return");
-        context.function_stack_.pop_back();
+        context.PopFunction();
         if (context.function_stack_.empty()) {
           if (context.exit_handler_) {
             std::move(context.exit_handler_)();
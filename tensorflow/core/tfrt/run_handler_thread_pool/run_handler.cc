@@ -27,6 +27,7 @@ limitations under the License.
 
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
 #include "tensorflow/core/lib/core/threadpool_interface.h"
+#include "tensorflow/core/lib/monitoring/gauge.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/context.h"
 #include "tensorflow/core/platform/denormal.h"
@@ -48,6 +49,19 @@ namespace {
 typedef typename internal::RunHandlerEnvironment::Task Task;
 typedef Eigen::RunQueue<Task, 1024> Queue;
 
+auto* run_handler_active_requests =
+    tensorflow::monitoring::Gauge<int64_t, 1>::New(
+        "/tensorflow/tfrt/run_handler/active_requests",
+        "Record the number of active requests of each sub thread pool.",
+        "sub_thread_pool");
+
+auto* run_handler_pending_tasks =
+    tensorflow::monitoring::Gauge<int64_t, 1>::New(
+        "/tensorflow/tfrt/run_handler/pending_tasks",
+        "Record the number of pending tasks of the active requests of each sub "
+        "thread pool.",
+        "sub_thread_pool");
+
 }  // namespace
 
 namespace internal {
@@ -141,6 +155,7 @@ ThreadWorkSource::ThreadWorkSource()
       non_blocking_inflight_(0),
       pending_tasks_(0),
       traceme_id_(0),
+      sub_thread_pool_affinity_(-1),
       version_(0),
       sub_thread_pool_waiter_(nullptr) {
   queue_waiters_.next = &queue_waiters_;
@@ -331,9 +346,18 @@ unsigned ThreadWorkSource::NonBlockingWorkShardingFactor() {
   return non_blocking_work_sharding_factor_;
 }
 
+int ThreadWorkSource::GetSubThreadPoolAffinity() {
+  return sub_thread_pool_affinity_.load(std::memory_order_relaxed);
+}
+
+void ThreadWorkSource::SetSubThreadPoolAffinity(int value) {
+  sub_thread_pool_affinity_.store(value, std::memory_order_relaxed);
+}
+
 std::string ThreadWorkSource::ToString() {
   return tensorflow::strings::StrCat(
       "traceme_id = ", GetTracemeId(),
+      ", sub thread pool affinity = ", GetSubThreadPoolAffinity(),
       ", inter queue size = ", TaskQueueSize(true),
       ", inter inflight = ", GetInflightTaskCount(true),
       ", intra queue size = ", TaskQueueSize(false),
@@ -356,6 +380,8 @@ RunHandlerThreadPool::RunHandlerThreadPool(
       blocking_thread_max_waiting_time_(
           options.blocking_threads_max_sleep_time_micro_sec),
       enable_wake_up_(options.enable_wake_up),
+      isolate_sub_thread_pools_(options.isolate_sub_thread_pools),
+      num_pinned_requests_(0),
       thread_data_(num_threads_),
       env_(env, thread_options, name),
       name_(name),
@@ -474,6 +500,10 @@ int RunHandlerThreadPool::NumNonBlockingThreads() const {
   return num_non_blocking_threads_;
 }
 
+void RunHandlerThreadPool::SetNumPinnedRequests(int num_pinned_requests) {
+  num_pinned_requests_.store(num_pinned_requests, std::memory_order_relaxed);
+}
+
 RunHandlerThreadPool::ThreadData::ThreadData()
     : new_version(0), current_index(0), current_version(0) {}
 
@@ -482,7 +512,8 @@ Task RunHandlerThreadPool::FindTask(
     int sub_thread_pool_id, int max_blocking_inflight,
     bool may_steal_blocking_work,
     const Eigen::MaxSizeVector<ThreadWorkSource*>& thread_work_sources,
-    bool* task_from_blocking_queue, ThreadWorkSource** tws) {
+    bool* task_from_blocking_queue, ThreadWorkSource** tws,
+    PinnedRequests pinned_requests) {
   Task t;
   int current_index = thread_data_[thread_id].current_index;
   *task_from_blocking_queue = false;
@@ -495,6 +526,16 @@ Task RunHandlerThreadPool::FindTask(
     *tws = thread_work_sources[current_index];
     ++current_index;
 
+    if (pinned_requests != PinnedRequests::kAll) {
+      const int affinity = (*tws)->GetSubThreadPoolAffinity();
+      const bool skip = pinned_requests == PinnedRequests::kOwnOnly
+                            ? affinity != sub_thread_pool_id
+                            : affinity >= 0 && affinity != sub_thread_pool_id;
+      if (skip) {
+        continue;
+      }
+    }
+
     // For blocking thread, search for blocking tasks first.
     if (may_steal_blocking_work &&
         (*tws)->GetInflightTaskCount(true) < max_blocking_inflight) {
@@ -543,7 +584,20 @@ void RunHandlerThreadPool::WorkerLoop(int thread_id,
         thread_data_[thread_id].current_thread_work_sources.get();
     sub_thread_pool_id = thread_data_[thread_id].sub_thread_pool_id;
     int active_requests = thread_work_sources->size();
-    if (may_steal_blocking_work) {
+    const bool has_pinned_requests =
+        num_pinned_requests_.load(std::memory_order_relaxed) > 0;
+    if (may_steal_blocking_work && has_pinned_requests) {
+      // The requests pinned to the sub thread pool of the thread come first,
+      // whatever their priority.
+      t = FindTask(0, active_requests, thread_id, sub_thread_pool_id,
+                   kMaxBlockingInflight,
+                   /*may_steal_blocking_work=*/true, *thread_work_sources,
+                   &task_from_blocking_queue, &tws, PinnedRequests::kOwnOnly);
+    }
+    if (may_steal_blocking_work && !t.f) {
+      const PinnedRequests pinned_requests =
+          has_pinned_requests ? PinnedRequests::kExcludeOthers
+                              : PinnedRequests::kAll;
       // Each thread will first look for tasks from requests that belongs to
       // its sub thread pool.
       int search_range_start =
@@ -561,16 +615,20 @@ void RunHandlerThreadPool::WorkerLoop(int thread_id,
       t = FindTask(search_range_start, search_range_end, thread_id,
                    sub_thread_pool_id, kMaxBlockingInflight,
                    /*may_steal_blocking_work=*/true, *thread_work_sources,
-                   &task_from_blocking_queue, &tws);
+                   &task_from_blocking_queue, &tws, pinned_requests);
       if (!t.f) {
         // Search from all requests if the thread cannot find tasks from
-        // requests that belong to its own sub thread pool.
+        // requests that belong to its own sub thread pool. The requests
+        // pinned to other sub thread pools are left to them if the sub thread
+        // pools are isolated.
         t = FindTask(0, active_requests, thread_id, sub_thread_pool_id,
                      kMaxBlockingInflight,
                      /*may_steal_blocking_work=*/true, *thread_work_sources,
-                     &task_from_blocking_queue, &tws);
+                     &task_from_blocking_queue, &tws,
+                     isolate_sub_thread_pools_ ? pinned_requests
+                                               : PinnedRequests::kAll);
       }
-    } else {
+    } else if (!may_steal_blocking_work) {
       // For non-blocking threads, it will always search from all pending
       // requests.
       t = FindTask(0, active_requests, thread_id, sub_thread_pool_id,
@@ -732,7 +790,8 @@ class RunHandlerPool::Impl {
                 options.use_adaptive_waiting_time, options.enable_wake_up,
                 options.max_concurrent_handler,
                 options.num_threads_in_sub_thread_pool,
-                options.sub_thread_request_percentage),
+                options.sub_thread_request_percentage,
+                options.isolate_sub_thread_pools),
             tensorflow::Env::Default(), tensorflow::ThreadOptions(),
             "tf_run_handler_pool", &waiters_mu_, &queue_waiters_)),
         iterations_(0),
@@ -753,6 +812,12 @@ class RunHandlerPool::Impl {
       queue_waiter.next = &queue_waiter;
       queue_waiter.prev = &queue_waiter;
     }
+    for (int i = 0; i < options.num_sub_thread_pool; ++i) {
+      active_requests_cells_.push_back(
+          run_handler_active_requests->GetCell(tensorflow::strings::StrCat(i)));
+      pending_tasks_cells_.push_back(
+          run_handler_pending_tasks->GetCell(tensorflow::strings::StrCat(i)));
+    }
     run_handler_thread_pool_->Start();
   }
 
@@ -772,6 +837,8 @@ class RunHandlerPool::Impl {
     return run_handler_thread_pool_.get();
   }
 
+  int num_sub_thread_pools() const { return queue_waiters_.size(); }
+
   bool has_free_handler() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
     return !free_handlers_.empty();
   }
@@ -827,6 +894,7 @@ class RunHandlerPool::Impl {
         ++it;
       }
       version = ++version_;
+      UpdateQueueDepthMetrics();
     }
     RecomputePoolStats(num_active_requests, version, *thread_work_sources);
     return std::unique_ptr<RunHandler>(new RunHandler(handler_impl));
@@ -857,6 +925,7 @@ class RunHandlerPool::Impl {
     free_handlers_.push_back(handler);
     DCHECK_LE(free_handlers_.size(), max_handlers_);
     LogInfo();
+    UpdateQueueDepthMetrics();
 
     // We do not recompute pool stats all the time. The side effect is that
     // there may be empty thread work sources in the queue. However, any new
@@ -910,6 +979,15 @@ class RunHandlerPool::Impl {
 
   void LogInfo() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
+  // Records the number of active requests and pending tasks of each sub
+  // thread pool.
+  void UpdateQueueDepthMetrics() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Returns the sub thread pool of the request at `index` in the sorted list
+  // of `num_active_requests` active requests.
+  int GetSubThreadPoolId(internal::ThreadWorkSource* tws, int index,
+                         int num_active_requests) const;
+
   // Maximum number of handlers pre-created during pool construction time. The
   // number has been chosen expecting each handler might at least want 1
   // inter-op thread for execution (during compute intensive workloads like
@@ -938,25 +1016,32 @@ class RunHandlerPool::Impl {
   int64_t version_ TF_GUARDED_BY(mu_);
   bool wait_if_no_active_request_;
   const std::vector<double> sub_thread_pool_end_request_percentage_;
+
+  // Indexed by sub thread pool.
+  std::vector<tensorflow::monitoring::GaugeCell<int64_t>*>
+      active_requests_cells_;
+  std::vector<tensorflow::monitoring::GaugeCell<int64_t>*>
+      pending_tasks_cells_;
 };
 
 void RunHandlerPool::Impl::RecomputePoolStats(
     int num_active_requests, uint64_t version,
     const Eigen::MaxSizeVector<internal::ThreadWorkSource*>&
         thread_work_sources) {
-  int sub_thread_pool_id = 0;
+  int num_pinned_requests = 0;
   for (int i = 0; i < num_active_requests; ++i) {
-    while (
-        sub_thread_pool_id <
-            sub_thread_pool_end_request_percentage_.size() - 1 &&
-        i >= num_active_requests *
-                 sub_thread_pool_end_request_percentage_[sub_thread_pool_id]) {
-      sub_thread_pool_id++;
+    internal::ThreadWorkSource* tws = thread_work_sources[i];
+    if (tws->GetSubThreadPoolAffinity() >= 0) {
+      ++num_pinned_requests;
     }
-    thread_work_sources[i]->SetWaiter(version,
-                                      &queue_waiters_[sub_thread_pool_id],
-                                      &waiters_mu_[sub_thread_pool_id]);
+    // The new tasks of the request wake up the threads of the sub thread pool
+    // that runs it.
+    const int sub_thread_pool_id =
+        GetSubThreadPoolId(tws, i, num_active_requests);
+    tws->SetWaiter(version, &queue_waiters_[sub_thread_pool_id],
+                   &waiters_mu_[sub_thread_pool_id]);
   }
+  run_handler_thread_pool()->SetNumPinnedRequests(num_pinned_requests);
 
   int num_threads = run_handler_thread_pool()->NumThreads();
   int num_blocking_threads = run_handler_thread_pool()->NumBlockingThreads();
@@ -968,6 +1053,42 @@ void RunHandlerPool::Impl::RecomputePoolStats(
   }
 }
 
+int RunHandlerPool::Impl::GetSubThreadPoolId(internal::ThreadWorkSource* tws,
+                                             int index,
+                                             int num_active_requests) const {
+  const int affinity = tws->GetSubThreadPoolAffinity();
+  if (affinity >= 0) {
+    return affinity;
+  }
+  int sub_thread_pool_id = 0;
+  while (sub_thread_pool_id <
+             sub_thread_pool_end_request_percentage_.size() - 1 &&
+         index >= num_active_requests *
+                      sub_thread_pool_end_request_percentage_
+                          [sub_thread_pool_id]) {
+    sub_thread_pool_id++;
+  }
+  return sub_thread_pool_id;
+}
+
+void RunHandlerPool::Impl::UpdateQueueDepthMetrics() {
+  const int num_active_requests = sorted_active_handlers_.size();
+  std::vector<int64_t> active_requests(active_requests_cells_.size(), 0);
+  std::vector<int64_t> pending_tasks(pending_tasks_cells_.size(), 0);
+  auto it = sorted_active_handlers_.cbegin();
+  for (int i = 0; i < num_active_requests; ++i, ++it) {
+    internal::ThreadWorkSource* tws = (*it)->tws();
+    const int sub_thread_pool_id =
+        GetSubThreadPoolId(tws, i, num_active_requests);
+    ++active_requests[sub_thread_pool_id];
+    pending_tasks[sub_thread_pool_id] += tws->GetPendingTaskCount();
+  }
+  for (int i = 0; i < active_requests.size(); ++i) {
+    active_requests_cells_[i]->Set(active_requests[i]);
+    pending_tasks_cells_[i]->Set(pending_tasks[i]);
+  }
+}
+
 void RunHandlerPool::Impl::LogInfo() {
   if (iterations_++ % 50000 == 10 && VLOG_IS_ON(1)) {
     int num_active_requests = sorted_active_handlers_.size();
@@ -1016,6 +1137,12 @@ void RunHandler::Impl::Reset(int64_t step_id,
   step_id_ = step_id;
   options_ = options;
   tws_.SetTracemeId(step_id);
+  // Requests pinned to a sub thread pool that doesn't exist are scheduled by
+  // priority.
+  tws_.SetSubThreadPoolAffinity(
+      options.sub_thread_pool_id < pool_impl_->num_sub_thread_pools()
+          ? options.sub_thread_pool_id
+          : -1);
 }
 
 int RunHandler::Impl::RunHandlerEigenThreadPool::NumThreads() const {
@@ -44,10 +44,16 @@ class RunHandler;
 
 // Options for RunHanler.
 struct RunHandlerOptions {
-  RunHandlerOptions() : priority(0) {}
+  RunHandlerOptions() : priority(0), sub_thread_pool_id(-1) {}
 
   // Request priority.
   int priority;
+
+  // If non-negative, the inter-op work of the request is preferably run by
+  // the threads of this sub thread pool, whatever the priority of the
+  // request. Pinning the requests of a model to the same sub thread pool keeps
+  // their working set in the caches of the same cores.
+  int sub_thread_pool_id;
 };
 
 // RunHandlerPool is a fixed size pool of pre-allocated RunHandlers
@@ -108,6 +114,11 @@ class RunHandlerPool {
 
     // If true, threads will be waken up by new tasks.
     bool enable_wake_up = true;
+
+    // If true, the inter-op threads don't run the inter-op work of requests
+    // pinned to other sub thread pools with RunHandlerOptions::
+    // sub_thread_pool_id, even if they are idle.
+    bool isolate_sub_thread_pools = false;
   };
   explicit RunHandlerPool(Options options);
   ~RunHandlerPool();
@@ -255,6 +266,11 @@ class ThreadWorkSource {
 
   unsigned NonBlockingWorkShardingFactor();
 
+  // The sub thread pool the request is pinned to, or -1.
+  int GetSubThreadPoolAffinity();
+
+  void SetSubThreadPoolAffinity(int value);
+
   std::string ToString();
 
  private:
@@ -280,6 +296,7 @@ class ThreadWorkSource {
   tensorflow::mutex waiters_mu_;
   Waiter queue_waiters_ TF_GUARDED_BY(waiters_mu_);
   std::atomic<int64_t> traceme_id_;
+  std::atomic<int> sub_thread_pool_affinity_;
 
   tensorflow::mutex run_handler_waiter_mu_;
   uint64_t version_ TF_GUARDED_BY(run_handler_waiter_mu_);
@@ -301,6 +318,7 @@ class RunHandlerThreadPool {
     int max_concurrent_handler;
     std::vector<int> num_threads_in_sub_thread_pool;
     std::vector<double> sub_thread_request_percentage;
+    bool isolate_sub_thread_pools;
     Options(int num_blocking_threads, int num_non_blocking_threads,
             bool wait_if_no_active_request,
             int non_blocking_threads_sleep_time_micro_sec,
@@ -308,7 +326,8 @@ class RunHandlerThreadPool {
             bool use_adaptive_waiting_time, bool enable_wake_up,
             int max_concurrent_handler,
             const std::vector<int>& num_threads_in_sub_thread_pool,
-            const std::vector<double>& sub_thread_request_percentage)
+            const std::vector<double>& sub_thread_request_percentage,
+            bool isolate_sub_thread_pools = false)
         : num_blocking_threads(num_blocking_threads),
           num_non_blocking_threads(num_non_blocking_threads),
           wait_if_no_active_request(wait_if_no_active_request),
@@ -320,7 +339,8 @@ class RunHandlerThreadPool {
           enable_wake_up(enable_wake_up),
           max_concurrent_handler(max_concurrent_handler),
           num_threads_in_sub_thread_pool(num_threads_in_sub_thread_pool),
-          sub_thread_request_percentage(sub_thread_request_percentage) {}
+          sub_thread_request_percentage(sub_thread_request_percentage),
+          isolate_sub_thread_pools(isolate_sub_thread_pools) {}
   };
   struct PerThread {
     constexpr PerThread() : pool(nullptr), thread_id(-1) {}
@@ -359,6 +379,17 @@ class RunHandlerThreadPool {
 
   void WorkerLoop(int thread_id, bool may_steal_blocking_work);
 
+  // Which of the requests pinned to a sub thread pool are searched by
+  // FindTask.
+  enum class PinnedRequests {
+    // All the requests.
+    kAll,
+    // Only the requests pinned to the sub thread pool of the thread.
+    kOwnOnly,
+    // All the requests but the ones pinned to other sub thread pools.
+    kExcludeOthers,
+  };
+
   // Search tasks from Requets range searching_range_start to
   // searching_range_end. If there is no tasks in the search range and
   // may_steal_blocking_work is true, then search from all requests.
@@ -367,7 +398,11 @@ class RunHandlerThreadPool {
       int sub_thread_pool_id, int max_blocking_inflight,
       bool may_steal_blocking_work,
       const Eigen::MaxSizeVector<ThreadWorkSource*>& thread_work_sources,
-      bool* task_from_blocking_queue, ThreadWorkSource** tws);
+      bool* task_from_blocking_queue, ThreadWorkSource** tws,
+      PinnedRequests pinned_requests = PinnedRequests::kAll);
+
+  // Sets the number of active requests pinned to a sub thread pool.
+  void SetNumPinnedRequests(int num_pinned_requests);
 
   void WaitForWorkInSubThreadPool(int thread_id, bool is_blocking,
                                   int sub_thread_pool_id);
@@ -399,6 +434,8 @@ class RunHandlerThreadPool {
   const int non_blocking_thread_sleep_time_;
   const int blocking_thread_max_waiting_time_;
   const bool enable_wake_up_;
+  const bool isolate_sub_thread_pools_;
+  std::atomic<int> num_pinned_requests_;
   Eigen::MaxSizeVector<ThreadData> thread_data_;
   internal::RunHandlerEnvironment env_;
   std::atomic<bool> cancelled_;
@@ -638,6 +638,108 @@ TEST_P(RunHandlerThreadPoolTest, MultipleSubThreadPool) {
   delete run_handler_thread_pool;
 }
 
+TEST(RunHandlerUtilTest, FindTaskFromPinnedRequests) {
+  Eigen::MaxSizeVector<tensorflow::mutex> waiters_mu(2);
+  waiters_mu.resize(2);
+  Eigen::MaxSizeVector<internal::Waiter> waiters(2);
+  waiters.resize(2);
+  internal::RunHandlerThreadPool run_handler_thread_pool(
+      internal::RunHandlerThreadPool::Options(
+          /*num_blocking_threads=*/2, /*num_non_blocking_threads=*/0,
+          /*wait_if_no_active_request=*/true,
+          /*non_blocking_threads_sleep_time_micro_sec=*/250,
+          /*blocking_threads_max_sleep_time_micro_sec=*/250,
+          /*use_adaptive_waiting_time=*/true, /*enable_wake_up=*/true,
+          /*max_concurrent_handler=*/128,
+          /*num_threads_in_sub_thread_pool=*/{1, 1},
+          /*sub_thread_request_percentage=*/{0.5, 1},
+          /*isolate_sub_thread_pools=*/true),
+      tensorflow::Env::Default(), tensorflow::ThreadOptions(),
+      "tf_run_handler_pool", &waiters_mu, &waiters);
+  Eigen::MaxSizeVector<internal::ThreadWorkSource*> thread_work_sources(3);
+  thread_work_sources.resize(3);
+  internal::ThreadWorkSource tws[3];
+  for (int i = 0; i < 3; ++i) {
+    tws[i].SetWaiter(1, &waiters[0], &waiters_mu[0]);
+    thread_work_sources[i] = &tws[i];
+  }
+  // The first request is not pinned, the others are pinned to the sub thread
+  // pools 1 and 0.
+  tws[1].SetSubThreadPoolAffinity(1);
+  tws[2].SetSubThreadPoolAffinity(0);
+
+  int result = -1;
+  for (int i = 0; i < 3; ++i) {
+    run_handler_thread_pool.AddWorkToQueue(
+        &tws[i], /*is_blocking=*/true, TaskFunction([&result, i] {
+          result = i;
+        }));
+  }
+
+  const auto find_task = [&](int sub_thread_pool_id,
+                             internal::RunHandlerThreadPool::PinnedRequests
+                                 pinned_requests) {
+    bool task_from_blocking_queue;
+    internal::ThreadWorkSource* found_tws;
+    return run_handler_thread_pool.FindTask(
+        /*searching_range_start=*/0, /*searching_range_end=*/3,
+        /*thread_id=*/0, sub_thread_pool_id, /*max_blocking_inflight=*/10,
+        /*may_steal_blocking_work=*/true, thread_work_sources,
+        &task_from_blocking_queue, &found_tws, pinned_requests);
+  };
+
+  // The sub thread pool 1 only finds the request pinned to it.
+  internal::Task t = find_task(
+      /*sub_thread_pool_id=*/1,
+      internal::RunHandlerThreadPool::PinnedRequests::kOwnOnly);
+  ASSERT_NE(t.f, nullptr);
+  t.f->f();
+  EXPECT_EQ(result, 1);
+  t = find_task(/*sub_thread_pool_id=*/1,
+                internal::RunHandlerThreadPool::PinnedRequests::kOwnOnly);
+  EXPECT_EQ(t.f, nullptr);
+
+  // The sub thread pool 1 doesn't take the request pinned to the sub thread
+  // pool 0.
+  t = find_task(/*sub_thread_pool_id=*/1,
+                internal::RunHandlerThreadPool::PinnedRequests::kExcludeOthers);
+  ASSERT_NE(t.f, nullptr);
+  t.f->f();
+  EXPECT_EQ(result, 0);
+  t = find_task(/*sub_thread_pool_id=*/1,
+                internal::RunHandlerThreadPool::PinnedRequests::kExcludeOthers);
+  EXPECT_EQ(t.f, nullptr);
+
+  t = find_task(/*sub_thread_pool_id=*/1,
+                internal::RunHandlerThreadPool::PinnedRequests::kAll);
+  ASSERT_NE(t.f, nullptr);
+  t.f->f();
+  EXPECT_EQ(result, 2);
+}
+
+TEST(RunHandlerUtilTest, PinnedRequestsRunOnTheirSubThreadPool) {
+  RunHandlerPool::Options pool_options;
+  pool_options.num_inter_op_threads = 2;
+  pool_options.num_intra_op_threads = 1;
+  pool_options.num_sub_thread_pool = 2;
+  pool_options.num_threads_in_sub_thread_pool = {1, 1};
+  pool_options.sub_thread_request_percentage = {0.5, 1};
+  pool_options.isolate_sub_thread_pools = true;
+  RunHandlerPool pool(pool_options);
+
+  RunHandlerOptions options;
+  options.sub_thread_pool_id = 1;
+  auto handler = pool.Get(/*step_id=*/1, /*timeout_in_ms=*/0, options);
+  tensorflow::BlockingCounter counter(10);
+  for (int i = 0; i < 10; ++i) {
+    handler->ScheduleInterOpClosure(
+        TaskFunction([&counter] { counter.DecrementCount(); }));
+  }
+  counter.Wait();
+  handler.reset();
+  pool.Quiesce();
+}
+
 INSTANTIATE_TEST_SUITE_P(Parameter, RunHandlerThreadPoolTest,
                          testing::Combine(::testing::Bool(),
                                           ::testing::Bool()));
@@ -305,10 +305,22 @@ class Feature {
         if (!stream.ReadVarint32(&packed_length)) return false;
         auto packed_limit = stream.PushLimit(packed_length);
 
-        while (!stream.ExpectAtEnd()) {
-          protobuf_uint64 n;  // There is no API for int64
-          if (!stream.ReadVarint64(&n)) return false;
-          int64_list->push_back(static_cast<int64_t>(n));
+        const void* packed_data;
+        int packed_size;
+        if (packed_length > 0 &&
+            stream.GetDirectBufferPointer(&packed_data, &packed_size) &&
+            packed_size == packed_length) {
+          if (!ParsePackedVarints(static_cast<const uint8*>(packed_data),
+                                  packed_length, int64_list)) {
+            return false;
+          }
+          stream.Skip(packed_length);
+        } else {
+          while (!stream.ExpectAtEnd()) {
+            protobuf_uint64 n;  // There is no API for int64
+            if (!stream.ReadVarint64(&n)) return false;
+            int64_list->push_back(static_cast<int64_t>(n));
+          }
         }
 
         stream.PopLimit(packed_limit);
@@ -328,6 +340,38 @@ class Feature {
   StringPiece GetSerialized() const { return serialized_; }
 
  private:
+  // Appends the `length` bytes of packed varints at `data` to `int64_list`.
+  //
+  // A varint ends with its only byte that has the high bit clear, so counting
+  // those bytes, in a loop that the compiler vectorizes, gives the number of
+  // values. The output is then resized once and the values are decoded
+  // straight into it, instead of being bounds-checked one by one.
+  template <typename Result>
+  static bool ParsePackedVarints(const uint8* data, uint32 length,
+                                 Result* int64_list) {
+    if (data[length - 1] & 0x80) return false;  // Truncated varint.
+    size_t count = 0;
+    for (uint32 i = 0; i < length; ++i) count += (data[i] & 0x80) == 0;
+
+    // The output may be smaller than requested for a LimitedArraySlice, in
+    // which case the extra values are decoded but dropped.
+    const size_t initial_size = int64_list->size();
+    int64_list->resize(initial_size + count);
+    const size_t available = int64_list->size() - initial_size;
+    auto* out = int64_list->data() + initial_size;
+    for (size_t i = 0; i < count; ++i) {
+      uint64 n = 0;
+      for (int shift = 0;; shift += 7) {
+        if (shift > 63) return false;  // Varint longer than 10 bytes.
+        const uint8 byte = *data++;
+        n |= static_cast<uint64>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) break;
+      }
+      if (i < available) out[i] = static_cast<int64_t>(n);
+    }
+    return true;
+  }
+
   // TODO(lew): Pair of uint8* would be more natural.
   StringPiece serialized_;
 };
@@ -71,12 +71,15 @@ static const int kBufferSize = 1024 * 1024;
 // bundle.
 const char* const kHeaderEntryKey = "";
 
-// The size threshold for multi-threaded tensor loading.
-const int64_t kLargeTensorThreshold = static_cast<int64_t>(1) << 32;
+// The size threshold for multi-threaded tensor loading. A single sequential
+// read is far from saturating the bandwidth of parallel file systems and
+// NVMe drives, so tensors are split into concurrent reads well before they
+// reach gigabytes.
+const int64_t kLargeTensorThreshold = static_cast<int64_t>(1) << 28;
 // Maximum number of threads to load the tensor from the file.
 const int kMaxFileReadThreads = 8;
 // Minimum size of a file section handled by each thread.
-const int64_t kMinSectionSize = static_cast<int64_t>(1) << 31;
+const int64_t kMinSectionSize = static_cast<int64_t>(1) << 27;
 
 namespace {
 
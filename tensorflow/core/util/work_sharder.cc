@@ -16,10 +16,16 @@ limitations under the License.
 #include "tensorflow/core/util/work_sharder.h"
 
 #include <algorithm>
+#include <cmath>
 #include <functional>
+#include <memory>
+#include <string>
 
+#include "absl/container/flat_hash_map.h"
 #include "tensorflow/core/platform/blocking_counter.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
 
 namespace tensorflow {
 
@@ -54,6 +60,56 @@ void Shard(int max_parallelism, thread::ThreadPool* workers, int64_t total,
       max_parallelism);
 }
 
+MeasuredCostPerUnit::MeasuredCostPerUnit(int64_t initial_cost_per_unit)
+    : cost_per_unit_(std::max(int64_t{1}, initial_cost_per_unit)) {}
+
+int64_t MeasuredCostPerUnit::Get() const {
+  return std::max<int64_t>(
+      1, std::llround(cost_per_unit_.load(std::memory_order_relaxed)));
+}
+
+void MeasuredCostPerUnit::Record(int64_t total, int64_t elapsed_nanos) {
+  if (total <= 0 || elapsed_nanos <= 0) {
+    return;
+  }
+  // Each measurement has a weight of 1/8 in the average, which follows the
+  // changes of the inputs of the kernel within a few steps. The concurrent
+  // updates may lose measurements, which only delays the average.
+  static constexpr double kWeight = 0.125;
+  const double measured = static_cast<double>(elapsed_nanos) / total;
+  const double previous = cost_per_unit_.load(std::memory_order_relaxed);
+  cost_per_unit_.store(previous + kWeight * (measured - previous),
+                       std::memory_order_relaxed);
+}
+
+MeasuredCostPerUnit* GetMeasuredCostPerUnit(StringPiece key,
+                                            int64_t initial_cost_per_unit) {
+  static mutex* mu = new mutex;
+  static auto* costs TF_GUARDED_BY(mu) =
+      new absl::flat_hash_map<std::string,
+                              std::unique_ptr<MeasuredCostPerUnit>>;
+  mutex_lock l(*mu);
+  std::unique_ptr<MeasuredCostPerUnit>& cost = (*costs)[key];
+  if (cost == nullptr) {
+    cost = std::make_unique<MeasuredCostPerUnit>(initial_cost_per_unit);
+  }
+  return cost.get();
+}
+
+void Shard(int max_parallelism, thread::ThreadPool* workers, int64_t total,
+           MeasuredCostPerUnit* cost_per_unit,
+           std::function<void(int64_t, int64_t)> work) {
+  std::atomic<int64_t> elapsed_nanos(0);
+  Shard(max_parallelism, workers, total, cost_per_unit->Get(),
+        [&work, &elapsed_nanos](int64_t start, int64_t limit) {
+          const uint64 start_nanos = Env::Default()->NowNanos();
+          work(start, limit);
+          elapsed_nanos.fetch_add(Env::Default()->NowNanos() - start_nanos,
+                                  std::memory_order_relaxed);
+        });
+  cost_per_unit->Record(total, elapsed_nanos.load());
+}
+
 // DEPRECATED: Prefer threadpool->ParallelFor with SchedulingStrategy, which
 // allows you to specify the strategy for choosing shard sizes, including using
 // a fixed shard size.
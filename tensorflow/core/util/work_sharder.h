@@ -16,9 +16,11 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_UTIL_WORK_SHARDER_H_
 #define TENSORFLOW_CORE_UTIL_WORK_SHARDER_H_
 
+#include <atomic>
 #include <functional>
 
 #include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/platform/stringpiece.h"
 #include "tensorflow/core/platform/types.h"
 
 namespace tensorflow {
@@ -59,6 +61,39 @@ namespace tensorflow {
 void Shard(int max_parallelism, thread::ThreadPool* workers, int64_t total,
            int64_t cost_per_unit, std::function<void(int64_t, int64_t)> work);
 
+// Estimates the cost per unit of a work from the time its units take to run,
+// for the kernels whose static estimate is unreliable. The estimate, in
+// nanoseconds, is a moving average of the measured costs, which starts at
+// the static estimate.
+//
+// The methods are thread-safe.
+class MeasuredCostPerUnit {
+ public:
+  explicit MeasuredCostPerUnit(int64_t initial_cost_per_unit);
+
+  // Returns the current estimate, which is at least 1.
+  int64_t Get() const;
+
+  // Records that `total` units took `elapsed_nanos`, summed over the shards.
+  void Record(int64_t total, int64_t elapsed_nanos);
+
+ private:
+  std::atomic<double> cost_per_unit_;
+};
+
+// Returns the process-wide estimate of the work `key`, created from
+// `initial_cost_per_unit` on the first call. The key should name the kernel
+// and the data type, e.g. "Softplus/float", since the cost depends on both.
+// The callers should look the estimate up once and keep it.
+MeasuredCostPerUnit* GetMeasuredCostPerUnit(StringPiece key,
+                                            int64_t initial_cost_per_unit);
+
+// Same as Shard() above with the current estimate of `cost_per_unit`, which
+// also records the time the shards take.
+void Shard(int max_parallelism, thread::ThreadPool* workers, int64_t total,
+           MeasuredCostPerUnit* cost_per_unit,
+           std::function<void(int64_t, int64_t)> work);
+
 // Each thread has an associated option to express the desired maximum
 // parallelism. Its default is a very large quantity.
 //
@@ -93,6 +93,45 @@ TEST(Shard, OverflowTest) {
   }
 }
 
+TEST(Shard, MeasuredCostPerUnit) {
+  MeasuredCostPerUnit cost(/*initial_cost_per_unit=*/1000);
+  EXPECT_EQ(cost.Get(), 1000);
+  // Moves toward the measured cost of 10ns per unit.
+  for (int i = 0; i < 100; ++i) {
+    cost.Record(/*total=*/100, /*elapsed_nanos=*/1000);
+  }
+  EXPECT_EQ(cost.Get(), 10);
+  // Ignores the empty measurements.
+  cost.Record(/*total=*/0, /*elapsed_nanos=*/1000);
+  cost.Record(/*total=*/100, /*elapsed_nanos=*/0);
+  EXPECT_EQ(cost.Get(), 10);
+  EXPECT_EQ(MeasuredCostPerUnit(0).Get(), 1);
+}
+
+TEST(Shard, GetMeasuredCostPerUnit) {
+  MeasuredCostPerUnit* cost = GetMeasuredCostPerUnit("Test/float", 100);
+  EXPECT_EQ(cost->Get(), 100);
+  EXPECT_EQ(GetMeasuredCostPerUnit("Test/float", 200), cost);
+  EXPECT_NE(GetMeasuredCostPerUnit("Test/double", 100), cost);
+}
+
+TEST(Shard, ShardWithMeasuredCostPerUnit) {
+  thread::ThreadPool threads(Env::Default(), "test", 4);
+  MeasuredCostPerUnit cost(/*initial_cost_per_unit=*/1);
+  const int64_t total = 1000;
+  std::atomic<int64_t> num_elements(0);
+  Shard(4, &threads, total, &cost,
+        [&num_elements](int64_t start, int64_t limit) {
+          for (int64_t i = start; i < limit; ++i) {
+            Env::Default()->SleepForMicroseconds(10);
+            ++num_elements;
+          }
+        });
+  EXPECT_EQ(num_elements.load(), total);
+  // The shards took at least 10us per unit, of which the average has 1/8.
+  EXPECT_GE(cost.Get(), 1000);
+}
+
 void BM_Sharding(::testing::benchmark::State& state) {
   const int arg = state.range(0);
 
@@ -29,9 +29,11 @@ limitations under the License.
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
 #include "llvm/Support/Casting.h"
+#include "tensorflow/c/eager/c_api_experimental.h"
 #include "tensorflow/c/eager/c_api_internal.h"
 #include "tensorflow/c/eager/parallel_device/parallel_device_lib.h"
 #include "tensorflow/c/eager/tfe_tensorhandle_internal.h"
+#include "tensorflow/c/safe_ptr.h"
 #include "tensorflow/c/tf_datatype.h"
 #include "tensorflow/c/tf_status.h"
 #include "tensorflow/c/tf_status_helper.h"
@@ -46,9 +48,13 @@ limitations under the License.
 #include "tensorflow/core/framework/types.pb.h"
 #include "tensorflow/core/graph/graph.h"
 #include "tensorflow/core/lib/strings/proto_serialization.h"
+#include "tensorflow/core/platform/blocking_counter.h"
+#include "tensorflow/core/platform/cpu_info.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/fingerprint.h"
 #include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/platform/threadpool.h"
 #include "tensorflow/core/public/version.h"
 #include "tensorflow/dtensor/cc/constants.h"
 #include "tensorflow/dtensor/cc/dstatus.h"
@@ -66,6 +72,31 @@ struct FunctionArgument {
   NodeDefBuilder::NodeOut output;
 };
 
+// Tensors of at least this many bytes are copied to the local devices of a
+// mesh concurrently. Smaller copies take less time than the hops to the pool.
+constexpr int64_t kParallelBroadcastMinBytes = 1 << 16;
+
+thread::ThreadPool* BroadcastThreadPool() {
+  static thread::ThreadPool* pool = new thread::ThreadPool(
+      Env::Default(), "dtensor_broadcast", port::MaxParallelism());
+  return pool;
+}
+
+// Returns true if the copies of `tensor` to `num_local_devices` devices are
+// worth issuing concurrently. Copies on an async executor only enqueue nodes,
+// so they are issued from the calling thread.
+bool ShouldBroadcastInParallel(TFE_TensorHandle* tensor, int num_local_devices,
+                               TFE_Executor* executor) {
+  if (num_local_devices <= 1 || TFE_ExecutorIsAsync(executor)) return false;
+  std::unique_ptr<TF_Status, decltype(&TF_DeleteStatus)> status(
+      TF_NewStatus(), TF_DeleteStatus);
+  const int64_t num_elements =
+      TFE_TensorHandleNumElements(tensor, status.get());
+  if (TF_GetCode(status.get()) != TF_OK) return false;
+  return num_elements * TF_DataTypeSize(TFE_TensorHandleDataType(tensor)) >=
+         kParallelBroadcastMinBytes;
+}
+
 std::vector<TensorHandlePtr> BroadcastTensorHandleToParallelTensor(
     TFE_Context* context, TFE_TensorHandle* tensor, const Mesh& target_mesh,
     TF_Status* status) {
@@ -73,18 +104,46 @@ std::vector<TensorHandlePtr> BroadcastTensorHandleToParallelTensor(
   absl::Span<const std::string> local_devices = target_mesh.local_devices();
   const int num_local_devices = local_devices.size();
 
-  std::vector<TensorHandlePtr> components;
-  components.reserve(num_local_devices);
+  std::vector<TensorHandlePtr> components(num_local_devices);
+  std::vector<Safe_TF_StatusPtr> copy_statuses;
+  copy_statuses.reserve(num_local_devices);
+  for (int i = 0; i < num_local_devices; ++i) {
+    copy_statuses.push_back(make_safe(TF_NewStatus()));
+  }
+  // Create tensor copies to each local devices specifie by `target_mesh`.
+  auto copy_to_device = [&](int i) {
+    components[i].reset(TFE_TensorHandleCopyToDevice(
+        tensor, context, local_devices[i].c_str(), copy_statuses[i].get()));
+  };
+
+  std::unique_ptr<TFE_Executor, decltype(&TFE_DeleteExecutor)> executor(
+      TFE_ContextGetExecutorForThread(context), TFE_DeleteExecutor);
+  if (ShouldBroadcastInParallel(tensor, num_local_devices, executor.get())) {
+    // A sync executor blocks on every copy, so the copies are issued from
+    // the threads of the pool, on the executor of the calling thread.
+    BlockingCounter counter(num_local_devices);
+    for (int i = 0; i < num_local_devices; ++i) {
+      BroadcastThreadPool()->Schedule([&, i]() {
+        TFE_ContextSetExecutorForThread(context, executor.get());
+        copy_to_device(i);
+        counter.DecrementCount();
+      });
+    }
+    counter.Wait();
+  } else {
+    for (int i = 0; i < num_local_devices; ++i) {
+      copy_to_device(i);
+      if (TF_GetCode(copy_statuses[i].get()) != TF_OK) break;
+    }
+  }
+
   for (int i = 0; i < num_local_devices; ++i) {
-    // Create tensor copies to each local devices specifie by `target_mesh`.
-    components.emplace_back(TFE_TensorHandleCopyToDevice(
-        tensor, context, local_devices[i].c_str(), status));
-    if (TF_GetCode(status) != TF_OK) {
+    if (TF_GetCode(copy_statuses[i].get()) != TF_OK) {
       TF_SetStatus(
           status, TF_INTERNAL,
           absl::StrCat(
               "Unable to copy tensor value for broadcast. Original message: ",
-              TF_Message(status))
+              TF_Message(copy_statuses[i].get()))
               .c_str());
       return {};
     }
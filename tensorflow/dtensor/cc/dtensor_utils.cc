@@ -157,5 +157,12 @@ int AllReduceCombineOptimizationGroupSize() {
                   "using the default value 0.";
   return 0;
 }
+
+bool EnableCollectiveScheduling() {
+  char* dtensor_enable_collective_scheduling_str =
+      std::getenv("DTENSOR_ENABLE_COLLECTIVE_SCHEDULING");
+  if (dtensor_enable_collective_scheduling_str == nullptr) return false;
+  return true;
+}
 }  // namespace dtensor
 }  // namespace tensorflow
@@ -68,6 +68,10 @@ bool EnableAllToAllForRelayout();
 
 // Returns the maximum number of AllReduce ops to merge into a group.
 int AllReduceCombineOptimizationGroupSize();
+
+// Returns whether to move the DTensor collectives up to the point where their
+// inputs are ready, so that they overlap with the computation after them.
+bool EnableCollectiveScheduling();
 }  // namespace dtensor
 }  // namespace tensorflow
 
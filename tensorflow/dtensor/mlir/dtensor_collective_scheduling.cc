@@ -0,0 +1,114 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <memory>
+
+#include "llvm/ADT/SmallVector.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"  // from @llvm-project
+#include "mlir/IR/Block.h"  // from @llvm-project
+#include "mlir/IR/Operation.h"  // from @llvm-project
+#include "mlir/IR/Value.h"  // from @llvm-project
+#include "mlir/IR/Visitors.h"  // from @llvm-project
+#include "mlir/Pass/Pass.h"  // from @llvm-project
+#include "tensorflow/compiler/mlir/tensorflow/ir/tf_ops.h"
+#include "tensorflow/compiler/mlir/utils/name_utils.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/dtensor/mlir/dtensor_mlir_passes.h"
+#include "tensorflow/dtensor/mlir/ir/tf_dtensor.h"
+
+namespace tensorflow {
+namespace dtensor {
+
+namespace {
+#define GEN_PASS_DEF_DTENSORCOLLECTIVESCHEDULING
+#include "tensorflow/dtensor/mlir/dtensor_passes.h.inc"
+
+bool IsCollective(mlir::Operation* op) {
+  return llvm::isa<mlir::TF::DTensorAllReduceOp,
+                   mlir::TF::DTensorReduceScatterOp,
+                   mlir::TF::DTensorAllGatherOp, mlir::TF::DTensorAllToAllOp>(
+      op);
+}
+
+// Moves the collectives of `block` right after the last producer of their
+// inputs in the block. The constant inputs, such as the group assignments,
+// are moved along with the collective. The collectives keep their relative
+// order, so that all the devices still issue them in the same order.
+void ScheduleCollectives(mlir::Block& block) {
+  llvm::SmallVector<mlir::Operation*, 4> collectives;
+  for (mlir::Operation& op : block) {
+    if (IsCollective(&op)) collectives.push_back(&op);
+  }
+
+  mlir::Operation* previous_collective = nullptr;
+  for (mlir::Operation* collective : collectives) {
+    // The latest op of the block that has to stay before the collective.
+    mlir::Operation* insertion_point = previous_collective;
+    llvm::SmallVector<mlir::Operation*, 2> constants;
+    for (mlir::Value operand : collective->getOperands()) {
+      mlir::Operation* producer = operand.getDefiningOp();
+      if (producer == nullptr) continue;
+      producer = block.findAncestorOpInBlock(*producer);
+      // The operands defined outside of the block are available at its start.
+      if (producer == nullptr) continue;
+      if (llvm::isa<mlir::TF::ConstOp>(producer)) {
+        constants.push_back(producer);
+        continue;
+      }
+      if (insertion_point == nullptr ||
+          insertion_point->isBeforeInBlock(producer)) {
+        insertion_point = producer;
+      }
+    }
+
+    if (insertion_point == nullptr) {
+      if (collective != &block.front()) collective->moveBefore(&block.front());
+    } else if (insertion_point->getNextNode() != collective) {
+      collective->moveAfter(insertion_point);
+    }
+    // Moving a constant earlier keeps all of its uses dominated.
+    for (mlir::Operation* constant : constants) {
+      if (collective->isBeforeInBlock(constant)) {
+        constant->moveBefore(collective);
+      }
+    }
+    VLOG(4) << "Scheduled collective "
+            << mlir::GetNameFromLoc(collective->getLoc());
+    previous_collective = collective;
+  }
+}
+
+// Issues the DTensor collectives as early as their inputs allow, so that the
+// communication overlaps with the computation that does not depend on it.
+// The collectives are side effect free, so the move preserves the semantics.
+struct DTensorCollectiveScheduling
+    : public impl::DTensorCollectiveSchedulingBase<
+          DTensorCollectiveScheduling> {
+  void runOnOperation() override {
+    getOperation().walk([](mlir::Block* block) {
+      ScheduleCollectives(*block);
+    });
+  }
+};
+
+}  // namespace
+
+std::unique_ptr<mlir::OperationPass<mlir::func::FuncOp>>
+CreateDTensorCollectiveSchedulingPass() {
+  return std::make_unique<DTensorCollectiveScheduling>();
+}
+
+}  // namespace dtensor
+}  // namespace tensorflow
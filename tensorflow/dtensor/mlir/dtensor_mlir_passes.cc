@@ -219,6 +219,14 @@ void CreateDTensorMLIRPass(const mlir::TF::StandardPipelineOptions &options,
 
   AddDTensorAllReduceCombineOptimization(pm);
 
+  // Issues the collectives as soon as their inputs are computed, so that the
+  // communication overlaps with the independent computation after them. This
+  // has to run after the combine optimization, which sorts the blocks again.
+  if (EnableCollectiveScheduling()) {
+    pm->addNestedPass<mlir::func::FuncOp>(
+        CreateDTensorCollectiveSchedulingPass());
+  }
+
   // DTensorReduceScatter lowering should come before DTensorAllReduce
   // and DTensorAllScatter lowerings since for some devices DTensorReduceScatter
   // will be decomposed into an DTensorAllReduce+DTensorScatter.
@@ -0,0 +1,41 @@
+// RUN: dtensor-opt %s -split-input-file -dtensor-collective-scheduling -verify-diagnostics | FileCheck %s
+
+// Check that a DTensorAllReduce is moved before the computation that does not
+// depend on it, together with its group assignment.
+// CHECK-LABEL: func @main
+func.func @main(%arg0: tensor<4x4xf32>, %arg1: tensor<4x4xf32>) -> (tensor<4x4xf32>, tensor<4x4xf32>) {
+  // CHECK:      %[[PRODUCER:.*]] = "tf.Neg"(%arg0)
+  // CHECK-NEXT: %[[GROUP_ASSIGNMENT:.*]] = "tf.Const"()
+  // CHECK-NEXT: %[[ALL_REDUCE:.*]] = "tf.DTensorAllReduce"(%[[PRODUCER]], %[[GROUP_ASSIGNMENT]])
+  // CHECK-NEXT: %[[MATMUL:.*]] = "tf.MatMul"(%arg1, %arg1)
+  // CHECK-NEXT: "tf.Add"(%[[ALL_REDUCE]], %[[MATMUL]])
+  %0:2 = "tf_device.cluster"() ({
+    %1 = "tf.Neg"(%arg0) : (tensor<4x4xf32>) -> tensor<4x4xf32>
+    %2 = "tf.MatMul"(%arg1, %arg1) : (tensor<4x4xf32>, tensor<4x4xf32>) -> tensor<4x4xf32>
+    %3 = "tf.Const"() {value = dense<[[0, 1], [2, 3]]> : tensor<2x2xi32>} : () -> tensor<2x2xi32>
+    %4 = "tf.DTensorAllReduce"(%1, %3) {_layout = ["sharding_specs:x,y, mesh:|x=2,y=2|*GPU"], device_type = "GPU", reduce_op = "Add"} : (tensor<4x4xf32>, tensor<2x2xi32>) -> tensor<4x4xf32>
+    %5 = "tf.Add"(%4, %2) : (tensor<4x4xf32>, tensor<4x4xf32>) -> tensor<4x4xf32>
+    tf_device.return %5, %2 : tensor<4x4xf32>, tensor<4x4xf32>
+  }) {_mesh = "|x=2,y=2|*GPU"} : () -> (tensor<4x4xf32>, tensor<4x4xf32>)
+  func.return %0#0, %0#1 : tensor<4x4xf32>, tensor<4x4xf32>
+}
+
+// -----
+
+// Check that collectives keep their relative order when they are moved.
+// CHECK-LABEL: func @main
+func.func @main(%arg0: tensor<4x4xf32>, %arg1: tensor<4x4xf32>) -> (tensor<4x4xf32>, tensor<4x4xf32>) {
+  // CHECK:      %[[GROUP_ASSIGNMENT:.*]] = "tf.Const"()
+  // CHECK-NEXT: %[[ALL_REDUCE_1:.*]] = "tf.DTensorAllReduce"(%arg0, %[[GROUP_ASSIGNMENT]])
+  // CHECK-NEXT: %[[ALL_REDUCE_2:.*]] = "tf.DTensorAllReduce"(%arg1, %[[GROUP_ASSIGNMENT]])
+  // CHECK-NEXT: "tf.Neg"(%arg0)
+  %0:2 = "tf_device.cluster"() ({
+    %1 = "tf.Neg"(%arg0) : (tensor<4x4xf32>) -> tensor<4x4xf32>
+    %2 = "tf.Const"() {value = dense<[[0, 1], [2, 3]]> : tensor<2x2xi32>} : () -> tensor<2x2xi32>
+    %3 = "tf.DTensorAllReduce"(%arg0, %2) {_layout = ["sharding_specs:x,y, mesh:|x=2,y=2|*GPU"], device_type = "GPU", reduce_op = "Add"} : (tensor<4x4xf32>, tensor<2x2xi32>) -> tensor<4x4xf32>
+    %4 = "tf.DTensorAllReduce"(%arg1, %2) {_layout = ["sharding_specs:x,y, mesh:|x=2,y=2|*GPU"], device_type = "GPU", reduce_op = "Add"} : (tensor<4x4xf32>, tensor<2x2xi32>) -> tensor<4x4xf32>
+    %5 = "tf.Add"(%3, %1) : (tensor<4x4xf32>, tensor<4x4xf32>) -> tensor<4x4xf32>
+    tf_device.return %5, %4 : tensor<4x4xf32>, tensor<4x4xf32>
+  }) {_mesh = "|x=2,y=2|*GPU"} : () -> (tensor<4x4xf32>, tensor<4x4xf32>)
+  func.return %0#0, %0#1 : tensor<4x4xf32>, tensor<4x4xf32>
+}
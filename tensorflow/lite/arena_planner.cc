@@ -18,6 +18,7 @@ limitations under the License.
 
 #include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <limits>
 #include <memory>
 #include <utility>
@@ -34,6 +35,7 @@ constexpr int32_t kLastActiveNodeUndefined =
     std::numeric_limits<int32_t>::max();
 constexpr int32_t kNodeNotAssigned = std::numeric_limits<int32_t>::max();
 constexpr int32_t kScalarTensorBytes = 4;
+constexpr size_t kMaxCachedPlans = 8;
 
 ArenaPlanner::ArenaPlanner(TfLiteContext* context,
                            std::unique_ptr<GraphInfo> graph_info,
@@ -45,7 +47,8 @@ ArenaPlanner::ArenaPlanner(TfLiteContext* context,
       persistent_arena_(kDefaultArenaAlignment, subgraph_index),
       preserve_all_tensors_(preserve_all_tensors),
       tensor_alignment_(tensor_alignment),
-      last_active_node_(kLastActiveNodeUndefined) {}
+      last_active_node_(kLastActiveNodeUndefined),
+      subgraph_index_(subgraph_index) {}
 
 ArenaPlanner::~ArenaPlanner() {
   arena_.ReleaseBuffer();
@@ -62,6 +65,30 @@ std::intptr_t ArenaPlanner::BasePointer(TfLiteAllocationType type) {
   return 0;
 }
 
+TfLiteStatus ArenaPlanner::SetOfflineMemoryAllocation(const char* data,
+                                                       size_t bytes) {
+  constexpr int kNumHeaderFields = 3;
+  TF_LITE_ENSURE(context_, bytes % sizeof(int32_t) == 0);
+  std::vector<int32_t> fields(bytes / sizeof(int32_t));
+  TF_LITE_ENSURE(context_, fields.size() >= kNumHeaderFields);
+  std::memcpy(fields.data(), data, bytes);
+  TF_LITE_ENSURE_EQ(context_, fields[0], kOfflineMemoryAllocationVersion);
+  if (fields[1] != subgraph_index_) {
+    return kTfLiteOk;
+  }
+  const int32_t num_tensors = fields[2];
+  TF_LITE_ENSURE(context_, num_tensors >= 0 &&
+                               num_tensors <= graph_info_->num_tensors() &&
+                               num_tensors + kNumHeaderFields == fields.size());
+  for (int i = kNumHeaderFields; i < fields.size(); ++i) {
+    TF_LITE_ENSURE(context_,
+                   fields[i] >= kOfflineMemoryAllocationOnlinePlanned);
+  }
+  offline_offsets_.assign(fields.begin() + kNumHeaderFields, fields.end());
+  cached_plans_.clear();
+  return kTfLiteOk;
+}
+
 TfLiteStatus ArenaPlanner::ResetAllocations() {
   TF_LITE_ENSURE_STATUS(arena_.ClearPlan());
   TF_LITE_ENSURE_STATUS(persistent_arena_.ClearPlan());
@@ -212,6 +239,7 @@ TfLiteStatus ArenaPlanner::PlanAllocations() {
   // Invalidate any existing data.
   const size_t num_tensors = graph_info_->num_tensors();
   TF_LITE_ENSURE_STATUS(ResetAllocations());
+  cached_plans_.clear();
   // Maybe other verb instead of 'Assigned'
   alloc_node_.assign(num_tensors, kNodeNotAssigned);
   dealloc_node_.assign(num_tensors, kNodeNotAssigned);
@@ -470,6 +498,23 @@ void ArenaPlanner::CreateTensorAllocationVector(
   // Indices of tensors in order their allocation offsets will be calculated.
   std::sort(tensors_to_allocate->begin(), tensors_to_allocate->end(),
             tensor_compare);
+  // Tensors planned offline are placed first, so that the tensors planned at
+  // runtime fill the gaps around them.
+  if (!offline_offsets_.empty()) {
+    std::stable_partition(tensors_to_allocate->begin(),
+                          tensors_to_allocate->end(), [&](int idx) {
+                            return OfflineOffset(idx) !=
+                                   kOfflineMemoryAllocationOnlinePlanned;
+                          });
+  }
+}
+
+int32_t ArenaPlanner::OfflineOffset(int tensor_index) const {
+  if (tensor_index >= offline_offsets_.size() ||
+      graph_info_->tensors()[tensor_index].allocation_type != kTfLiteArenaRw) {
+    return kOfflineMemoryAllocationOnlinePlanned;
+  }
+  return offline_offsets_[tensor_index];
 }
 
 std::vector<int32_t> ArenaPlanner::GetTensorsToAllocate(int first_node,
@@ -510,6 +555,14 @@ TfLiteStatus ArenaPlanner::CalculateAllocations(
     last_active_node_ = last_node;
     return kTfLiteOk;
   }
+  // Only the plans computed from scratch, i.e. right after ResetAllocations,
+  // are cached.
+  std::vector<int64_t> plan_signature;
+  const CachedPlan* cached_plan = nullptr;
+  if (first_node == 0 && last_active_node_ == kLastActiveNodeUndefined) {
+    plan_signature = PlanSignature(last_node, *tensors_allocated);
+    cached_plan = FindCachedPlan(plan_signature);
+  }
   if (first_node < last_active_node_) {
     arena_.ResetAllocs();
     last_active_node_ = first_node;
@@ -518,7 +571,14 @@ TfLiteStatus ArenaPlanner::CalculateAllocations(
     // exection faster.
     arena_.PurgeActiveAllocs(first_node);
   }
-  CreateTensorAllocationVector(tensors_allocated);
+  if (cached_plan != nullptr) {
+    for (const ArenaAllocWithUsageInterval& alloc : cached_plan->allocs) {
+      allocs_[alloc.tensor] = alloc;
+    }
+    arena_.RestoreAllocs(cached_plan->allocs);
+  } else {
+    CreateTensorAllocationVector(tensors_allocated);
+  }
   // Vector of ids of already allocated tensors, ordered by offset.
   for (const auto& tensor_index : *tensors_allocated) {
     TfLiteTensor& tensor = tensors[tensor_index];
@@ -541,7 +601,15 @@ TfLiteStatus ArenaPlanner::CalculateAllocations(
         continue;
       }
     }
-    if (tensor.allocation_type == kTfLiteArenaRw) {
+    if (tensor.allocation_type == kTfLiteArenaRw && cached_plan == nullptr) {
+      const int32_t offline_offset = OfflineOffset(tensor_index);
+      if (offline_offset != kOfflineMemoryAllocationOnlinePlanned &&
+          arena_.AllocateAt(tensor_alignment_, offline_offset, tensor.bytes,
+                            tensor_index, alloc_node_[tensor_index],
+                            dealloc_node_[tensor_index],
+                            &allocs_[tensor_index])) {
+        continue;
+      }
       TF_LITE_ENSURE_STATUS(
           arena_.Allocate(context_, tensor_alignment_, tensor.bytes,
                           tensor_index, alloc_node_[tensor_index],
@@ -560,10 +628,60 @@ TfLiteStatus ArenaPlanner::CalculateAllocations(
       }
     }
   }
+  if (!plan_signature.empty() && cached_plan == nullptr) {
+    CachePlan(std::move(plan_signature), *tensors_allocated);
+  }
   last_active_node_ = last_node;
   return kTfLiteOk;
 }
 
+std::vector<int64_t> ArenaPlanner::PlanSignature(
+    int last_node, const std::vector<int32_t>& tensors_allocated) {
+  const TfLiteTensor* tensors = graph_info_->tensors();
+  std::vector<int64_t> signature;
+  signature.reserve(1 + 6 * tensors_allocated.size());
+  signature.push_back(last_node);
+  for (int32_t tensor_index : tensors_allocated) {
+    signature.push_back(tensor_index);
+    signature.push_back(tensors[tensor_index].bytes);
+    signature.push_back(tensors[tensor_index].allocation_type);
+    signature.push_back(alloc_node_[tensor_index]);
+    signature.push_back(dealloc_node_[tensor_index]);
+    signature.push_back(FindSharedTensor(tensor_index));
+  }
+  return signature;
+}
+
+const ArenaPlanner::CachedPlan* ArenaPlanner::FindCachedPlan(
+    const std::vector<int64_t>& signature) {
+  for (auto it = cached_plans_.begin(); it != cached_plans_.end(); ++it) {
+    if (it->signature == signature) {
+      // Keep the most recently used plans first.
+      cached_plans_.splice(cached_plans_.begin(), cached_plans_, it);
+      return &cached_plans_.front();
+    }
+  }
+  return nullptr;
+}
+
+void ArenaPlanner::CachePlan(std::vector<int64_t> signature,
+                             const std::vector<int32_t>& tensors_allocated) {
+  const TfLiteTensor* tensors = graph_info_->tensors();
+  CachedPlan plan;
+  plan.signature = std::move(signature);
+  for (int32_t tensor_index : tensors_allocated) {
+    if (tensors[tensor_index].allocation_type == kTfLiteArenaRw &&
+        actual_tensor_id_.find(tensor_index) == actual_tensor_id_.end()) {
+      plan.allocs.push_back(allocs_[tensor_index]);
+    }
+  }
+  std::sort(plan.allocs.begin(), plan.allocs.end());
+  cached_plans_.push_front(std::move(plan));
+  if (cached_plans_.size() > kMaxCachedPlans) {
+    cached_plans_.pop_back();
+  }
+}
+
 bool AreTensorsAllocatedInSameArena(int32_t root_tensor_index,
                                     int32_t tensor_index,
                                     const TfLiteTensor* tensors) {
@@ -16,6 +16,7 @@ limitations under the License.
 #define TENSORFLOW_LITE_ARENA_PLANNER_H_
 
 #include <cstdint>
+#include <list>
 #include <memory>
 #include <unordered_map>
 #include <unordered_set>
@@ -30,6 +31,15 @@ limitations under the License.
 namespace tflite {
 
 constexpr const int kDefaultArenaAlignment = 64;
+
+// The key of the model metadata holding arena offsets planned offline, in the
+// same format as the one used by TFLite Micro: a little-endian int32 array
+// [version, subgraph index, number of tensors, offset of each tensor...], where
+// an offset of -1 lets the tensor be planned at runtime.
+constexpr char kOfflineMemoryAllocationMetadataKey[] =
+    "OfflineMemoryAllocation";
+constexpr int32_t kOfflineMemoryAllocationVersion = 1;
+constexpr int32_t kOfflineMemoryAllocationOnlinePlanned = -1;
 struct AllocationInfo;
 
 // A memory planner that makes all the allocations using arenas.
@@ -72,6 +82,15 @@ class ArenaPlanner : public MemoryPlanner {
   // Returns the base arena location for a given allocation type.
   std::intptr_t BasePointer(TfLiteAllocationType type);
 
+  // Sets the arena offsets planned offline, from the content of the
+  // kOfflineMemoryAllocationMetadataKey model metadata. The buffer is ignored
+  // if it is for another subgraph. The kTfLiteArenaRw tensors with an offline
+  // offset are placed at it, unless it conflicts with their current size or
+  // lifetime, e.g. after an input was resized, in which case they are planned
+  // at runtime like the other tensors. Must be called before
+  // ExecuteAllocations.
+  TfLiteStatus SetOfflineMemoryAllocation(const char* data, size_t bytes);
+
  private:
   // Check whether the input tensor's memory may be shared the output tensor.
   // tensor_changed: true if the output tensor modifies the tensor data. For
@@ -120,6 +139,32 @@ class ArenaPlanner : public MemoryPlanner {
   // Return the index of the tensor owing `tensor_index's` buffer.
   int FindSharedTensor(int tensor_index);
 
+  // The allocations of the kTfLiteArenaRw tensors computed by
+  // CalculateAllocations from scratch, which only depend on the signature.
+  struct CachedPlan {
+    std::vector<int64_t> signature;
+    // Sorted by offset.
+    std::vector<ArenaAllocWithUsageInterval> allocs;
+  };
+
+  // Returns what the allocations computed by CalculateAllocations for
+  // `tensors_allocated` depend on: the sizes, allocation types, lifetimes and
+  // buffer sharing of the tensors.
+  std::vector<int64_t> PlanSignature(
+      int last_node, const std::vector<int32_t>& tensors_allocated);
+
+  // Returns the cached plan with `signature`, or nullptr.
+  const CachedPlan* FindCachedPlan(const std::vector<int64_t>& signature);
+
+  // Caches the allocations just computed for `tensors_allocated`, evicting the
+  // least recently used plan if there are too many.
+  void CachePlan(std::vector<int64_t> signature,
+                 const std::vector<int32_t>& tensors_allocated);
+
+  // Returns the arena offset planned offline for `tensor_index`, or
+  // kOfflineMemoryAllocationOnlinePlanned.
+  int32_t OfflineOffset(int tensor_index) const;
+
   TfLiteContext* context_;
   std::unique_ptr<GraphInfo> graph_info_;
 
@@ -164,6 +209,19 @@ class ArenaPlanner : public MemoryPlanner {
 
   // Store number of references to each tensor.
   std::vector<int> refcounts_;
+
+  // Index of the subgraph whose tensors are planned.
+  int subgraph_index_;
+
+  // The plans of the most recently seen tensor sizes, e.g. for the different
+  // shapes of a resized input, most recently used first. Switching back to
+  // these sizes restores the plan instead of computing it again. The arena
+  // buffer itself only grows, so it is reused as is.
+  std::list<CachedPlan> cached_plans_;
+
+  // Arena offset planned offline for each tensor, or
+  // kOfflineMemoryAllocationOnlinePlanned. Empty if there is no offline plan.
+  std::vector<int32_t> offline_offsets_;
 };
 
 }  // namespace tflite
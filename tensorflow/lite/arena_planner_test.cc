@@ -21,6 +21,7 @@ limitations under the License.
 #include <initializer_list>
 #include <memory>
 #include <set>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -407,6 +408,149 @@ TEST_F(ArenaPlannerTest, SimpleGraphWithTemporary) {
   EXPECT_EQ(GetOffset(1), 4);
 }
 
+// Returns the content of the kOfflineMemoryAllocationMetadataKey metadata.
+std::string OfflineMemoryAllocation(int32_t subgraph_index,
+                                    const std::vector<int32_t>& offsets) {
+  std::vector<int32_t> fields = {kOfflineMemoryAllocationVersion,
+                                 subgraph_index,
+                                 static_cast<int32_t>(offsets.size())};
+  fields.insert(fields.end(), offsets.begin(), offsets.end());
+  return std::string(reinterpret_cast<const char*>(fields.data()),
+                     fields.size() * sizeof(int32_t));
+}
+
+TEST_F(ArenaPlannerTest, SimpleGraphWithOfflinePlan) {
+  TestGraph graph({0, 1},
+                  {
+                      /* in, out, tmp */
+                      {{0, 1}, {2}, {}},     // First op
+                      {{2, 0}, {4, 5}, {}},  // Second op
+                      {{4, 5}, {3}, {}}      // Third op
+                  },
+                  {3});
+  SetGraph(&graph);
+  const std::string offline_plan =
+      OfflineMemoryAllocation(0, {-1, -1, 64, -1, 0, 16});
+  ASSERT_EQ(planner_->SetOfflineMemoryAllocation(offline_plan.data(),
+                                                 offline_plan.size()),
+            kTfLiteOk);
+  Execute(0, graph.nodes().size() - 1);
+
+  EXPECT_EQ(GetOffset(2), 64);
+  EXPECT_EQ(GetOffset(4), 0);
+  EXPECT_EQ(GetOffset(5), 16);
+  // The tensors planned at runtime don't overlap the ones planned offline.
+  EXPECT_EQ(GetOffset(0), GetOffsetAfter(5));
+  EXPECT_EQ(GetOffset(1), GetOffsetAfter(0));
+  EXPECT_EQ(GetOffset(3), GetOffsetAfter(1));
+}
+
+TEST_F(ArenaPlannerTest, OfflinePlanConflictsArePlannedAtRuntime) {
+  TestGraph graph({0, 1},
+                  {
+                      /* in, out, tmp */
+                      {{0, 1}, {2}, {}},     // First op
+                      {{2, 0}, {4, 5}, {}},  // Second op
+                      {{4, 5}, {3}, {}}      // Third op
+                  },
+                  {3});
+  SetGraph(&graph);
+  // Tensors 4 and 5 are alive at the same time, and tensor 2 isn't aligned.
+  const std::string offline_plan =
+      OfflineMemoryAllocation(0, {-1, -1, 2, -1, 0, 0});
+  ASSERT_EQ(planner_->SetOfflineMemoryAllocation(offline_plan.data(),
+                                                 offline_plan.size()),
+            kTfLiteOk);
+  Execute(0, graph.nodes().size() - 1);
+
+  EXPECT_EQ(GetOffset(5), 0);
+  EXPECT_GE(GetOffset(4), GetOffsetAfter(5));
+  EXPECT_EQ(GetOffset(2) % kTensorAlignment, 0);
+}
+
+TEST_F(ArenaPlannerTest, OfflinePlanOfOtherSubgraphIsIgnored) {
+  TestGraph graph({0, 1},
+                  {
+                      /* in, out, tmp */
+                      {{0, 1}, {2}, {}},     // First op
+                      {{2, 0}, {4, 5}, {}},  // Second op
+                      {{4, 5}, {3}, {}}      // Third op
+                  },
+                  {3});
+  SetGraph(&graph);
+  const std::string offline_plan =
+      OfflineMemoryAllocation(1, {-1, -1, 64, -1, 0, 16});
+  ASSERT_EQ(planner_->SetOfflineMemoryAllocation(offline_plan.data(),
+                                                 offline_plan.size()),
+            kTfLiteOk);
+  Execute(0, graph.nodes().size() - 1);
+
+  // Same offsets as SimpleGraph.
+  EXPECT_EQ(GetOffset(5), 12);
+  EXPECT_EQ(GetOffset(4), GetOffsetAfter(5));
+  EXPECT_EQ(GetOffset(2), GetOffsetAfter(4));
+  EXPECT_EQ(GetOffset(1), 4);
+}
+
+TEST_F(ArenaPlannerTest, InvalidOfflinePlan) {
+  TestGraph graph({0, 1}, {{{0, 1}, {2}, {}}}, {2});
+  SetGraph(&graph);
+  // Too many offsets.
+  std::string offline_plan = OfflineMemoryAllocation(0, {-1, -1, -1, -1});
+  EXPECT_EQ(planner_->SetOfflineMemoryAllocation(offline_plan.data(),
+                                                 offline_plan.size()),
+            kTfLiteError);
+  // Not a whole number of int32.
+  offline_plan = OfflineMemoryAllocation(0, {-1}) + "x";
+  EXPECT_EQ(planner_->SetOfflineMemoryAllocation(offline_plan.data(),
+                                                 offline_plan.size()),
+            kTfLiteError);
+  // Invalid offset.
+  offline_plan = OfflineMemoryAllocation(0, {-2});
+  EXPECT_EQ(planner_->SetOfflineMemoryAllocation(offline_plan.data(),
+                                                 offline_plan.size()),
+            kTfLiteError);
+}
+
+TEST_F(ArenaPlannerTest, ResizedTensorsReusePreviousPlan) {
+  TestGraph graph({0, 1},
+                  {
+                      /* in, out, tmp */
+                      {{0, 1}, {2}, {}},     // First op
+                      {{2, 0}, {4, 5}, {}},  // Second op
+                      {{4, 5}, {3}, {}}      // Third op
+                  },
+                  {3});
+  SetGraph(&graph);
+  Execute(0, graph.nodes().size() - 1);
+  std::vector<std::ptrdiff_t> offsets;
+  for (int i = 0; i < graph.tensors()->size(); ++i) {
+    offsets.push_back(GetOffset(i));
+  }
+
+  // Grow the input, as for a new shape.
+  (*graph.tensors())[0].bytes = 40;
+  (*graph.tensors())[2].bytes = 40;
+  ResetAllocations();
+  Execute(0, graph.nodes().size() - 1);
+  EXPECT_NE(GetOffset(1), offsets[1]);
+
+  // Going back to the previous sizes gives the previous plan.
+  (*graph.tensors())[0].bytes = 3;
+  (*graph.tensors())[2].bytes = 9;
+  ResetAllocations();
+  Execute(0, graph.nodes().size() - 1);
+  for (int i = 0; i < graph.tensors()->size(); ++i) {
+    EXPECT_EQ(GetOffset(i), offsets[i]);
+  }
+  // The tensors still must not overlap.
+  EXPECT_EQ(GetOffset(5), 12);
+  EXPECT_EQ(GetOffset(4), GetOffsetAfter(5));
+  EXPECT_EQ(GetOffset(3), GetOffsetAfter(4));
+  EXPECT_EQ(GetOffset(2), GetOffsetAfter(4));
+  EXPECT_EQ(GetOffset(1), 4);
+}
+
 TEST_F(ArenaPlannerTest, SimpleGraphWithInplaceReshape) {
   TestGraph graph({0, 1},
                   {
@@ -0,0 +1,199 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/batching_signature_runner.h"
+
+#include <algorithm>
+#include <chrono>  // NOLINT(build/c++11)
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/logger.h"
+#include "tensorflow/lite/minimal_logging.h"
+#include "tensorflow/lite/signature_runner.h"
+
+namespace tflite {
+
+std::unique_ptr<BatchingSignatureRunner> BatchingSignatureRunner::Create(
+    SignatureRunner* runner, const Options& options) {
+  if (runner == nullptr || options.batch_sizes.empty() ||
+      options.batch_sizes[0] <= 0 ||
+      !std::is_sorted(options.batch_sizes.begin(), options.batch_sizes.end(),
+                      std::less_equal<int>()) ||
+      options.max_wait.count() < 0) {
+    TFLITE_LOG(TFLITE_LOG_ERROR, "Invalid options for batching.");
+    return nullptr;
+  }
+  for (const char* name : runner->input_names()) {
+    const TfLiteTensor* tensor = runner->input_tensor(name);
+    if (tensor->dims->size == 0 || tensor->type == kTfLiteString) {
+      TFLITE_LOG(TFLITE_LOG_ERROR, "Input %s can't be batched.", name);
+      return nullptr;
+    }
+  }
+  return std::unique_ptr<BatchingSignatureRunner>(
+      new BatchingSignatureRunner(runner, options));
+}
+
+BatchingSignatureRunner::BatchingSignatureRunner(SignatureRunner* runner,
+                                                 const Options& options)
+    : runner_(runner), options_(options) {
+  thread_ = std::thread(&BatchingSignatureRunner::BatchLoop, this);
+}
+
+BatchingSignatureRunner::~BatchingSignatureRunner() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  request_cv_.notify_one();
+  thread_.join();
+}
+
+TfLiteStatus BatchingSignatureRunner::Invoke(
+    int batch_size, const std::vector<const void*>& inputs,
+    const std::vector<void*>& outputs) {
+  if (batch_size <= 0 || batch_size > options_.batch_sizes.back()) {
+    TFLITE_LOG(TFLITE_LOG_ERROR,
+               "Batch size %d is not in [1, %d], the allowed range.",
+               batch_size, options_.batch_sizes.back());
+    return kTfLiteError;
+  }
+  if (inputs.size() != runner_->input_size() ||
+      outputs.size() != runner_->output_size()) {
+    TFLITE_LOG(TFLITE_LOG_ERROR,
+               "Expected %d inputs and %d outputs, got %d and %d.",
+               static_cast<int>(runner_->input_size()),
+               static_cast<int>(runner_->output_size()),
+               static_cast<int>(inputs.size()),
+               static_cast<int>(outputs.size()));
+    return kTfLiteError;
+  }
+
+  Request request;
+  request.batch_size = batch_size;
+  request.inputs = &inputs;
+  request.outputs = &outputs;
+  std::unique_lock<std::mutex> lock(mutex_);
+  pending_.push_back(&request);
+  pending_batch_size_ += batch_size;
+  request_cv_.notify_one();
+  done_cv_.wait(lock, [&request] { return request.done; });
+  return request.status;
+}
+
+int64_t BatchingSignatureRunner::num_batches() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_batches_;
+}
+
+void BatchingSignatureRunner::BatchLoop() {
+  const int max_batch_size = options_.batch_sizes.back();
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    request_cv_.wait(lock, [this] { return stop_ || !pending_.empty(); });
+    // The pending requests are still run when stopping.
+    if (pending_.empty()) return;
+    request_cv_.wait_until(
+        lock, std::chrono::steady_clock::now() + options_.max_wait,
+        [this, max_batch_size] {
+          return stop_ || pending_batch_size_ >= max_batch_size;
+        });
+
+    std::vector<Request*> batch;
+    int batch_size = 0;
+    while (!pending_.empty() &&
+           batch_size + pending_.front()->batch_size <= max_batch_size) {
+      batch.push_back(pending_.front());
+      batch_size += pending_.front()->batch_size;
+      pending_batch_size_ -= pending_.front()->batch_size;
+      pending_.pop_front();
+    }
+    const int padded_batch_size = *std::lower_bound(
+        options_.batch_sizes.begin(), options_.batch_sizes.end(), batch_size);
+
+    lock.unlock();
+    const TfLiteStatus status = RunBatch(batch, padded_batch_size);
+    lock.lock();
+    ++num_batches_;
+    for (Request* request : batch) {
+      request->status = status;
+      request->done = true;
+    }
+    done_cv_.notify_all();
+  }
+}
+
+TfLiteStatus BatchingSignatureRunner::RunBatch(
+    const std::vector<Request*>& batch, int batch_size) {
+  TF_LITE_ENSURE_STATUS(PrepareBatchSize(batch_size));
+
+  // Gathers the rows of the requests.
+  const std::vector<const char*>& input_names = runner_->input_names();
+  for (size_t i = 0; i < input_names.size(); ++i) {
+    TfLiteTensor* tensor = runner_->input_tensor(input_names[i]);
+    const size_t row_bytes = tensor->bytes / batch_size;
+    char* data = tensor->data.raw;
+    for (const Request* request : batch) {
+      const size_t bytes = request->batch_size * row_bytes;
+      std::memcpy(data, (*request->inputs)[i], bytes);
+      data += bytes;
+    }
+    std::memset(data, 0, tensor->data.raw + tensor->bytes - data);
+  }
+
+  TF_LITE_ENSURE_STATUS(runner_->Invoke());
+
+  // Scatters the rows of the outputs.
+  const std::vector<const char*>& output_names = runner_->output_names();
+  for (size_t i = 0; i < output_names.size(); ++i) {
+    const TfLiteTensor* tensor = runner_->output_tensor(output_names[i]);
+    if (tensor->dims->size == 0 || tensor->dims->data[0] != batch_size ||
+        tensor->type == kTfLiteString) {
+      TFLITE_LOG(TFLITE_LOG_ERROR,
+                 "Output %s doesn't have the batch size of the inputs.",
+                 output_names[i]);
+      return kTfLiteError;
+    }
+    const size_t row_bytes = tensor->bytes / batch_size;
+    const char* data = tensor->data.raw_const;
+    for (const Request* request : batch) {
+      const size_t bytes = request->batch_size * row_bytes;
+      std::memcpy((*request->outputs)[i], data, bytes);
+      data += bytes;
+    }
+  }
+  return kTfLiteOk;
+}
+
+TfLiteStatus BatchingSignatureRunner::PrepareBatchSize(int batch_size) {
+  if (batch_size == current_batch_size_) return kTfLiteOk;
+  for (const char* name : runner_->input_names()) {
+    const TfLiteIntArray* dims = runner_->input_tensor(name)->dims;
+    std::vector<int> new_dims(dims->data, dims->data + dims->size);
+    new_dims[0] = batch_size;
+    TF_LITE_ENSURE_STATUS(runner_->ResizeInputTensor(name, new_dims));
+  }
+  // Reset first, so that the tensors are allocated again after a failure.
+  current_batch_size_ = 0;
+  TF_LITE_ENSURE_STATUS(runner_->AllocateTensors());
+  current_batch_size_ = batch_size;
+  return kTfLiteOk;
+}
+
+}  // namespace tflite
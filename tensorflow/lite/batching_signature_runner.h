@@ -0,0 +1,133 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_BATCHING_SIGNATURE_RUNNER_H_
+#define TENSORFLOW_LITE_BATCHING_SIGNATURE_RUNNER_H_
+
+#include <chrono>              // NOLINT(build/c++11)
+#include <condition_variable>  // NOLINT(build/c++11)
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>   // NOLINT(build/c++11)
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/signature_runner.h"
+
+namespace tflite {
+
+/// WARNING: Experimental interface, subject to change
+///
+/// Runs the requests of several threads through a single SignatureRunner,
+/// gathering them in batches, so that each batch is computed by a single
+/// `Invoke` on the concatenation of the requests along the first (batch)
+/// dimension of every input and output.
+///
+/// The batch dimension of the inputs is resized to the smallest of the allowed
+/// batch sizes that fits the gathered requests, the remaining rows being zero
+/// padded. Keeping the number of batch sizes small lets the interpreter reuse
+/// the memory plans of the batch sizes it has seen.
+///
+/// Usage:
+///
+/// <pre><code>
+/// BatchingSignatureRunner::Options options;
+/// options.batch_sizes = {1, 4, 16};
+/// auto batcher = BatchingSignatureRunner::Create(runner, options);
+///
+/// // From any number of threads:
+/// std::vector<float> x(row_size), y(output_row_size);
+/// batcher->Invoke(/*batch_size=*/1, {x.data()}, {y.data()});
+/// </code></pre>
+///
+/// The model must be such that the rows of the outputs only depend on the
+/// same rows of the inputs, e.g. without any operator reducing over the batch
+/// dimension. Inputs and outputs of type string are not supported.
+///
+/// The wrapped SignatureRunner, and its Interpreter, must outlive the
+/// BatchingSignatureRunner and must not be used directly while it exists.
+class BatchingSignatureRunner {
+ public:
+  struct Options {
+    /// The batch sizes the inputs may be resized to, in increasing order.
+    std::vector<int> batch_sizes = {1, 2, 4, 8, 16, 32};
+    /// How long a batch waits for more requests once its first request
+    /// arrived, unless it reaches the largest batch size first.
+    std::chrono::microseconds max_wait = std::chrono::microseconds(500);
+  };
+
+  /// Returns nullptr if the options are invalid, or if the signature has an
+  /// input of rank 0 or of type string.
+  static std::unique_ptr<BatchingSignatureRunner> Create(
+      SignatureRunner* runner, const Options& options);
+
+  ~BatchingSignatureRunner();
+
+  BatchingSignatureRunner(const BatchingSignatureRunner&) = delete;
+  BatchingSignatureRunner& operator=(const BatchingSignatureRunner&) = delete;
+
+  /// Runs a request of `batch_size` rows and blocks until its outputs are
+  /// written. `inputs` and `outputs` hold the data of the request, in the
+  /// order of the input and output names of the signature, each of them
+  /// being `batch_size` rows laid out contiguously. The size of a row is that
+  /// of the tensor without its first dimension.
+  ///
+  /// Thread safe. Fails if `batch_size` is larger than the largest batch size.
+  TfLiteStatus Invoke(int batch_size, const std::vector<const void*>& inputs,
+                      const std::vector<void*>& outputs);
+
+  /// Returns the number of batches run so far.
+  int64_t num_batches() const;
+
+ private:
+  struct Request {
+    int batch_size;
+    const std::vector<const void*>* inputs;
+    const std::vector<void*>* outputs;
+    bool done = false;
+    TfLiteStatus status = kTfLiteOk;
+  };
+
+  BatchingSignatureRunner(SignatureRunner* runner, const Options& options);
+
+  // Gathers the pending requests in batches and runs them until stopped.
+  void BatchLoop();
+
+  // Runs a batch of requests, whose total batch size fits in `batch_size`.
+  TfLiteStatus RunBatch(const std::vector<Request*>& batch, int batch_size);
+
+  // Resizes the inputs to `batch_size` and allocates the tensors, if needed.
+  TfLiteStatus PrepareBatchSize(int batch_size);
+
+  SignatureRunner* const runner_;
+  const Options options_;
+  // The batch size the inputs currently have, or 0 before the first batch.
+  int current_batch_size_ = 0;
+
+  mutable std::mutex mutex_;
+  std::condition_variable request_cv_;
+  std::condition_variable done_cv_;
+  std::deque<Request*> pending_;
+  int pending_batch_size_ = 0;
+  bool stop_ = false;
+  int64_t num_batches_ = 0;
+  std::thread thread_;
+};
+
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_BATCHING_SIGNATURE_RUNNER_H_
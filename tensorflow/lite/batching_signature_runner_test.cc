@@ -0,0 +1,127 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/batching_signature_runner.h"
+
+#include <chrono>  // NOLINT(build/c++11)
+#include <memory>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "tensorflow/lite/core/interpreter.h"
+#include "tensorflow/lite/core/interpreter_builder.h"
+#include "tensorflow/lite/core/kernels/register.h"
+#include "tensorflow/lite/signature_runner.h"
+#include "tensorflow/lite/testing/util.h"
+
+namespace tflite {
+namespace {
+
+// The "add" signature of the model adds 2 to its input "x", of shape [N].
+class BatchingSignatureRunnerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    model_ = FlatBufferModel::BuildFromFile(
+        "tensorflow/lite/testdata/multi_signatures.bin", &reporter_);
+    ASSERT_TRUE(model_);
+    ops::builtin::BuiltinOpResolver resolver;
+    ASSERT_EQ(InterpreterBuilder(*model_, resolver)(&interpreter_), kTfLiteOk);
+    runner_ = interpreter_->GetSignatureRunner("add");
+    ASSERT_NE(runner_, nullptr);
+  }
+
+  TestErrorReporter reporter_;
+  std::unique_ptr<FlatBufferModel> model_;
+  std::unique_ptr<Interpreter> interpreter_;
+  SignatureRunner* runner_ = nullptr;
+};
+
+TEST_F(BatchingSignatureRunnerTest, RejectsInvalidOptions) {
+  BatchingSignatureRunner::Options options;
+  options.batch_sizes = {};
+  EXPECT_EQ(BatchingSignatureRunner::Create(runner_, options), nullptr);
+  options.batch_sizes = {4, 2};
+  EXPECT_EQ(BatchingSignatureRunner::Create(runner_, options), nullptr);
+  options.batch_sizes = {0, 2};
+  EXPECT_EQ(BatchingSignatureRunner::Create(runner_, options), nullptr);
+}
+
+TEST_F(BatchingSignatureRunnerTest, PadsToBatchSize) {
+  BatchingSignatureRunner::Options options;
+  options.batch_sizes = {4};
+  options.max_wait = std::chrono::microseconds(0);
+  auto batcher = BatchingSignatureRunner::Create(runner_, options);
+  ASSERT_NE(batcher, nullptr);
+
+  const std::vector<float> x = {1, 2, 3};
+  std::vector<float> y(3);
+  ASSERT_EQ(batcher->Invoke(3, {x.data()}, {y.data()}), kTfLiteOk);
+  EXPECT_EQ(y, std::vector<float>({3, 4, 5}));
+  EXPECT_EQ(runner_->input_tensor("x")->dims->data[0], 4);
+
+  // Larger than the largest batch size.
+  std::vector<float> large(5);
+  EXPECT_EQ(batcher->Invoke(5, {large.data()}, {large.data()}), kTfLiteError);
+  // Wrong number of inputs.
+  EXPECT_EQ(batcher->Invoke(1, {}, {y.data()}), kTfLiteError);
+}
+
+TEST_F(BatchingSignatureRunnerTest, BatchesConcurrentRequests) {
+  constexpr int kNumThreads = 8;
+  BatchingSignatureRunner::Options options;
+  options.batch_sizes = {1, 2, 4, kNumThreads};
+  // Long enough for all the threads to start, the batch being run as soon as
+  // it is full.
+  options.max_wait = std::chrono::seconds(10);
+  auto batcher = BatchingSignatureRunner::Create(runner_, options);
+  ASSERT_NE(batcher, nullptr);
+
+  std::vector<float> outputs(kNumThreads);
+  std::vector<TfLiteStatus> statuses(kNumThreads, kTfLiteError);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([&, i] {
+      const float input = i;
+      statuses[i] = batcher->Invoke(1, {&input}, {&outputs[i]});
+    });
+  }
+  for (std::thread& thread : threads) thread.join();
+
+  for (int i = 0; i < kNumThreads; ++i) {
+    EXPECT_EQ(statuses[i], kTfLiteOk);
+    EXPECT_EQ(outputs[i], i + 2);
+  }
+  EXPECT_EQ(batcher->num_batches(), 1);
+}
+
+TEST_F(BatchingSignatureRunnerTest, RunsPartialBatchAfterMaxWait) {
+  BatchingSignatureRunner::Options options;
+  options.batch_sizes = {1, 2, 4};
+  options.max_wait = std::chrono::milliseconds(1);
+  auto batcher = BatchingSignatureRunner::Create(runner_, options);
+  ASSERT_NE(batcher, nullptr);
+
+  for (int run = 0; run < 3; ++run) {
+    const std::vector<float> x = {10, 20};
+    std::vector<float> y(2);
+    ASSERT_EQ(batcher->Invoke(2, {x.data()}, {y.data()}), kTfLiteOk);
+    EXPECT_EQ(y, std::vector<float>({12, 22}));
+  }
+  EXPECT_EQ(batcher->num_batches(), 3);
+  EXPECT_EQ(runner_->input_tensor("x")->dims->data[0], 2);
+}
+
+}  // namespace
+}  // namespace tflite
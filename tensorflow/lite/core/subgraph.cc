@@ -1414,9 +1414,19 @@ TfLiteStatus Subgraph::PrepareOpsAndTensors() {
 #ifdef TFLITE_USE_SIMPLE_MEMORY_PLANNER
     memory_planner_.reset(new SimplePlanner(&context_, CreateGraphInfo()));
 #else
-    memory_planner_ = std::make_unique<ArenaPlanner>(
+    auto arena_planner = std::make_unique<ArenaPlanner>(
         &context_, CreateGraphInfo(), ShouldPreserveAllTensors(),
         kDefaultTensorAlignment, subgraph_index_);
+    const char* offline_plan = nullptr;
+    size_t offline_plan_bytes = 0;
+    if (GetModelMetadata(kOfflineMemoryAllocationMetadataKey, &offline_plan,
+                         &offline_plan_bytes) == kTfLiteOk &&
+        arena_planner->SetOfflineMemoryAllocation(
+            offline_plan, offline_plan_bytes) != kTfLiteOk) {
+      TFLITE_LOG(tflite::TFLITE_LOG_WARNING,
+                 "Ignoring the invalid offline memory plan of the model.");
+    }
+    memory_planner_ = std::move(arena_planner);
 #endif
     memory_planner_->PlanAllocations();
   }
@@ -1522,6 +1532,17 @@ TfLiteStatus Subgraph::InvokeImpl() {
   // Note that calling Invoke repeatedly will cause the original memory plan to
   // be reused, unless either ResizeInputTensor() or AllocateTensors() has been
   // called.
+  //
+  // Running independent nodes concurrently is not safe here, even when the
+  // execution plan has independent branches:
+  //  - The memory planner assumes this order: a tensor whose last use is a
+  //    node may share memory with the outputs and temporaries of the next
+  //    node.
+  //  - Kernels share the CpuBackendContext of the interpreter, whose gemm
+  //    contexts are not thread-safe.
+  //  - Nodes following a dynamic tensor are prepared lazily from this loop.
+  // Parallelism across branches is therefore left to delegates and to the
+  // intra-op threads of the kernels.
   for (int execution_plan_index = 0;
        execution_plan_index < execution_plan_.size(); execution_plan_index++) {
     if (execution_plan_index == next_execution_plan_index_to_prepare_) {
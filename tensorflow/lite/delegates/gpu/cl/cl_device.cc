@@ -354,6 +354,16 @@ GpuInfo GpuInfoFromDeviceID(cl_device_id id, cl_platform_id platform_id) {
       }
     }
   }
+  if (info.IsAMD() && info.SupportsExtension("cl_amd_device_attribute_query")) {
+    // Wave32 on RDNA, wave64 on GCN and CDNA.
+    cl_uint wavefront_width;
+    cl_int status = clGetDeviceInfo(
+        id, 0x4043 /*CL_DEVICE_WAVEFRONT_WIDTH_AMD*/, sizeof(cl_uint),
+        &wavefront_width, nullptr);
+    if (status == CL_SUCCESS && wavefront_width != 0) {
+      info.supported_subgroup_sizes.push_back(wavefront_width);
+    }
+  }
   if (info.IsAdreno()) {
     ParseQualcommOpenClCompilerVersion(info.opencl_info.driver_version,
                                        &info.adreno_info.cl_compiler_version);
@@ -19,6 +19,7 @@ limitations under the License.
 #include <string>
 #include <utility>
 
+#include "absl/strings/str_cat.h"
 #include "flatbuffers/flatbuffers.h"  // from @flatbuffers
 #include "tensorflow/lite/delegates/gpu/cl/cl_program.h"
 #include "tensorflow/lite/delegates/gpu/cl/compiled_program_cache_generated.h"
@@ -53,8 +54,13 @@ uint64_t GetProgramFingerprint(const std::string& code,
   return CombineFingerprints(code_fingerprint, options_fingerprint);
 }
 
+// Several devices of different architectures can share a platform, e.g. the
+// AMD GPUs of a workstation, so the binaries are only valid for the device and
+// the driver that compiled them.
 std::string GetDriverVersion(const CLDevice& device) {
-  return device.GetPlatformVersion() + "_jet_version_0";
+  const auto& info = device.GetInfo().opencl_info;
+  return absl::StrCat(device.GetPlatformVersion(), "_", info.device_name, "_",
+                      info.driver_version, "_jet_version_0");
 }
 
 }  // namespace
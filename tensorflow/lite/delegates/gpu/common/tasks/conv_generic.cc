@@ -1630,7 +1630,8 @@ ConvGeneric::ConvParams ConvGeneric::GuessBestParams(
       int block_size = conv_params.block_size.x * conv_params.block_size.y *
                        conv_params.block_size.w;
       float threads_per_cu = task_size_per_cu / block_size;
-      float warps_per_cu = threads_per_cu / 64;
+      const int wave_size = gpu_info.IsWaveSizeEqualTo32() ? 32 : 64;
+      float warps_per_cu = threads_per_cu / wave_size;
       if (warps_per_cu < 4.0f) {
         reduce_block_size_wzyx(&conv_params.block_size);
       }
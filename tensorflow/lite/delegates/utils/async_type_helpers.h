@@ -24,6 +24,8 @@ limitations under the License.
 namespace tflite::delegates::utils {
 
 constexpr char kBufferTypeAHardwareBufferBlob[] = "ahardware_buffer_blob";
+// CPU memory, wrapped in the TfLiteBackendBuffer as a plain pointer.
+constexpr char kBufferTypeHostMemory[] = "host_memory";
 constexpr char kSyncTypeSyncFenceFd[] = "sync_fence_fd";
 
 // RAII wrapper of TfLiteAttributeMap.
@@ -54,7 +56,7 @@ inline ScopedTfLiteSynchronization CreateScopedTfLiteSynchronization() {
                                      TfLiteSynchronizationDelete);
 }
 
-enum class BufferType { kUnknown, kAHardwareBufferBlob };
+enum class BufferType { kUnknown, kAHardwareBufferBlob, kHostMemory };
 
 struct BufferAttributes {
   std::optional<BufferType> buffer_type;
@@ -0,0 +1,182 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <unistd.h>
+
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "tensorflow/lite/async/c/task.h"
+#include "tensorflow/lite/async/interop/c/types.h"
+#include "tensorflow/lite/builtin_ops.h"
+#include "tensorflow/lite/core/async/async_signature_runner.h"
+#include "tensorflow/lite/core/c/builtin_op_data.h"
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/core/kernels/builtin_op_kernels.h"
+#include "tensorflow/lite/delegates/utils/async_type_helpers.h"
+#include "tensorflow/lite/delegates/xnnpack/xnnpack_delegate.h"
+#include "tensorflow/lite/interpreter_test_util.h"
+
+namespace tflite {
+namespace xnnpack {
+namespace {
+
+using ::tflite::delegates::utils::BufferAttributes;
+using ::tflite::delegates::utils::BufferType;
+using ::tflite::delegates::utils::CreateScopedTfLiteBackendBuffer;
+using ::tflite::delegates::utils::CreateScopedTfLiteSynchronization;
+using ::tflite::delegates::utils::ScopedTfLiteBackendBuffer;
+using ::tflite::delegates::utils::SyncAttributes;
+using ::tflite::delegates::utils::SyncType;
+using ::tflite::delegates::utils::WriteBufferAttrs;
+using ::tflite::delegates::utils::WriteSyncAttrs;
+
+constexpr int kNumElements = 4;
+constexpr char kSignatureKey[] = "serving_default";
+
+// Computes sum = x + y with the XNNPACK delegate, through the async API.
+class AsyncKernelTest : public InterpreterTest {
+ protected:
+  void SetUp() override {
+    interpreter_->AddTensors(3);
+    interpreter_->SetInputs({0, 1});
+    interpreter_->SetOutputs({2});
+    TfLiteQuantizationParams quant;
+    for (int t = 0; t < 3; ++t) {
+      interpreter_->SetTensorParametersReadWrite(t, kTfLiteFloat32, "",
+                                                 {kNumElements}, quant);
+    }
+    TfLiteRegistration registration = *ops::builtin::Register_ADD();
+    registration.builtin_code = kTfLiteBuiltinAdd;
+    registration.version = 1;
+    auto* params =
+        static_cast<TfLiteAddParams*>(calloc(1, sizeof(TfLiteAddParams)));
+    params->activation = kTfLiteActNone;
+    interpreter_->AddNodeWithParameters({0, 1}, {2}, nullptr, 0, params,
+                                        &registration);
+    BuildSignature(kSignatureKey, {{"x", 0}, {"y", 1}}, {{"sum", 2}});
+
+    TfLiteXNNPackDelegateOptions options =
+        TfLiteXNNPackDelegateOptionsDefault();
+    options.flags |= TFLITE_XNNPACK_DELEGATE_FLAG_ENABLE_ASYNC;
+    delegate_.reset(TfLiteXNNPackDelegateCreate(&options));
+    ASSERT_EQ(interpreter_->ModifyGraphWithDelegate(delegate_.get()),
+              kTfLiteOk);
+    runner_ = interpreter_->GetAsyncSignatureRunner(kSignatureKey);
+    ASSERT_NE(runner_, nullptr);
+  }
+
+  // Registers the host memory of `data` and binds it to `name` in `task`.
+  void BindBuffer(TfLiteExecutionTask* task, TfLiteIoType io_type,
+                  const char* name, std::vector<float>& data) {
+    ScopedTfLiteBackendBuffer buffer = CreateScopedTfLiteBackendBuffer();
+    TfLiteBackendBufferSetPtr(buffer.get(), data.data());
+    BufferAttributes attrs;
+    attrs.buffer_type = BufferType::kHostMemory;
+    attrs.size = data.size() * sizeof(float);
+    TfLiteBufferHandle handle = kTfLiteNullBufferHandle;
+    ASSERT_EQ(runner_->RegisterBuffer(io_type, buffer.get(),
+                                      WriteBufferAttrs(attrs).get(), &handle),
+              kTfLiteOk);
+    ASSERT_EQ(TfLiteExecutionTaskSetBuffer(task, io_type, name, handle),
+              kTfLiteOk);
+  }
+
+  std::unique_ptr<TfLiteDelegate, decltype(&TfLiteXNNPackDelegateDelete)>
+      delegate_{nullptr, TfLiteXNNPackDelegateDelete};
+  async::AsyncSignatureRunner* runner_ = nullptr;
+  // Padded, since XNNPACK may read past the end of the inputs.
+  std::vector<float> x_ = std::vector<float>(kNumElements + 4, 1.0f);
+  std::vector<float> y_ = std::vector<float>(kNumElements + 4, 2.0f);
+  std::vector<float> sum_ = std::vector<float>(kNumElements + 4, 0.0f);
+};
+
+TEST_F(AsyncKernelTest, InvokesAsynchronously) {
+  ASSERT_EQ(runner_->PrepareBackends(), kTfLiteOk);
+  TfLiteExecutionTask* task = runner_->CreateTask();
+  BindBuffer(task, kTfLiteIoTypeInput, "x", x_);
+  BindBuffer(task, kTfLiteIoTypeInput, "y", y_);
+  BindBuffer(task, kTfLiteIoTypeOutput, "sum", sum_);
+
+  for (int run = 0; run < 3; ++run) {
+    for (int i = 0; i < kNumElements; ++i) x_[i] = run + i;
+    ASSERT_EQ(runner_->InvokeAsync(task), kTfLiteOk);
+    ASSERT_EQ(runner_->Wait(task), kTfLiteOk);
+    for (int i = 0; i < kNumElements; ++i) {
+      EXPECT_EQ(sum_[i], run + i + 2.0f);
+    }
+  }
+  EXPECT_EQ(runner_->Finish(task), kTfLiteOk);
+}
+
+TEST_F(AsyncKernelTest, WaitsForInputFence) {
+  ASSERT_EQ(runner_->SetAttributes(
+                kTfLiteIoTypeInput, "x",
+                WriteSyncAttrs(SyncAttributes{SyncType::kSyncFenceFd}).get()),
+            kTfLiteOk);
+  ASSERT_EQ(runner_->PrepareBackends(), kTfLiteOk);
+  TfLiteExecutionTask* task = runner_->CreateTask();
+  BindBuffer(task, kTfLiteIoTypeInput, "x", x_);
+  BindBuffer(task, kTfLiteIoTypeInput, "y", y_);
+  BindBuffer(task, kTfLiteIoTypeOutput, "sum", sum_);
+
+  // A pipe stands for the fence of the producer of x: it is signalled once
+  // written to.
+  int fds[2];
+  ASSERT_EQ(pipe(fds), 0);
+  auto sync = CreateScopedTfLiteSynchronization();
+  TfLiteSynchronizationSetPtr(sync.get(), &fds[0]);
+  ASSERT_EQ(TfLiteExecutionTaskSetSync(task, kTfLiteIoTypeInput, "x",
+                                       sync.get()),
+            kTfLiteOk);
+
+  // The execution is scheduled before x is produced.
+  ASSERT_EQ(runner_->InvokeAsync(task), kTfLiteOk);
+  for (int i = 0; i < kNumElements; ++i) x_[i] = 10.0f;
+  ASSERT_EQ(write(fds[1], "", 1), 1);
+
+  ASSERT_EQ(runner_->Wait(task), kTfLiteOk);
+  for (int i = 0; i < kNumElements; ++i) {
+    EXPECT_EQ(sum_[i], 12.0f);
+  }
+  EXPECT_EQ(runner_->Finish(task), kTfLiteOk);
+  // The delegate closed the read end of the pipe.
+  close(fds[1]);
+}
+
+TEST_F(AsyncKernelTest, RejectsOutputFence) {
+  ASSERT_EQ(runner_->SetAttributes(
+                kTfLiteIoTypeOutput, "sum",
+                WriteSyncAttrs(SyncAttributes{SyncType::kSyncFenceFd}).get()),
+            kTfLiteOk);
+  EXPECT_NE(runner_->PrepareBackends(), kTfLiteOk);
+}
+
+TEST_F(AsyncKernelTest, RejectsTooSmallBuffer) {
+  ASSERT_EQ(runner_->PrepareBackends(), kTfLiteOk);
+  TfLiteExecutionTask* task = runner_->CreateTask();
+  std::vector<float> small_x(kNumElements - 1);
+  BindBuffer(task, kTfLiteIoTypeInput, "x", small_x);
+  BindBuffer(task, kTfLiteIoTypeInput, "y", y_);
+  BindBuffer(task, kTfLiteIoTypeOutput, "sum", sum_);
+  EXPECT_NE(runner_->InvokeAsync(task), kTfLiteOk);
+  EXPECT_EQ(runner_->Finish(task), kTfLiteOk);
+}
+
+}  // namespace
+}  // namespace xnnpack
+}  // namespace tflite
@@ -0,0 +1,80 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/delegates/xnnpack/shared_weights_cache.h"
+
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <unordered_map>
+
+namespace tflite {
+namespace xnnpack {
+namespace {
+
+// The live caches, by model buffer.
+struct Registry {
+  std::mutex mutex;
+  std::unordered_map<const void*, std::weak_ptr<SharedWeightsCache>> caches;
+};
+
+Registry& GetRegistry() {
+  static Registry* registry = new Registry();
+  return *registry;
+}
+
+}  // namespace
+
+std::shared_ptr<SharedWeightsCache> SharedWeightsCache::Get(
+    const void* model_buffer) {
+  Registry& registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  std::weak_ptr<SharedWeightsCache>& entry = registry.caches[model_buffer];
+  std::shared_ptr<SharedWeightsCache> cache = entry.lock();
+  if (cache == nullptr) {
+    TfLiteXNNPackDelegateWeightsCache* weights_cache =
+        TfLiteXNNPackDelegateWeightsCacheCreate();
+    if (weights_cache == nullptr) {
+      registry.caches.erase(model_buffer);
+      return nullptr;
+    }
+    cache.reset(new SharedWeightsCache(model_buffer, weights_cache));
+    entry = cache;
+  }
+  return cache;
+}
+
+SharedWeightsCache::~SharedWeightsCache() {
+  {
+    Registry& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    // The entry may already refer to a new cache of the same model, created
+    // after the last reference to this one was dropped.
+    auto it = registry.caches.find(model_buffer_);
+    if (it != registry.caches.end() && it->second.expired()) {
+      registry.caches.erase(it);
+    }
+  }
+  TfLiteXNNPackDelegateWeightsCacheDelete(cache_);
+}
+
+bool SharedWeightsCache::Finalize() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!finalized_) {
+    finalized_ = TfLiteXNNPackDelegateWeightsCacheFinalizeSoft(cache_);
+  }
+  return finalized_;
+}
+
+}  // namespace xnnpack
+}  // namespace tflite
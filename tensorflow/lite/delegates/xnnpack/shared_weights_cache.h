@@ -0,0 +1,82 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_DELEGATES_XNNPACK_SHARED_WEIGHTS_CACHE_H_
+#define TENSORFLOW_LITE_DELEGATES_XNNPACK_SHARED_WEIGHTS_CACHE_H_
+
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+
+#include "tensorflow/lite/delegates/xnnpack/xnnpack_delegate.h"
+
+namespace tflite {
+namespace xnnpack {
+
+// A weights cache shared by all the XNNPACK delegates applied to interpreters
+// built from the same model, so that a process running many interpreters of
+// a model holds a single copy of its packed weights.
+//
+// The caches are reference-counted and registered process-wide by model: Get()
+// returns the cache of a model for as long as one of its users keeps it alive,
+// and the cache is deleted along with its last reference.
+//
+// Typical usage, for every interpreter of a model:
+//
+//   std::shared_ptr<SharedWeightsCache> cache =
+//       SharedWeightsCache::Get(model->allocation()->base());
+//   TfLiteXNNPackDelegateOptions options =
+//       TfLiteXNNPackDelegateOptionsDefault();
+//   options.weights_cache = cache->get();
+//   ... create the delegate and call ModifyGraphWithDelegate() ...
+//   if (!cache->Finalize()) { ... }
+//
+// The cache, as well as the delegates using it, must be kept alive as long as
+// the interpreter is used.
+//
+// This class is thread-safe.
+class SharedWeightsCache {
+ public:
+  // Returns the cache of the model whose buffer is at `model_buffer`, creating
+  // one if no user of that model holds a cache anymore.
+  static std::shared_ptr<SharedWeightsCache> Get(const void* model_buffer);
+
+  ~SharedWeightsCache();
+
+  SharedWeightsCache(const SharedWeightsCache&) = delete;
+  SharedWeightsCache& operator=(const SharedWeightsCache&) = delete;
+
+  // The cache to pass in TfLiteXNNPackDelegateOptions::weights_cache.
+  TfLiteXNNPackDelegateWeightsCache* get() const { return cache_; }
+
+  // Soft-finalizes the cache, which is required before running inference,
+  // unless it already is. Delegates created afterwards keep reusing the packed
+  // weights. Returns true on success, false on error.
+  bool Finalize();
+
+ private:
+  SharedWeightsCache(const void* model_buffer,
+                     TfLiteXNNPackDelegateWeightsCache* cache)
+      : model_buffer_(model_buffer), cache_(cache) {}
+
+  const void* const model_buffer_;
+  TfLiteXNNPackDelegateWeightsCache* const cache_;  // Owned.
+
+  std::mutex mutex_;
+  bool finalized_ = false;
+};
+
+}  // namespace xnnpack
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_DELEGATES_XNNPACK_SHARED_WEIGHTS_CACHE_H_
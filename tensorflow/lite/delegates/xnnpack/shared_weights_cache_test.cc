@@ -0,0 +1,98 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/delegates/xnnpack/shared_weights_cache.h"
+
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "tensorflow/lite/core/interpreter_builder.h"
+#include "tensorflow/lite/delegates/xnnpack/conv_2d_tester.h"
+#include "tensorflow/lite/delegates/xnnpack/xnnpack_delegate.h"
+#include "tensorflow/lite/interpreter.h"
+#include "tensorflow/lite/mutable_op_resolver.h"
+
+namespace tflite {
+namespace xnnpack {
+namespace {
+
+class DummyOpResolver : public MutableOpResolver {
+ public:
+  DummyOpResolver() {
+    AddBuiltin(BuiltinOperator_CONV_2D, DummyRegistration(), 1, 3);
+  }
+
+ private:
+  static const TfLiteRegistration* DummyRegistration() {
+    static TfLiteRegistration r = {nullptr, nullptr, Prepare, Invoke};
+    return &r;
+  }
+  static TfLiteStatus Prepare(TfLiteContext*, TfLiteNode*) { return kTfLiteOk; }
+  static TfLiteStatus Invoke(TfLiteContext*, TfLiteNode*) { return kTfLiteOk; }
+};
+
+TEST(SharedWeightsCache, SharedByModel) {
+  std::vector<char> buffer1 = Conv2DTester().CreateTfLiteModel();
+  std::vector<char> buffer2 = Conv2DTester().CreateTfLiteModel();
+
+  std::shared_ptr<SharedWeightsCache> cache1 =
+      SharedWeightsCache::Get(buffer1.data());
+  ASSERT_NE(cache1, nullptr);
+  EXPECT_EQ(cache1, SharedWeightsCache::Get(buffer1.data()));
+  EXPECT_NE(cache1, SharedWeightsCache::Get(buffer2.data()));
+
+  // A model gets a new cache once the previous one is released.
+  cache1.reset();
+  std::shared_ptr<SharedWeightsCache> cache2 =
+      SharedWeightsCache::Get(buffer1.data());
+  ASSERT_NE(cache2, nullptr);
+  EXPECT_EQ(cache2.use_count(), 1);
+}
+
+TEST(SharedWeightsCache, InterpretersShareCache) {
+  std::vector<char> buffer = Conv2DTester().CreateTfLiteModel();
+  const Model* model = GetModel(buffer.data());
+  DummyOpResolver resolver;
+
+  std::vector<std::unique_ptr<Interpreter>> interpreters;
+  std::vector<std::unique_ptr<TfLiteDelegate,
+                              decltype(&TfLiteXNNPackDelegateDelete)>>
+      delegates;
+  std::vector<std::shared_ptr<SharedWeightsCache>> caches;
+  for (int i = 0; i < 3; ++i) {
+    caches.push_back(SharedWeightsCache::Get(buffer.data()));
+    ASSERT_NE(caches.back(), nullptr);
+    TfLiteXNNPackDelegateOptions delegate_options =
+        TfLiteXNNPackDelegateOptionsDefault();
+    delegate_options.weights_cache = caches.back()->get();
+
+    std::unique_ptr<Interpreter> interpreter;
+    ASSERT_EQ(kTfLiteOk, InterpreterBuilder(model, resolver)(&interpreter));
+    ASSERT_EQ(kTfLiteOk, interpreter->AllocateTensors());
+    delegates.emplace_back(TfLiteXNNPackDelegateCreate(&delegate_options),
+                           TfLiteXNNPackDelegateDelete);
+    ASSERT_EQ(kTfLiteOk,
+              interpreter->ModifyGraphWithDelegate(delegates.back().get()));
+    ASSERT_TRUE(caches.back()->Finalize());
+    ASSERT_EQ(kTfLiteOk, interpreter->Invoke());
+    interpreters.push_back(std::move(interpreter));
+  }
+  EXPECT_EQ(caches[0], caches[1]);
+  EXPECT_EQ(caches[0], caches[2]);
+}
+
+}  // namespace
+}  // namespace xnnpack
+}  // namespace tflite
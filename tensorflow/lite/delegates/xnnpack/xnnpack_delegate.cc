@@ -46,6 +46,24 @@ limitations under the License.
 #include "tensorflow/lite/schema/schema_generated.h"
 #include "tensorflow/lite/tools/optimize/reduced_precision_support.h"
 
+#if defined(__linux__)
+#include <unistd.h>
+
+#include <condition_variable>  // NOLINT(build/c++11)
+#include <deque>
+#include <mutex>   // NOLINT(build/c++11)
+#include <thread>  // NOLINT(build/c++11)
+
+#include "tensorflow/lite/async/backend_async_kernel_interface.h"
+#include "tensorflow/lite/async/c/task.h"
+#include "tensorflow/lite/async/interop/c/attribute_map.h"
+#include "tensorflow/lite/async/interop/c/constants.h"
+#include "tensorflow/lite/async/interop/c/types.h"
+#include "tensorflow/lite/delegates/utils/async_type_helpers.h"
+#include "tensorflow/lite/delegates/utils/ret_macros.h"
+#include "tensorflow/lite/delegates/utils/sync_fence.h"
+#endif  // defined(__linux__)
+
 struct TfLiteXNNPackDelegateWeightsCache;
 
 namespace tflite {
@@ -521,6 +539,10 @@ class Delegate {
             TFLITE_XNNPACK_DELEGATE_FLAG_DYNAMIC_FULLY_CONNECTED) != 0;
   }
 
+  bool enable_async() const {
+    return (options_.flags & TFLITE_XNNPACK_DELEGATE_FLAG_ENABLE_ASYNC) != 0;
+  }
+
   bool force_fp16() const {
 #ifdef XNNPACK_DELEGATE_FORCE_PRECISION_FP16
     return true;
@@ -987,12 +1009,22 @@ class Subgraph {
   TfLiteStatus Prepare(TfLiteContext* context) { return kTfLiteOk; }
 
   TfLiteStatus Invoke(TfLiteContext* context) {
+    return Invoke(context,
+                  [context](int t) { return context->tensors[t].data.raw; });
+  }
+
+  // Same as Invoke(context), but the data of the input and output tensors is
+  // located by `get_data`, which is called with the tensor index and returns
+  // nullptr for empty tensors.
+  template <typename GetData>
+  TfLiteStatus Invoke(TfLiteContext* context, GetData get_data) {
     bool any_pointers_changed = false;
     for (std::pair<int, void*> io_info : externals_) {
       const TfLiteTensor& tensor = context->tensors[io_info.first];
+      void* data = get_data(io_info.first);
       void* data_pointer = &dummy_data_;
-      if (tensor.data.raw != nullptr) {
-        data_pointer = tensor.data.raw;
+      if (data != nullptr) {
+        data_pointer = data;
       } else {
         if (tensor.bytes != 0) {
           TF_LITE_KERNEL_LOG(
@@ -6213,6 +6245,558 @@ const TfLiteRegistration kSubgraphRegistration = {
     /*.version=*/2,
 };
 
+#if defined(__linux__)
+using ::tflite::delegates::utils::BufferAttributes;
+using ::tflite::delegates::utils::BufferType;
+using ::tflite::delegates::utils::ReadBufferAttrs;
+using ::tflite::delegates::utils::ReadSyncAttrs;
+using ::tflite::delegates::utils::SyncAttributes;
+using ::tflite::delegates::utils::SyncType;
+using ::tflite::delegates::utils::WriteBufferAttrs;
+using ::tflite::delegates::utils::WriteSyncAttrs;
+
+// Asynchronous kernel of a delegated subgraph, for use with the
+// AsyncSignatureRunner.
+//
+// The input and output tensors are bound to host memory buffers, and the
+// executions are run in order by a worker thread, so that Eval() returns as
+// soon as the execution is scheduled. An execution waits for the sync fences of
+// its inputs on the worker thread before running the XNNPACK runtime, which
+// lets the application chain the inference after the producer of its inputs
+// without blocking. The outputs are ready when Wait() returns: XNNPACK runs on
+// the CPU, so there is no fence it could hand out for them.
+class AsyncKernel : public ::tflite::delegates::BackendAsyncKernelInterface {
+ public:
+  explicit AsyncKernel(std::unique_ptr<Subgraph> subgraph)
+      : subgraph_(std::move(subgraph)) {}
+
+  ~AsyncKernel() override {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    work_available_.notify_all();
+    if (worker_.joinable()) {
+      worker_.join();
+    }
+  }
+
+  Subgraph* subgraph() { return subgraph_.get(); }
+
+  // Buffer operations
+  TfLiteStatus RegisterBuffer(TfLiteOpaqueContext* opaque_context,
+                              TfLiteIoType io_type,
+                              const TfLiteBackendBuffer* buffer,
+                              const TfLiteAttributeMap* attrs,
+                              TfLiteBufferHandle handle) override;
+  TfLiteStatus RegisterBufferSlice(TfLiteOpaqueContext* opaque_context,
+                                   TfLiteBufferHandle buffer_pool,
+                                   const TfLiteAttributeMap* attrs,
+                                   TfLiteBufferHandle handle) override;
+  TfLiteStatus UnregisterBuffer(TfLiteOpaqueContext* opaque_context,
+                                TfLiteBufferHandle handle) override;
+
+  // Reconciliations
+  const std::vector<const char*>& SupportedBufferTypes(
+      TfLiteIoType io_type) const override {
+    return supported_buffer_types_;
+  }
+  const std::vector<const char*>& SupportedSynchronizations(
+      TfLiteIoType io_type) const override {
+    return io_type == kTfLiteIoTypeInput ? supported_input_synchronizations_
+                                         : supported_output_synchronizations_;
+  }
+  bool ReconcileRestrictions(const TfLiteOpaqueContext* opaque_context,
+                             const TfLiteOpaqueNode* opaque_node,
+                             int tensor_index,
+                             const TfLiteAttributeMap* user_provided_attributes,
+                             TfLiteAttributeMap* merged,
+                             TfLiteAttributeMap* conflict) const override;
+  TfLiteStatus SetAttributes(TfLiteOpaqueContext* opaque_context,
+                             TfLiteOpaqueNode* opaque_node, int tensor_index,
+                             const TfLiteAttributeMap* attrs) override;
+  TfLiteStatus Prepare(TfLiteOpaqueContext* opaque_context,
+                       TfLiteOpaqueNode* opaque_node) override;
+
+  // Execution methods
+  TfLiteStatus Eval(TfLiteOpaqueContext* opaque_context,
+                    TfLiteOpaqueNode* opaque_node,
+                    TfLiteExecutionTask* task) override;
+  TfLiteStatus Wait(TfLiteOpaqueContext* opaque_context,
+                    TfLiteExecutionTask* task) override;
+  TfLiteStatus Finish(TfLiteOpaqueContext* opaque_context,
+                      TfLiteExecutionTask* task) override;
+
+ private:
+  // Registered buffer or buffer slice.
+  struct Buffer {
+    char* data;
+    size_t size;
+    bool is_slice;
+  };
+
+  // State of a task, stored as its delegate execution data.
+  struct TaskState {
+    bool done = true;
+    TfLiteStatus status = kTfLiteOk;
+  };
+
+  // Execution scheduled by Eval().
+  struct Execution {
+    TfLiteExecutionTask* task;
+    TfLiteContext* context;
+    // Data of the tensors bound to a buffer of the task.
+    std::unordered_map<int, void*> data;
+    // Sync fences of the inputs, closed once signalled.
+    std::vector<int> input_fences;
+  };
+
+  // XNNPACK reads up to XNN_EXTRA_BYTES past the end of the input tensors.
+  static constexpr size_t kRequiredByteAlignment = 64;
+  static constexpr size_t kRequiredBytePadding = XNN_EXTRA_BYTES;
+
+  TaskState* GetTaskState(const TfLiteExecutionTask* task) const {
+    return static_cast<TaskState*>(
+        TfLiteExecutionTaskGetDelegateExecutionData(task, kernel_));
+  }
+
+  bool ReconcileBufferRestrictions(const TfLiteContext* context,
+                                   int tensor_index,
+                                   const BufferAttributes& user,
+                                   BufferAttributes& merged,
+                                   BufferAttributes& conflict) const;
+
+  // Runs the scheduled executions until the kernel is destroyed.
+  void WorkerLoop();
+
+  TfLiteStatus Run(Execution& execution);
+
+  std::unique_ptr<Subgraph> subgraph_;
+
+  const std::vector<const char*> supported_buffer_types_ = {
+      ::tflite::delegates::utils::kBufferTypeHostMemory};
+  const std::vector<const char*> supported_input_synchronizations_ = {
+      kTfLiteSyncTypeNoSyncObj,
+      ::tflite::delegates::utils::kSyncTypeSyncFenceFd};
+  const std::vector<const char*> supported_output_synchronizations_ = {
+      kTfLiteSyncTypeNoSyncObj};
+
+  mutable std::mutex mutex_;
+  std::unordered_map<TfLiteBufferHandle, Buffer> buffers_;
+  std::unordered_map<int, SyncType> sync_type_by_tensor_index_;
+  // Tensors whose inputs sync fences are waited for, set by Prepare().
+  std::vector<int> fenced_inputs_;
+  bool prepared_ = false;
+
+  std::deque<Execution> executions_;
+  std::condition_variable work_available_;
+  std::condition_variable work_done_;
+  bool stop_ = false;
+  std::thread worker_;
+};
+
+bool AsyncKernel::ReconcileBufferRestrictions(const TfLiteContext* context,
+                                              int tensor_index,
+                                              const BufferAttributes& user,
+                                              BufferAttributes& merged,
+                                              BufferAttributes& conflict) const {
+  const BufferType buffer_type =
+      user.buffer_type.value_or(BufferType::kHostMemory);
+  if (buffer_type != BufferType::kHostMemory) {
+    conflict.buffer_type = BufferType::kHostMemory;
+    return false;
+  }
+  merged.buffer_type = buffer_type;
+
+  const size_t alignment = user.alignment.value_or(kRequiredByteAlignment);
+  if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+    conflict.alignment = kRequiredByteAlignment;
+    return false;
+  }
+  merged.alignment = std::max(alignment, kRequiredByteAlignment);
+
+  const size_t padding = user.padding.value_or(kRequiredBytePadding);
+  merged.padding = std::max(padding, kRequiredBytePadding);
+
+  merged.size = std::max(user.size.value_or(0),
+                         context->tensors[tensor_index].bytes +
+                             merged.padding.value());
+  return true;
+}
+
+bool AsyncKernel::ReconcileRestrictions(
+    const TfLiteOpaqueContext* opaque_context,
+    const TfLiteOpaqueNode* opaque_node, int tensor_index,
+    const TfLiteAttributeMap* user_provided_attributes,
+    TfLiteAttributeMap* merged, TfLiteAttributeMap* conflict) const {
+  TFLITE_ABORT_CHECK(opaque_context != nullptr, "");            // Crash OK
+  TFLITE_ABORT_CHECK(user_provided_attributes != nullptr, "");  // Crash OK
+  TFLITE_ABORT_CHECK(merged != nullptr, "");                    // Crash OK
+
+  // The following casts are safe only because this code is part of the
+  // TF Lite runtime implementation.
+  const auto* context = reinterpret_cast<const TfLiteContext*>(opaque_context);
+  const auto* node = reinterpret_cast<const TfLiteNode*>(opaque_node);
+  if (TfLiteAttributeMapIsBufferAttributeMap(user_provided_attributes)) {
+    if (!TfLiteAttributeMapIsBufferAttributeMap(merged) ||
+        (conflict != nullptr &&
+         !TfLiteAttributeMapIsBufferAttributeMap(conflict))) {
+      TFLITE_LOG_PROD(TFLITE_LOG_ERROR,
+                      "'merged' or 'conflict' have a different attribute map "
+                      "type than 'user_provided_attributes'");
+      return false;
+    }
+    BufferAttributes merged_attrs{};
+    BufferAttributes conflict_attrs{};
+    const bool ok = ReconcileBufferRestrictions(
+        context, tensor_index, ReadBufferAttrs(user_provided_attributes),
+        merged_attrs, conflict_attrs);
+    WriteBufferAttrs(merged_attrs, merged);
+    if (conflict != nullptr) {
+      WriteBufferAttrs(conflict_attrs, conflict);
+    }
+    return ok;
+  }
+  if (TfLiteAttributeMapIsSyncAttributeMap(user_provided_attributes)) {
+    if (!TfLiteAttributeMapIsSyncAttributeMap(merged) ||
+        (conflict != nullptr &&
+         !TfLiteAttributeMapIsSyncAttributeMap(conflict))) {
+      TFLITE_LOG_PROD(TFLITE_LOG_ERROR,
+                      "'merged' or 'conflict' have a different attribute map "
+                      "type than 'user_provided_attributes'");
+      return false;
+    }
+    const SyncType sync_type = ReadSyncAttrs(user_provided_attributes)
+                                   .sync_type.value_or(SyncType::kNoSyncObj);
+    bool is_output = false;
+    for (int i = 0; node != nullptr && i < node->outputs->size; ++i) {
+      is_output |= node->outputs->data[i] == tensor_index;
+    }
+    // Only the inputs can be synchronized with fences.
+    const bool ok = sync_type == SyncType::kNoSyncObj ||
+                    (sync_type == SyncType::kSyncFenceFd && !is_output);
+    SyncAttributes merged_attrs{};
+    SyncAttributes conflict_attrs{};
+    if (ok) {
+      merged_attrs.sync_type = sync_type;
+    } else {
+      conflict_attrs.sync_type = SyncType::kNoSyncObj;
+    }
+    WriteSyncAttrs(merged_attrs, merged);
+    if (conflict != nullptr) {
+      WriteSyncAttrs(conflict_attrs, conflict);
+    }
+    return ok;
+  }
+  TFLITE_LOG_PROD(TFLITE_LOG_ERROR, "unknown type of user_provided_attributes");
+  return false;
+}
+
+TfLiteStatus AsyncKernel::SetAttributes(TfLiteOpaqueContext* opaque_context,
+                                        TfLiteOpaqueNode* opaque_node,
+                                        int tensor_index,
+                                        const TfLiteAttributeMap* attrs) {
+  if (TfLiteAttributeMapIsBufferAttributeMap(attrs)) {
+    const BufferAttributes buffer_attrs = ReadBufferAttrs(attrs);
+    TFLITE_RET_CHECK_STATUS(
+        buffer_attrs.buffer_type.value_or(BufferType::kHostMemory) ==
+            BufferType::kHostMemory,
+        "calling SetAttributes with an unsupported buffer type");
+    return kTfLiteOk;
+  }
+  TFLITE_RET_CHECK_STATUS(
+      TfLiteAttributeMapIsSyncAttributeMap(attrs),
+      "calling SetAttributes with an invalid attribute map type");
+  const SyncAttributes sync_attrs = ReadSyncAttrs(attrs);
+  TFLITE_RET_CHECK_STATUS(
+      sync_attrs.sync_type.has_value() &&
+          sync_attrs.sync_type.value() != SyncType::kUnknown,
+      "calling SetAttributes with unknown sync object type name");
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  TFLITE_RET_CHECK_STATUS(!prepared_,
+                          "SetAttributes must be called before Prepare");
+  sync_type_by_tensor_index_[tensor_index] = sync_attrs.sync_type.value();
+  return kTfLiteOk;
+}
+
+TfLiteStatus AsyncKernel::Prepare(TfLiteOpaqueContext* opaque_context,
+                                  TfLiteOpaqueNode* opaque_node) {
+  const auto* node = reinterpret_cast<const TfLiteNode*>(opaque_node);
+  std::lock_guard<std::mutex> lock(mutex_);
+  TFLITE_RET_CHECK_STATUS(!prepared_, "Prepare must be called at most once");
+  for (int i = 0; i < node->outputs->size; ++i) {
+    const auto it = sync_type_by_tensor_index_.find(node->outputs->data[i]);
+    TFLITE_RET_CHECK_STATUS(
+        it == sync_type_by_tensor_index_.end() ||
+            it->second == SyncType::kNoSyncObj,
+        "output sync fences are not supported by the XNNPACK delegate");
+  }
+  for (int i = 0; i < node->inputs->size; ++i) {
+    const auto it = sync_type_by_tensor_index_.find(node->inputs->data[i]);
+    if (it != sync_type_by_tensor_index_.end() &&
+        it->second == SyncType::kSyncFenceFd) {
+      fenced_inputs_.push_back(node->inputs->data[i]);
+    }
+  }
+  worker_ = std::thread(&AsyncKernel::WorkerLoop, this);
+  prepared_ = true;
+  return kTfLiteOk;
+}
+
+TfLiteStatus AsyncKernel::RegisterBuffer(TfLiteOpaqueContext* opaque_context,
+                                         TfLiteIoType io_type,
+                                         const TfLiteBackendBuffer* buffer,
+                                         const TfLiteAttributeMap* attrs,
+                                         TfLiteBufferHandle handle) {
+  TFLITE_ABORT_CHECK(buffer != nullptr, "");                  // Crash OK
+  TFLITE_ABORT_CHECK(attrs != nullptr, "");                   // Crash OK
+  TFLITE_ABORT_CHECK(handle != kTfLiteNullBufferHandle, "");  // Crash OK
+
+  TFLITE_RET_CHECK_STATUS(
+      TfLiteAttributeMapIsBufferAttributeMap(attrs),
+      "calling RegisterBuffer with invalid attribute map type");
+  const BufferAttributes buffer_attrs = ReadBufferAttrs(attrs);
+  TFLITE_RET_CHECK_STATUS(
+      buffer_attrs.buffer_type.value_or(BufferType::kUnknown) ==
+          BufferType::kHostMemory,
+      "calling RegisterBuffer with a buffer type other than host memory");
+  TFLITE_RET_CHECK_STATUS(buffer_attrs.size.has_value(),
+                          "calling RegisterBuffer with buffer size unspecified");
+  char* data = static_cast<char*>(TfLiteBackendBufferGetPtr(buffer));
+  TFLITE_RET_CHECK_STATUS(data != nullptr,
+                          "calling RegisterBuffer with nullptr buffer");
+  const size_t offset = buffer_attrs.offset.value_or(0);
+  TFLITE_RET_CHECK_STATUS(offset <= buffer_attrs.size.value(),
+                          "calling RegisterBuffer with an out of range offset");
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  const bool inserted =
+      buffers_
+          .emplace(handle, Buffer{data + offset,
+                                  buffer_attrs.size.value() - offset,
+                                  /*is_slice=*/false})
+          .second;
+  TFLITE_RET_CHECK_STATUS(inserted,
+                          "RegisterBuffer called with duplicate handle");
+  return kTfLiteOk;
+}
+
+TfLiteStatus AsyncKernel::RegisterBufferSlice(
+    TfLiteOpaqueContext* opaque_context, TfLiteBufferHandle buffer_pool,
+    const TfLiteAttributeMap* attrs, TfLiteBufferHandle handle) {
+  TFLITE_ABORT_CHECK(attrs != nullptr, "");                   // Crash OK
+  TFLITE_ABORT_CHECK(handle != kTfLiteNullBufferHandle, "");  // Crash OK
+
+  TFLITE_RET_CHECK_STATUS(
+      TfLiteAttributeMapIsBufferAttributeMap(attrs),
+      "calling RegisterBufferSlice with invalid attribute map type");
+  const BufferAttributes buffer_attrs = ReadBufferAttrs(attrs);
+  const size_t offset = buffer_attrs.offset.value_or(0);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto pool = buffers_.find(buffer_pool);
+  TFLITE_RET_CHECK_STATUS(pool != buffers_.end() && !pool->second.is_slice,
+                          "RegisterBufferSlice called with unknown pool");
+  TFLITE_RET_CHECK_STATUS(offset <= pool->second.size,
+                          "calling RegisterBufferSlice with an out of range "
+                          "offset");
+  const size_t size = buffer_attrs.size.value_or(pool->second.size - offset);
+  TFLITE_RET_CHECK_STATUS(size <= pool->second.size - offset,
+                          "calling RegisterBufferSlice with a slice larger "
+                          "than the pool");
+  const bool inserted =
+      buffers_
+          .emplace(handle,
+                   Buffer{pool->second.data + offset, size, /*is_slice=*/true})
+          .second;
+  TFLITE_RET_CHECK_STATUS(inserted,
+                          "RegisterBufferSlice called with duplicate handle");
+  return kTfLiteOk;
+}
+
+TfLiteStatus AsyncKernel::UnregisterBuffer(TfLiteOpaqueContext* opaque_context,
+                                           TfLiteBufferHandle handle) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  TFLITE_RET_CHECK_STATUS(buffers_.erase(handle) != 0,
+                          "UnregisterBuffer called with unknown handle");
+  return kTfLiteOk;
+}
+
+TfLiteStatus AsyncKernel::Eval(TfLiteOpaqueContext* opaque_context,
+                               TfLiteOpaqueNode* opaque_node,
+                               TfLiteExecutionTask* task) {
+  auto* context = reinterpret_cast<TfLiteContext*>(opaque_context);
+  const auto* node = reinterpret_cast<const TfLiteNode*>(opaque_node);
+
+  Execution execution;
+  execution.task = task;
+  execution.context = context;
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  TFLITE_RET_CHECK_STATUS(prepared_, "Eval must be called after Prepare");
+
+  // Resolves the buffers now, so that binding errors are reported by Eval.
+  for (const TfLiteIntArray* tensors : {node->inputs, node->outputs}) {
+    for (int i = 0; i < tensors->size; ++i) {
+      const int t = tensors->data[i];
+      if (t < 0) continue;
+      const TfLiteBufferHandle handle =
+          TfLiteExecutionTaskGetBufferByIndex(task, t);
+      if (handle == kTfLiteNullBufferHandle) continue;
+      const auto it = buffers_.find(handle);
+      TFLITE_RET_CHECK_STATUS(it != buffers_.end(),
+                              "Eval called with an unknown buffer handle");
+      TFLITE_RET_CHECK_STATUS(
+          it->second.size >= context->tensors[t].bytes,
+          "Eval called with a buffer smaller than its tensor");
+      execution.data[t] = it->second.data;
+    }
+  }
+  for (int t : fenced_inputs_) {
+    TfLiteSynchronization* sync = TfLiteExecutionTaskGetSyncByIndex(task, t);
+    if (sync == nullptr) continue;
+    const int* fence = static_cast<int*>(TfLiteSynchronizationGetPtr(sync));
+    if (fence == nullptr || *fence == -1) continue;
+    if (std::find(execution.input_fences.begin(),
+                  execution.input_fences.end(),
+                  *fence) == execution.input_fences.end()) {
+      execution.input_fences.push_back(*fence);
+    }
+  }
+
+  TaskState* state = GetTaskState(task);
+  if (state == nullptr) {
+    state = new TaskState;
+    TfLiteExecutionTaskSetDelegateExecutionData(task, kernel_, state);
+  }
+  state->done = false;
+  executions_.push_back(std::move(execution));
+  lock.unlock();
+  work_available_.notify_one();
+  return kTfLiteOk;
+}
+
+TfLiteStatus AsyncKernel::Wait(TfLiteOpaqueContext* opaque_context,
+                               TfLiteExecutionTask* task) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  const TaskState* state = GetTaskState(task);
+  if (state == nullptr) return kTfLiteOk;
+  work_done_.wait(lock, [state] { return state->done; });
+  return state->status;
+}
+
+TfLiteStatus AsyncKernel::Finish(TfLiteOpaqueContext* opaque_context,
+                                 TfLiteExecutionTask* task) {
+  const TfLiteStatus status = Wait(opaque_context, task);
+  std::lock_guard<std::mutex> lock(mutex_);
+  delete GetTaskState(task);
+  TfLiteExecutionTaskSetDelegateExecutionData(task, kernel_, nullptr);
+  return status;
+}
+
+void AsyncKernel::WorkerLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    work_available_.wait(lock, [this] { return stop_ || !executions_.empty(); });
+    if (executions_.empty()) return;
+    Execution execution = std::move(executions_.front());
+    executions_.pop_front();
+    lock.unlock();
+    const TfLiteStatus status = Run(execution);
+    lock.lock();
+    TaskState* state = GetTaskState(execution.task);
+    state->status = status;
+    state->done = true;
+    work_done_.notify_all();
+  }
+}
+
+TfLiteStatus AsyncKernel::Run(Execution& execution) {
+  TfLiteStatus status = kTfLiteOk;
+  if (!::tflite::delegates::utils::WaitForAllFds(execution.input_fences)
+           .has_value()) {
+    TFLITE_LOG_PROD(TFLITE_LOG_ERROR,
+                    "failed to wait for the input sync fences");
+    status = kTfLiteError;
+  }
+  // The backend owns the input fences.
+  for (int fence : execution.input_fences) {
+    close(fence);
+  }
+  if (status != kTfLiteOk) return status;
+
+  TfLiteContext* context = execution.context;
+  return subgraph_->Invoke(context, [context, &execution](int t) {
+    const auto it = execution.data.find(t);
+    return it != execution.data.end() ? it->second
+                                      : context->tensors[t].data.raw;
+  });
+}
+
+void* AsyncSubgraphInit(TfLiteContext* context, const char* buffer,
+                        size_t length) {
+  const TfLiteDelegateParams* params =
+      reinterpret_cast<const TfLiteDelegateParams*>(buffer);
+
+  std::unique_ptr<Subgraph> subgraph(Subgraph::Create(
+      context, params,
+      *static_cast<::tflite::xnnpack::Delegate*>(params->delegate->data_)));
+  if (subgraph == nullptr) {
+    return nullptr;
+  }
+  return static_cast<void*>(new AsyncKernel(std::move(subgraph)));
+}
+
+TfLiteStatus AsyncSubgraphPrepare(TfLiteContext* context, TfLiteNode* node) {
+  if (node->user_data == nullptr) {
+    return kTfLiteError;
+  }
+
+  return static_cast<AsyncKernel*>(node->user_data)
+      ->subgraph()
+      ->Prepare(context);
+}
+
+TfLiteStatus AsyncSubgraphInvoke(TfLiteContext* context, TfLiteNode* node) {
+  if (node->user_data == nullptr) {
+    return kTfLiteError;
+  }
+
+  return static_cast<AsyncKernel*>(node->user_data)->subgraph()->Invoke(context);
+}
+
+void AsyncSubgraphFree(TfLiteContext* context, void* buffer) {
+  if (buffer != nullptr) {
+    delete static_cast<AsyncKernel*>(buffer);
+  }
+}
+
+TfLiteAsyncKernel* AsyncSubgraphAsyncKernel(TfLiteContext* context,
+                                            TfLiteNode* node) {
+  if (node->user_data == nullptr) {
+    return nullptr;
+  }
+
+  return static_cast<AsyncKernel*>(node->user_data)->kernel();
+}
+
+// The subgraphs can still be invoked synchronously, when no asynchronous
+// execution is in flight.
+const TfLiteRegistration kAsyncSubgraphRegistration = {
+    /*.init=*/AsyncSubgraphInit,
+    /*.free=*/AsyncSubgraphFree,
+    /*.prepare=*/AsyncSubgraphPrepare,
+    /*.invoke=*/AsyncSubgraphInvoke,
+    /*.profiling_string=*/nullptr,
+    /*.builtin_code=*/0,
+    /*.custom_name=*/"TfLiteXNNPackDelegate",
+    /*.version=*/2,
+    /*.registration_external=*/nullptr,
+    /*.async_kernel=*/AsyncSubgraphAsyncKernel,
+};
+#endif  // defined(__linux__)
+
 TfLiteStatus DelegatePrepare(TfLiteContext* context, TfLiteDelegate* delegate) {
   TfLiteIntArray* ops_to_replace =
       static_cast<::tflite::xnnpack::Delegate*>(delegate->data_)
@@ -6221,8 +6805,15 @@ TfLiteStatus DelegatePrepare(TfLiteContext* context, TfLiteDelegate* delegate) {
     return kTfLiteError;
   }
 
+  const TfLiteRegistration* registration = &kSubgraphRegistration;
+#if defined(__linux__)
+  if (static_cast<::tflite::xnnpack::Delegate*>(delegate->data_)
+          ->enable_async()) {
+    registration = &kAsyncSubgraphRegistration;
+  }
+#endif  // defined(__linux__)
   const TfLiteStatus status = context->ReplaceNodeSubsetsWithDelegateKernels(
-      context, kSubgraphRegistration, ops_to_replace, delegate);
+      context, *registration, ops_to_replace, delegate);
   TfLiteIntArrayFree(ops_to_replace);
   return status;
 }
@@ -32,6 +32,10 @@ extern "C" {
 // Enable XNNPACK acceleration for FULLY_CONNECTED operator with dynamic
 // weights.
 #define TFLITE_XNNPACK_DELEGATE_FLAG_DYNAMIC_FULLY_CONNECTED 0x00000008
+// Provide an asynchronous kernel, for use with the AsyncSignatureRunner, when
+// the model is fully delegated. The model can still be invoked synchronously.
+// Only supported on Linux and Android.
+#define TFLITE_XNNPACK_DELEGATE_FLAG_ENABLE_ASYNC 0x00000010
 
 struct TfLiteXNNPackDelegateWeightsCache;
 
@@ -44,6 +48,7 @@ typedef struct {
   // - TFLITE_XNNPACK_DELEGATE_FLAG_QU8
   // - TFLITE_XNNPACK_DELEGATE_FLAG_FORCE_FP16
   // - TFLITE_XNNPACK_DELEGATE_FLAG_DYNAMIC_FULLY_CONNECTED
+  // - TFLITE_XNNPACK_DELEGATE_FLAG_ENABLE_ASYNC
   uint32_t flags;
   // Cache for packed weights, can be shared between multiple instances of
   // delegates.
@@ -1933,6 +1933,43 @@ TEST_P(SparseFullyConnectedOpTest, Simple1x4TestMultiThreadedMoreBatches) {
   }
 }
 
+TEST_P(SparseFullyConnectedOpTest, Simple4x4Test) {
+  std::initializer_list<float> weight_data = {
+      1, 2, 3, 4, 0,  0,  0,  0,   // u = 0
+      2, 3, 4, 5, 0,  0,  0,  0,   // u = 1
+      3, 4, 5, 6, 0,  0,  0,  0,   // u = 2
+      4, 5, 6, 7, 0,  0,  0,  0,   // u = 3
+      0, 0, 0, 0, -1, 1,  -1, 1,   // u = 4
+      0, 0, 0, 0, 1,  -1, 1,  -1,  // u = 5
+      0, 0, 0, 0, 2,  0,  2,  0,   // u = 6
+      0, 0, 0, 0, 0,  -2, 0,  -2,  // u = 7
+  };
+  TensorData weight = {};
+  weight.type = TensorType_FLOAT32;
+  weight.shape = {8, 8};
+  weight.traversal_order = {0, 1, 2, 3};
+  weight.format = {kTfLiteDimDense, kTfLiteDimSparseCSR};
+  weight.block_map = {0, 1};
+  weight.block_size = {4, 4};
+  SparseFullyConnectedOpModel<float> m(
+      GetRegistration(),
+      /*units=*/8, /*batches=*/2,
+      /*input=*/{TensorType_FLOAT32, {2, 8}}, weight, weight_data);
+  m.SetBias({1, 2, 3, 4, 5, 6, 7, 8});
+
+  m.SetInput({
+      1, 1, 1,  1,  1, 2, 3, 4,  // b = 0
+      1, -1, 1, -1, 4, 3, 2, 1,  // b = 1
+  });
+
+  ASSERT_EQ(m.Invoke(), kTfLiteOk);
+
+  EXPECT_THAT(m.GetOutputShape(), ElementsAre(2, 8));
+  EXPECT_THAT(m.GetOutput(), ElementsAre(11, 16, 21, 26, 7, 4, 15, 0,  // b = 0
+                                         0, 0, 1, 2, 3, 8, 19, 0     // b = 1
+                                         ));
+}
+
 TEST_P(SparseHybridFullyConnectedOpTest, SparseHybrid1x16Test) {
   std::initializer_list<float> weight_data = {
       /* 1st row */
@@ -2218,6 +2255,34 @@ TEST_P(SparseQuantizedFullyConnectedOpTest, Simple1x16TestScaledInputOutput) {
   EXPECT_THAT(m.GetOutput(), ElementsAre(-52, -50, -52));
 }
 
+TEST_P(SparseQuantizedFullyConnectedOpTest, Simple1x4Test) {
+  std::vector<float> weight_data = {
+      1, 2,  3, 4,  0, 0, 0, 0, 1, 1, 1, 1, -1, -1, -1, -1, 2, 0, 0, 2,  // u = 0
+      1, -1, 1, -1, 1, 1, 1, 1, 1, 0, 0, 0, -2, 2,  -2, 2,  1, 2, 3, 4,  // u = 1
+  };
+  TensorData weight = {TensorType_INT8, {2, 20}, 0, 0, 1};
+  weight.traversal_order = {0, 1, 2};
+  weight.format = {kTfLiteDimDense, kTfLiteDimSparseCSR};
+  weight.block_map = {1};
+  weight.block_size = {4};
+  SparseQuantizedFullyConnectedOpModel m(
+      GetRegistration(),
+      /*units=*/2, /*batches=*/2,
+      /*input=*/{TensorType_INT8, {2, 20}, 0, 0, 1, -10}, weight, weight_data,
+      /*output=*/{TensorType_INT8, {}, 0, 0, 1});
+
+  m.SetBias({1, 2});
+  m.SetInput({
+      1, 2, 3, 4, 5, 6, 7, 8, 1, 2, 3, 4, 1, 1, 1, 1, 2, 2, 2, 2,  // b = 0
+      1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,  // b = 1
+  });
+
+  ASSERT_EQ(m.Invoke(), kTfLiteOk);
+
+  EXPECT_THAT(m.GetOutputShape(), ElementsAre(2, 2));
+  EXPECT_THAT(m.GetOutput(), ElementsAre(45, 47, 15, 17));
+}
+
 INSTANTIATE_TEST_SUITE_P(
     SparseQuantizedFullyConnectedOpTest, SparseQuantizedFullyConnectedOpTest,
     ::testing::ValuesIn(SingleOpTest::GetKernelTags(*kKernelMapNoPie)));
@@ -20,6 +20,9 @@ limitations under the License.
 
 // NOLINTBEGIN
 #include <tmmintrin.h>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 
 #include <algorithm>
 #include <cstdlib>
@@ -324,6 +327,32 @@ inline __m128i ReduceInt32x4x4(__m128i a, __m128i b, __m128i c, __m128i d) {
   return _mm_add_epi32(all_evns, all_odds);    // [a0123, b0123, c0123, d0123]
 }
 
+#ifdef __AVX2__
+// Dot product of the 4-bit filter values, unpacked to one byte each, with the
+// int8 inputs, accumulated into eight int32. The filter values are in [0, 15],
+// so they can be used as the unsigned operand as is, and the sums of pairs of
+// products fit in int16.
+inline __m256i DotProdUint8Int8x4x8(__m256i acc_32x8, __m256i a_8x32,
+                                    __m256i b_8x32) {
+#if defined(__AVX512VNNI__) && defined(__AVX512VL__)
+  return _mm256_dpbusd_epi32(acc_32x8, a_8x32, b_8x32);
+#elif defined(__AVXVNNI__)
+  return _mm256_dpbusd_avx_epi32(acc_32x8, a_8x32, b_8x32);
+#else
+  const __m256i sumprod_16x16 = _mm256_maddubs_epi16(a_8x32, b_8x32);
+  const __m256i ones_16x16 = _mm256_set1_epi16(1);
+  return _mm256_add_epi32(acc_32x8,
+                          _mm256_madd_epi16(sumprod_16x16, ones_16x16));
+#endif
+}
+
+// Adds the upper and lower halves of a YMM register.
+inline __m128i FoldInt32x8(__m256i a) {
+  return _mm_add_epi32(_mm256_castsi256_si128(a),
+                       _mm256_extracti128_si256(a, 1));
+}
+#endif  // __AVX2__
+
 template <int RowsLeft, int RowsRight, int Cols>
 void SseRunKernel(const uint8_t* lhs, const int8_t* rhs, int32_t* dst,
                   int lhs_layout_rows, int lhs_layout_cols, int rhs_layout_rows,
@@ -359,6 +388,41 @@ void SseRunKernel(const uint8_t* lhs, const int8_t* rhs, int32_t* dst,
       const uint8_t* lhs_val = lhs_val_data;
       int right_index = j * RowsRight * rhs_layout_cols;
       const int8_t* rhs_val = rhs + right_index;
+#ifdef __AVX2__
+      // Both halves of the 32 values of a block are multiplied at once: the
+      // upper 4 bits of the filter bytes with the first 16 inputs in the lower
+      // lane, and the lower 4 bits with the next 16 inputs in the upper lane.
+      __m256i accum[RowsRight * RowsLeft];
+      for (int m = 0; m < (RowsLeft * RowsRight); ++m) {
+        accum[m] = _mm256_setzero_si256();
+      }
+      for (int k = 0; k < depth; ++k) {
+        __m256i lhs_row_8[RowsLeft];
+        for (int m = 0; m < RowsLeft; ++m) {
+          const __m128i lhs_row = _mm_load_si128((__m128i*)(lhs_val));
+          lhs_val += 16;
+          lhs_row_8[m] = _mm256_set_m128i(
+              _mm_and_si128(lhs_row, bitmask),
+              _mm_and_si128(_mm_srli_epi16(lhs_row, 4), bitmask));
+        }
+        for (int r = 0; r < RowsRight; ++r) {
+          const __m256i rhs_row = _mm256_loadu_si256((__m256i*)(rhs_val));
+          rhs_val += 32;
+          for (int l = 0; l < RowsLeft; ++l) {
+            accum[r * RowsLeft + l] = DotProdUint8Int8x4x8(
+                accum[r * RowsLeft + l], lhs_row_8[l], rhs_row);
+          }
+        }
+      }
+      for (int r = 0; r < RowsRight; ++r) {
+        __m128i sum = ReduceInt32x4x4(FoldInt32x8(accum[r * RowsLeft]),
+                                      FoldInt32x8(accum[r * RowsLeft + 1]),
+                                      FoldInt32x8(accum[r * RowsLeft + 2]),
+                                      FoldInt32x8(accum[r * RowsLeft + 3]));
+        _mm_storeu_si128((__m128i*)elementPtr, sum);
+        elementPtr += 4;
+      }
+#else
       __m128i accum[RowsRight * RowsLeft];
       for (int m = 0; m < (RowsLeft * RowsRight); ++m) {
         accum[m] = _mm_set1_epi8(0);
@@ -400,6 +464,7 @@ void SseRunKernel(const uint8_t* lhs, const int8_t* rhs, int32_t* dst,
         _mm_storeu_si128((__m128i*)elementPtr, sum);
         elementPtr += 4;
       }
+#endif  // __AVX2__
     }
   }
   if (lhs_vec != nullptr) {
@@ -1955,6 +1955,55 @@ void NeonSparseMatrixBatchVectorMultiplyAccumulate1x4(
   }
 }
 
+void NeonSparseMatrixBatchVectorMultiplyAccumulate4x4(
+    const float* __restrict__ matrix, const int32_t* __restrict__ segments,
+    const int32_t* __restrict__ indices, int m_rows, int m_cols,
+    const float* __restrict__ vector, int n_batch, float* __restrict__ result) {
+  constexpr int kBlockSize = kFloatValuesPerNeonVector;
+  TFLITE_DCHECK_EQ(m_rows % kBlockSize, 0);
+  TFLITE_DCHECK_EQ(m_cols % kBlockSize, 0);
+
+  for (int batch = 0; batch < n_batch; batch++) {
+    const float* matrix_ptr = matrix;
+    const float* vector_in_batch = vector + batch * m_cols;
+    for (int block_row = 0; block_row < m_rows / kBlockSize; block_row++) {
+      // One accumulator per row of the blocks.
+      float32x4_t acc0_32x4 = vmovq_n_f32(0.0);
+      float32x4_t acc1_32x4 = vmovq_n_f32(0.0);
+      float32x4_t acc2_32x4 = vmovq_n_f32(0.0);
+      float32x4_t acc3_32x4 = vmovq_n_f32(0.0);
+
+      for (int i = segments[block_row]; i < segments[block_row + 1]; i++) {
+        // The 4 vector values are shared by the 4 rows of the block.
+        const float32x4_t vector_f32x4 =
+            vld1q_f32(vector_in_batch + indices[i] * kBlockSize);
+        acc0_32x4 = vmlaq_f32(acc0_32x4, vld1q_f32(matrix_ptr), vector_f32x4);
+        acc1_32x4 =
+            vmlaq_f32(acc1_32x4, vld1q_f32(matrix_ptr + 4), vector_f32x4);
+        acc2_32x4 =
+            vmlaq_f32(acc2_32x4, vld1q_f32(matrix_ptr + 8), vector_f32x4);
+        acc3_32x4 =
+            vmlaq_f32(acc3_32x4, vld1q_f32(matrix_ptr + 12), vector_f32x4);
+        matrix_ptr += kBlockSize * kBlockSize;
+      }
+      float* result_in_block = result + batch * m_rows + block_row * kBlockSize;
+#ifdef __aarch64__
+      // Pairwise additions reduce the 4 accumulators at once.
+      const float32x4_t sums_32x4 =
+          vpaddq_f32(vpaddq_f32(acc0_32x4, acc1_32x4),
+                     vpaddq_f32(acc2_32x4, acc3_32x4));
+      vst1q_f32(result_in_block,
+                vaddq_f32(vld1q_f32(result_in_block), sums_32x4));
+#else
+      result_in_block[0] += AccumulateNeonLane(acc0_32x4);
+      result_in_block[1] += AccumulateNeonLane(acc1_32x4);
+      result_in_block[2] += AccumulateNeonLane(acc2_32x4);
+      result_in_block[3] += AccumulateNeonLane(acc3_32x4);
+#endif
+    }
+  }
+}
+
 void NeonSparseMatrixBatchVectorMultiplyAccumulate1x16(
     const int8_t* __restrict__ matrix, const int32_t* __restrict__ segments,
     const int32_t* __restrict__ indices, int m_rows, int m_cols,
@@ -2031,6 +2080,74 @@ void NeonSparseMatrixBatchVectorMultiplyAccumulate1x16(
   }
 }
 
+void NeonSparseMatrixBatchVectorMultiplyAccumulate1x4(
+    const int8_t* __restrict__ matrix, const int32_t* __restrict__ segments,
+    const int32_t* __restrict__ indices, int m_rows, int m_cols,
+    const int8_t* __restrict__ vector, const int32_t* __restrict__ bias_vector,
+    int n_batch, const int32_t input_offset, const int32_t output_multiplier,
+    const int32_t output_shift, const int32_t output_offset,
+    const int32_t output_activation_min, const int32_t output_activation_max,
+    int8_t* __restrict__ result) {
+  constexpr int kBlockSize = 4;
+  TFLITE_DCHECK_EQ(m_cols % kBlockSize, 0);
+
+  for (int batch = 0; batch < n_batch; ++batch) {
+    const int8_t* matrix_ptr = matrix;
+    const int8_t* vector_in_batch = vector + batch * m_cols;
+    for (int row = 0; row < m_rows; ++row) {
+      int32x4_t acc_i32x4 = vmovq_n_s32(0);
+      int32x4_t matrix_row_sum_i32x4 = vmovq_n_s32(0);
+
+      // Two blocks at a time: the blocks of a row are contiguous in the
+      // matrix, while their vector values are gathered in the two lanes.
+      int i = segments[row];
+      for (; i + 1 < segments[row + 1]; i += 2) {
+        int32_t vector_block0, vector_block1;
+        memcpy(&vector_block0, vector_in_batch + indices[i] * kBlockSize,
+               sizeof(int32_t));
+        memcpy(&vector_block1, vector_in_batch + indices[i + 1] * kBlockSize,
+               sizeof(int32_t));
+        const int8x8_t vector_i8x8 = vreinterpret_s8_s32(
+            vset_lane_s32(vector_block1, vdup_n_s32(vector_block0), 1));
+        const int8x8_t matrix_i8x8 = vld1_s8(matrix_ptr);
+        acc_i32x4 = vpadalq_s16(acc_i32x4, vmull_s8(vector_i8x8, matrix_i8x8));
+        matrix_row_sum_i32x4 =
+            vpadalq_s16(matrix_row_sum_i32x4, vmovl_s8(matrix_i8x8));
+        matrix_ptr += 2 * kBlockSize;
+      }
+      int32_t acc = 0;
+      int32_t matrix_row_sum = 0;
+      if (i < segments[row + 1]) {
+        const int8_t* vector_block_in_batch_ptr =
+            vector_in_batch + indices[i] * kBlockSize;
+        for (int c = 0; c < kBlockSize; ++c) {
+          acc += matrix_ptr[c] * vector_block_in_batch_ptr[c];
+          matrix_row_sum += matrix_ptr[c];
+        }
+        matrix_ptr += kBlockSize;
+      }
+#ifdef __aarch64__
+      acc += vaddvq_s32(acc_i32x4);
+      matrix_row_sum += vaddvq_s32(matrix_row_sum_i32x4);
+#else
+      acc += vgetq_lane_s32(acc_i32x4, 0) + vgetq_lane_s32(acc_i32x4, 1) +
+             vgetq_lane_s32(acc_i32x4, 2) + vgetq_lane_s32(acc_i32x4, 3);
+      matrix_row_sum += vgetq_lane_s32(matrix_row_sum_i32x4, 0) +
+                        vgetq_lane_s32(matrix_row_sum_i32x4, 1) +
+                        vgetq_lane_s32(matrix_row_sum_i32x4, 2) +
+                        vgetq_lane_s32(matrix_row_sum_i32x4, 3);
+#endif
+      const int32_t bias_value = bias_vector != nullptr ? bias_vector[row] : 0;
+      acc = acc + bias_value + input_offset * matrix_row_sum;
+      acc = MultiplyByQuantizedMultiplier(acc, output_multiplier, output_shift);
+      acc += output_offset;
+      result[batch * m_rows + row] =
+          static_cast<int8_t>(ActivationFunctionWithMinMax(
+              acc, output_activation_min, output_activation_max));
+    }
+  }
+}
+
 void NeonSparseMatrixBatchVectorMultiplyAccumulate(
     const float* __restrict__ matrix, const uint8_t* __restrict__ ledger,
     int m_rows, int m_cols, const float* __restrict__ vector, int n_batch,
@@ -31,6 +31,7 @@ limitations under the License.
 #include "tensorflow/lite/kernels/cpu_backend_context.h"
 #include "tensorflow/lite/kernels/cpu_backend_gemm.h"
 #include "tensorflow/lite/kernels/cpu_backend_gemm_params.h"
+#include "tensorflow/lite/kernels/internal/common.h"
 #include "tensorflow/lite/kernels/internal/compatibility.h"
 
 namespace tflite {
@@ -617,6 +618,108 @@ void SseSparseMatrixBatchVectorMultiplyAccumulate(
   }  // for batch
 }
 
+void SseSparseMatrixBatchVectorMultiplyAccumulate4x4(
+    const float* __restrict__ matrix, const int32_t* __restrict__ segments,
+    const int32_t* __restrict__ indices, int m_rows, int m_cols,
+    const float* __restrict__ vector, int n_batch, float* __restrict__ result) {
+  constexpr int kBlockSize = 4;
+  TFLITE_DCHECK_EQ(m_rows % kBlockSize, 0);
+  TFLITE_DCHECK_EQ(m_cols % kBlockSize, 0);
+
+  for (int batch = 0; batch < n_batch; ++batch) {
+    const float* matrix_ptr = matrix;
+    const float* vector_in_batch = vector + batch * m_cols;
+    for (int block_row = 0; block_row < m_rows / kBlockSize; ++block_row) {
+      // One accumulator per row of the blocks.
+      __m128 acc0_fx4 = _mm_setzero_ps();
+      __m128 acc1_fx4 = _mm_setzero_ps();
+      __m128 acc2_fx4 = _mm_setzero_ps();
+      __m128 acc3_fx4 = _mm_setzero_ps();
+      for (int i = segments[block_row]; i < segments[block_row + 1]; ++i) {
+        // The 4 vector values are shared by the 4 rows of the block.
+        const __m128 vector_fx4 =
+            _mm_loadu_ps(vector_in_batch + indices[i] * kBlockSize);
+        acc0_fx4 = _mm_add_ps(
+            acc0_fx4, _mm_mul_ps(_mm_loadu_ps(matrix_ptr), vector_fx4));
+        acc1_fx4 = _mm_add_ps(
+            acc1_fx4, _mm_mul_ps(_mm_loadu_ps(matrix_ptr + 4), vector_fx4));
+        acc2_fx4 = _mm_add_ps(
+            acc2_fx4, _mm_mul_ps(_mm_loadu_ps(matrix_ptr + 8), vector_fx4));
+        acc3_fx4 = _mm_add_ps(
+            acc3_fx4, _mm_mul_ps(_mm_loadu_ps(matrix_ptr + 12), vector_fx4));
+        matrix_ptr += kBlockSize * kBlockSize;
+      }
+      // Horizontal additions reduce the 4 accumulators at once.
+      const __m128 sums_fx4 = _mm_hadd_ps(_mm_hadd_ps(acc0_fx4, acc1_fx4),
+                                          _mm_hadd_ps(acc2_fx4, acc3_fx4));
+      float* result_in_block = result + batch * m_rows + block_row * kBlockSize;
+      _mm_storeu_ps(result_in_block,
+                    _mm_add_ps(_mm_loadu_ps(result_in_block), sums_fx4));
+    }
+  }
+}
+
+void SseSparseMatrixBatchVectorMultiplyAccumulate1x4(
+    const int8_t* __restrict__ matrix, const int32_t* __restrict__ segments,
+    const int32_t* __restrict__ indices, int m_rows, int m_cols,
+    const int8_t* __restrict__ vector, const int32_t* __restrict__ bias_vector,
+    int n_batch, const int32_t input_offset, const int32_t output_multiplier,
+    const int32_t output_shift, const int32_t output_offset,
+    const int32_t output_activation_min, const int32_t output_activation_max,
+    int8_t* __restrict__ result) {
+  constexpr int kBlockSize = 4;
+  constexpr int kBlocksPerXmm = 4;
+  TFLITE_DCHECK_EQ(m_cols % kBlockSize, 0);
+  const __m128i ones_8x16 = _mm_set1_epi8(1);
+
+  for (int batch = 0; batch < n_batch; ++batch) {
+    const int8_t* matrix_ptr = matrix;
+    const int8_t* vector_in_batch = vector + batch * m_cols;
+    for (int row = 0; row < m_rows; ++row) {
+      __m128i dotprod_32x4 = _mm_setzero_si128();
+      __m128i row_sum_32x4 = _mm_setzero_si128();
+      // Four blocks at a time: the blocks of a row are contiguous in the
+      // matrix, while their vector values are gathered in the four lanes.
+      int i = segments[row];
+      for (; i + kBlocksPerXmm <= segments[row + 1]; i += kBlocksPerXmm) {
+        const __m128i vec_8x16 = _mm_unpacklo_epi64(
+            _mm_unpacklo_epi32(
+                _mm_loadu_si32(vector_in_batch + indices[i] * kBlockSize),
+                _mm_loadu_si32(vector_in_batch + indices[i + 1] * kBlockSize)),
+            _mm_unpacklo_epi32(
+                _mm_loadu_si32(vector_in_batch + indices[i + 2] * kBlockSize),
+                _mm_loadu_si32(vector_in_batch +
+                               indices[i + 3] * kBlockSize)));
+        const __m128i row_8x16 =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(matrix_ptr));
+        dotprod_32x4 =
+            _mm_add_epi32(dotprod_32x4, DotProdInt8x4x4(vec_8x16, row_8x16));
+        row_sum_32x4 =
+            _mm_add_epi32(row_sum_32x4, DotProdInt8x4x4(ones_8x16, row_8x16));
+        matrix_ptr += kBlocksPerXmm * kBlockSize;
+      }
+      int32_t dotprod = ReduceInt32x4(dotprod_32x4);
+      int32_t row_sum = ReduceInt32x4(row_sum_32x4);
+      for (; i < segments[row + 1]; ++i) {
+        const int8_t* vector_block_in_batch_ptr =
+            vector_in_batch + indices[i] * kBlockSize;
+        for (int c = 0; c < kBlockSize; ++c) {
+          dotprod += *matrix_ptr * vector_block_in_batch_ptr[c];
+          row_sum += *matrix_ptr++;
+        }
+      }
+      const int32_t bias_value = bias_vector != nullptr ? bias_vector[row] : 0;
+      dotprod += bias_value + input_offset * row_sum;
+      dotprod = MultiplyByQuantizedMultiplier(dotprod, output_multiplier,
+                                              output_shift);
+      dotprod += output_offset;
+      result[batch * m_rows + row] =
+          static_cast<int8_t>(ActivationFunctionWithMinMax(
+              dotprod, output_activation_min, output_activation_max));
+    }
+  }
+}
+
 void SseReductionSumVector(const int8_t* input_vector, int32_t* output_vector,
                            const int output_size, const int reduction_size) {
   static constexpr std::intptr_t kBlockSize = 16;
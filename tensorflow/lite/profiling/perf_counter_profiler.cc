@@ -0,0 +1,204 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/profiling/perf_counter_profiler.h"
+
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace tflite {
+namespace profiling {
+
+#ifdef __linux__
+namespace {
+
+constexpr uint64_t kPerfEventConfigs[PerfCounterProfiler::kNumCounters] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_REFERENCES,
+    PERF_COUNT_HW_CACHE_MISSES,
+};
+
+int PerfEventOpen(uint64_t config, int group_fd) {
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = config;
+  attr.read_format = PERF_FORMAT_GROUP;
+  attr.disabled = group_fd < 0 ? 1 : 0;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  return static_cast<int>(syscall(__NR_perf_event_open, &attr, /*pid=*/0,
+                                  /*cpu=*/-1, group_fd, /*flags=*/0));
+}
+
+}  // namespace
+#endif  // __linux__
+
+PerfCounterProfiler::~PerfCounterProfiler() {
+#ifdef __linux__
+  for (int fd : fds_) {
+    close(fd);
+  }
+#endif
+}
+
+bool PerfCounterProfiler::OpenCounters() {
+#ifdef __linux__
+  for (uint64_t config : kPerfEventConfigs) {
+    const int fd = PerfEventOpen(config, fds_.empty() ? -1 : fds_[0]);
+    if (fd < 0) {
+      for (int opened_fd : fds_) {
+        close(opened_fd);
+      }
+      fds_.clear();
+      return false;
+    }
+    fds_.push_back(fd);
+  }
+  ioctl(fds_[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(fds_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  group_fd_ = fds_[0];
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool PerfCounterProfiler::ReadCounters(uint64_t* values) const {
+#ifdef __linux__
+  // Layout of a group read without any other read_format flag.
+  struct {
+    uint64_t nr;
+    uint64_t values[kNumCounters];
+  } data;
+  if (read(group_fd_, &data, sizeof(data)) != sizeof(data) ||
+      data.nr != kNumCounters) {
+    return false;
+  }
+  std::memcpy(values, data.values, sizeof(data.values));
+  return true;
+#else
+  return false;
+#endif
+}
+
+uint32_t PerfCounterProfiler::BeginEvent(const char* tag,
+                                         EventType event_type,
+                                         int64_t event_metadata1,
+                                         int64_t event_metadata2) {
+  if (!enabled_ || (event_type != EventType::OPERATOR_INVOKE_EVENT &&
+                    event_type != EventType::DELEGATE_OPERATOR_INVOKE_EVENT)) {
+    return 0;
+  }
+  if (!counters_opened_) {
+    counters_opened_ = true;
+    OpenCounters();
+  }
+  if (!IsSupported()) return 0;
+
+  // For operators, the first metadata is the node index and the second one the
+  // subgraph index.
+  const auto key = std::make_pair(event_metadata2, event_metadata1);
+  auto it = op_indices_.find(key);
+  if (it == op_indices_.end()) {
+    it = op_indices_.emplace(key, ops_.size()).first;
+    OpCounters op;
+    op.tag = tag != nullptr ? tag : "";
+    op.node_index = event_metadata1;
+    op.subgraph_index = event_metadata2;
+    ops_.push_back(op);
+  }
+
+  OpenEvent event;
+  event.op_index = it->second;
+  // Read last, so that the bookkeeping above isn't counted.
+  if (!ReadCounters(event.begin_values)) return 0;
+  open_events_.push_back(event);
+  return open_events_.size();
+}
+
+void PerfCounterProfiler::EndEvent(uint32_t event_handle) {
+  if (event_handle == 0 || event_handle > open_events_.size()) return;
+  uint64_t end_values[kNumCounters];
+  const bool counters_read = ReadCounters(end_values);
+  const OpenEvent& event = open_events_[event_handle - 1];
+  if (counters_read) {
+    OpCounters& op = ops_[event.op_index];
+    ++op.num_invocations;
+    for (int i = 0; i < kNumCounters; ++i) {
+      op.values[i] += end_values[i] - event.begin_values[i];
+    }
+  }
+  // The events of the operators nested in a control flow operator end before
+  // it, so this only drops the events that were never ended.
+  open_events_.resize(event_handle - 1);
+}
+
+void PerfCounterProfiler::Reset() {
+  open_events_.clear();
+  op_indices_.clear();
+  ops_.clear();
+}
+
+std::string PerfCounterProfiler::GetOutputString() const {
+  std::stringstream stream;
+  if (!IsSupported()) {
+    stream << "Hardware performance counters are not available.\n";
+    return stream.str();
+  }
+  stream << "Average hardware counters per operator invocation (user space, "
+            "invoking thread only):\n";
+  stream << std::setw(10) << "subgraph" << std::setw(8) << "node"
+         << std::setw(24) << "op" << std::setw(14) << "cycles" << std::setw(14)
+         << "instructions" << std::setw(8) << "IPC" << std::setw(14)
+         << "LLC misses" << std::setw(12) << "miss rate" << std::setw(14)
+         << "DRAM bytes"
+         << "\n";
+  stream << std::fixed;
+  for (const OpCounters& op : ops_) {
+    if (op.num_invocations == 0) continue;
+    const double n = op.num_invocations;
+    const double cycles = op.values[kCycles] / n;
+    const double instructions = op.values[kInstructions] / n;
+    const double references = op.values[kCacheReferences] / n;
+    const double misses = op.values[kCacheMisses] / n;
+    stream << std::setw(10) << op.subgraph_index << std::setw(8)
+           << op.node_index << std::setw(24) << op.tag << std::setprecision(0)
+           << std::setw(14) << cycles << std::setw(14) << instructions
+           << std::setprecision(2) << std::setw(8)
+           << (cycles > 0 ? instructions / cycles : 0.0)
+           << std::setprecision(0) << std::setw(14) << misses
+           << std::setprecision(3) << std::setw(12)
+           << (references > 0 ? misses / references : 0.0)
+           << std::setprecision(0) << std::setw(14) << misses * kCacheLineBytes
+           << "\n";
+  }
+  return stream.str();
+}
+
+}  // namespace profiling
+}  // namespace tflite
@@ -0,0 +1,121 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_PROFILING_PERF_COUNTER_PROFILER_H_
+#define TENSORFLOW_LITE_PROFILING_PERF_COUNTER_PROFILER_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "tensorflow/lite/core/api/profiler.h"
+
+namespace tflite {
+namespace profiling {
+
+// Profiler reading the hardware performance counters around every operator
+// invocation, through Linux perf events, to tell whether an operator is compute
+// or memory bound.
+//
+// The counters are those of the thread invoking the interpreter, opened when
+// the first operator event begins: the work done by the threads of the CPU
+// backends isn't counted, so the counts are the most meaningful with a single
+// thread. The memory traffic is estimated from the last level cache misses,
+// assuming a line of kCacheLineBytes per miss. Only user space is counted, so
+// that the counters are available with the default perf_event_paranoid level.
+//
+// On other platforms, or when perf events are not available, e.g. in a virtual
+// machine without a PMU, no counter is recorded and IsSupported() is false.
+//
+// This class is *not thread safe*.
+class PerfCounterProfiler : public tflite::Profiler {
+ public:
+  enum Counter {
+    kCycles = 0,
+    kInstructions,
+    kCacheReferences,
+    kCacheMisses,
+    kNumCounters,
+  };
+
+  static constexpr int kCacheLineBytes = 64;
+
+  // The counters of an operator, summed over its invocations.
+  struct OpCounters {
+    std::string tag;
+    int64_t node_index = 0;
+    int64_t subgraph_index = 0;
+    int64_t num_invocations = 0;
+    uint64_t values[kNumCounters] = {};
+  };
+
+  PerfCounterProfiler() = default;
+  ~PerfCounterProfiler() override;
+
+  PerfCounterProfiler(const PerfCounterProfiler&) = delete;
+  PerfCounterProfiler& operator=(const PerfCounterProfiler&) = delete;
+
+  uint32_t BeginEvent(const char* tag, EventType event_type,
+                      int64_t event_metadata1,
+                      int64_t event_metadata2) override;
+
+  void EndEvent(uint32_t event_handle) override;
+
+  // Returns false if the counters couldn't be opened. Only meaningful once an
+  // operator event began.
+  bool IsSupported() const { return group_fd_ >= 0; }
+
+  // Sets whether counters are recorded.
+  void SetEnabled(bool enabled) { enabled_ = enabled; }
+
+  // Clears the recorded counters.
+  void Reset();
+
+  // Returns the counters of every operator, in the order in which they were
+  // first invoked.
+  const std::vector<OpCounters>& GetOpCounters() const { return ops_; }
+
+  // Returns a table of the average counters per invocation of every operator.
+  std::string GetOutputString() const;
+
+ private:
+  struct OpenEvent {
+    size_t op_index;
+    uint64_t begin_values[kNumCounters];
+  };
+
+  // Opens the counters of the calling thread. Returns false on failure.
+  bool OpenCounters();
+
+  // Reads all the counters at once. Returns false on failure.
+  bool ReadCounters(uint64_t* values) const;
+
+  bool enabled_ = true;
+  bool counters_opened_ = false;
+  // File descriptors of the counters, the first one leading the group.
+  int group_fd_ = -1;
+  std::vector<int> fds_;
+
+  std::vector<OpenEvent> open_events_;
+  // Index in ops_ of every (subgraph index, node index).
+  std::map<std::pair<int64_t, int64_t>, size_t> op_indices_;
+  std::vector<OpCounters> ops_;
+};
+
+}  // namespace profiling
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_PROFILING_PERF_COUNTER_PROFILER_H_
@@ -0,0 +1,100 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/profiling/perf_counter_profiler.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "tensorflow/lite/core/api/profiler.h"
+
+namespace tflite {
+namespace profiling {
+namespace {
+
+using EventType = Profiler::EventType;
+
+// Busy loop the compiler can't optimize away.
+int64_t Spin(int iterations) {
+  volatile int64_t sum = 0;
+  for (int i = 0; i < iterations; ++i) sum += i;
+  return sum;
+}
+
+TEST(PerfCounterProfilerTest, IgnoresNonOperatorEvents) {
+  PerfCounterProfiler profiler;
+  uint32_t handle = profiler.BeginEvent("Invoke", EventType::DEFAULT, 0, 0);
+  EXPECT_EQ(handle, 0);
+  profiler.EndEvent(handle);
+  handle = profiler.BeginEvent("AllocateTensors",
+                               EventType::GENERAL_RUNTIME_INSTRUMENTATION_EVENT,
+                               0, 0);
+  EXPECT_EQ(handle, 0);
+  profiler.EndEvent(handle);
+  EXPECT_TRUE(profiler.GetOpCounters().empty());
+}
+
+TEST(PerfCounterProfilerTest, CountsPerOperator) {
+  PerfCounterProfiler profiler;
+  for (int run = 0; run < 3; ++run) {
+    uint32_t handle = profiler.BeginEvent(
+        "ADD", EventType::OPERATOR_INVOKE_EVENT, /*event_metadata1=*/0,
+        /*event_metadata2=*/0);
+    Spin(1000);
+    profiler.EndEvent(handle);
+    handle = profiler.BeginEvent("CONV_2D", EventType::OPERATOR_INVOKE_EVENT,
+                                 /*event_metadata1=*/1,
+                                 /*event_metadata2=*/0);
+    Spin(100000);
+    profiler.EndEvent(handle);
+  }
+  if (!profiler.IsSupported()) {
+    EXPECT_TRUE(profiler.GetOpCounters().empty());
+    EXPECT_NE(profiler.GetOutputString().find("not available"),
+              std::string::npos);
+    GTEST_SKIP() << "Hardware performance counters are not available.";
+  }
+
+  const std::vector<PerfCounterProfiler::OpCounters>& ops =
+      profiler.GetOpCounters();
+  ASSERT_EQ(ops.size(), 2);
+  EXPECT_EQ(ops[0].tag, "ADD");
+  EXPECT_EQ(ops[0].node_index, 0);
+  EXPECT_EQ(ops[0].num_invocations, 3);
+  EXPECT_EQ(ops[1].tag, "CONV_2D");
+  EXPECT_EQ(ops[1].node_index, 1);
+  EXPECT_EQ(ops[1].num_invocations, 3);
+  EXPECT_GT(ops[1].values[PerfCounterProfiler::kInstructions],
+            ops[0].values[PerfCounterProfiler::kInstructions]);
+  EXPECT_NE(profiler.GetOutputString().find("CONV_2D"), std::string::npos);
+
+  profiler.Reset();
+  EXPECT_TRUE(profiler.GetOpCounters().empty());
+}
+
+TEST(PerfCounterProfilerTest, DisabledProfilerRecordsNothing) {
+  PerfCounterProfiler profiler;
+  profiler.SetEnabled(false);
+  const uint32_t handle =
+      profiler.BeginEvent("ADD", EventType::OPERATOR_INVOKE_EVENT, 0, 0);
+  EXPECT_EQ(handle, 0);
+  profiler.EndEvent(handle);
+  EXPECT_TRUE(profiler.GetOpCounters().empty());
+}
+
+}  // namespace
+}  // namespace profiling
+}  // namespace tflite
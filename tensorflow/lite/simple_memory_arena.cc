@@ -141,6 +141,49 @@ TfLiteStatus SimpleMemoryArena::Allocate(
   return kTfLiteOk;
 }
 
+bool SimpleMemoryArena::AllocateAt(size_t alignment, size_t offset,
+                                   size_t size, int32_t tensor,
+                                   int32_t first_node, int32_t last_node,
+                                   ArenaAllocWithUsageInterval* new_alloc) {
+  if (alignment > arena_alignment_ || offset % alignment != 0) {
+    return false;
+  }
+  for (const auto& alloc : active_allocs_) {
+    if (alloc.offset >= offset + size) {
+      // active_allocs_ is sorted by offset, so no further alloc can overlap.
+      break;
+    }
+    if (alloc.last_node < first_node || alloc.first_node > last_node ||
+        alloc.size == 0) {
+      continue;
+    }
+    if (alloc.offset + alloc.size > offset) {
+      return false;
+    }
+  }
+  new_alloc->tensor = tensor;
+  new_alloc->first_node = first_node;
+  new_alloc->last_node = last_node;
+  new_alloc->size = size;
+  new_alloc->offset = size == 0 ? 0 : offset;
+  if (size == 0) {
+    return true;
+  }
+  high_water_mark_ = std::max(high_water_mark_, offset + size);
+  auto insertion_it = std::upper_bound(active_allocs_.begin(),
+                                       active_allocs_.end(), *new_alloc);
+  active_allocs_.insert(insertion_it, *new_alloc);
+  return true;
+}
+
+void SimpleMemoryArena::RestoreAllocs(
+    const std::vector<ArenaAllocWithUsageInterval>& allocs) {
+  active_allocs_ = allocs;
+  for (const auto& alloc : allocs) {
+    high_water_mark_ = std::max(high_water_mark_, alloc.offset + alloc.size);
+  }
+}
+
 TfLiteStatus SimpleMemoryArena::Commit(TfLiteContext* context,
                                        bool* arena_reallocated) {
   size_t required_size = RequiredBufferSize();
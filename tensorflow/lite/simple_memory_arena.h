@@ -99,6 +99,19 @@ class SimpleMemoryArena {
                         int32_t tensor, int32_t first_node, int32_t last_node,
                         ArenaAllocWithUsageInterval* new_alloc);
 
+  // Like Allocate, but places the tensor at `offset`, e.g. as planned offline.
+  // Returns false, and leaves the arena unchanged, if `offset` isn't a multiple
+  // of `alignment` or if the alloc would overlap an active alloc whose usage
+  // interval intersects [first_node, last_node].
+  bool AllocateAt(size_t alignment, size_t offset, size_t size, int32_t tensor,
+                  int32_t first_node, int32_t last_node,
+                  ArenaAllocWithUsageInterval* new_alloc);
+
+  // Replaces the active allocs by `allocs`, which must be sorted by offset and
+  // have been computed by Allocate or AllocateAt for the same tensors, e.g. to
+  // reuse a previous plan.
+  void RestoreAllocs(const std::vector<ArenaAllocWithUsageInterval>& allocs);
+
   inline size_t RequiredBufferSize() {
     // Add in a small amount of padding to reduce the chance of resize events
     // for small allocations.
@@ -89,5 +89,24 @@ void ProfilingListener::WriteOutput(const std::string& header,
   (*stream) << data << std::endl;
 }
 
+HardwareCounterListener::HardwareCounterListener(Interpreter* interpreter) {
+  TFLITE_TOOLS_CHECK(interpreter);
+  // Added next to the profiler of the ProfilingListener, if any.
+  interpreter->AddProfiler(&profiler_);
+  profiler_.SetEnabled(false);
+}
+
+void HardwareCounterListener::OnSingleRunStart(RunType run_type) {
+  profiler_.SetEnabled(run_type == REGULAR);
+}
+
+void HardwareCounterListener::OnSingleRunEnd() { profiler_.SetEnabled(false); }
+
+void HardwareCounterListener::OnBenchmarkEnd(const BenchmarkResults& results) {
+  TFLITE_LOG(INFO) << "Operator-wise Hardware Counters for Regular Benchmark "
+                      "Runs:";
+  TFLITE_LOG(INFO) << profiler_.GetOutputString();
+}
+
 }  // namespace benchmark
 }  // namespace tflite
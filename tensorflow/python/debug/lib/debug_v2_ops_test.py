@@ -800,6 +800,43 @@ class DebugNumericSummaryV2Test(test_util.TensorFlowTestCase):
         self.evaluate(
             array_ops.check_numerics_v2(t1 / t2, message="pass through test"))
 
+  def testCheckNumericsNOpPassesThroughFiniteTensors(self):
+    """Test that CheckNumericsN op returns its inputs when they are finite."""
+    with self.session(graph=ops.Graph()):
+      t1 = constant_op.constant([-1.0, 1.0])
+      t2 = constant_op.constant([[2.0], [3.0]])
+      t3 = constant_op.constant([], dtype=dtypes.float32)
+      outputs = self.evaluate(
+          array_ops.check_numerics_n([t1, t2, t3], message="n test"))
+      self.assertAllEqual(outputs[0], [-1.0, 1.0])
+      self.assertAllEqual(outputs[1], [[2.0], [3.0]])
+      self.assertAllEqual(outputs[2], [])
+
+  def testCheckNumericsNOpReportsFirstAbnormalTensor(self):
+    """Test that CheckNumericsN op names the first tensor with infs or nans."""
+    with self.session(graph=ops.Graph()):
+      t1 = constant_op.constant([-1.0, 1.0])
+      t2 = constant_op.constant([0.0, 0.0])
+      with self.assertRaisesRegex(
+          errors.InvalidArgumentError,
+          r"n test : Tensor 1 had -Inf and \+Inf values"):
+        self.evaluate(
+            array_ops.check_numerics_n([t1, t1 / t2, t2 / t2],
+                                       message="n test"))
+
+  def testCheckNumericsNOpManyTensors(self):
+    """Test CheckNumericsN op with more tensors than one GPU launch checks."""
+    with self.session(graph=ops.Graph()):
+      tensors = [
+          constant_op.constant(np.ones([i + 1], dtype=np.float32))
+          for i in range(40)
+      ]
+      tensors[37] = tensors[37] / constant_op.constant(0.0)
+      with self.assertRaisesRegex(
+          errors.InvalidArgumentError,
+          r"n test : Tensor 37 had \+Inf values"):
+        self.evaluate(array_ops.check_numerics_n(tensors, message="n test"))
+
 
 if __name__ == "__main__":
   ops.enable_eager_execution()
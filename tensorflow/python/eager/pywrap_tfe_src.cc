@@ -72,26 +72,47 @@ namespace {
 // This occurs when a PyFunc kernel is run. This behavior makes it safe in that
 // case, as well as the case where python decides to reuse the underlying
 // C++ thread in 2 python threads case.
+//
+// The ops are kept per op name, so that a loop running a few different ops
+// gets back an op that was last reset to the same name, and whose Reset can
+// then skip the op registry lookups.
 struct OpDeleter {
   void operator()(TFE_Op* op) const { TFE_DeleteOp(op); }
 };
-thread_local std::unordered_map<TFE_Context*,
-                                std::unique_ptr<TFE_Op, OpDeleter>>
+using ThreadLocalOpMap =
+    std::unordered_map<string, std::unique_ptr<TFE_Op, OpDeleter>>;
+thread_local std::unordered_map<TFE_Context*, ThreadLocalOpMap>
     thread_local_eager_operation_map;                             // NOLINT
 thread_local std::unique_ptr<TF_Status> thread_local_tf_status =  // NOLINT
     nullptr;
 
-std::unique_ptr<TFE_Op, OpDeleter> ReleaseThreadLocalOp(TFE_Context* ctx) {
+// The maximum number of op names whose ops are kept per thread and context.
+constexpr size_t kMaxThreadLocalOpsPerContext = 64;
+
+std::unique_ptr<TFE_Op, OpDeleter> ReleaseThreadLocalOp(
+    TFE_Context* ctx, const char* op_or_function_name) {
   auto it = thread_local_eager_operation_map.find(ctx);
-  if (it == thread_local_eager_operation_map.end()) {
+  if (it == thread_local_eager_operation_map.end() || it->second.empty()) {
     return nullptr;
   }
-  return std::move(it->second);
+  ThreadLocalOpMap& ops = it->second;
+  auto op_it = ops.find(op_or_function_name);
+  if (op_it == ops.end()) {
+    // Any op can be reset to a new name, even if it is slower.
+    op_it = ops.begin();
+  }
+  auto op = std::move(op_it->second);
+  ops.erase(op_it);
+  return op;
+}
+
+void ReleaseThreadLocalOps(TFE_Context* ctx) {
+  thread_local_eager_operation_map.erase(ctx);
 }
 
 TFE_Op* GetOp(TFE_Context* ctx, const char* op_or_function_name,
               const char* raw_device_name, TF_Status* status) {
-  auto op = ReleaseThreadLocalOp(ctx);
+  auto op = ReleaseThreadLocalOp(ctx, op_or_function_name);
   if (!op) {
     op.reset(tensorflow::wrap(tensorflow::unwrap(ctx)->CreateOperation()));
   }
@@ -106,7 +127,12 @@ TFE_Op* GetOp(TFE_Context* ctx, const char* op_or_function_name,
 void ReturnOp(TFE_Context* ctx, TFE_Op* op) {
   if (op) {
     tensorflow::unwrap(op)->Clear();
-    thread_local_eager_operation_map[ctx].reset(op);
+    ThreadLocalOpMap& ops = thread_local_eager_operation_map[ctx];
+    const string& op_name = tensorflow::unwrap(op)->Name();
+    if (ops.size() >= kMaxThreadLocalOpsPerContext && !ops.count(op_name)) {
+      ops.erase(ops.begin());
+    }
+    ops[op_name].reset(op);
   }
 }
 
@@ -1148,8 +1174,7 @@ PyObject* TFE_Py_UID() { return PyLong_FromLongLong(get_uid()); }
 void TFE_DeleteContextCapsule(PyObject* context) {
   TFE_Context* ctx =
       reinterpret_cast<TFE_Context*>(PyCapsule_GetPointer(context, nullptr));
-  auto op = ReleaseThreadLocalOp(ctx);
-  op.reset();
+  ReleaseThreadLocalOps(ctx);
   TFE_DeleteContext(ctx);
 }
 
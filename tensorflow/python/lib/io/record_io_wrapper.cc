@@ -314,7 +314,8 @@ PYBIND11_MODULE(_pywrap_record_io, m) {
                      &ZlibCompressionOptions::compression_method)
       .def_readwrite("mem_level", &ZlibCompressionOptions::mem_level)
       .def_readwrite("compression_strategy",
-                     &ZlibCompressionOptions::compression_strategy);
+                     &ZlibCompressionOptions::compression_strategy)
+      .def_readwrite("num_threads", &ZlibCompressionOptions::num_threads);
 
   using tensorflow::io::RecordWriterOptions;
   py::class_<RecordWriterOptions>(m, "RecordWriterOptions")
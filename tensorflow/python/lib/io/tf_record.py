@@ -53,7 +53,8 @@ class TFRecordOptions(object):
                compression_level=None,
                compression_method=None,
                mem_level=None,
-               compression_strategy=None):
+               compression_strategy=None,
+               compression_threads=None):
     # pylint: disable=line-too-long
     """Creates a `TFRecordOptions` instance.
 
@@ -73,6 +74,9 @@ class TFRecordOptions(object):
       compression_method: compression method or `None`.
       mem_level: 1 to 9, or `None`.
       compression_strategy: strategy or `None`. Default: Z_DEFAULT_STRATEGY.
+      compression_threads: int or `None`. With `"GZIP"` compression, more than
+        1 thread compresses the records in independent blocks, in parallel.
+        The output is a valid gzip file. Default: 1.
 
     Returns:
       A `TFRecordOptions` object.
@@ -93,6 +97,7 @@ class TFRecordOptions(object):
     self.compression_method = compression_method
     self.mem_level = mem_level
     self.compression_strategy = compression_strategy
+    self.compression_threads = compression_threads
 
   @classmethod
   def get_compression_type_string(cls, options):
@@ -142,6 +147,8 @@ class TFRecordOptions(object):
       options.zlib_options.mem_level = self.mem_level
     if self.compression_strategy is not None:
       options.zlib_options.compression_strategy = self.compression_strategy
+    if self.compression_threads is not None:
+      options.zlib_options.num_threads = self.compression_threads
     return options
 
 
@@ -228,6 +228,10 @@ class CoordinationServiceStandaloneImpl : public CoordinationServiceInterface {
     absl::flat_hash_set<std::string> ongoing_barriers_for_task_;
   };
 
+  // Returns true if `task_state` is connected but has not sent a heartbeat
+  // within the heartbeat timeout.
+  bool IsStaleTask(TaskState& task_state) TF_SHARED_LOCKS_REQUIRED(state_mu_);
+
   std::unique_ptr<CoordinationClientCache> client_cache_;
   Env& env_;
   const uint64_t service_incarnation_ = random::New64();
@@ -384,30 +388,37 @@ void CoordinationServiceStandaloneImpl::StartCheckStaleness() {
               return;
             }
           }
-          // Heartbeat check.
-          Status status = OkStatus();
+          // Heartbeat check. The scan only reads the task states, so it does
+          // not block the heartbeats of the other tasks.
           {
-            mutex_lock l(state_mu_);
+            tf_shared_lock l(state_mu_);
             for (const auto& [task_name, task_state] : cluster_state_) {
-              // Skip tasks that are not registered or in error state
-              if (task_state->GetState() !=
-                  CoordinatedTaskState::TASKSTATE_CONNECTED) {
-                continue;
-              }
-              const bool is_stale = task_state->TimeSinceLastHeartbeatMs() >
-                                    heartbeat_timeout_ms_;
-              VLOG(10) << "Checking staleness for " << task_name
-                       << " stale?=" << is_stale;
-              if (is_stale) {
+              if (IsStaleTask(*task_state)) {
                 stale_task_names.push_back(task_name);
-                status = MakeCoordinationError(errors::Unavailable(
-                    "Task ", task_name,
-                    " heartbeat timeout. This indicates that the remote task "
-                    "has failed, got preempted, or crashed unexpectedly."));
-                SetTaskError(task_name, status);
               }
             }
           }
+          if (!stale_task_names.empty()) {
+            mutex_lock l(state_mu_);
+            // A task may have sent a heartbeat since the scan.
+            stale_task_names.erase(
+                std::remove_if(stale_task_names.begin(),
+                               stale_task_names.end(),
+                               [this](absl::string_view task_name) {
+                                 return !IsStaleTask(
+                                     *cluster_state_[task_name]);
+                               }),
+                stale_task_names.end());
+            for (const auto& stale_task_name : stale_task_names) {
+              SetTaskError(
+                  stale_task_name,
+                  MakeCoordinationError(errors::Unavailable(
+                      "Task ", stale_task_name,
+                      " heartbeat timeout. This indicates that the remote "
+                      "task has failed, got preempted, or crashed "
+                      "unexpectedly.")));
+            }
+          }
           // Propagate heartbeat timeout errors to other connected tasks.
           if (!stale_task_names.empty()) {
             if (!has_service_to_client_connection) {
@@ -479,8 +490,14 @@ void CoordinationServiceStandaloneImpl::StartCheckStaleness() {
 
 void CoordinationServiceStandaloneImpl::Stop(bool shut_staleness_thread) {
   {
-    mutex_lock l(kv_mu_);
-    for (const auto& [key, get_kv_callbacks] : get_cb_) {
+    absl::flat_hash_map<std::string, std::vector<StatusOrValueCallback>>
+        get_cb;
+    {
+      mutex_lock l(kv_mu_);
+      get_cb = std::move(get_cb_);
+      get_cb_.clear();
+    }
+    for (const auto& [key, get_kv_callbacks] : get_cb) {
       for (const auto& get_kv_callback : get_kv_callbacks) {
         get_kv_callback(errors::Cancelled(
             absl::StrCat("Coordination service is shutting down. Cancelling "
@@ -488,7 +505,6 @@ void CoordinationServiceStandaloneImpl::Stop(bool shut_staleness_thread) {
                          key)));
       }
     }
-    get_cb_.clear();
   }
   {
     mutex_lock l(state_mu_);
@@ -712,26 +728,29 @@ Status CoordinationServiceStandaloneImpl::RecordHeartbeat(
   const std::string& task_name = GetTaskName(task);
   Status s = OkStatus();
   {
-    mutex_lock l(state_mu_);
-    if (!cluster_state_.contains(task_name)) {
+    // Heartbeats only update the heartbeat time of their task, which has its
+    // own lock, so the heartbeats of all the tasks are recorded concurrently.
+    tf_shared_lock l(state_mu_);
+    auto it = cluster_state_.find(task_name);
+    if (it == cluster_state_.end()) {
       return MakeCoordinationError(errors::InvalidArgument(
           "Unexpected task request with task_name=", task_name));
     }
-    if (!cluster_state_[task_name]->GetStatus().ok()) {
-      return cluster_state_[task_name]->GetStatus();
-    } else if (cluster_state_[task_name]->GetState() ==
+    TaskState* task_state = it->second.get();
+    if (!task_state->GetStatus().ok()) {
+      return task_state->GetStatus();
+    } else if (task_state->GetState() ==
                    CoordinatedTaskState::TASKSTATE_DISCONNECTED &&
                // We accept heartbeats for a short grace period to account for
                // the lag time between the service recording the state change
                // and the agent stopping heartbeats.
                Env::Default()->NowMicros() >
-                   cluster_state_[task_name]
-                       ->GetDisconnectedGracePeriodMicros()) {
+                   task_state->GetDisconnectedGracePeriodMicros()) {
       return MakeCoordinationError(errors::InvalidArgument(
           "Task with task_name=", task_name,
           " must be registered before sending heartbeat messages"));
     }
-    s = cluster_state_[task_name]->RecordHeartbeat(incarnation);
+    s = task_state->RecordHeartbeat(incarnation);
   }
 
   // Set and propagate any heartbeat errors.
@@ -875,18 +894,25 @@ Status CoordinationServiceStandaloneImpl::InsertKeyValue(
     const std::string& key, const std::string& value) {
   VLOG(3) << "InsertKeyValue(): " << key << ": " << value;
   const std::string& norm_key = NormalizeKey(key);
-  mutex_lock l(kv_mu_);
-  if (kv_store_.find(norm_key) != kv_store_.end()) {
-    return MakeCoordinationError(
-        errors::AlreadyExists("Config key ", key, " already exists."));
-  }
-  kv_store_.emplace(norm_key, value);
-  auto iter = get_cb_.find(norm_key);
-  if (iter != get_cb_.end()) {
-    for (const auto& cb : iter->second) {
-      cb(value);
+  std::vector<StatusOrValueCallback> callbacks;
+  {
+    mutex_lock l(kv_mu_);
+    if (kv_store_.find(norm_key) != kv_store_.end()) {
+      return MakeCoordinationError(
+          errors::AlreadyExists("Config key ", key, " already exists."));
+    }
+    kv_store_.emplace(norm_key, value);
+    auto iter = get_cb_.find(norm_key);
+    if (iter != get_cb_.end()) {
+      callbacks = std::move(iter->second);
+      get_cb_.erase(iter);
     }
-    get_cb_.erase(iter);
+  }
+  // The callbacks respond to the pending GetKeyValue() RPCs. They run without
+  // `kv_mu_`, so that the other keys can be accessed while all the tasks
+  // waiting for this key are answered.
+  for (const auto& cb : callbacks) {
+    cb(value);
   }
   return OkStatus();
 }
@@ -895,18 +921,17 @@ void CoordinationServiceStandaloneImpl::GetKeyValueAsync(
     const std::string& key, StatusOrValueCallback done) {
   VLOG(3) << "GetKeyValue(): " << key;
   const std::string& norm_key = NormalizeKey(key);
-  mutex_lock l(kv_mu_);
-  const auto& iter = kv_store_.find(norm_key);
-  if (iter != kv_store_.end()) {
-    done(iter->second);
-    return;
-  }
-  auto cb_iter = get_cb_.find(norm_key);
-  if (cb_iter == get_cb_.end()) {
-    cb_iter =
-        get_cb_.emplace(norm_key, std::vector<StatusOrValueCallback>()).first;
+  std::string value;
+  {
+    mutex_lock l(kv_mu_);
+    const auto& iter = kv_store_.find(norm_key);
+    if (iter == kv_store_.end()) {
+      get_cb_[norm_key].emplace_back(std::move(done));
+      return;
+    }
+    value = iter->second;
   }
-  cb_iter->second.emplace_back(std::move(done));
+  done(value);
 }
 
 StatusOr<std::string> CoordinationServiceStandaloneImpl::TryGetKeyValue(
@@ -971,6 +996,14 @@ Status CoordinationServiceStandaloneImpl::DeleteKeyValue(
   return OkStatus();
 }
 
+bool CoordinationServiceStandaloneImpl::IsStaleTask(TaskState& task_state) {
+  // Skip tasks that are not registered or in error state
+  if (task_state.GetState() != CoordinatedTaskState::TASKSTATE_CONNECTED) {
+    return false;
+  }
+  return task_state.TimeSinceLastHeartbeatMs() > heartbeat_timeout_ms_;
+}
+
 void CoordinationServiceStandaloneImpl::SetTaskError(
     absl::string_view task_name, Status error) {
   cluster_state_[task_name]->SetError(error);
@@ -44,6 +44,7 @@ limitations under the License.
 
 namespace tsl {
 namespace {
+using ::testing::ElementsAre;
 using ::testing::EqualsProto;
 using ::testing::IsEmpty;
 using ::testing::UnorderedElementsAre;
@@ -568,6 +569,41 @@ TEST(CoordinationServiceTest, TryGetKeyValue) {
   EXPECT_TRUE(absl::IsNotFound(result.status()));
 }
 
+TEST(CoordinationServiceTest, GetKeyValueCallbacksCanAccessStore) {
+  const CoordinationServiceConfig config =
+      GetCoordinationServiceConfig(/*num_tasks=*/1);
+  auto client_cache = std::make_unique<TestCoordinationClientCache>();
+  std::unique_ptr<CoordinationServiceInterface> coord_service =
+      CoordinationServiceInterface::EnableCoordinationService(
+          Env::Default(), config, std::move(client_cache));
+
+  // The pending callbacks are invoked when the key is inserted, and may use
+  // the key-value store themselves.
+  std::vector<std::string> values;
+  for (int i = 0; i < 2; ++i) {
+    coord_service->GetKeyValueAsync(
+        "test_key", [&](const StatusOr<std::string>& status_or_value) {
+          TF_ASSERT_OK(status_or_value.status());
+          StatusOr<std::string> result =
+              coord_service->TryGetKeyValue("test_key");
+          TF_ASSERT_OK(result.status());
+          values.push_back(*result);
+        });
+  }
+  TF_ASSERT_OK(coord_service->InsertKeyValue("test_key", "test_value"));
+  EXPECT_THAT(values, ElementsAre("test_value", "test_value"));
+
+  // A callback for an existing key is invoked immediately.
+  coord_service->GetKeyValueAsync(
+      "test_key", [&](const StatusOr<std::string>& status_or_value) {
+        TF_ASSERT_OK(coord_service->DeleteKeyValue("test_key"));
+        values.push_back(*status_or_value);
+      });
+  EXPECT_EQ(values.size(), 3);
+  EXPECT_TRUE(absl::IsNotFound(
+      coord_service->TryGetKeyValue("test_key").status()));
+}
+
 TEST_F(CoordinateTwoTasksTest, GetKeyValueDir_SingleValueInDirectory) {
   EnableCoordinationService();
   KeyValueEntry kv = CreateKv("dir/path", "value0");
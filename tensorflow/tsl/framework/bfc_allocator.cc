@@ -17,12 +17,14 @@ limitations under the License.
 
 #include <algorithm>
 #include <atomic>
+#include <cstdlib>
 #include <memory>
 #include <utility>
 
 #include "absl/strings/string_view.h"
 #include "tensorflow/tsl/framework/allocator_retry.h"
 #include "tensorflow/tsl/lib/core/bits.h"
+#include "tensorflow/tsl/platform/env.h"
 #include "tensorflow/tsl/platform/file_system.h"
 #include "tensorflow/tsl/platform/logging.h"
 #include "tensorflow/tsl/platform/mutex.h"
@@ -46,6 +48,10 @@ BFCAllocator::BFCAllocator(std::unique_ptr<SubAllocator> sub_allocator,
       coalesce_regions_(sub_allocator->SupportsCoalescing()),
       sub_allocator_(std::move(sub_allocator)),
       name_(name),
+      thread_cache_id_([] {
+        static std::atomic<int64_t> next_id{0};
+        return next_id.fetch_add(1, std::memory_order_relaxed);
+      }()),
       free_chunks_list_(kInvalidChunkHandle),
       next_allocation_id_(1) {
   if (opts.allow_growth) {
@@ -84,9 +90,15 @@ BFCAllocator::BFCAllocator(std::unique_ptr<SubAllocator> sub_allocator,
       CHECK_NE(BinForSize(bin_size * 2), BinFromIndex(b));
     }
   }
+
+  if (std::getenv("TF_BFC_ALLOCATION_TRACE") != nullptr) {
+    EnableAllocationTrace();
+  }
 }
 
 BFCAllocator::~BFCAllocator() {
+  MaybeWriteAllocationTrace();
+
   // Return memory back.
   VLOG(2) << "Number of regions allocated: "
           << region_manager_.regions().size();
@@ -264,6 +276,17 @@ void* BFCAllocator::AllocateRawInternalWithRetry(
 void* BFCAllocator::AllocateRaw(size_t unused_alignment, size_t num_bytes,
                                 const AllocationAttributes& allocation_attr) {
   VLOG(3) << "AllocateRaw " << Name() << "  " << num_bytes;
+  const bool thread_cacheable =
+      ThreadCacheEnabled() && num_bytes > 0 &&
+      RoundedBytes(num_bytes) <= opts_.thread_cache_max_chunk_bytes;
+  if (thread_cacheable && allocation_attr.freed_by_func == nullptr) {
+    void* cached = AllocateFromThreadCache(num_bytes);
+    if (cached != nullptr) {
+      VLOG(3) << "AllocateRaw " << Name() << "  " << num_bytes << " "
+              << cached << " (thread cache)";
+      return cached;
+    }
+  }
   void* result = [&] {
     if (!opts_.allow_retry_on_failure || !allocation_attr.retry_on_failure) {
       // If we have globally disabled retry-on-failure and fail to allocate an
@@ -310,10 +333,139 @@ void* BFCAllocator::AllocateRaw(size_t unused_alignment, size_t num_bytes,
                                           allocation_attr);
     }
   }();
+  if (allocation_trace_enabled_.load(std::memory_order_relaxed) &&
+      num_bytes > 0) {
+    AddAllocationTraceEvent(result ? AllocationId(result) : 0, num_bytes);
+  }
+  if (thread_cacheable && result != nullptr) {
+    RecordThreadCacheable(result, num_bytes);
+  }
   VLOG(3) << "AllocateRaw " << Name() << "  " << num_bytes << " " << result;
   return result;
 }
 
+BFCAllocator::ThreadCacheableShard& BFCAllocator::ShardForPtr(
+    const void* ptr) const {
+  // Chunks are at least kMinAllocationSize aligned, so drop the low bits.
+  const uintptr_t v = reinterpret_cast<uintptr_t>(ptr) >> kMinAllocationBits;
+  return thread_cacheable_shards_[v % kNumThreadCacheableShards];
+}
+
+BFCAllocator::ThreadCache* BFCAllocator::GetThreadCache() {
+  // Keyed by thread_cache_id_ rather than `this` so that an allocator created
+  // at the address of a destroyed one never picks up a stale cache.
+  static thread_local absl::flat_hash_map<int64_t, std::weak_ptr<ThreadCache>>
+      caches;
+  auto it = caches.find(thread_cache_id_);
+  if (it != caches.end()) {
+    // The allocator owns the cache, so the pointer stays valid for the
+    // duration of the calling method.
+    if (ThreadCache* cache = it->second.lock().get()) return cache;
+  }
+
+  auto cache = std::make_shared<ThreadCache>();
+  {
+    mutex_lock l(cache->mu);
+    cache->free_ptrs.resize(RoundedBytes(opts_.thread_cache_max_chunk_bytes) /
+                            kMinAllocationSize);
+  }
+  {
+    mutex_lock l(thread_caches_lock_);
+    thread_caches_.push_back(cache);
+  }
+  // Drop the entries of allocators that have been destroyed since.
+  for (auto expired = caches.begin(); expired != caches.end();) {
+    if (expired->second.expired()) {
+      caches.erase(expired++);
+    } else {
+      ++expired;
+    }
+  }
+  caches[thread_cache_id_] = cache;
+  return cache.get();
+}
+
+void* BFCAllocator::AllocateFromThreadCache(size_t num_bytes) {
+  const size_t rounded_bytes = RoundedBytes(num_bytes);
+  void* ptr = nullptr;
+  {
+    ThreadCache* cache = GetThreadCache();
+    mutex_lock l(cache->mu);
+    std::vector<void*>& ptrs =
+        cache->free_ptrs[rounded_bytes / kMinAllocationSize - 1];
+    if (ptrs.empty()) return nullptr;
+    ptr = ptrs.back();
+    ptrs.pop_back();
+    cache->cached_bytes -= rounded_bytes;
+  }
+  ThreadCacheableShard& shard = ShardForPtr(ptr);
+  mutex_lock l(shard.mu);
+  shard.chunks[ptr].requested_size = num_bytes;
+  return ptr;
+}
+
+void BFCAllocator::RecordThreadCacheable(void* ptr, size_t num_bytes) {
+  ThreadCacheableShard& shard = ShardForPtr(ptr);
+  mutex_lock l(shard.mu);
+  shard.chunks[ptr] = {RoundedBytes(num_bytes), num_bytes};
+}
+
+bool BFCAllocator::DeallocateToThreadCache(void* ptr) {
+  ThreadCacheableShard& shard = ShardForPtr(ptr);
+  size_t rounded_bytes;
+  {
+    mutex_lock l(shard.mu);
+    auto it = shard.chunks.find(ptr);
+    if (it == shard.chunks.end()) return false;
+    rounded_bytes = it->second.rounded_bytes;
+    if (!ThreadCacheEnabled()) {
+      shard.chunks.erase(it);
+      return false;
+    }
+  }
+
+  ThreadCache* cache = GetThreadCache();
+  {
+    mutex_lock l(cache->mu);
+    if (cache->cached_bytes + rounded_bytes <= opts_.thread_cache_max_bytes) {
+      cache->free_ptrs[rounded_bytes / kMinAllocationSize - 1].push_back(ptr);
+      cache->cached_bytes += rounded_bytes;
+      return true;
+    }
+  }
+  mutex_lock l(shard.mu);
+  shard.chunks.erase(ptr);
+  return false;
+}
+
+bool BFCAllocator::FlushThreadCaches() {
+  std::vector<void*> ptrs;
+  {
+    mutex_lock l(thread_caches_lock_);
+    for (const auto& cache : thread_caches_) {
+      mutex_lock cache_lock(cache->mu);
+      for (std::vector<void*>& class_ptrs : cache->free_ptrs) {
+        ptrs.insert(ptrs.end(), class_ptrs.begin(), class_ptrs.end());
+        class_ptrs.clear();
+      }
+      cache->cached_bytes = 0;
+    }
+  }
+  for (void* ptr : ptrs) {
+    ThreadCacheableShard& shard = ShardForPtr(ptr);
+    {
+      mutex_lock l(shard.mu);
+      shard.chunks.erase(ptr);
+    }
+    DeallocateRawInternalLocked(ptr);
+  }
+  if (!ptrs.empty()) {
+    VLOG(2) << "Flushed " << ptrs.size() << " chunks from thread caches of "
+            << Name();
+  }
+  return !ptrs.empty();
+}
+
 // static
 size_t BFCAllocator::RoundedBytes(size_t bytes) {
   size_t rounded_bytes =
@@ -464,6 +616,16 @@ void* BFCAllocator::AllocateRawInternal(size_t unused_alignment,
     }
   }
 
+  // Chunks parked in thread caches are in use as far as the bins are
+  // concerned. Return them before resorting to freeing whole regions.
+  if (FlushThreadCaches()) {
+    ptr = FindChunkPtr(bin_num, rounded_bytes, num_bytes, freed_before);
+    if (ptr != nullptr) {
+      AddTraceMe("MemoryAllocation", ptr);
+      return ptr;
+    }
+  }
+
   // Reaching this point means that no chunks can satisfy the request. Also,
   // the unallocated bytes cannot satisfy the request. Before giving up, let's
   // try deallocating free regions so that suballocator can combine them with
@@ -684,6 +846,14 @@ void BFCAllocator::SplitChunk(BFCAllocator::ChunkHandle h, size_t num_bytes) {
 void BFCAllocator::DeallocateRaw(void* ptr) {
   VLOG(3) << "DeallocateRaw " << Name() << " "
           << (ptr ? RequestedSize(ptr) : 0);
+  if (ptr != nullptr &&
+      allocation_trace_enabled_.load(std::memory_order_relaxed)) {
+    AddAllocationTraceEvent(AllocationId(ptr), 0);
+  }
+  if (ptr != nullptr && opts_.thread_cache_max_chunk_bytes > 0 &&
+      DeallocateToThreadCache(ptr)) {
+    return;
+  }
   DeallocateRawInternal(ptr);
   retry_helper_.NotifyDealloc();
 }
@@ -694,7 +864,10 @@ void BFCAllocator::DeallocateRawInternal(void* ptr) {
     return;
   }
   mutex_lock l(lock_);
+  DeallocateRawInternalLocked(ptr);
+}
 
+void BFCAllocator::DeallocateRawInternalLocked(void* ptr) {
   // Find the chunk from the ptr.
   BFCAllocator::ChunkHandle h = region_manager_.get_handle(ptr);
   CHECK(h != kInvalidChunkHandle);
@@ -937,6 +1110,14 @@ bool BFCAllocator::TracksAllocationSizes() const { return true; }
 
 size_t BFCAllocator::RequestedSize(const void* ptr) const {
   CHECK(ptr);
+  if (opts_.thread_cache_max_chunk_bytes > 0) {
+    // Chunks handed out by a thread cache keep the requested size of their
+    // first allocation in the chunk itself.
+    ThreadCacheableShard& shard = ShardForPtr(ptr);
+    mutex_lock l(shard.mu);
+    auto it = shard.chunks.find(ptr);
+    if (it != shard.chunks.end()) return it->second.requested_size;
+  }
   mutex_lock l(lock_);
   BFCAllocator::ChunkHandle h = region_manager_.get_handle(ptr);
   CHECK(h != kInvalidChunkHandle)
@@ -1134,6 +1315,73 @@ void BFCAllocator::MaybeWriteMemoryMap() {
   }
 }
 
+void BFCAllocator::EnableAllocationTrace() {
+  mutex_lock l(trace_lock_);
+  if (allocation_trace_ == nullptr) {
+    allocation_trace_ = std::make_unique<AllocationTrace>();
+    allocation_trace_->set_allocator_name(Name());
+    allocation_trace_->set_memory_limit(memory_limit_);
+    last_trace_event_micros_ = Env::Default()->NowMicros();
+  }
+  allocation_trace_enabled_.store(true, std::memory_order_relaxed);
+}
+
+AllocationTrace BFCAllocator::RecordAllocationTrace() {
+  mutex_lock l(trace_lock_);
+  return allocation_trace_ ? *allocation_trace_ : AllocationTrace();
+}
+
+void BFCAllocator::AddAllocationTraceEvent(int64_t allocation_id,
+                                           size_t num_bytes) {
+  // Bounds the memory held by a trace that is left enabled for a long run.
+  constexpr int kMaxAllocationTraceEvents = 1 << 24;
+  const auto& annotation =
+      profiler::ScopedMemoryDebugAnnotation::CurrentAnnotation();
+  const uint64 now_micros = Env::Default()->NowMicros();
+
+  mutex_lock l(trace_lock_);
+  if (allocation_trace_->event_size() >= kMaxAllocationTraceEvents) {
+    LOG_FIRST_N(WARNING, 1)
+        << "Allocation trace of " << Name() << " reached "
+        << kMaxAllocationTraceEvents << " events; dropping later events.";
+    return;
+  }
+  tensorflow::AllocationTraceEvent* event = allocation_trace_->add_event();
+  event->set_timestamp_delta_us(now_micros - last_trace_event_micros_);
+  last_trace_event_micros_ = now_micros;
+  event->set_allocation_id(allocation_id);
+  event->set_num_bytes(num_bytes);
+  event->set_step_id(annotation.pending_step_id);
+  if (annotation.pending_op_name == nullptr) {
+    event->set_op_name_index(-1);
+    return;
+  }
+  auto [it, inserted] = trace_op_name_indices_.try_emplace(
+      annotation.pending_op_name, allocation_trace_->op_name_size());
+  if (inserted) {
+    allocation_trace_->add_op_name(annotation.pending_op_name);
+  }
+  event->set_op_name_index(it->second);
+}
+
+void BFCAllocator::MaybeWriteAllocationTrace() {
+  const char* trace_file = std::getenv("TF_BFC_ALLOCATION_TRACE");
+  if (trace_file == nullptr) return;
+  string file_name = strings::StrCat(trace_file, "_", Name(), ".",
+                                     Env::Default()->NowMicros());
+  mutex_lock l(trace_lock_);
+  if (allocation_trace_ == nullptr) return;
+  Status status = WriteStringToFile(Env::Default(), file_name,
+                                    allocation_trace_->SerializeAsString());
+  if (!status.ok()) {
+    LOG(ERROR) << "Failed to write allocation trace to " << file_name << ": "
+               << status;
+    return;
+  }
+  VLOG(1) << "Wrote " << allocation_trace_->event_size()
+          << " allocation trace events to " << file_name;
+}
+
 MemoryDump BFCAllocator::RecordMemoryMap() {
   mutex_lock l(lock_);
   return RecordMemoryMapInternal();
@@ -1207,7 +1455,9 @@ MemoryDump BFCAllocator::RecordMemoryMapInternal() {
 
 absl::optional<AllocatorStats> BFCAllocator::GetStats() {
   mutex_lock l(lock_);
-  return stats_;
+  AllocatorStats stats = stats_;
+  stats.largest_free_block_bytes = LargestFreeChunk();
+  return stats;
 }
 
 bool BFCAllocator::ClearStats() {
@@ -17,12 +17,14 @@ limitations under the License.
 #define TENSORFLOW_TSL_FRAMEWORK_BFC_ALLOCATOR_H_
 
 #include <array>
+#include <atomic>
 #include <deque>
 #include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "tensorflow/tsl/framework/allocator.h"
 #include "tensorflow/tsl/framework/allocator_retry.h"
@@ -35,9 +37,11 @@ limitations under the License.
 #include "tensorflow/tsl/platform/types.h"
 
 namespace tensorflow {
+class AllocationTrace;
 class MemoryDump;
 }
 namespace tsl {
+using tensorflow::AllocationTrace;
 using tensorflow::MemoryDump;
 
 // A memory allocator that implements a 'best-fit with coalescing'
@@ -68,6 +72,18 @@ class BFCAllocator : public Allocator {
     // Controls when a chunk should be split, if its size exceeds the requested
     // allocation size.
     double fragmentation_fraction = 0;
+
+    // If > 0, freed chunks of at most this many bytes are parked in a cache
+    // owned by the deallocating thread instead of going back to the bins, and
+    // later requests of the same rounded size on that thread are served from
+    // the cache without taking the allocator-wide lock. Cached chunks are
+    // still in use as far as the bins and GetStats() are concerned; all caches
+    // are flushed back to the bins when a request can't be satisfied
+    // otherwise. Ignored while a timing counter is set.
+    size_t thread_cache_max_chunk_bytes = 0;
+
+    // Upper bound on the number of bytes held by a single thread's cache.
+    size_t thread_cache_max_bytes = 4 << 20;
   };
   BFCAllocator(std::unique_ptr<SubAllocator> sub_allocator, size_t total_memory,
                const string& name, const Options& opts);
@@ -107,6 +123,16 @@ class BFCAllocator : public Allocator {
 
   MemoryDump RecordMemoryMap();
 
+  // Starts recording every allocation and deallocation, see
+  // RecordAllocationTrace(). Setting TF_BFC_ALLOCATION_TRACE to a file prefix
+  // enables this at construction, and the trace is then written to
+  // "<prefix>_<Name()>.<micros>" when the allocator is destroyed. Chunks are
+  // not served from thread caches while tracing.
+  void EnableAllocationTrace();
+
+  // Returns the events recorded since EnableAllocationTrace().
+  AllocationTrace RecordAllocationTrace();
+
  private:
   struct Bin;
 
@@ -120,6 +146,64 @@ class BFCAllocator : public Allocator {
 
   void DeallocateRawInternal(void* ptr);
 
+  void DeallocateRawInternalLocked(void* ptr)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  // Free chunks parked by one thread, see
+  // Options::thread_cache_max_chunk_bytes. The mutex is only contended when
+  // another thread flushes the cache.
+  struct ThreadCache {
+    mutex mu;
+    // Indexed by RoundedBytes(num_bytes) / kMinAllocationSize - 1.
+    std::vector<std::vector<void*>> free_ptrs TF_GUARDED_BY(mu);
+    size_t cached_bytes TF_GUARDED_BY(mu) = 0;
+  };
+
+  // Bookkeeping for chunks that may be parked in a ThreadCache. The entry
+  // lives for as long as the chunk is held by a client or a cache, so that
+  // deallocation can find the size class without taking lock_.
+  struct ThreadCacheableChunk {
+    size_t rounded_bytes = 0;
+    size_t requested_size = 0;
+  };
+  struct ThreadCacheableShard {
+    mutex mu;
+    absl::flat_hash_map<const void*, ThreadCacheableChunk> chunks
+        TF_GUARDED_BY(mu);
+  };
+  static constexpr int kNumThreadCacheableShards = 16;
+
+  bool ThreadCacheEnabled() const {
+    return opts_.thread_cache_max_chunk_bytes > 0 &&
+           timing_counter_ == nullptr &&
+           !allocation_trace_enabled_.load(std::memory_order_relaxed);
+  }
+
+  // Appends an event to the allocation trace. `num_bytes` is 0 for a
+  // deallocation and `allocation_id` is 0 for a failed allocation.
+  void AddAllocationTraceEvent(int64_t allocation_id, size_t num_bytes)
+      TF_LOCKS_EXCLUDED(trace_lock_);
+  void MaybeWriteAllocationTrace() TF_LOCKS_EXCLUDED(trace_lock_);
+
+  ThreadCacheableShard& ShardForPtr(const void* ptr) const;
+
+  // Returns the cache owned by the calling thread, creating it on first use.
+  ThreadCache* GetThreadCache();
+
+  // Returns a parked chunk for `num_bytes`, or nullptr on a miss.
+  void* AllocateFromThreadCache(size_t num_bytes);
+
+  // Records the chunk behind `ptr` as eligible for thread caching.
+  void RecordThreadCacheable(void* ptr, size_t num_bytes);
+
+  // Parks `ptr` in the calling thread's cache. Returns false if the chunk
+  // must go back to the bins instead.
+  bool DeallocateToThreadCache(void* ptr);
+
+  // Returns every parked chunk to the bins. Returns true if any chunk was
+  // freed.
+  bool FlushThreadCaches() TF_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
   // Chunks whose freed_at_count is later than the safe frontier value are kept
   // on a special list and not subject to merging immediately upon being freed.
   //
@@ -596,6 +680,25 @@ class BFCAllocator : public Allocator {
 
   std::atomic<uint64> safe_frontier_ = {0};
 
+  // Identifies this allocator in the thread local cache maps.
+  const int64_t thread_cache_id_;
+
+  // Lock order: lock_, thread_caches_lock_, ThreadCache::mu,
+  // ThreadCacheableShard::mu.
+  mutex thread_caches_lock_;
+  std::vector<std::shared_ptr<ThreadCache>> thread_caches_
+      TF_GUARDED_BY(thread_caches_lock_);
+  mutable std::array<ThreadCacheableShard, kNumThreadCacheableShards>
+      thread_cacheable_shards_;
+
+  std::atomic<bool> allocation_trace_enabled_ = {false};
+  mutex trace_lock_;
+  std::unique_ptr<AllocationTrace> allocation_trace_
+      TF_GUARDED_BY(trace_lock_);
+  absl::flat_hash_map<string, int> trace_op_name_indices_
+      TF_GUARDED_BY(trace_lock_);
+  uint64 last_trace_event_micros_ TF_GUARDED_BY(trace_lock_) = 0;
+
   // Structures mutable after construction
   mutable mutex lock_;
   RegionManager region_manager_ TF_GUARDED_BY(lock_);
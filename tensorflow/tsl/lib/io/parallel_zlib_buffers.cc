@@ -0,0 +1,412 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/tsl/lib/io/parallel_zlib_buffers.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "tensorflow/tsl/platform/coding.h"
+#include "tensorflow/tsl/platform/errors.h"
+#include "tensorflow/tsl/platform/raw_coding.h"
+
+namespace tsl {
+namespace io {
+
+namespace {
+
+// The gzip header of a block: the magic bytes, the compression method, the
+// FEXTRA flag, the modification time, the extra flags and the OS, then the
+// size of the extra field and the "TF" subfield with the size of the block.
+constexpr size_t kHeaderSize = 20;
+constexpr uint8 kGzipMagic1 = 0x1f;
+constexpr uint8 kGzipMagic2 = 0x8b;
+constexpr uint8 kGzipFlagExtra = 0x04;
+constexpr uint8 kGzipUnknownOs = 0xff;
+constexpr uint16 kExtraFieldSize = 8;
+constexpr uint16 kBlockSizeFieldSize = 4;
+// The gzip trailer of a block: the CRC32 and the size of the input.
+constexpr size_t kTrailerSize = 8;
+// The blocks are small enough for their compressed size to fit in the
+// 32 bits of the block size field.
+constexpr int64_t kMaxBlockInputSize = 1 << 30;
+
+// Compresses `input` into a gzip member with the header of a block.
+Status CompressBlock(const ZlibCompressionOptions& options, StringPiece input,
+                     string* output) {
+  z_stream stream;
+  memset(&stream, 0, sizeof(stream));
+  // The header and the trailer are written here, around the raw deflate data.
+  int error = deflateInit2(&stream, options.compression_level,
+                           options.compression_method,
+                           -(options.window_bits - 16), options.mem_level,
+                           options.compression_strategy);
+  if (error != Z_OK) {
+    return errors::Internal("deflateInit2() failed with error ", error);
+  }
+  const uLong bound = deflateBound(&stream, input.size());
+  output->resize(kHeaderSize + bound + kTrailerSize);
+  stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+  stream.avail_in = input.size();
+  stream.next_out = reinterpret_cast<Bytef*>(&(*output)[kHeaderSize]);
+  stream.avail_out = bound;
+  error = deflate(&stream, Z_FINISH);
+  const size_t compressed_size = stream.total_out;
+  deflateEnd(&stream);
+  if (error != Z_STREAM_END) {
+    return errors::DataLoss("deflate() failed with error ", error);
+  }
+
+  const size_t block_size = kHeaderSize + compressed_size + kTrailerSize;
+  output->resize(block_size);
+  char* header = &(*output)[0];
+  memset(header, 0, kHeaderSize);
+  header[0] = kGzipMagic1;
+  header[1] = kGzipMagic2;
+  header[2] = Z_DEFLATED;
+  header[3] = kGzipFlagExtra;
+  header[9] = kGzipUnknownOs;
+  core::EncodeFixed16(header + 10, kExtraFieldSize);
+  header[12] = 'T';
+  header[13] = 'F';
+  core::EncodeFixed16(header + 14, kBlockSizeFieldSize);
+  core::EncodeFixed32(header + 16, block_size);
+  char* trailer = header + kHeaderSize + compressed_size;
+  core::EncodeFixed32(
+      trailer, crc32(0, reinterpret_cast<const Bytef*>(input.data()),
+                     input.size()));
+  core::EncodeFixed32(trailer + 4, input.size());
+  return OkStatus();
+}
+
+// Returns true if `header` is the header of a block, and sets `block_size` to
+// the size of the block.
+bool ParseBlockHeader(StringPiece header, uint32* block_size) {
+  if (header.size() != kHeaderSize ||
+      static_cast<uint8>(header[0]) != kGzipMagic1 ||
+      static_cast<uint8>(header[1]) != kGzipMagic2 ||
+      header[2] != Z_DEFLATED || header[3] != kGzipFlagExtra ||
+      core::DecodeFixed16(header.data() + 10) != kExtraFieldSize ||
+      header[12] != 'T' || header[13] != 'F' ||
+      core::DecodeFixed16(header.data() + 14) != kBlockSizeFieldSize) {
+    return false;
+  }
+  *block_size = core::DecodeFixed32(header.data() + 16);
+  return *block_size >= kHeaderSize + kTrailerSize;
+}
+
+// Decompresses `input`, the data of a block after its header.
+Status DecompressBlock(StringPiece input, string* output) {
+  const char* trailer = input.data() + input.size() - kTrailerSize;
+  const uint32 crc = core::DecodeFixed32(trailer);
+  output->resize(core::DecodeFixed32(trailer + 4));
+
+  z_stream stream;
+  memset(&stream, 0, sizeof(stream));
+  int error = inflateInit2(&stream, -MAX_WBITS);
+  if (error != Z_OK) {
+    return errors::Internal("inflateInit2() failed with error ", error);
+  }
+  stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+  stream.avail_in = input.size() - kTrailerSize;
+  stream.next_out = reinterpret_cast<Bytef*>(&(*output)[0]);
+  stream.avail_out = output->size();
+  error = inflate(&stream, Z_FINISH);
+  const bool complete = stream.avail_in == 0 && stream.avail_out == 0;
+  inflateEnd(&stream);
+  if (error != Z_STREAM_END || !complete) {
+    return errors::DataLoss("Corrupted block of a parallel gzip stream: "
+                            "inflate() returned ",
+                            error);
+  }
+  if (crc32(0, reinterpret_cast<const Bytef*>(output->data()),
+            output->size()) != crc) {
+    return errors::DataLoss(
+        "Corrupted block of a parallel gzip stream: CRC mismatch");
+  }
+  return OkStatus();
+}
+
+}  // namespace
+
+bool UseParallelZlib(const ZlibCompressionOptions& options) {
+  return options.num_threads > 1 && options.window_bits > MAX_WBITS;
+}
+
+ParallelZlibOutputBuffer::ParallelZlibOutputBuffer(
+    WritableFile* file, const ZlibCompressionOptions& zlib_options)
+    : file_(file), zlib_options_(zlib_options) {}
+
+ParallelZlibOutputBuffer::~ParallelZlibOutputBuffer() {
+  if (!closed_) {
+    LOG(WARNING)
+        << "ParallelZlibOutputBuffer::Close() not called. Possible data loss";
+  }
+  // Waits for the blocks being compressed.
+  thread_pool_.reset();
+}
+
+Status ParallelZlibOutputBuffer::Init() {
+  if (!UseParallelZlib(zlib_options_)) {
+    return errors::InvalidArgument(
+        "Parallel compression needs num_threads > 1 and the gzip window bits, "
+        "got num_threads = ",
+        zlib_options_.num_threads, " and window_bits = ",
+        static_cast<int>(zlib_options_.window_bits));
+  }
+  if (zlib_options_.parallel_block_size <= 0 ||
+      zlib_options_.parallel_block_size > kMaxBlockInputSize) {
+    return errors::InvalidArgument(
+        "parallel_block_size must be in (0, ", kMaxBlockInputSize, "], got ",
+        zlib_options_.parallel_block_size);
+  }
+  thread_pool_ = std::make_unique<thread::ThreadPool>(
+      Env::Default(), "parallel_zlib_compress", zlib_options_.num_threads);
+  input_.reserve(zlib_options_.parallel_block_size);
+  return OkStatus();
+}
+
+Status ParallelZlibOutputBuffer::Append(StringPiece data) {
+  if (closed_) {
+    return errors::FailedPrecondition("Append() called after Close()");
+  }
+  while (!data.empty()) {
+    const size_t bytes_to_append = std::min<size_t>(
+        data.size(), zlib_options_.parallel_block_size - input_.size());
+    input_.append(data.data(), bytes_to_append);
+    data.remove_prefix(bytes_to_append);
+    if (input_.size() == zlib_options_.parallel_block_size) {
+      CompressInput();
+      // Bounds the memory held by the blocks that are not written yet.
+      TF_RETURN_IF_ERROR(WriteBlocks(2 * zlib_options_.num_threads));
+    }
+  }
+  return OkStatus();
+}
+
+#if defined(TF_CORD_SUPPORT)
+Status ParallelZlibOutputBuffer::Append(const absl::Cord& cord) {
+  for (absl::string_view fragment : cord.Chunks()) {
+    TF_RETURN_IF_ERROR(Append(fragment));
+  }
+  return OkStatus();
+}
+#endif
+
+void ParallelZlibOutputBuffer::CompressInput() {
+  pending_blocks_.push_back(std::make_unique<Block>());
+  Block* block = pending_blocks_.back().get();
+  block->input = std::move(input_);
+  input_.clear();
+  input_.reserve(zlib_options_.parallel_block_size);
+  thread_pool_->Schedule([this, block]() {
+    block->status = CompressBlock(zlib_options_, block->input, &block->output);
+    string().swap(block->input);
+    block->done.Notify();
+  });
+  wrote_block_ = true;
+}
+
+Status ParallelZlibOutputBuffer::WriteBlocks(size_t max_pending_blocks) {
+  while (pending_blocks_.size() > max_pending_blocks) {
+    std::unique_ptr<Block> block = std::move(pending_blocks_.front());
+    pending_blocks_.pop_front();
+    block->done.WaitForNotification();
+    TF_RETURN_IF_ERROR(block->status);
+    TF_RETURN_IF_ERROR(file_->Append(block->output));
+  }
+  return OkStatus();
+}
+
+Status ParallelZlibOutputBuffer::Flush() {
+  if (closed_) {
+    return errors::FailedPrecondition("Flush() called after Close()");
+  }
+  if (!input_.empty()) {
+    CompressInput();
+  }
+  TF_RETURN_IF_ERROR(WriteBlocks(0));
+  return file_->Flush();
+}
+
+Status ParallelZlibOutputBuffer::Name(StringPiece* result) const {
+  return file_->Name(result);
+}
+
+Status ParallelZlibOutputBuffer::Sync() {
+  TF_RETURN_IF_ERROR(Flush());
+  return file_->Sync();
+}
+
+Status ParallelZlibOutputBuffer::Close() {
+  if (closed_) {
+    return OkStatus();
+  }
+  // An empty stream still holds a block, as gzip files hold a member.
+  if (!input_.empty() || !wrote_block_) {
+    CompressInput();
+  }
+  closed_ = true;
+  return WriteBlocks(0);
+}
+
+Status ParallelZlibOutputBuffer::Tell(int64_t* position) {
+  return file_->Tell(position);
+}
+
+ParallelZlibInputStream::ParallelZlibInputStream(
+    InputStreamInterface* input_stream,
+    const ZlibCompressionOptions& zlib_options, bool owns_input_stream)
+    : input_stream_(input_stream),
+      owns_input_stream_(owns_input_stream),
+      zlib_options_(zlib_options) {}
+
+ParallelZlibInputStream::~ParallelZlibInputStream() {
+  // Waits for the blocks being decompressed.
+  thread_pool_.reset();
+  fallback_stream_.reset();
+  if (owns_input_stream_) {
+    delete input_stream_;
+  }
+}
+
+Status ParallelZlibInputStream::ReadAhead() {
+  // Errors are returned in order, after the blocks before them.
+  auto add_error = [this](const Status& status) {
+    pending_blocks_.push_back(std::make_unique<Block>());
+    pending_blocks_.back()->status = status;
+    pending_blocks_.back()->done.Notify();
+    end_of_input_ = true;
+  };
+  const size_t max_pending_blocks = 2 * zlib_options_.num_threads;
+  while (!end_of_input_ && pending_blocks_.size() < max_pending_blocks) {
+    tstring header;
+    const Status s = input_stream_->ReadNBytes(kHeaderSize, &header);
+    if (errors::IsOutOfRange(s) && header.empty()) {
+      read_first_block_ = true;
+      end_of_input_ = true;
+      break;
+    }
+    uint32 block_size;
+    const bool is_block = s.ok() && ParseBlockHeader(header, &block_size);
+    if (!read_first_block_) {
+      read_first_block_ = true;
+      if (!s.ok() && !errors::IsOutOfRange(s)) {
+        return s;
+      }
+      if (!is_block) {
+        // The stream was not written by ParallelZlibOutputBuffer.
+        TF_RETURN_IF_ERROR(input_stream_->Reset());
+        fallback_stream_ = std::make_unique<ZlibInputStream>(
+            input_stream_, zlib_options_.input_buffer_size,
+            zlib_options_.output_buffer_size, zlib_options_,
+            /*owns_input_stream=*/false);
+        end_of_input_ = true;
+        return OkStatus();
+      }
+    }
+    if (!is_block) {
+      add_error(s.ok() ? errors::DataLoss(
+                             "Invalid block header in a parallel gzip stream")
+                       : s);
+      break;
+    }
+
+    tstring input;
+    const Status input_status =
+        input_stream_->ReadNBytes(block_size - kHeaderSize, &input);
+    if (!input_status.ok()) {
+      add_error(errors::IsOutOfRange(input_status)
+                    ? errors::DataLoss("Truncated block in a parallel gzip "
+                                       "stream")
+                    : input_status);
+      break;
+    }
+    if (!thread_pool_) {
+      thread_pool_ = std::make_unique<thread::ThreadPool>(
+          Env::Default(), "parallel_zlib_decompress",
+          zlib_options_.num_threads);
+    }
+    pending_blocks_.push_back(std::make_unique<Block>());
+    Block* block = pending_blocks_.back().get();
+    block->input.assign(input.data(), input.size());
+    thread_pool_->Schedule([block]() {
+      block->status = DecompressBlock(block->input, &block->output);
+      string().swap(block->input);
+      block->done.Notify();
+    });
+  }
+  return OkStatus();
+}
+
+Status ParallelZlibInputStream::ReadNBytes(int64_t bytes_to_read,
+                                           tstring* result) {
+  if (!read_first_block_) {
+    TF_RETURN_IF_ERROR(ReadAhead());
+  }
+  if (fallback_stream_) {
+    return fallback_stream_->ReadNBytes(bytes_to_read, result);
+  }
+  result->clear();
+  while (result->size() < bytes_to_read) {
+    if (output_pos_ == output_.size()) {
+      TF_RETURN_IF_ERROR(ReadAhead());
+      if (pending_blocks_.empty()) {
+        return errors::OutOfRange("EOF reached");
+      }
+      std::unique_ptr<Block> block = std::move(pending_blocks_.front());
+      pending_blocks_.pop_front();
+      block->done.WaitForNotification();
+      TF_RETURN_IF_ERROR(block->status);
+      output_ = std::move(block->output);
+      output_pos_ = 0;
+      continue;
+    }
+    const size_t bytes = std::min<size_t>(bytes_to_read - result->size(),
+                                          output_.size() - output_pos_);
+    result->append(output_.data() + output_pos_, bytes);
+    output_pos_ += bytes;
+    bytes_read_ += bytes;
+  }
+  return OkStatus();
+}
+
+int64_t ParallelZlibInputStream::Tell() const {
+  return fallback_stream_ ? fallback_stream_->Tell() : bytes_read_;
+}
+
+void ParallelZlibInputStream::ClearPendingBlocks() {
+  for (const auto& block : pending_blocks_) {
+    block->done.WaitForNotification();
+  }
+  pending_blocks_.clear();
+}
+
+Status ParallelZlibInputStream::Reset() {
+  ClearPendingBlocks();
+  fallback_stream_.reset();
+  read_first_block_ = false;
+  end_of_input_ = false;
+  output_.clear();
+  output_pos_ = 0;
+  bytes_read_ = 0;
+  return input_stream_->Reset();
+}
+
+}  // namespace io
+}  // namespace tsl
@@ -0,0 +1,180 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_TSL_LIB_IO_PARALLEL_ZLIB_BUFFERS_H_
+#define TENSORFLOW_TSL_LIB_IO_PARALLEL_ZLIB_BUFFERS_H_
+
+#include <deque>
+#include <memory>
+#include <string>
+
+#include "tensorflow/tsl/lib/io/inputstream_interface.h"
+#include "tensorflow/tsl/lib/io/zlib_compression_options.h"
+#include "tensorflow/tsl/lib/io/zlib_inputstream.h"
+#include "tensorflow/tsl/platform/env.h"
+#include "tensorflow/tsl/platform/file_system.h"
+#include "tensorflow/tsl/platform/macros.h"
+#include "tensorflow/tsl/platform/notification.h"
+#include "tensorflow/tsl/platform/status.h"
+#include "tensorflow/tsl/platform/stringpiece.h"
+#include "tensorflow/tsl/platform/threadpool.h"
+#include "tensorflow/tsl/platform/types.h"
+
+namespace tsl {
+namespace io {
+
+// The output of ParallelZlibOutputBuffer is a sequence of independent gzip
+// members, each holding `zlib_options.parallel_block_size` bytes of input (the
+// last one may hold less). The header of each member has an extra field "TF"
+// with the total size of the member in 4 little-endian bytes, which lets
+// ParallelZlibInputStream find the members without decompressing them.
+//
+// The files are valid gzip files that any gzip reader, including
+// ZlibInputStream with the GZIP options, can decompress.
+
+// Returns true if `options` ask for parallel compression, which is only
+// supported with the gzip window bits.
+bool UseParallelZlib(const ZlibCompressionOptions& options);
+
+// Compresses the data written to it in blocks, on
+// `zlib_options.num_threads` threads, and writes the compressed blocks to
+// `file` in order.
+//
+// A given instance of a ParallelZlibOutputBuffer is NOT safe for concurrent
+// use by multiple threads.
+class ParallelZlibOutputBuffer : public WritableFile {
+ public:
+  // Does not take ownership of `file`.
+  ParallelZlibOutputBuffer(WritableFile* file,
+                           const ZlibCompressionOptions& zlib_options);
+
+  ~ParallelZlibOutputBuffer() override;
+
+  // Checks the options. This call is required before any other operation on
+  // the buffer.
+  Status Init();
+
+  // Adds `data` to the block being filled, which is compressed when it is
+  // full.
+  Status Append(StringPiece data) override;
+
+#if defined(TF_CORD_SUPPORT)
+  Status Append(const absl::Cord& cord) override;
+#endif
+
+  // Compresses the partial block and writes all the blocks to file.
+  Status Flush() override;
+
+  // Compresses any cached input and writes all output to file. This must be
+  // called before the destructor to avoid any data loss.
+  Status Close() override;
+
+  // Returns the name of the underlying file.
+  Status Name(StringPiece* result) const override;
+
+  // Flushes the blocks and syncs the underlying file.
+  Status Sync() override;
+
+  // Returns the write position in the underlying file. The position does not
+  // reflect the blocks that are not written yet.
+  Status Tell(int64_t* position) override;
+
+ private:
+  struct Block {
+    Notification done;
+    Status status;
+    string input;
+    string output;
+  };
+
+  // Schedules the compression of `input_` into a new block.
+  void CompressInput();
+
+  // Writes the compressed blocks to file, in order, until at most
+  // `max_pending_blocks` blocks are left.
+  Status WriteBlocks(size_t max_pending_blocks);
+
+  WritableFile* file_;  // Not owned
+  const ZlibCompressionOptions zlib_options_;
+  std::unique_ptr<thread::ThreadPool> thread_pool_;
+  string input_;
+  std::deque<std::unique_ptr<Block>> pending_blocks_;
+  bool wrote_block_ = false;
+  bool closed_ = false;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(ParallelZlibOutputBuffer);
+};
+
+// Decompresses the blocks written by ParallelZlibOutputBuffer on
+// `zlib_options.num_threads` threads. The streams that were not written by
+// ParallelZlibOutputBuffer are decompressed by a ZlibInputStream.
+class ParallelZlibInputStream : public InputStreamInterface {
+ public:
+  // Takes ownership of `input_stream` iff `owns_input_stream` is true.
+  ParallelZlibInputStream(InputStreamInterface* input_stream,
+                          const ZlibCompressionOptions& zlib_options,
+                          bool owns_input_stream);
+
+  ~ParallelZlibInputStream() override;
+
+  // Reads bytes_to_read bytes into *result, overwriting *result.
+  //
+  // Return Status codes:
+  // OK:           If successful.
+  // OUT_OF_RANGE: If there are not enough bytes to read before
+  //               the end of the stream.
+  // DATA_LOSS:    If a block is corrupted.
+  Status ReadNBytes(int64_t bytes_to_read, tstring* result) override;
+
+  int64_t Tell() const override;
+
+  Status Reset() override;
+
+ private:
+  struct Block {
+    Notification done;
+    Status status;
+    string input;
+    string output;
+  };
+
+  // Reads the blocks of the stream ahead of the current one, and schedules
+  // their decompression.
+  Status ReadAhead();
+
+  // Waits for the pending blocks, and drops them.
+  void ClearPendingBlocks();
+
+  InputStreamInterface* input_stream_;
+  const bool owns_input_stream_;
+  const ZlibCompressionOptions zlib_options_;
+  std::unique_ptr<thread::ThreadPool> thread_pool_;
+  // Set if the stream was not written by ParallelZlibOutputBuffer.
+  std::unique_ptr<ZlibInputStream> fallback_stream_;
+  bool read_first_block_ = false;
+  bool end_of_input_ = false;
+  std::deque<std::unique_ptr<Block>> pending_blocks_;
+  // The decompressed data of the current block.
+  string output_;
+  size_t output_pos_ = 0;
+  int64_t bytes_read_ = 0;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(ParallelZlibInputStream);
+};
+
+}  // namespace io
+}  // namespace tsl
+
+#endif  // TENSORFLOW_TSL_LIB_IO_PARALLEL_ZLIB_BUFFERS_H_
@@ -0,0 +1,166 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/tsl/lib/io/parallel_zlib_buffers.h"
+
+#include "tensorflow/tsl/lib/core/status_test_util.h"
+#include "tensorflow/tsl/lib/io/random_inputstream.h"
+#include "tensorflow/tsl/lib/io/zlib_compression_options.h"
+#include "tensorflow/tsl/lib/io/zlib_inputstream.h"
+#include "tensorflow/tsl/lib/io/zlib_outputbuffer.h"
+#include "tensorflow/tsl/platform/env.h"
+#include "tensorflow/tsl/platform/errors.h"
+#include "tensorflow/tsl/platform/strcat.h"
+#include "tensorflow/tsl/platform/test.h"
+
+namespace tsl {
+namespace io {
+namespace {
+
+string GenTestString(int size) {
+  string result;
+  for (int i = 0; result.size() < size; ++i) {
+    strings::StrAppend(&result, "record ", i, " ");
+  }
+  result.resize(size);
+  return result;
+}
+
+ZlibCompressionOptions ParallelOptions() {
+  ZlibCompressionOptions options = ZlibCompressionOptions::GZIP();
+  options.num_threads = 4;
+  options.parallel_block_size = 1000;
+  return options;
+}
+
+void WriteParallel(const string& fname, const string& data,
+                   const ZlibCompressionOptions& options) {
+  std::unique_ptr<WritableFile> file_writer;
+  TF_ASSERT_OK(Env::Default()->NewWritableFile(fname, &file_writer));
+  ParallelZlibOutputBuffer out(file_writer.get(), options);
+  TF_ASSERT_OK(out.Init());
+  // Appends of various sizes, which cross the boundaries of the blocks.
+  size_t pos = 0;
+  for (int i = 1; pos < data.size(); ++i) {
+    const size_t n = std::min<size_t>(37 * i, data.size() - pos);
+    TF_ASSERT_OK(out.Append(StringPiece(data.data() + pos, n)));
+    pos += n;
+  }
+  TF_ASSERT_OK(out.Close());
+  TF_ASSERT_OK(file_writer->Close());
+}
+
+TEST(ParallelZlibBuffers, RoundTrip) {
+  Env* env = Env::Default();
+  string fname;
+  ASSERT_TRUE(env->LocalTempFilename(&fname));
+  for (int size : {0, 1, 999, 1000, 1001, 100000}) {
+    const string data = GenTestString(size);
+    WriteParallel(fname, data, ParallelOptions());
+
+    std::unique_ptr<RandomAccessFile> file_reader;
+    TF_ASSERT_OK(env->NewRandomAccessFile(fname, &file_reader));
+    RandomAccessInputStream input_stream(file_reader.get());
+    ParallelZlibInputStream in(&input_stream, ParallelOptions(), false);
+    tstring result;
+    TF_ASSERT_OK(in.ReadNBytes(data.size(), &result));
+    EXPECT_EQ(result, data);
+    EXPECT_EQ(in.Tell(), data.size());
+    EXPECT_TRUE(errors::IsOutOfRange(in.ReadNBytes(1, &result)));
+
+    // The stream is read again after a reset, in small reads.
+    TF_ASSERT_OK(in.Reset());
+    string reread;
+    while (reread.size() < data.size()) {
+      TF_ASSERT_OK(in.ReadNBytes(
+          std::min<size_t>(333, data.size() - reread.size()), &result));
+      reread.append(result.data(), result.size());
+    }
+    EXPECT_EQ(reread, data);
+  }
+}
+
+TEST(ParallelZlibBuffers, ReadBySerialGzipReader) {
+  Env* env = Env::Default();
+  string fname;
+  ASSERT_TRUE(env->LocalTempFilename(&fname));
+  const string data = GenTestString(20000);
+  WriteParallel(fname, data, ParallelOptions());
+
+  std::unique_ptr<RandomAccessFile> file_reader;
+  TF_ASSERT_OK(env->NewRandomAccessFile(fname, &file_reader));
+  RandomAccessInputStream input_stream(file_reader.get());
+  ZlibInputStream in(&input_stream, 1000, 1000,
+                     ZlibCompressionOptions::GZIP());
+  tstring result;
+  TF_ASSERT_OK(in.ReadNBytes(data.size(), &result));
+  EXPECT_EQ(result, data);
+}
+
+TEST(ParallelZlibBuffers, ReadsSerialGzipStream) {
+  Env* env = Env::Default();
+  string fname;
+  ASSERT_TRUE(env->LocalTempFilename(&fname));
+  const string data = GenTestString(20000);
+  {
+    std::unique_ptr<WritableFile> file_writer;
+    TF_ASSERT_OK(env->NewWritableFile(fname, &file_writer));
+    ZlibOutputBuffer out(file_writer.get(), 1000, 1000,
+                         ZlibCompressionOptions::GZIP());
+    TF_ASSERT_OK(out.Init());
+    TF_ASSERT_OK(out.Append(data));
+    TF_ASSERT_OK(out.Close());
+    TF_ASSERT_OK(file_writer->Close());
+  }
+
+  std::unique_ptr<RandomAccessFile> file_reader;
+  TF_ASSERT_OK(env->NewRandomAccessFile(fname, &file_reader));
+  RandomAccessInputStream input_stream(file_reader.get());
+  ParallelZlibInputStream in(&input_stream, ParallelOptions(), false);
+  tstring result;
+  TF_ASSERT_OK(in.ReadNBytes(data.size(), &result));
+  EXPECT_EQ(result, data);
+}
+
+TEST(ParallelZlibBuffers, CorruptedBlock) {
+  Env* env = Env::Default();
+  string fname;
+  ASSERT_TRUE(env->LocalTempFilename(&fname));
+  const string data = GenTestString(5000);
+  WriteParallel(fname, data, ParallelOptions());
+  string contents;
+  TF_ASSERT_OK(ReadFileToString(env, fname, &contents));
+  // Flips a byte of the deflate data of the first block.
+  contents[30] ^= 0xff;
+  TF_ASSERT_OK(WriteStringToFile(env, fname, contents));
+
+  std::unique_ptr<RandomAccessFile> file_reader;
+  TF_ASSERT_OK(env->NewRandomAccessFile(fname, &file_reader));
+  RandomAccessInputStream input_stream(file_reader.get());
+  ParallelZlibInputStream in(&input_stream, ParallelOptions(), false);
+  tstring result;
+  EXPECT_TRUE(errors::IsDataLoss(in.ReadNBytes(data.size(), &result)));
+}
+
+TEST(ParallelZlibBuffers, RejectsNonGzipOptions) {
+  ZlibCompressionOptions options = ZlibCompressionOptions::DEFAULT();
+  options.num_threads = 4;
+  ParallelZlibOutputBuffer out(nullptr, options);
+  EXPECT_TRUE(errors::IsInvalidArgument(out.Init()));
+}
+
+}  // namespace
+}  // namespace io
+}  // namespace tsl
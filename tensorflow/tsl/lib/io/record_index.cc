@@ -0,0 +1,83 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/tsl/lib/io/record_index.h"
+
+#include "tensorflow/tsl/lib/hash/crc32c.h"
+#include "tensorflow/tsl/platform/coding.h"
+#include "tensorflow/tsl/platform/errors.h"
+#include "tensorflow/tsl/platform/raw_coding.h"
+#include "tensorflow/tsl/platform/strcat.h"
+
+namespace tsl {
+namespace io {
+namespace {
+
+constexpr char kRecordIndexSuffix[] = ".index";
+// "TFRIDX01" in little-endian order.
+constexpr uint64 kRecordIndexMagic = 0x3130584449524654ull;
+constexpr size_t kHeaderSize = 2 * sizeof(uint64);
+constexpr size_t kFooterSize = sizeof(uint32);
+
+}  // namespace
+
+string RecordIndexFilename(StringPiece fname) {
+  return strings::StrCat(fname, kRecordIndexSuffix);
+}
+
+Status WriteRecordIndex(Env* env, const string& fname,
+                        const std::vector<uint64>& offsets) {
+  string contents;
+  contents.reserve(kHeaderSize + offsets.size() * sizeof(uint64) +
+                   kFooterSize);
+  core::PutFixed64(&contents, kRecordIndexMagic);
+  core::PutFixed64(&contents, offsets.size());
+  for (uint64 offset : offsets) {
+    core::PutFixed64(&contents, offset);
+  }
+  core::PutFixed32(&contents,
+                   crc32c::Mask(crc32c::Value(contents.data(), contents.size())));
+  return WriteStringToFile(env, fname, contents);
+}
+
+Status ReadRecordIndex(Env* env, const string& fname,
+                       std::vector<uint64>* offsets) {
+  string contents;
+  TF_RETURN_IF_ERROR(ReadFileToString(env, fname, &contents));
+  if (contents.size() < kHeaderSize + kFooterSize ||
+      core::DecodeFixed64(contents.data()) != kRecordIndexMagic) {
+    return errors::DataLoss("Not a record index: ", fname);
+  }
+  const uint64 num_records = core::DecodeFixed64(contents.data() + 8);
+  const size_t size = contents.size() - kHeaderSize - kFooterSize;
+  if (size % sizeof(uint64) != 0 || size / sizeof(uint64) != num_records) {
+    return errors::DataLoss("Truncated record index: ", fname);
+  }
+  const uint32 masked_crc =
+      core::DecodeFixed32(contents.data() + contents.size() - kFooterSize);
+  if (crc32c::Unmask(masked_crc) !=
+      crc32c::Value(contents.data(), contents.size() - kFooterSize)) {
+    return errors::DataLoss("Corrupted record index: ", fname);
+  }
+  offsets->resize(num_records);
+  for (uint64 i = 0; i < num_records; ++i) {
+    (*offsets)[i] =
+        core::DecodeFixed64(contents.data() + kHeaderSize + i * sizeof(uint64));
+  }
+  return OkStatus();
+}
+
+}  // namespace io
+}  // namespace tsl
@@ -0,0 +1,55 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_TSL_LIB_IO_RECORD_INDEX_H_
+#define TENSORFLOW_TSL_LIB_IO_RECORD_INDEX_H_
+
+#include <vector>
+
+#include "tensorflow/tsl/platform/env.h"
+#include "tensorflow/tsl/platform/status.h"
+#include "tensorflow/tsl/platform/stringpiece.h"
+#include "tensorflow/tsl/platform/types.h"
+
+namespace tsl {
+namespace io {
+
+// A record index is a sidecar file of a TFRecord file, which holds the offsets
+// of its records. With the index, record `i` of an uncompressed file is read
+// with a single `RecordReader::ReadRecord` call at `offsets[i]`.
+//
+// Format of a record index:
+//  uint64    magic number
+//  uint64    number of records
+//  uint64    offsets[number of records]
+//  uint32    masked crc of all the previous bytes
+
+// Returns the name of the index file of the TFRecord file `fname`.
+string RecordIndexFilename(StringPiece fname);
+
+// Writes the offsets of the records of a file to the index file `fname`.
+Status WriteRecordIndex(Env* env, const string& fname,
+                        const std::vector<uint64>& offsets);
+
+// Reads the offsets of the records of a file from the index file `fname`.
+//
+// Returns DATA_LOSS if the index file is corrupted.
+Status ReadRecordIndex(Env* env, const string& fname,
+                       std::vector<uint64>* offsets);
+
+}  // namespace io
+}  // namespace tsl
+
+#endif  // TENSORFLOW_TSL_LIB_IO_RECORD_INDEX_H_
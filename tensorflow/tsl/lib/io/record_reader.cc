@@ -68,7 +68,12 @@ RecordReader::RecordReader(RandomAccessFile* file,
     LOG(FATAL) << "Compression is unsupported on mobile platforms.";
   }
 #else
-  if (options.compression_type == RecordReaderOptions::ZLIB_COMPRESSION) {
+  if (options.compression_type == RecordReaderOptions::ZLIB_COMPRESSION &&
+      UseParallelZlib(options.zlib_options)) {
+    input_stream_.reset(new ParallelZlibInputStream(
+        input_stream_.release(), options.zlib_options, true));
+  } else if (options.compression_type ==
+             RecordReaderOptions::ZLIB_COMPRESSION) {
     input_stream_.reset(new ZlibInputStream(
         input_stream_.release(), options.zlib_options.input_buffer_size,
         options.zlib_options.output_buffer_size, options.zlib_options, true));
@@ -20,6 +20,7 @@ limitations under the License.
 #include "tensorflow/tsl/platform/errors.h"
 #include "tensorflow/tsl/platform/stringpiece.h"
 #if !defined(IS_SLIM_BUILD)
+#include "tensorflow/tsl/lib/io/parallel_zlib_buffers.h"
 #include "tensorflow/tsl/lib/io/snappy/snappy_compression_options.h"
 #include "tensorflow/tsl/lib/io/snappy/snappy_inputstream.h"
 #include "tensorflow/tsl/lib/io/zlib_compression_options.h"
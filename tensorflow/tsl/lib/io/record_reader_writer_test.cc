@@ -24,6 +24,7 @@ limitations under the License.
 #include <vector>
 
 #include "tensorflow/tsl/lib/core/status_test_util.h"
+#include "tensorflow/tsl/lib/io/record_index.h"
 #include "tensorflow/tsl/platform/env.h"
 #include "tensorflow/tsl/platform/errors.h"
 #include "tensorflow/tsl/platform/logging.h"
@@ -162,6 +163,51 @@ TEST(RecordReaderWriterTest, TestBasics) {
   }
 }
 
+TEST(RecordReaderWriterTest, TestIndex) {
+  Env* env = Env::Default();
+  string fname = testing::TmpDir() + "/record_reader_writer_index_test";
+  const std::vector<string> records = {"abc", "", "defghijklmnop", "q"};
+
+  {
+    std::unique_ptr<WritableFile> file;
+    TF_CHECK_OK(env->NewWritableFile(fname, &file));
+    io::RecordWriterOptions options;
+    options.index_filename = io::RecordIndexFilename(fname);
+    io::RecordWriter writer(file.get(), options);
+    for (const string& record : records) {
+      TF_EXPECT_OK(writer.WriteRecord(record));
+    }
+    TF_CHECK_OK(writer.Close());
+    TF_CHECK_OK(file->Close());
+  }
+
+  std::vector<uint64> offsets;
+  TF_ASSERT_OK(
+      io::ReadRecordIndex(env, io::RecordIndexFilename(fname), &offsets));
+  ASSERT_EQ(offsets.size(), records.size());
+
+  // The records are read in reverse order, at their offsets.
+  std::unique_ptr<RandomAccessFile> read_file;
+  TF_CHECK_OK(env->NewRandomAccessFile(fname, &read_file));
+  io::RecordReader reader(read_file.get(), io::RecordReaderOptions());
+  for (int i = records.size() - 1; i >= 0; --i) {
+    uint64 offset = offsets[i];
+    tstring record;
+    TF_ASSERT_OK(reader.ReadRecord(&offset, &record));
+    EXPECT_EQ(records[i], record);
+  }
+
+  // A truncated index is rejected.
+  string contents;
+  TF_ASSERT_OK(
+      ReadFileToString(env, io::RecordIndexFilename(fname), &contents));
+  contents.resize(contents.size() - 1);
+  TF_ASSERT_OK(
+      WriteStringToFile(env, io::RecordIndexFilename(fname), contents));
+  EXPECT_TRUE(errors::IsDataLoss(
+      io::ReadRecordIndex(env, io::RecordIndexFilename(fname), &offsets)));
+}
+
 TEST(RecordReaderWriterTest, TestSkipBasic) {
   Env* env = Env::Default();
   string fname = testing::TmpDir() + "/record_reader_writer_skip_basic_test";
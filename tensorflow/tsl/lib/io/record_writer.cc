@@ -17,8 +17,10 @@ limitations under the License.
 
 #include "tensorflow/tsl/lib/hash/crc32c.h"
 #include "tensorflow/tsl/lib/io/compression.h"
+#include "tensorflow/tsl/lib/io/record_index.h"
 #include "tensorflow/tsl/platform/coding.h"
 #include "tensorflow/tsl/platform/env.h"
+#include "tensorflow/tsl/platform/errors.h"
 
 namespace tsl {
 namespace io {
@@ -65,7 +67,16 @@ RecordWriter::RecordWriter(WritableFile* dest,
     LOG(FATAL) << "Compression is unsupported on mobile platforms.";
   }
 #else
-  if (IsZlibCompressed(options)) {
+  if (IsZlibCompressed(options) && UseParallelZlib(options.zlib_options)) {
+    ParallelZlibOutputBuffer* zlib_output_buffer =
+        new ParallelZlibOutputBuffer(dest, options.zlib_options);
+    Status s = zlib_output_buffer->Init();
+    if (!s.ok()) {
+      LOG(FATAL) << "Failed to initialize parallel Zlib outputbuffer. Error: "
+                 << s.ToString();
+    }
+    dest_ = zlib_output_buffer;
+  } else if (IsZlibCompressed(options)) {
     ZlibOutputBuffer* zlib_output_buffer = new ZlibOutputBuffer(
         dest, options.zlib_options.input_buffer_size,
         options.zlib_options.output_buffer_size, options.zlib_options);
@@ -110,6 +121,7 @@ Status RecordWriter::WriteRecord(StringPiece data) {
   char footer[kFooterSize];
   PopulateHeader(header, data.data(), data.size());
   PopulateFooter(footer, data.data(), data.size());
+  AddRecordOffset(data.size());
   TF_RETURN_IF_ERROR(dest_->Append(StringPiece(header, sizeof(header))));
   TF_RETURN_IF_ERROR(dest_->Append(data));
   return dest_->Append(StringPiece(footer, sizeof(footer)));
@@ -130,21 +142,36 @@ Status RecordWriter::WriteRecord(const absl::Cord& data) {
   char footer[kFooterSize];
   PopulateHeader(header, data);
   PopulateFooter(footer, data);
+  AddRecordOffset(data.size());
   TF_RETURN_IF_ERROR(dest_->Append(StringPiece(header, sizeof(header))));
   TF_RETURN_IF_ERROR(dest_->Append(data));
   return dest_->Append(StringPiece(footer, sizeof(footer)));
 }
 #endif
 
+void RecordWriter::AddRecordOffset(size_t n) {
+  if (options_.index_filename.empty()) return;
+  record_offsets_.push_back(offset_);
+  offset_ += kHeaderSize + n + kFooterSize;
+}
+
 Status RecordWriter::Close() {
   if (dest_ == nullptr) return OkStatus();
   if (IsZlibCompressed(options_) || IsSnappyCompressed(options_)) {
     Status s = dest_->Close();
     delete dest_;
     dest_ = nullptr;
-    return s;
+    TF_RETURN_IF_ERROR(s);
+  }
+  if (options_.index_filename.empty() || wrote_index_) return OkStatus();
+  wrote_index_ = true;
+  if (options_.compression_type != RecordWriterOptions::NONE) {
+    return errors::InvalidArgument(
+        "A record index requires uncompressed records: ",
+        options_.index_filename);
   }
-  return OkStatus();
+  return WriteRecordIndex(Env::Default(), options_.index_filename,
+                          record_offsets_);
 }
 
 Status RecordWriter::Flush() {
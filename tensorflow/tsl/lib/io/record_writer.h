@@ -16,11 +16,14 @@ limitations under the License.
 #ifndef TENSORFLOW_TSL_LIB_IO_RECORD_WRITER_H_
 #define TENSORFLOW_TSL_LIB_IO_RECORD_WRITER_H_
 
+#include <vector>
+
 #include "tensorflow/tsl/lib/hash/crc32c.h"
 #include "tensorflow/tsl/platform/coding.h"
 #include "tensorflow/tsl/platform/status.h"
 #include "tensorflow/tsl/platform/stringpiece.h"
 #if !defined(IS_SLIM_BUILD)
+#include "tensorflow/tsl/lib/io/parallel_zlib_buffers.h"
 #include "tensorflow/tsl/lib/io/snappy/snappy_compression_options.h"
 #include "tensorflow/tsl/lib/io/snappy/snappy_outputbuffer.h"
 #include "tensorflow/tsl/lib/io/zlib_compression_options.h"
@@ -48,6 +51,10 @@ struct RecordWriterOptions {
   static RecordWriterOptions CreateRecordWriterOptions(
       const string& compression_type);
 
+  // If not empty, Close() writes the offsets of the records to this record
+  // index file (see record_index.h). Requires uncompressed records.
+  string index_filename;
+
 #if !defined(IS_SLIM_BUILD)
   // Options specific to compression.
   io::ZlibCompressionOptions zlib_options;
@@ -88,7 +95,8 @@ class RecordWriter {
   // WritableFile.
   Status Flush();
 
-  // Writes all output to the file. Does *not* close the WritableFile.
+  // Writes all output to the file, and the record index if
+  // `options.index_filename` is set. Does *not* close the WritableFile.
   //
   // After calling Close(), any further calls to `WriteRecord()` or `Flush()`
   // are invalid.
@@ -111,8 +119,15 @@ class RecordWriter {
 #endif
 
  private:
+  // Keeps the offset of the record for the record index, if there is one.
+  void AddRecordOffset(size_t n);
+
   WritableFile* dest_;
   RecordWriterOptions options_;
+  // Offsets of the records written, for the record index.
+  std::vector<uint64> record_offsets_;
+  uint64 offset_ = 0;
+  bool wrote_index_ = false;
 
   inline static uint32 MaskedCrc(const char* data, size_t n) {
     return crc32c::Mask(crc32c::Value(data, n));
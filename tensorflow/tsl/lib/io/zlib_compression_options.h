@@ -117,6 +117,17 @@ class ZlibCompressionOptions {
   //
   // This option is ignored for `ZlibOutputBuffer`.
   bool soft_fail_on_error = false;  // NOLINT
+
+  // The number of threads that compress or decompress the data. If it is
+  // greater than 1 with the gzip window bits, the data is compressed by
+  // ParallelZlibOutputBuffer in independent blocks of `parallel_block_size`
+  // bytes, and decompressed by ParallelZlibInputStream. The files are still
+  // valid gzip files. Defaults to 1.
+  int32 num_threads = 1;
+
+  // The size of the uncompressed blocks that are compressed in parallel.
+  // Smaller blocks compress less well, larger blocks need more memory.
+  int64_t parallel_block_size = 1 << 20;
 };
 
 inline ZlibCompressionOptions ZlibCompressionOptions::DEFAULT() {
@@ -20,6 +20,7 @@ limitations under the License.
 #include "tensorflow/tsl/lib/gtl/map_util.h"
 #include "tensorflow/tsl/platform/errors.h"
 #include "tensorflow/tsl/platform/macros.h"
+#include "tensorflow/tsl/platform/mutex.h"
 #include "tensorflow/tsl/platform/scanner.h"
 #include "tensorflow/tsl/platform/str_util.h"
 #include "tensorflow/tsl/platform/types.h"
@@ -34,6 +35,45 @@ namespace {
 // Set to 1 to enable verbose debug output from curl.
 constexpr uint64 kVerboseOutput = 0;
 
+// The share handle of the connection pool of all the requests, which reuse
+// the connections and TLS sessions of the previous requests to the same hosts
+// instead of redoing their handshakes. libcurl calls the lock functions around
+// every access to the shared data.
+class CurlShare {
+ public:
+  CurlShare() {
+    share_ = curl_share_init();
+    CHECK(share_ != nullptr) << "Couldn't initialize a curl share handle.";
+    CHECK_EQ(curl_share_setopt(share_, CURLSHOPT_LOCKFUNC, &CurlShare::Lock),
+             CURLSHE_OK);
+    CHECK_EQ(
+        curl_share_setopt(share_, CURLSHOPT_UNLOCKFUNC, &CurlShare::Unlock),
+        CURLSHE_OK);
+    CHECK_EQ(curl_share_setopt(share_, CURLSHOPT_USERDATA, this), CURLSHE_OK);
+    for (curl_lock_data data : {CURL_LOCK_DATA_CONNECT,
+                                CURL_LOCK_DATA_SSL_SESSION,
+                                CURL_LOCK_DATA_DNS}) {
+      CHECK_EQ(curl_share_setopt(share_, CURLSHOPT_SHARE, data), CURLSHE_OK);
+    }
+  }
+
+  CURLSH* handle() const { return share_; }
+
+ private:
+  static void Lock(CURL* handle, curl_lock_data data, curl_lock_access access,
+                   void* userptr) {
+    static_cast<CurlShare*>(userptr)->mu_[data].lock();
+  }
+
+  static void Unlock(CURL* handle, curl_lock_data data, void* userptr) {
+    static_cast<CurlShare*>(userptr)->mu_[data].unlock();
+  }
+
+  CURLSH* share_;
+  // A lock per kind of shared data.
+  mutex mu_[CURL_LOCK_DATA_LAST];
+};
+
 // Proxy to the real libcurl implementation.
 class LibCurlProxy : public LibCurl {
  public:
@@ -112,7 +152,22 @@ class LibCurlProxy : public LibCurl {
   }
 
   void curl_free(void* p) override { ::curl_free(p); }
+
+  CURLSH* curl_share_handle() override { return share_.handle(); }
+
+ private:
+  CurlShare share_;
 };
+
+// Returns whether the requests should use HTTP/2 when the server supports it.
+bool UseHttp2() {
+  static const bool use_http2 = [] {
+    bool value;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_CURL_USE_HTTP2", false, &value));
+    return value;
+  }();
+  return use_http2;
+}
 }  // namespace
 
 CurlHttpRequest::CurlHttpRequest() : CurlHttpRequest(LibCurlProxy::Load()) {}
@@ -140,9 +195,25 @@ CurlHttpRequest::CurlHttpRequest(LibCurl* libcurl, Env* env)
   // Do not use signals for timeouts - does not work in multi-threaded programs.
   CHECK_CURL_OK(libcurl_->curl_easy_setopt(curl_, CURLOPT_NOSIGNAL, 1L));
 
-  // TODO(b/74351157): Enable HTTP/2.
-  CHECK_CURL_OK(libcurl_->curl_easy_setopt(curl_, CURLOPT_HTTP_VERSION,
-                                           CURL_HTTP_VERSION_1_1));
+  // Reuse the connections of the previous requests, which outlive their easy
+  // handles in the share handle.
+  CURLSH* share = libcurl_->curl_share_handle();
+  if (share != nullptr) {
+    CHECK_CURL_OK(libcurl_->curl_easy_setopt(curl_, CURLOPT_SHARE,
+                                             static_cast<void*>(share)));
+  }
+
+  // HTTP/2 is opt-in, and libcurl refuses it if it was built without it. The
+  // requests wait for a connection that they can reuse rather than opening a
+  // new one.
+  if (UseHttp2() &&
+      libcurl_->curl_easy_setopt(curl_, CURLOPT_HTTP_VERSION,
+                                 CURL_HTTP_VERSION_2TLS) == CURLE_OK) {
+    CHECK_CURL_OK(libcurl_->curl_easy_setopt(curl_, CURLOPT_PIPEWAIT, 1L));
+  } else {
+    CHECK_CURL_OK(libcurl_->curl_easy_setopt(curl_, CURLOPT_HTTP_VERSION,
+                                             CURL_HTTP_VERSION_1_1));
+  }
 
   // Set up the progress meter.
   CHECK_CURL_OK(
@@ -267,6 +267,10 @@ class LibCurl {
   virtual void curl_slist_free_all(curl_slist* list) = 0;
   virtual char* curl_easy_escape(CURL* curl, const char* str, int length) = 0;
   virtual void curl_free(void* p) = 0;
+
+  /// Returns the share handle through which the requests share their
+  /// connections, TLS sessions and DNS cache, or nullptr if they share nothing.
+  virtual CURLSH* curl_share_handle() { return nullptr; }
 };
 
 }  // namespace tsl
@@ -111,6 +111,9 @@ class FakeLibCurl : public LibCurl {
       case CURLOPT_XFERINFODATA:
         progress_data_ = param;
         break;
+      case CURLOPT_SHARE:
+        share_ = param;
+        break;
       default:
         break;
     }
@@ -229,6 +232,7 @@ class FakeLibCurl : public LibCurl {
     delete reinterpret_cast<std::vector<string>*>(list);
   }
   void curl_free(void* p) override { port::Free(p); }
+  CURLSH* curl_share_handle() override { return share_handle_; }
 
   // Variables defining the behavior of this fake.
   string response_content_;
@@ -258,6 +262,9 @@ class FakeLibCurl : public LibCurl {
   int (*progress_callback_)(void* clientp, curl_off_t dltotal, curl_off_t dlnow,
                             curl_off_t ultotal, curl_off_t ulnow) = nullptr;
   void* progress_data_ = nullptr;
+  void* share_ = nullptr;
+  // The share handle returned to the requests.
+  CURLSH* share_handle_ = nullptr;
   // Outcome of performing the request.
   string posted_content_;
   CURLcode curl_easy_perform_result_ = CURLE_OK;
@@ -296,6 +303,18 @@ TEST(CurlHttpRequestTest, GetRequest) {
   EXPECT_EQ(200, http_request.GetResponseCode());
 }
 
+TEST(CurlHttpRequestTest, SharesConnections) {
+  FakeLibCurl libcurl("get response", 200);
+  int share_handle;
+  libcurl.share_handle_ = reinterpret_cast<CURLSH*>(&share_handle);
+  CurlHttpRequest http_request(&libcurl);
+
+  http_request.SetUri("http://www.testuri.com");
+  TF_EXPECT_OK(http_request.Send());
+
+  EXPECT_EQ(libcurl.share_handle_, libcurl.share_);
+}
+
 TEST(CurlHttpRequestTest, GetRequest_Direct) {
   FakeLibCurl libcurl("get response", 200);
   CurlHttpRequest http_request(&libcurl);
@@ -30,6 +30,7 @@ limitations under the License.
 #include <fstream>
 #include <functional>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -55,6 +56,7 @@ limitations under the License.
 #include "tensorflow/tsl/platform/str_util.h"
 #include "tensorflow/tsl/platform/stringprintf.h"
 #include "tensorflow/tsl/platform/thread_annotations.h"
+#include "tensorflow/tsl/platform/threadpool.h"
 #include "tensorflow/tsl/profiler/lib/traceme.h"
 
 #ifdef _WIN32
@@ -72,6 +74,9 @@ constexpr char kStorageHost[] = "storage.googleapis.com";
 constexpr char kBucketMetadataLocationKey[] = "location";
 constexpr size_t kReadAppendableFileBufferSize = 1024 * 1024;  // In bytes.
 constexpr int kGetChildrenDefaultPageSize = 1000;
+// StatMany lists the directories that hold at least this many of the paths,
+// instead of reading the metadata of each object.
+constexpr int kStatManyMinListedPaths = 8;
 // The HTTP response code "308 Resume Incomplete".
 constexpr uint64 HTTP_CODE_RESUME_INCOMPLETE = 308;
 // The HTTP response code "412 Precondition Failed".
@@ -162,6 +167,22 @@ constexpr char kAppendMode[] = "GCS_APPEND_MODE";
 // objects.
 constexpr char kComposeAppend[] = "compose";
 
+// The environment variable that enables parallel composite uploads: the files
+// of at least this size (in MB) are uploaded in parts concurrently, which are
+// then composed into the object. This is disabled by default (0) as the
+// temporary part objects may be stranded if the upload fails.
+constexpr char kParallelCompositeUploadThreshold[] =
+    "GCS_PARALLEL_COMPOSITE_UPLOAD_THRESHOLD_MB";
+// The environment variable that overrides the size (in MB) of the parts of the
+// parallel composite uploads.
+constexpr char kParallelCompositeUploadPartSize[] =
+    "GCS_PARALLEL_COMPOSITE_UPLOAD_PART_SIZE_MB";
+// The number of parts uploaded concurrently, which bounds the memory used by
+// the parts to kParallelCompositeUploadThreads times the part size.
+constexpr int kParallelCompositeUploadThreads = 8;
+// The maximum number of source objects of a GCS compose request.
+constexpr int kMaxComposeSources = 32;
+
 Status GetTmpFilename(string* filename) {
   *filename = io::GetTempFilename("");
   return OkStatus();
@@ -601,6 +622,18 @@ class GcsWritableFile : public WritableFile {
       return errors::Internal(
           "Could not write to the internal temporary file.");
     }
+    if (!compose_append_ || start_offset_ == 0) {
+      uint64 file_size;
+      TF_RETURN_IF_ERROR(GetCurrentFileSize(&file_size));
+      const uint64 threshold =
+          filesystem_->parallel_composite_upload_threshold();
+      if (threshold > 0 && file_size >= threshold &&
+          file_size > filesystem_->parallel_composite_upload_part_size()) {
+        TF_RETURN_IF_ERROR(ParallelCompositeUpload(file_size));
+        start_offset_ = file_size;
+        return OkStatus();
+      }
+    }
     UploadSessionHandle session_handle;
     uint64 start_offset = 0;
     string object_to_upload = object_;
@@ -728,6 +761,142 @@ class GcsWritableFile : public WritableFile {
         retry_config_);
   }
 
+  /// \brief Uploads the file in parts concurrently and composes them.
+  ///
+  /// Each part is uploaded to a temporary object with a simple upload, and the
+  /// temporary objects are deleted once they are composed into the object.
+  Status ParallelCompositeUpload(uint64 file_size) {
+    const uint64 part_size = filesystem_->parallel_composite_upload_part_size();
+    const int num_parts = (file_size + part_size - 1) / part_size;
+    VLOG(3) << "ParallelCompositeUpload: " << GetGcsPath() << " in "
+            << num_parts << " parts";
+    std::vector<string> part_objects(num_parts);
+    for (int i = 0; i < num_parts; ++i) {
+      part_objects[i] =
+          strings::StrCat(io::Dirname(object_), "/.tmpcompose/",
+                          io::Basename(object_), ".part", i);
+    }
+
+    std::vector<Status> part_statuses(num_parts);
+    {
+      thread::ThreadPool pool(
+          Env::Default(), "gcs_parallel_upload",
+          std::min(num_parts, kParallelCompositeUploadThreads));
+      for (int i = 0; i < num_parts; ++i) {
+        const uint64 offset = i * part_size;
+        const uint64 length = std::min(part_size, file_size - offset);
+        pool.Schedule([this, &part_objects, &part_statuses, i, offset,
+                       length]() {
+          part_statuses[i] = UploadPart(part_objects[i], offset, length);
+        });
+      }
+    }
+    Status status;
+    for (const Status& part_status : part_statuses) {
+      status.Update(part_status);
+    }
+    if (status.ok()) {
+      status = ComposeParts(part_objects);
+    }
+    if (status.ok()) {
+      // Erase the file from the file cache on every successful write.
+      file_cache_erase_();
+    }
+
+    // The parts are deleted even if the upload failed, since the next Sync()
+    // uploads them again.
+    {
+      thread::ThreadPool pool(
+          Env::Default(), "gcs_parallel_upload_cleanup",
+          std::min(num_parts, kParallelCompositeUploadThreads));
+      for (const string& part_object : part_objects) {
+        pool.Schedule([this, &part_object]() {
+          const string part_path = GetGcsPathWithObject(part_object);
+          const Status delete_status = RetryingUtils::DeleteWithRetries(
+              [&part_path, this]() {
+                return filesystem_->DeleteFile(part_path, nullptr);
+              },
+              retry_config_);
+          if (!delete_status.ok() && !absl::IsNotFound(delete_status)) {
+            LOG(WARNING) << "Could not delete the temporary object "
+                         << part_path << ": " << delete_status;
+          }
+        });
+      }
+    }
+    return status;
+  }
+
+  /// Uploads `length` bytes of the file from `offset` to `part_object`.
+  Status UploadPart(const string& part_object, uint64 offset, uint64 length) {
+    std::ifstream infile(tmp_content_filename_, std::ifstream::binary);
+    string contents(length, '\0');
+    infile.seekg(offset);
+    infile.read(&contents[0], length);
+    if (!infile.good()) {
+      return errors::Internal(
+          "Could not read the internal temporary file for the upload of ",
+          GetGcsPathWithObject(part_object));
+    }
+    return RetryingUtils::CallWithRetries(
+        [&part_object, &contents, this]() {
+          std::unique_ptr<HttpRequest> request;
+          TF_RETURN_IF_ERROR(filesystem_->CreateHttpRequest(&request));
+          request->SetUri(strings::StrCat(
+              kGcsUploadUriBase, "b/", bucket_,
+              "/o?uploadType=media&name=", request->EscapeString(part_object)));
+          request->SetTimeouts(timeouts_->connect, timeouts_->idle,
+                               timeouts_->write);
+          request->SetPostFromBuffer(contents.data(), contents.size());
+          TF_RETURN_WITH_CONTEXT_IF_ERROR(
+              request->Send(), " when uploading ",
+              GetGcsPathWithObject(part_object));
+          return OkStatus();
+        },
+        retry_config_);
+  }
+
+  /// Composes the part objects, in order, into the object.
+  ///
+  /// A compose request takes at most kMaxComposeSources objects, so the parts
+  /// after the first batch are appended to the object in later requests.
+  Status ComposeParts(const std::vector<string>& part_objects) {
+    size_t begin = 0;
+    while (begin < part_objects.size()) {
+      string source_objects;
+      int num_sources = 0;
+      if (begin > 0) {
+        source_objects = strings::StrCat("{'name': '", object_, "'}");
+        ++num_sources;
+      }
+      for (; begin < part_objects.size() && num_sources < kMaxComposeSources;
+           ++begin, ++num_sources) {
+        strings::StrAppend(&source_objects, num_sources > 0 ? "," : "",
+                           "{'name': '", part_objects[begin], "'}");
+      }
+      const string request_body =
+          strings::StrCat("{'sourceObjects': [", source_objects, "]}");
+      TF_RETURN_IF_ERROR(RetryingUtils::CallWithRetries(
+          [&request_body, this]() {
+            std::unique_ptr<HttpRequest> request;
+            TF_RETURN_IF_ERROR(filesystem_->CreateHttpRequest(&request));
+            request->SetUri(strings::StrCat(kGcsUriBase, "b/", bucket_, "/o/",
+                                            request->EscapeString(object_),
+                                            "/compose"));
+            request->SetTimeouts(timeouts_->connect, timeouts_->idle,
+                                 timeouts_->metadata);
+            request->AddHeader("content-type", "application/json");
+            request->SetPostFromBuffer(request_body.c_str(),
+                                       request_body.size());
+            TF_RETURN_WITH_CONTEXT_IF_ERROR(
+                request->Send(), " when composing to ", GetGcsPath());
+            return OkStatus();
+          },
+          retry_config_));
+    }
+    return OkStatus();
+  }
+
   /// \brief Requests status of a previously initiated upload session.
   ///
   /// If the upload has already succeeded, sets 'completed' to true.
@@ -848,12 +1017,17 @@ GcsFileSystem::GcsFileSystem(bool make_default_cache) {
   if (GetEnvVar(kMaxStaleness, strings::safe_strtou64, &value)) {
     max_staleness = value;
   }
+
+  if (GetEnvVar(kReadAheadBlocks, strings::safe_strtou64, &value)) {
+    read_ahead_blocks_ = value;
+  }
   if (!make_default_cache) {
     max_bytes = 0;
   }
   VLOG(1) << "GCS cache max size = " << max_bytes << " ; "
           << "block size = " << block_size_ << " ; "
-          << "max staleness = " << max_staleness;
+          << "max staleness = " << max_staleness << " ; "
+          << "read-ahead blocks = " << read_ahead_blocks_;
   file_block_cache_ = MakeFileBlockCache(block_size_, max_bytes, max_staleness);
   // Apply overrides for the stat cache max age and max entries, if provided.
   uint64 stat_cache_max_age = kStatCacheDefaultMaxAge;
@@ -975,6 +1149,16 @@ GcsFileSystem::GcsFileSystem(bool make_default_cache) {
     compose_append_ = false;
   }
 
+  if (GetEnvVar(kParallelCompositeUploadThreshold, strings::safe_strtou64,
+                &value)) {
+    parallel_composite_upload_threshold_ = value * 1024 * 1024;
+  }
+  if (GetEnvVar(kParallelCompositeUploadPartSize, strings::safe_strtou64,
+                &value) &&
+      value > 0) {
+    parallel_composite_upload_part_size_ = value * 1024 * 1024;
+  }
+
   retry_config_ = GetGcsRetryConfig();
 }
 
@@ -1078,7 +1262,7 @@ void GcsFileSystem::ResetFileBlockCache(size_t block_size_bytes,
 std::unique_ptr<FileBlockCache> GcsFileSystem::MakeFileBlockCache(
     size_t block_size, size_t max_bytes, uint64 max_staleness) {
   std::unique_ptr<FileBlockCache> file_block_cache(new RamFileBlockCache(
-      block_size, max_bytes, max_staleness,
+      block_size, max_bytes, max_staleness, read_ahead_blocks_,
       [this](const string& filename, size_t offset, size_t n, char* buffer,
              size_t* bytes_transferred) {
         return LoadBufferFromGCS(filename, offset, n, buffer,
@@ -1722,7 +1906,8 @@ Status GcsFileSystem::GetChildrenBounded(const string& dirname,
                                          uint64 max_results,
                                          std::vector<string>* result,
                                          bool recursive,
-                                         bool include_self_directory_marker) {
+                                         bool include_self_directory_marker,
+                                         std::vector<GcsFileStat>* stats) {
   if (!result) {
     return errors::InvalidArgument("'result' cannot be null");
   }
@@ -1737,13 +1922,19 @@ Status GcsFileSystem::GetChildrenBounded(const string& dirname,
     std::unique_ptr<HttpRequest> request;
     TF_RETURN_IF_ERROR(CreateHttpRequest(&request));
     auto uri = strings::StrCat(kGcsUriBase, "b/", bucket, "/o");
+    if (stats != nullptr) {
+      uri = strings::StrCat(
+          uri, "?fields=items%2Fname%2Citems%2Fsize%2Citems%2Fgeneration",
+          "%2Citems%2Fupdated%2C");
+    } else {
+      uri = strings::StrCat(uri, "?fields=items%2Fname%2C");
+    }
     if (recursive) {
-      uri = strings::StrCat(uri, "?fields=items%2Fname%2CnextPageToken");
+      uri = strings::StrCat(uri, "nextPageToken");
     } else {
       // Set "/" as a delimiter to ask GCS to treat subfolders as children
       // and return them in "prefixes".
-      uri = strings::StrCat(uri,
-                            "?fields=items%2Fname%2Cprefixes%2CnextPageToken");
+      uri = strings::StrCat(uri, "prefixes%2CnextPageToken");
       uri = strings::StrCat(uri, "&delimiter=%2F");
     }
     if (!object_prefix.empty()) {
@@ -1790,6 +1981,18 @@ Status GcsFileSystem::GetChildrenBounded(const string& dirname,
         }
         if (!relative_path.empty() || include_self_directory_marker) {
           result->emplace_back(relative_path);
+          if (stats != nullptr) {
+            GcsFileStat stat;
+            TF_RETURN_IF_ERROR(GetInt64Value(item, "size", &stat.base.length));
+            TF_RETURN_IF_ERROR(
+                GetInt64Value(item, "generation", &stat.generation_number));
+            string updated;
+            TF_RETURN_IF_ERROR(GetStringValue(item, "updated", &updated));
+            TF_RETURN_IF_ERROR(
+                ParseRfc3339Time(updated, &stat.base.mtime_nsec));
+            stat.base.is_directory = str_util::EndsWith(name, "/");
+            stats->push_back(stat);
+          }
         }
         if (++retrieved_results >= max_results) {
           return OkStatus();
@@ -1818,6 +2021,11 @@ Status GcsFileSystem::GetChildrenBounded(const string& dirname,
               " doesn't match the prefix ", object_prefix);
         }
         result->emplace_back(relative_path);
+        if (stats != nullptr) {
+          GcsFileStat stat;
+          stat.base = DIRECTORY_STAT;
+          stats->push_back(stat);
+        }
         if (++retrieved_results >= max_results) {
           return OkStatus();
         }
@@ -1870,6 +2078,81 @@ Status GcsFileSystem::Stat(const string& fname, TransactionToken* token,
   return errors::NotFound("The specified path ", fname, " was not found.");
 }
 
+bool GcsFileSystem::StatMany(const std::vector<string>& fnames,
+                             TransactionToken* token,
+                             std::vector<FileStatistics>* stats,
+                             std::vector<Status>* status) {
+  stats->assign(fnames.size(), FileStatistics());
+  status->assign(fnames.size(), OkStatus());
+  std::unordered_map<string, std::vector<int>> paths_per_dir;
+  for (int i = 0; i < fnames.size(); ++i) {
+    if (!str_util::EndsWith(fnames[i], "/")) {
+      paths_per_dir[string(io::Dirname(fnames[i]))].push_back(i);
+    }
+  }
+
+  // The paths in a directory with many of them are found in a listing of the
+  // directory, which returns the metadata of up to 1000 objects per request.
+  std::vector<bool> found(fnames.size(), false);
+  for (const auto& itr : paths_per_dir) {
+    const string& dir = itr.first;
+    const std::vector<int>& indices = itr.second;
+    if (indices.size() < kStatManyMinListedPaths) {
+      continue;
+    }
+    std::vector<string> children;
+    std::vector<GcsFileStat> children_stats;
+    const Status s = GetChildrenBounded(
+        dir, UINT64_MAX, &children, /*recursively=*/false,
+        /*include_self_directory_marker=*/false, &children_stats);
+    if (!s.ok()) {
+      VLOG(1) << "StatMany: could not list " << dir << ": " << s;
+      continue;
+    }
+    std::unordered_map<string, GcsFileStat> stat_per_child;
+    for (int j = 0; j < children.size(); ++j) {
+      StringPiece child(children[j]);
+      const bool is_folder = absl::ConsumeSuffix(&child, "/");
+      // An object takes precedence over a folder with the same name, as in
+      // Stat().
+      if (is_folder) {
+        stat_per_child.emplace(string(child), children_stats[j]);
+      } else {
+        stat_per_child[string(child)] = children_stats[j];
+        stat_cache_->Insert(io::JoinPath(dir, child), children_stats[j]);
+      }
+    }
+    for (int i : indices) {
+      auto child_stat = stat_per_child.find(string(io::Basename(fnames[i])));
+      if (child_stat != stat_per_child.end()) {
+        (*stats)[i] = child_stat->second.base;
+        found[i] = true;
+      }
+    }
+  }
+
+  // The other paths are statted concurrently.
+  std::vector<string> unlisted_fnames;
+  std::vector<int> unlisted_indices;
+  for (int i = 0; i < fnames.size(); ++i) {
+    if (!found[i]) {
+      unlisted_fnames.push_back(fnames[i]);
+      unlisted_indices.push_back(i);
+    }
+  }
+  std::vector<FileStatistics> unlisted_stats;
+  std::vector<Status> unlisted_status;
+  FileSystem::StatMany(unlisted_fnames, token, &unlisted_stats,
+                       &unlisted_status);
+  bool result = true;
+  for (int j = 0; j < unlisted_indices.size(); ++j) {
+    (*stats)[unlisted_indices[j]] = unlisted_stats[j];
+    (*status)[unlisted_indices[j]] = unlisted_status[j];
+    result &= unlisted_status[j].ok();
+  }
+  return result;
+}
+
 Status GcsFileSystem::DeleteFile(const string& fname, TransactionToken* token) {
   string bucket, object;
   TF_RETURN_IF_ERROR(ParseGcsPath(fname, false, &bucket, &object));
@@ -62,6 +62,12 @@ constexpr size_t kDefaultMaxCacheSize = 0;
 // will be evicted on the next read.
 constexpr char kMaxStaleness[] = "GCS_READ_CACHE_MAX_STALENESS";
 constexpr uint64 kDefaultMaxStaleness = 0;
+// The environment variable that overrides the maximum number of blocks that
+// the block cache fetches concurrently ahead of the sequential reads of a file.
+constexpr char kReadAheadBlocks[] = "GCS_READ_CACHE_READ_AHEAD_BLOCKS";
+constexpr size_t kDefaultReadAheadBlocks = 0;
+// The default size of the parts of the parallel composite uploads.
+constexpr uint64 kDefaultParallelCompositeUploadPartSize = 32 * 1024 * 1024;
 
 // Helper function to extract an environment variable and convert it into a
 // value of type T.
@@ -163,6 +169,10 @@ class GcsFileSystem : public FileSystem {
   Status Stat(const string& fname, TransactionToken* token,
               FileStatistics* stat) override;
 
+  bool StatMany(const std::vector<string>& fnames, TransactionToken* token,
+                std::vector<FileStatistics>* stats,
+                std::vector<Status>* status) override;
+
   Status GetChildren(const string& dir, TransactionToken* token,
                      std::vector<string>* result) override;
 
@@ -215,6 +225,12 @@ class GcsFileSystem : public FileSystem {
   }
 
   bool compose_append() const { return compose_append_; }
+  uint64 parallel_composite_upload_threshold() const {
+    return parallel_composite_upload_threshold_;
+  }
+  uint64 parallel_composite_upload_part_size() const {
+    return parallel_composite_upload_part_size_;
+  }
   string additional_header_name() const {
     return additional_header_ ? additional_header_->first : "";
   }
@@ -390,9 +406,13 @@ class GcsFileSystem : public FileSystem {
   /// If 'include_self_directory_marker' is true and there is a GCS directory
   /// marker at the path 'dir', GetChildrenBound will return an empty string
   /// as one of the children that represents this marker.
+  ///
+  /// If 'stats' is not null, it is filled with the statistics of the children,
+  /// which are returned in the same listing requests.
   Status GetChildrenBounded(const string& dir, uint64 max_results,
                             std::vector<string>* result, bool recursively,
-                            bool include_self_directory_marker);
+                            bool include_self_directory_marker,
+                            std::vector<GcsFileStat>* stats = nullptr);
 
   /// Retrieves file statistics assuming fname points to a GCS object. The data
   /// may be read from cache or from GCS directly.
@@ -415,6 +435,9 @@ class GcsFileSystem : public FileSystem {
   // Reads smaller than block_size_ will trigger a read of block_size_.
   uint64 block_size_;
 
+  // The maximum number of blocks that the block cache reads ahead of a file.
+  size_t read_ahead_blocks_ = kDefaultReadAheadBlocks;
+
   // block_cache_lock_ protects the file_block_cache_ pointer (Note that
   // FileBlockCache instances are themselves threadsafe).
   mutex block_cache_lock_;
@@ -435,6 +458,10 @@ class GcsFileSystem : public FileSystem {
   std::unique_ptr<BucketLocationCache> bucket_location_cache_;
   std::unordered_set<string> allowed_locations_;
   bool compose_append_;
+  // The minimum size of the files uploaded in parallel parts, 0 if disabled.
+  uint64 parallel_composite_upload_threshold_ = 0;
+  uint64 parallel_composite_upload_part_size_ =
+      kDefaultParallelCompositeUploadPartSize;
 
   GcsStatsInterface* stats_ = nullptr;  // Not owned.
 
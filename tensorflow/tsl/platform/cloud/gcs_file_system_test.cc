@@ -3110,6 +3110,70 @@ TEST(GcsFileSystemTest, Stat_FilenameEndingWithSlash) {
   EXPECT_TRUE(stat.is_directory);
 }
 
+TEST(GcsFileSystemTest, StatMany_ListsDirectory) {
+  // The 8 paths in gs://bucket/path are found in a listing of the directory,
+  // except for file6.txt which is statted on its own.
+  string items;
+  for (int i = 0; i < 6; ++i) {
+    strings::StrAppend(&items, i > 0 ? "," : "", "{\"name\": \"path/file", i,
+                       ".txt\",\"size\": \"", 10 * i,
+                       "\",\"generation\": \"1\","
+                       "\"updated\": \"2016-04-29T23:15:24.896Z\"}");
+  }
+  std::vector<HttpRequest*> requests(
+      {new FakeHttpRequest(
+           "Uri: https://www.googleapis.com/storage/v1/b/bucket/o?"
+           "fields=items%2Fname%2Citems%2Fsize%2Citems%2Fgeneration%2Citems%2F"
+           "updated%2Cprefixes%2CnextPageToken&delimiter=%2F&prefix=path%2F\n"
+           "Auth Token: fake_token\n"
+           "Timeouts: 5 1 10\n",
+           strings::StrCat("{\"items\": [", items,
+                           "],\"prefixes\": [\"path/subpath/\"]}")),
+       new FakeHttpRequest(
+           "Uri: https://www.googleapis.com/storage/v1/b/bucket/o/"
+           "path%2Ffile6.txt?fields=size%2Cgeneration%2Cupdated\n"
+           "Auth Token: fake_token\n"
+           "Timeouts: 5 1 10\n",
+           "", errors::NotFound("404"), 404),
+       new FakeHttpRequest(
+           "Uri: https://www.googleapis.com/storage/v1/b/bucket/o?"
+           "fields=items%2Fname%2CnextPageToken&prefix=path%2Ffile6.txt%2F"
+           "&maxResults=1\n"
+           "Auth Token: fake_token\n"
+           "Timeouts: 5 1 10\n",
+           "{}")});
+  GcsFileSystem fs(
+      std::unique_ptr<AuthProvider>(new FakeAuthProvider),
+      std::unique_ptr<HttpRequest::Factory>(
+          new FakeHttpRequestFactory(&requests)),
+      std::unique_ptr<ZoneProvider>(new FakeZoneProvider), 0 /* block size */,
+      0 /* max bytes */, 0 /* max staleness */, 0 /* stat cache max age */,
+      0 /* stat cache max entries */, 0 /* matching paths cache max age */,
+      0 /* matching paths cache max entries */, kTestRetryConfig,
+      kTestTimeoutConfig, *kAllowedLocationsDefault,
+      nullptr /* gcs additional header */, false /* compose append */);
+
+  std::vector<string> fnames;
+  for (int i = 0; i < 7; ++i) {
+    fnames.push_back(strings::StrCat("gs://bucket/path/file", i, ".txt"));
+  }
+  fnames.push_back("gs://bucket/path/subpath");
+  std::vector<FileStatistics> stats;
+  std::vector<Status> status;
+  EXPECT_FALSE(fs.StatMany(fnames, nullptr, &stats, &status));
+  ASSERT_EQ(8, stats.size());
+  ASSERT_EQ(8, status.size());
+  for (int i = 0; i < 6; ++i) {
+    TF_EXPECT_OK(status[i]);
+    EXPECT_EQ(10 * i, stats[i].length);
+    EXPECT_NEAR(1461971724896, stats[i].mtime_nsec / 1000 / 1000, 1);
+    EXPECT_FALSE(stats[i].is_directory);
+  }
+  EXPECT_EQ(error::Code::NOT_FOUND, status[6].code());
+  TF_EXPECT_OK(status[7]);
+  EXPECT_TRUE(stats[7].is_directory);
+}
+
 TEST(GcsFileSystemTest, IsDirectory_NotFound) {
   std::vector<HttpRequest*> requests(
       {new FakeHttpRequest(
@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/tsl/platform/cloud/ram_file_block_cache.h"
 
+#include <algorithm>
 #include <cstring>
 #include <memory>
 
@@ -23,6 +24,14 @@ limitations under the License.
 
 namespace tsl {
 
+namespace {
+
+// The maximum number of files whose reads are tracked for the read-ahead. The
+// states are dropped past that, which only delays the read-ahead of the files.
+constexpr size_t kMaxReadAheadFiles = 1024;
+
+}  // namespace
+
 bool RamFileBlockCache::BlockNotStale(const std::shared_ptr<Block>& block) {
   mutex_lock l(block->mu);
   if (block->state != FetchState::FINISHED) {
@@ -60,6 +69,54 @@ std::shared_ptr<RamFileBlockCache::Block> RamFileBlockCache::Lookup(
   return new_entry;
 }
 
+size_t RamFileBlockCache::UpdateReadAhead(const string& filename,
+                                          size_t offset, size_t n) {
+  mutex_lock lock(mu_);
+  auto it = read_ahead_states_.find(filename);
+  if (it == read_ahead_states_.end()) {
+    if (read_ahead_states_.size() >= kMaxReadAheadFiles) {
+      read_ahead_states_.clear();
+    }
+    it = read_ahead_states_.emplace(filename, ReadAheadState()).first;
+  }
+  ReadAheadState& state = it->second;
+  if (offset == state.next_offset) {
+    state.num_blocks =
+        std::min(std::max<size_t>(1, 2 * state.num_blocks),
+                 max_read_ahead_blocks_);
+  } else {
+    state.num_blocks = 0;
+  }
+  state.next_offset = offset + n;
+  return state.num_blocks;
+}
+
+void RamFileBlockCache::ScheduleFetches(const string& filename, size_t begin,
+                                        size_t end) {
+  for (size_t pos = begin; pos < end; pos += block_size_) {
+    Key key = std::make_pair(filename, pos);
+    {
+      mutex_lock lock(mu_);
+      if (block_map_.find(key) != block_map_.end()) {
+        // The block is cached or being fetched already.
+        continue;
+      }
+    }
+    std::shared_ptr<Block> block = Lookup(key);
+    read_ahead_pool_->Schedule([this, key, block] {
+      Status status = MaybeFetch(key, block);
+      if (status.ok()) {
+        status = UpdateLRU(key, block);
+      }
+      // The block is fetched again by the read that needs it.
+      if (!status.ok()) {
+        VLOG(1) << "Failed to read ahead " << key.first << " @ " << key.second
+                << ": " << status;
+      }
+    });
+  }
+}
+
 // Remove blocks from the cache until we do not exceed our maximum size.
 void RamFileBlockCache::Trim() {
   while (!lru_list_.empty() && cache_size_ > max_bytes_) {
@@ -85,11 +142,17 @@ Status RamFileBlockCache::UpdateLRU(const Key& key,
   // in the cache, and our current block is not block size, this likely means
   // we have inconsistent state within the cache. Note: it's possible some
   // incomplete reads may still go undetected.
+  // The blocks that are still fetched, and the empty blocks past the end of
+  // the file, which are fetched when reading ahead, are not inconsistent.
   if (block->data.size() < block_size_) {
     Key fmax = std::make_pair(key.first, std::numeric_limits<size_t>::max());
     auto fcmp = block_map_.upper_bound(fmax);
-    if (fcmp != block_map_.begin() && key < (--fcmp)->first) {
-      return errors::Internal("Block cache contents are inconsistent.");
+    while (fcmp != block_map_.begin() && key < (--fcmp)->first) {
+      mutex_lock l(fcmp->second->mu);
+      if (fcmp->second->state == FetchState::FINISHED &&
+          !fcmp->second->data.empty()) {
+        return errors::Internal("Block cache contents are inconsistent.");
+      }
     }
   }
 
@@ -184,6 +247,13 @@ Status RamFileBlockCache::Read(const string& filename, size_t offset, size_t n,
   if (finish < offset + n) {
     finish += block_size_;
   }
+  if (read_ahead_pool_ != nullptr) {
+    // Fetch the blocks after the first one, and the blocks read ahead of this
+    // read, concurrently with the first one.
+    const size_t num_read_ahead_blocks = UpdateReadAhead(filename, offset, n);
+    ScheduleFetches(filename, start + block_size_,
+                    finish + num_read_ahead_blocks * block_size_);
+  }
   size_t total_bytes_transferred = 0;
   // Now iterate through the blocks, reading them one at a time.
   for (size_t pos = start; pos < finish; pos += block_size_) {
@@ -273,6 +343,7 @@ void RamFileBlockCache::Flush() {
   block_map_.clear();
   lru_list_.clear();
   lra_list_.clear();
+  read_ahead_states_.clear();
   cache_size_ = 0;
 }
 
@@ -282,6 +353,7 @@ void RamFileBlockCache::RemoveFile(const string& filename) {
 }
 
 void RamFileBlockCache::RemoveFile_Locked(const string& filename) {
+  read_ahead_states_.erase(filename);
   Key begin = std::make_pair(filename, 0);
   auto it = block_map_.lower_bound(begin);
   while (it != block_map_.end() && it->first.first == filename) {
@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef TENSORFLOW_TSL_PLATFORM_CLOUD_RAM_FILE_BLOCK_CACHE_H_
 #define TENSORFLOW_TSL_PLATFORM_CLOUD_RAM_FILE_BLOCK_CACHE_H_
 
+#include <algorithm>
 #include <functional>
 #include <list>
 #include <map>
@@ -30,6 +31,7 @@ limitations under the License.
 #include "tensorflow/tsl/platform/status.h"
 #include "tensorflow/tsl/platform/stringpiece.h"
 #include "tensorflow/tsl/platform/thread_annotations.h"
+#include "tensorflow/tsl/platform/threadpool.h"
 #include "tensorflow/tsl/platform/types.h"
 
 namespace tsl {
@@ -52,20 +54,43 @@ class RamFileBlockCache : public FileBlockCache {
 
   RamFileBlockCache(size_t block_size, size_t max_bytes, uint64 max_staleness,
                     BlockFetcher block_fetcher, Env* env = Env::Default())
+      : RamFileBlockCache(block_size, max_bytes, max_staleness,
+                          /*max_read_ahead_blocks=*/0, block_fetcher, env) {}
+
+  /// With `max_read_ahead_blocks` > 0, the blocks of a read are fetched
+  /// concurrently, and the sequential reads of a file fetch up to that many of
+  /// the next blocks in the background. The number of blocks read ahead of a
+  /// file doubles with every sequential read, and drops to 0 on a random read.
+  /// At most half of the cache is read ahead of a file.
+  RamFileBlockCache(size_t block_size, size_t max_bytes, uint64 max_staleness,
+                    size_t max_read_ahead_blocks, BlockFetcher block_fetcher,
+                    Env* env = Env::Default())
       : block_size_(block_size),
         max_bytes_(max_bytes),
         max_staleness_(max_staleness),
+        max_read_ahead_blocks_(
+            block_size > 0 ? std::min(max_read_ahead_blocks,
+                                      max_bytes / (2 * block_size))
+                           : 0),
         block_fetcher_(block_fetcher),
         env_(env) {
     if (max_staleness_ > 0) {
       pruning_thread_.reset(env_->StartThread(ThreadOptions(), "TF_prune_FBC",
                                               [this] { Prune(); }));
     }
+    if (IsCacheEnabled() && max_read_ahead_blocks_ > 0) {
+      read_ahead_pool_.reset(new thread::ThreadPool(
+          env_, "TF_read_ahead_FBC", max_read_ahead_blocks_));
+    }
     VLOG(1) << "GCS file block cache is "
-            << (IsCacheEnabled() ? "enabled" : "disabled");
+            << (IsCacheEnabled() ? "enabled" : "disabled")
+            << ", reading ahead up to " << max_read_ahead_blocks_ << " blocks";
   }
 
   ~RamFileBlockCache() override {
+    // Destroying read_ahead_pool_ will block until the scheduled fetches are
+    // done.
+    read_ahead_pool_.reset();
     if (pruning_thread_) {
       stop_pruning_thread_.Notify();
       // Destroying pruning_thread_ will block until Prune() receives the above
@@ -127,6 +152,8 @@ class RamFileBlockCache : public FileBlockCache {
   const size_t max_bytes_;
   /// The maximum staleness of any block in the LRU cache, in seconds.
   const uint64 max_staleness_;
+  /// The maximum number of blocks fetched ahead of the reads of a file.
+  const size_t max_read_ahead_blocks_;
   /// The callback to read a block from the underlying filesystem.
   const BlockFetcher block_fetcher_;
   /// The Env from which we read timestamps.
@@ -197,6 +224,16 @@ class RamFileBlockCache : public FileBlockCache {
   /// Look up a Key in the block cache.
   std::shared_ptr<Block> Lookup(const Key& key) TF_LOCKS_EXCLUDED(mu_);
 
+  /// Returns the number of blocks to read ahead of a read of `n` bytes at
+  /// `offset` in `filename`, and records the read.
+  size_t UpdateReadAhead(const string& filename, size_t offset, size_t n)
+      TF_LOCKS_EXCLUDED(mu_);
+
+  /// Fetch the blocks of `filename` in [begin, end) that are not in the cache
+  /// in the background.
+  void ScheduleFetches(const string& filename, size_t begin, size_t end)
+      TF_LOCKS_EXCLUDED(mu_);
+
   Status MaybeFetch(const Key& key, const std::shared_ptr<Block>& block)
       TF_LOCKS_EXCLUDED(mu_);
 
@@ -221,6 +258,9 @@ class RamFileBlockCache : public FileBlockCache {
   /// Notification for stopping the cache pruning thread.
   Notification stop_pruning_thread_;
 
+  /// The threads that fetch the blocks in the background.
+  std::unique_ptr<thread::ThreadPool> read_ahead_pool_;
+
   /// Guards access to the block map, LRU list, and cached byte count.
   mutable mutex mu_;
 
@@ -243,6 +283,17 @@ class RamFileBlockCache : public FileBlockCache {
 
   // A filename->file_signature map.
   std::map<string, int64_t> file_signature_map_ TF_GUARDED_BY(mu_);
+
+  /// \brief The state of the read-ahead of a file.
+  struct ReadAheadState {
+    /// The offset right after the last read of the file.
+    size_t next_offset = 0;
+    /// The number of blocks read ahead of the reads of the file.
+    size_t num_blocks = 0;
+  };
+
+  /// A filename->read-ahead state map.
+  std::map<string, ReadAheadState> read_ahead_states_ TF_GUARDED_BY(mu_);
 };
 
 }  // namespace tsl
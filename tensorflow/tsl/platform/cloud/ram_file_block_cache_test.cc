@@ -15,12 +15,15 @@ limitations under the License.
 
 #include "tensorflow/tsl/platform/cloud/ram_file_block_cache.h"
 
+#include <algorithm>
 #include <cstring>
+#include <vector>
 
 #include "tensorflow/tsl/lib/core/status_test_util.h"
 #include "tensorflow/tsl/platform/blocking_counter.h"
 #include "tensorflow/tsl/platform/cloud/now_seconds_env.h"
 #include "tensorflow/tsl/platform/env.h"
+#include "tensorflow/tsl/platform/mutex.h"
 #include "tensorflow/tsl/platform/notification.h"
 #include "tensorflow/tsl/platform/test.h"
 
@@ -566,5 +569,84 @@ TEST(RamFileBlockCacheTest, Flush) {
   EXPECT_EQ(calls, 2);
 }
 
+TEST(RamFileBlockCacheTest, ReadAhead) {
+  const size_t block_size = 16;
+  mutex mu;
+  std::vector<size_t> offsets;
+  auto fetcher = [&mu, &offsets](const string& filename, size_t offset,
+                                 size_t n, char* buffer,
+                                 size_t* bytes_transferred) {
+    {
+      mutex_lock l(mu);
+      offsets.push_back(offset);
+    }
+    memset(buffer, 'x', n);
+    *bytes_transferred = n;
+    return OkStatus();
+  };
+  {
+    RamFileBlockCache cache(block_size, 16 * block_size, 0,
+                            /*max_read_ahead_blocks=*/4, fetcher);
+    std::vector<char> out;
+    // The first read of the file reads ahead 1 block, and the second one 2.
+    TF_EXPECT_OK(ReadCache(&cache, "", 0, block_size, &out));
+    TF_EXPECT_OK(ReadCache(&cache, "", block_size, block_size, &out));
+    EXPECT_EQ(out, std::vector<char>(block_size, 'x'));
+    // The destructor waits for the fetches.
+  }
+  std::sort(offsets.begin(), offsets.end());
+  EXPECT_EQ(offsets, std::vector<size_t>({0, 16, 32, 48}));
+}
+
+TEST(RamFileBlockCacheTest, NoReadAheadOfRandomReads) {
+  const size_t block_size = 16;
+  mutex mu;
+  std::vector<size_t> offsets;
+  auto fetcher = [&mu, &offsets](const string& filename, size_t offset,
+                                 size_t n, char* buffer,
+                                 size_t* bytes_transferred) {
+    {
+      mutex_lock l(mu);
+      offsets.push_back(offset);
+    }
+    memset(buffer, 'x', n);
+    *bytes_transferred = n;
+    return OkStatus();
+  };
+  {
+    RamFileBlockCache cache(block_size, 16 * block_size, 0,
+                            /*max_read_ahead_blocks=*/4, fetcher);
+    std::vector<char> out;
+    // The second read isn't sequential, and reads its 2 blocks concurrently.
+    TF_EXPECT_OK(ReadCache(&cache, "", 0, block_size, &out));
+    TF_EXPECT_OK(ReadCache(&cache, "", 4 * block_size, 2 * block_size, &out));
+    EXPECT_EQ(out.size(), 2 * block_size);
+  }
+  std::sort(offsets.begin(), offsets.end());
+  EXPECT_EQ(offsets, std::vector<size_t>({0, 16, 64, 80}));
+}
+
+TEST(RamFileBlockCacheTest, ReadAheadPastEndOfFile) {
+  const size_t block_size = 16;
+  const size_t file_size = block_size + 4;
+  auto fetcher = [file_size](const string& filename, size_t offset, size_t n,
+                             char* buffer, size_t* bytes_transferred) {
+    *bytes_transferred = offset < file_size ? std::min(n, file_size - offset)
+                                            : 0;
+    memset(buffer, 'x', *bytes_transferred);
+    return OkStatus();
+  };
+  RamFileBlockCache cache(block_size, 16 * block_size, 0,
+                          /*max_read_ahead_blocks=*/4, fetcher);
+  std::vector<char> out;
+  TF_EXPECT_OK(ReadCache(&cache, "", 0, block_size, &out));
+  // The empty blocks read ahead past the end of the file don't make the last
+  // partial block inconsistent.
+  TF_EXPECT_OK(ReadCache(&cache, "", block_size, block_size, &out));
+  EXPECT_EQ(out.size(), 4);
+  TF_EXPECT_OK(ReadCache(&cache, "", 0, file_size, &out));
+  EXPECT_EQ(out.size(), file_size);
+}
+
 }  // namespace
 }  // namespace tsl
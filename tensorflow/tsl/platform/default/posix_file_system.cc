@@ -29,6 +29,10 @@ limitations under the License.
 #include <time.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+
 #include "tensorflow/tsl/platform/default/posix_file_system.h"
 #include "tensorflow/tsl/platform/env.h"
 #include "tensorflow/tsl/platform/errors.h"
@@ -45,12 +49,55 @@ using ::tsl::errors::IOError;
 // 128KB of copy buffer
 constexpr size_t kPosixCopyFileBufferSize = 128 * 1024;
 
+namespace {
+
+// Returns how many bytes past a sequential read `PosixRandomAccessFile` asks
+// the kernel to read ahead, from the environment variable
+// `TF_POSIX_READAHEAD_BYTES`. 0, the default, disables readahead.
+uint64 PosixReadaheadBytes() {
+  static const uint64 readahead_bytes = [] {
+    const char* value = getenv("TF_POSIX_READAHEAD_BYTES");
+    return value == nullptr ? 0 : strtoull(value, nullptr, 10);
+  }();
+  return readahead_bytes;
+}
+
+}  // namespace
+
 // pread() based random-access
 class PosixRandomAccessFile : public RandomAccessFile {
  private:
   string filename_;
   int fd_;
 
+#if defined(__linux__)
+  // The end of the last read, to detect sequential reads, and of the range
+  // that the kernel was last asked to read ahead. Updates race benignly when
+  // reads are concurrent: they only drive hints.
+  mutable std::atomic<uint64> next_read_offset_{0};
+  mutable std::atomic<uint64> readahead_end_{0};
+
+  // When reads are sequential, e.g. the buffer fills of a `RecordReader`,
+  // keeps up to `PosixReadaheadBytes()` past `end` in flight in the page
+  // cache. The kernel serves POSIX_FADV_WILLNEED asynchronously, so the disk
+  // works on the next buffers while the caller processes this one. Requests
+  // are issued in batches of at least half the window.
+  void MaybeReadahead(uint64 offset, uint64 end) const {
+    const uint64 window = PosixReadaheadBytes();
+    if (window == 0) return;
+    if (next_read_offset_.exchange(end, std::memory_order_relaxed) != offset) {
+      return;
+    }
+    const uint64 start =
+        std::max(end, readahead_end_.load(std::memory_order_relaxed));
+    if (start >= end + window / 2) return;
+    readahead_end_.store(end + window, std::memory_order_relaxed);
+    posix_fadvise(fd_, static_cast<off_t>(start),
+                  static_cast<off_t>(end + window - start),
+                  POSIX_FADV_WILLNEED);
+  }
+#endif
+
  public:
   PosixRandomAccessFile(const string& fname, int fd)
       : filename_(fname), fd_(fd) {}
@@ -67,6 +114,9 @@ class PosixRandomAccessFile : public RandomAccessFile {
 
   Status Read(uint64 offset, size_t n, StringPiece* result,
               char* scratch) const override {
+#if defined(__linux__)
+    MaybeReadahead(offset, offset + n);
+#endif
     Status s;
     char* dst = scratch;
     while (n > 0 && s.ok()) {
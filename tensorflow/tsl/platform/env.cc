@@ -315,6 +315,43 @@ Status Env::Stat(const string& fname, FileStatistics* stat) {
   return fs->Stat(fname, stat);
 }
 
+bool Env::StatMany(const std::vector<string>& fnames,
+                   std::vector<FileStatistics>* stats,
+                   std::vector<Status>* status) {
+  std::unordered_map<string, std::vector<int>> fnames_per_fs;
+  for (int i = 0; i < fnames.size(); ++i) {
+    StringPiece scheme, host, path;
+    io::ParseURI(fnames[i], &scheme, &host, &path);
+    fnames_per_fs[string(scheme)].push_back(i);
+  }
+
+  stats->assign(fnames.size(), FileStatistics());
+  status->assign(fnames.size(), OkStatus());
+  bool result = true;
+  for (const auto& itr : fnames_per_fs) {
+    const std::vector<int>& indices = itr.second;
+    FileSystem* file_system = file_system_registry_->Lookup(itr.first);
+    if (!file_system) {
+      const Status s = errors::Unimplemented("File system scheme '", itr.first,
+                                             "' not implemented");
+      for (int i : indices) (*status)[i] = s;
+      result = false;
+      continue;
+    }
+    std::vector<string> fs_fnames;
+    fs_fnames.reserve(indices.size());
+    for (int i : indices) fs_fnames.push_back(fnames[i]);
+    std::vector<FileStatistics> fs_stats;
+    std::vector<Status> fs_status;
+    result &= file_system->StatMany(fs_fnames, &fs_stats, &fs_status);
+    for (int j = 0; j < indices.size(); ++j) {
+      (*stats)[indices[j]] = fs_stats[j];
+      (*status)[indices[j]] = fs_status[j];
+    }
+  }
+  return result;
+}
+
 Status Env::IsDirectory(const string& fname) {
   FileSystem* fs;
   TF_RETURN_IF_ERROR(GetFileSystemForFile(fname, &fs));
@@ -314,6 +314,13 @@ class Env {
     return OkStatus();
   }
 
+  /// \brief Obtains statistics for each of the given paths.
+  ///
+  /// See FileSystem::StatMany. The paths may be in different file systems.
+  bool StatMany(const std::vector<string>& fnames,
+                std::vector<FileStatistics>* stats,
+                std::vector<Status>* status);
+
   /// \brief Returns whether the given path is a directory or not.
   /// Typical return codes (not guaranteed exhaustive):
   ///  * OK - The path exists and is a directory.
@@ -598,6 +605,10 @@ struct ThreadOptions {
   /// Guard area size to use near thread stacks to use (in bytes)
   size_t guard_size = 0;  // 0: use system default value
   int numa_node = port::kNUMANoAffinity;
+  /// If true and `numa_node` is `kNUMANoAffinity`, the threads of a
+  /// `thread::ThreadPool` are pinned to the NUMA nodes in equal parts, and
+  /// the closures they schedule run on their own node.
+  bool numa_partitioned = false;
 };
 
 /// A utility routine: copy contents of `src` in file system `src_fs`
@@ -31,12 +31,14 @@ limitations under the License.
 #endif  // defined(PLATFORM_POSIX) || defined(IS_MOBILE_PLATFORM) || \
         // defined(PLATFORM_GOOGLE)
 
+#include "tensorflow/tsl/platform/cpu_info.h"
 #include "tensorflow/tsl/platform/env.h"
 #include "tensorflow/tsl/platform/errors.h"
 #include "tensorflow/tsl/platform/platform.h"
 #include "tensorflow/tsl/platform/scanner.h"
 #include "tensorflow/tsl/platform/str_util.h"
 #include "tensorflow/tsl/platform/strcat.h"
+#include "tensorflow/tsl/platform/threadpool.h"
 
 namespace tsl {
 
@@ -110,6 +112,39 @@ bool FileSystem::FilesExist(const std::vector<string>& files,
   return result;
 }
 
+bool FileSystem::StatMany(const std::vector<string>& fnames,
+                          TransactionToken* token,
+                          std::vector<FileStatistics>* stats,
+                          std::vector<Status>* status) {
+  const int num_fnames = fnames.size();
+  stats->assign(num_fnames, FileStatistics());
+  status->assign(num_fnames, OkStatus());
+  auto stat_fn = [&](int i) {
+    (*status)[i] = Stat(fnames[i], token, &(*stats)[i]);
+  };
+  // Skip the ThreadPool on the iOS platform due to its problems with more than
+  // a few threads.
+#if TARGET_OS_IPHONE
+  for (int i = 0; i < num_fnames; ++i) {
+    stat_fn(i);
+  }
+#else
+  const int num_threads = std::min(port::NumSchedulableCPUs(), num_fnames);
+  if (num_threads <= 1) {
+    for (int i = 0; i < num_fnames; ++i) {
+      stat_fn(i);
+    }
+  } else {
+    thread::ThreadPool threads(Env::Default(), "StatMany", num_threads);
+    for (int i = 0; i < num_fnames; ++i) {
+      threads.Schedule([&stat_fn, i] { stat_fn(i); });
+    }
+  }
+#endif
+  return std::all_of(status->begin(), status->end(),
+                     [](const Status& s) { return s.ok(); });
+}
+
 Status FileSystem::DeleteRecursively(const string& dirname,
                                      TransactionToken* token,
                                      int64_t* undeleted_files,
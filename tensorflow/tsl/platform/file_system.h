@@ -231,6 +231,23 @@ class FileSystem {
     return OkStatus();
   }
 
+  /// \brief Obtains statistics for each of the given paths.
+  ///
+  /// Sets (*status)[i] to the status of the Stat of fnames[i] and, if it is
+  /// OK, (*stats)[i] to its statistics. Returns true if all the paths were
+  /// statted. The default implementation calls Stat for the paths in parallel;
+  /// file systems with batched metadata requests should override it.
+  virtual bool StatMany(const std::vector<string>& fnames,
+                        std::vector<FileStatistics>* stats,
+                        std::vector<Status>* status) {
+    return StatMany(fnames, nullptr, stats, status);
+  }
+
+  virtual bool StatMany(const std::vector<string>& fnames,
+                        TransactionToken* token,
+                        std::vector<FileStatistics>* stats,
+                        std::vector<Status>* status);
+
   /// \brief Deletes the named file.
   virtual tsl::Status DeleteFile(const std::string& fname) {
     return DeleteFile(fname, nullptr);
@@ -550,6 +567,7 @@ class FileSystem {
   using FileSystem::GetChildren;                              \
   using FileSystem::GetMatchingPaths;                         \
   using FileSystem::Stat;                                     \
+  using FileSystem::StatMany;                                 \
   using FileSystem::DeleteFile;                               \
   using FileSystem::RecursivelyCreateDir;                     \
   using FileSystem::DeleteDir;                                \
@@ -626,6 +644,12 @@ class WrappedFileSystem : public FileSystem {
     return fs_->Stat(fname, (token ? token : token_), stat);
   }
 
+  bool StatMany(const std::vector<string>& fnames, TransactionToken* token,
+                std::vector<FileStatistics>* stats,
+                std::vector<Status>* status) override {
+    return fs_->StatMany(fnames, (token ? token : token_), stats, status);
+  }
+
   tsl::Status DeleteFile(const std::string& fname,
                          TransactionToken* token) override {
     return fs_->DeleteFile(fname, (token ? token : token_));
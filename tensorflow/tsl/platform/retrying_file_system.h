@@ -89,6 +89,23 @@ class RetryingFileSystem : public FileSystem {
         retry_config_);
   }
 
+  bool StatMany(const std::vector<string>& fnames, TransactionToken* token,
+                std::vector<FileStatistics>* stats,
+                std::vector<Status>* status) override {
+    if (base_file_system_->StatMany(fnames, token, stats, status)) {
+      return true;
+    }
+    // The paths that failed are statted again one by one with retries.
+    bool result = true;
+    for (int i = 0; i < fnames.size(); ++i) {
+      if (!(*status)[i].ok() && !errors::IsNotFound((*status)[i])) {
+        (*status)[i] = Stat(fnames[i], token, &(*stats)[i]);
+      }
+      result &= (*status)[i].ok();
+    }
+    return result;
+  }
+
   Status DeleteFile(const string& fname, TransactionToken* token) override {
     return RetryingUtils::DeleteWithRetries(
         [this, &fname, token]() {
@@ -17,6 +17,11 @@ limitations under the License.
 
 #define EIGEN_USE_THREADS
 
+#include <algorithm>
+#include <atomic>
+#include <utility>
+#include <vector>
+
 #include "absl/types/optional.h"
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
 #include "tensorflow/tsl/platform/blocking_counter.h"
@@ -54,19 +59,48 @@ struct EigenEnvironment {
   Env* const env_;
   const ThreadOptions thread_options_;
   const string name_;
+  // The pool partitions its threads over `num_numa_nodes_` NUMA nodes if
+  // there are more than 1.
+  const int num_threads_;
+  const int num_numa_nodes_;
+  // The number of threads created, which is the index of the next thread.
+  int num_created_threads_ = 0;
 
   EigenEnvironment(Env* env, const ThreadOptions& thread_options,
-                   const string& name)
-      : env_(env), thread_options_(thread_options), name_(name) {}
+                   const string& name, int num_threads = 1,
+                   int num_numa_nodes = 1)
+      : env_(env),
+        thread_options_(thread_options),
+        name_(name),
+        num_threads_(num_threads),
+        num_numa_nodes_(num_numa_nodes) {}
+
+  // Returns the NUMA node of the thread at `thread_index`.
+  int NumaNodeOfThread(int thread_index) const {
+    return static_cast<int64_t>(thread_index) * num_numa_nodes_ / num_threads_;
+  }
+
+  // Returns the index of the first thread of `numa_node`.
+  int FirstThreadOfNumaNode(int numa_node) const {
+    return (static_cast<int64_t>(numa_node) * num_threads_ + num_numa_nodes_ -
+            1) /
+           num_numa_nodes_;
+  }
 
   EnvThread* CreateThread(std::function<void()> f) {
+    // The pool creates its threads in the order of their indices.
+    int numa_node = thread_options_.numa_node;
+    if (num_numa_nodes_ > 1) {
+      numa_node = NumaNodeOfThread(num_created_threads_);
+    }
+    ++num_created_threads_;
     return env_->StartThread(thread_options_, name_, [=]() {
       // Set the processor flag to flush denormals to zero.
       port::ScopedFlushDenormal flush;
       // Set the processor rounding mode to ROUND TO NEAREST.
       tsl::port::ScopedSetRound round(FE_TONEAREST);
-      if (thread_options_.numa_node != port::kNUMANoAffinity) {
-        port::NUMASetThreadNodeAffinity(thread_options_.numa_node);
+      if (numa_node != port::kNUMANoAffinity) {
+        port::NUMASetThreadNodeAffinity(numa_node);
       }
       f();
     });
@@ -95,6 +129,61 @@ struct EigenEnvironment {
   }
 };
 
+namespace {
+
+// Returns the number of NUMA nodes to partition the threads of a pool over, or
+// 1 if they are not partitioned.
+int NumNumaPartitions(const ThreadOptions& thread_options, int num_threads) {
+  if (!thread_options.numa_partitioned ||
+      thread_options.numa_node != port::kNUMANoAffinity ||
+      !port::NUMAEnabled()) {
+    return 1;
+  }
+  // Each node has at least 1 thread.
+  return std::max(1, std::min(port::NUMANumNodes(), num_threads));
+}
+
+// Schedules the closures on the threads of a NUMA node of a pool whose threads
+// are partitioned over the NUMA nodes: the node of the scheduling thread if it
+// is a thread of the pool, or else the nodes in turns.
+class NumaPartitionedThreadPool : public Eigen::ThreadPoolInterface {
+ public:
+  NumaPartitionedThreadPool(Eigen::ThreadPoolTempl<EigenEnvironment>* pool,
+                            EigenEnvironment env)
+      : pool_(pool), env_(std::move(env)) {}
+
+  void Schedule(std::function<void()> fn) override {
+    const int thread_id = pool_->CurrentThreadId();
+    const int numa_node =
+        thread_id >= 0
+            ? env_.NumaNodeOfThread(thread_id)
+            : next_numa_node_.fetch_add(1, std::memory_order_relaxed) %
+                  env_.num_numa_nodes_;
+    pool_->ScheduleWithHint(std::move(fn),
+                            env_.FirstThreadOfNumaNode(numa_node),
+                            env_.FirstThreadOfNumaNode(numa_node + 1));
+  }
+
+  void ScheduleWithHint(std::function<void()> fn, int start,
+                        int limit) override {
+    pool_->ScheduleWithHint(std::move(fn), start, limit);
+  }
+
+  void Cancel() override { pool_->Cancel(); }
+
+  int NumThreads() const override { return pool_->NumThreads(); }
+
+  int CurrentThreadId() const override { return pool_->CurrentThreadId(); }
+
+ private:
+  Eigen::ThreadPoolTempl<EigenEnvironment>* const pool_;  // Not owned.
+  // The copy of the environment of the pool maps the threads to the nodes.
+  const EigenEnvironment env_;
+  std::atomic<unsigned> next_numa_node_{0};
+};
+
+}  // namespace
+
 ThreadPool::ThreadPool(Env* env, const string& name, int num_threads)
     : ThreadPool(env, ThreadOptions(), name, num_threads, true, nullptr) {}
 
@@ -113,10 +202,28 @@ ThreadPool::ThreadPool(Env* env, const ThreadOptions& thread_options,
   if (num_threads < 1) num_threads = 1;
 #endif  // TENSORFLOW_THREADSCALING_EXPERIMENTAL
 
+  const int num_numa_nodes = NumNumaPartitions(thread_options, num_threads);
+  EigenEnvironment eigen_env(env, thread_options, "tf_" + name, num_threads,
+                             num_numa_nodes);
   eigen_threadpool_.reset(new Eigen::ThreadPoolTempl<EigenEnvironment>(
-      num_threads, low_latency_hint,
-      EigenEnvironment(env, thread_options, "tf_" + name)));
+      num_threads, low_latency_hint, eigen_env));
   underlying_threadpool_ = eigen_threadpool_.get();
+  if (num_numa_nodes > 1) {
+    // The threads of a node steal the closures of the threads of their node
+    // first.
+    std::vector<std::pair<unsigned, unsigned>> partitions(num_threads);
+    for (int i = 0; i < num_threads; ++i) {
+      const int numa_node = eigen_env.NumaNodeOfThread(i);
+      partitions[i] = {eigen_env.FirstThreadOfNumaNode(numa_node),
+                       eigen_env.FirstThreadOfNumaNode(numa_node + 1)};
+    }
+    eigen_threadpool_->SetStealPartitions(partitions);
+    numa_threadpool_ = std::make_unique<NumaPartitionedThreadPool>(
+        eigen_threadpool_.get(), eigen_env);
+    underlying_threadpool_ = numa_threadpool_.get();
+    VLOG(1) << "Partitioned the " << num_threads << " threads of " << name
+            << " over " << num_numa_nodes << " NUMA nodes";
+  }
   threadpool_device_.reset(new Eigen::ThreadPoolDevice(underlying_threadpool_,
                                                        num_threads, allocator));
 }
@@ -107,6 +107,12 @@ class ThreadPool {
   // wait. Conversely, if the threadpool is used to schedule high-latency
   // operations like I/O the hint should be set to false.
   //
+  // With `thread_options.numa_partitioned` on a host with several NUMA nodes,
+  // the threads are pinned to the nodes in equal parts and only steal the
+  // closures of their node. The closures scheduled by a thread of the pool,
+  // such as the nested shards of ParallelFor, run on its node, and the
+  // closures scheduled from other threads are spread over the nodes in turns.
+  //
   // REQUIRES: num_threads > 0
   ThreadPool(Env* env, const ThreadOptions& thread_options,
              const std::string& name, int num_threads, bool low_latency_hint,
@@ -234,6 +240,9 @@ class ThreadPool {
   // eigen_threadpool_ is instantiated and owned by thread::ThreadPool if
   // user_threadpool is not in the constructor.
   std::unique_ptr<Eigen::ThreadPoolTempl<EigenEnvironment>> eigen_threadpool_;
+  // Set if the threads of eigen_threadpool_ are partitioned over the NUMA
+  // nodes, in which case it is the underlying_threadpool_.
+  std::unique_ptr<Eigen::ThreadPoolInterface> numa_threadpool_;
   std::unique_ptr<Eigen::ThreadPoolDevice> threadpool_device_;
   TF_DISALLOW_COPY_AND_ASSIGN(ThreadPool);
 };
@@ -0,0 +1,195 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/tsl/profiler/lib/continuous_profiler.h"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "tensorflow/tsl/platform/errors.h"
+#include "tensorflow/tsl/platform/host_info.h"
+#include "tensorflow/tsl/platform/logging.h"
+#include "tensorflow/tsl/profiler/convert/post_process_single_host_xplane.h"
+#include "tensorflow/tsl/profiler/lib/profiler_collection.h"
+#include "tensorflow/tsl/profiler/lib/profiler_factory.h"
+#include "tensorflow/tsl/profiler/lib/profiler_lock.h"
+#include "tensorflow/tsl/profiler/lib/profiler_session.h"
+#include "tensorflow/tsl/profiler/utils/math_utils.h"
+#include "tensorflow/tsl/profiler/utils/time_utils.h"
+#include "tensorflow/tsl/profiler/utils/xplane_utils.h"
+
+namespace tsl {
+namespace profiler {
+namespace {
+
+using tensorflow::ProfileOptions;
+using tensorflow::profiler::XPlane;
+using tensorflow::profiler::XSpace;
+
+mutex profiler_mu(LINKER_INITIALIZED);
+ContinuousProfiler* profiler TF_GUARDED_BY(profiler_mu) = nullptr;
+
+ProfileOptions GetOptions(const ProfileOptions& opts) {
+  if (opts.version()) return opts;
+  return ProfilerSession::DefaultOptions();
+}
+
+}  // namespace
+
+ContinuousProfiler::ContinuousProfiler(const Options& options)
+    : options_(options) {
+  thread_.reset(Env::Default()->StartThread(
+      ThreadOptions(), "continuous_profiler", [this]() { SampleLoop(); }));
+}
+
+ContinuousProfiler::~ContinuousProfiler() {
+  {
+    mutex_lock l(mu_);
+    stopped_ = true;
+    stop_cv_.notify_all();
+  }
+  // Joins the sampling thread.
+  thread_.reset();
+}
+
+/*static*/ Status ContinuousProfiler::Start(const Options& options) {
+  if (options.sample_duration_ms == 0 ||
+      options.sample_duration_ms > options.sample_period_ms) {
+    return errors::InvalidArgument(
+        "The sample duration of the continuous profiler must be positive and "
+        "at most the sample period, got ",
+        options.sample_duration_ms, "ms and ", options.sample_period_ms,
+        "ms.");
+  }
+  mutex_lock l(profiler_mu);
+  if (profiler != nullptr) {
+    return errors::AlreadyExists("The continuous profiler is running.");
+  }
+  Options profiler_options = options;
+  profiler_options.profile_options = GetOptions(options.profile_options);
+  profiler = new ContinuousProfiler(profiler_options);
+  LOG(INFO) << "Continuous profiler started, sampling "
+            << options.sample_duration_ms << "ms every "
+            << options.sample_period_ms << "ms.";
+  return OkStatus();
+}
+
+/*static*/ void ContinuousProfiler::Stop() {
+  ContinuousProfiler* stopped_profiler;
+  {
+    mutex_lock l(profiler_mu);
+    stopped_profiler = std::exchange(profiler, nullptr);
+  }
+  delete stopped_profiler;
+}
+
+/*static*/ bool ContinuousProfiler::IsRunning() {
+  mutex_lock l(profiler_mu);
+  return profiler != nullptr;
+}
+
+/*static*/ Status ContinuousProfiler::CollectRecent(uint64 duration_ms,
+                                                    XSpace* space) {
+  // Holds the lock so that Stop waits for the collection.
+  mutex_lock l(profiler_mu);
+  if (profiler == nullptr) {
+    return errors::FailedPrecondition(
+        "The continuous profiler is not running.");
+  }
+  return profiler->CollectSamples(duration_ms, space);
+}
+
+void ContinuousProfiler::SampleLoop() {
+  const uint64 period_ns = MilliToNano(options_.sample_period_ms);
+  uint64 next_sample_ns = GetCurrentTimeNanos();
+  while (true) {
+    RecordSample();
+    next_sample_ns += period_ns;
+    // Skips the periods that the sample overran.
+    next_sample_ns = std::max<uint64>(next_sample_ns, GetCurrentTimeNanos());
+    if (WaitForStop(next_sample_ns)) return;
+  }
+}
+
+void ContinuousProfiler::RecordSample() {
+  auto profiler_lock = ProfilerLock::Acquire();
+  if (!profiler_lock.ok()) {
+    VLOG(1) << "Skipped a sample of the continuous profiler: "
+            << profiler_lock.status();
+    return;
+  }
+  auto sample = std::make_shared<Sample>();
+  sample->start_time_ns = GetCurrentTimeNanos();
+  {
+    ProfilerCollection profilers(CreateProfilers(options_.profile_options));
+    profilers.Start().IgnoreError();
+    // The sample is still recorded if the profiler is stopped meanwhile.
+    WaitForStop(sample->start_time_ns +
+                MilliToNano(options_.sample_duration_ms));
+    profilers.Stop().IgnoreError();
+    sample->end_time_ns = GetCurrentTimeNanos();
+    profilers.CollectData(&sample->space).IgnoreError();
+  }
+  profiler_lock->ReleaseIfActive();
+
+  const uint64 buffer_duration_ns = MilliToNano(options_.buffer_duration_ms);
+  mutex_lock l(mu_);
+  samples_.push_back(std::move(sample));
+  while (samples_.front()->end_time_ns + buffer_duration_ns <
+         samples_.back()->end_time_ns) {
+    samples_.pop_front();
+  }
+}
+
+bool ContinuousProfiler::WaitForStop(uint64 deadline_ns) {
+  mutex_lock l(mu_);
+  while (!stopped_) {
+    const uint64 now_ns = GetCurrentTimeNanos();
+    if (now_ns >= deadline_ns) return false;
+    stop_cv_.wait_for(l, std::chrono::nanoseconds(deadline_ns - now_ns));
+  }
+  return true;
+}
+
+Status ContinuousProfiler::CollectSamples(uint64 duration_ms, XSpace* space) {
+  std::vector<std::shared_ptr<const Sample>> samples;
+  const uint64 now_ns = GetCurrentTimeNanos();
+  const uint64 duration_ns = MilliToNano(duration_ms);
+  {
+    mutex_lock l(mu_);
+    for (const auto& sample : samples_) {
+      if (duration_ms == 0 || sample->end_time_ns + duration_ns >= now_ns) {
+        samples.push_back(sample);
+      }
+    }
+  }
+  space->add_hostnames(port::Hostname());
+  if (samples.empty()) {
+    return OkStatus();
+  }
+  // The planes of the samples are merged by name, which keeps the timelines
+  // of the host threads and of each device on their own planes.
+  for (const auto& sample : samples) {
+    for (const XPlane& plane : sample->space.planes()) {
+      MergePlanes(plane, FindOrAddMutablePlaneWithName(space, plane.name()));
+    }
+  }
+  PostProcessSingleHostXSpace(space, samples.front()->start_time_ns);
+  return OkStatus();
+}
+
+}  // namespace profiler
+}  // namespace tsl
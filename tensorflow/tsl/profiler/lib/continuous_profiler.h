@@ -0,0 +1,117 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_TSL_PROFILER_LIB_CONTINUOUS_PROFILER_H_
+#define TENSORFLOW_TSL_PROFILER_LIB_CONTINUOUS_PROFILER_H_
+
+#include <deque>
+#include <memory>
+
+#include "tensorflow/tsl/platform/env.h"
+#include "tensorflow/tsl/platform/mutex.h"
+#include "tensorflow/tsl/platform/status.h"
+#include "tensorflow/tsl/platform/thread_annotations.h"
+#include "tensorflow/tsl/platform/types.h"
+#include "tensorflow/tsl/profiler/protobuf/profiler_options.pb.h"
+#include "tensorflow/tsl/profiler/protobuf/xplane.pb.h"
+
+namespace tsl {
+namespace profiler {
+
+// ContinuousProfiler samples the activity of the process in the background,
+// for the latency spikes that on-demand profiling does not catch. Each sample
+// profiles the host and the devices, like a ProfilerSession, for
+// `sample_duration_ms` out of every `sample_period_ms`, so that the overhead
+// is a fraction of the one of profiling all the time. The samples of the last
+// `buffer_duration_ms` are kept in memory, and CollectRecent merges them.
+//
+// The samples hold the profiler lock only while they record, and the samples
+// that would overlap another profiling session are skipped.
+//
+// Thread-safety: the static methods are thread-safe.
+class ContinuousProfiler {
+ public:
+  struct Options {
+    // The options of the profilers of the samples.
+    tensorflow::ProfileOptions profile_options;
+    uint64 sample_duration_ms = 100;
+    uint64 sample_period_ms = 1000;
+    uint64 buffer_duration_ms = 60000;
+  };
+
+  // Starts the continuous profiler of the process.
+  //
+  // Return Status codes:
+  // OK:                If successful.
+  // INVALID_ARGUMENT:  If the sample duration is 0 or above the period.
+  // ALREADY_EXISTS:    If the continuous profiler is running.
+  static Status Start(const Options& options);
+
+  // Stops the continuous profiler of the process and drops its samples.
+  static void Stop();
+
+  // Returns whether the continuous profiler of the process is running.
+  static bool IsRunning();
+
+  // Merges the samples recorded in the last `duration_ms` milliseconds into
+  // `space`, or all the buffered samples if `duration_ms` is 0. The
+  // timestamps are relative to the start of the first sample.
+  //
+  // Return Status codes:
+  // OK:                   If successful.
+  // FAILED_PRECONDITION:  If the continuous profiler is not running.
+  static Status CollectRecent(uint64 duration_ms,
+                              tensorflow::profiler::XSpace* space);
+
+  ContinuousProfiler(const ContinuousProfiler&) = delete;
+  ContinuousProfiler& operator=(const ContinuousProfiler&) = delete;
+
+  ~ContinuousProfiler();
+
+ private:
+  struct Sample {
+    uint64 start_time_ns;
+    uint64 end_time_ns;
+    // The data of the profilers, with absolute timestamps.
+    tensorflow::profiler::XSpace space;
+  };
+
+  explicit ContinuousProfiler(const Options& options);
+
+  // Records the samples until the profiler is stopped.
+  void SampleLoop();
+
+  // Records a sample, unless another profiling session is active.
+  void RecordSample();
+
+  // Waits until `deadline_ns` and returns false, or returns true as soon as
+  // the profiler is stopped.
+  bool WaitForStop(uint64 deadline_ns) TF_LOCKS_EXCLUDED(mu_);
+
+  Status CollectSamples(uint64 duration_ms,
+                        tensorflow::profiler::XSpace* space)
+      TF_LOCKS_EXCLUDED(mu_);
+
+  const Options options_;
+  mutex mu_;
+  condition_variable stop_cv_;
+  bool stopped_ TF_GUARDED_BY(mu_) = false;
+  std::deque<std::shared_ptr<const Sample>> samples_ TF_GUARDED_BY(mu_);
+  std::unique_ptr<Thread> thread_;
+};
+
+}  // namespace profiler
+}  // namespace tsl
+
+#endif  // TENSORFLOW_TSL_PROFILER_LIB_CONTINUOUS_PROFILER_H_
@@ -0,0 +1,80 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/tsl/profiler/lib/continuous_profiler.h"
+
+#include "tensorflow/tsl/lib/core/status_test_util.h"
+#include "tensorflow/tsl/platform/env.h"
+#include "tensorflow/tsl/platform/errors.h"
+#include "tensorflow/tsl/platform/test.h"
+#include "tensorflow/tsl/profiler/lib/profiler_lock.h"
+#include "tensorflow/tsl/profiler/protobuf/xplane.pb.h"
+
+namespace tsl {
+namespace profiler {
+namespace {
+
+using tensorflow::profiler::XSpace;
+
+ContinuousProfiler::Options TestOptions() {
+  ContinuousProfiler::Options options;
+  options.sample_duration_ms = 10;
+  options.sample_period_ms = 20;
+  options.buffer_duration_ms = 1000;
+  return options;
+}
+
+TEST(ContinuousProfilerTest, StartAndStop) {
+  EXPECT_FALSE(ContinuousProfiler::IsRunning());
+  TF_ASSERT_OK(ContinuousProfiler::Start(TestOptions()));
+  EXPECT_TRUE(ContinuousProfiler::IsRunning());
+  EXPECT_TRUE(
+      errors::IsAlreadyExists(ContinuousProfiler::Start(TestOptions())));
+  Env::Default()->SleepForMicroseconds(100 * 1000);
+
+  XSpace space;
+  TF_ASSERT_OK(ContinuousProfiler::CollectRecent(/*duration_ms=*/0, &space));
+  EXPECT_EQ(space.hostnames_size(), 1);
+
+  ContinuousProfiler::Stop();
+  EXPECT_FALSE(ContinuousProfiler::IsRunning());
+  EXPECT_TRUE(errors::IsFailedPrecondition(
+      ContinuousProfiler::CollectRecent(/*duration_ms=*/0, &space)));
+}
+
+TEST(ContinuousProfilerTest, InvalidSampleDuration) {
+  ContinuousProfiler::Options options = TestOptions();
+  options.sample_duration_ms = 0;
+  EXPECT_TRUE(errors::IsInvalidArgument(ContinuousProfiler::Start(options)));
+  options.sample_duration_ms = options.sample_period_ms + 1;
+  EXPECT_TRUE(errors::IsInvalidArgument(ContinuousProfiler::Start(options)));
+  EXPECT_FALSE(ContinuousProfiler::IsRunning());
+}
+
+TEST(ContinuousProfilerTest, ReleasesProfilerLockBetweenSamples) {
+  ContinuousProfiler::Options options = TestOptions();
+  options.sample_duration_ms = 1;
+  options.sample_period_ms = 1000;
+  TF_ASSERT_OK(ContinuousProfiler::Start(options));
+  Env::Default()->SleepForMicroseconds(100 * 1000);
+  // The first sample is over, and the next one is far away.
+  StatusOr<ProfilerLock> profiler_lock = ProfilerLock::Acquire();
+  ASSERT_TRUE(profiler_lock.ok());
+  profiler_lock->ReleaseIfActive();
+  ContinuousProfiler::Stop();
+}
+
+}  // namespace
+}  // namespace profiler
+}  // namespace tsl
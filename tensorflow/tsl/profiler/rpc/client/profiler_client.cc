@@ -31,6 +31,7 @@ namespace tsl {
 namespace profiler {
 namespace {
 
+using tensorflow::DumpContinuousProfileRequest;
 using tensorflow::MonitorRequest;
 using tensorflow::MonitorResponse;
 using tensorflow::NewProfileSessionRequest;
@@ -92,6 +93,17 @@ Status MonitorGrpc(const std::string& service_address,
   return OkStatus();
 }
 
+Status DumpContinuousProfileGrpc(const std::string& service_address,
+                                 const DumpContinuousProfileRequest& request,
+                                 ProfileResponse* response) {
+  ::grpc::ClientContext context;
+  std::unique_ptr<tensorflow::grpc::ProfilerService::Stub> stub =
+      CreateStub<tensorflow::grpc::ProfilerService>(service_address);
+  TF_RETURN_IF_ERROR(FromGrpcStatus(
+      stub->DumpContinuousProfile(&context, request, response)));
+  return OkStatus();
+}
+
 /*static*/ std::unique_ptr<RemoteProfilerSession> RemoteProfilerSession::Create(
     const std::string& service_address, absl::Time deadline,
     const ProfileRequest& profile_request) {
@@ -43,6 +43,11 @@ Status MonitorGrpc(const std::string& service_address,
                    const tensorflow::MonitorRequest& request,
                    tensorflow::MonitorResponse* response);
 
+Status DumpContinuousProfileGrpc(
+    const std::string& service_address,
+    const tensorflow::DumpContinuousProfileRequest& request,
+    tensorflow::ProfileResponse* response);
+
 class RemoteProfilerSession {
  public:
   // Creates an instance and starts a remote profiling session immediately.
@@ -27,6 +27,7 @@ limitations under the License.
 #include "tensorflow/tsl/platform/macros.h"
 #include "tensorflow/tsl/platform/mutex.h"
 #include "tensorflow/tsl/platform/status.h"
+#include "tensorflow/tsl/profiler/lib/continuous_profiler.h"
 #include "tensorflow/tsl/profiler/lib/profiler_session.h"
 #include "tensorflow/tsl/profiler/protobuf/profiler_service.grpc.pb.h"
 #include "tensorflow/tsl/profiler/protobuf/profiler_service.pb.h"
@@ -41,6 +42,7 @@ namespace tsl {
 namespace profiler {
 namespace {
 
+using tensorflow::DumpContinuousProfileRequest;
 using tensorflow::MonitorRequest;
 using tensorflow::MonitorResponse;
 using tensorflow::ProfileRequest;
@@ -106,6 +108,29 @@ class ProfilerServiceImpl : public tensorflow::grpc::ProfilerService::Service {
     return ::grpc::Status::OK;
   }
 
+  ::grpc::Status DumpContinuousProfile(
+      ::grpc::ServerContext* ctx, const DumpContinuousProfileRequest* req,
+      ProfileResponse* response) override {
+    VLOG(1) << "Received a continuous profile request: " << req->DebugString();
+    XSpace xspace;
+    Status status =
+        ContinuousProfiler::CollectRecent(req->duration_ms(), &xspace);
+    if (errors::IsFailedPrecondition(status)) {
+      return ::grpc::Status(::grpc::StatusCode::FAILED_PRECONDITION,
+                            std::string(status.message()));
+    }
+    if (status.ok()) {
+      response->set_empty_trace(IsEmpty(xspace));
+      status = SaveXSpace(req->repository_root(), req->session_id(),
+                          req->host_name(), xspace);
+    }
+    if (!status.ok()) {
+      return ::grpc::Status(::grpc::StatusCode::INTERNAL,
+                            std::string(status.message()));
+    }
+    return ::grpc::Status::OK;
+  }
+
   ::grpc::Status Terminate(::grpc::ServerContext* ctx,
                            const TerminateRequest* req,
                            TerminateResponse* response) override {